@@ -6,6 +6,9 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/threading.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/dgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/sparsegemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/qnbitgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
@@ -17,6 +20,8 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/erf.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/layernorm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/channelnorm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/quantize.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qladd.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qlmul.cpp
@@ -51,6 +56,9 @@ if(MSVC)
       )
       list(APPEND mlas_platform_srcs ${obj_filename})
     endforeach()
+
+    # the dot product kernel is only built with the GCC/Clang toolchains
+    set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_UDOT_UNSUPPORTED)
   elseif(onnxruntime_target_platform STREQUAL "ARM")
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/arm/sgemmc.cpp
@@ -65,6 +73,8 @@ if(MSVC)
 
     set(mlas_platform_srcs_avx2
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/qladd_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/layernorm_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/cvtfp16_avx2.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "/arch:AVX2")
 
@@ -73,6 +83,9 @@ if(MSVC)
       set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512F_UNSUPPORTED")
     endif()
 
+    # the AMX kernel is only built with the GCC/Clang toolchains
+    set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AMX_UNSUPPORTED)
+
     set(mlas_platform_srcs
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
@@ -173,6 +186,17 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemmKernelNeon.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemvKernelNeon.S
     )
+
+    check_cxx_compiler_flag("-march=armv8.2-a+dotprod" HAS_ARM64_DOTPROD)
+    if(HAS_ARM64_DOTPROD)
+      set(mlas_platform_srcs_udot
+        ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/arm64/qgemm_kernel_udot.cpp
+      )
+      set_source_files_properties(${mlas_platform_srcs_udot} PROPERTIES COMPILE_FLAGS "-march=armv8.2-a+dotprod")
+      list(APPEND mlas_platform_srcs ${mlas_platform_srcs_udot})
+    else()
+      set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_UDOT_UNSUPPORTED)
+    endif()
   elseif(POWER)
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/power/SgemmKernelPower.cpp
@@ -244,8 +268,12 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/ErfKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/qladd_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/layernorm_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/cvtfp16_avx2.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/cvtfp16_avx2.cpp
+                                PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mf16c")
 
     # Some toolchains do not support AVX512 compiler flags but are still able
     # to build the sources. Other toolchains require the AVX512 compiler flags
@@ -300,6 +328,16 @@ else()
         if(HAS_AVX512CORE)
           set_source_files_properties(${mlas_platform_srcs_avx512core} PROPERTIES COMPILE_FLAGS "-mavx512bw -mavx512dq -mavx512vl")
         endif()
+
+        check_cxx_compiler_flag("-mamx-tile -mamx-int8" HAS_AMX)
+        if(HAS_AMX AND HAS_AVX512CORE)
+          set(mlas_platform_srcs_amx
+            ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/amx/qgemm_kernel_amx.cpp
+          )
+          set_source_files_properties(${mlas_platform_srcs_amx} PROPERTIES COMPILE_FLAGS "-mamx-tile -mamx-int8 -mavx512f -mavx512bw -mavx512dq -mavx512vl")
+        else()
+          set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AMX_UNSUPPORTED)
+        endif()
       else()
         set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512CORE_UNSUPPORTED")
       endif()
@@ -313,6 +351,7 @@ else()
       ${mlas_platform_srcs_avx2}
       ${mlas_platform_srcs_avx512f}
       ${mlas_platform_srcs_avx512core}
+      ${mlas_platform_srcs_amx}
     )
   endif()
 endif()
@@ -8,6 +8,13 @@ file(GLOB_RECURSE onnxruntime_providers_srcs CONFIGURE_DEPENDS
 
 if(onnxruntime_DISABLE_ML_OPS)
   list(FILTER onnxruntime_providers_srcs EXCLUDE REGEX ".*/ml/.*")
+elseif(onnxruntime_target_platform STREQUAL "x64" OR onnxruntime_target_platform STREQUAL "x86")
+  # the AVX2 tree ensemble kernels are only used if CPUID reports AVX2
+  if (MSVC)
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/providers/cpu/ml/tree_ensemble_avx2.cc PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+  else()
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/providers/cpu/ml/tree_ensemble_avx2.cc PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+  endif()
 endif()
 
 file(GLOB_RECURSE onnxruntime_cpu_contrib_ops_srcs CONFIGURE_DEPENDS
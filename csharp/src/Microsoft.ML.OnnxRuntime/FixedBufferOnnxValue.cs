@@ -43,6 +43,45 @@ namespace Microsoft.ML.OnnxRuntime
             }
         }
 
+        /// <summary>
+        /// Creates a <see cref="FixedBufferOnnxValue"/> object of the given shape on top of the memory and pins it.
+        /// The memory is used as is without a copy, so it can be refilled and the value reused across runs, and
+        /// output values are written straight into it.
+        /// </summary>
+        /// <typeparam name="T">element type of the tensor, string is not supported</typeparam>
+        /// <param name="memory">memory holding at least the number of elements of the shape</param>
+        /// <param name="shape">tensor shape</param>
+        /// <returns></returns>
+        public static FixedBufferOnnxValue CreateFromMemory<T>(Memory<T> memory, long[] shape)
+        {
+            var typeInfo = TensorBase.GetTypeInfo(typeof(T));
+            if (typeInfo == null || typeInfo.IsString)
+            {
+                throw new NotSupportedException("The element type " + typeof(T) + " is not supported for a memory backed tensor");
+            }
+
+            var memHandle = memory.Pin();
+            try
+            {
+                IntPtr dataBufferPointer = IntPtr.Zero;
+                unsafe
+                {
+                    dataBufferPointer = (IntPtr)memHandle.Pointer;
+                }
+                var ortValue = OrtValue.CreateTensorValueWithData(OrtMemoryInfo.DefaultInstance,
+                                                                  typeInfo.ElementType,
+                                                                  shape,
+                                                                  dataBufferPointer,
+                                                                  (uint)(memory.Length * typeInfo.TypeSize));
+                return new FixedBufferOnnxValue(memHandle, ortValue, OnnxValueType.ONNX_TYPE_TENSOR, typeInfo.ElementType);
+            }
+            catch (Exception)
+            {
+                memHandle.Dispose();
+                throw;
+            }
+        }
+
         #region IDisposable Support
 
         protected virtual void Dispose(bool disposing)
@@ -6,6 +6,7 @@ using System.Runtime.InteropServices;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Threading.Tasks;
 using Microsoft.ML.OnnxRuntime.Tensors;
 using System.Buffers;
 
@@ -23,6 +24,9 @@ namespace Microsoft.ML.OnnxRuntime
         private ModelMetadata _modelMetadata = null;
         private bool _disposed = false;
         private ulong _profilingStartTimeNs = 0;
+        // zero terminated utf8 names of the inputs, outputs and overridable initializers, pinned for the lifetime
+        // of the session so the runs don't convert and pin them on every call
+        private Dictionary<string, PinnedGCHandle> _pinnedNames = new Dictionary<string, PinnedGCHandle>();
 
         #region Public API
 
@@ -143,6 +147,75 @@ namespace Microsoft.ML.OnnxRuntime
             }
         }
 
+        /// <summary>
+        /// Runs the loaded model for the given inputs on the intra-op thread pool of the session, and fetches the specified outputs
+        /// in <paramref name="outputNames"/>. The session options must use at least 2 intra-op threads.
+        /// </summary>
+        /// <param name="inputs">Specify a collection of <see cref="NamedOnnxValue"/> that indicates the input values.</param>
+        /// <param name="outputNames">Specify a collection of string that indicates the output names to fetch.</param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames)
+        {
+            return RunAsync(inputs, outputNames, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs on the intra-op thread pool of the session, and fetches the specified outputs
+        /// in <paramref name="outputNames"/>. Uses the given RunOptions for this run.
+        /// </summary>
+        /// <param name="inputs">Specify a collection of <see cref="NamedOnnxValue"/> that indicates the input values.</param>
+        /// <param name="outputNames">Specify a collection of string that indicates the output names to fetch.</param>
+        /// <param name="options">Must not be disposed before the returned task completes.</param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames, RunOptions options)
+        {
+            // the pinned inputs and the output array have to stay alive until the run completes, so the cleanup list
+            // is handed over to the callback
+            var context = new RunAsyncContext();
+            context.CleanupList = new DisposableList<IDisposable>();
+            context.OutputNames = outputNames;
+            try
+            {
+                var inputNamesArray = ConvertNamesToUtf8(inputs, v => v.Name, context.CleanupList);
+                var inputValuesArray = GetOrtValuesHandles(inputs, context.CleanupList);
+                var outputNamesArray = ConvertNamesToUtf8(outputNames, n => n, context.CleanupList);
+
+                context.OutputValues = new IntPtr[outputNames.Count];
+                var pinnedOutputValues = new PinnedGCHandle(GCHandle.Alloc(context.OutputValues, GCHandleType.Pinned));
+                context.CleanupList.Add(pinnedOutputValues);
+
+                var contextHandle = GCHandle.Alloc(context);
+                try
+                {
+                    NativeApiStatus.VerifySuccess(NativeMethods.OrtRunAsync(
+                                                        _nativeHandle,
+                                                        options.Handle,
+                                                        inputNamesArray,
+                                                        inputValuesArray,
+                                                        (UIntPtr)inputNamesArray.Length,
+                                                        outputNamesArray,
+                                                        (UIntPtr)outputNamesArray.Length,
+                                                        pinnedOutputValues.Pointer,
+                                                        _runAsyncCallback,
+                                                        GCHandle.ToIntPtr(contextHandle)
+                                                        ));
+                }
+                catch
+                {
+                    // the callback is not invoked if the run could not be scheduled
+                    contextHandle.Free();
+                    throw;
+                }
+            }
+            catch
+            {
+                context.CleanupList.Dispose();
+                throw;
+            }
+
+            return context.Completion.Task;
+        }
+
         /// <summary>
         /// Runs the loaded model for the given inputs, and fetches all the outputs.
         /// </summary>
@@ -546,6 +619,13 @@ namespace Microsoft.ML.OnnxRuntime
             for (int i = 0; i < inputs.Count; ++i)
             {
                 var name = extractor(inputs.ElementAt(i));
+                PinnedGCHandle pinnedName;
+                if (_pinnedNames.TryGetValue(name, out pinnedName))
+                {
+                    result[i] = pinnedName.Pointer;
+                    continue;
+                }
+                // unknown names are still passed on, so the native run reports them
                 var utf8Name = NativeOnnxValueHelper.StringToZeroTerminatedUtf8(name);
                 var pinnedHandle = new PinnedGCHandle(GCHandle.Alloc(utf8Name, GCHandleType.Pinned));
                 result[i] = pinnedHandle.Pointer;
@@ -623,7 +703,59 @@ namespace Microsoft.ML.OnnxRuntime
             return ortValues;
         }
 
-        IDisposableReadOnlyCollection<DisposableNamedOnnxValue> CreateDisposableResult(List<OrtValue> ortValues,
+        private class RunAsyncContext
+        {
+            public DisposableList<IDisposable> CleanupList;
+            public IntPtr[] OutputValues;
+            public IReadOnlyCollection<string> OutputNames;
+            public TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> Completion =
+                new TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>();
+        }
+
+        // a static instance so the delegate can't be garbage collected while native code holds a pointer to it
+        private static readonly NativeMethods.DOrtRunAsyncCallbackFn _runAsyncCallback = RunAsyncCallback;
+
+        // Invoked on the native thread that executed the run
+        private static void RunAsyncCallback(IntPtr userData, IntPtr outputValues, UIntPtr outputCount, IntPtr status)
+        {
+            var contextHandle = GCHandle.FromIntPtr(userData);
+            var context = (RunAsyncContext)contextHandle.Target;
+            contextHandle.Free();
+
+            IDisposableReadOnlyCollection<DisposableNamedOnnxValue> result = null;
+            Exception error = null;
+            using (var cleanupList = context.CleanupList)
+            {
+                try
+                {
+                    NativeApiStatus.VerifySuccess(status);
+
+                    var ortValues = new DisposableList<OrtValue>(context.OutputValues.Length);
+                    cleanupList.Add(ortValues);
+                    foreach (var v in context.OutputValues)
+                    {
+                        ortValues.Add(new OrtValue(v));
+                    }
+                    result = CreateDisposableResult(ortValues, context.OutputNames);
+                }
+                catch (Exception e)
+                {
+                    error = e;
+                }
+            }
+
+            // complete the task on a managed thread so its continuations don't run on the session thread pool
+            if (error != null)
+            {
+                Task.Run(() => context.Completion.SetException(error));
+            }
+            else
+            {
+                Task.Run(() => context.Completion.SetResult(result));
+            }
+        }
+
+        static IDisposableReadOnlyCollection<DisposableNamedOnnxValue> CreateDisposableResult(List<OrtValue> ortValues,
             IReadOnlyCollection<string> outputNames)
         {
             var result = new DisposableList<DisposableNamedOnnxValue>(outputNames.Count);
@@ -743,6 +875,10 @@ namespace Microsoft.ML.OnnxRuntime
                 NativeApiStatus.VerifySuccess(NativeMethods.OrtSessionGetProfilingStartTimeNs(_nativeHandle,
                                                                     out startTime)); 
                 _profilingStartTimeNs = (ulong) startTime;
+
+                PinNames(_inputMetadata.Keys);
+                PinNames(_outputMetadata.Keys);
+                PinNames(_overridableInitializerMetadata.Keys);
             }
             catch (OnnxRuntimeException e)
             {
@@ -757,6 +893,17 @@ namespace Microsoft.ML.OnnxRuntime
             _builtInRunOptions = new RunOptions();  // create a default built-in run option, and avoid creating a new one every run() call  
         }
 
+        private void PinNames(IEnumerable<string> names)
+        {
+            foreach (var name in names)
+            {
+                if (!_pinnedNames.ContainsKey(name))
+                {
+                    var utf8Name = NativeOnnxValueHelper.StringToZeroTerminatedUtf8(name);
+                    _pinnedNames[name] = new PinnedGCHandle(GCHandle.Alloc(utf8Name, GCHandleType.Pinned));
+                }
+            }
+        }
 
         private string GetOutputName(ulong index)
         {
@@ -945,6 +1092,14 @@ namespace Microsoft.ML.OnnxRuntime
                 return;
             }
 
+            // cleanup unmanaged resources first, as releasing the session waits for the runs started with
+            // RunAsync, which may still use the built-in run options
+            if (_nativeHandle != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleaseSession(_nativeHandle);
+                _nativeHandle = IntPtr.Zero;
+            }
+
             if (disposing)
             {
                 // cleanup managed resources
@@ -961,12 +1116,13 @@ namespace Microsoft.ML.OnnxRuntime
                 }
             }
 
-            // cleanup unmanaged resources
-            if (_nativeHandle != IntPtr.Zero)
+            // the pinned names have no finalizer, so they are released on both paths to not leak the GC handles
+            foreach (var pinnedName in _pinnedNames.Values)
             {
-                NativeMethods.OrtReleaseSession(_nativeHandle);
-                _nativeHandle = IntPtr.Zero;
+                pinnedName.Dispose();
             }
+            _pinnedNames.Clear();
+
             _disposed = true;
         }
 
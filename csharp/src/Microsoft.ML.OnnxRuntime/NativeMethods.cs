@@ -182,6 +182,8 @@ namespace Microsoft.ML.OnnxRuntime
         public IntPtr SetGlobalInterOpNumThreads;
         public IntPtr SetGlobalSpinControl;
         public IntPtr AddInitializer;
+        public IntPtr CreateEnvWithCustomLoggerAndGlobalThreadPools;
+        public IntPtr RunAsync;
     }
 
     internal static class NativeMethods
@@ -212,6 +214,7 @@ namespace Microsoft.ML.OnnxRuntime
             OrtCreateSession = (DOrtCreateSession)Marshal.GetDelegateForFunctionPointer(api_.CreateSession, typeof(DOrtCreateSession));
             OrtCreateSessionFromArray = (DOrtCreateSessionFromArray)Marshal.GetDelegateForFunctionPointer(api_.CreateSessionFromArray, typeof(DOrtCreateSessionFromArray));
             OrtRun = (DOrtRun)Marshal.GetDelegateForFunctionPointer(api_.Run, typeof(DOrtRun));
+            OrtRunAsync = (DOrtRunAsync)Marshal.GetDelegateForFunctionPointer(api_.RunAsync, typeof(DOrtRunAsync));
             OrtRunWithBinding = (DOrtRunWithBinding)Marshal.GetDelegateForFunctionPointer(api_.RunWithBinding, typeof(DOrtRunWithBinding));
             OrtSessionGetInputCount = (DOrtSessionGetInputCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetInputCount, typeof(DOrtSessionGetInputCount));
             OrtSessionGetOutputCount = (DOrtSessionGetOutputCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetOutputCount, typeof(DOrtSessionGetOutputCount));
@@ -387,6 +390,27 @@ namespace Microsoft.ML.OnnxRuntime
                                                 );
         public static DOrtRun OrtRun;
 
+        public delegate void DOrtRunAsyncCallbackFn(
+                                                IntPtr /* void* */ userData,
+                                                IntPtr /* (OrtValue**) */ outputValues,
+                                                UIntPtr outputCount,
+                                                IntPtr /* (OrtStatus*) */ status // null on success, owned by the callback
+                                                );
+
+        public delegate IntPtr /*(ONNStatus*)*/ DOrtRunAsync(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                IntPtr[] inputNames,
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                IntPtr[] outputNames,
+                                                UIntPtr outputCount,
+                                                IntPtr /* (OrtValue**) */ outputValues, /* Must stay valid until the callback is invoked */
+                                                DOrtRunAsyncCallbackFn callback,
+                                                IntPtr /* void* */ userData
+                                                );
+        public static DOrtRunAsync OrtRunAsync;
+
         public delegate IntPtr /*(ONNStatus*)*/ DOrtRunWithBinding(
                                                 IntPtr /*(OrtSession*)*/ session,
                                                 IntPtr /*(OrtSessionRunOptions*)*/ runOptions, // can not be null
@@ -126,6 +126,18 @@ namespace Microsoft.ML.OnnxRuntime.Tensors
             typeInfoMap.TryGetValue(_primitiveType, out result);
             return result;
         }
+
+        /// <summary>
+        /// Queries the map for the given primitive type, returns result or null
+        /// </summary>
+        /// <param name="primitiveType">element type of a tensor</param>
+        /// <returns></returns>
+        public static TensorTypeInfo GetTypeInfo(Type primitiveType)
+        {
+            TensorTypeInfo result = null;
+            typeInfoMap.TryGetValue(primitiveType, out result);
+            return result;
+        }
     }
 
     /// <summary>
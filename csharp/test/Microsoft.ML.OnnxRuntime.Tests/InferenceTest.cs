@@ -334,6 +334,28 @@ namespace Microsoft.ML.OnnxRuntime.Tests
                     session.Run(inputNames, pinnedInputs, expectedOutputNames, pinnedOutputs);
                     validateRunResultData(outputTensor, expectedOutput, expectedDimensions);
                 }
+
+                // Run inference with memory backed inputs and outputs, reused across runs
+                {
+                    var inputNames = container.Select(i => i.Name).ToArray();
+                    var inputTensor = container[0].AsTensor<float>() as DenseTensor<float>;
+                    var inputShape = inputTensor.Dimensions.ToArray().Select(d => (long)d).ToArray();
+                    var outputMemory = new Memory<float>(new float[expectedOutput.Length]);
+                    using (FixedBufferOnnxValue pinnedInput = FixedBufferOnnxValue.CreateFromMemory(inputTensor.Buffer, inputShape),
+                                                pinnedOutput = FixedBufferOnnxValue.CreateFromMemory(outputMemory, new long[] { 1, 1000, 1, 1 }))
+                    {
+                        for (int i = 0; i < 2; ++i)
+                        {
+                            outputMemory.Span.Clear();
+                            session.Run(inputNames, new[] { pinnedInput }, expectedOutputNames, new[] { pinnedOutput });
+                            var outputTensor = new DenseTensor<float>(outputMemory, expectedOutputDimensions);
+                            validateRunResultData(outputTensor, expectedOutput, expectedDimensions);
+                        }
+                    }
+
+                    // the memory must hold the shape
+                    Assert.Throws<OnnxRuntimeException>(() => FixedBufferOnnxValue.CreateFromMemory(outputMemory, new long[] { 1, 1001 }));
+                }
             }
         }
 
@@ -409,6 +431,40 @@ namespace Microsoft.ML.OnnxRuntime.Tests
             Assert.True(startTime1 <= startTime2 && startTime2 <= startTime3);
         }
 
+        [Fact]
+        public void InferenceSessionRunAsync()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var options = new SessionOptions())
+            {
+                options.IntraOpNumThreads = 2;
+                using (var session = new InferenceSession(modelPath, options))
+                {
+                    var inputMeta = session.InputMetadata;
+                    var container = new List<NamedOnnxValue>();
+
+                    float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+
+                    foreach (var name in inputMeta.Keys)
+                    {
+                        var tensor = new DenseTensor<float>(inputData, inputMeta[name].Dimensions);
+                        container.Add(NamedOnnxValue.CreateFromTensor<float>(name, tensor));
+                    }
+
+                    var outputNames = session.OutputMetadata.Keys.ToList();
+                    using (var results = session.RunAsync(container, outputNames).Result)
+                    {
+                        validateRunResults(results);
+                    }
+
+                    // errors of the run are reported through the task
+                    var ex = Assert.Throws<AggregateException>(() => session.RunAsync(container, new List<string> { "wrong_name" }).Wait());
+                    Assert.IsType<OnnxRuntimeException>(ex.InnerException);
+                }
+            }
+        }
+
         private void validateRunResults(IReadOnlyCollection<NamedOnnxValue> results)
         {
             // validate the results
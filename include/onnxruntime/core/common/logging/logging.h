@@ -55,6 +55,12 @@ namespace profiling {
 enum EventCategory {
   SESSION_EVENT = 0,
   NODE_EVENT,
+  // work done by a thread of the intra-op thread pool for a parallel loop of a kernel
+  THREADPOOL_EVENT,
+  // copy between devices by the DataTransferManager
+  DATA_TRANSFER_EVENT,
+  // counter event with the memory use of the arenas. the args are the values of the counters.
+  MEMORY_EVENT,
   EVENT_CATEGORY_MAX
 };
 
@@ -63,7 +69,10 @@ Event descriptions for the above session events.
 */
 static constexpr const char* event_categor_names_[EVENT_CATEGORY_MAX] = {
     "Session",
-    "Node"};
+    "Node",
+    "ThreadPool",
+    "DataTransfer",
+    "Memory"};
 
 /*
 Timing record for all events.
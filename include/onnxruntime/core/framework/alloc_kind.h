@@ -27,7 +27,13 @@ enum class AllocKind {
   kPreExisting = 2,
   kAllocateStatically = 3,
   kAllocateOutput = 4,
-  kShare = 5
+  kShare = 5,
+  // graph output that is a view of the buffer of another value, e.g. the output of a Reshape. the view shares the
+  // ownership of the buffer so it stays valid after the Run.
+  kAlias = 6,
+  // value placed at a byte offset inside the buffer of another value: an input of a Concat inside the Concat output,
+  // or an output of a Split inside the Split input. the buffer is allocated with the first value placed in it.
+  kSlice = 7
 };
 
 std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind);
@@ -145,6 +145,26 @@ class CPUAllocator : public IAllocator {
   void Free(void* p) override;
 };
 
+/**
+   CPU allocator whose memory is placed on a given NUMA node.
+   The pages of each allocation are bound to the node before they are first touched, so an arena on top of it
+   keeps its chunks local to the threads pinned to that node. If the platform can't bind memory, placement falls
+   back to the default policy.
+*/
+class NumaCPUAllocator : public IAllocator {
+ public:
+  explicit NumaCPUAllocator(int numa_node)
+      : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)), numa_node_(numa_node) {}
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  int NumaNode() const { return numa_node_; }
+
+ private:
+  const int numa_node_;
+};
+
 #if defined(USE_MIMALLOC_ARENA_ALLOCATOR)
 class MiMallocAllocator : public IAllocator {
  public:
@@ -142,6 +142,19 @@ class IExecutionProvider {
   */
   virtual common::Status Sync() const;
 
+  /**
+     Indicate whether the work the provider submits from different threads can run concurrently on the device,
+     e.g. CUDA kernels launched on the per-thread default stream of each thread.
+     With the parallel execution mode the planner then adds fences to the values passed between threads.
+  */
+  virtual bool UsesPerThreadStreams() const { return false; }
+
+  /**
+     Blocks until the device has completed the tasks requested by the calling thread.
+     Only differs from Sync if UsesPerThreadStreams returns true.
+  */
+  virtual common::Status SyncCurrentThread() const { return Sync(); }
+
   /**
      Called when InferenceSession::Run started
      NOTE that due to async execution in provider, the actual work of previous
@@ -165,6 +178,36 @@ class IExecutionProvider {
   */
   virtual common::Status OnSessionInitializationEnd();
 
+  /**
+     Indicate whether the provider can capture the device work submitted during a Run (e.g. into a CUDA graph)
+     and replay it on later Runs instead of re-launching every kernel.
+  */
+  virtual bool IsGraphCaptureEnabled() const { return false; }
+
+  /**
+     Indicate whether a graph has been captured for <graph_key>.
+     The key is computed by InferenceSession::Run from the shapes and buffer addresses of the feeds and fetches,
+     as a captured graph is only valid for the exact buffers it was recorded with.
+  */
+  virtual bool IsGraphCaptured(uint64_t /*graph_key*/) const { return false; }
+
+  /**
+     Called between OnRunStart and graph execution to start capturing the work of the current Run for <graph_key>.
+  */
+  virtual common::Status BeginGraphCapture(uint64_t graph_key);
+
+  /**
+     Called after graph execution to finish the capture started by BeginGraphCapture. As the captured work is
+     only recorded and not executed, the provider must launch the graph once before returning.
+     If <discard> is true the Run failed, and the partially captured graph must be dropped without launching it.
+  */
+  virtual common::Status EndGraphCapture(uint64_t graph_key, bool discard);
+
+  /**
+     Launch the graph previously captured for <graph_key>.
+  */
+  virtual common::Status ReplayGraph(uint64_t graph_key);
+
   void InsertAllocator(AllocatorPtr allocator);
   void ReplaceAllocator(AllocatorPtr allocator);
 
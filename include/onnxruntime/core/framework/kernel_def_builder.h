@@ -86,6 +86,10 @@ class KernelDef {
     return exec_queue_id_;
   }
 
+  bool IsTrivial() const {
+    return is_trivial_;
+  }
+
   bool IsConflict(const KernelDef& other) const;
 
   uint64_t GetHash() const noexcept {
@@ -135,6 +139,10 @@ class KernelDef {
 
   // execution command queue id, 0 for default queue in execution provider
   int exec_queue_id_ = 0;
+
+  // the kernel costs too little to be worth scheduling on another thread.
+  // not part of the hash as it doesn't affect which kernel is selected.
+  bool is_trivial_ = false;
   // Default memory type for all inputs
   OrtMemType default_inputs_mem_type_{OrtMemTypeDefault};
   // Default memory type for all outputs
@@ -277,6 +285,15 @@ class KernelDefBuilder {
     return *this;
   }
 
+  /**
+     Specify that the kernel does a trivial amount of work, e.g. it only changes the shape of an aliased input.
+     The ParallelExecutor runs trivial kernels on the thread that made them ready instead of scheduling them.
+  */
+  KernelDefBuilder& Trivial(bool is_trivial = true) {
+    kernel_def_->is_trivial_ = is_trivial;
+    return *this;
+  }
+
   /**
   Specify the default inputs memory type, if not specified, it is DefaultMemory
   */
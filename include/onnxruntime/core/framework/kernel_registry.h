@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <unordered_map>
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 /**
@@ -51,6 +53,9 @@ class KernelRegistry {
 
   bool IsEmpty() const { return kernel_creator_fn_map_.empty(); }
 
+  // Non-copyable/movable as the lookup indexes point into kernel_creator_fn_map_.
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelRegistry);
+
 #ifdef onnxruntime_PYBIND_EXPORT_OPSCHEMA
   // This is used by the opkernel doc generator to enlist all registered operators for a given provider's opkernel
   const KernelCreateMap& GetKernelCreateMap() const {
@@ -77,6 +82,10 @@ class KernelRegistry {
   static bool VerifyKernelDef(const onnxruntime::Node& node,
                               const KernelDef& kernel_def,
                               std::string& error_str);
+
+  // Key of the kernel matching result of a node: the map key of the node plus everything VerifyKernelDef looks at,
+  // i.e. the since version of the node and the types of its actual inputs and outputs.
+  static std::string GetNodeSignatureKey(const onnxruntime::Node& node, const std::string& provider);
 #endif
 
   static std::string GetMapKey(const std::string& op_name, const std::string& domain, const std::string& provider) {
@@ -91,5 +100,16 @@ class KernelRegistry {
   // Kernel create function map from op name to kernel creation info.
   // key is opname+domain_name+provider_name
   KernelCreateMap kernel_creator_fn_map_;
+
+  // Index of the entries of kernel_creator_fn_map_ by their kernel def hash, used when loading an ORT format model.
+  std::unordered_map<uint64_t, const KernelCreateInfo*> kernel_def_hash_lookup_;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Cache of the successful VerifyKernelDef matches by node signature (see GetNodeSignatureKey) so the nodes of a
+  // model that share an op, opset and type signature are matched once. Registries such as the CPU one are shared
+  // between sessions that may be created concurrently, hence the mutex.
+  mutable std::unordered_map<std::string, const KernelCreateInfo*> node_signature_lookup_;
+  mutable OrtMutex node_signature_lookup_mutex_;
+#endif
 };
 }  // namespace onnxruntime
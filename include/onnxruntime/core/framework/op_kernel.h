@@ -13,6 +13,7 @@
 #include "core/framework/ml_value.h"
 #include "core/framework/op_kernel_info.h"
 #include "core/framework/op_node_proto_helper.h"
+#include "core/framework/prepacked_weights.h"
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 #include "core/graph/constants.h"
@@ -70,6 +71,32 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function together with UseSharedPrePackedBuffers to allow sessions loading the same model to
+  // share one copy of the packed data (see the session.share_env_prepacked_weights session config).
+  // @param alloc: The allocator the packed buffers must be allocated with.
+  // @param prepacked_weights: The kernel moves the packed buffers into this instead of keeping them. They will be
+  //                           handed back to it, and to other kernel instances, through UseSharedPrePackedBuffers.
+  //                           The default implementation packs privately via PrePack and leaves this empty.
+  virtual Status PrePackWithSharing(const Tensor& tensor, int input_idx, AllocatorPtr /*alloc*/, bool& is_packed,
+                                    PrePackedWeights& /*prepacked_weights*/) {
+    return PrePack(tensor, input_idx, is_packed);
+  }
+
+  // Use buffers produced by PrePackWithSharing for the same kernel and initializer instead of packing.
+  // The buffers are not owned by the kernel and remain valid for its lifetime.
+  // @param tensor: The initialized constant tensor the buffers were packed from
+  // @param used_shared_buffers: Set it to true if the kernel uses the buffers. Same semantics as is_packed in PrePack.
+  virtual Status UseSharedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                           const PrePackedWeights& /*prepacked_weights*/,
+                                           bool& used_shared_buffers) {
+    used_shared_buffers = false;
+    return Status::OK();
+  }
+
+  // Bytes of the buffers the kernel owns from pre-packing its constant initializers, for the memory report of the
+  // session. The buffers of a shared container used through UseSharedPrePackedBuffers are not included.
+  virtual size_t PrePackedBytes() const { return 0; }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetMemoryInfo(id, mem_type);
   }
@@ -183,6 +210,8 @@ class OpKernelContext {
 
   /**
    Return an allocator on device 0, with memtype of OrtMemTypeDefault.
+   The memory may come from the scratch region of the execution frame, so it must be freed before Compute returns.
+   Buffers that outlive the node, e.g. the tensors of an output sequence, must use the kernel's allocator.
    @remarks Use SafeInt when calculating the size of memory to allocate using AllocatorPtr->Alloc.
    */
   Status GetTempSpaceAllocator(AllocatorPtr* output) const ORT_MUST_USE_RESULT;
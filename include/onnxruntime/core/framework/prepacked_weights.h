@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+// The buffers a kernel produced by pre-packing one of its constant initializers, in a form that can be owned by
+// someone other than the kernel (see OpKernel::PrePackWithSharing) so they can be shared by multiple kernel instances.
+struct PrePackedWeights final {
+  // Some kernels pack a weight into several buffers (e.g. one per gate), so there can be more than one.
+  std::vector<BufferUniquePtr> buffers_;
+  // Size in bytes of each entry in buffers_.
+  std::vector<size_t> buffer_sizes_;
+};
+
+}  // namespace onnxruntime
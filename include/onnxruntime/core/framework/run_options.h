@@ -26,6 +26,23 @@ struct OrtRunOptions {
   // So it is possible that only some of the nodes are executed.
   bool only_execute_path_to_fetches = false;
 
+  // Identifies a stream of Run() calls, such as the frames of an utterance fed one at a time. Kernels that support
+  // streaming (the CPU LSTM and GRU in the forward direction) keep their final state between the calls with the same
+  // id and start the next call from it instead of from their initial state inputs.
+  // Empty (the default) runs without state. A stream must not be used by several Run() calls at the same time.
+  std::string stream_id;
+
+  // Set to 'true' for the last Run() call of the stream so the kernels release its state after the call.
+  bool end_of_stream = false;
+
+  // Limits the number of threads the parallel loops of the Run use from the intra-op thread pool, including the
+  // thread that runs the loop. 0 (the default) uses all the threads of the pool.
+  int intra_op_max_degree_of_parallelism = 0;
+
+  // 0 (the default) for normal priority, negative for low priority. While a normal priority Run uses the intra-op
+  // thread pool, the parallel loops of the low priority Runs only use the thread that runs them.
+  int priority = 0;
+
 #ifdef ENABLE_TRAINING
   // Set to 'true' to run in training mode.
   bool training_mode = true;
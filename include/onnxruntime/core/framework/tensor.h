@@ -71,6 +71,16 @@ class Tensor final {
   Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, const OrtMemoryInfo& alloc,
          ptrdiff_t offset = 0);
 
+  /**
+   * Create tensor with given type, shape and pre-allocated memory that the tensor takes ownership of.
+   * \param data A preallocated buffer. Can be NULL if the shape is empty.
+   * \param deleter Allocator used to free the buffer when the tensor is destroyed. Its Info() is the location.
+   *                For string tensors the strings are constructed in the buffer.
+   * \param offset Offset in bytes to start of Tensor within p_data.
+   */
+  Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, std::shared_ptr<IAllocator> deleter,
+         ptrdiff_t offset = 0);
+
   /**
    * Deprecated. The orginal design is this Tensor class won't do any allocation / release.
    * However, this function will allocate the buffer for the shape, and do placement new if p_type is string tensor.
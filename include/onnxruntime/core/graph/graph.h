@@ -41,6 +41,9 @@ struct Graph;
 struct Node;
 struct NodeEdge;
 }  // namespace fbs
+namespace utils {
+struct OrtFormatLoadOptions;
+}  // namespace utils
 }  // namespace experimental
 
 /**
@@ -333,7 +336,10 @@ class Node {
   bool ClearAttribute(const std::string& attr_name);
 
   /** Gets the Node's mutable attributes. */
-  NodeAttributes& GetMutableAttributes() noexcept { return attributes_; }
+  NodeAttributes& GetMutableAttributes() noexcept {
+    inferred_types_key_.clear();
+    return attributes_;
+  }
 
   /** Gets the Graph instance that is instantiated from a GraphProto attribute during Graph::Resolve.
   @param attr_name Attribute name for the GraphProto attribute.
@@ -555,6 +561,10 @@ class Node {
   // This allows attribute adding and removing.
   NodeAttributes attributes_;
 
+  // The types of the inputs and outputs after the last type/shape inferencing of the node, which Resolve skips while
+  // they are unchanged. Cleared when the attributes change.
+  std::string inferred_types_key_;
+
   // Graph that contains this Node
   Graph* graph_;
 
@@ -618,6 +628,14 @@ class Graph {
   /** Removes all initializer tensors from this Graph and releases the memory they were using. */
   void CleanAllInitializedTensors() noexcept;
 
+  /** Moves the raw data of an initializer tensor out of its TensorProto, which is left without data, so a tensor can
+  be created on the data without a copy. Only for the initializers that are removed from the Graph afterwards.
+  Can be called for different initializers concurrently.
+  @param[out] raw_data Set to the raw data, swapped with the raw data of the TensorProto.
+  @returns True if found.
+  */
+  bool ReleaseInitializedTensorRawData(const std::string& tensor_name, std::string& raw_data);
+
   /** Returns true if an initializer value can be overridden by a graph input with the same name. */
   bool CanOverrideInitializer() const noexcept { return ir_version_ >= 4; }
 
@@ -1054,7 +1072,8 @@ class Graph {
   static common::Status LoadFromOrtFormat(
       const onnxruntime::experimental::fbs::Graph& fbs_graph, const Model& owning_model,
       const std::unordered_map<std::string, int>& domain_to_version,
-      const logging::Logger& logger, std::unique_ptr<Graph>& graph);
+      const logging::Logger& logger, std::unique_ptr<Graph>& graph,
+      const onnxruntime::experimental::utils::OrtFormatLoadOptions* load_options = nullptr);
 
   // deserialize a subgraph
   static Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs_graph,
@@ -1078,7 +1097,8 @@ class Graph {
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
   // Populate Graph instance from ORT format serialized data.
-  common::Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs_graph);
+  common::Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs_graph,
+                                   const onnxruntime::experimental::utils::OrtFormatLoadOptions* load_options);
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -1194,6 +1214,12 @@ class Graph {
   // information matches between node and op.
   common::Status VerifyNodeAndOpMatch(const ResolveOptions& options);
 
+  // The key of the types of the inputs and outputs of the node that its last type/shape inferencing is valid for.
+  std::string InferredTypesKey(const Node& node) const;
+
+  // Whether an input of the node is an initializer added, replaced or removed since the last Resolve.
+  bool ConsumesChangedInitializer(const Node& node) const;
+
   // Set graph inputs/outputs when resolving a graph..
   common::Status SetGraphInputsOutputs();
 
@@ -1266,6 +1292,11 @@ class Graph {
 
   InitializedTensorSet name_to_initial_tensor_;
 
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+  // Only set while the Graph is being loaded from ORT format, so subgraphs loaded as part of it can use it.
+  const onnxruntime::experimental::utils::OrtFormatLoadOptions* ort_format_load_options_ = nullptr;
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD)
 
   IOnnxRuntimeOpSchemaCollectionPtr schema_registry_;
@@ -1357,6 +1388,10 @@ class Graph {
   // number of times Resolve has run.
   int num_resolves_ = 0;
 
+  // names of the initializers added, replaced or removed since the last Resolve. the type/shape inferencing of the
+  // nodes consuming them is not skipped as it may depend on the initializer data.
+  std::unordered_set<std::string> initializers_changed_since_resolve_;
+
   const logging::Logger& logger_;
 
   // distinguishes between graph loaded from model file and graph created from scratch
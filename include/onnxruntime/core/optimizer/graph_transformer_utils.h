@@ -12,6 +12,9 @@
 namespace onnxruntime {
 struct FreeDimensionOverride;
 class IExecutionProvider;
+namespace concurrency {
+class ThreadPool;
+}
 
 namespace optimizer_utils {
 
@@ -23,11 +26,13 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
 
 /** Generates all predefined (both rule-based and non-rule-based) transformers for this level.
     If transformers_and_rules_to_enable is not empty, it returns the intersection between the predefined transformers/rules 
-    and the transformers_and_rules_to_enable. */
+    and the transformers_and_rules_to_enable.
+    intra_op_thread_pool is used by constant folding to compute independent nodes in parallel. */
 std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerLevel level,
                                                                     gsl::span<const FreeDimensionOverride> free_dimension_overrides,
                                                                     const IExecutionProvider& execution_provider /*required by constant folding*/,
-                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {});
+                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {},
+                                                                    concurrency::ThreadPool* intra_op_thread_pool = nullptr);
 
 /** Given a TransformerLevel, this method generates a name for the rule-based graph transformer of that level. */
 std::string GenerateRuleBasedTransformerName(TransformerLevel level);
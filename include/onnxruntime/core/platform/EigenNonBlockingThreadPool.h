@@ -9,6 +9,8 @@
 
 /* Modifications Copyright (c) Microsoft. */
 
+#include <algorithm>
+#include <chrono>
 #include <type_traits>
 
 #pragma once
@@ -36,6 +38,7 @@
 #include "core/common/make_unique.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -406,6 +409,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       : env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(allow_spinning && thread_options.adaptive_spinning),
+        max_spin_ns_(static_cast<uint64_t>(thread_options.max_spin_duration_us) * 1000),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
@@ -561,6 +566,10 @@ void RunInParallel(std::function<void()> fn, unsigned n) override {
     std::vector<std::pair<int, unsigned>> pending_items;
     Barrier b(n, allow_spinning_);
 
+    if (adaptive_spinning_) {
+      NoteParallelSection();
+    }
+
     my_pt->in_parallel = true;
     if (!my_pt->tag.Get()) {
       my_pt->tag = Tag::GetNext();
@@ -644,6 +653,16 @@ int NumThreads() const EIGEN_FINAL {
   return num_threads_;
 }
 
+onnxruntime::concurrency::ThreadPoolStats GetStats() const {
+  onnxruntime::concurrency::ThreadPoolStats stats;
+  for (const auto& td : worker_data_) {
+    stats.num_steals += td.num_steals.load(std::memory_order_relaxed);
+    stats.num_spins += td.num_spins.load(std::memory_order_relaxed);
+    stats.num_parks += td.num_parks.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
 int CurrentThreadId() const EIGEN_FINAL {
   const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
   if (pt->pool == this) {
@@ -794,15 +813,27 @@ int CurrentThreadId() const EIGEN_FINAL {
       status = ThreadStatus::Spinning;
     }
 
+    // Scheduling counters, written only by the thread itself and read by GetStats.
+    std::atomic<uint64_t> num_steals{0};
+    std::atomic<uint64_t> num_spins{0};
+    std::atomic<uint64_t> num_parks{0};
+
   private:
     std::atomic<ThreadStatus> status{ThreadStatus::Spinning};
     OrtMutex mutex;
     OrtCondVar cv;
   };
 
+  // Single-writer increment, avoiding a locked read-modify-write on the worker's hot path.
+  static void IncrementCounter(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
   Environment& env_;
   const int num_threads_;
   const bool allow_spinning_;
+  const bool adaptive_spinning_;
+  const uint64_t max_spin_ns_;
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
@@ -820,6 +851,45 @@ int CurrentThreadId() const EIGEN_FINAL {
   int num_hint_words_;
   std::unique_ptr<std::atomic<uint64_t>[]> good_worker_hints_;
 
+  // Adaptive spinning state: the start time of the most recent parallel section, and a moving average of
+  // the interval between sections.  Both are updated by the threads entering RunInParallel without further
+  // synchronization; a lost update only perturbs the estimate.
+  std::atomic<uint64_t> last_parallel_section_ns_{0};
+  std::atomic<uint64_t> parallel_section_interval_ns_{0};
+
+  static uint64_t NowNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+  }
+
+  void NoteParallelSection() {
+    uint64_t now = NowNanos();
+    uint64_t prev = last_parallel_section_ns_.exchange(now, std::memory_order_relaxed);
+    if (prev != 0 && now > prev) {
+      uint64_t interval = now - prev;
+      uint64_t avg = parallel_section_interval_ns_.load(std::memory_order_relaxed);
+      // Exponential moving average with weight 1/8 for the newest sample
+      avg = (avg == 0) ? interval : avg - avg / 8 + interval / 8;
+      parallel_section_interval_ns_.store(avg, std::memory_order_relaxed);
+    }
+  }
+
+  // How long an idle worker should spin before parking.  If parallel sections have recently been arriving
+  // more often than max_spin_ns_ then spinning for about twice the typical interval is likely to catch the
+  // next one without an OS wake-up.  Otherwise it will most likely park anyway, so only spin briefly to
+  // cover work that the current section may still hand out, and yield the CPU to other processes.
+  uint64_t SpinWindowNanos() const {
+    const uint64_t min_spin_ns = max_spin_ns_ / 16;
+    uint64_t interval = parallel_section_interval_ns_.load(std::memory_order_relaxed);
+    uint64_t last = last_parallel_section_ns_.load(std::memory_order_relaxed);
+    uint64_t now = NowNanos();
+    if (interval == 0 || interval > max_spin_ns_ || (now > last && now - last > max_spin_ns_)) {
+      return min_spin_ns;
+    }
+    return std::max(min_spin_ns, std::min(max_spin_ns_, 2 * interval));
+  }
+
   // Wake any blocked workers so that they can cleanly exit WorkerLoop().  For an
   // abrupt exit, cancelled_==true and threads will exit their worker loops.  For
   // a clean exit, each thread will observe (1) done_ set, indicating that the
@@ -848,6 +918,9 @@ int CurrentThreadId() const EIGEN_FINAL {
     const int log2_spin = 20;
     const int spin_count = allow_spinning_ ? (1ull<<log2_spin) : 0;
     const int steal_count = spin_count/100;
+    // With adaptive spinning the spin loop is bounded by time rather than by spin_count alone;
+    // the clock is sampled every clock_check_count iterations.
+    const int clock_check_count = 1024;
 
     SetDenormalAsZero(set_denormal_as_zero_);
 
@@ -859,9 +932,16 @@ int CurrentThreadId() const EIGEN_FINAL {
           // In addition, priodically make a best-effort attempt to steal from other
           // threads which are not themselves spinning.
 
+          if (spin_count > 0) {
+            IncrementCounter(td.num_spins);
+          }
           SetGoodWorkerHint(thread_id, true);
+          const uint64_t spin_deadline_ns = adaptive_spinning_ ? NowNanos() + SpinWindowNanos() : 0;
           for (int i = 0; i < spin_count && !t.f && !cancelled_ && !done_; i++) {
             t = (i%steal_count == 0) ? TrySteal() : q.PopFront();
+            if (adaptive_spinning_ && i % clock_check_count == 0 && NowNanos() >= spin_deadline_ns) {
+              break;
+            }
           }
           SetGoodWorkerHint(thread_id, false);
 
@@ -910,6 +990,9 @@ int CurrentThreadId() const EIGEN_FINAL {
                         }
                       }
                     }
+                    if (should_block) {
+                      IncrementCounter(td.num_parks);
+                    }
                     return should_block;
                   },
                   // Post-block update (executed only if we blocked)
@@ -960,6 +1043,9 @@ int CurrentThreadId() const EIGEN_FINAL {
             worker_data_[victim].GetStatus() == WorkerData::ThreadStatus::Active) {
           Task t = worker_data_[victim].queue.PopBack();
           if (t.f) {
+            if (pt->pool == this && static_cast<int>(victim) != pt->thread_id) {
+              IncrementCounter(worker_data_[pt->thread_id].num_steals);
+            }
             return t;
           }
         }
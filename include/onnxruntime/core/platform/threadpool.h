@@ -16,6 +16,7 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 #include <functional>
@@ -45,11 +46,111 @@ struct TensorOpCost {
 template <typename Environment>
 class ThreadPoolTempl;
 
+namespace profiling {
+class Profiler;
+}  // namespace profiling
+
 namespace concurrency {
 
 class ExtendedThreadPoolInterface;
 class LoopCounter;
 
+// Scheduling counters of a thread pool, accumulated over its worker threads since the pool was created.
+// The counters are updated without synchronization with the reader, so a snapshot taken while work is
+// running may be slightly behind.
+struct ThreadPoolStats {
+  // Number of work items a worker took from another worker's queue.
+  uint64_t num_steals = 0;
+  // Number of times a worker ran out of work and started spinning.
+  uint64_t num_spins = 0;
+  // Number of times a worker parked (blocked on its condition variable) after spinning without finding work.
+  uint64_t num_parks = 0;
+};
+
+// While an instance is alive, each thread that runs a part of a parallel loop started from the creating thread
+// records a "ThreadPool" profiler event named <event_name> spanning the iterations it ran, so the trace shows how the
+// work of a kernel is spread over the threads. The executors create one around the Compute of a kernel while profiling
+// is enabled. Loops that the OpenMP build runs with OpenMP are not recorded.
+class ThreadPoolProfilingScope {
+ public:
+  ThreadPoolProfilingScope(profiling::Profiler& profiler, const std::string& event_name);
+  ~ThreadPoolProfilingScope();
+
+  // Profiler and event name set for the calling thread, or nullptr if there is no active scope.
+  static profiling::Profiler* CurrentProfiler();
+  static const std::string* CurrentEventName();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolProfilingScope);
+
+  profiling::Profiler* previous_profiler_;
+  const std::string* previous_event_name_;
+};
+
+// While an instance is alive, the degree of parallelism of the thread pools seen by the creating thread is at most
+// max_degree_of_parallelism, so the parallel loops it starts use fewer threads. The parallel executor uses it to share
+// the intra-op threads between the nodes it runs concurrently. Has no effect in the OpenMP build.
+class ThreadPoolParallelismLimitScope {
+ public:
+  explicit ThreadPoolParallelismLimitScope(int max_degree_of_parallelism);
+  ~ThreadPoolParallelismLimitScope();
+
+  // Returns the limit set on the calling thread, or 0 if there is none.
+  static int CurrentMaxDegreeOfParallelism();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolParallelismLimitScope);
+
+  int previous_max_degree_of_parallelism_;
+};
+
+class ThreadPool;
+
+// While an instance is alive, the parallel loops started by the creating thread belong to a normal or a low priority
+// Run. While a normal priority Run is using the intra-op thread pool tp, the parallel loops of the low priority Runs
+// on tp only use the thread that starts them, leaving the threads of the pool to the normal priority Run. Each Run
+// creates one instance with its tp on its calling thread; the threads that execute nodes on behalf of the Run create
+// theirs with a null tp, which only sets the priority of the thread. Has no effect in the OpenMP build.
+class ThreadPoolRunPriorityScope {
+ public:
+  ThreadPoolRunPriorityScope(ThreadPool* tp, bool low_priority);
+  ~ThreadPoolRunPriorityScope();
+
+  // Returns whether the calling thread is executing a low priority Run.
+  static bool CurrentIsLowPriority();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolRunPriorityScope);
+
+  ThreadPool* tp_;
+  bool low_priority_;
+  bool previous_low_priority_;
+};
+
+// While an instance is alive, the parallel loops started by the creating thread belong to a Run with the given
+// weight. While several Runs with a weight are using the intra-op thread pool tp, e.g. the Runs of sessions sharing
+// the global thread pools, the parallel loops of each Run use a share of the threads of tp proportional to its
+// weight, and the threads helping with a loop leave it between blocks of iterations when the share of its Run
+// shrinks. This way the large loops of one session can't hold all the threads of a shared pool while the Runs of other
+// sessions wait for them. Each Run creates one instance with its tp on its calling thread; the threads that execute
+// nodes on behalf of the Run create theirs with a null tp, which only sets the weight of the thread. A weight of 0
+// opts the Run out. Has no effect in the OpenMP build.
+class ThreadPoolRunWeightScope {
+ public:
+  ThreadPoolRunWeightScope(ThreadPool* tp, int weight);
+  ~ThreadPoolRunWeightScope();
+
+  // Returns the weight set on the calling thread, or 0 if there is none.
+  static int CurrentWeight();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolRunWeightScope);
+
+  ThreadPool* tp_;
+  int weight_;
+  int previous_weight_;
+};
+
 class ThreadPool {
  public:
 #ifdef _WIN32
@@ -83,6 +184,9 @@ class ThreadPool {
   // reasons such as if queues used for buffering work are full.
   void Schedule(std::function<void()> fn);
 
+  // Returns the scheduling counters of the pool. All counters are 0 if the pool has no threads.
+  ThreadPoolStats GetStats() const;
+
   // Returns the number of shards used by ParallelForFixedBlockSizeScheduling
   // with these parameters.
   int NumShardsUsedByFixedBlockSizeScheduling(std::ptrdiff_t total,
@@ -229,6 +333,8 @@ class ThreadPool {
 
  private:
   friend class LoopCounter;
+  friend class ThreadPoolRunPriorityScope;
+  friend class ThreadPoolRunWeightScope;
 
   // Returns the number of threads created in the pool.  This may be different from the
   // value returned by DegreeOfParallelism to code using the pool.
@@ -262,6 +368,9 @@ class ThreadPool {
   bool ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
                              const std::ptrdiff_t block_size = 1) const;
 
+  // Returns the share of degree_of_parallelism of a Run with the given weight, see ThreadPoolRunWeightScope.
+  int WeightedDegreeOfParallelism(int degree_of_parallelism, int weight) const;
+
   ThreadOptions thread_options_;
 
   // If a thread pool is created with degree_of_parallelism != 1 then an underlying
@@ -272,6 +381,12 @@ class ThreadPool {
 
   // If used, underlying_threadpool_ is instantiated and owned by the ThreadPool.
   std::unique_ptr<ThreadPoolTempl<Env> > extended_eigen_threadpool_;
+
+  // The number of normal priority Runs using the pool, see ThreadPoolRunPriorityScope.
+  std::atomic<int> num_normal_priority_runs_{0};
+
+  // The sum of the weights of the Runs using the pool, see ThreadPoolRunWeightScope.
+  std::atomic<int> total_run_weight_{0};
 };
 
 }  // namespace concurrency
@@ -2,14 +2,38 @@
 
 #include "onnxruntime_c_api.h"
 
+// Flags of OrtSessionOptionsAppendExecutionProvider_NnapiWithOptions, which can be combined with bitwise or
+enum NNAPIFlags {
+  NNAPI_FLAG_USE_NONE = 0x000,
+
+  // The NNAPI execution preference, the default is ANEURALNETWORKS_PREFER_FAST_SINGLE_ANSWER.
+  // Set at most one of these.
+  // ANEURALNETWORKS_PREFER_SUSTAINED_SPEED, for successive runs such as the frames of a camera
+  NNAPI_FLAG_PREFER_SUSTAINED_SPEED = 0x001,
+  // ANEURALNETWORKS_PREFER_LOW_POWER, to save the battery
+  NNAPI_FLAG_PREFER_LOW_POWER = 0x002,
+
+  // Compiles the subgraphs with dynamic input shapes once more for each set of input shapes they are run with, the
+  // first time they are run with it. The NNAPI drivers often can't run a model with dynamic shapes on their
+  // accelerator and fall back to their CPU implementation. Only the first 8 sets of input shapes of a subgraph are
+  // compiled, it runs the other ones with the model compiled for the dynamic shapes.
+  NNAPI_FLAG_COMPILE_PER_INPUT_SHAPES = 0x004,
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSessionOptions* options);
 
+/**
+ * \param nnapi_flags combination of NNAPIFlags
+ * \param cache_dir directory for the compilation cache of the NNAPI drivers, which makes the compilation of a model
+ *        that was compiled before much faster. Requires Android API level 29+. nullptr or "" disables the cache.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_NnapiWithOptions, _In_ OrtSessionOptions* options,
+               uint32_t nnapi_flags, _In_opt_ const char* cache_dir);
+
 #ifdef __cplusplus
 }
 #endif
-
-
@@ -10,6 +10,7 @@
 #include "core/platform/threadpool.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/prepacked_weights_container.h"
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
@@ -68,6 +69,14 @@ class Environment {
     return shared_allocators_;
   }
 
+  /**
+   * Returns the container for pre-packed weights shared between the sessions using this env.
+   * The container is thread-safe to use while holding its mutex.
+  */
+  PrepackedWeightsContainer& GetPrepackedWeightsContainer() const {
+    return *prepacked_weights_container_;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -81,5 +90,7 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  std::unique_ptr<PrepackedWeightsContainer> prepacked_weights_container_ =
+      onnxruntime::make_unique<PrepackedWeightsContainer>();
 };
 }  // namespace onnxruntime
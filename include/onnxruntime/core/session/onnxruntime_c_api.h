@@ -210,6 +210,13 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+// Invoked by RunAsync once the Run has completed, on the thread that executed it.
+// outputs is the output array passed to RunAsync. On success, the entries that were null are set to the new outputs,
+// which are owned by the caller, and status is null. On failure, status describes the error and must be released
+// with ReleaseStatus.
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(
+    void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status);
+
 // Set Graph optimization level.
 // Refer https://github.com/microsoft/onnxruntime/blob/master/docs/ONNX_Runtime_Graph_Optimizations.md
 // for in-depth undersrtanding of Graph Optimizations in ORT
@@ -1090,6 +1097,21 @@ struct OrtApi {
   ORT_API2_STATUS(CreateEnvWithCustomLoggerAndGlobalThreadPools, OrtLoggingFunction logging_function, _In_opt_ void* logger_param, OrtLoggingLevel logging_level,
                   _In_ const char* logid, _In_ const struct OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out);
 
+  /**
+   * Run the model without blocking the calling thread. The Run is executed on the intra-op thread pool of the
+   * session, which must have at least one thread, and run_async_callback is invoked with user_data once it
+   * has completed. The arguments are the same as for Run.
+   * Unlike the inputs and names, which are copied, 'output' and 'run_options' must stay valid until run_async_callback
+   * has been invoked. Releasing the session blocks until the outstanding Runs have completed.
+   * If an error is returned run_async_callback is not invoked.
+   */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output,
+                  _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+
 #ifdef USE_CUDA
   /**
    * Append CUDA execution provider
@@ -1105,6 +1127,63 @@ struct OrtApi {
    * and that's recommended because turning this option on may hurt model accuracy.
    */
   ORT_API2_STATUS(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* tp_options);
+
+  /**
+   * Sets the stream the Runs using these options belong to. Kernels that support streaming (the CPU LSTM and GRU in
+   * the forward direction) keep their final state between the Runs of a stream and start the next Run from it.
+   * \param stream_id identifies the stream. null or empty runs without state, which is the default.
+   * \param end_of_stream set to non-zero for the last Run of the stream, so its state is released after the Run.
+   */
+  ORT_API2_STATUS(RunOptionsSetStream, _Inout_ OrtRunOptions* options, _In_opt_ const char* stream_id,
+                  int end_of_stream);
+
+  /**
+   * Returns the latency statistics of the sampling profiler, which is enabled with the
+   * "session.profiling_sample_rate" session config entry. Returns an error if it is not enabled.
+   * \param out is a null terminated JSON document with the count and the mean, p50, p90, p99 and max kernel
+   *  execution time in microseconds of each node and op type that was executed in the sampled Runs.
+   *  It is allocated with allocator and should be freed with it.
+   */
+  ORT_API2_STATUS(SessionGetProfilingStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Returns the bytes in use of the arena allocators of the execution providers of the session.
+   * \param out is a null terminated JSON document such as
+   *  {"arenas":[{"provider":"CPUExecutionProvider","device":"Cpu","deviceId":0,"bytesInUse":1048576}]}.
+   *  It is allocated with allocator and should be freed with it.
+   */
+  ORT_API2_STATUS(SessionGetArenaStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Returns where the memory of the session goes, to size the hosts models are deployed to. When profiling is
+   * enabled the report is also written next to the profile, with a _memory.json suffix.
+   * \param out is a null terminated JSON document with
+   *  "initializers": the count and bytes of the initializers by provider and device,
+   *  "prePacked": the bytes of the pre-packed weights of each node, owned by its kernel or shared between sessions,
+   *  "plannedActivations": the peak bytes per device of the memory pattern planned for each input shape signature,
+   *  "nodes": the planned bytes of the outputs of each node, for the signature with the largest peak,
+   *  "arenas": the bytes in use, peak bytes in use and bytes reserved of the arenas of the execution providers.
+   *  It is allocated with allocator and should be freed with it.
+   */
+  ORT_API2_STATUS(SessionGetMemoryReport, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Limits the number of threads the parallel loops of the Runs using these options use from the intra-op thread
+   * pool of the session, including the thread that runs the loop. This lets concurrent Runs share the pool.
+   * \param value the maximum degree of parallelism. 0, the default, uses all the threads of the pool.
+   */
+  ORT_API2_STATUS(RunOptionsSetIntraOpMaxDegreeOfParallelism, _Inout_ OrtRunOptions* options, int value);
+
+  /**
+   * Sets the priority of the Runs using these options. While a normal priority Run uses the intra-op thread pool of
+   * the session, the parallel loops of the low priority Runs only use the thread that runs them.
+   * \param value 0, the default, for normal priority. A negative value for low priority, such as batch jobs that
+   *  should not add to the latency of interactive Runs.
+   */
+  ORT_API2_STATUS(RunOptionsSetPriority, _Inout_ OrtRunOptions* options, int value);
 };
 
 /*
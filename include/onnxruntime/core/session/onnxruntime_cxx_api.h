@@ -216,6 +216,14 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // keep the state of streaming kernels between the Session::Run calls with the same stream_id
+  RunOptions& SetStream(const char* stream_id, bool end_of_stream = false);
+
+  // limit the number of intra-op threads the parallel loops of the Session::Run calls use, 0 for all of them
+  RunOptions& SetIntraOpMaxDegreeOfParallelism(int value);
+  // 0 for normal priority, negative for low priority Session::Run calls that yield the intra-op threads
+  RunOptions& SetPriority(int value);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -283,6 +291,12 @@ struct Session : Base<OrtSession> {
 
   void Run(const RunOptions& run_options, const struct IoBinding&);
 
+  // Run that returns immediately and invokes callback once the Run has completed. See OrtApi::RunAsync.
+  // run_options and output_values must stay valid until callback has been invoked.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count,
+                RunAsyncCallbackFn callback, void* user_data);
+
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
   size_t GetOverridableInitializerCount() const;
@@ -292,6 +306,9 @@ struct Session : Base<OrtSession> {
   char* GetOverridableInitializerName(size_t index, OrtAllocator* allocator) const;
   char* EndProfiling(OrtAllocator* allocator) const;
   uint64_t GetProfilingStartTimeNs() const;
+  char* GetProfilingStats(OrtAllocator* allocator) const;  // the JSON statistics of the sampling profiler
+  char* GetArenaStats(OrtAllocator* allocator) const;      // the JSON bytes in use of the arenas of the session
+  char* GetMemoryReport(OrtAllocator* allocator) const;    // the JSON breakdown of the memory of the session
   ModelMetadata GetModelMetadata() const;
 
   TypeInfo GetInputTypeInfo(size_t index) const;
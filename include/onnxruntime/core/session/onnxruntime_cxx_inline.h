@@ -387,6 +387,21 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetStream(const char* stream_id, bool end_of_stream) {
+  ThrowOnError(GetApi().RunOptionsSetStream(p_, stream_id, end_of_stream ? 1 : 0));
+  return *this;
+}
+
+inline RunOptions& RunOptions::SetIntraOpMaxDegreeOfParallelism(int value) {
+  ThrowOnError(GetApi().RunOptionsSetIntraOpMaxDegreeOfParallelism(p_, value));
+  return *this;
+}
+
+inline RunOptions& RunOptions::SetPriority(int value) {
+  ThrowOnError(GetApi().RunOptionsSetPriority(p_, value));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ThrowOnError(GetApi().CreateSessionOptions(&p_));
 }
@@ -513,6 +528,15 @@ inline void Session::Run(const RunOptions& run_options, const IoBinding& io_bind
   ThrowOnError(GetApi().RunWithBinding(p_, run_options, io_binding));
 }
 
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                              const char* const* output_names, Value* output_values, size_t output_count,
+                              RunAsyncCallbackFn callback, void* user_data) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count,
+                                 ort_output_values, callback, user_data));
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(GetApi().SessionGetInputCount(p_, &out));
@@ -561,6 +585,24 @@ inline uint64_t Session::GetProfilingStartTimeNs() const {
   return out;
 }
 
+inline char* Session::GetProfilingStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetProfilingStats(p_, allocator, &out));
+  return out;
+}
+
+inline char* Session::GetArenaStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetArenaStats(p_, allocator, &out));
+  return out;
+}
+
+inline char* Session::GetMemoryReport(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetMemoryReport(p_, allocator, &out));
+  return out;
+}
+
 inline ModelMetadata Session::GetModelMetadata() const {
   OrtModelMetadata* out;
   ThrowOnError(GetApi().SessionGetModelMetadata(p_, &out));
@@ -24,10 +24,28 @@ static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.di
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
 
+// Soft and hard limits, in bytes, of the memory the session allocates from each allocator registered in the env, e.g.
+// the arena of a GPU shared by the sessions of several models. The allocations over the soft limit log a warning and
+// the ones over the hard limit fail, so one session can't take the memory the others need. The sizes are the
+// requested ones, without the rounding of the arena. Only take effect if session.use_env_allocators is also "1".
+// The values are non-negative integers and the default "0" means no limit.
+static const char* const kOrtSessionOptionsConfigEnvAllocatorSoftLimit = "session.env_allocator_soft_limit";
+static const char* const kOrtSessionOptionsConfigEnvAllocatorHardLimit = "session.env_allocator_hard_limit";
+
+// A value of "1" means the sessions using the same env share a single copy of the weights pre-packed by kernels
+// (e.g. MatMul) when they load the same model. Only takes effect if session.use_env_allocators is also "1".
+// The shared buffers are kept until the env is released. The default is "0".
+static const char* const kOrtSessionOptionsConfigShareEnvPrepackedWeights = "session.share_env_prepacked_weights";
+
 // Set to 'ORT' (case sensitive) to load an ORT format model.
 // If unset, model type will default to ONNX unless inferred from filename ('.ort' == ORT format) or bytes to be ORT
 static const char* const kOrtSessionOptionsConfigLoadModelFormat = "session.load_model_format";
 
+// A value of "1" means an ORT format model loaded from a file is memory mapped, and initializers are used in place
+// from the mapped file instead of being copied, so the weights are shared through the page cache. Only applies to
+// initializers with raw data aligned in the file, which models saved by this version ensure. The default is "0".
+static const char* const kOrtSessionOptionsConfigMapOrtModelInitializers = "session.map_ort_model_initializers";
+
 // Set to 'ORT' (case sensitive) to save optimized model in ORT format when SessionOptions.optimized_model_path is set.
 // If unset, format will default to ONNX unless optimized_model_filepath ends in '.ort'.
 static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save_model_format";
@@ -40,3 +58,197 @@ static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save
 // Note that an alternative way not using this option at runtime is to train and export a model without denormals
 // and that's recommended because turning this option on may hurt model accuracy.
 static const char* const kOrtSessionOptionsConfigSetDenormalAsZero = "session.set_denormal_as_zero";
+
+// Maximum number of input shape combinations for which the memory pattern and inferred shapes are cached.
+// When the limit is reached the least recently used entry is evicted. The value is a non-negative integer and
+// the default is "32". "0" disables the cache, so every Run plans its memory allocations from scratch.
+static const char* const kOrtSessionOptionsConfigExecutionPlanCacheSize = "session.execution_plan_cache_size";
+
+// If a value is "1", the per session intra-op thread pool adapts how long idle threads spin to the recent frequency
+// of parallel loops, parking them sooner when loops are infrequent, and splits loops into finer chunks for idle
+// threads to pick up. This reduces wakeup latency for many small loops while limiting wasted CPU when several
+// sessions share a machine. Only applies when spinning is allowed. The default is "0".
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveSpinning = "session.intra_op.adaptive_spinning";
+
+// Weight of the Runs of the session on its intra-op thread pool. While Runs with a weight are using the same pool,
+// e.g. the Runs of sessions sharing the global thread pools of the env, the parallel loops of each Run use a share of
+// the threads proportional to its weight, so a session with small loops isn't starved by the large loops of another
+// one. The value is a non-negative integer, "0" lets the loops of the Runs use all the threads. The default is "1"
+// for the sessions using the global thread pools and "0" for the sessions with their own thread pools.
+static const char* const kOrtSessionOptionsConfigIntraOpThreadPoolWeight = "session.intra_op.thread_pool_weight";
+
+// NUMA node to run the session on. The value is a non-negative integer. When set, the threads of the per session
+// intra-op thread pool are pinned to the logical processors of the node (one thread per processor unless the
+// number of intra-op threads is set), and the default CPU execution provider allocates its arena from memory
+// placed on the node. The arena isn't NUMA placed if session.use_env_allocators replaces it with the shared one.
+// The default is no NUMA placement.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaNode = "session.intra_op.numa_node";
+
+// Logical processors to pin the threads of the per session intra-op thread pool to, as a comma separated list of
+// processor numbers, e.g. "4,5,6,7". The threads are assigned to the processors in order, wrapping around if there
+// are more threads than processors, and the number of intra-op threads defaults to the number of processors in the
+// list. Used to partition the cores of a machine between sessions. Takes precedence over session.intra_op.numa_node
+// for the placement of the threads. The default is no pinning.
+static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op.thread_affinities";
+
+// Placement of the threads of the per session intra-op thread pool when neither session.intra_op.thread_affinities
+// nor session.intra_op.numa_node is set. The values are
+// "physical_cores": pin the threads to one logical processor of each physical core, so two threads never share a core
+//                   through SMT (hyper-threading),
+// "performance_cores": the same, using only the performance cores of a hybrid processor, so the shards of a parallel
+//                      loop don't wait for the ones that run on the slower efficiency cores.
+// The number of intra-op threads defaults to the number of cores used. The threads aren't pinned if the platform
+// doesn't report the core topology. The default is "", no pinning.
+static const char* const kOrtSessionOptionsConfigIntraOpThreadPlacement = "session.intra_op.thread_placement";
+
+// If a value is "1", the TreeEnsembleRegressor and TreeEnsembleClassifier kernels of the default CPU execution
+// provider replace the thresholds of BRANCH_LEQ and BRANCH_LT trees with their index among the distinct thresholds
+// of their feature when the session is created. Each input row is then binned once against these thresholds and
+// the trees compare 8 or 16 bit bins instead of the values, which gives the same results with smaller and more
+// cache friendly nodes for batches of rows. The default is "0".
+static const char* const kOrtSessionOptionsConfigQuantizeTreeEnsembleThresholds =
+    "ep.cpu.quantize_tree_ensemble_thresholds";
+
+// If a value is "1", the Conv kernels of the default CPU execution provider never compute 3x3 convolutions with the
+// Winograd algorithm. The Winograd algorithm is otherwise chosen for convolutions with large channel counts where its
+// estimated cost is lower, and its results differ from the direct computation by a small rounding error, which
+// accuracy sensitive models may want to avoid. The default is "0".
+static const char* const kOrtSessionOptionsConfigDisableWinogradConv = "ep.cpu.disable_winograd_conv";
+
+// The MatMul kernels of the default CPU execution provider multiply a constant 2-D float weight whose blocks of 4
+// columns of a row are zero in at least this ratio of the blocks with a sparse kernel, which skips the zero blocks.
+// The weight is packed into a compressed layout when the session is created. The value is a ratio between 0 and 1,
+// e.g. "0.9" for pruned weights with 90% zero blocks, and a value greater than 1 disables the sparse kernel.
+// The default is "0.8". Unstructured sparsity leaves fewer zero blocks than zero values.
+static const char* const kOrtSessionOptionsConfigSparseMatMulThreshold = "ep.cpu.sparse_matmul_threshold";
+
+// If a value is "1", the LabelEncoder and CategoryMapper kernels of the default CPU execution provider store their
+// keys in a minimal perfect hash table built when the session is created, instead of an open addressing table twice
+// as large as the number of keys. A lookup then reads a single slot, which suits large vocabularies, at the price of
+// a slower session creation. The default is "0".
+static const char* const kOrtSessionOptionsConfigMlPerfectHashTables = "ep.cpu.ml_perfect_hash_tables";
+
+// If a value is "1", the memory arenas of the session's execution providers return the regions that no tensor uses
+// to the device at the end of each Run, so that the memory a Run with unusually large inputs required isn't held
+// until the session is destroyed. The default is "0". Arenas of an execution provider that captures its Runs into
+// graphs are never shrunk, as the captured graphs use their memory.
+static const char* const kOrtSessionOptionsConfigArenaShrinkAfterRun = "session.arena_shrink_after_run";
+
+// Number of seconds a region of a memory arena must have gone unused before the shrinkage at the end of a Run
+// returns it, so that the regions the recent Runs needed are kept. The value is a non-negative integer and the
+// default is "0". Setting it enables the shrinkage of session.arena_shrink_after_run.
+static const char* const kOrtSessionOptionsConfigArenaShrinkMinIdleSeconds = "session.arena_shrink_min_idle_seconds";
+
+// Concrete shapes of graph inputs to specialize the graph for, in the format "name:dim,dim,...;name:dim,...".
+// The shapes are propagated through the graph by shape inferencing, the subgraphs computing shapes are constant
+// folded and the Reshape, Expand and Slice nodes that don't change the shape of their input are removed. The session
+// then only accepts inputs of these shapes. Create a session per shape bucket to serve several shapes, saving each
+// specialized model with SessionOptions.optimized_model_filepath to avoid repeating the optimization.
+// Requires graph optimization level 1 or higher. The default is no specialization.
+static const char* const kOrtSessionOptionsConfigStaticInputShapes = "session.static_input_shapes";
+
+// Directory of a persistent cache of optimized models. When set, the key of a cache entry is computed from the model,
+// the graph optimization level, the execution providers and their options, and the other session configuration.
+// If the entry exists, the optimized graph and the kernel information saved with it in the ORT format are loaded
+// and the graph optimizations and partitioning are skipped. Otherwise the optimized model is saved to the entry once
+// the session is initialized. The directory must exist and may be shared by several processes. Models loaded in the
+// ORT format and models with custom ops don't use the cache. The default is no cache.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Key for disable the parallel session initialization.
+// By default the initializers on CPU are deserialized, and the kernels of the CPU execution provider are created and
+// pre-pack their weights on the intra-op thread pool. If the config value is set to "1" this is done sequentially.
+static const char* const kOrtSessionOptionsConfigDisableParallelInitialization =
+    "session.disable_parallel_initialization";
+
+// Key for the lazy loading of initializers stored in external data files.
+// The CPU tensors of these initializers use the memory mapped file data in place and no buffer is allocated for them.
+// If the config value is set to "1" they are also not pre-packed, which reads and copies the whole tensor, so the
+// pages of the file are only read when a kernel first accesses them. E.g. a Gather over a large embedding table only
+// pages in the rows it looks up. The default value is "0".
+static const char* const kOrtSessionOptionsConfigLazyLoadExternalInitializers =
+    "session.lazy_load_external_initializers";
+
+// Enables the sampling profiler, which measures the kernel execution time of every node in 1 in N Runs and records
+// it in a latency histogram per node. The value is N, a non-negative integer; "0" (the default) disables it.
+// Unlike the Profiler enabled by SessionOptions.enable_profiling its memory use is fixed, so it can be left on in
+// production. The statistics are read with SessionGetProfilingStats. Subgraphs sample 1 in N of their executions.
+static const char* const kOrtSessionOptionsConfigProfilingSampleRate = "session.profiling_sample_rate";
+
+// File that the statistics of the sampling profiler are written to in the JSON format of SessionGetProfilingStats.
+// It is replaced after a Run once the export interval has passed since the last write. The default is no file.
+static const char* const kOrtSessionOptionsConfigProfilingStatsFile = "session.profiling_stats_file";
+
+// Number of seconds between the writes of session.profiling_stats_file. The default is "60".
+static const char* const kOrtSessionOptionsConfigProfilingStatsExportIntervalSeconds =
+    "session.profiling_stats_export_interval_seconds";
+
+// Key for adding the hardware performance counters to the node events of the Profiler.
+// If the config value is set to "1" and profiling is enabled, the CPU cycles, retired instructions, last level cache
+// references and misses of the thread running each kernel's Compute are added to the args of its "_kernel_time"
+// event, together with the memory bandwidth estimated from the cache misses. This uses perf_event_open on Linux and
+// is silently skipped where the counters are not available. On Windows use the HardwareCounters profile of ort.wprp.
+// The default value is "0".
+static const char* const kOrtSessionOptionsConfigProfileHardwareCounters = "session.profile_hardware_counters";
+
+// Number of Runs in which the parallel executor (ExecutionMode::ORT_PARALLEL) measures the kernel execution time of
+// each node. After them it runs the ready node on the critical path first, runs cheap nodes on the current thread
+// instead of dispatching them to the inter-op thread pool, and divides the intra-op threads between the nodes running
+// concurrently. The value is a non-negative integer, "0" keeps the first-come scheduling. The default value is "3".
+static const char* const kOrtSessionOptionsConfigParallelExecutorWarmupRuns = "session.parallel_executor_warmup_runs";
+
+// Nodes with an estimated kernel execution time below this number of microseconds are run by the parallel executor
+// on the thread that made them ready. The value is a non-negative integer. The default value is "20".
+static const char* const kOrtSessionOptionsConfigParallelExecutorInlineNodeCostUs =
+    "session.parallel_executor_inline_node_cost_us";
+
+// Key for refining the greedy graph partitioning with a cost model.
+// If the config value is set to "1", nodes of the execution providers with their own device memory that are next to
+// the nodes they don't support are moved to the CPU execution provider when the copies of their inputs and outputs
+// between the devices are estimated to cost more than running them on the CPU. The estimates use the shapes of the
+// values, so they are more accurate for models with static shapes. The default value is "0".
+static const char* const kOrtSessionOptionsConfigPartitioningCostModel = "session.partitioning_cost_model";
+
+// File the placement of the nodes is written to after the graph partitioning. Every line is the path of a node and
+// the type of the execution provider it is assigned to separated by a tab. The path is the node name, or '#' and the
+// node index if it has no name, prefixed by "<node path>/<attribute name>/" of the nodes containing nested graphs.
+// The default is no file.
+static const char* const kOrtSessionOptionsConfigSavePartitioningPlacement = "session.save_partitioning_placement";
+
+// File with a placement written by session.save_partitioning_placement, which is applied before the greedy graph
+// partitioning, e.g. after adjusting it by hand. Nodes whose execution provider isn't registered or has no kernel
+// for them, and nodes that aren't in the file, are partitioned as usual. The default is no file.
+static const char* const kOrtSessionOptionsConfigLoadPartitioningPlacement = "session.load_partitioning_placement";
+
+// Key for prefetching the external data of the initializers when the session is initialized.
+// If the config value is set to "1", the platform is asked to start reading the external data files into the page
+// cache before the graph is optimized, so the reads overlap with the optimizations. This helps most when the files
+// are on slow or network storage. The default value is "1". Set it to "0" if the external data doesn't fit in memory.
+static const char* const kOrtSessionOptionsConfigPrefetchExternalData = "session.prefetch_external_data";
+
+// Sizes the symbolic dimensions of the graph inputs are padded up to, in the format
+// "dim_param:size,size,...;dim_param:size,...", e.g. "sequence_length:16,32,64,128,256,512". Before a Run, the
+// tensor inputs are padded with zeros along each dimension named by one of the dim_params to the smallest size that
+// holds it, so the Runs only see a handful of distinct shapes and reuse their memory patterns and the shape specific
+// state of the execution providers. Padding an attention mask with zeros masks the padded positions, so the model
+// must ignore them through such a mask for the results to be unchanged. The dimensions of the graph outputs with the
+// same dim_params are sliced back to the sizes of the inputs after the Run. Sizes larger than the largest bucket
+// aren't padded. Runs with inputs that aren't on the CPU, or with pre-allocated outputs or outputs on another device,
+// aren't padded. The default is no padding.
+static const char* const kOrtSessionOptionsConfigPadBuckets = "session.pad_buckets";
+
+// A value of "1" saves the buffers the kernels produce by pre-packing constant initializers in ORT format models
+// written by this session, tagged with the platform they were packed on. Sessions loading the model on a platform
+// with the same signature use the saved buffers instead of packing the initializers, and with
+// session.map_ort_model_initializers the buffers are used in place from the memory mapped model file. Only kernels
+// that support sharing pre-packed weights save their buffers. The model is larger as the initializers are still
+// saved for other platforms. The default is "0".
+static const char* const kOrtSessionOptionsConfigSavePrePackedWeights = "session.save_prepacked_weights";
+
+// Comma separated names of the "sticky" graph inputs, which change less often than the other inputs, such as the
+// features of a user that an embedding tower is computed from. The outputs of the deterministic CPU nodes that only
+// depend on the sticky inputs and constant initializers are cached, and a later Run whose sticky inputs have the same
+// contents, compared by a hash, uses them instead of executing the nodes. The results of the last set of sticky
+// input values are kept. Runs that don't feed all of the sticky inputs as CPU tensors don't use the cache. Only the
+// sequential executor uses the cache. The default is no sticky inputs.
+static const char* const kOrtSessionOptionsConfigStickyInputs = "session.sticky_inputs";
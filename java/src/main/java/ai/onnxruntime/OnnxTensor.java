@@ -141,6 +141,27 @@ public class OnnxTensor implements OnnxValue {
     }
   }
 
+  /**
+   * Returns a direct ByteBuffer of the native platform endian-ness which views the memory of the
+   * underlying OnnxTensor without copying it.
+   *
+   * <p>Writes to the view change the tensor, which allows the tensor to be refilled and reused as
+   * an input, and outputs written into a tensor by {@link OrtSession#run(OrtSession.IoBinding)} can
+   * be read from the view. The view must not be accessed after this OnnxTensor is closed.
+   *
+   * <p>This method returns null if the OnnxTensor contains Strings as they are stored externally to
+   * the OnnxTensor.
+   *
+   * @return A ByteBuffer view of the OnnxTensor.
+   */
+  public ByteBuffer getByteBufferView() {
+    if (info.type != OnnxJavaType.STRING) {
+      return getBuffer();
+    } else {
+      return null;
+    }
+  }
+
   /**
    * Returns a copy of the underlying OnnxTensor as a FloatBuffer if it can be losslessly converted
    * into a float (i.e. it's a float or fp16), otherwise it returns null.
@@ -15,6 +15,7 @@ import java.util.List;
 import java.util.Map;
 import java.util.Optional;
 import java.util.Set;
+import java.util.concurrent.CompletableFuture;
 import java.util.logging.Logger;
 
 /**
@@ -248,41 +249,7 @@ public class OrtSession implements AutoCloseable {
       Map<String, OnnxTensor> inputs, Set<String> requestedOutputs, RunOptions runOptions)
       throws OrtException {
     if (!closed) {
-      if (inputs.isEmpty() || (inputs.size() > numInputs)) {
-        throw new OrtException(
-            "Unexpected number of inputs, expected [1," + numInputs + ") found " + inputs.size());
-      }
-      if (requestedOutputs.isEmpty() || (requestedOutputs.size() > numOutputs)) {
-        throw new OrtException(
-            "Unexpected number of requestedOutputs, expected [1,"
-                + numOutputs
-                + ") found "
-                + requestedOutputs.size());
-      }
-      String[] inputNamesArray = new String[inputs.size()];
-      long[] inputHandles = new long[inputs.size()];
-      int i = 0;
-      for (Map.Entry<String, OnnxTensor> t : inputs.entrySet()) {
-        if (inputNames.contains(t.getKey())) {
-          inputNamesArray[i] = t.getKey();
-          inputHandles[i] = t.getValue().getNativeHandle();
-          i++;
-        } else {
-          throw new OrtException(
-              "Unknown input name " + t.getKey() + ", expected one of " + inputNames.toString());
-        }
-      }
-      String[] outputNamesArray = new String[requestedOutputs.size()];
-      i = 0;
-      for (String s : requestedOutputs) {
-        if (outputNames.contains(s)) {
-          outputNamesArray[i] = s;
-          i++;
-        } else {
-          throw new OrtException(
-              "Unknown output name " + s + ", expected one of " + outputNames.toString());
-        }
-      }
+      RunArguments args = checkRunArguments(inputs, requestedOutputs);
       long runOptionsHandle = runOptions == null ? 0 : runOptions.nativeHandle;
 
       OnnxValue[] outputValues =
@@ -290,18 +257,167 @@ public class OrtSession implements AutoCloseable {
               OnnxRuntime.ortApiHandle,
               nativeHandle,
               allocator.handle,
-              inputNamesArray,
-              inputHandles,
-              inputNamesArray.length,
-              outputNamesArray,
-              outputNamesArray.length,
+              args.inputNames,
+              args.inputHandles,
+              args.inputNames.length,
+              args.outputNames,
+              args.outputNames.length,
               runOptionsHandle);
-      return new Result(outputNamesArray, outputValues);
+      return new Result(args.outputNames, outputValues);
+    } else {
+      throw new IllegalStateException("Trying to score a closed OrtSession.");
+    }
+  }
+
+  /**
+   * Scores an input feed dict on the intra-op thread pool of the session, without blocking the
+   * calling thread.
+   *
+   * <p>The session must have been created with at least 2 intra-op threads. The inputs and the run
+   * options must not be closed before the returned future completes, and closing the session
+   * blocks until the outstanding runs have completed. Non-async dependent stages of the returned
+   * future may be executed on a thread of the session thread pool.
+   *
+   * @param inputs The inputs to score.
+   * @param requestedOutputs The requested outputs.
+   * @param runOptions The RunOptions to control this run, may be null.
+   * @return A future which completes with the inferred outputs, or with an {@link OrtException}
+   *     if the run failed.
+   * @throws OrtException If the run could not be started, e.g. if the input or output names are
+   *     invalid, or if there are zero or too many inputs or outputs.
+   */
+  public CompletableFuture<Result> runAsync(
+      Map<String, OnnxTensor> inputs, Set<String> requestedOutputs, RunOptions runOptions)
+      throws OrtException {
+    if (!closed) {
+      RunArguments args = checkRunArguments(inputs, requestedOutputs);
+      long runOptionsHandle = runOptions == null ? 0 : runOptions.nativeHandle;
+
+      AsyncRun asyncRun = new AsyncRun(args.outputNames, allocator.handle, inputs, runOptions);
+      runAsync(
+          OnnxRuntime.ortApiHandle,
+          nativeHandle,
+          allocator.handle,
+          args.inputNames,
+          args.inputHandles,
+          args.inputNames.length,
+          args.outputNames,
+          args.outputNames.length,
+          runOptionsHandle,
+          asyncRun);
+      return asyncRun.future;
     } else {
       throw new IllegalStateException("Trying to score a closed OrtSession.");
     }
   }
 
+  /**
+   * Creates an {@link IoBinding} for this session, which binds preallocated tensors to the inputs
+   * and outputs of the model so they can be reused across calls to {@link #run(IoBinding)}.
+   *
+   * @return A new IoBinding.
+   * @throws OrtException If the native call failed.
+   */
+  public IoBinding createIoBinding() throws OrtException {
+    if (!closed) {
+      return new IoBinding(this);
+    } else {
+      throw new IllegalStateException("Trying to bind a closed OrtSession.");
+    }
+  }
+
+  /**
+   * Scores the inputs bound to the supplied {@link IoBinding}, writing the outputs into the tensors
+   * bound to it.
+   *
+   * @param binding The binding of the inputs and outputs.
+   * @throws OrtException If there was an error in native code, or if there are no outputs bound.
+   */
+  public void run(IoBinding binding) throws OrtException {
+    run(binding, null);
+  }
+
+  /**
+   * Scores the inputs bound to the supplied {@link IoBinding}, writing the outputs into the tensors
+   * bound to it.
+   *
+   * <p>No outputs are allocated and no values are copied into or out of the Java heap by this
+   * call. When the bound tensors wrap direct buffers, the next inputs can be written into the same
+   * buffers and the results read from the output buffers without creating any objects per run.
+   *
+   * @param binding The binding of the inputs and outputs.
+   * @param runOptions The RunOptions to control this run, may be null.
+   * @throws OrtException If there was an error in native code, or if there are no outputs bound.
+   */
+  public void run(IoBinding binding, RunOptions runOptions) throws OrtException {
+    if (!closed) {
+      if (binding.session != this) {
+        throw new IllegalArgumentException("The IoBinding was created by a different OrtSession.");
+      }
+      binding.checkClosed();
+      if (binding.boundOutputs.isEmpty()) {
+        throw new OrtException(
+            "Unexpected number of bound outputs, expected [1," + numOutputs + ") found 0");
+      }
+      long runOptionsHandle = runOptions == null ? 0 : runOptions.nativeHandle;
+      runWithBinding(
+          OnnxRuntime.ortApiHandle, nativeHandle, binding.nativeHandle, runOptionsHandle);
+    } else {
+      throw new IllegalStateException("Trying to score a closed OrtSession.");
+    }
+  }
+
+  /**
+   * Validates the inputs and requested outputs of a run and converts them into the arrays the
+   * native calls expect.
+   *
+   * @param inputs The inputs to score.
+   * @param requestedOutputs The requested outputs.
+   * @return The input names, handles and output names.
+   * @throws OrtException If the input or output names are invalid, or if there are zero or too
+   *     many inputs or outputs.
+   */
+  private RunArguments checkRunArguments(
+      Map<String, OnnxTensor> inputs, Set<String> requestedOutputs) throws OrtException {
+    if (inputs.isEmpty() || (inputs.size() > numInputs)) {
+      throw new OrtException(
+          "Unexpected number of inputs, expected [1," + numInputs + ") found " + inputs.size());
+    }
+    if (requestedOutputs.isEmpty() || (requestedOutputs.size() > numOutputs)) {
+      throw new OrtException(
+          "Unexpected number of requestedOutputs, expected [1,"
+              + numOutputs
+              + ") found "
+              + requestedOutputs.size());
+    }
+    RunArguments args = new RunArguments();
+    args.inputNames = new String[inputs.size()];
+    args.inputHandles = new long[inputs.size()];
+    int i = 0;
+    for (Map.Entry<String, OnnxTensor> t : inputs.entrySet()) {
+      if (inputNames.contains(t.getKey())) {
+        args.inputNames[i] = t.getKey();
+        args.inputHandles[i] = t.getValue().getNativeHandle();
+        i++;
+      } else {
+        throw new OrtException(
+            "Unknown input name " + t.getKey() + ", expected one of " + inputNames.toString());
+      }
+    }
+    args.outputNames = new String[requestedOutputs.size()];
+    i = 0;
+    for (String s : requestedOutputs) {
+      if (outputNames.contains(s)) {
+        args.outputNames[i] = s;
+        i++;
+      } else {
+        throw new OrtException(
+            "Unknown output name " + s + ", expected one of " + outputNames.toString());
+      }
+    }
+    return args;
+  }
+
   /**
    * Gets the metadata for the currently loaded model.
    *
@@ -414,6 +530,64 @@ public class OrtSession implements AutoCloseable {
       long runOptionsHandle)
       throws OrtException;
 
+  /**
+   * Schedules a run on the session thread pool. {@code asyncRun} is notified once the run has
+   * completed, unless this method throws.
+   *
+   * @param apiHandle The pointer to the api.
+   * @param nativeHandle The pointer to the session.
+   * @param allocatorHandle The pointer to the allocator.
+   * @param inputNamesArray The input names.
+   * @param inputs The input tensors.
+   * @param numInputs The number of inputs.
+   * @param outputNamesArray The requested output names.
+   * @param numOutputs The number of requested outputs.
+   * @param runOptionsHandle The (possibly null) pointer to the run options.
+   * @param asyncRun The object to notify.
+   * @throws OrtException If the run could not be scheduled.
+   */
+  private native void runAsync(
+      long apiHandle,
+      long nativeHandle,
+      long allocatorHandle,
+      String[] inputNamesArray,
+      long[] inputs,
+      long numInputs,
+      String[] outputNamesArray,
+      long numOutputs,
+      long runOptionsHandle,
+      AsyncRun asyncRun)
+      throws OrtException;
+
+  /**
+   * Wraps the outputs of an asynchronous run into OnnxValues, taking ownership of them.
+   *
+   * <p>The outputs are converted by a native method of this class rather than by the callback
+   * itself, so the classes are looked up with the class loader of this class.
+   *
+   * @param apiHandle The pointer to the api.
+   * @param allocatorHandle The pointer to the allocator.
+   * @param outputHandles The pointers to the outputs.
+   * @return The OnnxValues.
+   * @throws OrtException If the outputs could not be converted.
+   */
+  private static native OnnxValue[] convertOutputs(
+      long apiHandle, long allocatorHandle, long[] outputHandles) throws OrtException;
+
+  /**
+   * The native run call with bound inputs and outputs. runOptionsHandle can be zero (i.e. the null
+   * pointer).
+   *
+   * @param apiHandle The pointer to the api.
+   * @param nativeHandle The pointer to the session.
+   * @param bindingHandle The pointer to the IoBinding.
+   * @param runOptionsHandle The pointer to the run options, or zero.
+   * @throws OrtException If the native call failed in some way.
+   */
+  private native void runWithBinding(
+      long apiHandle, long nativeHandle, long bindingHandle, long runOptionsHandle)
+      throws OrtException;
+
   private native String endProfiling(long apiHandle, long nativeHandle, long allocatorHandle)
       throws OrtException;
 
@@ -431,6 +605,58 @@ public class OrtSession implements AutoCloseable {
   private native OnnxModelMetadata constructMetadata(
       long ortApiHandle, long nativeHandle, long allocatorHandle) throws OrtException;
 
+  /** The arguments of a run, validated by {@link #checkRunArguments}. */
+  private static final class RunArguments {
+    String[] inputNames;
+    long[] inputHandles;
+    String[] outputNames;
+  }
+
+  /** The state of a run started by {@link #runAsync}, notified by native code. */
+  private static final class AsyncRun {
+    private final String[] outputNames;
+    private final long allocatorHandle;
+    // referenced so they can't be garbage collected while the run uses them
+    private final Map<String, OnnxTensor> inputs;
+    private final RunOptions runOptions;
+    private final CompletableFuture<Result> future = new CompletableFuture<>();
+
+    AsyncRun(
+        String[] outputNames,
+        long allocatorHandle,
+        Map<String, OnnxTensor> inputs,
+        RunOptions runOptions) {
+      this.outputNames = outputNames;
+      this.allocatorHandle = allocatorHandle;
+      this.inputs = inputs;
+      this.runOptions = runOptions;
+    }
+
+    /**
+     * Called from native code on the thread which executed the run.
+     *
+     * @param outputHandles The pointers to the outputs, owned by this object.
+     */
+    private void complete(long[] outputHandles) {
+      try {
+        OnnxValue[] values = convertOutputs(OnnxRuntime.ortApiHandle, allocatorHandle, outputHandles);
+        future.complete(new Result(outputNames, values));
+      } catch (OrtException | RuntimeException e) {
+        future.completeExceptionally(e);
+      }
+    }
+
+    /**
+     * Called from native code on the thread which executed the run.
+     *
+     * @param code The error code.
+     * @param message The error message.
+     */
+    private void fail(int code, String message) {
+      future.completeExceptionally(new OrtException(code, message));
+    }
+  }
+
   /**
    * Represents the options used to construct this session.
    *
@@ -1051,6 +1277,140 @@ public class OrtSession implements AutoCloseable {
     private static native void close(long apiHandle, long nativeHandle);
   }
 
+  /**
+   * Binds tensors to the inputs and outputs of an {@link OrtSession}, so that repeated calls to
+   * {@link OrtSession#run(IoBinding)} reuse the same tensors rather than allocating new outputs.
+   *
+   * <p>The output tensors must be preallocated with the shape and type the model produces, e.g. by
+   * wrapping a direct buffer. The binding holds a reference to the bound tensors so their buffers
+   * stay alive while they are bound, but the tensors are owned by the caller and are not closed by
+   * the binding.
+   */
+  public static class IoBinding implements AutoCloseable {
+
+    private final long nativeHandle;
+
+    private final OrtSession session;
+
+    private final Map<String, OnnxTensor> boundInputs = new LinkedHashMap<>();
+
+    private final Map<String, OnnxTensor> boundOutputs = new LinkedHashMap<>();
+
+    private boolean closed = false;
+
+    /**
+     * Creates an IoBinding for the supplied session.
+     *
+     * @param session The session.
+     * @throws OrtException If the construction of the native IoBinding failed.
+     */
+    private IoBinding(OrtSession session) throws OrtException {
+      this.session = session;
+      this.nativeHandle = createIoBinding(OnnxRuntime.ortApiHandle, session.nativeHandle);
+    }
+
+    /**
+     * Binds a tensor to an input of the model, replacing any tensor already bound to it.
+     *
+     * @param name The input name.
+     * @param tensor The tensor.
+     * @throws OrtException If the name is not an input of the model, or the native call failed.
+     */
+    public void bindInput(String name, OnnxTensor tensor) throws OrtException {
+      checkClosed();
+      if (!session.inputNames.contains(name)) {
+        throw new OrtException(
+            "Unknown input name " + name + ", expected one of " + session.inputNames.toString());
+      }
+      bindInput(OnnxRuntime.ortApiHandle, nativeHandle, name, tensor.getNativeHandle());
+      boundInputs.put(name, tensor);
+    }
+
+    /**
+     * Binds a preallocated tensor to an output of the model, replacing any tensor already bound to
+     * it. The output is written into the tensor by each run.
+     *
+     * @param name The output name.
+     * @param tensor The tensor.
+     * @throws OrtException If the name is not an output of the model, or the native call failed.
+     */
+    public void bindOutput(String name, OnnxTensor tensor) throws OrtException {
+      checkClosed();
+      if (!session.outputNames.contains(name)) {
+        throw new OrtException(
+            "Unknown output name " + name + ", expected one of " + session.outputNames.toString());
+      }
+      bindOutput(OnnxRuntime.ortApiHandle, nativeHandle, name, tensor.getNativeHandle());
+      boundOutputs.put(name, tensor);
+    }
+
+    /**
+     * Returns the tensors bound to the inputs.
+     *
+     * @return An unmodifiable view of the bound inputs.
+     */
+    public Map<String, OnnxTensor> getBoundInputs() {
+      return Collections.unmodifiableMap(boundInputs);
+    }
+
+    /**
+     * Returns the tensors bound to the outputs.
+     *
+     * @return An unmodifiable view of the bound outputs.
+     */
+    public Map<String, OnnxTensor> getBoundOutputs() {
+      return Collections.unmodifiableMap(boundOutputs);
+    }
+
+    /** Unbinds all of the inputs. */
+    public void clearBoundInputs() {
+      checkClosed();
+      clearBoundInputs(OnnxRuntime.ortApiHandle, nativeHandle);
+      boundInputs.clear();
+    }
+
+    /** Unbinds all of the outputs. */
+    public void clearBoundOutputs() {
+      checkClosed();
+      clearBoundOutputs(OnnxRuntime.ortApiHandle, nativeHandle);
+      boundOutputs.clear();
+    }
+
+    /** Checks if the IoBinding is closed, if so throws {@link IllegalStateException}. */
+    private void checkClosed() {
+      if (closed) {
+        throw new IllegalStateException("Trying to use a closed IoBinding");
+      }
+    }
+
+    @Override
+    public void close() {
+      if (!closed) {
+        close(OnnxRuntime.ortApiHandle, nativeHandle);
+        boundInputs.clear();
+        boundOutputs.clear();
+        closed = true;
+      } else {
+        throw new IllegalStateException("Trying to close an already closed IoBinding");
+      }
+    }
+
+    private static native long createIoBinding(long apiHandle, long sessionHandle)
+        throws OrtException;
+
+    private native void bindInput(long apiHandle, long nativeHandle, String name, long valueHandle)
+        throws OrtException;
+
+    private native void bindOutput(long apiHandle, long nativeHandle, String name, long valueHandle)
+        throws OrtException;
+
+    private native void clearBoundInputs(long apiHandle, long nativeHandle);
+
+    private native void clearBoundOutputs(long apiHandle, long nativeHandle);
+
+    private static native void close(long apiHandle, long nativeHandle);
+  }
+
   /**
    * An {@link AutoCloseable} wrapper around a {@link Map} containing {@link OnnxValue}s.
    *
@@ -3,6 +3,7 @@
  * Licensed under the MIT License.
  */
 #include <jni.h>
+#include <stdlib.h>
 #include <string.h>
 #include "onnxruntime/core/session/onnxruntime_c_api.h"
 #include "OrtJniUtil.h"
@@ -310,6 +311,205 @@ JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_run
     return outputArray;
 }
 
+/*
+ * The state of a run started by runAsync, owned by the callback.
+ */
+typedef struct {
+    JavaVM* jvm;
+    const OrtApi* api;
+    jobject asyncRun; // global reference to the ai.onnxruntime.OrtSession$AsyncRun
+    OrtValue** outputValues;
+} AsyncRunContext;
+
+/*
+ * Completes the AsyncRun on the thread which executed the run. Only primitive values are passed back to Java, as
+ * FindClass would use the system class loader on threads attached by native code.
+ */
+static void ORT_API_CALL runAsyncCallback(void* userData, OrtValue** outputs, size_t numOutputs, OrtStatus* status) {
+    AsyncRunContext* context = (AsyncRunContext*) userData;
+    const OrtApi* api = context->api;
+    JavaVM* jvm = context->jvm;
+
+    JNIEnv* jniEnv = NULL;
+    int attached = 0;
+    if ((*jvm)->GetEnv(jvm, (void**)&jniEnv, JNI_VERSION_1_6) == JNI_EDETACHED) {
+#ifdef __ANDROID__
+        jint result = (*jvm)->AttachCurrentThread(jvm, &jniEnv, NULL);
+#else
+        jint result = (*jvm)->AttachCurrentThread(jvm, (void**)&jniEnv, NULL);
+#endif
+        if (result != JNI_OK) {
+            // nothing can be reported, at least release what the run produced
+            for (size_t i = 0; i < numOutputs; i++) {
+                if (outputs[i] != NULL) {
+                    api->ReleaseValue(outputs[i]);
+                }
+            }
+            if (status != NULL) {
+                api->ReleaseStatus(status);
+            }
+            free(context->outputValues);
+            free(context);
+            return;
+        }
+        attached = 1;
+    }
+
+    jclass asyncRunClass = (*jniEnv)->GetObjectClass(jniEnv, context->asyncRun);
+    if (status != NULL) {
+        jmethodID failMethod = (*jniEnv)->GetMethodID(jniEnv, asyncRunClass, "fail", "(ILjava/lang/String;)V");
+        jstring message = (*jniEnv)->NewStringUTF(jniEnv, api->GetErrorMessage(status));
+        jint code = convertErrorCode(api->GetErrorCode(status));
+        api->ReleaseStatus(status);
+        (*jniEnv)->CallVoidMethod(jniEnv, context->asyncRun, failMethod, code, message);
+    } else {
+        jmethodID completeMethod = (*jniEnv)->GetMethodID(jniEnv, asyncRunClass, "complete", "([J)V");
+        jlongArray outputHandles = (*jniEnv)->NewLongArray(jniEnv, (jsize) numOutputs);
+        for (size_t i = 0; i < numOutputs; i++) {
+            jlong handle = (jlong) outputs[i];
+            (*jniEnv)->SetLongArrayRegion(jniEnv, outputHandles, (jsize) i, 1, &handle);
+        }
+        (*jniEnv)->CallVoidMethod(jniEnv, context->asyncRun, completeMethod, outputHandles);
+    }
+    // AsyncRun catches the exceptions it can expect, anything else can't be propagated from this thread.
+    if ((*jniEnv)->ExceptionCheck(jniEnv)) {
+        (*jniEnv)->ExceptionClear(jniEnv);
+    }
+
+    (*jniEnv)->DeleteGlobalRef(jniEnv, context->asyncRun);
+    free(context->outputValues);
+    free(context);
+
+    if (attached) {
+        (*jvm)->DetachCurrentThread(jvm);
+    }
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession
+ * Method:    runAsync
+ * Signature: (JJJ[Ljava/lang/String;[JJ[Ljava/lang/String;JJLai/onnxruntime/OrtSession$AsyncRun;)V
+ * private native void runAsync(long apiHandle, long nativeHandle, long allocatorHandle, String[] inputNamesArray, long[] inputs, long numInputs, String[] outputNamesArray, long numOutputs, long runOptionsHandle, AsyncRun asyncRun)
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_runAsync
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong sessionHandle, jlong allocatorHandle, jobjectArray inputNamesArr, jlongArray tensorArr, jlong numInputs, jobjectArray outputNamesArr, jlong numOutputs, jlong runOptionsHandle, jobject asyncRun) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    OrtAllocator* allocator = (OrtAllocator*) allocatorHandle;
+    OrtSession* session = (OrtSession*) sessionHandle;
+    OrtRunOptions* runOptions = (OrtRunOptions*) runOptionsHandle;
+
+    // The output array has to outlive this call, so it is owned by the context rather than allocated from the
+    // session allocator.
+    AsyncRunContext* context = malloc(sizeof(AsyncRunContext));
+    OrtValue** outputValues = malloc(sizeof(OrtValue*)*(numOutputs > 0 ? numOutputs : 1));
+    if (context == NULL || outputValues == NULL || (*jniEnv)->GetJavaVM(jniEnv, &context->jvm) != JNI_OK) {
+        free(context);
+        free(outputValues);
+        throwOrtException(jniEnv, convertErrorCode(ORT_FAIL), "Failed to allocate the state of the run.");
+        return;
+    }
+    context->api = api;
+    context->outputValues = outputValues;
+    context->asyncRun = (*jniEnv)->NewGlobalRef(jniEnv, asyncRun);
+
+    // Create the buffers for the Java input and output strings, they are copied by RunAsync
+    const char** inputNames;
+    checkOrtStatus(jniEnv, api, api->AllocatorAlloc(allocator,sizeof(char*)*numInputs,(void**)&inputNames));
+    const char** outputNames;
+    checkOrtStatus(jniEnv, api, api->AllocatorAlloc(allocator,sizeof(char*)*numOutputs,(void**)&outputNames));
+    jobject* javaInputStrings;
+    checkOrtStatus(jniEnv, api, api->AllocatorAlloc(allocator,sizeof(jobject)*numInputs,(void**)&javaInputStrings));
+    jobject* javaOutputStrings;
+    checkOrtStatus(jniEnv, api, api->AllocatorAlloc(allocator,sizeof(jobject)*numOutputs,(void**)&javaOutputStrings));
+
+    for (int i = 0; i < numInputs; i++) {
+        javaInputStrings[i] = (*jniEnv)->GetObjectArrayElement(jniEnv,inputNamesArr,i);
+        inputNames[i] = (*jniEnv)->GetStringUTFChars(jniEnv,javaInputStrings[i],NULL);
+    }
+    jlong* inputTensors = (*jniEnv)->GetLongArrayElements(jniEnv,tensorArr,NULL);
+    for (int i = 0; i < numOutputs; i++) {
+        javaOutputStrings[i] = (*jniEnv)->GetObjectArrayElement(jniEnv,outputNamesArr,i);
+        outputNames[i] = (*jniEnv)->GetStringUTFChars(jniEnv,javaOutputStrings[i],NULL);
+        outputValues[i] = NULL;
+    }
+
+    OrtStatus* status = api->RunAsync(session, runOptions, (const char* const*) inputNames, (const OrtValue* const*) inputTensors, numInputs, (const char* const*) outputNames, numOutputs, outputValues, runAsyncCallback, context);
+    if (status != NULL) {
+        // the callback is not invoked if the run could not be scheduled
+        (*jniEnv)->DeleteGlobalRef(jniEnv, context->asyncRun);
+        free(outputValues);
+        free(context);
+        checkOrtStatus(jniEnv, api, status);
+    }
+
+    // Release the Java strings and the C array of pointers to the tensors.
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv,tensorArr,inputTensors,JNI_ABORT);
+    for (int i = 0; i < numInputs; i++) {
+        (*jniEnv)->ReleaseStringUTFChars(jniEnv,javaInputStrings[i],inputNames[i]);
+    }
+    for (int i = 0; i < numOutputs; i++) {
+        (*jniEnv)->ReleaseStringUTFChars(jniEnv,javaOutputStrings[i],outputNames[i]);
+    }
+
+    // Release the buffers
+    checkOrtStatus(jniEnv, api, api->AllocatorFree(allocator, inputNames));
+    checkOrtStatus(jniEnv, api, api->AllocatorFree(allocator, outputNames));
+    checkOrtStatus(jniEnv, api, api->AllocatorFree(allocator, javaInputStrings));
+    checkOrtStatus(jniEnv, api, api->AllocatorFree(allocator, javaOutputStrings));
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession
+ * Method:    convertOutputs
+ * Signature: (JJ[J)[Lai/onnxruntime/OnnxValue;
+ * private static native OnnxValue[] convertOutputs(long apiHandle, long allocatorHandle, long[] outputHandles)
+ */
+JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_convertOutputs
+  (JNIEnv * jniEnv, jclass jclazz, jlong apiHandle, jlong allocatorHandle, jlongArray outputHandles) {
+    (void) jclazz; // Required JNI parameter not needed by functions which don't need to access their host class.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    OrtAllocator* allocator = (OrtAllocator*) allocatorHandle;
+
+    jsize numOutputs = (*jniEnv)->GetArrayLength(jniEnv, outputHandles);
+    jlong* outputValues = (*jniEnv)->GetLongArrayElements(jniEnv, outputHandles, NULL);
+
+    char *onnxValueClassName = "ai/onnxruntime/OnnxValue";
+    jclass onnxValueClass = (*jniEnv)->FindClass(jniEnv, onnxValueClassName);
+    jobjectArray outputArray = (*jniEnv)->NewObjectArray(jniEnv,numOutputs,onnxValueClass,NULL);
+
+    for (jsize i = 0; i < numOutputs; i++) {
+        OrtValue* value = (OrtValue*) outputValues[i];
+        if (value == NULL) {
+            continue;
+        }
+        if ((*jniEnv)->ExceptionCheck(jniEnv)) {
+            // a previous conversion failed, so the remaining values are not owned by a Java object
+            api->ReleaseValue(value);
+            continue;
+        }
+        jobject onnxValue = convertOrtValueToONNXValue(jniEnv,api,allocator,value);
+        (*jniEnv)->SetObjectArrayElement(jniEnv,outputArray,i,onnxValue);
+    }
+
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv,outputHandles,outputValues,JNI_ABORT);
+    return outputArray;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession
+ * Method:    runWithBinding
+ * Signature: (JJJJ)V
+ * private native void runWithBinding(long apiHandle, long nativeHandle, long bindingHandle, long runOptionsHandle)
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_runWithBinding
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong sessionHandle, jlong bindingHandle, jlong runOptionsHandle) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    // The outputs are written into the bound tensors, so nothing is allocated or converted here.
+    checkOrtStatus(jniEnv,api,api->RunWithBinding((OrtSession*) sessionHandle, (const OrtRunOptions*) runOptionsHandle, (const OrtIoBinding*) bindingHandle));
+}
+
 /*
  * Class:     ai_onnxruntime_OrtSession
  * Method:    endProfiling
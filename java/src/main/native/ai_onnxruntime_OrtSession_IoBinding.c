@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 Oracle and/or its affiliates. All rights reserved.
+ * Licensed under the MIT License.
+ */
+#include <jni.h>
+#include "onnxruntime/core/session/onnxruntime_c_api.h"
+#include "OrtJniUtil.h"
+#include "ai_onnxruntime_OrtSession_IoBinding.h"
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    createIoBinding
+ * Signature: (JJ)J
+ */
+JNIEXPORT jlong JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_createIoBinding
+  (JNIEnv * jniEnv, jclass jclazz, jlong apiHandle, jlong sessionHandle) {
+    (void) jclazz; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    OrtIoBinding* binding;
+    checkOrtStatus(jniEnv,api,api->CreateIoBinding((OrtSession*) sessionHandle,&binding));
+    return (jlong) binding;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    bindInput
+ * Signature: (JJLjava/lang/String;J)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_bindInput
+    (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle, jstring name, jlong valueHandle) {
+  (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+  const OrtApi* api = (const OrtApi*) apiHandle;
+  const char* nameStr = (*jniEnv)->GetStringUTFChars(jniEnv,name,NULL);
+  checkOrtStatus(jniEnv,api,api->BindInput((OrtIoBinding*) nativeHandle,nameStr,(const OrtValue*) valueHandle));
+  (*jniEnv)->ReleaseStringUTFChars(jniEnv,name,nameStr);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    bindOutput
+ * Signature: (JJLjava/lang/String;J)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_bindOutput
+    (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle, jstring name, jlong valueHandle) {
+  (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+  const OrtApi* api = (const OrtApi*) apiHandle;
+  const char* nameStr = (*jniEnv)->GetStringUTFChars(jniEnv,name,NULL);
+  checkOrtStatus(jniEnv,api,api->BindOutput((OrtIoBinding*) nativeHandle,nameStr,(const OrtValue*) valueHandle));
+  (*jniEnv)->ReleaseStringUTFChars(jniEnv,name,nameStr);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    clearBoundInputs
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_clearBoundInputs
+    (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle) {
+  (void) jniEnv; (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+  const OrtApi* api = (const OrtApi*) apiHandle;
+  api->ClearBoundInputs((OrtIoBinding*) nativeHandle);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    clearBoundOutputs
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_clearBoundOutputs
+    (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle) {
+  (void) jniEnv; (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+  const OrtApi* api = (const OrtApi*) apiHandle;
+  api->ClearBoundOutputs((OrtIoBinding*) nativeHandle);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    close
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_close
+    (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong handle) {
+  (void) jniEnv; (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+  const OrtApi* api = (const OrtApi*) apiHandle;
+  api->ReleaseIoBinding((OrtIoBinding*) handle);
+}
@@ -39,6 +39,7 @@ import java.util.Iterator;
 import java.util.List;
 import java.util.Map;
 import java.util.Set;
+import java.util.concurrent.ExecutionException;
 import java.util.concurrent.ExecutorService;
 import java.util.concurrent.Executors;
 import java.util.concurrent.TimeUnit;
@@ -453,6 +454,38 @@ public class InferenceTest {
     }
   }
 
+  @Test
+  public void runAsyncTest() throws OrtException, InterruptedException {
+    String modelPath = getResourcePath("/squeezenet.onnx").toString();
+
+    try (OrtEnvironment env = OrtEnvironment.getEnvironment("runAsyncTest");
+        SessionOptions options = new SessionOptions()) {
+      options.setIntraOpNumThreads(2);
+
+      try (OrtSession session = env.createSession(modelPath, options)) {
+        NodeInfo inputMeta = session.getInputInfo().values().iterator().next();
+        float[] inputData = loadTensorFromFile(getResourcePath("/bench.in"));
+        Object tensorData =
+            OrtUtil.reshape(inputData, ((TensorInfo) inputMeta.getInfo()).getShape());
+        try (OnnxTensor inputTensor = OnnxTensor.createTensor(env, tensorData)) {
+          Map<String, OnnxTensor> container = new HashMap<>();
+          container.put(inputMeta.getName(), inputTensor);
+
+          try (OrtSession.Result results =
+              session.runAsync(container, session.getOutputNames(), null).get()) {
+            assertEquals(1, results.size());
+            float[] expectedOutput = loadTensorFromFile(getResourcePath("/bench.expected_out"));
+            float[] resultArray =
+                TestHelpers.flattenFloat(((OnnxTensor) results.get(0)).getValue());
+            assertArrayEquals(expectedOutput, resultArray, 1e-6f);
+          } catch (ExecutionException e) {
+            fail("RunAsync failed: " + e.getCause());
+          }
+        }
+      }
+    }
+  }
+
   @Test
   public void throwWrongInputName() throws OrtException {
     SqueezeNetTuple tuple = openSessionSqueezeNet();
@@ -857,6 +890,63 @@ public class InferenceTest {
     }
   }
 
+  @Test
+  public void testIoBinding() throws OrtException {
+    // model takes 1x5 input of fixed type, echoes back
+    String modelPath = getResourcePath("/test_types_FLOAT.pb").toString();
+
+    try (OrtEnvironment env = OrtEnvironment.getEnvironment("testIoBinding");
+        SessionOptions options = new SessionOptions();
+        OrtSession session = env.createSession(modelPath, options)) {
+      String inputName = session.getInputNames().iterator().next();
+      String outputName = session.getOutputNames().iterator().next();
+      long[] shape = new long[] {1, 5};
+      FloatBuffer inputBuffer =
+          ByteBuffer.allocateDirect(5 * 4).order(ByteOrder.nativeOrder()).asFloatBuffer();
+      FloatBuffer outputBuffer =
+          ByteBuffer.allocateDirect(5 * 4).order(ByteOrder.nativeOrder()).asFloatBuffer();
+
+      try (OnnxTensor input = OnnxTensor.createTensor(env, inputBuffer, shape);
+          OnnxTensor output = OnnxTensor.createTensor(env, outputBuffer, shape);
+          OrtSession.IoBinding binding = session.createIoBinding()) {
+        binding.bindInput(inputName, input);
+        binding.bindOutput(outputName, output);
+        assertEquals(1, binding.getBoundInputs().size());
+        assertEquals(1, binding.getBoundOutputs().size());
+
+        // Refill the input buffer and read the output buffer on each run, reusing the tensors.
+        float[] outputArr = new float[5];
+        for (int i = 0; i < 3; i++) {
+          float[] inputArr = new float[] {i, -2.0f * i, 3.0f, -4.0f + i, 5.0f * i};
+          inputBuffer.rewind();
+          inputBuffer.put(inputArr);
+          session.run(binding);
+          outputBuffer.rewind();
+          outputBuffer.get(outputArr);
+          assertArrayEquals(inputArr, outputArr, 1e-6f);
+          float[] viewArr = new float[5];
+          output.getByteBufferView().asFloatBuffer().get(viewArr);
+          assertArrayEquals(inputArr, viewArr, 1e-6f);
+        }
+
+        try {
+          binding.bindInput("not_an_input", input);
+          fail("Should have thrown on an unknown input name");
+        } catch (OrtException e) {
+          // pass
+        }
+
+        binding.clearBoundOutputs();
+        try {
+          session.run(binding);
+          fail("Should have thrown without any bound outputs");
+        } catch (OrtException e) {
+          // pass
+        }
+      }
+    }
+  }
+
   @Test
   public void testRunOptions() throws OrtException {
     // model takes 1x5 input of fixed type, echoes back
@@ -20,6 +20,7 @@ BahdanauAttention<T>::BahdanauAttention(AllocatorPtr allocator, const logging::L
   values_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * memory_depth_, values_ptr_, true);
   keys_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, keys_ptr_, true);
   processed_query_ = Allocate(allocator_, batch_size_ * attn_depth_, processed_query_ptr_, true);
+  scores_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, scores_ptr_, true);
   mem_seq_lengths_ = Allocate(allocator_, batch_size_, mem_seq_lengths_ptr_, true);
 
   ORT_ENFORCE(!normalize_, "not support normalize yet.");
@@ -79,30 +80,6 @@ void BahdanauAttention<T>::PrepareMemory(
                   keys_.data(), attn_depth_, ttp_);
 }
 
-template <typename T>
-static void SoftmaxInplace(const gsl::span<T>& alignments) {
-  T* x = alignments.data();
-  size_t len = alignments.size();
-
-  double sum = 0.0;
-
-  for (size_t i = 0; i < len; i++) {
-    T e = exp(x[i]);
-    sum += e;
-    x[i] = e;
-  }
-
-  if (sum == 0.0) {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(1.0 / len);
-    }
-  } else {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(x[i] / sum);
-    }
-  }
-}
-
 /**
   * Args:
   *     queries: Tensor, shape `[batch_size_, query_depth_]` to compare to keys.
@@ -121,37 +98,41 @@ void BahdanauAttention<T>::Compute(
                   query_layer_weights_.data(), attn_depth_, T{0.0},
                   processed_query_.data(), attn_depth_, ttp_);
 
-  std::fill(aligns.begin(), aligns.end(), T{});
-
-  // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
-  for (int b = 0; b < batch_size_; b++) {
-    T* alignments = aligns.data() + b * max_memory_steps_;
-    const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
-    const T* query = processed_query_.data() + b * attn_depth_;
-
-    int mem_steps = mem_seq_lengths_[b];
-    for (int step = 0; step < mem_steps; step++) {
-      const T* keys_on_step = keys + step * attn_depth_;
-      T* dest = alignments + step;
-
-      // reduce_sum(v * tanh(keys[step] + query)) on last dimension
-      *dest = T(0.0);
-      for (int i = 0; i < attn_depth_; i++) {
-        *dest += (attention_v_[i] * tanh(keys_on_step[i] + query[i]));
-      }
-    }
-
-    SoftmaxInplace(gsl::span<T>{alignments, gsl::narrow_cast<gsl::index>(mem_steps)});
-
-    // Calculate the context
-    auto outspan = output.subspan(b * memory_depth_);
-    auto values = values_.subspan(b * max_memory_steps_ * memory_depth_);
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    1, memory_depth_, max_memory_steps_, T{1.0},
-                    alignments, max_memory_steps_,
-                    values.data(), memory_depth_, T{0.0},
-                    outspan.data(), memory_depth_, ttp_);
-  }
+  // The batch entries are independent, each one reads its keys and values once.
+  const double steps = static_cast<double>(max_memory_steps_);
+  const TensorOpCost cost{steps * (attn_depth_ + memory_depth_) * sizeof(T),  // keys and values
+                          (steps + memory_depth_) * sizeof(T),                // alignments and context
+                          steps * (attn_depth_ * 20.0 + memory_depth_ * 2.0)};  // tanh and multiply-adds
+
+  concurrency::ThreadPool::TryParallelFor(
+      ttp_, batch_size_, cost, [this, &aligns, &output](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto b = first; b < last; b++) {
+          T* alignments = aligns.data() + b * max_memory_steps_;
+          const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
+          const T* query = processed_query_.data() + b * attn_depth_;
+          T* scores = scores_.data() + b * max_memory_steps_ * attn_depth_;
+          const int mem_steps = mem_seq_lengths_[b];
+
+          // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
+          // tanh is vectorized over all of the steps, and the reduction is one GEMV with v.
+          for (int step = 0; step < mem_steps; step++) {
+            for (int i = 0; i < attn_depth_; i++) {
+              scores[step * attn_depth_ + i] = keys[step * attn_depth_ + i] + query[i];
+            }
+          }
+          MlasComputeTanh(scores, scores, static_cast<size_t>(mem_steps) * attn_depth_);
+          math::Gemv<T, CPUMathUtil>(CblasNoTrans, mem_steps, attn_depth_, 1.0f, scores, attention_v_.data(),
+                                     0.0f, alignments, nullptr);
+
+          MlasComputeSoftmax(alignments, alignments, 1, static_cast<size_t>(mem_steps), false, nullptr);
+          std::fill(alignments + mem_steps, alignments + max_memory_steps_, T{});
+
+          // Calculate the context from the steps within the memory sequence length, the others have no weight.
+          const T* values = values_.data() + b * max_memory_steps_ * memory_depth_;
+          math::Gemv<T, CPUMathUtil>(CblasTrans, mem_steps, memory_depth_, 1.0f, values, alignments,
+                                     0.0f, output.data() + b * memory_depth_, nullptr);
+        }
+      });
 }
 
 template class BahdanauAttention<float>;
@@ -23,6 +23,10 @@ class Attention : public OpKernel, public AttentionCPUBase {
   Status Compute(OpKernelContext* context) const override;
   Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
 
+  size_t PrePackedBytes() const override {
+    return packed_weights_ ? packed_weights_size_ * 3 * static_cast<size_t>(num_heads_) : 0;
+  }
+
  private:
   BufferUniquePtr packed_weights_;
   size_t packed_weights_size_;
@@ -46,19 +50,28 @@ AttentionBase::AttentionBase(const OpKernelInfo& info) {
   num_heads_ = static_cast<int>(num_heads);
 
   is_unidirectional_ = info.GetAttrOrDefault<int64_t>("unidirectional", 0) == 1;
+
+  past_present_share_buffer_ = info.GetAttrOrDefault<int64_t>("past_present_share_buffer", 0) == 1;
+
+  packed_tokens_ = info.GetAttrOrDefault<int64_t>("packed_tokens", 0) == 1;
+  ORT_ENFORCE(!(packed_tokens_ && past_present_share_buffer_),
+              "packed_tokens and past_present_share_buffer can't be used together.");
 }
 
 Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const TensorShape& weights_shape,
                                   const TensorShape& bias_shape,
                                   const Tensor*& mask_index,
-                                  const Tensor* past) const {
+                                  const Tensor* past,
+                                  const Tensor* past_seq_len) const {
   // Input shapes:
   //   input       : (batch_size, sequence_length, hidden_size)
   //   weights     : (hidden_size, 3 * hidden_size)
   //   bias        : (3 * hidden_size)
   //   mask_index  : nullptr, (batch_size), (2 * batch_size), (batch_size, 1), (1, 1) or (batch_size, past_sequence_length + sequence_length)
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
+  //                 or (2, batch_size, num_heads, max_sequence_length, head_size) if past_present_share_buffer_
+  //   past_seq_len: scalar if past_present_share_buffer_
 
   const auto& dims = input_shape.GetDims();
   if (dims.size() != 3) {
@@ -96,6 +109,23 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                            "Input 'bias' dimension 0 should have same length as dimension 1 of input 'weights'");
   }
 
+  if (packed_tokens_) {
+    // The tokens of all of the sequences are packed into the sequence dimension, with the length of each sequence in
+    // mask_index.
+    if (batch_size != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'input' shall have shape (1, total_tokens, hidden_size) when packed_tokens is 1");
+    }
+    if (mask_index == nullptr || mask_index->Shape().NumDimensions() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'mask_index' with the sequence lengths is required when packed_tokens is 1");
+    }
+    if (past != nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past' is not supported when packed_tokens is 1");
+    }
+    return Status::OK();
+  }
+
   int past_sequence_length = 0;
   if (past != nullptr) {  // past is optional
     const auto& past_dims = past->Shape().GetDims();
@@ -118,6 +148,25 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
     past_sequence_length = static_cast<int>(past_dims[3]);
   }
 
+  if (past_present_share_buffer_) {
+    if (past == nullptr || past_seq_len == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'past' and 'past_sequence_length' are required when past_present_share_buffer is 1");
+    }
+    if (past_seq_len->Shape().Size() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' shall be a scalar");
+    }
+
+    // past holds the maximum sequence length, of which the first past_sequence_length positions are used
+    const int max_sequence_length = past_sequence_length;
+    past_sequence_length = *past_seq_len->Data<int32_t>();
+    if (past_sequence_length < 0 || past_sequence_length + sequence_length > max_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' is ", past_sequence_length,
+                             ", the new tokens don't fit into 'past' with a maximum sequence length of ",
+                             max_sequence_length);
+    }
+  }
+
   if (mask_index != nullptr) {  // mask_index is optional
     const auto& mask_dims = mask_index->Shape().GetDims();
     if (mask_dims.size() == 1) {
@@ -142,18 +191,50 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
   return Status::OK();
 }
 
+Status AttentionBase::GetTokenOffsets(const int32_t* sequence_lengths,
+                                      int batch_size,
+                                      int total_tokens,
+                                      std::vector<int>& token_offsets,
+                                      int& max_sequence_length) {
+  token_offsets.resize(static_cast<size_t>(batch_size) + 1);
+  token_offsets[0] = 0;
+  max_sequence_length = 0;
+  for (int b = 0; b < batch_size; b++) {
+    if (sequence_lengths[b] < 0 || sequence_lengths[b] > total_tokens - token_offsets[b]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'mask_index' has the invalid sequence length ",
+                             sequence_lengths[b], " for the ", total_tokens, " packed tokens");
+    }
+    token_offsets[b + 1] = token_offsets[b] + sequence_lengths[b];
+    max_sequence_length = std::max(max_sequence_length, static_cast<int>(sequence_lengths[b]));
+  }
+
+  if (token_offsets[batch_size] != total_tokens) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The sequence lengths in 'mask_index' add up to ",
+                           token_offsets[batch_size], " tokens, but 'input' has ", total_tokens, " packed tokens");
+  }
+
+  return Status::OK();
+}
+
 Tensor* AttentionBase::GetPresent(OpKernelContext* context,
                                   const Tensor* past,
                                   int batch_size,
                                   int head_size,
                                   int sequence_length,
-                                  int& past_sequence_length) const {
+                                  int& past_sequence_length,
+                                  const Tensor* past_seq_len) const {
   // Input and output shapes:
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
   //   present     : (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)
+  // or if past_present_share_buffer_, with past_sequence_length from past_seq_len:
+  //   past        : (2, batch_size, num_heads, max_sequence_length, head_size)
+  //   present     : (2, batch_size, num_heads, max_sequence_length, head_size)
 
   std::vector<int64_t> present_dims{2, batch_size, num_heads_, sequence_length, head_size};
-  if (nullptr != past) {
+  if (past_present_share_buffer_) {
+    present_dims = past->Shape().GetDims();
+    past_sequence_length = *past_seq_len->Data<int32_t>();
+  } else if (nullptr != past) {
     const auto& past_dims = past->Shape().GetDims();
     past_sequence_length = static_cast<int>(past_dims[3]);
     present_dims[3] += past_dims[3];
@@ -170,6 +251,7 @@ Tensor* AttentionBase::GetPresent(OpKernelContext* context,
 
 template <typename T>
 Attention<T>::Attention(const OpKernelInfo& info) : OpKernel(info), AttentionCPUBase(info) {
+  ORT_ENFORCE(!past_present_share_buffer_, "past_present_share_buffer is only supported by the CUDA Attention kernel.");
 }
 
 
@@ -233,11 +315,24 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
                                   past));
 
   const auto& shape = input->Shape().GetDims();
-  const int batch_size = static_cast<int>(shape[0]);
-  const int sequence_length = static_cast<int>(shape[1]);
+  int batch_size = static_cast<int>(shape[0]);
+  int sequence_length = static_cast<int>(shape[1]);
   const int hidden_size = static_cast<int>(shape[2]);
   const int head_size = hidden_size / num_heads_;
 
+  // With packed tokens, sequence b is the tokens from token_offsets[b] to token_offsets[b + 1] of the input and
+  // sequence_length is the length of the longest sequence.
+  std::vector<int> token_offsets;
+  if (packed_tokens_) {
+    ORT_RETURN_IF_NOT(context->OutputCount() < 2, "Output 'present' is not supported when packed_tokens is 1");
+    batch_size = static_cast<int>(mask_index->Shape()[0]);
+    ORT_RETURN_IF_ERROR(GetTokenOffsets(mask_index->template Data<int32_t>(), batch_size, sequence_length,
+                                        token_offsets, sequence_length));
+  }
+
+  // Number of tokens of the input, which is batch_size * sequence_length unless the tokens are packed
+  const int total_tokens = static_cast<int>(shape[0] * shape[1]);
+
   Tensor* output = context->Output(0, shape);
 
   constexpr size_t element_size = sizeof(T);
@@ -248,12 +343,12 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   auto* tp = context->GetOperatorThreadPool();
   // Compute Q, K, V
   // gemm_data(BS, 3NH) = input(BS, NH) x weights(NH, 3NH) + bias(3NH)
-  auto gemm_data = allocator->Alloc(SafeInt<size_t>(batch_size) * sequence_length * 3 * hidden_size * element_size);
+  auto gemm_data = allocator->Alloc(SafeInt<size_t>(total_tokens) * 3 * hidden_size * element_size);
   BufferUniquePtr gemm_buffer(gemm_data, BufferDeleter(allocator));
 
   auto Q = reinterpret_cast<T*>(gemm_data);
-  auto K = Q + batch_size * sequence_length * hidden_size;
-  auto V = K + batch_size * sequence_length * hidden_size;
+  auto K = Q + total_tokens * hidden_size;
+  auto V = K + total_tokens * hidden_size;
   T* QKV[3] = {Q, K, V};
 
   {
@@ -270,15 +365,20 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
         const int head_index = static_cast<int>((i / 3) % num_heads_);
         const int qkv_index = static_cast<int>(i % 3);
 
-        int input_offset = batch_index * sequence_length * hidden_size;
+        // Each sequence is laid out as NxSxH in Q, K and V, also when the sequences of the packed tokens differ in
+        // length.
+        const int token_offset = packed_tokens_ ? token_offsets[batch_index] : batch_index * sequence_length;
+        const int token_count = packed_tokens_ ? token_offsets[batch_index + 1] - token_offset : sequence_length;
+
+        int input_offset = token_offset * hidden_size;
         int weights_offset = qkv_index * hidden_size + head_index * head_size;
         T* qkv_dest = QKV[qkv_index];
-        int qkv_offset = (batch_index * num_heads_ + head_index) * (sequence_length * head_size);
+        int qkv_offset = token_offset * hidden_size + head_index * (token_count * head_size);
 
         // broadcast 3NH -> (3.B.N.S.H)
         const T* broadcast_data_src = bias_data + weights_offset;
         T* broadcast_data_dest = QKV[qkv_index] + qkv_offset;
-        for (int seq_index = 0; seq_index < sequence_length; seq_index++) {
+        for (int seq_index = 0; seq_index < token_count; seq_index++) {
           memcpy(broadcast_data_dest, broadcast_data_src, head_size * sizeof(T));
           broadcast_data_dest += head_size;
         }
@@ -292,7 +392,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
               static_cast<const uint8_t*>(packed_weights_.get()) + packed_weights_size_ * (weights_offset / head_size);
           MlasGemm(
               CblasNoTrans,               // TransA = no
-              sequence_length,            // M      = S
+              token_count,                // M      = S
               head_size,                  // N      = H
               hidden_size,                // K      = NH
               1.0f,                       // alpha
@@ -306,7 +406,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
         } else {
           math::GemmEx<float, ThreadPool>(CblasNoTrans,                   // TransA = no
                                           CblasNoTrans,                   // TransB = no
-                                          sequence_length,                // M      = S
+                                          token_count,                    // M      = S
                                           head_size,                      // N      = H
                                           hidden_size,                    // K      = NH
                                           1.0f,                           // alpha
@@ -324,7 +424,21 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
     });
   }
 
-  // Compute the attention score and apply the score to V
+  // Compute the attention score and apply the score to V, over each sequence by itself when the tokens are packed.
+  if (packed_tokens_) {
+    T* output_data = output->template MutableData<T>();
+    for (int b = 0; b < batch_size; b++) {
+      const int token_count = token_offsets[b + 1] - token_offsets[b];
+      if (token_count == 0) {
+        continue;
+      }
+      const size_t offset = static_cast<size_t>(token_offsets[b]) * hidden_size;
+      ORT_RETURN_IF_ERROR(ApplyAttention(Q + offset, K + offset, V + offset, nullptr, nullptr, output_data + offset,
+                                         1, token_count, head_size, hidden_size, context));
+    }
+    return Status::OK();
+  }
+
   return ApplyAttention(Q, K, V, mask_index, past, output,
                         batch_size, sequence_length,
                         head_size, hidden_size, context);
@@ -17,17 +17,29 @@ class AttentionBase {
                      const TensorShape& weights_shape,
                      const TensorShape& bias_shape,
                      const Tensor*& mask_index,  // For dummy mask with shape (1, 1) or (batch_size, 1), it will be updated to nullptr.
-                     const Tensor* past) const;
+                     const Tensor* past,
+                     const Tensor* past_seq_len = nullptr) const;  // Required if past_present_share_buffer_
 
   Tensor* GetPresent(OpKernelContext* context,
                      const Tensor* past,
                      int batch_size,
                      int head_size,
                      int sequence_length,
-                     int& past_sequence_length) const;
-
-  int num_heads_;           // number of attention heads
-  bool is_unidirectional_;  // whether every token can only attend to previous tokens.
+                     int& past_sequence_length,
+                     const Tensor* past_seq_len = nullptr) const;
+
+  // Computes the offsets (batch_size + 1) of the sequences of the packed tokens from their lengths in mask_index, and
+  // the length of the longest sequence.
+  static Status GetTokenOffsets(const int32_t* sequence_lengths,
+                                int batch_size,
+                                int total_tokens,
+                                std::vector<int>& token_offsets,
+                                int& max_sequence_length);
+
+  int num_heads_;                   // number of attention heads
+  bool is_unidirectional_;          // whether every token can only attend to previous tokens.
+  bool past_present_share_buffer_;  // whether present is past with the new keys and values appended in place.
+  bool packed_tokens_;              // whether input is (1, total_tokens, hidden_size) with the sequences unpadded.
 };
 
 }  // namespace contrib
@@ -15,6 +15,10 @@ namespace contrib {
 
 class AttentionCPUBase : public AttentionBase {
  protected:
+  // Total sequence length (S*) from which the attention is computed over blocks of keys with an online softmax
+  // instead of materializing the attention probs.
+  static constexpr int kTiledAttentionMinSequenceLength = 256;
+
   AttentionCPUBase(const OpKernelInfo& info) : AttentionBase(info) {}
 
   template <typename T>
@@ -29,6 +33,23 @@ class AttentionCPUBase : public AttentionBase {
                         int head_size,             // head size
                         int hidden_size,           // hidden size
                         OpKernelContext* context) const {
+    return ApplyAttention(Q, K, V, mask_index, past, output->template MutableData<T>(),
+                          batch_size, sequence_length, head_size, hidden_size, context);
+  }
+
+  // ApplyAttention writing the output (BxSxNH) to output_data, such as a sequence of the packed tokens of a batch.
+  template <typename T>
+  Status ApplyAttention(const T* Q,                // Q data. Its size is BxNxSxH
+                        const T* K,                // K data. Its size is BxNxSxH
+                        const T* V,                // V value with size BxNxSxH
+                        const Tensor* mask_index,  // mask index. nullptr if no mask or its size is B
+                        const Tensor* past,        // past state
+                        T* output_data,            // output data. Its size is BxSxNH
+                        int batch_size,            // batch size
+                        int sequence_length,       // sequence length
+                        int head_size,             // head size
+                        int hidden_size,           // hidden size
+                        OpKernelContext* context) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
@@ -40,6 +61,30 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: S* = S' + S
     const int all_sequence_length = past_sequence_length + sequence_length;
 
+    const int32_t* mask_index_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
+    const std::vector<int64_t>* mask_index_dims = mask_index != nullptr ? &(mask_index->Shape().GetDims()) : nullptr;
+    const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
+    T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
+
+    // For long sequences don't materialize the BxNxSxS* attention probs, as they dominate the memory usage.
+    if (all_sequence_length >= kTiledAttentionMinSequenceLength) {
+      void* key_mask = nullptr;
+      if (mask_index != nullptr) {
+        // the mask index only depends on the batch and the key position: (B)xS*
+        size_t key_mask_bytes = SafeInt<size_t>(batch_size) * all_sequence_length * sizeof(T);
+        key_mask = allocator->Alloc(key_mask_bytes);
+        memset(key_mask, 0, key_mask_bytes);
+        PrepareMask(mask_index_data, mask_index_dims, static_cast<T*>(key_mask), false,
+                    batch_size, 1, all_sequence_length - 1);
+      }
+      BufferUniquePtr key_mask_buffer(key_mask, BufferDeleter(allocator));
+
+      ComputeTiledAttention(output_data, Q, K, V, static_cast<T*>(key_mask),
+                            batch_size, sequence_length, past_sequence_length, head_size, hidden_size,
+                            past_data, present_data, allocator, tp);
+      return Status::OK();
+    }
+
     // Compute the attention score. It does 2 things:
     //         I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
     //                                           1 x mask_data(B, N, S, S*)
@@ -56,11 +101,6 @@ class AttentionCPUBase : public AttentionBase {
     }
     BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
 
-    const int32_t* mask_index_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
-    const std::vector<int64_t>* mask_index_dims = mask_index != nullptr ? &(mask_index->Shape().GetDims()) : nullptr;
-    const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
-    T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
-
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data),
                              batch_size, sequence_length, past_sequence_length, head_size,
@@ -71,7 +111,7 @@ class AttentionCPUBase : public AttentionBase {
         allocator->Alloc(SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * head_size * sizeof(T));
     BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
 
-    ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
+    ComputeVxAttentionScore(output_data, static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
                             batch_size, sequence_length, past_sequence_length, head_size, hidden_size,
                             past_data, present_data, tp);
 
@@ -105,8 +145,6 @@ class AttentionCPUBase : public AttentionBase {
     {
       if (mask_data != nullptr) {
         PrepareMask(mask_index, mask_index_dims, mask_data, is_unidirectional_, batch_size, sequence_length, past_sequence_length);
-      } else {  // no any mask
-        memset(attention_probs, 0, batch_size * num_heads_ * sequence_length * all_sequence_length * sizeof(T));
       }
 
       const int loop_len = batch_size * num_heads_;
@@ -117,15 +155,6 @@ class AttentionCPUBase : public AttentionBase {
 
       ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
         for (std::ptrdiff_t i = begin; i != end; ++i) {
-          const std::ptrdiff_t batch_index = i / num_heads_;
-
-          // broadcast mask data: (Bx)SxS* -> (BxNx)SxS*
-          if (mask_data != nullptr) {
-            const T* broadcast_data_src = reinterpret_cast<T*>(mask_data) + batch_index * sequence_length * all_sequence_length;
-            T* broadcast_data_dest = reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i;
-            memcpy(broadcast_data_dest, broadcast_data_src, sequence_length * all_sequence_length * sizeof(T));
-          }
-
           const T* k = K + input_chunk_length * i;
           if (nullptr != present) {
             // concatenate past_K and K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
@@ -138,20 +167,174 @@ class AttentionCPUBase : public AttentionBase {
           // B: K'               (B x N x) S* x H         (B x N x) H x S*       H x S*
           // C: attention_probs  (B x N x) S x S*         (B x N x) S x S*       S x S*
           math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, all_sequence_length, head_size, alpha,
-                                    Q + input_chunk_length * i, k, 1.0,
+                                    Q + input_chunk_length * i, k, 0.0,
                                     reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i, nullptr);
         }
       });
     }
 
-    //  attention_probs(B, N, S, S*) = Softmax(attention_probs)
+    //  attention_probs(B, N, S, S*) = Softmax(attention_probs + mask_data)
+    //  the mask is broadcast from (Bx)SxS* to (BxNx)SxS* in the softmax instead of being copied for every head.
     {
       const int N = batch_size * num_heads_ * sequence_length;
       const int D = all_sequence_length;
-      ComputeAttentionSoftmaxInplace(attention_probs, N, D, tp);
+      ComputeAttentionSoftmaxInplace(attention_probs, N, D, static_cast<const T*>(mask_data), sequence_length,
+                                     num_heads_, tp);
     }
   }
 
+  // Helper function to compute the attention without materializing the attention probs, like flash attention.
+  // Every task handles a block of queries of one head, and iterates over blocks of keys:
+  //   scores(Sq, Sk) = 1/sqrt(H) x Q(Sq, H) x K'(Sk, H -> H, Sk) + mask(Sq, Sk)
+  //   the row max m, the row sum l of e^(scores - m) and the output rows are rescaled if m increases
+  //   output(Sq, H) += e^(scores - m) x V(Sk, H)
+  // and the output rows are divided by l at the end. The output is written to its BxSxNxH location directly.
+  template <typename T>
+  void ComputeTiledAttention(T* output,                 // output with size BxSxNxH
+                             const T* Q,                // Q data with size BxNxSxH
+                             const T* K,                // K data with size BxNxSxH
+                             const T* V,                // V data with size BxNxSxH
+                             const T* key_mask,         // mask of the keys with size BxS*. nullptr if no mask index
+                             int batch_size,            // batch size
+                             int sequence_length,       // sequence length
+                             int past_sequence_length,  // sequence length in past state
+                             int head_size,             // head size
+                             int hidden_size,           // hidden size
+                             const T* past,             // past state
+                             T* present,                // present state
+                             AllocatorPtr allocator,
+                             ThreadPool* tp) const {
+    constexpr int query_block_size = 64;
+    constexpr int key_block_size = 128;
+
+    const int all_sequence_length = past_sequence_length + sequence_length;                  // S* = S' + S
+    const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
+    const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
+    const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const int loop_len = batch_size * num_heads_;
+
+    if (nullptr != present) {
+      // concatenate past_K and K, and past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
+      const T* past_v = past != nullptr ? past + loop_len * past_chunk_length : nullptr;
+      T* present_v = present + loop_len * present_chunk_length;
+      ThreadPool::TryParallelFor(tp, loop_len, static_cast<double>(present_chunk_length) * 2,
+                                 [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                                   for (std::ptrdiff_t i = begin; i != end; ++i) {
+                                     ConcatStateChunk(past, K + input_chunk_length * i, present,
+                                                      past_chunk_length, present_chunk_length, i);
+                                     ConcatStateChunk(past_v, V + input_chunk_length * i, present_v,
+                                                      past_chunk_length, present_chunk_length, i);
+                                   }
+                                 });
+      K = present;
+      V = present_v;
+    }
+
+    // K and V now have S* rows per head
+    const size_t kv_chunk_length = nullptr != present ? present_chunk_length : input_chunk_length;
+    const int num_query_blocks = (sequence_length + query_block_size - 1) / query_block_size;
+    const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+
+    // The cost of the two Gemms of a block of queries
+    const double cost = 2.0 * query_block_size * all_sequence_length * head_size;
+
+    ThreadPool::TryParallelFor(tp, loop_len * num_query_blocks, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // scores of a block of queries and keys, followed by the row max and row sum of the block of queries
+      const size_t scratch_bytes = SafeInt<size_t>(query_block_size) * (key_block_size + 2) * sizeof(T);
+      BufferUniquePtr scratch_buffer(allocator->Alloc(scratch_bytes), BufferDeleter(allocator));
+      T* scores = static_cast<T*>(scratch_buffer.get());
+      T* row_max = scores + query_block_size * key_block_size;
+      T* row_sum = row_max + query_block_size;
+
+      for (std::ptrdiff_t task = begin; task != end; ++task) {
+        const std::ptrdiff_t i = task / num_query_blocks;
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        const int query_begin = static_cast<int>(task % num_query_blocks) * query_block_size;
+        const int query_rows = std::min(query_block_size, sequence_length - query_begin);
+
+        const T* q = Q + input_chunk_length * i + query_begin * head_size;
+        const T* k = K + kv_chunk_length * i;
+        const T* v = V + kv_chunk_length * i;
+        const T* mask = key_mask != nullptr ? key_mask + batch_index * all_sequence_length : nullptr;
+        T* out = output + (batch_index * sequence_length + query_begin) * hidden_size + head_index * head_size;
+
+        // with the unidirectional mask the keys after the last query of the block are masked in every row.
+        // they are masked once more than the keys before them, so their exponent underflows to 0 and they are skipped.
+        const int key_end = is_unidirectional_
+                                ? std::min(all_sequence_length, past_sequence_length + query_begin + query_rows)
+                                : all_sequence_length;
+
+        for (int r = 0; r < query_rows; r++) {
+          row_max[r] = -std::numeric_limits<T>::infinity();
+          row_sum[r] = 0;
+          memset(out + r * hidden_size, 0, head_size * sizeof(T));
+        }
+
+        for (int key_begin = 0; key_begin < key_end; key_begin += key_block_size) {
+          const int key_cols = std::min(key_block_size, key_end - key_begin);
+
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, query_rows, key_cols, head_size, alpha,
+                                      q, head_size, k + key_begin * head_size, head_size, 0.0f,
+                                      scores, key_block_size, nullptr);
+
+          for (int r = 0; r < query_rows; r++) {
+            T* row = scores + r * key_block_size;
+            if (mask != nullptr) {
+              for (int c = 0; c < key_cols; c++) {
+                row[c] += mask[key_begin + c];
+              }
+            }
+
+            if (is_unidirectional_) {
+              for (int c = std::max(0, past_sequence_length + query_begin + r + 1 - key_begin); c < key_cols; c++) {
+                row[c] += static_cast<T>(-10000.0f);
+              }
+            }
+
+            T block_max = row_max[r];
+            for (int c = 0; c < key_cols; c++) {
+              block_max = std::max(block_max, row[c]);
+            }
+
+            for (int c = 0; c < key_cols; c++) {
+              row[c] -= block_max;
+            }
+            MlasComputeExp(row, row, key_cols);
+
+            T block_sum = 0;
+            for (int c = 0; c < key_cols; c++) {
+              block_sum += row[c];
+            }
+
+            if (block_max != row_max[r]) {
+              const T scale = expf(row_max[r] - block_max);
+              T* out_row = out + r * hidden_size;
+              for (int h = 0; h < head_size; h++) {
+                out_row[h] *= scale;
+              }
+              row_sum[r] *= scale;
+              row_max[r] = block_max;
+            }
+            row_sum[r] += block_sum;
+          }
+
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, query_rows, head_size, key_cols, 1.0f,
+                                      scores, key_block_size, v + key_begin * head_size, head_size, 1.0f,
+                                      out, hidden_size, nullptr);
+        }
+
+        for (int r = 0; r < query_rows; r++) {
+          const T inv_sum = 1.0f / row_sum[r];
+          T* out_row = out + r * hidden_size;
+          for (int h = 0; h < head_size; h++) {
+            out_row[h] *= inv_sum;
+          }
+        }
+      }
+    });
+  }
+
   template <typename T>
   void ComputeVxAttentionScore(T* output,                 // buffer for the result with size BxSxNxH
                                T* tmp_buffer,             // buffer for temp use with size is BxNxSxH
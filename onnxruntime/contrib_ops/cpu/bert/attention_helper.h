@@ -14,13 +14,26 @@ using onnxruntime::concurrency::ThreadPool;
 namespace onnxruntime {
 namespace contrib {
 
+// Computes the softmax of the N rows of D scores in place after adding the mask, if any. Row j uses the mask row
+// (j / (mask_row_count x mask_broadcast_count)) x mask_row_count + j % mask_row_count, so a (B)xSxS* mask is
+// broadcast over the N heads of (BxN)xSxS* scores with mask_row_count=S and mask_broadcast_count=N.
 template <typename T>
-void ComputeAttentionSoftmaxInplace(T* score, int N, int D, ThreadPool* tp) {
+void ComputeAttentionSoftmaxInplace(T* score, int N, int D, const T* mask, int mask_row_count,
+                                    int mask_broadcast_count, ThreadPool* tp) {
   ThreadPool::TryParallelFor(tp, N, D * 2.0, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
     for (std::ptrdiff_t j = begin; j != end; ++j) {
       float* x = reinterpret_cast<T*>(score) + j * D;
       float* y = x;
 
+      if (mask != nullptr) {
+        const std::ptrdiff_t mask_row = (j / (mask_row_count * mask_broadcast_count)) * mask_row_count +
+                                        j % mask_row_count;
+        const T* m = mask + mask_row * D;
+        for (int i = 0; i < D; i++) {
+          x[i] += m[i];
+        }
+      }
+
       // e^x is represented as infinity if x is large enough, like 100.f.
       // Infinity divided by Infinity is a NAN. Thus, softmax gets a NAN if
       // one or more item are large enough. a math transform as below is
@@ -55,8 +68,9 @@ void ComputeAttentionSoftmaxInplace(T* score, int N, int D, ThreadPool* tp) {
 }
 
 template <>
-inline void ComputeAttentionSoftmaxInplace(float* score, int N, int D, ThreadPool* tp) {
-  MlasComputeSoftmax(score, score, N, D, false, tp);
+inline void ComputeAttentionSoftmaxInplace(float* score, int N, int D, const float* mask, int mask_row_count,
+                                           int mask_broadcast_count, ThreadPool* tp) {
+  MlasComputeMaskedSoftmax(score, score, N, D, 1.0f, mask, mask_row_count, mask_broadcast_count, false, tp);
 }
 
 template <typename T>
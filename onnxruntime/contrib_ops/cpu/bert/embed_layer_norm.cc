@@ -3,6 +3,7 @@
 
 #include "embed_layer_norm.h"
 #include "embed_layer_norm_helper.h"
+#include "contrib_ops/cpu/layer_norm_helper.h"
 #include "core/util/math_cpuonly.h"
 #include "core/platform/threadpool.h"
 
@@ -28,6 +29,7 @@ template <typename T>
 EmbedLayerNorm<T>::EmbedLayerNorm(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {
   ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
   ORT_ENFORCE(epsilon_ >= 0);
+  packed_tokens_ = op_kernel_info.GetAttrOrDefault<int64_t>("packed_tokens", 0) == 1;
 }
 
 template <typename T>
@@ -45,14 +47,43 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   const auto& input_dims = input_ids->Shape().GetDims();
   int64_t hidden_size = word_embedding->Shape()[1];
 
-  TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
-  Tensor* output = context->Output(0, output_shape);
+  if (packed_tokens_ && nullptr == mask) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'mask' is required when packed_tokens is 1");
+  }
+
+  int batch_size = static_cast<int>(input_dims[0]);
+  int sequence_length = static_cast<int>(input_dims[1]);
 
   TensorShape mask_index_shape({input_dims[0]});
   Tensor* mask_index = context->Output(1, mask_index_shape);
+  int32_t* mask_index_data = mask_index->template MutableData<int32_t>();
 
-  int batch_size = static_cast<int>(input_dims[0]);
-  int sequence_length = static_cast<int>(input_dims[1]);
+  // Calculate mask
+  if (nullptr != mask) {
+    const int32_t* mask_data = mask->template Data<int32_t>();
+    for (int b = 0; b < batch_size; b++) {
+      mask_index_data[b] = static_cast<int32_t>(std::count_if(mask_data + (b * sequence_length),
+                                                              mask_data + (b * sequence_length) + sequence_length,
+                                                              [](int v) { return v == 1; }));
+    }
+  } else {
+    memset(mask_index_data, 0, batch_size * sizeof(int32_t));
+  }
+
+  // With packed tokens, output token i is the token token_indices[i] of the (batch_size, sequence_length) input.
+  std::vector<int> token_indices;
+  if (packed_tokens_) {
+    for (int b = 0; b < batch_size; b++) {
+      for (int s = 0; s < mask_index_data[b]; s++) {
+        token_indices.push_back(b * sequence_length + s);
+      }
+    }
+  }
+
+  TensorShape output_shape = packed_tokens_
+                                 ? TensorShape({1, static_cast<int64_t>(token_indices.size()), hidden_size})
+                                 : TensorShape({input_dims[0], input_dims[1], hidden_size});
+  Tensor* output = context->Output(0, output_shape);
 
   int word_embedding_length = static_cast<int>(word_embedding->Shape()[0]);
   int position_embedding_length = static_cast<int>(position_embedding->Shape()[0]);
@@ -71,8 +102,11 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   {
     std::atomic_bool failed{false};
 
-    int n = batch_size * sequence_length;
-    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), n, [=, &failed](ptrdiff_t index) {
+    int n = packed_tokens_ ? static_cast<int>(token_indices.size()) : batch_size * sequence_length;
+    const int* token_indices_data = token_indices.data();
+    const bool packed_tokens = packed_tokens_;
+    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), n, [=, &failed](ptrdiff_t i) {
+      const ptrdiff_t index = packed_tokens ? token_indices_data[i] : i;
       int word_col_index = input_ids_data[index];
       if (word_col_index < 0 || word_col_index >= word_embedding_length) {
         failed.store(true, std::memory_order_release);
@@ -92,30 +126,13 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
         }
       }
 
-      T* y = output_data + index * hidden_size;
       const T* input_word_embedding = word_embedding_data + word_col_index * hidden_size;
       const T* input_position_embedding = position_embedding_data + position_col_index * hidden_size;
       const T* input_segment_embedding = (nullptr == segment_embedding_data) ? nullptr : segment_embedding_data + segment_col_index * hidden_size;
 
-      T sum = static_cast<T>(0);
-      for (int i = 0; i < hidden_size; i++) {
-        T subtotal = input_word_embedding[i] + input_position_embedding[i];
-        if (nullptr != segment_embedding_data)
-          subtotal += input_segment_embedding[i];
-        y[i] = subtotal;
-        sum += subtotal;
-      }
-      T mean = sum / hidden_size;
-      sum = 0;
-      for (int i = 0; i < hidden_size; i++) {
-        T a = y[i] - mean;
-        y[i] = a;
-        sum += a * a;
-      }
-      T e = sqrt(sum / hidden_size + static_cast<T>(epsilon_));
-      for (int i = 0; i < hidden_size; i++) {
-        y[i] = y[i] / e * gamma_data[i] + beta_data[i];
-      }
+      layer_norm::ComputeRow<T>(input_word_embedding, input_position_embedding, input_segment_embedding,
+                                gamma_data, beta_data, output_data + i * hidden_size, hidden_size, epsilon_,
+                                false, nullptr, nullptr);
     }, 0);
 
     if (failed.load(std::memory_order_acquire)) {
@@ -123,18 +140,6 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
     }
   }
 
-  // Calculate mask
-  if (nullptr != mask) {
-    const int32_t* mask_data = mask->template Data<int32_t>();
-    for (int b = 0; b < batch_size; b++) {
-      mask_index->template MutableData<int32_t>()[b] = static_cast<int32_t>(std::count_if(mask_data + (b * sequence_length),
-                                                                                          mask_data + (b * sequence_length) + sequence_length,
-                                                                                          [](int v) { return v == 1; }));
-    }
-  } else {
-    memset(mask_index->template MutableData<int32_t>(), 0, batch_size * sizeof(int32_t));
-  }
-
   return Status::OK();
 }
 
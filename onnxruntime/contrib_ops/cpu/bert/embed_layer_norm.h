@@ -15,6 +15,7 @@ class EmbedLayerNorm : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
  private:
   float epsilon_;
+  bool packed_tokens_;  // whether to pack the first mask_index tokens of the sequences into (1, total_tokens, hidden)
 };
 }  // namespace contrib
 }  // namespace onnxruntime
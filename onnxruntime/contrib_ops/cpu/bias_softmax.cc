@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bias_softmax.h"
+
+#include "core/providers/common.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    BiasSoftmax,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    BiasSoftmax);
+
+Status BiasSoftmax::Compute(OpKernelContext* ctx) const {
+  const Tensor* X = ctx->Input<Tensor>(0);
+  const Tensor* B = ctx->Input<Tensor>(1);
+  const TensorShape& X_shape = X->Shape();
+  Tensor* Y = ctx->Output(0, X_shape);
+
+  const size_t rank = X_shape.NumDimensions();
+  const size_t softmax_axis = static_cast<size_t>(HandleNegativeAxis(softmax_axis_, rank));
+  const size_t broadcast_axis = static_cast<size_t>(HandleNegativeAxis(broadcast_axis_, rank));
+  if (broadcast_axis > softmax_axis) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "broadcast_axis ", broadcast_axis_,
+                           " should not be after softmax_axis ", softmax_axis_);
+  }
+
+  const size_t N = static_cast<size_t>(X_shape.SizeToDimension(softmax_axis));
+  const size_t D = static_cast<size_t>(X_shape.SizeFromDimension(softmax_axis));
+  if (N == 0 || D == 0) {
+    return Status::OK();
+  }
+
+  // the bias holds one row for every broadcast_size rows of the input
+  const size_t broadcast_size = N / static_cast<size_t>(X_shape.SizeToDimension(broadcast_axis));
+  if (static_cast<size_t>(B->Shape().Size()) != N / broadcast_size * D) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "bias of shape ", B->Shape(),
+                           " can't be broadcast to the input of shape ", X_shape);
+  }
+
+  MlasComputeMaskedSoftmax(X->Data<float>(), Y->MutableData<float>(), N, D, 1.0f, B->Data<float>(), 1,
+                           broadcast_size, false, ctx->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = softmax(X + B) where B is repeated every broadcast_size rows of X, see the BiasSoftmax schema.
+class BiasSoftmax final : public OpKernel {
+ public:
+  explicit BiasSoftmax(const OpKernelInfo& info) : OpKernel(info) {
+    softmax_axis_ = info.GetAttrOrDefault<int64_t>("softmax_axis", 1);
+    broadcast_axis_ = info.GetAttrOrDefault<int64_t>("broadcast_axis", 1);
+  }
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  int64_t softmax_axis_;
+  int64_t broadcast_axis_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
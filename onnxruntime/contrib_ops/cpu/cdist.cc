@@ -8,6 +8,10 @@
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace onnxruntime {
 namespace contrib {
 #define DEFINE_KERNEL(data_type)                                                                                  \
@@ -17,8 +21,52 @@ namespace contrib {
 DEFINE_KERNEL(float);
 DEFINE_KERNEL(double);
 
+// the output is computed in tiles that are handed out to the threads. the GEMM result for a tile is still in cache
+// when the distances are computed from it, and the rows of B for a tile are reused by all the rows of A in it.
+constexpr int64_t kTileRows = 64;
+constexpr int64_t kTileCols = 256;
+
+// C = alpha * A * B^T for a tile. A is {m, k}, B is {n, k} and the rows of C are ldc apart.
+static void GemmABt(const float* a, const float* b, float* c, int64_t m, int64_t n, int64_t k, int64_t ldc,
+                    float alpha) {
+  MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(m), static_cast<size_t>(n), static_cast<size_t>(k),
+           alpha, a, static_cast<size_t>(k), b, static_cast<size_t>(k), 0.0f, c, static_cast<size_t>(ldc), nullptr);
+}
+
+static void GemmABt(const double* a, const double* b, double* c, int64_t m, int64_t n, int64_t k, int64_t ldc,
+                    double alpha) {
+// use MLAS on 64-bit (no 32-bit dgemm)
+#if defined(_M_AMD64) || defined(__x86_64__)
+  MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(m), static_cast<size_t>(n), static_cast<size_t>(k),
+           alpha, a, static_cast<size_t>(k), b, static_cast<size_t>(k), 0.0, c, static_cast<size_t>(ldc), nullptr);
+#else
+  // https://eigen.tuxfamily.org/dox/TopicWritingEfficientProductExpression.html
+  auto out_map = EigenMatrixMapRowMajorOuterStride<double>(c, m, n, Eigen::OuterStride<>(ldc));
+  out_map.noalias() = alpha * (ConstEigenMatrixMapRowMajor<double>(a, m, k) *
+                               ConstEigenMatrixMapRowMajor<double>(b, n, k).transpose());
+#endif
+}
+
+// sum_k(Xik**2) for each row of a {rows, k} matrix, or its square root if 'norm' is true
+template <typename T>
+static std::vector<T> RowSumSquares(const T* data, int64_t rows, int64_t k, bool norm,
+                                    concurrency::ThreadPool* threadpool) {
+  std::vector<T> result(static_cast<size_t>(rows));
+  const double cost = static_cast<double>(k);
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, rows, TensorOpCost{cost * sizeof(T), static_cast<double>(sizeof(T)), cost * 2},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i < end; ++i) {
+          const T ss = ConstEigenVectorMap<T>(data + i * k, k).squaredNorm();
+          result[i] = norm ? std::sqrt(ss) : ss;
+        }
+      });
+  return result;
+}
+
 template <typename T>
-static void CalculateSqeuclidean(const Tensor& a, const Tensor& b, Tensor& c, concurrency::ThreadPool* threadpool) {
+static void CalculateDistances(const Tensor& a, const Tensor& b, Tensor& c, CDistMode mode,
+                               concurrency::ThreadPool* threadpool) {
   // input shapes have already been validated
   const auto& shape_a = a.Shape().GetDims();  // {m, k}
   const auto& shape_b = b.Shape().GetDims();  // {n, k}
@@ -26,67 +74,61 @@ static void CalculateSqeuclidean(const Tensor& a, const Tensor& b, Tensor& c, co
   int64_t n = shape_b[0];
   int64_t k = shape_a[1];
 
-  // https://github.com/droyed/eucl_dist/wiki/Main-Article
-  // dist(Xi,Yj) = sum_k(Xik**2) + sum_k(Yjk**2) - 2*sum_k(Xik*Yjk)
-
   const auto* a_data = a.Data<T>();
   const auto* b_data = b.Data<T>();
   auto* c_data = c.MutableData<T>();
 
-  // ReduceSumSquare for A
-  std::vector<T> a_ss;
-  a_ss.resize(m);
-  const auto* cur_a = a_data;
-  for (int64_t i = 0; i < m; ++i) {
-    a_ss[i] = ConstEigenVectorMap<T>(cur_a, k).squaredNorm();
-    cur_a += k;
-  }
-
-  // ReduceSumSquare for B
-  std::vector<T> b_ss;
-  b_ss.resize(n);
-  const auto* cur_b = b_data;
-  for (int64_t i = 0; i < n; ++i) {
-    b_ss[i] = ConstEigenVectorMap<T>(cur_b, k).squaredNorm();
-    cur_b += k;
-  }
+  // https://github.com/droyed/eucl_dist/wiki/Main-Article
+  // sqeuclidean: dist(Xi,Yj) = sum_k(Xik**2) + sum_k(Yjk**2) - 2*sum_k(Xik*Yjk)
+  // cosine:      dist(Xi,Yj) = 1 - sum_k(Xik*Yjk) / (||Xi|| * ||Yj||)
+  const bool cosine = mode == CDistMode::COSINE;
+  const std::vector<T> a_ss = RowSumSquares(a_data, m, k, cosine, threadpool);
+  const std::vector<T> b_ss = RowSumSquares(b_data, n, k, cosine, threadpool);
 
   // NOTE: We want to avoid subtracting two numbers that are very close to each other as that can lead to
   // 'catastrophic cancellation'. (sum_k(Xik**2) + sum_k(Yjk**2)) would be close to 2*sum_k(Xik*Yjk) if the values
   // in Xij and Yjk are very similar, so subtracting can be problematic.
   // Due to that we calculate -2*sum_k(Xik*Yjk) using GEMM, add sum_k(Xik**2) next, and add sum_k(Yjk**2) last.
-
-// use MLAS on 64-bit (no 32-bit dgemm)
-#if defined(_M_AMD64) || defined(__x86_64__)
-  // Use GEMM of A and B^T with -2 as alpha to calculate -2*sum_k(Xik*Yjk)
-  math::Gemm<T>(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                m, n, k,
-                static_cast<T>(-2.), a_data, b_data, static_cast<T>(0.),
-                c_data,
-                threadpool);
-#else
-  // the performance of this isn't great as the eigen matmul is single threaded by default
-  // if you're on x86 and care about performance try MKL first. if there's a good enough argument for optimising this
-  // we can look into it in the future.
-  ORT_UNUSED_PARAMETER(threadpool);
-
-  // https://eigen.tuxfamily.org/dox/TopicWritingEfficientProductExpression.html
-  auto out_map = EigenMatrixMapRowMajor<T>(c_data, m, n);
-  out_map.noalias() = static_cast<T>(-2.) *
-                      (ConstEigenMatrixMapRowMajor<T>(a_data, m, k) *
-                       ConstEigenMatrixMapRowMajor<T>(b_data, n, k).transpose());
-#endif
-
-  // add a_ss and b_ss, with broadcast
-  // output shape is {m, n}
-  auto* cur_out = c_data;
-  for (int64_t i = 0; i < m; ++i) {
-    T a_val = a_ss[i];
-    for (int64_t j = 0; j < n; ++j) {
-      *cur_out = (*cur_out + a_val) + b_ss[j];
-      ++cur_out;
+  const T alpha = cosine ? static_cast<T>(1.) : static_cast<T>(-2.);
+
+  const int64_t row_tiles = (m + kTileRows - 1) / kTileRows;
+  const int64_t col_tiles = (n + kTileCols - 1) / kTileCols;
+
+  concurrency::ThreadPool::TrySimpleParallelFor(threadpool, row_tiles * col_tiles, [&](std::ptrdiff_t tile) {
+    // consecutive tiles share the same rows of B
+    const int64_t row_begin = (tile % row_tiles) * kTileRows;
+    const int64_t col_begin = (tile / row_tiles) * kTileCols;
+    const int64_t rows = std::min(kTileRows, m - row_begin);
+    const int64_t cols = std::min(kTileCols, n - col_begin);
+
+    T* out = c_data + row_begin * n + col_begin;
+    GemmABt(a_data + row_begin * k, b_data + col_begin * k, out, rows, cols, k, n, alpha);
+
+    const T* b_vals = b_ss.data() + col_begin;
+    for (int64_t i = 0; i < rows; ++i, out += n) {
+      const T a_val = a_ss[row_begin + i];
+      switch (mode) {
+        case CDistMode::SQEUCLIDEAN:
+        case CDistMode::EUCLIDEAN:
+          for (int64_t j = 0; j < cols; ++j) {
+            // because of the GEMM there's a slight chance a number extremely close to zero could be negative,
+            // so it is clamped to avoid NaN's in the results.
+            out[j] = std::max((out[j] + a_val) + b_vals[j], static_cast<T>(0.));
+          }
+          if (mode == CDistMode::EUCLIDEAN) {
+            for (int64_t j = 0; j < cols; ++j) {
+              out[j] = std::sqrt(out[j]);
+            }
+          }
+          break;
+        case CDistMode::COSINE:
+          for (int64_t j = 0; j < cols; ++j) {
+            out[j] = static_cast<T>(1.) - out[j] / (a_val * b_vals[j]);
+          }
+          break;
+      }
     }
-  }
+  });
 }
 
 template <typename T>
@@ -111,19 +153,12 @@ common::Status CDist<T>::Compute(OpKernelContext* context) const {
 
   TensorShape output_shape = {shape_a[0], shape_b[0]};
   Tensor* C = context->Output(0, output_shape);
-  T* output = C->MutableData<T>();
-
-  CalculateSqeuclidean<T>(*A, *B, *C, tp);
-  auto map_out = EigenVectorArrayMap<T>(output, output_shape.Size());
-
-  // because we use GEMM in CalculateSqeuclidean there's a slight chance a number extremely close to zero
-  // could be negative, so we need to run abs() to avoid NaN's in the results.
-  if (mode_ == Mode::EUCLIDEAN) {
-    map_out = map_out.abs().sqrt();  // do both abs and sqrt in one call so Eigen has a chance to combine
-  } else if (mode_ == Mode::SQEUCLIDEAN) {
-    map_out = map_out.abs();
+  if (output_shape.Size() == 0) {
+    return Status::OK();
   }
 
+  CalculateDistances<T>(*A, *B, *C, mode_, tp);
+
   return Status::OK();
 }
 
@@ -9,22 +9,25 @@
 namespace onnxruntime {
 namespace contrib {
 
+enum class CDistMode { EUCLIDEAN,
+                       SQEUCLIDEAN,
+                       COSINE };
+
 template <typename T>
 class CDist final : public OpKernel {
  private:
-  typedef void (*DistFunc)(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n,
-                           concurrency::ThreadPool* tp);
-  enum class Mode { EUCLIDEAN,
-                    SQEUCLIDEAN } mode_;
+  CDistMode mode_;
 
  public:
   CDist(const OpKernelInfo& info) : OpKernel(info) {
     std::string metric;
     ORT_ENFORCE(info.GetAttr<std::string>("metric", &metric).IsOK());
     if (metric.compare("sqeuclidean") == 0)
-      mode_ = Mode::SQEUCLIDEAN;
+      mode_ = CDistMode::SQEUCLIDEAN;
     else if (metric.compare("euclidean") == 0) {
-      mode_ = Mode::EUCLIDEAN;
+      mode_ = CDistMode::EUCLIDEAN;
+    } else if (metric.compare("cosine") == 0) {
+      mode_ = CDistMode::COSINE;
     } else
       ORT_NOT_IMPLEMENTED();
   }
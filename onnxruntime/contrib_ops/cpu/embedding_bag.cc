@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag<float>);
+
+template <typename T>
+EmbeddingBag<T>::EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+  std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  ORT_ENFORCE(embedding_bag_helper::ParseMode(mode, mode_).IsOK(), "Unsupported EmbeddingBag mode: ", mode);
+}
+
+template <typename T>
+Status EmbeddingBag<T>::Compute(OpKernelContext* context) const {
+  const Tensor* weight = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+
+  int64_t num_bags = 0;
+  int64_t bag_size = 0;
+  ORT_RETURN_IF_ERROR(embedding_bag_helper::CheckInputs(*weight, *indices, offsets, per_sample_weights, mode_,
+                                                        num_bags, bag_size));
+
+  if (indices->IsDataType<int32_t>()) {
+    return ComputeImpl<int32_t>(context, num_bags, bag_size);
+  }
+  return ComputeImpl<int64_t>(context, num_bags, bag_size);
+}
+
+template <typename T>
+template <typename Tind>
+Status EmbeddingBag<T>::ComputeImpl(OpKernelContext* context, int64_t num_bags, int64_t bag_size) const {
+  const Tensor* weight = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+
+  const int64_t num_embeddings = weight->Shape()[0];
+  const int64_t embedding_dim = weight->Shape()[1];
+  const int64_t num_indices = indices->Shape().Size();
+
+  // resolve negative indices, and validate them before the bags are reduced in parallel
+  const Tind* indices_data = indices->template Data<Tind>();
+  std::vector<int64_t> rows(static_cast<size_t>(num_indices));
+  for (int64_t i = 0; i < num_indices; ++i) {
+    int64_t row = static_cast<int64_t>(indices_data[i]);
+    if (row < 0) {
+      row += num_embeddings;
+    }
+    if (row < 0 || row >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=",
+                             indices_data[i], " must be within the inclusive range [", -num_embeddings, ",",
+                             num_embeddings - 1, "]");
+    }
+    rows[static_cast<size_t>(i)] = row;
+  }
+
+  // bag i reduces the rows [bag_starts[i], bag_starts[i + 1])
+  std::vector<int64_t> bag_starts(static_cast<size_t>(num_bags + 1));
+  if (offsets != nullptr) {
+    const Tind* offsets_data = offsets->template Data<Tind>();
+    for (int64_t i = 0; i < num_bags; ++i) {
+      const int64_t start = static_cast<int64_t>(offsets_data[i]);
+      const int64_t previous = i == 0 ? 0 : bag_starts[static_cast<size_t>(i)];
+      if (start < previous || start > num_indices) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "offsets must be non-decreasing and at most the number of indices, got ",
+                               start, " at position ", i);
+      }
+      bag_starts[static_cast<size_t>(i)] = start;
+    }
+    bag_starts[static_cast<size_t>(num_bags)] = num_indices;
+  } else {
+    for (int64_t i = 0; i <= num_bags; ++i) {
+      bag_starts[static_cast<size_t>(i)] = i * bag_size;
+    }
+  }
+
+  Tensor* output = context->Output(0, {num_bags, embedding_dim});
+  const T* weight_data = weight->template Data<T>();
+  const T* sample_weights = per_sample_weights != nullptr ? per_sample_weights->template Data<T>() : nullptr;
+  T* output_data = output->template MutableData<T>();
+  const auto mode = mode_;
+
+  const double cost = static_cast<double>(embedding_dim) *
+                      (num_bags > 0 ? static_cast<double>(num_indices) / static_cast<double>(num_bags) : 0.0);
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_bags), std::max(cost, 1.0),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t bag = first; bag < last; ++bag) {
+          const int64_t start = bag_starts[bag];
+          const int64_t end = bag_starts[bag + 1];
+          EigenVectorArrayMap<T> out(output_data + bag * embedding_dim, embedding_dim);
+          if (start == end) {
+            out.setZero();
+            continue;
+          }
+
+          out = ConstEigenVectorArrayMap<T>(weight_data + rows[start] * embedding_dim, embedding_dim);
+          if (sample_weights != nullptr) {
+            out *= sample_weights[start];
+          }
+          for (int64_t i = start + 1; i < end; ++i) {
+            ConstEigenVectorArrayMap<T> row(weight_data + rows[i] * embedding_dim, embedding_dim);
+            if (mode == embedding_bag_helper::Mode::Max) {
+              out = out.max(row);
+            } else if (sample_weights != nullptr) {
+              out += row * sample_weights[i];
+            } else {
+              out += row;
+            }
+          }
+
+          if (mode == embedding_bag_helper::Mode::Mean) {
+            out /= static_cast<T>(end - start);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/embedding_bag_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(OpKernelContext* context, int64_t num_bags, int64_t bag_size) const;
+
+  embedding_bag_helper::Mode mode_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace embedding_bag_helper {
+
+Status ParseMode(const std::string& mode_str, Mode& mode) {
+  if (mode_str == "sum") {
+    mode = Mode::Sum;
+  } else if (mode_str == "mean") {
+    mode = Mode::Mean;
+  } else if (mode_str == "max") {
+    mode = Mode::Max;
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported EmbeddingBag mode: ", mode_str);
+  }
+
+  return Status::OK();
+}
+
+Status CheckInputs(const Tensor& weight, const Tensor& indices, const Tensor* offsets,
+                   const Tensor* per_sample_weights, Mode mode, int64_t& num_bags, int64_t& bag_size) {
+  if (weight.Shape().NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "weight must be 2-D, got ", weight.Shape());
+  }
+
+  const auto& indices_shape = indices.Shape();
+  if (indices_shape.NumDimensions() == 2) {
+    if (offsets != nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "offsets must not be given with 2-D indices");
+    }
+    num_bags = indices_shape[0];
+    bag_size = indices_shape[1];
+  } else if (indices_shape.NumDimensions() == 1) {
+    if (offsets == nullptr || offsets->Shape().NumDimensions() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "1-D indices require 1-D offsets");
+    }
+    if (offsets->DataType() != indices.DataType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "offsets must have the type of indices");
+    }
+    num_bags = offsets->Shape()[0];
+    bag_size = 0;
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices must be 1-D or 2-D, got ", indices_shape);
+  }
+
+  if (per_sample_weights != nullptr) {
+    if (mode != Mode::Sum) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "per_sample_weights are only supported by the sum mode");
+    }
+    if (per_sample_weights->Shape() != indices_shape) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "per_sample_weights must have the shape of indices, got ",
+                             per_sample_weights->Shape(), " and ", indices_shape);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace embedding_bag_helper
+}  // namespace contrib
+}  // namespace onnxruntime
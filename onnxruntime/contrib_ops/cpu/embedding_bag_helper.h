@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace embedding_bag_helper {
+
+enum class Mode {
+  Sum,
+  Mean,
+  Max,
+};
+
+Status ParseMode(const std::string& mode_str, Mode& mode);
+
+// Checks the shapes of the inputs of EmbeddingBag and returns the number of bags it computes.
+// bag_size is set to the size of the bags for 2-D indices, and to 0 for 1-D indices with offsets.
+Status CheckInputs(const Tensor& weight, const Tensor& indices, const Tensor* offsets,
+                   const Tensor* per_sample_weights, Mode mode, int64_t& num_bags, int64_t& bag_size);
+
+}  // namespace embedding_bag_helper
+}  // namespace contrib
+}  // namespace onnxruntime
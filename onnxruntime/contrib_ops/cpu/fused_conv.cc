@@ -19,6 +19,7 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        .MayInplace(3, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     FusedConvFloat);
 
@@ -0,0 +1,238 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+
+#include <algorithm>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of output values computed by a task. With the few inputs of a chain a tile stays in the L1/L2 cache
+// from the first operator to the last one.
+constexpr int64_t kTileSize = 4096;
+
+bool ParseOpType(const std::string& name, FusedElementwise::OpType& op_type, bool& is_binary) {
+  using OpType = FusedElementwise::OpType;
+  static const std::pair<const char*, OpType> binary_ops[] = {
+      {"Add", OpType::Add},
+      {"Sub", OpType::Sub},
+      {"Mul", OpType::Mul},
+      {"Div", OpType::Div},
+  };
+  static const std::pair<const char*, OpType> unary_ops[] = {
+      {"Abs", OpType::Abs},
+      {"Erf", OpType::Erf},
+      {"Exp", OpType::Exp},
+      {"Neg", OpType::Neg},
+      {"Relu", OpType::Relu},
+      {"Sigmoid", OpType::Sigmoid},
+      {"Sqrt", OpType::Sqrt},
+      {"Tanh", OpType::Tanh},
+  };
+
+  for (const auto& op : binary_ops) {
+    if (name == op.first) {
+      op_type = op.second;
+      is_binary = true;
+      return true;
+    }
+  }
+  for (const auto& op : unary_ops) {
+    if (name == op.first) {
+      op_type = op.second;
+      is_binary = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename TOperand>
+void ApplyBinaryStep(FusedElementwise::OpType op_type, bool chain_value_first, EigenVectorArrayMap<float>& y,
+                     const TOperand& x) {
+  using OpType = FusedElementwise::OpType;
+  switch (op_type) {
+    case OpType::Add:
+      y += x;
+      break;
+    case OpType::Sub:
+      if (chain_value_first) {
+        y -= x;
+      } else {
+        y = x - y;
+      }
+      break;
+    case OpType::Mul:
+      y *= x;
+      break;
+    case OpType::Div:
+      if (chain_value_first) {
+        y /= x;
+      } else {
+        y = x / y;
+      }
+      break;
+    default:
+      ORT_THROW("Unexpected binary operator.");
+  }
+}
+
+// Applies a step of the chain in place to the <count> values of the tile that starts at <y_data>.
+void ApplyStep(const FusedElementwise::Step& step, float* y_data, size_t count,
+               const float* operand, bool operand_is_single_value) {
+  using OpType = FusedElementwise::OpType;
+  EigenVectorArrayMap<float> y(y_data, count);
+
+  switch (step.op_type) {
+    case OpType::Abs:
+      y = y.abs();
+      break;
+    case OpType::Erf:
+      MlasComputeErf(y_data, y_data, count);
+      break;
+    case OpType::Exp:
+      MlasComputeExp(y_data, y_data, count);
+      break;
+    case OpType::Neg:
+      y = -y;
+      break;
+    case OpType::Relu:
+      y = y.cwiseMax(0.0f);
+      break;
+    case OpType::Sigmoid:
+      MlasComputeLogistic(y_data, y_data, count);
+      break;
+    case OpType::Sqrt:
+      y = y.sqrt();
+      break;
+    case OpType::Tanh:
+      MlasComputeTanh(y_data, y_data, count);
+      break;
+    default:
+      if (operand_is_single_value) {
+        ApplyBinaryStep(step.op_type, step.chain_value_first, y, *operand);
+      } else {
+        ApplyBinaryStep(step.op_type, step.chain_value_first, y, ConstEigenVectorArrayMap<float>(operand, count));
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<std::string> ops;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK() && !ops.empty(), "The 'ops' attribute is required.");
+  std::vector<int64_t> chain_input_indices = info.GetAttrsOrDefault<int64_t>("chain_input_indices");
+  ORT_ENFORCE(chain_input_indices.size() == ops.size(),
+              "The 'chain_input_indices' attribute must have one entry per operator. Got ", chain_input_indices.size(),
+              " entries for ", ops.size(), " operators.");
+
+  // the first input starts the chain, as if it was the result of a previous step
+  int next_input = 1;
+  steps_.reserve(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    Step step{};
+    bool is_binary = false;
+    ORT_ENFORCE(ParseOpType(ops[i], step.op_type, is_binary), "Unsupported operator in the chain: ", ops[i]);
+    if (is_binary) {
+      step.input_index = next_input++;
+      step.chain_value_first = i == 0 || chain_input_indices[i] == 0;
+    } else {
+      step.input_index = -1;
+    }
+    steps_.push_back(step);
+  }
+
+  ORT_ENFORCE(static_cast<int>(info.GetInputCount()) == next_input,
+              "The chain of operators takes ", next_input, " inputs. Got ", info.GetInputCount());
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const int input_count = context->InputCount();
+
+  // every input either has the shape of the output, up to leading dims of 1, or holds a single value
+  size_t output_rank = 0;
+  for (int i = 0; i < input_count; ++i) {
+    output_rank = std::max(output_rank, context->Input<Tensor>(i)->Shape().NumDimensions());
+  }
+
+  std::vector<int64_t> output_dims;
+  std::vector<const float*> input_data(input_count);
+  std::vector<bool> is_single_value(input_count);
+  for (int i = 0; i < input_count; ++i) {
+    const Tensor& input = *context->Input<Tensor>(i);
+    input_data[i] = input.Data<float>();
+    is_single_value[i] = input.Shape().Size() == 1;
+    if (is_single_value[i]) {
+      continue;
+    }
+
+    std::vector<int64_t> dims(output_rank - input.Shape().NumDimensions(), 1);
+    const auto& input_dims = input.Shape().GetDims();
+    dims.insert(dims.end(), input_dims.begin(), input_dims.end());
+    if (output_dims.empty()) {
+      output_dims = std::move(dims);
+    } else if (dims != output_dims) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "All the inputs that hold more than one value must have the same shape. Input ", i,
+                             " has shape ", input.Shape(), " and the output has shape ", TensorShape(output_dims));
+    }
+  }
+  if (output_dims.empty()) {
+    output_dims.resize(output_rank, 1);
+  }
+
+  Tensor& output = *context->Output(0, TensorShape(output_dims));
+  const int64_t output_size = output.Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+  float* output_data = output.MutableData<float>();
+
+  const int64_t tile_count = (output_size + kTileSize - 1) / kTileSize;
+  concurrency::ThreadPool::TryBatchParallelFor(
+      context->GetOperatorThreadPool(), static_cast<int32_t>(tile_count),
+      [&](ptrdiff_t tile) {
+        const int64_t start = tile * kTileSize;
+        const size_t count = static_cast<size_t>(std::min(kTileSize, output_size - start));
+        float* y = output_data + start;
+
+        if (is_single_value[0]) {
+          std::fill_n(y, count, *input_data[0]);
+        } else {
+          std::copy_n(input_data[0] + start, count, y);
+        }
+
+        for (const auto& step : steps_) {
+          const float* operand = nullptr;
+          bool operand_is_single_value = false;
+          if (step.input_index >= 0) {
+            operand_is_single_value = is_single_value[step.input_index];
+            operand = input_data[step.input_index] + (operand_is_single_value ? 0 : start);
+          }
+          ApplyStep(step, y, count, operand, operand_is_single_value);
+        }
+      },
+      0);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
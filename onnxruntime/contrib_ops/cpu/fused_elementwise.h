@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates a chain of elementwise operators fused by the ElementwiseFusion transformer. The output is processed in
+// tiles small enough for the inputs and the intermediate values of a tile to stay in the cache, and the tiles are
+// split across the thread pool.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class OpType {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Abs,
+    Erf,
+    Exp,
+    Neg,
+    Relu,
+    Sigmoid,
+    Sqrt,
+    Tanh,
+  };
+
+  struct Step {
+    OpType op_type;
+    // input of the kernel that is the other operand of a binary operator, -1 for unary operators
+    int input_index;
+    // whether the result of the previous step is the first operand of a binary operator
+    bool chain_value_first;
+  };
+
+ private:
+  std::vector<Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
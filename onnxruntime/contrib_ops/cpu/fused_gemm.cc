@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <type_traits>
+
 #include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
@@ -20,7 +22,39 @@ class FusedGemm final : public Gemm<T> {
         attrs[p.first.substr(ACTIVATION_NAME_PREFIX_LEN)] = p.second;
       }
     }
+    // a FusedGemm that only adds the sum Z has no activation
+    if (activation.empty()) {
+      return;
+    }
     ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
+
+    // the activations MLAS has kernels for are applied to each block of the output while it's still in cache,
+    // instead of by a second pass over the output
+    if (std::is_same<T, float>::value && GetMlasActivation(activation, attrs, this->mlas_activation_)) {
+      this->activation_.reset();
+    }
+  }
+
+ private:
+  static bool GetMlasActivation(const std::string& activation, const NodeAttributes& attrs,
+                                MLAS_ACTIVATION& mlas_activation) {
+    if (activation == "Relu") {
+      mlas_activation.ActivationKind = MlasReluActivation;
+    } else if (activation == "Sigmoid") {
+      mlas_activation.ActivationKind = MlasLogisticActivation;
+    } else if (activation == "Tanh") {
+      mlas_activation.ActivationKind = MlasTanhActivation;
+    } else if (activation == "LeakyRelu") {
+      mlas_activation.ActivationKind = MlasLeakyReluActivation;
+      ORT_THROW_IF_ERROR(functors::GetFloatParam("alpha", attrs, mlas_activation.Parameters.LeakyRelu.alpha));
+    } else if (activation == "HardSigmoid") {
+      mlas_activation.ActivationKind = MlasHardSigmoidActivation;
+      ORT_THROW_IF_ERROR(functors::GetFloatParam("alpha", attrs, mlas_activation.Parameters.HardSigmoid.alpha));
+      ORT_THROW_IF_ERROR(functors::GetFloatParam("beta", attrs, mlas_activation.Parameters.HardSigmoid.beta));
+    } else {
+      return false;
+    }
+    return true;
   }
 };
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "layer_norm.h"
+#include "layer_norm_helper.h"
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
@@ -101,39 +102,17 @@ Status LayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
     inv_std_var_data = static_cast<T*>(inv_std_var_data_buf_ptr.get());
   }
 
-  concurrency::ThreadPool::TryBatchParallelFor(p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
-                                               [&](ptrdiff_t task_idx) {
-                                                 const T* p_input = X_data + task_idx * norm_size;
-                                                 T* p_output = Y_data + task_idx * norm_size;
-
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   mean += p_input[h];
-                                                   mean_square += p_input[h] * p_input[h];
-                                                 }
-
-                                                 mean = mean / norm_size;
-                                                 if (simplified) {
-                                                   mean_square = sqrt(mean_square / norm_size + epsilon_);
-                                                 } else {
-                                                   mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon_);
-                                                 }
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   if (simplified) {
-                                                     p_output[h] = p_input[h] / mean_square * scale_data[h];
-                                                   } else {
-                                                     p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-                                                   }
-                                                 }
-
-                                                 if (mean_data != nullptr) {
-                                                   mean_data[task_idx] = mean;
-                                                 }
-                                                 inv_std_var_data[task_idx] = 1 / mean_square;
-                                               }, 0);
+  concurrency::ThreadPool::TryParallelFor(
+      p_ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(norm_count),
+      layer_norm::RowCost<T>(norm_size, 1),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task_idx = first; task_idx < last; ++task_idx) {
+          layer_norm::ComputeRow<T>(X_data + task_idx * norm_size, nullptr, nullptr, scale_data, bias_data,
+                                    Y_data + task_idx * norm_size, norm_size, epsilon_, simplified,
+                                    mean_data == nullptr ? nullptr : mean_data + task_idx,
+                                    inv_std_var_data + task_idx);
+        }
+      });
 
   return Status::OK();
 }
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cmath>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace layer_norm {
+
+// Normalizes a row of n values, input + skip + bias, where skip and bias are optional:
+//   output = (value - mean) / sqrt(variance + epsilon) * gamma + beta
+// or, if simplified, output = value / sqrt(mean(value * value) + epsilon) * gamma, with beta nullptr.
+// mean and inv_std_dev optionally receive the mean and the inverse of the denominator.
+template <typename T>
+inline void ComputeRow(const T* input, const T* skip, const T* bias, const T* gamma, const T* beta, T* output,
+                       int64_t n, float epsilon, bool simplified, T* mean, T* inv_std_dev) {
+  T sum = 0;
+  T sum_square = 0;
+  for (int64_t h = 0; h < n; h++) {
+    T value = input[h];
+    if (skip != nullptr) {
+      value += skip[h];
+    }
+    if (bias != nullptr) {
+      value += bias[h];
+    }
+    output[h] = value;
+    sum += value;
+    sum_square += value * value;
+  }
+
+  const T mean_value = sum / n;
+  const T denominator = simplified ? std::sqrt(sum_square / n + epsilon)
+                                   : std::sqrt(sum_square / n - mean_value * mean_value + epsilon);
+
+  for (int64_t h = 0; h < n; h++) {
+    if (simplified) {
+      output[h] = output[h] / denominator * gamma[h];
+    } else {
+      output[h] = (output[h] - mean_value) / denominator * gamma[h] + (beta == nullptr ? 0 : beta[h]);
+    }
+  }
+
+  if (mean != nullptr) {
+    *mean = mean_value;
+  }
+  if (inv_std_dev != nullptr) {
+    *inv_std_dev = 1 / denominator;
+  }
+}
+
+// The float rows are normalized by the vectorized MLAS kernel, which computes both moments in a single pass
+template <>
+inline void ComputeRow<float>(const float* input, const float* skip, const float* bias, const float* gamma,
+                              const float* beta, float* output, int64_t n, float epsilon, bool simplified,
+                              float* mean, float* inv_std_dev) {
+  MlasLayerNormalization(input, skip, bias, gamma, beta, output, static_cast<size_t>(n), epsilon, simplified,
+                         mean, inv_std_dev);
+}
+
+// Cost of normalizing a row of n values read from num_inputs buffers besides gamma and beta
+template <typename T>
+inline TensorOpCost RowCost(int64_t n, int num_inputs) {
+  return TensorOpCost{static_cast<double>(n * (num_inputs + 2) * sizeof(T)), static_cast<double>(n * sizeof(T)),
+                      static_cast<double>(n * (num_inputs + 4))};
+}
+
+}  // namespace layer_norm
+}  // namespace contrib
+}  // namespace onnxruntime
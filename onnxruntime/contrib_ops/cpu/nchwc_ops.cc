@@ -75,6 +75,24 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcUpsample);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    ScaleChannels,
+    1,
+    float,
+    KernelDefBuilder()
+        .MayInplace(0, 0)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcScaleChannels);
+
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    InstanceNormalization,
+    1,
+    float,
+    KernelDefBuilder()
+        .MayInplace(0, 0)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcInstanceNormalization);
+
 Status ReorderInput::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& X_shape = X->Shape();
@@ -235,5 +253,53 @@ Status NchwcUpsample::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status NchwcScaleChannels::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* scale = context->Input<Tensor>(1);
+  const auto& X_shape = X->Shape();
+  const auto& scale_shape = scale->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+  ORT_RETURN_IF_NOT(scale_shape.NumDimensions() == 4 && (scale_shape[0] == X_shape[0] || scale_shape[0] == 1) &&
+                        scale_shape[1] == X_shape[1] && scale_shape[2] == 1 && scale_shape[3] == 1,
+                    "scale shape ", scale_shape, " is not a channel scale of the input shape ", X_shape);
+
+  auto* Y = context->Output(0, X_shape);
+
+  MlasNchwcScaleChannels(X_shape.GetDims().data(),
+                         X->template Data<float>(),
+                         scale->template Data<float>(),
+                         scale_shape[0] != X_shape[0],
+                         Y->template MutableData<float>(),
+                         context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+Status NchwcInstanceNormalization::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* scale = context->Input<Tensor>(1);
+  const auto* B = context->Input<Tensor>(2);
+  const auto& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+  ORT_RETURN_IF_NOT(scale->Shape().Size() == X_shape[1] && B->Shape().Size() == X_shape[1],
+                    "scale and B must have ", X_shape[1], " elements, got shapes ", scale->Shape(), " and ",
+                    B->Shape());
+
+  auto* Y = context->Output(0, X_shape);
+
+  MlasNchwcInstanceNormalization(X_shape.GetDims().data(),
+                                 X->template Data<float>(),
+                                 scale->template Data<float>(),
+                                 B->template Data<float>(),
+                                 Y->template MutableData<float>(),
+                                 epsilon_,
+                                 &activation_,
+                                 context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
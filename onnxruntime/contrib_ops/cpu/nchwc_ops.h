@@ -91,5 +91,28 @@ class NchwcUpsample : public OpKernel {
   std::vector<int64_t> scales_;
 };
 
+class NchwcScaleChannels : public OpKernel {
+ public:
+  NchwcScaleChannels(const OpKernelInfo& info) : OpKernel(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class NchwcInstanceNormalization : public OpKernel {
+ public:
+  NchwcInstanceNormalization(const OpKernelInfo& info) : OpKernel(info) {
+    epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float epsilon_;
+
+  MLAS_ACTIVATION activation_;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
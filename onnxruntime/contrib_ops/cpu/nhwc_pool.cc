@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/pool_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Pooling over 4D tensors in NHWC format. The attributes are parsed as for the ONNX pooling operator named by
+// op_name and the pooling is executed by MlasPoolNhwc.
+class NhwcPool : public OpKernel, public PoolBase {
+ public:
+  NhwcPool(const OpKernelInfo& info, const std::string& op_name, MLAS_POOLING_KIND kind)
+      : OpKernel(info), PoolBase(info, op_name), kind_(kind) {
+    if (!pool_attrs_.global_pooling) {
+      ORT_ENFORCE(pool_attrs_.kernel_shape.size() == 2, "kernel_shape num_dims is not compatible with X num_dims.");
+    }
+    if (kind_ == MlasAveragePoolingExcludePad && pool_attrs_.count_include_pad) {
+      kind_ = MlasAveragePoolingIncludePad;
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override {
+    return PoolBase::ComputeNhwc(context, kind_);
+  }
+
+ private:
+  MLAS_POOLING_KIND kind_;
+};
+
+class NhwcMaxPool final : public NhwcPool {
+ public:
+  NhwcMaxPool(const OpKernelInfo& info) : NhwcPool(info, "MaxPool", MlasMaximumPooling) {}
+};
+
+class NhwcAveragePool final : public NhwcPool {
+ public:
+  NhwcAveragePool(const OpKernelInfo& info) : NhwcPool(info, "AveragePool", MlasAveragePoolingExcludePad) {}
+};
+
+class NhwcGlobalMaxPool final : public NhwcPool {
+ public:
+  NhwcGlobalMaxPool(const OpKernelInfo& info) : NhwcPool(info, "GlobalMaxPool", MlasMaximumPooling) {}
+};
+
+class NhwcGlobalAveragePool final : public NhwcPool {
+ public:
+  NhwcGlobalAveragePool(const OpKernelInfo& info)
+      : NhwcPool(info, "GlobalAveragePool", MlasAveragePoolingExcludePad) {}
+};
+
+#define ONNX_CPU_OPERATOR_TYPED_NHWC_POOL_KERNEL(name)                                                        \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(name, kMSDomain, 1, float, kCpuExecutionProvider,                             \
+                                KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()), \
+                                name);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_POOL_KERNEL(NhwcMaxPool)
+ONNX_CPU_OPERATOR_TYPED_NHWC_POOL_KERNEL(NhwcAveragePool)
+ONNX_CPU_OPERATOR_TYPED_NHWC_POOL_KERNEL(NhwcGlobalMaxPool)
+ONNX_CPU_OPERATOR_TYPED_NHWC_POOL_KERNEL(NhwcGlobalAveragePool)
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -25,6 +25,10 @@ class QAttention : public OpKernel, public AttentionCPUBase {
 
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
   Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  size_t PrePackedBytes() const override {
+    return packed_weights_ ? packed_weights_size_ * 3 * static_cast<size_t>(num_heads_) : 0;
+  }
 #endif
 
  private:
@@ -8,6 +8,7 @@
 #include "core/util/qmath.h"
 
 #include <algorithm>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -58,7 +59,7 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
                a_data + helper.LeftOffsets()[i],
                static_cast<size_t>(helper.K()),
                a_zero_point,
-               packed_b_.get(),
+               PackedB(helper.RightOffsets()[i]),
                b_zero_point,
                b_is_signed_,
                y_data + helper.OutputOffsets()[i],
@@ -96,6 +97,19 @@ class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
   DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {}
 
   Status Compute(OpKernelContext* context) const override;
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+ private:
+  // Quantizes A as its panels are packed by the GEMM instead of into a temporary buffer.
+  Status ComputeFusedQuantizeA(OpKernelContext* ctx,
+                               const Tensor* a,
+                               float a_scale,
+                               uint8_t a_zero_point,
+                               const Tensor* b,
+                               uint8_t b_zero_point,
+                               float multiplier,
+                               const Tensor* bias_tensor) const;
+#endif
 };
 
 class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
@@ -105,10 +119,29 @@ class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
   Status Compute(OpKernelContext* context) const override;
 };
 
-static void GetQuantizationParameter(const float* data, int64_t num_of_elements, float& scale, uint8_t& zp) {
-  // find input range min and max
+static void GetQuantizationParameter(const float* data, int64_t num_of_elements, float& scale, uint8_t& zp,
+                                     concurrency::ThreadPool* thread_pool) {
+  // find input range min and max, over blocks of the input in parallel for the larger inputs
+  constexpr std::ptrdiff_t min_block_size = 16384;
+  const std::ptrdiff_t num_blocks = std::max<std::ptrdiff_t>(
+      1, std::min<std::ptrdiff_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool),
+                                  static_cast<std::ptrdiff_t>(num_of_elements) / min_block_size));
+
   float min, max;
-  MlasFindMinMaxElement(data, &min, &max, num_of_elements);
+  if (num_blocks == 1) {
+    MlasFindMinMaxElement(data, &min, &max, static_cast<size_t>(num_of_elements));
+  } else {
+    std::vector<float> block_min(num_blocks);
+    std::vector<float> block_max(num_blocks);
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, num_blocks, [&](std::ptrdiff_t block) {
+      auto work = concurrency::ThreadPool::PartitionWork(block, num_blocks,
+                                                         static_cast<std::ptrdiff_t>(num_of_elements));
+      MlasFindMinMaxElement(data + work.start, &block_min[block], &block_max[block],
+                            static_cast<size_t>(work.end - work.start));
+    });
+    min = *std::min_element(block_min.begin(), block_min.end());
+    max = *std::max_element(block_max.begin(), block_max.end());
+  }
 
   // ensure the input range includes zero
   min = std::min(min, 0.0f);
@@ -123,6 +156,72 @@ static void GetQuantizationParameter(const float* data, int64_t num_of_elements,
   zp = static_cast<uint8_t>(RoundHalfToEven(std::max(float(qmin), std::min(float(qmax), initial_zero_point))));
 }
 
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+Status DynamicQuantizeMatMul::ComputeFusedQuantizeA(OpKernelContext* ctx,
+                                                    const Tensor* a,
+                                                    float a_scale,
+                                                    uint8_t a_zero_point,
+                                                    const Tensor* b,
+                                                    uint8_t b_zero_point,
+                                                    float multiplier,
+                                                    const Tensor* bias_tensor) const {
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), packed_b_ ? b_shape_ : b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = a->template Data<float>();
+  auto* y_data = y->template MutableData<float>();
+  const auto* bias_data = bias_tensor != nullptr ? bias_tensor->Data<float>() : nullptr;
+
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+    if (packed_b_) {
+      MlasGemm(static_cast<size_t>(helper.M()),
+               static_cast<size_t>(helper.N()),
+               static_cast<size_t>(helper.K()),
+               a_data + helper.LeftOffsets()[i],
+               static_cast<size_t>(helper.K()),
+               a_scale,
+               a_zero_point,
+               PackedB(helper.RightOffsets()[i]),
+               b_zero_point,
+               b_is_signed_,
+               y_data + helper.OutputOffsets()[i],
+               static_cast<size_t>(helper.N()),
+               &multiplier,
+               bias_data,
+               thread_pool);
+      continue;
+    }
+#endif
+    MlasGemm(static_cast<size_t>(helper.M()),
+             static_cast<size_t>(helper.N()),
+             static_cast<size_t>(helper.K()),
+             a_data + helper.LeftOffsets()[i],
+             static_cast<size_t>(helper.K()),
+             a_scale,
+             a_zero_point,
+             static_cast<const uint8_t*>(b->DataRaw()) + helper.RightOffsets()[i],
+             static_cast<size_t>(helper.N()),
+             b_zero_point,
+             b->IsDataType<int8_t>(),
+             y_data + helper.OutputOffsets()[i],
+             static_cast<size_t>(helper.N()),
+             &multiplier,
+             bias_data,
+             thread_pool);
+  }
+
+  return Status::OK();
+}
+#endif
+
 Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
   const Tensor* a = ctx->Input<Tensor>(0);
   const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
@@ -146,8 +245,18 @@ Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
 
   float a_scale;
   uint8_t a_zero_point;
-  GetQuantizationParameter(a_data, num_of_elements, a_scale, a_zero_point);
-
+  GetQuantizationParameter(a_data, num_of_elements, a_scale, a_zero_point, ctx->GetOperatorThreadPool());
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  return ComputeFusedQuantizeA(ctx,
+                               a,
+                               a_scale,
+                               a_zero_point,
+                               b,
+                               b_zero_point,
+                               a_scale * b_scale,
+                               ctx->Input<Tensor>(4));
+#else
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
   uint8_t* a_data_quant = static_cast<uint8_t*>(allocator->Alloc(SafeInt<size_t>(num_of_elements) * sizeof(uint8_t)));
@@ -163,6 +272,7 @@ Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
                        b_zero_point,
                        a_scale * b_scale,
                        ctx->Input<Tensor>(4));
+#endif
 }
 
 Status MatMulIntegerToFloat::Compute(OpKernelContext* ctx) const {
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = A x B + bias, with the weights B quantized blockwise to 4 or 8 bits, see the MatMulNBits schema for the layout.
+class MatMulNBits final : public OpKernel {
+ public:
+  MatMulNBits(const OpKernelInfo& info)
+      : OpKernel(info),
+        K_{gsl::narrow<size_t>(info.GetAttr<int64_t>("K"))},
+        N_{gsl::narrow<size_t>(info.GetAttr<int64_t>("N"))},
+        bits_{gsl::narrow<size_t>(info.GetAttrOrDefault<int64_t>("bits", 4))},
+        block_size_{gsl::narrow<size_t>(info.GetAttrOrDefault<int64_t>("block_size", 32))} {
+    ORT_ENFORCE(MlasIsBlockwiseQuantizedGemmAvailable(bits_, block_size_),
+                "MatMulNBits: unsupported bits ", bits_, " and block_size ", block_size_);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  const size_t K_;
+  const size_t N_;
+  const size_t bits_;
+  const size_t block_size_;
+};
+
+Status MatMulNBits::Compute(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+  const Tensor* scales = ctx->Input<Tensor>(2);
+  const Tensor* zero_points = ctx->Input<Tensor>(3);
+  const Tensor* bias = ctx->Input<Tensor>(4);
+
+  const TensorShape& a_shape = a->Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() >= 1 && static_cast<size_t>(a_shape[a_shape.NumDimensions() - 1]) == K_,
+                    "MatMulNBits: the last dimension of input A must be K ", K_, ", got shape ", a_shape);
+
+  size_t b_data_size;
+  size_t scales_size;
+  size_t zero_points_size;
+  MlasBlockwiseQuantizedBufferSizes(bits_, block_size_, N_, K_, &b_data_size, &scales_size, &zero_points_size);
+
+  ORT_RETURN_IF_NOT(static_cast<size_t>(b->Shape().Size()) == b_data_size,
+                    "MatMulNBits: input B must have ", b_data_size, " elements, got shape ", b->Shape());
+  ORT_RETURN_IF_NOT(static_cast<size_t>(scales->Shape().Size()) == scales_size,
+                    "MatMulNBits: input scales must have ", scales_size, " elements, got shape ", scales->Shape());
+  ORT_RETURN_IF_NOT(zero_points == nullptr || static_cast<size_t>(zero_points->Shape().Size()) == zero_points_size,
+                    "MatMulNBits: input zero_points must have ", zero_points_size, " elements, got shape ",
+                    zero_points->Shape());
+  ORT_RETURN_IF_NOT(bias == nullptr || static_cast<size_t>(bias->Shape().Size()) == N_,
+                    "MatMulNBits: input bias must have N ", N_, " elements, got shape ", bias->Shape());
+
+  std::vector<int64_t> y_dims = a_shape.GetDims();
+  y_dims.back() = static_cast<int64_t>(N_);
+  Tensor* y = ctx->Output(0, TensorShape(y_dims));
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const size_t M = static_cast<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+
+  MlasBlockwiseQuantizedGemm(bits_, block_size_, M, N_, K_,
+                             a->Data<float>(), K_,
+                             b->Data<uint8_t>(),
+                             scales->Data<float>(),
+                             zero_points != nullptr ? zero_points->Data<uint8_t>() : nullptr,
+                             bias != nullptr ? bias->Data<float>() : nullptr,
+                             y->MutableData<float>(), N_,
+                             ctx->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulNBits,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulNBits);
+
+}  // namespace contrib
+}  // namespace onnxruntime
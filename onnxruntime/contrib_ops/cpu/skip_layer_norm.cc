@@ -6,6 +6,7 @@
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
 #include "skip_layer_norm.h"
+#include "layer_norm_helper.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -96,32 +97,16 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
 
   T* output_data = output->MutableData<T>();
 
-  concurrency::ThreadPool::TryBatchParallelFor(p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
-                                               [&](ptrdiff_t task_idx) {
-                                                 const T* p_input = input_data + task_idx * hidden_size;
-                                                 const T* p_skip = skip_data + task_idx * hidden_size;
-                                                 T* p_output = output_data + task_idx * hidden_size;
-
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < hidden_size; h++) {
-                                                   T value = p_input[h] + p_skip[h];
-                                                   if (nullptr != bias_data) {
-                                                     value += bias_data[h];
-                                                   }
-                                                   p_output[h] = value;
-                                                   mean += value;
-                                                   mean_square += value * value;
-                                                 }
-
-                                                 mean = mean / hidden_size;
-                                                 mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
-
-                                                 for (int64_t h = 0; h < hidden_size; h++) {
-                                                   p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-                                                 }
-                                               }, 0);
+  concurrency::ThreadPool::TryParallelFor(
+      p_ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(task_count),
+      layer_norm::RowCost<T>(hidden_size, bias_data == nullptr ? 2 : 3),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task_idx = first; task_idx < last; ++task_idx) {
+          layer_norm::ComputeRow<T>(input_data + task_idx * hidden_size, skip_data + task_idx * hidden_size,
+                                    bias_data, gamma_data, beta_data, output_data + task_idx * hidden_size,
+                                    hidden_size, epsilon_, false, nullptr, nullptr);
+        }
+      });
 
   return Status::OK();
 }
@@ -5,8 +5,12 @@
 #include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -23,18 +27,23 @@ class Tokenizer final : public OpKernel {
   Status CharTokenize(OpKernelContext* context, size_t N, size_t C,
                       const std::vector<int64_t>& input_dims) const;
 
-  Status SeparatorExpressionTokenizer(OpKernelContext* context, size_t N, size_t C,
-                                      const std::vector<int64_t>& input_dims) const;
+  // Tokenizes the rows with either the separators or the token expression
+  Status ExpressionTokenizer(OpKernelContext* context, size_t N, size_t C,
+                             const std::vector<int64_t>& input_dims) const;
+
+  // tokens is a scratch buffer
+  Status SeparatorTokenize(const std::string& s, std::vector<re2::StringPiece>& row,
+                           std::vector<re2::StringPiece>& tokens) const;
 
-  Status TokenExpression(OpKernelContext* ctx,
-                         size_t N, size_t C,
-                         const std::vector<int64_t>& input_dims) const;
+  Status ExpressionTokenize(const std::string& s, std::vector<re2::StringPiece>& row) const;
 
   bool mark_{false};
   std::string pad_value_;
   int64_t mincharnum_{0};
   bool char_tokenezation_{false};
   std::vector<std::unique_ptr<re2::RE2>> separators_;
+  // the separators if none of them has regex special characters. they are then matched without RE2.
+  std::vector<std::string> literal_separators_;
   std::unique_ptr<re2::RE2> regex_;
 };
 
@@ -55,6 +64,16 @@ const char end_text = 0x3;
 
 using namespace tokenizer_details;
 
+// The cost of tokenizing a row, proportional to the average length of the strings
+static TensorOpCost RowCost(const std::string* input_data, size_t num_rows) {
+  size_t total_bytes = 0;
+  for (size_t row = 0; row < num_rows; ++row) {
+    total_bytes += input_data[row].size();
+  }
+  const double row_bytes = static_cast<double>(total_bytes) / static_cast<double>(num_rows);
+  return TensorOpCost{row_bytes, row_bytes, row_bytes * 8};
+}
+
 Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   int64_t mark = 0;
   auto status = info.GetAttr("mark", &mark);
@@ -99,6 +118,13 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
         }
         separators_.push_back(std::move(regex));
       }
+
+      bool all_literal = std::all_of(separators.cbegin(), separators.cend(), [](const std::string& sep) {
+        return !sep.empty() && sep.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+      });
+      if (all_literal) {
+        literal_separators_ = separators;
+      }
     } else {
       // Use tokenexp
       assert(!tokenexp.empty());
@@ -113,26 +139,53 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   }
 }
 
+// Finds the first occurrence of a non-empty literal at or after start_pos. memchr, which is vectorized, looks for
+// the first byte of the literal so runs of other characters are skipped many bytes at a time.
+static size_t FindLiteral(const re2::StringPiece& text, size_t start_pos, const std::string& literal) {
+  const char* const begin = text.data();
+  const char* const end = begin + text.size();
+  const size_t len = literal.size();
+  const char* p = begin + start_pos;
+  while (static_cast<size_t>(end - p) >= len) {
+    p = static_cast<const char*>(memchr(p, literal[0], static_cast<size_t>(end - p) - len + 1));
+    if (p == nullptr) {
+      break;
+    }
+    if (memcmp(p + 1, literal.data() + 1, len - 1) == 0) {
+      return static_cast<size_t>(p - begin);
+    }
+    ++p;
+  }
+  return std::string::npos;
+}
+
 Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
                                const std::vector<int64_t>& input_dims) const {
   // With char tokenzation we get as many tokens as the number of
   // utf8 characters in the string. So for every string we calculate its character(utf8) length
   // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       tokens)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
+  const size_t num_rows = N * C;
+  std::vector<size_t> row_tokens(num_rows);
+  std::vector<Status> row_status(num_rows);
+  const TensorOpCost cost = RowCost(input_data, num_rows);
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const auto& s = input_data[row];
+          if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(), row_tokens[row])) {
+            row_status[row] = Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                                     "Input string contains invalid utf8 chars: " + s);
+          }
+        }
+      });
+
+  size_t max_tokens = 0;
+  for (size_t row = 0; row < num_rows; ++row) {
+    ORT_RETURN_IF_ERROR(row_status[row]);
+    max_tokens = std::max(max_tokens, row_tokens[row]);
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -152,252 +205,184 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
-      size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
-      assert(result);
-      (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
-      token_idx += tlen;
-      ++tokens;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    // Padding strings
-    assert(tokens + (mark_ * 2) <= max_tokens);
-    const size_t pads = max_tokens - (mark_ * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-    ++curr_input;
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const auto& s = input_data[row];
+          auto output = output_data + row * max_tokens;
+          if (mark_) {
+            (output++)->assign(&start_text, 1);
+          }
+          const size_t str_len = s.size();
+          for (size_t token_idx = 0; token_idx < str_len;) {
+            size_t tlen = 0;
+            bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+            assert(result);
+            (void)result;
+            assert(token_idx + tlen <= str_len);
+            (output++)->assign(s.data() + token_idx, tlen);
+            token_idx += tlen;
+          }
+          if (mark_) {
+            (output++)->assign(&end_text, 1);
+          }
+          // Padding strings
+          for (auto const row_end = output_data + (row + 1) * max_tokens; output != row_end; ++output) {
+            *output = pad_value_;
+          }
+        }
+      });
   return Status::OK();
 }
 
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               const std::vector<int64_t>& input_dims) const {
+Status Tokenizer::SeparatorTokenize(const std::string& s, std::vector<re2::StringPiece>& row,
+                                    std::vector<re2::StringPiece>& tokens) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
-
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+  row.assign(1, StringPiece(s));
+  for (size_t sep_idx = 0; sep_idx < separators_.size(); ++sep_idx) {
+    const auto& sep = separators_[sep_idx];
+    const std::string* literal = literal_separators_.empty() ? nullptr : &literal_separators_[sep_idx];
+    tokens.clear();
+    for (const auto& text : row) {
+      const auto end_pos = text.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
+
+      bool match = true;
+      do {
+        if (literal != nullptr) {
+          const size_t literal_pos = FindLiteral(text, start_pos, *literal);
+          match = literal_pos != std::string::npos;
           if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + submatch.as_string());
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
+            submatch = StringPiece(text.data() + literal_pos, literal->size());
+          }
+        } else {
+          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+        }
+        size_t utf8_chars = 0;
+        if (match) {
+          // Record  pos/len
+          assert(submatch.data() != nullptr);
+          size_t match_pos = submatch.data() - text.data();
+          assert(match_pos >= start_pos);
+          auto token_len = match_pos - start_pos;
+          bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                token_len, utf8_chars);
+          if (!valid) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + submatch.as_string());
+          }
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, token_len);
+          }
+          // Update starting position
+          // Guard against empty string match
+          auto match_len = submatch.length();
+          if (match_len > 0) {
+            start_pos = match_pos + match_len;
           } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
+            size_t bytes = 0;
+            utf8_bytes(*submatch.data(), bytes);
+            start_pos = match_pos + bytes;
           }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
-  }
-
-  std::vector<int64_t> output_dims(input_dims);
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
+        } else {
+          // record trailing token
+          auto trailing_len = end_pos - start_pos;
+          utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                   trailing_len, utf8_chars);
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, trailing_len);
+          }
+        }
+      } while (match);
+    }  // row
+    // Replace the row with the results of this tokenezation
+    row.swap(tokens);
+  }  // separators_
   return Status::OK();
 }
 
-Status Tokenizer::TokenExpression(OpKernelContext* ctx,
-                                  size_t N, size_t C,
-                                  const std::vector<int64_t>& input_dims) const {
+Status Tokenizer::ExpressionTokenize(const std::string& s, std::vector<re2::StringPiece>& row) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
-
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-
-    size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+  StringPiece text(s);
+  const auto end_pos = s.length();
+  size_t start_pos = 0;
+  StringPiece submatch;
+
+  bool match = true;
+  do {
+    match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+    if (match) {
+      // Record  pos/len
+      assert(submatch.data() != nullptr);
+      size_t match_pos = submatch.data() - s.data();
+      assert(match_pos >= start_pos);
+      // Guard against empty match and make
+      // sure we make progress either way
+      auto token_len = submatch.length();
+      size_t utf8_chars = 0;
+      if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Match contains invalid utf8 chars: " + submatch.as_string());
+      }
+      if (utf8_chars >= size_t(mincharnum_)) {
+        row.push_back(submatch);
+        start_pos = match_pos + token_len;
+      } else {
+        size_t bytes = 0;
+        utf8_bytes(*submatch.data(), bytes);
+        start_pos = match_pos + bytes;
+      }
     }
+  } while (match);
+  return Status::OK();
+}
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + submatch.as_string());
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
+Status Tokenizer::ExpressionTokenizer(OpKernelContext* ctx, size_t N, size_t C,
+                                      const std::vector<int64_t>& input_dims) const {
+  using namespace re2;
+  auto X = ctx->Input<Tensor>(0);
+  auto const input_data = X->template Data<std::string>();
+  const size_t num_rows = N * C;
+
+  // Scan all strings and collect the output tokens of each one. The strings are independent of each other, so they
+  // are tokenized in parallel.
+  std::vector<std::vector<StringPiece>> rows(num_rows);
+  std::vector<Status> row_status(num_rows);
+  const TensorOpCost cost = RowCost(input_data, num_rows);
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<StringPiece> tokens;
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const auto& s = input_data[row];
+          size_t utf8_chars = 0;  // length in utf8 chars
+          if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(), utf8_chars)) {
+            row_status[row] = Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                                     "Input string contains invalid utf8 chars: " + s);
+          } else if (!separators_.empty()) {
+            row_status[row] = SeparatorTokenize(s, rows[row], tokens);
+          } else {
+            row_status[row] = ExpressionTokenize(s, rows[row]);
+          }
         }
-      }
-    } while (match);
-    max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
+      });
+
+  size_t max_tokens = 0;
+  for (size_t row = 0; row < num_rows; ++row) {
+    ORT_RETURN_IF_ERROR(row_status[row]);
+    max_tokens = std::max(max_tokens, rows[row].size());
   }
 
-  // Check for empty output
   std::vector<int64_t> output_dims(input_dims);
   // Check if we have no output due to either empty input
   // everything is a separator
@@ -417,42 +402,26 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
 
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
-
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          auto output = output_data + row * max_tokens;
+          if (mark_) {
+            (output++)->assign(&start_text, 1);
+          }
+          // Output tokens for this row
+          for (const auto& token : rows[row]) {
+            (output++)->assign(token.data(), token.size());
+          }
+          if (mark_) {
+            (output++)->assign(&end_text, 1);
+          }
+          for (auto const row_end = output_data + (row + 1) * max_tokens; output != row_end; ++output) {
+            *output = pad_value_;
+          }
+        }
+      });
   return Status::OK();
 }
 
@@ -497,12 +466,8 @@ Status Tokenizer::Compute(OpKernelContext* ctx) const {
   if (char_tokenezation_) {
     s = CharTokenize(ctx, N, C, input_dims);
   } else {
-    if (!separators_.empty()) {
-      s = SeparatorExpressionTokenizer(ctx, N, C, input_dims);
-    } else {
-      assert(regex_ != nullptr);
-      s = TokenExpression(ctx, N, C, input_dims);
-    }
+    assert(!separators_.empty() || regex_ != nullptr);
+    s = ExpressionTokenizer(ctx, N, C, input_dims);
   }
   return s;
 }
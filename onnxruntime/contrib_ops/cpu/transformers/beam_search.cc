@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/beam_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "core/framework/op_kernel_context_internal.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(BeamSearch,
+                        kMSDomain,
+                        1,
+                        kCpuExecutionProvider,
+                        KernelDefBuilder()
+                            .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>())
+                            .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                        transformers::BeamSearch);
+
+namespace transformers {
+
+namespace {
+
+// The num_beams best finished sequences of a prompt, scored by their sum of log probabilities divided by
+// length ^ length_penalty.
+class BeamHypotheses {
+ public:
+  struct Hypothesis {
+    float score;
+    std::vector<int64_t> sequence;
+  };
+
+  BeamHypotheses(int64_t num_beams, float length_penalty, bool early_stopping)
+      : num_beams_(static_cast<size_t>(num_beams)), length_penalty_(length_penalty), early_stopping_(early_stopping) {}
+
+  void Add(gsl::span<const int64_t> sequence, float sum_log_probs) {
+    const float score = sum_log_probs / std::pow(static_cast<float>(sequence.size()), length_penalty_);
+    if (hypotheses_.size() == num_beams_ && score <= hypotheses_.back().score) {
+      return;
+    }
+
+    auto position = std::upper_bound(hypotheses_.begin(), hypotheses_.end(), score,
+                                     [](float value, const Hypothesis& hypothesis) {
+                                       return value > hypothesis.score;
+                                     });
+    hypotheses_.insert(position, Hypothesis{score, std::vector<int64_t>(sequence.cbegin(), sequence.cend())});
+
+    if (hypotheses_.size() > num_beams_) {
+      hypotheses_.pop_back();
+    }
+  }
+
+  // the search for a prompt is done when none of its live beams can produce a better hypothesis than the worst one
+  bool IsDone(float best_sum_log_probs, int64_t sequence_length) const {
+    if (hypotheses_.size() < num_beams_) {
+      return false;
+    }
+
+    if (early_stopping_) {
+      return true;
+    }
+
+    return hypotheses_.back().score >= best_sum_log_probs / std::pow(static_cast<float>(sequence_length),
+                                                                     length_penalty_);
+  }
+
+  // sorted by descending score
+  const std::vector<Hypothesis>& Hypotheses() const { return hypotheses_; }
+
+ private:
+  size_t num_beams_;
+  float length_penalty_;
+  bool early_stopping_;
+  std::vector<Hypothesis> hypotheses_;
+};
+
+Status GetScalar(const Tensor* tensor, const char* name, int64_t default_value, int64_t& value) {
+  if (tensor == nullptr) {
+    value = default_value;
+    return Status::OK();
+  }
+
+  if (tensor->Shape().Size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "'", name, "' should be a scalar.");
+  }
+
+  value = *tensor->Data<int64_t>();
+  return Status::OK();
+}
+
+}  // namespace
+
+BeamSearch::BeamSearch(const OpKernelInfo& info) : GenerationBase(info) {
+  length_penalty_ = info.GetAttrOrDefault<float>("length_penalty", 1.0f);
+  early_stopping_ = info.GetAttrOrDefault<int64_t>("early_stopping", 0) != 0;
+}
+
+Status BeamSearch::Compute(OpKernelContext* context) const {
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  const auto& session_state = DecoderSessionState(*ctx_internal);
+
+  const auto* input_ids = context->Input<Tensor>(0);
+  const auto& dims = input_ids->Shape().GetDims();
+  if (dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "'input_ids' should have shape (batch_size, sequence_length). Got ", input_ids->Shape());
+  }
+
+  int64_t max_length = 0;
+  ORT_RETURN_IF_ERROR(GetMaxLength(context->Input<Tensor>(1), dims[1], max_length));
+
+  int64_t num_beams = 0;
+  ORT_RETURN_IF_ERROR(GetScalar(context->Input<Tensor>(2), "num_beams", 1, num_beams));
+
+  int64_t num_return_sequences = 0;
+  ORT_RETURN_IF_ERROR(GetScalar(context->Input<Tensor>(3), "num_return_sequences", 1, num_return_sequences));
+
+  if (num_beams < 1 || num_return_sequences < 1 || num_return_sequences > num_beams) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "'num_beams' should be positive and 'num_return_sequences' should be in [1, num_beams]. "
+                           "Got num_beams=", num_beams, " num_return_sequences=", num_return_sequences);
+  }
+
+  DecoderState state{*ctx_internal, session_state, *feeds_fetches_manager_, decoder_info_};
+  ORT_RETURN_IF_ERROR(state.Initialize(*input_ids, num_beams, pad_token_id_, max_length));
+
+  const int64_t batch_size = dims[0];
+  const int64_t num_sequences = state.NumSequences();
+
+  // all the beams of a prompt start out the same, so only the first one is expanded at the first step
+  std::vector<float> beam_scores(static_cast<size_t>(num_sequences), 0.0f);
+  for (int64_t i = 0; i < num_sequences; ++i) {
+    if (i % num_beams != 0) {
+      beam_scores[i] = -1e9f;
+    }
+  }
+
+  std::vector<BeamHypotheses> hypotheses(static_cast<size_t>(batch_size),
+                                         BeamHypotheses(num_beams, length_penalty_, early_stopping_));
+  std::vector<bool> done(static_cast<size_t>(batch_size), false);
+
+  std::vector<float> scores;
+  std::vector<int64_t> candidates;
+  std::vector<int64_t> next_tokens(static_cast<size_t>(num_sequences));
+  std::vector<int64_t> next_indices(static_cast<size_t>(num_sequences));
+  std::vector<float> next_scores(static_cast<size_t>(num_sequences));
+
+  while (state.SequenceLength() < max_length) {
+    gsl::span<const float> logits;
+    ORT_RETURN_IF_ERROR(state.Run(logits));
+
+    const int64_t vocab_size = state.VocabSize();
+
+    // score of every (beam, token) pair: the log probability of the beam followed by the token
+    scores.resize(static_cast<size_t>(num_sequences * vocab_size));
+    for (int64_t i = 0; i < num_sequences; ++i) {
+      const float* row = logits.data() + i * vocab_size;
+      const float max_logit = *std::max_element(row, row + vocab_size);
+
+      float sum = 0.0f;
+      for (int64_t v = 0; v < vocab_size; ++v) {
+        sum += std::exp(row[v] - max_logit);
+      }
+
+      const float offset = beam_scores[i] - max_logit - std::log(sum);
+      float* score_row = scores.data() + i * vocab_size;
+      for (int64_t v = 0; v < vocab_size; ++v) {
+        score_row[v] = row[v] + offset;
+      }
+    }
+
+    bool all_done = true;
+    for (int64_t b = 0; b < batch_size; ++b) {
+      const int64_t first = b * num_beams;
+
+      if (done[b]) {
+        // keep feeding padding to the beams of a finished prompt
+        for (int64_t k = 0; k < num_beams; ++k) {
+          next_tokens[first + k] = pad_token_id_;
+          next_indices[first + k] = first + k;
+          next_scores[first + k] = 0.0f;
+        }
+        continue;
+      }
+
+      // the 2 * num_beams best candidates leave at least num_beams which don't end the sequence
+      const float* batch_scores = scores.data() + first * vocab_size;
+      const int64_t num_scores = num_beams * vocab_size;
+      const int64_t num_candidates = std::min(2 * num_beams, num_scores);
+
+      candidates.resize(static_cast<size_t>(num_scores));
+      std::iota(candidates.begin(), candidates.end(), 0);
+      std::partial_sort(candidates.begin(), candidates.begin() + num_candidates, candidates.end(),
+                        [batch_scores](int64_t a, int64_t b) {
+                          return batch_scores[a] > batch_scores[b] || (batch_scores[a] == batch_scores[b] && a < b);
+                        });
+
+      int64_t num_next_beams = 0;
+      for (int64_t j = 0; j < num_candidates && num_next_beams < num_beams; ++j) {
+        const int64_t candidate = candidates[j];
+        const int64_t source = first + candidate / vocab_size;
+        const int64_t token = candidate % vocab_size;
+        const float score = batch_scores[candidate];
+
+        if (token == eos_token_id_) {
+          // an end of sequence outside the best num_beams candidates is not a better hypothesis
+          if (j < num_beams) {
+            hypotheses[b].Add(state.Sequence(source), score);
+          }
+          continue;
+        }
+
+        next_tokens[first + num_next_beams] = token;
+        next_indices[first + num_next_beams] = source;
+        next_scores[first + num_next_beams] = score;
+        ++num_next_beams;
+      }
+
+      if (num_next_beams < num_beams) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The vocabulary of size ", vocab_size,
+                               " is too small for a beam search with ", num_beams, " beams.");
+      }
+
+      done[b] = hypotheses[b].IsDone(batch_scores[candidates[0]], state.SequenceLength());
+      all_done = all_done && done[b];
+    }
+
+    if (all_done) {
+      break;
+    }
+
+    beam_scores.swap(next_scores);
+    ORT_RETURN_IF_ERROR(state.Update(next_tokens, next_indices));
+  }
+
+  // the live beams of the prompts that ran until max_length are hypotheses too
+  for (int64_t b = 0; b < batch_size; ++b) {
+    if (!done[b]) {
+      for (int64_t k = 0; k < num_beams; ++k) {
+        const int64_t i = b * num_beams + k;
+        hypotheses[b].Add(state.Sequence(i), beam_scores[i]);
+      }
+    }
+  }
+
+  Tensor* sequences = context->Output(0, {batch_size, num_return_sequences, max_length});
+  Tensor* sequences_scores = context->Output(1, {batch_size, num_return_sequences});
+
+  int64_t* sequences_data = sequences->MutableData<int64_t>();
+  std::fill_n(sequences_data, batch_size * num_return_sequences * max_length, pad_token_id_);
+
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const auto& best = hypotheses[b].Hypotheses();
+    for (int64_t r = 0; r < num_return_sequences; ++r) {
+      const auto& hypothesis = best[r];
+      const int64_t index = b * num_return_sequences + r;
+      std::copy(hypothesis.sequence.cbegin(), hypothesis.sequence.cend(), sequences_data + index * max_length);
+      if (sequences_scores != nullptr) {
+        sequences_scores->MutableData<float>()[index] = hypothesis.score;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "contrib_ops/cpu/transformers/generation_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Generates num_return_sequences sequences per prompt with a beam search over num_beams beams. The past state of the
+// beams that survive a step is gathered from the present state of the decoder inside the kernel.
+class BeamSearch final : public GenerationBase {
+ public:
+  explicit BeamSearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float length_penalty_;
+  bool early_stopping_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,419 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/generation_base.h"
+
+#include <algorithm>
+
+#include "core/framework/framework_common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+static bool IsTensorOfType(const NodeArg& node_arg, ONNX_NAMESPACE::TensorProto_DataType type) {
+  const auto* type_proto = node_arg.TypeAsProto();
+  return type_proto != nullptr && type_proto->has_tensor_type() && type_proto->tensor_type().elem_type() == type;
+}
+
+Status DecoderSubgraphInfo::Initialize(const GraphViewer& subgraph) {
+  const auto& inputs = subgraph.GetInputs();
+  const auto& outputs = subgraph.GetOutputs();
+
+  if (inputs.empty() || inputs[0]->Name() != "input_ids" ||
+      !IsTensorOfType(*inputs[0], ONNX_NAMESPACE::TensorProto_DataType_INT64)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The first input of the decoder subgraph should be the int64 tensor 'input_ids'.");
+  }
+
+  size_t past_start = 1;
+  if (past_start < inputs.size() && inputs[past_start]->Name() == "position_ids") {
+    if (!IsTensorOfType(*inputs[past_start], ONNX_NAMESPACE::TensorProto_DataType_INT64)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The 'position_ids' input of the decoder subgraph should be an int64 tensor.");
+    }
+    has_position_ids = true;
+    ++past_start;
+  }
+
+  if (past_start < inputs.size() && inputs[past_start]->Name() == "attention_mask") {
+    if (!IsTensorOfType(*inputs[past_start], ONNX_NAMESPACE::TensorProto_DataType_FLOAT)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The 'attention_mask' input of the decoder subgraph should be a float tensor.");
+    }
+    has_attention_mask = true;
+    ++past_start;
+  }
+
+  num_subgraph_inputs = static_cast<int>(inputs.size());
+  num_layers = static_cast<int>(inputs.size() - past_start);
+  if (num_layers == 0 || outputs.size() != static_cast<size_t>(num_layers) + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The decoder subgraph should have one past state input per layer, and the logits "
+                           "followed by one present state output per layer. Got ", num_layers, " past inputs and ",
+                           outputs.size(), " outputs.");
+  }
+
+  for (size_t i = past_start; i < inputs.size(); ++i) {
+    const auto& past = *inputs[i];
+    const auto* shape = past.Shape();
+    if (!IsTensorOfType(past, ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        shape == nullptr || shape->dim_size() != 5 ||
+        !shape->dim(2).has_dim_value() || !shape->dim(4).has_dim_value()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The past state input '", past.Name(),
+                             "' of the decoder subgraph should be a float tensor with shape "
+                             "(2, batch_size, num_heads, past_sequence_length, head_size) "
+                             "with known num_heads and head_size.");
+    }
+
+    if (i == past_start) {
+      num_heads = shape->dim(2).dim_value();
+      head_size = shape->dim(4).dim_value();
+    } else if (num_heads != shape->dim(2).dim_value() || head_size != shape->dim(4).dim_value()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "All the past state inputs of the decoder subgraph should have the same shape.");
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+static T* CreateTensor(const AllocatorPtr& allocator, const TensorShape& shape, OrtValue& ort_value) {
+  auto tensor = onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<T>(), shape, allocator);
+  T* data = tensor->MutableData<T>();
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+
+  return data;
+}
+
+DecoderState::DecoderState(OpKernelContextInternal& context, const SessionState& subgraph_session_state,
+                           const FeedsFetchesManager& ffm, const DecoderSubgraphInfo& info)
+    : context_(context),
+      subgraph_session_state_(subgraph_session_state),
+      ffm_(ffm),
+      info_(info) {
+  cpu_allocator_ = subgraph_session_state_.GetExecutionProviders()
+                       .Get(onnxruntime::kCpuExecutionProvider)
+                       ->GetAllocator(0, OrtMemTypeDefault);
+}
+
+Status DecoderState::Initialize(const Tensor& input_ids, int64_t num_beams, int64_t pad_token_id,
+                                int64_t max_length) {
+  const auto& dims = input_ids.Shape().GetDims();
+  if (dims.size() != 2 || dims[1] == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "'input_ids' should have shape (batch_size, sequence_length) with sequence_length > 0. Got ",
+                           input_ids.Shape());
+  }
+
+  const int64_t batch_size = dims[0];
+  const int64_t prompt_length = dims[1];
+
+  num_sequences_ = batch_size * num_beams;
+  max_length_ = max_length;
+  sequence_length_ = prompt_length;
+  attention_mask_length_ = prompt_length;
+
+  sequences_.assign(static_cast<size_t>(num_sequences_ * max_length_), pad_token_id);
+  next_positions_.resize(static_cast<size_t>(num_sequences_));
+  attention_mask_.resize(static_cast<size_t>(num_sequences_ * prompt_length));
+
+  const TensorShape prompt_shape{num_sequences_, prompt_length};
+
+  OrtValue input_ids_value;
+  int64_t* input_ids_data = CreateTensor<int64_t>(cpu_allocator_, prompt_shape, input_ids_value);
+
+  OrtValue position_ids_value;
+  int64_t* position_ids_data = CreateTensor<int64_t>(cpu_allocator_, prompt_shape, position_ids_value);
+
+  const int64_t* prompt = input_ids.Data<int64_t>();
+
+  for (int64_t i = 0; i < num_sequences_; ++i) {
+    const int64_t* prompt_row = prompt + (i / num_beams) * prompt_length;
+    std::copy(prompt_row, prompt_row + prompt_length, sequences_.data() + i * max_length_);
+    std::copy(prompt_row, prompt_row + prompt_length, input_ids_data + i * prompt_length);
+
+    // the position ids are deduced from the attention mask the same way as in gpt2_helper.py
+    int64_t tokens = 0;
+    for (int64_t j = 0; j < prompt_length; ++j) {
+      const bool is_token = prompt_row[j] != pad_token_id;
+      tokens += is_token ? 1 : 0;
+      attention_mask_[i * prompt_length + j] = is_token ? 1.0f : 0.0f;
+      position_ids_data[i * prompt_length + j] = std::max<int64_t>(tokens - 1, 0);
+    }
+
+    next_positions_[i] = tokens;
+  }
+
+  feeds_.clear();
+  feeds_.reserve(info_.num_subgraph_inputs + info_.num_implicit_inputs);
+  feeds_.push_back(input_ids_value);
+
+  if (info_.has_position_ids) {
+    feeds_.push_back(position_ids_value);
+  }
+
+  if (info_.has_attention_mask) {
+    OrtValue attention_mask_value;
+    float* attention_mask_data = CreateTensor<float>(cpu_allocator_, prompt_shape, attention_mask_value);
+    std::copy(attention_mask_.cbegin(), attention_mask_.cend(), attention_mask_data);
+    feeds_.push_back(attention_mask_value);
+  }
+
+  // the first step has an empty past state
+  const TensorShape past_shape{2, num_sequences_, info_.num_heads, 0, info_.head_size};
+  for (int i = 0; i < info_.num_layers; ++i) {
+    OrtValue past_value;
+    CreateTensor<float>(cpu_allocator_, past_shape, past_value);
+    feeds_.push_back(past_value);
+  }
+
+  for (const auto* entry : context_.GetImplicitInputs()) {
+    feeds_.push_back(*entry);
+  }
+
+  return Status::OK();
+}
+
+Status DecoderState::Run(gsl::span<const float>& next_token_logits) {
+  fetches_.clear();
+
+  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(subgraph_session_state_, ffm_, feeds_, fetches_, {},
+                                             ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(),
+                                             context_.Logger()));
+
+  const auto& logits = fetches_[0].Get<Tensor>();
+  const auto& dims = logits.Shape().GetDims();
+  if (!logits.IsDataType<float>() || dims.size() != 3 || dims[0] != num_sequences_ || dims[1] == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "The logits output of the decoder subgraph should be a float tensor with shape "
+                           "(batch_size, sequence_length, vocab_size). Got ", logits.Shape());
+  }
+
+  const int64_t positions = dims[1];
+  vocab_size_ = dims[2];
+
+  const float* logits_data = logits.Data<float>();
+
+  // only the logits of the last position are needed to pick the next token
+  if (positions == 1) {
+    next_token_logits = gsl::make_span(logits_data, static_cast<size_t>(num_sequences_ * vocab_size_));
+  } else {
+    next_token_logits_.resize(static_cast<size_t>(num_sequences_ * vocab_size_));
+    for (int64_t i = 0; i < num_sequences_; ++i) {
+      const float* last = logits_data + ((i + 1) * positions - 1) * vocab_size_;
+      std::copy(last, last + vocab_size_, next_token_logits_.data() + i * vocab_size_);
+    }
+
+    next_token_logits = gsl::make_span(next_token_logits_);
+  }
+
+  return Status::OK();
+}
+
+// Gathers the past state of the sequences that continue from each beam along the batch dimension of the
+// (2, batch_size, num_heads, sequence_length, head_size) present state.
+static Status ReorderPastState(const Tensor& present, gsl::span<const int64_t> beam_indices,
+                               const AllocatorPtr& allocator, OrtValue& past_value) {
+  const auto& dims = present.Shape().GetDims();
+  const auto num_sequences = static_cast<int64_t>(beam_indices.size());
+  if (!present.IsDataType<float>() || dims.size() != 5 || dims[0] != 2 || dims[1] != num_sequences) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "The present state outputs of the decoder subgraph should be float tensors with shape "
+                           "(2, batch_size, num_heads, sequence_length, head_size). Got ", present.Shape());
+  }
+
+  const int64_t block_size = dims[2] * dims[3] * dims[4];
+  const float* source = present.Data<float>();
+  float* target = CreateTensor<float>(allocator, present.Shape(), past_value);
+
+  for (int64_t half = 0; half < 2; ++half) {
+    for (int64_t i = 0; i < num_sequences; ++i) {
+      const float* block = source + (half * num_sequences + beam_indices[i]) * block_size;
+      std::copy(block, block + block_size, target + (half * num_sequences + i) * block_size);
+    }
+  }
+
+  return Status::OK();
+}
+
+Status DecoderState::Update(gsl::span<const int64_t> next_tokens, gsl::span<const int64_t> beam_indices) {
+  ORT_ENFORCE(static_cast<int64_t>(next_tokens.size()) == num_sequences_);
+  ORT_ENFORCE(beam_indices.empty() || static_cast<int64_t>(beam_indices.size()) == num_sequences_);
+  ORT_ENFORCE(sequence_length_ < max_length_, "The sequences are already at the maximum length.");
+
+  bool reorder = false;
+  for (size_t i = 0; i < beam_indices.size() && !reorder; ++i) {
+    reorder = beam_indices[i] != static_cast<int64_t>(i);
+  }
+
+  if (reorder) {
+    reordered_sequences_.resize(sequences_.size());
+    std::vector<int64_t> reordered_positions(next_positions_.size());
+    std::vector<float> reordered_attention_mask(attention_mask_.size());
+
+    for (int64_t i = 0; i < num_sequences_; ++i) {
+      const int64_t beam = beam_indices[i];
+      std::copy_n(sequences_.data() + beam * max_length_, sequence_length_,
+                  reordered_sequences_.data() + i * max_length_);
+      std::copy_n(attention_mask_.data() + beam * attention_mask_length_, attention_mask_length_,
+                  reordered_attention_mask.data() + i * attention_mask_length_);
+      reordered_positions[i] = next_positions_[beam];
+    }
+
+    sequences_.swap(reordered_sequences_);
+    next_positions_.swap(reordered_positions);
+    attention_mask_.swap(reordered_attention_mask);
+  }
+
+  const TensorShape token_shape{num_sequences_, 1};
+
+  OrtValue input_ids_value;
+  int64_t* input_ids_data = CreateTensor<int64_t>(cpu_allocator_, token_shape, input_ids_value);
+
+  OrtValue position_ids_value;
+  int64_t* position_ids_data = CreateTensor<int64_t>(cpu_allocator_, token_shape, position_ids_value);
+
+  // the attention mask gets a column for the new token
+  const int64_t attention_mask_length = attention_mask_length_ + 1;
+  std::vector<float> attention_mask(static_cast<size_t>(num_sequences_ * attention_mask_length));
+
+  for (int64_t i = 0; i < num_sequences_; ++i) {
+    sequences_[i * max_length_ + sequence_length_] = next_tokens[i];
+    input_ids_data[i] = next_tokens[i];
+    position_ids_data[i] = next_positions_[i]++;
+
+    const float* mask_row = attention_mask_.data() + i * attention_mask_length_;
+    float* next_mask_row = attention_mask.data() + i * attention_mask_length;
+    std::copy(mask_row, mask_row + attention_mask_length_, next_mask_row);
+    next_mask_row[attention_mask_length_] = 1.0f;
+  }
+
+  ++sequence_length_;
+  attention_mask_.swap(attention_mask);
+  attention_mask_length_ = attention_mask_length;
+
+  size_t feed_index = 0;
+  feeds_[feed_index++] = input_ids_value;
+
+  if (info_.has_position_ids) {
+    feeds_[feed_index++] = position_ids_value;
+  }
+
+  if (info_.has_attention_mask) {
+    OrtValue attention_mask_value;
+    float* attention_mask_data = CreateTensor<float>(cpu_allocator_, TensorShape{num_sequences_, attention_mask_length},
+                                                     attention_mask_value);
+    std::copy(attention_mask_.cbegin(), attention_mask_.cend(), attention_mask_data);
+    feeds_[feed_index++] = attention_mask_value;
+  }
+
+  // the present state of this step is the past state of the next one
+  for (int i = 0; i < info_.num_layers; ++i) {
+    const OrtValue& present = fetches_[i + 1];
+    if (reorder) {
+      ORT_RETURN_IF_ERROR(ReorderPastState(present.Get<Tensor>(), beam_indices, cpu_allocator_, feeds_[feed_index]));
+    } else {
+      feeds_[feed_index] = present;
+    }
+
+    ++feed_index;
+  }
+
+  return Status::OK();
+}
+
+GenerationBase::GenerationBase(const OpKernelInfo& info) : IControlFlowKernel(info) {
+  // make sure the attribute was present even though we don't need it here.
+  // a SessionState instance for executing the subgraph is created by InferenceSession and is available via
+  // OpKernelContextInternal::SubgraphSessionState("decoder") when Compute is called.
+  ONNX_NAMESPACE::GraphProto proto;
+  ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+  ORT_IGNORE_RETURN_VALUE(proto);
+
+  ORT_ENFORCE(info.GetAttr<int64_t>("eos_token_id", &eos_token_id_).IsOK());
+  pad_token_id_ = info.GetAttrOrDefault<int64_t>("pad_token_id", eos_token_id_);
+}
+
+Status GenerationBase::SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                                  const std::string& attribute_name,
+                                                  const SessionState& subgraph_session_state) {
+  ORT_ENFORCE(feeds_fetches_manager_ == nullptr,
+              "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+  ORT_UNUSED_PARAMETER(attribute_name);
+
+  const auto& node = Node();
+  const auto& subgraph = subgraph_session_state.GetGraphViewer();
+  ORT_RETURN_IF_ERROR(decoder_info_.Initialize(subgraph));
+  decoder_info_.num_implicit_inputs = static_cast<int>(node.ImplicitInputDefs().size());
+
+  std::vector<std::string> feed_names;
+  feed_names.reserve(decoder_info_.num_subgraph_inputs + decoder_info_.num_implicit_inputs);
+  for (const auto* input : subgraph.GetInputs()) {
+    feed_names.push_back(input->Name());
+  }
+
+  for (const auto* entry : node.ImplicitInputDefs()) {
+    feed_names.push_back(entry->Name());
+  }
+
+  // the decoder inputs are created on CPU by DecoderState, so only look up where the implicit inputs are
+  std::vector<OrtDevice> feed_locations;
+  ORT_RETURN_IF_ERROR(controlflow::detail::FindDevicesForValues(session_state, feed_names, feed_locations,
+                                                                decoder_info_.num_subgraph_inputs));
+
+  std::vector<std::string> fetch_names;
+  fetch_names.reserve(subgraph.GetOutputs().size());
+  for (const auto* output : subgraph.GetOutputs()) {
+    fetch_names.push_back(output->Name());
+  }
+
+  std::unique_ptr<FeedsFetchesManager> ffm;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, fetch_names,
+                                                  subgraph_session_state.GetOrtValueNameIdxMap(), ffm));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(subgraph_session_state, *ffm));
+
+  // the logits are searched and the present state is reordered on CPU
+  const auto& cpu_allocator_info = session_state.GetExecutionProviders()
+                                       .Get(onnxruntime::kCpuExecutionProvider)
+                                       ->GetAllocator(0, OrtMemTypeDefault)
+                                       ->Info();
+  std::vector<const OrtMemoryInfo*> fetch_locations(fetch_names.size(), &cpu_allocator_info);
+
+  utils::FinalizeFeedFetchCopyInfo(*ffm, feed_locations, fetch_locations);
+
+  feeds_fetches_manager_ = std::move(ffm);
+
+  return Status::OK();
+}
+
+Status GenerationBase::GetMaxLength(const Tensor* max_length_tensor, int64_t sequence_length, int64_t& max_length) {
+  if (max_length_tensor == nullptr || max_length_tensor->Shape().Size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "'max_length' should be a scalar.");
+  }
+
+  max_length = *max_length_tensor->Data<int64_t>();
+  if (max_length <= sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "'max_length' (", max_length,
+                           ") should be greater than the sequence length of 'input_ids' (", sequence_length, ").");
+  }
+
+  return Status::OK();
+}
+
+const SessionState& GenerationBase::DecoderSessionState(OpKernelContextInternal& context) const {
+  const auto* session_state = context.SubgraphSessionState("decoder");
+  ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'decoder' attribute.");
+  ORT_ENFORCE(feeds_fetches_manager_, "SetupSubgraphExecutionInfo must be called prior to execution of graph.");
+  return *session_state;
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
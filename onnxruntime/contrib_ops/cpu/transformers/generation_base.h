@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gsl/gsl"
+
+#include "core/common/common.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/controlflow/utils.h"
+
+namespace onnxruntime {
+class OpKernelContextInternal;
+
+namespace contrib {
+namespace transformers {
+
+// Inputs and outputs of the GPT-2 style decoder in the 'decoder' attribute, in the layout exported by
+// gpt2_helper.py:
+//   inputs:  input_ids, [position_ids], [attention_mask], past_0, ..., past_{num_layers - 1}
+//   outputs: logits, present_0, ..., present_{num_layers - 1}
+// input_ids and position_ids are int64 and have shape (batch_size, sequence_length), attention_mask is float and
+// has shape (batch_size, past_sequence_length + sequence_length), and each past state is float with shape
+// (2, batch_size, num_heads, past_sequence_length, head_size).
+struct DecoderSubgraphInfo {
+  Status Initialize(const GraphViewer& subgraph);
+
+  bool has_position_ids = false;
+  bool has_attention_mask = false;
+  int num_layers = 0;
+  int64_t num_heads = 0;
+  int64_t head_size = 0;
+
+  int num_subgraph_inputs = 0;
+  int num_implicit_inputs = 0;
+};
+
+// Per Compute() decoding state of num_sequences token sequences. The past state returned by one decoder step is kept
+// as an OrtValue and fed straight back into the next step, so it never leaves the kernel.
+class DecoderState {
+ public:
+  DecoderState(OpKernelContextInternal& context, const SessionState& subgraph_session_state,
+               const FeedsFetchesManager& ffm, const DecoderSubgraphInfo& info);
+
+  // Creates the feeds of the first step from the (batch_size, sequence_length) prompt, repeating each row
+  // num_beams times. Tokens equal to pad_token_id are masked out.
+  Status Initialize(const Tensor& input_ids, int64_t num_beams, int64_t pad_token_id, int64_t max_length);
+
+  // Runs one decoder step and returns the logits of the last position, with shape (num_sequences, vocab_size).
+  Status Run(gsl::span<const float>& next_token_logits);
+
+  // Appends next_tokens to the sequences. If beam_indices is not empty sequence i continues from the sequence
+  // beam_indices[i], and the sequences and the past state are reordered to match.
+  Status Update(gsl::span<const int64_t> next_tokens, gsl::span<const int64_t> beam_indices);
+
+  int64_t NumSequences() const { return num_sequences_; }
+  int64_t SequenceLength() const { return sequence_length_; }
+  int64_t VocabSize() const { return vocab_size_; }
+
+  gsl::span<const int64_t> Sequence(int64_t index) const {
+    return gsl::make_span(sequences_.data() + index * max_length_, static_cast<size_t>(sequence_length_));
+  }
+
+ private:
+  OpKernelContextInternal& context_;
+  const SessionState& subgraph_session_state_;
+  const FeedsFetchesManager& ffm_;
+  const DecoderSubgraphInfo& info_;
+  AllocatorPtr cpu_allocator_;
+
+  int64_t num_sequences_ = 0;
+  int64_t max_length_ = 0;
+  int64_t sequence_length_ = 0;
+  int64_t vocab_size_ = 0;
+
+  // num_sequences x max_length tokens, and the scratch buffer used to reorder them
+  std::vector<int64_t> sequences_;
+  std::vector<int64_t> reordered_sequences_;
+
+  // position id of the next token and attention mask of each sequence
+  std::vector<int64_t> next_positions_;
+  std::vector<float> attention_mask_;
+  int64_t attention_mask_length_ = 0;
+
+  // logits of the last position when the decoder returns more than one position
+  std::vector<float> next_token_logits_;
+
+  std::vector<OrtValue> feeds_;
+  std::vector<OrtValue> fetches_;
+};
+
+// Base class of the kernels that generate token sequences by running the decoder subgraph once per token.
+class GenerationBase : public controlflow::IControlFlowKernel {
+ public:
+  explicit GenerationBase(const OpKernelInfo& info);
+
+  Status SetupSubgraphExecutionInfo(const SessionState& session_state, const std::string& attribute_name,
+                                    const SessionState& subgraph_session_state) override;
+
+ protected:
+  // validates the max_length input and returns its value
+  static Status GetMaxLength(const Tensor* max_length_tensor, int64_t sequence_length, int64_t& max_length);
+
+  const SessionState& DecoderSessionState(OpKernelContextInternal& context) const;
+
+  int64_t eos_token_id_;
+  int64_t pad_token_id_;
+
+  DecoderSubgraphInfo decoder_info_;
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/greedy_search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+#include "core/framework/op_kernel_context_internal.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(GreedySearch,
+                        kMSDomain,
+                        1,
+                        kCpuExecutionProvider,
+                        KernelDefBuilder().TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),
+                        transformers::GreedySearch);
+
+namespace transformers {
+
+GreedySearch::GreedySearch(const OpKernelInfo& info) : GenerationBase(info) {
+  top_k_ = info.GetAttrOrDefault<int64_t>("top_k", 0);
+  top_p_ = info.GetAttrOrDefault<float>("top_p", 1.0f);
+  temperature_ = info.GetAttrOrDefault<float>("temperature", 1.0f);
+  ORT_ENFORCE(top_k_ >= 0, "top_k must not be negative. Got ", top_k_);
+  ORT_ENFORCE(top_p_ > 0.0f && top_p_ <= 1.0f, "top_p must be in (0, 1]. Got ", top_p_);
+  ORT_ENFORCE(temperature_ > 0.0f, "temperature must be positive. Got ", temperature_);
+
+  // read optional seed attribute and generate if not provided
+  int64_t seed = 0;
+  if (info.GetAttr<int64_t>("seed", &seed).IsOK()) {
+    generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
+  } else {
+    generator_ = std::default_random_engine{
+        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())};
+  }
+}
+
+// Samples the next token from the top_k most likely tokens, or all of them if top_k is 0, further narrowed to the
+// smallest set of most likely tokens whose probability reaches top_p.
+static int64_t SampleToken(gsl::span<const float> logits, int64_t top_k, float top_p, float temperature,
+                           std::default_random_engine& generator,
+                           std::vector<int64_t>& candidates, std::vector<float>& probabilities) {
+  const auto vocab_size = static_cast<int64_t>(logits.size());
+  const int64_t num_candidates = top_k > 0 ? std::min(top_k, vocab_size) : vocab_size;
+
+  candidates.resize(static_cast<size_t>(vocab_size));
+  std::iota(candidates.begin(), candidates.end(), 0);
+  std::partial_sort(candidates.begin(), candidates.begin() + num_candidates, candidates.end(),
+                    [&logits](int64_t a, int64_t b) {
+                      return logits[a] > logits[b] || (logits[a] == logits[b] && a < b);
+                    });
+
+  const float max_logit = logits[candidates[0]];
+  float sum = 0.0f;
+  probabilities.resize(static_cast<size_t>(num_candidates));
+  for (int64_t i = 0; i < num_candidates; ++i) {
+    probabilities[i] = std::exp((logits[candidates[i]] - max_logit) / temperature);
+    sum += probabilities[i];
+  }
+
+  int64_t num_kept = num_candidates;
+  if (top_p < 1.0f) {
+    float cumulative = 0.0f;
+    for (int64_t i = 0; i < num_candidates; ++i) {
+      cumulative += probabilities[i] / sum;
+      if (cumulative >= top_p) {
+        num_kept = i + 1;
+        break;
+      }
+    }
+  }
+
+  std::discrete_distribution<int64_t> distribution(probabilities.cbegin(), probabilities.cbegin() + num_kept);
+  return candidates[distribution(generator)];
+}
+
+Status GreedySearch::Compute(OpKernelContext* context) const {
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  const auto& session_state = DecoderSessionState(*ctx_internal);
+
+  const auto* input_ids = context->Input<Tensor>(0);
+  const auto& dims = input_ids->Shape().GetDims();
+  if (dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "'input_ids' should have shape (batch_size, sequence_length). Got ", input_ids->Shape());
+  }
+
+  int64_t max_length = 0;
+  ORT_RETURN_IF_ERROR(GetMaxLength(context->Input<Tensor>(1), dims[1], max_length));
+
+  DecoderState state{*ctx_internal, session_state, *feeds_fetches_manager_, decoder_info_};
+  ORT_RETURN_IF_ERROR(state.Initialize(*input_ids, 1, pad_token_id_, max_length));
+
+  const bool sample = top_k_ > 1 || top_p_ < 1.0f;
+  std::default_random_engine generator;
+  if (sample) {
+    std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
+    generator.seed(generator_());
+  }
+
+  const int64_t batch_size = state.NumSequences();
+  std::vector<bool> finished(static_cast<size_t>(batch_size), false);
+  std::vector<int64_t> next_tokens(static_cast<size_t>(batch_size));
+  std::vector<int64_t> candidates;
+  std::vector<float> probabilities;
+  int64_t num_unfinished = batch_size;
+
+  while (state.SequenceLength() < max_length && num_unfinished > 0) {
+    gsl::span<const float> logits;
+    ORT_RETURN_IF_ERROR(state.Run(logits));
+
+    const int64_t vocab_size = state.VocabSize();
+
+    for (int64_t i = 0; i < batch_size; ++i) {
+      // sequences that produced the end of sequence token are padded
+      if (finished[i]) {
+        next_tokens[i] = pad_token_id_;
+        continue;
+      }
+
+      auto row = logits.subspan(i * vocab_size, vocab_size);
+      if (sample) {
+        next_tokens[i] = SampleToken(row, top_k_, top_p_, temperature_, generator, candidates, probabilities);
+      } else {
+        next_tokens[i] = std::max_element(row.cbegin(), row.cend()) - row.cbegin();
+      }
+
+      if (next_tokens[i] == eos_token_id_) {
+        finished[i] = true;
+        --num_unfinished;
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(state.Update(next_tokens, {}));
+  }
+
+  Tensor* sequences = context->Output(0, {batch_size, max_length});
+  int64_t* sequences_data = sequences->MutableData<int64_t>();
+  std::fill_n(sequences_data, batch_size * max_length, pad_token_id_);
+
+  for (int64_t i = 0; i < batch_size; ++i) {
+    auto sequence = state.Sequence(i);
+    std::copy(sequence.cbegin(), sequence.cend(), sequences_data + i * max_length);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <random>
+
+#include "core/platform/ort_mutex.h"
+#include "contrib_ops/cpu/transformers/generation_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Generates one sequence per prompt by picking the most likely next token at each step, or by sampling it from the
+// top_k most likely tokens and/or the smallest set of tokens whose probability reaches top_p.
+class GreedySearch final : public GenerationBase {
+ public:
+  explicit GreedySearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t top_k_;
+  float top_p_;
+  float temperature_;
+
+  // every call to Compute() seeds its own engine from generator_.
+  // use generator_mutex_ to ensure Compute() can be called concurrently.
+  mutable std::default_random_engine generator_;
+  mutable onnxruntime::OrtMutex generator_mutex_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #include "word_conv_embedding.h"
 
+#include <vector>
+
+#include "core/platform/threadpool.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
@@ -10,33 +13,13 @@
 namespace onnxruntime {
 namespace contrib {
 
-void WordConvEmbedding::CharEmbeddingLookup(
-    const int* seq_ptr,
-    const float* char_embedding_weight_p,
-    size_t seq_len,
-    size_t word_len,
-    size_t char_embedding_size,
-    size_t filter_width,
-    const int* words_len_ptr,
-    float* dst) const {
-  for (size_t word_inx = 0; word_inx < seq_len; word_inx++) {
-    if (words_len_ptr[word_inx] > 0) {
-      const int* cur_seq_ptr = seq_ptr + word_inx * word_len;
-      float* cur_dst_ptr = dst + word_inx * word_len * char_embedding_size;
-      size_t char_length_to_lookup = std::max<size_t>(words_len_ptr[word_inx], filter_width);
-      for (size_t char_inx = 0; char_inx < char_length_to_lookup; char_inx++) {
-        memcpy(cur_dst_ptr, char_embedding_weight_p + (*cur_seq_ptr) * char_embedding_size, sizeof(float) * char_embedding_size);
-        cur_dst_ptr += char_embedding_size;
-        cur_seq_ptr++;
-      }
-    }
-  }
-}
-
-//input : [sequence_length, word_length, char_embedding_size]
+// The convolution input of each word is unfolded straight from the char embedding table, so the convolutions of
+// all the words in the sequence run as a single GEMM. As tanh is monotonic, the max pooling is done on the raw
+// convolution result and the bias and activation are only applied to the pooled output.
 void WordConvEmbedding::ComputeConvMaxPoolWithActivation(
     AllocatorPtr allocator,
-    const float* input,
+    const int* seq_ptr,
+    const float* char_embedding_weight_p,
     const float* weights,
     const float* bias,
     const int* words_len_ptr,
@@ -46,74 +29,82 @@ void WordConvEmbedding::ComputeConvMaxPoolWithActivation(
     int64_t filter_width,
     int64_t num_filters,
     float* output, concurrency::ThreadPool* tp) const {
-  int64_t input_word_size = word_len * char_embedding_size;
-  int64_t unfolded_width = word_len - filter_width + 1;
   int64_t unfolded_kernal_size = filter_width * char_embedding_size;
-  int64_t unfolded_segment_size = unfolded_width * unfolded_kernal_size;
-  int64_t conv_res_segment_size = unfolded_width * num_filters;
-  int64_t memcpy_size = unfolded_kernal_size * sizeof(float);
-
-  auto unfolded_buffer_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * unfolded_segment_size);
-  auto conv_result_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * conv_res_segment_size);
-  auto conv_activation_result_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * conv_res_segment_size);
-
-  int64_t word_inx = 0;
-  while (word_inx < seq_len) {
-    if (words_len_ptr[word_inx] <= 0) {
-      word_inx++;
-      continue;
-    }
+  size_t memcpy_size = char_embedding_size * sizeof(float);
 
-    float* words_unfolded_buffer_p = unfolded_buffer_p.get();
-    int64_t words_unfolded_width = 0;
-    int64_t tmp_word_inx = word_inx;
-    float* conv_buf_p = conv_result_p.get();
-    float* pactivationbuf = conv_activation_result_p.get();
-
-    // unfolding buffer
-    while (tmp_word_inx < seq_len && words_len_ptr[tmp_word_inx] > 0) {
-      const float* current_word_input = input + tmp_word_inx * input_word_size;
-      int64_t word_unfolded_width = std::max<int64_t>(words_len_ptr[tmp_word_inx], filter_width) - filter_width + 1;
-      words_unfolded_width += word_unfolded_width;
-      for (int64_t unfolded_inx = 0; unfolded_inx < word_unfolded_width; unfolded_inx++) {
-        memcpy(words_unfolded_buffer_p, current_word_input, memcpy_size);
-        current_word_input += char_embedding_size;
-        words_unfolded_buffer_p += unfolded_kernal_size;
-      }
-      tmp_word_inx++;
+  // the first unfolded row of each word, empty words have no rows
+  std::vector<int64_t> words_unfolded_offset(seq_len + 1, 0);
+  for (int64_t word_inx = 0; word_inx < seq_len; word_inx++) {
+    int64_t word_unfolded_width = 0;
+    if (words_len_ptr[word_inx] > 0) {
+      word_unfolded_width = std::max<int64_t>(words_len_ptr[word_inx], filter_width) - filter_width + 1;
     }
+    words_unfolded_offset[word_inx + 1] = words_unfolded_offset[word_inx] + word_unfolded_width;
+  }
 
-    math::GemmEx<float>(
-        CblasNoTrans, CblasTrans,
-        static_cast<int>(words_unfolded_width), static_cast<int>(num_filters), static_cast<int>(unfolded_kernal_size), 1.0f,
-        unfolded_buffer_p.get(), static_cast<int>(unfolded_kernal_size),
-        weights, static_cast<int>(unfolded_kernal_size), 0.0f,
-        conv_buf_p, static_cast<int>(num_filters), tp);
-
-    for (int64_t unfolded_inx = 0; unfolded_inx < words_unfolded_width; unfolded_inx++)
-      for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-        conv_buf_p[unfolded_inx * num_filters + filter_inx] += bias[filter_inx];
-      }
-    MlasComputeTanh(conv_buf_p, pactivationbuf, words_unfolded_width * num_filters);
-
-    float* activationbuf_cur_ptr = pactivationbuf;
-    for (int64_t pool_word_inx = word_inx; pool_word_inx < tmp_word_inx; pool_word_inx++) {
-      float* result_ptr = output + pool_word_inx * num_filters;
-      for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-        result_ptr[filter_inx] = -1.0f * 1e12f;
-      }
+  int64_t words_unfolded_width = words_unfolded_offset[seq_len];
+  if (words_unfolded_width == 0) {
+    std::memset(output, 0, seq_len * num_filters * sizeof(float));
+    return;
+  }
 
-      int64_t word_unfolded_width = std::max<int64_t>(words_len_ptr[pool_word_inx], filter_width) - filter_width + 1;
-      for (int64_t unfolded_inx = 0; unfolded_inx < word_unfolded_width; unfolded_inx++) {
-        for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-          result_ptr[filter_inx] = std::max(activationbuf_cur_ptr[filter_inx], result_ptr[filter_inx]);
+  auto unfolded_buffer_p = IAllocator::MakeUniquePtr<float>(allocator, words_unfolded_width * unfolded_kernal_size);
+  auto conv_result_p = IAllocator::MakeUniquePtr<float>(allocator, words_unfolded_width * num_filters);
+  float* unfolded_buffer = unfolded_buffer_p.get();
+  const float* conv_buf_p = conv_result_p.get();
+
+  // unfolding buffer
+  concurrency::ThreadPool::TryParallelFor(
+      tp, seq_len, static_cast<double>(word_len * unfolded_kernal_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t word_inx = first; word_inx < last; word_inx++) {
+          const int* word_seq_ptr = seq_ptr + word_inx * word_len;
+          float* words_unfolded_buffer_p = unfolded_buffer + words_unfolded_offset[word_inx] * unfolded_kernal_size;
+          int64_t word_unfolded_width = words_unfolded_offset[word_inx + 1] - words_unfolded_offset[word_inx];
+          for (int64_t unfolded_inx = 0; unfolded_inx < word_unfolded_width; unfolded_inx++) {
+            for (int64_t char_inx = unfolded_inx; char_inx < unfolded_inx + filter_width; char_inx++) {
+              memcpy(words_unfolded_buffer_p, char_embedding_weight_p + word_seq_ptr[char_inx] * char_embedding_size, memcpy_size);
+              words_unfolded_buffer_p += char_embedding_size;
+            }
+          }
         }
-        activationbuf_cur_ptr += num_filters;
-      }
-    }
-    word_inx = tmp_word_inx;
-  }
+      });
+
+  math::GemmEx<float>(
+      CblasNoTrans, CblasTrans,
+      static_cast<int>(words_unfolded_width), static_cast<int>(num_filters), static_cast<int>(unfolded_kernal_size), 1.0f,
+      unfolded_buffer, static_cast<int>(unfolded_kernal_size),
+      weights, static_cast<int>(unfolded_kernal_size), 0.0f,
+      conv_result_p.get(), static_cast<int>(num_filters), tp);
+
+  // max pooling, then bias and activation. The output of an empty word is 0.
+  concurrency::ThreadPool::TryParallelFor(
+      tp, seq_len, static_cast<double>(word_len * num_filters),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t word_inx = first; word_inx < last; word_inx++) {
+          float* result_ptr = output + word_inx * num_filters;
+          if (words_unfolded_offset[word_inx + 1] == words_unfolded_offset[word_inx]) {
+            std::memset(result_ptr, 0, num_filters * sizeof(float));
+            continue;
+          }
+
+          const float* activationbuf_cur_ptr = conv_buf_p + words_unfolded_offset[word_inx] * num_filters;
+          memcpy(result_ptr, activationbuf_cur_ptr, num_filters * sizeof(float));
+          for (int64_t unfolded_inx = words_unfolded_offset[word_inx] + 1; unfolded_inx < words_unfolded_offset[word_inx + 1]; unfolded_inx++) {
+            activationbuf_cur_ptr += num_filters;
+            for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
+              result_ptr[filter_inx] = std::max(activationbuf_cur_ptr[filter_inx], result_ptr[filter_inx]);
+            }
+          }
+          for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
+            result_ptr[filter_inx] += bias[filter_inx];
+          }
+        }
+        MlasComputeTanh(output + first * num_filters, output + first * num_filters,
+                        static_cast<size_t>((last - first) * num_filters));
+      });
 }
+
 void WordConvEmbedding::CalculateLengthOfEachWordInSequence(
     const int* seq_ptr,
     int* words_len_ptr,
@@ -186,28 +177,15 @@ Status WordConvEmbedding::Compute(OpKernelContext* ctx) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
 
-  // allocate memory for char look up
-  // seq_len * word_len * char_embedding_size
-  size_t chars_embeddings_size = seq_len * word_len * char_embedding_size;
-  auto chars_embeddings_ptr = IAllocator::MakeUniquePtr<float>(alloc, chars_embeddings_size);
   auto words_length_ptr = IAllocator::MakeUniquePtr<int>(alloc, seq_len);
-  std::memset(chars_embeddings_ptr.get(), 0, chars_embeddings_size * sizeof(float));
   std::memset(words_length_ptr.get(), 0, seq_len * sizeof(int));
 
   CalculateLengthOfEachWordInSequence(seq_ptr, words_length_ptr.get(), seq_len, word_len);
 
-  CharEmbeddingLookup(seq_ptr,
-                      w_char_embedding.Data<float>(),
-                      seq_len,
-                      word_len,
-                      char_embedding_size,
-                      filter_width,
-                      words_length_ptr.get(),
-                      chars_embeddings_ptr.get());
-
   ComputeConvMaxPoolWithActivation(
       alloc,
-      chars_embeddings_ptr.get(),
+      seq_ptr,
+      w_char_embedding.Data<float>(),
       w_conv.Data<float>(),
       b_conv.Data<float>(),
       words_length_ptr.get(),
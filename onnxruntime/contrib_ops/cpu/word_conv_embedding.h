@@ -21,18 +21,10 @@ class WordConvEmbedding final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  void CharEmbeddingLookup(
-      const int* seq_ptr,
-      const float* char_embedding_weight_p,
-      size_t seq_len,
-      size_t word_len,
-      size_t char_embedding_size,
-      size_t filter_width,
-      const int* words_len_ptr,
-      float* dst) const;
   void ComputeConvMaxPoolWithActivation(
       AllocatorPtr allocator,
-      const float* input,
+      const int* seq_ptr,
+      const float* char_embedding_weight_p,
       const float* weights,
       const float* bias,
       const int* words_len_ptr,
@@ -6,6 +6,7 @@
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 #include "attention_impl.h"
+#include "token_packing_impl.h"
 
 using namespace onnxruntime::cuda;
 using namespace ::onnxruntime::common;
@@ -23,7 +24,8 @@ namespace cuda {
       T,                                                          \
       kCudaExecutionProvider,                                     \
       KernelDefBuilder()                                          \
-          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())  \
+          .InputMemoryType<OrtMemTypeCPUInput>(5),                \
       Attention<T>);
 
 REGISTER_KERNEL_TYPED(float)
@@ -39,30 +41,68 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* bias = context->Input<Tensor>(2);
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
-  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(), weights->Shape(), bias->Shape(), mask_index, past));
+  const Tensor* past_seq_len = context->Input<Tensor>(5);
+  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(), weights->Shape(), bias->Shape(), mask_index, past, past_seq_len));
 
   // Input and output shapes:
   //   Input 0 - input       : (batch_size, sequence_length, hidden_size)
   //   Output 0 - output     : (batch_size, sequence_length, hidden_size)
+  //   or with packed tokens:
+  //   Input 0 - input       : (1, total_tokens, hidden_size)
+  //   Output 0 - output     : (1, total_tokens, hidden_size)
   const auto& shape = input->Shape();
   int batch_size = static_cast<int>(shape[0]);
   int sequence_length = static_cast<int>(shape[1]);
   int hidden_size = static_cast<int>(shape[2]);
   int head_size = hidden_size / num_heads_;
 
+  // Number of tokens of the input, which is batch_size * sequence_length unless the tokens are packed
+  const int total_tokens = batch_size * sequence_length;
+
+  // The packed tokens are scattered into a padded tensor for the attention kernel, with sequence_length of the longest
+  // sequence, so that only the attention computes on padding. Sizing it requires the sequence lengths on the host.
+  CudaAsyncBuffer<int> token_offsets_gpu(this);
+  if (packed_tokens_) {
+    ORT_RETURN_IF_NOT(context->OutputCount() < 2, "Output 'present' is not supported when packed_tokens is 1");
+    batch_size = static_cast<int>(mask_index->Shape()[0]);
+    std::vector<int32_t> sequence_lengths(batch_size);
+    CUDA_RETURN_IF_ERROR(cudaMemcpy(sequence_lengths.data(), mask_index->template Data<int32_t>(),
+                                    batch_size * sizeof(int32_t), cudaMemcpyDeviceToHost));
+    std::vector<int> token_offsets;
+    ORT_RETURN_IF_ERROR(GetTokenOffsets(sequence_lengths.data(), batch_size, total_tokens, token_offsets,
+                                        sequence_length));
+    token_offsets_gpu.AllocCpuPtr(token_offsets.size());
+    memcpy(token_offsets_gpu.CpuPtr(), token_offsets.data(), token_offsets.size() * sizeof(int));
+    ORT_RETURN_IF_ERROR(token_offsets_gpu.CopyToGpu());
+  }
+
   Tensor* output = context->Output(0, shape);
 
   int past_sequence_length = 0;
-  Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length);
+  Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length, past_seq_len);
+
+  // With a shared buffer the new keys and values are appended to present in place, so it only needs the content of
+  // past if it was not bound to the same buffer.
+  int max_sequence_length = 0;
+  if (past_present_share_buffer_) {
+    if (nullptr == present) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output 'present' is required when past_present_share_buffer is 1");
+    }
+    max_sequence_length = static_cast<int>(past->Shape()[3]);
+    if (present->DataRaw() != past->DataRaw()) {
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(present->MutableDataRaw(), past->DataRaw(), past->SizeInBytes(),
+                                           cudaMemcpyDeviceToDevice));
+    }
+  }
 
   cublasHandle_t cublas = CublasHandle();
   constexpr size_t element_size = sizeof(T);
 
   // Use GEMM for fully connection.
-  int m = batch_size * sequence_length;
+  int m = total_tokens;
   int n = 3 * hidden_size;
   int k = hidden_size;
-  auto gemm_buffer = GetScratchBuffer<T>(batch_size * sequence_length * 3 * hidden_size * element_size);
+  auto gemm_buffer = GetScratchBuffer<T>(total_tokens * 3 * hidden_size * element_size);
 
   typedef typename ToCudaType<T>::MappedType CudaT;
   CudaT one = ToCudaType<T>::FromFloat(1.0f);
@@ -84,14 +124,29 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
       reinterpret_cast<const CudaT*>(input->template Data<T>()), k,
       &one, reinterpret_cast<CudaT*>(gemm_buffer.get()), n, device_prop));
 
+  // With packed tokens, the attention runs from and to padded tensors, with the sequence lengths in mask_index.
+  IAllocatorUniquePtr<T> padded_qkv;
+  IAllocatorUniquePtr<T> padded_output;
+  if (packed_tokens_) {
+    const size_t padded_tokens = static_cast<size_t>(batch_size) * sequence_length;
+    padded_qkv = GetScratchBuffer<T>(padded_tokens * 3 * hidden_size);
+    padded_output = GetScratchBuffer<T>(padded_tokens * hidden_size);
+    if (!LaunchRestorePadding(gemm_buffer.get(), padded_qkv.get(), token_offsets_gpu.GpuPtr(),
+                              batch_size, sequence_length, 3 * hidden_size, element_size)) {
+      // Get last error to reset it to cudaSuccess.
+      CUDA_CALL(cudaGetLastError());
+      return Status(common::ONNXRUNTIME, common::FAIL);
+    }
+  }
+
   size_t workSpaceSize = GetAttentionWorkspaceSize(element_size, batch_size, num_heads_, head_size, sequence_length, past_sequence_length);
   auto temp_buffer = GetScratchBuffer<void>(workSpaceSize);
   if (!LaunchAttentionKernel(
           device_prop,
-          reinterpret_cast<const CudaT*>(gemm_buffer.get()),
+          reinterpret_cast<const CudaT*>(packed_tokens_ ? padded_qkv.get() : gemm_buffer.get()),
           nullptr == mask_index ? nullptr : mask_index->template Data<int>(),
           nullptr == mask_index ? nullptr : &(mask_index->Shape().GetDims()),
-          output->template MutableData<T>(),
+          packed_tokens_ ? padded_output.get() : output->template MutableData<T>(),
           batch_size,
           sequence_length,
           num_heads_,
@@ -102,7 +157,16 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
           is_unidirectional_,
           past_sequence_length,
           nullptr == past ? nullptr : past->template Data<T>(),
-          nullptr == present ? nullptr : present->template MutableData<T>())) {
+          nullptr == present ? nullptr : present->template MutableData<T>(),
+          max_sequence_length)) {
+    // Get last error to reset it to cudaSuccess.
+    CUDA_CALL(cudaGetLastError());
+    return Status(common::ONNXRUNTIME, common::FAIL);
+  }
+
+  if (packed_tokens_ &&
+      !LaunchRemovePadding(padded_output.get(), output->template MutableData<T>(), token_offsets_gpu.GpuPtr(),
+                           batch_size, sequence_length, hidden_size, element_size)) {
     // Get last error to reset it to cudaSuccess.
     CUDA_CALL(cudaGetLastError());
     return Status(common::ONNXRUNTIME, common::FAIL);
@@ -535,6 +535,44 @@ bool LaunchTransQkv(cudaStream_t stream,
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
+template <typename T>
+__global__ void DequantizeTransposeQKV(const int H, const int32_t* input, const T* bias, const float scale,
+                                       T* output) {
+  // Input:  BxSx3xNxH of the int32 results of the int8 GEMM
+  // Output: 3xBxNxSxH of input * scale + bias
+
+  int n = threadIdx.y;
+  int s = blockIdx.x;
+  int b = blockIdx.y;
+  int m = blockIdx.z;  // matrix id
+
+  const int num_heads = blockDim.y;
+
+  const int sequence_length = gridDim.x;
+  const int batch_size = gridDim.y;
+  const int NH = num_heads * H;
+  const int NHS = NH * sequence_length;
+  const int bias_offset = n * H + m * NH;
+  const int in_offset = bias_offset + s * 3 * NH + b * NHS * 3;
+  const int out_offset = s * H + n * sequence_length * H + b * NHS + m * NHS * batch_size;
+
+  const int i = threadIdx.x;
+  if (i < H) {
+    output[out_offset + i] = T(scale * static_cast<float>(input[in_offset + i]) +
+                               static_cast<float>(bias[bias_offset + i]));
+  }
+}
+
+template <typename T>
+bool LaunchDequantizeTransQkv(cudaStream_t stream,
+                              const int sequence_length, const int batch_size, const int head_size, const int num_heads,
+                              const int32_t* input, const T* bias, const float scale, T* output) {
+  const dim3 grid(sequence_length, batch_size, 3);
+  const dim3 block(head_size, num_heads, 1);
+  DequantizeTransposeQKV<T><<<grid, block, 0, stream>>>(head_size, input, bias, scale, output);
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
 template <typename T>
 __global__ void ConcatPastToPresent(const int sequence_length,
                                     const T* past,
@@ -615,6 +653,77 @@ bool LaunchConcatPastToPresent(cudaStream_t stream,
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
+template <typename T>
+__global__ void AppendKVToPresent(const int past_sequence_length,
+                                  const int max_sequence_length,
+                                  const T* k_v,
+                                  T* present) {
+  const int h = threadIdx.x;
+  const int n = threadIdx.y;
+  const int s = blockIdx.x;
+  const int b = blockIdx.y;
+  const int is_v = blockIdx.z;  // 0 for k, 1 for v
+
+  const int sequence_length = gridDim.x;
+  const int batch_size = gridDim.y;
+  const int num_heads = blockDim.y;
+  const int H = blockDim.x;
+
+  // k_v:     2 x BxNxSxH    (k and v)
+  // present: 2 x BxNxMxH    (present_k and present_v), with the past in the first S' positions of M
+  const int SH = sequence_length * H;
+  const int NSH = num_heads * SH;
+  const int in_offset = b * NSH + n * SH + s * H + h + is_v * (NSH * batch_size);
+
+  const int present_SH = max_sequence_length * H;
+  const int present_NSH = num_heads * present_SH;
+  const int out_offset = b * present_NSH + n * present_SH + (past_sequence_length + s) * H + h + is_v * (present_NSH * batch_size);
+  present[out_offset] = k_v[in_offset];
+}
+
+bool LaunchAppendKVToPresent(cudaStream_t stream,
+                             const int max_sequence_length,
+                             const int past_sequence_length,
+                             const int sequence_length,
+                             const int batch_size,
+                             const int head_size,
+                             const int num_heads,
+                             const float* k_v,
+                             float* present) {
+  const dim3 grid(sequence_length, batch_size, 2);
+  if (0 == (head_size & 1)) {
+    const dim3 block(head_size / 2, num_heads, 1);
+    AppendKVToPresent<float2><<<grid, block, 0, stream>>>(past_sequence_length, max_sequence_length, reinterpret_cast<const float2*>(k_v), reinterpret_cast<float2*>(present));
+  } else {
+    const dim3 block(head_size, num_heads, 1);
+    AppendKVToPresent<float><<<grid, block, 0, stream>>>(past_sequence_length, max_sequence_length, k_v, present);
+  }
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
+bool LaunchAppendKVToPresent(cudaStream_t stream,
+                             const int max_sequence_length,
+                             const int past_sequence_length,
+                             const int sequence_length,
+                             const int batch_size,
+                             const int head_size,
+                             const int num_heads,
+                             const half* k_v,
+                             half* present) {
+  const dim3 grid(sequence_length, batch_size, 2);
+  if (0 == (head_size % 4)) {
+    const dim3 block(head_size / 4, num_heads, 1);
+    AppendKVToPresent<float2><<<grid, block, 0, stream>>>(past_sequence_length, max_sequence_length, reinterpret_cast<const float2*>(k_v), reinterpret_cast<float2*>(present));
+  } else if (0 == (head_size & 1)) {
+    const dim3 block(head_size / 2, num_heads, 1);
+    AppendKVToPresent<half2><<<grid, block, 0, stream>>>(past_sequence_length, max_sequence_length, reinterpret_cast<const half2*>(k_v), reinterpret_cast<half2*>(present));
+  } else {
+    const dim3 block(head_size, num_heads, 1);
+    AppendKVToPresent<half><<<grid, block, 0, stream>>>(past_sequence_length, max_sequence_length, k_v, present);
+  }
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
 cublasStatus_t inline CublasGemmStridedBatched(
     cublasHandle_t handle, cublasOperation_t transa, cublasOperation_t transb,
     int m, int n, int k, const float alpha,
@@ -639,7 +748,8 @@ bool QkvToContext(
     const int batch_size, const int sequence_length, const int num_heads, const int head_size, const size_t element_size,
     const T* input, T* output, T* workspace,
     const int* mask_index, const std::vector<int64_t>* mask_index_dims,
-    bool is_unidirectional, int past_sequence_length, const T* past, T* present) {
+    bool is_unidirectional, int past_sequence_length, const T* past, T* present, int max_sequence_length,
+    const int32_t* quantized_input = nullptr, const T* bias = nullptr, float dequant_scale = 0.f) {
   const int all_sequence_length = past_sequence_length + sequence_length;
   const size_t bytes = ScratchSize(element_size, batch_size, num_heads, sequence_length, all_sequence_length);
   T* scratch1 = workspace;
@@ -647,7 +757,13 @@ bool QkvToContext(
   T* scratch3 = scratch2 + (bytes / element_size);
 
   // input should be BxSx3xNxH => scratch3: 3xBxNxSxH
-  if (!LaunchTransQkv(stream, sequence_length, batch_size, head_size, num_heads, input, scratch3)) {
+  if (nullptr != quantized_input) {
+    // the int32 results of the int8 GEMM are dequantized and biased as they are transposed
+    if (!LaunchDequantizeTransQkv(stream, sequence_length, batch_size, head_size, num_heads,
+                                  quantized_input, bias, dequant_scale, scratch3)) {
+      return false;
+    }
+  } else if (!LaunchTransQkv(stream, sequence_length, batch_size, head_size, num_heads, input, scratch3)) {
     return false;
   }
 
@@ -666,8 +782,18 @@ bool QkvToContext(
   // Concat past (2xBxNxS'xH) to present (2xBxNxS*xH):
   // past_k (BxNxS'xH) + k (BxNxSxH) => present_k (BxNxS*xH)
   // past_v (BxNxS'xH) + v (BxNxSxH) => present_v (BxNxS*xH)
-  const int present_size_per_batch = all_sequence_length * head_size;
-  if (nullptr != present) {
+  // With a shared buffer, present (2xBxNxMxH) already holds the past, and k and v are written after it:
+  // k (BxNxSxH) => present_k[:, :, S':S*, :]
+  // v (BxNxSxH) => present_v[:, :, S':S*, :]
+  const int present_size_per_batch = (max_sequence_length > 0 ? max_sequence_length : all_sequence_length) * head_size;
+  if (max_sequence_length > 0) {
+    if (!LaunchAppendKVToPresent(stream, max_sequence_length, past_sequence_length, sequence_length, batch_size, head_size, num_heads, k, present)) {
+      return false;
+    }
+
+    k = present;
+    v = present + batches * present_size_per_batch;
+  } else if (nullptr != present) {
     if (!LaunchConcatPastToPresent(stream, all_sequence_length, sequence_length, batch_size, head_size, num_heads, past, k, present)) {
       return false;
     }
@@ -735,7 +861,8 @@ bool LaunchAttentionKernel(
     bool is_unidirectional,
     int past_sequence_length,
     const void* past,
-    void* present) {
+    void* present,
+    int max_sequence_length) {
   // use default stream
   const cudaStream_t stream = nullptr;
 
@@ -744,13 +871,56 @@ bool LaunchAttentionKernel(
                         batch_size, sequence_length, num_heads, head_size, element_size,
                         reinterpret_cast<const half*>(input), reinterpret_cast<half*>(output), reinterpret_cast<half*>(workspace),
                         mask_index, mask_index_dims, is_unidirectional,
-                        past_sequence_length, reinterpret_cast<const half*>(past), reinterpret_cast<half*>(present));
+                        past_sequence_length, reinterpret_cast<const half*>(past), reinterpret_cast<half*>(present),
+                        max_sequence_length);
   } else {
     return QkvToContext(prop, cublas, stream,
                         batch_size, sequence_length, num_heads, head_size, element_size,
                         reinterpret_cast<const float*>(input), reinterpret_cast<float*>(output), reinterpret_cast<float*>(workspace),
                         mask_index, mask_index_dims, is_unidirectional,
-                        past_sequence_length, reinterpret_cast<const float*>(past), reinterpret_cast<float*>(present));
+                        past_sequence_length, reinterpret_cast<const float*>(past), reinterpret_cast<float*>(present),
+                        max_sequence_length);
+  }
+}
+
+bool LaunchQuantizedAttentionKernel(
+    const cudaDeviceProp& prop,
+    const int32_t* quantized_input,
+    const void* bias,
+    float dequant_scale,
+    const int* mask_index,
+    const std::vector<int64_t>* mask_index_dims,
+    void* output,
+    const int batch_size,
+    const int sequence_length,
+    const int num_heads,
+    const int head_size,
+    void* workspace,
+    cublasHandle_t& cublas,
+    const size_t element_size,
+    bool is_unidirectional,
+    int past_sequence_length,
+    const void* past,
+    void* present) {
+  // use default stream
+  const cudaStream_t stream = nullptr;
+
+  if (element_size == 2) {
+    return QkvToContext(prop, cublas, stream,
+                        batch_size, sequence_length, num_heads, head_size, element_size,
+                        static_cast<const half*>(nullptr), reinterpret_cast<half*>(output),
+                        reinterpret_cast<half*>(workspace),
+                        mask_index, mask_index_dims, is_unidirectional,
+                        past_sequence_length, reinterpret_cast<const half*>(past), reinterpret_cast<half*>(present),
+                        0, quantized_input, reinterpret_cast<const half*>(bias), dequant_scale);
+  } else {
+    return QkvToContext(prop, cublas, stream,
+                        batch_size, sequence_length, num_heads, head_size, element_size,
+                        static_cast<const float*>(nullptr), reinterpret_cast<float*>(output),
+                        reinterpret_cast<float*>(workspace),
+                        mask_index, mask_index_dims, is_unidirectional,
+                        past_sequence_length, reinterpret_cast<const float*>(past), reinterpret_cast<float*>(present),
+                        0, quantized_input, reinterpret_cast<const float*>(bias), dequant_scale);
   }
 }
 
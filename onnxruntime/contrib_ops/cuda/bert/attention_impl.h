@@ -31,6 +31,30 @@ bool LaunchAttentionKernel(
     bool is_unidirectional,                       // Whether there is unidirecitonal mask.
     int past_sequence_length,                     // Sequence length in past state
     const void* past,                             // Past state input
+    void* present,                                // Present state output
+    int max_sequence_length = 0                   // Sequence length of the past/present buffer the new keys and values are appended to in place. 0 to concatenate past and present.
+);
+
+// LaunchAttentionKernel on the int32 results of the int8 GEMM of the QKV projection, which are dequantized with
+// dequant_scale and biased as they are transposed for the Q*K' GEMM and the softmax, instead of in a separate pass.
+bool LaunchQuantizedAttentionKernel(
+    const cudaDeviceProp& prop,                   // Device Properties
+    const int32_t* quantized_input,               // Int32 result of the int8 input x weights GEMM: BxSx3xNxH
+    const void* bias,                             // Bias of the QKV projection: 3xNxH
+    float dequant_scale,                          // Product of the scales of the input and the weights
+    const int* mask_index,                        // Attention mask raw data or index. NULL means no mask.
+    const std::vector<int64_t>* mask_index_dims,  // Mask index shape
+    void* output,                                 // Output tensor
+    int batch_size,                               // Batch size (B)
+    int sequence_length,                          // Sequence length (S)
+    int num_heads,                                // Number of attention heads (N)
+    int head_size,                                // Hidden layer size per head (H)
+    void* workspace,                              // Temporary buffer
+    cublasHandle_t& cublas,                       // Cublas handle
+    const size_t element_size,                    // Element size of output tensor
+    bool is_unidirectional,                       // Whether there is unidirecitonal mask.
+    int past_sequence_length,                     // Sequence length in past state
+    const void* past,                             // Past state input
     void* present                                 // Present state output
 );
 
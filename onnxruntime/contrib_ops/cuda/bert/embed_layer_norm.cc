@@ -7,6 +7,7 @@
 #include "contrib_ops/cpu/bert/embed_layer_norm_helper.h"
 #include "embed_layer_norm.h"
 #include "embed_layer_norm_impl.h"
+#include "token_packing_impl.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -32,6 +33,7 @@ template <typename T>
 EmbedLayerNorm<T>::EmbedLayerNorm(const OpKernelInfo& op_kernel_info) : CudaKernel(op_kernel_info) {
   ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
   ORT_ENFORCE(epsilon_ >= 0);
+  packed_tokens_ = op_kernel_info.GetAttrOrDefault<int64_t>("packed_tokens", 0) == 1;
 }
 
 template <typename T>
@@ -50,8 +52,19 @@ Status EmbedLayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
   const auto& input_dims = input_ids->Shape().GetDims();
   int64_t hidden_size = word_embedding->Shape()[1];
 
-  TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
-  Tensor* output = context->Output(0, output_shape);
+  if (packed_tokens_ && nullptr == mask) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'mask' is required when packed_tokens is 1");
+  }
+
+  // With packed tokens, the output is computed padded and then packed, as its shape depends on the mask index.
+  Tensor* output = nullptr;
+  IAllocatorUniquePtr<T> padded_output;
+  if (packed_tokens_) {
+    padded_output = GetScratchBuffer<T>(input_ids->Shape().Size() * hidden_size);
+  } else {
+    TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
+    output = context->Output(0, output_shape);
+  }
 
   TensorShape mask_index_shape({input_dims[0]});
   Tensor* mask_index = context->Output(1, mask_index_shape);
@@ -61,7 +74,7 @@ Status EmbedLayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
   size_t element_size = sizeof(T);
 
   if (!LaunchEmbedLayerNormKernel(
-          output->template MutableData<T>(),
+          packed_tokens_ ? padded_output.get() : output->template MutableData<T>(),
           mask_index->template MutableData<int32_t>(),
           input_ids->template Data<int32_t>(),
           nullptr == segment_ids ? nullptr : segment_ids->template Data<int32_t>(),
@@ -81,6 +94,32 @@ Status EmbedLayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
     return Status(common::ONNXRUNTIME, common::FAIL);
   }
 
+  if (packed_tokens_) {
+    // Pack the first mask index tokens of each sequence.
+    std::vector<int32_t> sequence_lengths(batch_size);
+    CUDA_RETURN_IF_ERROR(cudaMemcpy(sequence_lengths.data(), mask_index->template Data<int32_t>(),
+                                    batch_size * sizeof(int32_t), cudaMemcpyDeviceToHost));
+
+    CudaAsyncBuffer<int> token_offsets(this, static_cast<size_t>(batch_size) + 1);
+    int* token_offsets_data = token_offsets.CpuPtr();
+    token_offsets_data[0] = 0;
+    for (int b = 0; b < batch_size; b++) {
+      token_offsets_data[b + 1] = token_offsets_data[b] + sequence_lengths[b];
+    }
+    const int64_t total_tokens = token_offsets_data[batch_size];
+    ORT_RETURN_IF_ERROR(token_offsets.CopyToGpu());
+
+    TensorShape output_shape({1, total_tokens, hidden_size});
+    output = context->Output(0, output_shape);
+
+    if (!LaunchRemovePadding(padded_output.get(), output->template MutableData<T>(), token_offsets.GpuPtr(),
+                             batch_size, sequence_length, static_cast<int>(hidden_size), element_size)) {
+      // Get last error to reset it to cudaSuccess.
+      CUDA_CALL(cudaGetLastError());
+      return Status(common::ONNXRUNTIME, common::FAIL);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -19,6 +19,7 @@ class EmbedLayerNorm final : public CudaKernel {
   Status ComputeInternal(OpKernelContext* ctx) const override;
  private:
   float epsilon_;
+  bool packed_tokens_;  // whether to pack the first mask_index tokens of the sequences into (1, total_tokens, hidden)
 };
 
 }  // namespace cuda
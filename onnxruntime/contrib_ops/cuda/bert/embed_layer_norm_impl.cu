@@ -103,11 +103,26 @@ inline bool ComputeMaskIndex(cudaStream_t stream, const int sequence_length, con
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
-template <typename T, unsigned TPB>
+// Loads the values of an embedding, dequantizing them if it is quantized.
+template <typename T, typename TEmbedding>
+struct EmbeddingLoader {
+  __device__ static inline T Load(const TEmbedding* embedding, int index, float scale, int zero_point) {
+    return T(scale * static_cast<float>(static_cast<int>(embedding[index]) - zero_point));
+  }
+};
+
+template <typename T>
+struct EmbeddingLoader<T, T> {
+  __device__ static inline T Load(const T* embedding, int index, float, int) {
+    return embedding[index];
+  }
+};
+
+template <typename T, typename TEmbedding, unsigned TPB>
 __global__ void EmbedLayerNormKernel(
     int hidden_size, const int* input_ids, const int* segment_ids, const T* beta, const T* gamma,
-    const T* word_embedding, const T* position_embedding, const T* segment_embedding,
-    const T epsilon, T* output) {
+    const TEmbedding* word_embedding, const TEmbedding* position_embedding, const TEmbedding* segment_embedding,
+    const EmbeddingQuantization quantization, const T epsilon, T* output) {
   KeyValuePairSum pair_sum;
   // 1. lookup word and segment of the block
   // blockIdx.x = position in the sequence
@@ -139,12 +154,15 @@ __global__ void EmbedLayerNormKernel(
 
   cub::KeyValuePair<T, T> thread_data(0, 0);
 
+  using Loader = EmbeddingLoader<T, TEmbedding>;
   for (int it = threadIdx.x; it < hidden_size; it += TPB) {
-    const T w(word_embedding[word_offset + it]);
+    const T w(Loader::Load(word_embedding, word_offset + it, quantization.word_scale, quantization.word_zero_point));
     T t(0);
     if (nullptr != segment_embedding)
-      t = segment_embedding[segment_offset + it];
-    const T p(position_embedding[position_offset + it]);
+      t = Loader::Load(segment_embedding, segment_offset + it, quantization.segment_scale,
+                       quantization.segment_zero_point);
+    const T p(Loader::Load(position_embedding, position_offset + it, quantization.position_scale,
+                           quantization.position_zero_point));
     const T val = w + t + p;
 
     output[output_offset + it] = val;
@@ -156,22 +174,31 @@ __global__ void EmbedLayerNormKernel(
   LayerNorm<T, TPB>(thread_data, hidden_size, output_offset, beta, gamma, epsilon, output);
 }
 
-template <typename T>
+template <typename T, typename TEmbedding>
 bool EmbedSkipLayerNorm(
     cudaStream_t stream, int hidden_size, int batch_size, int sequence_length,
     const int* input_ids, const int* segment_ids, const T* beta, const T* gamma,
-    const T* word_embedding, const T* position_embedding, const T* segment_embedding,
-    const T epsilon, T* output) {
+    const TEmbedding* word_embedding, const TEmbedding* position_embedding, const TEmbedding* segment_embedding,
+    const EmbeddingQuantization& quantization, const T epsilon, T* output) {
   constexpr int tpb = 256;
   const dim3 grid(sequence_length, batch_size, 1);
   const dim3 block(tpb, 1, 1);
 
-  EmbedLayerNormKernel<T, tpb>
-      <<<grid, block, 0, stream>>>(hidden_size, input_ids, segment_ids, beta, gamma, word_embedding, position_embedding, segment_embedding, epsilon, output);
+  EmbedLayerNormKernel<T, TEmbedding, tpb>
+      <<<grid, block, 0, stream>>>(hidden_size, input_ids, segment_ids, beta, gamma, word_embedding, position_embedding,
+                                   segment_embedding, quantization, epsilon, output);
 
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
+inline bool LaunchMaskIndex(cudaStream_t stream, const int sequence_length, const int batch_size, const int* input_mask,
+                            void* mask_index) {
+  if (nullptr == input_mask) {
+    return CUDA_CALL(cudaMemsetAsync(mask_index, 0, sizeof(int) * batch_size));
+  }
+  return ComputeMaskIndex(stream, sequence_length, batch_size, input_mask, static_cast<int*>(mask_index));
+}
+
 bool LaunchEmbedLayerNormKernel(
     void* output,
     void* mask_index,
@@ -190,30 +217,116 @@ bool LaunchEmbedLayerNormKernel(
     const size_t element_size) {
   const cudaStream_t stream = nullptr;  // default stream
 
-  if (nullptr == input_mask) {
-    if (!CUDA_CALL(cudaMemsetAsync(mask_index, 0, sizeof(int) * batch_size)))
-      return false;
-  } else if (!ComputeMaskIndex(stream, sequence_length, batch_size, input_mask, static_cast<int*>(mask_index))) {
+  if (!LaunchMaskIndex(stream, sequence_length, batch_size, input_mask, mask_index)) {
     return false;
   }
 
+  const EmbeddingQuantization no_quantization{};
   if (element_size == 2) {
-    return EmbedSkipLayerNorm<half>(
+    return EmbedSkipLayerNorm<half, half>(
         stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids,
         reinterpret_cast<const half*>(beta), reinterpret_cast<const half*>(gamma),
         reinterpret_cast<const half*>(word_embedding), reinterpret_cast<const half*>(position_embedding),
-        reinterpret_cast<const half*>(segment_embedding), __float2half_rn(epsilon),
+        reinterpret_cast<const half*>(segment_embedding), no_quantization, __float2half_rn(epsilon),
         reinterpret_cast<half*>(output));
   } else {
-    return EmbedSkipLayerNorm<float>(
+    return EmbedSkipLayerNorm<float, float>(
         stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids,
         reinterpret_cast<const float*>(beta), reinterpret_cast<const float*>(gamma),
         reinterpret_cast<const float*>(word_embedding), reinterpret_cast<const float*>(position_embedding),
-        reinterpret_cast<const float*>(segment_embedding), epsilon,
+        reinterpret_cast<const float*>(segment_embedding), no_quantization, epsilon,
         reinterpret_cast<float*>(output));
   }
 }
 
+template <typename T, typename TQuant>
+__global__ void DequantizeLayerNormWeightsKernel(int hidden_size, const TQuant* gamma, const TQuant* beta,
+                                                 const EmbeddingQuantization quantization,
+                                                 T* gamma_output, T* beta_output) {
+  const int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < hidden_size) {
+    gamma_output[i] = EmbeddingLoader<T, TQuant>::Load(gamma, i, quantization.gamma_scale,
+                                                       quantization.gamma_zero_point);
+    beta_output[i] = EmbeddingLoader<T, TQuant>::Load(beta, i, quantization.beta_scale,
+                                                      quantization.beta_zero_point);
+  }
+}
+
+template <typename T, typename TQuant>
+bool QEmbedSkipLayerNorm(
+    cudaStream_t stream, int hidden_size, int batch_size, int sequence_length,
+    const int* input_ids, const int* segment_ids, const TQuant* beta, const TQuant* gamma,
+    const TQuant* word_embedding, const TQuant* position_embedding, const TQuant* segment_embedding,
+    const EmbeddingQuantization& quantization, const T epsilon, void* workspace, T* output) {
+  // gamma and beta are only hidden_size values, so they are dequantized once for all the positions
+  T* gamma_dequantized = reinterpret_cast<T*>(workspace);
+  T* beta_dequantized = gamma_dequantized + hidden_size;
+  constexpr int tpb = 256;
+  DequantizeLayerNormWeightsKernel<T, TQuant><<<CeilDiv(hidden_size, tpb), tpb, 0, stream>>>(
+      hidden_size, gamma, beta, quantization, gamma_dequantized, beta_dequantized);
+
+  return EmbedSkipLayerNorm<T, TQuant>(
+      stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids, beta_dequantized, gamma_dequantized,
+      word_embedding, position_embedding, segment_embedding, quantization, epsilon, output);
+}
+
+template <typename T>
+bool LaunchQEmbedLayerNormKernel(
+    T* output, void* mask_index, const int* input_ids, const int* segment_ids, const int* input_mask,
+    const void* gamma, const void* beta, const void* word_embedding, const void* position_embedding,
+    const void* segment_embedding, bool is_signed, const EmbeddingQuantization& quantization, T epsilon,
+    const int hidden_size, int batch_size, int sequence_length, void* workspace) {
+  const cudaStream_t stream = nullptr;  // default stream
+
+  if (!LaunchMaskIndex(stream, sequence_length, batch_size, input_mask, mask_index)) {
+    return false;
+  }
+
+  if (is_signed) {
+    return QEmbedSkipLayerNorm<T, int8_t>(
+        stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids,
+        reinterpret_cast<const int8_t*>(beta), reinterpret_cast<const int8_t*>(gamma),
+        reinterpret_cast<const int8_t*>(word_embedding), reinterpret_cast<const int8_t*>(position_embedding),
+        reinterpret_cast<const int8_t*>(segment_embedding), quantization, epsilon, workspace, output);
+  }
+  return QEmbedSkipLayerNorm<T, uint8_t>(
+      stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids,
+      reinterpret_cast<const uint8_t*>(beta), reinterpret_cast<const uint8_t*>(gamma),
+      reinterpret_cast<const uint8_t*>(word_embedding), reinterpret_cast<const uint8_t*>(position_embedding),
+      reinterpret_cast<const uint8_t*>(segment_embedding), quantization, epsilon, workspace, output);
+}
+
+bool LaunchQEmbedLayerNormKernel(
+    void* output,
+    void* mask_index,
+    const int* input_ids,
+    const int* segment_ids,
+    const int* input_mask,
+    const void* gamma,
+    const void* beta,
+    const void* word_embedding,
+    const void* position_embedding,
+    const void* segment_embedding,
+    bool is_signed,
+    const EmbeddingQuantization& quantization,
+    float epsilon,
+    const int hidden_size,
+    int batch_size,
+    int sequence_length,
+    const size_t element_size,
+    void* workspace) {
+  if (element_size == 2) {
+    return LaunchQEmbedLayerNormKernel<half>(
+        reinterpret_cast<half*>(output), mask_index, input_ids, segment_ids, input_mask, gamma, beta,
+        word_embedding, position_embedding, segment_embedding, is_signed, quantization, __float2half_rn(epsilon),
+        hidden_size, batch_size, sequence_length, workspace);
+  }
+  return LaunchQEmbedLayerNormKernel<float>(
+      reinterpret_cast<float*>(output), mask_index, input_ids, segment_ids, input_mask, gamma, beta,
+      word_embedding, position_embedding, segment_embedding, is_signed, quantization, epsilon,
+      hidden_size, batch_size, sequence_length, workspace);
+}
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
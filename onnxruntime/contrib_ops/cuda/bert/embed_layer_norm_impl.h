@@ -2,10 +2,27 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <cstddef>
+
 namespace onnxruntime {
 namespace contrib {
 namespace cuda {
 
+// The per tensor scales and zero points of the quantized embeddings and layer normalization weights of
+// QEmbedLayerNormalization.
+struct EmbeddingQuantization {
+  float word_scale;
+  int word_zero_point;
+  float position_scale;
+  int position_zero_point;
+  float segment_scale;
+  int segment_zero_point;
+  float gamma_scale;
+  int gamma_zero_point;
+  float beta_scale;
+  int beta_zero_point;
+};
+
 bool LaunchEmbedLayerNormKernel(void* output,                     // output tensor
                                 void* mask_index,                 // output mask index
                                 const int* input_ids,             // input word IDs
@@ -22,6 +39,30 @@ bool LaunchEmbedLayerNormKernel(void* output,                     // output tens
                                 int sequence_length,              // sequence length
                                 const size_t element_size);       // size of element in output tensor. 2 for half, 4 for float.
 
+// Size of the workspace of LaunchQEmbedLayerNormKernel, for the dequantized gamma and beta.
+inline size_t GetQEmbedLayerNormWorkspaceSize(int hidden_size, size_t element_size) {
+  return 2 * static_cast<size_t>(hidden_size) * element_size;
+}
+
+bool LaunchQEmbedLayerNormKernel(void* output,                     // output tensor
+                                 void* mask_index,                 // output mask index
+                                 const int* input_ids,             // input word IDs
+                                 const int* segment_ids,           // input segment IDs
+                                 const int* input_mask,            // input mask
+                                 const void* gamma,                // quantized weight for layer normalization
+                                 const void* beta,                 // quantized bias for layer normalization
+                                 const void* word_embedding,       // quantized weights for word embeddings
+                                 const void* position_embedding,   // quantized weights for position embeddings
+                                 const void* segment_embedding,    // quantized weights for segment embeddings
+                                 bool is_signed,                   // whether the quantized tensors are int8 or uint8
+                                 const EmbeddingQuantization& quantization,  // scales and zero points
+                                 float epsilon,                    // epsilon for layer normalization
+                                 const int hidden_size,            // hidden size (that is head_size * num_heads)
+                                 int batch_size,                   // batch size
+                                 int sequence_length,              // sequence length
+                                 const size_t element_size,        // size of element in output tensor. 2 for half, 4 for float.
+                                 void* workspace);                 // GetQEmbedLayerNormWorkspaceSize bytes
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
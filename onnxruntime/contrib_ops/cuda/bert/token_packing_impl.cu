@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "token_packing_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// One block per (position, sequence) of the padded tensor. The elements are only moved, so T is an unsigned integer
+// of the size of an element.
+template <typename T, bool restore_padding>
+__global__ void PaddingKernel(const T* input, T* output, const int* token_offsets, const int width) {
+  const int position = blockIdx.x;
+  const int sequence_index = blockIdx.y;
+  const int sequence_length = gridDim.x;
+
+  const int token_offset = token_offsets[sequence_index];
+  const int token_count = token_offsets[sequence_index + 1] - token_offset;
+
+  const int padded_offset = (sequence_index * sequence_length + position) * width;
+  const int packed_offset = (token_offset + position) * width;
+
+  if (restore_padding) {
+    for (int i = threadIdx.x; i < width; i += blockDim.x) {
+      output[padded_offset + i] = (position < token_count) ? input[packed_offset + i] : T(0);
+    }
+  } else if (position < token_count) {
+    for (int i = threadIdx.x; i < width; i += blockDim.x) {
+      output[packed_offset + i] = input[padded_offset + i];
+    }
+  }
+}
+
+template <bool restore_padding>
+bool LaunchPaddingKernel(const void* input, void* output, const int* token_offsets, int batch_size,
+                         int sequence_length, int width, size_t element_size) {
+  if (batch_size == 0 || sequence_length == 0) {
+    return true;
+  }
+
+  // use default stream
+  const cudaStream_t stream = nullptr;
+  const dim3 grid(sequence_length, batch_size, 1);
+  constexpr int block_size = 256;
+
+  if (element_size == 2) {
+    PaddingKernel<uint16_t, restore_padding><<<grid, block_size, 0, stream>>>(
+        reinterpret_cast<const uint16_t*>(input), reinterpret_cast<uint16_t*>(output), token_offsets, width);
+  } else {
+    PaddingKernel<uint32_t, restore_padding><<<grid, block_size, 0, stream>>>(
+        reinterpret_cast<const uint32_t*>(input), reinterpret_cast<uint32_t*>(output), token_offsets, width);
+  }
+
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
+bool LaunchRestorePadding(const void* packed, void* padded, const int* token_offsets, int batch_size,
+                          int sequence_length, int width, size_t element_size) {
+  return LaunchPaddingKernel<true>(packed, padded, token_offsets, batch_size, sequence_length, width, element_size);
+}
+
+bool LaunchRemovePadding(const void* padded, void* packed, const int* token_offsets, int batch_size,
+                         int sequence_length, int width, size_t element_size) {
+  return LaunchPaddingKernel<false>(padded, packed, token_offsets, batch_size, sequence_length, width, element_size);
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
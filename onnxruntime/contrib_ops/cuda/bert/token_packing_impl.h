@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Scatters the packed tokens (total_tokens x width) of the sequences into a zero padded tensor
+// (batch_size x sequence_length x width). Sequence b is the tokens from token_offsets[b] to token_offsets[b + 1].
+bool LaunchRestorePadding(const void* packed,          // Packed tokens: total_tokens x width
+                          void* padded,                // Padded tokens: batch_size x sequence_length x width
+                          const int* token_offsets,    // Offsets of the sequences in device memory: batch_size + 1
+                          int batch_size,              // Batch size (B)
+                          int sequence_length,         // Length of the longest sequence (S)
+                          int width,                   // Number of elements of a token
+                          size_t element_size);        // Size of an element. 2 for half, 4 for float.
+
+// Gathers the tokens of the sequences from a padded tensor (batch_size x sequence_length x width) into a packed tensor
+// (total_tokens x width), the inverse of LaunchRestorePadding.
+bool LaunchRemovePadding(const void* padded,           // Padded tokens: batch_size x sequence_length x width
+                         void* packed,                 // Packed tokens: total_tokens x width
+                         const int* token_offsets,     // Offsets of the sequences in device memory: batch_size + 1
+                         int batch_size,               // Batch size (B)
+                         int sequence_length,          // Length of the longest sequence (S)
+                         int width,                    // Number of elements of a token
+                         size_t element_size);         // Size of an element. 2 for half, 4 for float.
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/gemm.h"
+#include "core/providers/cuda/activation/activations_impl.h"
+#include "contrib_ops/cuda/bert/fast_gelu_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// Gemm followed by Relu or FastGelu, the activations of GemmActivationFusion for the CUDA execution provider.
+// The epilogue of the cuBLASLt matmul applies them when it can, or they run on the output otherwise.
+template <typename T>
+class FusedGemm final : public onnxruntime::cuda::Gemm<T> {
+ public:
+  FusedGemm(const OpKernelInfo& info) : onnxruntime::cuda::Gemm<T>(info) {
+    const std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
+    if (activation == "Relu") {
+      activation_ = CublasLtActivation::Relu;
+    } else if (activation == "FastGelu") {
+      activation_ = CublasLtActivation::Gelu;
+    } else {
+      ORT_THROW("Unsupported activation of FusedGemm: ", activation);
+    }
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override {
+    bool activation_applied = false;
+    ORT_RETURN_IF_ERROR(this->ComputeGemm(context, activation_, activation_applied));
+    if (activation_applied) {
+      return Status::OK();
+    }
+
+    typedef typename ToCudaType<T>::MappedType CudaT;
+    Tensor* Y = context->Output<Tensor>(0);
+    CudaT* y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+    const int64_t count = Y->Shape().Size();
+    if (count == 0) {
+      return Status::OK();
+    }
+
+    if (activation_ == CublasLtActivation::Relu) {
+      CtxRelu ctx;
+      Impl_Relu<CudaT>(y_data, y_data, &ctx, static_cast<size_t>(count));
+    } else if (!LaunchFastGeluKernel<CudaT>(this->GetDeviceProp(), nullptr, static_cast<int>(count), 0,
+                                            y_data, nullptr, y_data)) {
+      CUDA_CALL(cudaGetLastError());
+      return Status(common::ONNXRUNTIME, common::FAIL);
+    }
+    return Status::OK();
+  }
+
+ private:
+  CublasLtActivation activation_;
+};
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedGemm,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
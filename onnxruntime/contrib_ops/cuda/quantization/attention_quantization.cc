@@ -2,7 +2,6 @@
 // Licensed under the MIT License.
 
 #include "attention_quantization.h"
-#include "attention_quantization_impl.cuh"
 #include "contrib_ops/cuda/bert/attention_impl.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/common.h"
@@ -86,6 +85,27 @@ Status QAttention<T, int8_t>::CheckInputs(const Tensor* input,
   return Status::OK();
 }
 
+template <typename T>
+Status QAttention<T, int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  // the weights stay for the inputs the packed weights don't apply to
+  is_packed = false;
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2 || tensor.Shape().Size() == 0 ||
+      !IsCublasLtInt8Supported(GetDeviceProp())) {
+    return Status::OK();
+  }
+
+  // as for cuBLAS, the row-major weights (hidden_size, 3 * hidden_size) are the column-major A operand of
+  // the transposed projection (3 * hidden_size, B * S) = weights^T x input^T
+  const int k = gsl::narrow<int>(tensor.Shape()[0]);
+  const int n = gsl::narrow<int>(tensor.Shape()[1]);
+  packed_weights_ = IAllocator::MakeUniquePtr<int8_t>(Info().GetAllocator(GetDeviceId(), OrtMemTypeDefault),
+                                                      CublasLtCol32Size(n, k));
+  ORT_RETURN_IF_ERROR(CublasLtTransformToCol32(this, n, k, tensor.template Data<int8_t>(), n,
+                                               packed_weights_.get()));
+  packed_weights_shape_ = tensor.Shape();
+  return Status::OK();
+}
+
 template <typename T>
 Status QAttention<T, int8_t>::ComputeInternal(OpKernelContext* context) const {
   // Input and output shapes:
@@ -136,43 +156,47 @@ Status QAttention<T, int8_t>::ComputeInternal(OpKernelContext* context) const {
   int m = batch_size * sequence_length;
   int n = 3 * hidden_size;
   int k = hidden_size;
-  auto gemm_buffer = GetScratchBuffer<T>(batch_size * sequence_length * 3 * hidden_size * element_size);
   auto gemm_buffer_quantized = GetScratchBuffer<int32_t>(batch_size * sequence_length * 3 * hidden_size);
 
   typedef typename ToCudaType<T>::MappedType CudaT;
 
-  GemmInt8(m, n, k,
-           1 /*alpha_matmul*/, 0 /* beta_matmul*/,
-           input->template Data<int8_t>(), k,
-           weights->template Data<int8_t>(), n,
-           gemm_buffer_quantized.get(), n,
-           this);
+  if (packed_weights_ != nullptr && weights->Shape() == packed_weights_shape_) {
+    // the int8 tensor cores compute the transposed projection (n, m) = weights^T(n, k) x input^T(k, m)
+    ORT_RETURN_IF_ERROR(CublasLtGemmInt8(this, cublaslt_algo_cache_, n, m, k,
+                                         packed_weights_.get(),
+                                         input->template Data<int8_t>(), k,
+                                         0,
+                                         gemm_buffer_quantized.get(), n));
+  } else {
+    GemmInt8(m, n, k,
+             1 /*alpha_matmul*/, 0 /* beta_matmul*/,
+             input->template Data<int8_t>(), k,
+             weights->template Data<int8_t>(), n,
+             gemm_buffer_quantized.get(), n,
+             this);
+  }
 
-  CudaT dequant_scale;
-  CudaT input_scale = *(reinterpret_cast<const CudaT*>(input_scale_tensor->template Data<T>()));
-  CudaT weight_scale = *(reinterpret_cast<const CudaT*>(weight_scale_tensor->template Data<T>()));
+  float dequant_scale;
   if (sizeof(T) == 2) {
-    dequant_scale = __float2half(__half2float(input_scale) * __half2float(weight_scale));
+    const CudaT input_scale = *(reinterpret_cast<const CudaT*>(input_scale_tensor->template Data<T>()));
+    const CudaT weight_scale = *(reinterpret_cast<const CudaT*>(weight_scale_tensor->template Data<T>()));
+    dequant_scale = __half2float(input_scale) * __half2float(weight_scale);
   } else {
-    dequant_scale = input_scale * weight_scale;
+    dequant_scale = *(reinterpret_cast<const float*>(input_scale_tensor->template Data<T>())) *
+                    *(reinterpret_cast<const float*>(weight_scale_tensor->template Data<T>()));
   }
-  // scale back and bias
-  CudaDequantizeWithBias(
-      gemm_buffer_quantized.get(),
-      reinterpret_cast<const CudaT*>(bias->template Data<T>()),
-      reinterpret_cast<CudaT*>(gemm_buffer.get()),
-      dequant_scale,
-      m,
-      n);
 
   int past_sequence_length = 0;
   Tensor* present_tensor = GetPresent(context, past_tensor, batch_size, head_size, sequence_length, past_sequence_length);
 
   size_t workSpaceSize = GetAttentionWorkspaceSize(element_size, batch_size, num_heads_, head_size, sequence_length, past_sequence_length);
   auto temp_buffer = GetScratchBuffer<void>(workSpaceSize);
-  if (!LaunchAttentionKernel(
+  // the scale and the bias are applied as the results of the GEMM are transposed for the attention
+  if (!LaunchQuantizedAttentionKernel(
           GetDeviceProp(),
-          reinterpret_cast<const CudaT*>(gemm_buffer.get()),
+          gemm_buffer_quantized.get(),
+          bias->template Data<T>(),
+          dequant_scale,
           nullptr == mask_index ? nullptr : mask_index->template Data<int>(),
           nullptr == mask_index ? nullptr : &(mask_index->Shape().GetDims()),
           output->template MutableData<T>(),
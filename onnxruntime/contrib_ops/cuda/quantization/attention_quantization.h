@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/shared_inc/cublaslt_gemm.h"
 #include "contrib_ops/cpu/bert/attention_base.h"
 
 namespace onnxruntime {
@@ -28,6 +29,8 @@ class QAttention<T, int8_t> final : public CudaKernel, public AttentionBase {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
  private:
   Status CheckInputs(const Tensor* input,
                      const Tensor* weights,
@@ -38,6 +41,11 @@ class QAttention<T, int8_t> final : public CudaKernel, public AttentionBase {
                      const Tensor* i_zp_tensor,
                      const Tensor* w_zp_tensor,
                      const Tensor* past_tensor) const;
+
+  // the constant weights in the COL32 layout of the int8 tensor core matmuls of cuBLASLt
+  IAllocatorUniquePtr<int8_t> packed_weights_;
+  TensorShape packed_weights_shape_;
+  mutable CublasLtAlgoCache cublaslt_algo_cache_;
 };
 
 }  // namespace cuda
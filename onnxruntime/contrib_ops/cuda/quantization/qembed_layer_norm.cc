@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "qembed_layer_norm.h"
+#include "core/providers/common.h"
+#include "core/util/math.h"
+#include "contrib_ops/cpu/bert/embed_layer_norm_helper.h"
+#include "contrib_ops/cuda/bert/embed_layer_norm_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T, TQuant)                                \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                        \
+      QEmbedLayerNormalization,                                         \
+      kMSDomain,                                                        \
+      1,                                                                \
+      T##_##TQuant,                                                     \
+      kCudaExecutionProvider,                                           \
+      KernelDefBuilder()                                                \
+          .InputMemoryType<OrtMemTypeCPUInput>(8)                       \
+          .InputMemoryType<OrtMemTypeCPUInput>(9)                       \
+          .InputMemoryType<OrtMemTypeCPUInput>(10)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(11)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(12)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(13)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(14)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(15)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(16)                      \
+          .InputMemoryType<OrtMemTypeCPUInput>(17)                      \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>()) \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<TQuant>())  \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),       \
+      QEmbedLayerNorm<T, TQuant>);
+
+REGISTER_KERNEL_TYPED(float, int8_t)
+REGISTER_KERNEL_TYPED(float, uint8_t)
+REGISTER_KERNEL_TYPED(MLFloat16, int8_t)
+REGISTER_KERNEL_TYPED(MLFloat16, uint8_t)
+
+namespace {
+
+float GetScale(const Tensor* scale_tensor) {
+  if (scale_tensor->IsDataType<MLFloat16>()) {
+    return math::halfToFloat(scale_tensor->template Data<MLFloat16>()->val);
+  }
+  return *scale_tensor->template Data<float>();
+}
+
+template <typename TQuant>
+Status GetQuantizationParameters(const Tensor* scale_tensor, const Tensor* zero_point_tensor, const char* name,
+                                 float& scale, int& zero_point) {
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(scale_tensor), name, " scale must be a scalar or 1D tensor of size 1");
+  scale = GetScale(scale_tensor);
+  zero_point = 0;
+  if (zero_point_tensor != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(zero_point_tensor),
+                      name, " zero point must be a scalar or 1D tensor of size 1");
+    zero_point = static_cast<int>(*zero_point_tensor->template Data<TQuant>());
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+template <typename T, typename TQuant>
+QEmbedLayerNorm<T, TQuant>::QEmbedLayerNorm(const OpKernelInfo& op_kernel_info) : CudaKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
+  ORT_ENFORCE(epsilon_ >= 0);
+}
+
+template <typename T, typename TQuant>
+Status QEmbedLayerNorm<T, TQuant>::ComputeInternal(OpKernelContext* context) const {
+  // The inputs 0 to 7 are the ones of EmbedLayerNormalization, with quantized embeddings, gamma and beta.
+  ORT_RETURN_IF_ERROR(embed_layer_norm::CheckInputs(context));
+
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const Tensor* segment_ids = context->Input<Tensor>(1);  // optional. nullptr if it's distill-bert
+  const Tensor* word_embedding = context->Input<Tensor>(2);
+  const Tensor* position_embedding = context->Input<Tensor>(3);
+  const Tensor* segment_embedding = context->Input<Tensor>(4);  // optional. nullptr if it's distill-bert
+  const Tensor* gamma = context->Input<Tensor>(5);
+  const Tensor* beta = context->Input<Tensor>(6);
+  const Tensor* mask = context->Input<Tensor>(7);  // optional. nullptr if not provided
+
+  EmbeddingQuantization quantization{};
+  ORT_RETURN_IF_ERROR(GetQuantizationParameters<TQuant>(context->Input<Tensor>(8), context->Input<Tensor>(13),
+                                                        "word_embedding", quantization.word_scale,
+                                                        quantization.word_zero_point));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameters<TQuant>(context->Input<Tensor>(9), context->Input<Tensor>(14),
+                                                        "position_embedding", quantization.position_scale,
+                                                        quantization.position_zero_point));
+  if (nullptr != segment_embedding) {
+    const Tensor* segment_scale = context->Input<Tensor>(10);
+    ORT_RETURN_IF_NOT(segment_scale != nullptr, "segment_embedding_scale is required with segment_embedding");
+    ORT_RETURN_IF_ERROR(GetQuantizationParameters<TQuant>(segment_scale, context->Input<Tensor>(15),
+                                                          "segment_embedding", quantization.segment_scale,
+                                                          quantization.segment_zero_point));
+  }
+  ORT_RETURN_IF_ERROR(GetQuantizationParameters<TQuant>(context->Input<Tensor>(11), context->Input<Tensor>(16),
+                                                        "gamma", quantization.gamma_scale,
+                                                        quantization.gamma_zero_point));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameters<TQuant>(context->Input<Tensor>(12), context->Input<Tensor>(17),
+                                                        "beta", quantization.beta_scale,
+                                                        quantization.beta_zero_point));
+
+  const auto& input_dims = input_ids->Shape().GetDims();
+  int64_t hidden_size = word_embedding->Shape()[1];
+
+  TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
+  Tensor* output = context->Output(0, output_shape);
+
+  TensorShape mask_index_shape({input_dims[0]});
+  Tensor* mask_index = context->Output(1, mask_index_shape);
+
+  int batch_size = static_cast<int>(input_dims[0]);
+  int sequence_length = static_cast<int>(input_dims[1]);
+  size_t element_size = sizeof(T);
+
+  auto workspace = GetScratchBuffer<void>(GetQEmbedLayerNormWorkspaceSize(static_cast<int>(hidden_size),
+                                                                          element_size));
+
+  if (!LaunchQEmbedLayerNormKernel(
+          output->template MutableData<T>(),
+          mask_index->template MutableData<int32_t>(),
+          input_ids->template Data<int32_t>(),
+          nullptr == segment_ids ? nullptr : segment_ids->template Data<int32_t>(),
+          nullptr == mask ? nullptr : mask->template Data<int32_t>(),
+          gamma->template Data<TQuant>(),
+          beta->template Data<TQuant>(),
+          word_embedding->template Data<TQuant>(),
+          position_embedding->template Data<TQuant>(),
+          nullptr == segment_embedding ? nullptr : segment_embedding->template Data<TQuant>(),
+          std::is_signed<TQuant>::value,
+          quantization,
+          epsilon_,
+          static_cast<int>(hidden_size),
+          batch_size,
+          sequence_length,
+          element_size,
+          workspace.get())) {
+    // Get last error to reset it to cudaSuccess.
+    CUDA_CALL(cudaGetLastError());
+    return Status(common::ONNXRUNTIME, common::FAIL);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "embedding_bag.h"
+#include "embedding_bag_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                                                     \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                                     \
+      EmbeddingBag,                                                                                  \
+      kMSDomain,                                                                                     \
+      1,                                                                                             \
+      T,                                                                                             \
+      kCudaExecutionProvider,                                                                        \
+      KernelDefBuilder()                                                                             \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                                     \
+          .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),    \
+                                                          DataTypeImpl::GetTensorType<int64_t>()}), \
+      EmbeddingBag<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+static_assert(static_cast<int>(embedding_bag_helper::Mode::Sum) == kEmbeddingBagSum &&
+                  static_cast<int>(embedding_bag_helper::Mode::Mean) == kEmbeddingBagMean &&
+                  static_cast<int>(embedding_bag_helper::Mode::Max) == kEmbeddingBagMax,
+              "The modes of the CUDA kernel don't match embedding_bag_helper::Mode");
+
+template <typename T>
+EmbeddingBag<T>::EmbeddingBag(const OpKernelInfo& info) : CudaKernel(info) {
+  std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  ORT_ENFORCE(embedding_bag_helper::ParseMode(mode, mode_).IsOK(), "Unsupported EmbeddingBag mode: ", mode);
+}
+
+template <typename T>
+Status EmbeddingBag<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* weight = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+
+  int64_t num_bags = 0;
+  int64_t bag_size = 0;
+  ORT_RETURN_IF_ERROR(embedding_bag_helper::CheckInputs(*weight, *indices, offsets, per_sample_weights, mode_,
+                                                        num_bags, bag_size));
+
+  const int64_t num_embeddings = weight->Shape()[0];
+  const int64_t embedding_dim = weight->Shape()[1];
+  Tensor* output = context->Output(0, {num_bags, embedding_dim});
+  const size_t N = static_cast<size_t>(output->Shape().Size());
+  if (N == 0) {
+    return Status::OK();
+  }
+
+  // the kernel skips out-of-range indices instead of failing, as it can't report them without a synchronization
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const CudaT* weight_data = reinterpret_cast<const CudaT*>(weight->template Data<T>());
+  const CudaT* per_sample_weights_data =
+      per_sample_weights != nullptr ? reinterpret_cast<const CudaT*>(per_sample_weights->template Data<T>()) : nullptr;
+  CudaT* output_data = reinterpret_cast<CudaT*>(output->template MutableData<T>());
+  const fast_divmod fdm_embedding_dim(static_cast<int>(embedding_dim));
+  const int mode = static_cast<int>(mode_);
+
+  if (indices->IsDataType<int32_t>()) {
+    EmbeddingBagImpl<CudaT, int32_t>(weight_data, indices->template Data<int32_t>(),
+                                     offsets != nullptr ? offsets->template Data<int32_t>() : nullptr,
+                                     per_sample_weights_data, mode, num_embeddings, embedding_dim,
+                                     indices->Shape().Size(), bag_size, fdm_embedding_dim, output_data, N);
+  } else {
+    EmbeddingBagImpl<CudaT, int64_t>(weight_data, indices->template Data<int64_t>(),
+                                     offsets != nullptr ? offsets->template Data<int64_t>() : nullptr,
+                                     per_sample_weights_data, mode, num_embeddings, embedding_dim,
+                                     indices->Shape().Size(), bag_size, fdm_embedding_dim, output_data, N);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
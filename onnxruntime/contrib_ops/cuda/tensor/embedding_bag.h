@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/embedding_bag_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+template <typename T>
+class EmbeddingBag final : public CudaKernel {
+ public:
+  EmbeddingBag(const OpKernelInfo& info);
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  embedding_bag_helper::Mode mode_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "embedding_bag_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// one thread per output element, accumulating in float
+template <typename T, typename Tind>
+__global__ void _EmbeddingBagKernel(
+    const T* weight_data,
+    const Tind* indices_data,
+    const Tind* offsets_data,
+    const T* per_sample_weights_data,
+    const int mode,
+    const int64_t num_embeddings,
+    const int64_t embedding_dim,
+    const int64_t num_indices,
+    const int64_t num_bags,
+    const int64_t bag_size,
+    const fast_divmod fdm_embedding_dim,
+    T* output_data,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int bag, dim;
+  fdm_embedding_dim.divmod(id, bag, dim);
+
+  int64_t start, end;
+  if (offsets_data != nullptr) {
+    start = min(max(static_cast<int64_t>(offsets_data[bag]), int64_t{0}), num_indices);
+    end = bag + 1 < num_bags ? min(max(static_cast<int64_t>(offsets_data[bag + 1]), start), num_indices) : num_indices;
+  } else {
+    start = bag * bag_size;
+    end = start + bag_size;
+  }
+
+  float result = 0.f;
+  int64_t count = 0;
+  for (int64_t i = start; i < end; ++i) {
+    int64_t row = static_cast<int64_t>(indices_data[i]);
+    if (row < 0) {
+      row += num_embeddings;
+    }
+    if (row < 0 || row >= num_embeddings) {
+      continue;
+    }
+
+    float value = static_cast<float>(weight_data[row * embedding_dim + dim]);
+    if (per_sample_weights_data != nullptr) {
+      value *= static_cast<float>(per_sample_weights_data[i]);
+    }
+    if (mode == kEmbeddingBagMax) {
+      result = count == 0 ? value : fmaxf(result, value);
+    } else {
+      result += value;
+    }
+    ++count;
+  }
+
+  if (mode == kEmbeddingBagMean && count > 0) {
+    result /= static_cast<float>(count);
+  }
+  output_data[id] = static_cast<T>(result);
+}
+
+template <typename T, typename Tind>
+void EmbeddingBagImpl(
+    const T* weight_data,
+    const Tind* indices_data,
+    const Tind* offsets_data,
+    const T* per_sample_weights_data,
+    const int mode,
+    const int64_t num_embeddings,
+    const int64_t embedding_dim,
+    const int64_t num_indices,
+    const int64_t bag_size,
+    const fast_divmod& fdm_embedding_dim,
+    T* output_data,
+    const size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  const int64_t num_bags = static_cast<int64_t>(N) / embedding_dim;
+  _EmbeddingBagKernel<T, Tind><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      weight_data, indices_data, offsets_data, per_sample_weights_data, mode, num_embeddings, embedding_dim,
+      num_indices, num_bags, bag_size, fdm_embedding_dim, output_data, (CUDA_LONG)N);
+}
+
+#define SPECIALIZED_IMPL(T, Tind) \
+  template void EmbeddingBagImpl<T, Tind>(const T* weight_data, const Tind* indices_data, const Tind* offsets_data, const T* per_sample_weights_data, const int mode, const int64_t num_embeddings, const int64_t embedding_dim, const int64_t num_indices, const int64_t bag_size, const fast_divmod& fdm_embedding_dim, T* output_data, const size_t N);
+
+SPECIALIZED_IMPL(float, int32_t)
+SPECIALIZED_IMPL(float, int64_t)
+SPECIALIZED_IMPL(half, int32_t)
+SPECIALIZED_IMPL(half, int64_t)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
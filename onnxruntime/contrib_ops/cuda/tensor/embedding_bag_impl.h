@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// the values of embedding_bag_helper::Mode
+constexpr int kEmbeddingBagSum = 0;
+constexpr int kEmbeddingBagMean = 1;
+constexpr int kEmbeddingBagMax = 2;
+
+// Bag i reduces the indices [offsets[i], offsets[i + 1]), or
+// [i * bag_size, (i + 1) * bag_size) when offsets is null.
+template <typename T, typename Tind>
+void EmbeddingBagImpl(
+    const T* weight_data,
+    const Tind* indices_data,
+    const Tind* offsets_data,
+    const T* per_sample_weights_data,
+    const int mode,
+    const int64_t num_embeddings,
+    const int64_t embedding_dim,
+    const int64_t num_indices,
+    const int64_t bag_size,
+    const fast_divmod& fdm_embedding_dim,
+    T* output_data,
+    const size_t N);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
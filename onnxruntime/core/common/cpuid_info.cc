@@ -71,6 +71,12 @@ CPUIDInfo::CPUIDInfo() noexcept {
       }
     }
   }
+
+  if (num_IDs >= 7) {
+    GetCPUID(7, data);
+    // the processor has cores of more than one type, e.g. performance and efficiency cores
+    is_hybrid_ = (data[3] & (1 << 15));
+  }
 #endif
 }
 
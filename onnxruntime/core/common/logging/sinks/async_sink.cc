@@ -0,0 +1,204 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace onnxruntime {
+namespace logging {
+
+// A ring buffer with a single producer, the logging thread it belongs to, and a single consumer, the background
+// thread. head_ and tail_ only grow, and are kept on separate cache lines so the two threads don't contend.
+class AsyncSink::Ring {
+ public:
+  explicit Ring(size_t capacity) : records_(capacity) {}
+
+  bool TryPush(Record& record) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == records_.size()) {
+      return false;
+    }
+
+    records_[head % records_.size()] = std::move(record);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // moves the records pushed so far to the end of records
+  void PopAll(std::vector<Record>& records) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    for (size_t i = tail; i != head; ++i) {
+      records.push_back(std::move(records_[i % records_.size()]));
+    }
+
+    tail_.store(head, std::memory_order_release);
+  }
+
+ private:
+  std::vector<Record> records_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+static uint64_t NextAsyncSinkId() noexcept {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+AsyncSink::AsyncSink(std::unique_ptr<ISink> sink, size_t ring_capacity)
+    : sink_{std::move(sink)}, ring_capacity_{std::max<size_t>(ring_capacity, 1)}, id_{NextAsyncSinkId()} {
+  if (sink_ == nullptr) {
+    ORT_THROW("ISink must be provided.");
+  }
+
+  thread_ = std::thread(&AsyncSink::Run, this);
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<OrtMutex> lock(wake_mutex_);
+    stop_ = true;
+    wake_cv_.notify_one();
+  }
+
+  thread_.join();
+}
+
+AsyncSink::Ring& AsyncSink::ThreadRing() {
+  // a thread has a ring buffer for each sink it logged to. the entries of deleted sinks are only referenced from
+  // here, and are dropped when the thread creates its next ring buffer.
+  thread_local std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> thread_rings;
+
+  for (auto& thread_ring : thread_rings) {
+    if (thread_ring.first == id_) {
+      return *thread_ring.second;
+    }
+  }
+
+  thread_rings.erase(std::remove_if(thread_rings.begin(), thread_rings.end(),
+                                    [](const std::pair<uint64_t, std::shared_ptr<Ring>>& thread_ring) {
+                                      return thread_ring.second.use_count() == 1;
+                                    }),
+                     thread_rings.end());
+
+  auto ring = std::make_shared<Ring>(ring_capacity_);
+  {
+    std::lock_guard<OrtMutex> lock(rings_mutex_);
+    rings_.push_back(ring);
+  }
+
+  thread_rings.emplace_back(id_, ring);
+  return *ring;
+}
+
+void AsyncSink::WakeUp() {
+  // the background thread also wakes up periodically, so a wake up that's lost because the producer read sleeping_
+  // right before it was set only delays the message slightly.
+  if (sleeping_.load()) {
+    std::lock_guard<OrtMutex> lock(wake_mutex_);
+    wake_cv_.notify_one();
+  }
+}
+
+void AsyncSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  if (message.Severity() == Severity::kFATAL) {
+    Flush();
+    std::lock_guard<OrtMutex> lock(write_mutex_);
+    sink_->Send(timestamp, logger_id, message);
+    return;
+  }
+
+  const CodeLocation& location = message.Location();
+  Record record{timestamp, logger_id, message.Severity(), message.Category(), message.DataType(),
+                location.file_and_path, location.line_num, location.function, location.stacktrace,
+                message.Message()};
+
+  Ring& ring = ThreadRing();
+  while (!ring.TryPush(record)) {
+    WakeUp();
+    std::this_thread::yield();
+  }
+
+  WakeUp();
+}
+
+void AsyncSink::Flush() {
+  std::unique_lock<OrtMutex> lock(wake_mutex_);
+  // the drain in progress may have missed the latest messages, the one after it can't
+  const uint64_t target = drain_count_ + 2;
+  flush_target_ = std::max(flush_target_, target);
+  wake_cv_.notify_one();
+  flushed_cv_.wait(lock, [this, target]() { return drain_count_ >= target; });
+}
+
+void AsyncSink::Write(std::vector<Record>& records) {
+  // the ring buffers are drained one after the other, so restore the order across threads
+  std::stable_sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) {
+    return lhs.timestamp < rhs.timestamp;
+  });
+
+  std::lock_guard<OrtMutex> lock(write_mutex_);
+  for (const Record& record : records) {
+    const CodeLocation location{record.file_and_path.c_str(), record.line_num, record.function.c_str(),
+                                record.stacktrace};
+    Capture capture{record.severity, record.category.c_str(), record.data_type, location};
+    capture.Stream() << record.message;
+    sink_->Send(record.timestamp, record.logger_id, capture);
+  }
+
+  records.clear();
+}
+
+void AsyncSink::Run() {
+  constexpr std::chrono::milliseconds kIdleWait{10};
+  std::vector<std::shared_ptr<Ring>> rings;
+  std::vector<Record> records;
+
+  for (;;) {
+    bool stopping;
+    {
+      std::lock_guard<OrtMutex> lock(wake_mutex_);
+      stopping = stop_;
+    }
+
+    {
+      // the ring buffers of exited threads are only referenced from here, drain them one more time and drop them
+      std::lock_guard<OrtMutex> lock(rings_mutex_);
+      rings = rings_;
+      rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                  [](const std::shared_ptr<Ring>& ring) { return ring.use_count() == 2; }),
+                   rings_.end());
+    }
+
+    for (auto& ring : rings) {
+      ring->PopAll(records);
+    }
+
+    rings.clear();
+
+    const bool idle = records.empty();
+    if (!idle) {
+      Write(records);
+    }
+
+    std::unique_lock<OrtMutex> lock(wake_mutex_);
+    ++drain_count_;
+    flushed_cv_.notify_all();
+    if (stopping) {
+      break;
+    }
+
+    if (idle && drain_count_ >= flush_target_ && !stop_) {
+      sleeping_.store(true);
+      wake_cv_.wait_for(lock, kIdleWait);
+      sleeping_.store(false);
+    }
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/logging/capture.h"
+#include "core/common/logging/isink.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// An ISink that defers formatting and writing the messages to a background thread, so logging threads don't
+/// serialize on the wrapped sink.
+/// Each logging thread copies its messages into a ring buffer of its own without taking a lock, and the background
+/// thread sends them to the wrapped sink in timestamp order. kFATAL messages are sent synchronously after the
+/// messages in flight as the process may not survive them.
+/// </summary>
+/// <seealso cref="ISink" />
+class AsyncSink : public ISink {
+ public:
+  /// <summary>
+  /// Initializes a new instance of the <see cref="AsyncSink"/> class and starts its background thread.
+  /// </summary>
+  /// <param name="sink">The sink the messages are sent to. Only the background thread writes to it.</param>
+  /// <param name="ring_capacity">The number of messages a logging thread can have in flight.
+  /// A logging thread whose ring buffer is full waits for the background thread.</param>
+  explicit AsyncSink(std::unique_ptr<ISink> sink, size_t ring_capacity = 1024);
+
+  /// <summary>
+  /// Sends the messages in flight and stops the background thread.
+  /// </summary>
+  ~AsyncSink() override;
+
+  /// <summary>
+  /// Blocks until the messages sent before the call have been written to the wrapped sink.
+  /// </summary>
+  void Flush();
+
+  void SendProfileEvent(profiling::EventRecord& event_record) const override {
+    sink_->SendProfileEvent(event_record);
+  }
+
+ private:
+  // the fields of a captured message, see Capture
+  struct Record {
+    Timestamp timestamp;
+    std::string logger_id;
+    Severity severity;
+    std::string category;
+    logging::DataType data_type;
+    std::string file_and_path;
+    int line_num;
+    std::string function;
+    std::vector<std::string> stacktrace;
+    std::string message;
+  };
+
+  class Ring;
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  // the ring buffer of the calling thread, which is created by its first message
+  Ring& ThreadRing();
+
+  void WakeUp();
+
+  // body of the background thread
+  void Run();
+
+  // sends the records to the wrapped sink in timestamp order and clears them
+  void Write(std::vector<Record>& records);
+
+  std::unique_ptr<ISink> sink_;
+  const size_t ring_capacity_;
+  // identifies the sink in the thread local lists of ring buffers, as a new sink may reuse the address of a
+  // deleted one
+  const uint64_t id_;
+
+  OrtMutex rings_mutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+
+  // serializes the writes of kFATAL messages with the background thread
+  OrtMutex write_mutex_;
+
+  OrtMutex wake_mutex_;
+  OrtCondVar wake_cv_;
+  OrtCondVar flushed_cv_;
+  std::atomic<bool> sleeping_{false};
+  bool stop_{false};
+  // number of times the background thread drained the ring buffers, and the number a Flush waits for.
+  // guarded by wake_mutex_
+  uint64_t drain_count_{0};
+  uint64_t flush_target_{0};
+
+  std::thread thread_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
@@ -62,19 +62,46 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
                                      const std::string& event_name,
                                      const TimePoint& start_time,
                                      const std::initializer_list<std::pair<std::string, std::string>>& event_args,
+                                     bool sync_gpu) {
+  EndTimeAndRecordEvent(category, event_name, start_time,
+                        std::unordered_map<std::string, std::string>{event_args.begin(), event_args.end()}, sync_gpu);
+}
+
+void Profiler::EndTimeAndRecordEvent(EventCategory category,
+                                     const std::string& event_name,
+                                     const TimePoint& start_time,
+                                     std::unordered_map<std::string, std::string>&& event_args,
                                      bool /*sync_gpu*/) {
   long long dur = TimeDiffMicroSeconds(start_time);
   long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
 
   EventRecord event(category, logging::GetProcessId(),
-                    logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+                    logging::GetThreadId(), event_name, ts, dur, std::move(event_args));
+  RecordEvent(std::move(event));
+}
+
+void Profiler::RecordCounterEvent(const std::string& counter_name,
+                                  const std::initializer_list<std::pair<std::string, int64_t>>& counter_values) {
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_);
+
+  std::unordered_map<std::string, std::string> event_args;
+  for (const auto& counter_value : counter_values) {
+    event_args.emplace(counter_value.first, std::to_string(counter_value.second));
+  }
+
+  EventRecord event(MEMORY_EVENT, logging::GetProcessId(),
+                    logging::GetThreadId(), counter_name, ts, 0, std::move(event_args));
+  RecordEvent(std::move(event));
+}
+
+void Profiler::RecordEvent(EventRecord&& event) {
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
     //TODO: sync_gpu if needed.
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
-      events_.emplace_back(event);
+      events_.emplace_back(std::move(event));
     } else {
       if (session_logger_ && !max_events_reached) {
         LOGS(*session_logger_, ERROR)
@@ -108,13 +135,19 @@ std::string Profiler::EndProfiling() {
     profile_stream_ << "\"tid\" :" << rec.tid << ",";
     profile_stream_ << "\"dur\" :" << rec.dur << ",";
     profile_stream_ << "\"ts\" :" << rec.ts << ",";
-    profile_stream_ << R"("ph" : "X",)";
+    // the values of counter events must be numbers
+    const bool is_counter = rec.cat == MEMORY_EVENT;
+    profile_stream_ << (is_counter ? R"("ph" : "C",)" : R"("ph" : "X",)");
     profile_stream_ << R"("name" :")" << rec.name << "\",";
     profile_stream_ << "\"args\" : {";
     bool is_first_arg = true;
     for (std::pair<std::string, std::string> event_arg : rec.args) {
       if (!is_first_arg) profile_stream_ << ",";
-      profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
+      if (is_counter) {
+        profile_stream_ << "\"" << event_arg.first << "\" : " << event_arg.second;
+      } else {
+        profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
+      }
       is_first_arg = false;
     }
     profile_stream_ << "}";
@@ -8,6 +8,7 @@
 #include <initializer_list>
 #include <iostream>
 #include <tuple>
+#include <unordered_map>
 
 #include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
@@ -78,6 +79,22 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a single event with args that are only known at runtime, e.g. optional ones.
+  */
+  void EndTimeAndRecordEvent(EventCategory category,
+                             const std::string& event_name,
+                             const TimePoint& start_time,
+                             std::unordered_map<std::string, std::string>&& event_args,
+                             bool sync_gpu = false);
+
+  /*
+  Record the current values of a group of counters, e.g. the memory use of an allocator. They are written as a
+  "counter event (C)", which trace viewers like Perfetto and chrome://tracing show as a graph over time.
+  */
+  void RecordCounterEvent(const std::string& counter_name,
+                          const std::initializer_list<std::pair<std::string, int64_t>>& counter_values);
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -111,6 +128,8 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  void RecordEvent(EventRecord&& event);
+
   /**
    * The maximum number of profiler records to collect.
    * This value is used to initialize the per-profiler maximum.
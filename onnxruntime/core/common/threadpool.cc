@@ -14,9 +14,11 @@ limitations under the License.
 ==============================================================================*/
 
 #include <memory>
+#include <thread>
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/common/profiler.h"
 #include "core/common/eigen_common_wrapper.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
@@ -25,6 +27,88 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+namespace {
+thread_local profiling::Profiler* current_profiler = nullptr;
+thread_local const std::string* current_profiling_event_name = nullptr;
+// 0 for no limit
+thread_local int current_max_degree_of_parallelism = 0;
+thread_local bool current_run_is_low_priority = false;
+// 0 for no weight
+thread_local int current_run_weight = 0;
+}  // namespace
+
+ThreadPoolProfilingScope::ThreadPoolProfilingScope(profiling::Profiler& profiler, const std::string& event_name)
+    : previous_profiler_(current_profiler), previous_event_name_(current_profiling_event_name) {
+  current_profiler = &profiler;
+  current_profiling_event_name = &event_name;
+}
+
+ThreadPoolProfilingScope::~ThreadPoolProfilingScope() {
+  current_profiler = previous_profiler_;
+  current_profiling_event_name = previous_event_name_;
+}
+
+profiling::Profiler* ThreadPoolProfilingScope::CurrentProfiler() {
+  return current_profiler;
+}
+
+const std::string* ThreadPoolProfilingScope::CurrentEventName() {
+  return current_profiling_event_name;
+}
+
+ThreadPoolParallelismLimitScope::ThreadPoolParallelismLimitScope(int max_degree_of_parallelism)
+    : previous_max_degree_of_parallelism_(current_max_degree_of_parallelism) {
+  ORT_ENFORCE(max_degree_of_parallelism > 0);
+  current_max_degree_of_parallelism = max_degree_of_parallelism;
+}
+
+ThreadPoolParallelismLimitScope::~ThreadPoolParallelismLimitScope() {
+  current_max_degree_of_parallelism = previous_max_degree_of_parallelism_;
+}
+
+int ThreadPoolParallelismLimitScope::CurrentMaxDegreeOfParallelism() {
+  return current_max_degree_of_parallelism;
+}
+
+ThreadPoolRunPriorityScope::ThreadPoolRunPriorityScope(ThreadPool* tp, bool low_priority)
+    : tp_(tp), low_priority_(low_priority), previous_low_priority_(current_run_is_low_priority) {
+  current_run_is_low_priority = low_priority;
+  if (tp_ != nullptr && !low_priority_) {
+    ++tp_->num_normal_priority_runs_;
+  }
+}
+
+ThreadPoolRunPriorityScope::~ThreadPoolRunPriorityScope() {
+  if (tp_ != nullptr && !low_priority_) {
+    --tp_->num_normal_priority_runs_;
+  }
+  current_run_is_low_priority = previous_low_priority_;
+}
+
+bool ThreadPoolRunPriorityScope::CurrentIsLowPriority() {
+  return current_run_is_low_priority;
+}
+
+ThreadPoolRunWeightScope::ThreadPoolRunWeightScope(ThreadPool* tp, int weight)
+    : tp_(tp), weight_(weight), previous_weight_(current_run_weight) {
+  ORT_ENFORCE(weight >= 0);
+  current_run_weight = weight;
+  if (tp_ != nullptr) {
+    tp_->total_run_weight_ += weight_;
+  }
+}
+
+ThreadPoolRunWeightScope::~ThreadPoolRunWeightScope() {
+  if (tp_ != nullptr) {
+    tp_->total_run_weight_ -= weight_;
+  }
+  current_run_weight = previous_weight_;
+}
+
+int ThreadPoolRunWeightScope::CurrentWeight() {
+  return current_run_weight;
+}
+
 // A sharded loop counter distributes loop iterations between a set of worker threads.  The iteration space of
 // the loop is divided (perhaps unevenly) between the shards.  Each thread has a home shard (perhaps not uniquely
 // to it), and it claims iterations via atomic operations on its home shard.  It then proceeds through the other
@@ -170,14 +254,65 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(d_of_p), total));
   assert(num_work_items > 0);
 
+  // the profiling scope is set on the calling thread, the helping threads record their events with it
+  profiling::Profiler* profiler = ThreadPoolProfilingScope::CurrentProfiler();
+  const std::string* profiling_event_name = ThreadPoolProfilingScope::CurrentEventName();
+
+  // with a weight, a helping thread leaves the loop before claiming the next block of iterations while more threads
+  // are in the loop than the share of the Run, e.g. because the Run of another session started using the pool. the
+  // calling thread stays until all the iterations are claimed.
+  const int run_weight = current_run_weight;
+  const int full_degree_of_parallelism = NumThreads() + 1;
+  const std::thread::id calling_thread = std::this_thread::get_id();
+  std::atomic<int> num_helpers{0};
+
   LoopCounter lc(*this, total, block_size);
   std::function<void()> run_work = [&]() {
+    TimePoint start_time;
+    if (profiler != nullptr) {
+      start_time = std::chrono::high_resolution_clock::now();
+    }
+
+    const bool may_leave = run_weight > 0 && std::this_thread::get_id() != calling_thread;
+    if (may_leave) {
+      ++num_helpers;
+    }
+
     int my_home_shard = lc.GetHomeShard();
     int my_shard = my_home_shard;
     uint64_t my_iter_start, my_iter_end;
-    while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end)) {
+    uint64_t num_iterations = 0;
+    bool left = false;
+    for (;;) {
+      if (may_leave) {
+        // the helpers and the calling thread fit in the share, so a helper leaves while num_helpers >= share
+        const int share = WeightedDegreeOfParallelism(full_degree_of_parallelism, run_weight);
+        int helpers = num_helpers.load(std::memory_order_relaxed);
+        while (helpers >= share && !num_helpers.compare_exchange_weak(helpers, helpers - 1)) {
+        }
+        if (helpers >= share) {
+          left = true;
+          break;
+        }
+      }
+
+      if (!lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end)) {
+        break;
+      }
+
       fn(static_cast<std::ptrdiff_t>(my_iter_start),
          static_cast<std::ptrdiff_t>(my_iter_end));
+      num_iterations += my_iter_end - my_iter_start;
+    }
+
+    if (may_leave && !left) {
+      --num_helpers;
+    }
+
+    if (profiler != nullptr && num_iterations > 0) {
+      profiler->EndTimeAndRecordEvent(profiling::THREADPOOL_EVENT, *profiling_event_name, start_time,
+                                      {{"iterations", std::to_string(num_iterations)},
+                                       {"total_iterations", std::to_string(total)}});
     }
   };
 
@@ -232,6 +367,16 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
   return true;
 }
 
+int ThreadPool::WeightedDegreeOfParallelism(int degree_of_parallelism, int weight) const {
+  const int total_weight = total_run_weight_.load(std::memory_order_relaxed);
+  if (weight <= 0 || total_weight <= weight) {
+    return degree_of_parallelism;
+  }
+
+  // rounded up, so every Run gets at least its calling thread
+  return static_cast<int>((static_cast<int64_t>(degree_of_parallelism) * weight + total_weight - 1) / total_weight);
+}
+
 int ThreadPool::NumShardsUsedByFixedBlockSizeScheduling(const std::ptrdiff_t total,
                                                         const std::ptrdiff_t block_size) const {
   if (!ShouldParallelizeLoop(total, block_size)) {
@@ -248,11 +393,12 @@ using CostModel = Eigen::TensorCostModel<Eigen::ThreadPoolDevice>;
 // efficiency. We want blocks to be not too small to mitigate parallelization
 // overheads; not too large to mitigate tail effect and potential load
 // imbalance and we also want number of blocks to be evenly dividable across
-// threads.
+// threads.  A larger max_oversharding_factor gives finer blocks, which lets threads
+// that join a loop late still pick up a share of the work.
 static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::TensorOpCost& cost,
-                                           std::function<ptrdiff_t(ptrdiff_t)> block_align, int num_threads) {
+                                           std::function<ptrdiff_t(ptrdiff_t)> block_align, int num_threads,
+                                           ptrdiff_t max_oversharding_factor = 4) {
   const double block_size_f = 1.0 / CostModel::taskSize(1, cost);
-  const ptrdiff_t max_oversharding_factor = 4;
   ptrdiff_t block_size = Eigen::numext::mini(
       n,
       Eigen::numext::maxi<ptrdiff_t>(Eigen::divup<ptrdiff_t>(n, max_oversharding_factor * num_threads), static_cast<ptrdiff_t>(block_size_f)));
@@ -315,7 +461,10 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
     return;
   }
 
-  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
+  // With adaptive spinning, idle threads may arrive at the loop at different times, so over-shard further and
+  // let them claim blocks from the loop counter as they become available.
+  const ptrdiff_t max_oversharding_factor = thread_options_.adaptive_spinning ? 16 : 4;
+  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p, max_oversharding_factor);
   ParallelForFixedBlockSizeScheduling(n, block, f);
 }
 
@@ -335,10 +484,27 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
 #else
   // When not using OpenMP, we parallelise over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
-  return tp ? (tp->NumThreads()+1) : 1;
+  int degree_of_parallelism = tp ? (tp->NumThreads()+1) : 1;
+  // yield the threads of the pool to the normal priority Runs while there are any
+  if (current_run_is_low_priority && tp && tp->num_normal_priority_runs_.load(std::memory_order_relaxed) > 0) {
+    return 1;
+  }
+  // share the threads of the pool with the other Runs using it
+  if (tp && current_run_weight > 0) {
+    degree_of_parallelism = tp->WeightedDegreeOfParallelism(degree_of_parallelism, current_run_weight);
+  }
+  return current_max_degree_of_parallelism > 0 ? std::min(degree_of_parallelism, current_max_degree_of_parallelism)
+                                               : degree_of_parallelism;
 #endif
 }
 
+ThreadPoolStats ThreadPool::GetStats() const {
+  if (extended_eigen_threadpool_) {
+    return extended_eigen_threadpool_->GetStats();
+  }
+  return ThreadPoolStats{};
+}
+
 // Return the number of threads created by the pool.
 int ThreadPool::NumThreads() const {
   if (underlying_threadpool_) {
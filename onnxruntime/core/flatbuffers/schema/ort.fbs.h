@@ -63,6 +63,12 @@ struct KernelCreateInfosBuilder;
 struct SubGraphSessionState;
 struct SubGraphSessionStateBuilder;
 
+struct PrePackedBuffer;
+struct PrePackedBufferBuilder;
+
+struct PrePackedWeights;
+struct PrePackedWeightsBuilder;
+
 struct SessionState;
 struct SessionStateBuilder;
 
@@ -1978,11 +1984,152 @@ inline flatbuffers::Offset<SubGraphSessionState> CreateSubGraphSessionStateDirec
       session_state);
 }
 
+struct PrePackedBuffer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedBufferBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_DATA = 4
+  };
+  const flatbuffers::Vector<uint8_t> *data() const {
+    return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_DATA);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_DATA) &&
+           verifier.VerifyVector(data()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedBufferBuilder {
+  typedef PrePackedBuffer Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_data(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> data) {
+    fbb_.AddOffset(PrePackedBuffer::VT_DATA, data);
+  }
+  explicit PrePackedBufferBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<PrePackedBuffer> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedBuffer>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedBuffer> CreatePrePackedBuffer(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> data = 0) {
+  PrePackedBufferBuilder builder_(_fbb);
+  builder_.add_data(data);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedBuffer> CreatePrePackedBufferDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<uint8_t> *data = nullptr) {
+  auto data__ = data ? _fbb.CreateVector<uint8_t>(*data) : 0;
+  return onnxruntime::experimental::fbs::CreatePrePackedBuffer(
+      _fbb,
+      data__);
+}
+
+struct PrePackedWeights FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedWeightsBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_NODE_INDEX = 4,
+    VT_INPUT_INDEX = 6,
+    VT_KERNEL_DEF_HASH = 8,
+    VT_BUFFERS = 10
+  };
+  uint32_t node_index() const {
+    return GetField<uint32_t>(VT_NODE_INDEX, 0);
+  }
+  int32_t input_index() const {
+    return GetField<int32_t>(VT_INPUT_INDEX, 0);
+  }
+  uint64_t kernel_def_hash() const {
+    return GetField<uint64_t>(VT_KERNEL_DEF_HASH, 0);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedBuffer>> *buffers() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedBuffer>> *>(VT_BUFFERS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint32_t>(verifier, VT_NODE_INDEX) &&
+           VerifyField<int32_t>(verifier, VT_INPUT_INDEX) &&
+           VerifyField<uint64_t>(verifier, VT_KERNEL_DEF_HASH) &&
+           VerifyOffset(verifier, VT_BUFFERS) &&
+           verifier.VerifyVector(buffers()) &&
+           verifier.VerifyVectorOfTables(buffers()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedWeightsBuilder {
+  typedef PrePackedWeights Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_node_index(uint32_t node_index) {
+    fbb_.AddElement<uint32_t>(PrePackedWeights::VT_NODE_INDEX, node_index, 0);
+  }
+  void add_input_index(int32_t input_index) {
+    fbb_.AddElement<int32_t>(PrePackedWeights::VT_INPUT_INDEX, input_index, 0);
+  }
+  void add_kernel_def_hash(uint64_t kernel_def_hash) {
+    fbb_.AddElement<uint64_t>(PrePackedWeights::VT_KERNEL_DEF_HASH, kernel_def_hash, 0);
+  }
+  void add_buffers(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedBuffer>>> buffers) {
+    fbb_.AddOffset(PrePackedWeights::VT_BUFFERS, buffers);
+  }
+  explicit PrePackedWeightsBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<PrePackedWeights> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedWeights>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedWeights> CreatePrePackedWeights(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t node_index = 0,
+    int32_t input_index = 0,
+    uint64_t kernel_def_hash = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedBuffer>>> buffers = 0) {
+  PrePackedWeightsBuilder builder_(_fbb);
+  builder_.add_kernel_def_hash(kernel_def_hash);
+  builder_.add_buffers(buffers);
+  builder_.add_input_index(input_index);
+  builder_.add_node_index(node_index);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedWeights> CreatePrePackedWeightsDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t node_index = 0,
+    int32_t input_index = 0,
+    uint64_t kernel_def_hash = 0,
+    const std::vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedBuffer>> *buffers = nullptr) {
+  auto buffers__ = buffers ? _fbb.CreateVector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedBuffer>>(*buffers) : 0;
+  return onnxruntime::experimental::fbs::CreatePrePackedWeights(
+      _fbb,
+      node_index,
+      input_index,
+      kernel_def_hash,
+      buffers__);
+}
+
 struct SessionState FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef SessionStateBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_KERNELS = 4,
-    VT_SUB_GRAPH_SESSION_STATES = 6
+    VT_SUB_GRAPH_SESSION_STATES = 6,
+    VT_PREPACKED_WEIGHTS_SIGNATURE = 8,
+    VT_PREPACKED_WEIGHTS = 10
   };
   const onnxruntime::experimental::fbs::KernelCreateInfos *kernels() const {
     return GetPointer<const onnxruntime::experimental::fbs::KernelCreateInfos *>(VT_KERNELS);
@@ -1990,6 +2137,12 @@ struct SessionState FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>> *sub_graph_session_states() const {
     return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>> *>(VT_SUB_GRAPH_SESSION_STATES);
   }
+  const flatbuffers::String *prepacked_weights_signature() const {
+    return GetPointer<const flatbuffers::String *>(VT_PREPACKED_WEIGHTS_SIGNATURE);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedWeights>> *prepacked_weights() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedWeights>> *>(VT_PREPACKED_WEIGHTS);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_KERNELS) &&
@@ -1997,6 +2150,11 @@ struct SessionState FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyOffset(verifier, VT_SUB_GRAPH_SESSION_STATES) &&
            verifier.VerifyVector(sub_graph_session_states()) &&
            verifier.VerifyVectorOfTables(sub_graph_session_states()) &&
+           VerifyOffset(verifier, VT_PREPACKED_WEIGHTS_SIGNATURE) &&
+           verifier.VerifyString(prepacked_weights_signature()) &&
+           VerifyOffset(verifier, VT_PREPACKED_WEIGHTS) &&
+           verifier.VerifyVector(prepacked_weights()) &&
+           verifier.VerifyVectorOfTables(prepacked_weights()) &&
            verifier.EndTable();
   }
 };
@@ -2011,6 +2169,12 @@ struct SessionStateBuilder {
   void add_sub_graph_session_states(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>>> sub_graph_session_states) {
     fbb_.AddOffset(SessionState::VT_SUB_GRAPH_SESSION_STATES, sub_graph_session_states);
   }
+  void add_prepacked_weights_signature(flatbuffers::Offset<flatbuffers::String> prepacked_weights_signature) {
+    fbb_.AddOffset(SessionState::VT_PREPACKED_WEIGHTS_SIGNATURE, prepacked_weights_signature);
+  }
+  void add_prepacked_weights(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedWeights>>> prepacked_weights) {
+    fbb_.AddOffset(SessionState::VT_PREPACKED_WEIGHTS, prepacked_weights);
+  }
   explicit SessionStateBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -2025,8 +2189,12 @@ struct SessionStateBuilder {
 inline flatbuffers::Offset<SessionState> CreateSessionState(
     flatbuffers::FlatBufferBuilder &_fbb,
     flatbuffers::Offset<onnxruntime::experimental::fbs::KernelCreateInfos> kernels = 0,
-    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>>> sub_graph_session_states = 0) {
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>>> sub_graph_session_states = 0,
+    flatbuffers::Offset<flatbuffers::String> prepacked_weights_signature = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedWeights>>> prepacked_weights = 0) {
   SessionStateBuilder builder_(_fbb);
+  builder_.add_prepacked_weights(prepacked_weights);
+  builder_.add_prepacked_weights_signature(prepacked_weights_signature);
   builder_.add_sub_graph_session_states(sub_graph_session_states);
   builder_.add_kernels(kernels);
   return builder_.Finish();
@@ -2035,12 +2203,18 @@ inline flatbuffers::Offset<SessionState> CreateSessionState(
 inline flatbuffers::Offset<SessionState> CreateSessionStateDirect(
     flatbuffers::FlatBufferBuilder &_fbb,
     flatbuffers::Offset<onnxruntime::experimental::fbs::KernelCreateInfos> kernels = 0,
-    std::vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>> *sub_graph_session_states = nullptr) {
+    std::vector<flatbuffers::Offset<onnxruntime::experimental::fbs::SubGraphSessionState>> *sub_graph_session_states = nullptr,
+    const char *prepacked_weights_signature = nullptr,
+    const std::vector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedWeights>> *prepacked_weights = nullptr) {
   auto sub_graph_session_states__ = sub_graph_session_states ? _fbb.CreateVectorOfSortedTables<onnxruntime::experimental::fbs::SubGraphSessionState>(sub_graph_session_states) : 0;
+  auto prepacked_weights_signature__ = prepacked_weights_signature ? _fbb.CreateString(prepacked_weights_signature) : 0;
+  auto prepacked_weights__ = prepacked_weights ? _fbb.CreateVector<flatbuffers::Offset<onnxruntime::experimental::fbs::PrePackedWeights>>(*prepacked_weights) : 0;
   return onnxruntime::experimental::fbs::CreateSessionState(
       _fbb,
       kernels,
-      sub_graph_session_states__);
+      sub_graph_session_states__,
+      prepacked_weights_signature__,
+      prepacked_weights__);
 }
 
 struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
 #include <vector>
 #include <utility>
@@ -10,6 +11,9 @@
 namespace onnxruntime {
 // Put this in a separate file to avoid circular dependency between tensor.h and data_types.h
 // Data type to represent a sequence of tensors of the same type
+// The tensors are held by ref-counted OrtValues, so sequences derived from this one (e.g. by SequenceInsert or
+// SequenceErase) and the outputs of SequenceAt share the tensors instead of copying them. The tensors of a sequence
+// must not be modified once it's created.
 class TensorSeq {
  public:
   TensorSeq() = default;
@@ -17,19 +21,29 @@ class TensorSeq {
     SetType(elem_type);
   }
 
-  using const_iterator = std::vector<Tensor>::const_iterator;
+  using const_iterator = std::vector<OrtValue>::const_iterator;
 
   // Sets the element type after construction.
   // Expects sequence to be empty at the time.
   void SetType(MLDataType elem_type) {
-    assert(tensors_.empty());
+    assert(ort_values_.empty());
     elem_type_ = elem_type->AsPrimitiveDataType();
     ORT_ENFORCE(elem_type_ != nullptr, "Tensor sequence must contain only primitive types");
   }
 
   void SetElements(std::vector<Tensor>&& tensors) {
-    assert(tensors_.empty());
-    tensors_ = std::move(tensors);
+    assert(ort_values_.empty());
+    ort_values_.reserve(tensors.size());
+    for (auto& tensor : tensors) {
+      auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+      ort_values_.emplace_back(new Tensor(std::move(tensor)), ml_tensor, ml_tensor->GetDeleteFunc());
+    }
+  }
+
+  // Sets the elements to OrtValues holding tensors, which are shared with their other holders.
+  void SetElements(std::vector<OrtValue>&& ort_values) {
+    assert(ort_values_.empty());
+    ort_values_ = std::move(ort_values);
   }
 
   MLDataType DataType() const noexcept { return elem_type_; }
@@ -42,21 +56,26 @@ class TensorSeq {
     return elem_type_ == o.DataType()->AsPrimitiveDataType();
   }
 
-  size_t Size() const noexcept { return tensors_.size(); }
+  size_t Size() const noexcept { return ort_values_.size(); }
 
   // Suitable for for range loop
   const_iterator begin() const noexcept {
-    return tensors_.cbegin();
+    return ort_values_.cbegin();
   }
 
   const_iterator end() const noexcept {
-    return tensors_.cend();
+    return ort_values_.cend();
   }
 
   // Get by index
   const Tensor& Get(size_t i) const {
-    ORT_ENFORCE(i < tensors_.size());
-    return tensors_[i];
+    return GetAt(i).Get<Tensor>();
+  }
+
+  // Get the OrtValue holding the tensor by index, copy it to share the tensor
+  const OrtValue& GetAt(size_t i) const {
+    ORT_ENFORCE(i < ort_values_.size());
+    return ort_values_[i];
   }
 
  private:
@@ -69,7 +88,7 @@ class TensorSeq {
 
   // TODO: optimization opportunity - if all tensors in the seq are scalars, we can potentially represent them
   // as vector<primitive type>
-  std::vector<Tensor> tensors_;
+  std::vector<OrtValue> ort_values_;
 };
 
 }  // namespace onnxruntime
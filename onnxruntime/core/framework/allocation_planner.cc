@@ -4,6 +4,7 @@
 #include "core/framework/allocation_planner.h"
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <sstream>
 #include "core/common/exceptions.h"
@@ -40,6 +41,12 @@ std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind) {
     case AllocKind::kShare:
       out << "Share";
       break;
+    case AllocKind::kAlias:
+      out << "Alias";
+      break;
+    case AllocKind::kSlice:
+      out << "Slice";
+      break;
   }
   return out;
 }
@@ -63,6 +70,8 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kSlice)
+        out << " " << elt_plan.reused_buffer << " + " << elt_plan.buffer_offset;
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -82,7 +91,9 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
     auto node = graph.GetNode(step.node_index);
     ORT_ENFORCE(nullptr != node);
     out << "[" << i << "] ";
-    out << node->OpType() << " (" << node->Name() << ")" << std::endl;
+    out << node->OpType() << " (" << node->Name() << ")";
+    if (!plan.node_stream_ids.empty()) out << ", stream " << plan.node_stream_ids[step.node_index];
+    out << std::endl;
     if (step.free_from_index <= step.free_to_index) {
       out << "Free ml-values: ";
       std::string sep;
@@ -151,6 +162,9 @@ class PlannerImpl {
     // Removing initializers is a temporary measure needed to limit the number of copies of 
     // tensors in GPU memory.
     OrtValueIndex reused_buffer_index = -1;  // index of original buffer to reuse
+
+    // true if no other node than the ones in the chain of reuses leading to this OrtValue reads its buffer
+    bool exclusive_buffer = true;
   };
 
   // ort_value_info_ is indexed by an OrtValueIndex
@@ -170,6 +184,16 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // SliceInfo: the value, and the byte offset in its buffer, a kSlice is placed in.
+  struct SliceInfo {
+    OrtValueIndex buffer;
+    size_t offset;
+  };
+  // the inputs of a Concat placed in its output, and the outputs of a Split placed in its input
+  std::unordered_map<OrtValueIndex, SliceInfo> slices_;
+  // the outputs of a Concat allocated with the first of its inputs, before the Concat runs
+  std::unordered_set<OrtValueIndex> early_buffers_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -208,6 +232,12 @@ class PlannerImpl {
     info.usecount = 0;
     info.reused_buffer_index = id;  // initially, no reuse; the ml-value uses its own buffer
     info.p_def_site = p_def_site;
+    info.exclusive_buffer = true;
+  }
+
+  bool HasSingleConsumer(OrtValueIndex n) {
+    const auto* p_def_site = ort_value_info_[n].p_def_site;
+    return p_def_site != nullptr && graph_viewer_.GetConsumerNodes(p_def_site->Name()).size() == 1;
   }
 
   // Reuse/Alias/Share between two OrtValue indexes
@@ -219,11 +249,15 @@ class PlannerImpl {
     Buffer(reused_for) = original;
     // adjust original buffer's usecount
     UseCount(original) += UseCount(reused_for);
+    // the buffer is shared with the other consumers of the reused ml-value
+    ort_value_info_[reused_for].exclusive_buffer = ort_value_info_[reused].exclusive_buffer && HasSingleConsumer(reused);
 
     // update allocation plan (for use at execution-time)
     auto& symplan = AllocPlan(reused_for);
     symplan.alloc_kind = alloc_kind;
     symplan.reused_buffer = original;
+    // a value reusing a slice is placed at the same offset in the original buffer
+    symplan.buffer_offset = AllocPlan(reused).buffer_offset;
   }
 
   // Find if there exists some input tensor that we can use in-place for output_arg_num-th input in the node.
@@ -258,7 +292,12 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            // the use count only tells that the consumers preceding this node in the execution order are done with
+            // the buffer. the parallel executor can run them concurrently, so the buffer must not be read by others.
+            bool can_update_in_place = !context_.IsParallelExecutionEnabled() || parent_node_ != nullptr ||
+                                       (ort_value_info_[input_arg_index].exclusive_buffer &&
+                                        HasSingleConsumer(input_arg_index));
+            if (1 == UseCount(original) && can_update_in_place) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
@@ -272,6 +311,51 @@ class PlannerImpl {
     return false;
   }
 
+  // Find if a graph output can be a view of an input of the node, i.e. the kernel aliases the input to the output and
+  // the buffer of the input can be handed to the caller. Weights are excluded as the caller could modify the output.
+  bool FindAliasedInputForGraphOutput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* aliased_input) {
+    // subgraph outputs are consumed by the control flow kernels, which may reuse their buffers between iterations
+    if (parent_node_ != nullptr) {
+      return false;
+    }
+
+    const KernelCreateInfo& ci = GetKernelCreateInfo(kernel_create_info_map_, node.Index());
+    if (ci.kernel_def == nullptr) {
+      return false;
+    }
+
+    auto p_output_arg = node.OutputDefs()[output_arg_num];
+    // the view takes ownership of the buffer, which requires placement new for strings
+    if (IsNonTensor(*p_output_arg) ||
+        p_output_arg->TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      return false;
+    }
+
+    auto input_args = node.InputDefs();
+    for (auto pair : ci.kernel_def->Alias()) {
+      if (pair.second != output_arg_num || pair.first < 0 || static_cast<size_t>(pair.first) >= input_args.size()) {
+        continue;
+      }
+
+      auto p_input_arg = input_args[pair.first];
+      if (!p_input_arg->Exists() || IsNonTensor(*p_input_arg)) {
+        continue;
+      }
+
+      auto input_arg_index = Index(p_input_arg->Name());
+      const auto& original_plan = AllocPlan(Buffer(input_arg_index));
+      if ((original_plan.alloc_kind == AllocKind::kAllocate ||
+           original_plan.alloc_kind == AllocKind::kAllocateOutput ||
+           original_plan.alloc_kind == AllocKind::kPreExisting) &&
+          original_plan.location == AllocPlan(p_output_arg->Name()).location) {
+        *aliased_input = input_arg_index;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
     // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
     namespace on = ONNX_NAMESPACE;
@@ -476,6 +560,10 @@ class PlannerImpl {
         OrtValueIndex index = Index(node_output->Name());
         ProcessDef(index, node_output);
         ++UseCount(index);
+        if (IsCpuOnnxNode(*pnode, "SequenceAt")) {
+          // the output is the tensor in the sequence, so it must not be updated in place or reused.
+          ++UseCount(index);
+        }
         plan_.SetLocation(static_cast<size_t>(index),
                           exec_provider->GetAllocator(0, p_kernel_def->OutputMemoryType(i))->Info());
       }
@@ -549,6 +637,172 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Get the size in bytes of a non-string tensor with a fully known shape, and the number of elements in the
+  // dimensions before axis.
+  bool GetStaticTensorSize(const onnxruntime::NodeArg& arg, int64_t axis, size_t& size_in_bytes,
+                           int64_t& outer_size) {
+    if (!arg.Exists() || IsNonTensor(arg) ||
+        arg.TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      return false;
+    }
+
+    const auto* shape = context_.GetShape(arg);
+    if (shape == nullptr || axis < 0 || axis >= shape->dim_size()) return false;
+
+    int64_t size = 1;
+    outer_size = 1;
+    for (int i = 0; i < shape->dim_size(); ++i) {
+      const auto& dim = shape->dim(i);
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return false;
+      size *= dim.dim_value();
+      if (i < axis) outer_size *= dim.dim_value();
+    }
+
+    size_in_bytes = static_cast<size_t>(size) * GetElementSize(arg.Type());
+    return true;
+  }
+
+  static int64_t GetAxis(const onnxruntime::Node& node, int rank) {
+    const auto& attributes = node.GetAttributes();
+    auto it = attributes.find("axis");
+    int64_t axis = it != attributes.end() ? it->second.i() : 0;
+    return axis < 0 ? axis + rank : axis;
+  }
+
+  static bool IsCpuOnnxNode(const onnxruntime::Node& node, const char* op_type) {
+    return node.OpType() == op_type && (node.Domain() == kOnnxDomain || node.Domain() == kOnnxDomainAlias) &&
+           node.GetExecutionProviderType() == kCpuExecutionProvider;
+  }
+
+  // Whether an input of a Concat can be written by its producer straight into the Concat output.
+  bool CanPlaceInConcatOutput(const onnxruntime::NodeArg& input, OrtValueIndex concat_output,
+                              const ConstPointerContainer<std::vector<NodeArg*>>& concat_inputs) {
+    if (std::count(concat_inputs.begin(), concat_inputs.end(), &input) != 1) return false;
+
+    const Node* producer = graph_viewer_.GetProducerNode(input.Name());
+    // control flow nodes return the values produced by their subgraphs
+    if (producer == nullptr || producer->GetExecutionProviderType() != kCpuExecutionProvider ||
+        producer->ContainsSubgraph()) {
+      return false;
+    }
+
+    // the producer and the Concat are the only users
+    auto index = Index(input.Name());
+    if (UseCount(index) != 2 || slices_.find(index) != slices_.end() ||
+        early_buffers_.find(index) != early_buffers_.end()) {
+      return false;
+    }
+
+    const auto& input_plan = AllocPlan(index);
+    if (input_plan.create_fence_if_async || !(input_plan.location == AllocPlan(concat_output).location)) {
+      return false;
+    }
+
+    // an output that aliases an input of its producer (e.g. Reshape) must stay in the buffer of that input
+    int output_arg_num = 0;
+    for (const NodeArg* output : producer->OutputDefs()) {
+      if (output == &input) break;
+      ++output_arg_num;
+    }
+    const KernelCreateInfo& ci = GetKernelCreateInfo(kernel_create_info_map_, producer->Index());
+    for (auto pair : ci.kernel_def->Alias()) {
+      if (pair.second == output_arg_num) return false;
+    }
+
+    return true;
+  }
+
+  // Place the inputs of a Concat inside its output, and the outputs of a Split inside its input, so that the
+  // producers write the Concat output directly and the consumers read the Split input directly. The tensors must
+  // have known shapes and the dimensions before the axis must be 1, so each one is contiguous in the buffer.
+  void ComputeSlicePlan() {
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    auto is_graph_output = [&graph_outputs](const NodeArg* arg) {
+      return std::find(graph_outputs.begin(), graph_outputs.end(), arg) != graph_outputs.end();
+    };
+
+    for (const auto& step : plan_.execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(step.node_index);
+      std::vector<std::pair<OrtValueIndex, size_t>> slices;
+      size_t offset = 0;
+
+      if (IsCpuOnnxNode(*pnode, "Concat")) {
+        const NodeArg* output = pnode->OutputDefs()[0];
+        const auto* output_shape = context_.GetShape(*output);
+        auto output_index = Index(output->Name());
+        if (output_shape == nullptr || is_graph_output(output) || AllocPlan(output_index).create_fence_if_async ||
+            slices_.find(output_index) != slices_.end()) {
+          continue;
+        }
+
+        const int64_t axis = GetAxis(*pnode, output_shape->dim_size());
+        size_t output_size = 0;
+        int64_t outer_size = 0;
+        if (!GetStaticTensorSize(*output, axis, output_size, outer_size) || outer_size != 1) continue;
+
+        const auto& input_defs = pnode->InputDefs();
+        bool contiguous = true;
+        for (const NodeArg* input : input_defs) {
+          size_t input_size = 0;
+          if (!GetStaticTensorSize(*input, axis, input_size, outer_size) || outer_size != 1) {
+            contiguous = false;
+            break;
+          }
+
+          // the inputs that can't be placed in the output are still copied by the Concat kernel
+          if (CanPlaceInConcatOutput(*input, output_index, input_defs)) {
+            slices.emplace_back(Index(input->Name()), offset);
+          }
+          offset += input_size;
+        }
+
+        if (!contiguous || offset != output_size || slices.empty()) continue;
+
+        early_buffers_.insert(output_index);
+        for (const auto& slice : slices) {
+          slices_[slice.first] = SliceInfo{output_index, slice.second};
+        }
+      } else if (IsCpuOnnxNode(*pnode, "Split")) {
+        const NodeArg* input = pnode->InputDefs()[0];
+        const auto* input_shape = context_.GetShape(*input);
+        auto input_index = Index(input->Name());
+        // the Split is the only user, so no one else reads the buffer while the outputs are updated in place
+        if (input_shape == nullptr || graph_viewer_.GetProducerNode(input->Name()) == nullptr ||
+            UseCount(input_index) != 2 || AllocPlan(input_index).create_fence_if_async) {
+          continue;
+        }
+
+        const int64_t axis = GetAxis(*pnode, input_shape->dim_size());
+        size_t input_size = 0;
+        int64_t outer_size = 0;
+        if (!GetStaticTensorSize(*input, axis, input_size, outer_size) || outer_size != 1) continue;
+
+        bool contiguous = true;
+        for (const NodeArg* output : pnode->OutputDefs()) {
+          size_t output_size = 0;
+          if (!GetStaticTensorSize(*output, axis, output_size, outer_size) || outer_size != 1) {
+            contiguous = false;
+            break;
+          }
+
+          auto output_index = Index(output->Name());
+          const auto& output_plan = AllocPlan(output_index);
+          if (!is_graph_output(output) && slices_.find(output_index) == slices_.end() &&
+              !output_plan.create_fence_if_async && output_plan.location == AllocPlan(input_index).location) {
+            slices.emplace_back(output_index, offset);
+          }
+          offset += output_size;
+        }
+
+        if (!contiguous || offset != input_size) continue;
+
+        for (const auto& slice : slices) {
+          slices_[slice.first] = SliceInfo{input_index, slice.second};
+        }
+      }
+    }
+  }
+
   // Should only be used after ProcessDef()
   Status ComputeReusePlan() {
     std::vector<SequentialExecutionPlan::NodeExecutionPlan>& execution_plan(plan_.execution_plan);
@@ -602,6 +856,17 @@ class PlannerImpl {
           // node_output is graph's output, so we can't reuse intermediate buffer
           AllocPlan(current).alloc_kind = AllocKind::kAllocateOutput;
 
+          if (FindAliasedInputForGraphOutput(*pnode, static_cast<int>(output_arg_def_index), &reused)) {
+            // return a view of the input instead of a copy. the buffer is then owned by the output as well, so it
+            // must not come from a memory pattern block, which is released with the execution frame.
+            Reuse(reused, current, AllocKind::kAlias);
+            auto& original_plan = AllocPlan(Buffer(reused));
+            if (original_plan.alloc_kind == AllocKind::kAllocate) {
+              original_plan.alloc_kind = AllocKind::kAllocateOutput;
+            }
+            continue;
+          }
+
           // hacky perf optimization to not copy a pre-existing value to an output if this is a Loop subgraph and
           // the value is not being changed in the subgraph.
           //
@@ -634,6 +899,21 @@ class PlannerImpl {
               }
             }
           }
+        } else if (IsCpuOnnxNode(*pnode, "SequenceAt")) {
+          // the kernel returns the tensor in the sequence instead of allocating one, see ComputeUseCounts
+          AllocPlan(current).alloc_kind = AllocKind::kAllocateOutput;
+        } else if (early_buffers_.find(current) != early_buffers_.end()) {
+          // already planned along with the first Concat input placed in it
+        } else if (slices_.find(current) != slices_.end()) {
+          const SliceInfo& slice = slices_.at(current);
+          if (early_buffers_.find(slice.buffer) != early_buffers_.end()) {
+            // the buffer of the Concat output is live from now on, so it can't be one freed before the Concat runs
+            auto& buffer_plan = AllocPlan(slice.buffer);
+            buffer_plan.alloc_kind = AllocKind::kAllocate;
+            buffer_plan.value_type = utils::GetMLDataType(*ort_value_info_[slice.buffer].p_def_site);
+          }
+          Reuse(slice.buffer, current, AllocKind::kSlice);
+          AllocPlan(current).buffer_offset += slice.offset;
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
@@ -686,6 +966,68 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Assign the nodes to streams for the parallel execution mode. A node continues the stream of its producer if
+  // that is the only node it consumes values from and no other consumer continues the stream yet. Values that an
+  // execution provider with per-thread streams produces on one stream and consumes on another need a fence to
+  // order the device work of the two threads running the streams.
+  Status ComputeStreamPlan() {
+    plan_.node_stream_ids.assign(graph_viewer_.MaxNodeIndex(), -1);
+    std::vector<bool> stream_continued(graph_viewer_.MaxNodeIndex(), false);
+    int num_streams = 0;
+
+    for (const SequentialExecutionPlan::NodeExecutionPlan& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      if (pnode == nullptr) return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Can not find the node ", step.node_index);
+
+      const Node* producer = nullptr;
+      bool single_producer = true;
+      for (auto it = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); it != end; ++it) {
+        if (producer == nullptr) {
+          producer = &it->GetNode();
+        } else if (producer != &it->GetNode()) {
+          single_producer = false;
+          break;
+        }
+      }
+
+      if (producer != nullptr && single_producer && !stream_continued[producer->Index()]) {
+        plan_.node_stream_ids[step.node_index] = plan_.node_stream_ids[producer->Index()];
+        stream_continued[producer->Index()] = true;
+      } else {
+        plan_.node_stream_ids[step.node_index] = num_streams++;
+      }
+    }
+
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    for (const SequentialExecutionPlan::NodeExecutionPlan& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      auto exec_provider = execution_providers_.Get(*pnode);
+      if (exec_provider == nullptr || !exec_provider->UsesPerThreadStreams()) {
+        continue;
+      }
+
+      const int stream_id = plan_.node_stream_ids[step.node_index];
+      auto outputs = pnode->OutputDefs();
+      for (auto* node_output : outputs) {
+        // graph outputs are consumed by the thread calling Run
+        if (node_output->Exists() &&
+            std::find(graph_outputs.begin(), graph_outputs.end(), node_output) != graph_outputs.end()) {
+          AllocPlan(Index(node_output->Name())).create_fence_if_async = true;
+          plan_.has_cross_stream_fences = true;
+        }
+      }
+
+      for (auto it = pnode->OutputEdgesBegin(), end = pnode->OutputEdgesEnd(); it != end; ++it) {
+        if (plan_.node_stream_ids[it->GetNode().Index()] != stream_id) {
+          AllocPlan(Index(outputs[it->GetSrcArgIndex()]->Name())).create_fence_if_async = true;
+          plan_.has_cross_stream_fences = true;
+        }
+      }
+    }
+
+    return Status::OK();
+  }
+
   // Whether a given NodeArg has fence or not.
   // If the buffer is reused, need to check whether original OrtValue has fence or not.
   bool HasFence(const onnxruntime::NodeArg* arg) {
@@ -695,7 +1037,7 @@ class PlannerImpl {
       AllocPlanPerValue& value_plan = AllocPlan(index);
 
       has_fence = value_plan.create_fence_if_async;
-      if (value_plan.alloc_kind == AllocKind::kReuse) {
+      if (value_plan.alloc_kind == AllocKind::kReuse || value_plan.alloc_kind == AllocKind::kSlice) {
         // Buffer reused, check original buffer to see if fence is shared.
         has_fence = has_fence || AllocPlan(value_plan.reused_buffer).create_fence_if_async;
       }
@@ -783,6 +1125,17 @@ Status PlannerImpl::CreatePlan() {
   // compute use counts for all ml-values
   ORT_RETURN_IF_ERROR(ComputeUseCounts());
 
+  // assign nodes to streams for the parallel executor. only the main graph is executed in parallel.
+  if (context_.IsParallelExecutionEnabled() && parent_node_ == nullptr) {
+    ORT_RETURN_IF_ERROR(ComputeStreamPlan());
+  }
+
+  // place the inputs of Concat and the outputs of Split in the buffers of the Concat output and the Split input.
+  // the parallel executor may run the producers of the Concat inputs concurrently.
+  if (!context_.IsParallelExecutionEnabled() || parent_node_ != nullptr) {
+    ComputeSlicePlan();
+  }
+
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
 
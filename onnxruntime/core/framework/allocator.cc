@@ -5,6 +5,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/utils.h"
+#include "core/platform/env.h"
 #include "core/session/ort_apis.h"
 #include <cstdlib>
 #include <sstream>
@@ -53,6 +54,19 @@ void* CPUAllocator::Alloc(size_t size) {
 void CPUAllocator::Free(void* p) {
   utils::DefaultFree(p);
 }
+
+void* NumaCPUAllocator::Alloc(size_t size) {
+  void* p = utils::DefaultAlloc(size);
+  if (p != nullptr) {
+    // best effort. a failure only means the pages are placed by the default policy.
+    ORT_IGNORE_RETURN_VALUE(Env::Default().BindMemoryToNumaNode(p, size, numa_node_));
+  }
+  return p;
+}
+
+void NumaCPUAllocator::Free(void* p) {
+  utils::DefaultFree(p);
+}
 }  // namespace onnxruntime
 
 std::ostream& operator<<(std::ostream& out, const OrtMemoryInfo& info) { return (out << info.ToString()); }
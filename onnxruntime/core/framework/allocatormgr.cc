@@ -38,17 +38,19 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
         return nullptr;
     }
 
-#ifdef USE_MIMALLOC
-    return std::shared_ptr<IArenaAllocator>(
-        onnxruntime::make_unique<MiMallocArena>(std::move(device_allocator), max_mem));
-#else
+#if defined(USE_MIMALLOC_ARENA_ALLOCATOR)
+    // mimalloc only manages CPU memory, the arenas of the other devices are BFCArenas
+    if (device_allocator->Info().device.Type() == OrtDevice::CPU) {
+      return std::shared_ptr<IArenaAllocator>(
+          onnxruntime::make_unique<MiMallocArena>(std::move(device_allocator), max_mem));
+    }
+#endif
     return std::shared_ptr<IArenaAllocator>(
         onnxruntime::make_unique<BFCArena>(std::move(device_allocator),
                                            max_mem,
                                            arena_extend_str,
                                            initial_chunk_size_bytes,
                                            max_dead_bytes_per_chunk));
-#endif
   }
 
   return AllocatorPtr(std::move(device_allocator));
@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+struct AllocatorStats;
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -27,6 +30,12 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Returns the memory the arena holds without using it to the underlying allocator, keeping the memory
+  // that was last used less than <min_idle_time> ago. Arenas that can't return memory do nothing.
+  // Shrink call need to be thread safe.
+  virtual Status Shrink(std::chrono::seconds /*min_idle_time*/) { return Status::OK(); }
+  // Arenas that don't collect statistics only report the bytes in use.
+  virtual void GetStats(AllocatorStats* stats);
   // allocate host pinned memory?
 };
 
@@ -43,6 +52,8 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_arena_extensions;  // Number of times the arena allocated memory from the underlying allocator.
+  int64_t num_arena_shrinkages;  // Number of times the arena returned memory to the underlying allocator.
 
   AllocatorStats() { Clear(); }
 
@@ -53,6 +64,8 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_arena_extensions = 0;
+    this->num_arena_shrinkages = 0;
   }
 
   std::string DebugString() const {
@@ -62,8 +75,15 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "NumExtensions:  " << this->num_arena_extensions << "\n"
+       << "NumShrinkages:  " << this->num_arena_shrinkages << "\n";
     return ss.str();
   }
 };
+
+inline void IArenaAllocator::GetStats(AllocatorStats* stats) {
+  stats->Clear();
+  stats->bytes_in_use = static_cast<int64_t>(Used());
+}
 }  // namespace onnxruntime
@@ -157,6 +157,7 @@ Status BFCArena::Extend(size_t rounded_bytes) {
   LOGS_DEFAULT(INFO) << "Extended allocation by " << bytes << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
+  ++stats_.num_arena_extensions;
   LOGS_DEFAULT(INFO) << "Total allocated bytes: "
                      << stats_.total_allocated_bytes;
 
@@ -302,6 +303,41 @@ void BFCArena::GetStats(AllocatorStats* stats) {
   *stats = stats_;
 }
 
+Status BFCArena::Shrink(std::chrono::seconds min_idle_time) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  const auto now = std::chrono::steady_clock::now();
+
+  // A region has no chunk in use when it is a single free chunk, as free neighbors are always coalesced
+  std::vector<void*> idle_regions;
+  for (const auto& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->next == kInvalidChunkHandle && now - region.idle_since() >= min_idle_time) {
+      idle_regions.push_back(region.ptr());
+    }
+  }
+
+  for (void* ptr : idle_regions) {
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    const size_t bytes = ChunkFromHandle(h)->size;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+    stats_.total_allocated_bytes -= bytes;
+    LOGS_DEFAULT(INFO) << "Freed region of " << bytes << " bytes at " << ptr;
+  }
+
+  if (!idle_regions.empty()) {
+    ++stats_.num_arena_shrinkages;
+    // don't grow the next regions from the size the largest workload required
+    curr_region_allocation_bytes_ = RoundedBytes(std::min(memory_limit_, static_cast<size_t>(initial_chunk_size_bytes_)));
+    LOGS_DEFAULT(INFO) << "Shrank " << device_allocator_->Info().name << " arena to "
+                       << stats_.total_allocated_bytes << " allocated bytes.";
+  }
+
+  return Status::OK();
+}
+
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
                              size_t num_bytes) {
   // First identify the first bin that could satisfy rounded_bytes.
@@ -519,6 +555,12 @@ void BFCArena::FreeAndMaybeCoalesce(BFCArena::ChunkHandle h) {
     }
   }
 
+  // The whole region is free, Shrink uses the time since then to keep the regions that are still needed
+  c = ChunkFromHandle(chunk_to_reassign);
+  if (c->prev == kInvalidChunkHandle && c->next == kInvalidChunkHandle) {
+    region_manager_.set_idle_since(c->ptr, std::chrono::steady_clock::now());
+  }
+
   InsertFreeChunkIntoBin(chunk_to_reassign);
 }
 
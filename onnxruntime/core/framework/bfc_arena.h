@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -90,7 +91,11 @@ class BFCArena : public IArenaAllocator {
     return device_allocator_->CreateFence(session_state);
   }
 
-  void GetStats(AllocatorStats* stats);
+  void GetStats(AllocatorStats* stats) override;
+
+  // Frees the regions obtained by Extend that have no chunk in use since at least <min_idle_time>.
+  // The next extensions start again from the initial chunk size.
+  Status Shrink(std::chrono::seconds min_idle_time) override;
 
   size_t RequestedSize(const void* ptr);
 
@@ -230,6 +235,9 @@ class BFCArena : public IArenaAllocator {
     void* ptr() const { return ptr_; }
     void* end_ptr() const { return end_ptr_; }
     size_t memory_size() const { return memory_size_; }
+    // Time at which the region was last left without any chunk in use
+    std::chrono::steady_clock::time_point idle_since() const { return idle_since_; }
+    void set_idle_since(std::chrono::steady_clock::time_point t) { idle_since_ = t; }
     ChunkHandle get_handle(const void* p) const {
       return handles_[IndexFor(p)];
     }
@@ -242,6 +250,7 @@ class BFCArena : public IArenaAllocator {
       std::swap(memory_size_, other.memory_size_);
       std::swap(end_ptr_, other.end_ptr_);
       std::swap(handles_, other.handles_);
+      std::swap(idle_since_, other.idle_since_);
     }
 
     int IndexFor(const void* p) const {
@@ -256,6 +265,7 @@ class BFCArena : public IArenaAllocator {
     void* ptr_ = nullptr;
     size_t memory_size_ = 0;
     void* end_ptr_ = nullptr;
+    std::chrono::steady_clock::time_point idle_since_ = std::chrono::steady_clock::now();
 
     // Array of size "memory_size / kMinAllocationSize".  It is
     // indexed by (p-base) / kMinAllocationSize, contains ChunkHandle
@@ -282,6 +292,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr, "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -290,6 +307,9 @@ class BFCArena : public IArenaAllocator {
       return MutableRegionFor(p)->set_handle(p, h);
     }
     void erase(const void* p) { return MutableRegionFor(p)->erase(p); }
+    void set_idle_since(const void* p, std::chrono::steady_clock::time_point t) {
+      MutableRegionFor(p)->set_idle_since(t);
+    }
 
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/capped_allocator.h"
+
+#include <algorithm>
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+
+CappedAllocator::CappedAllocator(AllocatorPtr allocator, size_t soft_limit, size_t hard_limit, std::string owner)
+    : IArenaAllocator(allocator->Info()),
+      allocator_(std::move(allocator)),
+      arena_(allocator_->Info().alloc_type == OrtArenaAllocator ? static_cast<IArenaAllocator*>(allocator_.get())
+                                                                 : nullptr),
+      soft_limit_(soft_limit),
+      hard_limit_(hard_limit),
+      owner_(std::move(owner)) {
+}
+
+void* CappedAllocator::Allocate(size_t size, bool reserve) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // count the bytes before allocating so that concurrent allocations can't exceed the hard limit together
+  bool warn = false;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (hard_limit_ != 0 && (size > hard_limit_ || bytes_in_use_ > hard_limit_ - size)) {
+      ORT_THROW(owner_, " is using ", bytes_in_use_, " bytes of ", Info().name, " memory and can't allocate ", size,
+                " more bytes within its hard limit of ", hard_limit_, " bytes");
+    }
+    bytes_in_use_ += size;
+    if (soft_limit_ != 0 && bytes_in_use_ > soft_limit_ && !over_soft_limit_) {
+      over_soft_limit_ = true;
+      warn = true;
+    }
+  }
+
+  if (warn) {
+    LOGS_DEFAULT(WARNING) << owner_ << " exceeded its soft limit of " << soft_limit_ << " bytes of " << Info().name
+                          << " memory";
+  }
+
+  void* p = nullptr;
+  ORT_TRY {
+    p = reserve && arena_ != nullptr ? arena_->Reserve(size) : allocator_->Alloc(size);
+  }
+  ORT_CATCH(...) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    bytes_in_use_ -= size;
+    ORT_RETHROW;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (p == nullptr) {
+    bytes_in_use_ -= size;
+    return nullptr;
+  }
+  sizes_[p] = size;
+  max_bytes_in_use_ = std::max(max_bytes_in_use_, bytes_in_use_);
+  max_alloc_size_ = std::max(max_alloc_size_, size);
+  ++num_allocs_;
+  return p;
+}
+
+void* CappedAllocator::Alloc(size_t size) {
+  return Allocate(size, false);
+}
+
+void* CappedAllocator::Reserve(size_t size) {
+  return Allocate(size, true);
+}
+
+void CappedAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = sizes_.find(p);
+    if (it != sizes_.end()) {
+      bytes_in_use_ -= it->second;
+      sizes_.erase(it);
+      if (over_soft_limit_ && bytes_in_use_ <= soft_limit_) {
+        over_soft_limit_ = false;
+      }
+    }
+  }
+
+  allocator_->Free(p);
+}
+
+size_t CappedAllocator::Used() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return bytes_in_use_;
+}
+
+Status CappedAllocator::Shrink(std::chrono::seconds min_idle_time) {
+  return arena_ != nullptr ? arena_->Shrink(min_idle_time) : Status::OK();
+}
+
+void CappedAllocator::GetStats(AllocatorStats* stats) {
+  if (arena_ != nullptr) {
+    arena_->GetStats(stats);
+  } else {
+    stats->Clear();
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  stats->num_allocs = num_allocs_;
+  stats->bytes_in_use = static_cast<int64_t>(bytes_in_use_);
+  stats->max_bytes_in_use = static_cast<int64_t>(max_bytes_in_use_);
+  stats->max_alloc_size = static_cast<int64_t>(max_alloc_size_);
+  stats->bytes_limit = static_cast<int64_t>(hard_limit_);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/arena.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Accounts the memory one owner, e.g. a session, allocates from an allocator shared with other owners, and caps it.
+// The allocations over the soft limit succeed but log a warning, once until the usage is back under the limit.
+// The allocations over the hard limit throw, as the arenas do when the device is out of memory, so that one session
+// can't take the memory the others rely on. A limit of 0 means no limit.
+// The usage is the sum of the requested sizes, which excludes the rounding of the underlying arena.
+class CappedAllocator : public IArenaAllocator {
+ public:
+  CappedAllocator(AllocatorPtr allocator, size_t soft_limit, size_t hard_limit, std::string owner);
+
+  void* Alloc(size_t size) override;
+  // Reserves from the underlying arena, or allocates if the underlying allocator isn't an arena.
+  void* Reserve(size_t size) override;
+  void Free(void* p) override;
+
+  FencePtr CreateFence(const SessionState* session_state) override {
+    return allocator_->CreateFence(session_state);
+  }
+
+  size_t Used() const override;
+  size_t Max() const override { return hard_limit_; }
+  Status Shrink(std::chrono::seconds min_idle_time) override;
+  // The statistics of the owner's usage, with the memory the underlying arena reserved for all the owners.
+  void GetStats(AllocatorStats* stats) override;
+
+ private:
+  void* Allocate(size_t size, bool reserve);
+
+  const AllocatorPtr allocator_;
+  // null if the underlying allocator isn't an arena
+  IArenaAllocator* const arena_;
+  const size_t soft_limit_;
+  const size_t hard_limit_;
+  const std::string owner_;
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<void*, size_t> sizes_;
+  size_t bytes_in_use_ = 0;
+  size_t max_bytes_in_use_ = 0;
+  size_t max_alloc_size_ = 0;
+  int64_t num_allocs_ = 0;
+  bool over_soft_limit_ = false;
+};
+
+}  // namespace onnxruntime
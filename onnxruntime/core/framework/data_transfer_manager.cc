@@ -6,6 +6,19 @@
 namespace onnxruntime {
 using namespace common;
 
+namespace {
+void RecordCopyEvent(profiling::Profiler& profiler, const TimePoint& start_time, const OrtDevice& src_device,
+                     const OrtDevice& dst_device, size_t num_tensors, size_t num_bytes) {
+  profiler.EndTimeAndRecordEvent(profiling::DATA_TRANSFER_EVENT,
+                                 MakeString("copy_", src_device.ToString(), "_to_", dst_device.ToString()),
+                                 start_time,
+                                 {{"src_device", src_device.ToString()},
+                                  {"dst_device", dst_device.ToString()},
+                                  {"num_tensors", std::to_string(num_tensors)},
+                                  {"bytes", std::to_string(num_bytes)}});
+}
+}  // namespace
+
 Status DataTransferManager::RegisterDataTransfer(std::unique_ptr<IDataTransfer> data_transfer) {
   if (nullptr == data_transfer) {
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "data_transfer registered is nullptr.");
@@ -39,7 +52,14 @@ Status DataTransferManager::CopyTensor(const Tensor& src, Tensor& dst, int exec_
       continue;
     }
 
-    return data_transfer->CopyTensor(src, dst, exec_queue_id);
+    if (profiler_ == nullptr || !profiler_->IsEnabled()) {
+      return data_transfer->CopyTensor(src, dst, exec_queue_id);
+    }
+
+    const TimePoint start_time = profiler_->StartTime();
+    auto status = data_transfer->CopyTensor(src, dst, exec_queue_id);
+    RecordCopyEvent(*profiler_, start_time, src.Location().device, dst.Location().device, 1, src.SizeInBytes());
+    return status;
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME,
@@ -84,7 +104,18 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
 
   // all copies are between the same devices so we can do them all at once
   if (all_same) {
-    return first_dt->CopyTensors(src_dst_pairs);
+    if (profiler_ == nullptr || !profiler_->IsEnabled()) {
+      return first_dt->CopyTensors(src_dst_pairs);
+    }
+
+    const TimePoint start_time = profiler_->StartTime();
+    auto status = first_dt->CopyTensors(src_dst_pairs);
+    size_t num_bytes = 0;
+    for (const auto& pair : src_dst_pairs) {
+      num_bytes += pair.src.get().SizeInBytes();
+    }
+    RecordCopyEvent(*profiler_, start_time, src_device, dst_device, src_dst_pairs.size(), num_bytes);
+    return status;
   }
 
   // there are a mix of devices requiring copies. we don't expect this to happen, so just iterate the pairs
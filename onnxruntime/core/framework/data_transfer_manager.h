@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/common/profiler.h"
 #include "core/common/status.h"
 #include "core/framework/data_transfer.h"
 #include "core/framework/tensor.h"
@@ -24,10 +25,15 @@ class DataTransferManager {
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const;
   common::Status CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs) const;
 
+  // Sets the profiler that records a "DataTransfer" event for each copy while it is enabled. Not owned.
+  void SetProfiler(profiling::Profiler* profiler) { profiler_ = profiler; }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DataTransferManager);
 
   // It's assumed that data transfers in this array have no overlap in terms of copying functionality.
   std::vector<std::unique_ptr<IDataTransfer>> datatransfers_;
+
+  profiling::Profiler* profiler_ = nullptr;
 };
 }  // namespace onnxruntime
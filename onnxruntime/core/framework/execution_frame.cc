@@ -7,11 +7,13 @@
 
 #include "core/framework/mem_pattern_planner.h"
 #include "core/framework/execution_plan_base.h"
+#include "core/framework/execution_plan_cache.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/scratch_allocator.h"
 #include "core/framework/session_state.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/utils.h"
@@ -84,6 +86,14 @@ AllocatorPtr IExecutionFrame::GetAllocator(const OrtMemoryInfo& info) const {
   return GetAllocatorImpl(info);
 }
 
+AllocatorPtr IExecutionFrame::GetTempSpaceAllocator(const OrtMemoryInfo& info) const {
+  return GetTempSpaceAllocatorImpl(info);
+}
+
+AllocatorPtr IExecutionFrame::GetTempSpaceAllocatorImpl(const OrtMemoryInfo& info) const {
+  return GetAllocatorImpl(info);
+}
+
 Status IExecutionFrame::ReleaseMLValue(int ort_value_idx) { return ReleaseMLValueImpl(ort_value_idx); }
 
 Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
@@ -102,6 +112,15 @@ Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   return Status::OK();
 }
 
+Status IExecutionFrame::SetMLValue(int ort_value_idx, const OrtValue& value) {
+  if (ort_value_idx < 0 || static_cast<size_t>(ort_value_idx) >= all_values_size_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid index ", ort_value_idx);
+  }
+
+  all_values_[ort_value_idx] = value;
+  return Status::OK();
+}
+
 int IExecutionFrame::GetNodeIdxToMLValueIdx(int index) const {
   // the validity of index is checked by GetMLValueIndex
   int ort_value_idx = node_index_info_.GetMLValueIndex(index);
@@ -207,7 +226,6 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
                                const SessionState& session_state)
     : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
       session_state_(session_state),
-      mem_patterns_(nullptr),
       planner_(nullptr) {
   Init(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetches);
 
@@ -242,26 +260,37 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
 
     //if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes, feed_mlvalue_idxs, inferred_shapes_);
+      plan_cache_entry_ = session_state.GetExecutionPlanCacheEntry(input_shapes, feed_mlvalue_idxs);
       // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
+      if (!plan_cache_entry_ || !plan_cache_entry_->mem_patterns) {
+        plan_cache_entry_ = nullptr;
         planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
       } else {
+        const auto& mem_patterns = *plan_cache_entry_->mem_patterns;
+        buffers_.resize(mem_patterns.locations.size());
+        scratch_locations_ = mem_patterns.locations;
+        scratch_allocators_.resize(mem_patterns.locations.size());
+
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          const auto& location = mem_patterns_->locations[i];
-          ORT_ENFORCE(buffers_.find(location) == buffers_.end());
-          if (mem_patterns_->patterns[i].PeakSize() > 0) {
-            AllocatorPtr alloc = GetAllocator(location);
-            void* buffer = nullptr;
+        // the kernels' temp space is carved from the end of the chunk.
+        for (size_t i = 0; i < mem_patterns.locations.size(); i++) {
+          const auto& location = mem_patterns.locations[i];
+          AllocatorPtr alloc = GetAllocator(location);
+          size_t pattern_size = 0;
+          ORT_ENFORCE(IAllocator::CalcMemSizeForArrayWithAlignment<ScratchAllocator::kAlignment>(
+                          mem_patterns.patterns[i].PeakSize(), 1, &pattern_size),
+                      "Memory pattern size overflow");
+          const size_t scratch_size = plan_cache_entry_->ScratchSize(i);
+          void* buffer = nullptr;
+          if (pattern_size > 0 || scratch_size > 0) {
             // it's possible we can't allocate the large block. if we have memory patterns we know we have successfully
             // executed once before, so if there's an arena involved it probably has smaller blocks available.
             // due to that we can still run and use those blocks (inside the arena logic) instead of one large one.
             // it's less efficient (the arena will add some overhead to coalesce individual allocations
             // back into blocks on 'free'), but better than failing completely.
             ORT_TRY {
-              auto peak_size = mem_patterns_->patterns[i].PeakSize();
+              auto peak_size = mem_patterns.patterns[i].PeakSize();
               // Planning of one memory type should only happen once.
               ORT_ENFORCE(
                   static_activation_memory_sizes_in_byte_.find(location.name) ==
@@ -272,7 +301,7 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
               // static_activation_memory_in_bytes_ is max virtual memory size the planner computes.
               // Memory dynamically allocated when executing kernels is not recorded using this field.
               static_activation_memory_sizes_in_byte_[location.name] = peak_size;
-              buffer = alloc->Alloc(peak_size);
+              buffer = alloc->Alloc(pattern_size + scratch_size);
               // handle allocator that doesn't throw
               if (buffer == nullptr) {
                 // INFO level as this may fire on every run and there may not be much a user can do
@@ -288,20 +317,41 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
             }
 
             if (buffer != nullptr) {
-              buffers_[location] = BufferUniquePtr(buffer, alloc);
+              buffers_[i] = BufferUniquePtr(buffer, alloc);
             }
 
             // log size of activation. Keep it commented out for now to avoid log flooding.
             // VLOGS(session_state_.Logger(), 1) << "Allocated memory for activations, size: "
-            //                                   << mem_patterns_->patterns[i].PeakSize();
+            //                                   << mem_patterns.patterns[i].PeakSize();
           }
+
+          scratch_allocators_[i] = std::make_shared<ScratchAllocator>(
+              alloc, buffer != nullptr ? static_cast<char*>(buffer) + pattern_size : nullptr, scratch_size);
         }
       }
     }
   }
+
+  // trace the peak temp space of the kernels so the pattern generated from this Run can plan it
+  if (planner_) {
+    for (const auto& location : session_state.GetExecutionPlan()->GetAllLocations()) {
+      AllocatorPtr alloc = GetAllocator(location);
+      if (alloc) {
+        scratch_locations_.push_back(location);
+        scratch_allocators_.push_back(std::make_shared<ScratchAllocator>(std::move(alloc), nullptr, 0));
+      }
+    }
+  }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  // grow the temp space planned for the input shapes if the kernels needed more of it in this Run
+  if (plan_cache_entry_) {
+    for (size_t i = 0; i < scratch_allocators_.size(); ++i) {
+      plan_cache_entry_->RecordScratchSize(i, scratch_allocators_[i]->PeakSize());
+    }
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -350,33 +400,30 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   // if we have pre-calculated memory pattern, and the ort_value is not output mlvalue
   // try to allocated on pre-allocated big chunk.
   const auto& per_alloc_plan = GetAllocationPlan(ort_value_index);
-  if (mem_patterns_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput) {
-    auto pattern = mem_patterns_->GetPatterns(location);
-    if (pattern) {
-      auto block = pattern->GetBlock(ort_value_index);
-      // if block not found, fall back to default behavior
-      if (block) {
-        auto it = buffers_.find(location);
-        if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
-            void* buffer = it->second.get();
-            auto status = AllocateTensorWithPreAllocateBufferHelper(
-                ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
-                shape);
-            return status;
-          } else {
-            // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
-            // fed in, so use VERBOSE as the log level as it's expected.
-            // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-            // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
-            LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
-                                                   << ", block in memory pattern size is: " << block->size_
-                                                   << " but the actually size is: " << size
-                                                   << ", fall back to default allocation behavior";
-          }
+  if (plan_cache_entry_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput) {
+    int location_idx = -1;
+    const auto* block = plan_cache_entry_->GetBlock(ort_value_index, location_idx);
+    // if block not found, fall back to default behavior
+    if (block && plan_cache_entry_->mem_patterns->locations[location_idx] == location) {
+      void* buffer = buffers_[location_idx].get();
+      // if we couldn't allocate the large block for the buffer there's no entry
+      if (buffer != nullptr) {
+        // if the block is not correct, log message then fall back to default behavior
+        if (block->size_ == size) {
+          auto status = AllocateTensorWithPreAllocateBufferHelper(
+              ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
+              shape);
+          return status;
+        } else {
+          // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
+          // fed in, so use VERBOSE as the log level as it's expected.
+          // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
+          // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
+          LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
+                                                 << ", block in memory pattern size is: " << block->size_
+                                                 << " but the actually size is: " << size
+                                                 << ", fall back to default allocation behavior";
         }
-        // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
       }
     }
   }
@@ -453,6 +500,29 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
   return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_buffer, element_type, location, shape);
 }
 
+Status ExecutionFrame::AllocateMLValueTensorInBuffer(OrtValue& ort_value, int ort_value_index, int buffer_index,
+                                                     size_t offset, MLDataType element_type,
+                                                     const OrtMemoryInfo& location, const TensorShape& shape) {
+  OrtValue& buffer_value = GetMutableMLValue(buffer_index);
+  auto* buffer_tensor = buffer_value.GetMutable<Tensor>();
+  size_t required_size = 0;
+  if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(shape.Size()), element_type->Size(), &required_size)) {
+    return Status(ONNXRUNTIME, FAIL, "size overflow");
+  }
+
+  // the planner placed the tensor according to the shapes in the model, which may be wrong
+  if (buffer_tensor->SizeInBytes() < offset || buffer_tensor->SizeInBytes() - offset < required_size) {
+    LOGS(session_state_.Logger(), WARNING) << "Shape mismatch attempting to place a tensor of shape " << shape
+                                           << " at offset " << offset << " in a buffer of shape "
+                                           << buffer_tensor->Shape() << ". Allocating a separate buffer.";
+    return AllocateMLValueTensorSelfOwnBuffer(ort_value, ort_value_index, element_type, location, shape);
+  }
+
+  ort_value.ShareFenceWith(buffer_value);
+  return AllocateTensorWithPreAllocateBufferHelper(
+      ort_value, static_cast<char*>(buffer_tensor->MutableDataRaw()) + offset, element_type, location, shape);
+}
+
 Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer,
                                                                  MLDataType element_type,
                                                                  const OrtMemoryInfo& location,
@@ -464,6 +534,45 @@ Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_v
   return Status::OK();
 }
 
+namespace {
+// The deleter of a view of the buffer of another tensor. It frees nothing but holds the OrtValue owning the buffer,
+// so the buffer is released once both the view and the original value are.
+class TensorViewBufferOwner final : public IAllocator {
+ public:
+  TensorViewBufferOwner(const OrtValue& original_value, const OrtMemoryInfo& location)
+      : IAllocator(location), original_value_(original_value) {}
+
+  void* Alloc(size_t /*size*/) override { ORT_THROW("A tensor view doesn't allocate memory."); }
+  void Free(void* /*p*/) override {}
+
+ private:
+  OrtValue original_value_;
+};
+}  // namespace
+
+static Status AllocateTensorView(OrtValue& ort_value, OrtValue& original_value, size_t offset,
+                                 MLDataType element_type, const TensorShape& shape) {
+  auto* original_tensor = original_value.GetMutable<Tensor>();
+  size_t required_size = 0;
+  if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(shape.Size()), element_type->Size(), &required_size)) {
+    return Status(ONNXRUNTIME, FAIL, "size overflow");
+  }
+
+  if (original_tensor->SizeInBytes() < offset || original_tensor->SizeInBytes() - offset < required_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Shape mismatch attempting to create a view of a buffer. ",
+                           original_tensor->Shape(), " is smaller than ", shape);
+  }
+
+  auto owner = std::make_shared<TensorViewBufferOwner>(original_value, original_tensor->Location());
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape,
+                                                   static_cast<char*>(original_tensor->MutableDataRaw()) + offset,
+                                                   owner);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  ort_value.ShareFenceWith(original_value);
+  return Status::OK();
+}
+
 static Status AllocateTraditionalMLValue(OrtValue& ort_value, const NonTensorTypeBase& type) {
   auto creator = type.GetCreateFunc();
   ort_value.Init(creator(), &type, type.GetDeleteFunc());
@@ -551,8 +660,15 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
         if (!reuse_value.IsAllocated()) {
           ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(reuse_value, reuse_mlvalue_index, shape, nnz));
         }
-        ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
-            ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
+        if (per_alloc_plan.buffer_offset != 0) {
+          // reusing a slice of the buffer
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorInBuffer(ort_value, ort_value_index, reuse_mlvalue_index,
+                                                            per_alloc_plan.buffer_offset, ml_data_type, alloc_info,
+                                                            *shape));
+        } else {
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
+              ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
+        }
         break;
       }
       case AllocKind::kShare: {
@@ -561,6 +677,35 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
         ort_value = GetMutableMLValue(reuse_mlvalue_index);
         break;
       }
+      case AllocKind::kAlias: {
+        int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
+        OrtValue& reuse_value = GetMutableMLValue(reuse_mlvalue_index);
+        if (!reuse_value.IsAllocated()) {
+          ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(reuse_value, reuse_mlvalue_index, shape, nnz));
+        }
+        // the graph output keeps the buffer alive after the execution frame is released
+        ORT_RETURN_IF_ERROR(AllocateTensorView(ort_value, reuse_value, per_alloc_plan.buffer_offset, ml_data_type,
+                                               *shape));
+        break;
+      }
+      case AllocKind::kSlice: {
+        int buffer_mlvalue_index = per_alloc_plan.reused_buffer;
+        OrtValue& buffer_value = GetMutableMLValue(buffer_mlvalue_index);
+        if (!buffer_value.IsAllocated()) {
+          // a Concat output is allocated with the first of its inputs, so its shape is the one from the model
+          std::string name;
+          ORT_RETURN_IF_ERROR(session_state_.GetOrtValueNameIdxMap().GetName(buffer_mlvalue_index, name));
+          const auto* node_arg = session_state_.GetGraphViewer().GetNodeArg(name);
+          ORT_RETURN_IF_NOT(node_arg != nullptr && node_arg->Shape() != nullptr,
+                            "The shape of the buffer ", name, " of a slice is unknown.");
+          TensorShape buffer_shape = utils::GetTensorShapeFromTensorShapeProto(*node_arg->Shape());
+          ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(buffer_value, buffer_mlvalue_index, &buffer_shape, nnz));
+        }
+        ORT_RETURN_IF_ERROR(AllocateMLValueTensorInBuffer(ort_value, ort_value_index, buffer_mlvalue_index,
+                                                          per_alloc_plan.buffer_offset, ml_data_type, alloc_info,
+                                                          *shape));
+        break;
+      }
       default: {
         std::ostringstream ostr;
         ostr << "Invalid allocation kind: " << static_cast<std::underlying_type<AllocKind>::type>(alloc_kind);
@@ -588,6 +733,16 @@ AllocatorPtr ExecutionFrame::GetAllocatorImpl(const OrtMemoryInfo& info) const {
   return session_state_.GetAllocator(info);
 }
 
+AllocatorPtr ExecutionFrame::GetTempSpaceAllocatorImpl(const OrtMemoryInfo& info) const {
+  for (size_t i = 0; i < scratch_locations_.size(); ++i) {
+    if (scratch_locations_[i] == info) {
+      return scratch_allocators_[i];
+    }
+  }
+
+  return GetAllocatorImpl(info);
+}
+
 // This method is not thread safe!
 // Return S_OK and nullptr if index map to an value that is an unused optional input/output
 Status ExecutionFrame::CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx,
@@ -652,7 +807,18 @@ Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup* out) const {
     return Status(ONNXRUNTIME, FAIL, "Memory pattern planner is not enabled on this execution framework.");
   }
 
-  return planner_->GeneratePatterns(out);
+  ORT_RETURN_IF_ERROR(planner_->GeneratePatterns(out));
+
+  out->scratch_sizes.assign(out->locations.size(), 0);
+  for (size_t i = 0; i < out->locations.size(); ++i) {
+    for (size_t j = 0; j < scratch_locations_.size(); ++j) {
+      if (scratch_locations_[j] == out->locations[i]) {
+        out->scratch_sizes[i] = scratch_allocators_[j]->PeakSize();
+      }
+    }
+  }
+
+  return Status::OK();
 }
 
 bool ExecutionFrame::TryGetInferredShape(int index, TensorShape& shape) const {
@@ -666,8 +832,13 @@ bool ExecutionFrame::TryGetInferredShape(int index, TensorShape& shape) const {
 
   // Search for inferred shape.
   // If inferred shape is found, it's assigned to "shape" so that caller can use it.
-  auto it = inferred_shapes_.find(ort_value_idx);
-  if (it != inferred_shapes_.end()) {
+  if (!plan_cache_entry_) {
+    return false;
+  }
+
+  const auto& inferred_shapes = plan_cache_entry_->inferred_shapes;
+  auto it = inferred_shapes.find(ort_value_idx);
+  if (it != inferred_shapes.end()) {
     shape = it->second;
     return true;
   }
@@ -23,7 +23,9 @@ class SessionState;
 class OrtValueNameIdxMap;
 class OrtValuePatternPlanner;
 struct MemoryPatternGroup;
+struct ExecutionPlanCacheEntry;
 class NodeIndexInfo;
+class ScratchAllocator;
 
 class IExecutionFrame {
  protected:
@@ -67,8 +69,14 @@ class IExecutionFrame {
 
   AllocatorPtr GetAllocator(const OrtMemoryInfo& info) const;
 
+  // The allocator for the temp space a kernel frees before returning from Compute.
+  AllocatorPtr GetTempSpaceAllocator(const OrtMemoryInfo& info) const;
+
   Status ReleaseMLValue(int ort_value_idx);
 
+  // Set the value at ort_value_idx that is produced without executing its node, e.g. a memoized node output.
+  Status SetMLValue(int ort_value_idx, const OrtValue& value);
+
  protected:
   // get the ort_value_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
@@ -90,6 +98,9 @@ class IExecutionFrame {
 
   virtual AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const = 0;
 
+  // defaults to GetAllocatorImpl
+  virtual AllocatorPtr GetTempSpaceAllocatorImpl(const OrtMemoryInfo& info) const;
+
   virtual Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape,
                                              size_t nnz) = 0;
 
@@ -163,6 +174,7 @@ class ExecutionFrame final : public IExecutionFrame {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
   AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const override;
+  AllocatorPtr GetTempSpaceAllocatorImpl(const OrtMemoryInfo& info) const override;
   Status ReleaseMLValueImpl(int ort_value_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
   Status CopyTensor(const Tensor& src, Tensor& dest) const override;
@@ -177,6 +189,12 @@ class ExecutionFrame final : public IExecutionFrame {
   Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer, MLDataType element_type,
                                                    const OrtMemoryInfo& location, const TensorShape& shape);
 
+  // create a tensor at byte offset in the buffer of the OrtValue at buffer_index. allocates its own buffer instead
+  // if the tensor doesn't fit, so the kernels using the tensor have to copy the data.
+  Status AllocateMLValueTensorInBuffer(OrtValue& ort_value, int ort_value_index, int buffer_index, size_t offset,
+                                       MLDataType element_type, const OrtMemoryInfo& location,
+                                       const TensorShape& shape);
+
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
@@ -187,23 +205,23 @@ class ExecutionFrame final : public IExecutionFrame {
   // map of index to custom allocator
   std::unordered_map<int, IExecutor::CustomAllocator> custom_allocators_;
 
-  // If we already have cached memory pattern on these input shapes
-  // Use this mem pattern that create a big chunk for all the internal
-  // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // If we already have a cached execution plan for these input shapes use the memory pattern in it,
+  // which creates a big chunk for all the internal kernel's input/output tensors.
+  // The entry is shared with the SessionState cache and stays alive for the lifetime of the frame even if evicted.
+  std::shared_ptr<const ExecutionPlanCacheEntry> plan_cache_entry_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::unique_ptr<OrtValuePatternPlanner> planner_;
 
   // Big chunks on different locations that will be used by mem_pattern.
-  std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
+  // Indexed the same way as MemoryPatternGroup::locations. Entries are empty if the allocation failed.
+  std::vector<BufferUniquePtr> buffers_;
 
-  // Given the input shapes of the executed graph, ExecutionFrame tries inferring
-  // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
-  // by i, if the key i exists.
-  // inferred_shapes_ is generated togehter with mem_patterns_.
-  std::unordered_map<int, TensorShape> inferred_shapes_;
+  // Serve the kernels' temp space from the end of buffers_, or trace its peak size if there's no memory pattern yet.
+  // Indexed the same way as MemoryPatternGroup::locations if there's a memory pattern.
+  std::vector<OrtMemoryInfo> scratch_locations_;
+  std::vector<std::shared_ptr<ScratchAllocator>> scratch_allocators_;
 
   // Size of virtual memory allocated before any kernel execution.
   // This field is not physical memory size.
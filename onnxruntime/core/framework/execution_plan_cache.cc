@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_plan_cache.h"
+
+namespace onnxruntime {
+
+ExecutionPlanCacheEntry::ExecutionPlanCacheEntry(std::unique_ptr<MemoryPatternGroup> mem_patterns_in,
+                                                 std::unordered_map<int, TensorShape> inferred_shapes_in,
+                                                 size_t num_ort_values)
+    : mem_patterns(std::move(mem_patterns_in)),
+      inferred_shapes(std::move(inferred_shapes_in)),
+      blocks_(num_ort_values, {-1, nullptr}) {
+  if (!mem_patterns) {
+    return;
+  }
+
+  const size_t num_scratch_sizes = mem_patterns->locations.size();
+  scratch_sizes_.reset(new std::atomic<size_t>[num_scratch_sizes]());
+  for (size_t loc = 0; loc < num_scratch_sizes && loc < mem_patterns->scratch_sizes.size(); ++loc) {
+    scratch_sizes_[loc].store(mem_patterns->scratch_sizes[loc], std::memory_order_relaxed);
+  }
+
+  // flatten the per location maps so an allocation doesn't need a location scan plus a hash lookup
+  for (size_t loc = 0, num_locations = mem_patterns->patterns.size(); loc < num_locations; ++loc) {
+    const auto& pattern = mem_patterns->patterns[loc];
+    for (size_t idx = 0; idx < num_ort_values; ++idx) {
+      if (blocks_[idx].second != nullptr) {
+        continue;
+      }
+
+      const auto* block = pattern.GetBlock(static_cast<int>(idx));
+      if (block != nullptr) {
+        blocks_[idx] = {static_cast<int>(loc), block};
+      }
+    }
+  }
+}
+
+void ExecutionPlanCacheEntry::RecordScratchSize(size_t location_idx, size_t size) const {
+  auto& scratch_size = scratch_sizes_[location_idx];
+  size_t current = scratch_size.load(std::memory_order_relaxed);
+  while (size > current && !scratch_size.compare_exchange_weak(current, size, std::memory_order_relaxed)) {
+  }
+}
+
+ExecutionPlanCache::Key ExecutionPlanCache::MakeKey(
+    const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
+  Key key;
+  size_t num_entries = shapes.size();
+  for (const auto& shape : shapes) {
+    num_entries += shape.get().NumDimensions();
+  }
+  key.reserve(num_entries);
+
+  for (const auto& shape : shapes) {
+    const auto& dims = shape.get().GetDims();
+    key.push_back(static_cast<int64_t>(dims.size()));
+    key.insert(key.end(), dims.cbegin(), dims.cend());
+  }
+
+  return key;
+}
+
+std::shared_ptr<const ExecutionPlanCacheEntry> ExecutionPlanCache::Find(const Key& key) {
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+
+  // move to front
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+void ExecutionPlanCache::Insert(Key key, std::shared_ptr<const ExecutionPlanCacheEntry> entry) {
+  if (capacity_ == 0 || index_.find(key) != index_.end()) {
+    return;
+  }
+
+  lru_.emplace_front(key, std::move(entry));
+  index_.emplace(std::move(key), lru_.begin());
+  EvictToCapacity();
+}
+
+void ExecutionPlanCache::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  EvictToCapacity();
+}
+
+void ExecutionPlanCache::EvictToCapacity() {
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
+
+}  // namespace onnxruntime
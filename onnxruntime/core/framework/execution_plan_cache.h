@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+/**
+The per input-shape state an ExecutionFrame needs to set up a Run: the memory pattern, the resolved output shapes
+and a flat view of the pattern's blocks indexed by OrtValue index.
+An entry is immutable once created and is shared with all the frames using it, so an entry evicted from the cache
+stays valid until the last Run using it completes.
+*/
+struct ExecutionPlanCacheEntry {
+  ExecutionPlanCacheEntry(std::unique_ptr<MemoryPatternGroup> mem_patterns,
+                          std::unordered_map<int, TensorShape> inferred_shapes,
+                          size_t num_ort_values);
+
+  // Location index and block for the OrtValue. Returns nullptr if the value is not part of the pattern.
+  const MemoryBlock* GetBlock(int ort_value_idx, int& location_idx) const {
+    if (ort_value_idx < 0 || static_cast<size_t>(ort_value_idx) >= blocks_.size()) {
+      return nullptr;
+    }
+
+    const auto& entry = blocks_[ort_value_idx];
+    location_idx = entry.first;
+    return entry.second;
+  }
+
+  // Size of the temp space to carve after the pattern's buffer for the location.
+  size_t ScratchSize(size_t location_idx) const {
+    return scratch_sizes_[location_idx].load(std::memory_order_relaxed);
+  }
+
+  // Grows the temp space of the location to the peak a Run using the entry needed, so the later Runs carve all of
+  // their temp space from the buffer. Thread-safe.
+  void RecordScratchSize(size_t location_idx, size_t size) const;
+
+  const std::unique_ptr<MemoryPatternGroup> mem_patterns;
+  const std::unordered_map<int, TensorShape> inferred_shapes;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionPlanCacheEntry);
+
+  std::vector<std::pair<int, const MemoryBlock*>> blocks_;
+  // indexed the same way as mem_patterns->locations
+  mutable std::unique_ptr<std::atomic<size_t>[]> scratch_sizes_;
+};
+
+/**
+Bounded LRU cache of ExecutionPlanCacheEntry keyed on the shapes of the feeds.
+Not thread-safe. SessionState serializes access.
+*/
+class ExecutionPlanCache {
+ public:
+  using Key = std::vector<int64_t>;
+
+  static constexpr size_t kDefaultCapacity = 32;
+
+  explicit ExecutionPlanCache(size_t capacity = kDefaultCapacity) : capacity_(capacity) {}
+
+  // Build the key for the given feed shapes. Rank is included so that e.g. {2, 3} and {2}, {3} don't collide.
+  static Key MakeKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes);
+
+  // Returns nullptr on a miss. A hit makes the entry the most recently used.
+  std::shared_ptr<const ExecutionPlanCacheEntry> Find(const Key& key);
+
+  // Add an entry, evicting the least recently used one if the cache is full.
+  // An existing entry for the key is kept as frames may already be using it.
+  void Insert(Key key, std::shared_ptr<const ExecutionPlanCacheEntry> entry);
+
+  void SetCapacity(size_t capacity);
+
+  size_t Size() const { return index_.size(); }
+
+  // Calls func with each key and entry, the most recently used first.
+  void ForEach(const std::function<void(const Key&, const ExecutionPlanCacheEntry&)>& func) const {
+    for (const auto& key_entry : lru_) {
+      func(key_entry.first, *key_entry.second);
+    }
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionPlanCache);
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      size_t hash = key.size();
+      for (auto v : key) {
+        hash ^= std::hash<int64_t>{}(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  using LruList = std::list<std::pair<Key, std::shared_ptr<const ExecutionPlanCacheEntry>>>;
+
+  void EvictToCapacity();
+
+  size_t capacity_;
+  // most recently used at the front
+  LruList lru_;
+  std::unordered_map<Key, LruList::iterator, KeyHash> index_;
+};
+
+}  // namespace onnxruntime
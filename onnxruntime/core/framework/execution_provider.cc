@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #include "core/framework/execution_provider.h"
 
+#include <algorithm>
+
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry_manager.h"
@@ -57,6 +59,18 @@ common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
 
 common::Status IExecutionProvider::OnSessionInitializationEnd() { return Status::OK(); }
 
+common::Status IExecutionProvider::BeginGraphCapture(uint64_t /*graph_key*/) {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
+common::Status IExecutionProvider::EndGraphCapture(uint64_t /*graph_key*/, bool /*discard*/) {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
+common::Status IExecutionProvider::ReplayGraph(uint64_t /*graph_key*/) {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
 // Update allocator in the provider if already present; ignore if not.
 void IExecutionProvider::ReplaceAllocator(AllocatorPtr allocator) {
   const auto& info = allocator->Info();
@@ -64,6 +78,9 @@ void IExecutionProvider::ReplaceAllocator(AllocatorPtr allocator) {
   if (ite != mem_info_set_.end()) {
     const int key = MakeKey(info.id, info.mem_type);
     allocators_[key] = allocator;
+    // keep GetAllocators() in sync, e.g. for the arena statistics of the session
+    std::replace_if(allocator_list_.begin(), allocator_list_.end(),
+                    [&info](const AllocatorPtr& alloc) { return alloc->Info() == info; }, allocator);
   }
 }
 
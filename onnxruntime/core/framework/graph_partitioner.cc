@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/framework/graph_partitioner.h"
+
+#include <fstream>
+
 #include "core/framework/kernel_registry_manager.h"
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
@@ -10,6 +13,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/framework/partition_cost_model.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -105,7 +109,74 @@ static Node* PlaceNode(Graph& graph, std::unique_ptr<IndexedSubGraph> capability
   return nullptr;
 }
 
+// Path of the node in the placement files of GraphPartitionerOptions.
+static std::string NodePath(const std::string& graph_path, const Node& node) {
+  return graph_path + (node.Name().empty() ? "#" + std::to_string(node.Index()) : node.Name());
+}
+
+static std::string SubgraphPath(const std::string& graph_path, const Node& node, const std::string& attribute_name) {
+  return NodePath(graph_path, node) + "/" + attribute_name + "/";
+}
+
+static Status LoadPlacement(const std::string& file_path, std::unordered_map<std::string, std::string>& placement) {
+  std::ifstream file(file_path);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the placement file ", file_path);
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    const auto separator = line.rfind('\t');
+    if (separator == std::string::npos) {
+      continue;
+    }
+    placement[line.substr(0, separator)] = line.substr(separator + 1);
+  }
+  return Status::OK();
+}
+
+static void WritePlacement(Graph& graph, const std::string& graph_path, std::ostream& file) {
+  for (auto& node : graph.Nodes()) {
+    file << NodePath(graph_path, node) << '\t' << node.GetExecutionProviderType() << '\n';
+    for (const auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+      WritePlacement(*entry.second, SubgraphPath(graph_path, node, entry.first), file);
+    }
+  }
+}
+
+static Status SavePlacement(Graph& graph, const std::string& file_path) {
+  std::ofstream file(file_path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the placement file ", file_path, " for writing");
+  }
+
+  WritePlacement(graph, std::string(), file);
+  file.flush();
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the placement file ", file_path);
+  }
+  return Status::OK();
+}
+
 Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const {
+  Placement placement;
+  if (!options_.load_placement_file.empty()) {
+    ORT_RETURN_IF_ERROR(LoadPlacement(options_.load_placement_file, placement));
+  }
+
+  ORT_RETURN_IF_ERROR(PartitionImpl(graph, export_dll, func_mgr, placement, std::string()));
+
+  if (!options_.save_placement_file.empty()) {
+    ORT_RETURN_IF_ERROR(SavePlacement(graph, options_.save_placement_file));
+  }
+  return Status::OK();
+}
+
+Status GraphPartitioner::PartitionImpl(Graph& graph, bool export_dll, FuncManager& func_mgr,
+                                       const Placement& placement, const std::string& graph_path) const {
   // It is a greedy partitioning algorithm per provider preferences user provided when calling ONNX RUNTIME right now.
   // 1. Execution providers' capabilities are checked one by one.
   // 2. All sub-graphs that an execution provider returns will be assigned to it if it's not assigned yet.
@@ -128,7 +199,8 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
     for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
       Graph* subgraph = entry.second;
       // we pass through the export_dll value and FuncManager from the top level graph
-      ORT_RETURN_IF_ERROR(Partition(*subgraph, export_dll, func_mgr));
+      ORT_RETURN_IF_ERROR(PartitionImpl(*subgraph, export_dll, func_mgr, placement,
+                                        SubgraphPath(graph_path, node, entry.first)));
     }
   }
 
@@ -145,6 +217,21 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // There are two mode of compile, one is return the entry point to the compiled binary
   // directly, another is export the compiled binary to shared library for future reuse.
 
+  // Nodes of a loaded placement are assigned first, so the providers' capabilities can't claim them.
+  // The cost model doesn't move them either.
+  std::unordered_set<NodeIndex> fixed_nodes;
+  if (!placement.empty()) {
+    for (auto& node : graph.Nodes()) {
+      auto entry = placement.find(NodePath(graph_path, node));
+      if (entry != placement.end() && node.GetExecutionProviderType().empty() &&
+          providers_.Get(entry->second) != nullptr &&
+          KernelRegistryManager::HasImplementationOf(kernel_registry_mgr_, node, entry->second)) {
+        node.SetExecutionProviderType(entry->second);
+        fixed_nodes.insert(node.Index());
+      }
+    }
+  }
+
   // TODO: when the graph contain a function node, and user pass in the dll which could
   // run the function by SessionOption, we should create a function kernel for it and
   // delegate the compute to the functions inside the dlls.
@@ -186,6 +273,10 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
     }
   }
 
+  if (options_.use_cost_model) {
+    ApplyPartitionCostModel(graph, kernel_registry_mgr_, fixed_nodes);
+  }
+
   ORT_RETURN_IF_ERROR(graph.Resolve());
 
   // To see if the node with no provider can be inlined. If one such nodes can be
@@ -210,7 +301,7 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // Resolve and rerun graph partition
   if (!nodes_need_inline.empty()) {
     ORT_RETURN_IF_ERROR(graph.Resolve());
-    ORT_RETURN_IF_ERROR(Partition(graph, export_dll, func_mgr));
+    ORT_RETURN_IF_ERROR(PartitionImpl(graph, export_dll, func_mgr, placement, graph_path));
   }
 
   //For some cases, like fp16 on cpu, right now we don't have any kernel support that.
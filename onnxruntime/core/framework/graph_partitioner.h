@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+
 #include "core/common/common.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/op_kernel.h"
@@ -13,6 +16,20 @@ namespace onnxruntime {
 class ExecutionProviders;
 class KernelRegistryManager;
 
+struct GraphPartitionerOptions {
+  // Move nodes next to the splits between the execution providers to the CPU execution provider where the copies
+  // between the devices are estimated to cost more than running the nodes on the CPU. See partition_cost_model.h.
+  bool use_cost_model = false;
+  // File with the placement of a previous partitioning, which is applied before the greedy partitioning.
+  // Every line is the path of a node and its provider type separated by a tab. The path of a node is its name, or
+  // '#' and its index if it has no name, prefixed by the path of the node and the attribute of the nested graphs
+  // containing it, e.g. "loop_0/body/add_1".
+  // Nodes that aren't in the graph, or whose provider isn't registered or has no kernel for them, are ignored.
+  std::string load_placement_file;
+  // File the placement is written to after the partitioning, in the format of load_placement_file.
+  std::string save_placement_file;
+};
+
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
@@ -20,12 +37,24 @@ class GraphPartitioner {
       : kernel_registry_mgr_(kernel_registry_mgr),
         providers_(providers) {}
 
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   const GraphPartitionerOptions& options)
+      : kernel_registry_mgr_(kernel_registry_mgr),
+        providers_(providers),
+        options_(options) {}
+
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphPartitioner);
 
+  using Placement = std::unordered_map<std::string, std::string>;
+
+  Status PartitionImpl(Graph& graph, bool export_dll, FuncManager& func_mgr, const Placement& placement,
+                       const std::string& graph_path) const;
+
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  GraphPartitionerOptions options_;
 };
 }  // namespace onnxruntime
@@ -220,6 +220,28 @@ Status KernelRegistry::TryCreateKernel(const onnxruntime::Node& node,
   return Status::OK();
 }
 
+std::string KernelRegistry::GetNodeSignatureKey(const onnxruntime::Node& node, const std::string& provider) {
+  std::string key = GetMapKey(node.OpType(), node.Domain(), provider);
+  key.append(1, ' ').append(std::to_string(node.SinceVersion()));
+
+  // the arg counts delimit the variadic inputs
+  for (int arg_count : node.InputArgCount()) {
+    key.append(1, ' ').append(std::to_string(arg_count));
+  }
+
+  auto append_defs = [&key](const ConstPointerContainer<std::vector<NodeArg*>>& defs) {
+    key.append(1, '|');
+    for (const NodeArg* def : defs) {
+      const auto* type = def->Exists() ? def->Type() : nullptr;
+      key.append(1, ' ').append(type != nullptr ? *type : std::string());
+    }
+  };
+
+  append_defs(node.InputDefs());
+  append_defs(node.OutputDefs());
+  return key;
+}
+
 static std::string ToString(const std::vector<std::string>& error_strs) {
   std::ostringstream ostr;
   std::for_each(std::begin(error_strs), std::end(error_strs),
@@ -246,14 +268,15 @@ Status KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
   const auto& node_provider = node.GetExecutionProviderType();
   const auto& expected_provider = (node_provider.empty() ? exec_provider : node_provider);
 
-  auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
   *out = nullptr;
 
   // if we have a hash (ORT format model) use only that.
   if (kernel_def_hash != 0) {
-    for (auto i = range.first; i != range.second; ++i) {
-      if (i->second.kernel_def->GetHash() == kernel_def_hash) {
-        *out = &i->second;
+    auto entry = kernel_def_hash_lookup_.find(kernel_def_hash);
+    if (entry != kernel_def_hash_lookup_.end()) {
+      const KernelDef& kernel_def = *entry->second->kernel_def;
+      if (kernel_def.OpName() == node.OpType() && kernel_def.Provider() == expected_provider) {
+        *out = entry->second;
         return Status::OK();
       }
     }
@@ -268,12 +291,25 @@ Status KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
   }
 #if !defined(ORT_MINIMAL_BUILD)
   else {
+    const std::string signature_key = GetNodeSignatureKey(node, expected_provider);
+    {
+      std::lock_guard<OrtMutex> lock(node_signature_lookup_mutex_);
+      auto entry = node_signature_lookup_.find(signature_key);
+      if (entry != node_signature_lookup_.end()) {
+        *out = entry->second;
+        return Status::OK();
+      }
+    }
+
     std::vector<std::string> verify_kernel_def_error_strs;
 
+    auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
     for (auto i = range.first; i != range.second; ++i) {
       std::string error_str;
       if (VerifyKernelDef(node, *i->second.kernel_def, error_str)) {
         *out = &i->second;
+        std::lock_guard<OrtMutex> lock(node_signature_lookup_mutex_);
+        node_signature_lookup_.emplace(signature_key, *out);
         return Status::OK();
       }
       verify_kernel_def_error_strs.push_back(error_str);
@@ -319,7 +355,15 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
 
   // Register the kernel.
   // Ownership of the KernelDef is transferred to the map.
-  kernel_creator_fn_map_.emplace(key, std::move(create_info));
+  auto entry = kernel_creator_fn_map_.emplace(key, std::move(create_info));
+  kernel_def_hash_lookup_.emplace(entry->second.kernel_def->GetHash(), &entry->second);
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // a new kernel may match nodes that were matched to another kernel before
+  std::lock_guard<OrtMutex> lock(node_signature_lookup_mutex_);
+  node_signature_lookup_.clear();
+#endif
+
   return Status::OK();
 }
 
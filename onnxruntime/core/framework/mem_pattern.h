@@ -53,6 +53,9 @@ class MemoryPattern {
 struct MemoryPatternGroup {
   std::vector<OrtMemoryInfo> locations;
   std::vector<MemoryPattern> patterns;
+  // peak size of the kernels' temp space per location, carved from the end of the pattern's buffer.
+  // indexed the same way as locations. empty if unknown, e.g. for the patterns planned from the symbolic shapes.
+  std::vector<size_t> scratch_sizes;
 
   const MemoryPattern* GetPatterns(const OrtMemoryInfo& location) const {
     for (size_t i = 0; i < locations.size(); i++)
@@ -16,6 +16,8 @@ limitations under the License.
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+#include <limits>
 #include <list>
 #include "core/common/safeint.h"
 #include "core/framework/mem_pattern.h"
@@ -26,6 +28,8 @@ namespace onnxruntime {
 // MemPatternPlanner is used to trace allocation/free steps
 // in a single iteration, record the pattern and cached for
 // future request if they have the same input shape.
+// The offsets are either assigned as the allocations are traced, or
+// computed once all the lifetimes are known (GenerateBestFitMemPattern).
 // Thread-safe.
 class MemPatternPlanner {
  public:
@@ -34,8 +38,9 @@ class MemPatternPlanner {
   void TraceAllocation(int ml_value_idx, size_t size) {
     std::lock_guard<OrtMutex> lock(lock_);
 
+    const size_t step = step_++;
     if (size == 0) {
-      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0));
+      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0), step);
       return;
     }
 
@@ -63,7 +68,7 @@ class MemPatternPlanner {
     // we only need to bounds check the addition of size to best_offset as that is the only time we extend
     // the maximum size of the buffer.
     buffer_size_ = std::max(buffer_size_, SafeInt<size_t>(best_offset) + size);
-    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size));
+    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size), step);
     blocks_.insert(best_fit_it, (static_cast<int>(allocs_.size()) - 1));
   }
 
@@ -72,6 +77,7 @@ class MemPatternPlanner {
 
     for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
       if (allocs_[*it].index_ == ml_value_index) {
+        allocs_[*it].free_step_ = step_++;
         blocks_.erase(it);
         break;
       }
@@ -80,11 +86,81 @@ class MemPatternPlanner {
 
   MemoryPattern GenerateMemPattern() const {
     std::lock_guard<OrtMutex> lock(lock_);
+    return GenerateTracedMemPattern();
+  }
+
+  // Assign the offsets using the lifetimes of all the traced blocks: the blocks are placed from the largest to the
+  // smallest, each in the smallest gap left by the already placed blocks it is alive together with. This usually
+  // packs tighter than assigning the offsets in allocation order. Falls back to the traced offsets otherwise.
+  MemoryPattern GenerateBestFitMemPattern() const {
+    std::lock_guard<OrtMutex> lock(lock_);
+
+    std::vector<size_t> order;
+    order.reserve(allocs_.size());
+    for (size_t i = 0; i < allocs_.size(); ++i) {
+      if (allocs_[i].block_.size_ > 0) {
+        order.push_back(i);
+      }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+      return allocs_[lhs].block_.size_ > allocs_[rhs].block_.size_;
+    });
+
+    std::vector<MemoryBlock> blocks(allocs_.size());
+    // placed blocks, sorted in order of their offset
+    std::list<size_t> placed;
+    SafeInt<size_t> buffer_size{0};
+    for (size_t i : order) {
+      const auto& alloc = allocs_[i];
+      const size_t size = alloc.block_.size_;
+
+      size_t current = 0;
+      size_t waste_bytes = std::numeric_limits<size_t>::max();
+      bool found_gap = false;
+      size_t best_offset = 0;
+      for (auto it = placed.begin(); it != placed.end(); ++it) {
+        const auto& other = allocs_[*it];
+        if (!alloc.OverlapsWith(other)) {
+          continue;
+        }
+
+        const auto& other_block = blocks[*it];
+        if (other_block.offset_ >= current) {
+          auto gap = other_block.offset_ - current;
+          if (gap >= size && (gap - size) < waste_bytes) {
+            found_gap = true;
+            waste_bytes = gap - size;
+            best_offset = current;
+          }
+        }
+        current = std::max(current, other_block.offset_ + other_block.size_);
+      }
+
+      if (!found_gap) {
+        best_offset = current;
+      }
+
+      auto best_fit_it = placed.begin();
+      for (; best_fit_it != placed.end(); ++best_fit_it) {
+        if (blocks[*best_fit_it].offset_ > best_offset) {
+          break;
+        }
+      }
+
+      buffer_size = std::max(buffer_size, SafeInt<size_t>(best_offset) + size);
+      blocks[i] = MemoryBlock(best_offset, size);
+      placed.insert(best_fit_it, i);
+    }
+
+    if (buffer_size >= buffer_size_) {
+      return GenerateTracedMemPattern();
+    }
 
     MemoryPattern pattern;
-    pattern.peak_size_ = buffer_size_;
-    for (auto& alloc : allocs_) {
-      pattern.patterns_[alloc.index_] = alloc.block_;
+    pattern.peak_size_ = buffer_size;
+    for (size_t i = 0; i < allocs_.size(); ++i) {
+      pattern.patterns_[allocs_[i].index_] = blocks[i];
     }
 
     return pattern;
@@ -94,15 +170,35 @@ class MemPatternPlanner {
   struct OrtValueAllocationBlock {
     int index_{-1};
     MemoryBlock block_;
+    // the block is in use from the allocation step up to, but not including, the free step
+    size_t alloc_step_{0};
+    size_t free_step_{std::numeric_limits<size_t>::max()};
 
     OrtValueAllocationBlock() = default;
-    OrtValueAllocationBlock(int index, const MemoryBlock& block) : index_(index), block_(block) {}
+    OrtValueAllocationBlock(int index, const MemoryBlock& block, size_t alloc_step)
+        : index_(index), block_(block), alloc_step_(alloc_step) {}
+
+    bool OverlapsWith(const OrtValueAllocationBlock& other) const {
+      return alloc_step_ < other.free_step_ && other.alloc_step_ < free_step_;
+    }
   };
 
+  MemoryPattern GenerateTracedMemPattern() const {
+    MemoryPattern pattern;
+    pattern.peak_size_ = buffer_size_;
+    for (auto& alloc : allocs_) {
+      pattern.patterns_[alloc.index_] = alloc.block_;
+    }
+
+    return pattern;
+  }
+
   std::vector<OrtValueAllocationBlock> allocs_;
   // blocks_ the list of currently allocated memory blocks, sorted in order of their offset
   std::list<int> blocks_;
   SafeInt<size_t> buffer_size_{0};
+  // counts the traced allocations and frees
+  size_t step_{0};
   mutable OrtMutex lock_;
 };
 
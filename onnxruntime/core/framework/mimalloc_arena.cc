@@ -2,18 +2,79 @@
 #include "mimalloc.h"
 #include "core/framework/mimalloc_arena.h"
 
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "core/mlas/inc/mlas.h"
+
 namespace onnxruntime {
+static uint64_t NextMiMallocArenaId() noexcept {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
 MiMallocArena::MiMallocArena(std::unique_ptr<IAllocator> resource_allocator,
                              size_t total_memory)
-    : info_(resource_allocator->Info().name, OrtAllocatorType::OrtArenaAllocator, resource_allocator->Info().device, resource_allocator->Info().id, resource_allocator->Info().mem_type) {
+    : IArenaAllocator(OrtMemoryInfo(resource_allocator->Info().name,
+                                    OrtAllocatorType::OrtArenaAllocator,
+                                    resource_allocator->Info().device,
+                                    resource_allocator->Info().id,
+                                    resource_allocator->Info().mem_type)),
+      id_{NextMiMallocArenaId()},
+      alive_{std::make_shared<int>(0)},
+      alignment_{MlasGetPreferredBufferAlignment()} {
   stats_.bytes_limit = total_memory;
 }
 
+mi_heap_t* MiMallocArena::ThreadHeap() {
+  struct ThreadHeapEntry {
+    uint64_t arena_id;
+    std::weak_ptr<void> arena_alive;
+    mi_heap_t* heap;
+  };
+
+  // a mimalloc heap can only allocate from the thread that created it, and mimalloc deletes the heaps of a thread
+  // when it exits
+  thread_local std::vector<ThreadHeapEntry> thread_heaps;
+
+  for (const auto& entry : thread_heaps) {
+    if (entry.arena_id == id_) {
+      return entry.heap;
+    }
+  }
+
+  // the heaps of deleted arenas are dropped when the thread creates its next heap. mi_heap_delete moves the blocks
+  // still in use, e.g. outputs the caller holds on to, to the default heap of the thread
+  thread_heaps.erase(std::remove_if(thread_heaps.begin(), thread_heaps.end(),
+                                    [](const ThreadHeapEntry& entry) {
+                                      if (!entry.arena_alive.expired()) {
+                                        return false;
+                                      }
+                                      mi_heap_delete(entry.heap);
+                                      return true;
+                                    }),
+                     thread_heaps.end());
+
+  mi_heap_t* heap = mi_heap_new();
+  if (heap == nullptr) {
+    ORT_THROW_EX(std::bad_alloc);
+  }
+
+  thread_heaps.push_back(ThreadHeapEntry{id_, alive_, heap});
+  return heap;
+}
+
 void* MiMallocArena::Alloc(size_t size) {
 #if (MI_STAT > 1)
   stats_.num_allocs++;
 #endif
-  return mi_malloc(size);
+  void* p = mi_heap_malloc_aligned(ThreadHeap(), size, alignment_);
+  if (p == nullptr) {
+    ORT_THROW_EX(std::bad_alloc);
+  }
+  return p;
 }
 
 void MiMallocArena::Free(void* p) {
@@ -21,7 +82,9 @@ void MiMallocArena::Free(void* p) {
 }
 
 void* MiMallocArena::Reserve(size_t size) {
-  return mi_malloc(size);
+  // reserved buffers, e.g. the initializers, live as long as the session, so keep them out of the heaps of the
+  // threads
+  return mi_malloc_aligned(size, alignment_);
 }
 
 // mimalloc only maintains stats when compiled under debug (which in turn sets MI_STAT)
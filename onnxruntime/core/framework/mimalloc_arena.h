@@ -1,9 +1,17 @@
 #if defined(USE_MIMALLOC_ARENA_ALLOCATOR)
+#include <memory>
+
 #include "core/common/common.h"
 #include "core/framework/arena.h"
 #include "onnxruntime_config.h"
 
+struct mi_heap_s;
+
 namespace onnxruntime {
+// An arena that allocates from a mimalloc heap of the calling thread, so the intra-op threads and the threads
+// running the sessions allocate the scratch buffers of the kernels without taking a lock, unlike the global mutex
+// of the BFCArena. A block can be freed by any thread, mimalloc returns it to the heap it came from lock free.
+// Each arena has heaps of its own, so the memory of a session isn't mixed with the other mimalloc allocations.
 class MiMallocArena : public IArenaAllocator {
  public:
   MiMallocArena(std::unique_ptr<IAllocator> resource_allocator, size_t total_memory);
@@ -13,7 +21,7 @@ class MiMallocArena : public IArenaAllocator {
   void Free(void* p) override;
 
   // mimalloc only maintains stats when compiled under debug, or when MI_STAT >= 2
-  void GetStats(AllocatorStats* stats);
+  void GetStats(AllocatorStats* stats) override;
 
   void* Reserve(size_t size) override;
 
@@ -23,14 +31,19 @@ class MiMallocArena : public IArenaAllocator {
     return stats_.bytes_limit;
   }
 
-  const OrtMemoryInfo& Info() const override {
-    return info_;
-  }
-
   size_t AllocatedSize(const void* ptr);
 
-  OrtMemoryInfo info_;
   AllocatorStats stats_;
+
+ private:
+  // the heap of the calling thread for this arena, which is created by its first allocation
+  mi_heap_s* ThreadHeap();
+
+  // identifies the arena in the thread local lists of heaps, as a new arena may reuse the address of a deleted one
+  const uint64_t id_;
+  // only referenced by the arena, the threads holding a heap for a deleted arena see it expire
+  std::shared_ptr<void> alive_;
+  const size_t alignment_;
 };
 }  // namespace onnxruntime
 #endif
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_cost_model.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+NodeCostModel::NodeCostModel(const GraphViewer& graph_viewer, size_t num_warmup_runs)
+    : graph_viewer_(graph_viewer),
+      num_warmup_runs_(num_warmup_runs),
+      node_durations_(graph_viewer.MaxNodeIndex()) {
+}
+
+void NodeCostModel::EndRun() {
+  if (runs_completed_.fetch_add(1, std::memory_order_acq_rel) + 1 != num_warmup_runs_) {
+    return;
+  }
+
+  const size_t num_nodes = node_durations_.size();
+  costs_ns_.assign(num_nodes, 0);
+  priorities_ns_.assign(num_nodes, 0);
+
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const uint64_t count = node_durations_[i].count.load(std::memory_order_relaxed);
+    if (count > 0) {
+      costs_ns_[i] = static_cast<int64_t>(node_durations_[i].sum_ns.load(std::memory_order_relaxed) / count);
+    }
+  }
+
+  // the successors of a node come after it in the topological order
+  const auto& order = graph_viewer_.GetNodesInTopologicalOrder();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const Node* node = graph_viewer_.GetNode(*it);
+    int64_t successor_priority = 0;
+    for (auto output = node->OutputNodesBegin(), end = node->OutputNodesEnd(); output != end; ++output) {
+      successor_priority = std::max(successor_priority, priorities_ns_[output->Index()]);
+    }
+
+    priorities_ns_[*it] = costs_ns_[*it] + successor_priority;
+  }
+
+  has_estimates_.store(true, std::memory_order_release);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+class GraphViewer;
+
+/**
+Per-node cost estimates used by the ParallelExecutor to schedule the ready nodes.
+The kernel execution time of every node is measured in the first num_warmup_runs Runs. After that the mean is the
+cost of the node, and the priority of a node is the cost of the most expensive path from it to the end of the graph,
+so running the ready node with the highest priority first follows the critical path.
+*/
+class NodeCostModel {
+ public:
+  NodeCostModel(const GraphViewer& graph_viewer, size_t num_warmup_runs);
+
+  /** Returns true if the kernel execution times of the Run starting now should be recorded. */
+  bool StartRun() noexcept {
+    return !HasEstimates() && runs_started_.fetch_add(1, std::memory_order_relaxed) < num_warmup_runs_;
+  }
+
+  void RecordNode(NodeIndex node_index, std::chrono::nanoseconds duration) noexcept {
+    if (node_index < node_durations_.size()) {
+      auto& node_duration = node_durations_[node_index];
+      node_duration.sum_ns.fetch_add(static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+      node_duration.count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /** Called at the end of a Run that StartRun returned true for. The estimates are computed after the last one. */
+  void EndRun();
+
+  /** Returns true once the costs and priorities are available. */
+  bool HasEstimates() const noexcept { return has_estimates_.load(std::memory_order_acquire); }
+
+  /** Estimated kernel execution time of the node. Requires HasEstimates(). */
+  int64_t CostNs(NodeIndex node_index) const { return costs_ns_[node_index]; }
+
+  /** Estimated execution time of the longest path from the node to the end of the graph. Requires HasEstimates(). */
+  int64_t PriorityNs(NodeIndex node_index) const { return priorities_ns_[node_index]; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeCostModel);
+
+  struct NodeDuration {
+    std::atomic<uint64_t> sum_ns{0};
+    std::atomic<uint64_t> count{0};
+  };
+
+  const GraphViewer& graph_viewer_;
+  const size_t num_warmup_runs_;
+  std::atomic<size_t> runs_started_{0};
+  std::atomic<size_t> runs_completed_{0};
+  std::vector<NodeDuration> node_durations_;
+
+  // written once before has_estimates_ is set
+  std::vector<int64_t> costs_ns_;
+  std::vector<int64_t> priorities_ns_;
+  std::atomic<bool> has_estimates_{false};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_result_cache.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <unordered_set>
+
+#include "core/framework/murmurhash3.h"
+#include "core/framework/session_state.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+// Hashes the bytes into the 128-bit hash, in chunks as MurmurHash3 takes an int length.
+void HashBytes(const void* data, size_t size, uint64_t hash[2]) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  do {
+    const size_t chunk = std::min(size, static_cast<size_t>(INT_MAX));
+    uint64_t chunk_hash[2];
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk), static_cast<uint32_t>(hash[0] ^ hash[1]), chunk_hash);
+    hash[0] ^= chunk_hash[0];
+    hash[1] = hash[1] * 31 + chunk_hash[1];
+    bytes += chunk;
+    size -= chunk;
+  } while (size > 0);
+}
+}  // namespace
+
+common::Status NodeResultCache::Create(const SessionState& session_state,
+                                       const std::vector<std::string>& sticky_inputs,
+                                       const std::function<bool(const Node&)>& is_deterministic,
+                                       std::unique_ptr<NodeResultCache>& cache) {
+  cache.reset();
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& alloc_plan = session_state.GetExecutionPlan()->allocation_plan;
+  const auto& constant_initializers = session_state.GetConstantInitializedTensors();
+
+  std::unique_ptr<NodeResultCache> result(new NodeResultCache());
+  // the values computed from the sticky inputs, and the constant initializers
+  std::unordered_set<int> sticky_values;
+  for (const auto& name : sticky_inputs) {
+    const auto& inputs = graph_viewer.GetInputs();
+    if (std::none_of(inputs.cbegin(), inputs.cend(), [&name](const NodeArg* input) { return input->Name() == name; })) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Sticky input ", name, " isn't an input of the graph.");
+    }
+
+    int idx;
+    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(name, idx));
+    if (sticky_values.insert(idx).second) {
+      result->sticky_input_idxs_.push_back(idx);
+    }
+  }
+
+  auto is_sticky_or_constant = [&](const NodeArg& arg) {
+    int idx;
+    return !arg.Exists() || (name_idx_map.GetIdx(arg.Name(), idx).IsOK() &&
+                             (sticky_values.count(idx) > 0 || constant_initializers.count(idx) > 0));
+  };
+
+  for (const auto& node_exec_plan : session_state.GetExecutionPlan()->execution_plan) {
+    const auto* node = graph_viewer.GetNode(node_exec_plan.node_index);
+    if (node == nullptr || node->GetExecutionProviderType() != kCpuExecutionProvider || node->ContainsSubgraph() ||
+        !node->ImplicitInputDefs().empty() || !is_deterministic(*node)) {
+      continue;
+    }
+
+    // a node of only constant inputs is left to the constant folding
+    bool has_sticky_input = false;
+    bool all_sticky_or_constant = true;
+    for (const auto* input : node->InputDefs()) {
+      int idx;
+      all_sticky_or_constant = all_sticky_or_constant && is_sticky_or_constant(*input);
+      has_sticky_input = has_sticky_input || (input->Exists() && name_idx_map.GetIdx(input->Name(), idx).IsOK() &&
+                                              sticky_values.count(idx) > 0);
+    }
+    if (!all_sticky_or_constant || !has_sticky_input) {
+      continue;
+    }
+
+    // the cached outputs replace the values of the frame, so they must be tensors the frame would allocate or reuse
+    // a buffer for, not views into the buffer of another value
+    std::vector<int> output_idxs;
+    bool can_cache_outputs = true;
+    for (const auto* output : node->OutputDefs()) {
+      int idx = -1;
+      if (output->Exists()) {
+        ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(output->Name(), idx));
+        const auto& plan = alloc_plan[idx];
+        can_cache_outputs = can_cache_outputs && plan.value_type != nullptr && plan.value_type->IsTensorType() &&
+                            (plan.alloc_kind == AllocKind::kAllocate || plan.alloc_kind == AllocKind::kReuse);
+      }
+      output_idxs.push_back(idx);
+    }
+    if (!can_cache_outputs) {
+      continue;
+    }
+
+    for (int idx : output_idxs) {
+      if (idx >= 0) {
+        sticky_values.insert(idx);
+      }
+    }
+    result->memoized_nodes_.emplace(node->Index(), std::move(output_idxs));
+  }
+
+  // The values reusing the buffer of a memoized output would write into the cached result if that output is replaced
+  // with it. The nodes consuming the outputs of the nodes left out are still memoized, as their inputs only depend on
+  // the sticky inputs.
+  std::unordered_set<int> reused_buffers;
+  for (const auto& plan : alloc_plan) {
+    if (plan.alloc_kind == AllocKind::kReuse || plan.alloc_kind == AllocKind::kShare ||
+        plan.alloc_kind == AllocKind::kAlias || plan.alloc_kind == AllocKind::kSlice) {
+      reused_buffers.insert(plan.reused_buffer);
+    }
+  }
+  for (auto it = result->memoized_nodes_.begin(); it != result->memoized_nodes_.end();) {
+    if (std::any_of(it->second.cbegin(), it->second.cend(),
+                    [&reused_buffers](int idx) { return reused_buffers.count(idx) > 0; })) {
+      it = result->memoized_nodes_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (result->memoized_nodes_.empty()) {
+    return Status::OK();
+  }
+
+  result->allocator_ = session_state.GetAllocator(OrtDevice());
+  ORT_RETURN_IF_NOT(result->allocator_ != nullptr, "No CPU allocator for the memoized results.");
+  cache = std::move(result);
+  return Status::OK();
+}
+
+bool NodeResultCache::GetKey(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                             Key& key) const {
+  key.clear();
+  for (int idx : sticky_input_idxs_) {
+    auto it = std::find(feed_mlvalue_idxs.cbegin(), feed_mlvalue_idxs.cend(), idx);
+    if (it == feed_mlvalue_idxs.cend()) {
+      return false;
+    }
+
+    const OrtValue& feed = feeds[it - feed_mlvalue_idxs.cbegin()];
+    if (!feed.IsTensor() || feed.Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+      return false;
+    }
+
+    // the contents are hashed rather than compared by address, as callers refill their input buffers between Runs
+    const Tensor& tensor = feed.Get<Tensor>();
+    uint64_t hash[2] = {0, 0};
+    const auto& dims = tensor.Shape().GetDims();
+    HashBytes(dims.data(), dims.size() * sizeof(int64_t), hash);
+    if (tensor.IsDataTypeString()) {
+      for (const auto& str : tensor.DataAsSpan<std::string>()) {
+        const size_t length = str.size();
+        HashBytes(&length, sizeof(length), hash);
+        HashBytes(str.data(), str.size(), hash);
+      }
+    } else {
+      HashBytes(tensor.DataRaw(), tensor.SizeInBytes(), hash);
+    }
+
+    key.push_back(reinterpret_cast<uintptr_t>(tensor.DataType()));
+    key.push_back(hash[0]);
+    key.push_back(hash[1]);
+  }
+
+  return true;
+}
+
+std::shared_ptr<const NodeResultCache::Results> NodeResultCache::Lookup(const Key& key) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return results_ != nullptr && key_ == key ? results_ : nullptr;
+}
+
+void NodeResultCache::Store(const Key& key, Results&& results) {
+  if (results.empty()) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (results_ != nullptr && key_ == key) {
+    // the results of the nodes the earlier Runs didn't execute, e.g. with other fetches
+    auto merged = std::make_shared<Results>(*results_);
+    merged->insert(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+    results_ = std::move(merged);
+  } else {
+    key_ = key;
+    results_ = std::make_shared<Results>(std::move(results));
+  }
+}
+
+common::Status NodeResultCache::CopyResult(const OrtValue& value, OrtValue& copy) const {
+  if (!value.IsAllocated()) {
+    copy = OrtValue();
+    return Status::OK();
+  }
+
+  const Tensor& src = value.Get<Tensor>();
+  ORT_RETURN_IF_NOT(src.Location().device.Type() == OrtDevice::CPU, "Memoized results must be on the CPU.");
+  auto dst = onnxruntime::make_unique<Tensor>(src.DataType(), src.Shape(), allocator_);
+  if (src.IsDataTypeString()) {
+    auto src_span = src.DataAsSpan<std::string>();
+    std::copy(src_span.cbegin(), src_span.cend(), dst->MutableData<std::string>());
+  } else {
+    memcpy(dst->MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+  }
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  copy.Init(dst.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class Node;
+class SessionState;
+
+/**
+Memoizes the outputs of the nodes that only depend on the "sticky" graph inputs, see
+kOrtSessionOptionsConfigStickyInputs, so a Run whose sticky inputs have the same contents as in an earlier Run uses
+the outputs that Run computed instead of executing the nodes again.
+The results of a single set of sticky input values are kept. They are copied out of the execution frame, as the
+memory planner reuses the buffers of the frame, and are immutable once cached so concurrent Runs can share them.
+*/
+class NodeResultCache {
+ public:
+  // The contents of the sticky inputs of a Run.
+  using Key = std::vector<uint64_t>;
+  // The outputs of the memoized nodes, in the order of the node's output definitions.
+  using Results = std::unordered_map<NodeIndex, std::vector<OrtValue>>;
+
+  /**
+  Selects the nodes to memoize: the deterministic CPU nodes without subgraphs whose inputs are the sticky inputs,
+  constant initializers or the outputs of other memoized nodes. The nodes whose output buffers the allocation plan
+  lets other values reuse are left out, as the cached results must not be overwritten.
+  @param session_state The finalized SessionState of the main graph.
+  @param sticky_inputs The names of the sticky graph inputs.
+  @param is_deterministic Returns true if the node computes the same outputs from the same inputs.
+  @param cache Set to the cache, or nullptr if no node can be memoized.
+  */
+  static common::Status Create(const SessionState& session_state, const std::vector<std::string>& sticky_inputs,
+                               const std::function<bool(const Node&)>& is_deterministic,
+                               std::unique_ptr<NodeResultCache>& cache) ORT_MUST_USE_RESULT;
+
+  /** Computes the key of the feeds of a Run. Returns false if a sticky input isn't fed as a CPU tensor. */
+  bool GetKey(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds, Key& key) const;
+
+  /** The results cached for the key, or nullptr if the cached results are for other sticky input values. */
+  std::shared_ptr<const Results> Lookup(const Key& key) const;
+
+  /** Adds the results a Run computed for the key, replacing the results cached for other sticky input values. */
+  void Store(const Key& key, Results&& results);
+
+  /** The OrtValue indexes of the outputs of the node if it's memoized, else nullptr. -1 for a missing output. */
+  const std::vector<int>* GetMemoizedOutputs(NodeIndex node_index) const {
+    auto it = memoized_nodes_.find(node_index);
+    return it != memoized_nodes_.end() ? &it->second : nullptr;
+  }
+
+  /** Copies an output of a memoized node out of the execution frame into a buffer of its own. */
+  common::Status CopyResult(const OrtValue& value, OrtValue& copy) const ORT_MUST_USE_RESULT;
+
+ private:
+  NodeResultCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeResultCache);
+
+  std::vector<int> sticky_input_idxs_;
+  AllocatorPtr allocator_;
+  std::unordered_map<NodeIndex, std::vector<int>> memoized_nodes_;
+
+  mutable OrtMutex mutex_;
+  Key key_;
+  std::shared_ptr<const Results> results_;
+};
+
+}  // namespace onnxruntime
@@ -26,7 +26,8 @@ Tensor* OpKernelContext::Output(int index, const TensorShape& shape) {
 }
 
 Tensor* OpKernelContext::Output(int index, const std::vector<int64_t>& shape) {
-  return Output(index, TensorShape(shape));
+  // view the dims as a TensorShape instead of copying them, the Tensor makes the only copy it needs
+  return Output(index, TensorShape::ReinterpretBaseType(shape));
 }
 
 Tensor* OpKernelContext::Output(int index, const std::initializer_list<int64_t>& shape) {
@@ -72,7 +73,7 @@ int OpKernelContext::NumVariadicInputs(size_t arg_num) const {
 }
 
 Status OpKernelContext::GetTempSpaceAllocator(AllocatorPtr* output) const {
-  *output = execution_frame_->GetAllocator(kernel_->Allocator(0, OrtMemTypeDefault));
+  *output = execution_frame_->GetTempSpaceAllocator(kernel_->Allocator(0, OrtMemTypeDefault));
   if (!*output)
     return Status(common::ONNXRUNTIME, common::FAIL, "TempSpace allocator not found");
   return Status::OK();
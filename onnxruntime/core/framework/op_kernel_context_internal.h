@@ -21,10 +21,14 @@ class OpKernelContextInternal : public OpKernelContext {
                                    IExecutionFrame& frame,
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
-                                   const bool& terminate_flag)
+                                   const bool& terminate_flag,
+                                   const std::string& stream_id,
+                                   bool end_of_stream)
       : OpKernelContext(&frame, &kernel, session_state.GetThreadPool(), logger),
         session_state_(session_state),
-        terminate_flag_(terminate_flag) {
+        terminate_flag_(terminate_flag),
+        stream_id_(stream_id),
+        end_of_stream_(end_of_stream) {
     const auto& implicit_inputs = kernel.Node().ImplicitInputDefs();
     int num_implicit_inputs = static_cast<int>(implicit_inputs.size());
     implicit_input_values_.reserve(num_implicit_inputs);
@@ -64,9 +68,15 @@ class OpKernelContextInternal : public OpKernelContext {
 
   const bool& GetTerminateFlag() const noexcept { return terminate_flag_; }
 
+  // The stream of the Run, empty if the Run has none. See RunOptions::stream_id.
+  const std::string& GetStreamId() const noexcept { return stream_id_; }
+  bool IsEndOfStream() const noexcept { return end_of_stream_; }
+
  private:
   const SessionState& session_state_;
   const bool& terminate_flag_;
+  const std::string& stream_id_;
+  const bool end_of_stream_;
   std::vector<const OrtValue*> implicit_input_values_;
 };
 
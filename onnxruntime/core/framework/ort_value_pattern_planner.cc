@@ -35,12 +35,12 @@ common::Status OrtValuePatternPlanner::TraceFree(int ort_value_index) {
   return common::Status::OK();
 }
 
-common::Status OrtValuePatternPlanner::GeneratePatterns(MemoryPatternGroup* out) {
+common::Status OrtValuePatternPlanner::GeneratePatterns(MemoryPatternGroup* out, bool use_best_fit) {
   if (!out) return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT);
 
   for (auto& it : planner_map_) {
     out->locations.push_back(it.first);
-    out->patterns.push_back(it.second->GenerateMemPattern());
+    out->patterns.push_back(use_best_fit ? it.second->GenerateBestFitMemPattern() : it.second->GenerateMemPattern());
   }
 
   return common::Status::OK();
@@ -21,7 +21,9 @@ class OrtValuePatternPlanner {
   explicit OrtValuePatternPlanner(const ExecutionPlanBase& execution_plan);
   common::Status TraceAllocation(int ort_value_idx, size_t size);
   common::Status TraceFree(int ort_value_index);
-  common::Status GeneratePatterns(MemoryPatternGroup* out);
+  // If use_best_fit is true the offsets are computed from the lifetimes of all the traced values instead of being
+  // assigned in the order of the allocations. See MemPatternPlanner::GenerateBestFitMemPattern.
+  common::Status GeneratePatterns(MemoryPatternGroup* out, bool use_best_fit = false);
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OrtValuePatternPlanner);
 
  private:
@@ -3,9 +3,12 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -14,12 +17,18 @@
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/hardware_counters.h"
 #include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag,
+                                   std::string stream_id, bool end_of_stream)
+    : out_standings_(0),
+      terminate_flag_(terminate_flag),
+      stream_id_(std::move(stream_id)),
+      end_of_stream_(end_of_stream),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   const auto& graph_viewer = session_state.GetGraphViewer();
   node_refs_.resize(graph_viewer.MaxNodeIndex());
   for (auto& node : graph_viewer.Nodes()) {
@@ -38,10 +47,45 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     tp = session_state.Profiler().StartTime();
   }
 
+  profiling::SamplingProfiler* const sampling_profiler = session_state.GetSamplingProfiler();
+  is_sampled_run_ = sampling_profiler != nullptr && sampling_profiler->ShouldSample();
+
+  NodeCostModel* const cost_model = session_state.GetNodeCostModel();
+  use_cost_model_ = cost_model != nullptr && cost_model->HasEstimates();
+  is_cost_profiling_run_ = cost_model != nullptr && !use_cost_model_ && cost_model->StartRun();
+  intra_op_degree_of_parallelism_ = concurrency::ThreadPool::DegreeOfParallelism(session_state.GetThreadPool());
+  // the limit, the priority and the weight the Run set on the calling thread, for the nodes run by the inter-op threads
+  run_max_degree_of_parallelism_ = concurrency::ThreadPoolParallelismLimitScope::CurrentMaxDegreeOfParallelism();
+  run_is_low_priority_ = concurrency::ThreadPoolRunPriorityScope::CurrentIsLowPriority();
+  run_weight_ = concurrency::ThreadPoolRunWeightScope::CurrentWeight();
+
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  if (exec_plan.has_cross_stream_fences) {
+    // the feeds were copied to the device on the stream of this thread, which the other threads don't wait for
+    for (const auto& xp : session_state.GetExecutionProviders()) {
+      if (xp->UsesPerThreadStreams()) {
+        ORT_RETURN_IF_ERROR(xp->SyncCurrentThread());
+      }
+    }
+  }
+
   root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                          fetch_allocators, session_state);
+  const auto& graph_root_nodes = session_state.GetGraphViewer().GetRootNodes();
+  std::vector<NodeIndex> prioritized_root_nodes;
+  if (use_cost_model_) {
+    // start the critical path first
+    prioritized_root_nodes = graph_root_nodes;
+    std::stable_sort(prioritized_root_nodes.begin(), prioritized_root_nodes.end(),
+                     [cost_model](NodeIndex a, NodeIndex b) {
+                       return cost_model->PriorityNs(a) > cost_model->PriorityNs(b);
+                     });
+  }
+
+  const auto& root_nodes = use_cost_model_ ? prioritized_root_nodes : graph_root_nodes;
+
   //std::cout << "start nodes:" << std::endl;
-  for (auto node_index : session_state.GetGraphViewer().GetRootNodes()) {
+  for (auto node_index : root_nodes) {
     auto p_op_kernel = session_state.GetKernel(node_index);
     if (!p_op_kernel)
       continue;
@@ -56,6 +100,10 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     while (out_standings_ > 0) complete_cv_.wait(lock);
   }
 
+  if (is_cost_profiling_run_) {
+    cost_model->EndRun();
+  }
+
   Status status = Status::OK();
 
   if (!errors_.empty()) {
@@ -79,6 +127,17 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   VLOGS(logger, 1) << "Fetching output.";
   // ExecutionFrame::Finalize will update 'fetches' with the final output
   ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
+
+  if (exec_plan.has_cross_stream_fences) {
+    // the outputs may have been produced on the streams of other threads, so wait for them to be complete before
+    // handing them to the caller
+    for (const auto& fetch : fetches) {
+      Fence_t fence = fetch.Fence();
+      if (fence) {
+        fence->BeforeUsingAsInput(kCpuExecutionProvider, 0);
+      }
+    }
+  }
   VLOGS(logger, 1) << "Done execution.";
 
   if (root_frame_->HasMemoryPatternPlanner()) {
@@ -122,6 +181,10 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
 
+  // the nodes this thread made ready and runs itself instead of enqueuing them
+  std::vector<size_t> ready_nodes;
+  std::deque<size_t> inline_nodes;
+
   // Avoid context switching if possible.
   while (keep_running) {
     // TODO: Convert RunNodeAsync return Status.
@@ -139,7 +202,8 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
     }
 
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_,
+                                              stream_id_, end_of_stream_);
 
     if (f_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -189,14 +253,67 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
+    TimePoint sample_begin_time;
+    if (is_sampled_run_ || is_cost_profiling_run_) {
+      sample_begin_time = std::chrono::high_resolution_clock::now();
+    }
+
+    // the kernel runs on this thread of the inter-op thread pool, which has its own counters
+    profiling::HardwareCounterValues kernel_counters;
+    bool has_kernel_counters = f_profiler_enabled && session_state.ProfileHardwareCounters() &&
+                               profiling::ReadHardwareCounters(kernel_counters);
+
     // Execute the kernel.
-    ORT_TRY {
-      status = p_op_kernel->Compute(&op_kernel_context);
+    {
+      // record the work the intra-op thread pool does for the kernel
+      const std::string parallel_for_event_name = f_profiler_enabled ? node.Name() + "_parallel_for" : std::string();
+      std::unique_ptr<concurrency::ThreadPoolProfilingScope> thread_pool_profiling_scope;
+      if (f_profiler_enabled) {
+        thread_pool_profiling_scope = onnxruntime::make_unique<concurrency::ThreadPoolProfilingScope>(
+            session_state.Profiler(), parallel_for_event_name);
+      }
+
+      // share the intra-op threads with the other nodes that are running so wide graphs don't oversubscribe the cores
+      int max_degree_of_parallelism = run_max_degree_of_parallelism_;
+      if (use_cost_model_) {
+        const int num_running_nodes = ++num_running_nodes_;
+        if (num_running_nodes > 1) {
+          max_degree_of_parallelism = std::max(1, intra_op_degree_of_parallelism_ / num_running_nodes);
+        }
+      }
+      concurrency::ThreadPoolParallelismLimitScope parallelism_limit_scope(max_degree_of_parallelism);
+      concurrency::ThreadPoolRunPriorityScope run_priority_scope(nullptr, run_is_low_priority_);
+      concurrency::ThreadPoolRunWeightScope run_weight_scope(nullptr, run_weight_);
+
+      ORT_TRY {
+        status = p_op_kernel->Compute(&op_kernel_context);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+
+      if (use_cost_model_) {
+        --num_running_nodes_;
+      }
     }
-    ORT_CATCH(const std::exception& ex) {
-      ORT_HANDLE_EXCEPTION([&]() {
-        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
-      });
+
+    if (has_kernel_counters) {
+      profiling::HardwareCounterValues counters_after;
+      has_kernel_counters = profiling::ReadHardwareCounters(counters_after);
+      kernel_counters = counters_after - kernel_counters;
+    }
+
+    if (is_sampled_run_ || is_cost_profiling_run_) {
+      const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::high_resolution_clock::now() - sample_begin_time);
+      if (is_sampled_run_) {
+        session_state.GetSamplingProfiler()->RecordNode(node_index, duration);
+      }
+      if (is_cost_profiling_run_) {
+        session_state.GetNodeCostModel()->RecordNode(node_index, duration);
+      }
     }
 
     if (!status.IsOK()) {
@@ -210,10 +327,24 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     }
 
     if (f_profiler_enabled) {
+      std::unordered_map<std::string, std::string> event_args{
+          {"op_name", p_op_kernel->KernelDef().OpName()},
+          {"provider", p_op_kernel->KernelDef().Provider()},
+      };
+
+      if (has_kernel_counters) {
+        kernel_counters.AddToEventArgs(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::high_resolution_clock::now() - kernel_begin_time)
+                                           .count(),
+                                       event_args);
+      }
+
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      node.Name() + "_kernel_time",
                                                      kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+                                                     std::move(event_args));
+
+      utils::RecordArenaCounterEvents(session_state);
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -256,28 +387,95 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       auto begin = node.OutputEdgesBegin();
       auto end = node.OutputEdgesEnd();
 
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
+      // if the planner assigned streams, prefer to keep running the node that continues the stream of this one,
+      // as the values passed along a stream have no fence
+      const auto& stream_ids = exec_plan.node_stream_ids;
+      const int stream_id = stream_ids.empty() ? -1 : stream_ids[node_index];
+
+      ready_nodes.clear();
+      {
+        std::lock_guard<OrtMutex> lock(ref_mutex_);
+        for (auto it = begin; it != end; it++) {
+          auto idx = (*it).GetNode().Index();
+          if ((--node_refs_[idx]) == 0) {
+            ready_nodes.push_back(idx);
           }
         }
-
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
       }
+
+      ScheduleReadyNodes(ready_nodes, stream_id, session_state, logger, inline_nodes);
+    }
+
+    if (!inline_nodes.empty()) {
+      node_index = inline_nodes.front();
+      inline_nodes.pop_front();
+      keep_running = true;
     }
   }
 
   return status;
 }
 
+void ParallelExecutor::ScheduleReadyNodes(std::vector<size_t>& ready_nodes, int stream_id,
+                                          const SessionState& session_state, const logging::Logger& logger,
+                                          std::deque<size_t>& inline_nodes) {
+  if (ready_nodes.empty()) {
+    return;
+  }
+
+  const NodeCostModel* cost_model = use_cost_model_ ? session_state.GetNodeCostModel() : nullptr;
+  if (cost_model != nullptr) {
+    std::stable_sort(ready_nodes.begin(), ready_nodes.end(), [cost_model](size_t a, size_t b) {
+      return cost_model->PriorityNs(a) > cost_model->PriorityNs(b);
+    });
+  }
+
+  // dispatching a trivial kernel such as a Reshape to another thread costs far more than running it, and it's run
+  // before the next node so the nodes it makes ready are scheduled as early as possible
+  auto is_trivial = [&session_state](size_t idx) {
+    const auto* kernel = session_state.GetKernel(idx);
+    return kernel != nullptr && kernel->KernelDef().IsTrivial();
+  };
+
+  // keep running the stream of the finished node if the planner assigned streams, otherwise the first node, which
+  // is on the critical path with the cost model
+  auto next = std::find_if_not(ready_nodes.begin(), ready_nodes.end(), is_trivial);
+  if (stream_id != -1 && next != ready_nodes.end()) {
+    const auto& stream_ids = session_state.GetExecutionPlan()->node_stream_ids;
+    auto same_stream = std::find_if(next, ready_nodes.end(), [&](size_t idx) {
+      return stream_ids[idx] == stream_id && !is_trivial(idx);
+    });
+    if (same_stream != ready_nodes.end()) {
+      next = same_stream;
+    }
+  }
+
+  const int64_t inline_node_cost_ns = session_state.GetInlineNodeCost().count();
+  for (auto it = ready_nodes.begin(); it != ready_nodes.end(); ++it) {
+    if (it == next || is_trivial(*it)) {
+      continue;
+    }
+
+    if (cost_model != nullptr && cost_model->CostNs(*it) < inline_node_cost_ns) {
+      // with the cost model, the cheap nodes are run by this thread after the ones it's already running
+      inline_nodes.push_back(*it);
+    } else {
+      EnqueueNode(*it, session_state, logger);
+    }
+  }
+
+  if (next != ready_nodes.end()) {
+    inline_nodes.push_front(*next);
+  }
+
+  // iterating in reverse keeps the trivial nodes in their order at the front
+  for (auto it = ready_nodes.rbegin(); it != ready_nodes.rend(); ++it) {
+    if (is_trivial(*it)) {
+      inline_nodes.push_front(*it);
+    }
+  }
+}
+
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
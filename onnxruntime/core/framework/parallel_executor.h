@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -20,7 +22,8 @@ class ExecutionFrame;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false,
+                   std::string stream_id = {}, bool end_of_stream = false);
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -35,6 +38,12 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // Adds the nodes that became ready and that the calling thread runs itself to inline_nodes and enqueues the others.
+  // The trivial nodes and the next node of the thread go to the front, the nodes the cost model finds cheap to the
+  // back. With the cost model the nodes are taken in the order of their priorities.
+  void ScheduleReadyNodes(std::vector<size_t>& ready_nodes, int stream_id, const SessionState& session_state,
+                          const logging::Logger& logger, std::deque<size_t>& inline_nodes);
+
   void FinishNodeRun(const Status& status) {
     bool finished = false;
     {
@@ -59,7 +68,24 @@ class ParallelExecutor : public IExecutor {
   OrtCondVar complete_cv_;
   std::vector<Status> errors_;
 
+  // whether the kernel execution times of this Run are recorded by the sampling profiler of the session state
+  bool is_sampled_run_ = false;
+
+  // whether the kernel execution times of this Run are recorded by the cost model of the session state
+  bool is_cost_profiling_run_ = false;
+  // whether the nodes are scheduled with the estimates of the cost model
+  bool use_cost_model_ = false;
+  int intra_op_degree_of_parallelism_ = 1;
+  // the intra-op limit and the priority of the Run, see OrtRunOptions
+  int run_max_degree_of_parallelism_ = 0;
+  bool run_is_low_priority_ = false;
+  // the weight of the Run on the intra-op thread pool, see ThreadPoolRunWeightScope
+  int run_weight_ = 0;
+  std::atomic<int> num_running_nodes_{0};
+
   const bool& terminate_flag_;
+  const std::string stream_id_;
+  const bool end_of_stream_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
   onnxruntime::concurrency::ThreadPool* const executor_pool_{};
 };
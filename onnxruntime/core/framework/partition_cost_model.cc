@@ -0,0 +1,405 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/partition_cost_model.h"
+
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/kernel_registry.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+namespace {
+
+// Rough throughputs the estimates are based on. They only need to rank placements, not to predict latencies.
+constexpr double kCpuElementsPerUs = 1000.0;  // memory bound ops
+constexpr double kCpuFlopsPerUs = 20000.0;    // compute bound ops
+constexpr double kDeviceSpeedup = 10.0;
+constexpr double kDeviceKernelLaunchUs = 5.0;
+constexpr double kCopyLatencyUs = 10.0;
+constexpr double kCopyBytesPerUs = 5000.0;
+// Dimensions that aren't known are assumed to be this large. Overestimating the values makes moving nodes off the
+// device look more expensive, so the cost model errs on the side of keeping the greedy placement.
+constexpr double kUnknownDimValue = 64.0;
+constexpr int kMaxSingleNodePasses = 8;
+
+double DimValue(const NodeArg& def, int index) {
+  const auto* shape = def.Shape();
+  if (shape == nullptr) {
+    return kUnknownDimValue;
+  }
+
+  const int rank = shape->dim_size();
+  if (index < 0) {
+    index += rank;
+  }
+  if (index < 0 || index >= rank) {
+    return kUnknownDimValue;
+  }
+
+  const auto& dim = shape->dim(index);
+  return utils::HasDimValue(dim) ? static_cast<double>(dim.dim_value()) : kUnknownDimValue;
+}
+
+double NumElements(const NodeArg& def) {
+  if (!def.Exists()) {
+    return 0.0;
+  }
+
+  const auto* shape = def.Shape();
+  if (shape == nullptr) {
+    return kUnknownDimValue;
+  }
+
+  double num_elements = 1.0;
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    num_elements *= DimValue(def, i);
+  }
+  return num_elements;
+}
+
+double SizeInBytes(const NodeArg& def) {
+  double element_size = 4.0;
+  const auto* type = def.TypeAsProto();
+  if (type != nullptr && type->value_case() == ONNX_NAMESPACE::TypeProto::kTensorType) {
+    switch (type->tensor_type().elem_type()) {
+      case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+      case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+      case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+        element_size = 1.0;
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+      case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+        element_size = 2.0;
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+      case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+      case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+        element_size = 8.0;
+        break;
+      default:
+        break;
+    }
+  }
+  return NumElements(def) * element_size;
+}
+
+// Number of multiply-adds of the compute bound ops, 0 for the others.
+double NumMultiplyAdds(const Node& node) {
+  const auto& op_type = node.OpType();
+  const auto inputs = node.InputDefs();
+  const auto outputs = node.OutputDefs();
+  if (inputs.size() < 2 || outputs.empty()) {
+    return 0.0;
+  }
+
+  if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul") {
+    return NumElements(*outputs[0]) * DimValue(*inputs[0], -1);
+  }
+
+  if (op_type == "Gemm") {
+    const auto& attributes = node.GetAttributes();
+    auto trans_a = attributes.find("transA");
+    const bool transposed = trans_a != attributes.end() && trans_a->second.i() != 0;
+    return NumElements(*outputs[0]) * DimValue(*inputs[0], transposed ? 0 : 1);
+  }
+
+  if (op_type == "Conv" || op_type == "ConvInteger" || op_type == "FusedConv") {
+    // every output element is a dot product over a filter, which is one output channel of the weights
+    return NumElements(*outputs[0]) * NumElements(*inputs[1]) / std::max(1.0, DimValue(*inputs[1], 0));
+  }
+
+  if (op_type == "ConvTranspose") {
+    // every input element is scaled by the filter of its input channel
+    return NumElements(*inputs[0]) * NumElements(*inputs[1]) / std::max(1.0, DimValue(*inputs[1], 0));
+  }
+
+  if ((op_type == "LSTM" || op_type == "GRU" || op_type == "RNN") && inputs.size() >= 3) {
+    // every step of every sequence multiplies its input by W and the previous hidden state by R
+    const double num_steps = NumElements(*inputs[0]) / std::max(1.0, DimValue(*inputs[0], 2));
+    return num_steps * (NumElements(*inputs[1]) + NumElements(*inputs[2]));
+  }
+
+  return 0.0;
+}
+
+double CpuCostUs(const Node& node) {
+  double num_elements = 0.0;
+  for (const auto* def : node.InputDefs()) {
+    num_elements += NumElements(*def);
+  }
+  for (const auto* def : node.OutputDefs()) {
+    num_elements += NumElements(*def);
+  }
+  return std::max(num_elements / kCpuElementsPerUs, 2.0 * NumMultiplyAdds(node) / kCpuFlopsPerUs);
+}
+
+double DeviceCostUs(const Node& node) {
+  return kDeviceKernelLaunchUs + CpuCostUs(node) / kDeviceSpeedup;
+}
+
+class PartitionCostModel {
+ public:
+  PartitionCostModel(Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                     const std::unordered_set<NodeIndex>& fixed_nodes)
+      : graph_(graph), kernel_registry_mgr_(kernel_registry_mgr), fixed_nodes_(fixed_nodes) {
+    std::unordered_set<std::string> graph_inputs;
+    for (const auto* def : graph_.GetInputs()) {
+      graph_inputs.insert(def->Name());
+    }
+
+    for (auto& node : graph_.Nodes()) {
+      int index = 0;
+      for (const auto* def : node.OutputDefs()) {
+        if (def->Exists()) {
+          auto& value = values_[def->Name()];
+          value.def = def;
+          value.producer = &node;
+          value.producer_output_index = index;
+        }
+        ++index;
+      }
+
+      index = 0;
+      for (const auto* def : node.InputDefs()) {
+        if (def->Exists()) {
+          auto& value = values_[def->Name()];
+          value.def = def;
+          value.consumers.emplace_back(&node, index);
+        }
+        ++index;
+      }
+      for (const auto* def : node.ImplicitInputDefs()) {
+        auto& value = values_[def->Name()];
+        value.def = def;
+        value.consumers.emplace_back(&node, -1);
+      }
+
+      if (IsDeviceProvider(node.GetExecutionProviderType())) {
+        const KernelCreateInfo* kernel_create_info = nullptr;
+        // fused nodes don't have a kernel yet, their inputs and outputs are all on the device
+        if (kernel_registry_mgr_.SearchKernelRegistry(node, &kernel_create_info).IsOK() &&
+            kernel_create_info != nullptr) {
+          kernel_defs_[node.Index()] = kernel_create_info->kernel_def.get();
+        }
+      }
+    }
+
+    for (const auto* def : graph_.GetOutputs()) {
+      auto iter = values_.find(def->Name());
+      if (iter != values_.end()) {
+        iter->second.is_graph_output = true;
+      }
+    }
+
+    // initializers are copied to the device once, and the values of the outer scope aren't copied by this graph
+    for (auto iter = values_.begin(); iter != values_.end();) {
+      const auto& value = iter->second;
+      if (graph_.IsInitializedTensor(iter->first) ||
+          (value.producer == nullptr && graph_inputs.count(iter->first) == 0)) {
+        iter = values_.erase(iter);
+      } else {
+        iter->second.copy_cost_us = kCopyLatencyUs + SizeInBytes(*value.def) / kCopyBytesPerUs;
+        ++iter;
+      }
+    }
+  }
+
+  size_t Apply() {
+    size_t num_moved = MoveIslands();
+    for (int pass = 0; pass < kMaxSingleNodePasses; ++pass) {
+      size_t num_moved_in_pass = 0;
+      for (auto& node : graph_.Nodes()) {
+        if (IsMovable(node) && MoveCostUs({node.Index()}) < 0.0) {
+          Move({node.Index()});
+          ++num_moved_in_pass;
+        }
+      }
+      if (num_moved_in_pass == 0) {
+        break;
+      }
+      num_moved += num_moved_in_pass;
+    }
+    return num_moved;
+  }
+
+ private:
+  struct Value {
+    const NodeArg* def = nullptr;
+    // nullptr for a graph input, which is fed from the CPU
+    const Node* producer = nullptr;
+    int producer_output_index = 0;
+    // consuming node and its input index, -1 for an implicit input
+    std::vector<std::pair<const Node*, int>> consumers;
+    bool is_graph_output = false;
+    double copy_cost_us = 0.0;
+  };
+
+  // The CPU is the empty string, a device is the type of the provider using its memory.
+  static bool IsDeviceProvider(const std::string& provider_type) {
+    return !provider_type.empty() && !utils::ProviderIsCpuBased(provider_type);
+  }
+
+  std::string NodeLocation(const Node& node, const std::unordered_set<NodeIndex>& moving) const {
+    const auto& provider_type = node.GetExecutionProviderType();
+    if (moving.count(node.Index()) > 0 || !IsDeviceProvider(provider_type)) {
+      return std::string();
+    }
+    return provider_type;
+  }
+
+  std::string InputLocation(const Node& node, int input_index, const std::unordered_set<NodeIndex>& moving) const {
+    std::string location = NodeLocation(node, moving);
+    auto iter = kernel_defs_.find(node.Index());
+    if (!location.empty() && input_index >= 0 && iter != kernel_defs_.end() &&
+        iter->second->IsInputOnCpu(static_cast<size_t>(input_index))) {
+      location.clear();
+    }
+    return location;
+  }
+
+  std::string OutputLocation(const Node& node, int output_index, const std::unordered_set<NodeIndex>& moving) const {
+    std::string location = NodeLocation(node, moving);
+    auto iter = kernel_defs_.find(node.Index());
+    if (!location.empty() && iter != kernel_defs_.end() &&
+        iter->second->IsOutputOnCpu(static_cast<size_t>(output_index))) {
+      location.clear();
+    }
+    return location;
+  }
+
+  // A value is copied once to every location it's consumed on other than the one it's produced on.
+  double CopyCostUs(const Value& value, const std::unordered_set<NodeIndex>& moving) const {
+    const std::string producer_location =
+        value.producer != nullptr ? OutputLocation(*value.producer, value.producer_output_index, moving)
+                                  : std::string();
+
+    std::vector<std::string> consumer_locations;
+    auto add_location = [&](std::string location) {
+      if (location != producer_location &&
+          std::find(consumer_locations.begin(), consumer_locations.end(), location) == consumer_locations.end()) {
+        consumer_locations.push_back(std::move(location));
+      }
+    };
+    for (const auto& consumer : value.consumers) {
+      add_location(InputLocation(*consumer.first, consumer.second, moving));
+    }
+    if (value.is_graph_output) {
+      add_location(std::string());
+    }
+
+    return static_cast<double>(consumer_locations.size()) * value.copy_cost_us;
+  }
+
+  bool IsMovable(const Node& node) const {
+    return IsDeviceProvider(node.GetExecutionProviderType()) &&
+           fixed_nodes_.count(node.Index()) == 0 &&
+           !node.ContainsSubgraph() &&
+           KernelRegistryManager::HasImplementationOf(kernel_registry_mgr_, node, kCpuExecutionProvider);
+  }
+
+  // Change of the estimated cost if the nodes are moved to the CPU. Negative if moving them is cheaper.
+  double MoveCostUs(const std::unordered_set<NodeIndex>& nodes) const {
+    double cost = 0.0;
+    std::unordered_set<const Value*> affected_values;
+    for (auto node_index : nodes) {
+      const Node& node = *graph_.GetNode(node_index);
+      cost += CpuCostUs(node) - DeviceCostUs(node);
+      auto add_affected_values = [&](const ConstPointerContainer<std::vector<NodeArg*>>& defs) {
+        for (const auto* def : defs) {
+          auto iter = values_.find(def->Name());
+          if (iter != values_.end()) {
+            affected_values.insert(&iter->second);
+          }
+        }
+      };
+      add_affected_values(node.InputDefs());
+      add_affected_values(node.ImplicitInputDefs());
+      add_affected_values(node.OutputDefs());
+    }
+
+    const std::unordered_set<NodeIndex> none;
+    for (const auto* value : affected_values) {
+      cost += CopyCostUs(*value, nodes) - CopyCostUs(*value, none);
+    }
+    return cost;
+  }
+
+  void Move(const std::unordered_set<NodeIndex>& nodes) {
+    for (auto node_index : nodes) {
+      graph_.GetNode(node_index)->SetExecutionProviderType(kCpuExecutionProvider);
+      kernel_defs_.erase(node_index);
+    }
+  }
+
+  // Islands are the connected components of the nodes of a device provider.
+  size_t MoveIslands() {
+    size_t num_moved = 0;
+    std::unordered_set<NodeIndex> visited;
+    for (auto& start_node : graph_.Nodes()) {
+      const auto& provider_type = start_node.GetExecutionProviderType();
+      if (!IsDeviceProvider(provider_type) || !visited.insert(start_node.Index()).second) {
+        continue;
+      }
+
+      std::unordered_set<NodeIndex> island;
+      bool movable = true;
+      std::queue<const Node*> to_visit;
+      to_visit.push(&start_node);
+      while (!to_visit.empty()) {
+        const Node* node = to_visit.front();
+        to_visit.pop();
+        island.insert(node->Index());
+        movable = movable && IsMovable(*node);
+
+        auto visit = [&](const Node& neighbor) {
+          if (neighbor.GetExecutionProviderType() == provider_type && visited.insert(neighbor.Index()).second) {
+            to_visit.push(&neighbor);
+          }
+        };
+        for (auto iter = node->InputNodesBegin(); iter != node->InputNodesEnd(); ++iter) {
+          visit(*iter);
+        }
+        for (auto iter = node->OutputNodesBegin(); iter != node->OutputNodesEnd(); ++iter) {
+          visit(*iter);
+        }
+      }
+
+      if (movable && MoveCostUs(island) < 0.0) {
+        Move(island);
+        num_moved += island.size();
+      }
+    }
+    return num_moved;
+  }
+
+  Graph& graph_;
+  const KernelRegistryManager& kernel_registry_mgr_;
+  const std::unordered_set<NodeIndex>& fixed_nodes_;
+  std::unordered_map<std::string, Value> values_;
+  std::unordered_map<NodeIndex, const KernelDef*> kernel_defs_;
+};
+
+}  // namespace
+
+size_t ApplyPartitionCostModel(Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                               const std::unordered_set<NodeIndex>& fixed_nodes) {
+  PartitionCostModel cost_model(graph, kernel_registry_mgr, fixed_nodes);
+  const size_t num_moved = cost_model.Apply();
+  if (num_moved > 0) {
+    LOGS_DEFAULT(INFO) << "Partition cost model moved " << num_moved
+                       << " nodes to the CPU execution provider in graph " << graph.Name();
+  }
+  return num_moved;
+}
+
+}  // namespace onnxruntime
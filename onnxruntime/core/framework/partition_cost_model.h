@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_set>
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+class KernelRegistryManager;
+
+// Refines the placement of the greedy partitioning, after the execution providers claimed the nodes they support.
+// A node that one provider doesn't support splits the graph between it and the CPU execution provider, and every
+// value crossing the split is copied between the devices. Where the copies are estimated to cost more than the time
+// the provider saves, its nodes next to the split are moved to the CPU execution provider too: first whole islands
+// of connected nodes of the provider, then single nodes at the border of the islands that are left.
+// The estimates are based on the shapes of the values, with the number of elements for memory bound ops and the
+// number of multiply-adds for MatMul, Gemm, Conv and the RNN ops.
+// Only nodes with a CPU kernel are moved. Fused nodes, nodes with subgraphs and the nodes in fixed_nodes are not.
+// Returns the number of nodes moved.
+size_t ApplyPartitionCostModel(Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                               const std::unordered_set<NodeIndex>& fixed_nodes);
+
+}  // namespace onnxruntime
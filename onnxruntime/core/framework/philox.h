@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__CUDACC__)
+#define ORT_PHILOX_HOST_DEVICE __host__ __device__ __forceinline__
+#else
+#define ORT_PHILOX_HOST_DEVICE inline
+#endif
+
+namespace onnxruntime {
+
+/**
+ * The Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"), which
+ * uses the same rounds as the cuRAND Philox_4x32_10 generator.
+ * A block of four 32-bit values is a function of the key and the 128-bit counter only, so the blocks of a stream can
+ * be generated in any order and by any number of threads, and the result doesn't depend on how they're split.
+ */
+class Philox4x32x10 {
+ public:
+  /**
+   * Generates the block of four values at the counter (index, subsequence) of the stream with the given key.
+   */
+  ORT_PHILOX_HOST_DEVICE static void Generate(uint64_t key, uint64_t index, uint64_t subsequence, uint32_t out[4]) {
+    uint32_t c0 = static_cast<uint32_t>(index);
+    uint32_t c1 = static_cast<uint32_t>(index >> 32);
+    uint32_t c2 = static_cast<uint32_t>(subsequence);
+    uint32_t c3 = static_cast<uint32_t>(subsequence >> 32);
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+
+    for (int round = 0; round < kRounds; ++round) {
+      if (round > 0) {
+        k0 += kW0;
+        k1 += kW1;
+      }
+
+      const uint64_t p0 = static_cast<uint64_t>(kM0) * c0;
+      const uint64_t p1 = static_cast<uint64_t>(kM1) * c2;
+      c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      c1 = static_cast<uint32_t>(p1);
+      c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c3 = static_cast<uint32_t>(p0);
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+  /**
+   * Converts a value to a float uniformly distributed in [0, 1), with 24 random bits.
+   */
+  ORT_PHILOX_HOST_DEVICE static float ToFloat(uint32_t x) {
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+  }
+
+  /**
+   * Converts two values to a double uniformly distributed in [0, 1), with 53 random bits.
+   */
+  ORT_PHILOX_HOST_DEVICE static double ToDouble(uint32_t hi, uint32_t lo) {
+    const uint64_t x = (static_cast<uint64_t>(hi) << 32) | lo;
+    return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+ private:
+  static constexpr int kRounds = 10;
+  static constexpr uint32_t kM0 = 0xD2511F53;
+  static constexpr uint32_t kM1 = 0xCD9E8D57;
+  static constexpr uint32_t kW0 = 0x9E3779B9;
+  static constexpr uint32_t kW1 = 0xBB67AE85;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_container.h"
+
+namespace onnxruntime {
+
+PrepackedWeightsContainer::PrepackedWeightsContainer()
+    : allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+const PrePackedWeights* PrepackedWeightsContainer::GetWeight(const std::string& key) const {
+  auto it = prepacked_weights_map_.find(key);
+  return it != prepacked_weights_map_.end() ? &it->second : nullptr;
+}
+
+const PrePackedWeights& PrepackedWeightsContainer::WriteWeight(const std::string& key, PrePackedWeights&& weights) {
+  // emplace doesn't replace an existing entry, which frames of other sessions may be using
+  return prepacked_weights_map_.emplace(key, std::move(weights)).first->second;
+}
+
+}  // namespace onnxruntime
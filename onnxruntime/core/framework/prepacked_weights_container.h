@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+Holds pre-packed weights that are shared between sessions so that loading the same model into multiple sessions
+only keeps a single copy of each packed buffer.
+Entries are keyed on the kernel and the content of the initializer that was packed, and live as long as the
+container, so the container must outlive every session using it.
+*/
+class PrepackedWeightsContainer final {
+ public:
+  PrepackedWeightsContainer();
+
+  // The allocator the shared buffers must be allocated with. Not an arena as the buffers are never freed before
+  // the container is.
+  AllocatorPtr GetAllocator() const { return allocator_; }
+
+  // Callers must hold this while they look up and write an entry, as sessions may be initialized concurrently.
+  OrtMutex& GetMutex() { return mutex_; }
+
+  // Returns nullptr if there's no entry for the key.
+  const PrePackedWeights* GetWeight(const std::string& key) const;
+
+  // Takes ownership of the buffers in <weights>. If an entry already exists for the key it is kept and returned.
+  const PrePackedWeights& WriteWeight(const std::string& key, PrePackedWeights&& weights);
+
+  size_t GetNumberOfElements() const { return prepacked_weights_map_.size(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsContainer);
+
+  AllocatorPtr allocator_;
+  OrtMutex mutex_;
+  std::unordered_map<std::string, PrePackedWeights> prepacked_weights_map_;
+};
+
+}  // namespace onnxruntime
@@ -24,6 +24,10 @@
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "core/providers/cuda/math/unary_elementwise_ops_impl.h"
 #include "core/providers/cuda/cuda_common.h"
+#ifndef DISABLE_CONTRIB_OPS
+#include "contrib_ops/cuda/bert/fast_gelu_impl.h"
+#include "contrib_ops/cuda/bert/skip_layer_norm_impl.h"
+#endif
 #endif
 
 namespace onnxruntime {
@@ -286,6 +290,55 @@ struct ProviderHostImpl : ProviderHost {
     return cuda::Impl_Cast(input_data, output_data, count);
   }
 
+  bool contrib_cuda__LaunchFastGeluKernel(const cudaDeviceProp& prop, cudaStream_t stream, int input_length,
+                                          int bias_length, const void* input, const void* bias, void* output,
+                                          size_t element_size) override {
+#ifndef DISABLE_CONTRIB_OPS
+    if (element_size == 2) {
+      return contrib::cuda::LaunchFastGeluKernel<half>(prop, stream, input_length, bias_length,
+                                                       reinterpret_cast<const half*>(input),
+                                                       reinterpret_cast<const half*>(bias),
+                                                       reinterpret_cast<half*>(output));
+    }
+    return contrib::cuda::LaunchFastGeluKernel<float>(prop, stream, input_length, bias_length,
+                                                      reinterpret_cast<const float*>(input),
+                                                      reinterpret_cast<const float*>(bias),
+                                                      reinterpret_cast<float*>(output));
+#else
+    ORT_UNUSED_PARAMETER(prop);
+    ORT_UNUSED_PARAMETER(stream);
+    ORT_UNUSED_PARAMETER(input_length);
+    ORT_UNUSED_PARAMETER(bias_length);
+    ORT_UNUSED_PARAMETER(input);
+    ORT_UNUSED_PARAMETER(bias);
+    ORT_UNUSED_PARAMETER(output);
+    ORT_UNUSED_PARAMETER(element_size);
+    return false;
+#endif
+  }
+
+  bool contrib_cuda__LaunchSkipLayerNormKernel(void* output, const void* input, const void* skip,
+                                               const void* gamma, const void* beta, const void* bias,
+                                               float epsilon, int hidden_size, int element_count,
+                                               size_t element_size) override {
+#ifndef DISABLE_CONTRIB_OPS
+    return contrib::cuda::LaunchSkipLayerNormKernel(output, input, skip, gamma, beta, bias, epsilon, hidden_size,
+                                                    element_count, element_size);
+#else
+    ORT_UNUSED_PARAMETER(output);
+    ORT_UNUSED_PARAMETER(input);
+    ORT_UNUSED_PARAMETER(skip);
+    ORT_UNUSED_PARAMETER(gamma);
+    ORT_UNUSED_PARAMETER(beta);
+    ORT_UNUSED_PARAMETER(bias);
+    ORT_UNUSED_PARAMETER(epsilon);
+    ORT_UNUSED_PARAMETER(hidden_size);
+    ORT_UNUSED_PARAMETER(element_count);
+    ORT_UNUSED_PARAMETER(element_size);
+    return false;
+#endif
+  }
+
   bool CudaCall_false(int retCode, const char* exprString, const char* libName, int successCode, const char* msg) override { return CudaCall<cudaError, false>(cudaError(retCode), exprString, libName, cudaError(successCode), msg); }
   bool CudaCall_true(int retCode, const char* exprString, const char* libName, int successCode, const char* msg) override { return CudaCall<cudaError, true>(cudaError(retCode), exprString, libName, cudaError(successCode), msg); }
 #endif
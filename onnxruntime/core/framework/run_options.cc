@@ -53,3 +53,22 @@ ORT_API_STATUS_IMPL(OrtApis::RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* op
   options->terminate = false;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetStream, _Inout_ OrtRunOptions* options, _In_opt_ const char* stream_id,
+                    int end_of_stream) {
+  options->stream_id = stream_id ? stream_id : "";
+  options->end_of_stream = end_of_stream != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetIntraOpMaxDegreeOfParallelism, _Inout_ OrtRunOptions* options, int value) {
+  if (value < 0)
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "intra-op max degree of parallelism must be non-negative");
+  options->intra_op_max_degree_of_parallelism = value;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetPriority, _Inout_ OrtRunOptions* options, int value) {
+  options->priority = value;
+  return nullptr;
+}
@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/sampling_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kMaxExponent;
+constexpr size_t LatencyHistogram::kNumBuckets;
+
+size_t LatencyHistogram::BucketIndex(uint64_t duration_ns) noexcept {
+  // the first kSubBuckets values have a bucket each
+  if (duration_ns < static_cast<uint64_t>(kSubBuckets)) {
+    return static_cast<size_t>(duration_ns);
+  }
+
+  int exponent = 0;
+  for (uint64_t v = duration_ns; v > 1; v >>= 1) {
+    exponent++;
+  }
+
+  if (exponent > kMaxExponent) {
+    return kNumBuckets - 1;
+  }
+
+  // the kSubBucketBits bits below the most significant one select the linear bucket within the power of two
+  const size_t sub_bucket = static_cast<size_t>(duration_ns >> (exponent - kSubBucketBits)) - kSubBuckets;
+  return static_cast<size_t>(exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBoundNs(size_t bucket) noexcept {
+  if (bucket < static_cast<size_t>(kSubBuckets)) {
+    return bucket;
+  }
+
+  const int exponent = static_cast<int>(bucket / kSubBuckets) + kSubBucketBits - 1;
+  const uint64_t sub_bucket = bucket % kSubBuckets;
+  return ((kSubBuckets + sub_bucket + 1) << (exponent - kSubBucketBits)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t duration_ns) noexcept {
+  counts_[BucketIndex(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(duration_ns, std::memory_order_relaxed);
+
+  uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (duration_ns > max_ns &&
+         !max_ns_.compare_exchange_weak(max_ns, duration_ns, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.counts[i];
+  }
+
+  snapshot.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+  snapshot.max_ns = max_ns_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void LatencyHistogram::Snapshot::Merge(const Snapshot& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts[i] += other.counts[i];
+  }
+
+  count += other.count;
+  sum_ns += other.sum_ns;
+  max_ns = std::max(max_ns, other.max_ns);
+}
+
+uint64_t LatencyHistogram::Snapshot::PercentileNs(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      // the bucket bound can exceed the longest recorded duration
+      return std::min(BucketUpperBoundNs(i), max_ns);
+    }
+  }
+
+  return max_ns;
+}
+
+SamplingProfiler::SamplingProfiler(size_t num_nodes, uint32_t sample_rate)
+    : sample_rate_(sample_rate) {
+  ORT_ENFORCE(sample_rate_ > 0, "The sample rate must be positive.");
+  node_histograms_.reserve(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    node_histograms_.push_back(onnxruntime::make_unique<LatencyHistogram>());
+  }
+}
+
+void SamplingProfiler::AddToReport(const GraphViewer& graph_viewer, const std::string& prefix,
+                                   SamplingProfileReport& report) const {
+  for (const auto& node : graph_viewer.Nodes()) {
+    if (node.Index() >= node_histograms_.size()) {
+      continue;
+    }
+
+    auto snapshot = node_histograms_[node.Index()]->GetSnapshot();
+    if (snapshot.count == 0) {
+      continue;
+    }
+
+    report.op_types[node.OpType()].Merge(snapshot);
+
+    LatencyStatistics statistics;
+    // same naming as the node events of the Profiler
+    statistics.name = prefix + (node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name());
+    statistics.op_type = node.OpType();
+    statistics.provider = node.GetExecutionProviderType();
+    statistics.histogram = std::move(snapshot);
+    report.nodes.push_back(std::move(statistics));
+  }
+}
+
+namespace {
+void WriteJsonString(std::ostream& out, const std::string& str) {
+  out << '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+void WriteLatencies(std::ostream& out, const LatencyHistogram::Snapshot& histogram) {
+  auto to_us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+  out << "\"count\": " << histogram.count
+      << ", \"mean_us\": " << to_us(histogram.MeanNs())
+      << ", \"p50_us\": " << to_us(histogram.PercentileNs(50))
+      << ", \"p90_us\": " << to_us(histogram.PercentileNs(90))
+      << ", \"p99_us\": " << to_us(histogram.PercentileNs(99))
+      << ", \"max_us\": " << to_us(histogram.max_ns);
+}
+}  // namespace
+
+std::string SamplingProfileReport::ToJson() const {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "{\n\"sample_rate\": " << sample_rate << ",\n\"sampled_runs\": " << sampled_runs << ",\n\"nodes\": [";
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto& node = nodes[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"name\": ";
+    WriteJsonString(out, node.name);
+    out << ", \"op_type\": ";
+    WriteJsonString(out, node.op_type);
+    out << ", \"provider\": ";
+    WriteJsonString(out, node.provider);
+    out << ", ";
+    WriteLatencies(out, node.histogram);
+    out << "}";
+  }
+
+  out << "\n],\n\"op_types\": [";
+  bool is_first = true;
+  for (const auto& op_type : op_types) {
+    out << (is_first ? "\n" : ",\n") << "{\"op_type\": ";
+    WriteJsonString(out, op_type.first);
+    out << ", ";
+    WriteLatencies(out, op_type.second);
+    out << "}";
+    is_first = false;
+  }
+
+  out << "\n]\n}\n";
+  return out.str();
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
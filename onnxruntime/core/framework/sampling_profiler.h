@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+class GraphViewer;
+
+namespace profiling {
+
+/**
+Latency histogram with logarithmic buckets. Each power of two is split into 2^kSubBucketBits linear buckets, so the
+percentiles it reports are within 1/2^kSubBucketBits of the recorded value. Recording is lock-free and can be done
+concurrently from any number of threads.
+*/
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // up to 2^40ns (~18 minutes). longer durations are counted in the last bucket.
+  static constexpr int kMaxExponent = 40;
+  static constexpr size_t kNumBuckets = kSubBuckets * (kMaxExponent - kSubBucketBits + 2);
+
+  /** A consistent copy of the histogram that the statistics are computed from. */
+  struct Snapshot {
+    std::array<uint64_t, kNumBuckets> counts{};
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+
+    void Merge(const Snapshot& other);
+
+    /** Upper bound of the bucket holding the given percentile (0-100) of the recorded durations. */
+    uint64_t PercentileNs(double percentile) const;
+
+    uint64_t MeanNs() const { return count == 0 ? 0 : sum_ns / count; }
+  };
+
+  LatencyHistogram() = default;
+
+  void Record(uint64_t duration_ns) noexcept;
+
+  Snapshot GetSnapshot() const;
+
+  static size_t BucketIndex(uint64_t duration_ns) noexcept;
+  static uint64_t BucketUpperBoundNs(size_t bucket) noexcept;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LatencyHistogram);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts_{};
+  std::atomic<uint64_t> sum_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+/** Latency statistics of a node or an op type, as reported by SamplingProfiler. */
+struct LatencyStatistics {
+  std::string name;
+  std::string op_type;
+  std::string provider;
+  LatencyHistogram::Snapshot histogram;
+};
+
+/** Statistics of a session, collected over a graph and its subgraphs. */
+struct SamplingProfileReport {
+  uint32_t sample_rate = 0;
+  uint64_t sampled_runs = 0;
+  std::vector<LatencyStatistics> nodes;
+  // keyed by op type so the output is sorted
+  std::map<std::string, LatencyHistogram::Snapshot> op_types;
+
+  /** Writes the report as a JSON object with the count, mean, p50, p90, p99 and max latency in microseconds. */
+  std::string ToJson() const;
+};
+
+/**
+Low-overhead profiler that can be left enabled in production. It measures the kernel execution time of the nodes
+in 1 in sample_rate runs and records it in a fixed size latency histogram per node, so its memory use doesn't grow
+with the number of runs. The runs that are not sampled only pay for an atomic increment.
+*/
+class SamplingProfiler {
+ public:
+  SamplingProfiler(size_t num_nodes, uint32_t sample_rate);
+
+  /** Returns true if the run starting now should be profiled. */
+  bool ShouldSample() noexcept {
+    if (run_count_.fetch_add(1, std::memory_order_relaxed) % sample_rate_ != 0) {
+      return false;
+    }
+
+    sampled_runs_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void RecordNode(NodeIndex node_index, std::chrono::nanoseconds duration) noexcept {
+    if (node_index < node_histograms_.size()) {
+      node_histograms_[node_index]->Record(static_cast<uint64_t>(duration.count()));
+    }
+  }
+
+  uint32_t SampleRate() const noexcept { return sample_rate_; }
+  uint64_t SampledRuns() const noexcept { return sampled_runs_.load(std::memory_order_relaxed); }
+
+  /** Adds the statistics of the nodes of graph_viewer that were executed. Node names are prefixed with prefix. */
+  void AddToReport(const GraphViewer& graph_viewer, const std::string& prefix, SamplingProfileReport& report) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SamplingProfiler);
+
+  const uint32_t sample_rate_;
+  std::atomic<uint64_t> run_count_{0};
+  std::atomic<uint64_t> sampled_runs_{0};
+  std::vector<std::unique_ptr<LatencyHistogram>> node_histograms_;
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/scratch_allocator.h"
+
+namespace onnxruntime {
+
+ScratchAllocator::ScratchAllocator(AllocatorPtr allocator, void* buffer, size_t capacity)
+    : IAllocator(allocator->Info()),
+      allocator_(std::move(allocator)),
+      buffer_(static_cast<char*>(buffer)),
+      capacity_(buffer == nullptr ? 0 : capacity) {
+}
+
+void* ScratchAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  size_t aligned_size;
+  if (!CalcMemSizeForArrayWithAlignment<kAlignment>(size, 1, &aligned_size) || aligned_size > kOffsetMask) {
+    ORT_THROW("Temp space allocation of ", size, " bytes is too large");
+  }
+
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t next;
+  size_t offset;
+  do {
+    offset = static_cast<size_t>(state & kOffsetMask);
+    ORT_ENFORCE((state >> kOffsetBits) != (~uint64_t{0} >> kOffsetBits) && offset <= kOffsetMask - aligned_size,
+                "Too many live temp space allocations");
+    next = state + (uint64_t{1} << kOffsetBits) + aligned_size;
+  } while (!state_.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  const size_t end = offset + aligned_size;
+  size_t peak_size = peak_size_.load(std::memory_order_relaxed);
+  while (end > peak_size && !peak_size_.compare_exchange_weak(peak_size, end, std::memory_order_relaxed)) {
+  }
+
+  if (end <= capacity_) {
+    return buffer_ + offset;
+  }
+
+  void* p = nullptr;
+  ORT_TRY {
+    p = allocator_->Alloc(size);
+  }
+  ORT_CATCH(...) {
+    Release();
+    ORT_RETHROW;
+  }
+  return p;
+}
+
+void ScratchAllocator::Free(void* p) {
+  // Alloc(0) returns nullptr without taking a slot
+  if (p == nullptr) {
+    return;
+  }
+
+  char* const ptr = static_cast<char*>(p);
+  if (ptr < buffer_ || ptr >= buffer_ + capacity_) {
+    allocator_->Free(p);
+  }
+
+  Release();
+}
+
+void ScratchAllocator::Release() {
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    const uint64_t count = (state >> kOffsetBits) - 1;
+    // the last free makes the whole buffer available again
+    next = count == 0 ? 0 : state - (uint64_t{1} << kOffsetBits);
+  } while (!state_.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+}  // namespace onnxruntime
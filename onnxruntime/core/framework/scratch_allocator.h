@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+// Serves the temp space of the kernels of a Run from a buffer planned with the memory pattern, so a kernel's
+// scratch allocations don't go through the arena and its lock.
+// The allocations are carved one after the other from the start of the buffer, and the buffer is reused from the
+// start once all of them are freed, which happens between the nodes as the kernels free their temp space before
+// returning. The allocations that don't fit, e.g. while concurrent kernels hold temp space, fall back to the
+// underlying allocator. The allocator is lock free.
+// PeakSize returns the size of the buffer that would have served all the allocations so far. The frame records it
+// in the execution plan cache entry of the input shapes, so the later Runs with the same shapes carve all of their
+// temp space from the buffer.
+class ScratchAllocator : public IAllocator {
+ public:
+  // <buffer> may be null if <capacity> is 0. The buffer must outlive the allocations.
+  ScratchAllocator(AllocatorPtr allocator, void* buffer, size_t capacity);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  size_t PeakSize() const { return peak_size_.load(std::memory_order_relaxed); }
+
+  static constexpr size_t kAlignment = 64;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScratchAllocator);
+
+  // releases the slot of an allocation
+  void Release();
+
+  const AllocatorPtr allocator_;
+  char* const buffer_;
+  const size_t capacity_;
+
+  // the number of live allocations in the high bits and the offset of the next allocation in the low bits, so that
+  // the last free can reset the offset atomically. the offset also advances for the allocations that don't fit.
+  static constexpr int kOffsetBits = 48;
+  static constexpr uint64_t kOffsetMask = (uint64_t{1} << kOffsetBits) - 1;
+  std::atomic<uint64_t> state_{0};
+  std::atomic<size_t> peak_size_{0};
+};
+
+}  // namespace onnxruntime
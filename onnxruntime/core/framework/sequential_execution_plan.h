@@ -24,9 +24,12 @@ struct AllocPlanPerValue {
   AllocKind alloc_kind{AllocKind::kAllocate};
   MLDataType value_type{nullptr};
   OrtMemoryInfo location;
-  // reused_buffer is valid only if alloc_kind == kReuse. It indicates
+  // reused_buffer is valid only if alloc_kind == kReuse, kShare, kAlias or kSlice. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // byte offset of the data of this OrtValue in the reused buffer. non-zero for a kSlice, and for the values reusing
+  // the buffer of a kSlice.
+  size_t buffer_offset{0};
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
@@ -68,6 +71,15 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // Records whether a given node has fence on its input or output, key is node index.
   std::vector<bool> node_has_fence;
 
+  // Records the stream each node is assigned to for the parallel execution mode, key is node index.
+  // A node continues the stream of its only producer, and the ParallelExecutor runs the nodes of a stream one after
+  // another on the same thread. Empty if the plan isn't for parallel execution.
+  std::vector<int> node_stream_ids;
+
+  // Whether values passed between streams, or from a stream to the caller of Run, have a fence as they are produced
+  // by an execution provider that uses per-thread streams.
+  bool has_cross_stream_fences{false};
+
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
@@ -5,6 +5,7 @@
 
 #include <chrono>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include "core/common/common.h"
@@ -13,6 +14,9 @@
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/utils.h"
+#include "core/platform/hardware_counters.h"
+#include "core/platform/threadpool.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/debug_node_inputs_outputs_utils.h"
@@ -138,6 +142,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     tp = session_state.Profiler().StartTime();
   }
 
+  profiling::SamplingProfiler* const sampling_profiler = session_state.GetSamplingProfiler();
+  const bool is_sampled_run = sampling_profiler != nullptr && sampling_profiler->ShouldSample();
+  const bool profile_hardware_counters = is_profiler_enabled && session_state.ProfileHardwareCounters();
+
   ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
   const std::unordered_set<NodeIndex>* to_be_executed_nodes = nullptr;
 
@@ -165,6 +173,19 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 
   const auto& graph_viewer = session_state.GetGraphViewer();
 
+  // the nodes that only depend on the sticky inputs use the outputs of an earlier Run with the same sticky inputs
+  NodeResultCache* node_result_cache = session_state.GetNodeResultCache();
+  NodeResultCache::Key node_result_key;
+  std::shared_ptr<const NodeResultCache::Results> cached_results;
+  NodeResultCache::Results computed_results;
+  if (node_result_cache != nullptr) {
+    if (node_result_cache->GetKey(feed_mlvalue_idxs, feeds, node_result_key)) {
+      cached_results = node_result_cache->Lookup(node_result_key);
+    } else {
+      node_result_cache = nullptr;
+    }
+  }
+
 #ifdef CONCURRENCY_VISUALIZER
   // need unique name for the series. number of nodes should be good enough for a subgraph
   char series_name[MaxSeriesNameLengthInChars] = "MainGraph";
@@ -200,6 +221,22 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       continue;
     }
 
+    const std::vector<int>* memoized_outputs =
+        node_result_cache != nullptr ? node_result_cache->GetMemoizedOutputs(node_index) : nullptr;
+    if (memoized_outputs != nullptr && cached_results != nullptr) {
+      auto cached = cached_results->find(node_index);
+      if (cached != cached_results->end()) {
+        for (size_t i = 0; i < memoized_outputs->size(); ++i) {
+          if ((*memoized_outputs)[i] >= 0) {
+            ORT_RETURN_IF_ERROR(frame.SetMLValue((*memoized_outputs)[i], cached->second[i]));
+          }
+        }
+
+        ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, node_exec_plan, logger));
+        continue;
+      }
+    }
+
     const auto& node = *graph_viewer.GetNode(node_exec_plan.node_index);
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -231,7 +268,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 #endif
     // construct OpKernelContext
     // TODO: log kernel inputs?
-    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_,
+                                              stream_id_, end_of_stream_);
     // TODO: log kernel outputs?
     if (is_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -295,8 +333,31 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                input_activation_sizes, input_parameter_sizes, node_name_for_profiling);
     }
 
+    TimePoint sample_begin_time;
+    if (is_sampled_run) {
+      sample_begin_time = std::chrono::high_resolution_clock::now();
+    }
+
+    profiling::HardwareCounterValues kernel_counters;
+    bool has_kernel_counters = profile_hardware_counters && profiling::ReadHardwareCounters(kernel_counters);
+
+#ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
+    TraceLoggingWrite(telemetry_provider_handle,
+                      "OpStart",
+                      TraceLoggingValue(p_op_kernel->KernelDef().OpName().c_str(), "op_name"));
+#endif
+
     Status compute_status;
     {
+      // record the work the intra-op thread pool does for the kernel
+      const std::string parallel_for_event_name =
+          is_profiler_enabled ? node_name_for_profiling + "_parallel_for" : std::string();
+      std::unique_ptr<concurrency::ThreadPoolProfilingScope> thread_pool_profiling_scope;
+      if (is_profiler_enabled) {
+        thread_pool_profiling_scope = onnxruntime::make_unique<concurrency::ThreadPoolProfilingScope>(
+            session_state.Profiler(), parallel_for_event_name);
+      }
+
 #ifdef CONCURRENCY_VISUALIZER
       diagnostic::span span(series, "%s.%d", node.OpType().c_str(), node.Index());
 #endif
@@ -319,6 +380,17 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 #endif
     }
 
+    if (has_kernel_counters) {
+      profiling::HardwareCounterValues counters_after;
+      has_kernel_counters = profiling::ReadHardwareCounters(counters_after);
+      kernel_counters = counters_after - kernel_counters;
+    }
+
+    if (is_sampled_run) {
+      sampling_profiler->RecordNode(node_index, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                    std::chrono::high_resolution_clock::now() - sample_begin_time));
+    }
+
     if (!compute_status.IsOK()) {
       std::ostringstream ss;
       ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
@@ -328,6 +400,17 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       return Status(compute_status.Category(), compute_status.Code(), msg_string);
     }
 
+    if (memoized_outputs != nullptr) {
+      std::vector<OrtValue> outputs(memoized_outputs->size());
+      for (int i = 0; i < op_kernel_context.OutputCount(); ++i) {
+        const OrtValue* output = op_kernel_context.GetOutputMLValue(i);
+        if (output != nullptr) {
+          ORT_RETURN_IF_ERROR(node_result_cache->CopyResult(*output, outputs[i]));
+        }
+      }
+      computed_results.emplace(node_index, std::move(outputs));
+    }
+
     if (is_profiler_enabled) {
       // Calculate total output sizes for this operation.
       CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling);
@@ -345,19 +428,30 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                 << "\n";
 #endif
 
+      // Log additional operation args / info.
+      std::unordered_map<std::string, std::string> event_args{
+          {"op_name", p_op_kernel->KernelDef().OpName()},
+          {"provider", p_op_kernel->KernelDef().Provider()},
+          {"graph_index", std::to_string(p_op_kernel->Node().Index())},
+          {"exec_plan_index", std::to_string(node_index)},
+          {"activation_size", std::to_string(input_activation_sizes)},
+          {"parameter_size", std::to_string(input_parameter_sizes)},
+          {"output_size", std::to_string(total_output_sizes)},
+      };
+
+      if (has_kernel_counters) {
+        kernel_counters.AddToEventArgs(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::high_resolution_clock::now() - kernel_begin_time)
+                                           .count(),
+                                       event_args);
+      }
+
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      node_name_for_profiling + "_kernel_time",
                                                      kernel_begin_time,
-                                                     // Log additional operation args / info.
-                                                     {
-                                                         {"op_name", p_op_kernel->KernelDef().OpName()},
-                                                         {"provider", p_op_kernel->KernelDef().Provider()},
-                                                         {"graph_index", std::to_string(p_op_kernel->Node().Index())},
-                                                         {"exec_plan_index", std::to_string(node_index)},
-                                                         {"activation_size", std::to_string(input_activation_sizes)},
-                                                         {"parameter_size", std::to_string(input_parameter_sizes)},
-                                                         {"output_size", std::to_string(total_output_sizes)},
-                                                     });
+                                                     std::move(event_args));
+
+      utils::RecordArenaCounterEvents(session_state);
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -431,6 +525,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   }
 #endif
 
+  if (node_result_cache != nullptr) {
+    node_result_cache->Store(node_result_key, std::move(computed_results));
+  }
+
   VLOGS(logger, 1) << "Fetching output.";
   // ExecutionFrame::Finalize will update 'fetches' with the final output
   ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
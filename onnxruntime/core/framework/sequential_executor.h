@@ -18,8 +18,12 @@
 namespace onnxruntime {
 class SequentialExecutor : public IExecutor {
  public:
-  SequentialExecutor(const bool& terminate_flag = false, const bool only_execute_path_to_fetches = false)
-      : terminate_flag_{terminate_flag}, only_execute_path_to_fetches_(only_execute_path_to_fetches) {}
+  SequentialExecutor(const bool& terminate_flag = false, const bool only_execute_path_to_fetches = false,
+                     std::string stream_id = {}, bool end_of_stream = false)
+      : terminate_flag_{terminate_flag},
+        only_execute_path_to_fetches_(only_execute_path_to_fetches),
+        stream_id_(std::move(stream_id)),
+        end_of_stream_(end_of_stream) {}
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -31,5 +35,7 @@ class SequentialExecutor : public IExecutor {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
   const bool& terminate_flag_;
   const bool only_execute_path_to_fetches_;
+  const std::string stream_id_;
+  const bool end_of_stream_;
 };
 }  // namespace onnxruntime
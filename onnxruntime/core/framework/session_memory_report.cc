@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/session_memory_report.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include "core/framework/arena.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+namespace {
+void WriteJsonString(std::ostream& out, const std::string& str) {
+  out << '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+// The provider with an allocator for the location, or an empty string.
+std::string GetProviderType(const ExecutionProviders& execution_providers, const OrtMemoryInfo& location) {
+  for (const auto& xp : execution_providers) {
+    for (const auto& alloc : xp->GetAllocators()) {
+      if (alloc->Info() == location) {
+        return xp->Type();
+      }
+    }
+  }
+  return std::string();
+}
+
+void WriteLocation(std::ostream& out, const std::string& provider_type, const OrtMemoryInfo& location) {
+  out << "\"provider\":";
+  WriteJsonString(out, provider_type);
+  out << ",\"device\":";
+  WriteJsonString(out, location.name);
+  out << ",\"deviceId\":" << location.id;
+}
+
+// The shapes of a plan cache key, e.g. [1,128],[1,128]
+std::string KeyToString(const ExecutionPlanCache::Key& key) {
+  std::ostringstream ss;
+  for (size_t i = 0; i < key.size();) {
+    const auto rank = static_cast<size_t>(key[i++]);
+    ss << (i == 1 ? "[" : ",[");
+    for (size_t d = 0; d < rank && i < key.size(); ++d) {
+      ss << (d == 0 ? "" : ",") << key[i++];
+    }
+    ss << "]";
+  }
+  return ss.str();
+}
+}  // namespace
+
+std::string CreateSessionMemoryReport(const SessionState& session_state) {
+  const auto& execution_providers = session_state.GetExecutionProviders();
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  std::ostringstream ss;
+
+  // initializers, by location
+  std::vector<std::tuple<const OrtMemoryInfo*, size_t, size_t>> initializers;
+  for (const auto& entry : session_state.GetInitializedTensors()) {
+    if (!entry.second.IsTensor()) {
+      continue;
+    }
+    const auto& tensor = entry.second.Get<Tensor>();
+    auto it = std::find_if(initializers.begin(), initializers.end(), [&tensor](const auto& location_entry) {
+      return *std::get<0>(location_entry) == tensor.Location();
+    });
+    if (it == initializers.end()) {
+      initializers.emplace_back(&tensor.Location(), 0, 0);
+      it = initializers.end() - 1;
+    }
+    std::get<1>(*it)++;
+    std::get<2>(*it) += tensor.SizeInBytes();
+  }
+
+  ss << "{\"initializers\":[";
+  for (size_t i = 0; i < initializers.size(); ++i) {
+    ss << (i == 0 ? "" : ",") << "{";
+    const OrtMemoryInfo& location = *std::get<0>(initializers[i]);
+    WriteLocation(ss, GetProviderType(execution_providers, location), location);
+    ss << ",\"count\":" << std::get<1>(initializers[i]) << ",\"bytes\":" << std::get<2>(initializers[i]) << "}";
+  }
+
+  // pre-packed weights, by node
+  const auto& shared_prepacked_bytes = session_state.GetSharedPrePackedBytes();
+  const auto& owned_prepacked_bytes = session_state.GetOwnedPrePackedBytes();
+  size_t total_prepacked_bytes = 0;
+  size_t total_shared_prepacked_bytes = 0;
+  std::ostringstream prepacked_nodes;
+  bool first = true;
+  for (const auto& node : graph_viewer.Nodes()) {
+    const OpKernel* kernel = session_state.GetKernel(node.Index());
+    auto owned_it = owned_prepacked_bytes.find(node.Index());
+    const size_t bytes = (kernel != nullptr ? kernel->PrePackedBytes() : 0) +
+                         (owned_it != owned_prepacked_bytes.end() ? owned_it->second : 0);
+    auto shared_it = shared_prepacked_bytes.find(node.Index());
+    const size_t shared_bytes = shared_it != shared_prepacked_bytes.end() ? shared_it->second : 0;
+    if (bytes == 0 && shared_bytes == 0) {
+      continue;
+    }
+    total_prepacked_bytes += bytes;
+    total_shared_prepacked_bytes += shared_bytes;
+    prepacked_nodes << (first ? "" : ",") << "{\"name\":";
+    WriteJsonString(prepacked_nodes, node.Name());
+    prepacked_nodes << ",\"opType\":";
+    WriteJsonString(prepacked_nodes, node.OpType());
+    prepacked_nodes << ",\"bytes\":" << bytes << ",\"sharedBytes\":" << shared_bytes << "}";
+    first = false;
+  }
+  ss << "],\"prePacked\":{\"bytes\":" << total_prepacked_bytes << ",\"sharedBytes\":" << total_shared_prepacked_bytes
+     << ",\"nodes\":[" << prepacked_nodes.str() << "]}";
+
+  // planned activations, by input shapes, and the outputs of each node for the shapes with the largest peak
+  const auto& ort_value_name_idx_map = session_state.GetOrtValueNameIdxMap();
+  size_t largest_peak = 0;
+  std::vector<std::pair<const Node*, size_t>> node_bytes;
+  ss << ",\"plannedActivations\":[";
+  first = true;
+  session_state.ForEachExecutionPlanCacheEntry(
+      [&](const ExecutionPlanCache::Key& key, const ExecutionPlanCacheEntry& entry) {
+        if (entry.mem_patterns == nullptr) {
+          return;
+        }
+        const auto& mem_patterns = *entry.mem_patterns;
+        size_t total_peak = 0;
+        ss << (first ? "" : ",") << "{\"shapes\":";
+        WriteJsonString(ss, KeyToString(key));
+        ss << ",\"locations\":[";
+        for (size_t i = 0; i < mem_patterns.locations.size(); ++i) {
+          ss << (i == 0 ? "" : ",") << "{";
+          const OrtMemoryInfo& location = mem_patterns.locations[i];
+          WriteLocation(ss, GetProviderType(execution_providers, location), location);
+          ss << ",\"peakBytes\":" << mem_patterns.patterns[i].PeakSize() << "}";
+          total_peak += mem_patterns.patterns[i].PeakSize();
+        }
+        ss << "]}";
+        first = false;
+
+        if (total_peak <= largest_peak) {
+          return;
+        }
+        largest_peak = total_peak;
+        node_bytes.clear();
+        for (const auto& node : graph_viewer.Nodes()) {
+          size_t bytes = 0;
+          for (const auto* output_def : node.OutputDefs()) {
+            int ort_value_idx;
+            int location_idx;
+            if (output_def->Exists() && ort_value_name_idx_map.GetIdx(output_def->Name(), ort_value_idx).IsOK()) {
+              const MemoryBlock* block = entry.GetBlock(ort_value_idx, location_idx);
+              bytes += block != nullptr ? block->size_ : 0;
+            }
+          }
+          if (bytes > 0) {
+            node_bytes.emplace_back(&node, bytes);
+          }
+        }
+      });
+
+  std::sort(node_bytes.begin(), node_bytes.end(),
+            [](const std::pair<const Node*, size_t>& a, const std::pair<const Node*, size_t>& b) {
+              return a.second > b.second;
+            });
+  ss << "],\"nodes\":[";
+  for (size_t i = 0; i < node_bytes.size(); ++i) {
+    ss << (i == 0 ? "" : ",") << "{\"name\":";
+    WriteJsonString(ss, node_bytes[i].first->Name());
+    ss << ",\"opType\":";
+    WriteJsonString(ss, node_bytes[i].first->OpType());
+    ss << ",\"outputBytes\":" << node_bytes[i].second << "}";
+  }
+
+  // arenas
+  ss << "],\"arenas\":[";
+  first = true;
+  for (const auto& xp : execution_providers) {
+    for (const auto& alloc : xp->GetAllocators()) {
+      if (alloc->Info().alloc_type != OrtArenaAllocator) {
+        continue;
+      }
+      AllocatorStats stats;
+      static_cast<IArenaAllocator*>(alloc.get())->GetStats(&stats);
+      ss << (first ? "" : ",") << "{";
+      WriteLocation(ss, xp->Type(), alloc->Info());
+      ss << ",\"bytesInUse\":" << stats.bytes_in_use << ",\"peakBytesInUse\":" << stats.max_bytes_in_use
+         << ",\"bytesReserved\":" << stats.total_allocated_bytes << ",\"bytesLimit\":" << stats.bytes_limit
+         << ",\"allocations\":" << stats.num_allocs << ",\"extensions\":" << stats.num_arena_extensions << "}";
+      first = false;
+    }
+  }
+  ss << "]}";
+
+  return ss.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+namespace onnxruntime {
+
+class SessionState;
+
+/**
+Returns a JSON document with where the memory of an initialized session goes:
+- "initializers": the count and bytes of the initializers by provider and device. The initializers released after
+  being pre-packed are not included.
+- "prePacked": the bytes of the pre-packed weights of each node, owned by its kernel ("bytes") or by the shared
+  container of the environment ("sharedBytes").
+- "plannedActivations": the peak bytes per device of the memory pattern planned for each input shape signature,
+  the most recently used first.
+- "nodes": for the signature with the largest total peak, the bytes of the outputs of each node in the planned
+  buffers, largest first.
+- "arenas": the statistics of the arena allocators of the execution providers.
+Only the main graph is covered, not the subgraphs of control flow nodes.
+*/
+std::string CreateSessionMemoryReport(const SessionState& session_state);
+
+}  // namespace onnxruntime
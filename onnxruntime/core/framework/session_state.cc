@@ -3,17 +3,32 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/prepacked_weights_container.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
+#include "core/graph/graph_flatbuffers_utils.h"
+#include "core/graph/symbolic_dim.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
 using namespace ::onnxruntime::common;
@@ -148,7 +163,78 @@ const KernelCreateInfo& SessionState::GetNodeKernelCreateInfo(NodeIndex node_ind
   return *entry->second;
 }
 
-Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager) {
+namespace {
+// Returns true if the kernel of the node can be created and pre-pack its weights concurrently with other kernels.
+// That is limited to the kernels of the CPU execution provider for the built-in domains, as the kernels of custom
+// ops and other execution providers may share state between instances. Kernels with subgraphs are excluded as they
+// use the subgraph session state.
+bool SupportsParallelInitialization(const Node& node) {
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider || node.ContainsSubgraph()) {
+    return false;
+  }
+
+  const auto& domain = node.Domain();
+  return domain == kOnnxDomain || domain == kOnnxDomainAlias || domain == kMLDomain || domain == kMSDomain ||
+         domain == kMSNchwcDomain || domain == kMSFeaturizersDomain;
+}
+
+// Calls func for each node of the graph. The nodes for which SupportsParallelInitialization is true are processed
+// on the thread pool if there is one, the others sequentially on the calling thread. func must not modify state
+// that is shared between nodes.
+Status ForEachNodeForInitialization(const GraphViewer& graph_viewer, concurrency::ThreadPool* thread_pool,
+                                    const std::function<Status(const Node&)>& func) {
+  std::vector<const Node*> parallel_nodes;
+  for (const auto& node : graph_viewer.Nodes()) {
+    if (thread_pool != nullptr && SupportsParallelInitialization(node)) {
+      parallel_nodes.push_back(&node);
+    } else {
+      ORT_RETURN_IF_ERROR(func(node));
+    }
+  }
+
+  if (parallel_nodes.empty()) {
+    return Status::OK();
+  }
+
+  OrtMutex status_mutex;
+  Status status;
+  std::exception_ptr exception;
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(parallel_nodes.size()), [&](std::ptrdiff_t i) {
+        Status node_status;
+        ORT_TRY {
+          node_status = func(*parallel_nodes[i]);
+        }
+        ORT_CATCH(...) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            std::lock_guard<OrtMutex> lock(status_mutex);
+            if (!exception) {
+              exception = std::current_exception();
+            }
+          });
+        }
+
+        if (!node_status.IsOK()) {
+          std::lock_guard<OrtMutex> lock(status_mutex);
+          if (status.IsOK()) {
+            status = node_status;
+          }
+        }
+      });
+
+#ifndef ORT_NO_EXCEPTIONS
+  // rethrow on the calling thread so the kernel construction errors surface as they do sequentially
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+#endif
+
+  return status;
+}
+}  // namespace
+
+Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager,
+                                   concurrency::ThreadPool* thread_pool) {
   const GraphNodes& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
     size_t max_nodeid = 0;
@@ -157,19 +243,23 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1, nullptr);
-    for (auto& node : graph_viewer_->Nodes()) {
-      // construct and save the kernels
-      const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
-
-      // the execution provider was required to be valid to find the KernelCreateInfo so we don't need to check it here
-      onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
-      const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
-
-      auto op_kernel = kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci);
-
-      // assumes vector is already resize()'ed to the number of nodes in the graph
-      session_kernels_[node.Index()] = op_kernel.release();
-    }
+    ORT_RETURN_IF_ERROR(ForEachNodeForInitialization(
+        *graph_viewer_, thread_pool, [this, &kernel_registry_manager](const Node& node) -> Status {
+          // construct and save the kernels
+          const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
+
+          // the execution provider was required to be valid to find the KernelCreateInfo so we don't need to check
+          // it here
+          onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
+          const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
+
+          auto op_kernel = kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci);
+
+          // assumes vector is already resize()'ed to the number of nodes in the graph. every node writes its own
+          // slot so this is safe to do concurrently.
+          session_kernels_[node.Index()] = op_kernel.release();
+          return Status::OK();
+        }));
   }
   node_index_info_ = onnxruntime::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
   return Status::OK();
@@ -177,6 +267,21 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
 
 const SequentialExecutionPlan* SessionState::GetExecutionPlan() const { return p_seq_exec_plan_.get(); }
 
+void SessionState::AddToSamplingProfileReport(profiling::SamplingProfileReport& report,
+                                              const std::string& prefix) const {
+  if (sampling_profiler_ != nullptr) {
+    sampling_profiler_->AddToReport(*graph_viewer_, prefix, report);
+  }
+
+  for (const auto& node_subgraphs : subgraph_session_states_) {
+    const Node* node = graph_viewer_->GetNode(node_subgraphs.first);
+    const std::string node_prefix = prefix + (node ? node->Name() : std::string()) + "/";
+    for (const auto& subgraph : node_subgraphs.second) {
+      subgraph.second->AddToSamplingProfileReport(report, node_prefix + subgraph.first + "/");
+    }
+  }
+}
+
 Status SessionState::AddInitializedTensor(int ort_value_index, const OrtValue& ort_value, const OrtCallback* d,
                                           bool constant) {
   auto p = initialized_tensors_.insert({ort_value_index, ort_value});
@@ -234,7 +339,57 @@ void SessionState::CleanInitializedTensorsFromGraph() {
   graph_.CleanAllInitializedTensors();
 }
 
-Status SessionState::PrepackInitializedConstantTensors() {
+namespace {
+// The packed data depends on the kernel (the kernel def hash covers the op, domain, version, provider and type
+// constraints), the input it is packed for, the node attributes (e.g. transB) and the shape, type and content of
+// the initializer.
+std::string GeneratePrepackedWeightsKey(const Node& node, const KernelDef& kernel_def, int input_idx,
+                                        const Tensor& tensor) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+
+  auto hash_bytes = [&hash](const void* data, size_t len) {
+    // MurmurHash3 takes an int length, so hash large initializers in chunks
+    constexpr size_t kMaxChunk = size_t{1} << 30;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    do {
+      size_t chunk = std::min(len, kMaxChunk);
+      MurmurHash3::x86_128(bytes, gsl::narrow_cast<int32_t>(chunk), hash[0], &hash);
+      bytes += chunk;
+      len -= chunk;
+    } while (len > 0);
+  };
+  // the length goes first so that the concatenation of the strings can't be split differently
+  auto hash_str = [&hash_bytes](const std::string& str) {
+    const uint64_t size = str.size();
+    hash_bytes(&size, sizeof(size));
+    hash_bytes(str.data(), str.size());
+  };
+
+  // std::map so the attribute order is deterministic
+  std::map<std::string, const ONNX_NAMESPACE::AttributeProto*> sorted_attrs;
+  for (const auto& attr : node.GetAttributes()) {
+    sorted_attrs.emplace(attr.first, &attr.second);
+  }
+
+  for (const auto& attr : sorted_attrs) {
+    hash_str(attr.first);
+    hash_str(attr.second->SerializeAsString());
+  }
+
+  const auto& dims = tensor.Shape().GetDims();
+  hash_bytes(dims.data(), dims.size() * sizeof(int64_t));
+  hash_bytes(tensor.DataRaw(), tensor.SizeInBytes());
+
+  std::ostringstream key;
+  key << kernel_def.GetHash() << '_' << input_idx << '_' << tensor.GetElementType() << '_'
+      << hash[0] << '_' << hash[1] << '_' << hash[2] << '_' << hash[3];
+  return key.str();
+}
+}  // namespace
+
+Status SessionState::PrepackInitializedConstantTensors(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
+                                                       concurrency::ThreadPool* thread_pool,
+                                                       const std::unordered_set<int>& initializers_to_skip) {
   // calculate the use count of each value
   std::unordered_map<std::string, size_t> node_arg_use_count;
   for (const auto& node : GetGraphViewer().Nodes()) {
@@ -245,42 +400,213 @@ Status SessionState::PrepackInitializedConstantTensors() {
     });
   }
 
-  for (auto& node : GetGraphViewer().Nodes()) {
-    auto kernel = GetMutableKernel(node.Index());
-    int input_idx = 0;
-    for (auto& input_def : node.InputDefs()) {
-      if (input_def->Exists()) {
-        const std::string& input_name = input_def->Name();
-        int ort_value_idx;
-        ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(input_name, ort_value_idx));
-        if (constant_initialized_tensors_.count(ort_value_idx) &&
-            constant_initialized_tensors_[ort_value_idx].IsTensor()) {
-          bool is_packed = false;
-          const Tensor& const_initialized_tensor = constant_initialized_tensors_[ort_value_idx].Get<Tensor>();
-          ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, is_packed));
-          if (is_packed && node_arg_use_count.count(input_name) && --node_arg_use_count[input_name] == 0) {
-            // release the constant intialized tensor
-            initialized_tensors_.erase(ort_value_idx);
-            constant_initialized_tensors_.erase(ort_value_idx);
+  // the inputs packed by each node. the tensors are released once all the nodes are done packing as other nodes may
+  // be packing the same tensor concurrently.
+  struct PackedInput {
+    const std::string* name;
+    int ort_value_idx;
+  };
+  std::vector<std::vector<PackedInput>> packed_inputs(session_kernels_.size());
+
+  ORT_RETURN_IF_ERROR(ForEachNodeForInitialization(
+      GetGraphViewer(), thread_pool,
+      [this, &graph_location, &packed_inputs, &initializers_to_skip](const Node& node) -> Status {
+        auto kernel = GetMutableKernel(node.Index());
+        int input_idx = 0;
+        for (auto& input_def : node.InputDefs()) {
+          if (input_def->Exists()) {
+            const std::string& input_name = input_def->Name();
+            int ort_value_idx;
+            ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(input_name, ort_value_idx));
+            auto constant_it = constant_initialized_tensors_.find(ort_value_idx);
+            if (constant_it != constant_initialized_tensors_.end() && constant_it->second.IsTensor() &&
+                initializers_to_skip.count(ort_value_idx) == 0) {
+              bool is_packed = false;
+              const Tensor& const_initialized_tensor = constant_it->second.Get<Tensor>();
+              ORT_RETURN_IF_ERROR(UseSerializedPrePackedWeights(graph_location, node, *kernel, input_idx,
+                                                                const_initialized_tensor, is_packed));
+              if (is_packed) {
+                // the ORT format model has the buffers packed on this platform
+              } else if (prepacked_weights_container_ != nullptr) {
+                ORT_RETURN_IF_ERROR(PrePackWithSharing(node, *kernel, input_idx, const_initialized_tensor,
+                                                       is_packed));
+              } else if (save_prepacked_weights_) {
+                ORT_RETURN_IF_ERROR(PrePackForSaving(node, *kernel, input_idx, const_initialized_tensor,
+                                                     is_packed));
+              } else {
+                ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, is_packed));
+              }
+
+              if (is_packed) {
+                packed_inputs[node.Index()].push_back({&input_name, ort_value_idx});
+              }
+            }
           }
+          input_idx++;
         }
+
+        return Status::OK();
+      }));
+
+  for (const auto& node_packed_inputs : packed_inputs) {
+    for (const auto& packed_input : node_packed_inputs) {
+      auto use_count = node_arg_use_count.find(*packed_input.name);
+      if (use_count != node_arg_use_count.end() && --use_count->second == 0) {
+        // release the constant intialized tensor
+        initialized_tensors_.erase(packed_input.ort_value_idx);
+        constant_initialized_tensors_.erase(packed_input.ort_value_idx);
       }
-      input_idx++;
     }
   }
 
   return Status::OK();
 }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
-  for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+Status SessionState::PrePackWithSharing(const Node& node, OpKernel& kernel, int input_idx, const Tensor& tensor,
+                                        bool& is_packed) {
+  auto& container = *prepacked_weights_container_;
+  const std::string key = GeneratePrepackedWeightsKey(node, kernel.KernelDef(), input_idx, tensor);
+
+  std::lock_guard<OrtMutex> lock(container.GetMutex());
+  const PrePackedWeights* shared_weights = container.GetWeight(key);
+  if (shared_weights != nullptr) {
+    ORT_RETURN_IF_ERROR(kernel.UseSharedPrePackedBuffers(tensor, input_idx, *shared_weights, is_packed));
+    if (!is_packed) {
+      // the kernel doesn't support sharing, so it keeps its own copy
+      ORT_RETURN_IF_ERROR(kernel.PrePack(tensor, input_idx, is_packed));
+    } else {
+      shared_prepacked_bytes_[node.Index()] += std::accumulate(shared_weights->buffer_sizes_.cbegin(),
+                                                               shared_weights->buffer_sizes_.cend(), size_t{0});
+      if (save_prepacked_weights_) {
+        std::lock_guard<OrtMutex> weights_lock(prepacked_weights_mutex_);
+        prepacked_weights_to_save_[std::make_pair(node.Index(), input_idx)] = shared_weights;
+      }
+    }
+
+    return Status::OK();
+  }
+
+  PrePackedWeights weights;
+  ORT_RETURN_IF_ERROR(kernel.PrePackWithSharing(tensor, input_idx, container.GetAllocator(), is_packed, weights));
+
+  // an empty result means the kernel packed into its own buffers
+  if (is_packed && !weights.buffers_.empty()) {
+    const auto& stored_weights = container.WriteWeight(key, std::move(weights));
+    bool used_shared_buffers = false;
+    ORT_RETURN_IF_ERROR(kernel.UseSharedPrePackedBuffers(tensor, input_idx, stored_weights, used_shared_buffers));
+    ORT_RETURN_IF_NOT(used_shared_buffers, "Kernel for node ", node.Name(),
+                      " did not use the pre-packed buffers it produced for input ", input_idx);
+    shared_prepacked_bytes_[node.Index()] += std::accumulate(stored_weights.buffer_sizes_.cbegin(),
+                                                             stored_weights.buffer_sizes_.cend(), size_t{0});
+    if (save_prepacked_weights_) {
+      std::lock_guard<OrtMutex> weights_lock(prepacked_weights_mutex_);
+      prepacked_weights_to_save_[std::make_pair(node.Index(), input_idx)] = &stored_weights;
+    }
   }
-  return key;
+
+  return Status::OK();
+}
+
+Status SessionState::PrePackForSaving(const Node& node, OpKernel& kernel, int input_idx, const Tensor& tensor,
+                                      bool& is_packed) {
+  // not an arena, as the buffers live as long as the session
+  PrePackedWeights weights;
+  ORT_RETURN_IF_ERROR(kernel.PrePackWithSharing(tensor, input_idx, std::make_shared<CPUAllocator>(), is_packed,
+                                                weights));
+
+  // an empty result means the kernel packed into its own buffers, which can't be saved
+  if (!is_packed || weights.buffers_.empty()) {
+    return Status::OK();
+  }
+
+  const auto key = std::make_pair(node.Index(), input_idx);
+  std::lock_guard<OrtMutex> lock(prepacked_weights_mutex_);
+  const auto& stored_weights = owned_prepacked_weights_[key] = std::move(weights);
+  bool used_shared_buffers = false;
+  ORT_RETURN_IF_ERROR(kernel.UseSharedPrePackedBuffers(tensor, input_idx, stored_weights, used_shared_buffers));
+  ORT_RETURN_IF_NOT(used_shared_buffers, "Kernel for node ", node.Name(),
+                    " did not use the pre-packed buffers it produced for input ", input_idx);
+  owned_prepacked_bytes_[node.Index()] += std::accumulate(stored_weights.buffer_sizes_.cbegin(),
+                                                          stored_weights.buffer_sizes_.cend(), size_t{0});
+  prepacked_weights_to_save_[key] = &stored_weights;
+
+  return Status::OK();
+}
+
+Status SessionState::UseSerializedPrePackedWeights(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
+                                                   const Node& node, OpKernel& kernel, int input_idx,
+                                                   const Tensor& tensor, bool& is_packed) {
+  is_packed = false;
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+  const auto key = std::make_pair(node.Index(), input_idx);
+  auto entry = serialized_prepacked_weights_.find(key);
+  if (entry == serialized_prepacked_weights_.cend()) {
+    return Status::OK();
+  }
+
+  // a different kernel packs the initializer differently, so let it pack the initializer itself
+  const auto& fbs_weights = *entry->second;
+  const auto* fbs_buffers = fbs_weights.buffers();
+  if (fbs_weights.kernel_def_hash() != kernel.KernelDef().GetHash() || fbs_buffers == nullptr ||
+      fbs_buffers->size() == 0) {
+    return Status::OK();
+  }
+
+  // use the buffers in place from the model file if it's memory mapped, and copy them otherwise
+  PrePackedWeights weights;
+  std::vector<Env::MappedMemoryPtr> mappings;
+  AllocatorPtr allocator;
+  size_t copied_bytes = 0;
+  for (const auto* fbs_buffer : *fbs_buffers) {
+    const auto* data = fbs_buffer != nullptr ? fbs_buffer->data() : nullptr;
+    ORT_RETURN_IF(data == nullptr || data->size() == 0, "Missing data for a pre-packed buffer of node ", node.Name(),
+                  ". Invalid ORT format model.");
+
+    const size_t size = data->size();
+    const auto offset = mapped_model_bytes_ != nullptr ? data->Data() - mapped_model_bytes_ : -1;
+    if (offset >= 0 && offset % experimental::utils::kOrtFormatRawDataAlignment == 0) {
+      Env::MappedMemoryPtr mapped_memory;
+      ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(graph_location.c_str(), offset, size, mapped_memory));
+      weights.buffers_.push_back(BufferUniquePtr(mapped_memory.get(), BufferDeleter(nullptr)));
+      mappings.push_back(std::move(mapped_memory));
+    } else {
+      if (!allocator) {
+        allocator = std::make_shared<CPUAllocator>();
+      }
+      void* buffer = allocator->Alloc(size);
+      memcpy(buffer, data->Data(), size);
+      weights.buffers_.push_back(BufferUniquePtr(buffer, BufferDeleter(allocator)));
+      copied_bytes += size;
+    }
+    weights.buffer_sizes_.push_back(size);
+  }
+
+  std::lock_guard<OrtMutex> lock(prepacked_weights_mutex_);
+  auto stored = owned_prepacked_weights_.emplace(key, std::move(weights)).first;
+  ORT_RETURN_IF_ERROR(kernel.UseSharedPrePackedBuffers(tensor, input_idx, stored->second, is_packed));
+  if (!is_packed) {
+    owned_prepacked_weights_.erase(stored);
+    return Status::OK();
+  }
+
+  std::move(mappings.begin(), mappings.end(), std::back_inserter(prepacked_weights_mappings_));
+  if (copied_bytes > 0) {
+    owned_prepacked_bytes_[node.Index()] += copied_bytes;
+  }
+  if (save_prepacked_weights_) {
+    prepacked_weights_to_save_[key] = &stored->second;
+  }
+#else
+  ORT_UNUSED_PARAMETER(graph_location);
+  ORT_UNUSED_PARAMETER(node);
+  ORT_UNUSED_PARAMETER(kernel);
+  ORT_UNUSED_PARAMETER(input_idx);
+  ORT_UNUSED_PARAMETER(tensor);
+#endif
+
+  return Status::OK();
 }
 
-#ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
                         const std::map<std::string, TensorShape>& feeds,
@@ -327,12 +653,19 @@ Status ResolveSizeAndShape(
   SafeInt<size_t> safe_size = 1;
   for (auto& dim : arg->Shape()->dim()) {
     if (dim.has_dim_param()) {
-      auto it = symbolic_dimensions.find(dim.dim_param());
-      if (it == symbolic_dimensions.end()) {
+      // the dim_param is a symbol of the graph inputs or a polynomial of them computed by the shape inferencing
+      int64_t value = 0;
+      if (!SymbolicDim::Evaluate(dim.dim_param(), symbolic_dimensions, value)) {
         return Status(ONNXRUNTIME, FAIL, "Unknown symbolic dimension, " + dim.dim_param() + ", found in memory pattern compute.");
       }
-      safe_size *= it->second;
-      shape.push_back(it->second);
+      if (value < 0) {
+        // e.g. a difference of symbols that the inputs make negative. the size is left unresolved, and the kernel
+        // reports the invalid shape when it runs.
+        size = 0;
+        return Status::OK();
+      }
+      safe_size *= value;
+      shape.push_back(value);
     } else if (dim.has_dim_value() && dim.dim_value() > 0) {
       safe_size *= dim.dim_value();
       shape.push_back(dim.dim_value());
@@ -356,7 +689,8 @@ Status ResolveSizeAndShape(
 Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                                const std::vector<int>& feed_mlvalue_idxs,
                                                MemoryPatternGroup* output,
-                                               std::unordered_map<int, TensorShape>& resolved_shapes) const {
+                                               std::unordered_map<int, TensorShape>& resolved_shapes,
+                                               bool& all_sizes_resolved) const {
   std::map<std::string, TensorShape> feeds;
   for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
     std::string name;
@@ -368,7 +702,9 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
   auto* exe_plan = GetExecutionPlan();
   ORT_ENFORCE(exe_plan);
   OrtValuePatternPlanner mem_planner(*exe_plan);
+  all_sizes_resolved = true;
   auto& node_index_info = GetNodeIndexInfo();
+  std::vector<bool> traced(exe_plan->allocation_plan.size(), false);
   for (auto& node_plan : exe_plan->execution_plan) {
     int node_index = node_index_info.GetNodeOffset(node_plan.node_index);
     auto* node = graph_viewer_->GetNode(node_plan.node_index);
@@ -394,15 +730,32 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
         resolved_shapes[ml_value_idx] = resolved_shape;
       }
 
+      // the first slice placed in the buffer of a Concat output allocates the buffer
+      int alloc_idx = ml_value_idx;
+      const auto& value_plan = exe_plan->allocation_plan[ml_value_idx];
+      if (value_plan.alloc_kind == AllocKind::kSlice) {
+        alloc_idx = value_plan.reused_buffer;
+        std::string buffer_name;
+        ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetName(alloc_idx, buffer_name));
+        arg = graph_viewer_->GetNodeArg(buffer_name);
+        ORT_RETURN_IF_ERROR(ResolveSizeAndShape(arg, map, size, resolved_shape));
+      }
+
       // Plan memory if conditions are met.
-      if (exe_plan->allocation_plan[ml_value_idx].alloc_kind == AllocKind::kAllocate &&
-          ml_data_type != DataTypeImpl::GetType<std::string>() && size != 0) {
+      if (exe_plan->allocation_plan[alloc_idx].alloc_kind == AllocKind::kAllocate &&
+          ml_data_type != DataTypeImpl::GetType<std::string>() && !traced[alloc_idx]) {
+        if (size == 0) {
+          all_sizes_resolved = false;
+          continue;
+        }
+
         size_t aligned_size = 0;
         if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(size, ml_data_type->Size(), &aligned_size)) {
           return Status(ONNXRUNTIME, FAIL, "Size overflow");
         }
 
-        mem_planner.TraceAllocation(ml_value_idx, aligned_size);
+        mem_planner.TraceAllocation(alloc_idx, aligned_size);
+        traced[alloc_idx] = true;
       }
     }
     //release nodes
@@ -418,39 +771,42 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
     }
   }
 
-  if (!mem_planner.GeneratePatterns(output).IsOK()) {
+  // all the lifetimes are known upfront, so the offsets don't need to be assigned in allocation order
+  if (!mem_planner.GeneratePatterns(output, true).IsOK()) {
     return Status(ONNXRUNTIME, FAIL, "Generate Memory Pattern failed");
   }
   return Status::OK();
 }
-#endif
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
-                                                              const std::vector<int>& feed_mlvalue_idxs,
-                                                              std::unordered_map<int, TensorShape>& inferred_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+std::shared_ptr<const ExecutionPlanCacheEntry> SessionState::GetExecutionPlanCacheEntry(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+    const std::vector<int>& feed_mlvalue_idxs) const {
+  auto key = ExecutionPlanCache::MakeKey(input_shapes);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-#ifdef ENABLE_TRAINING
+  auto entry = execution_plan_cache_.Find(key);
+  if (entry == nullptr) {
+    // plan the memory from the symbolic shapes so the first Run with these input shapes doesn't need to trace it
     auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
-    if (GeneratePatternGroupCache(input_shapes, feed_mlvalue_idxs, mem_patterns.get(), inferred_shapes).IsOK()) {
-      key = CalculateMemoryPatternsKey(input_shapes);
-      auto ptr = mem_patterns.get();
-      mem_patterns_[key] = std::move(mem_patterns);
-      shape_patterns_[key] = inferred_shapes;
-      return ptr;
-    }
-    return nullptr;
-#else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
-    return nullptr;
+    std::unordered_map<int, TensorShape> inferred_shapes;
+    bool all_sizes_resolved = false;
+    if (GeneratePatternGroupCache(input_shapes, feed_mlvalue_idxs, mem_patterns.get(), inferred_shapes,
+                                  all_sizes_resolved)
+            .IsOK()) {
+#ifndef ENABLE_TRAINING
+      // an entry stops the frame from tracing the allocations, so the values whose size depends on the data (e.g.
+      // NonZero outputs) would never be part of a pattern. training uses the resolved shapes of partial plans.
+      if (!all_sizes_resolved) {
+        return entry;
+      }
 #endif
+      entry = std::make_shared<const ExecutionPlanCacheEntry>(std::move(mem_patterns), std::move(inferred_shapes),
+                                                              static_cast<size_t>(ort_value_name_idx_map_.MaxIdx()) + 1);
+      execution_plan_cache_.Insert(std::move(key), entry);
+    }
   }
 
-  inferred_shapes = shape_patterns_[key];
-  return it->second.get();
+  return entry;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -466,17 +822,28 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  auto key = ExecutionPlanCache::MakeKey(input_shapes);
+  auto entry = std::make_shared<const ExecutionPlanCacheEntry>(std::move(mem_patterns),
+                                                               std::unordered_map<int, TensorShape>(),
+                                                               static_cast<size_t>(ort_value_name_idx_map_.MaxIdx()) + 1);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
-  }
+  execution_plan_cache_.Insert(std::move(key), std::move(entry));
 
   return Status::OK();
 }
 
+void SessionState::SetExecutionPlanCacheCapacity(size_t capacity) {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  execution_plan_cache_.SetCapacity(capacity);
+}
+
+void SessionState::ForEachExecutionPlanCacheEntry(
+    const std::function<void(const ExecutionPlanCache::Key&, const ExecutionPlanCacheEntry&)>& func) const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  execution_plan_cache_.ForEach(func);
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
@@ -681,7 +1048,31 @@ Status SessionState::SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
   ORT_RETURN_IF_ERROR(
       GetSubGraphSessionStatesOrtFormat(builder, subgraph_session_states_, sub_graph_session_states));
 
-  fbs_session_state = fbs::CreateSessionStateDirect(builder, kernels, &sub_graph_session_states);
+  // Pre-packed weights, aligned like the raw data of the initializers so they can be used in place
+  std::vector<flatbuffers::Offset<fbs::PrePackedWeights>> prepacked_weights;
+  prepacked_weights.reserve(prepacked_weights_to_save_.size());
+  for (const auto& entry : prepacked_weights_to_save_) {
+    const auto& weights = *entry.second;
+    std::vector<flatbuffers::Offset<fbs::PrePackedBuffer>> buffers;
+    buffers.reserve(weights.buffers_.size());
+    for (size_t i = 0; i < weights.buffers_.size(); ++i) {
+      builder.ForceVectorAlignment(weights.buffer_sizes_[i], sizeof(uint8_t),
+                                   experimental::utils::kOrtFormatRawDataAlignment);
+      auto data = builder.CreateVector(static_cast<const uint8_t*>(weights.buffers_[i].get()),
+                                       weights.buffer_sizes_[i]);
+      buffers.push_back(fbs::CreatePrePackedBuffer(builder, data));
+    }
+
+    const NodeIndex node_index = entry.first.first;
+    prepacked_weights.push_back(fbs::CreatePrePackedWeightsDirect(
+        builder, gsl::narrow<uint32_t>(node_index), entry.first.second,
+        kernel_create_info_map_.at(node_index)->kernel_def->GetHash(), &buffers));
+  }
+
+  fbs_session_state = fbs::CreateSessionStateDirect(
+      builder, kernels, &sub_graph_session_states,
+      prepacked_weights.empty() ? nullptr : MlasGetPlatformSignature(),
+      prepacked_weights.empty() ? nullptr : &prepacked_weights);
   return Status::OK();
 }
 
@@ -704,7 +1095,8 @@ Status SessionState::CreateSubgraphSessionState() {
       auto subgraph_session_state =
           onnxruntime::make_unique<SessionState>(*subgraph, execution_providers_, enable_mem_pattern_,
                                                  thread_pool_, inter_op_thread_pool_, data_transfer_mgr_,
-                                                 logger_, profiler_);
+                                                 logger_, profiler_, use_deterministic_compute_,
+                                                 prepacked_weights_container_);
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
@@ -723,7 +1115,8 @@ Status SessionState::CreateSubgraphSessionState() {
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 Status SessionState::LoadFromOrtFormat(const fbs::SessionState& fbs_session_state,
-                                       const KernelRegistryManager& kernel_registry_manager) {
+                                       const KernelRegistryManager& kernel_registry_manager,
+                                       const uint8_t* mapped_model_bytes) {
   const auto* fbs_kcis = fbs_session_state.kernels();
   ORT_RETURN_IF(nullptr == fbs_kcis, "Kernel create info is null. Invalid ORT format model.");
   auto* node_indices = fbs_kcis->node_indices();
@@ -746,6 +1139,24 @@ Status SessionState::LoadFromOrtFormat(const fbs::SessionState& fbs_session_stat
     kernel_create_info_map_.emplace(node_idx, gsl::not_null<const KernelCreateInfo*>(kci));
   }
 
+  // the layout of the pre-packed weights depends on the platform they were packed on
+  const auto* fbs_prepacked_weights = fbs_session_state.prepacked_weights();
+  const auto* fbs_prepacked_weights_signature = fbs_session_state.prepacked_weights_signature();
+  if (fbs_prepacked_weights != nullptr && fbs_prepacked_weights_signature != nullptr) {
+    if (fbs_prepacked_weights_signature->str() == MlasGetPlatformSignature()) {
+      for (const auto* fbs_weights : *fbs_prepacked_weights) {
+        ORT_RETURN_IF(nullptr == fbs_weights, "Pre-packed weights entry is null. Invalid ORT format model.");
+        serialized_prepacked_weights_.emplace(
+            std::make_pair(static_cast<NodeIndex>(fbs_weights->node_index()), fbs_weights->input_index()),
+            fbs_weights);
+      }
+      mapped_model_bytes_ = mapped_model_bytes;
+    } else {
+      LOGS(logger_, INFO) << "The pre-packed weights in the model were packed on a different platform ("
+                          << fbs_prepacked_weights_signature->str() << ") and will be packed again.";
+    }
+  }
+
   if (!subgraph_session_states_.empty()) {
     auto* fbs_sub_graph_session_states = fbs_session_state.sub_graph_session_states();
     ORT_RETURN_IF(nullptr == fbs_sub_graph_session_states,
@@ -767,7 +1178,8 @@ Status SessionState::LoadFromOrtFormat(const fbs::SessionState& fbs_session_stat
         auto* fbs_sub_session_state = fbs_sub_graph_ss->session_state();
         ORT_RETURN_IF(nullptr == fbs_sub_session_state,
                       "Subgraph SessionState for ", key, " is null. Invalid ORT format model.");
-        subgraph_session_state.LoadFromOrtFormat(*fbs_sub_session_state, kernel_registry_manager);
+        subgraph_session_state.LoadFromOrtFormat(*fbs_sub_session_state, kernel_registry_manager,
+                                                 mapped_model_bytes);
       }
     }
   }
@@ -780,7 +1192,8 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
                                           KernelRegistryManager& kernel_registry_manager,
                                           const SessionOptions& session_options,
                                           const onnxruntime::experimental::fbs::SessionState* serialized_session_state,
-                                          bool remove_initializers) {
+                                          bool remove_initializers,
+                                          const uint8_t* mapped_model_bytes) {
   // recursively create the subgraph session state instances and populate the kernel create info in them.
   // it's simpler to handle the kernel create info recursively when deserializing,
   // so also do it recursively when calling PopulateKernelCreateInfo for consistency.
@@ -788,8 +1201,9 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
 
   if (serialized_session_state) {
 #if defined(ENABLE_ORT_FORMAT_LOAD)
-    ORT_RETURN_IF_ERROR(LoadFromOrtFormat(*serialized_session_state, kernel_registry_manager));
+    ORT_RETURN_IF_ERROR(LoadFromOrtFormat(*serialized_session_state, kernel_registry_manager, mapped_model_bytes));
 #else
+    ORT_UNUSED_PARAMETER(mapped_model_bytes);
     return Status(ONNXRUNTIME, INVALID_ARGUMENT,
                   "ORT format model is not supported in this build.");
 #endif
@@ -844,7 +1258,27 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   std::unique_ptr<ITensorAllocator> tensor_allocator_(
       ITensorAllocator::Create(enable_mem_pattern_, *p_seq_exec_plan_, *this, weights_buffers_));
 
-  // move initializers from TensorProto instances in Graph to OrtValue instances in SessionState
+  // the initializers and kernels are set up on the intra-op thread pool unless that is disabled
+  concurrency::ThreadPool* initialization_thread_pool =
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisableParallelInitialization, "0") == "1"
+          ? nullptr
+          : thread_pool_;
+
+  // in the lazy mode the initializers stored in external files aren't pre-packed, as that reads the whole tensor.
+  // they stay memory mapped so the kernels only page in the data they access.
+  std::unordered_set<int> initializers_to_not_prepack;
+  if (session_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazyLoadExternalInitializers, "0") == "1") {
+    for (const auto& entry : graph_viewer_->GetAllInitializedTensors()) {
+      int ort_value_idx;
+      if (utils::UsesExternalDataBuffer(*entry.second) &&
+          ort_value_name_idx_map_.GetIdx(entry.first, ort_value_idx).IsOK()) {
+        initializers_to_not_prepack.insert(ort_value_idx);
+      }
+    }
+  }
+
+  // move initializers from TensorProto instances in Graph to OrtValue instances in SessionState.
+  // the tensors of the CPU initializers which are removed from the Graph take its raw data instead of a copy of it.
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -853,7 +1287,8 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
           [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
             return AddInitializedTensor(idx, value, &d, constant);
           },
-          logger_, data_transfer_mgr_, *p_seq_exec_plan_.get(), session_options));
+          logger_, data_transfer_mgr_, *p_seq_exec_plan_.get(), session_options, initialization_thread_pool,
+          remove_initializers ? &graph_ : nullptr));
 
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
@@ -862,14 +1297,65 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
-  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
+  ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager, initialization_thread_pool));
+
+  const std::string sample_rate_str =
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingSampleRate, "");
+  if (!sample_rate_str.empty()) {
+    std::istringstream iss(sample_rate_str);
+    int64_t sample_rate = -1;
+    if (!(iss >> sample_rate) || !iss.eof() || sample_rate < 0 || sample_rate > std::numeric_limits<uint32_t>::max()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtSessionOptionsConfigProfilingSampleRate, ": ", sample_rate_str);
+    }
+
+    if (sample_rate > 0) {
+      sampling_profiler_ = onnxruntime::make_unique<profiling::SamplingProfiler>(session_kernels_.size(),
+                                                                                 static_cast<uint32_t>(sample_rate));
+    }
+  }
+
+  profile_hardware_counters_ =
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileHardwareCounters, "0") == "1";
+
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    const std::string warmup_runs_str =
+        session_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelExecutorWarmupRuns, "3");
+    std::istringstream warmup_runs_iss(warmup_runs_str);
+    int64_t warmup_runs = -1;
+    if (!(warmup_runs_iss >> warmup_runs) || !warmup_runs_iss.eof() || warmup_runs < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtSessionOptionsConfigParallelExecutorWarmupRuns, ": ", warmup_runs_str);
+    }
+
+    const std::string inline_node_cost_str =
+        session_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelExecutorInlineNodeCostUs, "20");
+    std::istringstream inline_node_cost_iss(inline_node_cost_str);
+    int64_t inline_node_cost_us = -1;
+    if (!(inline_node_cost_iss >> inline_node_cost_us) || !inline_node_cost_iss.eof() || inline_node_cost_us < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtSessionOptionsConfigParallelExecutorInlineNodeCostUs, ": ", inline_node_cost_str);
+    }
+
+    inline_node_cost_ = std::chrono::microseconds(inline_node_cost_us);
+    if (warmup_runs > 0) {
+      node_cost_model_ = onnxruntime::make_unique<NodeCostModel>(*graph_viewer_, static_cast<size_t>(warmup_runs));
+    }
+  }
 
   const auto disable_prepacking =
       session_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0");
+  save_prepacked_weights_ =
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigSavePrePackedWeights, "0") == "1";
 
   if (disable_prepacking != "1") {
-    ORT_RETURN_IF_ERROR(PrepackInitializedConstantTensors());
+    ORT_RETURN_IF_ERROR(PrepackInitializedConstantTensors(graph_location, initialization_thread_pool,
+                                                          initializers_to_not_prepack));
   }
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+  // they refer to the model bytes, which are freed after the session is initialized
+  serialized_prepacked_weights_.clear();
+#endif
 
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
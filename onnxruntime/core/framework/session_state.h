@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "gsl/gsl"
@@ -16,6 +18,7 @@
 #include "core/framework/allocation_planner.h"
 #include "core/framework/callback.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/execution_plan_cache.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
@@ -23,11 +26,15 @@
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/node_cost_model.h"
+#include "core/framework/node_result_cache.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sampling_profiler.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/path_lib.h"
 #include "core/platform/threadpool.h"
@@ -42,6 +49,7 @@ namespace onnxruntime {
 
 namespace experimental {
 namespace fbs {
+struct PrePackedWeights;
 struct SessionState;
 }  // namespace fbs
 }  // namespace experimental
@@ -52,6 +60,7 @@ class OpKernel;
 class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
+class PrepackedWeightsContainer;
 
 /**
  * SessionState should be modified by the inference session class only.
@@ -80,7 +89,8 @@ class SessionState {
                const DataTransferManager& data_transfer_mgr,
                const logging::Logger& logger,
                profiling::Profiler& profiler,
-               bool use_deterministic_compute = false)
+               bool use_deterministic_compute = false,
+               PrepackedWeightsContainer* prepacked_weights_container = nullptr)
       : graph_(graph),
         execution_providers_(execution_providers),
         logger_(logger),
@@ -89,7 +99,8 @@ class SessionState {
         thread_pool_(thread_pool),
         inter_op_thread_pool_(inter_op_thread_pool),
         data_transfer_mgr_(data_transfer_mgr),
-        use_deterministic_compute_(use_deterministic_compute) {
+        use_deterministic_compute_(use_deterministic_compute),
+        prepacked_weights_container_(prepacked_weights_container) {
     SetupAllocators();
   }
 
@@ -185,12 +196,12 @@ class SessionState {
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
   /**
-  Get cached memory pattern based on input shapes
+  Get the cached execution plan (memory pattern and resolved shapes) for the given input shapes.
+  Returns nullptr if there's no entry for the shapes yet.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const ExecutionPlanCacheEntry> GetExecutionPlanCacheEntry(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
-      const std::vector<int>& feed_mlvalue_idxs,
-      std::unordered_map<int, TensorShape>& inferred_shapes) const;
+      const std::vector<int>& feed_mlvalue_idxs) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -199,6 +210,31 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Set the maximum number of input shape signatures to keep execution plans for.
+  The least recently used entry is evicted when the limit is exceeded. 0 disables the cache.
+  */
+  void SetExecutionPlanCacheCapacity(size_t capacity);
+
+  /**
+  Call func with the key and the entry of each cached execution plan, the most recently used first.
+  */
+  void ForEachExecutionPlanCacheEntry(
+      const std::function<void(const ExecutionPlanCache::Key&, const ExecutionPlanCacheEntry&)>& func) const;
+
+  /**
+  Get the bytes of the pre-packed buffers of the shared container that the kernel of each node uses,
+  keyed on the node index. Nodes that don't use shared buffers have no entry.
+  */
+  const std::unordered_map<NodeIndex, size_t>& GetSharedPrePackedBytes() const { return shared_prepacked_bytes_; }
+
+  /**
+  Get the bytes of the pre-packed buffers that the session owns for the kernel of each node, which were copied from
+  the ORT format model or packed to be saved in one, keyed on the node index. Buffers used in place from a memory
+  mapped model are not included.
+  */
+  const std::unordered_map<NodeIndex, size_t>& GetOwnedPrePackedBytes() const { return owned_prepacked_bytes_; }
+
   bool GetUseDeterministicCompute() const { return use_deterministic_compute_; }
 
   /**
@@ -246,6 +282,34 @@ class SessionState {
   /// Return SessionState for the given Node index and attribute name if found.
   const SessionState* GetSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name) const;
 
+  /**
+  Get the sampling profiler of the graph, or nullptr if it is not enabled with the
+  kOrtSessionOptionsConfigProfilingSampleRate config.
+  */
+  profiling::SamplingProfiler* GetSamplingProfiler() const noexcept { return sampling_profiler_.get(); }
+
+  /**
+  Get the cost model the ParallelExecutor schedules the nodes of the graph with, or nullptr if the graph is not run
+  with ExecutionMode::ORT_PARALLEL or the kOrtSessionOptionsConfigParallelExecutorWarmupRuns config is 0.
+  */
+  NodeCostModel* GetNodeCostModel() const noexcept { return node_cost_model_.get(); }
+
+  /**
+  Get the cache of the outputs of the nodes that only depend on the sticky inputs, or nullptr if the
+  kOrtSessionOptionsConfigStickyInputs config isn't set or no node can be memoized.
+  */
+  NodeResultCache* GetNodeResultCache() const noexcept { return node_result_cache_.get(); }
+  void SetNodeResultCache(std::unique_ptr<NodeResultCache> cache) noexcept { node_result_cache_ = std::move(cache); }
+
+  /** Nodes with a lower estimated cost are run inline by the ParallelExecutor. */
+  std::chrono::nanoseconds GetInlineNodeCost() const noexcept { return inline_node_cost_; }
+
+  /** Return true if the node events of the Profiler include the hardware performance counters. */
+  bool ProfileHardwareCounters() const noexcept { return profile_hardware_counters_; }
+
+  /** Add the statistics of the sampling profilers of the graph and its subgraphs to the report. */
+  void AddToSamplingProfileReport(profiling::SamplingProfileReport& report, const std::string& prefix = "") const;
+
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
@@ -269,15 +333,21 @@ class SessionState {
 #endif
 
 #if defined(ENABLE_ORT_FORMAT_LOAD)
+  // mapped_model_bytes is the start of the model bytes if they are memory mapped from the model file at graph_loc.
   Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::SessionState& fbs_session_state,
-                           const KernelRegistryManager& kernel_registry_manager);
+                           const KernelRegistryManager& kernel_registry_manager,
+                           const uint8_t* mapped_model_bytes = nullptr);
 #endif
 
+  // mapped_model_bytes is the start of the bytes of the ORT format model containing serialized_session_state if
+  // they are memory mapped from the model file at graph_loc. The serialized pre-packed weights are then used in place
+  // from the file instead of being copied.
   Status FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                               KernelRegistryManager& kernel_registry_manager,
                               const SessionOptions& session_options = {},
                               const onnxruntime::experimental::fbs::SessionState* serialized_session_state = nullptr,
-                              bool remove_initializers = true);
+                              bool remove_initializers = true,
+                              const uint8_t* mapped_model_bytes = nullptr);
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
@@ -287,8 +357,9 @@ class SessionState {
   // Populate OrtValueNameIdxMap and create the graph viewer.
   void CreateGraphInfo();
 
-  // create kernels using info in kernel_create_info_map_
-  Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
+  // create kernels using info in kernel_create_info_map_.
+  // the kernels of the CPU execution provider are created on thread_pool if it is not null.
+  Status CreateKernels(const KernelRegistryManager& custom_registry_manager, concurrency::ThreadPool* thread_pool);
 
   // remove TensorProto versions of initializers from Graph instance
   // (replaced byOrtValue instances in initialized_tensors_)
@@ -297,8 +368,24 @@ class SessionState {
   /**
   * Prepack the constant initialized tensors for better performance.
   * The original constant initialized tensors will be removed to save memory.
+  * The kernels of the CPU execution provider pre-pack on thread_pool if it is not null.
+  * The initializers with an ort value index in initializers_to_skip are not pre-packed.
+  * The pre-packed weights saved in the ORT format model at graph_loc are used instead of packing where possible.
   */
-  Status PrepackInitializedConstantTensors();
+  Status PrepackInitializedConstantTensors(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+                                           concurrency::ThreadPool* thread_pool,
+                                           const std::unordered_set<int>& initializers_to_skip);
+
+  // Pre-pack <tensor> for <kernel>, re-using the buffers in prepacked_weights_container_ if another session has
+  // already packed the same initializer for the same kernel, and adding them to it otherwise.
+  Status PrePackWithSharing(const Node& node, OpKernel& kernel, int input_idx, const Tensor& tensor, bool& is_packed);
+
+  // Pre-pack <tensor> for <kernel> into buffers owned by this session so they can be saved in an ORT format model.
+  Status PrePackForSaving(const Node& node, OpKernel& kernel, int input_idx, const Tensor& tensor, bool& is_packed);
+
+  // Use the pre-packed weights saved in the ORT format model for <kernel>. is_packed is false if there are none.
+  Status UseSerializedPrePackedWeights(const std::basic_string<PATH_CHAR_TYPE>& graph_loc, const Node& node,
+                                       OpKernel& kernel, int input_idx, const Tensor& tensor, bool& is_packed);
 
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
@@ -317,13 +404,14 @@ class SessionState {
                                   const SessionOptions& session_options,
                                   bool remove_initializers);
 
-#ifdef ENABLE_TRAINING
+  // Plan the memory pattern from the shapes of the graph inputs, whose symbolic dimensions are resolved with the
+  // feed shapes. all_sizes_resolved is set to false if the size of a value in the pattern could not be resolved.
   Status GeneratePatternGroupCache(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
       const std::vector<int>& feed_mlvalue_idxs,
       MemoryPatternGroup* output,
-      std::unordered_map<int, TensorShape>& inferred_shapes) const;
-#endif
+      std::unordered_map<int, TensorShape>& inferred_shapes,
+      bool& all_sizes_resolved) const;
 
   // KernelCreateInfo for each node so we do kernel lookup once
   std::unordered_map<NodeIndex, gsl::not_null<const KernelCreateInfo*>> kernel_create_info_map_;
@@ -388,12 +476,11 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
+  // lock for the execution_plan_cache_
   mutable OrtMutex mem_patterns_lock_;
 
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
-  mutable std::map<int64_t, std::unordered_map<int, TensorShape>> shape_patterns_;
+  // cache for the generated mem_patterns and resolved shapes. key is calculated based on input shapes.
+  mutable ExecutionPlanCache execution_plan_cache_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -414,6 +501,41 @@ class SessionState {
 
   bool use_deterministic_compute_;
 
+  // If set, pre-packed weights are shared with the other sessions using the container. Not owned.
+  PrepackedWeightsContainer* const prepacked_weights_container_;
+  // written under the mutex of prepacked_weights_container_
+  std::unordered_map<NodeIndex, size_t> shared_prepacked_bytes_;
+
+  // Pre-packed weights owned by this session, either loaded from an ORT format model or packed to be saved in one,
+  // keyed on the node index and the input index. This and the three members below are written under
+  // prepacked_weights_mutex_.
+  std::map<std::pair<NodeIndex, int>, PrePackedWeights> owned_prepacked_weights_;
+  std::unordered_map<NodeIndex, size_t> owned_prepacked_bytes_;
+  // The pre-packed weights to save in an ORT format model, owned by owned_prepacked_weights_ or the shared container.
+  std::map<std::pair<NodeIndex, int>, const PrePackedWeights*> prepacked_weights_to_save_;
+  // The memory mapped regions of the model file that the buffers in owned_prepacked_weights_ refer to.
+  std::vector<Env::MappedMemoryPtr> prepacked_weights_mappings_;
+  OrtMutex prepacked_weights_mutex_;
+  bool save_prepacked_weights_ = false;
+
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+  // The pre-packed weights in the ORT format model being loaded, keyed on the node index and the input index.
+  // Empty if they were packed on a different platform. Only valid while the session state is being finalized as
+  // they refer to the model bytes.
+  std::map<std::pair<NodeIndex, int>, const onnxruntime::experimental::fbs::PrePackedWeights*>
+      serialized_prepacked_weights_;
+  // Start of the model bytes if they are memory mapped from the model file, see FinalizeSessionState.
+  const uint8_t* mapped_model_bytes_ = nullptr;
+#endif
+
+  std::unique_ptr<profiling::SamplingProfiler> sampling_profiler_;
+
+  bool profile_hardware_counters_ = false;
+
+  std::unique_ptr<NodeCostModel> node_cost_model_;
+  std::unique_ptr<NodeResultCache> node_result_cache_;
+  std::chrono::nanoseconds inline_node_cost_{std::chrono::microseconds(20)};
+
   std::unique_ptr<NodeIndexInfo> node_index_info_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
 
@@ -23,6 +23,7 @@
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 namespace session_state_utils {
@@ -87,6 +88,25 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+// copy a user supplied CPU tensor to the buffer of an initializer planned on another device
+static common::Status CopyUserSuppliedTensor(const Tensor& src, const MemBuffer& m, OrtValue& ort_value,
+                                             const DataTransferManager& data_transfer_mgr) {
+  if (src.IsDataTypeString()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "string tensor is not supported for copying between allocators");
+  }
+  if (m.GetLen() < src.SizeInBytes()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The preallocated buffer is too small for the user supplied tensor. ",
+                           "Requires ", src.SizeInBytes(), ", Got ", m.GetLen());
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(src.DataType(), src.Shape(), m.GetBuffer(), m.GetAllocInfo());
+  ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(src, *p_tensor));
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return common::Status::OK();
+}
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const OrtMemoryInfo& default_cpu_memory_info,
@@ -94,55 +114,82 @@ common::Status SaveInitializedTensors(
     const std::function<Status(int idx, const OrtValue& value, const OrtCallback& d, bool constant)>& save_tensor_func,
     const logging::Logger& logger, const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
-    const SessionOptions& session_options) {
+    const SessionOptions& session_options,
+    concurrency::ThreadPool* thread_pool,
+    Graph* removed_initializers_graph) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
   // Determine if an intializer was supplied by the user for the purpose of sharing and if it requires a cross-device
   // copy. In case a cross-device copy is required, sharing cannot be accomplished since we allocate our own buffer
-  // for the destn device which cannot be shared between sessions.
+  // for the destn device which cannot be shared between sessions. A user supplied CPU tensor is still the source of
+  // that copy instead of the tensor proto, so sessions on different devices only need to decode it once.
+  enum class UserSuppliedInitializer { None, Share, CopyFrom };
   auto use_user_supplied_initializer =
-      [&session_options, &exec_plan, &logger, &ort_value_name_idx_map](const std::string& name) -> bool {
-    bool retval = false;
+      [&session_options, &exec_plan, &logger, &ort_value_name_idx_map](const std::string& name) {
     auto it = session_options.initializers_to_share_map.find(name);
-    if (it == session_options.initializers_to_share_map.end()) {
-      retval = false;
-    } else {
-      int ort_value_index = -1;
-      if (!ort_value_name_idx_map.GetIdx(name, ort_value_index).IsOK()) {
-        retval = false;
-      } else {
-        auto planned_mem_info = exec_plan.GetLocation(ort_value_index);
-        auto user_mem_info = it->second->Get<Tensor>().Location();
-        retval = user_mem_info.device == planned_mem_info.device;
-        if (!retval) {
-          LOGS(logger, WARNING) << "Cannot use user supplied initializer with name: ("
-                                << name << ") because the ORT planned memory location device "
-                                << planned_mem_info.ToString()
-                                << " ) is different from what is supplied (" << user_mem_info.ToString() << ")";
-        }
-      }
+    int ort_value_index = -1;
+    if (it == session_options.initializers_to_share_map.end() ||
+        !ort_value_name_idx_map.GetIdx(name, ort_value_index).IsOK()) {
+      return UserSuppliedInitializer::None;
+    }
+
+    auto planned_mem_info = exec_plan.GetLocation(ort_value_index);
+    auto user_mem_info = it->second->Get<Tensor>().Location();
+    if (user_mem_info.device == planned_mem_info.device) {
+      return UserSuppliedInitializer::Share;
+    }
+    if (user_mem_info.device.Type() == OrtDevice::CPU) {
+      LOGS(logger, INFO) << "Copying user supplied initializer with name (" << name << ") to the ORT planned memory "
+                         << "location " << planned_mem_info.ToString();
+      return UserSuppliedInitializer::CopyFrom;
     }
 
-    return retval;
+    LOGS(logger, WARNING) << "Cannot use user supplied initializer with name: ("
+                          << name << ") because the ORT planned memory location device "
+                          << planned_mem_info.ToString()
+                          << " ) is different from what is supplied (" << user_mem_info.ToString() << ")";
+    return UserSuppliedInitializer::None;
   };
 
   //1. first plan the memory
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
   std::set<int> user_supplied_initializer_ids;  // set containing the ort value ids of all user supplied initializers
+  // set containing the ort value ids of the initializers copied from a user supplied CPU tensor
+  std::set<int> copied_initializer_ids;
+  // set containing the ort value ids of the CPU initializers which use the memory mapped data of their external file
+  std::set<int> external_data_initializer_ids;
+  // set containing the ort value ids of the CPU initializers which use the raw data moved out of their TensorProto
+  std::set<int> raw_data_initializer_ids;
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
-    if (use_user_supplied_initializer(entry.first)) {
+    const auto user_supplied = use_user_supplied_initializer(entry.first);
+    if (user_supplied == UserSuppliedInitializer::Share) {
       user_supplied_initializer_ids.insert(ort_value_index);
+    } else if (user_supplied == UserSuppliedInitializer::CopyFrom) {
+      copied_initializer_ids.insert(ort_value_index);
+    } else if (utils::UsesExternalDataBuffer(*entry.second)) {
+      const OrtMemoryInfo& location = exec_plan.GetLocation(ort_value_index);
+      if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+        external_data_initializer_ids.insert(ort_value_index);
+      }
+    } else if (removed_initializers_graph != nullptr && utils::UsesRawDataBuffer(*entry.second)) {
+      const OrtMemoryInfo& location = exec_plan.GetLocation(ort_value_index);
+      if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+        raw_data_initializer_ids.insert(ort_value_index);
+      }
     }
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
 
   for (const auto& entry : id_to_initialized_tensor) {
-    // We don't want to trace shared initializers since their memory is provided by the user
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
+    // We don't want to trace shared initializers since their memory is provided by the user, or the initializers
+    // in external files or with moved raw data since the tensors use that data so a buffer isn't needed
+    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end() ||
+        external_data_initializer_ids.find(entry.first) != external_data_initializer_ids.end() ||
+        raw_data_initializer_ids.find(entry.first) != raw_data_initializer_ids.end()) {
       continue;
     }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
@@ -160,42 +207,117 @@ common::Status SaveInitializedTensors(
                        << i.second << " bytes for " << i.first << std::endl;
   }
 
-  OrtCallback deleter{nullptr, nullptr};
-
   //3. create weight tensors based on weights buffer
+  struct InitializedTensor {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::unique_ptr<MemBuffer> m;
+    // user supplied CPU tensor to copy to m instead of deserializing tensor_proto
+    const OrtValue* copy_source = nullptr;
+    // whether the tensor is created on the raw data moved out of tensor_proto
+    bool move_raw_data = false;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+
+  // the planner isn't thread safe so get all the buffers first
+  std::vector<InitializedTensor> tensors(id_to_initialized_tensor.size());
+  std::vector<size_t> cpu_tensor_indices;
+  size_t tensor_idx = 0;
   for (const auto& entry : id_to_initialized_tensor) {
-    int ort_value_index = entry.first;
+    InitializedTensor& tensor = tensors[tensor_idx];
+    tensor.ort_value_index = entry.first;
+    tensor.tensor_proto = entry.second;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    OrtValue ort_value;
 
     if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
-      ort_value = *(session_options.initializers_to_share_map.at(name));
+      tensor.ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
+    } else if (external_data_initializer_ids.find(entry.first) != external_data_initializer_ids.end()) {
+      tensor.m = onnxruntime::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(entry.first));
+      if (thread_pool != nullptr) {
+        cpu_tensor_indices.push_back(tensor_idx);
+      }
+    } else if (raw_data_initializer_ids.find(entry.first) != raw_data_initializer_ids.end()) {
+      tensor.m = onnxruntime::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(entry.first));
+      tensor.move_raw_data = true;
+      if (thread_pool != nullptr) {
+        cpu_tensor_indices.push_back(tensor_idx);
+      }
     } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
-
-      std::unique_ptr<MemBuffer> m;
       // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m));
+      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(entry.first, name, tensor.m));
 #ifndef NDEBUG
-      ORT_ENFORCE(m != nullptr);
-      ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
+      ORT_ENFORCE(tensor.m != nullptr);
+      ORT_ENFORCE(tensor.m->GetBuffer() != nullptr || tensor.m->GetLen() == 0);
 #endif
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, default_cpu_memory_info, ort_value, deleter,
-                                         data_transfer_mgr);
-      if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
+      if (copied_initializer_ids.find(entry.first) != copied_initializer_ids.end()) {
+        tensor.copy_source = session_options.initializers_to_share_map.at(name);
+      }
+      const OrtMemoryInfo& alloc_info = tensor.m->GetAllocInfo();
+      if (thread_pool != nullptr && tensor.copy_source == nullptr &&
+          (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput)) {
+        cpu_tensor_indices.push_back(tensor_idx);
       }
     }
 
+    tensor_idx++;
+  }
+
+  auto deserialize_tensor = [&](InitializedTensor& tensor) {
+    ORT_TRY {
+      if (tensor.copy_source != nullptr) {
+        tensor.status = CopyUserSuppliedTensor(tensor.copy_source->Get<Tensor>(), *tensor.m, tensor.ort_value,
+                                               data_transfer_mgr);
+      } else if (tensor.move_raw_data) {
+        // the swap with an empty string doesn't copy the data, and leaves the TensorProto with its type and shape
+        auto raw_data = onnxruntime::make_unique<std::string>();
+        removed_initializers_graph->ReleaseInitializedTensorRawData(tensor.tensor_proto->name(), *raw_data);
+        tensor.status = utils::RawDataToMLValue(*tensor.tensor_proto, std::move(raw_data), tensor.m->GetAllocInfo(),
+                                                tensor.ort_value, tensor.deleter);
+      } else {
+        tensor.status = DeserializeTensorProto(env, graph_loc, *tensor.tensor_proto, *tensor.m,
+                                               default_cpu_memory_info, tensor.ort_value, tensor.deleter,
+                                               data_transfer_mgr);
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        tensor.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      });
+    }
+  };
+
+  // tensors on other devices are copied through the data transfer manager so deserialize them sequentially.
+  // without a thread pool all the tensors are deserialized here.
+  for (size_t i = 0, cpu_i = 0; i < tensors.size(); i++) {
+    if (cpu_i < cpu_tensor_indices.size() && cpu_tensor_indices[cpu_i] == i) {
+      cpu_i++;
+    } else if (tensors[i].m != nullptr) {
+      deserialize_tensor(tensors[i]);
+    }
+  }
+
+  // CPU tensors are independent of each other, so decode and copy them in parallel
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(cpu_tensor_indices.size()),
+      [&](std::ptrdiff_t i) { deserialize_tensor(tensors[cpu_tensor_indices[i]]); });
+
+  for (auto& tensor : tensors) {
+    const char* name = (tensor.tensor_proto->name().empty()) ? "" : tensor.tensor_proto->name().c_str();
+    if (!tensor.status.IsOK()) {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << name << " failed." << tensor.status.ErrorMessage();
+      return Status(tensor.status.Category(), tensor.status.Code(), oss.str());
+    }
+
     // any outer scope value is shadowed by a local value and can't override it.
     // due to that check_outer_scope is false
     bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    ORT_RETURN_IF_ERROR(save_tensor_func(tensor.ort_value_index, tensor.ort_value, tensor.deleter, constant));
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << tensor.ort_value_index;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
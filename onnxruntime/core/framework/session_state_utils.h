@@ -16,6 +16,7 @@ class Env;
 class KernelRegistryManager;
 class Node;
 class SessionState;
+class Graph;
 class GraphViewer;
 class OrtValueNameIdxMap;
 class DataTransferManager;
@@ -25,7 +26,14 @@ namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace session_state_utils {
+// If removed_initializers_graph is not null, its initializers are removed after they are saved, so the CPU tensors
+// of the initializers with raw data are created on the raw data moved out of their TensorProto instead of on a
+// planned buffer the data is copied to. This keeps the memory used by the initializers at the size of the model.
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const OrtMemoryInfo& default_cpu_memory_info,
@@ -35,7 +43,9 @@ common::Status SaveInitializedTensors(
     const logging::Logger& logger,
     const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
-    const SessionOptions& session_options);
+    const SessionOptions& session_options,
+    concurrency::ThreadPool* thread_pool = nullptr,
+    Graph* removed_initializers_graph = nullptr);
 
 common::Status SaveInputOutputNamesToNodeMapping(const GraphViewer& graph,
                                                  SessionState& session_state,
@@ -17,6 +17,13 @@ Tensor::Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, const
   Init(p_type, shape, p_data, nullptr, offset);
 }
 
+Tensor::Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, std::shared_ptr<IAllocator> deleter,
+               ptrdiff_t offset)
+    : alloc_info_(deleter->Info()) {
+  ORT_ENFORCE(p_type != nullptr);
+  Init(p_type, shape, p_data, deleter, offset);
+}
+
 Tensor::Tensor(MLDataType p_type, const TensorShape& shape, std::shared_ptr<IAllocator> allocator)
     : alloc_info_(allocator->Info()) {
   ORT_ENFORCE(p_type != nullptr);
@@ -10,14 +10,11 @@
 namespace onnxruntime {
 
 TensorShape::TensorShape(const int64_t* dimension_sizes, size_t dimension_count)
-    : std::vector<int64_t>(dimension_count) {
-  for (size_t i = 0; i < dimension_count; ++i) {
-    (*this)[i] = dimension_sizes[i];
-  }
+    : std::vector<int64_t>(dimension_sizes, dimension_sizes + dimension_count) {
 }
 
-TensorShape::TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end) {
-  assign(dims.begin() + start, dims.begin() + end);
+TensorShape::TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end)
+    : std::vector<int64_t>(dims.begin() + start, dims.begin() + end) {
 }
 
 /**
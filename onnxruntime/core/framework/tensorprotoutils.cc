@@ -414,12 +414,94 @@ static Status GetFileContent(
   return Status::OK();
 }
 
+// Gets the path of the file with the external data of 'tensor_proto', relative to the directory of
+// 'tensor_proto_path' if it's given, and the location of the data in it.
+static Status GetExternalDataLocation(const ORTCHAR_T* tensor_proto_path,
+                                      const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                      std::basic_string<ORTCHAR_T>& full_path, FileOffsetType& offset,
+                                      size_t& length) {
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+  if (tensor_proto_path != nullptr) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
+    full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
+  } else {
+    full_path = external_data_info->GetRelPath();
+  }
+
+  offset = external_data_info->GetOffset();
+  length = external_data_info->GetLength();
+  return Status::OK();
+}
+
+Status PrefetchExternalData(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                            const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL) {
+    return Status::OK();
+  }
+
+  std::basic_string<ORTCHAR_T> full_path;
+  FileOffsetType offset;
+  size_t length;
+  ORT_RETURN_IF_ERROR(GetExternalDataLocation(tensor_proto_path, tensor_proto, full_path, offset, length));
+  return env.PrefetchFile(full_path.c_str(), offset, length);
+}
+
 static void MoveOrtCallback(OrtCallback& from, OrtCallback& to) {
   to.f = from.f;
   to.param = from.param;
   from.f = nullptr;
   from.param = nullptr;
 }
+bool UsesExternalDataBuffer(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  // the data is only used in place if it doesn't need to be byte swapped or unpacked
+  if (endian::native != endian::little ||
+      tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  // an empty tensor may have no file data to point to
+  size_t size_in_bytes = 0;
+  return GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes).IsOK() && size_in_bytes > 0;
+}
+
+bool UsesRawDataBuffer(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  // the data is only used in place if it doesn't need to be byte swapped and has the exact size of the tensor
+  if (endian::native != endian::little || !utils::HasRawData(tensor_proto) ||
+      tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  size_t size_in_bytes = 0;
+  return GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes).IsOK() && size_in_bytes > 0 &&
+         size_in_bytes == tensor_proto.raw_data().size();
+}
+
+static void DeleteString(void* param) noexcept {
+  delete reinterpret_cast<std::string*>(param);
+}
+
+Status RawDataToMLValue(const ONNX_NAMESPACE::TensorProto& tensor_proto, std::unique_ptr<std::string> raw_data,
+                        const OrtMemoryInfo& location, OrtValue& value, OrtCallback& deleter) {
+  deleter.f = nullptr;
+  deleter.param = nullptr;
+  size_t size_in_bytes = 0;
+  ORT_RETURN_IF_ERROR(GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes));
+  if (raw_data == nullptr || raw_data->size() != size_in_bytes) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The raw data of tensor ", tensor_proto.name(),
+                           " has ", raw_data ? raw_data->size() : 0, " bytes, expected ", size_in_bytes);
+  }
+
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  TensorShape tensor_shape{GetTensorShapeFromTensorProto(tensor_proto)};
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  value.Init(new Tensor(type, tensor_shape, &(*raw_data)[0], location), ml_tensor, ml_tensor->GetDeleteFunc());
+  deleter = OrtCallback{DeleteString, raw_data.release()};
+  return Status::OK();
+}
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 6239)
@@ -441,19 +523,12 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "string tensor can not have raw data");
 
-      std::unique_ptr<ExternalDataInfo> external_data_info;
-      ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
       std::basic_string<ORTCHAR_T> full_path;
-      if (tensor_proto_path != nullptr) {
-        ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
-        full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
-      } else {
-        full_path = external_data_info->GetRelPath();
-      }
-      raw_data_len = external_data_info->GetLength();
+      FileOffsetType offset;
+      ORT_RETURN_IF_ERROR(GetExternalDataLocation(tensor_proto_path, tensor_proto, full_path, offset, raw_data_len));
       // load the file
       ORT_RETURN_IF_ERROR(GetFileContent(
-          env, full_path.c_str(), external_data_info->GetOffset(), raw_data_len,
+          env, full_path.c_str(), offset, raw_data_len,
           raw_data, deleter_for_file_data.d));
     } else if (utils::HasRawData(tensor_proto)) {
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
 #include <vector>
 #include <type_traits>
 
@@ -40,6 +42,35 @@ common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_prot
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
 
+/**
+ * Hints 'env' that the external data of 'tensor_proto' will be read soon, so the platform can start reading it in
+ * the background. Does nothing if 'tensor_proto' has no external data. The external data file is relative to the
+ * directory of 'tensor_proto_path', as for TensorProtoToMLValue.
+ * Returns an error if the hint isn't supported or fails, which doesn't keep the data from being read later.
+ */
+common::Status PrefetchExternalData(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                    const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+/**
+ * Returns true if TensorProtoToMLValue creates the CPU tensor of 'tensor_proto' on the data memory mapped (or read)
+ * from its external data file, in which case the MemBuffer it is given doesn't need a preallocated buffer.
+ * The mapped pages are only read from the file when they are first accessed.
+ */
+bool UsesExternalDataBuffer(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+/**
+ * Returns true if the CPU tensor of 'tensor_proto' can be created by RawDataToMLValue on the memory of its raw_data,
+ * which doesn't need to be byte swapped and has the size of the tensor.
+ */
+bool UsesRawDataBuffer(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+/**
+ * Creates the tensor of 'tensor_proto' on 'raw_data', the raw data taken out of it, without copying the data.
+ * 'deleter' takes the ownership of 'raw_data' and frees it when the tensor is no longer used.
+ */
+common::Status RawDataToMLValue(const ONNX_NAMESPACE::TensorProto& tensor_proto, std::unique_ptr<std::string> raw_data,
+                                const OrtMemoryInfo& location, OrtValue& value, OrtCallback& deleter);
+
 /** Creates a TensorProto from a Tensor.
     @param[in] tensor the Tensor whose data and shape will be used to create the TensorProto.
     @param[in] tensor_proto_name the name of the TensorProto.
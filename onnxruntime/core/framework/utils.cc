@@ -6,6 +6,7 @@
 #include <iomanip>
 
 #include "core/graph/graph_viewer.h"
+#include "core/framework/arena.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/execution_providers.h"
@@ -268,7 +269,7 @@ common::Status InitializeFeedFetchCopyInfo(const SessionState& session_state,
     feeds_fetches_manager.SetDeviceCopyChecks(DeviceCopyCheck::NoCopy, DeviceCopyCheck::NoCopy);
   } else {
     // setup all the static info about where the graph inputs and outputs are located
-    auto info = feeds_fetches_manager.GetFeedsFetchesInfo();
+    const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
     auto& feed_copy_info = feeds_fetches_manager.GetMutableFeedsDeviceCopyInfo();
     auto& fetch_copy_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
     ORT_RETURN_IF_ERROR(utils::CalculateStaticCopyInfoForFeeds(session_state, info.feed_names, feed_copy_info));
@@ -434,17 +435,20 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
                                        const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                        ExecutionMode execution_mode, const bool& terminate_flag,
-                                       const logging::Logger& logger, const bool only_execute_path_to_fetches = false) {
-  std::unique_ptr<IExecutor> p_exec;
-  if (execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag, only_execute_path_to_fetches));
-  } else if (execution_mode == ExecutionMode::ORT_PARALLEL) {
+                                       const logging::Logger& logger, const bool only_execute_path_to_fetches = false,
+                                       const std::string& stream_id = {}, bool end_of_stream = false) {
+  // the sequential executor is cheap to create so it lives on the stack instead of being allocated for every run
+  SequentialExecutor sequential_executor(terminate_flag, only_execute_path_to_fetches, stream_id, end_of_stream);
+  std::unique_ptr<IExecutor> parallel_executor;
+  IExecutor* p_exec = &sequential_executor;
+  if (execution_mode == ExecutionMode::ORT_PARALLEL) {
     auto* p_inter_op_thread_pool = session_state.GetInterOpThreadPool();
     if (!p_inter_op_thread_pool) {
       LOGS(logger, WARNING) << "Only one thread was configured for parallel execution. Hence will use sequential execution.";
-      p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag, only_execute_path_to_fetches));
     } else {
-      p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
+      parallel_executor = std::unique_ptr<IExecutor>(
+          new ParallelExecutor(session_state, terminate_flag, stream_id, end_of_stream));
+      p_exec = parallel_executor.get();
     }
   }
 
@@ -506,14 +510,19 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                             ExecutionMode execution_mode, const bool& terminate_flag,
-                            const logging::Logger& logger, bool only_execute_path_to_fetches) {
-  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+                            const logging::Logger& logger, bool only_execute_path_to_fetches,
+                            const std::string& stream_id, bool end_of_stream) {
+  // a manager reused from a previous execution already has the static copy info
+  if (feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::Unknown) {
+    ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+  }
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
 
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
-                                 execution_mode, terminate_flag, logger, only_execute_path_to_fetches);
+                                 execution_mode, terminate_flag, logger, only_execute_path_to_fetches,
+                                 stream_id, end_of_stream);
 
   return status;
 }
@@ -527,6 +536,18 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
   return status;
 }
 
+void RecordArenaCounterEvents(const SessionState& session_state) {
+  for (const auto& xp : session_state.GetExecutionProviders()) {
+    for (const auto& alloc : xp->GetAllocators()) {
+      if (alloc->Info().alloc_type == OrtArenaAllocator) {
+        session_state.Profiler().RecordCounterEvent(
+            MakeString(alloc->Info().name, "_arena"),
+            {{"bytes_in_use", static_cast<int64_t>(static_cast<IArenaAllocator*>(alloc.get())->Used())}});
+      }
+    }
+  }
+}
+
 int32_t ONNXTensorElementDataTypeToProtoTensorType(ONNXTensorElementDataType onnx_enum) {
   switch (onnx_enum) {
     case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
@@ -38,6 +38,9 @@ namespace utils {
 void* DefaultAlloc(size_t size);
 void DefaultFree(void* p);
 
+// Whether the provider runs its kernels on CPU memory, so its inputs and outputs don't need copies to the CPU.
+bool ProviderIsCpuBased(const std::string& provider_type);
+
 const std::string& GetNodeInputProviderType(const SessionState::NodeInfo& info);
 
 common::Status CopyOneInputAcrossDevices(const SessionState& session_state, const std::string& input_name,
@@ -60,10 +63,13 @@ void FinalizeFeedFetchCopyInfo(FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<const OrtMemoryInfo*>& fetch_alloc_info);
 
 // Execute the main graph. The feed_fetches_manager will be finalized based on the provided feeds and fetches.
+// It can be reused for later executions with the same feed and fetch names and locations.
+// stream_id and end_of_stream are passed to the kernels, see RunOptions::stream_id.
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                             ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
-                            bool only_execute_path_to_fetches = false);
+                            bool only_execute_path_to_fetches = false, const std::string& stream_id = {},
+                            bool end_of_stream = false);
 
 // Execute a subgraph. The feeds_fetches_manager should have been finalized prior to calling this function.
 // See IControlFlowNode::SetupSubgraphExecutionInfo usage in the control flow kernels.
@@ -72,6 +78,10 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger);
 
+// Records a "Memory" counter event with the bytes in use of each arena of the execution providers of session_state.
+// The profiler of session_state must be enabled.
+void RecordArenaCounterEvents(const SessionState& session_state);
+
 template <typename T>
 constexpr ONNXTensorElementDataType GetONNXTensorElementDataType() {
   return ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
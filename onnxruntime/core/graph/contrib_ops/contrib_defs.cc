@@ -198,6 +198,52 @@ void ValidateTypeAndShapeForScaleAndZP(ONNX_NAMESPACE::InferenceContext& ctx, in
   }
 }
 
+// Shape inference of GreedySearch and BeamSearch. The decoder subgraph is inferred with the types and shapes of its
+// own inputs since they are created by the kernel instead of being passed to the node.
+void GenerationShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, bool beam_search) {
+  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (beam_search && ctx.getNumOutputs() > 1) {
+    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::FLOAT);
+  }
+
+  const auto* decoder = ctx.getAttribute("decoder");
+  auto* graph_inferencer = ctx.getGraphAttributeInferencer("decoder");
+  if (decoder != nullptr && decoder->has_g() && graph_inferencer != nullptr) {
+    std::vector<const ONNX_NAMESPACE::TypeProto*> subgraph_input_types;
+    for (const auto& input : decoder->g().input()) {
+      subgraph_input_types.push_back(&input.type());
+    }
+
+    std::vector<const ONNX_NAMESPACE::TensorProto*> input_data(subgraph_input_types.size(), nullptr);
+    graph_inferencer->doInferencing(subgraph_input_types, input_data);
+  }
+
+  if (!hasInputShape(ctx, 0)) {
+    return;
+  }
+
+  auto& input_ids_shape = getInputShape(ctx, 0);
+  if (input_ids_shape.dim_size() != 2) {
+    fail_shape_inference("input_ids shall be 2 dimensions");
+  }
+
+  // (batch_size, [num_return_sequences], max_length)
+  ONNX_NAMESPACE::TensorShapeProto sequences_shape;
+  *sequences_shape.add_dim() = input_ids_shape.dim(0);
+  if (beam_search) {
+    sequences_shape.add_dim();
+  }
+  sequences_shape.add_dim();
+  updateOutputShape(ctx, 0, sequences_shape);
+
+  if (beam_search && ctx.getNumOutputs() > 1) {
+    ONNX_NAMESPACE::TensorShapeProto scores_shape;
+    *scores_shape.add_dim() = input_ids_shape.dim(0);
+    scores_shape.add_dim();
+    updateOutputShape(ctx, 1, scores_shape);
+  }
+}
+
 void FusedMatMulShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
   propagateElemTypeFromInputToOutput(ctx, 0, 0);
   auto transAAttr = ctx.getAttribute("transA");
@@ -398,6 +444,146 @@ const char* contrib_ops_auto_pad_doc =
     "In case of odd number add the extra padding at the end for SAME_UPPER and at the "
     "beginning for SAME_LOWER. VALID mean no padding.";
 
+// the output shape of the NHWC pooling operators, with the spatial dimensions computed as for the NCHW operators
+void NhwcPoolShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, bool global_pooling) {
+  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (!hasNInputShapes(ctx, 1)) {
+    return;
+  }
+
+  const auto& input_shape = getInputShape(ctx, 0);
+  if (input_shape.dim_size() != 4) {
+    fail_shape_inference("Input tensor must be 4D in NHWC format.");
+  }
+
+  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+  *output_shape->add_dim() = input_shape.dim(0);
+
+  if (global_pooling) {
+    output_shape->add_dim()->set_dim_value(1);
+    output_shape->add_dim()->set_dim_value(1);
+    *output_shape->add_dim() = input_shape.dim(3);
+    return;
+  }
+
+  std::vector<int64_t> kernel_shape;
+  if (!getRepeatedAttribute(ctx, "kernel_shape", kernel_shape) || kernel_shape.size() != 2) {
+    fail_shape_inference("Attribute kernel_shape must specify the 2 spatial dimensions.");
+  }
+
+  std::vector<int64_t> strides;
+  if (!getRepeatedAttribute(ctx, "strides", strides) || strides.empty()) {
+    strides.assign(2, 1);
+  }
+
+  std::vector<int64_t> pads;
+  if (!getRepeatedAttribute(ctx, "pads", pads) || pads.empty()) {
+    pads.assign(4, 0);
+  }
+
+  if (strides.size() != 2 || pads.size() != 4) {
+    fail_shape_inference("Attributes strides and pads must match the 2 spatial dimensions.");
+  }
+
+  const auto* auto_pad_attr = ctx.getAttribute("auto_pad");
+  const std::string auto_pad = (auto_pad_attr != nullptr) ? auto_pad_attr->s() : "NOTSET";
+  const auto* ceil_mode_attr = ctx.getAttribute("ceil_mode");
+  const bool ceil_mode = (ceil_mode_attr != nullptr) && (ceil_mode_attr->i() != 0);
+
+  for (int dim = 0; dim < 2; ++dim) {
+    auto* output_dim = output_shape->add_dim();
+    if (!input_shape.dim(dim + 1).has_dim_value()) {
+      continue;
+    }
+
+    const int64_t input_size = input_shape.dim(dim + 1).dim_value();
+    if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+      output_dim->set_dim_value((input_size + strides[dim] - 1) / strides[dim]);
+    } else {
+      const int64_t padded_size = (auto_pad == "VALID") ? input_size : input_size + pads[dim] + pads[dim + 2];
+      const int64_t window_span = padded_size - kernel_shape[dim];
+      output_dim->set_dim_value((ceil_mode ? (window_span + strides[dim] - 1) : window_span) / strides[dim] + 1);
+    }
+  }
+
+  *output_shape->add_dim() = input_shape.dim(3);
+}
+
+void NhwcPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSDomain);
+  schema.SinceVersion(1);
+  schema.Attr("auto_pad", contrib_ops_auto_pad_doc, AttributeProto::STRING, std::string("NOTSET"));
+  schema.Attr("kernel_shape", "The size of the kernel along the height and width axes.", AttributeProto::INTS);
+  schema.Attr("strides", "Stride along the height and width axes. Defaults to 1.", AttributeProto::INTS,
+              OPTIONAL_VALUE);
+  schema.Attr("pads", contrib_ops_pads_doc, AttributeProto::INTS, OPTIONAL_VALUE);
+  schema.Attr("ceil_mode", "Whether to use ceil or floor (default) to compute the output shape.", AttributeProto::INT,
+              static_cast<int64_t>(0));
+  schema.Input(0, "X", "Input data tensor in NHWC format.", "T");
+  schema.Output(0, "Y", "Output data tensor in NHWC format.", "T");
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    NhwcPoolShapeInference(ctx, false);
+  });
+}
+
+void NhwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSDomain);
+  schema.SinceVersion(1);
+  schema.Input(0, "X", "Input data tensor in NHWC format.", "T");
+  schema.Output(0, "Y", "Output data tensor in NHWC format, with the height and width reduced to 1.", "T");
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    NhwcPoolShapeInference(ctx, true);
+  });
+}
+
+// the output shapes of EmbedLayerNormalization and QEmbedLayerNormalization
+void EmbedLayerNormalizationShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
+  if (!hasInputShape(ctx, 0))
+    return;
+
+  auto& input_ids_shape = getInputShape(ctx, 0);
+  auto& input_ids_dims = input_ids_shape.dim();
+
+  // Note that both batch size and sequence length could be symbolic.
+  // So we only check dimension size here.
+  if (input_ids_dims.size() != 2) {
+    fail_shape_inference("Inputs 0 shall be 2 dimensions");
+  }
+
+  // get hidden_size from the last dimension of embedding
+  auto& word_embedding_shape = getInputShape(ctx, 3);
+  auto& word_embedding_dims = word_embedding_shape.dim();
+  if (word_embedding_dims.size() != 2 ||
+      !word_embedding_dims[1].has_dim_value() ||
+      word_embedding_shape.dim(1).dim_value() <= 0) {
+    fail_shape_inference("word_embedding should have 2 dimensions and dimension size is known.");
+  }
+  int64_t hidden_size = word_embedding_shape.dim(1).dim_value();
+
+  // input shape is (batch_size, sequence_length), output shape is (batch_size, sequence_length, hidden_size), or
+  // (1, total_tokens, hidden_size) with packed tokens, where total_tokens depends on the mask.
+  ONNX_NAMESPACE::TensorShapeProto output_shape;
+  if (getAttribute(ctx, "packed_tokens", 0) != 0) {
+    output_shape.add_dim()->set_dim_value(1);
+    output_shape.add_dim();
+  } else {
+    for (auto& dim : input_ids_dims) {
+      *output_shape.add_dim() = dim;
+    }
+  }
+  output_shape.add_dim();
+  output_shape.mutable_dim(2)->set_dim_value(hidden_size);
+
+  updateOutputShape(ctx, 0, output_shape);
+
+  // mask_index shape is (batch_size)
+  ONNX_NAMESPACE::TensorShapeProto mask_index_shape;
+  *mask_index_shape.add_dim() = input_ids_dims[0];
+  updateOutputShape(ctx, 1, mask_index_shape);
+}
+
 void RegisterBertSchemas() {
   static const char* Attention_ver1_doc = R"DOC(
 Multi-Head Self Attention that can be either unidirectional (like GPT-2) or bidirectional (like BERT).
@@ -407,6 +593,13 @@ where value of each element is the end position, or valid length of actual seque
 left-side padding, mask_index has shape (2 * batch_size), where the values are the exclusive end positions followed by
 the inclusive start positions. When unidirectional is 1, and each token only attend to previous tokens. For GPT-2, both past
 and present state are optional. Present state could appear in output even when past state is not in input.
+When past_present_share_buffer is 1, past and present are the same buffer with a fixed maximum sequence length, where
+only the first past_sequence_length positions are valid, and the keys and values of the new tokens are written in place
+after them. This avoids copying the past state on every decoding step.
+When packed_tokens is 1, input has shape (1, total_tokens, hidden_size) with the tokens of all of the sequences packed
+without padding, as produced by EmbedLayerNormalization with packed_tokens, and mask_index is required with the length
+of each sequence in shape (batch_size). Every token only attends to the tokens of its own sequence. The past and
+present states are not supported in this mode.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
@@ -418,13 +611,34 @@ and present state are optional. Present state could appear in output even when p
             "Whether every token can only attend to previous tokens. Default value is 0.",
             AttributeProto::INT,
             static_cast<int64_t>(0))
-      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), hidden_size = num_heads * head_size", "T")
+      .Attr("past_present_share_buffer",
+            "Whether past and present share a buffer with shape (2, batch_size, num_heads, max_sequence_length, head_size), "
+            "that the new keys and values are appended to in place. Requires the past_sequence_length input. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("packed_tokens",
+            "Whether input has the tokens of the sequences packed without padding, with the sequence lengths in "
+            "mask_index. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Input(0, "input",
+             "3D input tensor with shape (batch_size, sequence_length, hidden_size), hidden_size = num_heads * head_size",
+             "T")
       .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size)", "T")
       .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
-      .Input(3, "mask_index", "Attention mask with shape (batch_size, past_sequence_length + sequence_length), or index with shape (batch_size) or (2 * batch_size).", "M", OpSchema::Optional)
-      .Input(4, "past", "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size).", "T", OpSchema::Optional)
+      .Input(3, "mask_index",
+             "Attention mask with shape (batch_size, past_sequence_length + sequence_length), or index with shape (batch_size) or (2 * batch_size).",
+             "M", OpSchema::Optional)
+      .Input(4, "past",
+             "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size), or (2, batch_size, num_heads, max_sequence_length, head_size) when past_present_share_buffer is 1.",
+             "T", OpSchema::Optional)
+      .Input(5, "past_sequence_length",
+             "Scalar with the number of valid positions in past when past_present_share_buffer is 1.", "M",
+             OpSchema::Optional)
       .Output(0, "output", "3D output tensor with shape (batch_size, append_length, hidden_size)", "T")
-      .Output(1, "present", "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)", "T", OpSchema::Optional)
+      .Output(1, "present",
+              "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size), or the shape of past when past_present_share_buffer is 1.",
+              "T", OpSchema::Optional)
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors.")
       .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index to integer types")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -450,7 +664,9 @@ and present state are optional. Present state could appear in output even when p
                 fail_shape_inference("Inputs 4 shall be 5 dimensions");
               }
 
-              if (past_dims[3].has_dim_value() && input_dims[1].has_dim_value()) {
+              if (getAttribute(ctx, "past_present_share_buffer", 0) != 0) {
+                propagateShapeFromInputToOutput(ctx, 4, 1);
+              } else if (past_dims[3].has_dim_value() && input_dims[1].has_dim_value()) {
                 auto all_sequence_length = past_shape.dim(3).dim_value() + input_shape.dim(1).dim_value();
 
                 ONNX_NAMESPACE::TensorShapeProto present_shape;
@@ -559,13 +775,19 @@ EmbedLayerNormalization is the fusion of embedding layer in BERT model, with opt
 The embedding layer takes input_ids (word IDs) and segment_ids (sentence IDs) to look up word_embedding, position_embedding,
 and segment_emedding; the embeddings are added then applied layer normalization using gamma and beta tensors.
 The last input mask is optional. If mask is provided, mask index (that is position of first 0 in mask, or number of words)
-will be calculated.)DOC";
+will be calculated.
+When packed_tokens is 1, the mask is required and only the first mask index tokens of each sequence are computed, packed
+one sequence after another into an output with shape (1, total_tokens, hidden_size). The ops that follow run on the
+packed tokens without padding, and Attention with packed_tokens uses mask_index to find the sequences.)DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(EmbedLayerNormalization)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
       .SetDoc(EmbedLayerNormalization_ver1_doc)
-      .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, kDefaultEmbedLayerNormEpsilon)
+      .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT,
+            kDefaultEmbedLayerNormEpsilon)
+      .Attr("packed_tokens", "Whether to pack the tokens of the sequences without padding. Default value is 0.",
+            AttributeProto::INT, static_cast<int64_t>(0))
       .Input(0, "input_ids", "2D words IDs with shape (batch_size, sequence_length)", "T1")
       .Input(1, "segment_ids", "2D segment IDs with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
       .Input(2, "word_embedding", "2D with shape (,hidden_size)", "T")
@@ -574,49 +796,59 @@ will be calculated.)DOC";
       .Input(5, "gamma", "1D gamma tensor for layer normalization with shape (hidden_size)", "T")
       .Input(6, "beta", "1D beta tensor for layer normalization  with shape (hidden_size)", "T")
       .Input(7, "mask", "2D attention mask with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
-      .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Output(0, "output",
+              "3D output tensor with shape (batch_size, sequence_length, hidden_size), or "
+              "(1, total_tokens, hidden_size) when packed_tokens is 1",
+              "T")
       .Output(1, "mask_index", "1D mask_index tensor with shape (batch_size)", "T1")
       .TypeConstraint("T1", {"tensor(int32)"}, "Constrain input and output integer tensors types")
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output float tensors types.")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
         propagateElemTypeFromInputToOutput(ctx, 2, 0);
         propagateElemTypeFromInputToOutput(ctx, 0, 1);
-        if (!hasInputShape(ctx, 0))
-          return;
-
-        auto& input_ids_shape = getInputShape(ctx, 0);
-        auto& input_ids_dims = input_ids_shape.dim();
-
-        // Note that both batch size and sequence length could be symbolic.
-        // So we only check dimension size here.
-        if (input_ids_dims.size() != 2) {
-          fail_shape_inference("Inputs 0 shall be 2 dimensions");
-        }
-
-        // get hidden_size from the last dimension of embedding
-        auto& word_embedding_shape = getInputShape(ctx, 3);
-        auto& word_embedding_dims = word_embedding_shape.dim();
-        if (word_embedding_dims.size() != 2 ||
-            !word_embedding_dims[1].has_dim_value() ||
-            word_embedding_shape.dim(1).dim_value() <= 0) {
-          fail_shape_inference("word_embedding should have 2 dimensions and dimension size is known.");
-        }
-        int64_t hidden_size = word_embedding_shape.dim(1).dim_value();
-
-        // input shape is (batch_size, sequence_length), output shape is (batch_size, sequence_length, hidden_size)
-        ONNX_NAMESPACE::TensorShapeProto output_shape;
-        for (auto& dim : input_ids_dims) {
-          *output_shape.add_dim() = dim;
-        }
-        output_shape.add_dim();
-        output_shape.mutable_dim(2)->set_dim_value(hidden_size);
+        EmbedLayerNormalizationShapeInference(ctx);
+      });
 
-        updateOutputShape(ctx, 0, output_shape);
+  static const char* QEmbedLayerNormalization_ver1_doc = R"DOC(
+QEmbedLayerNormalization is EmbedLayerNormalization with quantized embeddings and layer normalization weights, each
+quantized per tensor with a scale and an optional zero point (0 when not given). The embeddings are dequantized as they
+are looked up, so the embedding tables stay quantized in memory, and the output is float.)DOC";
 
-        // mask_index shape is (batch_size)
-        ONNX_NAMESPACE::TensorShapeProto mask_index_shape;
-        *mask_index_shape.add_dim() = input_ids_dims[0];
-        updateOutputShape(ctx, 1, mask_index_shape);
+  ONNX_CONTRIB_OPERATOR_SCHEMA(QEmbedLayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(QEmbedLayerNormalization_ver1_doc)
+      .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT,
+            kDefaultEmbedLayerNormEpsilon)
+      .Input(0, "input_ids", "2D words IDs with shape (batch_size, sequence_length)", "T1")
+      .Input(1, "segment_ids", "2D segment IDs with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
+      .Input(2, "word_embedding_quant", "2D with shape (,hidden_size)", "T2")
+      .Input(3, "position_embedding_quant", "2D with shape (, hidden_size)", "T2")
+      .Input(4, "segment_embedding_quant", "2D with shape (, hidden_size)", "T2", OpSchema::Optional)
+      .Input(5, "gamma_quant", "1D gamma tensor for layer normalization with shape (hidden_size)", "T2")
+      .Input(6, "beta_quant", "1D beta tensor for layer normalization  with shape (hidden_size)", "T2")
+      .Input(7, "mask", "2D attention mask with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
+      .Input(8, "word_embedding_scale", "Scale of word_embedding_quant, a scalar", "T")
+      .Input(9, "position_embedding_scale", "Scale of position_embedding_quant, a scalar", "T")
+      .Input(10, "segment_embedding_scale", "Scale of segment_embedding_quant, a scalar", "T", OpSchema::Optional)
+      .Input(11, "gamma_scale", "Scale of gamma_quant, a scalar", "T")
+      .Input(12, "beta_scale", "Scale of beta_quant, a scalar", "T")
+      .Input(13, "word_embedding_zero_point", "Zero point of word_embedding_quant, a scalar", "T2", OpSchema::Optional)
+      .Input(14, "position_embedding_zero_point", "Zero point of position_embedding_quant, a scalar", "T2",
+             OpSchema::Optional)
+      .Input(15, "segment_embedding_zero_point", "Zero point of segment_embedding_quant, a scalar", "T2",
+             OpSchema::Optional)
+      .Input(16, "gamma_zero_point", "Zero point of gamma_quant, a scalar", "T2", OpSchema::Optional)
+      .Input(17, "beta_zero_point", "Zero point of beta_quant, a scalar", "T2", OpSchema::Optional)
+      .Output(0, "layernorm_out", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Output(1, "mask_index_out", "1D mask_index tensor with shape (batch_size)", "T1")
+      .TypeConstraint("T1", {"tensor(int32)"}, "Constrain input and output integer tensors types")
+      .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain the quantized tensors to 8 bit tensors.")
+      .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output float tensors types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 8, 0);
+        propagateElemTypeFromInputToOutput(ctx, 0, 1);
+        EmbedLayerNormalizationShapeInference(ctx);
       });
 
   static const char* FastGelu_ver1_doc = R"DOC(
@@ -636,7 +868,8 @@ GELU (Gaussian Error Linear Unit) approximation: Y=0.5*X*(1+tanh(0.797885*X+0.03
       .SetDomain(kMSDomain)
       .SinceVersion(1)
       .SetDoc("Skip and Layer Normalization Fusion")
-      .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, kDefaultSkipLayerNormEpsilon)
+      .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT,
+            kDefaultSkipLayerNormEpsilon)
       .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
       .Input(1, "skip", "3D skip tensor with shape (batch_size, sequence_length, hidden_size)", "T")
       .Input(2, "gamma", "1D input tensor with shape (hidden_size)", "T")
@@ -644,7 +877,9 @@ GELU (Gaussian Error Linear Unit) approximation: Y=0.5*X*(1+tanh(0.797885*X+0.03
       .Input(4, "bias", "1D bias tensor with shape (hidden_size", "T", OpSchema::Optional)
       .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
       .Output(1, "mean", "Saved mean used during training to speed up gradient computation", "U", OpSchema::Optional)
-      .Output(2, "inv_std_var", "Saved inverse standard variance used during training to speed up gradient computation.", "U", OpSchema::Optional)
+      .Output(2, "inv_std_var",
+              "Saved inverse standard variance used during training to speed up gradient computation.", "U",
+              OpSchema::Optional)
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float or half tensors.")
       .TypeConstraint("U", {"tensor(float)"}, "Constrain mean and inv_std_var to float tensors.")
       .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
@@ -713,7 +948,8 @@ If scale is not provided, crop the borders as provided.)DOC";
   ONNX_CONTRIB_OPERATOR_SCHEMA(Crop)
       .SinceVersion(1)
       .SetDoc(Crop_ver1_doc)
-      .Attr("border", "A 1-D values of (leftBorder, topBorder, rightBorder, bottomBorder).", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("border", "A 1-D values of (leftBorder, topBorder, rightBorder, bottomBorder).", AttributeProto::INTS,
+            OPTIONAL_VALUE)
       .Attr("scale", "A 1-D values of (height, width).", AttributeProto::INTS, OPTIONAL_VALUE)
       .Input(0, "input", "Input tensor of shape [N,C,H,W]", "T")
       .Output(0, "output", "Result, has same type as input, with H and W dimensions reduced.", "T")
@@ -956,8 +1192,10 @@ value at X[t][n] >= seqLengths[n].
   ONNX_OPERATOR_SCHEMA(MeanVarianceNormalization)
       .SinceVersion(1)
       .SetDoc(R"DOC(Perform mean variance normalization.)DOC")
-      .Attr("across_channels", "If 1, mean and variance are computed across channels. Default is 0.", AttributeProto::INT, static_cast<int64_t>(0))
-      .Attr("normalize_variance", "If 0, normalize the mean only.  Default is 1.", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("across_channels", "If 1, mean and variance are computed across channels. Default is 0.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("normalize_variance", "If 0, normalize the mean only.  Default is 1.", AttributeProto::INT,
+            static_cast<int64_t>(1))
       .Input(0, "input", "Input tensor of shape [N,C,H,W]", "T")
       .Output(0, "output", "Result, has same shape and type as input", "T")
       .TypeConstraint(
@@ -1170,6 +1408,26 @@ value at X[t][n] >= seqLengths[n].
 Sample echo operator.)DOC");
 
   // register schemas for more operators here
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcMaxPool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .SetDoc(R"DOC(MaxPool over a 4D tensor in NHWC format, as produced by models converted from channels last
+frameworks. The attributes match the ONNX MaxPool operator; dilations are not supported.)DOC");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcAveragePool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .SetDoc(R"DOC(AveragePool over a 4D tensor in NHWC format, as produced by models converted from channels last
+frameworks. The attributes match the ONNX AveragePool operator.)DOC")
+      .Attr("count_include_pad", "Whether to include the pad pixels when computing the average.", AttributeProto::INT,
+            static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcGlobalMaxPool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator)
+      .SetDoc(R"DOC(GlobalMaxPool over a 4D tensor in NHWC format.)DOC");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcGlobalAveragePool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator)
+      .SetDoc(R"DOC(GlobalAveragePool over a 4D tensor in NHWC format.)DOC");
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(MaxpoolWithMask)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1309,7 +1567,8 @@ Sample echo operator.)DOC");
       .SinceVersion(1)
       .SetDoc(R"DOC(
 The fused convolution operator schema is the same as Conv besides it includes an attribute
-activation.)DOC")
+activation, and an optional input Z that is added to the convolution output before the activation,
+such as the residual of a ResNet block.)DOC")
       .Attr(
           "auto_pad",
           "",
@@ -1366,6 +1625,12 @@ activation.)DOC")
           "",
           "T",
           OpSchema::Optional)
+      .Input(
+          3,
+          "Z",
+          "Tensor added to the output before the activation. It must have the same shape as the output.",
+          "T",
+          OpSchema::Optional)
       .Output(
           0,
           "Y",
@@ -1382,7 +1647,8 @@ activation.)DOC")
       .SinceVersion(1)
       .SetDoc(R"DOC(
 The FusedGemm operator schema is the same as Gemm besides it includes attributes
-activation and leaky_relu_alpha.)DOC")
+activation and leaky_relu_alpha, and an optional input Z that is added to the output before the
+activation, such as a residual.)DOC")
       .Input(
           0,
           "A",
@@ -1402,7 +1668,14 @@ activation and leaky_relu_alpha.)DOC")
           "C",
           "Input tensor C. "
           "The shape of C should be unidirectional broadcastable to (M, N).",
-          "T")
+          "T",
+          OpSchema::Optional)
+      .Input(
+          3,
+          "Z",
+          "Tensor of shape (M, N) added to the output before the activation.",
+          "T",
+          OpSchema::Optional)
       .Output(0, "Y", "Output tensor of shape (M, N).", "T")
       .TypeConstraint(
           "T",
@@ -1878,6 +2151,57 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
         ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
       });
 
+  static const char* MatMulNBits_doc = R"DOC(
+MatMulNBits performs a matrix multiplication of the float input A with the constant input B, whose weights are
+quantized blockwise to 'bits' bits, e.g. the weights of a large language model quantized to 4 bits.
+
+Each column of B is split into blocks of 'block_size' values along K, quantized with a scale and a zero point of
+each block, where the value of a weight is (q - zero_point) * scale. The weights are dequantized on the fly, so the
+values read from memory are 'bits' per weight.
+
+Input B is stored as uint8 with shape [N, n_blocks_per_col, blob_size], where n_blocks_per_col is
+ceil(K / block_size) and blob_size is block_size * bits / 8. The values of a block are packed in order, the first
+value of a pair of 4-bit values in the low nibble, and the last block of a column is padded.
+Input scales has the N * n_blocks_per_col scales of the blocks, column by column.
+Input zero_points, if present, has the zero points of the blocks packed to 'bits' bits, with the zero points of each
+column starting at a byte boundary, i.e. its shape is [N * ceil(n_blocks_per_col * bits / 8)]. If not present, the
+zero point is 2^(bits - 1).
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulNBits)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(MatMulNBits_doc)
+      .Attr("K", "size of each input feature", AttributeProto::INT)
+      .Attr("N", "size of each output feature", AttributeProto::INT)
+      .Attr("bits", "number of bits of a quantized weight, 4 or 8", AttributeProto::INT, static_cast<int64_t>(4))
+      .Attr("block_size",
+            "number of weights of a block quantized with a scale and zero point, a power of 2 from 16 to 256",
+            AttributeProto::INT, static_cast<int64_t>(32))
+      .Input(0, "A", "The input tensor, with K as its last dimension", "T1")
+      .Input(1, "B", "The quantized weights, as a 3D uint8 tensor [N, n_blocks_per_col, blob_size]", "T2")
+      .Input(2, "scales", "The scales of the blocks, as a 1D tensor [N * n_blocks_per_col]", "T1")
+      .Input(3, "zero_points", "The packed zero points of the blocks", "T2", OpSchema::Optional)
+      .Input(4, "bias", "1D input tensor, whose dimension is N", "T1", OpSchema::Optional)
+      .Output(0, "Y", "The output tensor, with the shape of A with N as its last dimension", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, scales, bias and output Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain the quantized weights and zero points to uint8 tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        const auto& a_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (a_shape.dim_size() == 0) {
+          fail_shape_inference("Input A of MatMulNBits must have at least one dimension");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto y_shape = a_shape;
+        y_shape.mutable_dim(a_shape.dim_size() - 1)->set_dim_value(getAttribute(ctx, "N", 0));
+        updateOutputShape(ctx, 0, y_shape);
+      });
+
   static const char* TransposeMatMul_doc = R"DOC(
 Duplicate of FusedMatMul. Going forward FusedMatMul should be used. This OP will be supported for backward compatibility. 
 Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-1.13.0/reference/generated/numpy.matmul.html
@@ -2775,7 +3099,9 @@ Example 4:
       .Input(2, "B", "Bias tensor.", "T")
       .Output(0, "Y", "Output data tensor.", "T")
       .Output(1, "mean", "Saved mean used during training to speed up gradient computation", "U", OpSchema::Optional)
-      .Output(2, "inv_std_var", "Saved inverse standard variance used during training to speed up gradient computation.", "U", OpSchema::Optional)
+      .Output(2, "inv_std_var",
+              "Saved inverse standard variance used during training to speed up gradient computation.", "U",
+              OpSchema::Optional)
       .TypeConstraint(
           "T",
           {"tensor(float16)", "tensor(float)", "tensor(double)", "tensor(bfloat16)"},
@@ -2838,7 +3164,9 @@ Example 4:
       .Input(0, "X", "Input data tensor from the previous layer.", "T")
       .Input(1, "scale", "Scale tensor.", "T")
       .Output(0, "Y", "Output data tensor.", "T")
-      .Output(1, "inv_std_var", "Saved inverse standard variance used during training to speed up gradient computation.", "U", OpSchema::Optional)
+      .Output(1, "inv_std_var",
+              "Saved inverse standard variance used during training to speed up gradient computation.", "U",
+              OpSchema::Optional)
       .TypeConstraint(
           "T",
           {"tensor(float16)", "tensor(float)", "tensor(double)", "tensor(bfloat16)"},
@@ -2911,6 +3239,89 @@ It's an extension of Gelu. It takes the sum of input A and bias input B as the i
           "Constrain input and output types to float tensors.")
       .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
 
+  static const char* FusedElementwise_ver1_doc =
+      R"DOC(A chain of elementwise operators evaluated in a single pass over the data, produced by the
+ElementwiseFusion graph transformer. The first operator of the chain takes the first one or two inputs. Each
+following operator takes the result of the previous one and, if it is a binary operator, the next input.
+All inputs have the shape of the output or hold a single value.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(FusedElementwise_ver1_doc)
+      .Attr("ops",
+            "The operators of the chain, in evaluation order. One of Add, Sub, Mul, Div, Abs, Erf, Exp, Neg, Relu, "
+            "Sigmoid, Sqrt and Tanh.",
+            AttributeProto::STRINGS)
+      .Attr("chain_input_indices",
+            "For each operator of the chain, the input index the result of the previous operator had in the original "
+            "binary operator. Ignored for the first operator and for unary operators.",
+            AttributeProto::INTS)
+      .Input(0, "inputs", "The inputs of the chain.", "T", OpSchema::Variadic)
+      .Output(0, "Y", "The result of the last operator of the chain.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+        std::vector<const ONNX_NAMESPACE::TensorShapeProto*> shapes;
+        for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+          if (!hasInputShape(ctx, i)) {
+            return;
+          }
+          shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+        }
+        multidirectionalBroadcastShapeInference(shapes,
+                                                *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+      });
+
+  static const char* EmbeddingBag_ver1_doc =
+      R"DOC(Computes sums, means or maxima of bags of rows of an embedding table without materializing the
+gathered rows, e.g. for the sparse features of recommendation models. The bags are either given by 1-D indices and
+the offsets at which each bag starts within them, or by 2-D indices holding one bag per row. Indices may be negative
+to count from the end of the table, as for Gather. An empty bag produces zeros. It is also produced by the
+EmbeddingBagFusion graph transformer from Gather nodes followed by ReduceSum, ReduceMean or ReduceMax.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(EmbeddingBag_ver1_doc)
+      .Attr("mode", "How the rows of a bag are reduced: sum, mean or max.", AttributeProto::STRING, std::string("sum"))
+      .Input(0, "weight", "The embedding table, of shape (num_embeddings, embedding_dim).", "T")
+      .Input(1, "indices", "The rows of the bags, of shape (num_indices) or (num_bags, bag_size).", "Tind")
+      .Input(2, "offsets", "The position in indices at which each bag starts, of shape (num_bags). Required iff "
+             "indices is 1-D.", "Tind", OpSchema::Optional)
+      .Input(3, "per_sample_weights", "Weights the rows are multiplied with before they are summed, of the shape "
+             "of indices. Only supported by the sum mode.", "T", OpSchema::Optional)
+      .Output(0, "output", "The reduced bags, of shape (num_bags, embedding_dim).", "T")
+      .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain the table and output to float tensors.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+          return;
+        }
+
+        const auto& weight_shape = getInputShape(ctx, 0);
+        const auto& indices_shape = getInputShape(ctx, 1);
+        if (weight_shape.dim_size() != 2) {
+          fail_shape_inference("weight must be 2-D");
+        }
+        if (indices_shape.dim_size() != 1 && indices_shape.dim_size() != 2) {
+          fail_shape_inference("indices must be 1-D or 2-D");
+        }
+
+        TensorShapeProto output_shape;
+        if (indices_shape.dim_size() == 2) {
+          *output_shape.add_dim() = indices_shape.dim(0);
+        } else if (hasInputShape(ctx, 2) && getInputShape(ctx, 2).dim_size() == 1) {
+          *output_shape.add_dim() = getInputShape(ctx, 2).dim(0);
+        } else {
+          output_shape.add_dim();
+        }
+        *output_shape.add_dim() = weight_shape.dim(1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
   // Used to be ONNX 1.7 Inverse(12)
   // Comment out docs not to increase the binary size
   //
@@ -3035,14 +3446,79 @@ It's an extension of Gelu. It takes the sum of input A and bias input B as the i
         }
       });
 
+  static const char* GreedySearch_ver1_doc = R"DOC(
+Generates a sequence for each prompt in input_ids by running the GPT-2 style decoder in the 'decoder' attribute once
+per generated token, until every sequence has produced eos_token_id or max_length tokens are reached.
+The next token is the most likely one, or is sampled from the top_k most likely tokens and/or the smallest set of
+most likely tokens whose probability reaches top_p if those attributes are set.
+The decoder has the inputs input_ids, optional position_ids and attention_mask, and past_0 ... past_{n-1}, and the
+outputs logits and present_0 ... present_{n-1}, as exported by gpt2_helper.py. The past state stays inside the operator
+between steps. Sequences are padded with pad_token_id after eos_token_id.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GreedySearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(GreedySearch_ver1_doc)
+      .Attr("decoder", "The GPT-2 style decoder subgraph run for each generated token.", AttributeProto::GRAPH)
+      .Attr("eos_token_id", "The id of the end of sequence token.", AttributeProto::INT)
+      .Attr("pad_token_id", "The id of the padding token. Defaults to eos_token_id.", AttributeProto::INT,
+            OPTIONAL_VALUE)
+      .Attr("top_k", "Sample from the top_k most likely tokens if greater than 1.", AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("top_p", "Sample from the most likely tokens whose probability reaches top_p if less than 1.",
+            AttributeProto::FLOAT, 1.0f)
+      .Attr("temperature", "The temperature applied to the logits when sampling.", AttributeProto::FLOAT, 1.0f)
+      .Attr("seed", "Seed of the random generator used for sampling.", AttributeProto::INT, OPTIONAL_VALUE)
+      .Input(0, "input_ids", "The prompts with shape (batch_size, sequence_length).", "I")
+      .Input(1, "max_length", "The scalar maximum length of the generated sequences, including the prompt.", "I")
+      .Output(0, "sequences", "The generated sequences with shape (batch_size, max_length).", "I")
+      .TypeConstraint("I", {"tensor(int64)"}, "Constrain token ids to integer types")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        GenerationShapeInference(ctx, false);
+      });
+
+  static const char* BeamSearch_ver1_doc = R"DOC(
+Generates num_return_sequences sequences for each prompt in input_ids with a beam search over num_beams beams, running
+the GPT-2 style decoder in the 'decoder' attribute once per step. The decoder has the same inputs and outputs as for
+GreedySearch. The past state of the beams kept after each step is gathered from the present state inside the operator.
+A finished sequence is scored by its sum of log probabilities divided by its length ^ length_penalty.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(BeamSearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(BeamSearch_ver1_doc)
+      .Attr("decoder", "The GPT-2 style decoder subgraph run for each step.", AttributeProto::GRAPH)
+      .Attr("eos_token_id", "The id of the end of sequence token.", AttributeProto::INT)
+      .Attr("pad_token_id", "The id of the padding token. Defaults to eos_token_id.", AttributeProto::INT,
+            OPTIONAL_VALUE)
+      .Attr("length_penalty", "Exponent of the length the score of a finished sequence is divided by.",
+            AttributeProto::FLOAT, 1.0f)
+      .Attr("early_stopping", "Stop the search of a prompt as soon as num_beams sequences are finished.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "input_ids", "The prompts with shape (batch_size, sequence_length).", "I")
+      .Input(1, "max_length", "The scalar maximum length of the generated sequences, including the prompt.", "I")
+      .Input(2, "num_beams", "The scalar number of beams. Defaults to 1.", "I", OpSchema::Optional)
+      .Input(3, "num_return_sequences", "The scalar number of sequences returned per prompt. Defaults to 1.", "I",
+             OpSchema::Optional)
+      .Output(0, "sequences", "The best sequences with shape (batch_size, num_return_sequences, max_length).", "I")
+      .Output(1, "sequences_scores", "The scores of the sequences with shape (batch_size, num_return_sequences).", "T",
+              OpSchema::Optional)
+      .TypeConstraint("I", {"tensor(int64)"}, "Constrain token ids to integer types")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain scores to float types")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        GenerationShapeInference(ctx, true);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(BiasSoftmax)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
       .SetDoc(
           "Y = softmax(scores + bias)) with simple broadcast on bias. "
           "Intended to specialize softmax(scores + additive_mask) commonly found in transformer models.")
-      .Attr("softmax_axis", "apply softmax to elements for dimensions softmax_axis or higher", AttributeProto::INT, static_cast<int64_t>(1))
-      .Attr("broadcast_axis", "broadcast bias across input for dimensions broadcast_axis to softmax_axis-1", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("softmax_axis", "apply softmax to elements for dimensions softmax_axis or higher", AttributeProto::INT,
+            static_cast<int64_t>(1))
+      .Attr("broadcast_axis", "broadcast bias across input for dimensions broadcast_axis to softmax_axis-1",
+            AttributeProto::INT, static_cast<int64_t>(1))
       .Input(0, "data", "The input data as Tensor.", "T")
       .Input(1, "bias", "The bias (or mask) as Tensor.", "T")
       .Output(0, "output", "The output.", "T")
@@ -148,6 +148,30 @@ void RegisterNchwcSchemas() {
   ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
       .FillUsing(NchwcGlobalPoolOpSchemaGenerator);
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(InstanceNormalization)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr("epsilon", "", AttributeProto::FLOAT, OPTIONAL_VALUE)
+      .Attr("activation", "", AttributeProto::STRING, OPTIONAL_VALUE)
+      .Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE)
+      .Input(0, "X", "", "T")
+      .Input(1, "scale", "", "T")
+      .Input(2, "B", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ScaleChannels)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Input(0, "X", "", "T")
+      .Input(1, "scale", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(Upsample)
       .SetDomain(kMSNchwcDomain)
       .SinceVersion(1)
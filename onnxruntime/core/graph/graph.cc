@@ -31,6 +31,7 @@
 #include "core/graph/function.h"
 #include "core/graph/function_impl.h"
 #include "core/graph/schema_registry.h"
+#include "core/graph/symbolic_shape_inference.h"
 #include "onnx/checker.h"
 using namespace ONNX_NAMESPACE::checker;
 #endif
@@ -735,6 +736,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_types_key_.clear();
   attributes_[attr_name] = value;
 }
 
@@ -742,6 +744,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_types_key_.clear();                                             \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -753,6 +756,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_types_key_.clear();                                             \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -765,6 +769,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    inferred_types_key_.clear();                             \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -777,6 +782,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_types_key_.clear();
   AttributeProto a;
   a.set_name(attr_name);
   a.set_type(AttributeProto_AttributeType::AttributeProto_AttributeType_GRAPH);
@@ -807,6 +813,7 @@ ADD_LIST_ATTR_IMPL(SparseTensorProto, AttributeProto_AttributeType::AttributePro
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_types_key_.clear();
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -970,12 +977,19 @@ Graph::Graph(const Model& owning_model,
 
   // Process 'Constant' nodes
   // Put the 'TensorProto' stored in the 'Constant' nodes attribute into the graphs initializer list
-  for (auto& node : graph_proto_->node()) {
+  for (auto& node : *graph_proto_->mutable_node()) {
     if (node.op_type() != kConstant) {
       continue;
     }
 
     const gsl::not_null<TensorProto*> tensor{graph_proto_->add_initializer()};
+    if (node.attribute_size() > 0 && node.attribute(0).type() == AttributeProto_AttributeType_TENSOR) {
+      // the node is removed below, so take its tensor instead of copying the data
+      tensor->Swap(node.mutable_attribute(0)->mutable_t());
+      *(tensor->mutable_name()) = node.output(0);
+      continue;
+    }
+
     auto status = utils::ConstantNodeProtoToTensorProto(node, *tensor);
     ORT_ENFORCE(status.IsOK(), status.ToString());
   }
@@ -2222,6 +2236,39 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+std::string Graph::InferredTypesKey(const Node& node) const {
+  // the serialized type of each input and output, and whether each input is a constant initializer
+  std::string key;
+  auto append_defs = [&key](const std::vector<NodeArg*>& defs) {
+    for (const auto* def : defs) {
+      key += def->Name();
+      key += '\0';
+      if (def->Exists() && def->TypeAsProto() != nullptr) {
+        key += def->TypeAsProto()->SerializeAsString();
+      }
+      key += '\0';
+    }
+  };
+
+  append_defs(node.InputDefs());
+  for (const auto* input_def : node.InputDefs()) {
+    key += GetConstantInitializer(input_def->Name(), false) != nullptr ? '1' : '0';
+  }
+  key += '\0';
+  append_defs(node.OutputDefs());
+  return key;
+}
+
+bool Graph::ConsumesChangedInitializer(const Node& node) const {
+  if (initializers_changed_since_resolve_.empty()) {
+    return false;
+  }
+
+  return std::any_of(node.InputDefs().cbegin(), node.InputDefs().cend(), [this](const NodeArg* input_def) {
+    return initializers_changed_since_resolve_.count(input_def->Name()) > 0;
+  });
+}
+
 Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
@@ -2244,16 +2291,26 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   // and need to call Resolve
   lsc.output_names.insert(outer_scope_node_arg_names_.cbegin(), outer_scope_node_arg_names_.cend());
 
+  // the type/shape inferencing of a node is skipped if the types of its inputs and outputs, its attributes and the
+  // data of its constant initializer inputs didn't change since it last ran. as the nodes are visited in topological
+  // order, a node whose inferred output types change causes its consumers to be inferred again.
+  // nodes in subgraphs and nodes with subgraphs are always inferred as they depend on values from other graphs.
+  const bool incremental_inferencing = !options.override_types && !IsSubgraph();
+
+  // fills the dimensions the ONNX shape inferencing can't compute as it doesn't propagate the values of shape tensors.
+  // it runs for the nodes whose inferencing is skipped too, as the values flow through them.
+  SymbolicShapeInferencer symbolic_shape_inferencer(*this);
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     auto& node_name = node.Name();
     auto& domain = node.Domain();
 
     if (!node.Op()) {
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       {
         auto status = Status::OK();
         ORT_TRY {
@@ -2314,11 +2371,19 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    const bool node_incremental_inferencing = incremental_inferencing && !node.ContainsSubgraph();
+    if (!node_incremental_inferencing || node.inferred_types_key_.empty() ||
+        node.inferred_types_key_ != InferredTypesKey(node) || ConsumesChangedInitializer(node)) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      NO_CHANGE_ON_SYNC_FLAG(symbolic_shape_inferencer.InferNode(node));
+      node.inferred_types_key_ = node_incremental_inferencing ? InferredTypesKey(node) : std::string();
+    } else {
+      NO_CHANGE_ON_SYNC_FLAG(symbolic_shape_inferencer.InferNode(node));
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
     }
   }
 
@@ -2480,6 +2545,7 @@ Status Graph::Resolve(const ResolveOptions& options) {
   auto finalize_func = [&options](Graph& graph) {
             graph.CleanUnusedInitializers(options.initializer_names_to_preserve);
             graph.GraphResolveNeeded(false);
+            graph.initializers_changed_since_resolve_.clear();
 
             // if we are resolving immediately after loading from a GraphProto, we don't need to
             // do a proto sync
@@ -2507,6 +2573,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
+  initializers_changed_since_resolve_.insert(tensor.name());
   SetGraphResolveNeeded();
   if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
@@ -2566,6 +2633,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   found = iter != name_to_initial_tensor_.end();
   if (found) {
     name_to_initial_tensor_.erase(tensor_name);
+    initializers_changed_since_resolve_.insert(tensor_name);
     SetGraphResolveNeeded();
   }
 
@@ -2615,6 +2683,7 @@ Status Graph::ReplaceInitializedTensor(const ONNX_NAMESPACE::TensorProto& new_in
               "graph_proto_ is not in sync with name_to_initial_tensor_");
 
   **existing_entry = new_initializer;
+  initializers_changed_since_resolve_.insert(initializer_name);
 
   return Status::OK();
 }
@@ -2630,6 +2699,17 @@ bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorPro
   return true;
 }
 
+bool Graph::ReleaseInitializedTensorRawData(const std::string& tensor_name, std::string& raw_data) {
+  auto iter = name_to_initial_tensor_.find(tensor_name);
+  if (name_to_initial_tensor_.end() == iter) {
+    return false;
+  }
+
+  // the TensorProto instances are owned by graph_proto_ (or deserialized_proto_data_), which are not const
+  const_cast<TensorProto*>(iter->second)->mutable_raw_data()->swap(raw_data);
+  return true;
+}
+
 void Graph::CleanAllInitializedTensors() noexcept {
   name_to_initial_tensor_.clear();
 
@@ -3439,11 +3519,12 @@ Status Graph::LoadFromOrtFormat(
     const onnxruntime::experimental::fbs::Graph& fbs_graph,
     const Model& owning_model,
     const std::unordered_map<std::string, int>& domain_to_version,
-    const logging::Logger& logger, std::unique_ptr<Graph>& graph) {
+    const logging::Logger& logger, std::unique_ptr<Graph>& graph,
+    const onnxruntime::experimental::utils::OrtFormatLoadOptions* load_options) {
   // can't use make_unique as we're calling a private ctor
   graph.reset(new Graph(owning_model, domain_to_version, nullptr, nullptr, logger));
 
-  ORT_RETURN_IF_ERROR(graph->LoadFromOrtFormat(fbs_graph));
+  ORT_RETURN_IF_ERROR(graph->LoadFromOrtFormat(fbs_graph, load_options));
 
 #if !defined(ORT_MINIMAL_BUILD)
   // in a full build we need to run Resolve to fully populate ResolveContext and Node::op_,
@@ -3466,7 +3547,7 @@ Status Graph::LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs
                         parent_graph.domain_to_version_, &parent_graph, &parent_node,
                         logger));
 
-  return graph->LoadFromOrtFormat(fbs_graph);
+  return graph->LoadFromOrtFormat(fbs_graph, parent_graph.ort_format_load_options_);
 }
 
 Graph::Graph(const Model& owning_model,
@@ -3485,7 +3566,12 @@ Graph::Graph(const Model& owning_model,
       is_loaded_from_model_file_(true) {  // true as the Graph isn't manually constructed from scratch
 }
 
-common::Status Graph::LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs_graph) {
+common::Status Graph::LoadFromOrtFormat(const onnxruntime::experimental::fbs::Graph& fbs_graph,
+                                        const onnxruntime::experimental::utils::OrtFormatLoadOptions* load_options) {
+  // make the options available to the subgraphs while they're loaded
+  ort_format_load_options_ = load_options;
+  auto clear_load_options = gsl::finally([this]() { ort_format_load_options_ = nullptr; });
+
   // We deserialize the graph from ORT format in the following order:
   // 1. Deserialize the initializers
   // 2. Deserialize the NodeArgs
@@ -3503,7 +3589,7 @@ common::Status Graph::LoadFromOrtFormat(const onnxruntime::experimental::fbs::Gr
     for (const auto* fbs_tensor : *fbs_initializers) {
       ORT_RETURN_IF(nullptr == fbs_tensor, "Initializer tensor is missing. Invalid ORT format model.");
       TensorProto* initializer = deserialized_proto_data_.add_initializer();
-      ORT_RETURN_IF_ERROR(experimental::utils::LoadInitializerOrtFormat(*fbs_tensor, *initializer));
+      ORT_RETURN_IF_ERROR(experimental::utils::LoadInitializerOrtFormat(*fbs_tensor, *initializer, load_options));
       name_to_initial_tensor_[initializer->name()] = initializer;
     }
   }
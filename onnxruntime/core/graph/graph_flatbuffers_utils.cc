@@ -40,6 +40,8 @@ Status SaveInitializerOrtFormat(flatbuffers::FlatBufferBuilder& builder,
     size_t tensor_byte_size = 0;
     ORT_RETURN_IF_ERROR(
         onnxruntime::utils::UnpackInitializerData(initializer, unpacked_tensor, tensor_byte_size));
+    // align the data so it can be used in place if the model file is memory mapped
+    builder.ForceVectorAlignment(tensor_byte_size, sizeof(uint8_t), kOrtFormatRawDataAlignment);
     raw_data = builder.CreateVector(unpacked_tensor.get(), tensor_byte_size);
   }
 
@@ -142,7 +144,8 @@ Status SaveAttributeOrtFormat(flatbuffers::FlatBufferBuilder& builder,
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 
 Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor,
-                                TensorProto& initializer) {
+                                TensorProto& initializer,
+                                const OrtFormatLoadOptions* load_options) {
   initializer.Clear();
 
   LOAD_STR_FROM_ORT_FORMAT(initializer, name, fbs_tensor.name());
@@ -167,7 +170,24 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor,
     ORT_RETURN_IF(nullptr == fbs_raw_data, "Missing raw data for initializer. Invalid ORT format model.");
 
     // fbs_raw_data is uint8_t vector, so the size is byte size
-    initializer.set_raw_data(fbs_raw_data->Data(), fbs_raw_data->size());
+    const auto offset = load_options && !load_options->model_file_name.empty()
+                            ? fbs_raw_data->Data() - load_options->model_bytes
+                            : -1;
+    if (offset >= 0 && fbs_raw_data->size() > 0 && offset % kOrtFormatRawDataAlignment == 0) {
+      // refer to the data in the model file instead of copying it. a zero length means the whole file, so empty
+      // tensors, along with data from models written before the raw data was aligned, are still copied.
+      initializer.set_data_location(TensorProto_DataLocation_EXTERNAL);
+      auto add_external_data = [&initializer](const std::string& key, const std::string& value) {
+        auto* entry = initializer.add_external_data();
+        entry->set_key(key);
+        entry->set_value(value);
+      };
+      add_external_data("location", load_options->model_file_name);
+      add_external_data("offset", std::to_string(offset));
+      add_external_data("length", std::to_string(fbs_raw_data->size()));
+    } else {
+      initializer.set_raw_data(fbs_raw_data->Data(), fbs_raw_data->size());
+    }
   }
 
   return Status::OK();
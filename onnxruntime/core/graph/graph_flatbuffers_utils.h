@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+
 namespace ONNX_NAMESPACE {
 class TensorProto;
 class AttributeProto;
@@ -32,6 +35,20 @@ struct Tensor;
 
 namespace utils {
 
+// Writers align Tensor.raw_data to this many bytes within the ORT format model so that a reader can use the raw
+// data of an initializer in place from a memory mapped model file.
+constexpr size_t kOrtFormatRawDataAlignment = 64;
+
+// Options for loading the initializers of an ORT format model.
+struct OrtFormatLoadOptions {
+  // File name of the model (relative to the directory of the model path used as the graph location).
+  // If set, initializers with aligned raw data are not copied. Instead they refer to their location in the model
+  // file as external data, which is memory mapped when the initialized tensors are created.
+  std::string model_file_name;
+  // Start of the model bytes, used to calculate the file offset of the raw data.
+  const uint8_t* model_bytes = nullptr;
+};
+
 // TODO, add ORT_MUST_USE_RESULT when it is moved to a different header
 onnxruntime::common::Status SaveInitializerOrtFormat(
     flatbuffers::FlatBufferBuilder& builder, const ONNX_NAMESPACE::TensorProto& initializer,
@@ -48,7 +65,8 @@ onnxruntime::common::Status SaveAttributeOrtFormat(
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 
 onnxruntime::common::Status LoadInitializerOrtFormat(
-    const fbs::Tensor& fbs_tensor, ONNX_NAMESPACE::TensorProto& initializer);
+    const fbs::Tensor& fbs_tensor, ONNX_NAMESPACE::TensorProto& initializer,
+    const OrtFormatLoadOptions* load_options = nullptr);
 
 // Load a give fbs::Attribute into AttributeProto
 // Note, If the attribute type is a graph, we will leave an empty graph in attr_proto,
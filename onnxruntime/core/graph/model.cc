@@ -590,7 +590,8 @@ Model::Model() : model_path_{} {
 #if defined(ENABLE_ORT_FORMAT_LOAD)
 common::Status Model::LoadFromOrtFormat(const fbs::Model& fbs_model,
                                         const logging::Logger& logger,
-                                        std::unique_ptr<Model>& model) {
+                                        std::unique_ptr<Model>& model,
+                                        const experimental::utils::OrtFormatLoadOptions* load_options) {
   model.reset(new Model());
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -615,7 +616,8 @@ common::Status Model::LoadFromOrtFormat(const fbs::Model& fbs_model,
   auto fbs_graph = fbs_model.graph();
   ORT_RETURN_IF(nullptr == fbs_graph, "Graph is null. Invalid ORT format model.");
 
-  ORT_RETURN_IF_ERROR(Graph::LoadFromOrtFormat(*fbs_graph, *model, domain_to_version, logger, model->graph_));
+  ORT_RETURN_IF_ERROR(Graph::LoadFromOrtFormat(*fbs_graph, *model, domain_to_version, logger, model->graph_,
+                                               load_options));
 
   return Status::OK();
 }
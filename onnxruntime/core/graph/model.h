@@ -231,7 +231,8 @@ class Model {
 #if defined(ENABLE_ORT_FORMAT_LOAD)
   static common::Status LoadFromOrtFormat(const onnxruntime::experimental::fbs::Model& fbs_model,
                                           const logging::Logger& logger,
-                                          std::unique_ptr<Model>& model);
+                                          std::unique_ptr<Model>& model,
+                                          const experimental::utils::OrtFormatLoadOptions* load_options = nullptr);
 #endif
 
  private:
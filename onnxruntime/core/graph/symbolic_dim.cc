@@ -0,0 +1,309 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/symbolic_dim.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsIdentifier(const std::string& name) {
+  if (name.empty() || !(std::isalpha(static_cast<unsigned char>(name[0])) || name[0] == '_')) {
+    return false;
+  }
+
+  return std::all_of(name.cbegin(), name.cend(), [](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+  });
+}
+
+}  // namespace
+
+SymbolicDim SymbolicDim::Value(int64_t value) {
+  SymbolicDim dim;
+  dim.known_ = true;
+  dim.terms_[Monomial()] = value;
+  return dim.Normalize();
+}
+
+SymbolicDim SymbolicDim::Symbol(const std::string& name) {
+  SymbolicDim dim;
+  dim.known_ = true;
+  dim.terms_[Monomial{name}] = 1;
+  return dim;
+}
+
+SymbolicDim SymbolicDim::FromDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) {
+  if (dim.has_dim_value()) {
+    return Value(dim.dim_value());
+  }
+
+  if (dim.has_dim_param() && !dim.dim_param().empty()) {
+    const auto& dim_param = dim.dim_param();
+    auto parsed = Parse(dim_param);
+    if (parsed.IsKnown() && parsed.ToString() == dim_param) {
+      return parsed;
+    }
+
+    return Symbol(dim_param);
+  }
+
+  return Unknown();
+}
+
+bool SymbolicDim::IsValue() const {
+  return known_ && (terms_.empty() || (terms_.size() == 1 && terms_.cbegin()->first.empty()));
+}
+
+int64_t SymbolicDim::GetValue() const {
+  ORT_ENFORCE(IsValue(), "SymbolicDim ", ToString(), " is not a value");
+  return terms_.empty() ? 0 : terms_.cbegin()->second;
+}
+
+SymbolicDim SymbolicDim::operator+(const SymbolicDim& other) const {
+  if (!known_ || !other.known_) {
+    return Unknown();
+  }
+
+  SymbolicDim result = *this;
+  for (const auto& term : other.terms_) {
+    result.terms_[term.first] += term.second;
+  }
+
+  return result.Normalize();
+}
+
+SymbolicDim SymbolicDim::operator-(const SymbolicDim& other) const {
+  return *this + other * Value(-1);
+}
+
+SymbolicDim SymbolicDim::operator*(const SymbolicDim& other) const {
+  if (!known_ || !other.known_) {
+    return Unknown();
+  }
+
+  SymbolicDim result;
+  result.known_ = true;
+  for (const auto& lhs : terms_) {
+    for (const auto& rhs : other.terms_) {
+      Monomial monomial;
+      monomial.reserve(lhs.first.size() + rhs.first.size());
+      std::merge(lhs.first.cbegin(), lhs.first.cend(), rhs.first.cbegin(), rhs.first.cend(),
+                 std::back_inserter(monomial));
+      result.terms_[monomial] += lhs.second * rhs.second;
+    }
+  }
+
+  return result.Normalize();
+}
+
+SymbolicDim SymbolicDim::operator/(const SymbolicDim& other) const {
+  if (!known_ || !other.known_ || other.terms_.size() != 1) {
+    return Unknown();
+  }
+
+  const auto& divisor = *other.terms_.cbegin();
+  if (divisor.second == 0) {
+    return Unknown();
+  }
+
+  if (IsValue() && other.IsValue()) {
+    return Value(GetValue() / divisor.second);
+  }
+
+  SymbolicDim result;
+  result.known_ = true;
+  for (const auto& term : terms_) {
+    if (term.second % divisor.second != 0 ||
+        !std::includes(term.first.cbegin(), term.first.cend(), divisor.first.cbegin(), divisor.first.cend())) {
+      return Unknown();
+    }
+
+    Monomial monomial;
+    std::set_difference(term.first.cbegin(), term.first.cend(), divisor.first.cbegin(), divisor.first.cend(),
+                        std::back_inserter(monomial));
+    result.terms_[monomial] += term.second / divisor.second;
+  }
+
+  return result.Normalize();
+}
+
+std::string SymbolicDim::ToString() const {
+  if (!known_) {
+    return std::string();
+  }
+
+  if (terms_.empty()) {
+    return "0";
+  }
+
+  auto term_to_string = [](const std::pair<const Monomial, int64_t>& term) {
+    std::string str;
+    if (term.first.empty()) {
+      return std::to_string(term.second);
+    }
+
+    if (term.second == -1) {
+      str = "-";
+    } else if (term.second != 1) {
+      str = std::to_string(term.second) + "*";
+    }
+
+    for (size_t i = 0; i < term.first.size(); ++i) {
+      if (i > 0) {
+        str += '*';
+      }
+      str += term.first[i];
+    }
+
+    return str;
+  };
+
+  // the terms with symbols first, then the constant
+  std::string str;
+  auto append = [&str, &term_to_string](const std::pair<const Monomial, int64_t>& term) {
+    auto term_str = term_to_string(term);
+    if (!str.empty() && term_str[0] != '-') {
+      str += '+';
+    }
+    str += term_str;
+  };
+
+  for (const auto& term : terms_) {
+    if (!term.first.empty()) {
+      append(term);
+    }
+  }
+
+  auto constant = terms_.find(Monomial());
+  if (constant != terms_.cend()) {
+    append(*constant);
+  }
+
+  return str;
+}
+
+void SymbolicDim::ToDim(ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) const {
+  if (!known_) {
+    dim.clear_dim_value();
+    dim.clear_dim_param();
+  } else if (IsValue()) {
+    dim.set_dim_value(GetValue());
+  } else {
+    dim.set_dim_param(ToString());
+  }
+}
+
+bool SymbolicDim::Evaluate(const std::string& dim_param, const std::unordered_map<std::string, int64_t>& symbols,
+                           int64_t& value) {
+  auto it = symbols.find(dim_param);
+  if (it != symbols.cend()) {
+    value = it->second;
+    return true;
+  }
+
+  auto parsed = Parse(dim_param);
+  if (!parsed.IsKnown()) {
+    return false;
+  }
+
+  value = 0;
+  for (const auto& term : parsed.terms_) {
+    int64_t term_value = term.second;
+    for (const auto& symbol : term.first) {
+      auto symbol_it = symbols.find(symbol);
+      if (symbol_it == symbols.cend()) {
+        return false;
+      }
+      term_value *= symbol_it->second;
+    }
+    value += term_value;
+  }
+
+  return true;
+}
+
+SymbolicDim SymbolicDim::Parse(const std::string& expr) {
+  // expr := ['-'] term (('+' | '-') term)*, term := factor ('*' factor)*, factor := integer | identifier
+  if (expr.empty()) {
+    return Unknown();
+  }
+
+  SymbolicDim result = Value(0);
+  size_t pos = 0;
+  const size_t end = expr.size();
+  while (pos < end) {
+    int64_t sign = 1;
+    if (expr[pos] == '+' || expr[pos] == '-') {
+      if (pos == 0 && expr[pos] == '+') {
+        return Unknown();
+      }
+      sign = expr[pos] == '-' ? -1 : 1;
+      ++pos;
+    } else if (pos != 0) {
+      return Unknown();
+    }
+
+    SymbolicDim term = Value(sign);
+    while (true) {
+      size_t factor_end = pos;
+      while (factor_end < end && expr[factor_end] != '+' && expr[factor_end] != '-' && expr[factor_end] != '*') {
+        ++factor_end;
+      }
+
+      const std::string factor = expr.substr(pos, factor_end - pos);
+      if (!factor.empty() && std::all_of(factor.cbegin(), factor.cend(),
+                                         [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        if (factor.size() > 18) {
+          return Unknown();
+        }
+        term = term * Value(std::stoll(factor));
+      } else if (IsIdentifier(factor)) {
+        term = term * Symbol(factor);
+      } else {
+        return Unknown();
+      }
+
+      pos = factor_end;
+      if (pos < end && expr[pos] == '*') {
+        ++pos;
+        continue;
+      }
+      break;
+    }
+
+    result = result + term;
+  }
+
+  return result;
+}
+
+SymbolicDim& SymbolicDim::Normalize() {
+  for (auto it = terms_.begin(); it != terms_.end();) {
+    if (it->second == 0) {
+      it = terms_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  const bool single_symbol = terms_.size() == 1 && terms_.cbegin()->first.size() == 1 && terms_.cbegin()->second == 1;
+  if (!single_symbol) {
+    for (const auto& term : terms_) {
+      if (!std::all_of(term.first.cbegin(), term.first.cend(), IsIdentifier)) {
+        *this = Unknown();
+        break;
+      }
+    }
+  }
+
+  return *this;
+}
+
+}  // namespace onnxruntime
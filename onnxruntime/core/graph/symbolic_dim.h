@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+
+/**
+A dimension whose size is an integer, a symbol, or a polynomial of symbols with integer coefficients, e.g.
+"batch*seq" or "2*seq+1". The shape inferencing of the graph writes the polynomials as the dim_param of a dimension,
+so the memory planning can evaluate them once the values of the graph inputs' symbols are known.
+The string form is canonical: two equal polynomials have the same dim_param.
+A default constructed SymbolicDim is unknown, and the arithmetic on an unknown SymbolicDim is unknown.
+*/
+class SymbolicDim {
+ public:
+  SymbolicDim() = default;
+
+  static SymbolicDim Value(int64_t value);
+
+  // <name> is kept as is. A name that isn't an identifier can't be part of a polynomial, so the arithmetic on it
+  // other than with the identity values is unknown.
+  static SymbolicDim Symbol(const std::string& name);
+
+  // The dim_param of a dimension is parsed if it's in the canonical form of a polynomial, otherwise it's a symbol.
+  // A dimension with neither a dim_value nor a dim_param is unknown.
+  static SymbolicDim FromDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim);
+
+  bool IsKnown() const { return known_; }
+  bool IsValue() const;
+  // Returns the value of a dimension that IsValue.
+  int64_t GetValue() const;
+
+  SymbolicDim operator+(const SymbolicDim& other) const;
+  SymbolicDim operator-(const SymbolicDim& other) const;
+  SymbolicDim operator*(const SymbolicDim& other) const;
+  // Division that is known for two values and for the polynomials divisible by a single term, e.g. "batch*seq*64"
+  // by 64 or by "seq". Unknown otherwise.
+  SymbolicDim operator/(const SymbolicDim& other) const;
+
+  bool operator==(const SymbolicDim& other) const { return known_ == other.known_ && terms_ == other.terms_; }
+  bool operator!=(const SymbolicDim& other) const { return !(*this == other); }
+
+  // The canonical form. Empty if unknown.
+  std::string ToString() const;
+
+  // Sets the dim_value or dim_param of <dim>. Clears both if unknown.
+  void ToDim(ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) const;
+
+  // Evaluates the dim_param of a dimension given the values of the symbols.
+  // <dim_param> is either a symbol in <symbols> or a polynomial of them.
+  // Returns false if the dim_param uses a symbol that isn't in <symbols>.
+  static bool Evaluate(const std::string& dim_param, const std::unordered_map<std::string, int64_t>& symbols,
+                       int64_t& value);
+
+ private:
+  // the sorted symbols of a term. the constant term has none.
+  using Monomial = std::vector<std::string>;
+
+  static SymbolicDim Unknown() { return SymbolicDim(); }
+
+  // Parses the canonical form. Returns an unknown SymbolicDim if <expr> isn't a polynomial of identifiers.
+  static SymbolicDim Parse(const std::string& expr);
+
+  // Drops the terms with a zero coefficient. Unknown if a symbol that isn't an identifier is part of a polynomial.
+  SymbolicDim& Normalize();
+
+  bool known_ = false;
+  std::map<Monomial, int64_t> terms_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,479 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/graph/symbolic_shape_inference.h"
+
+#include <algorithm>
+
+#include "core/graph/constants.h"
+#include "core/graph/graph.h"
+#include "onnx/defs/tensor_proto_util.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+bool GetIntAttribute(const Node& node, const std::string& name, int64_t& value) {
+  const auto& attributes = node.GetAttributes();
+  auto it = attributes.find(name);
+  if (it == attributes.cend() || it->second.type() != AttributeProto_AttributeType_INT) {
+    return false;
+  }
+
+  value = it->second.i();
+  return true;
+}
+
+bool GetIntsAttribute(const Node& node, const std::string& name, std::vector<int64_t>& values) {
+  const auto& attributes = node.GetAttributes();
+  auto it = attributes.find(name);
+  if (it == attributes.cend() || it->second.type() != AttributeProto_AttributeType_INTS) {
+    return false;
+  }
+
+  values.assign(it->second.ints().cbegin(), it->second.ints().cend());
+  return true;
+}
+
+bool HasInput(const Node& node, size_t index) {
+  return node.InputDefs().size() > index && node.InputDefs()[index]->Exists();
+}
+
+bool IsIntegerTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || type->value_case() != TypeProto::kTensorType) {
+    return false;
+  }
+
+  const auto elem_type = type->tensor_type().elem_type();
+  return elem_type == TensorProto_DataType_INT64 || elem_type == TensorProto_DataType_INT32;
+}
+
+// The dimensions of the shape of <arg>. Returns false if the rank is unknown.
+bool GetDims(const NodeArg& arg, std::vector<SymbolicDim>& dims) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  dims.clear();
+  for (const auto& dim : shape->dim()) {
+    dims.push_back(SymbolicDim::FromDim(dim));
+  }
+
+  return true;
+}
+
+// the axes of Squeeze/Unsqueeze, from the attribute before opset 13 and the optional input since
+template <typename GetConstantValue>
+bool GetAxes(const Node& node, GetConstantValue get_constant_value, std::vector<int64_t>& axes) {
+  axes.clear();
+  if (node.SinceVersion() < 13) {
+    GetIntsAttribute(node, "axes", axes);
+    return true;
+  }
+
+  return !HasInput(node, 1) || get_constant_value(*node.InputDefs()[1], axes);
+}
+
+}  // namespace
+
+void SymbolicShapeInferencer::InferNode(Node& node) {
+  if (node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) {
+    return;
+  }
+
+  auto& output_defs = node.MutableOutputDefs();
+  if (output_defs.empty() || !output_defs[0]->Exists()) {
+    return;
+  }
+
+  auto& output = *output_defs[0];
+
+  SymbolicValue value;
+  if (IsIntegerTensor(output) && InferOutputValue(node, value) &&
+      static_cast<int64_t>(value.elements.size()) <= kMaxElements) {
+    values_[output.Name()] = std::move(value);
+  }
+
+  std::vector<SymbolicDim> dims;
+  if (output.TypeAsProto() == nullptr || output.TypeAsProto()->value_case() != TypeProto::kTensorType ||
+      !InferOutputShape(node, dims)) {
+    return;
+  }
+
+  TensorShapeProto shape;
+  if (output.Shape() != nullptr) {
+    shape = *output.Shape();
+    if (shape.dim_size() != static_cast<int>(dims.size())) {
+      return;
+    }
+  } else {
+    for (size_t i = 0; i < dims.size(); ++i) {
+      shape.add_dim();
+    }
+  }
+
+  bool updated = output.Shape() == nullptr;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    auto& dim = *shape.mutable_dim(static_cast<int>(i));
+    const auto& inferred = dims[i];
+    if (!dim.has_dim_value() && !dim.has_dim_param() && inferred.IsKnown() &&
+        !(inferred.IsValue() && inferred.GetValue() < 0)) {
+      inferred.ToDim(dim);
+      updated = true;
+    }
+  }
+
+  if (updated) {
+    output.SetShape(shape);
+  }
+}
+
+bool SymbolicShapeInferencer::GetValue(const NodeArg& arg, SymbolicValue& value) const {
+  if (!arg.Exists()) {
+    return false;
+  }
+
+  auto it = values_.find(arg.Name());
+  if (it != values_.cend()) {
+    value = it->second;
+    return true;
+  }
+
+  const auto* initializer = graph_.GetConstantInitializer(arg.Name(), true);
+  if (initializer == nullptr || initializer->data_location() == TensorProto_DataLocation_EXTERNAL ||
+      initializer->dims_size() > 1 || (initializer->dims_size() == 1 && initializer->dims(0) > kMaxElements)) {
+    return false;
+  }
+
+  std::vector<int64_t> data;
+  bool parsed = false;
+  ORT_TRY {
+    if (initializer->data_type() == TensorProto_DataType_INT64) {
+      data = ParseData<int64_t>(initializer);
+      parsed = true;
+    } else if (initializer->data_type() == TensorProto_DataType_INT32) {
+      const auto data32 = ParseData<int32_t>(initializer);
+      data.assign(data32.cbegin(), data32.cend());
+      parsed = true;
+    }
+  }
+  ORT_CATCH(const std::exception&) {
+    parsed = false;
+  }
+
+  if (!parsed) {
+    return false;
+  }
+
+  value.is_scalar = initializer->dims_size() == 0;
+  value.elements.clear();
+  for (auto v : data) {
+    value.elements.push_back(SymbolicDim::Value(v));
+  }
+
+  return true;
+}
+
+bool SymbolicShapeInferencer::GetConstantValue(const NodeArg& arg, std::vector<int64_t>& values) const {
+  SymbolicValue value;
+  if (!GetValue(arg, value)) {
+    return false;
+  }
+
+  values.clear();
+  for (const auto& element : value.elements) {
+    if (!element.IsValue()) {
+      return false;
+    }
+    values.push_back(element.GetValue());
+  }
+
+  return true;
+}
+
+bool SymbolicShapeInferencer::InferOutputValue(const Node& node, SymbolicValue& value) const {
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+  if (inputs.empty() || !inputs[0]->Exists()) {
+    return false;
+  }
+
+  auto get_constant_value = [this](const NodeArg& arg, std::vector<int64_t>& values) {
+    return GetConstantValue(arg, values);
+  };
+
+  if (op_type == "Shape") {
+    value.is_scalar = false;
+    return GetDims(*inputs[0], value.elements);
+  }
+
+  if (op_type == "Size") {
+    std::vector<SymbolicDim> dims;
+    if (!GetDims(*inputs[0], dims)) {
+      return false;
+    }
+
+    SymbolicDim size = SymbolicDim::Value(1);
+    for (const auto& dim : dims) {
+      size = size * dim;
+    }
+
+    value.is_scalar = true;
+    value.elements = {size};
+    return true;
+  }
+
+  if (op_type == "Identity" || op_type == "Cast") {
+    // Cast is only tracked between integer types, which the caller checks for the output
+    return IsIntegerTensor(*inputs[0]) && GetValue(*inputs[0], value);
+  }
+
+  if (op_type == "Gather") {
+    SymbolicValue data;
+    std::vector<int64_t> indices;
+    SymbolicValue indices_value;
+    int64_t axis = 0;
+    GetIntAttribute(node, "axis", axis);
+    if (axis != 0 || !HasInput(node, 1) || !GetValue(*inputs[0], data) || data.is_scalar ||
+        !GetValue(*inputs[1], indices_value) || !GetConstantValue(*inputs[1], indices)) {
+      return false;
+    }
+
+    const auto size = static_cast<int64_t>(data.elements.size());
+    value.is_scalar = indices_value.is_scalar;
+    value.elements.clear();
+    for (auto index : indices) {
+      if (index < 0) {
+        index += size;
+      }
+      if (index < 0 || index >= size) {
+        return false;
+      }
+      value.elements.push_back(data.elements[static_cast<size_t>(index)]);
+    }
+
+    return true;
+  }
+
+  if (op_type == "Slice") {
+    SymbolicValue data;
+    std::vector<int64_t> starts;
+    std::vector<int64_t> ends;
+    std::vector<int64_t> axes;
+    std::vector<int64_t> steps;
+    if (!GetValue(*inputs[0], data) || data.is_scalar) {
+      return false;
+    }
+
+    if (node.SinceVersion() < 10) {
+      if (!GetIntsAttribute(node, "starts", starts) || !GetIntsAttribute(node, "ends", ends)) {
+        return false;
+      }
+      GetIntsAttribute(node, "axes", axes);
+    } else if (!HasInput(node, 2) || !GetConstantValue(*inputs[1], starts) ||
+               !GetConstantValue(*inputs[2], ends) ||
+               (HasInput(node, 3) && !GetConstantValue(*inputs[3], axes)) ||
+               (HasInput(node, 4) && !GetConstantValue(*inputs[4], steps))) {
+      return false;
+    }
+
+    if (starts.size() != 1 || ends.size() != 1 || (!axes.empty() && axes != std::vector<int64_t>{0} &&
+                                                   axes != std::vector<int64_t>{-1})) {
+      return false;
+    }
+
+    const int64_t step = steps.empty() ? 1 : steps[0];
+    if (step == 0 || steps.size() > 1) {
+      return false;
+    }
+
+    const auto size = static_cast<int64_t>(data.elements.size());
+    int64_t start = starts[0] < 0 ? std::max(starts[0], -size) + size : starts[0];
+    int64_t end = ends[0] < 0 ? std::max(ends[0], -size - 1) + size : ends[0];
+
+    value.is_scalar = false;
+    value.elements.clear();
+    if (step > 0) {
+      start = std::min(start, size);
+      end = std::min(end, size);
+      for (int64_t i = start; i < end; i += step) {
+        value.elements.push_back(data.elements[static_cast<size_t>(i)]);
+      }
+    } else {
+      start = std::min(start, size - 1);
+      end = std::min(end, size - 1);
+      for (int64_t i = start; i > end; i += step) {
+        value.elements.push_back(data.elements[static_cast<size_t>(i)]);
+      }
+    }
+
+    return true;
+  }
+
+  if (op_type == "Concat") {
+    int64_t axis = 0;
+    if (!GetIntAttribute(node, "axis", axis) || (axis != 0 && axis != -1)) {
+      return false;
+    }
+
+    value.is_scalar = false;
+    value.elements.clear();
+    for (const auto* input : inputs) {
+      SymbolicValue input_value;
+      if (!GetValue(*input, input_value) || input_value.is_scalar) {
+        return false;
+      }
+      value.elements.insert(value.elements.end(), input_value.elements.cbegin(), input_value.elements.cend());
+    }
+
+    return true;
+  }
+
+  if (op_type == "Unsqueeze") {
+    // only a scalar to a 1-D tensor
+    std::vector<int64_t> axes;
+    if (!GetAxes(node, get_constant_value, axes) || (axes != std::vector<int64_t>{0} &&
+                                                     axes != std::vector<int64_t>{-1}) ||
+        !GetValue(*inputs[0], value) || !value.is_scalar) {
+      return false;
+    }
+
+    value.is_scalar = false;
+    return true;
+  }
+
+  if (op_type == "Squeeze") {
+    // only a 1-D tensor of one element to a scalar
+    std::vector<int64_t> axes;
+    if (!GetAxes(node, get_constant_value, axes) || (!axes.empty() && axes != std::vector<int64_t>{0} &&
+                                                     axes != std::vector<int64_t>{-1}) ||
+        !GetValue(*inputs[0], value) || value.is_scalar || value.elements.size() != 1) {
+      return false;
+    }
+
+    value.is_scalar = true;
+    return true;
+  }
+
+  if (op_type == "Add" || op_type == "Sub" || op_type == "Mul" || op_type == "Div") {
+    SymbolicValue lhs;
+    SymbolicValue rhs;
+    if (!HasInput(node, 1) || !GetValue(*inputs[0], lhs) || !GetValue(*inputs[1], rhs)) {
+      return false;
+    }
+
+    const size_t lhs_size = lhs.elements.size();
+    const size_t rhs_size = rhs.elements.size();
+    if (lhs_size != rhs_size && lhs_size != 1 && rhs_size != 1) {
+      return false;
+    }
+
+    // a 1-D tensor of one element broadcasts to the other's shape, so the result is only a scalar if both are
+    value.is_scalar = lhs.is_scalar && rhs.is_scalar;
+    value.elements.clear();
+    for (size_t i = 0, end = std::max(lhs_size, rhs_size); i < end; ++i) {
+      const auto& a = lhs.elements[lhs_size == 1 ? 0 : i];
+      const auto& b = rhs.elements[rhs_size == 1 ? 0 : i];
+      if (op_type == "Add") {
+        value.elements.push_back(a + b);
+      } else if (op_type == "Sub") {
+        value.elements.push_back(a - b);
+      } else if (op_type == "Mul") {
+        value.elements.push_back(a * b);
+      } else {
+        value.elements.push_back(a / b);
+      }
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+bool SymbolicShapeInferencer::InferOutputShape(const Node& node, std::vector<SymbolicDim>& dims) const {
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+
+  if (op_type == "Reshape") {
+    SymbolicValue shape;
+    if (!HasInput(node, 1) || !GetValue(*inputs[1], shape) || shape.is_scalar) {
+      return false;
+    }
+
+    std::vector<SymbolicDim> input_dims;
+    const bool has_input_dims = GetDims(*inputs[0], input_dims);
+
+    // 0 copies the input dimension, -1 is what's left of the input's size
+    dims = shape.elements;
+    int64_t inferred_index = -1;
+    SymbolicDim known_size = SymbolicDim::Value(1);
+    for (size_t i = 0; i < dims.size(); ++i) {
+      if (dims[i].IsValue() && dims[i].GetValue() == 0) {
+        dims[i] = has_input_dims && i < input_dims.size() ? input_dims[i] : SymbolicDim();
+      } else if (dims[i].IsValue() && dims[i].GetValue() == -1) {
+        inferred_index = static_cast<int64_t>(i);
+        continue;
+      }
+      known_size = known_size * dims[i];
+    }
+
+    if (inferred_index >= 0) {
+      SymbolicDim input_size = has_input_dims ? SymbolicDim::Value(1) : SymbolicDim();
+      for (const auto& dim : input_dims) {
+        input_size = input_size * dim;
+      }
+      dims[inferred_index] = input_size / known_size;
+    }
+
+    return true;
+  }
+
+  if (op_type == "Expand") {
+    SymbolicValue shape;
+    std::vector<SymbolicDim> input_dims;
+    if (!HasInput(node, 1) || !GetValue(*inputs[1], shape) || shape.is_scalar ||
+        !GetDims(*inputs[0], input_dims)) {
+      return false;
+    }
+
+    // multidirectional broadcast of the input shape and the shape input
+    const size_t rank = std::max(input_dims.size(), shape.elements.size());
+    dims.assign(rank, SymbolicDim());
+    for (size_t i = 0; i < rank; ++i) {
+      const size_t input_offset = rank - input_dims.size();
+      const size_t shape_offset = rank - shape.elements.size();
+      const SymbolicDim a = i >= input_offset ? input_dims[i - input_offset] : SymbolicDim::Value(1);
+      const SymbolicDim b = i >= shape_offset ? shape.elements[i - shape_offset] : SymbolicDim::Value(1);
+      if (a.IsValue() && a.GetValue() == 1) {
+        dims[i] = b;
+      } else if ((b.IsValue() && b.GetValue() == 1) || a == b) {
+        dims[i] = a;
+      }
+    }
+
+    return true;
+  }
+
+  if (op_type == "ConstantOfShape") {
+    SymbolicValue shape;
+    if (!GetValue(*inputs[0], shape) || shape.is_scalar) {
+      return false;
+    }
+
+    dims = shape.elements;
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
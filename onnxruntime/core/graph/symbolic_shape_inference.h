@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/symbolic_dim.h"
+
+namespace onnxruntime {
+
+class Graph;
+class Node;
+class NodeArg;
+
+/**
+Propagates the symbolic values of the small integer tensors that compute shapes, e.g. Shape -> Gather -> Concat,
+and uses them to fill the dimensions of the outputs of Reshape, Expand and ConstantOfShape that the ONNX shape
+inferencing leaves unknown as it doesn't propagate data. The dimensions are polynomials of the graph inputs'
+symbols written as dim_param, see SymbolicDim, so the memory planning can resolve them at session initialization.
+Used by Graph::Resolve, which calls InferNode for each node in topological order after its type/shape inferencing.
+*/
+class SymbolicShapeInferencer {
+ public:
+  explicit SymbolicShapeInferencer(const Graph& graph) : graph_(graph) {}
+
+  // Computes the symbolic values of the node's outputs and fills the unknown dimensions of its output shapes.
+  // Only the dimensions that are unknown are set, so this never conflicts with the ONNX shape inferencing.
+  void InferNode(Node& node);
+
+  // The values are only tracked for tensors up to this number of elements.
+  static constexpr int64_t kMaxElements = 64;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SymbolicShapeInferencer);
+
+  struct SymbolicValue {
+    std::vector<SymbolicDim> elements;
+    bool is_scalar = false;
+  };
+
+  // The symbolic value of the node's output or of a constant initializer.
+  bool GetValue(const NodeArg& arg, SymbolicValue& value) const;
+  // A value whose elements are all integers.
+  bool GetConstantValue(const NodeArg& arg, std::vector<int64_t>& values) const;
+
+  bool InferOutputValue(const Node& node, SymbolicValue& value) const;
+  bool InferOutputShape(const Node& node, std::vector<SymbolicDim>& dims) const;
+
+  const Graph& graph_;
+  std::unordered_map<std::string, SymbolicValue> values_;
+};
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
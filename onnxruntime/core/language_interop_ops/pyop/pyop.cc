@@ -31,7 +31,6 @@
 #include <numeric>
 #include <vector>
 #include <memory>
-#include <mutex>
 #include <functional>
 #include <unordered_map>
 
@@ -44,26 +43,36 @@ PyOpLibProxy& PyOpLibProxy::GetInstance() {
   return proxy;
 }
 
+// Releases the Python objects it holds when it goes out of scope.
+// The callers hold the GIL, which serializes the calls into the interpreter.
 class Scope
 {
 public:
-    Scope(const vector<PyObject*>& objs = {}): objs_(objs) {
-        mtx_.lock();
-    }
+    Scope(const vector<PyObject*>& objs = {}): objs_(objs) {}
     ~Scope() {
         for (auto obj: objs_) {
             Py_XDECREF(obj);
         }
-        mtx_.unlock();
     }
     void Add(PyObject* obj) {
         objs_.push_back(obj);
     }
 private:
-    static std::mutex mtx_;
     vector<PyObject*> objs_;
 };
 
+// Holds the GIL of the calling thread for its lifetime, so it's released when a Python call throws.
+class GilGuard
+{
+public:
+    GilGuard(): state_(PyOpLibProxy::GetInstance().GetGil()) {}
+    ~GilGuard() {
+        PyOpLibProxy::GetInstance().PutGil(state_);
+    }
+private:
+    int32_t state_;
+};
+
 PyOpLibProxy::PyOpLibProxy() {
     Scope scope;
     Py_Initialize();
@@ -84,8 +93,6 @@ PyOpLibProxy::~PyOpLibProxy() {
     }
 }
 
-std::mutex Scope::mtx_;
-
 const char* PyOpLibProxy::GetLastErrorMessage(std::string& err) {
     Scope scope;
     if (PyErr_Occurred()) {
@@ -111,44 +118,47 @@ void PyOpLibProxy::PutGil(int32_t state) const {
    PyGILState_Release((PyGILState_STATE)state);
 }
 
-PyObject* MakePyObj(const void* data, int32_t type, const vector<int64_t>& dim) {
-    std::vector<npy_intp> np_dim;
-    for (auto d: dim) {
-        np_dim.push_back(static_cast<npy_intp>(d));
+// Wraps the data of an input tensor in a read only NumPy array without copying it.
+// The array is only valid during the call it's passed to.
+PyObject* MakePyView(const void* data, int32_t type, const vector<int64_t>& dim) {
+    std::vector<npy_intp> np_dim(dim.begin(), dim.end());
+    auto pyObj = PyArray_SimpleNewFromData(static_cast<int>(np_dim.size()), np_dim.data(), type,
+                                           const_cast<void*>(data));
+    if (nullptr != pyObj) {
+        PyArray_CLEARFLAGS(reinterpret_cast<PyArrayObject*>(pyObj), NPY_ARRAY_WRITEABLE);
     }
-    auto pyObj = static_cast<PyObject*>(PyArray_EMPTY(static_cast<int>(np_dim.size()), np_dim.data(), type, 0));
-    auto data_len = std::accumulate(begin(np_dim), end(np_dim),
-                                    static_cast<int64_t>(PyArray_DescrFromType(type)->elsize),
-                                    std::multiplies<int64_t>());
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    memcpy(PyArray_DATA(np_array), data, data_len);
     return pyObj;
 }
 
-bool ExtractOutput(PyObject*                   pyObj,
-                   vector<unique_ptr<char[]>>& outputs,
-                   vector<int32_t>&            outputs_elem_size,
-                   vector<vector<int64_t>>&    outputs_dim) {
+// Copies a returned NumPy array straight into the buffer of the ORT output it's bound to.
+bool WriteOutput(PyObject*                   pyObj,
+                 size_t                      index,
+                 const PyOpOutputBufferFunc& get_output_buffer) {
     if (!PyArray_Check(pyObj)) {
         return false;
     }
 
-    outputs_dim.push_back({});
     auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    outputs_elem_size.push_back(static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
+    vector<int64_t> dims(PyArray_SHAPE(np_array), PyArray_SHAPE(np_array) + PyArray_NDIM(np_array));
+    auto buffer = get_output_buffer(index, dims, static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
+    if (nullptr == buffer) {
+        return false;
+    }
 
-    for (int i = 0; i < PyArray_NDIM(np_array); ++i) {
-        outputs_dim.back().push_back(PyArray_SHAPE(np_array)[i]);
+    if (PyArray_IS_C_CONTIGUOUS(np_array)) {
+        memcpy(buffer, PyArray_DATA(np_array), PyArray_NBYTES(np_array));
+        return true;
     }
 
-    auto data_len = std::accumulate(begin(outputs_dim.back()),
-                                    end(outputs_dim.back()),
-                                    static_cast<int64_t>(outputs_elem_size.back()),
-                                    std::multiplies<int64_t>());
+    // let NumPy gather the elements of a strided array, e.g. a transposed view
+    auto pyOutput = PyArray_SimpleNewFromData(PyArray_NDIM(np_array), PyArray_SHAPE(np_array),
+                                              PyArray_TYPE(np_array), buffer);
+    if (nullptr == pyOutput) {
+        return false;
+    }
 
-    outputs.push_back(unique_ptr<char[]>(new char[data_len]));
-    memcpy(static_cast<void*>(outputs.back().get()), PyArray_DATA(np_array), data_len);
-    return true;
+    Scope scope({pyOutput});
+    return PyArray_CopyInto(reinterpret_cast<PyArrayObject*>(pyOutput), np_array) == 0;
 }
 
 void* PyOpLibProxy::NewInstance(const char* module, const char* class_name, const unordered_map<string, string>& args) {
@@ -185,9 +195,7 @@ bool PyOpLibProxy::InvokePythonFunc(void*                            raw_inst,
                                     const vector<const void*>&       inputs,
                                     const vector<int32_t>&           inputs_type,
                                     const vector<vector<int64_t>>&   inputs_dim,
-                                    vector<unique_ptr<char[]>>&      outputs,
-                                    vector<int32_t>&                 outputs_elem_size,
-                                    vector<vector<int64_t>>&         outputs_dim,
+                                    const PyOpOutputBufferFunc&      get_output_buffer,
                                     std::function<void(const char*)> logging_func) {
     Scope scope;
     auto instance = static_cast<PyObject*>(raw_inst);
@@ -204,32 +212,51 @@ bool PyOpLibProxy::InvokePythonFunc(void*                            raw_inst,
 
     scope.Add(pyFunc);
     auto pyArgs = PyTuple_New(inputs.size());
+    scope.Add(pyArgs);
     for (size_t i = 0; i < inputs.size(); ++i) {
-        PyTuple_SetItem(pyArgs, i, MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]));
+        auto pyInput = MakePyView(inputs[i], inputs_type[i], inputs_dim[i]);
+        if (nullptr == pyInput) {
+            logging_func("InvokePythonFunc: failed to wrap input");
+            return false;
+        }
+        PyTuple_SetItem(pyArgs, i, pyInput);
     }
 
-    scope.Add(pyArgs);
-    auto pyResult = PyEval_CallObject(pyFunc, pyArgs);
-    if (nullptr == pyResult) {
-        logging_func("InvokePythonFunc: no result");
-        return false;
-    }
+    bool succeeded = true;
+    {
+        Scope result_scope;
+        auto pyResult = PyEval_CallObject(pyFunc, pyArgs);
+        if (nullptr == pyResult) {
+            logging_func("InvokePythonFunc: no result");
+            return false;
+        }
 
-    scope.Add(pyResult);
-    if (PyArray_Check(pyResult)) {
-        ExtractOutput(pyResult, outputs, outputs_elem_size, outputs_dim);
-    } else if (PyTuple_Check(pyResult)) {
-        for (int32_t i = 0; i < PyTuple_Size(pyResult); ++i) {
-            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), outputs, outputs_elem_size, outputs_dim)) {
+        result_scope.Add(pyResult);
+        if (PyArray_Check(pyResult)) {
+            if (!WriteOutput(pyResult, 0, get_output_buffer)) {
                 logging_func("InvokePythonFunc: failed to extract output");
-                return false;
+                succeeded = false;
             }
+        } else if (PyTuple_Check(pyResult)) {
+            for (int32_t i = 0; i < PyTuple_Size(pyResult) && succeeded; ++i) {
+                if (!WriteOutput(PyTuple_GetItem(pyResult, i), i, get_output_buffer)) {
+                    logging_func("InvokePythonFunc: failed to extract output");
+                    succeeded = false;
+                }
+            }
+        } else {
+            logging_func("InvokePythonFunc: returned value must be numpy(s)");
+            succeeded = false;
+        }
+    }
+
+    // the views of the inputs must not outlive the call as they don't own their data
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (Py_REFCNT(PyTuple_GET_ITEM(pyArgs, i)) > 1) {
+            logging_func("InvokePythonFunc: compute function keeps a reference to an input, copy it instead");
         }
-    } else {
-        logging_func("InvokePythonFunc: returned value must be numpy(s)");
-        return false;
     }
-    return true;
+    return succeeded;
 }//bool InvokePythonFunc
 
 PyCustomKernel::PyCustomKernel(Ort::CustomOpApi ort,
@@ -239,18 +266,16 @@ PyCustomKernel::PyCustomKernel(Ort::CustomOpApi ort,
                                const std::string& compute,
                                PyOpLogFunc logging_func) : ort_(ort), attrs_(attrs), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func) {
   std::string err;
-  auto state = PyOpLibProxy::GetInstance().GetGil();
+  GilGuard gil;
   ORT_ENFORCE(PyOpLibProxy::GetInstance().Initialized(), "Py library not properly initialized.");
   instance_ = PyOpLibProxy::GetInstance().NewInstance(module.c_str(), class_name_.c_str(), attrs_);
-  PyOpLibProxy::GetInstance().PutGil(state);
   ORT_ENFORCE(nullptr != instance_, PyOpLibProxy::GetInstance().GetLastErrorMessage(err));
 }
 
 PyCustomKernel::~PyCustomKernel() {
   if (nullptr != instance_) {
-    auto state = PyOpLibProxy::GetInstance().GetGil();
+    GilGuard gil;
     PyOpLibProxy::GetInstance().ReleaseInstance(instance_);
-    PyOpLibProxy::GetInstance().PutGil(state);
     instance_ = nullptr;
   }
 }
@@ -262,9 +287,8 @@ void PyCustomKernel::Compute(OrtKernelContext* context) {
   ORT_ENFORCE(nullptr != context);
   auto inputs_count = (size_t) reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->InputCount();
   std::vector<const void*> inputs;
-  std::vector<std::unique_ptr<char[]>> outputs;
-  std::vector<int32_t> inputs_type, outputs_elem_size;
-  std::vector<std::vector<int64_t>> inputs_dim, outputs_dim;
+  std::vector<int32_t> inputs_type;
+  std::vector<std::vector<int64_t>> inputs_dim;
 
   for (size_t i = 0; i < inputs_count; ++i) {
     auto ort_value = ort_.KernelContext_GetInput(context, i);
@@ -273,20 +297,22 @@ void PyCustomKernel::Compute(OrtKernelContext* context) {
     inputs_dim.push_back(const_cast<MLValue*>(ort_value)->Get<Tensor>().Shape().GetDims());
   }
 
+  // the outputs are allocated once their shapes are known, and the results are copied into them directly
+  auto get_output_buffer = [this, context](size_t index, const std::vector<int64_t>& dims,
+                                           int32_t elem_size) -> void* {
+    auto ort_output = ort_.KernelContext_GetOutput(context, index, dims.data(), dims.size());
+    if (nullptr == ort_output ||
+        reinterpret_cast<MLValue*>(ort_output)->Get<Tensor>().DataType()->Size() != static_cast<size_t>(elem_size)) {
+      return nullptr;
+    }
+    return ort_.GetTensorMutableData<char>(ort_output);
+  };
+
   std::string err;
-  auto state = PyOpLibProxy::GetInstance().GetGil();
+  GilGuard gil;
   ORT_ENFORCE(PyOpLibProxy::GetInstance().InvokePythonFunc(instance_, compute_.c_str(), inputs, inputs_type,
-                                                           inputs_dim, outputs, outputs_elem_size,
-                                                           outputs_dim, logging_func_),
+                                                           inputs_dim, get_output_buffer, logging_func_),
               PyOpLibProxy::GetInstance().GetLastErrorMessage(err));  //ORT_ENFORCE
-  PyOpLibProxy::GetInstance().PutGil(state);
-
-  for (size_t i = 0; i < outputs.size(); ++i) {
-    auto ort_output = ort_.KernelContext_GetOutput(context, i, outputs_dim[i].data(), outputs_dim[i].size());
-    auto output_mem_addr = ort_.GetTensorMutableData<char>(ort_output);
-    auto output_len = std::accumulate(begin(outputs_dim[i]), end(outputs_dim[i]), static_cast<int64_t>(outputs_elem_size[i]), std::multiplies<int64_t>());
-    memcpy(output_mem_addr, outputs[i].get(), output_len);
-  }
 }
 
 int32_t PyCustomKernel::GetType(const OrtValue* input) const {
@@ -18,6 +18,8 @@ namespace onnxruntime {
 using OnnxTypes   = std::vector<ONNXTensorElementDataType>;
 using OnnxAttrs   = std::unordered_map<std::string, std::string>;
 using PyOpLogFunc = std::function<void(const char*)>;
+// Returns the buffer of the output with the given index and dims, or nullptr if its element size doesn't match.
+using PyOpOutputBufferFunc = std::function<void*(size_t, const std::vector<int64_t>&, int32_t)>;
 
 class PyOpLibProxy {
 
@@ -29,9 +31,7 @@ public:
                           const std::vector<const void*>&,
                           const std::vector<int32_t>&,
                           const std::vector<std::vector<int64_t>>&,
-                          std::vector<std::unique_ptr<char[]>>&,
-                          std::vector<int32_t>&,
-                          std::vector<std::vector<int64_t>>&,
+                          const PyOpOutputBufferFunc&,
                           std::function<void(const char*)>);
     const char* GetLastErrorMessage(std::string&);
     void* NewInstance(const char*, const char*, const OnnxAttrs&);
@@ -110,6 +110,12 @@ MlasGetPreferredBufferAlignment(
     void
     );
 
+const char*
+MLASCALL
+MlasGetPlatformSignature(
+    void
+    );
+
 //
 // Activation routines.
 //
@@ -121,6 +127,7 @@ enum MLAS_ACTIVATION_KIND {
     MlasTanhActivation,
     MlasLogisticActivation,
     MlasClipActivation,
+    MlasHardSigmoidActivation,
 };
 
 struct MLAS_ACTIVATION {
@@ -133,6 +140,10 @@ struct MLAS_ACTIVATION {
             float minimum;
             float maximum;
         } Clip;
+        struct {
+            float alpha;
+            float beta;
+        } HardSigmoid;
         float Values[2];
     } Parameters;
 };
@@ -188,6 +199,53 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Single precision matrix/matrix multiply with the activation and the optional
+// bias vector, with an element per row of matrix C, applied to each block of
+// matrix C as it is completed, while the block is still in the cache, instead
+// of by a separate pass over matrix C.
+//
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -245,6 +303,33 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Quantized integer matrix/matrix multiply routines with a single precision
+// matrix A, which is quantized to uint8 with AScale and offa as its panels are
+// packed.
+//
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float AScale,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    bool BIsSigned,
+    float* C,
+    size_t ldc,
+    const float* Scale,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -281,6 +366,26 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float AScale,
+    uint8_t offa,
+    const void* PackedB,
+    uint8_t offb,
+    bool BIsSigned,
+    float* C,
+    size_t ldc,
+    const float* Scale,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer packing routines.
 //
@@ -322,6 +427,122 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Sparse matrix/matrix multiply routines.
+//
+// Matrix B is packed in a block compressed format that only stores the blocks
+// of MLAS_SPARSE_GEMM_BLOCK_N columns of a row of B that have a non-zero
+// value, so the multiply skips the blocks of zeros of pruned weights.
+//
+
+#define MLAS_SPARSE_GEMM_BLOCK_N                    4
+
+size_t
+MLASCALL
+MlasSparseGemmCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    size_t N,
+    size_t K,
+    size_t NonZeroBlocks
+    );
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Blockwise quantized matrix/matrix multiply routines.
+//
+// Each column of matrix B is quantized to BlkBitWidth bits in blocks of BlkLen
+// values along K, with a scale and a zero point per block. The values of a
+// block are packed in order, the first value of a 4-bit pair in the low
+// nibble, and the blocks of a column are stored contiguously.
+//
+
+bool
+MLASCALL
+MlasIsBlockwiseQuantizedGemmAvailable(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    );
+
+void
+MLASCALL
+MlasBlockwiseQuantizedBufferSizes(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t N,
+    size_t K,
+    size_t* QuantBDataSizeInBytes,
+    size_t* QuantBScaleSize,
+    size_t* QuantBZeroPointSizeInBytes
+    );
+
+void
+MLASCALL
+MlasQuantizeBlockwise(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    size_t N,
+    size_t K,
+    bool Symmetric,
+    uint8_t* QuantBData,
+    float* QuantBScale,
+    uint8_t* QuantBZeroPoint
+    );
+
+void
+MLASCALL
+MlasBlockwiseQuantizedGemm(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    const float* Bias,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
@@ -330,10 +551,13 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
+    MlasConvAlgorithmWinograd,
 };
 
 struct MLAS_CONV_PARAMETERS {
     const MLAS_ACTIVATION* Activation;
+    float Beta;
     size_t Dimensions;
     size_t BatchCount;
     size_t GroupCount;
@@ -358,6 +582,10 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            const float* PackedFilter;
+            size_t TileBlockSize;
+        } Winograd;
     } u;
 };
 
@@ -377,6 +605,8 @@ MlasConvPrepare(
     const int64_t* OutputShape,
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
+    float Beta,
+    const float* WinogradFilter,
     size_t* WorkingBufferSize,
     MLAS_THREADPOOL* ThreadPool
     );
@@ -393,6 +623,36 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    );
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const uint8_t* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Pooling routines.
 //
@@ -419,6 +679,20 @@ MlasPool(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasPoolNhwc(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -458,6 +732,21 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasComputeMaskedSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    float Scale,
+    const float* Mask,
+    size_t MaskRowCount,
+    size_t MaskBroadcastCount,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -466,6 +755,59 @@ MlasComputeTanh(
     size_t N
     );
 
+//
+// Layer normalization routines.
+//
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
+//
+// Batch and instance normalization routines.
+//
+
+void
+MLASCALL
+MlasChannelScaleShift(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t BatchCount,
+    size_t ChannelCount,
+    size_t ChannelSize,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasInstanceNormalization(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t BatchCount,
+    size_t ChannelCount,
+    size_t ChannelSize,
+    float Epsilon,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -479,6 +821,55 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+extern "C"
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+typedef enum { MlasHalfTypeFloat16, MlasHalfTypeBFloat16 } MLAS_HALF_TYPE;
+
+void
+MLASCALL
+MlasConvertHalfToFloat(
+    MLAS_HALF_TYPE HalfType,
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasConvertFloatToHalf(
+    MLAS_HALF_TYPE HalfType,
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasHalfGemm(
+    MLAS_HALF_TYPE HalfType,
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* B,
+    size_t ldb,
+    float beta,
+    uint16_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Transpose routines.
 //
@@ -492,6 +883,15 @@ MlasTranspose(
     size_t N
     );
 
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    );
+
 void
 MLASCALL
 MlasTranspose(
@@ -501,6 +901,27 @@ MlasTranspose(
     size_t N
     );
 
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    uint64_t* Output,
+    size_t M,
+    size_t N
+    );
+
+bool
+MLASCALL
+MlasTransposeTensor(
+    const void* Input,
+    void* Output,
+    size_t ElementSize,
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -598,6 +1019,30 @@ MlasNchwcUpsample(
     float* Output
     );
 
+void
+MLASCALL
+MlasNchwcScaleChannels(
+    const int64_t* InputShape,
+    const float* Input,
+    const float* Scale,
+    bool BroadcastBatch,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasNchwcInstanceNormalization(
+    const int64_t* InputShape,
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float Epsilon,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Linear quantization routines.
 //
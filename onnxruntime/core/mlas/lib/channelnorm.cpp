@@ -0,0 +1,442 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    channelnorm.cpp
+
+Abstract:
+
+    This module implements routines to normalize the channels of a tensor in
+    NCHW format for the batch and instance normalization operators.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a channel normalization
+// operation on worker threads.
+//
+
+struct MLAS_CHANNEL_NORM_WORK_BLOCK {
+    int32_t ThreadCount;
+    size_t ChannelCount;
+    size_t TotalChannelCount;
+    size_t ChannelSize;
+    const float* Input;
+    const float* Scale;
+    const float* Bias;
+    float* Output;
+    bool ComputeMoments;
+    float Epsilon;
+    const MLAS_ACTIVATION* Activation;
+};
+
+void
+MlasScaleShiftChannel(
+    const float* Input,
+    float* Output,
+    size_t ChannelSize,
+    float Scale,
+    float Shift
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output = Input * Scale + Shift for the elements of a
+    channel.
+
+Arguments:
+
+    Input - Supplies the input channel.
+
+    Output - Supplies the output channel. The output channel may be the input
+        channel.
+
+    ChannelSize - Supplies the number of elements of the channel.
+
+    Scale - Supplies the scale of the channel.
+
+    Shift - Supplies the shift of the channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(Shift);
+
+    size_t n = 0;
+
+    for (; n + 8 <= ChannelSize; n += 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input + n);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + n + 4);
+
+        MlasStoreFloat32x4(Output + n, MlasMultiplyAddFloat32x4(Vector0, ScaleVector, ShiftVector));
+        MlasStoreFloat32x4(Output + n + 4, MlasMultiplyAddFloat32x4(Vector1, ScaleVector, ShiftVector));
+    }
+
+    for (; n < ChannelSize; n++) {
+        Output[n] = Input[n] * Scale + Shift;
+    }
+}
+
+void
+MlasComputeChannelMoments(
+    const float* Input,
+    size_t ChannelSize,
+    float* Mean,
+    float* Variance
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mean and the variance of the elements of a
+    channel in a single pass.
+
+    The sums are accumulated relative to the first element of the channel to
+    avoid the loss of precision from subtracting the square of a large mean
+    from the mean of the squares.
+
+Arguments:
+
+    Input - Supplies the input channel.
+
+    ChannelSize - Supplies the number of elements of the channel.
+
+    Mean - Receives the mean of the channel.
+
+    Variance - Receives the variance of the channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Offset = Input[0];
+
+    MLAS_FLOAT32X4 OffsetVector = MlasBroadcastFloat32x4(Offset);
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = SumVector0;
+    MLAS_FLOAT32X4 SumSquaresVector0 = SumVector0;
+    MLAS_FLOAT32X4 SumSquaresVector1 = SumVector0;
+
+    size_t n = 0;
+
+    for (; n + 8 <= ChannelSize; n += 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + n), OffsetVector);
+        MLAS_FLOAT32X4 Vector1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + n + 4), OffsetVector);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SumSquaresVector0);
+        SumSquaresVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SumSquaresVector1);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquaresVector0, SumSquaresVector1));
+
+    for (; n < ChannelSize; n++) {
+
+        float Value = Input[n] - Offset;
+
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+
+    const float MeanOffset = Sum / ChannelSize;
+
+    *Mean = MeanOffset + Offset;
+    *Variance = std::max(SumSquares / ChannelSize - MeanOffset * MeanOffset, 0.0f);
+}
+
+void
+MlasChannelNormalizationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    channel normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CHANNEL_NORM_WORK_BLOCK*)Context;
+
+    const size_t ChannelSize = WorkBlock->ChannelSize;
+
+    //
+    // Partition the channels from all of the batches to the threads.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->TotalChannelCount,
+        &WorkIndex, &WorkRemaining);
+
+    const float* Input = WorkBlock->Input + WorkIndex * ChannelSize;
+    float* Output = WorkBlock->Output + WorkIndex * ChannelSize;
+
+    for (size_t nc = WorkIndex; nc < WorkIndex + WorkRemaining; nc++) {
+
+        const size_t c = nc % WorkBlock->ChannelCount;
+
+        float Scale = WorkBlock->Scale[c];
+        float Shift = WorkBlock->Bias[c];
+
+        //
+        // Instance normalization computes the moments of each channel and
+        // folds them into the scale and shift of the channel. Otherwise, the
+        // scale and the shift are applied as is.
+        //
+
+        if (WorkBlock->ComputeMoments) {
+
+            float Mean;
+            float Variance;
+
+            MlasComputeChannelMoments(Input, ChannelSize, &Mean, &Variance);
+
+            Scale = Scale / std::sqrt(Variance + WorkBlock->Epsilon);
+            Shift = Shift - Mean * Scale;
+        }
+
+        MlasScaleShiftChannel(Input, Output, ChannelSize, Scale, Shift);
+
+        //
+        // Apply the activation to the channel while it is still in the cache.
+        //
+
+        MlasActivation(WorkBlock->Activation, Output, nullptr, 1, ChannelSize, ChannelSize);
+
+        Input += ChannelSize;
+        Output += ChannelSize;
+    }
+}
+
+void
+MlasExecuteChannelNormalization(
+    MLAS_CHANNEL_NORM_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine executes a channel normalization operation on the thread
+    pool.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the channel normalization
+        parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Limit the number of threads to the number of channels and try to keep
+    // each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > WorkBlock->TotalChannelCount) {
+        ThreadCount = int32_t(WorkBlock->TotalChannelCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((WorkBlock->TotalChannelCount * WorkBlock->ChannelSize) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    if (ThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock->ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasChannelNormalizationThreaded, WorkBlock, ThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasChannelScaleShift(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t BatchCount,
+    size_t ChannelCount,
+    size_t ChannelSize,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine scales and shifts each channel of the input tensor and then
+    applies the activation:
+
+        Output[n, c, :] = Activation(Input[n, c, :] * Scale[c] + Bias[c])
+
+    This implements batch normalization with the statistics of the channels
+    folded into the scale and the bias.
+
+Arguments:
+
+    Input - Supplies the input tensor in NCHW format.
+
+    Scale - Supplies the scale of each channel.
+
+    Bias - Supplies the shift of each channel.
+
+    Output - Supplies the output tensor. The output tensor may be the input
+        tensor.
+
+    BatchCount - Supplies the number of batches.
+
+    ChannelCount - Supplies the number of channels.
+
+    ChannelSize - Supplies the number of elements of each channel.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        output.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CHANNEL_NORM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ChannelCount = ChannelCount;
+    WorkBlock.TotalChannelCount = BatchCount * ChannelCount;
+    WorkBlock.ChannelSize = ChannelSize;
+    WorkBlock.Input = Input;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.ComputeMoments = false;
+    WorkBlock.Epsilon = 0.0f;
+    WorkBlock.Activation = Activation;
+
+    MlasExecuteChannelNormalization(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasInstanceNormalization(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t BatchCount,
+    size_t ChannelCount,
+    size_t ChannelSize,
+    float Epsilon,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes each channel of each batch of the input tensor by
+    its own mean and variance and then applies the activation:
+
+        Value = (Input[n, c, :] - Mean) / sqrt(Variance + Epsilon)
+        Output[n, c, :] = Activation(Value * Scale[c] + Bias[c])
+
+    The mean and the variance are computed in a single pass over the channel.
+
+Arguments:
+
+    Input - Supplies the input tensor in NCHW format.
+
+    Scale - Supplies the scale of each channel.
+
+    Bias - Supplies the shift of each channel.
+
+    Output - Supplies the output tensor. The output tensor may be the input
+        tensor.
+
+    BatchCount - Supplies the number of batches.
+
+    ChannelCount - Supplies the number of channels.
+
+    ChannelSize - Supplies the number of elements of each channel.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        output.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (ChannelSize == 0) {
+        return;
+    }
+
+    MLAS_CHANNEL_NORM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ChannelCount = ChannelCount;
+    WorkBlock.TotalChannelCount = BatchCount * ChannelCount;
+    WorkBlock.ChannelSize = ChannelSize;
+    WorkBlock.Input = Input;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.ComputeMoments = true;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Activation = Activation;
+
+    MlasExecuteChannelNormalization(&WorkBlock, ThreadPool);
+}
@@ -75,6 +75,10 @@ struct MLAS_SOFTMAX_WORK_BLOCK {
     float* Output;
     size_t N;
     size_t D;
+    float Scale;
+    const float* Mask;
+    size_t MaskRowCount;
+    size_t MaskBroadcastCount;
 };
 
 MLAS_FORCEINLINE
@@ -798,6 +802,83 @@ Return Value:
     }
 }
 
+static
+void
+MlasComputeScaleAddMaskF32Kernel(
+    const float* Input,
+    const float* Mask,
+    float* Output,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output = Scale * Input + Mask for a row of values.
+    The mask is optional.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Mask - Supplies the optional additive mask buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the scale factor of the input.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    if (Mask != nullptr) {
+
+        while (N >= 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Input), ScaleVector,
+                MlasLoadFloat32x4(Mask));
+            MlasStoreFloat32x4(Output, Vector);
+
+            Input += 4;
+            Mask += 4;
+            Output += 4;
+            N -= 4;
+        }
+
+        while (N > 0) {
+
+            *Output++ = *Input++ * Scale + *Mask++;
+            N -= 1;
+        }
+
+    } else {
+
+        while (N >= 4) {
+
+            MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Input), ScaleVector));
+
+            Input += 4;
+            Output += 4;
+            N -= 4;
+        }
+
+        while (N > 0) {
+
+            *Output++ = *Input++ * Scale;
+            N -= 1;
+        }
+    }
+}
+
 void
 MlasComputeSoftmaxThreaded(
     void* Context,
@@ -843,8 +924,34 @@ Return Value:
     const float* Input = WorkBlock->Input + n * D;
     float* Output = WorkBlock->Output + n * D;
 
+    const float Scale = WorkBlock->Scale;
+    const float* Mask = WorkBlock->Mask;
+    const bool ScaleOrMask = (Scale != 1.0f) || (Mask != nullptr);
+    const size_t MaskRowCount = WorkBlock->MaskRowCount;
+    const size_t MaskBlockRowCount = MaskRowCount * WorkBlock->MaskBroadcastCount;
+
     while (CountN > 0) {
 
+        //
+        // Scale the row and add the mask row in the output buffer, which then
+        // becomes the input of the softmax. Each block of MaskRowCount mask
+        // rows is broadcast to MaskBroadcastCount blocks of rows.
+        //
+
+        const float* RowInput = Input;
+
+        if (ScaleOrMask) {
+
+            const float* MaskRow = nullptr;
+
+            if (Mask != nullptr) {
+                MaskRow = Mask + ((n / MaskBlockRowCount) * MaskRowCount + (n % MaskRowCount)) * D;
+            }
+
+            MlasComputeScaleAddMaskF32Kernel(Input, MaskRow, Output, D, Scale);
+            Input = Output;
+        }
+
         //
         // Find the maximum value for the row.
         //
@@ -906,8 +1013,9 @@ Return Value:
 #endif
         }
 
-        Input += D;
+        Input = RowInput + D;
         Output += D;
+        n++;
         CountN--;
     }
 }
@@ -950,6 +1058,73 @@ Return Value:
 
     None.
 
+--*/
+{
+    MlasComputeMaskedSoftmax(Input, Output, N, D, 1.0f, nullptr, 1, 1, LogSoftmax, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeMaskedSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    float Scale,
+    const float* Mask,
+    size_t MaskRowCount,
+    size_t MaskBroadcastCount,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function of the scaled
+    input plus an additive mask, softmax(Scale * Input + Mask), without
+    materializing the masked input.
+
+    The mask has MaskRowCount rows of D elements for each block of
+    MaskRowCount * MaskBroadcastCount rows of the input. Input row n uses the
+    mask row (n / (MaskRowCount * MaskBroadcastCount)) * MaskRowCount +
+    (n % MaskRowCount). For example, the attention scores with shape
+    (batch, heads, sequence, sequence) use a mask with shape
+    (batch, sequence, sequence) by setting MaskRowCount to the sequence
+    length and MaskBroadcastCount to the number of heads.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Scale - Supplies the scale factor of the input.
+
+    Mask - Supplies the optional additive mask buffer.
+
+    MaskRowCount - Supplies the number of consecutive mask rows used by
+        consecutive input rows.
+
+    MaskBroadcastCount - Supplies the number of times each block of
+        MaskRowCount mask rows is repeated.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
 --*/
 {
     MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
@@ -963,6 +1138,10 @@ Return Value:
     WorkBlock.Output = Output;
     WorkBlock.N = N;
     WorkBlock.D = D;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Mask = Mask;
+    WorkBlock.MaskRowCount = (MaskRowCount == 0) ? 1 : MaskRowCount;
+    WorkBlock.MaskBroadcastCount = (MaskBroadcastCount == 0) ? 1 : MaskBroadcastCount;
 
     //
     // Compute the number of target threads given the complexity of the softmax
@@ -571,7 +571,7 @@ Return Value:
         //
 
         size_t CountK;
-        float beta = 0.0f;
+        float beta = Parameters->Beta;
         float* SegmentOutput = Output + SegmentStartN + n;
 
         for (size_t k = 0; k < K; k += CountK) {
@@ -590,39 +590,1249 @@ Return Value:
                     SegmentStartN + n, CountN);
             }
 
+            //
+            // Apply the activation with optional bias as the last slice along
+            // the K dimension completes the rows of the output.
+            //
+
+            const bool LastSliceK = (k + CountK == K);
+
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, LastSliceK ? Parameters->Activation : nullptr,
+                LastSliceK ? Bias : nullptr);
+
+            beta = 1.0f;
+        }
+    }
+}
+
+void
+MlasConvOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    float* ColumnBuffer =
+        WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+
+    MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
+        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
+        Segment->CountN);
+}
+
+void
+MlasConvGemmDirectThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of indices to use for this thread.
+    //
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
+    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
+
+    size_t BatchGroupStart;
+    size_t BatchGroupEnd;
+
+    if (uint32_t(Index) < BatchGroupCountExtra) {
+        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
+    } else {
+        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
+    }
+
+    //
+    // Iterate over the batch and groups allocated to this thread.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        const float* input = WorkBlock->Input + bg * InputGroupSize;
+        const float* filter = WorkBlock->Filter + group * FilterGroupSize;
+        float* output = WorkBlock->Output + bg * OutputGroupSize;
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        //
+        // Invoke the non-threaded GEMM directly with the input tensor, which
+        // applies the activation with optional bias.
+        //
+
+        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Parameters->Beta,
+            output, OutputSize, Parameters->Activation, bias);
+    }
+}
+
+inline
+bool
+MlasConvTryMultithread(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a convolution operation across multiple
+    threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+
+    if (ThreadStrideN >= OutputSize) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+    size_t SegmentCountN;
+
+    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+
+        SegmentCountN = OutputSize - SegmentStartN;
+
+        if (SegmentCountN > ThreadStrideN) {
+            SegmentCountN = ThreadStrideN;
+        }
+
+        WorkBlock.Segments[Index].StartN = SegmentStartN;
+        WorkBlock.Segments[Index].CountN = SegmentCountN;
+
+        Index++;
+    }
+
+    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, ThreadPool);
+
+    return true;
+}
+
+//
+// Define the loads of the input elements for the depthwise convolution. The
+// quantized elements are shifted by the zero point, so that padding elements
+// contribute nothing to the accumulators.
+//
+
+MLAS_FORCEINLINE
+float
+MlasConvDepthwiseLoadInput(
+    const float* Input,
+    float InputZeroPoint
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(InputZeroPoint);
+
+    return *Input;
+}
+
+MLAS_FORCEINLINE
+int32_t
+MlasConvDepthwiseLoadInput(
+    const uint8_t* Input,
+    int32_t InputZeroPoint
+    )
+{
+    return int32_t(*Input) - InputZeroPoint;
+}
+
+template<size_t KernelSize, typename InputType, typename AccumulatorType>
+MLAS_FORCEINLINE
+AccumulatorType
+MlasConvDepthwisePointBounded(
+    const InputType* const* RowInput,
+    const AccumulatorType* const* RowFilter,
+    size_t RowCount,
+    size_t InputWidth,
+    size_t InputColumn,
+    AccumulatorType InputZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single output element where some of the kernel
+    columns fall in the left or right padding of the input image.
+
+Arguments:
+
+    RowInput - Supplies the input rows that the kernel rows map to.
+
+    RowFilter - Supplies the filter rows for each of the input rows.
+
+    RowCount - Supplies the number of valid kernel rows.
+
+    InputWidth - Supplies the width of the input image.
+
+    InputColumn - Supplies the input column of the first kernel column, which
+        wraps around for columns to the left of the input image.
+
+    InputZeroPoint - Supplies the zero point offset of the input image.
+
+Return Value:
+
+    Returns the output element.
+
+--*/
+{
+    AccumulatorType Accumulator = AccumulatorType(0);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        for (size_t kw = 0; kw < KernelSize; kw++) {
+
+            const size_t iw = InputColumn + kw;
+
+            if (iw < InputWidth) {
+                Accumulator += MlasConvDepthwiseLoadInput(&RowInput[r][iw], InputZeroPoint) *
+                    RowFilter[r][kw];
+            }
+        }
+    }
+
+    return Accumulator;
+}
+
+template<size_t KernelSize, size_t Stride, typename InputType, typename AccumulatorType>
+MLAS_FORCEINLINE
+void
+MlasConvDepthwiseInteriorScalar(
+    const InputType* const* RowInput,
+    const AccumulatorType* const* RowFilter,
+    size_t RowCount,
+    size_t InputColumn,
+    AccumulatorType InputZeroPoint,
+    AccumulatorType* Output,
+    size_t OutputCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a range of output elements where every kernel column
+    maps inside the input image.
+
+Arguments:
+
+    RowInput - Supplies the input rows that the kernel rows map to.
+
+    RowFilter - Supplies the filter rows for each of the input rows.
+
+    RowCount - Supplies the number of valid kernel rows.
+
+    InputColumn - Supplies the input column of the first kernel column for the
+        first output element.
+
+    InputZeroPoint - Supplies the zero point offset of the input image.
+
+    Output - Supplies the first output element.
+
+    OutputCount - Supplies the number of output elements to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t ow = 0; ow < OutputCount; ow++) {
+
+        AccumulatorType Accumulator = AccumulatorType(0);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            const InputType* input = RowInput[r] + InputColumn + ow * Stride;
+            const AccumulatorType* filter = RowFilter[r];
+
+            for (size_t kw = 0; kw < KernelSize; kw++) {
+                Accumulator += MlasConvDepthwiseLoadInput(&input[kw], InputZeroPoint) *
+                    filter[kw];
+            }
+        }
+
+        Output[ow] = Accumulator;
+    }
+}
+
+template<size_t KernelSize, size_t Stride, typename InputType, typename AccumulatorType>
+struct MLAS_CONV_DEPTHWISE_INTERIOR
+{
+    MLAS_FORCEINLINE
+    static
+    void
+    Compute(
+        const InputType* const* RowInput,
+        const AccumulatorType* const* RowFilter,
+        size_t RowCount,
+        size_t InputColumn,
+        AccumulatorType InputZeroPoint,
+        AccumulatorType* Output,
+        size_t OutputCount
+        )
+    {
+        MlasConvDepthwiseInteriorScalar<KernelSize, Stride>(RowInput, RowFilter,
+            RowCount, InputColumn, InputZeroPoint, Output, OutputCount);
+    }
+};
+
+template<size_t KernelSize>
+struct MLAS_CONV_DEPTHWISE_INTERIOR<KernelSize, 1, float, float>
+{
+    MLAS_FORCEINLINE
+    static
+    void
+    Compute(
+        const float* const* RowInput,
+        const float* const* RowFilter,
+        size_t RowCount,
+        size_t InputColumn,
+        float InputZeroPoint,
+        float* Output,
+        size_t OutputCount
+        )
+    {
+        //
+        // Compute four adjacent output elements at a time. With a unit stride,
+        // each kernel column maps to four adjacent input elements.
+        //
+
+        while (OutputCount >= 4) {
+
+            MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+            for (size_t r = 0; r < RowCount; r++) {
+
+                const float* input = RowInput[r] + InputColumn;
+                const float* filter = RowFilter[r];
+
+                for (size_t kw = 0; kw < KernelSize; kw++) {
+                    Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&input[kw]),
+                        filter[kw], Accumulator);
+                }
+            }
+
+            MlasStoreFloat32x4(Output, Accumulator);
+
+            InputColumn += 4;
+            Output += 4;
+            OutputCount -= 4;
+        }
+
+        MlasConvDepthwiseInteriorScalar<KernelSize, 1>(RowInput, RowFilter,
+            RowCount, InputColumn, InputZeroPoint, Output, OutputCount);
+    }
+};
+
+template<size_t KernelSize, size_t Stride, typename InputType, typename AccumulatorType>
+void
+MlasConvDepthwiseKernel(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const InputType* Input,
+    AccumulatorType InputZeroPoint,
+    const AccumulatorType* Filter,
+    AccumulatorType* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single channel of a depthwise convolution with a
+    square kernel and a square stride.
+
+    Each output row is split into the elements that touch the left padding,
+    the interior elements where every kernel column maps inside the input
+    image, and the elements that touch the right padding. Kernel rows that map
+    to the top or bottom padding are skipped.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input image for the channel.
+
+    InputZeroPoint - Supplies the zero point offset of the input image.
+
+    Filter - Supplies the KernelSize x KernelSize filter for the channel.
+
+    Output - Supplies the output image for the channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    //
+    // Compute the range of output columns where every kernel column maps
+    // inside the input image.
+    //
+
+    size_t OutputWidthInteriorStart = (PaddingLeft + Stride - 1) / Stride;
+    size_t OutputWidthInteriorEnd = 0;
+
+    if (InputWidth + PaddingLeft >= KernelSize) {
+        OutputWidthInteriorEnd = (InputWidth + PaddingLeft - KernelSize) / Stride + 1;
+    }
+
+    OutputWidthInteriorStart = std::min(OutputWidthInteriorStart, OutputWidth);
+    OutputWidthInteriorEnd = std::max(OutputWidthInteriorStart,
+        std::min(OutputWidthInteriorEnd, OutputWidth));
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        //
+        // Gather the kernel rows that map inside the input image.
+        //
+
+        const InputType* RowInput[KernelSize];
+        const AccumulatorType* RowFilter[KernelSize];
+        size_t RowCount = 0;
+
+        for (size_t kh = 0; kh < KernelSize; kh++) {
+
+            const size_t ih = oh * Stride + kh - PaddingTop;
+
+            if (ih < InputHeight) {
+                RowInput[RowCount] = Input + ih * InputWidth;
+                RowFilter[RowCount] = Filter + kh * KernelSize;
+                RowCount++;
+            }
+        }
+
+        size_t ow = 0;
+
+        for (; ow < OutputWidthInteriorStart; ow++) {
+            Output[ow] = MlasConvDepthwisePointBounded<KernelSize>(RowInput,
+                RowFilter, RowCount, InputWidth, ow * Stride - PaddingLeft, InputZeroPoint);
+        }
+
+        MLAS_CONV_DEPTHWISE_INTERIOR<KernelSize, Stride, InputType, AccumulatorType>::Compute(
+            RowInput, RowFilter, RowCount, ow * Stride - PaddingLeft, InputZeroPoint,
+            Output + ow, OutputWidthInteriorEnd - ow);
+
+        for (ow = OutputWidthInteriorEnd; ow < OutputWidth; ow++) {
+            Output[ow] = MlasConvDepthwisePointBounded<KernelSize>(RowInput,
+                RowFilter, RowCount, InputWidth, ow * Stride - PaddingLeft, InputZeroPoint);
+        }
+
+        Output += OutputWidth;
+    }
+}
+
+template<typename InputType, typename AccumulatorType>
+void
+MlasConvDepthwiseChannel(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const InputType* Input,
+    AccumulatorType InputZeroPoint,
+    const AccumulatorType* Filter,
+    AccumulatorType* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single channel of a depthwise convolution using
+    the kernel specialized for the kernel size and the stride.
+
+Arguments:
+
+    See MlasConvDepthwiseKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t KernelSize = Parameters->KernelShape[1];
+    const size_t Stride = Parameters->StrideShape[1];
+
+    if (KernelSize == 3) {
+        if (Stride == 1) {
+            MlasConvDepthwiseKernel<3, 1>(Parameters, Input, InputZeroPoint, Filter, Output);
+        } else {
+            MlasConvDepthwiseKernel<3, 2>(Parameters, Input, InputZeroPoint, Filter, Output);
+        }
+    } else {
+        if (Stride == 1) {
+            MlasConvDepthwiseKernel<5, 1>(Parameters, Input, InputZeroPoint, Filter, Output);
+        } else {
+            MlasConvDepthwiseKernel<5, 2>(Parameters, Input, InputZeroPoint, Filter, Output);
+        }
+    }
+}
+
+void
+MlasConvDepthwiseFloatThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t KernelSize = Parameters->K;
+
+    //
+    // Compute the range of channels to use for this thread.
+    //
+
+    size_t ChannelIndex;
+    size_t ChannelRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount,
+        Parameters->BatchCount * GroupCount, &ChannelIndex, &ChannelRemaining);
+
+    for (size_t bg = ChannelIndex; bg < ChannelIndex + ChannelRemaining; bg++) {
+
+        const size_t group = bg % GroupCount;
+
+        float* output = WorkBlock->Output + bg * OutputSize;
+
+        MlasConvDepthwiseChannel(Parameters, WorkBlock->Input + bg * InputSize,
+            0.0f, WorkBlock->Filter + group * KernelSize, output);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, 1, OutputSize, OutputSize);
+    }
+}
+
+//
+// Define the parameters to execute segments of a quantized depthwise
+// convolution operation on worker threads.
+//
+
+struct MLAS_CONV_DEPTHWISE_U8_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const uint8_t* Input;
+    int32_t InputZeroPoint;
+    const uint8_t* Filter;
+    int32_t FilterZeroPoint;
+    int32_t* Output;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasConvDepthwiseU8Threaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    quantized depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_DEPTHWISE_U8_WORK_BLOCK* WorkBlock = (MLAS_CONV_DEPTHWISE_U8_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t KernelSize = Parameters->K;
+
+    //
+    // Compute the range of channels to use for this thread.
+    //
+
+    size_t ChannelIndex;
+    size_t ChannelRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount,
+        Parameters->BatchCount * GroupCount, &ChannelIndex, &ChannelRemaining);
+
+    for (size_t bg = ChannelIndex; bg < ChannelIndex + ChannelRemaining; bg++) {
+
+        const size_t group = bg % GroupCount;
+
+        //
+        // Shift the filter by the zero point offset once for the channel.
+        //
+
+        const uint8_t* filter = WorkBlock->Filter + group * KernelSize;
+        int32_t FilterValues[5 * 5];
+
+        for (size_t k = 0; k < KernelSize; k++) {
+            FilterValues[k] = int32_t(filter[k]) - WorkBlock->FilterZeroPoint;
+        }
+
+        MlasConvDepthwiseChannel(Parameters, WorkBlock->Input + bg * InputSize,
+            WorkBlock->InputZeroPoint, FilterValues, WorkBlock->Output + bg * OutputSize);
+    }
+}
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const uint8_t* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized depthwise convolution operation.
+
+    The convolution parameters must have been prepared by MlasConvPrepare
+    with the MlasConvAlgorithmDepthwise algorithm selected.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    InputZeroPoint - Supplies the zero point offset of the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    FilterZeroPoint - Supplies the zero point offset of the filter tensor.
+
+    Output - Supplies the intermediate output tensor, which is typically
+        requantized with MlasRequantizeOutput.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t ChannelCount = Parameters->BatchCount * Parameters->GroupCount;
+
+    int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) >= ChannelCount) {
+        TargetThreadCount = int32_t(ChannelCount);
+    }
+
+    MLAS_CONV_DEPTHWISE_U8_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.InputZeroPoint = InputZeroPoint;
+    WorkBlock.Filter = Filter;
+    WorkBlock.FilterZeroPoint = FilterZeroPoint;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasConvDepthwiseU8Threaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+//
+// Define the Winograd F(4x4, 3x3) convolution parameters. Each input tile of
+// 6x6 elements is transformed to 36 values, which are multiplied with the 36
+// transformed values of each filter and then transformed back to an output
+// tile of 4x4 elements.
+//
+// The transformed input tiles of a block of tiles are stored as 36 matrices
+// with a row per input channel and a column per tile, so that the products
+// for all of the channels and filters are computed with 36 GEMMs.
+//
+
+#define MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE         4
+#define MLAS_CONV_WINOGRAD_INPUT_TILE_SIZE          6
+#define MLAS_CONV_WINOGRAD_TRANSFORM_COUNT          36
+
+//
+// Define the range of the number of tiles transformed as a block. Smaller
+// blocks fall below the efficient column count of the GEMM kernels.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK       8
+#define MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK       16
+
+//
+// Define the minimum number of input channels and filters per group for the
+// Winograd algorithm. Below these counts, the transforms dominate the savings
+// of the GEMMs.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS         16
+
+//
+// Define the approximate number of operations for the transform of a tile of
+// one input channel and for the transform of a tile of one output channel.
+//
+
+#define MLAS_CONV_WINOGRAD_INPUT_TRANSFORM_COST     192
+#define MLAS_CONV_WINOGRAD_OUTPUT_TRANSFORM_COST    160
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradTransformFilter1D(
+    const float* g,
+    size_t gStride,
+    float* u,
+    size_t uStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies three filter elements by the 6x3 filter transform
+    matrix G.
+
+Arguments:
+
+    g - Supplies the address of the first filter element.
+
+    gStride - Supplies the distance between the filter elements.
+
+    u - Supplies the address of the first transformed element.
+
+    uStride - Supplies the distance between the transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float g0 = g[0];
+    const float g1 = g[gStride];
+    const float g2 = g[2 * gStride];
+
+    u[0] = g0 * (1.0f / 4.0f);
+    u[uStride] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+    u[2 * uStride] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+    u[3 * uStride] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    u[4 * uStride] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    u[5 * uStride] = g2;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradTransformInput1D(
+    const float* d,
+    size_t dStride,
+    float* v,
+    size_t vStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies six input elements by the 6x6 input transform
+    matrix B transposed.
+
+Arguments:
+
+    d - Supplies the address of the first input element.
+
+    dStride - Supplies the distance between the input elements.
+
+    v - Supplies the address of the first transformed element.
+
+    vStride - Supplies the distance between the transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float d0 = d[0];
+    const float d1 = d[dStride];
+    const float d2 = d[2 * dStride];
+    const float d3 = d[3 * dStride];
+    const float d4 = d[4 * dStride];
+    const float d5 = d[5 * dStride];
+
+    const float t0 = d4 - 4.0f * d2;
+    const float t1 = d3 - 4.0f * d1;
+    const float t2 = d4 - d2;
+    const float t3 = 2.0f * (d3 - d1);
+
+    v[0] = 4.0f * d0 - 5.0f * d2 + d4;
+    v[vStride] = t0 + t1;
+    v[2 * vStride] = t0 - t1;
+    v[3 * vStride] = t2 + t3;
+    v[4 * vStride] = t2 - t3;
+    v[5 * vStride] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradTransformOutput1D(
+    const float* m,
+    size_t mStride,
+    float* y,
+    size_t yStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies six transformed output elements by the 4x6 output
+    transform matrix A transposed.
+
+Arguments:
+
+    m - Supplies the address of the first transformed element.
+
+    mStride - Supplies the distance between the transformed elements.
+
+    y - Supplies the address of the first output element.
+
+    yStride - Supplies the distance between the output elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float m0 = m[0];
+    const float m1 = m[mStride];
+    const float m2 = m[2 * mStride];
+    const float m3 = m[3 * mStride];
+    const float m4 = m[4 * mStride];
+    const float m5 = m[5 * mStride];
+
+    const float t0 = m1 + m2;
+    const float t1 = m1 - m2;
+    const float t2 = m3 + m4;
+    const float t3 = m3 - m4;
+
+    y[0] = m0 + t0 + t2;
+    y[yStride] = t1 + 2.0f * t3;
+    y[2 * yStride] = t0 + 4.0f * t2;
+    y[3 * yStride] = t1 + 8.0f * t3 + m5;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements to allocate for the filter
+    of a 3x3 convolution packed by MlasConvWinogradPackFilter.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of elements of the packed filter, else zero if
+    MlasConvPrepare never selects the Winograd algorithm for these channel
+    counts.
+
+--*/
+{
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return 0;
+    }
+
+    return GroupCount * MLAS_CONV_WINOGRAD_TRANSFORM_COUNT * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the filter of a 3x3 convolution for the Winograd
+    algorithm.
+
+    The 36 transformed values of each filter and input channel are stored as
+    36 matrices per group, each with a row per filter and a column per input
+    channel.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor in OIHW order.
+
+    PackedFilter - Supplies the buffer to receive the transformed filter. The
+        size of the buffer is returned by MlasConvWinogradPackFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t TransformStride = FilterCount * InputChannels;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                //
+                // Compute G * g * G^T for the 3x3 filter elements.
+                //
+
+                float Columns[3][6];
+                float Transform[6][6];
+
+                for (size_t kw = 0; kw < 3; kw++) {
+                    MlasConvWinogradTransformFilter1D(&Filter[kw], 3, &Columns[kw][0], 1);
+                }
+
+                for (size_t i = 0; i < 6; i++) {
+                    MlasConvWinogradTransformFilter1D(&Columns[0][i], 6, &Transform[i][0], 1);
+                }
+
+                float* packed = PackedFilter + f * InputChannels + c;
+
+                for (size_t i = 0; i < 6; i++) {
+                    for (size_t j = 0; j < 6; j++) {
+                        packed[(i * 6 + j) * TransformStride] = Transform[i][j];
+                    }
+                }
+
+                Filter += 9;
+            }
+        }
+
+        PackedFilter += MLAS_CONV_WINOGRAD_TRANSFORM_COUNT * TransformStride;
+    }
+}
+
+void
+MlasConvWinogradTransformInputTiles(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    size_t TileIndex,
+    size_t TileCount,
+    float* TransformedInput
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of input tiles for all of the input
+    channels of a group.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor for the group.
+
+    TileIndex - Supplies the index of the first tile in row major order.
+
+    TileCount - Supplies the number of tiles of the block.
+
+    TransformedInput - Supplies the buffer to receive the 36 matrices of
+        transformed input tiles.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    const size_t TileColumns = (Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TransformStride = InputChannels * TileBlockSize;
+
+    for (size_t t = 0; t < TileCount; t++) {
+
+        const size_t ih0 = ((TileIndex + t) / TileColumns) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - PaddingTop;
+        const size_t iw0 = ((TileIndex + t) % TileColumns) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - PaddingLeft;
+
+        const bool InteriorColumns = iw0 < InputWidth &&
+            iw0 + MLAS_CONV_WINOGRAD_INPUT_TILE_SIZE <= InputWidth;
+
+        const float* input = Input;
+        float* transformed = TransformedInput + t;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            //
+            // Load the input tile with zeros for the padding elements.
+            //
+
+            float Tile[6][6];
+
+            for (size_t i = 0; i < 6; i++) {
+
+                const size_t ih = ih0 + i;
+
+                if (ih >= InputHeight) {
+
+                    for (size_t j = 0; j < 6; j++) {
+                        Tile[i][j] = 0.0f;
+                    }
+
+                } else if (InteriorColumns) {
+
+                    const float* row = input + ih * InputWidth + iw0;
+
+                    for (size_t j = 0; j < 6; j++) {
+                        Tile[i][j] = row[j];
+                    }
 
-            beta = 1.0f;
-        }
+                } else {
 
-        //
-        // Apply the activation with optional bias.
-        //
+                    const float* row = input + ih * InputWidth;
+
+                    for (size_t j = 0; j < 6; j++) {
+                        const size_t iw = iw0 + j;
+                        Tile[i][j] = (iw < InputWidth) ? row[iw] : 0.0f;
+                    }
+                }
+            }
+
+            //
+            // Compute B^T * d * B for the input tile.
+            //
+
+            float Columns[6][6];
+
+            for (size_t j = 0; j < 6; j++) {
+                MlasConvWinogradTransformInput1D(&Tile[0][j], 6, &Columns[j][0], 1);
+            }
 
-        MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
-            CountN, OutputSize);
+            for (size_t i = 0; i < 6; i++) {
+                MlasConvWinogradTransformInput1D(&Columns[0][i], 6,
+                    &transformed[i * 6 * TransformStride], TransformStride);
+            }
+
+            input += InputSize;
+            transformed += TileBlockSize;
+        }
     }
 }
 
 void
-MlasConvOperationThreaded(
-    void* Context,
-    int32_t Index
+MlasConvWinogradTransformOutputTiles(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* TransformedOutput,
+    size_t TileCount,
+    float* OutputTiles
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    convolution operation.
+    This routine transforms a block of output tiles for all of the filters of
+    a group.
 
 Arguments:
 
-    Context - Supplies the pointer to the context for the threaded operation.
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
 
-    Index - Supplies the current index of the threaded operation.
+    TransformedOutput - Supplies the 36 matrices of transformed output tiles.
+
+    TileCount - Supplies the number of tiles of the block.
+
+    OutputTiles - Supplies the buffer to receive the output tiles. Each row
+        of the buffer stores the 4x4 tiles of a filter.
 
 Return Value:
 
@@ -630,20 +1840,40 @@ Return Value:
 
 --*/
 {
-    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TransformStride = FilterCount * TileBlockSize;
 
-    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+    for (size_t f = 0; f < FilterCount; f++) {
 
-    float* ColumnBuffer =
-        WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+        const float* transformed = TransformedOutput + f * TileBlockSize;
+        float* output = OutputTiles + f * TileBlockSize * 16;
 
-    MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
-        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
-        Segment->CountN);
+        for (size_t t = 0; t < TileCount; t++) {
+
+            //
+            // Compute A^T * m * A for the output tile.
+            //
+
+            float Columns[6][4];
+
+            for (size_t j = 0; j < 6; j++) {
+                MlasConvWinogradTransformOutput1D(&transformed[j * TransformStride],
+                    6 * TransformStride, &Columns[j][0], 1);
+            }
+
+            for (size_t i = 0; i < 4; i++) {
+                MlasConvWinogradTransformOutput1D(&Columns[0][i], 4, &output[i * 4], 1);
+            }
+
+            transformed++;
+            output += 16;
+        }
+    }
 }
 
 void
-MlasConvGemmDirectThreaded(
+MlasConvWinogradThreaded(
     void* Context,
     int32_t Index
     )
@@ -652,7 +1882,7 @@ MlasConvGemmDirectThreaded(
 Routine Description:
 
     This routine is invoked from a worker thread to execute a segment of a
-    convolution operation.
+    Winograd convolution operation.
 
 Arguments:
 
@@ -670,59 +1900,85 @@ Return Value:
 
     const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
 
-    //
-    // Compute the range of indices to use for this thread.
-    //
-
     const size_t GroupCount = Parameters->GroupCount;
-    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
 
-    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+    const size_t TileColumns = (OutputWidth + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+    const size_t TileRows = (OutputHeight + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+    const size_t TileCount = TileRows * TileColumns;
+    const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
 
-    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
-    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
+    const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = MLAS_CONV_WINOGRAD_TRANSFORM_COUNT * FilterCount * InputChannels;
 
-    size_t BatchGroupStart;
-    size_t BatchGroupEnd;
+    //
+    // Carve the working buffer of this thread into the transformed input
+    // tiles, the transformed output tiles, and the output tiles.
+    //
 
-    if (uint32_t(Index) < BatchGroupCountExtra) {
-        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
-        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
-    } else {
-        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
-        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
-    }
+    const size_t TransformedInputSize = MLAS_CONV_WINOGRAD_TRANSFORM_COUNT * InputChannels * TileBlockSize;
+    const size_t TransformedOutputSize = MLAS_CONV_WINOGRAD_TRANSFORM_COUNT * FilterCount * TileBlockSize;
+    const size_t OutputTilesSize = FilterCount * TileBlockSize * 16;
+
+    float* TransformedInput = WorkBlock->WorkingBuffer +
+        Index * (TransformedInputSize + TransformedOutputSize + OutputTilesSize);
+    float* TransformedOutput = TransformedInput + TransformedInputSize;
+    float* OutputTiles = TransformedOutput + TransformedOutputSize;
 
     //
-    // Iterate over the batch and groups allocated to this thread.
+    // Compute the range of tile blocks to use for this thread.
     //
 
-    const size_t FilterCount = Parameters->FilterCount;
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t K = Parameters->K;
+    size_t WorkIndex;
+    size_t WorkRemaining;
 
-    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
-    const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount,
+        Parameters->BatchCount * GroupCount * TileBlockCount, &WorkIndex, &WorkRemaining);
 
-    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+    for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
 
-        size_t group = bg % GroupCount;
+        const size_t bg = w / TileBlockCount;
+        const size_t group = bg % GroupCount;
+        const size_t TileIndex = (w % TileBlockCount) * TileBlockSize;
 
-        const float* input = WorkBlock->Input + bg * InputGroupSize;
-        const float* filter = WorkBlock->Filter + group * FilterGroupSize;
-        float* output = WorkBlock->Output + bg * OutputGroupSize;
+        size_t CountTiles = TileCount - TileIndex;
+
+        if (CountTiles > TileBlockSize) {
+            CountTiles = TileBlockSize;
+        }
+
+        MlasConvWinogradTransformInputTiles(Parameters, WorkBlock->Input + bg * InputGroupSize,
+            TileIndex, CountTiles, TransformedInput);
 
         //
-        // Invoke the non-threaded GEMM directly with the input tensor.
+        // Multiply each of the transformed filter matrices by the matching
+        // transformed input matrix.
         //
 
-        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+        const float* filter = WorkBlock->Filter + group * FilterGroupSize;
+
+        for (size_t k = 0; k < MLAS_CONV_WINOGRAD_TRANSFORM_COUNT; k++) {
+
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountTiles,
+                InputChannels, 1.0f, filter + k * FilterCount * InputChannels, InputChannels,
+                TransformedInput + k * InputChannels * TileBlockSize, TileBlockSize, 0.0f,
+                TransformedOutput + k * FilterCount * TileBlockSize, TileBlockSize, nullptr,
+                nullptr);
+        }
+
+        MlasConvWinogradTransformOutputTiles(Parameters, TransformedOutput, CountTiles,
+            OutputTiles);
 
         //
-        // Apply the activation with optional bias.
+        // Apply the activation with optional bias to the output tiles.
         //
 
         const float* bias = WorkBlock->Bias;
@@ -731,97 +1987,163 @@ Return Value:
             bias += group * FilterCount;
         }
 
-        MlasActivation(Parameters->Activation, output, bias, FilterCount,
-            OutputSize, OutputSize);
+        MlasActivation(Parameters->Activation, OutputTiles, bias, FilterCount,
+            CountTiles * 16, TileBlockSize * 16);
+
+        //
+        // Copy the output tiles to the output tensor, clipping the tiles at
+        // the bottom and right edges.
+        //
+
+        float* output = WorkBlock->Output + bg * OutputGroupSize;
+
+        for (size_t t = 0; t < CountTiles; t++) {
+
+            const size_t oh = ((TileIndex + t) / TileColumns) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+            const size_t ow = ((TileIndex + t) % TileColumns) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+
+            size_t CountRows = OutputHeight - oh;
+            size_t CountColumns = OutputWidth - ow;
+
+            if (CountRows > MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE) {
+                CountRows = MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+            }
+
+            if (CountColumns > MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE) {
+                CountColumns = MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+            }
+
+            for (size_t f = 0; f < FilterCount; f++) {
+
+                const float* tile = OutputTiles + (f * TileBlockSize + t) * 16;
+                float* row = output + f * OutputSize + oh * OutputWidth + ow;
+
+                for (size_t i = 0; i < CountRows; i++) {
+                    for (size_t j = 0; j < CountColumns; j++) {
+                        row[j] = tile[i * 4 + j];
+                    }
+                    row += OutputWidth;
+                }
+            }
+        }
     }
 }
 
-inline
 bool
-MlasConvTryMultithread(
-    const MLAS_CONV_PARAMETERS* Parameters,
-    const float* Input,
-    const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
-    float* Output,
+MlasConvWinogradTryPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    const float* WinogradFilter,
+    size_t* WorkingBufferSize,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a convolution operation across multiple
-    threads.
+    This routine selects the Winograd algorithm for a 3x3 convolution with
+    unit strides and dilations if its estimated cost is below the cost of the
+    expansion and GEMM algorithm.
 
 Arguments:
 
-    Parameters - Supplies the structure that contains the convolution
-        parameters.
-
-    Input - Supplies the input tensor.
-
-    Filter - Supplies the filter tensor.
-
-    Bias - Optionally supplies the bias vector.
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    WinogradFilter - Supplies the filter packed by MlasConvWinogradPackFilter.
 
-    Output - Supplies the output tensor.
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
 
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    Returns true if the Winograd algorithm was selected, else false.
 
 --*/
 {
-    MLAS_CONV_WORK_BLOCK WorkBlock;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
 
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return false;
+    }
 
-    if (ThreadStrideN >= OutputSize) {
+    const size_t TileRows = (Parameters->OutputShape[0] + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+    const size_t TileColumns = (Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+    const size_t TileCount = TileRows * TileColumns;
+
+    if (TileCount < MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK) {
         return false;
     }
 
     //
-    // Initialize the common fields of the work block.
+    // Spread the tiles across the threads with blocks that are not smaller
+    // than the minimum tile block. The tiles of an image are then divided
+    // evenly across its blocks.
     //
 
-    WorkBlock.Parameters = Parameters;
-    WorkBlock.Input = Input;
-    WorkBlock.Filter = Filter;
-    WorkBlock.Bias = Bias;
-    WorkBlock.WorkingBuffer = WorkingBuffer;
-    WorkBlock.Output = Output;
+    const size_t BatchGroupCount = Parameters->BatchCount * Parameters->GroupCount;
+    const int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
-    //
-    // Segment the operation across multiple threads.
-    //
+    size_t TileBlockSize = (BatchGroupCount * TileCount + MaximumThreadCount - 1) / MaximumThreadCount;
 
-    int32_t Index = 0;
-    size_t SegmentCountN;
+    if (TileBlockSize < MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK) {
+        TileBlockSize = MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK;
+    } else if (TileBlockSize > MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK) {
+        TileBlockSize = MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK;
+    }
 
-    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+    size_t TileBlocksPerImage = (TileCount + TileBlockSize - 1) / TileBlockSize;
 
-        SegmentCountN = OutputSize - SegmentStartN;
+    if (TileBlocksPerImage > TileCount / MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK) {
+        TileBlocksPerImage = TileCount / MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK;
+    }
 
-        if (SegmentCountN > ThreadStrideN) {
-            SegmentCountN = ThreadStrideN;
-        }
+    TileBlockSize = (TileCount + TileBlocksPerImage - 1) / TileBlocksPerImage;
 
-        WorkBlock.Segments[Index].StartN = SegmentStartN;
-        WorkBlock.Segments[Index].CountN = SegmentCountN;
+    const size_t TileBlockCount = BatchGroupCount * TileBlocksPerImage;
 
-        Index++;
+    int32_t TargetThreadCount = MaximumThreadCount;
+
+    if (size_t(TargetThreadCount) >= TileBlockCount) {
+        TargetThreadCount = int32_t(TileBlockCount);
     }
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, ThreadPool);
+    //
+    // Compare the operations per thread of the Winograd algorithm, including
+    // the rounding of the output to whole tiles and the imbalance of the tile
+    // blocks across the threads, with the operations per thread of the GEMM
+    // of the expanded input. The transforms and the smaller GEMMs don't run
+    // at the rate of the large GEMM, so the Winograd algorithm must save at
+    // least a third of the operations.
+    //
+
+    const size_t TileBlocksPerThread = (TileBlockCount + TargetThreadCount - 1) / TargetThreadCount;
+
+    const double WinogradCost = double(TileBlocksPerThread * TileBlockSize) *
+        (double(MLAS_CONV_WINOGRAD_TRANSFORM_COUNT) * double(FilterCount) * double(InputChannels) +
+        double(MLAS_CONV_WINOGRAD_INPUT_TRANSFORM_COST) * double(InputChannels) +
+        double(MLAS_CONV_WINOGRAD_OUTPUT_TRANSFORM_COST) * double(FilterCount));
+
+    const double GemmCost = double(BatchGroupCount) * double(FilterCount) *
+        double(Parameters->OutputSize) * double(Parameters->K) / double(MaximumThreadCount);
+
+    if (WinogradCost * 3.0 >= GemmCost * 2.0) {
+        return false;
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = TargetThreadCount;
+    Parameters->u.Winograd.PackedFilter = WinogradFilter;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+
+    *WorkingBufferSize = size_t(TargetThreadCount) * TileBlockSize *
+        (MLAS_CONV_WINOGRAD_TRANSFORM_COUNT * (InputChannels + FilterCount) + 16 * FilterCount);
 
     return true;
 }
@@ -850,14 +2172,18 @@ Arguments:
 
     Input - Supplies the input tensor.
 
-    Filter - Supplies the filter tensor.
+    Filter - Supplies the filter tensor. The filter isn't referenced if the
+        Winograd algorithm was selected, which uses the packed filter supplied
+        to MlasConvPrepare.
 
     Bias - Optionally supplies the bias vector.
 
     WorkingBuffer - Supplies a working buffer sized to the number of elements
         returned by MlasConvPrepare.
 
-    Output - Supplies the output tensor.
+    Output - Supplies the output tensor. If the Beta supplied to
+        MlasConvPrepare is non-zero, the output tensor is scaled by Beta and
+        accumulated into before the activation is applied.
 
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
@@ -881,6 +2207,57 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // Schedule the channels of a depthwise convolution across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        const size_t ChannelCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= ChannelCount) {
+            TargetThreadCount = int32_t(ChannelCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvDepthwiseFloatThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+
+        return;
+    }
+
+    //
+    // Schedule the tile blocks of a Winograd convolution across multiple
+    // threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Parameters->u.Winograd.PackedFilter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = WorkingBuffer;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+        MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -930,19 +2307,13 @@ Return Value:
                 case MlasConvAlgorithmGemmDirect:
                 {
                     //
-                    // Invoke the threaded GEMM directly with the input tensor.
+                    // Invoke the threaded GEMM directly with the input tensor,
+                    // which applies the activation with optional bias.
                     //
 
                     MlasGemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize, ThreadPool);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
-
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb,
+                        Parameters->Beta, Output, OutputSize, Parameters->Activation, bias, ThreadPool);
 
                     break;
                 }
@@ -951,7 +2322,7 @@ Return Value:
                 {
                     //
                     // Expand the input tensor to the working buffer and then invoke the
-                    // threaded GEMM.
+                    // threaded GEMM, which applies the activation with optional bias.
                     //
 
                     if (Parameters->Dimensions == 2) {
@@ -961,14 +2332,8 @@ Return Value:
                     }
 
                     MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, ThreadPool);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
-
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                        K, WorkingBuffer, OutputSize, Parameters->Beta, Output, OutputSize,
+                        Parameters->Activation, bias, ThreadPool);
 
                     break;
                 }
@@ -1021,6 +2386,8 @@ MlasConvPrepare(
     const int64_t* OutputShape,
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
+    float Beta,
+    const float* WinogradFilter,
     size_t* WorkingBufferSize,
     MLAS_THREADPOOL* ThreadPool
     )
@@ -1063,6 +2430,16 @@ Arguments:
     Activation - Supplies the parameters for the activation to apply to the
         convolution output.
 
+    Beta - Supplies the scalar multiplier for the existing contents of the
+        output tensor, which are added to the convolution output before the
+        activation is applied, e.g. to fuse the residual addition of a ResNet
+        block. Zero ignores the existing contents.
+
+    WinogradFilter - Optionally supplies the filter packed by
+        MlasConvWinogradPackFilter, else nullptr if the Winograd algorithm must
+        not be selected. The packed filter must remain valid until MlasConv
+        has completed.
+
     WorkingBufferSize - Receives the number of elements to allocate for the
         working buffer for intermediate results.
 
@@ -1080,6 +2457,7 @@ Return Value:
     //
 
     Parameters->Activation = Activation;
+    Parameters->Beta = Beta;
     Parameters->BatchCount = BatchCount;
     Parameters->GroupCount = GroupCount;
     Parameters->InputChannels = InputChannels;
@@ -1148,6 +2526,40 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect a depthwise convolution with a square 3x3 or 5x5 kernel and a
+    // square stride of one or two, which is computed directly from the input
+    // tensor. The depthwise and Winograd algorithms overwrite the output
+    // tensor, so these are only selected if the output isn't accumulated into.
+    //
+
+    if (Dimensions == 2 && InputChannels == 1 && FilterCount == 1 && AllDilationsAreOne && Beta == 0.0f) {
+
+        const size_t KernelSize = Parameters->KernelShape[1];
+        const size_t Stride = Parameters->StrideShape[1];
+
+        if ((KernelSize == 3 || KernelSize == 5) && Parameters->KernelShape[0] == KernelSize &&
+            (Stride == 1 || Stride == 2) && Parameters->StrideShape[0] == Stride) {
+
+            Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+            return;
+        }
+    }
+
+    //
+    // Detect a 3x3 convolution that is cheaper to compute with the Winograd
+    // algorithm.
+    //
+
+    if (WinogradFilter != nullptr && Beta == 0.0f && Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3) {
+
+        if (MlasConvWinogradTryPrepare(Parameters, WinogradFilter, WorkingBufferSize, ThreadPool)) {
+            return;
+        }
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -0,0 +1,627 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the half precision (float16 and bfloat16) matrix
+    multiply operation (HGEMM).
+
+    The matrices stay in half precision in memory. Blocks of the source
+    matrices are widened to single precision in buffers on the stack and
+    multiplied with the SGEMM kernels, so the products are accumulated in
+    single precision. The output matrix is narrowed back to half precision
+    once the whole inner dimension has been accumulated.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the dimensions of the blocks of the matrices widened to single
+// precision. The output block of StrideM rows by StrideN columns is
+// accumulated in single precision over the steps of StrideK.
+//
+
+#define MLAS_HGEMM_STRIDEM                          32
+#define MLAS_HGEMM_STRIDEN                          MLAS_SGEMM_STRIDEN
+#define MLAS_HGEMM_STRIDEK                          MLAS_SGEMM_STRIDEK
+
+//
+// Define the number of multiply-accumulates per thread.
+//
+
+#define MLAS_HGEMM_THREAD_COMPLEXITY                (64 * 1024)
+
+MLAS_FORCEINLINE
+float
+MlasHalfToFloat(
+    MLAS_HALF_TYPE HalfType,
+    uint16_t Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision value to single precision.
+
+Arguments:
+
+    HalfType - Supplies the format of the half precision value.
+
+    Value - Supplies the half precision value.
+
+Return Value:
+
+    Returns the single precision value.
+
+--*/
+{
+    uint32_t Bits;
+
+    if (HalfType == MlasHalfTypeBFloat16) {
+
+        Bits = uint32_t(Value) << 16;
+
+    } else {
+
+        uint32_t Sign = uint32_t(Value & 0x8000) << 16;
+        uint32_t Exponent = (Value >> 10) & 0x1F;
+        uint32_t Mantissa = Value & 0x3FF;
+
+        if (Exponent == 0x1F) {
+
+            //
+            // Infinity or NaN.
+            //
+
+            Bits = Sign | 0x7F800000 | (Mantissa << 13);
+
+        } else if (Exponent != 0) {
+
+            Bits = Sign | ((Exponent + (127 - 15)) << 23) | (Mantissa << 13);
+
+        } else if (Mantissa != 0) {
+
+            //
+            // Normalize the denormal value.
+            //
+
+            Exponent = 127 - 15 + 1;
+
+            while ((Mantissa & 0x400) == 0) {
+                Mantissa <<= 1;
+                Exponent--;
+            }
+
+            Bits = Sign | (Exponent << 23) | ((Mantissa & 0x3FF) << 13);
+
+        } else {
+
+            Bits = Sign;
+        }
+    }
+
+    float Float;
+    memcpy(&Float, &Bits, sizeof(float));
+    return Float;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToHalf(
+    MLAS_HALF_TYPE HalfType,
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to half precision,
+    rounding to the nearest even value.
+
+Arguments:
+
+    HalfType - Supplies the format of the half precision value.
+
+    Value - Supplies the single precision value.
+
+Return Value:
+
+    Returns the half precision value.
+
+--*/
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(float));
+
+    if (HalfType == MlasHalfTypeBFloat16) {
+
+        if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+            return uint16_t((Bits >> 16) | 0x0040);
+        }
+
+        return uint16_t((Bits + 0x7FFF + ((Bits >> 16) & 1)) >> 16);
+    }
+
+    const uint32_t Sign = (Bits >> 16) & 0x8000;
+    Bits &= 0x7FFFFFFF;
+
+    uint32_t Half;
+
+    if (Bits >= ((127 + 16) << 23)) {
+
+        //
+        // The value overflows to infinity or is a NaN.
+        //
+
+        Half = (Bits > 0x7F800000) ? 0x7E00 : 0x7C00;
+
+    } else if (Bits < ((127 - 14) << 23)) {
+
+        //
+        // The value is a denormal or zero. Adding the magic value shifts the
+        // mantissa into place and the floating point unit rounds it.
+        //
+
+        const uint32_t DenormalMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+        float DenormalMagic;
+        memcpy(&DenormalMagic, &DenormalMagicBits, sizeof(float));
+
+        float Float;
+        memcpy(&Float, &Bits, sizeof(float));
+        Float += DenormalMagic;
+        memcpy(&Bits, &Float, sizeof(float));
+
+        Half = Bits - DenormalMagicBits;
+
+    } else {
+
+        const uint32_t MantissaOdd = (Bits >> 13) & 1;
+
+        Bits += (uint32_t(15 - 127) << 23) + 0xFFF + MantissaOdd;
+        Half = Bits >> 13;
+    }
+
+    return uint16_t(Half | Sign);
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloat(
+    MLAS_HALF_TYPE HalfType,
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision.
+
+Arguments:
+
+    HalfType - Supplies the format of the half precision values.
+
+    Source - Supplies the half precision values.
+
+    Destination - Supplies the buffer to receive the single precision values.
+
+    Count - Supplies the number of values to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    if (HalfType == MlasHalfTypeFloat16 && MlasPlatform.ConvertHalfToFloatKernel != nullptr) {
+        MlasPlatform.ConvertHalfToFloatKernel(Source, Destination, Count);
+        return;
+    }
+#endif
+
+#if defined(MLAS_NEON64_INTRINSICS) && !defined(_MSC_VER)
+    if (HalfType == MlasHalfTypeFloat16) {
+
+        while (Count >= 4) {
+            vst1q_f32(Destination, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(Source))));
+            Source += 4;
+            Destination += 4;
+            Count -= 4;
+        }
+    }
+#endif
+
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MlasHalfToFloat(HalfType, Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalf(
+    MLAS_HALF_TYPE HalfType,
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision, rounding to the nearest even value.
+
+Arguments:
+
+    HalfType - Supplies the format of the half precision values.
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the buffer to receive the half precision values.
+
+    Count - Supplies the number of values to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    if (HalfType == MlasHalfTypeFloat16 && MlasPlatform.ConvertFloatToHalfKernel != nullptr) {
+        MlasPlatform.ConvertFloatToHalfKernel(Source, Destination, Count);
+        return;
+    }
+#endif
+
+#if defined(MLAS_NEON64_INTRINSICS) && !defined(_MSC_VER)
+    if (HalfType == MlasHalfTypeFloat16) {
+
+        while (Count >= 4) {
+            vst1_u16(Destination, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(Source))));
+            Source += 4;
+            Destination += 4;
+            Count -= 4;
+        }
+    }
+#endif
+
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MlasFloatToHalf(HalfType, Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to float16,
+    rounding to the nearest even value. This is the inverse of
+    MlasConvertHalfToFloatBuffer.
+
+Arguments:
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the buffer to receive the float16 values.
+
+    Count - Supplies the number of values to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertFloatToHalf(MlasHalfTypeFloat16, Source, Destination, Count);
+}
+
+void
+MlasHalfGemmWidenBlock(
+    MLAS_HALF_TYPE HalfType,
+    CBLAS_TRANSPOSE Trans,
+    const uint16_t* Source,
+    size_t lds,
+    float* Destination,
+    size_t Rows,
+    size_t Columns
+    )
+/*++
+
+Routine Description:
+
+    This routine widens a block of a half precision matrix to a row major
+    single precision buffer, transposing the block if the source matrix is
+    transposed.
+
+Arguments:
+
+    HalfType - Supplies the format of the half precision values.
+
+    Trans - Supplies the transpose operation for the source matrix.
+
+    Source - Supplies the address of the block in the source matrix.
+
+    lds - Supplies the first dimension of the source matrix.
+
+    Destination - Supplies the buffer to receive the block, which has Columns
+        elements per row.
+
+    Rows - Supplies the number of rows of the block.
+
+    Columns - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Trans == CblasNoTrans) {
+
+        for (size_t r = 0; r < Rows; r++) {
+            MlasConvertHalfToFloat(HalfType, Source + r * lds, Destination + r * Columns, Columns);
+        }
+
+    } else {
+
+        for (size_t c = 0; c < Columns; c++) {
+            for (size_t r = 0; r < Rows; r++) {
+                Destination[r * Columns + c] = MlasHalfToFloat(HalfType, Source[c * lds + r]);
+            }
+        }
+    }
+}
+
+struct MLAS_HGEMM_WORK_BLOCK {
+    MLAS_HALF_TYPE HalfType;
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const uint16_t* A;
+    size_t lda;
+    const uint16_t* B;
+    size_t ldb;
+    float beta;
+    uint16_t* C;
+    size_t ldc;
+    size_t BlockCountN;
+    int32_t ThreadCount;
+};
+
+void
+MlasHalfGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    HGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_HGEMM_WORK_BLOCK*)Context;
+
+    const MLAS_HALF_TYPE HalfType = WorkBlock->HalfType;
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t K = WorkBlock->K;
+
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_HGEMM_STRIDEM * MLAS_HGEMM_STRIDEK], 16 * sizeof(float));
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_HGEMM_STRIDEK * MLAS_HGEMM_STRIDEN], 16 * sizeof(float));
+    MLAS_DECLSPEC_ALIGN(float PanelC[MLAS_HGEMM_STRIDEM * MLAS_HGEMM_STRIDEN], 16 * sizeof(float));
+
+    //
+    // Partition the output blocks to the threads.
+    //
+
+    const size_t BlockCountM = (M + MLAS_HGEMM_STRIDEM - 1) / MLAS_HGEMM_STRIDEM;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, BlockCountM * WorkBlock->BlockCountN,
+        &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t m = (WorkIndex / WorkBlock->BlockCountN) * MLAS_HGEMM_STRIDEM;
+        const size_t n = (WorkIndex % WorkBlock->BlockCountN) * MLAS_HGEMM_STRIDEN;
+        const size_t CountM = std::min(M - m, size_t(MLAS_HGEMM_STRIDEM));
+        const size_t CountN = std::min(N - n, size_t(MLAS_HGEMM_STRIDEN));
+
+        uint16_t* C = WorkBlock->C + m * WorkBlock->ldc + n;
+
+        //
+        // Widen the output block if it is scaled into the result, so that the
+        // first step of the inner dimension accumulates into it.
+        //
+
+        float beta = WorkBlock->beta;
+
+        if (beta != 0.0f) {
+            MlasHalfGemmWidenBlock(HalfType, CblasNoTrans, C, WorkBlock->ldc, PanelC, CountM, CountN);
+        }
+
+        if (K == 0) {
+            for (size_t i = 0; i < CountM * CountN; i++) {
+                PanelC[i] *= beta;
+            }
+        }
+
+        for (size_t k = 0; k < K; k += MLAS_HGEMM_STRIDEK) {
+
+            const size_t CountK = std::min(K - k, size_t(MLAS_HGEMM_STRIDEK));
+
+            const uint16_t* A = (WorkBlock->TransA == CblasNoTrans) ?
+                WorkBlock->A + m * WorkBlock->lda + k : WorkBlock->A + k * WorkBlock->lda + m;
+            const uint16_t* B = (WorkBlock->TransB == CblasNoTrans) ?
+                WorkBlock->B + k * WorkBlock->ldb + n : WorkBlock->B + n * WorkBlock->ldb + k;
+
+            MlasHalfGemmWidenBlock(HalfType, WorkBlock->TransA, A, WorkBlock->lda, PanelA, CountM, CountK);
+            MlasHalfGemmWidenBlock(HalfType, WorkBlock->TransB, B, WorkBlock->ldb, PanelB, CountK, CountN);
+
+            MlasGemm(CblasNoTrans, CblasNoTrans, CountM, CountN, CountK, WorkBlock->alpha,
+                PanelA, CountK, PanelB, CountN, beta, PanelC, CountN, nullptr);
+
+            beta = 1.0f;
+        }
+
+        if (beta == 0.0f) {
+            std::fill_n(PanelC, CountM * CountN, 0.0f);
+        }
+
+        for (size_t r = 0; r < CountM; r++) {
+            MlasConvertFloatToHalf(HalfType, PanelC + r * CountN, C + r * WorkBlock->ldc, CountN);
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasHalfGemm(
+    MLAS_HALF_TYPE HalfType,
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const uint16_t* A,
+    size_t lda,
+    const uint16_t* B,
+    size_t ldb,
+    float beta,
+    uint16_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the half precision matrix/matrix multiply
+    operation (HGEMM), where the products are accumulated in single
+    precision.
+
+Arguments:
+
+    HalfType - Supplies the format of the half precision matrices.
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier (see HGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see HGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    MLAS_HGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.HalfType = HalfType;
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.BlockCountN = (N + MLAS_HGEMM_STRIDEN - 1) / MLAS_HGEMM_STRIDEN;
+
+    //
+    // Compute the number of target threads given the complexity of the HGEMM
+    // operation, limited to the number of output blocks.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+    const size_t BlockCount = ((M + MLAS_HGEMM_STRIDEM - 1) / MLAS_HGEMM_STRIDEM) * WorkBlock.BlockCountN;
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (Complexity < double(MLAS_HGEMM_THREAD_COMPLEXITY * ThreadCount)) {
+        ThreadCount = int32_t(Complexity / double(MLAS_HGEMM_THREAD_COMPLEXITY)) + 1;
+    }
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasHalfGemmThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
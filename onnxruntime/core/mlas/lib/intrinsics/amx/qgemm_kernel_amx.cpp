@@ -0,0 +1,348 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using AMX tile intrinsics.
+
+    The kernel consumes the same packed buffers as the AVX2 and AVX512VNNI
+    kernels: packed A is stored row major with K padded to a multiple of four
+    and packed B is stored in panels of 16 columns, where each group of four
+    K values for the 16 columns forms a 64 byte row. A block of 16 such rows
+    is exactly the layout TDPBUSD expects for its second source tile.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// Define the tile assignments used by this kernel.
+//
+
+#define TMM_C0          0
+#define TMM_C1          1
+#define TMM_A           2
+#define TMM_A_TAIL      3
+#define TMM_B0          4
+#define TMM_B1          5
+#define TMM_B0_TAIL     6
+#define TMM_B1_TAIL     7
+
+//
+// Define the maximum dimensions of a tile.
+//
+
+constexpr size_t MLAS_AMX_TILE_ROWS = 16;
+constexpr size_t MLAS_AMX_TILE_COLSB = 64;
+
+//
+// Define the number of packed K values (groups of four bytes) processed by a
+// single tile multiply.
+//
+
+constexpr size_t MLAS_AMX_TILE_PACKED_K = MLAS_AMX_TILE_COLSB / 4;
+
+//
+// Define the layout of the tile configuration loaded by LDTILECFG.
+//
+
+struct MLAS_AMX_TILE_CONFIG {
+    uint8_t PaletteId;
+    uint8_t StartRow;
+    uint8_t Reserved[14];
+    uint16_t ColumnBytes[16];
+    uint8_t Rows[16];
+};
+
+static_assert(sizeof(MLAS_AMX_TILE_CONFIG) == 64, "tile configuration must be 64 bytes");
+
+MLAS_FORCEINLINE
+void
+MlasGemmU8S8ConfigureTilesAmx(
+    size_t CountM,
+    size_t PackedCountKRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine loads the tile configuration for a block of output rows.
+
+Arguments:
+
+    CountM - Supplies the number of rows to process (at most 16).
+
+    PackedCountKRemaining - Supplies the number of packed K values in the
+        final partial K block, or zero if there is no partial block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_AMX_TILE_CONFIG TileConfig = {};
+
+    TileConfig.PaletteId = 1;
+
+    TileConfig.Rows[TMM_C0] = uint8_t(CountM);
+    TileConfig.ColumnBytes[TMM_C0] = MLAS_AMX_TILE_COLSB;
+    TileConfig.Rows[TMM_C1] = uint8_t(CountM);
+    TileConfig.ColumnBytes[TMM_C1] = MLAS_AMX_TILE_COLSB;
+
+    TileConfig.Rows[TMM_A] = uint8_t(CountM);
+    TileConfig.ColumnBytes[TMM_A] = MLAS_AMX_TILE_COLSB;
+    TileConfig.Rows[TMM_B0] = MLAS_AMX_TILE_ROWS;
+    TileConfig.ColumnBytes[TMM_B0] = MLAS_AMX_TILE_COLSB;
+    TileConfig.Rows[TMM_B1] = MLAS_AMX_TILE_ROWS;
+    TileConfig.ColumnBytes[TMM_B1] = MLAS_AMX_TILE_COLSB;
+
+    if (PackedCountKRemaining > 0) {
+        TileConfig.Rows[TMM_A_TAIL] = uint8_t(CountM);
+        TileConfig.ColumnBytes[TMM_A_TAIL] = uint16_t(PackedCountKRemaining * 4);
+        TileConfig.Rows[TMM_B0_TAIL] = uint8_t(PackedCountKRemaining);
+        TileConfig.ColumnBytes[TMM_B0_TAIL] = MLAS_AMX_TILE_COLSB;
+        TileConfig.Rows[TMM_B1_TAIL] = uint8_t(PackedCountKRemaining);
+        TileConfig.ColumnBytes[TMM_B1_TAIL] = MLAS_AMX_TILE_COLSB;
+    }
+
+    _tile_loadconfig(&TileConfig);
+}
+
+MLAS_FORCEINLINE
+void
+MlasGemmU8S8OutputTileAmx(
+    const int32_t* Accumulators,
+    int32_t* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the zero point fixups to a 16 column block of tile
+    accumulators and stores the block to the output matrix.
+
+Arguments:
+
+    Accumulators - Supplies the address of the accumulators stored from a C
+        tile, with a stride of 16 elements.
+
+    C - Supplies the address of the output matrix block.
+
+    CountM - Supplies the number of rows to store.
+
+    CountN - Supplies the number of columns to store (at most 16).
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumVector - Supplies the sum of each row from matrix A multiplied by
+        the zero point offset of matrix B.
+
+    ColumnSumVector - Supplies the sum of each column from matrix B
+        multiplied by the zero point offset of matrix A.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point
+        offset of matrix A multplied by the zero point offset of matrix B.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __mmask16 Mask = (CountN >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << CountN) - 1);
+
+    __m512i ColumnSums = _mm512_maskz_loadu_epi32(Mask, ColumnSumVector);
+    ColumnSums = _mm512_add_epi32(ColumnSums, _mm512_set1_epi32(DepthValue));
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        __m512i Accumulator = _mm512_loadu_si512(Accumulators + m * MLAS_AMX_TILE_ROWS);
+        Accumulator = _mm512_add_epi32(Accumulator, ColumnSums);
+        Accumulator = _mm512_add_epi32(Accumulator, _mm512_set1_epi32(RowSumVector[m]));
+
+        if (!ZeroMode) {
+            Accumulator = _mm512_add_epi32(Accumulator, _mm512_maskz_loadu_epi32(Mask, C));
+        }
+
+        _mm512_mask_storeu_epi32(C, Mask, Accumulator);
+
+        C += ldc;
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmU8S8KernelAmx(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasGemmU8S8CopyPackAAvx2.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasGemmU8S8CopyPackBAvx2.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed columns from matrix A and
+        the number of packed rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumVector - Supplies the sum of each row from matrix A multiplied by
+        the zero point offset of matrix B. These values are accumulated into
+        every row of matrix C.
+
+    ColumnSumVector - Supplies the sum of each column from matrix B multiplied
+        by the zero point offset of matrix A. These values are accumulated
+        into every column of matrix C.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrix A multplied by the zero point offset of matrix B. This value
+        is accumulated into every element of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int32_t Accumulators[2][MLAS_AMX_TILE_ROWS * MLAS_AMX_TILE_ROWS], 64);
+
+    if (CountM > MLAS_AMX_TILE_ROWS) {
+        CountM = MLAS_AMX_TILE_ROWS;
+    }
+
+    const size_t PackedCountKBlocks = PackedCountK / MLAS_AMX_TILE_PACKED_K;
+    const size_t PackedCountKRemaining = PackedCountK % MLAS_AMX_TILE_PACKED_K;
+
+    const size_t StrideA = PackedCountK * 4;
+    const size_t PanelStrideB = PackedCountK * MLAS_AMX_TILE_COLSB;
+    const size_t BlockStrideB = MLAS_AMX_TILE_PACKED_K * MLAS_AMX_TILE_COLSB;
+    const size_t TailOffsetA = PackedCountKBlocks * MLAS_AMX_TILE_COLSB;
+    const size_t TailOffsetB = PackedCountKBlocks * BlockStrideB;
+
+    MlasGemmU8S8ConfigureTilesAmx(CountM, PackedCountKRemaining);
+
+    //
+    // Process pairs of 16 column panels from matrix B, sharing each load of
+    // matrix A between the two panels.
+    //
+
+    while (CountN > 16) {
+
+        const uint8_t* b0 = B;
+        const uint8_t* b1 = B + PanelStrideB;
+
+        _tile_zero(TMM_C0);
+        _tile_zero(TMM_C1);
+
+        for (size_t k = 0; k < PackedCountKBlocks; k++) {
+            _tile_loadd(TMM_A, A + k * MLAS_AMX_TILE_COLSB, StrideA);
+            _tile_loadd(TMM_B0, b0 + k * BlockStrideB, MLAS_AMX_TILE_COLSB);
+            _tile_loadd(TMM_B1, b1 + k * BlockStrideB, MLAS_AMX_TILE_COLSB);
+            _tile_dpbusd(TMM_C0, TMM_A, TMM_B0);
+            _tile_dpbusd(TMM_C1, TMM_A, TMM_B1);
+        }
+
+        if (PackedCountKRemaining > 0) {
+            _tile_loadd(TMM_A_TAIL, A + TailOffsetA, StrideA);
+            _tile_loadd(TMM_B0_TAIL, b0 + TailOffsetB, MLAS_AMX_TILE_COLSB);
+            _tile_loadd(TMM_B1_TAIL, b1 + TailOffsetB, MLAS_AMX_TILE_COLSB);
+            _tile_dpbusd(TMM_C0, TMM_A_TAIL, TMM_B0_TAIL);
+            _tile_dpbusd(TMM_C1, TMM_A_TAIL, TMM_B1_TAIL);
+        }
+
+        _tile_stored(TMM_C0, Accumulators[0], MLAS_AMX_TILE_COLSB);
+        _tile_stored(TMM_C1, Accumulators[1], MLAS_AMX_TILE_COLSB);
+
+        const size_t CountN1 = (CountN >= 32) ? 16 : (CountN - 16);
+
+        MlasGemmU8S8OutputTileAmx(Accumulators[0], C, CountM, 16, ldc,
+            RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+        MlasGemmU8S8OutputTileAmx(Accumulators[1], C + 16, CountM, CountN1, ldc,
+            RowSumVector, ColumnSumVector + 16, DepthValue, ZeroMode);
+
+        B += 2 * PanelStrideB;
+        C += 16 + CountN1;
+        ColumnSumVector += 16 + CountN1;
+        CountN -= 16 + CountN1;
+    }
+
+    //
+    // Process the remaining single panel from matrix B.
+    //
+
+    if (CountN > 0) {
+
+        _tile_zero(TMM_C0);
+
+        for (size_t k = 0; k < PackedCountKBlocks; k++) {
+            _tile_loadd(TMM_A, A + k * MLAS_AMX_TILE_COLSB, StrideA);
+            _tile_loadd(TMM_B0, B + k * BlockStrideB, MLAS_AMX_TILE_COLSB);
+            _tile_dpbusd(TMM_C0, TMM_A, TMM_B0);
+        }
+
+        if (PackedCountKRemaining > 0) {
+            _tile_loadd(TMM_A_TAIL, A + TailOffsetA, StrideA);
+            _tile_loadd(TMM_B0_TAIL, B + TailOffsetB, MLAS_AMX_TILE_COLSB);
+            _tile_dpbusd(TMM_C0, TMM_A_TAIL, TMM_B0_TAIL);
+        }
+
+        _tile_stored(TMM_C0, Accumulators[0], MLAS_AMX_TILE_COLSB);
+
+        MlasGemmU8S8OutputTileAmx(Accumulators[0], C, CountM, CountN, ldc,
+            RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+    }
+
+    _tile_release();
+
+    return CountM;
+}
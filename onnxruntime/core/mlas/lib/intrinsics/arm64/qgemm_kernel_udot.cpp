@@ -0,0 +1,359 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_udot.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using the ARMv8.2 dot product instructions.
+
+    The kernel consumes the packed A buffer produced for the NEON kernel: rows
+    are interleaved in groups of four, two or one rows where each row supplies
+    four K values at a time. Packed B is stored in panels of 8 columns, where
+    each group of four K values for the 8 columns forms a 32 byte row. Each
+    16 byte half of that row holds four columns in the order UDOT expects for
+    its first source operand.
+
+--*/
+
+#include "../../mlasi.h"
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8MultiplyAccumulateUdot(
+    uint32x4_t Accumulators[RowCount][2],
+    const uint8_t* A,
+    uint8x16_t BElements0,
+    uint8x16_t BElements1
+    );
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8MultiplyAccumulateUdot<4>(
+    uint32x4_t Accumulators[4][2],
+    const uint8_t* A,
+    uint8x16_t BElements0,
+    uint8x16_t BElements1
+    )
+{
+    uint8x16_t AElements = vld1q_u8(A);
+
+    Accumulators[0][0] = vdotq_laneq_u32(Accumulators[0][0], BElements0, AElements, 0);
+    Accumulators[0][1] = vdotq_laneq_u32(Accumulators[0][1], BElements1, AElements, 0);
+    Accumulators[1][0] = vdotq_laneq_u32(Accumulators[1][0], BElements0, AElements, 1);
+    Accumulators[1][1] = vdotq_laneq_u32(Accumulators[1][1], BElements1, AElements, 1);
+    Accumulators[2][0] = vdotq_laneq_u32(Accumulators[2][0], BElements0, AElements, 2);
+    Accumulators[2][1] = vdotq_laneq_u32(Accumulators[2][1], BElements1, AElements, 2);
+    Accumulators[3][0] = vdotq_laneq_u32(Accumulators[3][0], BElements0, AElements, 3);
+    Accumulators[3][1] = vdotq_laneq_u32(Accumulators[3][1], BElements1, AElements, 3);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8MultiplyAccumulateUdot<2>(
+    uint32x4_t Accumulators[2][2],
+    const uint8_t* A,
+    uint8x16_t BElements0,
+    uint8x16_t BElements1
+    )
+{
+    uint8x8_t AElements = vld1_u8(A);
+
+    Accumulators[0][0] = vdotq_lane_u32(Accumulators[0][0], BElements0, AElements, 0);
+    Accumulators[0][1] = vdotq_lane_u32(Accumulators[0][1], BElements1, AElements, 0);
+    Accumulators[1][0] = vdotq_lane_u32(Accumulators[1][0], BElements0, AElements, 1);
+    Accumulators[1][1] = vdotq_lane_u32(Accumulators[1][1], BElements1, AElements, 1);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8MultiplyAccumulateUdot<1>(
+    uint32x4_t Accumulators[1][2],
+    const uint8_t* A,
+    uint8x16_t BElements0,
+    uint8x16_t BElements1
+    )
+{
+    uint8x16_t AElements = vreinterpretq_u8_u32(vld1q_dup_u32(reinterpret_cast<const uint32_t*>(A)));
+
+    Accumulators[0][0] = vdotq_u32(Accumulators[0][0], BElements0, AElements);
+    Accumulators[0][1] = vdotq_u32(Accumulators[0][1], BElements1, AElements);
+}
+
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8StoreOutputUdot(
+    int32_t* C,
+    int32x4_t Accumulator0,
+    int32x4_t Accumulator1,
+    size_t CountN,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine stores a row of up to 8 output elements after optionally
+    accumulating the values from matrix C.
+
+Arguments:
+
+    C - Supplies the address of the output row.
+
+    Accumulator0 - Supplies the accumulators for the first four columns.
+
+    Accumulator1 - Supplies the accumulators for the next four columns.
+
+    CountN - Supplies the number of columns to store.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (CountN >= 8) {
+
+        if (!ZeroMode) {
+            Accumulator0 = vaddq_s32(Accumulator0, vld1q_s32(&C[0]));
+            Accumulator1 = vaddq_s32(Accumulator1, vld1q_s32(&C[4]));
+        }
+
+        vst1q_s32(&C[0], Accumulator0);
+        vst1q_s32(&C[4], Accumulator1);
+        return;
+    }
+
+    if ((CountN & 4) != 0) {
+
+        if (!ZeroMode) {
+            Accumulator0 = vaddq_s32(Accumulator0, vld1q_s32(&C[0]));
+        }
+
+        vst1q_s32(&C[0], Accumulator0);
+        Accumulator0 = Accumulator1;
+        C += 4;
+    }
+
+    if ((CountN & 2) != 0) {
+
+        int32x2_t Accumulator = vget_low_s32(Accumulator0);
+
+        if (!ZeroMode) {
+            Accumulator = vadd_s32(Accumulator, vld1_s32(&C[0]));
+        }
+
+        vst1_s32(&C[0], Accumulator);
+        Accumulator0 = vextq_s32(Accumulator0, Accumulator0, 2);
+        C += 2;
+    }
+
+    if ((CountN & 1) != 0) {
+
+        int32_t Accumulator = vgetq_lane_s32(Accumulator0, 0);
+
+        if (!ZeroMode) {
+            Accumulator += C[0];
+        }
+
+        C[0] = Accumulator;
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8KernelUdotRows(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of the output matrix for all of the
+    columns of the packed B panel.
+
+Arguments:
+
+    See MlasGemmU8X8KernelUdot.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    int32x4_t RowSums[RowCount];
+
+    for (size_t i = 0; i < RowCount; i++) {
+        RowSums[i] = vdupq_n_s32(RowSumVector[i] + DepthValue);
+    }
+
+    while (CountN > 0) {
+
+        uint32x4_t Accumulators[RowCount][2];
+
+        for (size_t i = 0; i < RowCount; i++) {
+            Accumulators[i][0] = vmovq_n_u32(0);
+            Accumulators[i][1] = vmovq_n_u32(0);
+        }
+
+        //
+        // Multiply each group of four K values of the rows of matrix A by the
+        // same group of K values of the 8 columns of matrix B.
+        //
+
+        const uint8_t* a = A;
+
+        for (size_t k = PackedCountK; k > 0; k--) {
+
+            uint8x16_t BElements0 = vld1q_u8(&B[0]);
+            uint8x16_t BElements1 = vld1q_u8(&B[16]);
+
+            MlasGemmU8X8MultiplyAccumulateUdot<RowCount>(Accumulators, a,
+                BElements0, BElements1);
+
+            a += RowCount * 4;
+            B += 32;
+        }
+
+        //
+        // Add the row sums, the column sums, and the global depth value, then
+        // output the accumulator block.
+        //
+
+        const int32x4_t ColumnSums0 = vld1q_s32(&ColumnSumVector[0]);
+        const int32x4_t ColumnSums1 = vld1q_s32(&ColumnSumVector[4]);
+        ColumnSumVector += 8;
+
+        int32_t* c = C;
+
+        for (size_t i = 0; i < RowCount; i++) {
+
+            int32x4_t Accumulator0 = vreinterpretq_s32_u32(Accumulators[i][0]);
+            int32x4_t Accumulator1 = vreinterpretq_s32_u32(Accumulators[i][1]);
+
+            Accumulator0 = vaddq_s32(vaddq_s32(Accumulator0, RowSums[i]), ColumnSums0);
+            Accumulator1 = vaddq_s32(vaddq_s32(Accumulator1, RowSums[i]), ColumnSums1);
+
+            MlasGemmU8X8StoreOutputUdot(c, Accumulator0, Accumulator1, CountN, ZeroMode);
+
+            c += ldc;
+        }
+
+        if (CountN < 8) {
+            break;
+        }
+
+        C += 8;
+        CountN -= 8;
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmU8X8KernelUdot(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasGemmU8X8CopyPackANeon.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasGemmU8X8CopyPackBUdot.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed columns from matrix A and
+        the number of packed rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumVector - Supplies the sum of each row from matrix A multiplied by
+        the zero point offset of matrix B. These values are accumulated into
+        every row of matrix C.
+
+    ColumnSumVector - Supplies the sum of each column from matrix B multiplied
+        by the zero point offset of matrix A. These values are accumulated into
+        every column of matrix C.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrix A multplied by the zero point offset of matrix B. This value
+        is accumulated into every element of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    //
+    // The row grouping matches the interleaving of the packed A buffer.
+    //
+
+    if (CountM >= 4) {
+        MlasGemmU8X8KernelUdotRows<4>(A, B, C, PackedCountK, CountN, ldc,
+            RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+        return 4;
+    }
+
+    if (CountM >= 2) {
+        MlasGemmU8X8KernelUdotRows<2>(A, B, C, PackedCountK, CountN, ldc,
+            RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+        return 2;
+    }
+
+    MlasGemmU8X8KernelUdotRows<1>(A, B, C, PackedCountK, CountN, ldc,
+        RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+    return 1;
+}
@@ -0,0 +1,146 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels to convert buffers between half and
+    single precision with the F16C instructions.
+
+--*/
+
+#include "../../mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of float16 values to single precision.
+
+Arguments:
+
+    Source - Supplies the float16 values.
+
+    Destination - Supplies the buffer to receive the single precision values.
+
+    Count - Supplies the number of values to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+
+        __m128i Half0 = _mm_loadu_si128((const __m128i*)Source);
+        __m128i Half1 = _mm_loadu_si128((const __m128i*)(Source + 8));
+
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(Half0));
+        _mm256_storeu_ps(Destination + 8, _mm256_cvtph_ps(Half1));
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)Source)));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining values through a buffer on the stack so that
+        // the vector load and store don't access memory past the buffers.
+        //
+
+        uint16_t HalfBuffer[8] = { 0 };
+        float FloatBuffer[8];
+
+        memcpy(HalfBuffer, Source, Count * sizeof(uint16_t));
+        _mm256_storeu_ps(FloatBuffer, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)HalfBuffer)));
+        memcpy(Destination, FloatBuffer, Count * sizeof(float));
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to float16,
+    rounding to the nearest even value.
+
+Arguments:
+
+    Source - Supplies the single precision values.
+
+    Destination - Supplies the buffer to receive the float16 values.
+
+    Count - Supplies the number of values to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+
+        __m128i Half0 = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m128i Half1 = _mm256_cvtps_ph(_mm256_loadu_ps(Source + 8), _MM_FROUND_TO_NEAREST_INT);
+
+        _mm_storeu_si128((__m128i*)Destination, Half0);
+        _mm_storeu_si128((__m128i*)(Destination + 8), Half1);
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+
+        _mm_storeu_si128((__m128i*)Destination,
+            _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        float FloatBuffer[8] = { 0 };
+        uint16_t HalfBuffer[8];
+
+        memcpy(FloatBuffer, Source, Count * sizeof(float));
+        _mm_storeu_si128((__m128i*)HalfBuffer,
+            _mm256_cvtps_ph(_mm256_loadu_ps(FloatBuffer), _MM_FROUND_TO_NEAREST_INT));
+        memcpy(Destination, HalfBuffer, Count * sizeof(uint16_t));
+    }
+}
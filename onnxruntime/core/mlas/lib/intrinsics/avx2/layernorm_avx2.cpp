@@ -0,0 +1,175 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel to compute layer normalization with AVX2
+    and FMA3 instructions.
+
+--*/
+
+#include "../../mlasi.h"
+
+MLAS_FORCEINLINE
+static
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasLayerNormalizationF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel to normalize a row of values, see
+    MlasLayerNormalizationF32Kernel.
+
+--*/
+{
+    __m256 SumVector0 = _mm256_setzero_ps();
+    __m256 SumVector1 = SumVector0;
+    __m256 SumSquaresVector0 = SumVector0;
+    __m256 SumSquaresVector1 = SumVector0;
+
+    const float* Values = (Skip != nullptr || Bias != nullptr) ? Output : Input;
+    size_t n = 0;
+
+    for (; n + 16 <= N; n += 16) {
+
+        __m256 Vector0 = _mm256_loadu_ps(Input + n);
+        __m256 Vector1 = _mm256_loadu_ps(Input + n + 8);
+
+        if (Skip != nullptr) {
+            Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(Skip + n));
+            Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(Skip + n + 8));
+        }
+
+        if (Bias != nullptr) {
+            Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(Bias + n));
+            Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(Bias + n + 8));
+        }
+
+        if (Values == Output) {
+            _mm256_storeu_ps(Output + n, Vector0);
+            _mm256_storeu_ps(Output + n + 8, Vector1);
+        }
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm256_add_ps(SumVector1, Vector1);
+        SumSquaresVector0 = _mm256_fmadd_ps(Vector0, Vector0, SumSquaresVector0);
+        SumSquaresVector1 = _mm256_fmadd_ps(Vector1, Vector1, SumSquaresVector1);
+    }
+
+    for (; n + 8 <= N; n += 8) {
+
+        __m256 Vector = _mm256_loadu_ps(Input + n);
+
+        if (Skip != nullptr) {
+            Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Skip + n));
+        }
+
+        if (Bias != nullptr) {
+            Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Bias + n));
+        }
+
+        if (Values == Output) {
+            _mm256_storeu_ps(Output + n, Vector);
+        }
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector);
+        SumSquaresVector0 = _mm256_fmadd_ps(Vector, Vector, SumSquaresVector0);
+    }
+
+    float Sum = MlasReduceAddFloat32x8(_mm256_add_ps(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x8(_mm256_add_ps(SumSquaresVector0, SumSquaresVector1));
+
+    for (; n < N; n++) {
+
+        float Value = Input[n];
+
+        if (Skip != nullptr) {
+            Value += Skip[n];
+        }
+
+        if (Bias != nullptr) {
+            Value += Bias[n];
+        }
+
+        if (Values == Output) {
+            Output[n] = Value;
+        }
+
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+
+    const float MeanValue = Sum / N;
+    float Variance = SumSquares / N;
+
+    if (!Simplified) {
+        Variance = std::max(Variance - MeanValue * MeanValue, 0.0f);
+    }
+
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+    const float Shift = Simplified ? 0.0f : -MeanValue * InvStdDevValue;
+
+    *Mean = MeanValue;
+    *InvStdDev = InvStdDevValue;
+
+    __m256 ScaleVector = _mm256_set1_ps(InvStdDevValue);
+    __m256 ShiftVector = _mm256_set1_ps(Shift);
+
+    n = 0;
+
+    for (; n + 8 <= N; n += 8) {
+
+        __m256 Vector = _mm256_fmadd_ps(_mm256_loadu_ps(Values + n), ScaleVector, ShiftVector);
+
+        if (Beta != nullptr) {
+            Vector = _mm256_fmadd_ps(Vector, _mm256_loadu_ps(Gamma + n), _mm256_loadu_ps(Beta + n));
+        } else {
+            Vector = _mm256_mul_ps(Vector, _mm256_loadu_ps(Gamma + n));
+        }
+
+        _mm256_storeu_ps(Output + n, Vector);
+    }
+
+    for (; n < N; n++) {
+
+        float Value = (Values[n] * InvStdDevValue + Shift) * Gamma[n];
+
+        if (Beta != nullptr) {
+            Value += Beta[n];
+        }
+
+        Output[n] = Value;
+    }
+}
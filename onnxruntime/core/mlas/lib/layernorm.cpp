@@ -0,0 +1,267 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute layer normalization.
+
+    Our usage requires building platform specific versions of the algorithm to
+    target different instruction sets. The implementation below targets the
+    base instruction set (typically SSE2) while an intrinsics implementation
+    targets AVX2/FMA3.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasLayerNormalizationF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to normalize a row of values.
+
+    The first pass adds the optional addends to the input, stores the sums to
+    the output if there are addends, and accumulates the sum and the sum of
+    squares of the values. The second pass scales and shifts the centered
+    values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Supplies an optional buffer added to the input.
+
+    Bias - Supplies an optional buffer added to the input.
+
+    Gamma - Supplies the scale buffer.
+
+    Beta - Supplies an optional shift buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Simplified - Supplies true to normalize by the root mean square without
+        centering the values.
+
+    Mean - Receives the mean of the values.
+
+    InvStdDev - Receives the inverse of the standard deviation of the values,
+        or of their root mean square if Simplified is true.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = SumVector0;
+    MLAS_FLOAT32X4 SumSquaresVector0 = SumVector0;
+    MLAS_FLOAT32X4 SumSquaresVector1 = SumVector0;
+
+    const float* Values = (Skip != nullptr || Bias != nullptr) ? Output : Input;
+    size_t n = 0;
+
+    for (; n + 8 <= N; n += 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input + n);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + n + 4);
+
+        if (Skip != nullptr) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Skip + n));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Skip + n + 4));
+        }
+
+        if (Bias != nullptr) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Bias + n));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Bias + n + 4));
+        }
+
+        if (Values == Output) {
+            MlasStoreFloat32x4(Output + n, Vector0);
+            MlasStoreFloat32x4(Output + n + 4, Vector1);
+        }
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SumSquaresVector0);
+        SumSquaresVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SumSquaresVector1);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquaresVector0, SumSquaresVector1));
+
+    for (; n < N; n++) {
+
+        float Value = Input[n];
+
+        if (Skip != nullptr) {
+            Value += Skip[n];
+        }
+
+        if (Bias != nullptr) {
+            Value += Bias[n];
+        }
+
+        if (Values == Output) {
+            Output[n] = Value;
+        }
+
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+
+    const float MeanValue = Sum / N;
+    float Variance = SumSquares / N;
+
+    if (!Simplified) {
+        Variance = std::max(Variance - MeanValue * MeanValue, 0.0f);
+    }
+
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+    const float Shift = Simplified ? 0.0f : -MeanValue * InvStdDevValue;
+
+    *Mean = MeanValue;
+    *InvStdDev = InvStdDevValue;
+
+    //
+    // Output = (Value - Mean) * InvStdDev * Gamma + Beta
+    //
+
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(InvStdDevValue);
+    MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(Shift);
+
+    n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Values + n), ScaleVector, ShiftVector);
+
+        if (Beta != nullptr) {
+            Vector = MlasMultiplyAddFloat32x4(Vector, MlasLoadFloat32x4(Gamma + n), MlasLoadFloat32x4(Beta + n));
+        } else {
+            Vector = MlasMultiplyFloat32x4(Vector, MlasLoadFloat32x4(Gamma + n));
+        }
+
+        MlasStoreFloat32x4(Output + n, Vector);
+    }
+
+    for (; n < N; n++) {
+
+        float Value = (Values[n] * InvStdDevValue + Shift) * Gamma[n];
+
+        if (Beta != nullptr) {
+            Value += Beta[n];
+        }
+
+        Output[n] = Value;
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a row of values:
+
+        Value = Input + Skip + Bias
+        Output = (Value - Mean(Value)) / sqrt(Variance(Value) + Epsilon) * Gamma + Beta
+
+    If Simplified is true, the values are normalized by their root mean square
+    instead and are not centered:
+
+        Output = Value / sqrt(Mean(Value * Value) + Epsilon) * Gamma + Beta
+
+    The mean and the variance are computed in a single pass over the values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Supplies an optional buffer added to the input.
+
+    Bias - Supplies an optional buffer added to the input.
+
+    Gamma - Supplies the scale buffer.
+
+    Beta - Supplies an optional shift buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the input
+        buffer.
+
+    N - Supplies the number of elements to process.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Simplified - Supplies true to normalize by the root mean square.
+
+    Mean - Optionally receives the mean of the values.
+
+    InvStdDev - Optionally receives the inverse of the standard deviation of
+        the values, or of their root mean square if Simplified is true.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float MeanValue;
+    float InvStdDevValue;
+
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.LayerNormalizationF32Kernel(Input, Skip, Bias, Gamma, Beta, Output, N, Epsilon, Simplified,
+        &MeanValue, &InvStdDevValue);
+#else
+    MlasLayerNormalizationF32Kernel(Input, Skip, Bias, Gamma, Beta, Output, N, Epsilon, Simplified,
+        &MeanValue, &InvStdDevValue);
+#endif
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+}
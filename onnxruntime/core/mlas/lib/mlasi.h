@@ -453,6 +453,44 @@ void
 
 typedef MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL;
 
+typedef
+void
+(MLASCALL MLAS_LAYER_NORMALIZATION_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
+typedef MLAS_LAYER_NORMALIZATION_FLOAT_KERNEL* PMLAS_LAYER_NORMALIZATION_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_KERNEL)(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_KERNEL* PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_KERNEL)(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_FLOAT_TO_HALF_KERNEL* PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL;
+
 typedef
 void
 (MLASCALL MLAS_QLINEAR_BINARY_OP_S8_KERNEL)(
@@ -516,6 +554,9 @@ extern "C" {
     MLAS_SGEMM_KERNEL_M1_ROUTINE MlasSgemmKernelM1TransposeBAvx;
 #elif defined(MLAS_TARGET_ARM64)
     MLAS_GEMV_FLOAT_KERNEL MlasGemvFloatKernel;
+#if !defined(MLAS_UDOT_UNSUPPORTED)
+    MLAS_GEMM_U8S8_KERNEL MlasGemmU8X8KernelUdot;
+#endif
 #endif
 
 #if defined(MLAS_TARGET_AMD64)
@@ -532,6 +573,7 @@ extern "C" {
     MLAS_GEMV_U8S8_KERNEL MlasGemvU8S8KernelAvx512Vnni;
     MLAS_GEMM_U8U8_KERNEL MlasGemmU8U8KernelAvx2;
     MLAS_GEMM_U8U8_KERNEL MlasGemmU8U8KernelAvx512Core;
+    MLAS_GEMM_U8S8_KERNEL MlasGemmU8S8KernelAmx;
 #endif
 
 #if defined(MLAS_TARGET_AMD64)
@@ -600,6 +642,16 @@ extern "C" {
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
 
+    MLAS_LAYER_NORMALIZATION_FLOAT_KERNEL MlasLayerNormalizationF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYER_NORMALIZATION_FLOAT_KERNEL MlasLayerNormalizationF32KernelAvx2;
+#endif
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelF16C;
+#endif
+
 }
 
 //
@@ -646,7 +698,9 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias
     );
 
 //
@@ -656,6 +710,8 @@ MlasSgemmOperation(
 struct MLAS_GEMM_U8X8_KERNEL_SSE;
 struct MLAS_GEMM_U8S8_KERNEL_AVX2;
 struct MLAS_GEMM_U8U8_KERNEL_AVX2;
+struct MLAS_GEMM_U8X8_KERNEL_NEON;
+struct MLAS_GEMM_U8X8_KERNEL_UDOT;
 
 template<typename KernelType>
 void
@@ -711,9 +767,17 @@ struct MLAS_PLATFORM {
     PMLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL ComputeLogSoftmaxOutputF32Kernel;
     PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL ReduceMaximumF32Kernel;
     PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL ReduceMinimumMaximumF32Kernel;
+    PMLAS_LAYER_NORMALIZATION_FLOAT_KERNEL LayerNormalizationF32Kernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertHalfToFloatKernel;
+    PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL ConvertFloatToHalfKernel;
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
 #endif
+
+#if defined(MLAS_TARGET_ARM64)
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation;
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8PackedOperation;
+#endif
 };
 
 extern MLAS_PLATFORM MlasPlatform;
@@ -17,6 +17,29 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#if defined(__linux__) && defined(MLAS_TARGET_AMD64)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(MLAS_TARGET_ARM64)
+#include <sys/auxv.h>
+
+//
+// Define the hardware capability bit for the ARMv8.2 dot product instructions
+// for C runtimes that predate it.
+//
+
+#if !defined(HWCAP_ASIMDDP)
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#endif
+
 //
 // Stores the platform information.
 //
@@ -86,6 +109,122 @@ MlasReadExtendedControlRegister(
 #endif
 }
 
+#if defined(MLAS_TARGET_AMD64) && !defined(MLAS_AMX_UNSUPPORTED)
+
+inline
+bool
+MlasRequestTileDataPermission(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine requests permission from the operating system to use the
+    AMX tile data state. Linux disables the state by default and raises a
+    fault on the first tile instruction unless the process has opted in.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns true if the tile data state can be used by this process.
+
+--*/
+{
+#if defined(__linux__)
+    constexpr unsigned long ARCH_REQ_XCOMP_PERM = 0x1023;
+    constexpr unsigned long XFEATURE_XTILEDATA = 18;
+
+    return syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) == 0;
+#else
+    return true;
+#endif
+}
+
+#endif
+
+#endif
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+
+//
+// Instruction set levels the kernels can be limited to.
+//
+
+enum MLAS_ISA_LEVEL {
+    MlasIsaSse2,
+    MlasIsaAvx,
+    MlasIsaAvx2,
+    MlasIsaAvx512F,
+    MlasIsaAvx512Core,
+    MlasIsaAvx512Vnni,
+    MlasIsaAmx,
+};
+
+inline
+MLAS_ISA_LEVEL
+MlasGetMaximumIsaLevel(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the highest instruction set level the kernels are
+    selected from, as limited by the MLAS_MAX_ISA environment variable. This
+    allows the kernels of the lower levels to be tested and benchmarked on a
+    processor supporting the higher ones.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    The instruction set level, which is the highest one when the variable is
+    not set or not recognized.
+
+--*/
+{
+    char Value[32] = {0};
+
+#if defined(_WIN32)
+    size_t Length;
+    if (getenv_s(&Length, Value, sizeof(Value), "MLAS_MAX_ISA") != 0) {
+        return MlasIsaAmx;
+    }
+#else
+    const char* EnvironmentValue = getenv("MLAS_MAX_ISA");
+    if (EnvironmentValue == nullptr) {
+        return MlasIsaAmx;
+    }
+    strncpy(Value, EnvironmentValue, sizeof(Value) - 1);
+#endif
+
+    static const struct {
+        const char* Name;
+        MLAS_ISA_LEVEL Level;
+    } IsaLevels[] = {
+        {"sse2", MlasIsaSse2},
+        {"avx", MlasIsaAvx},
+        {"avx2", MlasIsaAvx2},
+        {"avx512f", MlasIsaAvx512F},
+        {"avx512core", MlasIsaAvx512Core},
+        {"avx512vnni", MlasIsaAvx512Vnni},
+    };
+
+    for (const auto& IsaLevel : IsaLevels) {
+        if (strcmp(Value, IsaLevel.Name) == 0) {
+            return IsaLevel.Level;
+        }
+    }
+
+    return MlasIsaAmx;
+}
+
 #endif
 
 MLAS_PLATFORM::MLAS_PLATFORM(
@@ -138,6 +277,9 @@ Return Value:
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->LayerNormalizationF32Kernel = MlasLayerNormalizationF32Kernel;
+    this->ConvertHalfToFloatKernel = nullptr;
+    this->ConvertFloatToHalfKernel = nullptr;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
     this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
 
@@ -150,6 +292,8 @@ Return Value:
     // Check if the processor supports the AVX and OSXSAVE features.
     //
 
+    const MLAS_ISA_LEVEL MaximumIsaLevel = MlasGetMaximumIsaLevel();
+
     unsigned Cpuid1[4];
 #if defined(_WIN32)
     __cpuid((int*)Cpuid1, 1);
@@ -165,7 +309,7 @@ Return Value:
 
         uint64_t xcr0 = MlasReadExtendedControlRegister(_XCR_XFEATURE_ENABLED_MASK);
 
-        if ((xcr0 & 0x6) == 0x6) {
+        if ((xcr0 & 0x6) == 0x6 && MaximumIsaLevel >= MlasIsaAvx) {
 
             this->GemmFloatKernel = MlasGemmFloatKernelAvx;
 
@@ -198,7 +342,7 @@ Return Value:
             __cpuid_count(7, 0, Cpuid7[0], Cpuid7[1], Cpuid7[2], Cpuid7[3]);
 #endif
 
-            if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
+            if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0) && MaximumIsaLevel >= MlasIsaAvx2) {
 
                 this->GemmU8S8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
                 this->GemmU8S8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
@@ -221,6 +365,17 @@ Return Value:
                 this->QLinearAddS8Kernel = MlasQLinearAddS8KernelAvx2;
                 this->QLinearAddU8Kernel = MlasQLinearAddU8KernelAvx2;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormalizationF32Kernel = MlasLayerNormalizationF32KernelAvx2;
+
+                //
+                // Check if the processor supports the F16C half precision
+                // conversion instructions.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelF16C;
+                    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernelF16C;
+                }
 
 #if !defined(MLAS_AVX512F_UNSUPPORTED)
 
@@ -229,7 +384,8 @@ Return Value:
                 // operating system supports saving AVX512F state.
                 //
 
-                if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
+                if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0) &&
+                    MaximumIsaLevel >= MlasIsaAvx512F) {
 
                     this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
                     this->GemmDoubleKernel = MlasGemmDoubleKernelAvx512F;
@@ -252,7 +408,7 @@ Return Value:
 
 #if !defined(MLAS_AVX512CORE_UNSUPPORTED)
 
-                    if ((Cpuid7[1] & 0xC0020000) == 0xC0020000) {
+                    if ((Cpuid7[1] & 0xC0020000) == 0xC0020000 && MaximumIsaLevel >= MlasIsaAvx512Core) {
 
                         this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Core;
                         this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Core;
@@ -262,12 +418,31 @@ Return Value:
                         // Check if the processor supports AVX512VNNI.
                         //
 
-                        if ((Cpuid7[2] & 0x800) != 0) {
+                        if ((Cpuid7[2] & 0x800) != 0 && MaximumIsaLevel >= MlasIsaAvx512Vnni) {
 
                             this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
                             this->GemmU8U8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
                             this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
                             this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Vnni;
+
+#if !defined(MLAS_AMX_UNSUPPORTED)
+
+                            //
+                            // Check if the processor supports AMX-TILE and
+                            // AMX-INT8 and the operating system supports
+                            // saving the tile state.
+                            //
+
+                            if (((Cpuid7[3] & 0x3000000) == 0x3000000) &&
+                                ((xcr0 & 0x60000) == 0x60000) &&
+                                MaximumIsaLevel >= MlasIsaAmx &&
+                                MlasRequestTileDataPermission()) {
+
+                                this->GemmU8S8Kernel = MlasGemmU8S8KernelAmx;
+                            }
+
+#endif // MLAS_AMX_UNSUPPORTED
+
                         }
                     }
 
@@ -286,6 +461,31 @@ Return Value:
 
 #endif // MLAS_TARGET_AMD64_IX86
 
+#if defined(MLAS_TARGET_ARM64)
+
+    //
+    // Default to the baseline NEON support.
+    //
+
+    this->GemmU8X8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_NEON>;
+    this->GemmU8X8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_NEON>;
+
+#if defined(__linux__) && !defined(MLAS_UDOT_UNSUPPORTED)
+
+    //
+    // Check if the processor supports the ARMv8.2 dot product instructions.
+    //
+
+    if ((getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0) {
+
+        this->GemmU8X8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_UDOT>;
+        this->GemmU8X8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_UDOT>;
+    }
+
+#endif
+
+#endif // MLAS_TARGET_ARM64
+
 }
 
 size_t
@@ -317,3 +517,55 @@ Return Value:
     return MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
 #endif
 }
+
+const char*
+MLASCALL
+MlasGetPlatformSignature(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns a string that identifies the layout of the buffers
+    produced by the packing routines of this library on the current platform,
+    such as MlasGemmPackB. A packed buffer that was saved may only be used on a
+    platform with the same signature.
+
+    The version number must be incremented when the layout of a packed buffer
+    changes.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the platform signature.
+
+--*/
+{
+    static const std::string Signature = [] {
+        std::string signature = "mlas1";
+#if defined(MLAS_TARGET_AMD64)
+        signature += "-amd64";
+#elif defined(MLAS_TARGET_IX86)
+        signature += "-x86";
+#elif defined(MLAS_TARGET_ARM64)
+        signature += "-arm64";
+#elif defined(MLAS_TARGET_ARM)
+        signature += "-arm";
+#else
+        signature += "-generic";
+#endif
+        signature += "-sgemm" + std::to_string(MLAS_SGEMM_PACKED_STRIDEK) + "x" +
+            std::to_string(MLAS_SGEMM_STRIDEN_THREAD_ALIGN);
+        signature += "-align" + std::to_string(MlasGetPreferredBufferAlignment());
+#if defined(MLAS_TARGET_AMD64)
+        signature += "-nchwc" + std::to_string(MlasPlatform.NchwcBlockSize);
+#endif
+        return signature;
+    }();
+
+    return Signature.c_str();
+}
@@ -1038,11 +1038,32 @@ Return Value:
         size_t InputSizeRemaining = InputSize;
 
         //
-        // Iterate over the input buffer a vector at a time.
+        // Iterate over the input buffer four vectors at a time using separate
+        // accumulators to hide the latency of the reduction, then a vector at
+        // a time.
         //
 
         MLAS_FLOAT32X4 Reduction = PoolingType::InitialVector();
 
+        if (InputSizeRemaining >= 16) {
+
+            MLAS_FLOAT32X4 Reduction1 = Reduction;
+            MLAS_FLOAT32X4 Reduction2 = Reduction;
+            MLAS_FLOAT32X4 Reduction3 = Reduction;
+
+            do {
+                Reduction = PoolingType::Reduce(Reduction, MlasLoadFloat32x4(Input));
+                Reduction1 = PoolingType::Reduce(Reduction1, MlasLoadFloat32x4(Input + 4));
+                Reduction2 = PoolingType::Reduce(Reduction2, MlasLoadFloat32x4(Input + 8));
+                Reduction3 = PoolingType::Reduce(Reduction3, MlasLoadFloat32x4(Input + 12));
+                Input += 16;
+                InputSizeRemaining -= 16;
+            } while (InputSizeRemaining >= 16);
+
+            Reduction = PoolingType::Reduce(PoolingType::Reduce(Reduction, Reduction1),
+                PoolingType::Reduce(Reduction2, Reduction3));
+        }
+
         while (InputSizeRemaining >= 4) {
             Reduction = PoolingType::Reduce(Reduction, MlasLoadFloat32x4(Input));
             Input += 4;
@@ -1304,3 +1325,373 @@ Return Value:
     return;
 #endif
 }
+
+//
+// Define the parameters to execute segments of a NHWC pooling operation on
+// worker threads.
+//
+
+struct MLAS_POOL_NHWC_WORK_BLOCK
+{
+    int32_t ThreadCount;
+    MLAS_POOLING_KIND PoolingKind;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    size_t ChannelCount;
+    size_t ChannelBlockSize;
+    size_t ChannelBlockCount;
+    size_t TotalWorkCount;
+    int64_t KernelHeight;
+    int64_t KernelWidth;
+    int64_t PaddingTop;
+    int64_t PaddingLeft;
+    int64_t StrideHeight;
+    int64_t StrideWidth;
+    const float* Input;
+    float* Output;
+};
+
+//
+// Define the number of channels that a thread reduces for global pooling. A
+// block of channels from every spatial element of a batch is assigned to a
+// thread, so that global pooling spans threads even for a single batch.
+//
+
+#define MLAS_POOL_NHWC_GLOBAL_CHANNEL_BLOCK 16
+
+template<typename PoolingType>
+void
+MlasPoolNhwcReduceChannels(
+    const MLAS_POOL_NHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    float* Output,
+    size_t ihStart,
+    size_t ihEnd,
+    size_t iwStart,
+    size_t iwEnd,
+    size_t ChannelStart,
+    size_t ChannelEnd,
+    float Divisor
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a range of channels over a window of the spatial
+    elements of a batch of a NHWC tensor.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the pooling parameters.
+
+    Input - Supplies the batch of the input tensor.
+
+    Output - Supplies the spatial element of the output tensor.
+
+    ihStart - Supplies the first row of the window.
+
+    ihEnd - Supplies the row after the last row of the window.
+
+    iwStart - Supplies the first column of the window.
+
+    iwEnd - Supplies the column after the last column of the window.
+
+    ChannelStart - Supplies the first channel to reduce.
+
+    ChannelEnd - Supplies the channel after the last channel to reduce.
+
+    Divisor - Supplies the divisor for average pooling.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t ChannelCount = WorkBlock->ChannelCount;
+    const bool IsAveragePooling = (WorkBlock->PoolingKind != MlasMaximumPooling);
+
+    const MLAS_FLOAT32X4 DivisorVector = MlasBroadcastFloat32x4(Divisor);
+
+    size_t c = ChannelStart;
+
+    //
+    // Reduce sixteen channels at a time to hide the latency of the reduction.
+    //
+
+    for (; c + 16 <= ChannelEnd; c += 16) {
+
+        MLAS_FLOAT32X4 Reduction0 = PoolingType::InitialVector();
+        MLAS_FLOAT32X4 Reduction1 = Reduction0;
+        MLAS_FLOAT32X4 Reduction2 = Reduction0;
+        MLAS_FLOAT32X4 Reduction3 = Reduction0;
+
+        for (size_t ih = ihStart; ih < ihEnd; ih++) {
+            for (size_t iw = iwStart; iw < iwEnd; iw++) {
+
+                const float* input = Input + (ih * InputWidth + iw) * ChannelCount + c;
+
+                Reduction0 = PoolingType::Reduce(Reduction0, MlasLoadFloat32x4(input));
+                Reduction1 = PoolingType::Reduce(Reduction1, MlasLoadFloat32x4(input + 4));
+                Reduction2 = PoolingType::Reduce(Reduction2, MlasLoadFloat32x4(input + 8));
+                Reduction3 = PoolingType::Reduce(Reduction3, MlasLoadFloat32x4(input + 12));
+            }
+        }
+
+        if (IsAveragePooling) {
+            Reduction0 = MlasDivideFloat32x4(Reduction0, DivisorVector);
+            Reduction1 = MlasDivideFloat32x4(Reduction1, DivisorVector);
+            Reduction2 = MlasDivideFloat32x4(Reduction2, DivisorVector);
+            Reduction3 = MlasDivideFloat32x4(Reduction3, DivisorVector);
+        }
+
+        MlasStoreFloat32x4(Output + c, Reduction0);
+        MlasStoreFloat32x4(Output + c + 4, Reduction1);
+        MlasStoreFloat32x4(Output + c + 8, Reduction2);
+        MlasStoreFloat32x4(Output + c + 12, Reduction3);
+    }
+
+    for (; c + 4 <= ChannelEnd; c += 4) {
+
+        MLAS_FLOAT32X4 Reduction = PoolingType::InitialVector();
+
+        for (size_t ih = ihStart; ih < ihEnd; ih++) {
+            for (size_t iw = iwStart; iw < iwEnd; iw++) {
+                Reduction = PoolingType::Reduce(Reduction,
+                    MlasLoadFloat32x4(Input + (ih * InputWidth + iw) * ChannelCount + c));
+            }
+        }
+
+        if (IsAveragePooling) {
+            Reduction = MlasDivideFloat32x4(Reduction, DivisorVector);
+        }
+
+        MlasStoreFloat32x4(Output + c, Reduction);
+    }
+
+    for (; c < ChannelEnd; c++) {
+
+        float Reduction = PoolingType::InitialValue();
+
+        for (size_t ih = ihStart; ih < ihEnd; ih++) {
+            for (size_t iw = iwStart; iw < iwEnd; iw++) {
+                Reduction = PoolingType::Reduce(Reduction, Input[(ih * InputWidth + iw) * ChannelCount + c]);
+            }
+        }
+
+        Output[c] = PoolingType::AveragePool(Reduction, Divisor);
+    }
+}
+
+template<typename PoolingType>
+void
+MlasPoolNhwcThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NHWC pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_POOL_NHWC_WORK_BLOCK*)Context;
+
+    const MLAS_POOLING_KIND PoolingKind = WorkBlock->PoolingKind;
+
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t OutputHeight = WorkBlock->OutputHeight;
+    const size_t OutputWidth = WorkBlock->OutputWidth;
+    const size_t ChannelCount = WorkBlock->ChannelCount;
+    const size_t ChannelBlockSize = WorkBlock->ChannelBlockSize;
+    const size_t ChannelBlockCount = WorkBlock->ChannelBlockCount;
+
+    const int64_t KernelHeight = WorkBlock->KernelHeight;
+    const int64_t KernelWidth = WorkBlock->KernelWidth;
+
+    //
+    // Partition the blocks of channels of the output spatial elements from all
+    // of the batches to the threads.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->TotalWorkCount, &WorkIndex, &WorkRemaining);
+
+    for (size_t work = WorkIndex; work < WorkIndex + WorkRemaining; work++) {
+
+        const size_t cb = work % ChannelBlockCount;
+        const size_t OutputIndex = work / ChannelBlockCount;
+
+        const size_t n = OutputIndex / (OutputHeight * OutputWidth);
+        const size_t ph = (OutputIndex / OutputWidth) % OutputHeight;
+        const size_t pw = OutputIndex % OutputWidth;
+
+        const int64_t ihStart64 = ph * WorkBlock->StrideHeight - WorkBlock->PaddingTop;
+        const int64_t ihEnd64 = ihStart64 + KernelHeight;
+        const int64_t iwStart64 = pw * WorkBlock->StrideWidth - WorkBlock->PaddingLeft;
+        const int64_t iwEnd64 = iwStart64 + KernelWidth;
+
+        const size_t ihStart = size_t(std::max(ihStart64, int64_t(0)));
+        const size_t ihEnd = size_t(std::min(ihEnd64, int64_t(InputHeight)));
+        const size_t iwStart = size_t(std::max(iwStart64, int64_t(0)));
+        const size_t iwEnd = size_t(std::min(iwEnd64, int64_t(InputWidth)));
+
+        float Divisor;
+
+        if (PoolingKind == MlasAveragePoolingExcludePad) {
+            Divisor = float((ihEnd - ihStart) * (iwEnd - iwStart));
+        } else {
+            Divisor = float(KernelHeight * KernelWidth);
+        }
+
+        const size_t ChannelStart = cb * ChannelBlockSize;
+        const size_t ChannelEnd = std::min(ChannelStart + ChannelBlockSize, ChannelCount);
+
+        MlasPoolNhwcReduceChannels<PoolingType>(WorkBlock,
+            WorkBlock->Input + n * InputHeight * InputWidth * ChannelCount,
+            WorkBlock->Output + OutputIndex * ChannelCount, ihStart, ihEnd, iwStart, iwEnd,
+            ChannelStart, ChannelEnd, Divisor);
+    }
+}
+
+void
+MLASCALL
+MlasPoolNhwc(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the two dimensional pooling operation for tensors
+    in NHWC format. The channels are reduced a vector at a time.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    InputShape - Supplies the shape of the input tensor in NHWC order.
+
+    KernelShape - Supplies the shape of the kernel transform, else nullptr for
+        global pooling.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor, else nullptr if there is no padding.
+
+    StrideShape - Supplies the shape of the stride, else nullptr if all of the
+        strides are one.
+
+    OutputShape - Supplies the shape of the output tensor in NHWC order.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_POOL_NHWC_WORK_BLOCK WorkBlock;
+
+    const size_t BatchCount = size_t(InputShape[0]);
+
+    WorkBlock.PoolingKind = PoolingKind;
+    WorkBlock.InputHeight = size_t(InputShape[1]);
+    WorkBlock.InputWidth = size_t(InputShape[2]);
+    WorkBlock.ChannelCount = size_t(InputShape[3]);
+    WorkBlock.OutputHeight = size_t(OutputShape[1]);
+    WorkBlock.OutputWidth = size_t(OutputShape[2]);
+    WorkBlock.KernelHeight = (KernelShape != nullptr) ? KernelShape[0] : InputShape[1];
+    WorkBlock.KernelWidth = (KernelShape != nullptr) ? KernelShape[1] : InputShape[2];
+    WorkBlock.PaddingTop = (Padding != nullptr) ? Padding[0] : 0;
+    WorkBlock.PaddingLeft = (Padding != nullptr) ? Padding[1] : 0;
+    WorkBlock.StrideHeight = (StrideShape != nullptr) ? StrideShape[0] : 1;
+    WorkBlock.StrideWidth = (StrideShape != nullptr) ? StrideShape[1] : 1;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+
+    const size_t OutputSize = WorkBlock.OutputHeight * WorkBlock.OutputWidth;
+
+    //
+    // Each output spatial element reduces all of its channels unless there
+    // are too few output elements to keep the threads busy, which is the case
+    // for global pooling. The channels are then split into blocks that are
+    // reduced independently.
+    //
+
+    if (OutputSize == 1 && WorkBlock.ChannelCount > MLAS_POOL_NHWC_GLOBAL_CHANNEL_BLOCK) {
+        WorkBlock.ChannelBlockSize = MLAS_POOL_NHWC_GLOBAL_CHANNEL_BLOCK;
+    } else {
+        WorkBlock.ChannelBlockSize = std::max(WorkBlock.ChannelCount, size_t(1));
+    }
+
+    WorkBlock.ChannelBlockCount =
+        (WorkBlock.ChannelCount + WorkBlock.ChannelBlockSize - 1) / WorkBlock.ChannelBlockSize;
+    WorkBlock.TotalWorkCount = BatchCount * OutputSize * WorkBlock.ChannelBlockCount;
+
+    //
+    // Limit the number of threads to the number of work items and try to keep
+    // each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > WorkBlock.TotalWorkCount) {
+        ThreadCount = int32_t(WorkBlock.TotalWorkCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    const size_t KernelSize = size_t(WorkBlock.KernelHeight * WorkBlock.KernelWidth);
+    size_t BlockCount = ((BatchCount * OutputSize * KernelSize * WorkBlock.ChannelCount) /
+        MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    if (ThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    if (PoolingKind == MlasMaximumPooling) {
+        MlasExecuteThreaded(MlasPoolNhwcThreaded<MLAS_MAXIMUM_POOLING>, &WorkBlock, ThreadCount, ThreadPool);
+    } else {
+        MlasExecuteThreaded(MlasPoolNhwcThreaded<MLAS_AVERAGE_POOLING>, &WorkBlock, ThreadCount, ThreadPool);
+    }
+}
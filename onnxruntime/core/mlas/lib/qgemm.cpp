@@ -33,6 +33,8 @@ struct MLAS_GEMM_U8X8_WORK_BLOCK {
     size_t N;
     size_t K;
     const uint8_t* A;
+    const float* AFloat;
+    float AScale;
     size_t lda;
     const void* B;
     size_t ldb;
@@ -199,6 +201,68 @@ Return Value:
     }
 }
 
+template<typename KernelType>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8CopyPackA(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    typename KernelType::PackedAType* PanelA,
+    uint8_t* PanelAQuant,
+    size_t OffsetA,
+    size_t CountM,
+    size_t CountK,
+    int32_t* RowSumBuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a panel of matrix A to the local packed buffer. If
+    matrix A is single precision, the panel is first quantized with the scale
+    and the zero point offset of matrix A to a local buffer, so the quantized
+    values are packed while they are in the cache and matrix A is not
+    quantized by a separate pass.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    PanelA - Supplies the address of the local packed buffer.
+
+    PanelAQuant - Supplies the address of a local buffer of CountM * CountK
+        values used to quantize a single precision matrix A.
+
+    OffsetA - Supplies the offset of the panel in matrix A.
+
+    CountM - Supplies the number of rows of the panel.
+
+    CountK - Supplies the number of columns of the panel.
+
+    RowSumBuffer - Supplies the address of the buffer to receive the sums of
+        the rows of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t lda = WorkBlock->lda;
+
+    if (WorkBlock->AFloat == nullptr) {
+        KernelType::CopyPackA(PanelA, WorkBlock->A + OffsetA, lda, CountM, CountK, RowSumBuffer);
+        return;
+    }
+
+    const float* a = WorkBlock->AFloat + OffsetA;
+
+    for (size_t m = 0; m < CountM; m++) {
+        MlasQuantizeLinear(a + m * lda, PanelAQuant + m * CountK, CountK, WorkBlock->AScale, WorkBlock->offa);
+    }
+
+    KernelType::CopyPackA(PanelA, PanelAQuant, CountK, CountM, CountK, RowSumBuffer);
+}
+
 template<typename KernelType>
 void
 MLASCALL
@@ -226,6 +290,7 @@ Return Value:
 
     MLAS_DECLSPEC_ALIGN(typename KernelType::PackedAType PanelA[Strides.M * Strides.K], 64);
     MLAS_DECLSPEC_ALIGN(typename KernelType::PackedBType PanelB[Strides.N * Strides.K], 64);
+    MLAS_DECLSPEC_ALIGN(uint8_t PanelAQuant[Strides.M * Strides.K], 64);
 
     MLAS_DECLSPEC_ALIGN(int32_t RowSumBuffer[Strides.M], 64);
     MLAS_DECLSPEC_ALIGN(int32_t ColumnSumBuffer[Strides.N], 64);
@@ -238,7 +303,7 @@ Return Value:
     const size_t ldb = WorkBlock->ldb;
     const size_t ldc = WorkBlock->ldc;
 
-    const uint8_t* A = WorkBlock->A + WorkBlock->RangeStartM * lda;
+    const size_t OffsetA = WorkBlock->RangeStartM * lda;
     const uint8_t* B = (const uint8_t*)WorkBlock->B + WorkBlock->RangeStartN;
     int32_t* C = WorkBlock->C + WorkBlock->RangeStartM * ldc + WorkBlock->RangeStartN;
 
@@ -249,8 +314,8 @@ Return Value:
     // Try to use a GEMV kernel if supported by this kernel type.
     //
 
-    if ((M == 1) && (offa == 0) && (offb == 0) && !WorkBlock->CIsFloat) {
-        if (KernelType::TryGemvKernel(A, B, ldb, C, K, N, WorkBlock->BIsSigned)) {
+    if ((M == 1) && (offa == 0) && (offb == 0) && !WorkBlock->CIsFloat && WorkBlock->AFloat == nullptr) {
+        if (KernelType::TryGemvKernel(WorkBlock->A + OffsetA, B, ldb, C, K, N, WorkBlock->BIsSigned)) {
             return;
         }
     }
@@ -320,8 +385,8 @@ Return Value:
                 // Copy a panel of matrix A to a local packed buffer.
                 //
 
-                KernelType::CopyPackA(PanelA, A + m * lda, lda, CountM, CountK,
-                    RowSumBuffer);
+                MlasGemmU8X8CopyPackA<KernelType>(WorkBlock, PanelA, PanelAQuant,
+                    OffsetA + m * lda + k, CountM, CountK, RowSumBuffer);
 
                 MlasGemmU8X8ScaleSumBuffer(RowSumBuffer, CountM, -offb);
 
@@ -356,7 +421,6 @@ Return Value:
             }
         }
 
-        A += CountK;
         B += CountK * ldb;
     }
 }
@@ -387,6 +451,7 @@ Return Value:
     constexpr MLAS_GEMM_U8X8_STRIDES Strides = KernelType::PackedStrides;
 
     MLAS_DECLSPEC_ALIGN(typename KernelType::PackedAType PanelA[Strides.M * Strides.K], 64);
+    MLAS_DECLSPEC_ALIGN(uint8_t PanelAQuant[Strides.M * Strides.K], 64);
 
     MLAS_DECLSPEC_ALIGN(int32_t RowSumBuffer[Strides.M], 64);
     MLAS_DECLSPEC_ALIGN(int32_t ColumnSumBuffer[Strides.N], 64);
@@ -398,7 +463,7 @@ Return Value:
     const size_t lda = WorkBlock->lda;
     const size_t ldc = WorkBlock->ldc;
 
-    const uint8_t* A = WorkBlock->A + WorkBlock->RangeStartM * lda;
+    const size_t OffsetA = WorkBlock->RangeStartM * lda;
     const uint8_t* PackedB = (const uint8_t*)WorkBlock->B;
     int32_t* C = WorkBlock->C + WorkBlock->RangeStartM * ldc + WorkBlock->RangeStartN;
 
@@ -482,8 +547,8 @@ Return Value:
                 // Copy a panel of matrix A to a local packed buffer.
                 //
 
-                KernelType::CopyPackA(PanelA, A + m * lda, lda, CountM, CountK,
-                    RowSumBuffer);
+                MlasGemmU8X8CopyPackA<KernelType>(WorkBlock, PanelA, PanelAQuant,
+                    OffsetA + m * lda + k, CountM, CountK, RowSumBuffer);
 
                 MlasGemmU8X8ScaleSumBuffer(RowSumBuffer, CountM, -offb);
 
@@ -518,7 +583,6 @@ Return Value:
             }
         }
 
-        A += CountK;
         PackedB = (const uint8_t*)PackedB + AlignedN * CountK;
     }
 }
@@ -1969,6 +2033,13 @@ constexpr size_t MLAS_GEMM_U8X8_KERNEL_NEON::PackedK;
 constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8X8_KERNEL_NEON::Strides;
 constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8X8_KERNEL_NEON::PackedStrides;
 
+template
+void
+MLASCALL
+MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_NEON>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
 template
 void
 MLASCALL
@@ -1976,6 +2047,278 @@ MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_NEON>(
     const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
     );
 
+#if !defined(MLAS_UDOT_UNSUPPORTED)
+
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8CopyPackBProcessUdot(
+    uint8_t* D,
+    const uint8x8_t BytesRows[4],
+    uint32x4_t ColumnSums[2]
+    )
+{
+    //
+    // Transpose the four rows of 8 columns so that the four K values of each
+    // column are adjacent.
+    //
+
+    uint8x8x2_t BytesZip0 = vzip_u8(BytesRows[0], BytesRows[1]);
+    uint8x8x2_t BytesZip1 = vzip_u8(BytesRows[2], BytesRows[3]);
+
+    uint16x4x2_t WordsZip0 = vzip_u16(vreinterpret_u16_u8(BytesZip0.val[0]),
+        vreinterpret_u16_u8(BytesZip1.val[0]));
+    uint16x4x2_t WordsZip1 = vzip_u16(vreinterpret_u16_u8(BytesZip0.val[1]),
+        vreinterpret_u16_u8(BytesZip1.val[1]));
+
+    vst1_u8(&D[0], vreinterpret_u8_u16(WordsZip0.val[0]));
+    vst1_u8(&D[8], vreinterpret_u8_u16(WordsZip0.val[1]));
+    vst1_u8(&D[16], vreinterpret_u8_u16(WordsZip1.val[0]));
+    vst1_u8(&D[24], vreinterpret_u8_u16(WordsZip1.val[1]));
+
+    uint16x8_t WordsSum = vaddq_u16(vaddl_u8(BytesRows[0], BytesRows[1]),
+        vaddl_u8(BytesRows[2], BytesRows[3]));
+
+    ColumnSums[0] = vaddw_u16(ColumnSums[0], vget_low_u16(WordsSum));
+    ColumnSums[1] = vaddw_high_u16(ColumnSums[1], WordsSum);
+}
+
+void
+MLASCALL
+MlasGemmU8X8CopyPackBUdot(
+    uint8_t* D,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    int32_t* ColumnSumBuffer,
+    bool BIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    packed buffer.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+    ColumnSumBuffer - Supplies the address of the buffer to receive the sums of
+        the elements along each of the columns.
+
+    BIsSigned - Supplies true if the source matrix is signed data, else false
+        if the source matrix is unsigned data.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const uint8x8_t BitFlipVector = vdup_n_u8(BIsSigned ? 0x80 : 0);
+    const uint8x8_t ZeroVector = vmov_n_u8(0);
+
+    //
+    // Process 8 columns of matrix B in a loop.
+    //
+    // The buffer is packed as a series of 32 byte vectors where four rows of
+    // 8 columns are transposed with the following pattern:
+    //
+    //      [ A0 B0 C0 D0 A1 B1 C1 D1 ... A7 B7 C7 D7 ]
+    //
+    // Signed buffers are converted to unsigned buffers in order to share a
+    // common kernel.
+    //
+    // If CountK is not aligned to a multiple of four, then the packed buffer
+    // is padded with zero rows.
+    //
+    // If CountN is not aligned to a multiple of 8, then the extra columns are
+    // padded with zeroes.
+    //
+
+    while (CountN > 0) {
+
+        const uint8_t* b = B;
+        uint8_t PaddedMatrixBData[4][8];
+        uint32x4_t ColumnSums[2];
+
+        ColumnSums[0] = vmovq_n_u32(0);
+        ColumnSums[1] = vmovq_n_u32(0);
+
+        for (size_t k = 0; k < CountK; k += 4) {
+
+            const size_t RowsRemaining = std::min(CountK - k, size_t(4));
+            uint8x8_t BytesRows[4];
+
+            for (size_t kk = 0; kk < 4; kk++) {
+
+                if (kk >= RowsRemaining) {
+                    BytesRows[kk] = ZeroVector;
+                    continue;
+                }
+
+                const uint8_t* bb = b + kk * ldb;
+
+                if (CountN < 8) {
+
+                    vst1_u8(PaddedMatrixBData[kk], ZeroVector);
+
+                    for (size_t n = 0; n < CountN; n++) {
+                        PaddedMatrixBData[kk][n] = bb[n];
+                    }
+
+                    bb = PaddedMatrixBData[kk];
+                }
+
+                BytesRows[kk] = veor_u8(vld1_u8(bb), BitFlipVector);
+            }
+
+            MlasGemmU8X8CopyPackBProcessUdot(D, BytesRows, ColumnSums);
+
+            b += ldb * 4;
+            D += 32;
+        }
+
+        vst1q_s32(&ColumnSumBuffer[0], vreinterpretq_s32_u32(ColumnSums[0]));
+        vst1q_s32(&ColumnSumBuffer[4], vreinterpretq_s32_u32(ColumnSums[1]));
+
+        if (CountN < 8) {
+            break;
+        }
+
+        ColumnSumBuffer += 8;
+        B += 8;
+        CountN -= 8;
+    }
+}
+
+struct MLAS_GEMM_U8X8_KERNEL_UDOT
+{
+    typedef uint8_t PackedAType;
+    typedef uint8_t PackedBType;
+    typedef uint8_t OffsetBType;
+
+    static constexpr size_t PackedK = 4;
+    static constexpr MLAS_GEMM_U8X8_STRIDES Strides{24, 128, 256};
+    static constexpr MLAS_GEMM_U8X8_STRIDES PackedStrides{24, 256, 128};
+
+    MLAS_FORCEINLINE
+    static
+    bool
+    TryGemvKernel(
+        const uint8_t* A,
+        const uint8_t* B,
+        size_t ldb,
+        int32_t* C,
+        size_t CountK,
+        size_t CountN,
+        bool BIsSigned
+        )
+    {
+        MLAS_UNREFERENCED_PARAMETER(A);
+        MLAS_UNREFERENCED_PARAMETER(B);
+        MLAS_UNREFERENCED_PARAMETER(ldb);
+        MLAS_UNREFERENCED_PARAMETER(C);
+        MLAS_UNREFERENCED_PARAMETER(CountK);
+        MLAS_UNREFERENCED_PARAMETER(CountN);
+        MLAS_UNREFERENCED_PARAMETER(BIsSigned);
+
+        return false;
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    CopyPackA(
+        PackedAType* D,
+        const uint8_t* A,
+        size_t lda,
+        size_t CountM,
+        size_t CountK,
+        int32_t* RowSumBuffer
+        )
+    {
+        MlasGemmU8X8CopyPackANeon(D, A, lda, CountM, CountK, RowSumBuffer);
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    CopyPackB(
+        PackedBType* D,
+        const uint8_t* B,
+        size_t ldb,
+        size_t CountN,
+        size_t CountK,
+        int32_t* ColumnSumBuffer,
+        bool BIsSigned
+        )
+    {
+        MlasGemmU8X8CopyPackBUdot(D, B, ldb, CountN, CountK, ColumnSumBuffer,
+            BIsSigned);
+    }
+
+    MLAS_FORCEINLINE
+    static
+    size_t
+    GemmKernel(
+        const PackedAType* A,
+        const PackedBType* B,
+        int32_t* C,
+        size_t PackedCountK,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc,
+        const int32_t* RowSumBuffer,
+        const int32_t* ColumnSumBuffer,
+        int32_t DepthValue,
+        bool ZeroMode
+        )
+    {
+        return MlasGemmU8X8KernelUdot(A, B, C, PackedCountK, CountM, CountN, ldc,
+            RowSumBuffer, ColumnSumBuffer, DepthValue, ZeroMode);
+    }
+};
+
+constexpr size_t MLAS_GEMM_U8X8_KERNEL_UDOT::PackedK;
+constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8X8_KERNEL_UDOT::Strides;
+constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8X8_KERNEL_UDOT::PackedStrides;
+
+//
+// The packed B buffer is sized and sliced along K using the parameters of the
+// NEON kernel.
+//
+
+static_assert(MLAS_GEMM_U8X8_KERNEL_UDOT::PackedK == MLAS_GEMM_U8X8_KERNEL_NEON::PackedK,
+    "packed K must match the NEON kernel");
+static_assert(MLAS_GEMM_U8X8_KERNEL_UDOT::PackedStrides.K == MLAS_GEMM_U8X8_KERNEL_NEON::PackedStrides.K,
+    "packed K stride must match the NEON kernel");
+
+template
+void
+MLASCALL
+MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_UDOT>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+template
+void
+MLASCALL
+MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_UDOT>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+#endif
+
 #endif
 
 void
@@ -2051,11 +2394,10 @@ Return Value:
 #elif defined(MLAS_SSE2_INTRINSICS)
     MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>(&WorkBlock);
 #elif defined(MLAS_NEON64_INTRINSICS)
-    if (WorkBlock.BIsPacked) {
-        MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_NEON>(&WorkBlock);
-    } else {
-        MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_NEON>(&WorkBlock);
-    }
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation = WorkBlock.BIsPacked ?
+        MlasPlatform.GemmU8X8PackedOperation : MlasPlatform.GemmU8X8Operation;
+
+    GemmU8X8Operation(&WorkBlock);
 #endif
 }
 
@@ -2331,6 +2673,113 @@ Return Value:
     MlasGemmU8X8Schedule(&WorkBlock, ThreadPool);
 }
 
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float AScale,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    bool BIsSigned,
+    float* C,
+    size_t ldc,
+    const float* Scale,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) with a single precision matrix A, which is quantized
+    with the supplied scale and zero point offset as its panels are packed.
+    This avoids a separate pass and buffer to quantize matrix A, e.g. for
+    dynamically quantized activations.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of the single precision matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    AScale - Supplies the scale used to quantize matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    BIsSigned - Supplies true if matrix B is signed data, else false if matrix
+        B is unsigned data.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Scale - Supplies the scale multiplier to apply to each element of matrix C,
+        the product of AScale and the scale of matrix B.
+
+    Bias - Supplies the bias vector to apply to element of matrix C. The vector
+        is of length N.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_U8X8_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the GEMM parameters to the work block.
+    //
+
+    memset(&WorkBlock, 0, sizeof(MLAS_GEMM_U8X8_WORK_BLOCK));
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.AFloat = A;
+    WorkBlock.AScale = AScale;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = (int32_t*)C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.Scale = Scale;
+    WorkBlock.BiasFloat = Bias;
+    WorkBlock.offa = offa;
+    WorkBlock.offb = offb;
+    WorkBlock.BIsSigned = BIsSigned;
+    WorkBlock.CIsFloat = true;
+
+    //
+    // Schedule the operation across a set of worker threads.
+    //
+
+    MlasGemmU8X8Schedule(&WorkBlock, ThreadPool);
+}
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_NEON64_INTRINSICS)
 
 void
@@ -2517,6 +2966,110 @@ Return Value:
     MlasGemmU8X8Schedule(&WorkBlock, ThreadPool);
 }
 
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float AScale,
+    uint8_t offa,
+    const void* PackedB,
+    uint8_t offb,
+    bool BIsSigned,
+    float* C,
+    size_t ldc,
+    const float* Scale,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) with a single precision matrix A, which is quantized
+    with the supplied scale and zero point offset as its panels are packed.
+    This avoids a separate pass and buffer to quantize matrix A, e.g. for
+    dynamically quantized activations.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of the single precision matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    AScale - Supplies the scale used to quantize matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    BIsSigned - Supplies true if matrix B is signed data, else false if matrix
+        B is unsigned data.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Scale - Supplies the scale multiplier to apply to each element of matrix C,
+        the product of AScale and the scale of matrix B.
+
+    Bias - Supplies the bias vector to apply to element of matrix C. The vector
+        is of length N.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_U8X8_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the GEMM parameters to the work block.
+    //
+
+    memset(&WorkBlock, 0, sizeof(MLAS_GEMM_U8X8_WORK_BLOCK));
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.AFloat = A;
+    WorkBlock.AScale = AScale;
+    WorkBlock.lda = lda;
+    WorkBlock.B = PackedB;
+    WorkBlock.C = (int32_t*)C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.Scale = Scale;
+    WorkBlock.BiasFloat = Bias;
+    WorkBlock.offa = offa;
+    WorkBlock.offb = offb;
+    WorkBlock.BIsPacked = true;
+    WorkBlock.BIsSigned = BIsSigned;
+    WorkBlock.CIsFloat = true;
+
+    //
+    // Schedule the operation across a set of worker threads.
+    //
+
+    MlasGemmU8X8Schedule(&WorkBlock, ThreadPool);
+}
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -2701,7 +3254,15 @@ Return Value:
                 MLAS_GEMM_U8U8_KERNEL_AVX2::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
             }
 #elif defined(MLAS_NEON64_INTRINSICS)
+#if !defined(MLAS_UDOT_UNSUPPORTED)
+            if (MlasPlatform.GemmU8X8PackedOperation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_UDOT>) {
+                MLAS_GEMM_U8X8_KERNEL_UDOT::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
+            } else {
+                MLAS_GEMM_U8X8_KERNEL_NEON::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
+            }
+#else
             MLAS_GEMM_U8X8_KERNEL_NEON::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
+#endif
 #else
 #error Unknown architecture.
 #endif
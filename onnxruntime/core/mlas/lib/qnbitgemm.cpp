@@ -0,0 +1,811 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qnbitgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a matrix B of weights quantized blockwise to 4 or 8 bits.
+
+    Each column of matrix B is split into blocks of BlkLen values along K, and
+    each block is quantized with a scale and a zero point of its own. The
+    blocks of a column are stored contiguously, so a column is read as a
+    sequential stream of BlkLen * BlkBitWidth / 8 bytes per block.
+
+    For a small number of rows of matrix A, e.g. one token of a decoder, the
+    blocks are dequantized on the fly into registers and multiplied with the
+    rows of A, so the weights are read once from memory in their quantized
+    size. For more rows, strips of columns are dequantized to a buffer that is
+    then multiplied by the single precision GEMM, whose cost amortizes the
+    dequantization.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows of matrix A multiplied at a time with a column,
+// the number of columns of a work item of a thread, the number of rows of
+// matrix A from which strips of matrix B are dequantized for the SGEMM, and
+// the number of rows of a dequantized panel of a strip.
+//
+
+#define MLAS_QNBIT_GEMM_TILE_M                      4
+#define MLAS_QNBIT_GEMM_STRIDEN                     16
+#define MLAS_QNBIT_GEMM_SGEMM_THRESHOLD_M           16
+#define MLAS_QNBIT_GEMM_STRIDEK                     256
+
+//
+// Define the number of multiply-accumulates per thread.
+//
+
+#define MLAS_QNBIT_GEMM_THREAD_COMPLEXITY           (64 * 1024)
+
+MLAS_FORCEINLINE
+size_t
+MlasQNBitBlkDataSize(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    )
+{
+    return BlkLen * BlkBitWidth / 8;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasQNBitZeroPointsPerColumn(
+    size_t BlkBitWidth,
+    size_t BlockCountK
+    )
+{
+    return (BlockCountK * BlkBitWidth + 7) / 8;
+}
+
+bool
+MLASCALL
+MlasIsBlockwiseQuantizedGemmAvailable(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether the blockwise quantized GEMM supports the
+    bit width and the block length.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits of a quantized value, 4 or 8.
+
+    BlkLen - Supplies the number of values of a block, a power of two from 16
+        to 256.
+
+Return Value:
+
+    Returns true if the combination is supported.
+
+--*/
+{
+    if (BlkBitWidth != 4 && BlkBitWidth != 8) {
+        return false;
+    }
+
+    return BlkLen >= 16 && BlkLen <= 256 && (BlkLen & (BlkLen - 1)) == 0;
+}
+
+void
+MLASCALL
+MlasBlockwiseQuantizedBufferSizes(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t N,
+    size_t K,
+    size_t* QuantBDataSizeInBytes,
+    size_t* QuantBScaleSize,
+    size_t* QuantBZeroPointSizeInBytes
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sizes of the buffers of a quantized matrix B.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits of a quantized value.
+
+    BlkLen - Supplies the number of values of a block.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    QuantBDataSizeInBytes - Receives the size in bytes of the quantized
+        values, N columns of ceil(K / BlkLen) blocks of BlkLen values.
+
+    QuantBScaleSize - Receives the number of scales, one per block.
+
+    QuantBZeroPointSizeInBytes - Receives the size in bytes of the zero
+        points, one per block packed to BlkBitWidth bits, with the zero points
+        of each column starting at a byte boundary.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+    *QuantBDataSizeInBytes = N * BlockCountK * MlasQNBitBlkDataSize(BlkBitWidth, BlkLen);
+    *QuantBScaleSize = N * BlockCountK;
+    *QuantBZeroPointSizeInBytes = N * MlasQNBitZeroPointsPerColumn(BlkBitWidth, BlockCountK);
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+int32_t
+MlasQNBitElement(
+    const uint8_t* Data,
+    size_t i
+    )
+{
+    if (BlkBitWidth == 4) {
+        return (Data[i / 2] >> (4 * (i & 1))) & 0x0F;
+    } else {
+        return Data[i];
+    }
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+int32_t
+MlasQNBitZeroPoint(
+    const uint8_t* ColumnZeroPoint,
+    size_t Block
+    )
+{
+    if (ColumnZeroPoint == nullptr) {
+        return 1 << (BlkBitWidth - 1);
+    }
+
+    return MlasQNBitElement<BlkBitWidth>(ColumnZeroPoint, Block);
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasQNBitDequantize4(
+    const uint8_t* BlkData,
+    size_t k,
+    MLAS_FLOAT32X4 Scale,
+    MLAS_FLOAT32X4 Offset
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes the four values of a block starting at k, which
+    is a multiple of four, as q * Scale + Offset, with Offset the negated
+    product of the zero point and the scale.
+
+--*/
+{
+    int32_t Values[4];
+
+    if (BlkBitWidth == 4) {
+        const uint8_t b0 = BlkData[k / 2];
+        const uint8_t b1 = BlkData[k / 2 + 1];
+        Values[0] = b0 & 0x0F;
+        Values[1] = b0 >> 4;
+        Values[2] = b1 & 0x0F;
+        Values[3] = b1 >> 4;
+    } else {
+        Values[0] = BlkData[k];
+        Values[1] = BlkData[k + 1];
+        Values[2] = BlkData[k + 2];
+        Values[3] = BlkData[k + 3];
+    }
+
+    const MLAS_FLOAT32X4 q = MlasCastToFloat32x4(MlasLoadInt32x4(Values));
+
+    return MlasMultiplyAddFloat32x4(q, Scale, Offset);
+}
+
+template<size_t BlkBitWidth>
+void
+MlasQNBitGemmColumnKernel(
+    size_t BlkLen,
+    size_t K,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    const uint8_t* ColumnData,
+    const float* ColumnScale,
+    const uint8_t* ColumnZeroPoint,
+    float Bias,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies rows of matrix A with a quantized column of matrix
+    B, dequantizing the blocks of the column into registers, and stores the
+    result in the column of the rows of matrix C.
+
+Arguments:
+
+    BlkLen - Supplies the number of values of a block.
+
+    K - Supplies the number of columns of matrix A.
+
+    A - Supplies the address of the first row of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    CountM - Supplies the number of rows.
+
+    ColumnData - Supplies the address of the blocks of the column.
+
+    ColumnScale - Supplies the address of the scales of the blocks.
+
+    ColumnZeroPoint - Supplies the address of the zero points of the blocks,
+        else nullptr if the blocks are symmetric.
+
+    Bias - Supplies the value added to the column.
+
+    C - Supplies the address of the column in the first row of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlkDataSize = MlasQNBitBlkDataSize(BlkBitWidth, BlkLen);
+
+    while (CountM > 0) {
+
+        const size_t TileM = std::min(CountM, size_t(MLAS_QNBIT_GEMM_TILE_M));
+
+        //
+        // The rows past the end of the tile alias the first row, so that the
+        // loop reads valid memory, and their accumulators are discarded.
+        //
+
+        const float* a0 = A;
+        const float* a1 = (TileM > 1) ? A + lda : A;
+        const float* a2 = (TileM > 2) ? A + 2 * lda : A;
+        const float* a3 = (TileM > 3) ? A + 3 * lda : A;
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator2 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator3 = MlasZeroFloat32x4();
+
+        float Sum0 = 0.0f;
+        float Sum1 = 0.0f;
+        float Sum2 = 0.0f;
+        float Sum3 = 0.0f;
+
+        const uint8_t* BlkData = ColumnData;
+
+        for (size_t k0 = 0, Block = 0; k0 < K; k0 += BlkLen, Block++) {
+
+            const float BlkScale = ColumnScale[Block];
+            const float BlkOffset = -float(MlasQNBitZeroPoint<BlkBitWidth>(ColumnZeroPoint, Block)) * BlkScale;
+            const MLAS_FLOAT32X4 Scale = MlasBroadcastFloat32x4(BlkScale);
+            const MLAS_FLOAT32X4 Offset = MlasBroadcastFloat32x4(BlkOffset);
+            const size_t CountK = std::min(K - k0, BlkLen);
+
+            size_t k = 0;
+
+            for (; k + 4 <= CountK; k += 4) {
+
+                const MLAS_FLOAT32X4 b = MlasQNBitDequantize4<BlkBitWidth>(BlkData, k, Scale, Offset);
+
+                Accumulator0 = MlasMultiplyAddFloat32x4(b, MlasLoadFloat32x4(a0 + k0 + k), Accumulator0);
+                Accumulator1 = MlasMultiplyAddFloat32x4(b, MlasLoadFloat32x4(a1 + k0 + k), Accumulator1);
+                Accumulator2 = MlasMultiplyAddFloat32x4(b, MlasLoadFloat32x4(a2 + k0 + k), Accumulator2);
+                Accumulator3 = MlasMultiplyAddFloat32x4(b, MlasLoadFloat32x4(a3 + k0 + k), Accumulator3);
+            }
+
+            //
+            // Multiply the remaining values of the last block, which is
+            // partial when K isn't a multiple of four.
+            //
+
+            for (; k < CountK; k++) {
+
+                const float b = float(MlasQNBitElement<BlkBitWidth>(BlkData, k)) * BlkScale + BlkOffset;
+
+                Sum0 += b * a0[k0 + k];
+                Sum1 += b * a1[k0 + k];
+                Sum2 += b * a2[k0 + k];
+                Sum3 += b * a3[k0 + k];
+            }
+
+            BlkData += BlkDataSize;
+        }
+
+        C[0] = MlasReduceAddFloat32x4(Accumulator0) + Sum0 + Bias;
+        if (TileM > 1) {
+            C[ldc] = MlasReduceAddFloat32x4(Accumulator1) + Sum1 + Bias;
+        }
+        if (TileM > 2) {
+            C[2 * ldc] = MlasReduceAddFloat32x4(Accumulator2) + Sum2 + Bias;
+        }
+        if (TileM > 3) {
+            C[3 * ldc] = MlasReduceAddFloat32x4(Accumulator3) + Sum3 + Bias;
+        }
+
+        A += TileM * lda;
+        C += TileM * ldc;
+        CountM -= TileM;
+    }
+}
+
+template<size_t BlkBitWidth>
+void
+MlasQNBitDequantizeColumn(
+    size_t BlkLen,
+    size_t k0,
+    size_t CountK,
+    const uint8_t* ColumnData,
+    const float* ColumnScale,
+    const uint8_t* ColumnZeroPoint,
+    float* Column
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes CountK values of a column of matrix B starting
+    at row k0, which is a multiple of BlkLen, to contiguous values.
+
+--*/
+{
+    const size_t BlkDataSize = MlasQNBitBlkDataSize(BlkBitWidth, BlkLen);
+
+    size_t Block = k0 / BlkLen;
+    const uint8_t* BlkData = ColumnData + Block * BlkDataSize;
+
+    for (size_t k1 = 0; k1 < CountK; k1 += BlkLen, Block++) {
+
+        const float BlkScale = ColumnScale[Block];
+        const float BlkOffset = -float(MlasQNBitZeroPoint<BlkBitWidth>(ColumnZeroPoint, Block)) * BlkScale;
+        const MLAS_FLOAT32X4 Scale = MlasBroadcastFloat32x4(BlkScale);
+        const MLAS_FLOAT32X4 Offset = MlasBroadcastFloat32x4(BlkOffset);
+        const size_t BlkCountK = std::min(CountK - k1, BlkLen);
+
+        size_t k = 0;
+
+        for (; k + 4 <= BlkCountK; k += 4) {
+            MlasStoreFloat32x4(Column + k1 + k, MlasQNBitDequantize4<BlkBitWidth>(BlkData, k, Scale, Offset));
+        }
+
+        for (; k < BlkCountK; k++) {
+            Column[k1 + k] = float(MlasQNBitElement<BlkBitWidth>(BlkData, k)) * BlkScale + BlkOffset;
+        }
+
+        BlkData += BlkDataSize;
+    }
+}
+
+struct MLAS_QNBIT_GEMM_WORK_BLOCK {
+    size_t BlkBitWidth;
+    size_t BlkLen;
+    size_t M;
+    size_t N;
+    size_t K;
+    const float* A;
+    size_t lda;
+    const uint8_t* QuantBData;
+    const float* QuantBScale;
+    const uint8_t* QuantBZeroPoint;
+    const float* Bias;
+    float* C;
+    size_t ldc;
+    int32_t ThreadCount;
+};
+
+template<size_t BlkBitWidth>
+void
+MlasQNBitGemmOperation(
+    const MLAS_QNBIT_GEMM_WORK_BLOCK* WorkBlock,
+    size_t FirstColumn,
+    size_t LastColumn
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the columns of matrix C from FirstColumn up to
+    LastColumn.
+
+--*/
+{
+    const size_t BlkLen = WorkBlock->BlkLen;
+    const size_t M = WorkBlock->M;
+    const size_t K = WorkBlock->K;
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ColumnDataSize = BlockCountK * MlasQNBitBlkDataSize(BlkBitWidth, BlkLen);
+    const size_t ColumnZeroPointSize = MlasQNBitZeroPointsPerColumn(BlkBitWidth, BlockCountK);
+
+    auto ColumnZeroPoint = [&](size_t n) -> const uint8_t* {
+        return (WorkBlock->QuantBZeroPoint != nullptr) ? WorkBlock->QuantBZeroPoint + n * ColumnZeroPointSize
+                                                       : nullptr;
+    };
+
+    if (M < MLAS_QNBIT_GEMM_SGEMM_THRESHOLD_M) {
+
+        for (size_t n = FirstColumn; n < LastColumn; n++) {
+            MlasQNBitGemmColumnKernel<BlkBitWidth>(BlkLen, K, WorkBlock->A, WorkBlock->lda, M,
+                WorkBlock->QuantBData + n * ColumnDataSize, WorkBlock->QuantBScale + n * BlockCountK,
+                ColumnZeroPoint(n), (WorkBlock->Bias != nullptr) ? WorkBlock->Bias[n] : 0.0f,
+                WorkBlock->C + n, WorkBlock->ldc);
+        }
+
+        return;
+    }
+
+    //
+    // Dequantize the strip of columns a panel of rows of matrix B at a time
+    // to the rows of a buffer, which is the transposed matrix B of a multiply
+    // accumulated to matrix C. The panel is a multiple of the block length.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_QNBIT_GEMM_STRIDEN * MLAS_QNBIT_GEMM_STRIDEK], 16 * sizeof(float));
+
+    const size_t CountN = LastColumn - FirstColumn;
+    float* C = WorkBlock->C + FirstColumn;
+    const size_t ldc = WorkBlock->ldc;
+
+    for (size_t k0 = 0; k0 < K; k0 += MLAS_QNBIT_GEMM_STRIDEK) {
+
+        const size_t CountK = std::min(K - k0, size_t(MLAS_QNBIT_GEMM_STRIDEK));
+
+        for (size_t n = FirstColumn; n < LastColumn; n++) {
+            MlasQNBitDequantizeColumn<BlkBitWidth>(BlkLen, k0, CountK, WorkBlock->QuantBData + n * ColumnDataSize,
+                WorkBlock->QuantBScale + n * BlockCountK, ColumnZeroPoint(n), PanelB + (n - FirstColumn) * CountK);
+        }
+
+        MlasGemm(CblasNoTrans, CblasTrans, M, CountN, CountK, 1.0f, WorkBlock->A + k0, WorkBlock->lda, PanelB,
+            CountK, (k0 == 0) ? 0.0f : 1.0f, C, ldc, nullptr);
+    }
+
+    if (WorkBlock->Bias != nullptr) {
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < CountN; n++) {
+                C[m * ldc + n] += WorkBlock->Bias[FirstColumn + n];
+            }
+        }
+    }
+}
+
+void
+MlasQNBitGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    blockwise quantized GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_QNBIT_GEMM_WORK_BLOCK*)Context;
+
+    const size_t N = WorkBlock->N;
+
+    //
+    // Partition the strips of columns to the threads.
+    //
+
+    const size_t BlockCountN = (N + MLAS_QNBIT_GEMM_STRIDEN - 1) / MLAS_QNBIT_GEMM_STRIDEN;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, BlockCountN, &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t FirstColumn = WorkIndex * MLAS_QNBIT_GEMM_STRIDEN;
+        const size_t LastColumn = std::min(N, FirstColumn + MLAS_QNBIT_GEMM_STRIDEN);
+
+        if (WorkBlock->BlkBitWidth == 4) {
+            MlasQNBitGemmOperation<4>(WorkBlock, FirstColumn, LastColumn);
+        } else {
+            MlasQNBitGemmOperation<8>(WorkBlock, FirstColumn, LastColumn);
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasBlockwiseQuantizedGemm(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    const float* Bias,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation C = A * B + Bias with a matrix B quantized blockwise, as
+    produced by MlasQuantizeBlockwise.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits of a quantized value.
+
+    BlkLen - Supplies the number of values of a block.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A, which isn't transposed.
+
+    lda - Supplies the first dimension of matrix A.
+
+    QuantBData - Supplies the address of the quantized values of matrix B.
+
+    QuantBScale - Supplies the address of the scales of the blocks.
+
+    QuantBZeroPoint - Supplies the address of the zero points of the blocks,
+        else nullptr if the blocks are symmetric around 2^(BlkBitWidth - 1).
+
+    Bias - Supplies the address of the N values added to each row of matrix C,
+        else nullptr.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    MLAS_QNBIT_GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.BlkBitWidth = BlkBitWidth;
+    WorkBlock.BlkLen = BlkLen;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.QuantBData = QuantBData;
+    WorkBlock.QuantBScale = QuantBScale;
+    WorkBlock.QuantBZeroPoint = QuantBZeroPoint;
+    WorkBlock.Bias = Bias;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    //
+    // Compute the number of target threads given the number of
+    // multiply-accumulates, limited to the number of strips of columns.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+    const size_t BlockCountN = (N + MLAS_QNBIT_GEMM_STRIDEN - 1) / MLAS_QNBIT_GEMM_STRIDEN;
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (Complexity < double(MLAS_QNBIT_GEMM_THREAD_COMPLEXITY * ThreadCount)) {
+        ThreadCount = int32_t(Complexity / double(MLAS_QNBIT_GEMM_THREAD_COMPLEXITY)) + 1;
+    }
+
+    if (size_t(ThreadCount) > BlockCountN) {
+        ThreadCount = int32_t(BlockCountN);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasQNBitGemmThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasQuantizeBlockwise(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    size_t N,
+    size_t K,
+    bool Symmetric,
+    uint8_t* QuantBData,
+    float* QuantBScale,
+    uint8_t* QuantBZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes the blocks of the columns of matrix B. The buffers
+    have the sizes returned by MlasBlockwiseQuantizedBufferSizes.
+
+Arguments:
+
+    BlkBitWidth - Supplies the number of bits of a quantized value.
+
+    BlkLen - Supplies the number of values of a block.
+
+    B - Supplies the address of matrix B, which isn't transposed.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    Symmetric - Supplies true to quantize the blocks symmetrically around the
+        zero point 2^(BlkBitWidth - 1), so that no zero points are stored,
+        else the blocks are quantized over the range of their values.
+
+    QuantBData - Supplies the address of the quantized values.
+
+    QuantBScale - Supplies the address of the scales of the blocks.
+
+    QuantBZeroPoint - Supplies the address of the zero points of the blocks,
+        which is unused and may be nullptr if Symmetric is true.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t BlkDataSize = MlasQNBitBlkDataSize(BlkBitWidth, BlkLen);
+    const size_t ColumnZeroPointSize = MlasQNBitZeroPointsPerColumn(BlkBitWidth, BlockCountK);
+    const int32_t QuantMax = (1 << BlkBitWidth) - 1;
+    const int32_t SymmetricZeroPoint = 1 << (BlkBitWidth - 1);
+
+    std::fill_n(QuantBData, N * BlockCountK * BlkDataSize, uint8_t(0));
+
+    if (!Symmetric) {
+        std::fill_n(QuantBZeroPoint, N * ColumnZeroPointSize, uint8_t(0));
+    }
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t Block = 0; Block < BlockCountK; Block++) {
+
+            const size_t k0 = Block * BlkLen;
+            const size_t CountK = std::min(K - k0, BlkLen);
+
+            float Scale;
+            int32_t ZeroPoint;
+
+            if (Symmetric) {
+
+                //
+                // Map the value of the largest magnitude to the quantized
+                // value of the largest magnitude, -2^(BlkBitWidth - 1).
+                //
+
+                float AbsMax = 0.0f;
+                float SignedMax = 0.0f;
+
+                for (size_t k = 0; k < CountK; k++) {
+                    const float Value = B[(k0 + k) * ldb + n];
+                    if (std::fabs(Value) > AbsMax) {
+                        AbsMax = std::fabs(Value);
+                        SignedMax = Value;
+                    }
+                }
+
+                Scale = SignedMax / -float(SymmetricZeroPoint);
+                ZeroPoint = SymmetricZeroPoint;
+
+            } else {
+
+                //
+                // The range always contains zero, so that zero is exactly
+                // representable.
+                //
+
+                float Min = 0.0f;
+                float Max = 0.0f;
+
+                for (size_t k = 0; k < CountK; k++) {
+                    const float Value = B[(k0 + k) * ldb + n];
+                    Min = std::min(Min, Value);
+                    Max = std::max(Max, Value);
+                }
+
+                Scale = (Max - Min) / float(QuantMax);
+                ZeroPoint = (Scale != 0.0f) ?
+                    std::min(std::max(int32_t(std::nearbyint(-Min / Scale)), 0), QuantMax) : SymmetricZeroPoint;
+
+                uint8_t* ZeroPointBytes = QuantBZeroPoint + n * ColumnZeroPointSize;
+
+                if (BlkBitWidth == 4) {
+                    ZeroPointBytes[Block / 2] |= uint8_t(ZeroPoint << (4 * (Block & 1)));
+                } else {
+                    ZeroPointBytes[Block] = uint8_t(ZeroPoint);
+                }
+            }
+
+            QuantBScale[n * BlockCountK + Block] = Scale;
+
+            const float ReciprocalScale = (Scale != 0.0f) ? 1.0f / Scale : 0.0f;
+            uint8_t* BlkData = QuantBData + (n * BlockCountK + Block) * BlkDataSize;
+
+            //
+            // Pad the last block of the column with the zero point.
+            //
+
+            for (size_t k = 0; k < BlkLen; k++) {
+
+                int32_t q = ZeroPoint;
+
+                if (k < CountK) {
+                    q += int32_t(std::nearbyint(B[(k0 + k) * ldb + n] * ReciprocalScale));
+                    q = std::min(std::max(q, 0), QuantMax);
+                }
+
+                if (BlkBitWidth == 4) {
+                    BlkData[k / 2] |= uint8_t(q << (4 * (k & 1)));
+                } else {
+                    BlkData[k] = uint8_t(q);
+                }
+            }
+        }
+    }
+}
@@ -48,6 +48,8 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const MLAS_ACTIVATION* Activation;
+    const float* Bias;
 };
 
 void
@@ -765,7 +767,9 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias
     )
 /*++
 
@@ -801,6 +805,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Activation - Supplies the optional activation to apply to the rows of
+        matrix C after the kernel has computed them, with the optional bias
+        vector. This is only supplied for the last slice along the K dimension,
+        so that each block of rows is activated while it is in the cache.
+
+    Bias - Supplies the optional bias vector, with an element per row of
+        matrix C.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -823,6 +835,15 @@ Return Value:
         }
 #endif
 
+        if (Activation != nullptr) {
+
+            MlasActivation(Activation, C, Bias, RowsHandled, CountN, ldc);
+
+            if (Bias != nullptr) {
+                Bias += RowsHandled;
+            }
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -846,7 +867,9 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias
     )
 /*++
 
@@ -884,6 +907,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Activation - Supplies the optional activation to apply to matrix C, else
+        nullptr.
+
+    Bias - Supplies the optional bias vector to add to the rows of matrix C
+        with the activation, else nullptr.
+
 Return Value:
 
     None.
@@ -913,6 +942,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Activation != nullptr) {
+                MlasActivation(Activation, C, Bias, 1, N, ldc);
+            }
             return;
         }
 
@@ -920,6 +952,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Activation != nullptr) {
+                MlasActivation(Activation, C, Bias, 1, N, ldc);
+            }
             return;
         }
 
@@ -948,6 +983,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Activation != nullptr) {
+                MlasActivation(Activation, C, Bias, M, 1, ldc);
+            }
             return;
         }
 
@@ -1026,9 +1064,18 @@ Return Value:
 
             float* c = C + n;
 
+            //
+            // Apply the activation as the rows are completed by the last
+            // slice along the K dimension.
+            //
+
+            const MLAS_ACTIVATION* activation = (k + CountK == K) ? Activation : nullptr;
+            const float* bias = Bias;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    activation, bias);
 
             } else {
 
@@ -1052,7 +1099,12 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        activation, bias);
+
+                    if (bias != nullptr) {
+                        bias += RowsTransposed;
+                    }
 
                 } while (RowsRemaining > 0);
             }
@@ -1076,7 +1128,9 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias
     )
 /*++
 
@@ -1116,6 +1170,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Activation - Supplies the optional activation to apply to matrix C, else
+        nullptr.
+
+    Bias - Supplies the optional bias vector to add to the rows of matrix C
+        with the activation, else nullptr.
+
 Return Value:
 
     None.
@@ -1162,9 +1222,18 @@ Return Value:
             const float* pb = (const float*)PackedB + AlignedN * k + CountK * SliceStartN;
             float* c = C + n;
 
+            //
+            // Apply the activation as the rows are completed by the last
+            // slice along the K dimension.
+            //
+
+            const MLAS_ACTIVATION* activation = (k + CountK == K) ? Activation : nullptr;
+            const float* bias = Bias;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    activation, bias);
 
             } else {
 
@@ -1188,7 +1257,12 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        activation, bias);
+
+                    if (bias != nullptr) {
+                        bias += RowsTransposed;
+                    }
 
                 } while (RowsRemaining > 0);
             }
@@ -1270,6 +1344,7 @@ Return Value:
 
     const float* A = WorkBlock->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
     float* C = WorkBlock->C + RangeStartM * ldc + RangeStartN;
+    const float* Bias = (WorkBlock->Bias != nullptr) ? WorkBlock->Bias + RangeStartM : nullptr;
 
     if (WorkBlock->B != nullptr) {
 
@@ -1280,13 +1355,15 @@ Return Value:
         const float* B = WorkBlock->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, WorkBlock->K,
-            WorkBlock->alpha, A, lda, B, ldb, WorkBlock->beta, C, ldc);
+            WorkBlock->alpha, A, lda, B, ldb, WorkBlock->beta, C, ldc, WorkBlock->Activation,
+            Bias);
 
     } else {
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             WorkBlock->K, WorkBlock->alpha, A, lda, WorkBlock->PackedB,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, WorkBlock->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, WorkBlock->beta, C, ldc,
+            WorkBlock->Activation, Bias);
     }
 }
 
@@ -1388,6 +1465,8 @@ MlasGemm(
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1426,6 +1505,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Activation - Supplies the optional activation to apply to matrix C, else
+        nullptr. Each block of matrix C is activated as it is completed.
+
+    Bias - Supplies the optional bias vector to add to the rows of matrix C
+        with the activation, else nullptr.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1456,6 +1541,8 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.Activation = Activation;
+    WorkBlock.Bias = Bias;
 
     //
     // Schedule the operation across a set of worker threads.
@@ -1478,6 +1565,8 @@ MlasGemm(
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_ACTIVATION* Activation,
+    const float* Bias,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1512,6 +1601,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Activation - Supplies the optional activation to apply to matrix C, else
+        nullptr. Each block of matrix C is activated as it is completed.
+
+    Bias - Supplies the optional bias vector to add to the rows of matrix C
+        with the activation, else nullptr.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1540,6 +1635,8 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.Activation = Activation;
+    WorkBlock.Bias = Bias;
 
     //
     // Schedule the operation across a set of worker threads.
@@ -1548,6 +1645,80 @@ Return Value:
     MlasSgemmSchedule(&WorkBlock, ThreadPool);
 }
 
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) without an activation.
+
+Arguments:
+
+    See the above routine.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a packed matrix B and without an activation.
+
+Arguments:
+
+    See the above routine.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, nullptr, nullptr, ThreadPool);
+}
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -1511,6 +1511,428 @@ Return Value:
     }
 }
 
+struct MLAS_NCHWC_SCALE_CHANNELS_WORK_BLOCK {
+    int32_t ThreadCount;
+    size_t ChannelBlockCount;
+    size_t TotalChannelBlockCount;
+    size_t SpatialCount;
+    bool BroadcastBatch;
+    const float* Input;
+    const float* Scale;
+    float* Output;
+};
+
+void
+MlasNchwcScaleChannelsThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc scale channels operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NCHWC_SCALE_CHANNELS_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t SpatialCount = WorkBlock->SpatialCount;
+
+    //
+    // Partition the blocks of channels from all of the batches to the threads.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->TotalChannelBlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    const float* Input = WorkBlock->Input + WorkIndex * SpatialCount * BlockSize;
+    float* Output = WorkBlock->Output + WorkIndex * SpatialCount * BlockSize;
+
+    for (size_t cb = WorkIndex; cb < WorkIndex + WorkRemaining; cb++) {
+
+        //
+        // The scale tensor has a single spatial element, so the block of
+        // scales for this block of channels is used for every spatial element.
+        //
+
+        const size_t ScaleIndex = WorkBlock->BroadcastBatch ? (cb % WorkBlock->ChannelBlockCount) : cb;
+        const float* Scale = WorkBlock->Scale + ScaleIndex * BlockSize;
+
+        for (size_t bs = 0; bs < BlockSize; bs += 8) {
+
+            MLAS_FLOAT32X4 Scale0 = MlasLoadFloat32x4(Scale + bs);
+            MLAS_FLOAT32X4 Scale1 = MlasLoadFloat32x4(Scale + bs + 4);
+
+            for (size_t i = 0; i < SpatialCount; i++) {
+
+                const size_t Offset = i * BlockSize + bs;
+
+                MLAS_FLOAT32X4 v0 = MlasLoadFloat32x4(Input + Offset);
+                MLAS_FLOAT32X4 v1 = MlasLoadFloat32x4(Input + Offset + 4);
+
+                MlasStoreFloat32x4(Output + Offset, MlasMultiplyFloat32x4(v0, Scale0));
+                MlasStoreFloat32x4(Output + Offset + 4, MlasMultiplyFloat32x4(v1, Scale1));
+            }
+        }
+
+        Input += SpatialCount * BlockSize;
+        Output += SpatialCount * BlockSize;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcScaleChannels(
+    const int64_t* InputShape,
+    const float* Input,
+    const float* Scale,
+    bool BroadcastBatch,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies each channel of the NCHWc input tensor by the
+    corresponding element of the NCHWc scale tensor, which has a single spatial
+    element. This implements the channel attention of a squeeze and excite
+    block.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Input - Supplies the input tensor.
+
+    Scale - Supplies the scale tensor with a shape of (N, C, 1, 1) or
+        (1, C, 1, 1).
+
+    BroadcastBatch - Supplies true if the scale tensor has a single batch that
+        is used for all of the batches of the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t ChannelCount = size_t(InputShape[1]);
+    const size_t SpatialCount = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    MLAS_NCHWC_SCALE_CHANNELS_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ChannelBlockCount = ChannelCount / BlockSize;
+    WorkBlock.TotalChannelBlockCount = BatchCount * WorkBlock.ChannelBlockCount;
+    WorkBlock.SpatialCount = SpatialCount;
+    WorkBlock.BroadcastBatch = BroadcastBatch;
+    WorkBlock.Input = Input;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Output = Output;
+
+    //
+    // Limit the number of threads to the number of blocks of channels and try
+    // to keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > WorkBlock.TotalChannelBlockCount) {
+        ThreadCount = int32_t(WorkBlock.TotalChannelBlockCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((BatchCount * ChannelCount * SpatialCount) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    if (ThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasNchwcScaleChannelsThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
+
+struct MLAS_NCHWC_INSTANCE_NORM_WORK_BLOCK {
+    int32_t ThreadCount;
+    size_t ChannelBlockCount;
+    size_t TotalChannelBlockCount;
+    size_t SpatialCount;
+    const float* Input;
+    const float* Scale;
+    const float* Bias;
+    float* Output;
+    float Epsilon;
+    const MLAS_ACTIVATION* Activation;
+};
+
+void
+MlasNchwcInstanceNormalizationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc instance normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NCHWC_INSTANCE_NORM_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t SpatialCount = WorkBlock->SpatialCount;
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    //
+    // Partition the blocks of channels from all of the batches to the threads.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->TotalChannelBlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    const float* Input = WorkBlock->Input + WorkIndex * SpatialCount * BlockSize;
+    float* Output = WorkBlock->Output + WorkIndex * SpatialCount * BlockSize;
+
+    for (size_t cb = WorkIndex; cb < WorkIndex + WorkRemaining; cb++) {
+
+        const size_t ChannelIndex = (cb % WorkBlock->ChannelBlockCount) * BlockSize;
+
+        for (size_t bs = 0; bs < BlockSize; bs += 8) {
+
+            //
+            // Accumulate the sum and the sum of squares of the eight channels
+            // in a single pass. The values are accumulated relative to the
+            // first spatial element to avoid the loss of precision from
+            // subtracting the square of a large mean from the mean of the
+            // squares.
+            //
+
+            MLAS_FLOAT32X4 Offset0 = MlasLoadFloat32x4(Input + bs);
+            MLAS_FLOAT32X4 Offset1 = MlasLoadFloat32x4(Input + bs + 4);
+            MLAS_FLOAT32X4 Sum0 = ZeroFloat32x4;
+            MLAS_FLOAT32X4 Sum1 = ZeroFloat32x4;
+            MLAS_FLOAT32X4 SumSquares0 = ZeroFloat32x4;
+            MLAS_FLOAT32X4 SumSquares1 = ZeroFloat32x4;
+
+            for (size_t i = 0; i < SpatialCount; i++) {
+
+                const size_t Offset = i * BlockSize + bs;
+
+                MLAS_FLOAT32X4 v0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + Offset), Offset0);
+                MLAS_FLOAT32X4 v1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + Offset + 4), Offset1);
+
+                Sum0 = MlasAddFloat32x4(Sum0, v0);
+                Sum1 = MlasAddFloat32x4(Sum1, v1);
+                SumSquares0 = MlasMultiplyAddFloat32x4(v0, v0, SumSquares0);
+                SumSquares1 = MlasMultiplyAddFloat32x4(v1, v1, SumSquares1);
+            }
+
+            //
+            // Fold the mean and the variance of each channel into the scale
+            // and the shift of the channel.
+            //
+
+            MLAS_DECLSPEC_ALIGN(float Offsets[8], 16);
+            MLAS_DECLSPEC_ALIGN(float Sums[8], 16);
+            MLAS_DECLSPEC_ALIGN(float SumSquares[8], 16);
+            MLAS_DECLSPEC_ALIGN(float Scales[8], 16);
+            MLAS_DECLSPEC_ALIGN(float Shifts[8], 16);
+
+            MlasStoreAlignedFloat32x4(Offsets, Offset0);
+            MlasStoreAlignedFloat32x4(Offsets + 4, Offset1);
+            MlasStoreAlignedFloat32x4(Sums, Sum0);
+            MlasStoreAlignedFloat32x4(Sums + 4, Sum1);
+            MlasStoreAlignedFloat32x4(SumSquares, SumSquares0);
+            MlasStoreAlignedFloat32x4(SumSquares + 4, SumSquares1);
+
+            for (size_t n = 0; n < 8; n++) {
+
+                const float MeanOffset = Sums[n] / SpatialCount;
+                const float Variance = std::max(SumSquares[n] / SpatialCount - MeanOffset * MeanOffset, 0.0f);
+                const float Scale = WorkBlock->Scale[ChannelIndex + bs + n] / std::sqrt(Variance + WorkBlock->Epsilon);
+
+                Scales[n] = Scale;
+                Shifts[n] = WorkBlock->Bias[ChannelIndex + bs + n] - (MeanOffset + Offsets[n]) * Scale;
+            }
+
+            MLAS_FLOAT32X4 Scale0 = MlasLoadFloat32x4(Scales);
+            MLAS_FLOAT32X4 Scale1 = MlasLoadFloat32x4(Scales + 4);
+            MLAS_FLOAT32X4 Shift0 = MlasLoadFloat32x4(Shifts);
+            MLAS_FLOAT32X4 Shift1 = MlasLoadFloat32x4(Shifts + 4);
+
+            for (size_t i = 0; i < SpatialCount; i++) {
+
+                const size_t Offset = i * BlockSize + bs;
+
+                MLAS_FLOAT32X4 v0 = MlasLoadFloat32x4(Input + Offset);
+                MLAS_FLOAT32X4 v1 = MlasLoadFloat32x4(Input + Offset + 4);
+
+                MlasStoreFloat32x4(Output + Offset, MlasMultiplyAddFloat32x4(v0, Scale0, Shift0));
+                MlasStoreFloat32x4(Output + Offset + 4, MlasMultiplyAddFloat32x4(v1, Scale1, Shift1));
+            }
+        }
+
+        //
+        // Apply the activation to the block of channels while it is still in
+        // the cache.
+        //
+
+        MlasActivation(WorkBlock->Activation, Output, nullptr, 1, SpatialCount * BlockSize, SpatialCount * BlockSize);
+
+        Input += SpatialCount * BlockSize;
+        Output += SpatialCount * BlockSize;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcInstanceNormalization(
+    const int64_t* InputShape,
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float Epsilon,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes each channel of each batch of the NCHWc input
+    tensor by its own mean and variance and then applies the activation. The
+    mean and the variance are computed in a single pass over the channel.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Input - Supplies the input tensor.
+
+    Scale - Supplies the scale of each channel, padded to the number of
+        channels of the input tensor.
+
+    Bias - Supplies the shift of each channel, padded to the number of
+        channels of the input tensor.
+
+    Output - Supplies the output tensor.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        output.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t ChannelCount = size_t(InputShape[1]);
+    const size_t SpatialCount = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    if (SpatialCount == 0) {
+        return;
+    }
+
+    MLAS_NCHWC_INSTANCE_NORM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ChannelBlockCount = ChannelCount / BlockSize;
+    WorkBlock.TotalChannelBlockCount = BatchCount * WorkBlock.ChannelBlockCount;
+    WorkBlock.SpatialCount = SpatialCount;
+    WorkBlock.Input = Input;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Activation = Activation;
+
+    //
+    // Limit the number of threads to the number of blocks of channels and try
+    // to keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > WorkBlock.TotalChannelBlockCount) {
+        ThreadCount = int32_t(WorkBlock.TotalChannelBlockCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((BatchCount * ChannelCount * SpatialCount) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    if (ThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasNchwcInstanceNormalizationThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
+
 #if !defined(MLAS_TARGET_AMD64)
 
 //
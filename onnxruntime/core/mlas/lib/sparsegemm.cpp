@@ -0,0 +1,577 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparsegemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a sparse matrix B, e.g. the pruned weights of a model.
+
+    Matrix B is split into stripes of MLAS_SPARSE_GEMM_BLOCK_N columns. The
+    packed buffer stores, for each stripe, the rows of the stripe that have a
+    non-zero value as blocks of MLAS_SPARSE_GEMM_BLOCK_N values together with
+    their row index. A tile of rows of matrix A is multiplied with a stripe by
+    accumulating the blocks of the stripe, each scaled by the elements of the
+    rows of A in the column given by its row index, so the blocks of zeros are
+    skipped entirely.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows of matrix A multiplied at a time with a stripe,
+// and the number of rows and stripes of a work item of a thread.
+//
+
+#define MLAS_SPARSE_GEMM_TILE_M                     4
+#define MLAS_SPARSE_GEMM_STRIDEM                    16
+#define MLAS_SPARSE_GEMM_STRIDE_STRIPES             16
+
+//
+// Define the number of multiply-accumulates per thread.
+//
+
+#define MLAS_SPARSE_GEMM_THREAD_COMPLEXITY          (64 * 1024)
+
+static_assert(MLAS_SPARSE_GEMM_BLOCK_N == 4, "The stripes are multiplied as MLAS_FLOAT32X4 vectors");
+
+//
+// The packed matrix B starts with this header, followed by the offset of the
+// first block of each stripe and the offset past the last block, the values of
+// the blocks and the row index of each block.
+//
+
+struct MLAS_SPARSE_GEMM_PACKED_HEADER {
+    size_t N;
+    size_t K;
+    size_t NonZeroBlocks;
+};
+
+struct MLAS_SPARSE_GEMM_PACKED_B {
+    size_t N;
+    size_t K;
+    size_t StripeCount;
+    const size_t* StripeOffsets;
+    const float* Values;
+    const uint32_t* RowIndices;
+};
+
+MLAS_FORCEINLINE
+size_t
+MlasSparseGemmStripeCount(
+    size_t N
+    )
+{
+    return (N + MLAS_SPARSE_GEMM_BLOCK_N - 1) / MLAS_SPARSE_GEMM_BLOCK_N;
+}
+
+MLAS_FORCEINLINE
+float
+MlasSparseGemmElementB(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    return (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+}
+
+MLAS_FORCEINLINE
+bool
+MlasSparseGemmIsZeroBlock(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    const size_t CountN = std::min(N - n, size_t(MLAS_SPARSE_GEMM_BLOCK_N));
+
+    for (size_t i = 0; i < CountN; i++) {
+        if (MlasSparseGemmElementB(TransB, B, ldb, k, n + i) != 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t
+MLASCALL
+MlasSparseGemmCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine counts the blocks of matrix B that have a non-zero value. The
+    sparsity of the blocks of matrix B is one minus the ratio of this count to
+    K * ceil(N / MLAS_SPARSE_GEMM_BLOCK_N).
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the number of non-zero blocks.
+
+--*/
+{
+    size_t NonZeroBlocks = 0;
+
+    for (size_t n = 0; n < N; n += MLAS_SPARSE_GEMM_BLOCK_N) {
+        for (size_t k = 0; k < K; k++) {
+            if (!MlasSparseGemmIsZeroBlock(TransB, N, B, ldb, k, n)) {
+                NonZeroBlocks++;
+            }
+        }
+    }
+
+    return NonZeroBlocks;
+}
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    size_t N,
+    size_t K,
+    size_t NonZeroBlocks
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the size of the buffer for the packed matrix B.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B, which must be less than
+        2^32.
+
+    NonZeroBlocks - Supplies the number of non-zero blocks of matrix B, as
+        returned by MlasSparseGemmCountBlocks.
+
+Return Value:
+
+    Returns the size in bytes of the packed matrix B.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    return sizeof(MLAS_SPARSE_GEMM_PACKED_HEADER) +
+        (MlasSparseGemmStripeCount(N) + 1) * sizeof(size_t) +
+        NonZeroBlocks * MLAS_SPARSE_GEMM_BLOCK_N * sizeof(float) +
+        NonZeroBlocks * sizeof(uint32_t);
+}
+
+MLAS_FORCEINLINE
+MLAS_SPARSE_GEMM_PACKED_B
+MlasSparseGemmUnpackHeader(
+    const void* PackedB
+    )
+{
+    const auto* Header = static_cast<const MLAS_SPARSE_GEMM_PACKED_HEADER*>(PackedB);
+
+    MLAS_SPARSE_GEMM_PACKED_B Packed;
+    Packed.N = Header->N;
+    Packed.K = Header->K;
+    Packed.StripeCount = MlasSparseGemmStripeCount(Header->N);
+    Packed.StripeOffsets = reinterpret_cast<const size_t*>(Header + 1);
+    Packed.Values = reinterpret_cast<const float*>(Packed.StripeOffsets + Packed.StripeCount + 1);
+    Packed.RowIndices = reinterpret_cast<const uint32_t*>(
+        Packed.Values + Header->NonZeroBlocks * MLAS_SPARSE_GEMM_BLOCK_N);
+    return Packed;
+}
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the non-zero blocks of matrix B. The buffer must be
+    MlasSparseGemmPackBSize bytes, and aligned for size_t.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    auto* Header = static_cast<MLAS_SPARSE_GEMM_PACKED_HEADER*>(PackedB);
+    Header->N = N;
+    Header->K = K;
+    Header->NonZeroBlocks = MlasSparseGemmCountBlocks(TransB, N, K, B, ldb);
+
+    const MLAS_SPARSE_GEMM_PACKED_B Packed = MlasSparseGemmUnpackHeader(PackedB);
+    auto* StripeOffsets = const_cast<size_t*>(Packed.StripeOffsets);
+    auto* Values = const_cast<float*>(Packed.Values);
+    auto* RowIndices = const_cast<uint32_t*>(Packed.RowIndices);
+
+    size_t Block = 0;
+
+    for (size_t Stripe = 0; Stripe < Packed.StripeCount; Stripe++) {
+
+        StripeOffsets[Stripe] = Block;
+
+        const size_t n = Stripe * MLAS_SPARSE_GEMM_BLOCK_N;
+        const size_t CountN = std::min(N - n, size_t(MLAS_SPARSE_GEMM_BLOCK_N));
+
+        for (size_t k = 0; k < K; k++) {
+
+            if (MlasSparseGemmIsZeroBlock(TransB, N, B, ldb, k, n)) {
+                continue;
+            }
+
+            //
+            // Pad the blocks of the last stripe with zeros.
+            //
+
+            float* BlockValues = Values + Block * MLAS_SPARSE_GEMM_BLOCK_N;
+
+            for (size_t i = 0; i < MLAS_SPARSE_GEMM_BLOCK_N; i++) {
+                BlockValues[i] = (i < CountN) ? MlasSparseGemmElementB(TransB, B, ldb, k, n + i) : 0.0f;
+            }
+
+            RowIndices[Block] = uint32_t(k);
+            Block++;
+        }
+    }
+
+    StripeOffsets[Packed.StripeCount] = Block;
+}
+
+MLAS_FORCEINLINE
+void
+MlasSparseGemmStoreBlock(
+    float* C,
+    MLAS_FLOAT32X4 Accumulator,
+    float alpha,
+    size_t CountN
+    )
+{
+    Accumulator = MlasMultiplyFloat32x4(Accumulator, MlasBroadcastFloat32x4(alpha));
+
+    if (CountN == MLAS_SPARSE_GEMM_BLOCK_N) {
+        MlasStoreFloat32x4(C, Accumulator);
+        return;
+    }
+
+    float Buffer[MLAS_SPARSE_GEMM_BLOCK_N];
+    MlasStoreFloat32x4(Buffer, Accumulator);
+
+    for (size_t i = 0; i < CountN; i++) {
+        C[i] = Buffer[i];
+    }
+}
+
+void
+MlasSparseGemmKernel(
+    const float* A,
+    size_t lda,
+    const MLAS_SPARSE_GEMM_PACKED_B& Packed,
+    size_t Stripe,
+    size_t CountM,
+    float alpha,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies rows of matrix A with a stripe of the packed
+    matrix B, and stores the result in the stripe of the rows of matrix C.
+
+Arguments:
+
+    A - Supplies the address of the first row of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    Packed - Supplies the packed matrix B.
+
+    Stripe - Supplies the index of the stripe.
+
+    CountM - Supplies the number of rows.
+
+    alpha - Supplies the scalar multiplier.
+
+    C - Supplies the address of the stripe in the first row of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t n = Stripe * MLAS_SPARSE_GEMM_BLOCK_N;
+    const size_t CountN = std::min(Packed.N - n, size_t(MLAS_SPARSE_GEMM_BLOCK_N));
+    const size_t FirstBlock = Packed.StripeOffsets[Stripe];
+    const size_t BlockCount = Packed.StripeOffsets[Stripe + 1] - FirstBlock;
+    const float* Values = Packed.Values + FirstBlock * MLAS_SPARSE_GEMM_BLOCK_N;
+    const uint32_t* RowIndices = Packed.RowIndices + FirstBlock;
+
+    while (CountM > 0) {
+
+        const size_t TileM = std::min(CountM, size_t(MLAS_SPARSE_GEMM_TILE_M));
+
+        //
+        // The rows past the end of the tile alias the first row, so that the
+        // loop reads valid memory, and their accumulators are discarded.
+        //
+
+        const float* a0 = A;
+        const float* a1 = (TileM > 1) ? A + lda : A;
+        const float* a2 = (TileM > 2) ? A + 2 * lda : A;
+        const float* a3 = (TileM > 3) ? A + 3 * lda : A;
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator2 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator3 = MlasZeroFloat32x4();
+
+        for (size_t b = 0; b < BlockCount; b++) {
+
+            const MLAS_FLOAT32X4 BlockB = MlasLoadFloat32x4(Values + b * MLAS_SPARSE_GEMM_BLOCK_N);
+            const size_t k = RowIndices[b];
+
+            Accumulator0 = MlasMultiplyAddFloat32x4(BlockB, a0[k], Accumulator0);
+            Accumulator1 = MlasMultiplyAddFloat32x4(BlockB, a1[k], Accumulator1);
+            Accumulator2 = MlasMultiplyAddFloat32x4(BlockB, a2[k], Accumulator2);
+            Accumulator3 = MlasMultiplyAddFloat32x4(BlockB, a3[k], Accumulator3);
+        }
+
+        MlasSparseGemmStoreBlock(C, Accumulator0, alpha, CountN);
+        if (TileM > 1) {
+            MlasSparseGemmStoreBlock(C + ldc, Accumulator1, alpha, CountN);
+        }
+        if (TileM > 2) {
+            MlasSparseGemmStoreBlock(C + 2 * ldc, Accumulator2, alpha, CountN);
+        }
+        if (TileM > 3) {
+            MlasSparseGemmStoreBlock(C + 3 * ldc, Accumulator3, alpha, CountN);
+        }
+
+        A += TileM * lda;
+        C += TileM * ldc;
+        CountM -= TileM;
+    }
+}
+
+struct MLAS_SPARSE_GEMM_WORK_BLOCK {
+    size_t M;
+    float alpha;
+    const float* A;
+    size_t lda;
+    MLAS_SPARSE_GEMM_PACKED_B Packed;
+    float* C;
+    size_t ldc;
+    size_t BlockCountN;
+    int32_t ThreadCount;
+};
+
+void
+MlasSparseGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    sparse GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SPARSE_GEMM_WORK_BLOCK*)Context;
+
+    const size_t M = WorkBlock->M;
+    const size_t StripeCount = WorkBlock->Packed.StripeCount;
+
+    //
+    // Partition the blocks of rows and stripes to the threads.
+    //
+
+    const size_t BlockCountM = (M + MLAS_SPARSE_GEMM_STRIDEM - 1) / MLAS_SPARSE_GEMM_STRIDEM;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, BlockCountM * WorkBlock->BlockCountN,
+        &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t m = (WorkIndex / WorkBlock->BlockCountN) * MLAS_SPARSE_GEMM_STRIDEM;
+        const size_t FirstStripe = (WorkIndex % WorkBlock->BlockCountN) * MLAS_SPARSE_GEMM_STRIDE_STRIPES;
+        const size_t CountM = std::min(M - m, size_t(MLAS_SPARSE_GEMM_STRIDEM));
+        const size_t LastStripe = std::min(StripeCount, FirstStripe + MLAS_SPARSE_GEMM_STRIDE_STRIPES);
+
+        for (size_t Stripe = FirstStripe; Stripe < LastStripe; Stripe++) {
+            MlasSparseGemmKernel(WorkBlock->A + m * WorkBlock->lda, WorkBlock->lda, WorkBlock->Packed, Stripe,
+                CountM, WorkBlock->alpha, WorkBlock->C + m * WorkBlock->ldc + Stripe * MLAS_SPARSE_GEMM_BLOCK_N,
+                WorkBlock->ldc);
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation C = alpha * A * B with a matrix B packed by MlasSparseGemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier.
+
+    A - Supplies the address of matrix A, which isn't transposed.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    MLAS_SPARSE_GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.M = M;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.Packed = MlasSparseGemmUnpackHeader(PackedB);
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.BlockCountN = (WorkBlock.Packed.StripeCount + MLAS_SPARSE_GEMM_STRIDE_STRIPES - 1) /
+        MLAS_SPARSE_GEMM_STRIDE_STRIPES;
+
+    //
+    // Compute the number of target threads given the number of non-zero
+    // multiply-accumulates, limited to the number of work items.
+    //
+
+    const size_t NonZeroBlocks = WorkBlock.Packed.StripeOffsets[WorkBlock.Packed.StripeCount];
+    const double Complexity = double(M) * double(NonZeroBlocks) * double(MLAS_SPARSE_GEMM_BLOCK_N);
+    const size_t BlockCount = ((M + MLAS_SPARSE_GEMM_STRIDEM - 1) / MLAS_SPARSE_GEMM_STRIDEM) *
+        WorkBlock.BlockCountN;
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (Complexity < double(MLAS_SPARSE_GEMM_THREAD_COMPLEXITY * ThreadCount)) {
+        ThreadCount = int32_t(Complexity / double(MLAS_SPARSE_GEMM_THREAD_COMPLEXITY)) + 1;
+    }
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasSparseGemmThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
@@ -12,11 +12,457 @@ Abstract:
 
     This module implements the transpose operation.
 
+    Matrices are transposed a register tile at a time by the kernels below.
+    Larger matrices are recursively split along their longer dimension until
+    a block fits in the first level cache, so that the rows of the input and
+    the output touched by a block stay resident whatever the shape of the
+    matrix.
+
+    Tensor transposes with arbitrary permutations are reduced to batches of
+    strided matrix transposes by dropping the unit dimensions and merging
+    the axes that stay adjacent in the output.
+
 --*/
 
 #include "mlasi.h"
 
-#ifdef MLAS_TARGET_AMD64_IX86
+//
+// Define the number of bytes of a block processed by the tiled loop. Blocks
+// larger than this are split in half along their longer dimension.
+//
+
+constexpr size_t MLAS_TRANSPOSE_BLOCK_BYTES = 16 * 1024;
+
+//
+// Define the maximum number of axes of a tensor transpose once the unit
+// dimensions have been dropped and the adjacent axes merged.
+//
+
+constexpr size_t MLAS_TRANSPOSE_MAXIMUM_RANK = 8;
+
+//
+// Define the minimum number of bytes to transpose per thread.
+//
+
+constexpr size_t MLAS_TRANSPOSE_MINIMUM_BYTES_PER_THREAD = 64 * 1024;
+
+//
+// Define the number of rows of a matrix partitioned to the threads as a unit,
+// which is a multiple of the size of every tile kernel.
+//
+
+constexpr size_t MLAS_TRANSPOSE_ROWS_PER_BLOCK = 8;
+
+//
+// Define the tile kernels which transpose a TileSize by TileSize block of the
+// input matrix to the output matrix.
+//
+
+template<typename ElementType>
+struct MLAS_TRANSPOSE_TILE_KERNEL;
+
+template<>
+struct MLAS_TRANSPOSE_TILE_KERNEL<uint8_t>
+{
+    static constexpr size_t TileSize = 8;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint8_t* Input,
+        size_t ldi,
+        uint8_t* Output,
+        size_t ldo
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        __m128i a0 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 0]);
+        __m128i a1 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 1]);
+        __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+
+        __m128i a2 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 2]);
+        __m128i a3 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 3]);
+        __m128i b1 = _mm_unpacklo_epi8(a2, a3);
+
+        __m128i a4 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 4]);
+        __m128i a5 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 5]);
+        __m128i b2 = _mm_unpacklo_epi8(a4, a5);
+
+        __m128i a6 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 6]);
+        __m128i a7 = _mm_loadl_epi64((const __m128i*)&Input[ldi * 7]);
+        __m128i b3 = _mm_unpacklo_epi8(a6, a7);
+
+        __m128i c0 = _mm_unpacklo_epi16(b0, b1);
+        __m128i c1 = _mm_unpackhi_epi16(b0, b1);
+        __m128i c2 = _mm_unpacklo_epi16(b2, b3);
+        __m128i c3 = _mm_unpackhi_epi16(b2, b3);
+
+        __m128 d0 = _mm_castsi128_ps(_mm_unpacklo_epi32(c0, c2));
+        _mm_storel_pi((__m64*)&Output[ldo * 0], d0);
+        _mm_storeh_pi((__m64*)&Output[ldo * 1], d0);
+
+        __m128 d1 = _mm_castsi128_ps(_mm_unpackhi_epi32(c0, c2));
+        _mm_storel_pi((__m64*)&Output[ldo * 2], d1);
+        _mm_storeh_pi((__m64*)&Output[ldo * 3], d1);
+
+        __m128 d2 = _mm_castsi128_ps(_mm_unpacklo_epi32(c1, c3));
+        _mm_storel_pi((__m64*)&Output[ldo * 4], d2);
+        _mm_storeh_pi((__m64*)&Output[ldo * 5], d2);
+
+        __m128 d3 = _mm_castsi128_ps(_mm_unpackhi_epi32(c1, c3));
+        _mm_storel_pi((__m64*)&Output[ldo * 6], d3);
+        _mm_storeh_pi((__m64*)&Output[ldo * 7], d3);
+#else
+        for (size_t n = 0; n < TileSize; n++) {
+            for (size_t m = 0; m < TileSize; m++) {
+                Output[n * ldo + m] = Input[m * ldi + n];
+            }
+        }
+#endif
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_TILE_KERNEL<uint16_t>
+{
+    static constexpr size_t TileSize = 8;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint16_t* Input,
+        size_t ldi,
+        uint16_t* Output,
+        size_t ldo
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[ldi * 0]);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[ldi * 1]);
+        __m128i a2 = _mm_loadu_si128((const __m128i*)&Input[ldi * 2]);
+        __m128i a3 = _mm_loadu_si128((const __m128i*)&Input[ldi * 3]);
+        __m128i a4 = _mm_loadu_si128((const __m128i*)&Input[ldi * 4]);
+        __m128i a5 = _mm_loadu_si128((const __m128i*)&Input[ldi * 5]);
+        __m128i a6 = _mm_loadu_si128((const __m128i*)&Input[ldi * 6]);
+        __m128i a7 = _mm_loadu_si128((const __m128i*)&Input[ldi * 7]);
+
+        __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+        __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+        __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+        __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+        __m128i b4 = _mm_unpacklo_epi16(a4, a5);
+        __m128i b5 = _mm_unpackhi_epi16(a4, a5);
+        __m128i b6 = _mm_unpacklo_epi16(a6, a7);
+        __m128i b7 = _mm_unpackhi_epi16(a6, a7);
+
+        __m128i c0 = _mm_unpacklo_epi32(b0, b2);
+        __m128i c1 = _mm_unpackhi_epi32(b0, b2);
+        __m128i c2 = _mm_unpacklo_epi32(b1, b3);
+        __m128i c3 = _mm_unpackhi_epi32(b1, b3);
+        __m128i c4 = _mm_unpacklo_epi32(b4, b6);
+        __m128i c5 = _mm_unpackhi_epi32(b4, b6);
+        __m128i c6 = _mm_unpacklo_epi32(b5, b7);
+        __m128i c7 = _mm_unpackhi_epi32(b5, b7);
+
+        _mm_storeu_si128((__m128i*)&Output[ldo * 0], _mm_unpacklo_epi64(c0, c4));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 1], _mm_unpackhi_epi64(c0, c4));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 2], _mm_unpacklo_epi64(c1, c5));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 3], _mm_unpackhi_epi64(c1, c5));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 4], _mm_unpacklo_epi64(c2, c6));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 5], _mm_unpackhi_epi64(c2, c6));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 6], _mm_unpacklo_epi64(c3, c7));
+        _mm_storeu_si128((__m128i*)&Output[ldo * 7], _mm_unpackhi_epi64(c3, c7));
+#else
+        for (size_t n = 0; n < TileSize; n++) {
+            for (size_t m = 0; m < TileSize; m++) {
+                Output[n * ldo + m] = Input[m * ldi + n];
+            }
+        }
+#endif
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_TILE_KERNEL<uint32_t>
+{
+    static constexpr size_t TileSize = 4;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint32_t* Input,
+        size_t ldi,
+        uint32_t* Output,
+        size_t ldo
+        )
+    {
+        //
+        // The elements are only moved by the float vector loads, stores and
+        // interleaves, so any 32-bit value is transposed unchanged.
+        //
+
+        MLAS_FLOAT32X4 a0 = MlasLoadFloat32x4((const float*)&Input[ldi * 0]);
+        MLAS_FLOAT32X4 a1 = MlasLoadFloat32x4((const float*)&Input[ldi * 1]);
+        MLAS_FLOAT32X4 a2 = MlasLoadFloat32x4((const float*)&Input[ldi * 2]);
+        MLAS_FLOAT32X4 a3 = MlasLoadFloat32x4((const float*)&Input[ldi * 3]);
+
+        MLAS_FLOAT32X4 b0 = MlasInterleaveLowFloat32x4(a0, a2);
+        MLAS_FLOAT32X4 b1 = MlasInterleaveHighFloat32x4(a0, a2);
+        MLAS_FLOAT32X4 b2 = MlasInterleaveLowFloat32x4(a1, a3);
+        MLAS_FLOAT32X4 b3 = MlasInterleaveHighFloat32x4(a1, a3);
+
+        MlasStoreFloat32x4((float*)&Output[ldo * 0], MlasInterleaveLowFloat32x4(b0, b2));
+        MlasStoreFloat32x4((float*)&Output[ldo * 1], MlasInterleaveHighFloat32x4(b0, b2));
+        MlasStoreFloat32x4((float*)&Output[ldo * 2], MlasInterleaveLowFloat32x4(b1, b3));
+        MlasStoreFloat32x4((float*)&Output[ldo * 3], MlasInterleaveHighFloat32x4(b1, b3));
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_TILE_KERNEL<uint64_t>
+{
+    static constexpr size_t TileSize = 4;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint64_t* Input,
+        size_t ldi,
+        uint64_t* Output,
+        size_t ldo
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        for (size_t m = 0; m < TileSize; m += 2) {
+            for (size_t n = 0; n < TileSize; n += 2) {
+                __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[ldi * (m + 0) + n]);
+                __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[ldi * (m + 1) + n]);
+                _mm_storeu_si128((__m128i*)&Output[ldo * (n + 0) + m], _mm_unpacklo_epi64(a0, a1));
+                _mm_storeu_si128((__m128i*)&Output[ldo * (n + 1) + m], _mm_unpackhi_epi64(a0, a1));
+            }
+        }
+#else
+        for (size_t n = 0; n < TileSize; n++) {
+            for (size_t m = 0; m < TileSize; m++) {
+                Output[n * ldo + m] = Input[m * ldi + n];
+            }
+        }
+#endif
+    }
+};
+
+template<typename ElementType>
+void
+MlasTransposeBlock(
+    const ElementType* Input,
+    size_t ldi,
+    ElementType* Output,
+    size_t ldo,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns) where the rows of both matrices are
+    strided.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    ldi - Supplies the number of elements between the rows of the input
+        matrix.
+
+    Output - Supplies the output buffer.
+
+    ldo - Supplies the number of elements between the rows of the output
+        matrix.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using TileKernel = MLAS_TRANSPOSE_TILE_KERNEL<ElementType>;
+    constexpr size_t TileSize = TileKernel::TileSize;
+
+    //
+    // Split the block along its longer dimension at a tile boundary until the
+    // block fits in the first level cache.
+    //
+
+    while (M * N * sizeof(ElementType) > MLAS_TRANSPOSE_BLOCK_BYTES &&
+           std::max(M, N) >= 2 * TileSize) {
+
+        if (M >= N) {
+
+            size_t HalfM = (M / 2) & ~(TileSize - 1);
+
+            MlasTransposeBlock(Input, ldi, Output, ldo, HalfM, N);
+
+            Input += HalfM * ldi;
+            Output += HalfM;
+            M -= HalfM;
+
+        } else {
+
+            size_t HalfN = (N / 2) & ~(TileSize - 1);
+
+            MlasTransposeBlock(Input, ldi, Output, ldo, M, HalfN);
+
+            Input += HalfN;
+            Output += HalfN * ldo;
+            N -= HalfN;
+        }
+    }
+
+    //
+    // Transpose the block a tile at a time and the columns and rows that
+    // don't fill a tile an element at a time.
+    //
+
+    size_t m = 0;
+
+    for (; m + TileSize <= M; m += TileSize) {
+
+        size_t n = 0;
+
+        for (; n + TileSize <= N; n += TileSize) {
+            TileKernel::Transpose(&Input[m * ldi + n], ldi, &Output[n * ldo + m], ldo);
+        }
+
+        for (; n < N; n++) {
+            for (size_t mm = m; mm < m + TileSize; mm++) {
+                Output[n * ldo + mm] = Input[mm * ldi + n];
+            }
+        }
+    }
+
+    for (; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+            Output[n * ldo + m] = Input[m * ldi + n];
+        }
+    }
+}
+
+void
+MlasTransposeElementBlock(
+    const uint8_t* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    size_t M,
+    size_t N,
+    size_t ElementSize
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns) for elements of other sizes than the
+    ones supported by the tile kernels.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    ldi - Supplies the number of elements between the rows of the input
+        matrix.
+
+    Output - Supplies the output buffer.
+
+    ldo - Supplies the number of elements between the rows of the output
+        matrix.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+    ElementSize - Supplies the number of bytes of an element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n++) {
+        for (size_t m = 0; m < M; m++) {
+            memcpy(&Output[(n * ldo + m) * ElementSize], &Input[(m * ldi + n) * ElementSize], ElementSize);
+        }
+    }
+}
+
+void
+MlasTransposeStrided(
+    const uint8_t* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    size_t M,
+    size_t N,
+    size_t ElementSize
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns) with the kernel for the element size.
+
+Arguments:
+
+    See MlasTransposeElementBlock.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (ElementSize) {
+
+        case 1:
+            MlasTransposeBlock(Input, ldi, Output, ldo, M, N);
+            break;
+
+        case 2:
+            MlasTransposeBlock(reinterpret_cast<const uint16_t*>(Input), ldi,
+                reinterpret_cast<uint16_t*>(Output), ldo, M, N);
+            break;
+
+        case 4:
+            MlasTransposeBlock(reinterpret_cast<const uint32_t*>(Input), ldi,
+                reinterpret_cast<uint32_t*>(Output), ldo, M, N);
+            break;
+
+        case 8:
+            MlasTransposeBlock(reinterpret_cast<const uint64_t*>(Input), ldi,
+                reinterpret_cast<uint64_t*>(Output), ldo, M, N);
+            break;
+
+        default:
+            MlasTransposeElementBlock(Input, ldi, Output, ldo, M, N, ElementSize);
+            break;
+    }
+}
 
 void
 MLASCALL
@@ -51,124 +497,386 @@ Return Value:
 
 --*/
 {
-    size_t n = N;
+    MlasTransposeBlock(Input, N, Output, M, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns).
+
+Arguments:
+
+    See the uint8_t version of MlasTranspose.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeBlock(Input, N, Output, M, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns).
+
+Arguments:
+
+    See the uint8_t version of MlasTranspose.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeBlock(Input, N, Output, M, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    uint64_t* Output,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the input matrix (M rows by N columns) to the
+    output matrix (N rows by M columns).
+
+Arguments:
+
+    See the uint8_t version of MlasTranspose.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeBlock(Input, N, Output, M, M, N);
+}
+
+struct MLAS_TRANSPOSE_WORK_BLOCK {
+    const uint8_t* Input;
+    uint8_t* Output;
+    size_t ElementSize;
+    size_t M;
+    size_t N;
+    size_t ldi;
+    size_t ldo;
+    size_t MBlockCount;
+    size_t OuterRank;
+    size_t OuterShape[MLAS_TRANSPOSE_MAXIMUM_RANK];
+    size_t OuterInputStride[MLAS_TRANSPOSE_MAXIMUM_RANK];
+    size_t OuterOutputStride[MLAS_TRANSPOSE_MAXIMUM_RANK];
+    size_t OuterCount;
+    int32_t ThreadCount;
+};
+
+void
+MlasTransposeTensorThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    tensor transpose operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_TRANSPOSE_WORK_BLOCK*)Context;
 
     //
-    // Transpose elements from the input matrix to the output matrix 8 columns
-    // at a time.
+    // Partition the row blocks of every matrix to the threads. The row blocks
+    // are a multiple of the tile size, so the tiles of a thread don't straddle
+    // the rows given to another thread.
     //
 
-    while (n >= 8) {
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->OuterCount * WorkBlock->MBlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    const size_t ElementSize = WorkBlock->ElementSize;
+    const size_t M = WorkBlock->M;
+
+    while (WorkRemaining > 0) {
 
-        const uint8_t* s = Input;
-        uint8_t* d = Output;
-        size_t m = M;
+        size_t OuterIndex = WorkIndex / WorkBlock->MBlockCount;
+        size_t MBlockIndex = WorkIndex % WorkBlock->MBlockCount;
+        size_t MBlockRemaining = std::min(WorkBlock->MBlockCount - MBlockIndex, WorkRemaining);
 
-        while (m >= 8) {
+        //
+        // Compute the offset of the matrix in the input and the output from the
+        // index of the matrix in the outer axes.
+        //
 
-            __m128i a0 = _mm_loadl_epi64((const __m128i*)&s[N * 0]);
-            __m128i a1 = _mm_loadl_epi64((const __m128i*)&s[N * 1]);
-            __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+        size_t InputOffset = 0;
+        size_t OutputOffset = 0;
 
-            __m128i a2 = _mm_loadl_epi64((const __m128i*)&s[N * 2]);
-            __m128i a3 = _mm_loadl_epi64((const __m128i*)&s[N * 3]);
-            __m128i b1 = _mm_unpacklo_epi8(a2, a3);
+        for (size_t i = WorkBlock->OuterRank; i > 0; i--) {
+            size_t OuterDim = WorkBlock->OuterShape[i - 1];
+            size_t Coordinate = OuterIndex % OuterDim;
+            OuterIndex /= OuterDim;
+            InputOffset += Coordinate * WorkBlock->OuterInputStride[i - 1];
+            OutputOffset += Coordinate * WorkBlock->OuterOutputStride[i - 1];
+        }
+
+        size_t m = MBlockIndex * MLAS_TRANSPOSE_ROWS_PER_BLOCK;
+        size_t CountM = std::min(MBlockRemaining * MLAS_TRANSPOSE_ROWS_PER_BLOCK, M - m);
+
+        MlasTransposeStrided(WorkBlock->Input + (InputOffset + m * WorkBlock->ldi) * ElementSize,
+            WorkBlock->ldi, WorkBlock->Output + (OutputOffset + m) * ElementSize, WorkBlock->ldo,
+            CountM, WorkBlock->N, ElementSize);
+
+        WorkIndex += MBlockRemaining;
+        WorkRemaining -= MBlockRemaining;
+    }
+}
 
-            __m128i a4 = _mm_loadl_epi64((const __m128i*)&s[N * 4]);
-            __m128i a5 = _mm_loadl_epi64((const __m128i*)&s[N * 5]);
-            __m128i b2 = _mm_unpacklo_epi8(a4, a5);
+bool
+MLASCALL
+MlasTransposeTensor(
+    const void* Input,
+    void* Output,
+    size_t ElementSize,
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
 
-            __m128i a6 = _mm_loadl_epi64((const __m128i*)&s[N * 6]);
-            __m128i a7 = _mm_loadl_epi64((const __m128i*)&s[N * 7]);
-            __m128i b3 = _mm_unpacklo_epi8(a6, a7);
+Routine Description:
 
-            __m128i c0 = _mm_unpacklo_epi16(b0, b1);
-            __m128i c1 = _mm_unpackhi_epi16(b0, b1);
-            __m128i c2 = _mm_unpacklo_epi16(b2, b3);
-            __m128i c3 = _mm_unpackhi_epi16(b2, b3);
+    This routine transposes the input tensor to the output tensor, where
+    output axis i is input axis Permutation[i].
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    ElementSize - Supplies the number of bytes of an element.
+
+    Rank - Supplies the number of axes of the tensors.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Permutation - Supplies the input axis of each output axis.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the transpose was done, else false if the tensor still
+    has more than MLAS_TRANSPOSE_MAXIMUM_RANK axes once the unit dimensions
+    are dropped and the adjacent axes merged.
+
+--*/
+{
+    //
+    // Build the permutation of the axes with more than one element, in the
+    // order of the output, and merge the runs of input axes that stay
+    // adjacent in the output into a single axis.
+    //
 
-            __m128 d0 = _mm_castsi128_ps(_mm_unpacklo_epi32(c0, c2));
-            _mm_storel_pi((__m64*)&d[M * 0], d0);
-            _mm_storeh_pi((__m64*)&d[M * 1], d0);
+    size_t FoldedRank = 0;
+    size_t FoldedFirstAxis[MLAS_TRANSPOSE_MAXIMUM_RANK];
+    size_t FoldedShape[MLAS_TRANSPOSE_MAXIMUM_RANK];
+    size_t PreviousAxis = 0;
+    size_t TotalElements = 1;
 
-            __m128 d1 = _mm_castsi128_ps(_mm_unpackhi_epi32(c0, c2));
-            _mm_storel_pi((__m64*)&d[M * 2], d1);
-            _mm_storeh_pi((__m64*)&d[M * 3], d1);
+    for (size_t i = 0; i < Rank; i++) {
 
-            __m128 d2 = _mm_castsi128_ps(_mm_unpacklo_epi32(c1, c3));
-            _mm_storel_pi((__m64*)&d[M * 4], d2);
-            _mm_storeh_pi((__m64*)&d[M * 5], d2);
+        size_t Axis = Permutation[i];
+        size_t Dim = InputShape[Axis];
 
-            __m128 d3 = _mm_castsi128_ps(_mm_unpackhi_epi32(c1, c3));
-            _mm_storel_pi((__m64*)&d[M * 6], d3);
-            _mm_storeh_pi((__m64*)&d[M * 7], d3);
+        TotalElements *= Dim;
 
-            s += N * 8;
-            d += 8;
-            m -= 8;
+        if (Dim == 1) {
+            continue;
         }
 
-        while (m > 0) {
+        //
+        // The axis extends the previous folded axis if every input axis in
+        // between has a unit dimension.
+        //
 
-            d[M * 0] = s[0];
-            d[M * 1] = s[1];
-            d[M * 2] = s[2];
-            d[M * 3] = s[3];
-            d[M * 4] = s[4];
-            d[M * 5] = s[5];
-            d[M * 6] = s[6];
-            d[M * 7] = s[7];
+        bool Adjacent = FoldedRank > 0 && Axis > PreviousAxis;
 
-            s += N;
-            d += 1;
-            m -= 1;
+        for (size_t a = PreviousAxis + 1; Adjacent && a < Axis; a++) {
+            Adjacent = InputShape[a] == 1;
         }
 
-        Input += 8;
-        Output += M * 8;
-        n -= 8;
+        if (Adjacent) {
+            FoldedShape[FoldedRank - 1] *= Dim;
+        } else {
+            if (FoldedRank == MLAS_TRANSPOSE_MAXIMUM_RANK) {
+                return false;
+            }
+            FoldedFirstAxis[FoldedRank] = Axis;
+            FoldedShape[FoldedRank] = Dim;
+            FoldedRank++;
+        }
+
+        PreviousAxis = Axis;
+    }
+
+    const size_t TotalBytes = TotalElements * ElementSize;
+
+    if (TotalBytes == 0) {
+        return true;
     }
 
     //
-    // Transpose elements from the input matrix to the output matrix for the
-    // remaining columns.
+    // Rank the folded axes by their position in the input to get the folded
+    // permutation.
     //
 
-    while (n > 0) {
+    size_t FoldedPermutation[MLAS_TRANSPOSE_MAXIMUM_RANK];
 
-        const uint8_t* s = Input;
-        uint8_t* d = Output;
-        size_t m = M;
+    for (size_t i = 0; i < FoldedRank; i++) {
+        size_t InputRank = 0;
+        for (size_t j = 0; j < FoldedRank; j++) {
+            InputRank += (FoldedFirstAxis[j] < FoldedFirstAxis[i]) ? 1 : 0;
+        }
+        FoldedPermutation[i] = InputRank;
+    }
 
-        while (m >= 8) {
+    size_t FoldedInputShape[MLAS_TRANSPOSE_MAXIMUM_RANK];
 
-            d[0] = s[N * 0];
-            d[1] = s[N * 1];
-            d[2] = s[N * 2];
-            d[3] = s[N * 3];
-            d[4] = s[N * 4];
-            d[5] = s[N * 5];
-            d[6] = s[N * 6];
-            d[7] = s[N * 7];
+    for (size_t i = 0; i < FoldedRank; i++) {
+        FoldedInputShape[FoldedPermutation[i]] = FoldedShape[i];
+    }
 
-            s += N * 8;
-            d += 8;
-            m -= 8;
-        }
+    //
+    // Fold the innermost axis into the element when it stays innermost. Once
+    // the adjacent axes are merged, this leaves either a copy or a tensor
+    // whose innermost input and output axes differ.
+    //
+
+    if (FoldedRank > 0 && FoldedPermutation[FoldedRank - 1] == FoldedRank - 1) {
+        FoldedRank--;
+        ElementSize *= FoldedShape[FoldedRank];
+    }
+
+    if (FoldedRank == 0) {
+        memcpy(Output, Input, TotalBytes);
+        return true;
+    }
+
+    size_t InputStride[MLAS_TRANSPOSE_MAXIMUM_RANK];
+    size_t OutputStride[MLAS_TRANSPOSE_MAXIMUM_RANK];
+
+    InputStride[FoldedRank - 1] = 1;
+    OutputStride[FoldedRank - 1] = 1;
+
+    for (size_t i = FoldedRank - 1; i > 0; i--) {
+        InputStride[i - 1] = InputStride[i] * FoldedInputShape[i];
+        OutputStride[i - 1] = OutputStride[i] * FoldedShape[i];
+    }
 
-        while (m > 0) {
+    //
+    // Each matrix transposes the innermost input axis with the input axis
+    // that is innermost in the output. The other axes index the matrices in
+    // the order of the output.
+    //
+
+    MLAS_TRANSPOSE_WORK_BLOCK WorkBlock;
 
-            d[0] = s[0];
+    WorkBlock.Input = (const uint8_t*)Input;
+    WorkBlock.Output = (uint8_t*)Output;
+    WorkBlock.ElementSize = ElementSize;
+    WorkBlock.M = FoldedShape[FoldedRank - 1];
+    WorkBlock.ldi = InputStride[FoldedPermutation[FoldedRank - 1]];
+    WorkBlock.N = 1;
+    WorkBlock.ldo = 1;
+    WorkBlock.OuterRank = 0;
+    WorkBlock.OuterCount = 1;
 
-            s += N;
-            d += 1;
-            m -= 1;
+    for (size_t i = 0; i < FoldedRank - 1; i++) {
+
+        if (FoldedPermutation[i] == FoldedRank - 1) {
+            WorkBlock.N = FoldedShape[i];
+            WorkBlock.ldo = OutputStride[i];
+            continue;
         }
 
-        Input += 1;
-        Output += M;
-        n -= 1;
+        WorkBlock.OuterShape[WorkBlock.OuterRank] = FoldedShape[i];
+        WorkBlock.OuterInputStride[WorkBlock.OuterRank] = InputStride[FoldedPermutation[i]];
+        WorkBlock.OuterOutputStride[WorkBlock.OuterRank] = OutputStride[i];
+        WorkBlock.OuterRank++;
+        WorkBlock.OuterCount *= FoldedShape[i];
     }
-}
 
-#endif
+    WorkBlock.MBlockCount = (WorkBlock.M + MLAS_TRANSPOSE_ROWS_PER_BLOCK - 1) / MLAS_TRANSPOSE_ROWS_PER_BLOCK;
+
+    //
+    // Compute the number of target threads given the number of bytes to move
+    // and the number of row blocks to partition.
+    //
+
+    const size_t TotalWork = WorkBlock.OuterCount * WorkBlock.MBlockCount;
+    const size_t BlockCount = (TotalBytes / MLAS_TRANSPOSE_MINIMUM_BYTES_PER_THREAD) + 1;
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    if (size_t(ThreadCount) > TotalWork) {
+        ThreadCount = int32_t(TotalWork);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasTransposeTensorThreaded, &WorkBlock, ThreadCount, ThreadPool);
+
+    return true;
+}
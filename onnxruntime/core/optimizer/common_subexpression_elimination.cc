@@ -3,8 +3,13 @@
 
 #include "common_subexpression_elimination.h"
 #include "core/optimizer/utils.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 
+#include <algorithm>
+#include <functional>
+#include <map>
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
@@ -32,6 +37,13 @@
 // first every graph input, constant initializer and graph node output are assigned
 // an equivalence class, and then nodes that have the same operation and equivalent inputs
 // are collapsed.
+//
+// Additionally:
+//  - the inputs of commutative operations are put in a canonical order, so Add(x1, x2) and Add(x2, x1) are merged.
+//  - constant initializers with the same type, shape and content are merged into one.
+//  - the nodes of a Loop or Scan body that compute the same value in every iteration, i.e. whose inputs are all
+//    constant initializers, outer scope values or outputs of such nodes, are hoisted into the graph containing the
+//    Loop or Scan node so they're computed once.
 
 namespace onnxruntime {
 
@@ -129,8 +141,8 @@ class EquivalenceClass {
 
   // When the value is not an output of an operation, (i.e., a constant initializer or an input),
   // non_op_value is set to the corresponding NodeArg, and other fields are empty.
-  // Currently, different inputs/initializers are always considered different values, although we
-  // could merge equal initializers.
+  // Different inputs are always considered different values. Constant initializers with the same content share
+  // the NodeArg of the first of them.
   const NodeArg* non_op_value_;
 
   // When an operation is not supported by the CSE optimization pass, we consider its
@@ -141,6 +153,18 @@ class EquivalenceClass {
   const std::size_t hash_;
 };
 
+// Returns true if the result of the node doesn't depend on the order of its inputs.
+// The order of the inputs of Sum changes the rounding of the additions unless there are two of them.
+bool IsCommutative(const Node& node) {
+  if (node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) {
+    return false;
+  }
+
+  const auto& op_type = node.OpType();
+  return op_type == "Add" || op_type == "Mul" || op_type == "Max" || op_type == "Min" ||
+         (op_type == "Sum" && node.InputDefs().size() == 2);
+}
+
 std::vector<std::vector<const EquivalenceClass*>> Normalize(const Node& node, const std::vector<const EquivalenceClass*>& inputs) {
   const auto& arg_count = node.InputArgCount();
   auto input_iter = inputs.begin();
@@ -161,6 +185,18 @@ std::vector<std::vector<const EquivalenceClass*>> Normalize(const Node& node, co
     }
   }
 
+  // Order the inputs of commutative operations by their equivalence class. The classes are unique so their addresses
+  // are their value numbers. Add and Mul have two single formal parameters, Max, Min and Sum one variadic parameter.
+  if (IsCommutative(node)) {
+    if (result.size() == 2 && result[0].size() == 1 && result[1].size() == 1) {
+      if (std::less<const EquivalenceClass*>{}(result[1][0], result[0][0])) {
+        std::swap(result[0], result[1]);
+      }
+    } else if (result.size() == 1) {
+      std::sort(result[0].begin(), result[0].end(), std::less<const EquivalenceClass*>{});
+    }
+  }
+
   return result;
 }
 
@@ -316,6 +352,258 @@ struct NodeArgPtrEquality {
 bool IsNodeSupported(const Node& node) {
   return !node.ContainsSubgraph() && optimizer_utils::IsOperationDeterministic(node.Domain(), node.OpType());
 }
+
+// The content of a constant initializer, without copying it if it's stored as raw data.
+class InitializerContent {
+ public:
+  // Returns false if the content can't be read, for string or external data.
+  bool Init(const ONNX_NAMESPACE::TensorProto& initializer) {
+    if (initializer.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+        initializer.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL) {
+      return false;
+    }
+
+    if (utils::HasRawData(initializer)) {
+      data_ = reinterpret_cast<const uint8_t*>(initializer.raw_data().data());
+      size_ = initializer.raw_data().size();
+      return true;
+    }
+
+    if (!utils::UnpackInitializerData(initializer, unpacked_, size_).IsOK()) {
+      return false;
+    }
+
+    data_ = unpacked_.get();
+    return true;
+  }
+
+  std::size_t Hash() const {
+    uint32_t hash = 0;
+    MurmurHash3::x86_32(data_, static_cast<int>(size_), 0, &hash);
+    return hash;
+  }
+
+  bool operator==(const InitializerContent& other) const {
+    return size_ == other.size_ && (size_ == 0 || std::equal(data_, data_ + size_, other.data_));
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::unique_ptr<uint8_t[]> unpacked_;
+};
+
+// Maps the names of the constant initializers that have the same type, shape and content as another constant
+// initializer to the NodeArg of that initializer.
+std::unordered_map<std::string, const NodeArg*> FindDuplicateInitializers(
+    const Graph& graph, const std::unordered_set<const NodeArg*>& graph_outputs) {
+  // only initializers with the same type and shape are candidates. process them by name so the result is stable.
+  std::map<std::pair<int32_t, std::vector<int64_t>>, std::vector<std::string>> candidates;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    const NodeArg* node_arg = graph.GetNodeArg(entry.first);
+    if (node_arg == nullptr || graph_outputs.count(node_arg) != 0 ||
+        graph_utils::GetConstantInitializer(graph, entry.first, false) == nullptr) {
+      continue;
+    }
+
+    const auto& dims = entry.second->dims();
+    candidates[{entry.second->data_type(), std::vector<int64_t>(dims.begin(), dims.end())}].push_back(entry.first);
+  }
+
+  std::unordered_map<std::string, const NodeArg*> duplicates;
+  for (auto& entry : candidates) {
+    auto& names = entry.second;
+    if (names.size() < 2) {
+      continue;
+    }
+
+    std::sort(names.begin(), names.end());
+
+    // the distinct contents seen so far, by hash
+    std::vector<InitializerContent> contents(names.size());
+    std::unordered_multimap<std::size_t, size_t> distinct_contents;
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (!contents[i].Init(*graph.GetAllInitializedTensors().at(names[i]))) {
+        continue;
+      }
+
+      const std::size_t hash = contents[i].Hash();
+      bool is_duplicate = false;
+      auto range = distinct_contents.equal_range(hash);
+      for (auto distinct = range.first; distinct != range.second; ++distinct) {
+        if (contents[distinct->second] == contents[i]) {
+          duplicates.emplace(names[i], graph.GetNodeArg(names[distinct->second]));
+          is_duplicate = true;
+          break;
+        }
+      }
+
+      if (!is_duplicate) {
+        distinct_contents.emplace(hash, i);
+      }
+    }
+  }
+
+  return duplicates;
+}
+
+// Returns true if the body of the Loop or Scan node consumes the value in a nested subgraph.
+bool IsConsumedBySubgraph(const Graph& body, const std::string& name) {
+  for (const auto& node : body.Nodes()) {
+    for (const auto* implicit_input : node.ImplicitInputDefs()) {
+      if (implicit_input->Name() == name) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Moves the nodes of the body of the Loop or Scan node that compute the same value in every iteration to graph,
+// which contains the Loop or Scan node. Returns true if any node was moved.
+bool HoistLoopInvariantNodes(Graph& graph, Node& loop_node) {
+  Graph* body = loop_node.GetMutableGraphAttribute("body");
+  if (body == nullptr) {
+    return false;
+  }
+
+  std::unordered_set<std::string> body_inputs_and_outputs;
+  for (const auto* input : body->GetInputsIncludingInitializers()) {
+    body_inputs_and_outputs.insert(input->Name());
+  }
+  for (const auto* output : body->GetOutputs()) {
+    body_inputs_and_outputs.insert(output->Name());
+  }
+
+  // the NodeArgs in graph that replace the values hoisted from the body, by their name in the body
+  std::unordered_map<std::string, NodeArg*> hoisted_values;
+  std::vector<Node*> hoisted_nodes;
+  std::unordered_set<std::string> hoisted_initializers;
+
+  GraphViewer body_viewer(*body);
+  for (NodeIndex node_index : body_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = body->GetNode(node_index);
+    if (node == nullptr || !IsNodeSupported(*node)) {
+      continue;
+    }
+
+    // the node is invariant if each input is a hoisted value, a constant initializer or an outer scope value
+    bool is_invariant = true;
+    for (const auto* input : node->InputDefs()) {
+      if (!input->Exists() || hoisted_values.count(input->Name()) != 0) {
+        continue;
+      }
+
+      const auto& name = input->Name();
+      const bool is_local_value = body_inputs_and_outputs.count(name) != 0 || body->GetProducerNode(name) != nullptr;
+      if (is_local_value || (body->GetConstantInitializer(name, false) == nullptr && !body->IsOuterScopeValue(name))) {
+        is_invariant = false;
+        break;
+      }
+    }
+
+    // the outputs must be replaceable in the body
+    for (const auto* output : node->OutputDefs()) {
+      if (output->Exists() &&
+          (body_inputs_and_outputs.count(output->Name()) != 0 || IsConsumedBySubgraph(*body, output->Name()))) {
+        is_invariant = false;
+      }
+    }
+
+    if (!is_invariant) {
+      continue;
+    }
+
+    std::vector<NodeArg*> inputs;
+    for (const auto* input : node->InputDefs()) {
+      const auto& name = input->Name();
+      auto hoisted = hoisted_values.find(name);
+      if (!input->Exists()) {
+        inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      } else if (hoisted != hoisted_values.cend()) {
+        inputs.push_back(hoisted->second);
+      } else if (const auto* initializer = body->GetConstantInitializer(name, false)) {
+        // copy the initializer to graph under a name that doesn't hide any value
+        ONNX_NAMESPACE::TensorProto hoisted_initializer{*initializer};
+        hoisted_initializer.set_name(graph.GenerateNodeArgName(name));
+        graph.AddInitializedTensor(hoisted_initializer);
+        hoisted_initializers.insert(name);
+        NodeArg* hoisted_arg = &graph.GetOrCreateNodeArg(hoisted_initializer.name(), input->TypeAsProto());
+        hoisted_values[name] = hoisted_arg;
+        inputs.push_back(hoisted_arg);
+      } else {
+        // a value of graph or of one of its outer scopes
+        inputs.push_back(&graph.GetOrCreateNodeArg(name, input->TypeAsProto()));
+      }
+    }
+
+    std::vector<NodeArg*> outputs;
+    for (const auto* output : node->OutputDefs()) {
+      if (!output->Exists()) {
+        outputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+        continue;
+      }
+
+      // the name must not be taken in the body either, as the body refers to the value by this name
+      std::string name;
+      do {
+        name = graph.GenerateNodeArgName(output->Name());
+      } while (body->GetNodeArg(name) != nullptr);
+
+      NodeArg* hoisted_arg = &graph.GetOrCreateNodeArg(name, output->TypeAsProto());
+      hoisted_values[output->Name()] = hoisted_arg;
+      outputs.push_back(hoisted_arg);
+    }
+
+    auto& hoisted_node = graph.AddNode(graph.GenerateNodeName(node->Name()), node->OpType(), node->Description(),
+                                       inputs, outputs, &node->GetAttributes(), node->Domain());
+    hoisted_node.SetExecutionProviderType(node->GetExecutionProviderType());
+    hoisted_nodes.push_back(node);
+  }
+
+  if (hoisted_nodes.empty()) {
+    return false;
+  }
+
+  // the remaining nodes of the body consume the hoisted values from outer scope
+  for (auto& node : body->Nodes()) {
+    auto& input_defs = node.MutableInputDefs();
+    for (size_t i = 0; i < input_defs.size(); ++i) {
+      auto hoisted = hoisted_values.find(input_defs[i]->Name());
+      if (input_defs[i]->Exists() && hoisted != hoisted_values.cend()) {
+        body->AddOuterScopeNodeArg(hoisted->second->Name());
+        graph_utils::ReplaceNodeInput(node, static_cast<int>(i),
+                                      body->GetOrCreateNodeArg(hoisted->second->Name(), input_defs[i]->TypeAsProto()));
+      }
+    }
+  }
+
+  for (Node* node : hoisted_nodes) {
+    graph_utils::RemoveNodeOutputEdges(*body, *node);
+  }
+
+  for (Node* node : hoisted_nodes) {
+    body->RemoveNode(node->Index());
+  }
+
+  // remove the initializers of the body that were only consumed by the hoisted nodes
+  for (auto& node : body->Nodes()) {
+    for (const auto* input : node.InputDefs()) {
+      hoisted_initializers.erase(input->Name());
+    }
+    for (const auto* input : node.ImplicitInputDefs()) {
+      hoisted_initializers.erase(input->Name());
+    }
+  }
+
+  for (const auto& name : hoisted_initializers) {
+    body->RemoveInitializedTensor(name);
+  }
+
+  body->SetGraphResolveNeeded();
+  return true;
+}
 }  // namespace
 
 }  // namespace onnxruntime
@@ -353,6 +641,12 @@ Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, i
 
   int unique_discriminator = 1;
 
+  std::unordered_set<const NodeArg*> graph_outputs;
+  graph_outputs.insert(graph_viewer.GetOutputs().begin(), graph_viewer.GetOutputs().end());
+
+  // Constant initializers with the same content as another one are replaced by it.
+  const auto duplicate_initializers = FindDuplicateInitializers(graph, graph_outputs);
+
   for (NodeIndex node_index : node_topology_list) {
     Node* node = graph.GetNode(node_index);
     if (node == nullptr)
@@ -360,6 +654,13 @@ Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, i
 
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
 
+    if ((graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Loop", {1, 11, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Scan", {8, 9, 11})) &&
+        graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) &&
+        HoistLoopInvariantNodes(graph, *node)) {
+      modified = true;
+    }
+
     std::vector<const EquivalenceClass*> input_values;
     input_values.reserve(node->InputDefs().size());
     for (const NodeArg* input_def : node->InputDefs()) {
@@ -367,11 +668,20 @@ Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, i
       if (it == equivalence_classes.end()) {
         // Because nodes are processed in topological order, this will always be
         // a non-op value (graph input or constant initializer).
-        auto value = onnxruntime::make_unique<EquivalenceClass>(input_def);
-        const auto* raw_ptr = value.get();
-        unique_equivalence_classes.push_back(std::move(value));
-        value_to_representative.emplace(raw_ptr, Representative{input_def, 0, kInvalidOutputIndex});
-        it = equivalence_classes.emplace_hint(it, input_def, raw_ptr);
+        auto duplicate = duplicate_initializers.find(input_def->Name());
+        const NodeArg* value_def = duplicate != duplicate_initializers.cend() ? duplicate->second : input_def;
+        it = equivalence_classes.find(value_def);
+        if (it == equivalence_classes.end()) {
+          auto value = onnxruntime::make_unique<EquivalenceClass>(value_def);
+          const auto* raw_ptr = value.get();
+          unique_equivalence_classes.push_back(std::move(value));
+          value_to_representative.emplace(raw_ptr, Representative{value_def, 0, kInvalidOutputIndex});
+          it = equivalence_classes.emplace(value_def, raw_ptr).first;
+        }
+
+        if (value_def != input_def) {
+          it = equivalence_classes.emplace(input_def, it->second).first;
+        }
       }
 
       input_values.push_back(it->second);
@@ -399,14 +709,20 @@ Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, i
     }
   }
 
-  std::unordered_set<const NodeArg*> graph_outputs;
-  graph_outputs.insert(graph_viewer.GetOutputs().begin(), graph_viewer.GetOutputs().end());
-
   for (NodeIndex node_index : node_topology_list) {
     Node* node = graph.GetNode(node_index);
     if (node == nullptr)
       continue;
 
+    auto& input_defs = node->MutableInputDefs();
+    for (size_t i = 0; i < input_defs.size(); ++i) {
+      auto duplicate = duplicate_initializers.find(input_defs[i]->Name());
+      if (input_defs[i]->Exists() && duplicate != duplicate_initializers.cend()) {
+        graph_utils::ReplaceNodeInput(*node, static_cast<int>(i), *graph.GetNodeArg(duplicate->second->Name()));
+        modified = true;
+      }
+    }
+
     bool node_output_replaced = false;
     for (OutputIndex output_idx = 0, end = static_cast<int>(node->OutputDefs().size());
          output_idx < end; ++output_idx) {
@@ -442,6 +758,25 @@ Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, i
     }
   }
 
+  // remove the duplicate initializers unless a subgraph still consumes them
+  if (!duplicate_initializers.empty()) {
+    std::unordered_set<std::string> consumed;
+    for (const auto& node : graph.Nodes()) {
+      for (const auto* input : node.InputDefs()) {
+        consumed.insert(input->Name());
+      }
+      for (const auto* input : node.ImplicitInputDefs()) {
+        consumed.insert(input->Name());
+      }
+    }
+
+    for (const auto& duplicate : duplicate_initializers) {
+      if (consumed.count(duplicate.first) == 0) {
+        graph.RemoveInitializedTensor(duplicate.first);
+      }
+    }
+  }
+
   return Status::OK();
 }
 
@@ -7,6 +7,7 @@
 #include "core/optimizer/optimizer_execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime::common;
 
@@ -14,10 +15,12 @@ namespace onnxruntime {
 
 ConstantFolding::ConstantFolding(const IExecutionProvider& execution_provider,
                                  const std::unordered_set<std::string>& compatible_execution_providers,
-                                 const std::unordered_set<std::string>& excluded_initializers) noexcept
+                                 const std::unordered_set<std::string>& excluded_initializers,
+                                 concurrency::ThreadPool* thread_pool) noexcept
     : GraphTransformer("ConstantFolding", compatible_execution_providers),
       excluded_initializers_(excluded_initializers),
-      execution_provider_(execution_provider) {
+      execution_provider_(execution_provider),
+      thread_pool_(thread_pool) {
 }
 
 // We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
@@ -55,131 +58,326 @@ static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
   return is_concrete_shape;  // convert to constant if this is true
 }
 
-Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
-  bool have_updated_nodes = false;
-  GraphViewer graph_viewer(graph);
-  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+// Replace an If node whose condition is a constant initializer with the nodes of the branch it always takes.
+// The values produced in the branch are renamed to be unique in the graph, except for the branch outputs which take
+// the names of the If node outputs. Branches containing control flow nodes are not inlined.
+static bool InlineConstantIfNode(Graph& graph, Node& node,
+                                 const std::unordered_set<std::string>& excluded_initializers) {
+  const auto& cond_name = node.InputDefs()[0]->Name();
+  if (excluded_initializers.count(cond_name) != 0) {
+    return false;
+  }
 
-  for (NodeIndex i : order) {
-    auto* node = graph.GetNode(i);
-    if (!node) {
-      continue;
-    }
+  const auto* cond = graph_utils::GetConstantInitializer(graph, cond_name);
+  bool condition = false;
+  if (cond == nullptr || cond->data_type() != ONNX_NAMESPACE::TensorProto_DataType_BOOL ||
+      !utils::UnpackTensor(*cond, &condition, 1).IsOK()) {
+    return false;
+  }
 
-    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+  Graph* branch = node.GetMutableGraphAttribute(condition ? "then_branch" : "else_branch");
+  if (branch == nullptr) {
+    return false;
+  }
 
-    // Updating a node may allow shape inferencing to infer output shapes of following nodes,
-    // so re-run the shape inferencing. use have_updated_nodes as that only applies to this Graph
-    // (vs. 'modified' which is passed into subgraphs and applies to the main graph and all subgraphs)
-    // Ignore any control flow node containing subgraphs as UpdateShapeInference is not intended to be used on it.
-    if (have_updated_nodes && !node->ContainsSubgraph()) {
-      ORT_RETURN_IF_ERROR(graph.UpdateShapeInference(*node));
+  for (const auto& branch_node : branch->Nodes()) {
+    if (branch_node.ContainsSubgraph()) {
+      return false;
     }
+  }
 
-    bool converted_to_constant = false;
-    if (node->OpType().compare("Shape") == 0) {
-      converted_to_constant = ConstantFoldShapeNode(graph, *node);
-    } else {
-      InitializedTensorSet constant_inputs;
+  // new names of the values produced in the branch
+  std::unordered_map<std::string, std::string> renamed;
+  const auto& branch_outputs = branch->GetOutputs();
+  const auto& if_outputs = node.OutputDefs();
+  for (size_t i = 0; i < branch_outputs.size(); ++i) {
+    const auto* producer = branch->GetProducerNode(branch_outputs[i]->Name());
+    if (producer != nullptr && renamed.count(branch_outputs[i]->Name()) == 0) {
+      renamed[branch_outputs[i]->Name()] = if_outputs[i]->Name();
+    }
+  }
 
-      // we currently constant fold using the CPU EP only.
-      // if the node is assigned to a different EP we can run it if it's an ONNX op as we have CPU based
-      // implementations for all ONNX ops. If the node/op is from a different op domain or if the CPU implementation
-      // does not support the specific input type(s) required by the node (currently we only support a subset of
-      // types in some CPU kernels) then we can't proceed with constant folding for the node.
-      auto ep_type = node->GetExecutionProviderType();
-      bool cpu_ep = ep_type == kCpuExecutionProvider;
-      if (!cpu_ep && node->Domain() != kOnnxDomain) {
-        continue;
+  for (const auto& branch_node : branch->Nodes()) {
+    for (const auto* output : branch_node.OutputDefs()) {
+      if (output->Exists() && renamed.count(output->Name()) == 0) {
+        renamed[output->Name()] = graph.GenerateNodeArgName(output->Name());
       }
+    }
+  }
 
-      // Check if constant folding can be applied on this node.
-      if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
-          !optimizer_utils::IsOperationDeterministic(node->Domain(), node->OpType()) ||
-          // constant folding does not support executing a node that includes subgraphs (control flow operators,
-          // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
-          // by the Recurse call above
-          node->ContainsSubgraph() || !graph_utils::AllNodeInputsAreConstant(graph, *node, constant_inputs, excluded_initializers_)) {
-        continue;
-      }
+  for (const auto& initializer : branch->GetAllInitializedTensors()) {
+    ONNX_NAMESPACE::TensorProto renamed_initializer{*initializer.second};
+    renamed_initializer.set_name(graph.GenerateNodeArgName(initializer.first));
+    renamed[initializer.first] = renamed_initializer.name();
+    graph.AddInitializedTensor(renamed_initializer);
+  }
 
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_);
+  auto get_node_arg = [&graph, &renamed](const NodeArg* arg) -> NodeArg* {
+    if (!arg->Exists()) {
+      return &graph.GetOrCreateNodeArg("", nullptr);
+    }
 
-      std::vector<int> fetch_mlvalue_idxs;
-      for (const auto* node_out : node->OutputDefs()) {
-        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
-      }
+    auto entry = renamed.find(arg->Name());
+    return &graph.GetOrCreateNodeArg(entry != renamed.cend() ? entry->second : arg->Name(), arg->TypeAsProto());
+  };
 
-      // override the EP assigned to the node so that it will use the CPU kernel for Compute.
-      if (!cpu_ep) {
-        node->SetExecutionProviderType(kCpuExecutionProvider);
-      }
+  for (const auto& branch_node : branch->Nodes()) {
+    std::vector<NodeArg*> inputs;
+    std::vector<NodeArg*> outputs;
+    for (const auto* input : branch_node.InputDefs()) {
+      inputs.push_back(get_node_arg(input));
+    }
+
+    for (const auto* output : branch_node.OutputDefs()) {
+      outputs.push_back(get_node_arg(output));
+    }
+
+    auto& inlined = graph.AddNode(graph.GenerateNodeName(branch_node.Name()), branch_node.OpType(),
+                                  branch_node.Description(), inputs, outputs, &branch_node.GetAttributes(),
+                                  branch_node.Domain());
+    inlined.SetExecutionProviderType(node.GetExecutionProviderType());
+  }
+
+  // branch outputs that are not produced by a node of the branch, such as an outer scope value, an initializer or
+  // an output repeated in the list, are copied to the If node output
+  for (size_t i = 0; i < branch_outputs.size(); ++i) {
+    auto entry = renamed.find(branch_outputs[i]->Name());
+    if (entry == renamed.cend() || entry->second != if_outputs[i]->Name()) {
+      auto& identity = graph.AddNode(graph.GenerateNodeName(node.Name() + "_Identity"), "Identity", "",
+                                     {get_node_arg(branch_outputs[i])},
+                                     {&graph.GetOrCreateNodeArg(if_outputs[i]->Name(), if_outputs[i]->TypeAsProto())});
+      identity.SetExecutionProviderType(node.GetExecutionProviderType());
+    }
+  }
+
+  return true;
+}
+
+bool ConstantFolding::CanComputeNode(const Graph& graph, const Node& node,
+                                     InitializedTensorSet& constant_inputs) const {
+  // we currently constant fold using the CPU EP only.
+  // if the node is assigned to a different EP we can run it if it's an ONNX op as we have CPU based
+  // implementations for all ONNX ops. If the node/op is from a different op domain or if the CPU implementation
+  // does not support the specific input type(s) required by the node (currently we only support a subset of
+  // types in some CPU kernels) then we can't proceed with constant folding for the node.
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider && node.Domain() != kOnnxDomain) {
+    return false;
+  }
+
+  InitializedTensorSet node_constant_inputs;
+
+  // Check if constant folding can be applied on this node.
+  if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+      !optimizer_utils::IsOperationDeterministic(node.Domain(), node.OpType()) ||
+      // constant folding does not support executing a node that includes subgraphs (control flow operators,
+      // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
+      // by the Recurse call in ApplyImpl
+      node.ContainsSubgraph() ||
+      !graph_utils::AllNodeInputsAreConstant(graph, node, node_constant_inputs, excluded_initializers_)) {
+    return false;
+  }
+
+  constant_inputs.insert(node_constant_inputs.cbegin(), node_constant_inputs.cend());
+  return true;
+}
+
+Status ConstantFolding::ComputeNodes(Graph& graph, const std::vector<Node*>& nodes,
+                                     const InitializedTensorSet& constant_inputs,
+                                     std::unordered_map<std::string, OrtValue>& computed_values,
+                                     std::unordered_set<NodeIndex>& failed_nodes, bool& modified,
+                                     const logging::Logger& logger) const {
+  // The nodes only consume initializers so they're independent of each other and share one execution frame.
+  // The initializers computed by the previous level are taken from computed_values rather than converted back from
+  // their TensorProto.
+  std::vector<const Node*> const_nodes(nodes.cbegin(), nodes.cend());
+  OptimizerExecutionFrame::Info info(const_nodes, constant_inputs, graph.ModelPath(), execution_provider_,
+                                     &computed_values);
+
+  std::vector<int> fetch_mlvalue_idxs;
+  std::vector<std::unique_ptr<const OpKernel>> kernels;
+  kernels.reserve(nodes.size());
+  for (Node* node : nodes) {
+    for (const auto* node_out : node->OutputDefs()) {
+      fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+    }
+
+    // override the EP assigned to the node so that it will use the CPU kernel for Compute.
+    auto ep_type = node->GetExecutionProviderType();
+    bool cpu_ep = ep_type == kCpuExecutionProvider;
+    if (!cpu_ep) {
+      node->SetExecutionProviderType(kCpuExecutionProvider);
+    }
+
+    kernels.push_back(info.CreateKernel(node));
+
+    // undo the EP change to the value that was assigned at graph partitioning time
+    if (!cpu_ep) {
+      node->SetExecutionProviderType(ep_type);
+    }
+
+    if (kernels.back() == nullptr) {
+      LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
+                            << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+      failed_nodes.insert(node->Index());
+    }
+  }
+
+  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+
+  // each node writes its own outputs only, so the nodes can run concurrently on the frame
+  std::vector<Status> statuses(nodes.size());
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(nodes.size()), [&](std::ptrdiff_t i) {
+        if (kernels[i] == nullptr) {
+          return;
+        }
+
+        ORT_TRY {
+          OpKernelContext op_kernel_context(&frame, kernels[i].get(), nullptr, logger);
+          statuses[i] = kernels[i]->Compute(&op_kernel_context);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+          });
+        }
+      });
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  ORT_ENFORCE(fetches.size() == fetch_mlvalue_idxs.size());
+
+  computed_values.clear();
+  size_t first_fetch_idx = 0;
+  for (size_t node_idx = 0; node_idx < nodes.size(); ++node_idx) {
+    Node& node = *nodes[node_idx];
+    const size_t num_fetches = node.OutputDefs().size();
+    const size_t end_fetch_idx = first_fetch_idx + num_fetches;
+    if (kernels[node_idx] == nullptr) {
+      first_fetch_idx = end_fetch_idx;
+      continue;
+    }
 
-      auto kernel = info.CreateKernel(node);
+    // Go over all output node args and substitute them with the newly computed tensors, which will be
+    // added to the graph as initializers.
+    bool converted_to_constant = true;
+    for (size_t fetch_idx = first_fetch_idx; fetch_idx < end_fetch_idx; ++fetch_idx) {
+      OrtValue& ort_value = fetches[fetch_idx];
 
-      // undo the EP change to the value that was assigned at graph partitioning time
-      if (!cpu_ep) {
-        node->SetExecutionProviderType(ep_type);
+      if (!ort_value.IsTensor()) {
+        LOGS(logger, WARNING) << "Unsupported output type of " << ort_value.Type()
+                              << ". Can't constant fold " << node.OpType() << " node '" << node.Name() << "'";
+        converted_to_constant = false;
+        break;
       }
+    }
 
-      if (kernel == nullptr) {
-        LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
-                              << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+    if (!converted_to_constant) {
+      failed_nodes.insert(node.Index());
+      first_fetch_idx = end_fetch_idx;
+      continue;
+    }
 
-        // Move on to the next candidate node
-        continue;
+    for (size_t fetch_idx = first_fetch_idx; fetch_idx < end_fetch_idx; ++fetch_idx) {
+      OrtValue& ort_value = fetches[fetch_idx];
+      // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
+      auto* constant_arg_out = node.MutableOutputDefs()[fetch_idx - first_fetch_idx];
+      const Tensor& out_tensor = ort_value.Get<Tensor>();
+      ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
+
+      ONNX_NAMESPACE::TensorShapeProto result_shape;
+      for (auto& dim : out_tensor.Shape().GetDims()) {
+        result_shape.add_dim()->set_dim_value(dim);
       }
 
-      OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+      constant_arg_out->SetShape(result_shape);
+      graph.AddInitializedTensor(out_tensorproto);
+      computed_values.emplace(constant_arg_out->Name(), ort_value);
+    }
 
-      OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, logger);
-      ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+    first_fetch_idx = end_fetch_idx;
 
-      std::vector<OrtValue> fetches;
-      ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+    // Remove the output edges of the constant node and then remove the node itself.
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+    modified = true;
+  }
 
-      // Go over all output node args and substitute them with the newly computed tensors, which will be
-      // added to the graph as initializers.
-      ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
-      converted_to_constant = true;
-      for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-        OrtValue& ort_value = fetches[fetch_idx];
+  return Status::OK();
+}
 
-        if (!ort_value.IsTensor()) {
-          LOGS(logger, WARNING) << "Unsupported output type of " << ort_value.Type()
-                                << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-          converted_to_constant = false;
-          break;
-        }
+Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  bool have_updated_nodes = false;
+  bool is_first_level = true;
+  std::unordered_set<NodeIndex> failed_nodes;
+  std::unordered_map<std::string, OrtValue> computed_values;
+
+  // Each iteration walks the graph, folds the Shape and If nodes that can be folded as it goes, and collects the
+  // nodes whose inputs are all constant. These are computed together, which makes the nodes consuming their
+  // outputs foldable in the next iteration.
+  for (;;) {
+    std::vector<Node*> nodes_to_compute;
+    InitializedTensorSet constant_inputs;
+
+    GraphViewer graph_viewer(graph);
+    auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+    for (NodeIndex i : order) {
+      auto* node = graph.GetNode(i);
+      if (!node) {
+        continue;
+      }
+
+      if (is_first_level) {
+        ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+      }
+
+      // Updating a node may allow shape inferencing to infer output shapes of following nodes,
+      // so re-run the shape inferencing. use have_updated_nodes as that only applies to this Graph
+      // (vs. 'modified' which is passed into subgraphs and applies to the main graph and all subgraphs)
+      // Ignore any control flow node containing subgraphs as UpdateShapeInference is not intended to be used on it.
+      if (have_updated_nodes && !node->ContainsSubgraph()) {
+        ORT_RETURN_IF_ERROR(graph.UpdateShapeInference(*node));
+      }
+
+      // the If node is replaced by the nodes of the branch taken so it's removed the same way as a folded node
+      bool converted_to_constant = false;
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "If", {1, 11}) &&
+          graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+        converted_to_constant = InlineConstantIfNode(graph, *node, excluded_initializers_);
+      } else if (node->OpType().compare("Shape") == 0) {
+        converted_to_constant = ConstantFoldShapeNode(graph, *node);
+      } else if (failed_nodes.count(node->Index()) == 0 && CanComputeNode(graph, *node, constant_inputs)) {
+        nodes_to_compute.push_back(node);
       }
 
       if (converted_to_constant) {
-        for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-          OrtValue& ort_value = fetches[fetch_idx];
-          // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
-          auto* constant_arg_out = node->MutableOutputDefs()[fetch_idx];
-          const Tensor& out_tensor = ort_value.Get<Tensor>();
-          ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
-
-          ONNX_NAMESPACE::TensorShapeProto result_shape;
-          for (auto& dim : out_tensor.Shape().GetDims()) {
-            result_shape.add_dim()->set_dim_value(dim);
-          }
-
-          constant_arg_out->SetShape(result_shape);
-          graph.AddInitializedTensor(out_tensorproto);
-        }
+        // Remove the output edges of the constant node and then remove the node itself.
+        graph_utils::RemoveNodeOutputEdges(graph, *node);
+        graph.RemoveNode(node->Index());
+        modified = true;
+        have_updated_nodes = true;
       }
     }
 
-    if (converted_to_constant) {
-      // Remove the output edges of the constant node and then remove the node itself.
-      graph_utils::RemoveNodeOutputEdges(graph, *node);
-      graph.RemoveNode(node->Index());
-      modified = true;
-      have_updated_nodes = true;
+    is_first_level = false;
+    if (nodes_to_compute.empty()) {
+      break;
     }
+
+    bool level_modified = false;
+    ORT_RETURN_IF_ERROR(ComputeNodes(graph, nodes_to_compute, constant_inputs, computed_values, failed_nodes,
+                                     level_modified, logger));
+    if (!level_modified) {
+      break;
+    }
+
+    modified = true;
+    have_updated_nodes = true;
   }
 
   return Status::OK();
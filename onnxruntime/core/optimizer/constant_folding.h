@@ -9,28 +9,48 @@
 #include "core/framework/execution_provider.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 /**
 @class ConstantFolding
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+The nodes are folded level by level: the nodes whose inputs are all constant are computed together, in parallel on
+the thread pool if one is given, and the nodes consuming their outputs are computed in the next level.
 */
 class ConstantFolding : public GraphTransformer {
  public:
   /*! Constant folding will not be applied to nodes that have one of initializers from excluded_initializers as input.
       For pre-training, the trainable weights are those initializers to be excluded.
       \param execution_provider Execution provider instance to execute constant folding.
+      \param thread_pool Thread pool to compute the nodes of a level in parallel. If nullptr they're computed serially.
   */
   ConstantFolding(const IExecutionProvider& execution_provider,
                   const std::unordered_set<std::string>& compatible_execution_providers = {},
-                  const std::unordered_set<std::string>& excluded_initializers = {}) noexcept;
+                  const std::unordered_set<std::string>& excluded_initializers = {},
+                  concurrency::ThreadPool* thread_pool = nullptr) noexcept;
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  // Check if the node can be computed, and if so add its constant inputs to constant_inputs.
+  bool CanComputeNode(const Graph& graph, const Node& node, InitializedTensorSet& constant_inputs) const;
+
+  // Compute the nodes of a level, which only consume constant initializers, and replace their outputs with
+  // initializers. The nodes that were folded are removed from the graph and nodes that can't be folded are added to
+  // failed_nodes. The outputs of the level are returned in computed_values so the next level uses them as is.
+  Status ComputeNodes(Graph& graph, const std::vector<Node*>& nodes, const InitializedTensorSet& constant_inputs,
+                      std::unordered_map<std::string, OrtValue>& computed_values,
+                      std::unordered_set<NodeIndex>& failed_nodes, bool& modified,
+                      const logging::Logger& logger) const;
+
   const std::unordered_set<std::string> excluded_initializers_;
   const IExecutionProvider& execution_provider_;
+  concurrency::ThreadPool* const thread_pool_;
 };
 
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
 
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
@@ -70,6 +71,38 @@ static bool GetClipConstantMinMax(const Graph& graph, const Node& node, float& m
   return min_max_are_constant_values;
 }
 
+// Test if this is an activation that can be fused and also extract the activation's parameters.
+static bool GetActivationParams(const Graph& graph, const Node& conv_node, const Node& next_node,
+                                std::vector<float>& activation_params) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Relu", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Tanh", {6, 13})) {
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LeakyRelu", {6})) {
+    activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "alpha")->f());
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Clip", {6, 11, 12, 13})) {
+    float min, max;
+    if (!GetClipConstantMinMax(graph, next_node, min, max)) {
+      return false;
+    }
+    activation_params.push_back(min);
+    activation_params.push_back(max);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "HardSigmoid", {6}) &&
+             conv_node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    // only the MLAS activations of the CPU FusedConv implement HardSigmoid
+    const auto* alpha = graph_utils::GetNodeAttribute(next_node, "alpha");
+    const auto* beta = graph_utils::GetNodeAttribute(next_node, "beta");
+    activation_params.push_back(alpha != nullptr ? alpha->f() : 0.2f);
+    activation_params.push_back(beta != nullptr ? beta->f() : 0.5f);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
 }  // namespace
 
 Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -90,43 +123,61 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
-    const auto& next_node = *(node->OutputNodesBegin());
-
-    if (next_node.GetExecutionProviderType() != node->GetExecutionProviderType()) {
+    if (!graph.GetNodeOutputsInGraphOutputs(*node).empty()) {
       continue;
     }
 
-    if (!graph.GetNodeOutputsInGraphOutputs(*node).empty()) {
+    Node& conv_node = *node;
+    Node* next_node = graph.GetNode(conv_node.OutputNodesBegin()->Index());
+
+    if (next_node->GetExecutionProviderType() != conv_node.GetExecutionProviderType()) {
       continue;
     }
 
-    // Test if this is an activation that can be fused and also extract the
-    // activation's parameters.
-    std::vector<float> activation_params;
-    if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Relu", {6, 13}) &&
-        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Sigmoid", {6, 13}) &&
-        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Tanh", {6, 13})) {
-      if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LeakyRelu", {6})) {
-        activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "alpha")->f());
-      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Clip", {6, 11, 12, 13})) {
-        float min, max;
-        if (GetClipConstantMinMax(graph, next_node, min, max)) {
-          activation_params.push_back(min);
-          activation_params.push_back(max);
-        } else {
-          continue;
+    // The CPU FusedConv adds the optional sum Z to the output before the activation, so an Add of a tensor with the
+    // same shape as the output, such as the residual of a ResNet block, is fused along with an activation after it.
+    NodeArg* sum = nullptr;
+    Node* add_node = nullptr;
+    if (conv_node.GetExecutionProviderType() == kCpuExecutionProvider) {
+      sum = optimizer_utils::GetFusableAddend(conv_node, *next_node);
+      if (sum != nullptr) {
+        add_node = next_node;
+        next_node = nullptr;
+        if (optimizer_utils::CheckOutputEdges(graph, *add_node, 1)) {
+          next_node = graph.GetNode(add_node->OutputNodesBegin()->Index());
         }
-      } else {
-        continue;
       }
     }
 
-    Node& conv_node = *node;
-    Node& act_node = *graph.GetNode(next_node.Index());
+    std::vector<float> activation_params;
+    Node* act_node = nullptr;
+    if (next_node != nullptr && next_node->GetExecutionProviderType() == conv_node.GetExecutionProviderType() &&
+        GetActivationParams(graph, conv_node, *next_node, activation_params)) {
+      act_node = next_node;
+    }
+
+    if (add_node == nullptr && act_node == nullptr) {
+      continue;
+    }
+
+    std::vector<NodeArg*> fused_inputs = conv_node.MutableInputDefs();
+    std::vector<std::reference_wrapper<Node>> fused_nodes{conv_node};
+    if (add_node != nullptr) {
+      if (fused_inputs.size() < 3) {
+        // The optional bias parameter is empty so set to an empty string.
+        fused_inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      }
+      fused_inputs.push_back(sum);
+      fused_nodes.push_back(*add_node);
+    }
+    if (act_node != nullptr) {
+      fused_nodes.push_back(*act_node);
+    }
 
     Node& fused_conv = graph.AddNode(graph.GenerateNodeName("fused " + conv_node.Name()), "FusedConv",
-                                     "fused Conv " + conv_node.Name() + "with activation " + act_node.OpType(),
-                                     conv_node.MutableInputDefs(),
+                                     "fused Conv " + conv_node.Name() + (add_node != nullptr ? " with Add" : "") +
+                                         (act_node != nullptr ? " with activation " + act_node->OpType() : ""),
+                                     fused_inputs,
                                      {},
                                      &conv_node.GetAttributes(),
                                      "com.microsoft");
@@ -135,13 +186,15 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
     fused_conv.SetExecutionProviderType(conv_node.GetExecutionProviderType());
 
     // Add attributes to specify the activation type and parameters.
-    fused_conv.AddAttribute("activation", next_node.OpType());
-    if (activation_params.size() > 0) {
-      fused_conv.AddAttribute("activation_params", activation_params);
+    if (act_node != nullptr) {
+      fused_conv.AddAttribute("activation", act_node->OpType());
+      if (activation_params.size() > 0) {
+        fused_conv.AddAttribute("activation_params", activation_params);
+      }
     }
 
-    // move output definitions and edges from act_node to fused_conv. delete conv_node and act_node.
-    graph_utils::FinalizeNodeFusion(graph, {conv_node, act_node}, fused_conv);
+    // move output definitions and edges from the last node to fused_conv. delete the fused nodes.
+    graph_utils::FinalizeNodeFusion(graph, fused_nodes, fused_conv);
 
     modified = true;
   }
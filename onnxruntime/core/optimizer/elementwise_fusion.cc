@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Operators the FusedElementwise kernel implements.
+bool IsChainOperator(const Node& node, bool& is_binary) {
+  is_binary = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13}) ||
+              graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13}) ||
+              graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13}) ||
+              graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13});
+  return is_binary ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13});
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool IsSingleValue(const TensorShapeProto& shape) {
+  for (const auto& dim : shape.dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether <shape>, padded with leading dims of 1 to the rank of <output_shape>, is known to be <output_shape>.
+bool HasOutputDims(const TensorShapeProto& shape, const TensorShapeProto& output_shape) {
+  const int padding = output_shape.dim_size() - shape.dim_size();
+  if (padding < 0) {
+    return false;
+  }
+
+  for (int i = 0; i < output_shape.dim_size(); ++i) {
+    const auto& output_dim = output_shape.dim(i);
+    if (i < padding) {
+      if (!utils::HasDimValue(output_dim) || output_dim.dim_value() != 1) {
+        return false;
+      }
+      continue;
+    }
+
+    const auto& dim = shape.dim(i - padding);
+    const bool same_value = utils::HasDimValue(dim) && utils::HasDimValue(output_dim) &&
+                            dim.dim_value() == output_dim.dim_value();
+    const bool same_param = utils::HasDimParam(dim) && utils::HasDimParam(output_dim) &&
+                            dim.dim_param() == output_dim.dim_param();
+    if (!same_value && !same_param) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The fused kernel doesn't broadcast other than from single values.
+bool IsCompatibleInput(const NodeArg& input, const TensorShapeProto& output_shape) {
+  const auto* shape = input.Shape();
+  return IsFloatTensor(input) && shape != nullptr && (IsSingleValue(*shape) || HasOutputDims(*shape, output_shape));
+}
+
+// An input edge of a node later in the chain, which has to be connected to the fused node.
+struct ChainInputEdge {
+  NodeIndex src_node;
+  int src_arg_index;
+  int dst_arg_index;
+};
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    bool is_binary = false;
+    if (!IsChainOperator(node, is_binary) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const NodeArg& output = *node.OutputDefs()[0];
+    const TensorShapeProto* output_shape = output.Shape();
+    if (output_shape == nullptr || !IsFloatTensor(output)) {
+      continue;
+    }
+
+    bool inputs_compatible = true;
+    for (const auto* input : node.InputDefs()) {
+      inputs_compatible = inputs_compatible && IsCompatibleInput(*input, *output_shape);
+    }
+    if (!inputs_compatible) {
+      continue;
+    }
+
+    // the inputs of the fused node are the inputs of the first node of the chain followed by the input that each
+    // later binary node of the chain combines the chain value with.
+    std::vector<std::reference_wrapper<Node>> chain{node};
+    std::vector<NodeArg*> fused_inputs = node.MutableInputDefs();
+    std::vector<std::string> ops{node.OpType()};
+    std::vector<int64_t> chain_input_indices{0};
+    std::vector<ChainInputEdge> chain_input_edges;
+
+    // the intermediate results of the chain must only be consumed by the next node of the chain
+    while (optimizer_utils::CheckOutputEdges(graph, chain.back(), 1)) {
+      const Node& last = chain.back();
+      Node& next = *graph.GetNode(last.OutputNodesBegin()->Index());
+
+      bool next_is_binary = false;
+      if (!IsChainOperator(next, next_is_binary) ||
+          next.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        break;
+      }
+
+      const TensorShapeProto* next_output_shape = next.OutputDefs()[0]->Shape();
+      if (next_output_shape == nullptr || next_output_shape->dim_size() != output_shape->dim_size() ||
+          !HasOutputDims(*next_output_shape, *output_shape)) {
+        break;
+      }
+
+      int64_t chain_input_index = 0;
+      if (next_is_binary) {
+        const auto& next_inputs = next.InputDefs();
+        if (next_inputs[0] == next_inputs[1]) {
+          break;  // both operands are the chain value
+        }
+
+        chain_input_index = next_inputs[0] == last.OutputDefs()[0] ? 0 : 1;
+        const int other_input = 1 - static_cast<int>(chain_input_index);
+        if (!IsCompatibleInput(*next_inputs[other_input], *output_shape)) {
+          break;
+        }
+
+        const Node::EdgeEnd* edge = graph_utils::GetInputEdge(next, other_input);
+        if (edge != nullptr) {
+          chain_input_edges.push_back({edge->GetNode().Index(), edge->GetSrcArgIndex(),
+                                       static_cast<int>(fused_inputs.size())});
+        }
+        fused_inputs.push_back(next.MutableInputDefs()[other_input]);
+      }
+
+      chain.push_back(next);
+      ops.push_back(next.OpType());
+      chain_input_indices.push_back(chain_input_index);
+    }
+
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                     "FusedElementwise",
+                                     "fused chain of elementwise operators",
+                                     fused_inputs,
+                                     {},
+                                     {},
+                                     kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("chain_input_indices", chain_input_indices);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // FinalizeNodeFusion only moves the input edges of the first node of the chain
+    for (const auto& edge : chain_input_edges) {
+      graph.AddEdge(edge.src_node, fused_node.Index(), edge.src_arg_index, edge.dst_arg_index);
+    }
+
+    graph_utils::FinalizeNodeFusion(graph, chain, fused_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
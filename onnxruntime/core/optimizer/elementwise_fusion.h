@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuse chains of float unary and binary elementwise operators (Add, Sub, Mul, Div, Abs, Erf, Exp, Neg, Relu, Sigmoid,
+Sqrt, Tanh) into a FusedElementwise node, which runs the whole chain on a tile of the output at a time instead of
+writing and reading back every intermediate result.
+
+Every node of a chain has the same output shape, and every input that doesn't come from the previous node of the
+chain either has that shape or holds a single value, so the chain never broadcasts beyond scalars.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+int32_t ElementType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() ? type->tensor_type().elem_type()
+                                                    : TensorProto_DataType_UNDEFINED;
+}
+
+bool HasRank(const NodeArg& arg, int rank) {
+  const auto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() == rank;
+}
+
+// Whether the shapes are known to be the same, comparing symbolic dims by name.
+bool HaveSameShape(const NodeArg& arg, const NodeArg& other) {
+  const auto* shape = arg.Shape();
+  const auto* other_shape = other.Shape();
+  if (shape == nullptr || other_shape == nullptr || shape->dim_size() != other_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const auto& other_dim = other_shape->dim(i);
+    const bool same_value = utils::HasDimValue(dim) && utils::HasDimValue(other_dim) &&
+                            dim.dim_value() == other_dim.dim_value();
+    const bool same_param = utils::HasDimParam(dim) && utils::HasDimParam(other_dim) &&
+                            dim.dim_param() == other_dim.dim_param();
+    if (!same_value && !same_param) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The axes of Unsqueeze or of a Reduce operator, given as an attribute or, since opset 13, as a constant input.
+bool GetAxes(const Graph& graph, const Node& node, std::vector<int64_t>& axes) {
+  if (node.InputDefs().size() > 1) {
+    return optimizer_utils::AppendTensorFromInitializer(graph, *node.InputDefs()[1], axes);
+  }
+
+  const auto* attr = graph_utils::GetNodeAttribute(node, "axes");
+  if (attr == nullptr) {
+    return false;
+  }
+  axes.assign(attr->ints().begin(), attr->ints().end());
+  return true;
+}
+
+bool HasSingleAxis(const Graph& graph, const Node& node, int64_t axis, int64_t negative_axis) {
+  std::vector<int64_t> axes;
+  return GetAxes(graph, node, axes) && axes.size() == 1 && (axes[0] == axis || axes[0] == negative_axis);
+}
+
+// The mode of EmbeddingBag that a Reduce operator over the bag axis computes, or nullptr.
+const char* ReduceMode(const Graph& graph, const Node& node) {
+  const char* mode = nullptr;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", {1, 11, 13})) {
+    mode = "sum";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11, 13})) {
+    mode = "mean";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMax", {1, 11, 12, 13})) {
+    mode = "max";
+  } else {
+    return nullptr;
+  }
+
+  // the gathered tensor is [num_bags, bag_size, embedding_dim]
+  if (!optimizer_utils::IsAttributeWithExpectedValue(node, "keepdims", static_cast<int64_t>(0)) ||
+      !HasSingleAxis(graph, node, 1, -2)) {
+    return nullptr;
+  }
+  return mode;
+}
+
+}  // namespace
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& gather = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(gather, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather, "Gather", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(gather, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::CheckOutputEdges(graph, gather, 1)) {
+      continue;
+    }
+
+    const NodeArg& weight = *gather.InputDefs()[0];
+    const NodeArg& indices = *gather.InputDefs()[1];
+    const auto* axis = graph_utils::GetNodeAttribute(gather, "axis");
+    if ((axis != nullptr && axis->i() != 0) || !HasRank(weight, 2) || !HasRank(indices, 2)) {
+      continue;
+    }
+
+    // the CPU kernel only supports float
+    const int32_t weight_type = ElementType(weight);
+    const bool is_cpu = gather.GetExecutionProviderType() == kCpuExecutionProvider;
+    if (weight_type != TensorProto_DataType_FLOAT && (is_cpu || weight_type != TensorProto_DataType_FLOAT16)) {
+      continue;
+    }
+
+    std::vector<std::reference_wrapper<Node>> nodes{gather};
+    Node* next = graph.GetNode(gather.OutputNodesBegin()->Index());
+    if (next->GetExecutionProviderType() != gather.GetExecutionProviderType()) {
+      continue;
+    }
+
+    // Mul(Gather(weight, indices), Unsqueeze(per_sample_weights, axes=[2]))
+    Node* unsqueeze = nullptr;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*next, "Mul", {7, 13})) {
+      const auto& mul_inputs = next->InputDefs();
+      const int other_input = mul_inputs[0] == gather.OutputDefs()[0] ? 1 : 0;
+      const Node* other_node = graph_utils::GetInputNode(*next, other_input);
+      if (mul_inputs[0] == mul_inputs[1] || other_node == nullptr ||
+          !graph_utils::IsSupportedOptypeVersionAndDomain(*other_node, "Unsqueeze", {1, 11, 13}) ||
+          other_node->GetExecutionProviderType() != gather.GetExecutionProviderType() ||
+          !optimizer_utils::CheckOutputEdges(graph, *other_node, 1) ||
+          !optimizer_utils::CheckOutputEdges(graph, *next, 1) ||
+          !HasSingleAxis(graph, *other_node, 2, -1)) {
+        continue;
+      }
+
+      const NodeArg& sample_weights = *other_node->InputDefs()[0];
+      if (ElementType(sample_weights) != weight_type || !HaveSameShape(sample_weights, indices)) {
+        continue;
+      }
+
+      unsqueeze = graph.GetNode(other_node->Index());
+      nodes.push_back(*next);
+      next = graph.GetNode(next->OutputNodesBegin()->Index());
+      if (next->GetExecutionProviderType() != gather.GetExecutionProviderType()) {
+        continue;
+      }
+    }
+
+    const char* mode = ReduceMode(graph, *next);
+    if (mode == nullptr || (unsqueeze != nullptr && std::string(mode) != "sum")) {
+      continue;
+    }
+    nodes.push_back(*next);
+
+    std::vector<NodeArg*> fused_inputs{gather.MutableInputDefs()[0], gather.MutableInputDefs()[1]};
+    if (unsqueeze != nullptr) {
+      fused_inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      fused_inputs.push_back(unsqueeze->MutableInputDefs()[0]);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                     "EmbeddingBag",
+                                     "fused embedding lookup and reduction",
+                                     fused_inputs,
+                                     {},
+                                     {},
+                                     kMSDomain);
+    fused_node.AddAttribute("mode", std::string(mode));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(gather.GetExecutionProviderType());
+
+    // FinalizeNodeFusion only moves the input edges of Gather, the weights come from the input of Unsqueeze
+    if (unsqueeze != nullptr) {
+      const Node::EdgeEnd* edge = graph_utils::GetInputEdge(*unsqueeze, 0);
+      if (edge != nullptr) {
+        graph.AddEdge(edge->GetNode().Index(), fused_node.Index(), edge->GetSrcArgIndex(), 3);
+      }
+    }
+
+    graph_utils::FinalizeNodeFusion(graph, nodes, fused_node);
+
+    if (unsqueeze != nullptr) {
+      // the removed Mul was the only consumer of Unsqueeze
+      graph_utils::RemoveNodeOutputEdges(graph, *unsqueeze);
+      graph.RemoveNode(unsqueeze->Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
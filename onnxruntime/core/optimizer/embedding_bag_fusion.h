@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class EmbeddingBagFusion
+
+Fuse the embedding lookups that exporters emit for EmbeddingBag, i.e. a Gather from a 2-D table with 2-D indices
+followed by ReduceSum, ReduceMean or ReduceMax over the bag axis, into an EmbeddingBag node, which reduces the rows
+of every bag without materializing the gathered [num_bags, bag_size, embedding_dim] tensor.
+
+A Mul of the gathered rows by Unsqueeze(weights, axes=[2]) between Gather and ReduceSum becomes the
+per_sample_weights input of the fused node.
+*/
+class EmbeddingBagFusion : public GraphTransformer {
+ public:
+  EmbeddingBagFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("EmbeddingBagFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
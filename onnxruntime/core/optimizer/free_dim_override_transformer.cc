@@ -104,6 +104,12 @@ Status FreeDimensionOverrideTransformer::ApplyImpl(Graph& graph, bool& modified,
     }
   }
 
+  if (modified) {
+    // Changing a graph input doesn't otherwise trigger shape inferencing when the graph is resolved, so the
+    // overrides would only reach the rest of the graph once another transformer modified it.
+    graph.SetGraphResolveNeeded();
+  }
+
   return Status::OK();
 }
 
@@ -4,6 +4,7 @@
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
 
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
@@ -36,6 +37,18 @@ bool IsFusableActivation(const Node& node) {
 #endif
          IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {1, 10}, kOnnxDomain);
 }
+
+// The CUDA FusedGemm is for float and float16, with the activations the epilogue of the cuBLASLt matmuls supports.
+bool IsCudaFusableActivation(const Node& gemm_node, const Node& node) {
+  const auto* type = gemm_node.InputDefs()[0]->TypeAsProto();
+  if (type == nullptr || (type->tensor_type().elem_type() != TensorProto_DataType_FLOAT &&
+                          type->tensor_type().elem_type() != TensorProto_DataType_FLOAT16)) {
+    return false;
+  }
+  return IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13}, kOnnxDomain) ||
+         // FastGelu without its bias input, which would be added after the activation
+         (IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) && node.InputDefs().size() == 1);
+}
 }  // namespace
 
 Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
@@ -56,38 +69,77 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
-    const Node& next_node = *(node.OutputNodesBegin());
-    if (!IsFusableActivation(next_node) || next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    if (!graph.GetNodeOutputsInGraphOutputs(node).empty()) {
       continue;
     }
 
-    if (!graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    Node& gemm_node = node;
+    Node* next_node = graph.GetNode(gemm_node.OutputNodesBegin()->Index());
+
+    // The CPU FusedGemm adds the optional (M, N) sum Z to the output before the activation, so an Add of a tensor
+    // with the same shape as the output is fused along with an activation after it.
+    NodeArg* sum = nullptr;
+    Node* add_node = nullptr;
+    if (gemm_node.GetExecutionProviderType() == kCpuExecutionProvider) {
+      sum = optimizer_utils::GetFusableAddend(gemm_node, *next_node);
+      if (sum != nullptr) {
+        add_node = next_node;
+        next_node = nullptr;
+        if (optimizer_utils::CheckOutputEdges(graph, *add_node, 1)) {
+          next_node = graph.GetNode(add_node->OutputNodesBegin()->Index());
+        }
+      }
+    }
+
+    Node* act_node = nullptr;
+    if (next_node != nullptr && next_node->GetExecutionProviderType() == gemm_node.GetExecutionProviderType() &&
+        (gemm_node.GetExecutionProviderType() == kCudaExecutionProvider
+             ? IsCudaFusableActivation(gemm_node, *next_node)
+             : IsFusableActivation(*next_node))) {
+      act_node = next_node;
+    }
+
+    if (add_node == nullptr && act_node == nullptr) {
       continue;
     }
 
-    Node& gemm_node = node;
-    Node& act_node = *graph.GetNode(next_node.Index());  // get mutable reference
+    std::vector<NodeArg*> fused_inputs = gemm_node.MutableInputDefs();
+    std::vector<std::reference_wrapper<Node>> fused_nodes{gemm_node};
+    if (add_node != nullptr) {
+      if (fused_inputs.size() < 3) {
+        // The optional C input is empty so set to an empty string.
+        fused_inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      }
+      fused_inputs.push_back(sum);
+      fused_nodes.push_back(*add_node);
+    }
+    if (act_node != nullptr) {
+      fused_nodes.push_back(*act_node);
+    }
 
     Node& fused_gemm = graph.AddNode(graph.GenerateNodeName("fused " + gemm_node.Name()), "FusedGemm",
-                                     "fused Gemm " + gemm_node.Name() + "with activation " + act_node.OpType(),
-                                     gemm_node.MutableInputDefs(), {}, &gemm_node.GetAttributes(), "com.microsoft");
-
-    // Add a new attribute to specify the activation type
-    fused_gemm.AddAttribute("activation", act_node.OpType());
+                                     "fused Gemm " + gemm_node.Name() + (add_node != nullptr ? " with Add" : "") +
+                                         (act_node != nullptr ? " with activation " + act_node->OpType() : ""),
+                                     fused_inputs, {}, &gemm_node.GetAttributes(), "com.microsoft");
 
     // Assign provider to this new node. Provider should be same as the provider for old node.
     fused_gemm.SetExecutionProviderType(gemm_node.GetExecutionProviderType());
 
-    // Add optional attributes for activations
-    const NodeAttributes& attrs = act_node.GetAttributes();
-    for (const auto& attr : attrs) {
-      AttributeProto fused_gemm_attr(attr.second);
-      fused_gemm_attr.set_name("activation_" + attr.first);
-      fused_gemm.AddAttribute("activation_" + attr.first, fused_gemm_attr);
+    if (act_node != nullptr) {
+      // Add a new attribute to specify the activation type
+      fused_gemm.AddAttribute("activation", act_node->OpType());
+
+      // Add optional attributes for activations
+      const NodeAttributes& attrs = act_node->GetAttributes();
+      for (const auto& attr : attrs) {
+        AttributeProto fused_gemm_attr(attr.second);
+        fused_gemm_attr.set_name("activation_" + attr.first);
+        fused_gemm.AddAttribute("activation_" + attr.first, fused_gemm_attr);
+      }
     }
 
-    // move output definitions and edges from act_node to fused_gemm. delete gemm_node and act_node.
-    graph_utils::FinalizeNodeFusion(graph, {gemm_node, act_node}, fused_gemm);
+    // move output definitions and edges from the last node to fused_gemm. delete the fused nodes.
+    graph_utils::FinalizeNodeFusion(graph, fused_nodes, fused_gemm);
 
     modified = true;
   }
@@ -106,7 +106,7 @@ class NchwcTransformerImpl {
   size_t RemoveOutputEdges(Node& node);
   void CreateNchwcArgument(Node& node, Node& nchwc_node, int64_t channels, const NchwcArgument::Shape& shape);
   void FuseNchwcArgument(Node& node, const NchwcArgument& nchwc_arg);
-  void InsertReorderInput(Node& node);
+  void InsertReorderInput(Node& node, size_t input_index = 0);
 
   void ConvPoolShapeInference(const Node& node,
                               const NchwcArgument::Shape& input_shape,
@@ -116,9 +116,12 @@ class NchwcTransformerImpl {
   void TransformConv(Node& node);
   void TransformPool(Node& node);
   void TransformBinary(Node& node, bool add_node);
+  bool TransformScaleChannels(Node& node);
   void TransformConcat(Node& node);
+  void TransformSplit(Node& node);
   void TransformActivation(Node& node);
   void TransformBatchNormalization(Node& node);
+  void TransformInstanceNormalization(Node& node);
   void TransformTranspose(Node& node);
   void TransformResize(Node& node);
 
@@ -179,15 +182,14 @@ void NchwcTransformerImpl::FuseNchwcArgument(Node& node, const NchwcArgument& nc
 
   // Associate the existing NCHWc NodeArg with the output from this node.
   auto* output_original_arg = node.MutableOutputDefs()[0];
-  auto& nchwc_node = nchwc_arg.output_node_;
-  auto* output_nchwc_arg = nchwc_node.MutableOutputDefs()[0];
   nchwc_args_[output_original_arg] =
-      onnxruntime::make_unique<NchwcArgument>(nchwc_node, output_nchwc_arg, original_uses, nchwc_arg.channels_, nchwc_arg.shape_);
+      onnxruntime::make_unique<NchwcArgument>(nchwc_arg.output_node_, nchwc_arg.nchwc_arg_, original_uses,
+                                              nchwc_arg.channels_, nchwc_arg.shape_);
 }
 
-void NchwcTransformerImpl::InsertReorderInput(Node& node) {
+void NchwcTransformerImpl::InsertReorderInput(Node& node, size_t input_index) {
   auto& input_defs = node.MutableInputDefs();
-  auto* input_original_arg = input_defs[0];
+  auto* input_original_arg = input_defs[input_index];
 
   auto it = reorder_inputs_.find(input_original_arg);
   if (it == reorder_inputs_.end()) {
@@ -202,9 +204,9 @@ void NchwcTransformerImpl::InsertReorderInput(Node& node) {
                                               nullptr,
                                               kMSNchwcDomain);
     reorder_input_node.SetExecutionProviderType(kCpuExecutionProvider);
-    input_defs[0] = input_nchwc_arg;
+    input_defs[input_index] = input_nchwc_arg;
   } else {
-    input_defs[0] = it->second;
+    input_defs[input_index] = it->second;
   }
 }
 
@@ -343,7 +345,7 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
 
   // Also require that the optional bias tensor be static.
   const ONNX_NAMESPACE::TensorProto* conv_B_tensor_proto = nullptr;
-  if (input_defs.size() >= 3) {
+  if (input_defs.size() >= 3 && input_defs[2]->Exists()) {
     if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[2]) ||
         !graph_.GetInitializedTensor(input_defs[2]->Name(), conv_B_tensor_proto) ||
         (conv_B_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
@@ -353,6 +355,23 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
     }
   }
 
+  // The optional sum tensor of FusedConv becomes the Sum input of the NCHWc
+  // convolution. Unless it's already in NCHWc format, it's reordered, which
+  // requires the channel count to be a multiple of the block size.
+  NchwcArgument* nchwc_sum = nullptr;
+  bool has_sum = input_defs.size() >= 4 && input_defs[3]->Exists();
+  if (has_sum) {
+    auto it = nchwc_args_.find(input_defs[3]);
+    if (it != nchwc_args_.end()) {
+      nchwc_sum = it->second.get();
+      if (nchwc_sum->channels_ != output_channels) {
+        return;
+      }
+    } else if ((output_channels % nchwc_block_size) != 0) {
+      return;
+    }
+  }
+
   // Check if the filter has already been converted to the target format.
   std::unordered_map<NodeArg*, NodeArg*>* filters_map;
   if (reorder_filter_OIHWBo) {
@@ -436,6 +455,13 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
     nchwc_node.MutableInputDefs()[2] = nchwc_conv_B_arg;
   }
 
+  if (nchwc_sum != nullptr) {
+    nchwc_node.MutableInputDefs()[3] = nchwc_sum->nchwc_arg_;
+    nchwc_sum->remaining_original_uses_--;
+  } else if (has_sum) {
+    InsertReorderInput(nchwc_node, 3);
+  }
+
   NchwcArgument::Shape output_shape(output_defs[0]);
 
   if (do_reorder_input) {
@@ -584,7 +610,7 @@ void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
           nchwc_input_defs[2] = &graph_.GetOrCreateNodeArg("", nullptr);
           nchwc_input_args_count[2] = 1;
         }
-        nchwc_input_defs[3] = nchwc_inputs[n ^ 1]->output_node_.MutableOutputDefs()[0];
+        nchwc_input_defs[3] = nchwc_inputs[n ^ 1]->nchwc_arg_;
         nchwc_input_args_count[3] = 1;
 
         FuseNchwcArgument(node, *nchwc_input_n);
@@ -597,6 +623,89 @@ void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
   CreateNchwcArgument(node, node, nchwc_input_0->channels_, nchwc_input_0->shape_);
 }
 
+// Squeeze and excite blocks multiply a tensor by a channel scale that is
+// computed from a global pooling of the tensor. If both inputs of the Mul node
+// are in NCHWc format and one input has a spatial shape of 1x1, then the Mul
+// node is replaced by a NCHWc node that broadcasts the channel scale.
+bool NchwcTransformerImpl::TransformScaleChannels(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  if (input_defs.size() != 2) {
+    return false;
+  }
+
+  NchwcArgument* nchwc_inputs[2];
+  for (size_t n = 0; n < 2; n++) {
+    auto it = nchwc_args_.find(input_defs[n]);
+    if (it == nchwc_args_.end()) {
+      return false;
+    }
+    nchwc_inputs[n] = it->second.get();
+  }
+
+  auto has_unit_spatial_shape = [](const NodeArg* arg) {
+    const auto* shape = arg->Shape();
+    if ((shape == nullptr) || (shape->dim_size() != kNchwcDims)) {
+      return false;
+    }
+    for (int i = kNchwcBatchChannelDims; i < kNchwcDims; i++) {
+      auto& dim = shape->dim(i);
+      if (!utils::HasDimValue(dim) || (dim.dim_value() != 1)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Use the elementwise Mul if both or neither of the inputs have a spatial
+  // shape of 1x1.
+  bool is_scale_0 = has_unit_spatial_shape(input_defs[0]);
+  bool is_scale_1 = has_unit_spatial_shape(input_defs[1]);
+  if (is_scale_0 == is_scale_1) {
+    return false;
+  }
+  size_t scale_index = is_scale_0 ? 0 : 1;
+  auto* nchwc_input = nchwc_inputs[scale_index ^ 1];
+  auto* nchwc_scale = nchwc_inputs[scale_index];
+
+  if (nchwc_input->channels_ != nchwc_scale->channels_) {
+    return false;
+  }
+
+  // The scale must either have the same batch count as the input or a single
+  // batch that is broadcast.
+  if (!nchwc_input->shape_.IsDimEqual(nchwc_scale->shape_, 0)) {
+    const auto* scale_shape = input_defs[scale_index]->Shape();
+    auto& scale_batch_dim = scale_shape->dim(0);
+    if (!utils::HasDimValue(scale_batch_dim) || (scale_batch_dim.dim_value() != 1)) {
+      const auto* input_shape = input_defs[scale_index ^ 1]->Shape();
+      if ((input_shape == nullptr) || (input_shape->dim_size() != kNchwcDims) ||
+          !utils::HasDimValue(scale_batch_dim) || !utils::HasDimValue(input_shape->dim(0)) ||
+          (scale_batch_dim.dim_value() != input_shape->dim(0).dim_value())) {
+        return false;
+      }
+    }
+  }
+
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "ScaleChannels",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_, nchwc_scale->nchwc_arg_},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  nchwc_input->remaining_original_uses_--;
+  nchwc_scale->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+  return true;
+}
+
 void NchwcTransformerImpl::TransformConcat(Node& node) {
   auto& input_defs = node.MutableInputDefs();
   auto& output_defs = node.MutableOutputDefs();
@@ -643,8 +752,88 @@ void NchwcTransformerImpl::TransformConcat(Node& node) {
   CreateNchwcArgument(node, node, total_channels, output_shape);
 }
 
+// The existing Split operator implementation can be used with a tensor in
+// NCHWc format if the split is along the channel axis and each of the outputs
+// has a block aligned number of channels.
+void NchwcTransformerImpl::TransformSplit(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  // Verify that this is a split along the channel axis.
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr) || (axis_attr->i() != 1 && axis_attr->i() != 1 - kNchwcDims)) {
+    return;
+  }
+
+  const size_t nchwc_block_size = MlasNchwcGetBlockSize();
+  const int64_t channels = nchwc_input->channels_;
+  if ((channels % nchwc_block_size) != 0) {
+    return;
+  }
+
+  // Without the split attribute, the channels are split equally.
+  const size_t output_defs_count = output_defs.size();
+  std::vector<int64_t> split;
+  const auto* split_attr = graph_utils::GetNodeAttribute(node, "split");
+  if (split_attr != nullptr) {
+    split.assign(split_attr->ints().begin(), split_attr->ints().end());
+  }
+  if (split.empty()) {
+    if ((channels % static_cast<int64_t>(output_defs_count)) != 0) {
+      return;
+    }
+    split.resize(output_defs_count, channels / static_cast<int64_t>(output_defs_count));
+  }
+
+  if (split.size() != output_defs_count) {
+    return;
+  }
+  int64_t total_channels = 0;
+  for (auto split_channels : split) {
+    if (split_channels <= 0 || (split_channels % nchwc_block_size) != 0) {
+      return;
+    }
+    total_channels += split_channels;
+  }
+  if (total_channels != channels) {
+    return;
+  }
+
+  // Count the uses of each of the outputs before removing the output edges.
+  std::vector<size_t> output_uses(output_defs_count, 0);
+  for (auto edge = node.OutputEdgesBegin(); edge != node.OutputEdgesEnd(); ++edge) {
+    output_uses[edge->GetSrcArgIndex()]++;
+  }
+  for (int output_index : graph_.GetNodeOutputsInGraphOutputs(node)) {
+    output_uses[output_index]++;
+  }
+  graph_utils::RemoveNodeOutputEdges(graph_, node);
+
+  input_defs[0] = nchwc_input->nchwc_arg_;
+  nchwc_input->remaining_original_uses_--;
+
+  // Create a NCHWc output for each of the outputs. Copy the shape from the
+  // NCHWc input, but use the output for the channel dimension.
+  for (size_t n = 0; n < output_defs_count; n++) {
+    auto* output_original_arg = output_defs[n];
+    auto* output_nchwc_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName("reorder"), nullptr);
+    NchwcArgument::Shape output_shape = nchwc_input->shape_;
+    output_shape.dims_[1] = output_original_arg;
+    nchwc_args_[output_original_arg] =
+        onnxruntime::make_unique<NchwcArgument>(node, output_nchwc_arg, output_uses[n], split[n], output_shape);
+    output_defs[n] = output_nchwc_arg;
+  }
+}
+
 // After doing a Conv/Add fusion, there may be an activation node that could now
-// be fused into the Conv node as well. Otherwise, this is an elementwise
+// be fused into the Conv node as well. An activation following an instance
+// normalization is fused in the same way. Otherwise, this is an elementwise
 // operation that can directly use the NCHWc input.
 void NchwcTransformerImpl::TransformActivation(Node& node) {
   auto& input_defs = node.MutableInputDefs();
@@ -655,13 +844,25 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
     input_defs[0] = nchwc_input->nchwc_arg_;
     nchwc_input->remaining_original_uses_--;
 
-    // Check if this is a single use NCHWc convolution that hasn't already
-    // been fused with another activation.
+    // Check if this is a single use NCHWc convolution or instance
+    // normalization that hasn't already been fused with another activation.
     auto& nchwc_node = nchwc_input->output_node_;
-    if ((nchwc_node.OpType() == "Conv") && (nchwc_node.Domain() == kMSNchwcDomain) &&
+    if ((nchwc_node.OpType() == "Conv" || nchwc_node.OpType() == "InstanceNormalization") &&
+        (nchwc_node.Domain() == kMSNchwcDomain) &&
         (nchwc_input->starting_original_uses_ == 1) &&
         (graph_utils::GetNodeAttribute(nchwc_node, "activation") == nullptr)) {
       nchwc_node.AddAttribute("activation", node.OpType());
+      // Pass the parameters of the activation with their default values.
+      auto get_float_attr = [&node](const std::string& name, float default_value) {
+        const auto* attr = graph_utils::GetNodeAttribute(node, name);
+        return (attr != nullptr && utils::HasFloat(*attr)) ? attr->f() : default_value;
+      };
+      if (node.OpType() == "LeakyRelu") {
+        nchwc_node.AddAttribute("activation_params", std::vector<float>{get_float_attr("alpha", 0.01f)});
+      } else if (node.OpType() == "HardSigmoid") {
+        nchwc_node.AddAttribute("activation_params",
+                                std::vector<float>{get_float_attr("alpha", 0.2f), get_float_attr("beta", 0.5f)});
+      }
       FuseNchwcArgument(node, *nchwc_input);
       removed_nodes_.push_front(node.Index());
     } else {
@@ -790,6 +991,94 @@ void NchwcTransformerImpl::TransformBatchNormalization(Node& node) {
   removed_nodes_.push_front(node.Index());
 }
 
+// Transform InstanceNormalization to the NCHWc variant, which computes the
+// statistics of each channel directly from the NCHWc input. This also allows
+// fusing a following activation such as InstanceNormalization+Relu.
+void NchwcTransformerImpl::TransformInstanceNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Don't transform the node if the input is not already in NCHWc format.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  const int64_t channels = nchwc_input->channels_;
+
+  auto get_in_tensor_proto = [this, channels](const std::string& input_name) {
+    const auto* tensor_proto = graph_utils::GetConstantInitializer(graph_, input_name);
+    if (tensor_proto != nullptr) {
+      if ((tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+          (tensor_proto->dims_size() != 1) ||
+          (tensor_proto->dims(0) != channels)) {
+        tensor_proto = nullptr;
+      }
+    }
+    return tensor_proto;
+  };
+
+  const auto* in_scale_tensor_proto = get_in_tensor_proto(input_defs[1]->Name());
+  if (in_scale_tensor_proto == nullptr) {
+    return;
+  }
+  const auto* in_B_tensor_proto = get_in_tensor_proto(input_defs[2]->Name());
+  if (in_B_tensor_proto == nullptr) {
+    return;
+  }
+
+  Initializer in_scale{*in_scale_tensor_proto, graph_.ModelPath()};
+  Initializer in_B{*in_B_tensor_proto, graph_.ModelPath()};
+
+  const size_t nchwc_block_size = MlasNchwcGetBlockSize();
+  const int64_t nchwc_channels = (channels + nchwc_block_size - 1) & ~(nchwc_block_size - 1);
+
+  // Zero pad the scale and bias to the NCHWc channel count.
+  std::vector<float> padded_buffer(nchwc_channels);
+
+  std::copy_n(in_scale.data<float>(), channels, padded_buffer.data());
+
+  ONNX_NAMESPACE::TensorProto nchwc_scale_tensor_proto;
+  nchwc_scale_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_scale_tensor_proto.set_name(graph_.GenerateNodeArgName("in_scale"));
+  nchwc_scale_tensor_proto.set_raw_data(padded_buffer.data(), nchwc_channels * sizeof(float));
+  nchwc_scale_tensor_proto.add_dims(nchwc_channels);
+
+  auto* nchwc_scale_arg = &graph_utils::AddInitializer(graph_, nchwc_scale_tensor_proto);
+
+  std::copy_n(in_B.data<float>(), channels, padded_buffer.data());
+
+  ONNX_NAMESPACE::TensorProto nchwc_B_tensor_proto;
+  nchwc_B_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_B_tensor_proto.set_name(graph_.GenerateNodeArgName("in_B"));
+  nchwc_B_tensor_proto.set_raw_data(padded_buffer.data(), nchwc_channels * sizeof(float));
+  nchwc_B_tensor_proto.add_dims(nchwc_channels);
+
+  auto* nchwc_B_arg = &graph_utils::AddInitializer(graph_, nchwc_B_tensor_proto);
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "InstanceNormalization",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_, nchwc_scale_arg, nchwc_B_arg},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  const auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr && utils::HasFloat(*epsilon_attr)) {
+    nchwc_node.AddAttribute("epsilon", epsilon_attr->f());
+  }
+
+  nchwc_input->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, channels, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+}
+
 void NchwcTransformerImpl::TransformTranspose(Node& node) {
   auto& input_defs = node.MutableInputDefs();
   auto& output_defs = node.MutableOutputDefs();
@@ -943,15 +1232,23 @@ void NchwcTransformerImpl::Transform(Node& node) {
         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8, 13})) {
       TransformBinary(node, true);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13})) {
-      TransformBinary(node, false);
+      if (!TransformScaleChannels(node)) {
+        TransformBinary(node, false);
+      }
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13})) {
       TransformConcat(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Split", {2, 11})) {
+      TransformSplit(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13}) ||
                graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
-               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13})) {
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6})) {
       TransformActivation(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
       TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "InstanceNormalization", {6})) {
+      TransformInstanceNormalization(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1, 13})) {
       TransformTranspose(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {9, 13}) ||
@@ -20,7 +20,8 @@ namespace onnxruntime {
 OptimizerExecutionFrame::Info::Info(const std::vector<const Node*>& nodes,
                                     const InitializedTensorSet& initialized_tensor_set,
                                     const Path& model_path,
-                                    const IExecutionProvider& execution_provider)
+                                    const IExecutionProvider& execution_provider,
+                                    const std::unordered_map<std::string, OrtValue>* computed_values)
     : execution_provider_(execution_provider) {
   allocator_ptr_ = execution_provider_.GetAllocator(device_id_, mem_type_);
   ORT_ENFORCE(allocator_ptr_, "Failed to get allocator for optimizer");
@@ -28,13 +29,23 @@ OptimizerExecutionFrame::Info::Info(const std::vector<const Node*>& nodes,
   data_transfer_mgr_.RegisterDataTransfer(onnxruntime::make_unique<CPUDataTransfer>());
 
   // Create MLValues related maps
-  auto initialize_maps = [this, &initialized_tensor_set, &model_path](const NodeArg& arg, size_t /*index*/) -> Status {
+  auto initialize_maps = [this, &initialized_tensor_set, &model_path,
+                          computed_values](const NodeArg& arg, size_t /*index*/) -> Status {
     int idx = ort_value_name_idx_map_.Add(arg.Name());
     ort_value_idx_nodearg_map_[idx] = &arg;
 
     // Only create OrtValue instances for initializers used by an array of nodes.
     InitializedTensorSet::const_iterator it = initialized_tensor_set.find(arg.Name());
-    if (it != initialized_tensor_set.cend()) {
+    // an initializer consumed by several of the nodes is converted once
+    if (it != initialized_tensor_set.cend() && initializers_.count(idx) == 0) {
+      if (computed_values != nullptr) {
+        auto computed_value = computed_values->find(arg.Name());
+        if (computed_value != computed_values->cend()) {
+          initializers_[idx] = computed_value->second;
+          return Status::OK();
+        }
+      }
+
       const auto& tensor_proto = *(it->second);
       size_t cpu_tensor_length;
       ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &cpu_tensor_length));
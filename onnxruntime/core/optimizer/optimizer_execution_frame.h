@@ -20,10 +20,13 @@ class OptimizerExecutionFrame final : public IExecutionFrame {
  public:
   class Info {
    public:
+    // computed_values optionally provides the already computed values of some of the initializers, which are used
+    // as is instead of being converted from their TensorProto.
     Info(const std::vector<const Node*>& nodes,
          const InitializedTensorSet& initialized_tensor_set,
          const Path& model_path,
-         const IExecutionProvider& execution_provider);
+         const IExecutionProvider& execution_provider,
+         const std::unordered_map<std::string, OrtValue>* computed_values = nullptr);
     ~Info() {
       for (auto& kvp : deleter_for_initialized_tensors_) {
         kvp.second.f(kvp.second.param);
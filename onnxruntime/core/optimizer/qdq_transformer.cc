@@ -0,0 +1,419 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_transformer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/utils.h"
+#include "core/mlas/inc/mlas.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Per channel filter and per column weight parameters are only supported by
+// the MLAS based QLinearConv and QLinearMatMul kernels, which likewise limit
+// the int8_t filter of QLinearConv.
+#if defined(MLAS_TARGET_AMD64_IX86)
+constexpr bool kSupportsPerChannelWeights = true;
+#else
+constexpr bool kSupportsPerChannelWeights = false;
+#endif
+
+bool IsDQNode(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "DequantizeLinear", {10, 13});
+}
+
+bool IsQNode(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "QuantizeLinear", {10, 13});
+}
+
+int32_t GetElementType(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+  return type->tensor_type().elem_type();
+}
+
+bool IsScalarShape(const TensorShapeProto* shape) {
+  if (shape == nullptr) {
+    return false;
+  }
+  return shape->dim_size() == 0 ||
+         (shape->dim_size() == 1 && utils::HasDimValue(shape->dim(0)) && shape->dim(0).dim_value() == 1);
+}
+
+// Returns true if the (de)quantize node has an explicit zero point and a per
+// tensor scale and zero point.
+bool HasPerTensorParameters(const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  return input_defs.size() == 3 && input_defs[2]->Exists() &&
+         IsScalarShape(input_defs[1]->Shape()) && IsScalarShape(input_defs[2]->Shape());
+}
+
+// Returns true if the DequantizeLinear node of a weight has an explicit zero
+// point and either per tensor parameters or parameters along the specified
+// axis of the weight.
+bool HasPerAxisParameters(const Node& dq_node, int64_t axis) {
+  if (HasPerTensorParameters(dq_node)) {
+    return true;
+  }
+
+  const auto& input_defs = dq_node.InputDefs();
+  if (!kSupportsPerChannelWeights || dq_node.SinceVersion() < 13 ||
+      input_defs.size() != 3 || !input_defs[2]->Exists()) {
+    return false;
+  }
+
+  const auto* input_shape = input_defs[0]->Shape();
+  const auto* scale_shape = input_defs[1]->Shape();
+  const auto* zero_point_shape = input_defs[2]->Shape();
+  if (input_shape == nullptr || scale_shape == nullptr || zero_point_shape == nullptr ||
+      scale_shape->dim_size() != 1 || zero_point_shape->dim_size() != 1) {
+    return false;
+  }
+
+  int64_t dq_axis = 1;
+  const auto& attributes = dq_node.GetAttributes();
+  const auto axis_attr = attributes.find("axis");
+  if (axis_attr != attributes.end()) {
+    dq_axis = axis_attr->second.i();
+  }
+  if (dq_axis < 0) {
+    dq_axis += input_shape->dim_size();
+  }
+
+  return dq_axis == axis;
+}
+
+// Reads the constant scalar scale and zero point of a (de)quantize node.
+bool GetConstantParameters(const Graph& graph, const Node& node, float& scale, int32_t& zero_point) {
+  const auto& input_defs = node.InputDefs();
+  const auto* scale_tensor = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+  const auto* zero_point_tensor = graph_utils::GetConstantInitializer(graph, input_defs[2]->Name());
+  if (scale_tensor == nullptr || zero_point_tensor == nullptr ||
+      scale_tensor->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  if (!utils::UnpackTensor(*scale_tensor, &scale, 1).IsOK()) {
+    return false;
+  }
+
+  if (zero_point_tensor->data_type() == TensorProto_DataType_UINT8) {
+    uint8_t value;
+    if (!utils::UnpackTensor(*zero_point_tensor, &value, 1).IsOK()) {
+      return false;
+    }
+    zero_point = value;
+  } else if (zero_point_tensor->data_type() == TensorProto_DataType_INT8) {
+    int8_t value;
+    if (!utils::UnpackTensor(*zero_point_tensor, &value, 1).IsOK()) {
+      return false;
+    }
+    zero_point = value;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+bool HaveSameConstantParameters(const Graph& graph, const Node& node1, const Node& node2) {
+  float scale1, scale2;
+  int32_t zero_point1, zero_point2;
+  return GetConstantParameters(graph, node1, scale1, zero_point1) &&
+         GetConstantParameters(graph, node2, scale2, zero_point2) &&
+         scale1 == scale2 && zero_point1 == zero_point2;
+}
+
+size_t GetElementCount(const TensorProto& tensor) {
+  size_t count = 1;
+  for (const auto dim : tensor.dims()) {
+    count *= static_cast<size_t>(dim);
+  }
+  return count;
+}
+
+bool GetConstantFloats(const Graph& graph, const NodeArg& node_arg, std::vector<float>& values) {
+  const auto* tensor = graph_utils::GetConstantInitializer(graph, node_arg.Name());
+  if (tensor == nullptr || tensor->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+  values.resize(GetElementCount(*tensor));
+  return utils::UnpackTensor(*tensor, values.data(), values.size()).IsOK();
+}
+
+// Returns true if the int32_t bias of a convolution is dequantized with a zero
+// point of zero and with the product of the input and filter scales, which is
+// the scale QLinearConv applies to its bias.
+bool IsConvBiasCompatible(const Graph& graph, const Node& x_dq_node, const Node& w_dq_node, const Node& b_dq_node) {
+  const auto& b_input_defs = b_dq_node.InputDefs();
+  if (GetElementType(*b_input_defs[0]) != TensorProto_DataType_INT32) {
+    return false;
+  }
+
+  if (b_input_defs.size() == 3 && b_input_defs[2]->Exists()) {
+    const auto* zero_point_tensor = graph_utils::GetConstantInitializer(graph, b_input_defs[2]->Name());
+    if (zero_point_tensor == nullptr || zero_point_tensor->data_type() != TensorProto_DataType_INT32) {
+      return false;
+    }
+    std::vector<int32_t> zero_points(GetElementCount(*zero_point_tensor));
+    if (!utils::UnpackTensor(*zero_point_tensor, zero_points.data(), zero_points.size()).IsOK() ||
+        std::any_of(zero_points.begin(), zero_points.end(), [](int32_t zero_point) { return zero_point != 0; })) {
+      return false;
+    }
+  }
+
+  std::vector<float> x_scale, w_scale, b_scale;
+  if (!GetConstantFloats(graph, *x_dq_node.InputDefs()[1], x_scale) ||
+      !GetConstantFloats(graph, *w_dq_node.InputDefs()[1], w_scale) ||
+      !GetConstantFloats(graph, *b_input_defs[1], b_scale) ||
+      x_scale.size() != 1 || w_scale.empty() ||
+      (b_scale.size() != 1 && b_scale.size() != w_scale.size())) {
+    return false;
+  }
+
+  for (size_t i = 0; i < std::max(w_scale.size(), b_scale.size()); i++) {
+    const float expected_scale = x_scale[0] * w_scale[w_scale.size() == 1 ? 0 : i];
+    const float actual_scale = b_scale[b_scale.size() == 1 ? 0 : i];
+    if (std::fabs(actual_scale - expected_scale) > 1e-6f * std::fabs(expected_scale)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Returns the DequantizeLinear node producing the specified input of the node,
+// or nullptr if the input is produced by another node or is a graph input.
+const Node* GetDQInputNode(const Graph& graph, const Node& node, size_t input_index) {
+  const auto& input_defs = node.InputDefs();
+  if (input_index >= input_defs.size() || !input_defs[input_index]->Exists()) {
+    return nullptr;
+  }
+  const Node* producer = graph.GetProducerNode(input_defs[input_index]->Name());
+  if (producer == nullptr || !IsDQNode(*producer) ||
+      producer->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+  return producer;
+}
+
+Status ProcessNode(Graph& graph, Node& node, bool& modified,
+                   const std::unordered_set<std::string>& compatible_execution_providers) {
+  if (!graph_utils::IsSupportedProvider(node, compatible_execution_providers)) {
+    return Status::OK();
+  }
+
+  const bool is_conv = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11});
+  const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13});
+  const bool is_add = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13});
+  const bool is_mul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13});
+  const bool is_pass_through =
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {12}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13});
+  if (!is_conv && !is_matmul && !is_add && !is_mul && !is_pass_through) {
+    return Status::OK();
+  }
+
+  // The node must produce a single output that is only consumed by a
+  // QuantizeLinear node.
+  const auto& output_defs = node.OutputDefs();
+  if ((output_defs.size() > 1 && output_defs[1]->Exists()) ||
+      !optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+    return Status::OK();
+  }
+
+  const Node& q_node = node.OutputEdgesBegin()->GetNode();
+  if (!IsQNode(q_node) || q_node.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+      !HasPerTensorParameters(q_node)) {
+    return Status::OK();
+  }
+  const int32_t output_type = GetElementType(*q_node.OutputDefs()[0]);
+
+  // Collect the DequantizeLinear nodes that produce the quantized data inputs.
+  std::vector<size_t> data_input_indices;
+  if (is_conv || is_matmul || is_add || is_mul) {
+    data_input_indices = {0, 1};
+  } else if (node.OpType() == "Concat") {
+    for (size_t i = 0; i < node.InputDefs().size(); i++) {
+      data_input_indices.push_back(i);
+    }
+  } else {
+    data_input_indices = {0};
+  }
+
+  std::vector<const Node*> dq_nodes;
+  for (size_t input_index : data_input_indices) {
+    const Node* dq_node = GetDQInputNode(graph, node, input_index);
+    if (dq_node == nullptr) {
+      return Status::OK();
+    }
+    dq_nodes.push_back(dq_node);
+  }
+
+  auto get_mutable_input_defs = [&graph](const Node& dq_node) -> std::vector<NodeArg*>& {
+    return graph.GetNode(dq_node.Index())->MutableInputDefs();
+  };
+
+  std::string op_type;
+  std::string domain = kOnnxDomain;
+  std::vector<NodeArg*> input_defs;
+  const Node* bias_dq_node = nullptr;
+
+  if (is_pass_through) {
+    // The op only moves or selects values, so it can operate on the quantized
+    // data directly if every input is quantized exactly like the output.
+    for (const Node* dq_node : dq_nodes) {
+      if (GetElementType(*dq_node->InputDefs()[0]) != output_type ||
+          !HasPerTensorParameters(*dq_node) ||
+          !HaveSameConstantParameters(graph, *dq_node, q_node)) {
+        return Status::OK();
+      }
+    }
+
+    op_type = node.OpType();
+    domain = node.Domain();
+    input_defs = node.MutableInputDefs();
+    for (size_t i = 0; i < data_input_indices.size(); i++) {
+      input_defs[data_input_indices[i]] = get_mutable_input_defs(*dq_nodes[i])[0];
+    }
+  } else {
+    const Node& a_dq_node = *dq_nodes[0];
+    const Node& b_dq_node = *dq_nodes[1];
+    const int32_t a_type = GetElementType(*a_dq_node.InputDefs()[0]);
+    const int32_t b_type = GetElementType(*b_dq_node.InputDefs()[0]);
+
+    if (!HasPerTensorParameters(a_dq_node)) {
+      return Status::OK();
+    }
+
+    if (is_conv) {
+      if (a_type != TensorProto_DataType_UINT8 || output_type != TensorProto_DataType_UINT8 ||
+          !(b_type == TensorProto_DataType_UINT8 ||
+            (b_type == TensorProto_DataType_INT8 && kSupportsPerChannelWeights)) ||
+          !HasPerAxisParameters(b_dq_node, 0)) {
+        return Status::OK();
+      }
+
+      const auto& conv_input_defs = node.InputDefs();
+      if (conv_input_defs.size() > 2 && conv_input_defs[2]->Exists()) {
+        bias_dq_node = GetDQInputNode(graph, node, 2);
+        if (bias_dq_node == nullptr || !IsConvBiasCompatible(graph, a_dq_node, b_dq_node, *bias_dq_node)) {
+          return Status::OK();
+        }
+      }
+
+      op_type = "QLinearConv";
+    } else if (is_matmul) {
+      if (a_type != TensorProto_DataType_UINT8 || b_type != TensorProto_DataType_UINT8 ||
+          output_type != TensorProto_DataType_UINT8) {
+        return Status::OK();
+      }
+
+      // QLinearMatMul supports parameters per column of the B matrix.
+      const auto* b_shape = b_dq_node.InputDefs()[0]->Shape();
+      if (!HasPerTensorParameters(b_dq_node) &&
+          (b_shape == nullptr || b_shape->dim_size() < 2 ||
+           !HasPerAxisParameters(b_dq_node, b_shape->dim_size() - 1))) {
+        return Status::OK();
+      }
+
+      op_type = "QLinearMatMul";
+    } else {
+      if ((a_type != TensorProto_DataType_UINT8 && a_type != TensorProto_DataType_INT8) ||
+          a_type != b_type || a_type != output_type || !HasPerTensorParameters(b_dq_node)) {
+        return Status::OK();
+      }
+
+      op_type = is_add ? "QLinearAdd" : "QLinearMul";
+      domain = kMSDomain;
+    }
+
+    const auto& a_input_defs = get_mutable_input_defs(a_dq_node);
+    const auto& b_input_defs = get_mutable_input_defs(b_dq_node);
+    auto& q_input_defs = graph.GetNode(q_node.Index())->MutableInputDefs();
+    input_defs = {a_input_defs[0], a_input_defs[1], a_input_defs[2],
+                  b_input_defs[0], b_input_defs[1], b_input_defs[2],
+                  q_input_defs[1], q_input_defs[2]};
+    if (bias_dq_node != nullptr) {
+      input_defs.push_back(get_mutable_input_defs(*bias_dq_node)[0]);
+      dq_nodes.push_back(bias_dq_node);
+    }
+  }
+
+  Node& qlinear_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_quantized"),
+                                     op_type,
+                                     "Quantized " + node.OpType() + " from QDQ",
+                                     input_defs,
+                                     graph.GetNode(q_node.Index())->MutableOutputDefs(),
+                                     is_conv || is_pass_through ? &node.GetAttributes() : nullptr,
+                                     domain);
+  qlinear_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  // Disconnect the DequantizeLinear nodes from the node being replaced.
+  std::vector<NodeIndex> dq_node_indices;
+  for (const Node* dq_node : dq_nodes) {
+    if (std::find(dq_node_indices.begin(), dq_node_indices.end(), dq_node->Index()) == dq_node_indices.end()) {
+      dq_node_indices.push_back(dq_node->Index());
+    }
+  }
+
+  std::vector<Node::EdgeEnd> dq_edges;
+  for (auto input_edge = node.InputEdgesBegin(); input_edge != node.InputEdgesEnd(); ++input_edge) {
+    if (std::find(dq_node_indices.begin(), dq_node_indices.end(), input_edge->GetNode().Index()) !=
+        dq_node_indices.end()) {
+      dq_edges.push_back(*input_edge);
+    }
+  }
+  for (const auto& dq_edge : dq_edges) {
+    graph.RemoveEdge(dq_edge.GetNode().Index(), node.Index(), dq_edge.GetSrcArgIndex(), dq_edge.GetDstArgIndex());
+  }
+
+  Node& mutable_q_node = *graph.GetNode(q_node.Index());
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  graph.RemoveNode(node.Index());
+  graph_utils::RemoveNodeOutputEdges(graph, mutable_q_node);
+  graph.RemoveNode(mutable_q_node.Index());
+
+  // Remove the DequantizeLinear nodes that have no other consumers.
+  for (NodeIndex dq_node_index : dq_node_indices) {
+    Node* dq_node = graph.GetNode(dq_node_index);
+    if (optimizer_utils::CheckOutputEdges(graph, *dq_node, 0)) {
+      graph.RemoveNode(dq_node_index);
+    }
+  }
+
+  modified = true;
+
+  return Status::OK();
+}
+
+}  // namespace
+
+Status QDQTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer{graph};
+  const auto node_indices = graph_viewer.GetNodesInTopologicalOrder();
+  for (const auto node_index : node_indices) {
+    auto* node = graph.GetNode(node_index);
+    if (!node) continue;
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    ORT_RETURN_IF_ERROR(ProcessNode(graph, *node, modified, GetCompatibleExecutionProviders()));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QDQTransformer
+
+Rewrites the DequantizeLinear -> Op -> QuantizeLinear node groups emitted for
+QDQ (quantize/dequantize) formatted models into operators that consume the
+quantized data directly:
+
+  DQ(x), DQ(w) [, DQ(bias)] -> Conv -> Q    becomes QLinearConv
+  DQ(a), DQ(b) -> MatMul -> Q               becomes QLinearMatMul
+  DQ(a), DQ(b) -> Add/Mul -> Q              becomes com.microsoft.QLinearAdd/QLinearMul
+  DQ(x)... -> MaxPool/Reshape/Concat -> Q   becomes the same op on the quantized data
+                                            if all of the scales and zero points match
+
+A DequantizeLinear node is removed once it has no remaining consumers.
+*/
+class QDQTransformer : public GraphTransformer {
+ public:
+  QDQTransformer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQTransformer", compatible_execution_providers) {
+  }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
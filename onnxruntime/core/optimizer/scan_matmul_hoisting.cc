@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/scan_matmul_hoisting.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsConsumedBySubgraph(const Graph& graph, const std::string& name) {
+  for (const auto& node : graph.Nodes()) {
+    for (const auto* input : node.ImplicitInputDefs()) {
+      if (input->Name() == name) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Adds the edge from the producer of the value in graph, if any, to the input of the node.
+void AddEdgeFromProducer(Graph& graph, const NodeArg& value, Node& node, int input_index) {
+  const Node* producer = graph.GetProducerNode(value.Name());
+  if (producer == nullptr) {
+    return;
+  }
+
+  const auto& outputs = producer->OutputDefs();
+  const auto output = std::find(outputs.cbegin(), outputs.cend(), &value);
+  if (output != outputs.cend()) {
+    graph.AddEdge(producer->Index(), node.Index(), static_cast<int>(output - outputs.cbegin()), input_index);
+  }
+}
+
+// Replaces the input of the Scan node whose element is only consumed by x_t * W in the body with the product of the
+// whole input and W, computed in graph. Returns true if the MatMul was hoisted.
+bool HoistScanInputMatMul(Graph& graph, Node& scan, Graph& body, int input_index,
+                          const std::unordered_set<std::string>& compatible_execution_providers) {
+  const NodeArg* element = body.GetInputs()[input_index];
+  auto consumers = body.GetMutableConsumerNodes(element->Name());
+  if (consumers.size() != 1 || body.IsOutput(element) || IsConsumedBySubgraph(body, element->Name())) {
+    return false;
+  }
+
+  Node& matmul = *consumers[0];
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMul", {1, 9, 13}) ||
+      !graph_utils::IsSupportedProvider(matmul, compatible_execution_providers) ||
+      matmul.InputDefs()[0] != element || matmul.InputDefs()[1] == element) {
+    return false;
+  }
+
+  // each row of the product of the [sequence, ..., K] input and a [K, N] weight is the product of an element
+  NodeArg* product = matmul.MutableOutputDefs()[0];
+  const NodeArg& weight = *matmul.InputDefs()[1];
+  const std::string weight_name = weight.Name();
+  const auto* weight_shape = weight.Shape();
+  if (weight_shape == nullptr || weight_shape->dim_size() != 2 || product->TypeAsProto() == nullptr ||
+      body.IsOutput(product)) {
+    return false;
+  }
+
+  const auto* initializer = body.GetConstantInitializer(weight_name, false);
+  if (initializer == nullptr && !body.IsOuterScopeValue(weight_name)) {
+    return false;
+  }
+
+  NodeArg* hoisted_weight = nullptr;
+  if (initializer != nullptr) {
+    // copy the initializer to graph under a name that doesn't hide any value
+    TensorProto hoisted_initializer{*initializer};
+    hoisted_initializer.set_name(graph.GenerateNodeArgName(weight_name));
+    graph.AddInitializedTensor(hoisted_initializer);
+    hoisted_weight = &graph.GetOrCreateNodeArg(hoisted_initializer.name(), weight.TypeAsProto());
+  } else {
+    // a value of graph or of one of its outer scopes
+    hoisted_weight = &graph.GetOrCreateNodeArg(weight_name, weight.TypeAsProto());
+  }
+
+  TypeProto product_type{*product->TypeAsProto()};
+  product_type.mutable_tensor_type()->clear_shape();
+  auto& hoisted_product = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(product->Name()), &product_type);
+
+  NodeArg& input = *scan.MutableInputDefs()[input_index];
+  auto& hoisted_matmul = graph.AddNode(graph.GenerateNodeName(matmul.Name()), "MatMul",
+                                       "MatMul of the whole input of " + scan.Name(), {&input, hoisted_weight},
+                                       {&hoisted_product});
+  hoisted_matmul.SetExecutionProviderType(scan.GetExecutionProviderType());
+
+  const auto* input_edge = graph_utils::GetInputEdge(scan, input_index);
+  if (input_edge != nullptr) {
+    graph.RemoveEdge(input_edge->GetNode().Index(), scan.Index(), input_edge->GetSrcArgIndex(), input_index);
+  }
+  AddEdgeFromProducer(graph, input, hoisted_matmul, 0);
+  AddEdgeFromProducer(graph, *hoisted_weight, hoisted_matmul, 1);
+
+  graph_utils::ReplaceNodeInput(scan, input_index, hoisted_product);
+  graph.AddEdge(hoisted_matmul.Index(), scan.Index(), 0, input_index);
+
+  // the consumers of the product in the body take it as the element of the scan input. an initializer of the body
+  // only consumed by the MatMul is removed when the body is resolved.
+  std::vector<const NodeArg*> body_inputs = body.GetInputsIncludingInitializers();
+  std::replace(body_inputs.begin(), body_inputs.end(), element, static_cast<const NodeArg*>(product));
+
+  graph_utils::RemoveNodeOutputEdges(body, matmul);
+  body.RemoveNode(matmul.Index());
+  body.SetInputs(body_inputs);
+  return true;
+}
+}  // namespace
+
+Status ScanMatMulHoisting::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& scan = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(scan, modified, graph_level, logger));
+
+    // opset 8 Scan has a batch axis and a sequence_lens input before the loop state
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(scan, "Scan", {9, 11}) ||
+        !graph_utils::IsSupportedProvider(scan, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    Graph* body = scan.GetMutableGraphAttribute("body");
+    const auto* num_scan_inputs = graph_utils::GetNodeAttribute(scan, "num_scan_inputs");
+    if (body == nullptr || num_scan_inputs == nullptr ||
+        body->GetInputs().size() != scan.InputDefs().size()) {
+      continue;
+    }
+
+    std::vector<int64_t> scan_input_axes;
+    graph_utils::GetRepeatedNodeAttributeValues(scan, "scan_input_axes", scan_input_axes);
+
+    const int num_inputs = static_cast<int>(scan.InputDefs().size());
+    const int num_loop_state_variables = num_inputs - static_cast<int>(num_scan_inputs->i());
+    bool hoisted = false;
+    for (int i = std::max(num_loop_state_variables, 0); i < num_inputs; ++i) {
+      // the rows of the product are the elements of the input if the sequence axis is the outermost one
+      const size_t scan_input = static_cast<size_t>(i - num_loop_state_variables);
+      if (scan_input < scan_input_axes.size() && scan_input_axes[scan_input] != 0) {
+        continue;
+      }
+
+      hoisted = HoistScanInputMatMul(graph, scan, *body, i, GetCompatibleExecutionProviders()) || hoisted;
+    }
+
+    if (hoisted) {
+      body->SetGraphResolveNeeded();
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ScanMatMulHoisting
+
+Hoist the MatMul of a Scan input element by a loop invariant 2-D weight, i.e. the x_t * W of the input projection
+of a recurrence, out of the Scan body. The graph containing the Scan node multiplies the whole [sequence, ...] input
+by the weight in a single GEMM, and the body consumes the rows of the product as its scan input instead of running a
+small GEMM per iteration.
+
+The weight must be an outer scope value or a constant initializer of the body. The loop invariant nodes of the body
+are hoisted by CommonSubexpressionElimination.
+*/
+class ScanMatMulHoisting : public GraphTransformer {
+ public:
+  ScanMatMulHoisting(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ScanMatMulHoisting", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
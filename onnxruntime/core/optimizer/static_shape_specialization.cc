@@ -0,0 +1,295 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/static_shape_specialization.h"
+
+#include <algorithm>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static bool ParseDimension(const std::string& s, int64_t& value) {
+  // Limit the length so the value can't overflow an int64_t.
+  if (s.empty() || s.size() > 18 || !std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+    return false;
+  }
+
+  value = std::stoll(s);
+  return true;
+}
+
+Status StaticShapeSpecialization::ParseInputShapes(const std::string& input_shapes_string,
+                                                   InputShapeMap& input_shapes) {
+  input_shapes.clear();
+
+  size_t begin = 0;
+  while (begin < input_shapes_string.size()) {
+    size_t end = input_shapes_string.find(';', begin);
+    if (end == std::string::npos) {
+      end = input_shapes_string.size();
+    }
+
+    const std::string entry = input_shapes_string.substr(begin, end - begin);
+    begin = end + 1;
+
+    if (entry.empty()) {
+      continue;
+    }
+
+    // Input names may contain ':' so split at the last one.
+    const size_t separator = entry.rfind(':');
+    if (separator == std::string::npos || separator == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid static input shape '", entry,
+                             "'. Expected the format name:dim,dim,...");
+    }
+
+    std::vector<int64_t> dims;
+    const std::string dims_string = entry.substr(separator + 1);
+    size_t dim_begin = 0;
+    while (dim_begin < dims_string.size()) {
+      size_t dim_end = dims_string.find(',', dim_begin);
+      if (dim_end == std::string::npos) {
+        dim_end = dims_string.size();
+      }
+
+      int64_t dim_value;
+      if (!ParseDimension(dims_string.substr(dim_begin, dim_end - dim_begin), dim_value)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid dimension in static input shape '", entry,
+                               "'. Dimensions must be non-negative integers.");
+      }
+
+      dims.push_back(dim_value);
+      dim_begin = dim_end + 1;
+    }
+
+    const std::string name = entry.substr(0, separator);
+    if (!input_shapes.emplace(name, std::move(dims)).second) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Duplicate static input shape for input '", name, "'.");
+    }
+  }
+
+  return Status::OK();
+}
+
+static bool GetStaticShape(const NodeArg& node_arg, std::vector<int64_t>& dims) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  dims.clear();
+  for (int i = 0, num_dims = shape->dim_size(); i < num_dims; i++) {
+    const auto& dim = shape->dim(i);
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return false;
+    }
+    dims.push_back(dim.dim_value());
+  }
+
+  return true;
+}
+
+// Returns true if the Slice steps are absent or a positive constant, so a Slice that keeps the shape of its input
+// also keeps its contents.
+static bool HasPositiveSliceSteps(const Graph& graph, const Node& slice) {
+  if (slice.InputDefs().size() < 5 || !slice.InputDefs()[4]->Exists()) {
+    return true;
+  }
+
+  const TensorProto* steps_proto = graph_utils::GetConstantInitializer(graph, slice.InputDefs()[4]->Name());
+  if (steps_proto == nullptr) {
+    return false;
+  }
+
+  Initializer steps(*steps_proto, graph.ModelPath());
+  if (steps.data_type() == TensorProto_DataType_INT64) {
+    const int64_t* data = steps.data<int64_t>();
+    return std::all_of(data, data + steps.size(), [](int64_t step) { return step > 0; });
+  }
+
+  if (steps.data_type() == TensorProto_DataType_INT32) {
+    const int32_t* data = steps.data<int32_t>();
+    return std::all_of(data, data + steps.size(), [](int32_t step) { return step > 0; });
+  }
+
+  return false;
+}
+
+// A Reshape, Expand or Slice node is a no-op if it produces the same static shape as its data input. The remaining
+// inputs must be constant initializers so the data input is the only one that can be wired to the consumers.
+static bool IsNoOpShapeNode(const Graph& graph, const Node& node, const logging::Logger& logger) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5, 13}) &&
+      !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Expand", {8, 13}) &&
+      !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {1, 10, 11, 13})) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  for (size_t i = 1; i < input_defs.size(); i++) {
+    if (input_defs[i]->Exists() && !graph_utils::IsConstantInitializer(graph, input_defs[i]->Name())) {
+      return false;
+    }
+  }
+
+  if (node.OpType() == "Slice" && !HasPositiveSliceSteps(graph, node)) {
+    return false;
+  }
+
+  std::vector<int64_t> input_dims;
+  std::vector<int64_t> output_dims;
+  if (!GetStaticShape(*input_defs[0], input_dims) || !GetStaticShape(*node.OutputDefs()[0], output_dims) ||
+      input_dims != output_dims) {
+    return false;
+  }
+
+  return graph_utils::CanRemoveNode(graph, node, logger);
+}
+
+// Replaces a Size node with a static input shape by an initializer holding the element count.
+static bool FoldSizeNode(Graph& graph, Node& node, const logging::Logger& logger) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Size", {1, 13})) {
+    return false;
+  }
+
+  std::vector<int64_t> input_dims;
+  if (!GetStaticShape(*node.InputDefs()[0], input_dims)) {
+    return false;
+  }
+
+  const auto& output_name = node.OutputDefs()[0]->Name();
+  if (!graph_utils::CanReplaceNodeWithInitializer(graph, node, output_name, logger)) {
+    return false;
+  }
+
+  int64_t size = 1;
+  for (auto dim : input_dims) {
+    size *= dim;
+  }
+
+  TensorProto size_initializer_proto;
+  size_initializer_proto.set_name(output_name);
+  size_initializer_proto.set_data_type(TensorProto_DataType_INT64);
+  size_initializer_proto.set_raw_data(&size, sizeof(size));
+
+  auto& new_node_arg = graph_utils::AddInitializer(graph, size_initializer_proto);
+  return graph_utils::ReplaceNodeWithInitializer(graph, node, new_node_arg);
+}
+
+Status StaticShapeSpecialization::SpecializeGraphInputs(Graph& graph, bool& modified,
+                                                        const logging::Logger& logger) const {
+  size_t inputs_found = 0;
+
+  for (const NodeArg* graph_input : graph.GetInputs()) {
+    auto it = input_shapes_.find(graph_input->Name());
+    if (it == input_shapes_.end()) {
+      continue;
+    }
+
+    inputs_found++;
+
+    const auto* input_type = graph_input->TypeAsProto();
+    const auto* input_shape = graph_input->Shape();
+    if (!input_type || !input_type->has_tensor_type()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Static input shape given for input '",
+                             graph_input->Name(), "' which is not a tensor.");
+    }
+
+    const auto& dims = it->second;
+    if (input_shape != nullptr && input_shape->dim_size() != static_cast<int>(dims.size())) {
+      LOGS(logger, ERROR) << "The model has input '" << graph_input->Name() << "' of rank " << input_shape->dim_size()
+                          << " which does not equal the rank " << dims.size() << " of the static input shape.";
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid static input shape.");
+    }
+
+    TensorShapeProto new_shape;
+    bool shape_modified = input_shape == nullptr;
+    for (size_t i = 0; i < dims.size(); i++) {
+      auto* new_dimension = new_shape.add_dim();
+      if (input_shape != nullptr) {
+        const auto& dimension = input_shape->dim(static_cast<int>(i));
+        if (utils::HasDimValue(dimension)) {
+          if (dimension.dim_value() != dims[i]) {
+            LOGS(logger, ERROR) << "The model has input '" << graph_input->Name() << "' "
+                                << "with a fixed dimension size " << dimension.dim_value() << " "
+                                << "which does not equal the static input shape dimension of " << dims[i] << ".";
+            return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid static input shape.");
+          }
+        } else {
+          shape_modified = true;
+        }
+
+        if (dimension.has_denotation()) {
+          new_dimension->set_denotation(dimension.denotation());
+        }
+      }
+      new_dimension->set_dim_value(dims[i]);
+    }
+
+    if (shape_modified) {
+      auto* mutable_graph_input = graph.GetNodeArg(graph_input->Name());
+      assert(mutable_graph_input != nullptr);
+      mutable_graph_input->SetShape(new_shape);
+      modified = true;
+    }
+  }
+
+  if (inputs_found != input_shapes_.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Static input shapes were given for names that are not inputs of the graph.");
+  }
+
+  if (modified) {
+    // Changing a graph input doesn't otherwise trigger shape inferencing when the graph is resolved.
+    graph.SetGraphResolveNeeded();
+  }
+
+  return Status::OK();
+}
+
+Status StaticShapeSpecialization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  if (graph_level == 0 && !input_shapes_.empty()) {
+    bool inputs_modified = false;
+    ORT_RETURN_IF_ERROR(SpecializeGraphInputs(graph, inputs_modified, logger));
+    if (inputs_modified) {
+      // Let shape inferencing and the folding transformers run on the new shapes before removing nodes.
+      modified = true;
+      return Status::OK();
+    }
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (NodeIndex i : order) {
+    auto* node = graph.GetNode(i);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (FoldSizeNode(graph, *node, logger)) {
+      modified = true;
+    } else if (IsNoOpShapeNode(graph, *node, logger)) {
+      if (graph_utils::RemoveNode(graph, *node)) {
+        modified = true;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class StaticShapeSpecialization
+
+Transformer that specializes the graph for concrete input shapes.
+
+The shapes of the graph inputs named in the input shape map are replaced with the given dimensions, after which
+shape inferencing propagates them through the graph. Once the output shapes are static, the subgraphs computing
+shapes (e.g. Shape->Gather->Concat->Reshape chains) are folded by the Shape node folding of ConstantFolding and
+ShapeToInitializer. This transformer then replaces Size nodes with an initializer and removes the Reshape, Expand
+and Slice nodes that produce a tensor with the same static shape as their data input.
+*/
+class StaticShapeSpecialization : public GraphTransformer {
+ public:
+  using InputShapeMap = std::unordered_map<std::string, std::vector<int64_t>>;
+
+  explicit StaticShapeSpecialization(const InputShapeMap& input_shapes = {},
+                                     const std::unordered_set<std::string>& compatible_execution_providers = {})
+      : GraphTransformer("StaticShapeSpecialization", compatible_execution_providers),
+        input_shapes_(input_shapes) {}
+
+  /** Parses input shapes in the format "name:dim,dim,...;name:dim,..." where every dim is a non-negative integer. */
+  static Status ParseInputShapes(const std::string& input_shapes_string, InputShapeMap& input_shapes);
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  Status SpecializeGraphInputs(Graph& graph, bool& modified, const logging::Logger& logger) const;
+
+  InputShapeMap input_shapes_;
+};
+
+}  // namespace onnxruntime
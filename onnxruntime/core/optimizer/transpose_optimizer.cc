@@ -0,0 +1,632 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/transpose_optimizer.h"
+
+#include <cstring>
+#include <deque>
+#include <numeric>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+using Permutation = std::vector<int64_t>;
+
+// How an operator is changed when a Transpose is pushed through it.
+enum class PushKind {
+  Elementwise,  // inputs are transposed back, outputs are transposed
+  Concat,       // same as Elementwise, and the axis is remapped
+  Split,        // the axis is remapped and every output is transposed
+  Reduce,       // the axes are remapped, the output is transposed with the kept axes only if keepdims is 0
+  ArgReduce,    // same as Reduce with a single axis
+};
+
+bool GetPushKind(const Node& node, PushKind& kind) {
+  using Versions = std::vector<ONNX_NAMESPACE::OperatorSetVersion>;
+  static const std::unordered_map<std::string, std::pair<PushKind, Versions>> pushable_ops = {
+      {"Abs", {PushKind::Elementwise, {6, 13}}},
+      {"Ceil", {PushKind::Elementwise, {6, 13}}},
+      {"Clip", {PushKind::Elementwise, {6, 11, 12, 13}}},
+      {"Cast", {PushKind::Elementwise, {6, 9, 13}}},
+      {"Elu", {PushKind::Elementwise, {6}}},
+      {"Erf", {PushKind::Elementwise, {9, 13}}},
+      {"Exp", {PushKind::Elementwise, {6, 13}}},
+      {"Floor", {PushKind::Elementwise, {6, 13}}},
+      {"HardSigmoid", {PushKind::Elementwise, {6}}},
+      {"Identity", {PushKind::Elementwise, {1, 13}}},
+      {"IsNaN", {PushKind::Elementwise, {9, 13}}},
+      {"LeakyRelu", {PushKind::Elementwise, {6}}},
+      {"Log", {PushKind::Elementwise, {6, 13}}},
+      {"Neg", {PushKind::Elementwise, {6, 13}}},
+      {"Not", {PushKind::Elementwise, {1}}},
+      {"Reciprocal", {PushKind::Elementwise, {6, 13}}},
+      {"Relu", {PushKind::Elementwise, {6, 13}}},
+      {"Round", {PushKind::Elementwise, {11}}},
+      {"Selu", {PushKind::Elementwise, {6}}},
+      {"Sigmoid", {PushKind::Elementwise, {6, 13}}},
+      {"Sign", {PushKind::Elementwise, {9, 13}}},
+      {"Softplus", {PushKind::Elementwise, {1}}},
+      {"Softsign", {PushKind::Elementwise, {1}}},
+      {"Sqrt", {PushKind::Elementwise, {6, 13}}},
+      {"Tanh", {PushKind::Elementwise, {6, 13}}},
+      {"Add", {PushKind::Elementwise, {7, 13}}},
+      {"And", {PushKind::Elementwise, {7}}},
+      {"Div", {PushKind::Elementwise, {7, 13}}},
+      {"Equal", {PushKind::Elementwise, {7, 11, 13}}},
+      {"Greater", {PushKind::Elementwise, {7, 9, 13}}},
+      {"GreaterOrEqual", {PushKind::Elementwise, {12}}},
+      {"Less", {PushKind::Elementwise, {7, 9, 13}}},
+      {"LessOrEqual", {PushKind::Elementwise, {12}}},
+      {"Max", {PushKind::Elementwise, {8, 12, 13}}},
+      {"Mean", {PushKind::Elementwise, {8, 13}}},
+      {"Min", {PushKind::Elementwise, {8, 12, 13}}},
+      {"Mod", {PushKind::Elementwise, {10, 13}}},
+      {"Mul", {PushKind::Elementwise, {7, 13}}},
+      {"Or", {PushKind::Elementwise, {7}}},
+      {"Pow", {PushKind::Elementwise, {7, 12, 13}}},
+      {"PRelu", {PushKind::Elementwise, {7, 9}}},
+      {"Sub", {PushKind::Elementwise, {7, 13}}},
+      {"Sum", {PushKind::Elementwise, {8, 13}}},
+      {"Where", {PushKind::Elementwise, {9}}},
+      {"Xor", {PushKind::Elementwise, {7}}},
+      {"Concat", {PushKind::Concat, {4, 11, 13}}},
+      {"Split", {PushKind::Split, {2, 11, 13}}},
+      {"ReduceL1", {PushKind::Reduce, {1, 11, 13}}},
+      {"ReduceL2", {PushKind::Reduce, {1, 11, 13}}},
+      {"ReduceLogSum", {PushKind::Reduce, {1, 11, 13}}},
+      {"ReduceLogSumExp", {PushKind::Reduce, {1, 11, 13}}},
+      {"ReduceMax", {PushKind::Reduce, {1, 11, 12, 13}}},
+      {"ReduceMean", {PushKind::Reduce, {1, 11, 13}}},
+      {"ReduceMin", {PushKind::Reduce, {1, 11, 12, 13}}},
+      {"ReduceProd", {PushKind::Reduce, {1, 11, 13}}},
+      {"ReduceSum", {PushKind::Reduce, {1, 11}}},  // the axes are an input since opset 13
+      {"ReduceSumSquare", {PushKind::Reduce, {1, 11, 13}}},
+      {"ArgMax", {PushKind::ArgReduce, {1, 11, 12, 13}}},
+      {"ArgMin", {PushKind::ArgReduce, {1, 11, 12, 13}}},
+  };
+
+  auto it = pushable_ops.find(node.OpType());
+  // nodes added by this transformer have no schema until the graph is resolved
+  if (it == pushable_ops.end() || node.Op() == nullptr || !graph_utils::MatchesOpSetDomain(node, kOnnxDomain) ||
+      !graph_utils::MatchesOpSinceVersion(node, it->second.second)) {
+    return false;
+  }
+
+  kind = it->second.first;
+  return true;
+}
+
+// The Transpose schema didn't change between versions, so the nodes added by this transformer need no version.
+bool IsTranspose(const Node& node) {
+  return node.OpType() == "Transpose" && graph_utils::MatchesOpSetDomain(node, kOnnxDomain);
+}
+
+bool GetPermutation(const Node& transpose, Permutation& perm) {
+  if (!graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm)) {
+    // the default permutation reverses the dims
+    const auto* shape = transpose.InputDefs()[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    perm.resize(shape->dim_size());
+    std::iota(perm.rbegin(), perm.rend(), int64_t{0});
+  }
+
+  std::vector<bool> seen(perm.size(), false);
+  for (auto axis : perm) {
+    if (axis < 0 || axis >= static_cast<int64_t>(perm.size()) || seen[axis]) {
+      return false;
+    }
+    seen[axis] = true;
+  }
+  return true;
+}
+
+Permutation InvertPermutation(const Permutation& perm) {
+  Permutation inverse(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    inverse[perm[i]] = static_cast<int64_t>(i);
+  }
+  return inverse;
+}
+
+// Permutation of a single Transpose equivalent to a Transpose by <first> followed by a Transpose by <second>.
+Permutation ComposePermutations(const Permutation& first, const Permutation& second) {
+  Permutation composed(second.size());
+  for (size_t i = 0; i < second.size(); ++i) {
+    composed[i] = first[second[i]];
+  }
+  return composed;
+}
+
+// An empty permutation is the identity for rank 0 values.
+bool IsIdentityPermutation(const Permutation& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Axes of the transposed value are the axes perm[axis] of the value before the Transpose.
+bool NormalizeAxis(int64_t& axis, int64_t rank) {
+  if (axis < 0) {
+    axis += rank;
+  }
+  return axis >= 0 && axis < rank;
+}
+
+// Permutation of the output of a reduction with keepdims=0 over <axes> of the value transposed by <perm>,
+// when the reduction is done on the value before the Transpose instead.
+Permutation ReducedPermutation(const Permutation& perm, const std::vector<int64_t>& axes) {
+  const size_t rank = perm.size();
+  std::vector<bool> is_reduced(rank, false);
+  std::vector<bool> is_input_axis_reduced(rank, false);
+  for (auto axis : axes) {
+    is_reduced[axis] = true;
+    is_input_axis_reduced[perm[axis]] = true;
+  }
+
+  // position of the kept axes of the value before the Transpose in the reduced value
+  std::vector<int64_t> reduced_position(rank, -1);
+  int64_t next_position = 0;
+  for (size_t axis = 0; axis < rank; ++axis) {
+    if (!is_input_axis_reduced[axis]) {
+      reduced_position[axis] = next_position++;
+    }
+  }
+
+  Permutation reduced_perm;
+  for (size_t axis = 0; axis < rank; ++axis) {
+    if (!is_reduced[axis]) {
+      reduced_perm.push_back(reduced_position[perm[axis]]);
+    }
+  }
+  return reduced_perm;
+}
+
+bool IsSingleValue(const TensorShapeProto& shape) {
+  for (const auto& dim : shape.dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Size of the elements of the initializers that can be transposed, 0 for the other types.
+size_t InitializerElementSize(int32_t data_type) {
+  switch (data_type) {
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_BFLOAT16:
+      return 2;
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+      return 4;
+    case TensorProto_DataType_DOUBLE:
+    case TensorProto_DataType_INT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Adds a copy of <tensor>, padded with leading dims of 1 to the rank of <perm> and transposed by <perm>.
+NodeArg& AddTransposedInitializer(Graph& graph, const TensorProto& tensor, const Permutation& perm) {
+  const size_t rank = perm.size();
+  std::vector<int64_t> dims(rank - tensor.dims_size(), 1);
+  dims.insert(dims.end(), tensor.dims().begin(), tensor.dims().end());
+
+  std::vector<int64_t> strides(rank, 1);
+  for (size_t i = rank; i > 1; --i) {
+    strides[i - 2] = strides[i - 1] * dims[i - 1];
+  }
+
+  std::vector<int64_t> transposed_dims(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    transposed_dims[i] = dims[perm[i]];
+  }
+
+  Initializer source{tensor, graph.ModelPath()};
+  Initializer transposed{static_cast<TensorProto_DataType>(tensor.data_type()),
+                         graph.GenerateNodeArgName(tensor.name() + "_transposed"), transposed_dims};
+  const size_t element_size = InitializerElementSize(tensor.data_type());
+  const auto* source_data = source.data<uint8_t>();
+  auto* transposed_data = transposed.data<uint8_t>();
+
+  const int64_t size = std::accumulate(transposed_dims.begin(), transposed_dims.end(), int64_t{1},
+                                       std::multiplies<int64_t>{});
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t offset = 0;
+    for (size_t axis = 0; axis < rank; ++axis) {
+      offset += index[axis] * strides[perm[axis]];
+    }
+    std::memcpy(transposed_data + i * element_size, source_data + offset * element_size, element_size);
+
+    for (size_t axis = rank; axis > 0 && ++index[axis - 1] == transposed_dims[axis - 1]; --axis) {
+      index[axis - 1] = 0;
+    }
+  }
+
+  TensorProto transposed_tensor;
+  transposed.ToProto(transposed_tensor);
+  return graph_utils::AddInitializer(graph, transposed_tensor);
+}
+
+// A value consumed by a node, with the node output producing it if any.
+struct ValueSource {
+  NodeArg* arg;
+  NodeIndex producer;
+  int producer_output_index;
+  bool has_producer;
+};
+
+ValueSource GetInputSource(Node& node, int input_index) {
+  const Node::EdgeEnd* edge = graph_utils::GetInputEdge(node, input_index);
+  if (edge == nullptr) {
+    return {node.MutableInputDefs()[input_index], 0, 0, false};
+  }
+  return {node.MutableInputDefs()[input_index], edge->GetNode().Index(), edge->GetSrcArgIndex(), true};
+}
+
+void ReplaceInput(Graph& graph, Node& node, int input_index, const ValueSource& source) {
+  const Node::EdgeEnd* edge = graph_utils::GetInputEdge(node, input_index);
+  if (edge != nullptr) {
+    graph.RemoveEdge(edge->GetNode().Index(), node.Index(), edge->GetSrcArgIndex(), input_index);
+  }
+
+  node.MutableInputDefs()[input_index] = source.arg;
+  if (source.has_producer) {
+    graph.AddEdge(source.producer, node.Index(), source.producer_output_index, input_index);
+  }
+}
+
+// Makes the consumers of output <output_index> of <node> consume <source> instead. Returns false without changing
+// the graph if the output is consumed by a subgraph, as subgraphs refer to the values of the outer graph by name.
+bool ReplaceOutputUses(Graph& graph, Node& node, int output_index, const ValueSource& source) {
+  std::vector<std::pair<NodeIndex, int>> uses;
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    if (it->GetSrcArgIndex() != output_index) {
+      continue;
+    }
+    if (it->GetDstArgIndex() >= static_cast<int>(it->GetNode().InputDefs().size())) {
+      return false;
+    }
+    uses.emplace_back(it->GetNode().Index(), it->GetDstArgIndex());
+  }
+
+  for (const auto& use : uses) {
+    ReplaceInput(graph, *graph.GetNode(use.first), use.second, source);
+  }
+  return true;
+}
+
+// Moves the output edges of output <output_index> of <node> to output <new_output_index> of <new_producer>,
+// which produces the same NodeArg from now on.
+void MoveOutputEdges(Graph& graph, Node& node, int output_index, Node& new_producer, int new_output_index) {
+  std::vector<std::pair<NodeIndex, int>> uses;
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    if (it->GetSrcArgIndex() == output_index) {
+      uses.emplace_back(it->GetNode().Index(), it->GetDstArgIndex());
+    }
+  }
+
+  for (const auto& use : uses) {
+    graph.RemoveEdge(node.Index(), use.first, output_index, use.second);
+    graph.AddEdge(new_producer.Index(), use.first, new_output_index, use.second);
+  }
+}
+
+void RemoveIfUnused(Graph& graph, Node& node) {
+  if (node.GetOutputEdgesCount() == 0 && graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    graph.RemoveNode(node.Index());
+  }
+}
+
+// Removes <transpose> and <consumer>, which cancel each other and where <consumer> produces a graph output, by
+// having the producer of the input of <transpose> produce the graph output instead. This is only possible when
+// <transpose> is the only consumer of its input.
+bool ProduceGraphOutput(Graph& graph, Node& transpose, Node& consumer, const ValueSource& input) {
+  if (!input.has_producer || graph.IsOutput(input.arg) || transpose.GetOutputEdgesCount() != 1 ||
+      !graph.GetNodeOutputsInGraphOutputs(transpose).empty()) {
+    return false;
+  }
+
+  Node& producer = *graph.GetNode(input.producer);
+  for (auto it = producer.OutputEdgesBegin(), end = producer.OutputEdgesEnd(); it != end; ++it) {
+    if (it->GetSrcArgIndex() == input.producer_output_index && it->GetNode().Index() != transpose.Index()) {
+      return false;
+    }
+  }
+
+  producer.MutableOutputDefs()[input.producer_output_index] = consumer.MutableOutputDefs()[0];
+  MoveOutputEdges(graph, consumer, 0, producer, input.producer_output_index);
+  graph_utils::RemoveNodeOutputEdges(graph, transpose);
+  graph.RemoveNode(consumer.Index());
+  graph.RemoveNode(transpose.Index());
+  return true;
+}
+
+// Merges <transpose> into the Transposes that consume its output, removing both when they cancel each other.
+bool MergeConsumerTransposes(Graph& graph, Node& transpose, const Permutation& perm) {
+  const ValueSource input = GetInputSource(transpose, 0);
+
+  std::vector<NodeIndex> consumers;
+  for (auto it = transpose.OutputNodesBegin(), end = transpose.OutputNodesEnd(); it != end; ++it) {
+    consumers.push_back(it->Index());
+  }
+
+  bool modified = false;
+  for (auto consumer_index : consumers) {
+    Node& consumer = *graph.GetNode(consumer_index);
+    Permutation consumer_perm;
+    if (!IsTranspose(consumer) || consumer.GetExecutionProviderType() != transpose.GetExecutionProviderType() ||
+        !GetPermutation(consumer, consumer_perm) || consumer_perm.size() != perm.size()) {
+      continue;
+    }
+
+    const Permutation composed = ComposePermutations(perm, consumer_perm);
+    if (IsIdentityPermutation(composed)) {
+      // the graph outputs keep their names, so a Transpose producing one can't simply be bypassed
+      if (!graph.GetNodeOutputsInGraphOutputs(consumer).empty()) {
+        if (ProduceGraphOutput(graph, transpose, consumer, input)) {
+          return true;
+        }
+        continue;
+      }
+      if (!ReplaceOutputUses(graph, consumer, 0, input)) {
+        continue;
+      }
+      graph_utils::RemoveNodeOutputEdges(graph, consumer);
+      graph.RemoveNode(consumer.Index());
+    } else {
+      ReplaceInput(graph, consumer, 0, input);
+      consumer.AddAttribute("perm", composed);
+    }
+    modified = true;
+  }
+
+  if (modified) {
+    RemoveIfUnused(graph, transpose);
+  }
+  return modified;
+}
+
+// How an input of the node a Transpose is pushed through is changed.
+struct InputUpdate {
+  int index;
+  const Node* bypassed_transpose;         // Transpose with the same permutation whose input is used instead
+  const TensorProto* transposed_tensor;   // constant initializer to transpose back
+};
+
+// Pushes <transpose> through its consumer, which then transposes its outputs instead.
+bool PushTranspose(Graph& graph, Node& transpose, const Permutation& perm, std::deque<NodeIndex>& transposes) {
+  if (!optimizer_utils::CheckOutputEdges(graph, transpose, 1)) {
+    return false;
+  }
+
+  const Node::EdgeEnd& output_edge = *transpose.OutputEdgesBegin();
+  Node& node = *graph.GetNode(output_edge.GetNode().Index());
+  const int transposed_input = output_edge.GetDstArgIndex();
+
+  PushKind kind;
+  if (!GetPushKind(node, kind) || node.GetExecutionProviderType() != transpose.GetExecutionProviderType() ||
+      transposed_input >= static_cast<int>(node.InputDefs().size()) ||
+      (transposed_input != 0 && kind != PushKind::Elementwise && kind != PushKind::Concat)) {
+    return false;
+  }
+
+  const int64_t rank = static_cast<int64_t>(perm.size());
+  const Permutation inverse = InvertPermutation(perm);
+
+  // the other inputs of elementwise operators and Concat must be transposed back. this is only done when it is
+  // free: the input is transposed by the same permutation, is an initializer, or holds a single value.
+  std::vector<InputUpdate> input_updates;
+  if (kind == PushKind::Elementwise || kind == PushKind::Concat) {
+    const auto& input_defs = node.InputDefs();
+    for (int i = 0, end = static_cast<int>(input_defs.size()); i < end; ++i) {
+      if (i == transposed_input || !input_defs[i]->Exists()) {
+        continue;
+      }
+
+      const Node* producer = graph_utils::GetInputNode(node, i);
+      Permutation producer_perm;
+      if (producer != nullptr && IsTranspose(*producer) &&
+          producer->GetExecutionProviderType() == transpose.GetExecutionProviderType() &&
+          GetPermutation(*producer, producer_perm) && producer_perm == perm) {
+        input_updates.push_back({i, producer, nullptr});
+        continue;
+      }
+
+      const TensorShapeProto* shape = input_defs[i]->Shape();
+      if (shape == nullptr || shape->dim_size() > rank || (kind == PushKind::Concat && shape->dim_size() != rank)) {
+        return false;
+      }
+
+      if (IsSingleValue(*shape)) {
+        continue;  // broadcasts the same way to any layout
+      }
+
+      const TensorProto* tensor = graph_utils::GetConstantInitializer(graph, input_defs[i]->Name());
+      if (tensor == nullptr || tensor->dims_size() > rank || InitializerElementSize(tensor->data_type()) == 0) {
+        return false;
+      }
+      input_updates.push_back({i, nullptr, tensor});
+    }
+  }
+
+  // the axes of the other operators are remapped, and their outputs may be transposed differently
+  Permutation output_perm = perm;
+  const char* axis_attr_name = nullptr;
+  std::vector<int64_t> remapped_axes;
+  if (kind == PushKind::Concat || kind == PushKind::Split) {
+    const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+    int64_t axis = axis_attr != nullptr ? axis_attr->i() : 0;
+    if ((kind == PushKind::Concat && axis_attr == nullptr) || !NormalizeAxis(axis, rank)) {
+      return false;
+    }
+    axis_attr_name = "axis";
+    remapped_axes.push_back(perm[axis]);
+  } else if (kind == PushKind::Reduce || kind == PushKind::ArgReduce) {
+    const auto* keepdims_attr = graph_utils::GetNodeAttribute(node, "keepdims");
+    const bool keepdims = keepdims_attr == nullptr || keepdims_attr->i() != 0;
+
+    std::vector<int64_t> axes;
+    if (kind == PushKind::ArgReduce) {
+      const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+      axes.push_back(axis_attr != nullptr ? axis_attr->i() : 0);
+      axis_attr_name = "axis";
+    } else if (graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+      axis_attr_name = "axes";
+    } else {
+      // all the axes are reduced, the output holds a single value
+      output_perm.clear();
+    }
+
+    for (auto& axis : axes) {
+      if (!NormalizeAxis(axis, rank)) {
+        return false;
+      }
+      remapped_axes.push_back(perm[axis]);
+    }
+
+    if (axis_attr_name != nullptr && !keepdims) {
+      output_perm = ReducedPermutation(perm, axes);
+    }
+  }
+
+  // the graph is only changed from here on
+  ReplaceInput(graph, node, transposed_input, GetInputSource(transpose, 0));
+  graph.RemoveNode(transpose.Index());
+
+  std::vector<NodeIndex> bypassed_transposes;
+  for (const auto& update : input_updates) {
+    if (update.bypassed_transpose != nullptr) {
+      Node& bypassed = *graph.GetNode(update.bypassed_transpose->Index());
+      ReplaceInput(graph, node, update.index, GetInputSource(bypassed, 0));
+      bypassed_transposes.push_back(bypassed.Index());
+    } else {
+      NodeArg& transposed_arg = AddTransposedInitializer(graph, *update.transposed_tensor, inverse);
+      graph_utils::ReplaceNodeInput(node, update.index, transposed_arg);
+    }
+  }
+
+  for (auto bypassed_index : bypassed_transposes) {
+    // the same Transpose may feed several inputs
+    Node* bypassed = graph.GetNode(bypassed_index);
+    if (bypassed != nullptr) {
+      RemoveIfUnused(graph, *bypassed);
+    }
+  }
+
+  if (axis_attr_name != nullptr) {
+    if (kind == PushKind::Reduce) {
+      node.AddAttribute(axis_attr_name, remapped_axes);
+    } else {
+      node.AddAttribute(axis_attr_name, remapped_axes[0]);
+    }
+  }
+
+  if (IsIdentityPermutation(output_perm)) {
+    return true;
+  }
+
+  auto& output_defs = node.MutableOutputDefs();
+  for (int i = 0, end = static_cast<int>(output_defs.size()); i < end; ++i) {
+    NodeArg& output = *output_defs[i];
+    if (!output.Exists()) {
+      continue;
+    }
+
+    // the node now produces its output in the layout before the Transpose
+    TypeProto type;
+    if (output.TypeAsProto() != nullptr) {
+      type = *output.TypeAsProto();
+    }
+    const TensorShapeProto* output_shape = output.Shape();
+    if (output_shape != nullptr && output_shape->dim_size() == static_cast<int>(output_perm.size())) {
+      auto* shape = type.mutable_tensor_type()->mutable_shape();
+      for (size_t axis = 0; axis < output_perm.size(); ++axis) {
+        *shape->mutable_dim(static_cast<int>(output_perm[axis])) = output_shape->dim(static_cast<int>(axis));
+      }
+    } else if (type.has_tensor_type()) {
+      type.mutable_tensor_type()->clear_shape();
+    }
+
+    NodeArg& node_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output.Name()), &type);
+    Node& output_transpose = graph.AddNode(graph.GenerateNodeName("Transpose"),
+                                          "Transpose",
+                                          "Transpose pushed through " + node.Name(),
+                                          {&node_output},
+                                          {&output});
+    output_transpose.AddAttribute("perm", output_perm);
+    output_transpose.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    MoveOutputEdges(graph, node, i, output_transpose, 0);
+    output_defs[i] = &node_output;
+    graph.AddEdge(node.Index(), output_transpose.Index(), i, 0);
+
+    transposes.push_back(output_transpose.Index());
+  }
+
+  return true;
+}
+
+}  // namespace
+
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // Transposes are pushed in topological order, and the ones added by a push are pushed further down later on
+  std::deque<NodeIndex> transposes;
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (IsTranspose(node) && graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      transposes.push_back(node_index);
+    }
+  }
+
+  while (!transposes.empty()) {
+    const NodeIndex transpose_index = transposes.front();
+    transposes.pop_front();
+
+    auto* transpose = graph.GetNode(transpose_index);
+    Permutation perm;
+    if (nullptr == transpose || !GetPermutation(*transpose, perm)) {
+      continue;
+    }
+
+    if (MergeConsumerTransposes(graph, *transpose, perm)) {
+      modified = true;
+      transpose = graph.GetNode(transpose_index);
+      if (nullptr == transpose) {
+        continue;  // all the consumers were merged
+      }
+    }
+
+    if (PushTranspose(graph, *transpose, perm, transposes)) {
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
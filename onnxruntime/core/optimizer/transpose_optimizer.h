@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TransposeOptimizer
+
+Push Transpose nodes down the graph through the operators that don't depend on the layout of their input, and
+merge or cancel them with the Transpose nodes they meet. This removes the NHWC<->NCHW Transpose pairs that models
+converted from other frameworks have around each layout sensitive operator. As the permutations are handled
+generically, Transposes in either direction are pushed and cancelled.
+
+A Transpose is pushed through its single consumer when the consumer is
+  - an elementwise operator (unary, or broadcasting with inputs that are single values, constant initializers or
+    Transposes with the same permutation),
+  - a Concat or a Split, whose axis is remapped,
+  - a reduction or an ArgMax/ArgMin with the axes as attribute, whose axes are remapped.
+The outputs of the consumer are then transposed instead of its input, so a push never adds a Transpose on data
+that wasn't transposed before.
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
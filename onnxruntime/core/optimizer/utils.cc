@@ -283,6 +283,39 @@ bool CheckOutputEdges(const Graph& graph, const Node& node, size_t expected_outp
   return node.GetOutputEdgesCount() == expected_output_edges;
 }
 
+NodeArg* GetFusableAddend(const Node& producer, Node& add_node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_node, "Add", {7, 13}) ||
+      add_node.GetExecutionProviderType() != producer.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  auto& add_inputs = add_node.MutableInputDefs();
+  const NodeArg* output = producer.OutputDefs()[0];
+  NodeArg* addend;
+  if (add_inputs[0] == output && add_inputs[1] != output) {
+    addend = add_inputs[1];
+  } else if (add_inputs[1] == output && add_inputs[0] != output) {
+    addend = add_inputs[0];
+  } else {
+    return nullptr;
+  }
+
+  // The Add must not broadcast. Symbolic dimensions are only equal if they have the same dim_param.
+  const auto* output_shape = output->Shape();
+  const auto* addend_shape = addend->Shape();
+  if (output_shape == nullptr || addend_shape == nullptr || output_shape->dim_size() != addend_shape->dim_size() ||
+      output->Type() == nullptr || addend->Type() == nullptr || *output->Type() != *addend->Type()) {
+    return nullptr;
+  }
+  for (int i = 0; i < output_shape->dim_size(); ++i) {
+    if (output_shape->dim(i) != addend_shape->dim(i)) {
+      return nullptr;
+    }
+  }
+
+  return addend;
+}
+
 // Allow certain domains/ops. We don't know anything about unknown domains/ops (e.g. custom ops),
 // so we have to assume that they are not deterministic, to be on the safe side.
 // We could also allow other known domains (kMSDomain, kMSNchwcDomain, kMSFeaturizersDomain),
@@ -90,5 +90,11 @@ bool CheckOutputEdges(const Graph& graph, const Node& node, size_t expected_outp
 
 bool IsOperationDeterministic(const std::string& domain, const std::string& op);
 
+/** Check whether add_node is an Add of the output of producer and another tensor of exactly the same shape and type,
+    which producer can accumulate into its output in place of the Add, e.g. the residual of a ResNet block.
+@returns the other input of the Add, or nullptr if the Add can't be fused into producer.
+*/
+NodeArg* GetFusableAddend(const Node& producer, Node& add_node);
+
 }  // namespace optimizer_utils
 }  // namespace onnxruntime
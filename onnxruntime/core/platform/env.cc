@@ -21,6 +21,15 @@ namespace onnxruntime {
 
 Env::Env() = default;
 
+common::Status Env::BindMemoryToNumaNode(void* /*addr*/, size_t /*size*/, int /*numa_node*/) const {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Binding memory to a NUMA node is not supported on this platform.");
+}
+
+common::Status Env::PrefetchFile(_In_z_ const ORTCHAR_T* /*file_path*/, FileOffsetType /*offset*/,
+                                 size_t /*length*/) const {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Prefetching files is not supported on this platform.");
+}
+
 }  // namespace onnxruntime
 
 // This definition is provided to handle GSL failures in CUDA as
@@ -68,6 +68,14 @@ struct ThreadOptions {
 
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
+
+  // If true (and spinning is allowed), idle threads spin for a window derived from how frequently parallel loops
+  // have recently been started, parking sooner when loops are infrequent, and loops are split into finer chunks
+  // for idle threads to pick up. Otherwise threads spin for a fixed number of iterations.
+  bool adaptive_spinning = false;
+
+  // Upper bound for the adaptive spin window, in microseconds.
+  unsigned int max_spin_duration_us = 1000;
 };
 /// \brief An interface used by the onnxruntime implementation to
 /// access operating system functionality like the filesystem etc.
@@ -119,6 +127,31 @@ class Env {
   // This function doesn't support systems with more than 64 logical processors
   virtual std::vector<size_t> GetThreadAffinityMasks() const = 0;
 
+  /**
+   * Gets the thread affinity values (in the same form as ThreadOptions::affinity) for the logical processors of
+   * NUMA node <numa_node> that the process is allowed to run on.
+   * Returns an empty vector if the node doesn't exist or NUMA information isn't available on this platform.
+   */
+  virtual std::vector<size_t> GetNumaNodeThreadAffinityMasks(int /*numa_node*/) const { return {}; }
+
+  /**
+   * Gets the thread affinity values (in the same form as ThreadOptions::affinity) for one logical processor of each
+   * physical core that the process is allowed to run on, so threads pinned to them don't share a core with an SMT
+   * sibling. If <performance_cores_only> is true, only the fastest cores of a hybrid processor are returned.
+   * Returns an empty vector if the processor topology isn't available on this platform.
+   */
+  virtual std::vector<size_t> GetPhysicalCoreThreadAffinityMasks(bool /*performance_cores_only*/) const {
+    return {};
+  }
+
+  /**
+   * Sets the memory policy of the pages fully contained in [addr, addr + size) to prefer NUMA node <numa_node>.
+   * This is only effective for pages that haven't been touched yet.
+   * Returns a NOT_IMPLEMENTED status if the platform doesn't support it, in which case pages are placed by the
+   * default (usually first touch) policy.
+   */
+  virtual common::Status BindMemoryToNumaNode(void* addr, size_t size, int numa_node) const;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -149,6 +182,17 @@ class Env {
   virtual common::Status ReadFileIntoBuffer(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                             gsl::span<char> buffer) const = 0;
 
+  /**
+   * Hints that the content of the file will be read soon, so the platform can start reading it into the page cache
+   * in the background and later reads or accesses of its mapping don't wait for the storage.
+   * @param file_path The path to the file.
+   * @param offset The file offset from which the content will be read.
+   * @param length The length in bytes that will be read, 0 for up to the end of the file.
+   * Returns a NOT_IMPLEMENTED status if the platform doesn't support it, in which case the content is read when it's
+   * accessed.
+   */
+  virtual common::Status PrefetchFile(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length) const;
+
   using MappedMemoryPtr = std::unique_ptr<char[], OrtCallbackInvoker>;
 
   /**
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace onnxruntime {
+namespace profiling {
+
+/** Values of the hardware performance counters of a thread. */
+struct HardwareCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t llc_references = 0;
+  uint64_t llc_misses = 0;
+
+  HardwareCounterValues operator-(const HardwareCounterValues& other) const {
+    HardwareCounterValues result;
+    result.cycles = cycles - other.cycles;
+    result.instructions = instructions - other.instructions;
+    result.llc_references = llc_references - other.llc_references;
+    result.llc_misses = llc_misses - other.llc_misses;
+    return result;
+  }
+
+  /**
+  Adds the values to the args of a profiler event that took duration_ns. The memory bandwidth is estimated from the
+  number of last level cache misses, assuming a 64 byte cache line.
+  */
+  void AddToEventArgs(int64_t duration_ns, std::unordered_map<std::string, std::string>& event_args) const {
+    constexpr uint64_t kCacheLineSize = 64;
+    event_args["cycles"] = std::to_string(cycles);
+    event_args["instructions"] = std::to_string(instructions);
+    event_args["llc_references"] = std::to_string(llc_references);
+    event_args["llc_misses"] = std::to_string(llc_misses);
+    // bytes per ns is GB/s
+    event_args["memory_bandwidth_gbps"] =
+        std::to_string(duration_ns > 0 ? static_cast<double>(llc_misses * kCacheLineSize) / duration_ns : 0.0);
+  }
+};
+
+/**
+Reads the hardware performance counters of the calling thread. The counters are opened on the first call on each
+thread and stay open until the thread exits. Work that is handed off to other threads is not counted.
+Returns false if the counters are not available, e.g. on other platforms than Linux, when the kernel doesn't allow
+unprivileged access (see /proc/sys/kernel/perf_event_paranoid) or in virtual machines without a virtual PMU.
+On Windows the counters are collected by the recorder instead, see ort.wprp.
+*/
+bool ReadHardwareCounters(HardwareCounterValues& values);
+
+}  // namespace profiling
+}  // namespace onnxruntime
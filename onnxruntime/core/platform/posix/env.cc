@@ -27,10 +27,16 @@ limitations under the License.
 #include <dlfcn.h>
 #include <ftw.h>
 #include <string.h>
+#include <algorithm>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
 #include <assert.h>
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <fstream>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -105,6 +111,38 @@ struct Freer {
 
 using MallocdStringPtr = std::unique_ptr<char, Freer<char> >;
 
+#if defined(__linux__) && !defined(__ANDROID__)
+// Parse a sysfs cpu list such as "0-15,32-47". Returns false if the list is malformed.
+bool ParseCpuList(const std::string& cpu_list, std::vector<size_t>& cpus) {
+  size_t pos = 0;
+  while (pos < cpu_list.size()) {
+    size_t end = cpu_list.find(',', pos);
+    if (end == std::string::npos) {
+      end = cpu_list.size();
+    }
+    std::string range = cpu_list.substr(pos, end - pos);
+    pos = end + 1;
+    if (range.empty()) {
+      continue;
+    }
+
+    char* parse_end = nullptr;
+    size_t first = strtoul(range.c_str(), &parse_end, 10);
+    size_t last = first;
+    if (*parse_end == '-') {
+      last = strtoul(parse_end + 1, &parse_end, 10);
+    }
+    if (*parse_end != '\0' || last < first) {
+      return false;
+    }
+    for (size_t cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return true;
+}
+#endif
+
 class PosixThread : public EnvThread {
  private:
   struct Param {
@@ -206,6 +244,124 @@ class PosixEnv : public Env {
     return ret;
   }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+  std::vector<size_t> GetNumaNodeThreadAffinityMasks(int numa_node) const override {
+    std::vector<size_t> ret;
+    if (numa_node < 0) {
+      return ret;
+    }
+
+    std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    std::string cpu_list;
+    std::vector<size_t> node_cpus;
+    if (!cpu_list_file || !std::getline(cpu_list_file, cpu_list) || !ParseCpuList(cpu_list, node_cpus)) {
+      return ret;
+    }
+
+    // Skip CPUs the process isn't allowed to run on (e.g. due to taskset or a cgroup cpuset), as pinning
+    // a thread to them would fail.
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_allowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (size_t cpu : node_cpus) {
+      if (cpu < CPU_SETSIZE && (!have_allowed || CPU_ISSET(cpu, &allowed))) {
+        ret.push_back(cpu);
+      }
+    }
+    return ret;
+  }
+
+  std::vector<size_t> GetPhysicalCoreThreadAffinityMasks(bool performance_cores_only) const override {
+    std::vector<size_t> ret;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      return ret;
+    }
+
+    // the kernel lists the performance cores of Intel hybrid processors as the cpus of the cpu_core PMU, and
+    // describes the relative performance of the cores of ARM big.LITTLE processors with cpu_capacity
+    std::vector<size_t> performance_cpus;
+    if (performance_cores_only) {
+      std::ifstream core_pmu_file("/sys/devices/cpu_core/cpus");
+      std::string cpu_list;
+      if (!core_pmu_file || !std::getline(core_pmu_file, cpu_list) || !ParseCpuList(cpu_list, performance_cpus)) {
+        performance_cpus.clear();
+      }
+    }
+
+    std::vector<std::pair<size_t, long>> cores;  // first allowed logical processor of the core and its capacity
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (!CPU_ISSET(cpu, &allowed)) {
+        continue;
+      }
+
+      const std::string cpu_dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+      std::ifstream siblings_file(cpu_dir + "/topology/thread_siblings_list");
+      std::string sibling_list;
+      std::vector<size_t> siblings;
+      if (!siblings_file || !std::getline(siblings_file, sibling_list) || !ParseCpuList(sibling_list, siblings)) {
+        return {};
+      }
+
+      // a core is represented by its first logical processor the process is allowed to run on
+      const bool is_first_sibling = std::none_of(siblings.begin(), siblings.end(), [cpu, &allowed](size_t sibling) {
+        return sibling < cpu && CPU_ISSET(sibling, &allowed);
+      });
+      if (!is_first_sibling) {
+        continue;
+      }
+
+      long capacity = 0;
+      if (!performance_cpus.empty()) {
+        capacity = std::find(performance_cpus.begin(), performance_cpus.end(), cpu) != performance_cpus.end() ? 1 : 0;
+      } else if (performance_cores_only) {
+        std::ifstream capacity_file(cpu_dir + "/cpu_capacity");
+        if (!(capacity_file >> capacity)) {
+          capacity = 0;
+        }
+      }
+      cores.emplace_back(cpu, capacity);
+    }
+
+    long max_capacity = 0;
+    for (const auto& core : cores) {
+      max_capacity = std::max(max_capacity, core.second);
+    }
+    for (const auto& core : cores) {
+      if (core.second == max_capacity) {
+        ret.push_back(core.first);
+      }
+    }
+    return ret;
+  }
+
+  common::Status BindMemoryToNumaNode(void* addr, size_t size, int numa_node) const override {
+    // Only bind whole pages inside the range, so that the policy of memory adjacent to the block isn't changed.
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page_size - 1);
+    if (numa_node < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid NUMA node ", numa_node);
+    }
+    if (end <= begin) {
+      return Status::OK();
+    }
+
+    constexpr int kMpolPreferred = 1;  // MPOL_PREFERRED from numaif.h, which requires libnuma headers
+    constexpr size_t kBitsPerMaskWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerMaskWord + 1, 0);
+    node_mask[numa_node / kBitsPerMaskWord] |= 1UL << (numa_node % kBitsPerMaskWord);
+    // the kernel expects the number of bits in the mask plus one
+    const unsigned long max_node = static_cast<unsigned long>(node_mask.size() * kBitsPerMaskWord + 1);
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, node_mask.data(), max_node, 0) != 0) {
+      const int err = errno;
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mbind to NUMA node ", numa_node, " failed. errno: ", err);
+    }
+    return Status::OK();
+  }
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -304,6 +460,30 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  Status PrefetchFile(const ORTCHAR_T* file_path, FileOffsetType offset, size_t length) const override {
+    ORT_RETURN_IF_NOT(file_path);
+    ORT_RETURN_IF_NOT(offset >= 0);
+
+#if defined(POSIX_FADV_WILLNEED)
+    ScopedFileDescriptor file_descriptor{open(file_path, O_RDONLY)};
+    if (!file_descriptor.IsValid()) {
+      return ReportSystemError("open", file_path);
+    }
+
+    // this only queues the reads, which go on after the file descriptor is closed.
+    // a length of 0 means up to the end of the file for posix_fadvise too.
+    const int result = posix_fadvise(file_descriptor.Get(), offset, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+    if (result != 0) {
+      errno = result;
+      return ReportSystemError("posix_fadvise", file_path);
+    }
+
+    return Status::OK();
+#else
+    return Env::PrefetchFile(file_path, offset, length);
+#endif
+  }
+
   Status MapFileIntoMemory(const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                            MappedMemoryPtr& mapped_memory) const override {
     ORT_RETURN_IF_NOT(file_path);
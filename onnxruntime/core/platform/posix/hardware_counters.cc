@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+namespace profiling {
+
+#ifdef __linux__
+namespace {
+
+// The counters are opened as a single group so they are scheduled together and read with one system call.
+class PerfEventGroup {
+ public:
+  PerfEventGroup() {
+    const std::array<std::pair<uint32_t, uint64_t>, kNumEvents> events{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    }};
+
+    for (size_t i = 0; i < kNumEvents; ++i) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = events[i].first;
+      attr.config = events[i].second;
+      attr.read_format = PERF_FORMAT_GROUP;
+      // only the leader starts disabled, the other events follow it
+      attr.disabled = i == 0 ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      // count the calling thread on any CPU
+      const int group_fd = i == 0 ? -1 : fds_[0];
+      fds_[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+      if (fds_[i] < 0) {
+        Close();
+        return;
+      }
+    }
+
+    if (ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0) {
+      Close();
+    }
+  }
+
+  ~PerfEventGroup() { Close(); }
+
+  bool Read(HardwareCounterValues& values) const {
+    if (fds_[0] < 0) {
+      return false;
+    }
+
+    // layout of PERF_FORMAT_GROUP: the number of events followed by their values
+    uint64_t buffer[1 + kNumEvents];
+    if (read(fds_[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != kNumEvents) {
+      return false;
+    }
+
+    values.cycles = buffer[1];
+    values.instructions = buffer[2];
+    values.llc_references = buffer[3];
+    values.llc_misses = buffer[4];
+    return true;
+  }
+
+ private:
+  static constexpr size_t kNumEvents = 4;
+
+  void Close() {
+    for (auto& fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+  }
+
+  std::array<int, kNumEvents> fds_{{-1, -1, -1, -1}};
+};
+
+constexpr size_t PerfEventGroup::kNumEvents;
+
+}  // namespace
+
+bool ReadHardwareCounters(HardwareCounterValues& values) {
+  thread_local PerfEventGroup perf_event_group;
+  return perf_event_group.Read(values);
+}
+
+#else
+
+bool ReadHardwareCounters(HardwareCounterValues& /*values*/) {
+  return false;
+}
+
+#endif
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -40,6 +40,22 @@ EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 namespace onnxruntime {
 
 namespace {
+
+class UnmapFileParam {
+ public:
+  void* addr;
+  size_t len;
+};
+
+static void UnmapFile(void* param) noexcept {
+  UnmapFileParam* p = reinterpret_cast<UnmapFileParam*>(param);
+  if (!UnmapViewOfFile(p->addr)) {
+    const int err = GetLastError();
+    LOGS_DEFAULT(ERROR) << "UnmapViewOfFile failed. error code: " << err;
+  }
+  delete p;
+}
+
 class WindowsThread : public EnvThread {
  private:
   struct Param {
@@ -178,6 +194,74 @@ class WindowsEnv : public Env {
     return ret;
   }
 
+  std::vector<size_t> GetNumaNodeThreadAffinityMasks(int numa_node) const override {
+    std::vector<size_t> ret;
+    GROUP_AFFINITY group_affinity;
+    if (numa_node < 0 || GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numa_node), &group_affinity) == FALSE) {
+      return ret;
+    }
+    // Thread affinity is set with SetThreadAffinityMask, which only addresses the processors in the
+    // current processor group, so a node in another group yields no usable processors.
+    GROUP_AFFINITY current_group;
+    if (GetThreadGroupAffinity(GetCurrentThread(), &current_group) == FALSE ||
+        current_group.Group != group_affinity.Group) {
+      return ret;
+    }
+    for (size_t bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit) {
+      size_t mask = static_cast<size_t>(1) << bit;
+      if (group_affinity.Mask & mask) {
+        ret.push_back(mask);
+      }
+    }
+    return ret;
+  }
+
+  std::vector<size_t> GetPhysicalCoreThreadAffinityMasks(bool performance_cores_only) const override {
+    std::vector<size_t> ret;
+    GROUP_AFFINITY current_group;
+    if (GetThreadGroupAffinity(GetCurrentThread(), &current_group) == FALSE) {
+      return ret;
+    }
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+      return ret;
+    }
+    std::vector<char> buffer(length);
+    auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+    if (GetLogicalProcessorInformationEx(RelationProcessorCore, info, &length) == FALSE) {
+      return ret;
+    }
+
+    // the first logical processor of each core in the current processor group, and its efficiency class. higher
+    // classes are faster cores, and all the cores have class 0 on processors that aren't hybrid.
+    std::vector<std::pair<size_t, BYTE>> cores;
+    for (DWORD offset = 0; offset < length;) {
+      const auto* core = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+      offset += core->Size;
+      for (WORD i = 0; i < core->Processor.GroupCount; ++i) {
+        const GROUP_AFFINITY& group_mask = core->Processor.GroupMask[i];
+        const KAFFINITY allowed = group_mask.Mask & current_group.Mask;
+        if (group_mask.Group == current_group.Group && allowed != 0) {
+          cores.emplace_back(static_cast<size_t>(allowed & (~allowed + 1)), core->Processor.EfficiencyClass);
+        }
+      }
+    }
+
+    BYTE max_class = 0;
+    for (const auto& core : cores) {
+      if (core.second > max_class) {
+        max_class = core.second;
+      }
+    }
+    for (const auto& core : cores) {
+      if (!performance_cores_only || core.second == max_class) {
+        ret.push_back(core.first);
+      }
+    }
+    return ret;
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
@@ -286,8 +370,61 @@ class WindowsEnv : public Env {
     return Status::OK();
   }
 
-  Status MapFileIntoMemory(_In_z_ const ORTCHAR_T*, FileOffsetType, size_t, MappedMemoryPtr&) const override {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "MapFileIntoMemory is not implemented on Windows.");
+  Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
+                           MappedMemoryPtr& mapped_memory) const override {
+    ORT_RETURN_IF_NOT(file_path);
+    ORT_RETURN_IF_NOT(offset >= 0);
+
+#if WINVER >= _WIN32_WINNT_WIN8
+    wil::unique_hfile file_handle{
+        CreateFile2(file_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL)};
+#else
+    wil::unique_hfile file_handle{
+        CreateFileW(file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)};
+#endif
+    if (file_handle.get() == INVALID_HANDLE_VALUE) {
+      const int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "open file ", ToMBString(file_path), " fail, errcode = ", err);
+    }
+
+    if (length == 0) {
+      mapped_memory = MappedMemoryPtr{};
+      return Status::OK();
+    }
+
+    // the view is created with copy-on-write access like the private mapping on other platforms, so pages are
+    // only read from the file when they are first touched
+    wil::unique_handle file_mapping_handle{
+        CreateFileMappingW(file_handle.get(), NULL, PAGE_WRITECOPY, 0, 0, NULL)};
+    if (file_mapping_handle.get() == NULL) {
+      const int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "CreateFileMapping ", ToMBString(file_path),
+                             " fail, errcode = ", err);
+    }
+
+    // the offset of a view must be a multiple of the allocation granularity
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    const FileOffsetType granularity = static_cast<FileOffsetType>(system_info.dwAllocationGranularity);
+    const FileOffsetType offset_to_granularity = offset % granularity;
+    const size_t mapped_length = length + static_cast<size_t>(offset_to_granularity);
+    const FileOffsetType mapped_offset = offset - offset_to_granularity;
+
+    void* const mapped_base = MapViewOfFile(file_mapping_handle.get(), FILE_MAP_COPY,
+                                            static_cast<DWORD>((mapped_offset >> 32) & 0xFFFFFFFF),
+                                            static_cast<DWORD>(mapped_offset & 0xFFFFFFFF),
+                                            mapped_length);
+    if (mapped_base == NULL) {
+      const int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "MapViewOfFile ", ToMBString(file_path), " fail, errcode = ", err);
+    }
+
+    // the view keeps the file mapping object alive so the handles can be closed
+    mapped_memory =
+        MappedMemoryPtr{reinterpret_cast<char*>(mapped_base) + offset_to_granularity,
+                        OrtCallbackInvoker{OrtCallback{UnmapFile, new UnmapFileParam{mapped_base, mapped_length}}}};
+
+    return Status::OK();
   }
 
   bool FolderExists(const std::wstring& path) const override {
@@ -0,0 +1,17 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+// User mode code can't program the PMU on Windows. The counters are collected by ETW instead: the
+// OrtTraceLoggingProvider.HardwareCounters profile in ort.wprp records them together with the OpStart and OpEnd
+// events that builds with onnxruntime_ENABLE_INSTRUMENT write around each kernel.
+bool ReadHardwareCounters(HardwareCounterValues& /*values*/) {
+  return false;
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
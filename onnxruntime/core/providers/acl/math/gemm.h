@@ -28,6 +28,10 @@ typedef struct {
   std::shared_ptr<arm_compute::IFunction> layer;
   std::shared_ptr<arm_compute::Tensor> a, b, c, d;
   std::shared_ptr<arm_compute::MemoryManagerOnDemand> mm_layer;
+  // input shape the layer is configured for
+  TensorShape a_shape;
+  // B and C are constant and stay imported between the runs
+  bool b_imported;
 } ACLNEGEMM;
 
 typedef std::map<OpKernel*, ACLNEGEMM>::iterator GEMMLayersIterator;
@@ -45,6 +49,10 @@ class Gemm : public onnxruntime::Gemm<T> {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    const Tensor* tensor;
+    constant_b_ = info.TryGetConstantInput(1, &tensor) &&
+                  (info.node().InputDefs().size() < 3 || info.TryGetConstantInput(2, &tensor));
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -105,12 +113,20 @@ class Gemm : public onnxruntime::Gemm<T> {
 
     ACLNEGEMM* pGEMM;
     GEMMLayersIterator it = gemmLayers.find((OpKernel*)this);
+    if (it != gemmLayers.end() && it->second.a_shape != A->Shape()) {
+      // the layer was configured for another input shape
+      LOGS_DEFAULT(VERBOSE) << "Reconfiguring ACL Gemm for input shape " << A->Shape().ToString();
+      gemmLayers.erase(it);
+      it = gemmLayers.end();
+    }
     if (it == gemmLayers.end()) {
       ACLNEGEMM tGEMM;
       tGEMM.a = std::make_shared<arm_compute::Tensor>();
       tGEMM.b = std::make_shared<arm_compute::Tensor>();
       tGEMM.c = std::make_shared<arm_compute::Tensor>();
       tGEMM.d = std::make_shared<arm_compute::Tensor>();
+      tGEMM.a_shape = A->Shape();
+      tGEMM.b_imported = false;
 
       tGEMM.a->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(A->Shape()), arm_compute::Format::F32));
       tGEMM.b->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(B->Shape()), arm_compute::Format::F32));
@@ -134,7 +150,6 @@ class Gemm : public onnxruntime::Gemm<T> {
       ret = gemmLayers.insert(std::pair<OpKernel*, ACLNEGEMM>((OpKernel*)this, tGEMM));
       pGEMM = &ret.first->second;
     } else {
-      //TODO: valildate shapes
       pGEMM = &it->second;
     }
 
@@ -143,10 +158,15 @@ class Gemm : public onnxruntime::Gemm<T> {
     T* d_data = D->template MutableData<T>();
 
     ACLImportMemory(pGEMM->a->allocator(), (void*)a_data, A->Shape().Size() * 4);
-    ACLImportMemory(pGEMM->b->allocator(), (void*)b_data, B->Shape().Size() * 4);
-    if(useC){
-      const T* c_data = C->template Data<T>();
-      ACLImportMemory(pGEMM->c->allocator(), (void*)c_data, C->Shape().Size() * 4);
+    // constant weights are imported once; the fully connected layer transforms them on its first run and keeps
+    // the result
+    if (!pGEMM->b_imported) {
+      ACLImportMemory(pGEMM->b->allocator(), (void*)b_data, B->Shape().Size() * 4);
+      if(useC){
+        const T* c_data = C->template Data<T>();
+        ACLImportMemory(pGEMM->c->allocator(), (void*)c_data, C->Shape().Size() * 4);
+      }
+      pGEMM->b_imported = constant_b_;
     }
 
     if(D->Shape().Size() != 0 && pGEMM->d->info()->has_padding() ){
@@ -170,8 +190,10 @@ class Gemm : public onnxruntime::Gemm<T> {
     }
 
     pGEMM->a->allocator()->free();
-    pGEMM->b->allocator()->free();
-    pGEMM->c->allocator()->free();
+    if (!pGEMM->b_imported) {
+      pGEMM->b->allocator()->free();
+      pGEMM->c->allocator()->free();
+    }
     pGEMM->d->allocator()->free();
 
     return Status::OK();
@@ -188,6 +210,7 @@ class Gemm : public onnxruntime::Gemm<T> {
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
+  bool constant_b_;
 };
 
 template <typename T>
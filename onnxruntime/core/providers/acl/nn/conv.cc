@@ -56,8 +56,18 @@ template <typename T>
 Status Conv<T>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
 
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+
   ACLNEConv* pConv;
   ConvLayersIterator it = Conv::convLayers.find((OpKernel*)this);
+  if (it != Conv::convLayers.end() && it->second.in_shape != X->Shape()) {
+    // the layer was configured for another input shape
+    LOGS_DEFAULT(VERBOSE) << "Reconfiguring ACL Conv for input shape " << X->Shape().ToString();
+    Conv::convLayers.erase(it);
+    it = Conv::convLayers.end();
+  }
   if (it != Conv::convLayers.end()) {
     pConv = &it->second;
     if (pConv->isDepthwiseCPU == true) {
@@ -66,10 +76,6 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
     }
   }
 
-  const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
-  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
-
   const int64_t N = X->Shape()[0];
   const int64_t M = W->Shape()[0];
 
@@ -138,6 +144,8 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
 
     ACLNEConv tconv;
     tconv.mm_layer = std::move(mm_layer);
+    tconv.in_shape = X->Shape();
+    tconv.k_imported = false;
 
     tconv.in = std::make_shared<arm_compute::Tensor>();
     tconv.k = std::make_shared<arm_compute::Tensor>();
@@ -281,19 +289,22 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
     ACLPrintTensorShape("Y", *tconv.out.get());
 
   } else {
-    //TODO: valildate shapes
     pConv = &it->second;
   }
 
   const T* x_data = X->template Data<T>();
   ACLImportMemory(pConv->in->allocator(), (void*)x_data, X->Shape().Size() * 4);
 
-  const T* k_data = W->template Data<T>();
-  ACLImportMemory(pConv->k->allocator(), (void*)k_data, W->Shape().Size() * 4);
+  // constant weights and bias are imported once; the layer transforms them on its first run and keeps the result
+  if (!pConv->k_imported) {
+    const T* k_data = W->template Data<T>();
+    ACLImportMemory(pConv->k->allocator(), (void*)k_data, W->Shape().Size() * 4);
 
-  if (B != nullptr) {
-    const T* b_data = B->template Data<T>();
-    ACLImportMemory(pConv->b->allocator(), (void*)b_data, B->Shape().Size() * 4);
+    if (B != nullptr) {
+      const T* b_data = B->template Data<T>();
+      ACLImportMemory(pConv->b->allocator(), (void*)b_data, B->Shape().Size() * 4);
+    }
+    pConv->k_imported = constant_weights_;
   }
 
   T* y_data = Y->template MutableData<T>();
@@ -305,9 +316,11 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   pConv->mm_layer->clear();
 
   pConv->in->allocator()->free();
-  pConv->k->allocator()->free();
-  if (B != nullptr)
-    pConv->b->allocator()->free();
+  if (!pConv->k_imported) {
+    pConv->k->allocator()->free();
+    if (B != nullptr)
+      pConv->b->allocator()->free();
+  }
   pConv->out->allocator()->free();
 
   LOGS_DEFAULT(VERBOSE) << std::endl;
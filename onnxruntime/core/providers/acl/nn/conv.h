@@ -30,6 +30,10 @@ typedef struct
   std::shared_ptr<arm_compute::Tensor> k;
   std::shared_ptr<arm_compute::Tensor> b;
   std::shared_ptr<arm_compute::Tensor> out;
+  // input shape the layer is configured for
+  TensorShape in_shape;
+  // the weights and bias are constant and stay imported between the runs
+  bool k_imported;
   bool isDepthwiseCPU;
 } ACLNEConv;
 
@@ -41,6 +45,10 @@ class Conv : public onnxruntime::Conv<T> {
   explicit Conv(const OpKernelInfo& info) : onnxruntime::Conv<T>(info), conv_attrs_(info) {
     provider_ = (const_cast<ACLExecutionProvider*>(
         static_cast<const ACLExecutionProvider*>(info.GetExecutionProvider())));
+
+    const Tensor* tensor;
+    constant_weights_ = info.TryGetConstantInput(1, &tensor) &&
+                        (info.node().InputDefs().size() < 3 || info.TryGetConstantInput(2, &tensor));
   }
 
   ~Conv() {
@@ -54,6 +62,7 @@ class Conv : public onnxruntime::Conv<T> {
   ConvAttributes conv_attrs_;
   ACLExecutionProvider* provider_;
   std::string activation_type;
+  bool constant_weights_;
 
   arm_compute::TensorShape ACLReshapeWeightsDepthwise(arm_compute::Tensor* kernel) const;
 };
@@ -191,10 +191,13 @@ common::Status If::SetupSubgraphExecutionInfo(const SessionState& session_state,
 
   utils::FinalizeFeedFetchCopyInfo(*ffm, feed_locations, fetch_locations);
 
-  if (attribute_name == "then_branch")
+  if (attribute_name == "then_branch") {
     then_feeds_fetches_manager_ = std::move(ffm);
-  else
+    then_session_state_ = &subgraph_session_state;
+  } else {
     else_feeds_fetches_manager_ = std::move(ffm);
+    else_session_state_ = &subgraph_session_state;
+  }
 
   return Status::OK();
 }
@@ -207,23 +210,17 @@ Status If::Compute(OpKernelContext* ctx) const {
 
   auto condition = *ctx->Input<Tensor>(0)->Data<bool>();
 
-  auto attribute = condition ? "then_branch" : "else_branch";
-  auto* session_state = ctx_internal->SubgraphSessionState(attribute);
-  ORT_ENFORCE(session_state, "Subgraph SessionState was not found for '", attribute, "' attribute.");
-
+  // the branch's SessionState, Info and FeedsFetchesManager were all prepared in SetupSubgraphExecutionInfo
+  const auto* session_state = condition ? then_session_state_ : else_session_state_;
   const auto& info = condition ? then_info_ : else_info_;
+  const auto& ffm = condition ? then_feeds_fetches_manager_ : else_feeds_fetches_manager_;
+
   IfImpl impl{*ctx_internal, *session_state, *info};
 
   auto status = impl.Initialize();
   ORT_RETURN_IF_ERROR(status);
 
-  if (condition) {
-    status = impl.Execute(*then_feeds_fetches_manager_);
-  } else {
-    status = impl.Execute(*else_feeds_fetches_manager_);
-  }
-
-  return status;
+  return impl.Execute(*ffm);
 }
 
 IfImpl::IfImpl(OpKernelContextInternal& context,
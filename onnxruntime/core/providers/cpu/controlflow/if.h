@@ -33,5 +33,10 @@ class If : public controlflow::IControlFlowKernel {
   std::unique_ptr<Info> else_info_;
   std::unique_ptr<FeedsFetchesManager> then_feeds_fetches_manager_;
   std::unique_ptr<FeedsFetchesManager> else_feeds_fetches_manager_;
+
+  // SessionState of each subgraph, saved when the subgraph execution info is setup so Compute doesn't need to look it
+  // up by attribute name for every execution.
+  const SessionState* then_session_state_ = nullptr;
+  const SessionState* else_session_state_ = nullptr;
 };
 }  // namespace onnxruntime
@@ -21,6 +21,8 @@
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/session_options.h"
 
+#include <unordered_set>
+
 #include "gsl/gsl"
 
 #ifdef _MSC_VER
@@ -162,6 +164,7 @@ class LoopImpl {
 
  private:
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
+  void CreateLoopCarriedVarAllocators(std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
   // create the single Loop output from a collection of per-iteration outputs
@@ -183,9 +186,22 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // loop carried var buffers from the iteration before the previous one that are no longer referenced by the
+  // feeds or the saved loop outputs. the next iteration writes its loop carried var output into them if the shape
+  // matches, so a loop whose state has a fixed shape alternates between two buffers instead of allocating each time.
+  std::vector<OrtValue> recycled_loop_carried_vars_;
+
+  // buffers that must never be recycled: the Loop inputs, the implicit inputs and the saved loop outputs
+  std::unordered_set<const void*> pinned_buffers_;
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
+// returns the buffer of a tensor value, or nullptr if the value is not a tensor or has no data
+static const void* TensorBuffer(const OrtValue& value) {
+  return value.IsAllocated() && value.IsTensor() ? value.Get<Tensor>().DataRaw() : nullptr;
+}
+
 static Status ConcatenateCpuOutput(std::vector<OrtValue>& per_iteration_output,
                                    void* output, size_t output_size_in_bytes) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
@@ -377,6 +393,15 @@ Status LoopImpl::Initialize() {
   condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank);
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
+  recycled_loop_carried_vars_.resize(info_.num_loop_carried_vars);
+
+  for (int i = 2; i < info_.num_subgraph_inputs; ++i) {
+    pinned_buffers_.insert(TensorBuffer(*context_.GetInputMLValue(i)));
+  }
+
+  for (const auto* entry : implicit_inputs_) {
+    pinned_buffers_.insert(TensorBuffer(*entry));
+  }
 
   return status;
 }
@@ -399,20 +424,62 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
+void LoopImpl::CreateLoopCarriedVarAllocators(
+    std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    // skip 'cond' in output
+    fetch_allocators[i + 1] = [this, i](const TensorShape& shape, const OrtMemoryInfo& location,
+                                        OrtValue& ort_value, bool& allocated) {
+      OrtValue& recycled = recycled_loop_carried_vars_[i];
+      if (recycled.IsAllocated()) {
+        const auto& tensor = recycled.Get<Tensor>();
+        if (tensor.Shape() == shape && tensor.Location().device == location.device) {
+          ort_value = recycled;
+          allocated = true;
+        }
+
+        // a buffer is only handed out once
+        recycled = OrtValue();
+      }
+
+      return Status::OK();
+    };
+  }
+}
+
 void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
                                          std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
+  // save loop outputs as we have to concatenate at the end
+  for (int j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
+    const auto& loop_output = last_outputs[j + 1];  // skip 'cond' in output
+    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(loop_output);
+    pinned_buffers_.insert(TensorBuffer(loop_output));
+  }
+
+  // the loop carried var inputs of the last iteration can be overwritten by the next iteration unless the subgraph
+  // passed them through to an output, or they are shared with another loop carried var
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    OrtValue& last_input = next_inputs[i + 2];  // skip iter_num and cond
+    const void* buffer = TensorBuffer(last_input);
+
+    bool recyclable = buffer != nullptr && pinned_buffers_.count(buffer) == 0 &&
+                      std::none_of(last_outputs.cbegin(), last_outputs.cend(),
+                                   [buffer](const OrtValue& output) { return TensorBuffer(output) == buffer; });
+
+    for (int j = 0; recyclable && j < info_.num_loop_carried_vars; ++j) {
+      recyclable = j == i || TensorBuffer(next_inputs[j + 2]) != buffer;
+    }
+
+    recycled_loop_carried_vars_[i] = recyclable ? last_input : OrtValue();
+  }
+
   // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
   for (int i = 1; i < info_.num_subgraph_inputs; ++i) {
     next_inputs[i] = last_outputs[i - 1];
   }
-
-  // save loop outputs as we have to concatenate at the end
-  for (int j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
-  }
 }
 
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
@@ -440,7 +507,10 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
 
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+
   CreateInitialFeeds(feeds);
+  CreateLoopCarriedVarAllocators(fetch_allocators);
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
@@ -450,7 +520,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
@@ -516,7 +586,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
                                          << " was not found. Defaulting to a rank 1 shape of {0}.";
       }
 
-      ORT_IGNORE_RETURN_VALUE(context_.Output(i, TensorShape(output_dims)));
+      ORT_IGNORE_RETURN_VALUE(context_.Output(i, output_dims));
     }
   }
   return status;
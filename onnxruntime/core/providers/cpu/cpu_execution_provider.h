@@ -3,22 +3,51 @@
 
 #pragma once
 
+#include <sstream>
+
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
 #include "core/graph/constants.h"
 
 namespace onnxruntime {
 
+// Default of CPUExecutionProviderInfo::sparse_matmul_threshold.
+constexpr float kDefaultSparseMatMulThreshold = 0.8f;
+
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // If >= 0, allocate from memory placed on this NUMA node, to match a thread pool pinned to the node.
+  int numa_node{-1};
+  // If true, tree ensemble kernels quantize their thresholds, see kOrtSessionOptionsConfigQuantizeTreeEnsembleThresholds.
+  bool quantize_tree_ensemble_thresholds{false};
+  // If true, Conv kernels never use the Winograd algorithm, see kOrtSessionOptionsConfigDisableWinogradConv.
+  bool disable_winograd_conv{false};
+  // MatMul kernels multiply constant float weights whose ratio of zero blocks is at least this with a sparse kernel,
+  // see kOrtSessionOptionsConfigSparseMatMulThreshold.
+  float sparse_matmul_threshold{kDefaultSparseMatMulThreshold};
+  // If true, LabelEncoder and CategoryMapper kernels use minimal perfect hash tables,
+  // see kOrtSessionOptionsConfigMlPerfectHashTables.
+  bool ml_perfect_hash_tables{false};
 
-  explicit CPUExecutionProviderInfo(bool use_arena)
-      : create_arena(use_arena) {}
+  explicit CPUExecutionProviderInfo(bool use_arena, int numa_node_in = -1)
+      : create_arena(use_arena), numa_node(numa_node_in) {}
 
   CPUExecutionProviderInfo() = default;
 };
 
+// Provider option set to "1" if CPUExecutionProviderInfo::quantize_tree_ensemble_thresholds is true.
+constexpr const char* kCpuProviderOptionQuantizeTreeEnsembleThresholds = "quantize_tree_ensemble_thresholds";
+
+// Provider option set to "1" if CPUExecutionProviderInfo::disable_winograd_conv is true.
+constexpr const char* kCpuProviderOptionDisableWinogradConv = "disable_winograd_conv";
+
+// Provider option holding CPUExecutionProviderInfo::sparse_matmul_threshold if it isn't the default.
+constexpr const char* kCpuProviderOptionSparseMatMulThreshold = "sparse_matmul_threshold";
+
+// Provider option set to "1" if CPUExecutionProviderInfo::ml_perfect_hash_tables is true.
+constexpr const char* kCpuProviderOptionMlPerfectHashTables = "ml_perfect_hash_tables";
+
 using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
                                       std::vector<std::unique_ptr<ComputeCapability>>&)>;
 
@@ -40,10 +69,35 @@ class CPUExecutionProvider : public IExecutionProvider {
     create_arena = false;
 #endif
 
-    AllocatorCreationInfo device_info{[](int) { return onnxruntime::make_unique<TAllocator>(); },
+    const int numa_node = info.numa_node;
+    AllocatorCreationInfo device_info{[numa_node](int) -> std::unique_ptr<IAllocator> {
+                                        if (numa_node >= 0) {
+                                          return onnxruntime::make_unique<NumaCPUAllocator>(numa_node);
+                                        }
+                                        return onnxruntime::make_unique<TAllocator>();
+                                      },
                                       0, create_arena};
 
     InsertAllocator(CreateAllocator(device_info));
+
+    UnorderedMapStringToString options;
+    if (info.quantize_tree_ensemble_thresholds) {
+      options[kCpuProviderOptionQuantizeTreeEnsembleThresholds] = "1";
+    }
+    if (info.disable_winograd_conv) {
+      options[kCpuProviderOptionDisableWinogradConv] = "1";
+    }
+    if (info.sparse_matmul_threshold != kDefaultSparseMatMulThreshold) {
+      std::ostringstream threshold;
+      threshold << info.sparse_matmul_threshold;
+      options[kCpuProviderOptionSparseMatMulThreshold] = threshold.str();
+    }
+    if (info.ml_perfect_hash_tables) {
+      options[kCpuProviderOptionMlPerfectHashTables] = "1";
+    }
+    if (!options.empty()) {
+      SetProviderOptions(options);
+    }
   }
 
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
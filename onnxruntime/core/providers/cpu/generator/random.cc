@@ -22,10 +22,11 @@ limitations under the License.
 #endif
 
 #include <algorithm>
-#include <chrono>
-#include <random>
+#include <cmath>
 
 #include "core/common/safeint.h"
+#include "core/framework/philox.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include "core/common/eigen_common_wrapper.h"
 #include "gsl/gsl"
@@ -68,11 +69,111 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<float>()).TypeConstraint("T2", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
     Multinomial);
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor);
+// The values of a Philox block as values uniformly distributed in [0, 1).
+template <typename T>
+struct PhiloxUniform;
+
+template <>
+struct PhiloxUniform<float> {
+  static constexpr int64_t kPerBlock = 4;
+  static float Get(const uint32_t* block, int64_t i) { return Philox4x32x10::ToFloat(block[i]); }
+};
+
+template <>
+struct PhiloxUniform<double> {
+  static constexpr int64_t kPerBlock = 2;
+  static double Get(const uint32_t* block, int64_t i) {
+    return Philox4x32x10::ToDouble(block[2 * i], block[2 * i + 1]);
+  }
+};
+
+// cost of generating a Philox block
+constexpr double kPhiloxBlockCost = 64.0;
+
+// The output is generated from blocks offset, offset + 1, ... of the Philox stream of the seed, and element i only
+// depends on i, so the blocks are generated in parallel and the output doesn't depend on the number of threads.
+template <typename T>
+static void GenerateUniform(float low, float high, PhiloxGenerator& generator, concurrency::ThreadPool* tp,
+                            Tensor& Y) {
+  using Uniform = PhiloxUniform<T>;
+  T* out = Y.MutableData<T>();
+  const int64_t size = Y.Shape().Size();
+  const int64_t num_blocks = (size + Uniform::kPerBlock - 1) / Uniform::kPerBlock;
+  const auto seeds = generator.NextPhiloxSeeds(static_cast<uint64_t>(num_blocks));
+  const T range = static_cast<T>(high) - static_cast<T>(low);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks),
+      TensorOpCost{0.0, static_cast<double>(Uniform::kPerBlock * sizeof(T)), kPhiloxBlockCost},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        uint32_t block[4];
+        for (int64_t b = first; b < last; ++b) {
+          Philox4x32x10::Generate(seeds.first, seeds.second + b, 0, block);
+          const int64_t begin = b * Uniform::kPerBlock;
+          const int64_t end = std::min(begin + Uniform::kPerBlock, size);
+          for (int64_t i = begin; i < end; ++i) {
+            out[i] = static_cast<T>(low) + range * Uniform::Get(block, i - begin);
+          }
+        }
+      });
+}
+
+// Generates the output like GenerateUniform, with the Box-Muller transform of uniform values 2k and 2k + 1 as
+// elements 2k and 2k + 1. The transform is vectorized over chunks of blocks.
+template <typename T>
+static void GenerateNormal(float mean, float scale, PhiloxGenerator& generator, concurrency::ThreadPool* tp,
+                           Tensor& Y) {
+  using Uniform = PhiloxUniform<T>;
+  constexpr int64_t kPairsPerBlock = Uniform::kPerBlock / 2;
+  constexpr int64_t kBlocksPerChunk = 64;
+  using ChunkArray = Eigen::Array<T, Eigen::Dynamic, 1, Eigen::ColMajor, kBlocksPerChunk * kPairsPerBlock, 1>;
+
+  T* out = Y.MutableData<T>();
+  const int64_t size = Y.Shape().Size();
+  const int64_t num_blocks = (size + Uniform::kPerBlock - 1) / Uniform::kPerBlock;
+  const auto seeds = generator.NextPhiloxSeeds(static_cast<uint64_t>(num_blocks));
+  const T two_pi = static_cast<T>(2.0 * 3.14159265358979323846);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks),
+      TensorOpCost{0.0, static_cast<double>(Uniform::kPerBlock * sizeof(T)), kPhiloxBlockCost * 2},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        uint32_t block[4];
+        ChunkArray u1, u2;
+        for (int64_t chunk = first; chunk < last; chunk += kBlocksPerChunk) {
+          const int64_t chunk_blocks = std::min<int64_t>(kBlocksPerChunk, last - chunk);
+          const int64_t num_pairs = chunk_blocks * kPairsPerBlock;
+          u1.resize(num_pairs);
+          u2.resize(num_pairs);
+          for (int64_t b = 0; b < chunk_blocks; ++b) {
+            Philox4x32x10::Generate(seeds.first, seeds.second + chunk + b, 0, block);
+            for (int64_t k = 0; k < kPairsPerBlock; ++k) {
+              // in (0, 1] for the log
+              u1[b * kPairsPerBlock + k] = 1 - Uniform::Get(block, 2 * k);
+              u2[b * kPairsPerBlock + k] = Uniform::Get(block, 2 * k + 1);
+            }
+          }
+
+          const ChunkArray radius = (u1.log() * -2).sqrt() * static_cast<T>(scale);
+          const ChunkArray theta = u2 * two_pi;
+          u1 = radius * theta.cos() + static_cast<T>(mean);
+          u2 = radius * theta.sin() + static_cast<T>(mean);
+
+          int64_t i = chunk * Uniform::kPerBlock;
+          for (int64_t k = 0; k < num_pairs && i < size; ++k, i += 2) {
+            out[i] = u1[k];
+            if (i + 1 < size) {
+              out[i + 1] = u2[k];
+            }
+          }
+        }
+      });
+}
 
-static Status RandomNormalCompute(float mean, float scale, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
-static Status RandomUniformCompute(float high, float low, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
+static Status RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, concurrency::ThreadPool* tp,
+                                  TensorProto::DataType dtype, Tensor& Y);
+static Status RandomUniformCompute(float high, float low, PhiloxGenerator& generator, concurrency::ThreadPool* tp,
+                                   TensorProto::DataType dtype, Tensor& Y);
 
 static Status CreateOutputTensorFromTensorShape(OpKernelContext* ctx, const Tensor& X, Tensor** Y);
 static TensorProto::DataType InferDataType(const Tensor& tensor);
@@ -80,8 +181,7 @@ static TensorProto::DataType InferDataType(const Tensor& tensor);
 Status RandomNormal::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
+  auto status = RandomNormalCompute(mean_, scale_, generator_, ctx->GetOperatorThreadPool(), dtype_, Y);
 
   return status;
 }
@@ -89,8 +189,7 @@ Status RandomNormal::Compute(OpKernelContext* ctx) const {
 Status RandomUniform::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y);
+  auto status = RandomUniformCompute(low_, high_, generator_, ctx->GetOperatorThreadPool(), dtype_, Y);
 
   return status;
 }
@@ -111,8 +210,7 @@ Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y);
+  status = RandomNormalCompute(mean_, scale_, generator_, ctx->GetOperatorThreadPool(), dtype, *Y);
 
   return status;
 }
@@ -132,8 +230,8 @@ Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y);
+
+  status = RandomUniformCompute(low_, high_, generator_, ctx->GetOperatorThreadPool(), dtype, *Y);
 
   return status;
 }
@@ -154,57 +252,76 @@ static Status MultinomialCompute(OpKernelContext* ctx,
                                  const int64_t batch_size,
                                  const int64_t num_classes,
                                  const int64_t num_samples,
-                                 std::default_random_engine& generator,
+                                 PhiloxGenerator& generator,
                                  Tensor& Y) {
-  // implementation copied from Tensorflow with some changes such as using the std::uniform_real_distribution
-  // instead of the Philox RNG.
+  // implementation copied from Tensorflow with some changes such as drawing sample j of batch b from the values
+  // b * num_samples + j of the Philox stream, so the batches can be sampled in parallel.
   Eigen::array<int64_t, 2> X_dims = {{batch_size, num_classes}};
   ConstMatrix<float> logits = ConstMatrix<float>(X.template Data<float>(), X_dims);
 
   Eigen::array<int64_t, 2> Y_dims = {{batch_size, num_samples}};
   Matrix<OutputType> output = Matrix<OutputType>(Y.template MutableData<OutputType>(), Y_dims);
 
-  // BEGIN create temporary tensor
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-  auto cdf_data = static_cast<double*>(alloc->Alloc(SafeInt<size_t>(sizeof(double)) * num_classes));
-  BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(alloc));
-  Eigen::array<int64_t, 1> cdf_dims = {{num_classes}};
-  auto cdf = EigenVector<double>(cdf_data, cdf_dims);
-  // END create temporary tensor
-
-  std::uniform_real_distribution<double> dist(0.0, 1.0);  // TODO: should this be initialized per batch?
-
-  for (int64_t b = 0; b < batch_size; ++b) {
-    const float* logits_row = &(logits(b, 0));
-    // Takes an along-class maximum (for numerical stability).
-    float maxx = std::numeric_limits<float>::lowest();
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        maxx = std::max(maxx, logits_row[j]);
-      }
-    }
-    const auto max_logit = static_cast<double>(maxx);
-
-    // Precompute cumulative probability distribution across classes.
-    // Note: This isn't normalized.
-    cdf = (logits.chip<0>(b).cast<double>() - max_logit).exp();
-    double running_total = 0;
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        running_total += cdf(j);
-      }
-      cdf(j) = running_total;
-    }
-    // Generate each sample.
-    const double* cdf_begin = cdf.data();
-    const double* cdf_end = cdf.data() + num_classes;
-    for (int64_t j = 0; j < num_samples; ++j) {
-      const double to_find = dist(generator) * running_total;
-      auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
-      output(b, j) = static_cast<OutputType>(std::distance(cdf_begin, found_iter));
-    }
-  }
+
+  // a double takes half of a Philox block
+  const int64_t num_blocks = (batch_size * num_samples + 1) / 2;
+  const auto seeds = generator.NextPhiloxSeeds(static_cast<uint64_t>(num_blocks));
+
+  const double cost = static_cast<double>(num_classes) * 16.0 +
+                      static_cast<double>(num_samples) * (32.0 + std::log2(static_cast<double>(num_classes)));
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_size),
+      TensorOpCost{static_cast<double>(num_classes * sizeof(float)),
+                   static_cast<double>(num_samples * sizeof(OutputType)), cost},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // BEGIN create temporary tensor
+        auto cdf_data = static_cast<double*>(alloc->Alloc(SafeInt<size_t>(sizeof(double)) * num_classes));
+        BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(alloc));
+        Eigen::array<int64_t, 1> cdf_dims = {{num_classes}};
+        auto cdf = EigenVector<double>(cdf_data, cdf_dims);
+        // END create temporary tensor
+
+        for (int64_t b = first; b < last; ++b) {
+          const float* logits_row = &(logits(b, 0));
+          // Takes an along-class maximum (for numerical stability).
+          float maxx = std::numeric_limits<float>::lowest();
+          for (int64_t j = 0; j < num_classes; ++j) {
+            if (Eigen::numext::isfinite(logits_row[j])) {
+              maxx = std::max(maxx, logits_row[j]);
+            }
+          }
+          const auto max_logit = static_cast<double>(maxx);
+
+          // Precompute cumulative probability distribution across classes.
+          // Note: This isn't normalized.
+          cdf = (logits.chip<0>(b).cast<double>() - max_logit).exp();
+          double running_total = 0;
+          for (int64_t j = 0; j < num_classes; ++j) {
+            if (Eigen::numext::isfinite(logits_row[j])) {
+              running_total += cdf(j);
+            }
+            cdf(j) = running_total;
+          }
+          // Generate each sample.
+          const double* cdf_begin = cdf.data();
+          const double* cdf_end = cdf.data() + num_classes;
+          uint32_t block[4];
+          int64_t block_index = -1;
+          for (int64_t j = 0; j < num_samples; ++j) {
+            const int64_t sample = b * num_samples + j;
+            if (sample / 2 != block_index) {
+              block_index = sample / 2;
+              Philox4x32x10::Generate(seeds.first, seeds.second + block_index, 0, block);
+            }
+            const uint32_t* value = block + (sample % 2) * 2;
+            const double to_find = Philox4x32x10::ToDouble(value[0], value[1]) * running_total;
+            auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
+            output(b, j) = static_cast<OutputType>(std::distance(cdf_begin, found_iter));
+          }
+        }
+      });
 
   return Status::OK();
 }
@@ -236,7 +353,6 @@ Status Multinomial::Compute(OpKernelContext* ctx) const {
   Tensor* Y = ctx->Output(0, {batch_size, num_samples_});
 
   Status status = Status::OK();
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
   switch (output_dtype_) {
     case TensorProto::INT32: {
       status = MultinomialCompute<int32_t>(ctx, X, batch_size, num_classes, num_samples_, generator_, *Y);
@@ -273,20 +389,19 @@ static TensorProto::DataType InferDataType(const Tensor& tensor) {
 }
 
 static Status RandomNormalCompute(float mean, float scale,
-                                  std::default_random_engine& generator,
+                                  PhiloxGenerator& generator,
+                                  concurrency::ThreadPool* tp,
                                   TensorProto::DataType dtype, Tensor& Y) {
   switch (dtype) {
     case TensorProto::FLOAT: {
-      GenerateData<float, std::normal_distribution<float>>(
-          generator, std::normal_distribution<float>{mean, scale}, Y);
+      GenerateNormal<float>(mean, scale, generator, tp, Y);
       break;
     }
     case TensorProto::FLOAT16: {
       ORT_NOT_IMPLEMENTED("FLOAT16 is not supported");
     }
     case TensorProto::DOUBLE: {
-      GenerateData<double, std::normal_distribution<double>>(
-          generator, std::normal_distribution<double>{mean, scale}, Y);
+      GenerateNormal<double>(mean, scale, generator, tp, Y);
       break;
     }
     default:
@@ -297,21 +412,20 @@ static Status RandomNormalCompute(float mean, float scale,
 }
 
 static Status RandomUniformCompute(float low, float high,
-                                   std::default_random_engine& generator,
+                                   PhiloxGenerator& generator,
+                                   concurrency::ThreadPool* tp,
                                    TensorProto::DataType dtype,
                                    Tensor& Y) {
   switch (dtype) {
     case TensorProto::FLOAT: {
-      GenerateData<float, std::uniform_real_distribution<float>>(
-          generator, std::uniform_real_distribution<float>{low, high}, Y);
+      GenerateUniform<float>(low, high, generator, tp, Y);
       break;
     }
     case TensorProto::FLOAT16: {
       ORT_NOT_IMPLEMENTED("FLOAT16 is not supported");
     }
     case TensorProto::DOUBLE: {
-      GenerateData<double, std::uniform_real_distribution<double>>(
-          generator, std::uniform_real_distribution<double>{low, high}, Y);
+      GenerateUniform<double>(low, high, generator, tp, Y);
       break;
     }
     default:
@@ -321,13 +435,4 @@ static Status RandomUniformCompute(float low, float high,
   return Status::OK();
 }
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor) {
-  T* out = tensor.MutableData<T>();
-  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
-    *out = distribution(generator);
-    ++out;
-  }
-}
-
 }  // namespace onnxruntime
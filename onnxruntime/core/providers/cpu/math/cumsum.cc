@@ -2,8 +2,11 @@
 // Licensed under the MIT License.
 
 #include "cumsum.h"
+
+#include <algorithm>
+
 #include "core/providers/common.h"
-#include "core/providers/cpu/tensor/utils.h"
+#include "core/providers/cpu/math/prefix_sum.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
 
@@ -11,41 +14,46 @@ using namespace onnxruntime;
 
 namespace {
 // static section
-std::vector<int64_t> GetStarts(int64_t rank, int64_t axis, int64_t index) {
-  std::vector<int64_t> starts(rank, 0);
-  starts[axis] = index;
-  return starts;
-}
-template <typename T>
-void ZeroOutSliceAtIndex(Tensor& output, int64_t rank, int64_t axis, int64_t index,
-                         const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  T zero{};
-  auto output_starts(GetStarts(rank, axis, index));
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator) {
-    *output_iterator = zero;
-  }
-}
-template <typename T>
-void CopySlices(const Tensor& input, Tensor& output,
-                const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts,
-                const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator) {
-    *output_iterator = *input_iterator;
-  }
-}
+
+// Scans the axis of a {outer, dim, inner} input when inner is more than 1. Every step along the axis adds a row of
+// contiguous values, so the inner loops vectorize. The rows are split into ranges of columns between the threads.
 template <typename T>
-void SumSlices(const Tensor& input, Tensor& output,
-               const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts, const std::vector<int64_t>& previous_output_starts,
-               const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  SliceIterator<T> previous_output_iterator(output, previous_output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator, ++previous_output_iterator) {
-    *output_iterator = *input_iterator + *previous_output_iterator;
-  }
+void CumSumStrided(const T* input, T* output, int64_t outer, int64_t dim, int64_t inner,
+                   bool exclusive, bool reverse, concurrency::ThreadPool* tp) {
+  const std::ptrdiff_t step = reverse ? -inner : inner;
+  const int64_t first = reverse ? (dim - 1) * inner : 0;
+  const double bytes = static_cast<double>(dim * sizeof(T));
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, outer * inner, TensorOpCost{bytes, bytes, static_cast<double>(dim)},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t unit = begin; unit < end;) {
+          const int64_t o = unit / inner;
+          const int64_t c = unit % inner;
+          const int64_t columns = std::min<int64_t>(end - unit, inner - c);
+          const T* in = input + o * dim * inner + first + c;
+          T* out = output + o * dim * inner + first + c;
+
+          // If (exclusive == true) the first row is always 0, otherwise it is a copy of the input
+          if (exclusive) {
+            std::fill_n(out, columns, T{});
+          } else {
+            std::copy_n(in, columns, out);
+            in += step;
+          }
+
+          // Each output row is the sum of the corresponding input row and the previous output row
+          for (int64_t index = 1; index < dim; ++index, in += step, out += step) {
+            const T* previous = out;
+            T* current = out + step;
+            for (int64_t j = 0; j < columns; ++j) {
+              current[j] = previous[j] + in[j];
+            }
+          }
+
+          unit += columns;
+        }
+      });
 }
 }  // namespace
 
@@ -147,61 +155,32 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   int64_t axis = 0;
   ORT_THROW_IF_ERROR(cumsum_op::GetAxis(axis_tensor, rank, axis));
 
-  auto dim(output_tensor.Shape()[axis]);    // dimension size for the axis
-  TensorShape slice_shape(input->Shape());  // the shape of one slice of input/output for the given value of the axis
-  slice_shape[axis] = 1;
-  auto slice_size(slice_shape.Size());     // total number of elements in each slice
-  auto slice_dims(slice_shape.GetDims());  // dim array for the slice
-
-  std::vector<int64_t> steps(rank, 1);  // steps for the slice -- always set to 1
+  const int64_t dim = output_shape[axis];  // dimension size for the axis
+  const int64_t outer = output_shape.SizeToDimension(static_cast<size_t>(axis));
+  const int64_t inner = output_shape.SizeFromDimension(static_cast<size_t>(axis) + 1);
 
-  if (!reverse_) {
-    int64_t index(0);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      ++index;
-    }
-    {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, 0));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      ++index;
-    }
+  const T* input_data = input->template Data<T>();
+  T* output_data = output_tensor.template MutableData<T>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
 
-    for (; index < dim; ++index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index - 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index - 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
+  if (inner > 1) {
+    CumSumStrided(input_data, output_data, outer, dim, inner, exclusive_ != 0, reverse_ != 0, tp);
+  } else if (outer < concurrency::ThreadPool::DegreeOfParallelism(tp)) {
+    // too few rows to keep the threads busy, so each row is scanned in parallel
+    for (int64_t o = 0; o < outer; ++o) {
+      PrefixSum(input_data + o * dim, output_data + o * dim, dim, exclusive_ != 0, reverse_ != 0, tp);
     }
   } else {
-    //_reverse == true
-    int64_t index(dim - 1);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      --index;
-    }
-    {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, dim - 1));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      --index;
-    }
-
-    for (; index >= 0; --index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index + 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index + 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
+    const double bytes = static_cast<double>(dim * sizeof(T));
+    concurrency::ThreadPool::TryParallelFor(
+        tp, outer, TensorOpCost{bytes, bytes, static_cast<double>(dim)},
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t o = begin; o < end; ++o) {
+            const std::ptrdiff_t step = reverse_ ? -1 : 1;
+            const int64_t first = o * dim + (reverse_ ? dim - 1 : 0);
+            SerialPrefixSum(input_data + first, output_data + first, dim, step, exclusive_ != 0, T{});
+          }
+        });
   }
 
   return Status::OK();
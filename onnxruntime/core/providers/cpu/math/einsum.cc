@@ -59,6 +59,7 @@ Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const T
     auto einsum_compute_processor = EinsumTypedComputeProcessor<float>(context, allocator,
                                                                        tp,
                                                                        einsum_compute_preprocessor,
+                                                                       contraction_path_cache_,
                                                                        nullptr);
 
     // Set device specific methods (CPU methods) to be used during processing
@@ -72,6 +73,7 @@ Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const T
                                                                          allocator,
                                                                          tp,
                                                                          einsum_compute_preprocessor,
+                                                                         contraction_path_cache_,
                                                                          nullptr);
 
     // Set device specific methods (CPU methods) to be used during processing
@@ -86,6 +88,7 @@ Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const T
                                                                         allocator,
                                                                         tp,
                                                                         einsum_compute_preprocessor,
+                                                                        contraction_path_cache_,
                                                                         nullptr);
 
     // Set device specific methods (CPU methods) to be used during processing
@@ -99,6 +102,7 @@ Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const T
                                                                          allocator,
                                                                          tp,
                                                                          einsum_compute_preprocessor,
+                                                                         contraction_path_cache_,
                                                                          nullptr);
 
     einsum_compute_processor.SetDeviceHelpers(EinsumOp::DeviceHelpers::CpuDeviceHelpers::Transpose,
@@ -27,6 +27,9 @@ class Einsum : public OpKernel {
 
   std::string equation_;
   std::unique_ptr<EinsumEquationPreprocessor> einsum_equation_preprocessor_;
+
+  // Contraction paths found for the input shapes seen so far
+  mutable EinsumOp::ContractionPathCache contraction_path_cache_;
 };
 
 }  // namespace onnxruntime
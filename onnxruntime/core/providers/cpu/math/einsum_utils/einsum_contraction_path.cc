@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "einsum_contraction_path.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace onnxruntime {
+
+namespace EinsumOp {
+
+namespace {
+
+using OperandDims = std::vector<int64_t>;
+
+double Size(const OperandDims& dims) {
+  double size = 1;
+  for (auto dim : dims) {
+    size *= static_cast<double>(dim);
+  }
+  return size;
+}
+
+struct Contraction {
+  OperandDims result_dims;
+  double cost;
+};
+
+// Models EinsumTypedComputeProcessor's pair-wise processing of operands[left] and operands[right]:
+// the labels that only one of them has and that are not needed anymore are first reduced by a ReduceSum,
+// then the pair is multiplied by a MatMul that also reduces the labels they share and that are not needed anymore.
+// A label is still needed if it shows up in the output or in any of the other operands.
+Contraction Contract(const std::vector<OperandDims>& operands, size_t left, size_t right,
+                     const std::vector<bool>& label_in_output) {
+  const auto& left_dims = operands[left];
+  const auto& right_dims = operands[right];
+  const size_t num_labels = left_dims.size();
+
+  Contraction contraction{OperandDims(num_labels, 1), 0};
+  double matmul_cost = 1;
+  bool reduces_left = false;
+  bool reduces_right = false;
+
+  for (size_t label = 0; label < num_labels; ++label) {
+    bool needed = label_in_output[label];
+    for (size_t operand = 0, end = operands.size(); !needed && operand < end; ++operand) {
+      needed = operand != left && operand != right && operands[operand][label] > 1;
+    }
+
+    const bool has_left = left_dims[label] > 1;
+    const bool has_right = right_dims[label] > 1;
+    if (has_left && has_right) {
+      matmul_cost *= static_cast<double>(left_dims[label]);
+    } else if (has_left || has_right) {
+      if (!needed) {
+        reduces_left = reduces_left || has_left;
+        reduces_right = reduces_right || has_right;
+        continue;
+      }
+      matmul_cost *= static_cast<double>(has_left ? left_dims[label] : right_dims[label]);
+    }
+
+    if (needed) {
+      contraction.result_dims[label] = std::max(left_dims[label], right_dims[label]);
+    }
+  }
+
+  contraction.cost = matmul_cost + (reduces_left ? Size(left_dims) : 0) + (reduces_right ? Size(right_dims) : 0);
+  return contraction;
+}
+
+std::vector<OperandDims> ReplacePair(const std::vector<OperandDims>& operands, size_t left, size_t right,
+                                     OperandDims result_dims) {
+  std::vector<OperandDims> remaining;
+  remaining.reserve(operands.size() - 1);
+  for (size_t operand = 0, end = operands.size(); operand < end; ++operand) {
+    if (operand != left && operand != right) {
+      remaining.push_back(operands[operand]);
+    }
+  }
+  remaining.push_back(std::move(result_dims));
+  return remaining;
+}
+
+void SearchOptimalPath(const std::vector<OperandDims>& operands, const std::vector<bool>& label_in_output,
+                       double cost, ContractionPath& path, double& best_cost, ContractionPath& best_path) {
+  if (operands.size() == 1) {
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_path = path;
+    }
+    return;
+  }
+
+  for (size_t left = 0, end = operands.size(); left < end; ++left) {
+    for (size_t right = left + 1; right < end; ++right) {
+      auto contraction = Contract(operands, left, right, label_in_output);
+      // no need to go further down a path that already costs as much as the best one
+      if (cost + contraction.cost >= best_cost) {
+        continue;
+      }
+
+      path.emplace_back(left, right);
+      SearchOptimalPath(ReplacePair(operands, left, right, std::move(contraction.result_dims)), label_in_output,
+                        cost + contraction.cost, path, best_cost, best_path);
+      path.pop_back();
+    }
+  }
+}
+
+ContractionPath FindGreedyPath(std::vector<OperandDims> operands, const std::vector<bool>& label_in_output) {
+  ContractionPath path;
+  path.reserve(operands.size() - 1);
+
+  while (operands.size() > 1) {
+    size_t best_left = 0;
+    size_t best_right = 1;
+    Contraction best{};
+    double best_size_change = std::numeric_limits<double>::max();
+
+    for (size_t left = 0, end = operands.size(); left < end; ++left) {
+      for (size_t right = left + 1; right < end; ++right) {
+        auto contraction = Contract(operands, left, right, label_in_output);
+        const double size_change = Size(contraction.result_dims) - Size(operands[left]) - Size(operands[right]);
+        if (size_change < best_size_change || (size_change == best_size_change && contraction.cost < best.cost)) {
+          best_left = left;
+          best_right = right;
+          best_size_change = size_change;
+          best = std::move(contraction);
+        }
+      }
+    }
+
+    path.emplace_back(best_left, best_right);
+    operands = ReplacePair(operands, best_left, best_right, std::move(best.result_dims));
+  }
+
+  return path;
+}
+
+}  // namespace
+
+ContractionPath FindContractionPath(const std::vector<std::vector<int64_t>>& operand_dims,
+                                    const std::vector<bool>& label_in_output) {
+  if (operand_dims.size() < 2) {
+    return {};
+  }
+
+  if (operand_dims.size() == 2) {
+    return {{0, 1}};
+  }
+
+  if (operand_dims.size() > kMaxOperandsForOptimalContractionPath) {
+    return FindGreedyPath(operand_dims, label_in_output);
+  }
+
+  ContractionPath path;
+  ContractionPath best_path;
+  double best_cost = std::numeric_limits<double>::max();
+  SearchOptimalPath(operand_dims, label_in_output, 0, path, best_cost, best_path);
+  return best_path;
+}
+
+ContractionPath ContractionPathCache::Get(const std::vector<TensorShape>& operand_dims,
+                                          const std::vector<bool>& label_in_output) {
+  // the homogenized dims of all operands have the same rank, so concatenating them identifies the shapes
+  std::vector<int64_t> key;
+  std::vector<std::vector<int64_t>> dims;
+  dims.reserve(operand_dims.size());
+  for (const auto& shape : operand_dims) {
+    const auto& shape_dims = shape.GetDims();
+    key.insert(key.end(), shape_dims.begin(), shape_dims.end());
+    dims.push_back(shape_dims);
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = paths_.find(key);
+    if (it != paths_.end()) {
+      return it->second;
+    }
+  }
+
+  auto path = FindContractionPath(dims, label_in_output);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (paths_.size() < kMaxCachedPaths) {
+    paths_.emplace(std::move(key), path);
+  }
+  return path;
+}
+
+}  // namespace EinsumOp
+
+}  // namespace onnxruntime
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This module hosts the following abstractions -
+
+// 1) FindContractionPath - Picks the order in which the operands of an Einsum with 3 or more inputs are contracted
+// pair-wise, based on a cost model of the number of multiply-adds and the size of the intermediate results.
+
+// 2) ContractionPathCache - Caches the contraction paths per input shapes. Held by the Einsum kernel and hence
+// shared by the CPU and CUDA implementations.
+
+#pragma once
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+namespace EinsumOp {
+
+// Each step of a contraction path holds the positions of the 2 operands to contract in the list of operands.
+// As in opt_einsum, both operands are removed from the list and the result of their contraction is appended to it.
+using ContractionPath = std::vector<std::pair<size_t, size_t>>;
+
+// Paths are searched exhaustively up to this many operands, and greedily above it
+constexpr size_t kMaxOperandsForOptimalContractionPath = 5;
+
+// `operand_dims` holds the homogenized dims of each operand (one dim per subscript label, 1 if the operand doesn't
+// have that label) and `label_in_output` whether each subscript label shows up in the op's output.
+//
+// The optimal search returns the path with the fewest multiply-adds. The greedy search contracts the pair that
+// shrinks the total size of the operands the most at each step, and uses the multiply-adds to break ties.
+// When costs are equal the earliest pairs are preferred, so the path defaults to contracting left to right.
+ContractionPath FindContractionPath(const std::vector<std::vector<int64_t>>& operand_dims,
+                                    const std::vector<bool>& label_in_output);
+
+class ContractionPathCache {
+ public:
+  // Returns the cached path for the operand shapes, finding it on first use.
+  ContractionPath Get(const std::vector<TensorShape>& operand_dims, const std::vector<bool>& label_in_output);
+
+ private:
+  // bounds the cache for models whose input shapes keep changing. paths past the limit are found on every call.
+  static constexpr size_t kMaxCachedPaths = 64;
+
+  OrtMutex mutex_;
+  std::map<std::vector<int64_t>, ContractionPath> paths_;
+};
+
+}  // namespace EinsumOp
+
+}  // namespace onnxruntime
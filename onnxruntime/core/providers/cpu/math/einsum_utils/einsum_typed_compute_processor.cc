@@ -137,11 +137,14 @@ std::unique_ptr<Tensor> EinsumTypedComputeProcessor<T>::PairwiseOperandProcess(c
                     "Einsum op: Input dimensions must be equal along an axis to be reduced across all inputs");
         reduced_size *= left_dim;
       } else if (has_left_dim) {  // if it is only in one of left and right, we can reduce right away
+        // reduce the result of any previous reduction, as an operand may have several dims to reduce
         current_left = EinsumOp::ReduceSum<T>(
-            left, left_dims, {i}, allocator_, tp_, einsum_ep_assets_, device_reduce_sum_func_);
+            current_left ? *current_left : left, current_left ? current_left->Shape().GetDims() : left_dims, {i},
+            allocator_, tp_, einsum_ep_assets_, device_reduce_sum_func_);
       } else if (has_right_dim) {
         current_right = EinsumOp::ReduceSum<T>(
-            right, right_dims, {i}, allocator_, tp_, einsum_ep_assets_, device_reduce_sum_func_);
+            current_right ? *current_right : right, current_right ? current_right->Shape().GetDims() : right_dims, {i},
+            allocator_, tp_, einsum_ep_assets_, device_reduce_sum_func_);
       }
     } else {  // This dimension is not reduced (i.e.) it appears in the output after processing these 2 operands
       // Both the left and right operands have non-trivial dimension value along this axis
@@ -334,28 +337,66 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     }
   }
 
-  // Process the operands in a pair-wise fashion
+  // Process the operands in a pair-wise fashion, in the order given by the contraction path
   {
-    bool is_final_pair = false;
-    // Keep processing each input pair-wise
+    const auto& subscript_indices_to_output_indices =
+        einsum_compute_preprocessor_.GetMappedSubscriptIndicesToOutputindices();
+
+    std::vector<bool> label_in_output(num_subscript_labels);
+    for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
+      label_in_output[dim] = subscript_indices_to_output_indices[dim] != -1;
+    }
+
+    // The operands left to contract, with their homogenized dims.
+    // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
+    std::vector<std::unique_ptr<const Tensor>> owned_operands;
+    std::vector<const Tensor*> operands;
+    std::vector<TensorShape> operand_dims;
+    owned_operands.reserve(num_inputs);
+    operands.reserve(num_inputs);
+    operand_dims.reserve(num_inputs);
+
+    operands.push_back(result ? result.get() : raw_inputs[0]);
+    operand_dims.push_back(result ? result->Shape() : homogenized_input_dims[0]);
+    owned_operands.push_back(std::move(result));
     for (int input = 1; input < num_inputs; ++input) {
+      operands.push_back(preprocessed_inputs[input] ? preprocessed_inputs[input].get() : raw_inputs[input]);
+      operand_dims.push_back(homogenized_input_dims[input]);
+      owned_operands.emplace_back();
+    }
+
+    const auto contraction_path = contraction_path_cache_.Get(operand_dims, label_in_output);
+
+    for (size_t step = 0, num_steps = contraction_path.size(); step < num_steps; ++step) {
+      const size_t left = contraction_path[step].first;
+      const size_t right = contraction_path[step].second;
+
+      // Reduce along the dims that are not in the output and that no other operand has
       std::vector<int64_t> reduced_dims;
       reduced_dims.reserve(num_subscript_labels);  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
       for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[dim] == input) {
-          // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
+        bool needed = label_in_output[dim];
+        for (size_t operand = 0, end = operands.size(); !needed && operand < end; ++operand) {
+          needed = operand != left && operand != right && operand_dims[operand][dim] > 1;
+        }
+        if (!needed) {
           reduced_dims.push_back(dim);
         }
       }
-      if (input == num_inputs - 1) {
-        is_final_pair = true;
+
+      auto pair_result = PairwiseOperandProcess(*operands[left], operand_dims[left],
+                                                *operands[right], operand_dims[right],
+                                                reduced_dims, step == num_steps - 1);
+
+      // Replace the pair with its result (right > left, so erase right first)
+      for (size_t operand : {right, left}) {
+        owned_operands.erase(owned_operands.begin() + operand);
+        operands.erase(operands.begin() + operand);
+        operand_dims.erase(operand_dims.begin() + operand);
       }
-      // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
-                                      preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
-                                      homogenized_input_dims[input],
-                                      reduced_dims, is_final_pair);
+      operands.push_back(pair_result.get());
+      operand_dims.push_back(pair_result->Shape());
+      owned_operands.push_back(std::move(pair_result));
     }
   }
 
@@ -9,6 +9,7 @@
 
 #include "einsum_auxiliary_ops.h"
 #include "einsum_compute_preprocessor.h"
+#include "einsum_contraction_path.h"
 
 namespace onnxruntime {
 
@@ -19,11 +20,13 @@ class EinsumTypedComputeProcessor {
   explicit EinsumTypedComputeProcessor(OpKernelContext* context, AllocatorPtr allocator,
                                        concurrency::ThreadPool* tp,
                                        EinsumComputePreprocessor& einsum_compute_preprocessor,
+                                       EinsumOp::ContractionPathCache& contraction_path_cache,
                                        void* einsum_cuda_assets)
       : context_(context),
         allocator_(allocator),
         tp_(tp),
         einsum_compute_preprocessor_(einsum_compute_preprocessor),
+        contraction_path_cache_(contraction_path_cache),
         einsum_ep_assets_(einsum_cuda_assets) {}
 
   // Pass-in device specific functions
@@ -59,6 +62,8 @@ class EinsumTypedComputeProcessor {
   AllocatorPtr allocator_;
   concurrency::ThreadPool* tp_;
   EinsumComputePreprocessor& einsum_compute_preprocessor_;
+  // Holds the order in which operands are contracted when there are more than 2 of them
+  EinsumOp::ContractionPathCache& contraction_path_cache_;
 
   EinsumOp::DeviceHelpers::Transpose device_transpose_func_;
   EinsumOp::DeviceHelpers::MatMul<T> device_matmul_func_;
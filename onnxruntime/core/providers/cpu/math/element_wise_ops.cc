@@ -3,6 +3,7 @@
 
 #include "core/framework/data_types_internal.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/providers/cpu/tensor/tile.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include <unsupported/Eigen/SpecialFunctions>
 #include "core/util/math.h"
@@ -20,12 +21,15 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
 }
 }  // namespace functors
 
-#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      OP_TYPE,                                                                     \
-      VERSION,                                                                     \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+// the output only depends on the input values at the same position, so the first input can be updated in place.
+#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)   \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                            \
+      OP_TYPE,                                                               \
+      VERSION,                                                               \
+      TYPE,                                                                  \
+      KernelDefBuilder()                                                     \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>())          \
+          .MayInplace(0, 0),                                                 \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
@@ -43,7 +47,9 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
       OP_TYPE,                                                                                        \
       VERSION_FROM, VERSION_TO,                                                                       \
       TYPE,                                                                                           \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                    \
+      KernelDefBuilder()                                                                              \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>())                                   \
+          .MayInplace(0, 0),                                                                          \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
@@ -63,7 +69,8 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
       VERSION,                                                             \
       KernelDefBuilder()                                                   \
           .TypeConstraint("T", BuildKernelDefConstraints<__VA_ARGS__>())   \
-          .TypeConstraint("T1", BuildKernelDefConstraints<__VA_ARGS__>()), \
+          .TypeConstraint("T1", BuildKernelDefConstraints<__VA_ARGS__>())  \
+          .MayInplace(0, 0),                                               \
       KERNEL_CLASS);
 
 // var args are type constraints for T and T1
@@ -74,7 +81,8 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
       VERSION_TO,                                                                                   \
       KernelDefBuilder()                                                                            \
           .TypeConstraint("T", BuildKernelDefConstraints<__VA_ARGS__>())                            \
-          .TypeConstraint("T1", BuildKernelDefConstraints<__VA_ARGS__>()),                          \
+          .TypeConstraint("T1", BuildKernelDefConstraints<__VA_ARGS__>())                           \
+          .MayInplace(0, 0),                                                                        \
       KERNEL_CLASS);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, float, Add);
@@ -1194,28 +1202,10 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
-static void ExpandBroadcastLooper(BroadcastHelper& helper, const ProcessBroadcastSpanFuncs& functors) {
-  ORT_ENFORCE(!helper.HaveTwoTensorInputs(), "ExpandBroadcastLooper should only have a shape for the second input.");
-
-  if (helper.IsInput0Scalar()) {
-    while (helper.NeedMoreOutput()) {
-      functors.input0scalar(helper);
-      helper.Next();
-    }
-    /*
-  } else if (helper.IsInput0Scalar()) {
-    // not possible as we only have one tensor as input
-  */
-  } else {
-    while (helper.NeedMoreOutput()) {
-      functors.general(helper);
-      helper.Next();
-    }
-  }
-}
-
 // Split out the untyped processing from the type specific work to minimize binary size
-static void UntypedExpand(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs) {
+static Status UntypedExpand(OpKernelContext& context, size_t element_size) {
+  const auto& input_tensor = *context.Input<Tensor>(0);
+
   // Input 1 is a 1-dimensional tensor containing the dimension values to exapnd to
   const auto& shape_data_tensor = *context.Input<Tensor>(1);
   ORT_ENFORCE(shape_data_tensor.Shape().GetDims().size() == 1,
@@ -1225,29 +1215,36 @@ static void UntypedExpand(OpKernelContext& context, const ProcessBroadcastSpanFu
   const auto* p_dims = shape_data_tensor.Data<int64_t>();
   TensorShape shape(std::vector<int64_t>{p_dims, p_dims + shape_data_tensor.Shape().Size()});
 
-  InputBroadcaster input_broadcaster(*context.Input<Tensor>(0), shape);
-  OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(),
-                                       *context.Output(0, input_broadcaster.GetOutputShape()));
-  BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster);
+  // the broadcaster validates the shapes and computes the output shape
+  InputBroadcaster input_broadcaster(input_tensor, shape);
+  const TensorShape output_shape = input_broadcaster.GetOutputShape();
+  auto& output_tensor = *context.Output(0, output_shape);
+  if (output_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  // Expand is a Tile of the axes of size 1 of the input, once aligned to the output rank. Tiling copies the
+  // expanded blocks by doubling instead of writing the output one broadcast span at a time.
+  const auto& output_dims = output_shape.GetDims();
+  const auto& input_dims = input_tensor.Shape().GetDims();
+  const size_t rank = std::max<size_t>(output_dims.size(), 1);
+  std::vector<int64_t> aligned_input_dims(rank, 1);
+  std::copy(input_dims.cbegin(), input_dims.cend(), aligned_input_dims.end() - input_dims.size());
+
+  std::vector<int64_t> repeats(rank, 1);
+  for (size_t axis = 0; axis < output_dims.size(); ++axis) {
+    repeats[axis] = output_dims[axis] / aligned_input_dims[axis];
+  }
 
-  ExpandBroadcastLooper(broadcast_helper, funcs);
+  TileCoreForFixedSizeTypes(aligned_input_dims, reinterpret_cast<const uint8_t*>(input_tensor.DataRaw()),
+                            reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw()), repeats.data(),
+                            element_size);
+  return Status::OK();
 }
 
 template <typename T>
 Status Expand_8<T>::Compute(OpKernelContext* context) const {
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>().array() = per_iter_bh.ScalarInput0<T>();
-      },
-      [](BroadcastHelper&) {
-        ORT_THROW("Invalid usage. Input 1 is a shape with no data.");
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>();
-      }};
-
-  UntypedExpand(*context, funcs);
-  return Status::OK();
+  return UntypedExpand(*context, sizeof(T));
 }
 
 #define REG_EXPAND_KERNEL(TYPE)                                                    \
@@ -1531,6 +1528,13 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
 
   Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
 
+  ParallelBroadcastTwo(input_broadcaster, output_tensor, funcs, context.GetOperatorThreadPool(), unit_cost,
+                       user_data);
+}
+
+void ParallelBroadcastTwo(InputBroadcaster& input_broadcaster, Tensor& output_tensor,
+                          const ProcessBroadcastSpanFuncs& funcs, concurrency::ThreadPool* tp, double unit_cost,
+                          void* user_data) {
   size_t span_size = input_broadcaster.GetSpanSize();
   size_t output_size = output_tensor.Shape().Size();
 
@@ -1539,8 +1543,6 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
     return;
   }
 
-  concurrency::ThreadPool* tp = context.GetOperatorThreadPool();
-
   if (span_size == output_size) {  // Input data will be processed in a single span, so parallelize within the span
     OutputBroadcaster output_broadcaster(span_size, output_tensor);
     BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, user_data, tp, unit_cost);
@@ -1585,32 +1587,40 @@ static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
     return;
   }
 
+  // the output has the shape of all the inputs broadcast together. once an intermediate result has that shape the
+  // remaining inputs are combined into the output in place, as each output value only depends on the input values
+  // at the same position.
+  std::vector<int64_t> output_dims = input0.Shape().GetDims();
+  for (int i = 1; i < input_count; i++) {
+    output_dims = Broadcaster(output_dims, context.Input<Tensor>(i)->Shape().GetDims()).output_shape_;
+  }
+  Tensor& output = *context.Output(0, TensorShape(output_dims));
+
   TensorAllocator tensor_allocator(context);
+  concurrency::ThreadPool* tp = context.GetOperatorThreadPool();
   std::unique_ptr<Tensor> temp_input;
   std::unique_ptr<Tensor> temp_output;
+  const Tensor* p_input = &input0;
 
   // For more than 2 tensors, we combine the the current two inputs into a temporary tensor,
   // and combine the next input with that
   for (int i = 0; i < input_count - 1; i++) {
-    auto& tensor0 = temp_input ? *temp_input : input0;
     auto& tensor1 = *context.Input<Tensor>(i + 1);
 
-    InputBroadcaster input_broadcaster(tensor0, tensor1);
+    InputBroadcaster input_broadcaster(*p_input, tensor1);
 
-    // Create a temporary output for all but the last iteration, which goes to the real output
+    // Create a temporary output until the intermediate result has the shape of the real output
     Tensor* p_output = nullptr;
-    if (i == input_count - 2) {
-      p_output = context.Output(0, input_broadcaster.GetOutputShape());
+    if (input_broadcaster.GetOutputShape() == output.Shape()) {
+      p_output = &output;
     } else {
       temp_output = allocate_tensor(tensor_allocator, input_broadcaster.GetOutputShape());
       p_output = temp_output.get();
     }
 
-    OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(), *p_output);
-    BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster);
-
-    BroadcastLooper(broadcast_helper, funcs);
+    ParallelBroadcastTwo(input_broadcaster, *p_output, funcs, tp, 1.0);
 
+    p_input = p_output;
     temp_input = std::move(temp_output);
   }
 }
@@ -919,6 +919,13 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
 void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, double unit_cost,
                          void* user_data = nullptr);
 
+// Broadcast the two inputs of input_broadcaster into output with parallelization, within the span if the output
+// is a single span, or across spans otherwise. output must have the shape given by input_broadcaster.
+// unit_cost must be a valid cost value.
+void ParallelBroadcastTwo(InputBroadcaster& input_broadcaster, Tensor& output,
+                          const ProcessBroadcastSpanFuncs& funcs, concurrency::ThreadPool* tp, double unit_cost,
+                          void* user_data = nullptr);
+
 // Helper to provide the looping logic with optimization for parallelizing within a single span if the
 // TBroadcastHelper instance was setup to enable that.
 template <typename TBroadcastHelper>
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "core/providers/cpu/math/half_gemm.h"
 
 namespace onnxruntime {
 
@@ -28,10 +29,125 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
 
-// opset 13 Adds BFloat16 support but we are not supporting it yet
+// opset 13 Adds BFloat16 support
 ONNX_CPU_OPERATOR_KERNEL(
     Gemm,
     13,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    7,
+    8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    9,
+    10,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    11,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gemm,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gemm,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    Gemm<BFloat16>);
+
+template <>
+void GemmWithActivation<float>(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int64_t M, int64_t N, int64_t K,
+                               float alpha, const float* a_data, const float* b_data, float beta, float* y_data,
+                               const MLAS_ACTIVATION* activation, concurrency::ThreadPool* thread_pool) {
+  const size_t lda = static_cast<size_t>(trans_a == CblasNoTrans ? K : M);
+  const size_t ldb = static_cast<size_t>(trans_b == CblasNoTrans ? N : K);
+  MlasGemm(trans_a, trans_b, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha,
+           a_data, lda, b_data, ldb, beta, y_data, static_cast<size_t>(N), activation, nullptr, thread_pool);
+}
+
+template <typename T>
+static Status ComputeHalfGemm(OpKernelContext* context, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                              float alpha, float beta) {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* W = context->Input<Tensor>(1);
+  const auto* B = context->Input<Tensor>(2);
+  // Bias could be missing. Treat as scalar 0 if that is the case.
+  GemmHelper helper(X->Shape(), trans_a != CblasNoTrans, W->Shape(), trans_b != CblasNoTrans,
+                    B != nullptr ? B->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  int64_t M = helper.M();
+  int64_t N = helper.N();
+  int64_t K = helper.K();
+
+  auto Y = context->Output(0, {M, N});
+
+  // if input is empty tensor, return as nothing need to be calculated and we've set the shape for the output
+  if (M == 0 || N == 0)
+    return Status::OK();
+
+  T* y_data = Y->MutableData<T>();
+
+  // Broadcast the bias to the output, which MLAS then scales by beta and accumulates into
+  if (beta != 0 && B != nullptr) {
+    const T* b_data = B->Data<T>();
+    const TensorShape& b_shape = B->Shape();
+    if (b_shape.Size() == 1) {
+      // B is (), (1,) or (1, 1), set the scalar
+      std::fill_n(y_data, M * N, *b_data);
+    } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+      // B is (N,) or (1, N)
+      for (int64_t m = 0; m < M; ++m) {
+        std::copy_n(b_data, N, y_data + m * N);
+      }
+    } else if (b_shape[1] == 1) {
+      // B is (M, 1)
+      for (int64_t m = 0; m < M; ++m) {
+        std::fill_n(y_data + m * N, N, b_data[m]);
+      }
+    } else {
+      // B is (M, N), no broadcast needed.
+      std::copy_n(b_data, M * N, y_data);
+    }
+  } else {
+    beta = 0;
+  }
+
+  HalfGemm<T>(trans_a, trans_b, M, N, K, alpha, X->Data<T>(), W->Data<T>(), beta, y_data,
+              context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+template <>
+Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const {
+  return ComputeHalfGemm<MLFloat16>(context, trans_A_, trans_B_, alpha_, beta_);
+}
+
+template <>
+Status Gemm<BFloat16>::Compute(OpKernelContext* context) const {
+  return ComputeHalfGemm<BFloat16>(context, trans_A_, trans_B_, alpha_, beta_);
+}
+
 }  // namespace onnxruntime
@@ -9,9 +9,25 @@
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
+// Y = activation(alpha * A x B + beta * Y) with the activation applied by MLAS to each block of Y as it's computed.
+// Only float is supported.
+template <typename T>
+void GemmWithActivation(CBLAS_TRANSPOSE /*trans_a*/, CBLAS_TRANSPOSE /*trans_b*/, int64_t /*M*/, int64_t /*N*/,
+                        int64_t /*K*/, float /*alpha*/, const T* /*a_data*/, const T* /*b_data*/, float /*beta*/,
+                        T* /*y_data*/, const MLAS_ACTIVATION* /*activation*/,
+                        concurrency::ThreadPool* /*thread_pool*/) {
+  ORT_THROW("GemmWithActivation is only implemented for float");
+}
+
+template <>
+void GemmWithActivation<float>(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int64_t M, int64_t N, int64_t K,
+                               float alpha, const float* a_data, const float* b_data, float beta, float* y_data,
+                               const MLAS_ACTIVATION* activation, concurrency::ThreadPool* thread_pool);
+
 template <typename T>
 class Gemm : public OpKernel {
 private:
@@ -37,6 +53,8 @@ private:
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    mlas_activation_.ActivationKind = MlasIdentityActivation;
   }
 
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
@@ -46,7 +64,9 @@ private:
                           float beta,
                           const T* c_data, const TensorShape* c_shape,
                           T* y_data,
-                          concurrency::ThreadPool* thread_pool) {
+                          concurrency::ThreadPool* thread_pool,
+                          const MLAS_ACTIVATION* activation = nullptr,
+                          const T* sum_data = nullptr) {
     // if input is empty tensor, return directly as nothing need to be calculated.
     if (M == 0 || N == 0)
       return;
@@ -70,6 +90,24 @@ private:
       }
     }
 
+    // The (M, N) sum is added to the scaled bias, so it's accumulated into the product before the activation.
+    if (sum_data != nullptr) {
+      auto output_mat = EigenMatrixMapRowMajor<T>(y_data, M, N);
+      if (beta != 0 && c_data != nullptr) {
+        output_mat = output_mat * static_cast<T>(beta) + ConstEigenMatrixMapRowMajor<T>(sum_data, M, N);
+      } else {
+        output_mat = ConstEigenMatrixMapRowMajor<T>(sum_data, M, N);
+      }
+      c_data = sum_data;
+      beta = 1;
+    }
+
+    if (activation != nullptr) {
+      GemmWithActivation<T>(trans_a, trans_b, M, N, K, alpha, a_data, b_data, c_data != nullptr ? beta : 0, y_data,
+                            activation, thread_pool);
+      return;
+    }
+
     math::Gemm<T>(trans_a, trans_b,
                   M, N, K,
                   alpha,
@@ -108,12 +146,20 @@ private:
     const T* b_data = B != nullptr ? B->Data<T>() : nullptr;
     const TensorShape* b_shape = B != nullptr ? &B->Shape() : nullptr;
 
+    // the optional sum of FusedGemm is added to the output before the activation
+    const auto* Z = Node().InputDefs().size() > 3 ? context->Input<Tensor>(3) : nullptr;
+    if (Z != nullptr) {
+      ORT_RETURN_IF_NOT(Y->Shape() == Z->Shape(), "output and sum shape must match");
+    }
+
     T* y_data = Y->MutableData<T>();
 
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<T>(), W->Data<T>(), beta_,
                 b_data, b_shape,
                 y_data,
-                thread_pool);
+                thread_pool,
+                mlas_activation_.ActivationKind != MlasIdentityActivation ? &mlas_activation_ : nullptr,
+                Z != nullptr ? Z->Data<T>() : nullptr);
 
     if(activation_){
       std::unique_ptr<functors::ElementWiseRangedTransform<T>> f(activation_->Copy());
@@ -136,6 +182,15 @@ private:
  protected:
   // For fused gemm + activation  
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
+  // For fused gemm + an activation MLAS applies while the output is computed, set instead of activation_
+  MLAS_ACTIVATION mlas_activation_;
 };
 
+// MLFloat16 and BFloat16 are multiplied by MLAS with the products accumulated in float.
+template <>
+Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const;
+
+template <>
+Status Gemm<BFloat16>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
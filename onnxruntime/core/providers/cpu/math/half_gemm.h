@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/data_types.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+template <typename T>
+struct MlasHalfTypeOf;
+
+template <>
+struct MlasHalfTypeOf<MLFloat16> {
+  static constexpr MLAS_HALF_TYPE value = MlasHalfTypeFloat16;
+};
+
+template <>
+struct MlasHalfTypeOf<BFloat16> {
+  static constexpr MLAS_HALF_TYPE value = MlasHalfTypeBFloat16;
+};
+
+// Y = alpha * op(A) * op(B) + beta * Y for MLFloat16 or BFloat16 matrices, with the products accumulated in float.
+template <typename T>
+void HalfGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int64_t M, int64_t N, int64_t K, float alpha,
+              const T* a_data, const T* b_data, float beta, T* y_data, concurrency::ThreadPool* thread_pool) {
+  static_assert(sizeof(T) == sizeof(uint16_t), "half precision types are 16 bits");
+
+  const size_t lda = static_cast<size_t>(trans_a == CblasNoTrans ? K : M);
+  const size_t ldb = static_cast<size_t>(trans_b == CblasNoTrans ? N : K);
+
+  MlasHalfGemm(MlasHalfTypeOf<T>::value, trans_a, trans_b,
+               static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha,
+               reinterpret_cast<const uint16_t*>(a_data), lda,
+               reinterpret_cast<const uint16_t*>(b_data), ldb,
+               beta, reinterpret_cast<uint16_t*>(y_data), static_cast<size_t>(N), thread_pool);
+}
+
+}  // namespace onnxruntime
@@ -3,10 +3,15 @@
 
 #include "core/providers/cpu/math/matmul.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/math/half_gemm.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <limits>
+#include <sstream>
+
 namespace onnxruntime {
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -58,6 +63,14 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     13,
@@ -88,6 +101,20 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    MatMul<BFloat16>);
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -125,39 +152,169 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <typename T>
+static Status ComputeHalfMatMul(OpKernelContext* ctx) {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = a->Data<T>();
+  const auto* b_data = b->Data<T>();
+  auto* y_data = y->MutableData<T>();
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    HalfGemm<T>(CblasNoTrans, CblasNoTrans,
+                helper.M(),
+                helper.N(),
+                helper.K(),
+                1.0f,
+                a_data + helper.LeftOffsets()[i],
+                b_data + helper.RightOffsets()[i],
+                0.0f,
+                y_data + helper.OutputOffsets()[i],
+                thread_pool);
+  }
+
+  return Status::OK();
+}
+
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  return ComputeHalfMatMul<MLFloat16>(ctx);
+}
+
+template <>
+Status MatMul<BFloat16>::Compute(OpKernelContext* ctx) const {
+  return ComputeHalfMatMul<BFloat16>(ctx);
+}
+
+float MatMul<float>::GetSparseThreshold(const OpKernelInfo& info) {
+  const IExecutionProvider* provider = info.GetExecutionProvider();
+  if (provider != nullptr) {
+    const auto& options = provider->GetProviderOptions();
+    auto it = options.find(kCpuProviderOptionSparseMatMulThreshold);
+    if (it != options.end()) {
+      std::istringstream iss(it->second);
+      float threshold;
+      if ((iss >> threshold) && iss.eof()) {
+        return threshold;
+      }
+    }
+  }
+  return kDefaultSparseMatMulThreshold;
+}
+
+Status MatMul<float>::PackB(const Tensor& tensor, const AllocatorPtr& alloc, BufferUniquePtr& packed_b,
+                            size_t& packed_b_size, bool& is_sparse) {
+  // Only handle the common case of a 2D weight matrix. Additional matrices
+  // could be handled by stacking the packed buffers.
+  b_shape_ = tensor.Shape();
+  packed_b_size = 0;
+  is_sparse = false;
+  if (b_shape_.NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const bool trans_b = trans_b_attr_ && b_shape_.NumDimensions() != 1;
+  const size_t K = trans_b ? static_cast<size_t>(b_shape_[1])
+                           : static_cast<size_t>(b_shape_[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape_[0])
+                           : static_cast<size_t>(b_shape_[1]);
+  const size_t ldb = trans_b ? K : N;
+
+  // MlasSparseGemm doesn't transpose A
+  const size_t block_count = K * ((N + MLAS_SPARSE_GEMM_BLOCK_N - 1) / MLAS_SPARSE_GEMM_BLOCK_N);
+  if (!trans_a_attr_ && block_count > 0 && sparse_threshold_ <= 1.0f &&
+      K <= std::numeric_limits<uint32_t>::max()) {
+    const size_t non_zero_blocks = MlasSparseGemmCountBlocks(trans_b ? CblasTrans : CblasNoTrans, N, K,
+                                                             tensor.Data<float>(), ldb);
+    const double sparsity = 1.0 - static_cast<double>(non_zero_blocks) / static_cast<double>(block_count);
+    if (sparsity >= sparse_threshold_) {
+      packed_b_size = MlasSparseGemmPackBSize(N, K, non_zero_blocks);
+      auto* packed_b_data = alloc->Alloc(packed_b_size);
+      packed_b = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+      MlasSparseGemmPackB(trans_b ? CblasTrans : CblasNoTrans, N, K, tensor.Data<float>(), ldb, packed_b_data);
+      is_sparse = true;
+      return Status::OK();
+    }
+  }
+
+  packed_b_size = MlasGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                N,
+                K,
+                tensor.Data<float>(),
+                static_cast<int>(ldb),
+                packed_b_data);
+  return Status::OK();
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
   is_packed = false;
 
   // only pack Matrix B
   if (input_idx == 1) {
-    // Only handle the common case of a 2D weight matrix. Additional matrices
-    // could be handled by stacking the packed buffers.
-    b_shape_ = tensor.Shape();
-    if (b_shape_.NumDimensions() != 2) {
-      return Status::OK();
-    }
+    size_t packed_b_size;
+    ORT_RETURN_IF_ERROR(PackB(tensor, Info().GetAllocator(0, OrtMemTypeDefault), packed_b_, packed_b_size,
+                              packed_b_is_sparse_));
+    is_packed = packed_b_ != nullptr;
+    packed_b_bytes_ = is_packed ? packed_b_size : 0;
+  }
+  return Status::OK();
+}
 
-    const bool trans_b = trans_b_attr_ && b_shape_.NumDimensions() != 1;
-    const size_t K = trans_b ? static_cast<size_t>(b_shape_[1])
-                             : static_cast<size_t>(b_shape_[0]);
-    const size_t N = trans_b ? static_cast<size_t>(b_shape_[0])
-                             : static_cast<size_t>(b_shape_[1]);
+Status MatMul<float>::PrePackWithSharing(const Tensor& tensor, int input_idx, AllocatorPtr alloc, bool& is_packed,
+                                         PrePackedWeights& prepacked_weights) {
+  is_packed = false;
 
-    const size_t packed_b_size = MlasGemmPackBSize(N, K);
-    if (packed_b_size == 0) {
-      return Status::OK();
+  if (input_idx == 1) {
+    BufferUniquePtr packed_b;
+    size_t packed_b_size;
+    bool is_sparse;
+    ORT_RETURN_IF_ERROR(PackB(tensor, alloc, packed_b, packed_b_size, is_sparse));
+    if (is_sparse) {
+      // the format isn't recorded in the shared buffers, and the sparse ones are small, so the kernel keeps them
+      packed_b_ = std::move(packed_b);
+      packed_b_bytes_ = packed_b_size;
+      packed_b_is_sparse_ = true;
+      is_packed = true;
+    } else if (packed_b) {
+      prepacked_weights.buffers_.push_back(std::move(packed_b));
+      prepacked_weights.buffer_sizes_.push_back(packed_b_size);
+      is_packed = true;
     }
+  }
+  return Status::OK();
+}
+
+Status MatMul<float>::UseSharedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                const PrePackedWeights& prepacked_weights,
+                                                bool& used_shared_buffers) {
+  used_shared_buffers = false;
 
-    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
-    auto* packed_b_data = alloc->Alloc(packed_b_size);
-    packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
-    MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
-                  N,
-                  K,
-                  tensor.Data<float>(),
-                  static_cast<int>(trans_b ? K : N),
-                  packed_b_data);
-    is_packed = true;
+  if (input_idx == 1 && prepacked_weights.buffers_.size() == 1) {
+    b_shape_ = tensor.Shape();
+    // the container owns the buffer
+    packed_b_ = BufferUniquePtr(prepacked_weights.buffers_[0].get(), BufferDeleter(nullptr));
+    packed_b_bytes_ = 0;
+    packed_b_is_sparse_ = false;
+    used_shared_buffers = true;
   }
   return Status::OK();
 }
@@ -188,6 +345,20 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   // TODO: replace it with GemmBatch for performance, it's OK for now as GemmBatch unrolls as well
   size_t max_len = helper.OutputOffsets().size();
   for (size_t i = 0; i < max_len; i++) {
+    if (packed_b_is_sparse_) {
+      MlasSparseGemm(
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          alpha_attr_,
+          a_data + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          y_data + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          thread_pool);
+      continue;
+    }
     if (packed_b_) {
       MlasGemm(
           trans_a ? CblasTrans : CblasNoTrans,
@@ -22,15 +22,35 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transA", &trans_a_attr_, 0);
     info.GetAttrOrDefault<int64_t>("transB", &trans_b_attr_, 0);
     info.GetAttrOrDefault<float>("alpha", &alpha_attr_, 1.0);
+    sparse_threshold_ = GetSparseThreshold(info);
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
 
+  Status PrePackWithSharing(const Tensor& tensor, int input_idx, AllocatorPtr alloc, bool& is_packed,
+                            PrePackedWeights& prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(const Tensor& tensor, int input_idx, const PrePackedWeights& prepacked_weights,
+                                   bool& used_shared_buffers) override;
+
+  size_t PrePackedBytes() const override { return packed_b_bytes_; }
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  static float GetSparseThreshold(const OpKernelInfo& info);
+
+  // Sets b_shape_. packed_b is left empty if B is not packed. is_sparse is set if B is packed for MlasSparseGemm
+  // because the ratio of its zero blocks is at least sparse_threshold_.
+  Status PackB(const Tensor& tensor, const AllocatorPtr& alloc, BufferUniquePtr& packed_b, size_t& packed_b_size,
+               bool& is_sparse);
+
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
+  // size of packed_b_ if the kernel owns it
+  size_t packed_b_bytes_{0};
+  bool packed_b_is_sparse_{false};
+  float sparse_threshold_;
 
   // For FusedMatMul and TransposeMatMul contrib ops
   float alpha_attr_;
@@ -38,4 +58,11 @@ class MatMul<float> final : public OpKernel {
   int64_t trans_b_attr_;
 };
 
+// MLFloat16 and BFloat16 are multiplied by MLAS with the products accumulated in float.
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* context) const;
+
+template <>
+Status MatMul<BFloat16>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
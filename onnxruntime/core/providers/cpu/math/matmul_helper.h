@@ -128,7 +128,7 @@ class MatMulComputeHelper {
     }
 
     // assign shape
-    output_shape_ = TensorShape(output_dims);
+    output_shape_ = TensorShape(std::move(output_dims));
 
     // compute broadcast offsets
     ComputeBroadcastOffsets();
@@ -70,7 +70,7 @@ Status MatMulInteger::Compute(OpKernelContext* ctx) const {
                a_data + helper.LeftOffsets()[i],
                static_cast<size_t>(helper.K()),
                a_offset,
-               packed_b_.get(),
+               PackedB(helper.RightOffsets()[i]),
                b_offset,
                b_is_signed_,
                y_data + helper.OutputOffsets()[i],
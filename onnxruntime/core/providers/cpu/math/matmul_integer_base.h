@@ -4,6 +4,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/providers/common.h"
+#include "core/common/safeint.h"
 
 namespace onnxruntime {
 
@@ -16,39 +17,64 @@ class MatMulIntegerBase : public OpKernel {
     is_packed = false;
 
     // only pack Matrix B
-    if (input_idx == 1) {
-      // Only handle the common case of a 2D weight matrix. Additional matrices
-      // could be handled by stacking the packed buffers.
+    if (input_idx == GetBIdx()) {
+      // Stacked weight matrices are packed individually into a single buffer, one
+      // packed matrix every packed_b_stride_ bytes.
       b_shape_ = tensor.Shape();
-      if (b_shape_.NumDimensions() != 2) {
+      const size_t num_dims = b_shape_.NumDimensions();
+      if (num_dims < 2) {
         return Status::OK();
       }
 
-      const size_t K = static_cast<size_t>(b_shape_[0]);
-      const size_t N = static_cast<size_t>(b_shape_[1]);
+      const size_t K = static_cast<size_t>(b_shape_[num_dims - 2]);
+      const size_t N = static_cast<size_t>(b_shape_[num_dims - 1]);
+      const size_t batch_count = static_cast<size_t>(b_shape_.SizeToDimension(num_dims - 2));
+      if (K == 0 || N == 0 || batch_count == 0) {
+        return Status::OK();
+      }
 
       const auto* b_data = static_cast<const uint8_t*>(tensor.DataRaw());
       b_is_signed_ = tensor.IsDataType<int8_t>();
 
-      const size_t packed_b_size = MlasGemmPackBSize(N, K, b_is_signed_);
-      if (packed_b_size == 0) {
+      packed_b_stride_ = MlasGemmPackBSize(N, K, b_is_signed_);
+      if (packed_b_stride_ == 0) {
         return Status::OK();
       }
+      b_matrix_size_ = K * N;
 
       auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
-      auto* packed_b_data = alloc->Alloc(packed_b_size);
+      auto* packed_b_data = alloc->Alloc(SafeInt<size_t>(packed_b_stride_) * batch_count);
       packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
-      MlasGemmPackB(N, K, b_data, N, b_is_signed_, packed_b_data);
+      for (size_t batch = 0; batch < batch_count; batch++) {
+        MlasGemmPackB(N, K, b_data + batch * b_matrix_size_, N, b_is_signed_,
+                      static_cast<uint8_t*>(packed_b_data) + batch * packed_b_stride_);
+      }
       is_packed = true;
     }
     return Status::OK();
   }
+
+  size_t PrePackedBytes() const override {
+    const size_t num_dims = b_shape_.NumDimensions();
+    return packed_b_ ? packed_b_stride_ * static_cast<size_t>(b_shape_.SizeToDimension(num_dims - 2)) : 0;
+  }
 #endif
 
  protected:
+  // Index of the B matrix input of the operator.
+  virtual int GetBIdx() const { return 1; }
+
+  // Packed buffer for the B matrix starting at element <b_offset> of the original tensor, given as one of the
+  // MatMulComputeHelper::RightOffsets.
+  const void* PackedB(size_t b_offset) const {
+    return static_cast<const uint8_t*>(packed_b_.get()) + (b_offset / b_matrix_size_) * packed_b_stride_;
+  }
+
   bool b_is_signed_;
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
+  size_t packed_b_stride_{0};
+  size_t b_matrix_size_{0};
 };
 
 }  // namespace onnxruntime
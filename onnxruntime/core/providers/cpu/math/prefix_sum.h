@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+// Scans 'count' values that are 'step' apart, starting with 'carry'. output[i] is the sum of carry and the values
+// before input[i] for an exclusive scan, or up to and including input[i] otherwise.
+// input and output may be the same. Returns the sum of carry and all the values.
+template <typename T>
+T SerialPrefixSum(const T* input, T* output, int64_t count, std::ptrdiff_t step, bool exclusive, T carry) {
+  if (exclusive) {
+    for (int64_t i = 0; i < count; ++i, input += step, output += step) {
+      const T value = *input;
+      *output = carry;
+      carry += value;
+    }
+  } else {
+    for (int64_t i = 0; i < count; ++i, input += step, output += step) {
+      carry += *input;
+      *output = carry;
+    }
+  }
+
+  return carry;
+}
+
+// Prefix sum of 'count' contiguous values, from the last value to the first if 'reverse' is set.
+// Long inputs are scanned in parallel in three steps:
+//   1. every block of the input is scanned on its own,
+//   2. the totals of the blocks are scanned to find the value every block starts from,
+//   3. that value is added to the outputs of every block but the first.
+// Returns the sum of all the values.
+template <typename T>
+T PrefixSum(const T* input, T* output, int64_t count, bool exclusive, bool reverse, concurrency::ThreadPool* tp) {
+  const std::ptrdiff_t step = reverse ? -1 : 1;
+  if (reverse && count > 0) {
+    input += count - 1;
+    output += count - 1;
+  }
+
+  // the blocks are large enough for the extra pass over the output to pay off
+  constexpr int64_t kMinBlockSize = 32 * 1024;
+  const int64_t num_blocks = std::max<int64_t>(
+      1, std::min<int64_t>(concurrency::ThreadPool::DegreeOfParallelism(tp), count / kMinBlockSize));
+  if (num_blocks == 1) {
+    return SerialPrefixSum(input, output, count, step, exclusive, T{});
+  }
+
+  std::vector<T> block_offsets(static_cast<size_t>(num_blocks));
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    const auto work = concurrency::ThreadPool::PartitionWork(block, num_blocks, count);
+    block_offsets[block] = SerialPrefixSum(input + work.start * step, output + work.start * step,
+                                           work.end - work.start, step, exclusive, T{});
+  });
+
+  const T total = SerialPrefixSum(block_offsets.data(), block_offsets.data(), num_blocks, 1, true, T{});
+
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks - 1, [&](std::ptrdiff_t i) {
+    const std::ptrdiff_t block = i + 1;
+    const auto work = concurrency::ThreadPool::PartitionWork(block, num_blocks, count);
+    const T offset = block_offsets[block];
+    T* block_output = output + work.start * step;
+    for (std::ptrdiff_t j = 0, end = work.end - work.start; j < end; ++j) {
+      block_output[j * step] += offset;
+    }
+  });
+
+  return total;
+}
+
+}  // namespace onnxruntime
@@ -1,7 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/matmul_integer_base.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/common/safeint.h"
 #include "core/providers/common.h"
@@ -10,13 +10,26 @@
 #include "core/util/gemmlowp_common.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 
-class QLinearMatMul final : public OpKernel {
+class QLinearMatMul final : public MatMulIntegerBase {
  public:
-  QLinearMatMul(const OpKernelInfo& info) : OpKernel(info) {}
+  QLinearMatMul(const OpKernelInfo& info) : MatMulIntegerBase(info) {}
 
   Status Compute(OpKernelContext* context) const override;
+
+#if defined(MLAS_SUPPORTS_PACKED_GEMM_U8X8) && !defined(MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT)
+  // GEMMLOWP consumes the original B matrix, so leave it unpacked.
+  Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) override {
+    is_packed = false;
+    return Status::OK();
+  }
+#endif
+
+ protected:
+  int GetBIdx() const override { return 3; }
 };
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -30,26 +43,39 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
     QLinearMatMul);
 
+namespace {
+
+// The weight scale and zero point are either per tensor or per column of B.
+bool IsScalarOrColumnVector(const Tensor* tensor, int64_t column_count) {
+  const auto& shape = tensor->Shape();
+  return shape.NumDimensions() == 0 ||
+         (shape.NumDimensions() == 1 && (shape[0] == 1 || shape[0] == column_count));
+}
+
+}  // namespace
+
 Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
   const auto* a = ctx->Input<Tensor>(0);
-  const auto* b = ctx->Input<Tensor>(3);
+  const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(3);
 
   MatMulComputeHelper helper;
-  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), packed_b_ ? b_shape_ : b->Shape()));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
   // Bail out early if the output is going to be empty
   if (y->Shape().Size() == 0)
     return Status::OK();
 
+  const int64_t column_count = helper.N();
+
   // validate offsets
   const auto* a_offset = ctx->Input<Tensor>(2);
   const auto* b_offset = ctx->Input<Tensor>(5);
   const auto* y_offset = ctx->Input<Tensor>(7);
   ORT_ENFORCE(IsScalarOr1ElementVector(a_offset),
               "QLinearMatmul : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_offset),
-              "QLinearMatmul : weight zero point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOrColumnVector(b_offset, column_count),
+              "QLinearMatmul : weight zero point must be a scalar, 1D tensor of size 1, or 1D tensor of size N");
   ORT_ENFORCE(IsScalarOr1ElementVector(y_offset),
               "QLinearMatmul : result zero point must be a scalar or 1D tensor of size 1");
 
@@ -59,16 +85,31 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
   const auto* y_scale = ctx->Input<Tensor>(6);
   ORT_ENFORCE(IsScalarOr1ElementVector(a_scale),
               "QLinearMatmul : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale),
-              "QLinearMatmul : weight scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOrColumnVector(b_scale, column_count),
+              "QLinearMatmul : weight scale must be a scalar, 1D tensor of size 1, or 1D tensor of size N");
   ORT_ENFORCE(IsScalarOr1ElementVector(y_scale),
               "QLinearMatmul : result scale must be a scalar or 1D tensor of size 1");
 
+  const auto a_offset_value = *a_offset->template Data<uint8_t>();
+  const auto y_offset_value = *y_offset->template Data<uint8_t>();
+
+  const auto* b_offset_data = b_offset->template Data<uint8_t>();
+  const auto b_offset_value = b_offset_data[0];
+  const bool is_b_offset_uniform =
+      std::all_of(b_offset_data, b_offset_data + b_offset->Shape().Size(),
+                  [b_offset_value](uint8_t offset) { return offset == b_offset_value; });
+
   auto a_scale_data = *(a_scale->template Data<float>());
-  auto b_scale_data = *(b_scale->template Data<float>());
   auto y_scale_data = *(y_scale->template Data<float>());
 
-  const float real_multiplier = (a_scale_data * b_scale_data) / y_scale_data;
+  const int64_t b_scale_size = b_scale->Shape().Size();
+  const auto* b_scale_data = b_scale->template Data<float>();
+  std::vector<float> output_scales(static_cast<size_t>(b_scale_size));
+  for (int64_t i = 0; i < b_scale_size; i++) {
+    output_scales[i] = (a_scale_data * b_scale_data[i]) / y_scale_data;
+  }
+
+  const float real_multiplier = output_scales[0];
 
 #ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
   AllocatorPtr alloc;
@@ -77,7 +118,16 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
                                        static_cast<size_t>(helper.M()) * static_cast<size_t>(helper.N()));
   BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
   auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+  // A weight zero point that is shared by all of the columns is applied by the
+  // GEMM, otherwise the GEMM output is adjusted per column before requantizing.
+  const uint8_t gemm_b_offset = is_b_offset_uniform ? b_offset_value : 0;
 #else
+  if (!is_b_offset_uniform || output_scales.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "QLinearMatmul : per-column weight quantization is not supported on this platform");
+  }
+
   // Compute the fixed point multiplier and shift for requantizing with GEMMLOWP.
   int32_t integer_multiplier;
   int right_shift;
@@ -86,34 +136,75 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
 #ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
-    QGemm(static_cast<int>(helper.M()),
-          static_cast<int>(helper.N()),
-          static_cast<int>(helper.K()),
-          a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-          static_cast<int>(helper.K()),
-          *a_offset->template Data<uint8_t>(),
-          b->template Data<uint8_t>() + helper.RightOffsets()[i],
-          static_cast<int>(helper.N()),
-          *b_offset->template Data<uint8_t>(),
-          false,
-          gemm_output,
-          static_cast<int>(helper.N()),
-          ctx->GetOperatorThreadPool());
-
-    MlasRequantizeOutput(gemm_output,
-                         y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
-                         nullptr,
-                         static_cast<size_t>(helper.M()),
-                         static_cast<size_t>(helper.N()),
-                         real_multiplier,
-                         *y_offset->template Data<uint8_t>());
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+    if (packed_b_) {
+      MlasGemm(static_cast<size_t>(helper.M()),
+               static_cast<size_t>(helper.N()),
+               static_cast<size_t>(helper.K()),
+               a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+               static_cast<size_t>(helper.K()),
+               a_offset_value,
+               PackedB(helper.RightOffsets()[i]),
+               gemm_b_offset,
+               b_is_signed_,
+               gemm_output,
+               static_cast<size_t>(helper.N()),
+               ctx->GetOperatorThreadPool());
+    } else
+#endif
+    {
+      QGemm(static_cast<int>(helper.M()),
+            static_cast<int>(helper.N()),
+            static_cast<int>(helper.K()),
+            a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+            static_cast<int>(helper.K()),
+            a_offset_value,
+            b->template Data<uint8_t>() + helper.RightOffsets()[i],
+            static_cast<int>(helper.N()),
+            gemm_b_offset,
+            false,
+            gemm_output,
+            static_cast<int>(helper.N()),
+            ctx->GetOperatorThreadPool());
+    }
+
+    if (!is_b_offset_uniform) {
+      QGemmApplyColumnOffsets(static_cast<int>(helper.M()),
+                              static_cast<int>(helper.N()),
+                              static_cast<int>(helper.K()),
+                              a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                              static_cast<int>(helper.K()),
+                              a_offset_value,
+                              b_offset_data,
+                              false,
+                              gemm_output,
+                              static_cast<int>(helper.N()));
+    }
+
+    if (output_scales.size() == 1) {
+      MlasRequantizeOutput(gemm_output,
+                           y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                           nullptr,
+                           static_cast<size_t>(helper.M()),
+                           static_cast<size_t>(helper.N()),
+                           real_multiplier,
+                           y_offset_value);
+    } else {
+      MlasRequantizeOutputColumn(gemm_output,
+                                 y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                                 nullptr,
+                                 static_cast<size_t>(helper.M()),
+                                 static_cast<size_t>(helper.N()),
+                                 output_scales.data(),
+                                 y_offset_value);
+    }
 #else
     GemmlowpMultiplyu8u8_u8(a->template Data<uint8_t>() + helper.LeftOffsets()[i],
                             b->template Data<uint8_t>() + helper.RightOffsets()[i],
                             y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
-                            *a_offset->template Data<uint8_t>(),
-                            *b_offset->template Data<uint8_t>(),
-                            *y_offset->template Data<uint8_t>(),
+                            a_offset_value,
+                            b_offset_value,
+                            y_offset_value,
                             static_cast<int>(helper.M()),
                             static_cast<int>(helper.N()),
                             static_cast<int>(helper.K()),
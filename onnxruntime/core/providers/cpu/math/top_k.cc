@@ -25,6 +25,7 @@
 #include <queue>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 using namespace std;
 namespace onnxruntime {
@@ -140,6 +141,122 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// The axis is split across the thread pool when it has at least this many elements and there are fewer rows
+// than threads. Below this, the cost of merging the chunks outweighs the parallelism.
+static constexpr int64_t kMinAxisSizeToSplit = 16 * 1024;
+
+// Elements of a chunk are compared to the current k-th best value this many at a time, and only the blocks
+// that have a better value are inserted into the heap. The block comparison has no data dependent branches
+// so the compiler can vectorize it.
+static constexpr int64_t kFilterBlockSize = 16;
+
+// Selects the (up to) k best elements of input_data[start, end) into candidates, in no particular order, and
+// returns how many were selected. Uses the same heap as the priority queue path in FindTopKElements.
+template <class Comparator>
+static int64_t SelectChunkTopK(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                               int64_t start, int64_t end, const unsigned k, int64_t* candidates) {
+  const int64_t size = end - start;
+  if (size <= k) {
+    std::iota(candidates, candidates + size, start);
+    return size;
+  }
+
+  int64_t cur_idx = start;
+  for (int64_t l = 0; l < k; ++l, ++cur_idx) {
+    candidates[k - l - 1] = cur_idx;
+    HeapifyIthPosition(candidates, k - l - 1, k, comparer);
+  }
+
+  auto top = input_data[candidates[0]];
+  auto insert = [&](int64_t idx) {
+    // an equal value doesn't replace the top of the heap as its index is higher
+    if (comparer.CompareValueOnly(input_data[idx], top)) {
+      candidates[0] = idx;
+      HeapifyIthPosition(candidates, 0, k, comparer);
+      top = input_data[candidates[0]];
+    }
+  };
+
+  for (; cur_idx + kFilterBlockSize <= end; cur_idx += kFilterBlockSize) {
+    const auto* block = input_data + cur_idx;
+    bool any_better = false;
+    for (int64_t b = 0; b < kFilterBlockSize; ++b) {
+      any_better |= comparer.CompareValueOnly(block[b], top);
+    }
+
+    if (any_better) {
+      for (int64_t b = 0; b < kFilterBlockSize; ++b) {
+        insert(cur_idx + b);
+      }
+    }
+  }
+
+  for (; cur_idx < end; ++cur_idx) {
+    insert(cur_idx);
+  }
+
+  return k;
+}
+
+// Finds the top k elements of rows that are contiguous in memory (the axis is the innermost dimension) by splitting
+// each row into chunks processed by different threads. The top k of each chunk are selected with a heap and the
+// candidates of all the chunks of a row are then merged with nth_element.
+// This is exact as the comparer is a strict ordering of (value, index), so each of the top k of a row is in the
+// top k of its chunk.
+template <class Comparator>
+static void FindTopKElementsInChunks(const typename Comparator::DataType* input_data, int64_t rows, int64_t cols,
+                                     const unsigned k, bool sorted, int64_t tp_threads,
+                                     EigenMatrixMapRowMajor<typename Comparator::DataType>& values_map,
+                                     EigenMatrixMapRowMajor<int64_t>& indices_map,
+                                     concurrency::ThreadPool* threadpool) {
+  // each chunk should be large enough for the heap to filter most of its elements
+  const int64_t max_chunks_per_row = std::max(cols / std::max(static_cast<int64_t>(k) * 8, kMinAxisSizeToSplit / 4),
+                                              static_cast<int64_t>(1));
+  const int64_t chunks_per_row = std::min(std::max(tp_threads / rows, static_cast<int64_t>(1)), max_chunks_per_row);
+  const int64_t chunk_size = (cols + chunks_per_row - 1) / chunks_per_row;
+
+  std::vector<int64_t> candidates(rows * chunks_per_row * k);
+  std::vector<int64_t> num_candidates(rows * chunks_per_row);
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, rows * chunks_per_row,
+      [&](std::ptrdiff_t chunk) {
+        const int64_t row = chunk / chunks_per_row;
+        const int64_t start = row * cols + (chunk % chunks_per_row) * chunk_size;
+        const int64_t end = std::min(start + chunk_size, (row + 1) * cols);
+        Comparator comparer(input_data);
+        num_candidates[chunk] = SelectChunkTopK(comparer, input_data, start, std::max(start, end), k,
+                                                candidates.data() + chunk * k);
+      });
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, rows,
+      [&](std::ptrdiff_t row) {
+        Comparator comparer(input_data);
+
+        // gather the candidates of the row. the first chunk's are already in place
+        auto row_candidates = candidates.begin() + row * chunks_per_row * k;
+        auto row_end = row_candidates + num_candidates[row * chunks_per_row];
+        for (int64_t chunk = 1; chunk < chunks_per_row; ++chunk) {
+          auto chunk_candidates = row_candidates + chunk * k;
+          row_end = std::copy(chunk_candidates, chunk_candidates + num_candidates[row * chunks_per_row + chunk],
+                              row_end);
+        }
+
+        nth_element(row_candidates, row_candidates + (k - 1), row_end, comparer);
+        if (sorted) {
+          std::sort(row_candidates, row_candidates + k, comparer);
+        }
+
+        const int64_t row_offset = row * cols;
+        for (int64_t l = 0; l < k; ++l) {
+          const int64_t idx = row_candidates[l];
+          values_map(row, l) = input_data[idx];
+          indices_map(row, l) = idx - row_offset;
+        }
+      });
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -165,6 +282,14 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   const int64_t block_slice = reduced_cols / k;
 
   int64_t tp_threads = concurrency::ThreadPool::DegreeOfParallelism(threadpool);
+
+  // too few rows to keep the threads busy, so split the axis instead
+  if (block_slice == 1 && rows < tp_threads && num_blocks >= kMinAxisSizeToSplit) {
+    FindTopKElementsInChunks<Comparator>(input_data, rows, cols, k, sorted, tp_threads, values_map, indices_map,
+                                         threadpool);
+    return;
+  }
+
   int64_t num_threads = std::min(tp_threads, rows);  // split on rows so can't have more threads than rows
 
   // rough attempt to make sure there's enough work for each thread. if there's insufficient work the usage of
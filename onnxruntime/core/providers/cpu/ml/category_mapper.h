@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/ml/ml_common.h"
+#include "core/providers/cpu/ml/static_hash_map.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -22,27 +23,18 @@ class CategoryMapper final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_categories.size();
+    ORT_ENFORCE(string_categories.size() == int_categories.size());
 
-    ORT_ENFORCE(num_entries == int_categories.size());
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_categories[i];
-      int64_t index = int_categories[i];
-
-      string_to_int_map_[str] = index;
-      int_to_string_map_[index] = str;
-    }
+    const bool perfect_hash = UsePerfectHashTables(info);
+    string_to_int_map_.Build(string_categories, int_categories, perfect_hash);
+    int_to_string_map_.Build(int_categories, string_categories, perfect_hash);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  StaticHashMap<std::string, int64_t> string_to_int_map_;
+  StaticHashMap<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
   int64_t default_int_;
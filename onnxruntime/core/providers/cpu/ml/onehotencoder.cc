@@ -76,7 +76,7 @@ common::Status OneHotEncoderOp<T>::Compute(OpKernelContext* context) const {
   std::vector<int64_t> output_shape(input_shape.GetDims());
   output_shape.push_back(num_categories_);
 
-  Tensor* Y = context->Output(0, TensorShape(output_shape));
+  Tensor* Y = context->Output(0, output_shape);
   auto* y_data = Y->template MutableData<float>();
   std::fill_n(y_data, Y->Shape().Size(), 0.0f);
 
@@ -101,7 +101,7 @@ common::Status OneHotEncoderOp<std::string>::Compute(OpKernelContext* context) c
   std::vector<int64_t> output_shape(input_shape.GetDims());
   output_shape.push_back(num_categories_);
 
-  Tensor* Y = context->Output(0, TensorShape(output_shape));
+  Tensor* Y = context->Output(0, output_shape);
   auto* y_data = Y->template MutableData<float>();
   std::fill_n(y_data, Y->Shape().Size(), 0.0f);
 
@@ -0,0 +1,266 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+
+namespace onnxruntime {
+namespace ml {
+
+namespace detail {
+
+// Hashes a key with MurmurHash3. Floating point zeros are hashed as +0 so that -0 finds the entry of 0 like it
+// equals it, and NaN keys hash like any other value but never compare equal, so they are never found.
+template <typename T>
+inline void HashKey(const T& key, uint32_t seed, uint32_t out[4]) {
+  static_assert(std::is_arithmetic<T>::value, "keys are strings or arithmetic types");
+  T value = key;
+  if (std::is_floating_point<T>::value && value == 0) {
+    value = 0;
+  }
+  MurmurHash3::x86_128(&value, static_cast<int>(sizeof(T)), seed, out);
+}
+
+inline void HashKey(const std::string& key, uint32_t seed, uint32_t out[4]) {
+  MurmurHash3::x86_128(key.data(), static_cast<int>(key.size()), seed, out);
+}
+
+}  // namespace detail
+
+// An immutable map built once from the keys and values of a kernel's attributes, e.g. the vocabulary of a
+// LabelEncoder. The entries are stored in flat arrays, and the lookups probe a table of 32-bit hashes next to
+// entry indexes, so that keys, and strings in particular, are only compared when their hashes match.
+//
+// By default the table uses open addressing with linear probing at a load factor of at most 1/2. With
+// perfect_hash set, it is a minimal perfect hash built by hash and displace: the keys are split into buckets of
+// about 4 keys, and each bucket gets a displacement that moves its keys to free slots of a table as large as the
+// number of keys. A lookup then reads a single slot, and the table takes no more memory than the entries.
+//
+// When a key appears more than once, the value of its last occurrence is kept, like assigning the entries to a
+// std::unordered_map in order.
+template <typename TKey, typename TValue>
+class StaticHashMap {
+ public:
+  StaticHashMap() = default;
+
+  void Build(const std::vector<TKey>& keys, const std::vector<TValue>& values, bool perfect_hash = false) {
+    ORT_ENFORCE(keys.size() == values.size(), "The number of keys and values of a map must be equal.");
+    ORT_ENFORCE(keys.size() < static_cast<size_t>(kEmpty), "Too many entries for a map: ", keys.size());
+
+    BuildOpenAddressing(keys, values);
+
+    perfect_hash_ = false;
+    if (perfect_hash && !keys_.empty()) {
+      perfect_hash_ = BuildPerfectHash();
+      if (!perfect_hash_) {
+        // the displacement search failed for a bucket, which is very unlikely; keep the open addressing table
+        BuildOpenAddressing(std::vector<TKey>(keys_), std::vector<TValue>(values_));
+      }
+    }
+  }
+
+  // Returns the value of key, or nullptr if the map has no entry for it.
+  const TValue* Find(const TKey& key) const {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+
+    uint32_t hash[4];
+    detail::HashKey(key, kSeed, hash);
+
+    if (perfect_hash_) {
+      const uint32_t n = static_cast<uint32_t>(slots_.size());
+      const uint32_t displacement = displacements_[hash[0] % displacements_.size()];
+      const Slot& slot = slots_[PerfectHashSlot(hash, displacement, n)];
+      return slot.hash == hash[3] && keys_[slot.entry] == key ? &values_[slot.entry] : nullptr;
+    }
+
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = hash[3] & mask;; i = (i + 1) & mask) {
+      const Slot& slot = slots_[i];
+      if (slot.entry == kEmpty) {
+        return nullptr;
+      }
+      if (slot.hash == hash[3] && keys_[slot.entry] == key) {
+        return &values_[slot.entry];
+      }
+    }
+  }
+
+  size_t Size() const { return keys_.size(); }
+
+  bool IsPerfectHash() const { return perfect_hash_; }
+
+ private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t kSeed = 0x9747b28c;
+  // Average number of keys of the buckets of the perfect hash.
+  static constexpr size_t kKeysPerBucket = 4;
+
+  struct Slot {
+    uint32_t hash = 0;
+    uint32_t entry = kEmpty;
+  };
+
+  // Returns the slot of a key for a displacement d: the d-th of the (d0, d1) pairs moves the position of the key
+  // by d0 times its second hash plus d1, so that keys of a bucket that collide for one displacement don't collide
+  // for all of them.
+  static uint32_t PerfectHashSlot(const uint32_t hash[4], uint32_t d, uint32_t n) {
+    const uint64_t d0 = d / n;
+    const uint64_t d1 = d % n;
+    return static_cast<uint32_t>((hash[1] + d0 * hash[2] + d1) % n);
+  }
+
+  // Builds the open addressing table from the keys and values, dropping the entries of repeated keys.
+  void BuildOpenAddressing(const std::vector<TKey>& keys, const std::vector<TValue>& values) {
+    keys_.clear();
+    values_.clear();
+    keys_.reserve(keys.size());
+    values_.reserve(keys.size());
+    size_t capacity = 1;
+    while (capacity < 2 * keys.size()) {
+      capacity *= 2;
+    }
+    slots_.assign(keys.empty() ? 0 : capacity, Slot{});
+    displacements_.clear();
+
+    const size_t mask = capacity - 1;
+    for (size_t k = 0; k < keys.size(); ++k) {
+      uint32_t hash[4];
+      detail::HashKey(keys[k], kSeed, hash);
+      for (size_t i = hash[3] & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots_[i];
+        if (slot.entry == kEmpty) {
+          slot.hash = hash[3];
+          slot.entry = static_cast<uint32_t>(keys_.size());
+          keys_.push_back(keys[k]);
+          values_.push_back(values[k]);
+          break;
+        }
+        if (slot.hash == hash[3] && keys_[slot.entry] == keys[k]) {
+          values_[slot.entry] = values[k];
+          break;
+        }
+      }
+    }
+  }
+
+  // Replaces the open addressing table with a minimal perfect hash of the distinct keys of keys_.
+  // Returns false if no displacement places the keys of some bucket.
+  bool BuildPerfectHash() {
+    const size_t n = keys_.size();
+    const size_t num_buckets = (n + kKeysPerBucket - 1) / kKeysPerBucket;
+
+    std::vector<std::array<uint32_t, 4>> hashes(n);
+    std::vector<std::vector<uint32_t>> buckets(num_buckets);
+    for (size_t k = 0; k < n; ++k) {
+      detail::HashKey(keys_[k], kSeed, hashes[k].data());
+      buckets[hashes[k][0] % num_buckets].push_back(static_cast<uint32_t>(k));
+    }
+
+    // place the largest buckets first, while most slots are free
+    std::vector<uint32_t> order(num_buckets);
+    for (size_t b = 0; b < num_buckets; ++b) {
+      order[b] = static_cast<uint32_t>(b);
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<Slot> slots(n);
+    std::vector<uint32_t> displacements(num_buckets, 0);
+    std::vector<uint32_t> positions;
+    const uint32_t n32 = static_cast<uint32_t>(n);
+    // every free slot is tried with d0 = 0, so this only fails for buckets with keys whose hashes all collide
+    const uint64_t max_displacement = std::min<uint64_t>(static_cast<uint64_t>(n) * 64, kEmpty);
+
+    for (uint32_t b : order) {
+      const auto& bucket = buckets[b];
+      if (bucket.empty()) {
+        break;
+      }
+      bool placed = false;
+      for (uint64_t d = 0; d < max_displacement && !placed; ++d) {
+        positions.clear();
+        placed = true;
+        for (uint32_t k : bucket) {
+          uint32_t pos = PerfectHashSlot(hashes[k].data(), static_cast<uint32_t>(d), n32);
+          if (slots[pos].entry != kEmpty || std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+            placed = false;
+            break;
+          }
+          positions.push_back(pos);
+        }
+        if (placed) {
+          displacements[b] = static_cast<uint32_t>(d);
+          for (size_t i = 0; i < bucket.size(); ++i) {
+            slots[positions[i]].hash = hashes[bucket[i]][3];
+            slots[positions[i]].entry = bucket[i];
+          }
+        }
+      }
+      if (!placed) {
+        return false;
+      }
+    }
+
+    slots_ = std::move(slots);
+    displacements_ = std::move(displacements);
+    return true;
+  }
+
+  std::vector<TKey> keys_;
+  std::vector<TValue> values_;
+  std::vector<Slot> slots_;
+  // displacement of each bucket if the table is a perfect hash
+  std::vector<uint32_t> displacements_;
+  bool perfect_hash_ = false;
+};
+
+// Returns true if the execution provider of the kernel asks for minimal perfect hash tables.
+inline bool UsePerfectHashTables(const OpKernelInfo& info) {
+  const IExecutionProvider* provider = info.GetExecutionProvider();
+  if (provider == nullptr) {
+    return false;
+  }
+  const auto& options = provider->GetProviderOptions();
+  auto it = options.find(kCpuProviderOptionMlPerfectHashTables);
+  return it != options.end() && it->second == "1";
+}
+
+// Writes the value of each input key in the map to the output, or default_value for the keys it doesn't contain.
+// The lookups are split between the threads of the pool.
+template <typename TKey, typename TValue>
+void MapKeys(concurrency::ThreadPool* thread_pool, const StaticHashMap<TKey, TValue>& map,
+             gsl::span<const TKey> input, gsl::span<TValue> output, const TValue& default_value) {
+  // hashing and comparing strings and copying string values costs more than a few cycles
+  const double compute_cycles = (std::is_same<TKey, std::string>::value ? 64.0 : 16.0) +
+                                (std::is_same<TValue, std::string>::value ? 64.0 : 0.0);
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(input.size()),
+      TensorOpCost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)), compute_cycles},
+      [&map, &input, &output, &default_value](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const TValue* value = map.Find(input[i]);
+          output[i] = value == nullptr ? default_value : *value;
+        }
+      });
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
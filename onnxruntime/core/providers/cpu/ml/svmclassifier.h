@@ -38,61 +38,68 @@ class SVMCommon {
                           concurrency::ThreadPool* threadpool) const {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
-    if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
+    float alpha = 1.f;
+    float beta = 1.f;
+    static const TensorShape shape_C({1});
+    float c = scalar_C;  // scalar_C is used for LINEAR in the GEMM
 
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
+    if (kernel_type_ == KERNEL::RBF) {
+      // ||a - b||^2 = ||a||^2 + ||b||^2 - 2ab, so the cross term of every batch and support vector comes from the
+      // GEMM and the squared norms are added to it below
+      alpha = -2.f;
+      c = 0.f;
+    } else if (kernel_type_ != KERNEL::LINEAR) {
+      // kernel_type_ == POLY or SIGMOID
+      alpha = gamma_;
+      c = coef0_;
+    }
 
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
+    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                      m, n, k,
+                                      alpha, a.data(), b.data(), beta,
+                                      c != 0.f ? &c : nullptr, &shape_C,
+                                      out.data(),
+                                      threadpool);
 
-        cur_batch += k;  // move to start of next batch
-      }
-    } else {
-      float alpha = 1.f;
-      float beta = 1.f;
-      static const TensorShape shape_C({1});
-      float c = scalar_C;  // scalar_C is used for LINEAR in the GEMM
-
-      if (kernel_type_ != KERNEL::LINEAR) {
-        // kernel_type_ == POLY or SIGMOID
-        alpha = gamma_;
-        c = coef0_;
-      }
+    if (kernel_type_ == KERNEL::LINEAR) {
+      return;
+    }
 
-      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        m, n, k,
-                                        alpha, a.data(), b.data(), beta,
-                                        c != 0.f ? &c : nullptr, &shape_C,
-                                        out.data(),
-                                        threadpool);
-
-      if (kernel_type_ == KERNEL::POLY) {
-        auto map_out = EigenVectorArrayMap<T>(out.data(), out.size());
-        if (degree_ == 2)
-          map_out = map_out.square();
-        else if (degree_ == 3)
-          map_out = map_out.cube();
-        else
-          map_out = map_out.pow(degree_);
-
-      } else if (kernel_type_ == KERNEL::SIGMOID) {
-        MlasComputeTanh(out.data(), out.data(), out.size());
+    std::vector<T> b_squared_norms;
+    if (kernel_type_ == KERNEL::RBF) {
+      b_squared_norms.resize(static_cast<size_t>(n));
+      for (int64_t i = 0; i < n; ++i) {
+        b_squared_norms[i] = ConstEigenVectorMap<T>(b.data() + i * k, k).squaredNorm();
       }
     }
+
+    // apply the kernel to each batch while its output row is in cache
+    const double row_bytes = static_cast<double>(n * sizeof(T));
+    concurrency::ThreadPool::TryParallelFor(
+        threadpool, m, TensorOpCost{row_bytes, row_bytes, static_cast<double>(n * 4)},
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t batch = begin; batch < end; ++batch) {
+            T* row = out.data() + batch * n;
+            if (kernel_type_ == KERNEL::RBF) {
+              const T a_squared_norm = ConstEigenVectorMap<T>(a.data() + batch * k, k).squaredNorm();
+              for (int64_t i = 0; i < n; ++i) {
+                // the GEMM can leave a tiny negative distance for a batch that matches a support vector
+                row[i] = -gamma_ * std::max(row[i] + a_squared_norm + b_squared_norms[i], static_cast<T>(0));
+              }
+              MlasComputeExp(row, row, static_cast<size_t>(n));
+            } else if (kernel_type_ == KERNEL::POLY) {
+              auto map_out = EigenVectorArrayMap<T>(row, n);
+              if (degree_ == 2)
+                map_out = map_out.square();
+              else if (degree_ == 3)
+                map_out = map_out.cube();
+              else
+                map_out = map_out.pow(degree_);
+            } else if (kernel_type_ == KERNEL::SIGMOID) {
+              MlasComputeTanh(row, row, static_cast<size_t>(n));
+            }
+          }
+        });
   }
 
  private:
@@ -62,6 +62,20 @@ struct TreeNodeElement {
   bool is_missing_track_true;
 };
 
+// The nodes of all the trees as a structure of arrays, with the nodes of a tree stored contiguously
+// in depth-first order. A leaf has feature 0 and points to itself so it can be evaluated like any other node.
+template <typename T>
+struct TreeNodeArrays {
+  std::vector<int32_t> feature_ids;
+  std::vector<T> thresholds;
+  std::vector<int32_t> truenode_ids;
+  std::vector<int32_t> falsenode_ids;
+  std::vector<int32_t> missing_tracks_true;   // all bits set if a missing value goes to the true node, 0 if not
+  std::vector<TreeNodeElement<T>*> elements;  // the node each index was built from
+  std::vector<int32_t> roots;
+  std::vector<int32_t> depths;
+};
+
 template <typename ITYPE, typename OTYPE>
 class TreeAggregator {
  protected:
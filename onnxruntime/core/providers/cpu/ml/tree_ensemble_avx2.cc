@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "tree_ensemble_avx2.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+#ifdef __AVX2__
+
+bool TreeEnsembleHasAvx2Kernel() {
+  return true;
+}
+
+template <int Predicate>
+static int64_t FindLeavesAvx2(const int32_t* feature_ids,
+                              const float* thresholds,
+                              const int32_t* truenode_ids,
+                              const int32_t* falsenode_ids,
+                              const int32_t* missing_tracks_true,
+                              int32_t root,
+                              const float* x_data,
+                              int64_t stride,
+                              int64_t n_rows,
+                              int32_t* leaves) {
+  const __m256i row_offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                 _mm256_set1_epi32(static_cast<int32_t>(stride)));
+  int64_t row = 0;
+  for (; row + 8 <= n_rows; row += 8) {
+    const float* x = x_data + row * stride;
+    __m256i node = _mm256_set1_epi32(root);
+    for (;;) {
+      const __m256i feature = _mm256_i32gather_epi32(feature_ids, node, 4);
+      const __m256 threshold = _mm256_i32gather_ps(thresholds, node, 4);
+      const __m256 val = _mm256_i32gather_ps(x, _mm256_add_epi32(row_offsets, feature), 4);
+      __m256 cond = _mm256_cmp_ps(val, threshold, Predicate);
+      if (missing_tracks_true != nullptr) {
+        const __m256 missing = _mm256_castsi256_ps(_mm256_i32gather_epi32(missing_tracks_true, node, 4));
+        cond = _mm256_or_ps(cond, _mm256_and_ps(missing, _mm256_cmp_ps(val, val, _CMP_UNORD_Q)));
+      }
+
+      const __m256i truenode = _mm256_i32gather_epi32(truenode_ids, node, 4);
+      const __m256i falsenode = _mm256_i32gather_epi32(falsenode_ids, node, 4);
+      const __m256i next = _mm256_castps_si256(
+          _mm256_blendv_ps(_mm256_castsi256_ps(falsenode), _mm256_castsi256_ps(truenode), cond));
+
+      // every row has reached its leaf once no node changes
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(next, node)) == -1) {
+        break;
+      }
+      node = next;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(leaves + row), node);
+  }
+  return row;
+}
+
+int64_t TreeEnsembleFindLeavesAvx2(TreeNodeCompare compare,
+                                   const int32_t* feature_ids,
+                                   const float* thresholds,
+                                   const int32_t* truenode_ids,
+                                   const int32_t* falsenode_ids,
+                                   const int32_t* missing_tracks_true,
+                                   int32_t root,
+                                   const float* x_data,
+                                   int64_t stride,
+                                   int64_t n_rows,
+                                   int32_t* leaves) {
+  // the predicates match the scalar comparisons with NaN, which is only true for !=
+  switch (compare) {
+    case TreeNodeCompare::kLeq:
+      return FindLeavesAvx2<_CMP_LE_OQ>(feature_ids, thresholds, truenode_ids, falsenode_ids, missing_tracks_true,
+                                        root, x_data, stride, n_rows, leaves);
+    case TreeNodeCompare::kLt:
+      return FindLeavesAvx2<_CMP_LT_OQ>(feature_ids, thresholds, truenode_ids, falsenode_ids, missing_tracks_true,
+                                        root, x_data, stride, n_rows, leaves);
+    case TreeNodeCompare::kGte:
+      return FindLeavesAvx2<_CMP_GE_OQ>(feature_ids, thresholds, truenode_ids, falsenode_ids, missing_tracks_true,
+                                        root, x_data, stride, n_rows, leaves);
+    case TreeNodeCompare::kGt:
+      return FindLeavesAvx2<_CMP_GT_OQ>(feature_ids, thresholds, truenode_ids, falsenode_ids, missing_tracks_true,
+                                        root, x_data, stride, n_rows, leaves);
+    case TreeNodeCompare::kEq:
+      return FindLeavesAvx2<_CMP_EQ_OQ>(feature_ids, thresholds, truenode_ids, falsenode_ids, missing_tracks_true,
+                                        root, x_data, stride, n_rows, leaves);
+    case TreeNodeCompare::kNeq:
+      return FindLeavesAvx2<_CMP_NEQ_UQ>(feature_ids, thresholds, truenode_ids, falsenode_ids, missing_tracks_true,
+                                         root, x_data, stride, n_rows, leaves);
+  }
+  return 0;
+}
+
+#else
+
+bool TreeEnsembleHasAvx2Kernel() {
+  return false;
+}
+
+int64_t TreeEnsembleFindLeavesAvx2(TreeNodeCompare /*compare*/,
+                                   const int32_t* /*feature_ids*/,
+                                   const float* /*thresholds*/,
+                                   const int32_t* /*truenode_ids*/,
+                                   const int32_t* /*falsenode_ids*/,
+                                   const int32_t* /*missing_tracks_true*/,
+                                   int32_t /*root*/,
+                                   const float* /*x_data*/,
+                                   int64_t /*stride*/,
+                                   int64_t /*n_rows*/,
+                                   int32_t* /*leaves*/) {
+  return 0;
+}
+
+#endif  // __AVX2__
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+
+// this header is included by tree_ensemble_avx2.cc which is compiled with AVX2 enabled,
+// so it must not include any header with inline functions
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+enum class TreeNodeCompare {
+  kLeq,
+  kLt,
+  kGte,
+  kGt,
+  kEq,
+  kNeq
+};
+
+// Returns true if tree_ensemble_avx2.cc was compiled with AVX2 enabled.
+// The caller still needs to check CPUIDInfo::HasAVX2 before calling TreeEnsembleFindLeavesAvx2.
+bool TreeEnsembleHasAvx2Kernel();
+
+// Finds the leaf of a tree stored as TreeNodeArrays for rows of x_data, 8 rows at a time with AVX2 gathers.
+// Leaves must point to themselves. missing_tracks_true is nullptr if no node has a missing value track.
+// 8 * stride must fit in an int32_t.
+// Returns the number of rows processed, a multiple of 8, which leaves the remaining rows to the caller.
+int64_t TreeEnsembleFindLeavesAvx2(TreeNodeCompare compare,
+                                   const int32_t* feature_ids,
+                                   const float* thresholds,
+                                   const int32_t* truenode_ids,
+                                   const int32_t* falsenode_ids,
+                                   const int32_t* missing_tracks_true,
+                                   int32_t root,
+                                   const float* x_data,
+                                   int64_t stride,
+                                   int64_t n_rows,
+                                   int32_t* leaves);
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
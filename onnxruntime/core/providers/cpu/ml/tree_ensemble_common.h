@@ -3,7 +3,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
 #include "tree_ensemble_aggregator.h"
+#include "tree_ensemble_avx2.h"
+#include "core/common/cpuid_info.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 
@@ -31,6 +39,25 @@ class TreeEnsembleCommon {
   int parallel_tree_;  // starts parallelizing the computing if n_tree >= parallel_tree_ and n_rows == 1
   int parallel_N_;     // starts parallelizing the computing if n_rows >= parallel_N_
 
+  // Evaluates blocks of rows one tree at a time if n_rows > 1. Empty if the nodes don't all use the same mode.
+  TreeNodeArrays<OTYPE> node_arrays_;
+  TreeNodeCompare compare_;
+  bool use_avx2_;
+
+  // Set if the thresholds are quantized: the distinct thresholds of each feature in increasing order.
+  // A node then compares the bin of its feature, the number of thresholds of the feature the input value
+  // doesn't satisfy the comparison with, to the index of its threshold, which gives the same result.
+  // The bins are 8 bits wide if every feature has less than 255 thresholds and 16 bits wide otherwise,
+  // with the largest value marking missing values.
+  std::vector<std::vector<OTYPE>> feature_thresholds_;
+  std::vector<uint8_t> node_bins8_;
+  std::vector<uint16_t> node_bins16_;
+
+  // number of rows evaluated against a tree before moving to the next one
+  static constexpr int64_t kRowBlockSize = 128;
+  // trees deeper than this are evaluated one row at a time, as rows reach their leaf at very different depths
+  static constexpr int32_t kMaxAvx2TreeDepth = 16;
+
  public:
   TreeEnsembleCommon(int parallel_tree,
                      int parallel_N,
@@ -50,7 +77,8 @@ class TreeEnsembleCommon {
                      const std::vector<int64_t>& target_class_ids,
                      const std::vector<int64_t>& target_class_nodeids,
                      const std::vector<int64_t>& target_class_treeids,
-                     const std::vector<OTYPE>& target_class_weights);
+                     const std::vector<OTYPE>& target_class_weights,
+                     bool quantize_thresholds = false);
 
   void compute(OpKernelContext* ctx, const Tensor* X, Tensor* Z, Tensor* label) const;
 
@@ -60,8 +88,35 @@ class TreeEnsembleCommon {
 
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Z, Tensor* label, const AGG& agg) const;
+
+  template <typename AGG>
+  void ComputeAggPerBlock(concurrency::ThreadPool* ttp, const ITYPE* x_data, OTYPE* z_data, int64_t* label_data,
+                          int64_t N, int64_t stride, const AGG& agg) const;
+
+  void BuildNodeArrays();
+  void BuildThresholdBins();
+
+  // Computes the bins of the features of n_rows rows of x_data, see feature_thresholds_.
+  template <typename BIN>
+  void BinRows(const ITYPE* x_data, int64_t stride, int64_t n_rows, BIN* bins) const;
+
+  template <typename BIN>
+  void FindLeavesBinned(size_t tree, const BIN* bins, const BIN* node_bins, int64_t n_rows, int32_t* leaves) const;
+
+  // Finds the leaf of tree <tree> for n_rows rows of x_data. leaves receives indices in node_arrays_.
+  void FindLeaves(size_t tree, const ITYPE* x_data, int64_t stride, int64_t n_rows, int32_t* leaves) const;
+
+  template <typename CMP>
+  void FindLeaves(int32_t root, const ITYPE* x_data, int64_t stride, int64_t begin_row, int64_t n_rows,
+                  int32_t* leaves, CMP cmp) const;
 };
 
+template <typename ITYPE, typename OTYPE>
+constexpr int64_t TreeEnsembleCommon<ITYPE, OTYPE>::kRowBlockSize;
+
+template <typename ITYPE, typename OTYPE>
+constexpr int32_t TreeEnsembleCommon<ITYPE, OTYPE>::kMaxAvx2TreeDepth;
+
 template <typename ITYPE, typename OTYPE>
 TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int parallel_N,
                                                      const std::string& aggregate_function,
@@ -80,7 +135,8 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
                                                      const std::vector<int64_t>& target_class_ids,
                                                      const std::vector<int64_t>& target_class_nodeids,
                                                      const std::vector<int64_t>& target_class_treeids,
-                                                     const std::vector<OTYPE>& target_class_weights) {
+                                                     const std::vector<OTYPE>& target_class_weights,
+                                                     bool quantize_thresholds) {
   parallel_tree_ = parallel_tree;
   parallel_N_ = parallel_N;
 
@@ -213,6 +269,145 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
       break;
     }
   }
+
+  compare_ = TreeNodeCompare::kLeq;
+  switch (fpos == -1 ? NODE_MODE::LEAF : cmodes[fpos]) {
+    case NODE_MODE::BRANCH_LT:
+      compare_ = TreeNodeCompare::kLt;
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      compare_ = TreeNodeCompare::kGte;
+      break;
+    case NODE_MODE::BRANCH_GT:
+      compare_ = TreeNodeCompare::kGt;
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      compare_ = TreeNodeCompare::kEq;
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      compare_ = TreeNodeCompare::kNeq;
+      break;
+    default:
+      break;
+  }
+  use_avx2_ = std::is_same<ITYPE, float>::value && std::is_same<OTYPE, float>::value &&
+              TreeEnsembleHasAvx2Kernel() && CPUIDInfo::GetCPUIDInfo().HasAVX2();
+  if (same_mode_) {
+    BuildNodeArrays();
+    // the AVX2 kernel compares 8 rows at a time, which is faster than comparing the bins of a single row
+    if (quantize_thresholds && !use_avx2_) {
+      BuildThresholdBins();
+    }
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+void TreeEnsembleCommon<ITYPE, OTYPE>::BuildNodeArrays() {
+  struct PendingNode {
+    TreeNodeElement<OTYPE>* node;
+    int32_t parent;
+    bool is_true_branch;
+    int32_t depth;
+  };
+
+  TreeNodeArrays<OTYPE>& arrays = node_arrays_;
+  std::vector<PendingNode> stack;
+  for (auto* root : roots_) {
+    arrays.roots.push_back(static_cast<int32_t>(arrays.elements.size()));
+    int32_t tree_depth = 0;
+    stack.push_back({root, -1, false, 0});
+    while (!stack.empty()) {
+      PendingNode pending = stack.back();
+      stack.pop_back();
+
+      // a node reached twice means the nodes don't form a tree, keep evaluating them with the pointers
+      TreeNodeElement<OTYPE>* node = pending.node;
+      if (arrays.elements.size() >= static_cast<size_t>(n_nodes_) ||
+          (node->is_not_leaf && (node->truenode == nullptr || node->falsenode == nullptr))) {
+        node_arrays_ = TreeNodeArrays<OTYPE>();
+        return;
+      }
+
+      const int32_t index = static_cast<int32_t>(arrays.elements.size());
+      if (pending.parent >= 0) {
+        (pending.is_true_branch ? arrays.truenode_ids : arrays.falsenode_ids)[pending.parent] = index;
+      }
+
+      arrays.elements.push_back(node);
+      arrays.missing_tracks_true.push_back(node->is_missing_track_true ? -1 : 0);
+      if (node->is_not_leaf) {
+        arrays.feature_ids.push_back(node->feature_id);
+        arrays.thresholds.push_back(node->value);
+        arrays.truenode_ids.push_back(-1);
+        arrays.falsenode_ids.push_back(-1);
+        // the true branch is pushed last so it directly follows its parent
+        stack.push_back({node->falsenode, index, false, pending.depth + 1});
+        stack.push_back({node->truenode, index, true, pending.depth + 1});
+      } else {
+        arrays.feature_ids.push_back(0);
+        arrays.thresholds.push_back(0);
+        arrays.truenode_ids.push_back(index);
+        arrays.falsenode_ids.push_back(index);
+      }
+      tree_depth = std::max(tree_depth, pending.depth);
+    }
+    arrays.depths.push_back(tree_depth);
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+void TreeEnsembleCommon<ITYPE, OTYPE>::BuildThresholdBins() {
+  // Only the bins of <= and < are a prefix of the sorted thresholds that determines the comparison.
+  if (node_arrays_.roots.empty() || (compare_ != TreeNodeCompare::kLeq && compare_ != TreeNodeCompare::kLt)) {
+    return;
+  }
+
+  const TreeNodeArrays<OTYPE>& arrays = node_arrays_;
+  std::vector<std::vector<OTYPE>> thresholds;
+  for (size_t i = 0; i < arrays.elements.size(); ++i) {
+    if (!arrays.elements[i]->is_not_leaf) {
+      continue;
+    }
+    // a NaN threshold can't be ordered with the other ones
+    if (arrays.feature_ids[i] < 0 || std::isnan(static_cast<double>(arrays.thresholds[i]))) {
+      return;
+    }
+    const size_t feature = static_cast<size_t>(arrays.feature_ids[i]);
+    if (feature >= thresholds.size()) {
+      thresholds.resize(feature + 1);
+    }
+    thresholds[feature].push_back(arrays.thresholds[i]);
+  }
+
+  size_t max_thresholds = 0;
+  for (auto& feature_thresholds : thresholds) {
+    std::sort(feature_thresholds.begin(), feature_thresholds.end());
+    feature_thresholds.erase(std::unique(feature_thresholds.begin(), feature_thresholds.end()),
+                             feature_thresholds.end());
+    max_thresholds = std::max(max_thresholds, feature_thresholds.size());
+  }
+
+  // the bins go up to the number of thresholds, plus the value for missing values
+  if (thresholds.empty() || max_thresholds + 1 >= std::numeric_limits<uint16_t>::max()) {
+    return;
+  }
+
+  std::vector<uint16_t> node_bins(arrays.elements.size(), 0);
+  for (size_t i = 0; i < arrays.elements.size(); ++i) {
+    if (arrays.elements[i]->is_not_leaf) {
+      const auto& feature_thresholds = thresholds[arrays.feature_ids[i]];
+      node_bins[i] = static_cast<uint16_t>(
+          std::lower_bound(feature_thresholds.begin(), feature_thresholds.end(), arrays.thresholds[i]) -
+          feature_thresholds.begin());
+    }
+  }
+
+  if (max_thresholds + 1 < std::numeric_limits<uint8_t>::max()) {
+    node_bins8_.assign(node_bins.begin(), node_bins.end());
+  } else {
+    node_bins16_ = std::move(node_bins);
+  }
+  feature_thresholds_ = std::move(thresholds);
 }
 
 template <typename ITYPE, typename OTYPE>
@@ -263,6 +458,11 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
   OTYPE* z_data = Z->template MutableData<OTYPE>();
   int64_t* label_data = label == nullptr ? nullptr : label->template MutableData<int64_t>();
 
+  if (N > 1 && stride > 0 && !node_arrays_.roots.empty()) {
+    ComputeAggPerBlock(ttp, x_data, z_data, label_data, N, stride, agg);
+    return;
+  }
+
   if (n_targets_or_classes_ == 1) {
     if (N == 1) {
       ScoreValue<OTYPE> score = {0, 0};
@@ -492,6 +692,246 @@ TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeave(
   return root;
 }
 
+template <typename ITYPE, typename OTYPE>
+template <typename AGG>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAggPerBlock(concurrency::ThreadPool* ttp, const ITYPE* x_data,
+                                                          OTYPE* z_data, int64_t* label_data, int64_t N,
+                                                          int64_t stride, const AGG& agg) const {
+  // Every tree is evaluated for a block of rows before moving to the next tree so that the nodes of the tree
+  // stay in cache. The scores of a row are still accumulated in the order of the trees.
+  // The rows are binned once per block if the thresholds are quantized, unless the input has less features than
+  // the trees use.
+  const bool use_bins = !feature_thresholds_.empty() && static_cast<size_t>(stride) >= feature_thresholds_.size();
+  auto compute_rows = [this, &agg, x_data, z_data, label_data, stride, use_bins](int64_t begin, int64_t end) {
+    int32_t leaves[kRowBlockSize];
+    std::vector<uint8_t> bins8;
+    std::vector<uint16_t> bins16;
+    std::vector<ScoreValue<OTYPE>> scores1;
+    std::vector<std::vector<ScoreValue<OTYPE>>> scores;
+    for (int64_t block = begin; block < end; block += kRowBlockSize) {
+      const int64_t n_rows = std::min<int64_t>(kRowBlockSize, end - block);
+      const ITYPE* x_block = x_data + block * stride;
+
+      if (use_bins) {
+        if (!node_bins8_.empty()) {
+          bins8.resize(n_rows * feature_thresholds_.size());
+          BinRows(x_block, stride, n_rows, bins8.data());
+        } else {
+          bins16.resize(n_rows * feature_thresholds_.size());
+          BinRows(x_block, stride, n_rows, bins16.data());
+        }
+      }
+
+      auto find_leaves = [&](size_t j) {
+        if (!use_bins) {
+          FindLeaves(j, x_block, stride, n_rows, leaves);
+        } else if (!node_bins8_.empty()) {
+          FindLeavesBinned(j, bins8.data(), node_bins8_.data(), n_rows, leaves);
+        } else {
+          FindLeavesBinned(j, bins16.data(), node_bins16_.data(), n_rows, leaves);
+        }
+      };
+
+      if (n_targets_or_classes_ == 1) {
+        scores1.assign(n_rows, ScoreValue<OTYPE>({0, 0}));
+        for (size_t j = 0; j < node_arrays_.roots.size(); ++j) {
+          find_leaves(j);
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction1(scores1[r], *node_arrays_.elements[leaves[r]]);
+          }
+        }
+
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.FinalizeScores1(z_data + block + r, scores1[r],
+                              label_data == nullptr ? nullptr : (label_data + block + r));
+        }
+      } else {
+        scores.resize(n_rows);
+        for (auto& row_scores : scores) {
+          row_scores.assign(n_targets_or_classes_, ScoreValue<OTYPE>({0, 0}));
+        }
+        for (size_t j = 0; j < node_arrays_.roots.size(); ++j) {
+          find_leaves(j);
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction(scores[r], *node_arrays_.elements[leaves[r]]);
+          }
+        }
+
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.FinalizeScores(scores[r], z_data + (block + r) * n_targets_or_classes_, -1,
+                             label_data == nullptr ? nullptr : (label_data + block + r));
+        }
+      }
+    }
+  };
+
+  if (N <= parallel_N_) {
+    compute_rows(0, N);
+  } else {
+    auto num_threads = std::min<int32_t>(concurrency::ThreadPool::DegreeOfParallelism(ttp), SafeInt<int32_t>(N));
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp,
+        num_threads,
+        [&compute_rows, num_threads, N](ptrdiff_t batch_num) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
+          compute_rows(work.start, work.end);
+        });
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+inline int64_t FindLeavesAvx2(TreeNodeCompare, const TreeNodeArrays<OTYPE>&, int32_t, bool,
+                              const ITYPE*, int64_t, int64_t, int32_t*) {
+  return 0;
+}
+
+inline int64_t FindLeavesAvx2(TreeNodeCompare compare, const TreeNodeArrays<float>& arrays, int32_t root,
+                              bool has_missing_tracks, const float* x_data, int64_t stride, int64_t n_rows,
+                              int32_t* leaves) {
+  return TreeEnsembleFindLeavesAvx2(compare, arrays.feature_ids.data(), arrays.thresholds.data(),
+                                    arrays.truenode_ids.data(), arrays.falsenode_ids.data(),
+                                    has_missing_tracks ? arrays.missing_tracks_true.data() : nullptr,
+                                    root, x_data, stride, n_rows, leaves);
+}
+
+template <typename ITYPE, typename OTYPE>
+void TreeEnsembleCommon<ITYPE, OTYPE>::FindLeaves(size_t tree, const ITYPE* x_data, int64_t stride,
+                                                  int64_t n_rows, int32_t* leaves) const {
+  const int32_t root = node_arrays_.roots[tree];
+  int64_t done = 0;
+  if (use_avx2_ && node_arrays_.depths[tree] <= kMaxAvx2TreeDepth &&
+      stride <= std::numeric_limits<int32_t>::max() / 8) {
+    done = FindLeavesAvx2(compare_, node_arrays_, root, has_missing_tracks_, x_data, stride, n_rows, leaves);
+  }
+
+  switch (compare_) {
+    case TreeNodeCompare::kLeq:
+      FindLeaves(root, x_data, stride, done, n_rows, leaves, std::less_equal<>());
+      break;
+    case TreeNodeCompare::kLt:
+      FindLeaves(root, x_data, stride, done, n_rows, leaves, std::less<>());
+      break;
+    case TreeNodeCompare::kGte:
+      FindLeaves(root, x_data, stride, done, n_rows, leaves, std::greater_equal<>());
+      break;
+    case TreeNodeCompare::kGt:
+      FindLeaves(root, x_data, stride, done, n_rows, leaves, std::greater<>());
+      break;
+    case TreeNodeCompare::kEq:
+      FindLeaves(root, x_data, stride, done, n_rows, leaves, std::equal_to<>());
+      break;
+    case TreeNodeCompare::kNeq:
+      FindLeaves(root, x_data, stride, done, n_rows, leaves, std::not_equal_to<>());
+      break;
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename CMP>
+void TreeEnsembleCommon<ITYPE, OTYPE>::FindLeaves(int32_t root, const ITYPE* x_data, int64_t stride,
+                                                  int64_t begin_row, int64_t n_rows, int32_t* leaves,
+                                                  CMP cmp) const {
+  const int32_t* feature_ids = node_arrays_.feature_ids.data();
+  const OTYPE* thresholds = node_arrays_.thresholds.data();
+  const int32_t* truenode_ids = node_arrays_.truenode_ids.data();
+  const int32_t* falsenode_ids = node_arrays_.falsenode_ids.data();
+  const int32_t* missing_tracks_true = node_arrays_.missing_tracks_true.data();
+
+  for (int64_t r = begin_row; r < n_rows; ++r) {
+    const ITYPE* x = x_data + r * stride;
+    int32_t node = root;
+    int32_t next;
+    ITYPE val;
+    if (has_missing_tracks_) {
+      for (;;) {
+        val = x[feature_ids[node]];
+        next = (cmp(val, thresholds[node]) || (missing_tracks_true[node] && _isnan_(val)))
+                   ? truenode_ids[node]
+                   : falsenode_ids[node];
+        if (next == node)
+          break;
+        node = next;
+      }
+    } else {
+      for (;;) {
+        val = x[feature_ids[node]];
+        next = cmp(val, thresholds[node]) ? truenode_ids[node] : falsenode_ids[node];
+        if (next == node)
+          break;
+        node = next;
+      }
+    }
+    leaves[r] = node;
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename BIN>
+void TreeEnsembleCommon<ITYPE, OTYPE>::BinRows(const ITYPE* x_data, int64_t stride, int64_t n_rows,
+                                               BIN* bins) const {
+  const size_t n_features = feature_thresholds_.size();
+  const BIN missing = std::numeric_limits<BIN>::max();
+  for (int64_t r = 0; r < n_rows; ++r) {
+    const ITYPE* x = x_data + r * stride;
+    BIN* row_bins = bins + r * n_features;
+    for (size_t f = 0; f < n_features; ++f) {
+      const ITYPE val = x[f];
+      const auto& thresholds = feature_thresholds_[f];
+      if (_isnan_(val)) {
+        row_bins[f] = missing;
+      } else if (compare_ == TreeNodeCompare::kLeq) {
+        row_bins[f] = static_cast<BIN>(
+            std::partition_point(thresholds.begin(), thresholds.end(), [val](OTYPE t) { return !(val <= t); }) -
+            thresholds.begin());
+      } else {
+        row_bins[f] = static_cast<BIN>(
+            std::partition_point(thresholds.begin(), thresholds.end(), [val](OTYPE t) { return !(val < t); }) -
+            thresholds.begin());
+      }
+    }
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename BIN>
+void TreeEnsembleCommon<ITYPE, OTYPE>::FindLeavesBinned(size_t tree, const BIN* bins, const BIN* node_bins,
+                                                        int64_t n_rows, int32_t* leaves) const {
+  const size_t n_features = feature_thresholds_.size();
+  const BIN missing = std::numeric_limits<BIN>::max();
+  const int32_t root = node_arrays_.roots[tree];
+  const int32_t* feature_ids = node_arrays_.feature_ids.data();
+  const int32_t* truenode_ids = node_arrays_.truenode_ids.data();
+  const int32_t* falsenode_ids = node_arrays_.falsenode_ids.data();
+  const int32_t* missing_tracks_true = node_arrays_.missing_tracks_true.data();
+
+  for (int64_t r = 0; r < n_rows; ++r) {
+    const BIN* row_bins = bins + r * n_features;
+    int32_t node = root;
+    int32_t next;
+    BIN bin;
+    if (has_missing_tracks_) {
+      for (;;) {
+        bin = row_bins[feature_ids[node]];
+        next = (bin <= node_bins[node] || (missing_tracks_true[node] && bin == missing))
+                   ? truenode_ids[node]
+                   : falsenode_ids[node];
+        if (next == node)
+          break;
+        node = next;
+      }
+    } else {
+      for (;;) {
+        bin = row_bins[feature_ids[node]];
+        next = bin <= node_bins[node] ? truenode_ids[node] : falsenode_ids[node];
+        if (next == node)
+          break;
+        node = next;
+      }
+    }
+    leaves[r] = node;
+  }
+}
+
 template <typename ITYPE, typename OTYPE>
 class TreeEnsembleCommonClassifier : TreeEnsembleCommon<ITYPE, OTYPE> {
  private:
@@ -521,7 +961,8 @@ class TreeEnsembleCommonClassifier : TreeEnsembleCommon<ITYPE, OTYPE> {
                                const std::vector<int64_t>& class_treeids,
                                const std::vector<OTYPE>& class_weights,
                                const std::vector<std::string>& classlabels_strings,
-                               const std::vector<int64_t>& classlabels_int64s);
+                               const std::vector<int64_t>& classlabels_int64s,
+                               bool quantize_thresholds = false);
 
   int64_t get_class_count() const { return this->n_targets_or_classes_; }
 
@@ -549,7 +990,8 @@ TreeEnsembleCommonClassifier<ITYPE, OTYPE>::TreeEnsembleCommonClassifier(
     const std::vector<int64_t>& class_treeids,
     const std::vector<OTYPE>& class_weights,
     const std::vector<std::string>& classlabels_strings,
-    const std::vector<int64_t>& classlabels_int64s)
+    const std::vector<int64_t>& classlabels_int64s,
+    bool quantize_thresholds)
     : TreeEnsembleCommon<ITYPE, OTYPE>(parallel_tree,
                                        parallel_N,
                                        aggregate_function,
@@ -569,7 +1011,8 @@ TreeEnsembleCommonClassifier<ITYPE, OTYPE>::TreeEnsembleCommonClassifier(
                                        class_ids,
                                        class_nodeids,
                                        class_treeids,
-                                       class_weights) {
+                                       class_weights,
+                                       quantize_thresholds) {
   classlabels_strings_ = classlabels_strings;
   classlabels_int64s_ = classlabels_int64s;
 
@@ -618,6 +1061,17 @@ void TreeEnsembleCommonClassifier<ITYPE, OTYPE>::compute(OpKernelContext* ctx, c
   }
 }
 
+// Returns true if the execution provider of the kernel asks tree ensembles to quantize their thresholds.
+inline bool QuantizeTreeEnsembleThresholds(const OpKernelInfo& info) {
+  const IExecutionProvider* provider = info.GetExecutionProvider();
+  if (provider == nullptr) {
+    return false;
+  }
+  const auto& options = provider->GetProviderOptions();
+  auto it = options.find(kCpuProviderOptionQuantizeTreeEnsembleThresholds);
+  return it != options.end() && it->second == "1";
+}
+
 }  // namespace detail
 }  // namespace ml
 }  // namespace onnxruntime
@@ -22,6 +22,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
 
@@ -90,9 +91,8 @@ class BatchNorm : public OpKernel {
                                 is_spatial_ ? sample_size : sample_size_incl_all_channels,
                                 is_spatial_ ? N * C : N);
     if (is_spatial_) {  // spatial == 1
-      for (size_t nc = 0; nc < N * C; ++nc) {
-        Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
-      }
+      ScaleShiftChannels(X->template Data<T>(), new_scale.data(), new_bias.data(), Y->template MutableData<T>(),
+                         N, C, sample_size, p_op_kernel_context->GetOperatorThreadPool());
     } else {  // spatial == 0
       for (size_t n = 0; n < N; ++n) {
         Y_arr.col(n) = X_arr.col(n) * new_scale.col(0) + new_bias.col(0);
@@ -102,6 +102,25 @@ class BatchNorm : public OpKernel {
     return Status::OK();
   }
 
+ private:
+  template <typename U>
+  static void ScaleShiftChannels(const U* X, const U* scale, const U* bias, U* Y, size_t N, size_t C,
+                                 size_t sample_size, concurrency::ThreadPool* /*thread_pool*/) {
+    ConstEigenArrayMap<U> X_arr(X, sample_size, N * C);
+    EigenArrayMap<U> Y_arr(Y, sample_size, N * C);
+    for (size_t nc = 0; nc < N * C; ++nc) {
+      Y_arr.col(nc) = X_arr.col(nc) * scale[nc % C] + bias[nc % C];
+    }
+  }
+
+  // The float channels are scaled and shifted by MLAS on the thread pool.
+  static void ScaleShiftChannels(const float* X, const float* scale, const float* bias, float* Y, size_t N, size_t C,
+                                 size_t sample_size, concurrency::ThreadPool* thread_pool) {
+    MLAS_ACTIVATION activation;
+    activation.ActivationKind = MlasIdentityActivation;
+    MlasChannelScaleShift(X, scale, bias, Y, N, C, sample_size, &activation, thread_pool);
+  }
+
  protected:
   float epsilon_;
   const bool is_spatial_;
@@ -17,11 +17,29 @@
 
 #include "core/providers/cpu/nn/conv.h"
 
+#include <algorithm>
+
 #include "core/common/safeint.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 
+namespace {
+
+// Returns false if the execution provider of the kernel disables the Winograd convolution algorithm.
+bool IsWinogradConvEnabled(const OpKernelInfo& info) {
+  const IExecutionProvider* provider = info.GetExecutionProvider();
+  if (provider == nullptr) {
+    return true;
+  }
+  const auto& options = provider->GetProviderOptions();
+  auto it = options.find(kCpuProviderOptionDisableWinogradConv);
+  return it == options.end() || it->second != "1";
+}
+
+}  // namespace
+
 template <typename T>
 Status Conv<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -160,11 +178,48 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (input_idx != 1 || !IsWinogradConvEnabled(Info())) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape();
+  const auto is_one = [](int64_t value) { return value == 1; };
+  if (shape.NumDimensions() != 4 || shape[2] != 3 || shape[3] != 3 || shape[0] % conv_attrs_.group != 0 ||
+      !std::all_of(conv_attrs_.strides.begin(), conv_attrs_.strides.end(), is_one) ||
+      !std::all_of(conv_attrs_.dilations.begin(), conv_attrs_.dilations.end(), is_one)) {
+    return Status::OK();
+  }
+
+  const auto group_count = static_cast<size_t>(conv_attrs_.group);
+  const auto input_channels = static_cast<size_t>(shape[1]);
+  const auto filter_count = static_cast<size_t>(shape[0]) / group_count;
+
+  // MLAS returns zero if the channel counts are too small for the Winograd algorithm to ever be selected.
+  const size_t packed_size = MlasConvWinogradPackFilterSize(group_count, input_channels, filter_count);
+  if (packed_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  packed_W_winograd_bytes_ = SafeInt<size_t>(sizeof(float)) * packed_size;
+  auto* packed_data = alloc->Alloc(packed_W_winograd_bytes_);
+  packed_W_winograd_ = BufferUniquePtr(packed_data, BufferDeleter(alloc));
+
+  MlasConvWinogradPackFilter(group_count, input_channels, filter_count, tensor.Data<float>(),
+                             static_cast<float*>(packed_data));
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const auto* X = context->Input<Tensor>(0);
   const auto* W = context->Input<Tensor>(1);
-  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+  const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
+  // the optional sum of FusedConv is added to the output before the activation
+  const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
   const int64_t M = W->Shape()[0];
@@ -189,7 +244,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   std::vector<int64_t> Y_dims({N, M});
   TensorShape input_shape = X->Shape().Slice(2);
   ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  Tensor* Y = context->Output(0, Y_dims);
   TensorShape output_shape = Y->Shape().Slice(2);
 
   // Bail out early if one of the dimensions is zero.
@@ -204,6 +259,18 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   const auto* Bdata = B != nullptr ? B->template Data<float>() : nullptr;
   auto* Ydata = Y->template MutableData<float>();
 
+  float beta = 0.0f;
+  if (Sum != nullptr) {
+    const auto& sum_shape = Sum->Shape();
+    ORT_RETURN_IF_NOT(Y->Shape() == sum_shape, "output and sum shape must match");
+    // If the output was not allocated inplace with the sum tensor, then copy here.
+    const auto* sum_data = Sum->template Data<float>();
+    if (Ydata != sum_data) {
+      memcpy(Ydata, sum_data, sum_shape.Size() * sizeof(float));
+    }
+    beta = 1.0f;
+  }
+
   const size_t kernel_rank = kernel_shape.size();
   concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
@@ -223,6 +290,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     output_shape.GetDims().data(),
                     static_cast<size_t>(M / conv_attrs_.group),
                     &activation_,
+                    beta,
+                    static_cast<const float*>(packed_W_winograd_.get()),
                     &WorkingBufferSize,
                     thread_pool);
 
@@ -271,22 +340,26 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             static_cast<int>(kernel_shape.size()),
             col_buffer_data);
 
-        math::Gemm<float>(
+        // the sum, the bias and the activation are applied by MLAS to each block of the output as it's computed
+        MlasGemm(
             CblasNoTrans,
             CblasNoTrans,
-            M / conv_attrs_.group,
-            output_image_size,
-            kernel_dim,
+            static_cast<size_t>(M / conv_attrs_.group),
+            static_cast<size_t>(output_image_size),
+            static_cast<size_t>(kernel_dim),
             1,
             W->template Data<float>() + group_id * W_offset,
+            static_cast<size_t>(kernel_dim),
             col_buffer_data,
-            0,
+            static_cast<size_t>(output_image_size),
+            beta,
             Ydata + group_id * Y_offset,
+            static_cast<size_t>(output_image_size),
+            &activation_,
+            Bdata != nullptr ? Bdata + group_id * (M / conv_attrs_.group) : nullptr,
             thread_pool);
       }
 
-      MlasActivation(&activation_, Ydata, Bdata, M, output_image_size, output_image_size);
-
       Xdata += X_offset * conv_attrs_.group;
       Ydata += Y_offset * conv_attrs_.group;
     }
@@ -28,12 +28,22 @@ class Conv<float> : public OpKernel {
     activation_.ActivationKind = MlasIdentityActivation;
   }
 
+  // Transforms a constant 3x3 filter for the Winograd algorithm. The filter itself is kept, as MlasConvPrepare only
+  // selects the Winograd algorithm for some input shapes.
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  size_t PrePackedBytes() const override { return packed_W_winograd_bytes_; }
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  BufferUniquePtr packed_W_winograd_;
+  size_t packed_W_winograd_bytes_{0};
 };
 
 }  // namespace onnxruntime
@@ -72,7 +72,7 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
   std::vector<int64_t> Y_dims({N, M});
   TensorShape input_shape = X->Shape().Slice(2);
   ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  Tensor* Y = context->Output(0, Y_dims);
   TensorShape output_shape = Y->Shape().Slice(2);
 
   // Bail out early if one of the dimensions is zero.
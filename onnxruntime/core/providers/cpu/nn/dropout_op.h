@@ -4,9 +4,10 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/framework/philox.h"
 #include "core/framework/random_generator.h"
-#include <chrono>
-#include <random>
+#include "core/platform/threadpool.h"
+#include <algorithm>
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -17,14 +18,14 @@ class Dropout final: public OpKernel {
   Dropout(const OpKernelInfo& info) : OpKernel{info} {
     int64_t seed = 0;
     if (info.GetAttr<int64_t>("seed", &seed).IsOK()) {
-      generator_ = onnxruntime::make_unique<RandomGenerator>(seed);
+      generator_ = onnxruntime::make_unique<PhiloxGenerator>(static_cast<uint64_t>(seed));
     }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  mutable std::unique_ptr<RandomGenerator> generator_;
+  mutable std::unique_ptr<PhiloxGenerator> generator_;
 };
 
 namespace {
@@ -82,14 +83,26 @@ Status Dropout<T1, T2, trainable_dropout>::Compute(OpKernelContext* context) con
     EigenVectorArrayMap<T1> Y_arr(Y_span.data(), Y_span.size());
     EigenVectorArrayMap<bool> mask_arr(mask_span.data(), mask_span.size());
 
-    // generate mask
+    // generate mask. element i takes value i % 4 of Philox block i / 4, so the blocks are generated in parallel
+    // and the mask doesn't depend on the number of threads.
     {
-      RandomGenerator& generator = generator_ != nullptr ? *generator_.get() : RandomGenerator::Default();
-      std::default_random_engine rng(generator.NextSeed());
-      std::uniform_real_distribution<float> dist{0.0f, 1.0f};
-      mask_arr = Eigen::ArrayX<bool>::NullaryExpr(
-          mask_arr.size(),
-          [ratio_value, &dist, &rng]() { return dist(rng) >= ratio_value; });
+      PhiloxGenerator& generator = generator_ != nullptr ? *generator_.get() : PhiloxGenerator::Default();
+      const int64_t size = static_cast<int64_t>(mask_span.size());
+      const int64_t num_blocks = (size + 3) / 4;
+      const auto seeds = generator.NextPhiloxSeeds(static_cast<uint64_t>(num_blocks));
+      bool* mask_data = mask_span.data();
+      concurrency::ThreadPool::TryParallelFor(
+          context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_blocks),
+          TensorOpCost{0.0, 4.0 * sizeof(bool), 64.0},
+          [ratio_value, size, &seeds, mask_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+            uint32_t block[4];
+            for (int64_t b = first; b < last; ++b) {
+              Philox4x32x10::Generate(seeds.first, seeds.second + b, 0, block);
+              for (int64_t i = b * 4, end = std::min(i + 4, size); i < end; ++i) {
+                mask_data[i] = Philox4x32x10::ToFloat(block[i - b * 4]) >= ratio_value;
+              }
+            }
+          });
     }
 
     Y_arr = mask_arr.cast<T1>() * X_arr / (1.0f - ratio_value);
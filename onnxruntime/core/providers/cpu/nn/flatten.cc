@@ -10,6 +10,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     8,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 
@@ -19,6 +20,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     10,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 
@@ -29,6 +31,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     12,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 
@@ -37,6 +40,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     13,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 }  // namespace onnxruntime
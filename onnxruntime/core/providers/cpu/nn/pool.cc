@@ -119,6 +119,39 @@ Status PoolBase::Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const
   return Status::OK();
 }
 
+Status PoolBase::ComputeNhwc(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
+  const auto* X = context->Input<Tensor>(0);
+  const TensorShape& x_shape = X->Shape();
+
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() == 4, "Input must be a 4D tensor in NHWC format.");
+  if (!pool_attrs_.global_pooling) {
+    ORT_RETURN_IF_NOT(pool_attrs_.kernel_shape.size() == 2,
+                      "kernel_shape num_dims is not compatible with X num_dims.");
+    ORT_RETURN_IF_NOT(pool_attrs_.default_dilations, "Dilations are not supported for NHWC pooling.");
+  }
+
+  // Infer the spatial output size from the NCHW view of the input.
+  const int64_t channels = x_shape[3];
+  const TensorShape nchw_shape({x_shape[0], channels, x_shape[1], x_shape[2]});
+  std::vector<int64_t> pads = pool_attrs_.pads;
+  std::vector<int64_t> nchw_output_dims = pool_attrs_.SetOutputSize(nchw_shape, channels, &pads);
+  std::vector<int64_t> output_dims{nchw_output_dims[0], nchw_output_dims[2], nchw_output_dims[3], channels};
+  TensorShape output_shape(output_dims);
+  Tensor* Y = context->Output(0, output_shape);
+
+  // edge case: one or more dims with value of 0
+  if (output_shape.Size() == 0)
+    return Status::OK();
+
+  MlasPoolNhwc(kind, x_shape.GetDims().data(),
+               pool_attrs_.global_pooling ? nullptr : pool_attrs_.kernel_shape.data(),
+               pool_attrs_.global_pooling ? nullptr : pads.data(),
+               pool_attrs_.global_pooling ? nullptr : pool_attrs_.strides.data(), output_dims.data(),
+               X->template Data<float>(), Y->template MutableData<float>(), context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
 template <>
 Status Pool<float, MaxPool<1 /*VERSION*/>>::Compute(OpKernelContext* context) const {
   return PoolBase::Compute(context, MlasMaximumPooling);
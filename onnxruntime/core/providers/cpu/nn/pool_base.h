@@ -110,10 +110,20 @@ class PoolBase {
         pool_attrs_(info, op_name_, GetStartVersion(info)) {
   }
 
+  // Used by kernels whose op name differs from the ONNX pooling operator that defines their attributes, such as the
+  // channels last pooling kernels.
+  PoolBase(const OpKernelInfo& info, const std::string& op_name)
+      : op_name_(op_name),
+        pool_attrs_(info, op_name_, GetStartVersion(info)) {
+  }
+
   ~PoolBase() = default;
 
   Status Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
 
+  // Pools a 4D tensor in NHWC format.
+  Status ComputeNhwc(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+
  protected:
   const std::string op_name_;
 
@@ -11,252 +11,31 @@
 #include "core/util/gemmlowp_common.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <algorithm>
+#include <type_traits>
+
 namespace onnxruntime {
 
 template <typename T>
-class QLinearConv;
-
-template <>
-class QLinearConv<uint8_t> : public OpKernel {
+class QLinearConv : public OpKernel {
  public:
-  explicit QLinearConv<uint8_t>(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {}
+  explicit QLinearConv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info), is_W_packed_(false) {}
 
   Status Compute(OpKernelContext* context) const override;
-
- protected:
-  ConvAttributes conv_attrs_;
-};
-
-ONNX_CPU_OPERATOR_TYPED_KERNEL(
-    QLinearConv,
-    10,
-    uint8_t,
-    KernelDefBuilder()
-        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
-        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
-        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>())
-        .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
-    QLinearConv<uint8_t>);
-
-Status QLinearConv<uint8_t>::Compute(OpKernelContext* context) const {
-  const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(3);
-
-  // validate offsets
-  const Tensor* X_zero_point = context->Input<Tensor>(2);
-  const Tensor* W_zero_point = context->Input<Tensor>(5);
-  const Tensor* Y_zero_point = context->Input<Tensor>(7);
-  ORT_ENFORCE(IsScalarOr1ElementVector(X_zero_point),
-              "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(W_zero_point),
-              "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(Y_zero_point),
-              "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
-
-  auto X_zero_point_value = *(X_zero_point->template Data<uint8_t>());
-  auto W_zero_point_value = *(W_zero_point->template Data<uint8_t>());
-  auto Y_zero_point_value = *(Y_zero_point->template Data<uint8_t>());
-
-  // validate scale
-  const Tensor* X_scale = context->Input<Tensor>(1);
-  const Tensor* W_scale = context->Input<Tensor>(4);
-  const Tensor* Y_scale = context->Input<Tensor>(6);
-  ORT_ENFORCE(IsScalarOr1ElementVector(X_scale),
-              "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(W_scale),
-              "QLinearConv : filter scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(Y_scale),
-              "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
-
-  auto X_scale_value = *(X_scale->template Data<float>());
-  auto W_scale_value = *(W_scale->template Data<float>());
-  auto Y_scale_value = *(Y_scale->template Data<float>());
-
-  const Tensor* B = context->Input<Tensor>(8);
-
-  const int64_t N = X->Shape()[0];
-  const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
-
-  std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
-
-  const size_t kernel_rank = kernel_shape.size();
-
-  std::vector<int64_t> pads(conv_attrs_.pads);
-  if (pads.empty()) {
-    pads.resize(kernel_rank * 2, 0);
-  }
-  std::vector<int64_t> dilations(conv_attrs_.dilations);
-  if (dilations.empty()) {
-    dilations.resize(kernel_rank, 1);
-  }
-  std::vector<int64_t> strides(conv_attrs_.strides);
-  if (strides.empty()) {
-    strides.resize(kernel_rank, 1);
-  }
-
-  std::vector<int64_t> Y_dims({N, M});
-  TensorShape input_shape = X->Shape().Slice(2);
-  ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
-  TensorShape output_shape = Y->Shape().Slice(2);
-
-  // Bail out early if one of the dimensions is zero.
-  if (Y->Shape().Size() == 0) {
-    return Status::OK();
-  }
-
-  const int64_t input_image_size = input_shape.Size();
-  const int64_t output_image_size = output_shape.Size();
-  const int64_t kernel_size = TensorShape(kernel_shape).Size();
-
-  const int64_t group_input_channels = W->Shape()[1];
-  const int64_t group_output_channels = M / conv_attrs_.group;
-
-  const int64_t X_offset = group_input_channels * input_image_size;
-  const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / conv_attrs_.group;
-  const int64_t kernel_dim = group_input_channels * kernel_size;
-  const int64_t W_offset = W->Shape().Size() / conv_attrs_.group;
-  const int64_t col_buffer_size = kernel_dim * output_image_size;
-
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-  BufferUniquePtr col_buffer;
-  std::vector<int64_t> col_buffer_shape;
-
-  // Pointwise convolutions can use the original input tensor in place,
-  // otherwise a temporary buffer is required for the im2col transform.
-  if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
-    auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * col_buffer_size);
-    col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
-
-    if (kernel_rank != 2) {
-      const auto& output_dims = output_shape.GetDims();
-      col_buffer_shape.reserve(1 + output_dims.size());
-      col_buffer_shape.push_back(kernel_dim);
-      col_buffer_shape.insert(col_buffer_shape.end(), output_dims.begin(), output_dims.end());
-    }
-  }
-
-  auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
-
-  const float real_multiplier = (X_scale_value * W_scale_value) / Y_scale_value;
-
-#ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
-  // Use an intermediate int32_t buffer for the GEMM computation before
-  // requantizing to the output type.
-  auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * Y_offset);
-  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
-  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
-#else
-  // Compute the fixed point multiplier and shift for requantizing with GEMMLOWP.
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
-#endif
-
-  const auto* Xdata = X->template Data<uint8_t>();
-  const auto* Wdata = W->template Data<uint8_t>();
-  const auto* Bdata = B != nullptr ? B->template Data<int32_t>() : nullptr;
-  auto* Ydata = Y->template MutableData<uint8_t>();
-
-  for (int64_t image_id = 0; image_id < N; ++image_id) {
-    for (int64_t group_id = 0; group_id < conv_attrs_.group; ++group_id) {
-      if (col_buffer_data != nullptr) {
-        if (kernel_rank == 2) {
-          math::Im2col<uint8_t, StorageOrder::NCHW>()(
-              Xdata,
-              group_input_channels,
-              input_shape[0],
-              input_shape[1],
-              kernel_shape[0],
-              kernel_shape[1],
-              dilations[0],
-              dilations[1],
-              pads[0],
-              pads[1],
-              pads[2],
-              pads[3],
-              strides[0],
-              strides[1],
-              col_buffer_data,
-              X_zero_point_value);
-        } else {
-          math::Im2colNd<uint8_t, StorageOrder::NCHW>()(
-              Xdata,
-              X->Shape().GetDims().data() + 1,
-              col_buffer_shape.data(),
-              C * input_image_size,
-              col_buffer_size,
-              kernel_shape.data(),
-              strides.data(),
-              dilations.data(),
-              pads.data(),
-              static_cast<int>(kernel_rank),
-              col_buffer_data,
-              false,
-              X_zero_point_value);
-        }
-      }
-
-#ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
-      QGemm(static_cast<int>(group_output_channels),
-            static_cast<int>(output_image_size),
-            static_cast<int>(kernel_dim),
-            Wdata + group_id * W_offset,
-            static_cast<int>(kernel_dim),
-            W_zero_point_value,
-            col_buffer_data == nullptr ? Xdata : col_buffer_data,
-            static_cast<int>(output_image_size),
-            X_zero_point_value,
-            false,
-            gemm_output,
-            static_cast<int>(output_image_size),
-            context->GetOperatorThreadPool());
-
-      MlasRequantizeOutput(gemm_output,
-                           Ydata,
-                           Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr,
-                           static_cast<size_t>(group_output_channels),
-                           static_cast<size_t>(output_image_size),
-                           real_multiplier,
-                           Y_zero_point_value);
-#else
-      GemmlowpMultiplyu8u8_u8(Wdata + group_id * W_offset,
-                              col_buffer_data == nullptr ? Xdata : col_buffer_data,
-                              Ydata,
-                              W_zero_point_value,
-                              X_zero_point_value,
-                              Y_zero_point_value,
-                              static_cast<int>(group_output_channels),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr);
+#if defined(MLAS_TARGET_AMD64_IX86)
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
 #endif
 
-      Xdata += X_offset;
-      Ydata += Y_offset;
+  size_t PrePackedBytes() const override {
+    size_t bytes = reordered_W_buffer_ ? static_cast<size_t>(W_shape_.Size()) : 0;
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+    if (packed_W_buffer_) {
+      bytes += static_cast<size_t>(conv_attrs_.group) * packed_W_size_;
     }
+#endif
+    return bytes;
   }
 
-  return Status::OK();
-}
-
-#if defined(MLAS_TARGET_AMD64_IX86)
-
-template <>
-class QLinearConv<int8_t> : public OpKernel {
- public:
-  explicit QLinearConv<int8_t>(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info), is_W_packed_(false) {}
-
-  Status Compute(OpKernelContext* context) const override;
-  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
-
  private:
   static void ReorderFilter(const uint8_t* input,
                             uint8_t* output,
@@ -274,6 +53,19 @@ class QLinearConv<int8_t> : public OpKernel {
   bool is_W_packed_;
 };
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    QLinearConv,
+    10,
+    uint8_t,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
+    QLinearConv<uint8_t>);
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     QLinearConv,
     10,
@@ -285,11 +77,14 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
     QLinearConv<int8_t>);
 
-void QLinearConv<int8_t>::ReorderFilter(const uint8_t* input,
-                                        uint8_t* output,
-                                        size_t output_channels,
-                                        size_t input_channels,
-                                        size_t kernel_size) {
+#endif
+
+template <typename T>
+void QLinearConv<T>::ReorderFilter(const uint8_t* input,
+                                   uint8_t* output,
+                                   size_t output_channels,
+                                   size_t input_channels,
+                                   size_t kernel_size) {
   for (size_t k = 0; k < kernel_size; k++) {
     for (size_t ic = 0; ic < input_channels; ic++) {
       for (size_t oc = 0; oc < output_channels; oc++) {
@@ -300,7 +95,10 @@ void QLinearConv<int8_t>::ReorderFilter(const uint8_t* input,
   }
 }
 
-Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+#if defined(MLAS_TARGET_AMD64_IX86)
+
+template <typename T>
+Status QLinearConv<T>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
   is_packed = false;
 
   // Support packing the weight matrix.
@@ -318,6 +116,12 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
     return Status::OK();
   }
 
+  // Depthwise convolutions with an unsigned filter are computed directly from
+  // the original filter tensor.
+  if (std::is_same<T, uint8_t>::value && shape[1] == 1 && shape[0] == conv_attrs_.group) {
+    return Status::OK();
+  }
+
   // Note: The tensor has already been allocated with this tensor shape, so all
   // shape indices are guaranteed to fit inside size_t.
   const size_t output_channels = static_cast<size_t>(shape[0]);
@@ -334,7 +138,7 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
   auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
 
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-  packed_W_size_ = MlasGemmPackBSize(group_output_channels, kernel_dim, true);
+  packed_W_size_ = MlasGemmPackBSize(group_output_channels, kernel_dim, std::is_signed<T>::value);
 
   if (packed_W_size_ != 0) {
     auto* packed_W = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(group_count) * packed_W_size_));
@@ -352,7 +156,7 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
 
     for (int64_t group_id = 0; group_id < conv_attrs_.group; ++group_id) {
       ReorderFilter(Wdata, group_reordered_W, group_output_channels, group_input_channels, kernel_size);
-      MlasGemmPackB(group_output_channels, kernel_dim, group_reordered_W, group_output_channels, true, packed_W);
+      MlasGemmPackB(group_output_channels, kernel_dim, group_reordered_W, group_output_channels, std::is_signed<T>::value, packed_W);
       packed_W += packed_W_size_;
       Wdata += W_offset;
     }
@@ -373,12 +177,16 @@ Status QLinearConv<int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& i
   return Status::OK();
 }
 
-Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
+#endif
+
+template <typename T>
+Status QLinearConv<T>::Compute(OpKernelContext* context) const {
   const Tensor* X = context->Input<Tensor>(0);
   const Tensor* W = is_W_packed_ ? nullptr : context->Input<Tensor>(3);
   const auto& W_shape = is_W_packed_ ? W_shape_ : W->Shape();
 
   const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
   const int64_t M = W_shape[0];
 
   // validate offsets
@@ -393,20 +201,21 @@ Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
   auto X_zero_point_value = *(X_zero_point->template Data<uint8_t>());
   auto Y_zero_point_value = *(Y_zero_point->template Data<uint8_t>());
 
+  // The filter zero point is either per tensor or per output channel. The
+  // values are kept as raw bytes and are interpreted as signed for an int8_t
+  // filter.
   const auto& W_zero_point_shape = W_zero_point->Shape();
-  if (W_zero_point_shape.NumDimensions() == 0 ||
-      (W_zero_point_shape.NumDimensions() == 1 && (W_zero_point_shape[0] == 1 || W_zero_point_shape[0] == M))) {
-    const int64_t W_zero_point_size = W_zero_point_shape.Size();
-    const auto* W_zero_point_data = W_zero_point->template Data<int8_t>();
-    for (int64_t i = 0; i < W_zero_point_size; i++) {
-      if (W_zero_point_data[i] != 0) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "QLinearConv : filter zero point must be zero");
-      }
-    }
-  } else {
+  if (!(W_zero_point_shape.NumDimensions() == 0 ||
+        (W_zero_point_shape.NumDimensions() == 1 && (W_zero_point_shape[0] == 1 || W_zero_point_shape[0] == M)))) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "QLinearConv : filter zero point shape invalid");
   }
 
+  const auto* W_zero_point_data = static_cast<const uint8_t*>(W_zero_point->DataRaw());
+  const uint8_t W_zero_point_value = W_zero_point_data[0];
+  const bool is_W_zero_point_uniform =
+      std::all_of(W_zero_point_data, W_zero_point_data + W_zero_point_shape.Size(),
+                  [W_zero_point_value](uint8_t zero_point) { return zero_point == W_zero_point_value; });
+
   // validate scale
   const Tensor* X_scale = context->Input<Tensor>(1);
   const Tensor* W_scale = context->Input<Tensor>(4);
@@ -441,7 +250,6 @@ Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   const size_t kernel_rank = kernel_shape.size();
-  ORT_ENFORCE(kernel_rank == 2, "QLinearConv : must be 2D convolution");
 
   std::vector<int64_t> pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -459,7 +267,7 @@ Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
   std::vector<int64_t> Y_dims({N, M});
   TensorShape input_shape = X->Shape().Slice(2);
   ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  Tensor* Y = context->Output(0, Y_dims);
   TensorShape output_shape = Y->Shape().Slice(2);
 
   // Bail out early if one of the dimensions is zero.
@@ -483,96 +291,336 @@ Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
-  // Use an intermediate int32_t buffer for the GEMM computation before
-  // requantizing to the output type.
-  auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * Y_offset);
-  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
-  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
-
   const auto* Xdata = X->template Data<uint8_t>();
   const auto* Bdata = B != nullptr ? B->template Data<int32_t>() : nullptr;
   auto* Ydata = Y->template MutableData<uint8_t>();
 
-  auto* transpose_input = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * X_offset));
-  BufferUniquePtr transpose_input_buffer(transpose_input, BufferDeleter(alloc));
+#if defined(MLAS_TARGET_AMD64_IX86)
+  if (kernel_rank == 2) {
+    concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+    // Depthwise convolutions are computed directly from the input tensor for all
+    // of the channels at once instead of running an im2col and GEMM per channel.
+    if (std::is_same<T, uint8_t>::value && W != nullptr && is_W_zero_point_uniform &&
+        group_input_channels == 1 && group_output_channels == 1) {
+      MLAS_ACTIVATION activation;
+      activation.ActivationKind = MlasIdentityActivation;
+
+      MLAS_CONV_PARAMETERS conv_params;
+      size_t working_buffer_size;
+      MlasConvPrepare(&conv_params,
+                      kernel_rank,
+                      1,
+                      static_cast<size_t>(group_count),
+                      1,
+                      input_shape.GetDims().data(),
+                      kernel_shape.data(),
+                      dilations.data(),
+                      pads.data(),
+                      strides.data(),
+                      output_shape.GetDims().data(),
+                      1,
+                      &activation,
+                      0.0f,
+                      nullptr,
+                      &working_buffer_size,
+                      thread_pool);
+
+      if (conv_params.Algorithm == MlasConvAlgorithmDepthwise) {
+        const int64_t Y_image_size = M * output_image_size;
+        auto depthwise_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * Y_image_size);
+        BufferUniquePtr depthwise_output_buffer(depthwise_output_data, BufferDeleter(alloc));
+        auto* depthwise_output = static_cast<int32_t*>(depthwise_output_buffer.get());
+
+        const auto* Wdata = static_cast<const uint8_t*>(W->DataRaw());
+
+        for (int64_t image_id = 0; image_id < N; ++image_id) {
+          MlasConvDepthwise(&conv_params,
+                            Xdata,
+                            X_zero_point_value,
+                            Wdata,
+                            W_zero_point_value,
+                            depthwise_output,
+                            thread_pool);
+
+          if (output_scales.size() == 1) {
+            MlasRequantizeOutput(depthwise_output,
+                                 Ydata,
+                                 Bdata,
+                                 static_cast<size_t>(M),
+                                 static_cast<size_t>(output_image_size),
+                                 output_scales[0],
+                                 Y_zero_point_value);
+          } else {
+            for (int64_t channel = 0; channel < M; ++channel) {
+              MlasRequantizeOutput(depthwise_output + channel * output_image_size,
+                                   Ydata + channel * output_image_size,
+                                   Bdata != nullptr ? Bdata + channel : nullptr,
+                                   1,
+                                   static_cast<size_t>(output_image_size),
+                                   output_scales[channel],
+                                   Y_zero_point_value);
+            }
+          }
+
+          Xdata += C * input_image_size;
+          Ydata += Y_image_size;
+        }
+
+        return Status::OK();
+      }
+    }
+
+    // Use an intermediate int32_t buffer for the GEMM computation before
+    // requantizing to the output type.
+    auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * Y_offset);
+    BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+    auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+    auto* transpose_input = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * X_offset));
+    BufferUniquePtr transpose_input_buffer(transpose_input, BufferDeleter(alloc));
 
-  auto* transpose_output = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * Y_offset));
-  BufferUniquePtr transpose_output_buffer(transpose_output, BufferDeleter(alloc));
+    auto* transpose_output = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * Y_offset));
+    BufferUniquePtr transpose_output_buffer(transpose_output, BufferDeleter(alloc));
 
-  // Handle the case of a dynamic weight filter.
-  BufferUniquePtr reordered_W_buffer;
-  uint8_t* reordered_W = nullptr;
-  bool use_reordered_W = true;
+    // Handle the case of a dynamic weight filter.
+    BufferUniquePtr reordered_W_buffer;
+    uint8_t* reordered_W = nullptr;
+    bool use_reordered_W = true;
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-  if (packed_W_buffer_) {
-    use_reordered_W = false;
-  }
+    if (packed_W_buffer_) {
+      use_reordered_W = false;
+    }
 #endif
-  if (use_reordered_W) {
-    if (reordered_W_buffer_) {
-      reordered_W = static_cast<uint8_t*>(reordered_W_buffer_.get());
-    } else {
-      // Weight tensor was not constant or prepacking is disabled.
-      reordered_W = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * W_shape.Size()));
-      reordered_W_buffer = BufferUniquePtr(reordered_W, BufferDeleter(alloc));
-      ReorderFilter(static_cast<const uint8_t*>(W->DataRaw()),
-                    reordered_W,
-                    static_cast<size_t>(M),
-                    static_cast<size_t>(group_input_channels),
-                    static_cast<size_t>(kernel_size));
+    if (use_reordered_W) {
+      if (reordered_W_buffer_) {
+        reordered_W = static_cast<uint8_t*>(reordered_W_buffer_.get());
+      } else {
+        // Weight tensor was not constant or prepacking is disabled.
+        reordered_W = static_cast<uint8_t*>(alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * W_shape.Size()));
+        reordered_W_buffer = BufferUniquePtr(reordered_W, BufferDeleter(alloc));
+        ReorderFilter(static_cast<const uint8_t*>(W->DataRaw()),
+                      reordered_W,
+                      static_cast<size_t>(M),
+                      static_cast<size_t>(group_input_channels),
+                      static_cast<size_t>(kernel_size));
+      }
+    }
+
+    // Pointwise convolutions can use the original input tensor in place,
+    // otherwise a temporary buffer is required for the im2col transform.
+    BufferUniquePtr col_buffer;
+    if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+      auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * col_buffer_size);
+      col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
+    }
+    auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+
+    // A filter zero point that is shared by all of the output channels is
+    // applied by the GEMM, otherwise the GEMM output is adjusted per output
+    // channel before requantizing.
+    const uint8_t gemm_W_zero_point = is_W_zero_point_uniform ? W_zero_point_value : 0;
+
+    // Replicate the logic from MlasGemmU8X8Schedule to control the number of
+    // worker threads used for the convolution.
+    constexpr int32_t maximum_thread_count = 16;
+    constexpr double thread_complexity = static_cast<double>(64 * 1024);
+
+    const double complexity = static_cast<double>(output_image_size) *
+                              static_cast<double>(group_output_channels) *
+                              static_cast<double>(kernel_dim);
+
+    int32_t thread_count = maximum_thread_count;
+    if (complexity < thread_complexity * maximum_thread_count) {
+      thread_count = static_cast<int32_t>(complexity / thread_complexity) + 1;
     }
+    if (thread_count > output_image_size) {
+      // Ensure that every thread produces at least one output.
+      thread_count = static_cast<int32_t>(output_image_size);
+    }
+
+    thread_count = std::min(thread_count, concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+
+    for (int64_t image_id = 0; image_id < N; ++image_id) {
+      for (int64_t group_id = 0; group_id < group_count; ++group_id) {
+        // Transpose the input from channels first (NCHW) to channels last (NHWC).
+        MlasTranspose(Xdata,
+                      transpose_input,
+                      static_cast<size_t>(group_input_channels),
+                      static_cast<size_t>(input_image_size));
+
+        auto conv_worker = [&](ptrdiff_t batch) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch, thread_count, static_cast<ptrdiff_t>(output_image_size));
+          int64_t output_start = static_cast<int64_t>(work.start);
+          int64_t output_count = static_cast<int64_t>(work.end - work.start);
+
+          // Prepare the im2col transformation or use the input buffer directly for
+          // pointwise convolutions.
+          uint8_t* worker_gemm_input;
+          if (col_buffer_data != nullptr) {
+            worker_gemm_input = col_buffer_data + output_start * kernel_dim;
+            math::Im2col<uint8_t, StorageOrder::NHWC>()(
+                transpose_input,
+                group_input_channels,
+                input_shape[0],
+                input_shape[1],
+                kernel_shape[0],
+                kernel_shape[1],
+                dilations[0],
+                dilations[1],
+                pads[0],
+                pads[1],
+                strides[0],
+                strides[1],
+                output_shape[1],
+                output_start,
+                output_count,
+                worker_gemm_input,
+                X_zero_point_value);
+          } else {
+            worker_gemm_input = transpose_input + output_start * kernel_dim;
+          }
+
+          auto* worker_gemm_output = gemm_output + output_start * group_output_channels;
+          auto* worker_transpose_output = transpose_output + output_start * group_output_channels;
+
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+          if (packed_W_buffer_) {
+            MlasGemm(static_cast<size_t>(output_count),
+                     static_cast<size_t>(group_output_channels),
+                     static_cast<size_t>(kernel_dim),
+                     worker_gemm_input,
+                     static_cast<size_t>(kernel_dim),
+                     X_zero_point_value,
+                     static_cast<const uint8_t*>(packed_W_buffer_.get()) + group_id * packed_W_size_,
+                     gemm_W_zero_point,
+                     std::is_signed<T>::value,
+                     worker_gemm_output,
+                     static_cast<size_t>(group_output_channels),
+                     nullptr);
+          } else
+#endif
+          {
+            MlasGemm(static_cast<size_t>(output_count),
+                     static_cast<size_t>(group_output_channels),
+                     static_cast<size_t>(kernel_dim),
+                     worker_gemm_input,
+                     static_cast<size_t>(kernel_dim),
+                     X_zero_point_value,
+                     reordered_W + group_id * group_output_channels,
+                     static_cast<size_t>(M),
+                     gemm_W_zero_point,
+                     std::is_signed<T>::value,
+                     worker_gemm_output,
+                     static_cast<size_t>(group_output_channels),
+                     nullptr);
+          }
+
+          if (!is_W_zero_point_uniform) {
+            QGemmApplyColumnOffsets(static_cast<int>(output_count),
+                                    static_cast<int>(group_output_channels),
+                                    static_cast<int>(kernel_dim),
+                                    worker_gemm_input,
+                                    static_cast<int>(kernel_dim),
+                                    X_zero_point_value,
+                                    W_zero_point_data + group_id * group_output_channels,
+                                    std::is_signed<T>::value,
+                                    worker_gemm_output,
+                                    static_cast<int>(group_output_channels));
+          }
+
+          // Requantize the block of output pixels produced by this worker while
+          // the GEMM output is still in cache.
+          if (output_scales.size() == 1) {
+            MlasRequantizeOutputColumn(worker_gemm_output,
+                                       worker_transpose_output,
+                                       Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr,
+                                       static_cast<size_t>(output_count),
+                                       static_cast<size_t>(group_output_channels),
+                                       output_scales[0],
+                                       Y_zero_point_value);
+          } else {
+            MlasRequantizeOutputColumn(worker_gemm_output,
+                                       worker_transpose_output,
+                                       Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr,
+                                       static_cast<size_t>(output_count),
+                                       static_cast<size_t>(group_output_channels),
+                                       output_scales.data() + group_id * group_output_channels,
+                                       Y_zero_point_value);
+          }
+        };
+
+        concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, thread_count, conv_worker);
+
+        // Transpose the output from channels last (NHWC) to channels first (NCHW).
+        MlasTranspose(transpose_output,
+                      Ydata,
+                      static_cast<size_t>(output_image_size),
+                      static_cast<size_t>(group_output_channels));
+
+        Xdata += X_offset;
+        Ydata += Y_offset;
+      }
+    }
+
+    return Status::OK();
   }
+#endif
+
+  // The remaining convolutions are computed per group with the filter as the
+  // left hand side of the GEMM, which limits the filter to per tensor
+  // quantization.
+  if (!std::is_same<T, uint8_t>::value) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "QLinearConv : must be 2D convolution");
+  }
+  if (!is_W_zero_point_uniform || output_scales.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "QLinearConv : per-channel filter quantization is not supported for this convolution");
+  }
+
+  const float real_multiplier = output_scales[0];
+
+  BufferUniquePtr col_buffer;
+  std::vector<int64_t> col_buffer_shape;
 
   // Pointwise convolutions can use the original input tensor in place,
   // otherwise a temporary buffer is required for the im2col transform.
-  BufferUniquePtr col_buffer;
   if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
     auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * col_buffer_size);
     col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
-  }
-  auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
-  // Replicate the logic from MlasGemmU8X8Schedule to control the number of
-  // worker threads used for the convolution.
-  constexpr int32_t maximum_thread_count = 16;
-  constexpr double thread_complexity = static_cast<double>(64 * 1024);
+    if (kernel_rank != 2) {
+      const auto& output_dims = output_shape.GetDims();
+      col_buffer_shape.reserve(1 + output_dims.size());
+      col_buffer_shape.push_back(kernel_dim);
+      col_buffer_shape.insert(col_buffer_shape.end(), output_dims.begin(), output_dims.end());
+    }
+  }
 
-  const double complexity = static_cast<double>(output_image_size) *
-                            static_cast<double>(group_output_channels) *
-                            static_cast<double>(kernel_dim);
+  auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
-  int32_t thread_count = maximum_thread_count;
-  if (complexity < thread_complexity * maximum_thread_count) {
-    thread_count = static_cast<int32_t>(complexity / thread_complexity) + 1;
-  }
-  if (thread_count > output_image_size) {
-    // Ensure that every thread produces at least one output.
-    thread_count = static_cast<int32_t>(output_image_size);
-  }
+#ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
+  // Use an intermediate int32_t buffer for the GEMM computation before
+  // requantizing to the output type.
+  auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * Y_offset);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+#else
+  // Compute the fixed point multiplier and shift for requantizing with GEMMLOWP.
+  int32_t integer_multiplier;
+  int right_shift;
+  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+#endif
 
-  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
-  thread_count = std::min(thread_count, concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+  const auto* Wdata = static_cast<const uint8_t*>(W->DataRaw());
+  const int64_t W_offset = W_shape.Size() / group_count;
 
   for (int64_t image_id = 0; image_id < N; ++image_id) {
     for (int64_t group_id = 0; group_id < group_count; ++group_id) {
-      // Transpose the input from channels first (NCHW) to channels last (NHWC).
-      MlasTranspose(Xdata,
-                    transpose_input,
-                    static_cast<size_t>(group_input_channels),
-                    static_cast<size_t>(input_image_size));
-
-      auto conv_worker = [&](ptrdiff_t batch) {
-        auto work = concurrency::ThreadPool::PartitionWork(batch, thread_count, static_cast<ptrdiff_t>(output_image_size));
-        int64_t output_start = static_cast<int64_t>(work.start);
-        int64_t output_count = static_cast<int64_t>(work.end - work.start);
-
-        // Prepare the im2col transformation or use the input buffer directly for
-        // pointwise convolutions.
-        uint8_t* worker_gemm_input;
-        if (col_buffer_data != nullptr) {
-          worker_gemm_input = col_buffer_data + output_start * kernel_dim;
-          math::Im2col<uint8_t, StorageOrder::NHWC>()(
-              transpose_input,
+      if (col_buffer_data != nullptr) {
+        if (kernel_rank == 2) {
+          math::Im2col<uint8_t, StorageOrder::NCHW>()(
+              Xdata,
               group_input_channels,
               input_shape[0],
               input_shape[1],
@@ -582,78 +630,66 @@ Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
               dilations[1],
               pads[0],
               pads[1],
+              pads[2],
+              pads[3],
               strides[0],
               strides[1],
-              output_shape[1],
-              output_start,
-              output_count,
-              worker_gemm_input,
+              col_buffer_data,
               X_zero_point_value);
         } else {
-          worker_gemm_input = transpose_input + output_start * kernel_dim;
+          math::Im2colNd<uint8_t, StorageOrder::NCHW>()(
+              Xdata,
+              X->Shape().GetDims().data() + 1,
+              col_buffer_shape.data(),
+              C * input_image_size,
+              col_buffer_size,
+              kernel_shape.data(),
+              strides.data(),
+              dilations.data(),
+              pads.data(),
+              static_cast<int>(kernel_rank),
+              col_buffer_data,
+              false,
+              X_zero_point_value);
         }
+      }
 
-        auto* worker_gemm_output = gemm_output + output_start * group_output_channels;
-        auto* worker_transpose_output = transpose_output + output_start * group_output_channels;
+#ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
+      QGemm(static_cast<int>(group_output_channels),
+            static_cast<int>(output_image_size),
+            static_cast<int>(kernel_dim),
+            Wdata + group_id * W_offset,
+            static_cast<int>(kernel_dim),
+            W_zero_point_value,
+            col_buffer_data == nullptr ? Xdata : col_buffer_data,
+            static_cast<int>(output_image_size),
+            X_zero_point_value,
+            false,
+            gemm_output,
+            static_cast<int>(output_image_size),
+            context->GetOperatorThreadPool());
 
-#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-        if (packed_W_buffer_) {
-          MlasGemm(static_cast<size_t>(output_count),
-                   static_cast<size_t>(group_output_channels),
-                   static_cast<size_t>(kernel_dim),
-                   worker_gemm_input,
-                   static_cast<size_t>(kernel_dim),
-                   X_zero_point_value,
-                   static_cast<const int8_t*>(packed_W_buffer_.get()) + group_id * packed_W_size_,
-                   0,
-                   true,
-                   worker_gemm_output,
-                   static_cast<size_t>(group_output_channels),
-                   nullptr);
-        } else
+      MlasRequantizeOutput(gemm_output,
+                           Ydata,
+                           Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr,
+                           static_cast<size_t>(group_output_channels),
+                           static_cast<size_t>(output_image_size),
+                           real_multiplier,
+                           Y_zero_point_value);
+#else
+      GemmlowpMultiplyu8u8_u8(Wdata + group_id * W_offset,
+                              col_buffer_data == nullptr ? Xdata : col_buffer_data,
+                              Ydata,
+                              W_zero_point_value,
+                              X_zero_point_value,
+                              Y_zero_point_value,
+                              static_cast<int>(group_output_channels),
+                              static_cast<int>(output_image_size),
+                              static_cast<int>(kernel_dim),
+                              integer_multiplier,
+                              right_shift,
+                              Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr);
 #endif
-        {
-          MlasGemm(static_cast<size_t>(output_count),
-                   static_cast<size_t>(group_output_channels),
-                   static_cast<size_t>(kernel_dim),
-                   worker_gemm_input,
-                   static_cast<size_t>(kernel_dim),
-                   X_zero_point_value,
-                   reordered_W + group_id * group_output_channels,
-                   static_cast<size_t>(M),
-                   0,
-                   true,
-                   worker_gemm_output,
-                   static_cast<size_t>(group_output_channels),
-                   nullptr);
-        }
-
-        if (output_scales.size() == 1) {
-          MlasRequantizeOutputColumn(worker_gemm_output,
-                                     worker_transpose_output,
-                                     Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr,
-                                     static_cast<size_t>(output_count),
-                                     static_cast<size_t>(group_output_channels),
-                                     output_scales[0],
-                                     Y_zero_point_value);
-        } else {
-          MlasRequantizeOutputColumn(worker_gemm_output,
-                                     worker_transpose_output,
-                                     Bdata != nullptr ? Bdata + group_id * group_output_channels : nullptr,
-                                     static_cast<size_t>(output_count),
-                                     static_cast<size_t>(group_output_channels),
-                                     output_scales.data() + group_id * group_output_channels,
-                                     Y_zero_point_value);
-        }
-      };
-
-      concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, thread_count, conv_worker);
-
-      // Transpose the output from channels last (NHWC) to channels first (NCHW).
-      MlasTranspose(transpose_output,
-                    Ydata,
-                    static_cast<size_t>(output_image_size),
-                    static_cast<size_t>(group_output_channels));
 
       Xdata += X_offset;
       Ydata += Y_offset;
@@ -663,6 +699,4 @@ Status QLinearConv<int8_t>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
-#endif
-
 }  // namespace onnxruntime
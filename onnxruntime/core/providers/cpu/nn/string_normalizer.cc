@@ -4,6 +4,7 @@
 #include "string_normalizer.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #include <codecvt>
@@ -15,6 +16,8 @@
 #include <iconv.h>
 #endif  // _MSC_VER
 
+#include <algorithm>
+#include <cstring>
 #include <locale>
 #include <functional>
 #include <unordered_set>
@@ -192,10 +195,58 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS
 
 #endif  // MS_VER
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      Utf8Converter& converter,
+// Whether all the characters of the string are ASCII, checking 8 bytes at a time
+bool IsAscii(const std::string& s) {
+  const char* p = s.data();
+  const char* const end = p + s.size();
+  for (; end - p >= 8; p += 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    if ((word & 0x8080808080808080ULL) != 0) {
+      return false;
+    }
+  }
+  for (; p != end; ++p) {
+    if ((static_cast<unsigned char>(*p) & 0x80) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ChangeAsciiCase(StringNormalizer::CaseAction caseaction, std::string& str) {
+  assert(caseaction != StringNormalizer::NONE);
+  const char first = (caseaction == StringNormalizer::LOWER) ? 'A' : 'a';
+  const char other_case = (caseaction == StringNormalizer::LOWER) ? 'a' - 'A' : 'A' - 'a';
+  for (auto& ch : str) {
+    if (static_cast<unsigned char>(ch - first) < 26) {
+      ch = static_cast<char>(ch + other_case);
+    }
+  }
+}
+
+// Converts the string and changes its case. Returns false if the string isn't valid utf8.
+bool ChangeCase(const Locale& loc, Utf8Converter& converter, bool ascii_case_fast_path,
+                StringNormalizer::CaseAction caseaction, const std::string& s, std::string& result) {
+  if (ascii_case_fast_path && IsAscii(s)) {
+    result = s;
+    ChangeAsciiCase(caseaction, result);
+    return true;
+  }
+
+  std::wstring wstr = converter.from_bytes(s);
+  if (wstr == wconv_error) {
+    return false;
+  }
+  // In place transform
+  loc.ChangeCase(caseaction, wstr);
+  result = converter.to_bytes(wstr);
+  return true;
+}
+
+template <class RandomAccessIter>
+Status CopyCaseAction(RandomAccessIter first, RandomAccessIter end, OpKernelContext* ctx,
+                      const Locale& loc, bool ascii_case_fast_path,
                       size_t N, size_t C,
                       StringNormalizer::CaseAction caseaction) {
   std::vector<int64_t> output_dims;
@@ -218,25 +269,45 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
-      }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
+  if (caseaction == StringNormalizer::NONE) {
+    size_t output_idx = 0;
+    while (first != end) {
       // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+      *(output_data + output_idx) = std::move(*first);
+      ++output_idx;
+      ++first;
+    }
+    return Status::OK();
+  }
+
+  assert(caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER);
+  size_t total_bytes = 0;
+  for (auto it = first; it != end; ++it) {
+    total_bytes += static_cast<const std::string&>(*it).size();
+  }
+  const double string_bytes = static_cast<double>(total_bytes) / static_cast<double>(C);
+
+  // the strings are converted independently of each other
+  std::vector<uint8_t> invalid(C, 0);
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(C),
+      TensorOpCost{string_bytes, string_bytes, string_bytes * 16},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t last) {
+        // the converter may keep a conversion state
+        Utf8Converter converter(conv_error, wconv_error);
+        for (std::ptrdiff_t i = begin; i < last; ++i) {
+          const std::string& s = first[i];
+          if (!ChangeCase(loc, converter, ascii_case_fast_path, caseaction, s, output_data[i])) {
+            invalid[i] = 1;
+          }
+        }
+      });
+
+  for (size_t i = 0; i < C; ++i) {
+    if (invalid[i] != 0) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                    "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(first[i]));
     }
-    ++output_idx;
-    ++first;
   }
   return Status::OK();
 }
@@ -247,7 +318,8 @@ using namespace string_normalizer;
 StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
                                                                is_case_sensitive_(true),
                                                                case_change_action_(NONE),
-                                                               compare_caseaction_(NONE) {
+                                                               compare_caseaction_(NONE),
+                                                               ascii_case_fast_path_(false) {
   int64_t iscasesensitive = 0;
   Status status = info.GetAttr("is_case_sensitive", &iscasesensitive);
   ORT_ENFORCE(status.IsOK(), "attribute is_case_sensitive is not set");
@@ -271,10 +343,23 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  locale_ = onnxruntime::make_unique<Locale>(info.GetAttrOrDefault("locale", default_locale));
   Utf8Converter converter(conv_error, wconv_error);
 
+  // some locales change the case of ASCII letters differently, e.g. the Turkish i
+  ascii_case_fast_path_ = true;
+  for (auto caseaction : {LOWER, UPPER}) {
+    std::string ascii(128, '\0');
+    std::wstring wascii(128, L'\0');
+    for (int ch = 0; ch < 128; ++ch) {
+      ascii[ch] = static_cast<char>(ch);
+      wascii[ch] = static_cast<wchar_t>(ch);
+    }
+    ChangeAsciiCase(caseaction, ascii);
+    locale_->ChangeCase(caseaction, wascii);
+    ascii_case_fast_path_ = ascii_case_fast_path_ && std::equal(ascii.cbegin(), ascii.cend(), wascii.cbegin());
+  }
+
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
   for (const auto& sw : swords) {
     ORT_ENFORCE(!sw.empty(), "Empty stopwords not allowed");
@@ -284,13 +369,15 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     } else {
       std::wstring wstr = converter.from_bytes(sw);
       ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
+      locale_->ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(wstr);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
   }
 }
 
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -319,8 +406,7 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   }
 
   Status status;
-  Locale locale(locale_name_);
-  Utf8Converter converter(conv_error, wconv_error);
+  const Locale& locale = *locale_;
   auto const input_data = X->template Data<std::string>();
   using StrRef = std::reference_wrapper<const std::string>;
   if (is_case_sensitive_) {
@@ -336,50 +422,63 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
         }
         ++first;
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
+      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, ascii_case_fast_path_,
                               N, filtered_strings.size(), case_change_action_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, ascii_case_fast_path_, N, C,
+                              case_change_action_);
     }
   } else {
     if (!wstopwords_.empty()) {
       // Filter input. When no case action is required
       // we simply store original string references.
       // Otherwise, we store converted strings.
+      Utf8Converter converter(conv_error, wconv_error);
       std::vector<StrRef> filtered_orignal_strings;
       std::vector<std::string> filtered_cased_strings;
       filtered_orignal_strings.reserve(C);
       filtered_cased_strings.reserve(C);
+      std::string cased;
       auto first = input_data;
       auto const last = input_data + C;
       while (first != last) {
         const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
+        std::wstring wstr;
+        if (ascii_case_fast_path_ && IsAscii(s)) {
+          // ASCII characters have the same code points as wide characters
+          cased = s;
+          ChangeAsciiCase(compare_caseaction_, cased);
+          wstr.assign(cased.cbegin(), cased.cend());
+        } else {
+          wstr = converter.from_bytes(s);
+          if (wstr == wconv_error) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Input contains invalid utf8 chars at: " + s);
+          }
+          locale.ChangeCase(compare_caseaction_, wstr);
+          cased.clear();
         }
-        locale.ChangeCase(compare_caseaction_, wstr);
         if (0 == wstopwords_.count(wstr)) {
           if (case_change_action_ == NONE) {
             filtered_orignal_strings.push_back(std::cref(s));
           } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            filtered_cased_strings.push_back(cased.empty() ? converter.to_bytes(wstr) : cased);
           }
         }
         ++first;
       }
       if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
+        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale,
+                                ascii_case_fast_path_, N, filtered_orignal_strings.size(), NONE);
       } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale,
+                                ascii_case_fast_path_, N, filtered_cased_strings.size(), NONE);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, ascii_case_fast_path_, N, C,
+                              case_change_action_);
     }
   }
   return status;
@@ -5,8 +5,10 @@
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
+#include "core/providers/cpu/ml/static_hash_map.h"
 
-#include <functional>
+#include <algorithm>
+#include <limits>
 #include <unordered_map>
 
 namespace onnxruntime {
@@ -23,63 +25,15 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
+// The n-grams of the pool are stored in a flattened trie over token ids, the indexes of the distinct pool items.
+// Node 0 is the root, the children of the root are found by token id in root_children_ and the children of the
+// other nodes in a hash map from (node, token id) pairs. A node of an n-gram of the pool has its ngram id,
+// for (1,2,3) node 2 would be a child of 1 but have id == 0 because (1,2) does not exist. Node 3 would have a
+// valid id.
+constexpr uint32_t kNoToken = std::numeric_limits<uint32_t>::max();
 
-template <>
-struct NgramPart<int64_t>;
-
-template <>
-struct NgramPart<std::string>;
-
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
-
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = std::unordered_map<int64_t, std::unique_ptr<NgramPartInt>>;
-
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
-
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
-
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
-
-// Returns next ngram_id
-template <class K, class ForwardIter, class Map>
-inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
-  for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, onnxruntime::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
-    }
-  }
-  return ngram_id;
+inline uint64_t EdgeKey(uint32_t node, uint32_t token) {
+  return (static_cast<uint64_t>(node) << 32) | token;
 }
 
 }  // namespace ngram_details
@@ -89,10 +43,6 @@ using namespace onnxruntime::ngram_details;
 
 namespace onnxruntime {
 
-inline const void* AdvanceElementPtr(const void* p, size_t elements, size_t element_size) {
-  return reinterpret_cast<const uint8_t*>(p) + elements * element_size;
-}
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -127,12 +77,17 @@ struct TfIdfVectorizer::Impl {
   std::vector<int64_t> ngram_indexes_;
   std::vector<float> weights_;
 
-  std::vector<std::string> pool_strings_;
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // true if the pool is pool_strings, false for pool_int64s
+  bool pool_strings_ = false;
+  // Token ids of the items of the pool
+  ml::StaticHashMap<std::string, uint32_t> str_tokens_;
+  ml::StaticHashMap<int64_t, uint32_t> int64_tokens_;
+
+  // The trie of the n-grams, see ngram_details
+  std::vector<uint32_t> root_children_;
+  ml::StaticHashMap<uint64_t, uint32_t> children_;
+  // ngram id of each node, 0 - means no n-gram ends at the node
+  std::vector<size_t> node_ngram_ids_;
 
   size_t output_size_ = 0;
 
@@ -141,14 +96,45 @@ struct TfIdfVectorizer::Impl {
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
-  void IncrementCount(size_t ngram_id, size_t row_num,
-                      std::vector<uint32_t>& frequencies) const {
-    assert(ngram_id != 0);
-    --ngram_id;
-    assert(ngram_id < ngram_indexes_.size());
-    auto output_idx = row_num * output_size_ + ngram_indexes_[ngram_id];
-    assert(static_cast<size_t>(output_idx) < frequencies.size());
-    ++frequencies[output_idx];
+  bool Empty() const { return root_children_.empty(); }
+
+  uint32_t Child(uint32_t node, uint32_t token) const {
+    if (node == 0) {
+      return root_children_[token];
+    }
+    const uint32_t* child = children_.Find(EdgeKey(node, token));
+    return child == nullptr ? 0 : *child;
+  }
+
+  // Inserts ngrams n-grams of ngram_size tokens each starting at first. Returns next ngram_id
+  size_t PopulateGrams(std::vector<uint32_t>::const_iterator first, size_t ngrams, size_t ngram_size, size_t ngram_id,
+                       std::unordered_map<uint64_t, uint32_t>& children) {
+    for (; ngrams > 0; --ngrams) {
+      uint32_t node = 0;
+      for (size_t n = 1; n <= ngram_size; ++n, ++first) {
+        uint32_t child = 0;
+        if (node == 0) {
+          child = root_children_[*first];
+        } else {
+          auto hit = children.find(EdgeKey(node, *first));
+          child = hit == children.end() ? 0 : hit->second;
+        }
+        if (child == 0) {
+          child = static_cast<uint32_t>(node_ngram_ids_.size());
+          node_ngram_ids_.push_back(0);
+          if (node == 0) {
+            root_children_[*first] = child;
+          } else {
+            children.emplace(EdgeKey(node, *first), child);
+          }
+        }
+        node = child;
+      }
+      ORT_ENFORCE(node_ngram_ids_[node] == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+      node_ngram_ids_[node] = ngram_id;
+      ++ngram_id;
+    }
+    return ngram_id;
   }
 };
 
@@ -208,17 +194,54 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
                 " must be of equal size");
   }
 
+  std::vector<std::string> pool_strings;
   std::vector<int64_t> pool_int64s;
-  status = info.GetAttrs("pool_strings", impl_->pool_strings_);
+  status = info.GetAttrs("pool_strings", pool_strings);
   if (status.IsOK()) {
-    ORT_ENFORCE(!impl_->pool_strings_.empty(), "pool_strings must not be empty if specified");
+    ORT_ENFORCE(!pool_strings.empty(), "pool_strings must not be empty if specified");
+    impl_->pool_strings_ = true;
   } else {
     status = info.GetAttrs("pool_int64s", pool_int64s);
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
   }
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
-  const auto total_items = (impl_->pool_strings_.empty()) ? pool_int64s.size() : impl_->pool_strings_.size();
+  const auto total_items = impl_->pool_strings_ ? pool_strings.size() : pool_int64s.size();
+
+  // Number the distinct items of the pool
+  std::vector<uint32_t> pool_tokens(total_items);
+  uint32_t num_tokens = 0;
+  if (impl_->pool_strings_) {
+    std::unordered_map<std::string, uint32_t> tokens;
+    for (size_t i = 0; i < total_items; ++i) {
+      pool_tokens[i] = tokens.emplace(pool_strings[i], num_tokens).first->second;
+      num_tokens = static_cast<uint32_t>(tokens.size());
+    }
+    std::vector<std::string> keys;
+    std::vector<uint32_t> values;
+    for (const auto& token : tokens) {
+      keys.push_back(token.first);
+      values.push_back(token.second);
+    }
+    impl_->str_tokens_.Build(keys, values);
+  } else {
+    std::unordered_map<int64_t, uint32_t> tokens;
+    for (size_t i = 0; i < total_items; ++i) {
+      pool_tokens[i] = tokens.emplace(pool_int64s[i], num_tokens).first->second;
+      num_tokens = static_cast<uint32_t>(tokens.size());
+    }
+    std::vector<int64_t> keys;
+    std::vector<uint32_t> values;
+    for (const auto& token : tokens) {
+      keys.push_back(token.first);
+      values.push_back(token.second);
+    }
+    impl_->int64_tokens_.Build(keys, values);
+  }
+
+  std::unordered_map<uint64_t, uint32_t> children;
+  impl_->root_children_.assign(num_tokens, 0);
+  impl_->node_ngram_ids_.assign(1, 0);  // the root
   size_t ngram_id = 1;  // start with 1, 0 - means no n-gram
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = impl_->min_gram_length_;
@@ -234,144 +257,98 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       ORT_ENFORCE((items % ngram_size == 0),
                   "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
       auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
+      // Skip loading into the trie ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (impl_->pool_strings_.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
-        } else {
-          ngram_id = PopulateGrams<std::string>(impl_->pool_strings_.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
-        }
+        ngram_id = impl_->PopulateGrams(pool_tokens.cbegin() + start_idx, ngrams, ngram_size, ngram_id, children);
       } else {
         ngram_id += ngrams;
       }
     }
     ++ngram_size;
   }
-}
+  ORT_ENFORCE(impl_->node_ngram_ids_.size() < std::numeric_limits<uint32_t>::max(), "Too many n-grams");
 
-TfIdfVectorizer::~TfIdfVectorizer() = default;
-
-void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::vector<uint32_t>& frequences) const {
-  const Impl& impl = *impl_;
-  std::vector<int64_t> output_dims;
-  if (B == 0) {
-    output_dims.push_back(impl.output_size_);
-    B = 1;  // For use in the loops below
+  if (impl_->node_ngram_ids_.size() == 1) {
+    // no n-gram of the required sizes
+    impl_->root_children_.clear();
   } else {
-    output_dims.push_back(B);
-    output_dims.push_back(impl.output_size_);
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> values;
+    keys.reserve(children.size());
+    values.reserve(children.size());
+    for (const auto& child : children) {
+      keys.push_back(child.first);
+      values.push_back(child.second);
+    }
+    impl_->children_.Build(keys, values);
   }
+}
 
-  const auto row_size = impl.output_size_;
+TfIdfVectorizer::~TfIdfVectorizer() = default;
 
-  TensorShape output_shape(output_dims);
-  assert(frequences.size() == static_cast<size_t>(output_shape.Size()));
+void TfIdfVectorizer::ComputeImpl(const Tensor& X, ptrdiff_t row_num, size_t row_size, float* output_row,
+                                  std::vector<uint32_t>& tokens, std::vector<int64_t>& hits) const {
+  const auto& impl = *impl_;
 
-  auto Y = ctx->Output(0, output_shape);
-  auto output_data = Y->MutableData<float>();
-  const auto& w = impl.weights_;
-  switch (impl.weighting_criteria_) {
-    case kTF: {
-      for (auto f : frequences) {
-        *output_data++ = static_cast<float>(f);
-      }
-    } break;
-    case kIDF: {
-      if (!w.empty()) {
-        const auto* freqs = frequences.data();
-        for (size_t batch = 0; batch < B; ++batch) {
-          for (size_t i = 0; i < row_size; ++i) {
-            *output_data++ = (*freqs++ > 0) ? w[i] : 0;
-          }
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = (f > 0) ? 1.0f : 0;
-        }
-      }
-    } break;
-    case kTFIDF: {
-      if (!w.empty()) {
-        const auto* freqs = frequences.data();
-        for (size_t batch = 0; batch < B; ++batch) {
-          for (size_t i = 0; i < row_size; ++i) {
-            *output_data++ = *freqs++ * w[i];
-          }
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = static_cast<float>(f);
-        }
-      }
-    } break;
-    case kNone:  // fall-through
-    default:
-      assert(false);
+  // Look up the token ids of the row once, instead of for every n-gram that contains them
+  tokens.resize(row_size);
+  const size_t row_offset = row_num * row_size;
+  if (X.IsDataTypeString()) {
+    const std::string* row = X.Data<std::string>() + row_offset;
+    for (size_t i = 0; i < row_size; ++i) {
+      const uint32_t* token = impl.str_tokens_.Find(row[i]);
+      tokens[i] = token == nullptr ? kNoToken : *token;
+    }
+  } else if (X.IsDataType<int32_t>()) {
+    const int32_t* row = X.Data<int32_t>() + row_offset;
+    for (size_t i = 0; i < row_size; ++i) {
+      const uint32_t* token = impl.int64_tokens_.Find(int64_t{row[i]});
+      tokens[i] = token == nullptr ? kNoToken : *token;
+    }
+  } else {
+    const int64_t* row = X.Data<int64_t>() + row_offset;
+    for (size_t i = 0; i < row_size; ++i) {
+      const uint32_t* token = impl.int64_tokens_.Find(row[i]);
+      tokens[i] = token == nullptr ? kNoToken : *token;
+    }
   }
-}
 
-void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
-                                  std::vector<uint32_t>& frequencies) const {
-  auto X = ctx->Input<Tensor>(0);
-  const auto elem_size = X->DataType()->Size();
-
-  const void* row_begin = AdvanceElementPtr(X->DataRaw(), row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
-
-  const auto& impl = *impl_;
+  // The counts are accumulated in the output row, and the output indexes of the n-grams found are kept
+  // to apply the weighting criteria to them only, as most of the counts are usually zero.
+  hits.clear();
+  const int64_t row_length = static_cast<int64_t>(row_size);
   const auto max_gram_length = impl.max_gram_length_;
   const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
   auto start_ngram_size = impl.min_gram_length_;
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
-
-    while (ngram_start < ngram_row_end) {
+  for (int64_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+    for (int64_t ngram_start = 0; ngram_start < row_length; ++ngram_start) {
       // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, skip_distance * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
+      if (ngram_start + skip_distance * (start_ngram_size - 1) >= row_length) {
         break;
       }
 
-      auto ngram_item = ngram_start;
-      if (X->IsDataTypeString()) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          str_map = &hit->second->leafs_;
+      uint32_t node = 0;
+      for (int64_t ngram_size = 1, item = ngram_start;
+           ngram_size <= max_gram_length && item < row_length;
+           ++ngram_size, item += skip_distance) {
+        if (tokens[item] == kNoToken) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (X->IsDataType<int32_t>()) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
+        node = impl.Child(node, tokens[item]);
+        if (node == 0) {
+          break;
+        }
+        const size_t ngram_id = impl.node_ngram_ids_[node];
+        if (ngram_size >= start_ngram_size && ngram_id != 0) {
+          assert(ngram_id - 1 < impl.ngram_indexes_.size());
+          const int64_t output_idx = impl.ngram_indexes_[ngram_id - 1];
+          if (output_row[output_idx] == 0) {
+            hits.push_back(output_idx);
           }
-          int_map = &hit->second->leafs_;
+          output_row[output_idx] += 1;
         }
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -379,6 +356,28 @@ void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_
       break;
     }
   }
+
+  // Apply weighing criteria
+  const auto& w = impl.weights_;
+  switch (impl.weighting_criteria_) {
+    case kTF:
+      break;
+    case kIDF: {
+      for (auto i : hits) {
+        output_row[i] = w.empty() ? 1.0f : w[i];
+      }
+    } break;
+    case kTFIDF: {
+      if (!w.empty()) {
+        for (auto i : hits) {
+          output_row[i] *= w[i];
+        }
+      }
+    } break;
+    case kNone:  // fall-through
+    default:
+      assert(false);
+  }
 }
 
 Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
@@ -411,30 +410,41 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   }
 
   assert((num_rows * C) == total_items);
-  // Frequency holder allocate [B..output_size_]
-  // and init all to zero
-  std::vector<uint32_t> frequencies;
-  frequencies.resize(num_rows * impl_->output_size_, 0);
-
-  if (total_items == 0 ||
-      (X->IsDataTypeString() && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+  const auto& impl = *impl_;
+  std::vector<int64_t> output_dims;
+  if (B == 0) {
+    output_dims.push_back(impl.output_size_);
+  } else {
+    output_dims.push_back(B);
+    output_dims.push_back(impl.output_size_);
+  }
+  auto Y = ctx->Output(0, TensorShape(output_dims));
+  auto output_data = Y->MutableData<float>();
+  std::fill_n(output_data, num_rows * impl.output_size_, 0.0f);
+
+  if (total_items == 0 || impl.Empty() || X->IsDataTypeString() != impl.pool_strings_) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
     // {b_dim, output_size} when b_dim is the number of received observations
     // and output_size the is the maximum value in ngram_indexes attribute plus 1.
-    OutputResult(ctx, B, frequencies);
     return Status::OK();
   }
 
-  std::function<void(ptrdiff_t)> fn = [this, ctx, C, &frequencies](ptrdiff_t row_num) {
-    ComputeImpl(ctx, row_num, C, frequencies);
-  };
-
-  concurrency::ThreadPool::TryBatchParallelFor(ctx->GetOperatorThreadPool(), num_rows, std::move(fn), 0);
-
-  OutputResult(ctx, B, frequencies);
+  // every item starts a lookup of up to max_gram_length trie edges for each skip distance
+  const double row_cost = static_cast<double>(C) * static_cast<double>(impl.max_gram_length_) *
+                          static_cast<double>(impl.max_skip_count_ + 1) * 16.0;
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), num_rows,
+      TensorOpCost{static_cast<double>(C * X->DataType()->Size()),
+                   static_cast<double>(impl.output_size_ * sizeof(float)), row_cost},
+      [this, X, C, output_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<uint32_t> tokens;
+        std::vector<int64_t> hits;
+        for (std::ptrdiff_t row_num = first; row_num < last; ++row_num) {
+          ComputeImpl(*X, row_num, C, output_data + row_num * impl_->output_size_, tokens, hits);
+        }
+      });
 
   return Status::OK();
 }
@@ -19,12 +19,10 @@ class TfIdfVectorizer final : public OpKernel {
   Status Compute(OpKernelContext* ctx) const override;
 
  private:
-
-  void ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
-                     std::vector<uint32_t>& frequencies) const;
-
-  // Apply weighing criteria and output
-  void OutputResult(OpKernelContext* ctx, size_t b_dim, const std::vector<uint32_t>& frequences) const;
+  // Counts the n-grams of a row into its zero initialized output and applies the weighing criteria.
+  // tokens and hits are scratch buffers reused between rows.
+  void ComputeImpl(const Tensor& X, ptrdiff_t row_num, size_t row_size, float* output_row,
+                   std::vector<uint32_t>& tokens, std::vector<int64_t>& hits) const;
 
   struct Impl;
   std::unique_ptr<Impl> impl_;
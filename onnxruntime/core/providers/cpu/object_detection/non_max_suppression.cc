@@ -13,6 +13,7 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
+#include "core/platform/threadpool.h"
 #include <queue>
 #include <utility>
 
@@ -158,74 +159,140 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
     inline bool operator<(const BoxInfo& rhs) const {
       return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
     }
+  };
 
-    inline bool SuppressByIOU(const BoxInfo& rhs, float iou_threshold) const {
-      const float intersection_x_min = std::max(box_[1], rhs.box_[1]);
-      const float intersection_y_min = std::max(box_[0], rhs.box_[0]);
-      const float intersection_x_max = std::min(box_[3], rhs.box_[3]);
-      const float intersection_y_max = std::min(box_[2], rhs.box_[2]);
+  // The boxes already selected for a class, stored as structure of arrays so that testing a candidate
+  // against them is a straight-line loop over contiguous floats the compiler can vectorize.
+  // The kept set is scanned in blocks so a suppressed candidate still stops early.
+  class SelectedBoxes {
+   public:
+    void Reserve(size_t n) {
+      y_min_.reserve(n);
+      x_min_.reserve(n);
+      y_max_.reserve(n);
+      x_max_.reserve(n);
+      area_.reserve(n);
+    }
 
-      const float intersection_area = std::max(intersection_x_max - intersection_x_min, .0f) *
-                                      std::max(intersection_y_max - intersection_y_min, .0f);
-      if (intersection_area <= .0f) {
-        return false;
-      }
-      const float union_area = area_ + rhs.area_ - intersection_area;
-      const float intersection_over_union = intersection_area / union_area;
-      return intersection_over_union > iou_threshold;
+    void Clear() {
+      y_min_.clear();
+      x_min_.clear();
+      y_max_.clear();
+      x_max_.clear();
+      area_.clear();
     }
-  };
 
-  const auto center_point_box = GetCenterPointBox();
+    size_t Size() const { return area_.size(); }
 
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfo> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min(max_output_boxes_per_class, pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfo> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index, center_point_box, batch_boxes + (box_index * 4));
-          }
+    void Add(const BoxInfo& box) {
+      y_min_.push_back(box.box_[0]);
+      x_min_.push_back(box.box_[1]);
+      y_max_.push_back(box.box_[2]);
+      x_max_.push_back(box.box_[3]);
+      area_.push_back(box.area_);
+    }
+
+    // Returns true if the IOU (Intersection Over Union) of 'box' with any selected box exceeds iou_threshold
+    bool Suppresses(const BoxInfo& box, float iou_threshold) const {
+      constexpr size_t block_size = 8;
+      const size_t num_selected = Size();
+      for (size_t block_start = 0; block_start < num_selected; block_start += block_size) {
+        const size_t block_end = std::min(num_selected, block_start + block_size);
+        bool suppressed = false;
+        for (size_t i = block_start; i < block_end; ++i) {
+          const float intersection_x_min = std::max(x_min_[i], box.box_[1]);
+          const float intersection_y_min = std::max(y_min_[i], box.box_[0]);
+          const float intersection_x_max = std::min(x_max_[i], box.box_[3]);
+          const float intersection_y_max = std::min(y_max_[i], box.box_[2]);
+
+          const float intersection_area = std::max(intersection_x_max - intersection_x_min, .0f) *
+                                          std::max(intersection_y_max - intersection_y_min, .0f);
+          const float union_area = area_[i] + box.area_ - intersection_area;
+          // lanes without intersection are masked out, so their quotient is never used
+          suppressed |= (intersection_area > .0f) & (intersection_area / union_area > iou_threshold);
         }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index, center_point_box, batch_boxes + (box_index * 4));
+        if (suppressed) {
+          return true;
         }
       }
-      std::priority_queue<BoxInfo, std::vector<BoxInfo>> sorted_boxes(std::less<BoxInfo>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfo& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (next_top_score.SuppressByIOU(selected_index, iou_threshold)) {
-            selected = false;
-            break;
+      return false;
+    }
+
+   private:
+    std::vector<float> y_min_;
+    std::vector<float> x_min_;
+    std::vector<float> y_max_;
+    std::vector<float> x_max_;
+    std::vector<float> area_;
+  };
+
+  const auto center_point_box = GetCenterPointBox();
+  const bool has_score_threshold = pc.score_threshold_ != nullptr;
+
+  // Every (batch, class) pair is independent. Each writes its selections to its own slot and the slots are
+  // concatenated in (batch, class) order afterwards, so the output is identical to a serial run.
+  const int64_t num_pairs = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<SelectedIndex>> selected_indices_per_pair(num_pairs);
+  const TensorOpCost cost{static_cast<double>(pc.num_boxes_ * (4 + 1) * sizeof(float)),
+                          static_cast<double>(std::min(max_output_boxes_per_class, pc.num_boxes_) * sizeof(SelectedIndex)),
+                          static_cast<double>(pc.num_boxes_ * 32)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_pairs), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        SelectedBoxes selected_boxes_inside_class;
+        selected_boxes_inside_class.Reserve(static_cast<size_t>(std::min(max_output_boxes_per_class, pc.num_boxes_)));
+        std::vector<BoxInfo> candidate_boxes;
+
+        for (std::ptrdiff_t pair = first; pair < last; ++pair) {
+          const int64_t batch_index = pair / pc.num_classes_;
+          const int64_t class_index = pair % pc.num_classes_;
+          int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
+          const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
+          candidate_boxes.clear();
+          candidate_boxes.reserve(pc.num_boxes_);
+
+          // Filter by score_threshold_
+          const auto* class_scores = scores_data + box_score_offset;
+          if (has_score_threshold) {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
+              if (*class_scores > score_threshold) {
+                candidate_boxes.emplace_back(*class_scores, box_index, center_point_box, batch_boxes + (box_index * 4));
+              }
+            }
+          } else {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
+              candidate_boxes.emplace_back(*class_scores, box_index, center_point_box, batch_boxes + (box_index * 4));
+            }
           }
-        }
+          std::priority_queue<BoxInfo, std::vector<BoxInfo>> sorted_boxes(std::less<BoxInfo>(), std::move(candidate_boxes));
+
+          auto& selected_indices = selected_indices_per_pair[pair];
+          selected_boxes_inside_class.Clear();
+          // Get the next box with top score, filter by iou_threshold
+          while (!sorted_boxes.empty() &&
+                 static_cast<int64_t>(selected_boxes_inside_class.Size()) < max_output_boxes_per_class) {
+            const BoxInfo& next_top_score = sorted_boxes.top();
+
+            // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
+            if (!selected_boxes_inside_class.Suppresses(next_top_score, iou_threshold)) {
+              selected_boxes_inside_class.Add(next_top_score);
+              selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+            }
+            sorted_boxes.pop();
+          }  //while
+        }    //for pair
+      });
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-        sorted_boxes.pop();
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+  std::vector<SelectedIndex> selected_indices;
+  size_t total_selected = 0;
+  for (const auto& pair_selected : selected_indices_per_pair) {
+    total_selected += pair_selected.size();
+  }
+  selected_indices.reserve(total_selected);
+  for (const auto& pair_selected : selected_indices_per_pair) {
+    selected_indices.insert(selected_indices.end(), pair_selected.begin(), pair_selected.end());
+  }
 
   const auto last_dim = 3;
   const auto num_selected = selected_indices.size();
@@ -240,6 +240,26 @@ bool SetupForReduce(const Tensor* input_tensor_ptr,
   }
   return need_copy;
 }
+void FuseReductionDims(const std::vector<int64_t>& input_dims,
+                       const std::vector<int64_t>& reduced_axes,
+                       std::vector<int64_t>& fused_dims,
+                       std::vector<bool>& fused_is_reduced) {
+  fused_dims.clear();
+  fused_is_reduced.clear();
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    if (input_dims[i] == 1) {
+      continue;
+    }
+    bool is_reduced = std::find(reduced_axes.begin(), reduced_axes.end(), static_cast<int64_t>(i)) != reduced_axes.end();
+    if (!fused_dims.empty() && fused_is_reduced.back() == is_reduced) {
+      fused_dims.back() *= input_dims[i];
+    } else {
+      fused_dims.push_back(input_dims[i]);
+      fused_is_reduced.push_back(is_reduced);
+    }
+  }
+}
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  const std::vector<int64_t>& reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results) {
@@ -337,6 +357,79 @@ void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
   }
 }
 
+// Number of kept values reduced together by a task of ReduceKRK.
+constexpr int64_t kReduceKRKBlockSize = 256;
+
+// Reduces a (K, R) input over its contiguous inner dim R. The kept values are split across the thread pool.
+template <typename T, typename AGG>
+void ReduceKR(const T* from_data, typename AGG::value_type* to_data, int64_t K, int64_t R,
+              concurrency::ThreadPool* tp) {
+  auto fn = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t k = first; k < last; ++k) {
+      const T* row = from_data + k * R;
+      to_data[k] = AGG(R, row[0]).aggall(row);
+    }
+  };
+
+  auto cost = TensorOpCost{static_cast<double>(R * sizeof(T)),
+                           static_cast<double>(sizeof(typename AGG::value_type)),
+                           static_cast<double>(R * (AGG::two_loops() ? 2 : 1))};
+  concurrency::ThreadPool::TryParallelFor(tp, K, cost, fn);
+}
+
+// Reduces a (K0, R, K1) input over its strided dim R. The reduction walks the input one row of K1 contiguous
+// values at a time rather than one strided column at a time. The K0 * K1 kept values are split in blocks of
+// kReduceKRKBlockSize across the thread pool.
+template <typename T, typename AGG>
+void ReduceKRK(const T* from_data, typename AGG::value_type* to_data, int64_t K0, int64_t R, int64_t K1,
+               concurrency::ThreadPool* tp) {
+  const int64_t num_blocks = (K1 + kReduceKRKBlockSize - 1) / kReduceKRKBlockSize;
+
+  auto fn = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<AGG> accumulators;
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t k0 = task / num_blocks;
+      const int64_t k1 = (task % num_blocks) * kReduceKRKBlockSize;
+      const int64_t size = std::min(kReduceKRKBlockSize, K1 - k1);
+      const T* block_data = from_data + k0 * R * K1 + k1;
+      typename AGG::value_type* block_output = to_data + k0 * K1 + k1;
+
+      if (AGG::fast_reduce_rk()) {
+        AGG::reduce_rk(block_data, block_output, R, K1, size);
+        continue;
+      }
+
+      accumulators.clear();
+      for (int64_t i = 0; i < size; ++i) {
+        accumulators.emplace_back(R, block_data[i]);
+      }
+      if (AGG::two_loops()) {
+        for (int64_t r = 0; r < R; ++r) {
+          const T* row = block_data + r * K1;
+          for (int64_t i = 0; i < size; ++i) {
+            accumulators[i].update0(row[i]);
+          }
+        }
+      }
+      for (int64_t r = 0; r < R; ++r) {
+        const T* row = block_data + r * K1;
+        for (int64_t i = 0; i < size; ++i) {
+          accumulators[i].update(row[i]);
+        }
+      }
+      for (int64_t i = 0; i < size; ++i) {
+        block_output[i] = accumulators[i].get_value();
+      }
+    }
+  };
+
+  const int64_t block_size = std::min(kReduceKRKBlockSize, K1);
+  auto cost = TensorOpCost{static_cast<double>(R * block_size * sizeof(T)),
+                           static_cast<double>(block_size * sizeof(typename AGG::value_type)),
+                           static_cast<double>(R * block_size * (AGG::two_loops() ? 2 : 1))};
+  concurrency::ThreadPool::TryParallelFor(tp, K0 * num_blocks, cost, fn);
+}
+
 template <typename T, typename AGG>
 void NoTransposeReduce(Tensor* output, const TensorShape& new_input_shape, const Tensor& input,
                        const std::vector<int64_t>& reduced_axes, concurrency::ThreadPool* tp,
@@ -353,8 +446,49 @@ void NoTransposeReduce(Tensor* output, const TensorShape& new_input_shape, const
     return;
   }
 
-  if (!last_results.equal(new_input_shape.GetDims(), reduced_axes)) {
-    NoTransposePrepareForReduce(new_input_shape, reduced_axes, last_results);
+  if (count == 0) {
+    return;
+  }
+
+  // Once the dims are fused, the common layouts are a contiguous reduction (KR), a strided one (RK or KRK), or
+  // a reduction of all the values (R). The others, such as RKR, go through the generic projected indices below.
+  std::vector<int64_t> fused_dims;
+  std::vector<bool> fused_is_reduced;
+  FuseReductionDims(new_input_shape.GetDims(), reduced_axes, fused_dims, fused_is_reduced);
+  const size_t num_fused_dims = fused_dims.size();
+
+  if (num_fused_dims == 0 || (num_fused_dims == 1 && fused_is_reduced[0])) {
+    to_data[0] = AGG(new_input_shape.Size(), from_data[0]).aggall(from_data);
+    return;
+  }
+  if (num_fused_dims == 1) {
+    // only dims of size 1 are reduced
+    ReduceKR<T, AGG>(from_data, to_data, fused_dims[0], 1, tp);
+    return;
+  }
+  if (num_fused_dims == 2 && !fused_is_reduced[0]) {
+    ReduceKR<T, AGG>(from_data, to_data, fused_dims[0], fused_dims[1], tp);
+    return;
+  }
+  if (num_fused_dims == 2) {
+    ReduceKRK<T, AGG>(from_data, to_data, 1, fused_dims[0], fused_dims[1], tp);
+    return;
+  }
+  if (num_fused_dims == 3 && fused_is_reduced[1]) {
+    ReduceKRK<T, AGG>(from_data, to_data, fused_dims[0], fused_dims[1], fused_dims[2], tp);
+    return;
+  }
+
+  std::vector<int64_t> fused_reduced_axes;
+  for (size_t i = 0; i < num_fused_dims; ++i) {
+    if (fused_is_reduced[i]) {
+      fused_reduced_axes.push_back(static_cast<int64_t>(i));
+    }
+  }
+  const TensorShape fused_shape(fused_dims);
+
+  if (!last_results.equal(fused_dims, fused_reduced_axes)) {
+    NoTransposePrepareForReduce(fused_shape, fused_reduced_axes, last_results);
     if (last_results.last_loop_red_size == 0 || last_results.last_loop_size == 0)
       return;
   }
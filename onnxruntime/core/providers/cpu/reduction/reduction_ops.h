@@ -84,6 +84,13 @@ class ReduceAggregator {
   inline TVAL get_value() { return accumulator_; }
   inline void enforce(const ResultsNoTransposePrepareForReduce&) {}
   static inline bool two_loops() { return false; }
+
+  // Whether the aggregator implements reduce_rk, which reduces <R> rows of <K> contiguous values, each row
+  // <stride> values after the previous one, into to_data[0:K]. The rows are processed one after the other with
+  // coefficient-wise operations, so the loop over the K values is vectorized. Aggregators without it are
+  // updated one value at a time.
+  static inline bool fast_reduce_rk() { return false; }
+  static inline void reduce_rk(const T*, TVAL*, int64_t, int64_t, int64_t) { ORT_ENFORCE(false, "must be overloaded."); }
 };
 
 template <typename T, typename TVAL = T>
@@ -94,6 +101,14 @@ class ReduceAggregatorSum : public ReduceAggregator<T, TVAL> {
   inline TVAL aggall(const T* from_data) {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).sum();
   }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out += ConstEigenVectorArrayMap<T>(from_data + r * stride, K);
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -104,6 +119,14 @@ class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).squaredNorm();
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K).square();
+    for (int64_t r = 1; r < R; ++r) {
+      out += ConstEigenVectorArrayMap<T>(from_data + r * stride, K).square();
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -114,6 +137,10 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).mean();
   }
   inline T get_value() { return this->accumulator_ / static_cast<T>(this->N_); }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    ReduceAggregatorSum<T, TVAL>::reduce_rk(from_data, to_data, R, stride, K);
+    EigenVectorArrayMap<TVAL>(to_data, K) /= static_cast<T>(R);
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -124,6 +151,14 @@ class ReduceAggregatorMax : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).maxCoeff();
   }
   inline void update(const T& v) { this->accumulator_ = v > this->accumulator_ ? v : this->accumulator_; }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out = out.max(ConstEigenVectorArrayMap<T>(from_data + r * stride, K));
+    }
+  }
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -223,6 +258,14 @@ class ReduceAggregatorMin : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).minCoeff();
   }
   inline void update(const T& v) { this->accumulator_ = v < this->accumulator_ ? v : this->accumulator_; }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out = out.min(ConstEigenVectorArrayMap<T>(from_data + r * stride, K));
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -233,6 +276,14 @@ class ReduceAggregatorProd : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).prod();
   }
   inline void update(const T& v) { this->accumulator_ *= v; }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out *= ConstEigenVectorArrayMap<T>(from_data + r * stride, K);
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -243,6 +294,14 @@ class ReduceAggregatorL1 : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).cwiseAbs().sum();
   }
   inline void update(const T& v) { this->accumulator_ += v > 0 ? v : -v; }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K).abs();
+    for (int64_t r = 1; r < R; ++r) {
+      out += ConstEigenVectorArrayMap<T>(from_data + r * stride, K).abs();
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -254,6 +313,12 @@ class ReduceAggregatorL2 : public ReduceAggregator<T, TVAL> {
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
   inline TVAL get_value() { return reduce_sqrt<T>(this->accumulator_); }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    ReduceAggregatorSumSquare<T, TVAL>::reduce_rk(from_data, to_data, R, stride, K);
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = out.unaryExpr([](const T& v) { return reduce_sqrt<T>(v); });
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -265,6 +330,12 @@ class ReduceAggregatorLogSum : public ReduceAggregator<T, TVAL> {
   }
   inline void update(const T& v) { this->accumulator_ += v; }
   inline TVAL get_value() { return reduce_log<T>(this->accumulator_); }
+  static inline bool fast_reduce_rk() { return true; }
+  static inline void reduce_rk(const T* from_data, TVAL* to_data, int64_t R, int64_t stride, int64_t K) {
+    ReduceAggregatorSum<T, TVAL>::reduce_rk(from_data, to_data, R, stride, K);
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = out.unaryExpr([](const T& v) { return reduce_log<T>(v); });
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -295,6 +366,15 @@ bool SetupForReduce(const Tensor* input_tensor_ptr,
                     bool& empty_reduce,
                     const TensorShape* input_shape_override);
 
+// Drops the dims of size 1 and merges the adjacent dims that are all reduced or all kept, so a reduction runs over
+// as few and as large contiguous blocks as possible. For instance a reduction of axes {2, 3} of a NCHW tensor is
+// a reduction of axis 1 of a (N*C, H*W) tensor. <fused_dims> holds the merged dims, outermost first, and
+// <fused_is_reduced> whether each of them is reduced.
+void FuseReductionDims(const std::vector<int64_t>& input_dims,
+                       const std::vector<int64_t>& reduced_axes,
+                       std::vector<int64_t>& fused_dims,
+                       std::vector<bool>& fused_is_reduced);
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  const std::vector<int64_t>& reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results);
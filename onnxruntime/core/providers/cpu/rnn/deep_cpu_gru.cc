@@ -11,6 +11,8 @@
 
 #include "core/providers/cpu/rnn/deep_cpu_gru.h"
 
+#include "core/framework/op_kernel_context_internal.h"
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -275,6 +277,18 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   auto status = ValidateCommonRnnInputs(X, W.Shape(), R.Shape(), B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
   ORT_RETURN_IF_ERROR(status);
 
+  // in streaming mode a forward GRU starts from the final state of the previous Run of the stream.
+  // the other directions need the frames that come after the input so they run without state.
+  const auto& stream_id = static_cast<OpKernelContextInternal&>(context).GetStreamId();
+  const bool end_of_stream = static_cast<OpKernelContextInternal&>(context).IsEndOfStream();
+  StreamState* stream_state = nullptr;
+  if (direction_ == Direction::kForward && !stream_id.empty()) {
+    stream_state = &stream_states_.Get(stream_id);
+    if (stream_state->hidden != nullptr) {
+      ORT_RETURN_IF_ERROR(ValidateStreamState(*stream_state->hidden, stream_id, batch_size, hidden_size_));
+    }
+  }
+
   // GRU outputs are optional but must be in the same order
   TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
   Tensor* Y = context.Output(/*index*/ 0, Y_dims);
@@ -288,6 +302,8 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
     if (max_sequence_length == 0) {
       if (Y != nullptr) std::fill_n(Y->MutableData<T>(), Y_dims.Size(), T{});
       if (Y_h != nullptr) std::fill_n(Y_h->MutableData<T>(), Y_h_dims.Size(), T{});
+      // nothing was processed so the state of the stream is unchanged
+      if (stream_state != nullptr && end_of_stream) stream_states_.Release(stream_id);
       return Status::OK();
     }
   }
@@ -317,6 +333,9 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   gsl::span<const T> initial_hidden_1 = initial_hidden.empty()
                                             ? initial_hidden
                                             : initial_hidden.subspan(0, initial_hidden_size_per_direction);
+  if (stream_state != nullptr && stream_state->hidden != nullptr) {
+    initial_hidden_1 = stream_state->hidden->DataAsSpan<T>();
+  }
 
   // output shape is [seq_length, num_directions, batch_size, hidden_size]
   // so it's not a case of all the output for one direction being first.
@@ -387,6 +406,14 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   DumpMatrix("Y_h", hidden_output.data(), num_directions_ * batch_size, hidden_size_);
 
+  if (stream_state != nullptr) {
+    if (end_of_stream) {
+      stream_states_.Release(stream_id);
+    } else {
+      SaveStreamState<T>(hidden_output, batch_size, hidden_size_, alloc, stream_state->hidden);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -65,6 +65,9 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // final hidden states of the streams run in streaming mode
+  mutable rnn::detail::StreamStates stream_states_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
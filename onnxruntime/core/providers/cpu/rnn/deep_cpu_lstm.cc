@@ -11,6 +11,10 @@
 
 #include "core/providers/cpu/rnn/deep_cpu_lstm.h"
 
+#include <numeric>
+
+#include "core/framework/op_kernel_context_internal.h"
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -228,6 +232,13 @@ class UniDirectionalLstm {
                         span_T_iter& batched_output_end, const gsl::span<const int>& seq_lengths,
                         int min_sequence_length, int step, int row, int local_fused_hidden_rows, bool output_sequence);
 
+  // Runs the steps on the sequences sorted by decreasing length, so the sequences still running at each step are
+  // the first rows of the batch and a single GEMM per step covers exactly them. Used when the lengths differ.
+  void ComputePacked(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths,
+                     int output_step_length, const GemmWeights<T>& input_weights,
+                     const GemmWeights<T>& recurrent_weights, gsl::span<T>& outputs,
+                     gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
+
   void AllocateBuffers();
 
   void InitializeBuffers(const gsl::span<const T>& initial_hidden_state, const gsl::span<const T>& initial_cell_state);
@@ -398,6 +409,18 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   Status status = ValidateInputs(X, W_shape, R_shape, B, sequence_lens, initial_h, initial_c, P, batch_size);
   ORT_RETURN_IF_ERROR(status);
 
+  // in streaming mode a forward LSTM starts from the final state of the previous Run of the stream.
+  // the other directions need the frames that come after the input so they run without state.
+  const auto& stream_id = static_cast<OpKernelContextInternal&>(context).GetStreamId();
+  const bool end_of_stream = static_cast<OpKernelContextInternal&>(context).IsEndOfStream();
+  StreamState* stream_state = nullptr;
+  if (direction_ == Direction::kForward && !stream_id.empty()) {
+    stream_state = &stream_states_.Get(stream_id);
+    if (stream_state->hidden != nullptr) {
+      ORT_RETURN_IF_ERROR(ValidateStreamState(*stream_state->hidden, stream_id, batch_size, hidden_size_));
+    }
+  }
+
   // LSTM outputs are optional but must be in the same order
   TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
   Tensor* Y = context.Output(/*index*/ 0, Y_dims);
@@ -419,6 +442,9 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
         std::fill_n(Y_h->MutableData<T>(), Y_h_dims.Size(), T{});
       if (Y_c != nullptr)
         std::fill_n(Y_c->MutableData<T>(), Y_c_dims.Size(), T{});
+      // nothing was processed so the state of the stream is unchanged
+      if (stream_state != nullptr && end_of_stream)
+        stream_states_.Release(stream_id);
       return Status::OK();
     }
   }
@@ -460,6 +486,11 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   gsl::span<const T> initial_cell_1 =
       initial_cell.empty() ? initial_cell : initial_cell.subspan(0, initial_cell_size_per_direction);
 
+  if (stream_state != nullptr && stream_state->hidden != nullptr) {
+    initial_hidden_1 = stream_state->hidden->DataAsSpan<T>();
+    initial_cell_1 = stream_state->cell->DataAsSpan<T>();
+  }
+
   // output shape is [seq_length, num_directions, batch_size, hidden_size]
   // so it's not a case of all the output for one direction being first.
   // due to that we can only easily check that the end of the output for each direction is valid.
@@ -536,6 +567,15 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   DumpMatrix("Y_h", hidden_output.data(), num_directions_ * batch_size, hidden_size_);
   DumpMatrix("Y_c", last_cell.data(), num_directions_ * batch_size, hidden_size_);
 
+  if (stream_state != nullptr) {
+    if (end_of_stream) {
+      stream_states_.Release(stream_id);
+    } else {
+      SaveStreamState<T>(hidden_output, batch_size, hidden_size_, alloc, stream_state->hidden);
+      SaveStreamState<T>(last_cell, batch_size, hidden_size_, alloc, stream_state->cell);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -786,6 +826,16 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   int32_t min_sequence_length =
       std::min(seq_length_, *std::min_element(sequence_lengths.cbegin(), sequence_lengths.cend()));
 
+  if (min_sequence_length < max_sequence_length) {
+    ComputePacked(inputs, sequence_lengths, output_step_length, input_weights, recurrent_weights, outputs,
+                  final_hidden_state, final_cell_state);
+
+    if (output_sequence && direction_ == Direction::kReverse)
+      ReverseSequence<T>(outputs, original_outputs, sequence_lengths, seq_length_, batch_size_, hidden_size_,
+                         num_directions, thread_pool_);
+    return;
+  }
+
   ///**************************LSTM Calculations****************************/
   float alpha = 1.0f;
   float beta = 0.0f;  // first call to ComputeGemm zeros out any existing data
@@ -1001,6 +1051,118 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                        num_directions, thread_pool_);
 }
 
+template <typename T>
+void UniDirectionalLstm<T>::ComputePacked(const gsl::span<const T>& inputs,
+                                          const gsl::span<const int>& sequence_lengths,
+                                          const int output_step_length, const GemmWeights<T>& input_weights,
+                                          const GemmWeights<T>& recurrent_weights, gsl::span<T>& outputs,
+                                          gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state) {
+  const int hidden_size_x4 = 4 * hidden_size_;
+  const bool output_sequence = !outputs.empty();
+
+  // order[r] is the batch entry of the r-th longest sequence
+  std::vector<int> order(batch_size_);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&sequence_lengths](int a, int b) { return sequence_lengths[a] > sequence_lengths[b]; });
+
+  std::vector<int> sorted_lengths(batch_size_);
+  for (int r = 0; r < batch_size_; r++) {
+    sorted_lengths[r] = sequence_lengths[order[r]];
+  }
+
+  const int max_sequence_length = sorted_lengths[0];
+
+  // active_rows[step] is the number of sequences still running at step, and step_offsets[step] the row of the
+  // packed inputs the step starts at
+  std::vector<int> active_rows(max_sequence_length + 1, 0);
+  std::vector<int> step_offsets(max_sequence_length + 1, 0);
+  for (int step = 0; step < max_sequence_length; step++) {
+    active_rows[step] = static_cast<int>(
+        std::count_if(sorted_lengths.cbegin(), sorted_lengths.cend(), [step](int len) { return len > step; }));
+    step_offsets[step + 1] = step_offsets[step] + active_rows[step];
+  }
+
+  const int total_rows = step_offsets[max_sequence_length];
+
+  // pack the inputs of the running sequences step by step, and apply the weights to all of them at once
+  IAllocatorUniquePtr<T> packed_inputs_ptr;
+  gsl::span<T> packed_inputs = Allocate(allocator_, total_rows * input_size_, packed_inputs_ptr);
+  for (int step = 0; step < max_sequence_length; step++) {
+    for (int r = 0; r < active_rows[step]; r++) {
+      gsl::copy(inputs.subspan((step * batch_size_ + order[r]) * input_size_, input_size_),
+                packed_inputs.subspan((step_offsets[step] + r) * input_size_, input_size_));
+    }
+  }
+
+  ComputeGemm(total_rows, hidden_size_x4, input_size_, 1.0f, packed_inputs.cbegin(), packed_inputs.cend(),
+              input_weights, 0.0f, output_iofc_.begin(), output_iofc_.end(), hidden_size_x4, thread_pool_);
+
+  DumpMatrix("Xt*(W[iofc]^T) packed", output_iofc_.data(), total_rows, hidden_size_x4);
+
+  // the hidden and cell states in sorted order. the hidden state is updated in place once the step's GEMM has read it
+  IAllocatorUniquePtr<T> hidden_ptr, cell_ptr;
+  gsl::span<T> hidden = Allocate(allocator_, batch_size_ * hidden_size_, hidden_ptr);
+  gsl::span<T> cell = Allocate(allocator_, batch_size_ * hidden_size_, cell_ptr);
+  for (int r = 0; r < batch_size_; r++) {
+    gsl::copy(batched_hidden0_.subspan(order[r] * hidden_size_, hidden_size_),
+              hidden.subspan(r * hidden_size_, hidden_size_));
+    gsl::copy(batched_internal_memory_prev_.subspan(order[r] * hidden_size_, hidden_size_),
+              cell.subspan(r * hidden_size_, hidden_size_));
+  }
+
+  const gsl::span<const int> sorted_lengths_span = sorted_lengths;
+  span_T_iter C_prev = cell.begin();
+  const span_T_iter C_prev_end = cell.end();
+  span_T_iter C_prev_clipped = batched_internal_memory_clipped_.begin();
+  const span_T_iter C_prev_clipped_end = batched_internal_memory_clipped_.end();
+  span_T_iter batched_output = hidden.begin();
+  span_T_iter batched_output_end = hidden.end();
+
+  for (int step = 0; step < max_sequence_length; step++) {
+    const int rows = active_rows[step];
+    span_T_iter step_out_IOFC = output_iofc_.begin() + step_offsets[step] * hidden_size_x4;
+    span_T_iter step_out_IOFC_end = step_out_IOFC + rows * hidden_size_x4;
+
+    // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
+    ComputeGemm(rows, hidden_size_x4, hidden_size_, 1.0f, hidden.cbegin(), hidden.cend(), recurrent_weights,
+                1.0f, step_out_IOFC, output_iofc_.end(), hidden_size_x4, thread_pool_);
+
+    // all the rows are running at this step, so no row is skipped
+    GateComputations(step_out_IOFC, step_out_IOFC_end, C_prev, C_prev_end, C_prev_clipped, C_prev_clipped_end,
+                     batched_output, batched_output_end, sorted_lengths_span, max_sequence_length, step, 0, rows,
+                     false);
+
+    for (int r = 0; r < rows; r++) {
+      if (output_sequence) {
+        gsl::copy(hidden.subspan(r * hidden_size_, hidden_size_),
+                  outputs.subspan(step * output_step_length + order[r] * hidden_size_, hidden_size_));
+      }
+
+      if (sorted_lengths[r] == step + 1) {
+        gsl::copy(hidden.subspan(r * hidden_size_, hidden_size_),
+                  final_hidden_state.subspan(order[r] * hidden_size_, hidden_size_));
+        gsl::copy(cell.subspan(r * hidden_size_, hidden_size_),
+                  final_cell_state.subspan(order[r] * hidden_size_, hidden_size_));
+      }
+    }
+  }
+
+  // zero the final states of the empty sequences, and the outputs of the steps after the end of each sequence
+  for (int r = 0; r < batch_size_; r++) {
+    if (sorted_lengths[r] == 0) {
+      std::fill_n(final_hidden_state.begin() + order[r] * hidden_size_, hidden_size_, T{});
+      std::fill_n(final_cell_state.begin() + order[r] * hidden_size_, hidden_size_, T{});
+    }
+
+    if (output_sequence) {
+      for (int step = sorted_lengths[r]; step < seq_length_; step++) {
+        std::fill_n(outputs.begin() + step * output_step_length + order[r] * hidden_size_, hidden_size_, T{});
+      }
+    }
+  }
+}
+
 // #define PREVIOUS_BROKEN_VERSION
 
 // This function can't use session thread pool
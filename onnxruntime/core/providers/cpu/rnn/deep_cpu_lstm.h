@@ -53,6 +53,11 @@ class DeepCpuLstmOp final : public OpKernel {
   Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
   Status Compute(OpKernelContext* context) const override;
 
+  size_t PrePackedBytes() const override {
+    return ((packed_W_.buffer_ ? packed_W_.weights_size_ : 0) + (packed_R_.buffer_ ? packed_R_.weights_size_ : 0)) *
+           static_cast<size_t>(num_directions_);
+  }
+
   ~DeepCpuLstmOp() override = default;
 
  private:
@@ -83,6 +88,8 @@ class DeepCpuLstmOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // final hidden and cell states of the streams run in streaming mode
+  mutable rnn::detail::StreamStates stream_states_;
 };
 
 }  // namespace onnxruntime
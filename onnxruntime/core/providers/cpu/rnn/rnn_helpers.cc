@@ -99,6 +99,28 @@ Status ValidateCommonRnnInputs(const Tensor& X,
   return Status::OK();
 }  // namespace detail
 
+StreamState& StreamStates::Get(const std::string& stream_id) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  // references to the elements of an unordered_map stay valid when other elements are added or erased
+  return states_[stream_id];
+}
+
+void StreamStates::Release(const std::string& stream_id) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  states_.erase(stream_id);
+}
+
+Status ValidateStreamState(const Tensor& state, const std::string& stream_id, int batch_size, int hidden_size) {
+  const auto& state_shape = state.Shape();
+  if (state_shape[1] != batch_size || state_shape[2] != hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The state of stream '", stream_id, "' has shape ",
+                           state_shape, " but this Run needs {1,", batch_size, ",", hidden_size,
+                           "}. The batch size can't change within a stream.");
+  }
+
+  return Status::OK();
+}
+
 // map of arg name and whether the alpha and/or beta arguments are required
 static std::unordered_map<std::string, std::pair<bool, bool>>
     NameToArgUsageMap{{"affine", {1, 1}},
@@ -7,13 +7,19 @@
 #pragma warning(disable : 4267)
 #endif
 
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/common/safeint.h"
+#include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 
 #include "gsl/gsl"
@@ -169,6 +175,43 @@ struct PackedWeights {
   TensorShape shape_;
 };
 
+/// The state kept by a recurrent kernel between the Runs of a stream (see RunOptions::stream_id).
+/// Holds the final hidden state of the last Run, and its final cell state for LSTM.
+struct StreamState {
+  std::unique_ptr<Tensor> hidden;
+  std::unique_ptr<Tensor> cell;
+};
+
+/// The states of the streams run by a recurrent kernel in streaming mode.
+class StreamStates {
+ public:
+  /// Returns the state of the stream, which has no tensors until a Run of the stream has completed.
+  /// A stream is only used by one Run at a time, so the state can be used after Get returns.
+  StreamState& Get(const std::string& stream_id);
+
+  void Release(const std::string& stream_id);
+
+ private:
+  OrtMutex mutex_;
+  std::unordered_map<std::string, StreamState> states_;
+};
+
+/// Checks that the state saved by the previous Run of a stream has the shape of the initial state of this Run.
+Status ValidateStreamState(const Tensor& state, const std::string& stream_id, int batch_size, int hidden_size);
+
+/// Saves the final state of a Run of a stream, allocating the state tensor with alloc the first time.
+template <typename T>
+void SaveStreamState(gsl::span<const T> final_state, int batch_size, int hidden_size, const AllocatorPtr& alloc,
+                     std::unique_ptr<Tensor>& state) {
+  if (state == nullptr) {
+    state = onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<T>(), TensorShape({1, batch_size, hidden_size}),
+                                             alloc);
+  }
+
+  ORT_ENFORCE(static_cast<size_t>(state->Shape().Size()) == final_state.size());
+  std::copy(final_state.cbegin(), final_state.cend(), state->MutableData<T>());
+}
+
 template <typename T>
 struct GemmWeights {
   GemmWeights(int idx, const T* weights_data, size_t weights_size, const PackedWeights& packed_weights) {
@@ -25,8 +25,8 @@ Status ConcatFromSequence::Compute(OpKernelContext* ctx) const {
   // Hold pointers to the input tensors to be used in the PrepareForCompute() step
   std::vector<const Tensor*> input_tensor_pointers;
   input_tensor_pointers.reserve(X->Size());
-  for (const auto& t : *X) {
-    input_tensor_pointers.push_back(&t);
+  for (const auto& ort_value : *X) {
+    input_tensor_pointers.push_back(&ort_value.Get<Tensor>());
   }
 
   // Validate inputs and prepare some metadata used during actual compute
@@ -40,7 +40,7 @@ Status ConcatFromSequence::Compute(OpKernelContext* ctx) const {
     return Status::OK();
 
   // Compute values to be placed in the output tensor
-  return ComputeImpl(p);
+  return ComputeImpl(p, ctx->GetOperatorThreadPool());
 }
 
 }  // namespace onnxruntime
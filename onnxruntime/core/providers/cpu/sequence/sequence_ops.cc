@@ -5,6 +5,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/TensorSeq.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/common.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -13,8 +14,9 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
-// TODO: The current implementation of sequence ops relies on tensor copies. Ideally we should try to avoid
-// these copies. This has been postponed due to lack of time.
+// The tensors of a sequence are immutable and shared by ref-counted OrtValues, so the sequence ops only copy the
+// tensors they take from their tensor inputs. SequenceAt returns the tensor of the sequence itself, the allocation
+// planner keeps its output from being updated in place or reused for other values.
 
 // SequenceLength
 ONNX_CPU_OPERATOR_KERNEL(
@@ -94,7 +96,15 @@ Status SequenceAt::Compute(OpKernelContext* context) const {
   if (input_seq_idx < 0) {
     input_seq_idx = static_cast<int64_t>(X->Size()) + input_seq_idx;
   }
-  const Tensor& indexed_tensor = X->Get(input_seq_idx);
+  // share the tensor unless the output was provided, e.g. bound to a buffer of the caller
+  const OrtValue& indexed_value = X->GetAt(input_seq_idx);
+  OrtValue* output_value = static_cast<OpKernelContextInternal*>(context)->GetOutputMLValue(0);
+  if (output_value != nullptr && !output_value->IsAllocated()) {
+    *output_value = indexed_value;
+    return Status::OK();
+  }
+
+  const Tensor& indexed_tensor = indexed_value.Get<Tensor>();
   auto* Y = context->Output(0, indexed_tensor.Shape().GetDims());
   ORT_ENFORCE(Y != nullptr, "SequenceAt: Got nullptr for output tensor");
   CopyCpuTensor(&indexed_tensor, Y);
@@ -182,12 +192,15 @@ ONNX_CPU_OPERATOR_KERNEL(
                                  DataTypeImpl::GetTensorType<int64_t>()}),
     SequenceInsert);
 
-Status CreateCopyAndAppendCpuTensor(const Tensor& in_tensor, OpKernelContext* context, std::vector<Tensor>& tensors) {
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-  Tensor tmp(in_tensor.DataType(), onnxruntime::TensorShape(in_tensor.Shape()), alloc);
-  CopyCpuTensor(&in_tensor, &tmp);
-  tensors.push_back(std::move(tmp));
+// The buffers of tensor inputs belong to the execution frame, which may reuse them once the node ran,
+// so they are copied to own buffers before they're added to a sequence. The copies outlive the Run as part of the
+// output sequence, so they come from the kernel's allocator rather than the frame's temp space.
+Status CreateCopyAndAppendCpuTensor(const Tensor& in_tensor, const AllocatorPtr& alloc,
+                                    std::vector<OrtValue>& ort_values) {
+  auto tmp = onnxruntime::make_unique<Tensor>(in_tensor.DataType(), onnxruntime::TensorShape(in_tensor.Shape()), alloc);
+  CopyCpuTensor(&in_tensor, tmp.get());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_values.emplace_back(tmp.release(), ml_tensor, ml_tensor->GetDeleteFunc());
   return Status::OK();
 }
 
@@ -222,22 +235,22 @@ Status SequenceInsert::Compute(OpKernelContext* context) const {
 
   auto* Y = context->Output<TensorSeq>(0);
   ORT_ENFORCE(Y != nullptr, "SequenceInsert: Got nullptr for output sequence");
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_tensors_input_seq + 1);
+  AllocatorPtr alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  // only the inserted tensor is copied, the tensors of the input sequence are shared
+  std::vector<OrtValue> ort_values;
+  ort_values.reserve(num_tensors_input_seq + 1);
   for (int i = 0; i < num_tensors_input_seq; ++i) {
     if (i == input_seq_idx) {
-      CreateCopyAndAppendCpuTensor(*X, context, tensors);
-      CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
-    } else {
-      CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
+      ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, alloc, ort_values));
     }
+    ort_values.push_back(S->GetAt(i));
   }
   if (input_seq_idx == num_tensors_input_seq + 1) {
-    CreateCopyAndAppendCpuTensor(*X, context, tensors);
+    ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, alloc, ort_values));
   }
 
   Y->SetType(S->DataType());
-  Y->SetElements(std::move(tensors));
+  Y->SetElements(std::move(ort_values));
 
   return Status::OK();
 }
@@ -275,15 +288,15 @@ Status SequenceErase::Compute(OpKernelContext* context) const {
   auto* Y = context->Output<TensorSeq>(0);
   ORT_ENFORCE(Y != nullptr, "SequenceErase: Got nullptr for output sequence");
   Y->SetType(S->DataType());
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_tensors_input_seq - 1);
+  std::vector<OrtValue> ort_values;
+  ort_values.reserve(num_tensors_input_seq - 1);
   for (int i = 0; i < num_tensors_input_seq; ++i) {
     if (i == input_seq_idx) {
       continue;
     }
-    CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
+    ort_values.push_back(S->GetAt(i));
   }
-  Y->SetElements(std::move(tensors));
+  Y->SetElements(std::move(ort_values));
   return Status::OK();
 }
 
@@ -315,13 +328,14 @@ Status SequenceConstruct::Compute(OpKernelContext* context) const {
 
   // now copy the tensors to the output sequence
   Y->SetType(first_dtype);
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_inputs);
+  AllocatorPtr alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  std::vector<OrtValue> ort_values;
+  ort_values.reserve(num_inputs);
   for (int input_idx = 0; input_idx < num_inputs; ++input_idx) {
     const auto* X = context->Input<Tensor>(input_idx);
-    CreateCopyAndAppendCpuTensor(*X, context, tensors);
+    ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, alloc, ort_values));
   }
-  Y->SetElements(std::move(tensors));
+  Y->SetElements(std::move(ort_values));
   return Status::OK();
 }
 
@@ -500,6 +514,8 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
   auto& input_dims = input_shape.GetDims();
   std::vector<int64_t> output_dimensions{input_dims};
   std::vector<Tensor> tensors;
+  // the tensors outlive the Run as part of the output sequence
+  AllocatorPtr alloc = Info().GetAllocator(0, OrtMemTypeDefault);
   int64_t input_offset = 0;
   const T* input_data = input.template Data<T>();
   for (int i = 0; i < num_outputs; ++i) {
@@ -512,8 +528,6 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
     }
     output_dimensions[axis] = split_size;
 
-    AllocatorPtr alloc;
-    ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
     Tensor output_tensor(input.DataType(), onnxruntime::TensorShape(output_dimensions), alloc);
     T* output_data = output_tensor.template MutableData<T>();
 
@@ -8,11 +8,9 @@
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
-#include "Eigen/src/Core/arch/Default/Half.h"
 
-#if defined(_M_AMD64)
 #include "core/mlas/inc/mlas.h"
-#endif
+#include "core/platform/threadpool.h"
 
 // FUTURE:
 // Float16 and String have expensive special cased handling. Enable by default, but provide an easy way to disable
@@ -25,59 +23,49 @@ namespace onnxruntime {
 
 namespace {
 template <typename SrcType, typename DstType>
-inline void CastData(const Tensor& in, Tensor& out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in.Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out.MutableData<DstType>(), shape_size);
+inline void CastData(const SrcType* in_data, DstType* out_data, std::ptrdiff_t count) {
+  auto in_vector = ConstEigenVectorMap<SrcType>(in_data, count);
+  auto output_vector = EigenVectorMap<DstType>(out_data, count);
   output_vector = in_vector.template cast<DstType>();
 }
 
 #ifdef CAST_FLOAT16_ENABLED
 template <>
-inline void CastData<float, MLFloat16>(const Tensor& in, Tensor& out, const TensorShape& shape) {
-  auto out_data = out.MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in.Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)),
-                                                   shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
+inline void CastData<float, MLFloat16>(const float* in_data, MLFloat16* out_data, std::ptrdiff_t count) {
+  MlasConvertFloatToHalfBuffer(in_data, &out_data[0].val, static_cast<size_t>(count));
 }
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor& in, Tensor& out, const TensorShape& shape) {
-  auto out_data = out.MutableData<float>();
-  auto in_data = in.Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)),
-                                                    shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
+inline void CastData<MLFloat16, float>(const MLFloat16* in_data, float* out_data, std::ptrdiff_t count) {
+  MlasConvertHalfToFloat(MlasHalfTypeFloat16, &in_data[0].val, out_data, static_cast<size_t>(count));
 }
 
+// the BFloat16 constructor truncates, which is kept here instead of the rounding done by MlasConvertFloatToHalf
 template <>
-inline void CastData<float, BFloat16>(const Tensor& in, Tensor& out, const TensorShape& shape) {
-  auto out_data = out.template MutableData<BFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in.template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<BFloat16>(out_data, shape_size);
+inline void CastData<float, BFloat16>(const float* in_data, BFloat16* out_data, std::ptrdiff_t count) {
+  auto in_vector = ConstEigenVectorMap<float>(in_data, count);
+  auto output_vector = EigenVectorMap<BFloat16>(out_data, count);
   output_vector = in_vector.template cast<BFloat16>();
 }
 
 template <>
-inline void CastData<BFloat16, float>(const Tensor& in, Tensor& out, const TensorShape& shape) {
-  auto out_data = out.template MutableData<float>();
-  auto in_data = in.template Data<BFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<BFloat16>(in_data, shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.unaryExpr([](BFloat16 val) { return val.ToFloat(); });
+inline void CastData<BFloat16, float>(const BFloat16* in_data, float* out_data, std::ptrdiff_t count) {
+  MlasConvertHalfToFloat(MlasHalfTypeBFloat16, &in_data[0].val, out_data, static_cast<size_t>(count));
 }
 #endif
 
+// Casts the tensor in blocks partitioned across the thread pool. Small tensors are cast on the calling thread.
+template <typename SrcType, typename DstType>
+void CastData(concurrency::ThreadPool* tp, const Tensor& in, Tensor& out, const TensorShape& shape) {
+  const auto* in_data = in.Data<SrcType>();
+  auto* out_data = out.MutableData<DstType>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, shape.Size(), TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 1.0},
+      [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        CastData<SrcType, DstType>(in_data + first, out_data + first, last - first);
+      });
+}
+
 #ifdef CAST_STRING_ENABLED
 
 // handle floating point input separately
@@ -256,20 +244,20 @@ ONNX_CPU_OPERATOR_KERNEL(
 // default dispatch
 template <typename TSrc, typename TDst>
 struct Cast::Dispatcher {
-  void operator()(const Tensor& src, Tensor& dst, const TensorShape& shape) {
-    CastData<TSrc, TDst>(src, dst, shape);
+  void operator()(concurrency::ThreadPool* tp, const Tensor& src, Tensor& dst, const TensorShape& shape) {
+    CastData<TSrc, TDst>(tp, src, dst, shape);
   }
 };
 
 template <typename TSrc>
 struct Cast::SrcDispatcher {
-  void operator()(int32_t to, const Tensor& src, Tensor& dst, const TensorShape& shape) {
+  void operator()(int32_t to, concurrency::ThreadPool* tp, const Tensor& src, Tensor& dst, const TensorShape& shape) {
     utils::MLTypeCallDispatcherWithCarriedType<TSrc, Cast::Dispatcher,
                                                float, double, int8_t, uint8_t, int16_t, uint16_t,
                                                int32_t, uint32_t, int64_t, uint64_t, bool>
         t_disp(to);
 
-    t_disp.Invoke(src, dst, shape);
+    t_disp.Invoke(tp, src, dst, shape);
   }
 };
 
@@ -323,20 +311,22 @@ Status Cast::Compute(OpKernelContext* context) const {
   } else
 #endif
   {
-    auto do_cast = [](int32_t from, int32_t to, const Tensor& src, Tensor& dst, const TensorShape& shape) {
+    concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+    auto do_cast = [tp](int32_t from, int32_t to, const Tensor& src, Tensor& dst, const TensorShape& shape) {
       utils::MLTypeCallDispatcher<SrcDispatcher,
                                   float, double,  // MLFloat16 is special cased below
                                   int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t, bool>
           t_disp(from);
 
-      t_disp.Invoke(to, src, dst, shape);
+      t_disp.Invoke(to, tp, src, dst, shape);
     };
 
 #ifdef CAST_FLOAT16_ENABLED
     // MLFloat16  needs special handling
     if (from == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) {
       if (to_ == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
-        CastData<MLFloat16, float>(*X, *Y, shape);
+        CastData<MLFloat16, float>(tp, *X, *Y, shape);
       } else {
         // need to cast to float first in a temporary buffer
         AllocatorPtr allocator;
@@ -344,12 +334,12 @@ Status Cast::Compute(OpKernelContext* context) const {
         auto tmp_buffer = IAllocator::MakeUniquePtr<float>(allocator, shape.Size());
         Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, tmp_buffer.get(), allocator->Info());
 
-        CastData<MLFloat16, float>(*X, tmp_tensor, shape);
+        CastData<MLFloat16, float>(tp, *X, tmp_tensor, shape);
         do_cast(ONNX_NAMESPACE::TensorProto_DataType_FLOAT, to_, tmp_tensor, *Y, shape);
       }
     } else if (to_ == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) {
       if (from == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
-        CastData<float, MLFloat16>(*X, *Y, shape);
+        CastData<float, MLFloat16>(tp, *X, *Y, shape);
       } else {
         // need to cast to float first in a temporary buffer
         AllocatorPtr allocator;
@@ -358,11 +348,11 @@ Status Cast::Compute(OpKernelContext* context) const {
         Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, tmp_buffer.get(), allocator->Info());
 
         do_cast(from, ONNX_NAMESPACE::TensorProto_DataType_FLOAT, *X, tmp_tensor, shape);
-        CastData<float, MLFloat16>(tmp_tensor, *Y, shape);
+        CastData<float, MLFloat16>(tp, tmp_tensor, *Y, shape);
       }
     } else if (from == ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16) {
       if (to_ == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
-        CastData<BFloat16, float>(*X, *Y, shape);
+        CastData<BFloat16, float>(tp, *X, *Y, shape);
       } else {
         // need to cast to float first in a temporary buffer
         AllocatorPtr allocator;
@@ -370,12 +360,12 @@ Status Cast::Compute(OpKernelContext* context) const {
         auto tmp_buffer = IAllocator::MakeUniquePtr<float>(allocator, shape.Size());
         Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, tmp_buffer.get(), allocator->Info());
 
-        CastData<BFloat16, float>(*X, tmp_tensor, shape);
+        CastData<BFloat16, float>(tp, *X, tmp_tensor, shape);
         do_cast(ONNX_NAMESPACE::TensorProto_DataType_FLOAT, to_, tmp_tensor, *Y, shape);
       }
     } else if (to_ == ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16) {
       if (from == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
-        CastData<float, BFloat16>(*X, *Y, shape);
+        CastData<float, BFloat16>(tp, *X, *Y, shape);
       } else {
         // need to cast to float first in a temporary buffer
         AllocatorPtr allocator;
@@ -384,7 +374,7 @@ Status Cast::Compute(OpKernelContext* context) const {
         Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, tmp_buffer.get(), allocator->Info());
 
         do_cast(from, ONNX_NAMESPACE::TensorProto_DataType_FLOAT, *X, tmp_tensor, shape);
-        CastData<float, BFloat16>(tmp_tensor, *Y, shape);
+        CastData<float, BFloat16>(tp, tmp_tensor, *Y, shape);
       }
     }
     else
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/math/prefix_sum.h"
+
+namespace onnxruntime {
+
+// Writes the items of [0, count) for which is_selected(i) is true in order, in two passes over chunks of the items
+// which are split between the threads of the thread pool:
+//   1. count the selected items of every chunk,
+//   2. write the selected items of every chunk with write(i, output_index), where the chunk starts at the sum of the
+//      counts of the chunks before it.
+// allocate(num_selected) is called between the passes, so the output can be created once its size is known.
+// Returns the number of selected items.
+template <typename IsSelected, typename Allocate, typename Write>
+int64_t ParallelCompact(concurrency::ThreadPool* tp, int64_t count,
+                        IsSelected is_selected, Allocate allocate, Write write) {
+  // chunks are large enough for the passes not to be dominated by the scheduling
+  constexpr int64_t kMinChunkSize = 16 * 1024;
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(concurrency::ThreadPool::DegreeOfParallelism(tp), count / kMinChunkSize));
+
+  std::vector<int64_t> chunk_offsets(static_cast<size_t>(num_chunks), 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_chunks, [&](std::ptrdiff_t chunk) {
+    const auto work = concurrency::ThreadPool::PartitionWork(chunk, num_chunks, count);
+    int64_t num_selected = 0;
+    for (std::ptrdiff_t i = work.start; i < work.end; ++i) {
+      num_selected += is_selected(i) ? 1 : 0;
+    }
+    chunk_offsets[chunk] = num_selected;
+  });
+
+  const int64_t num_selected = PrefixSum(chunk_offsets.data(), chunk_offsets.data(), num_chunks,
+                                         /*exclusive*/ true, /*reverse*/ false, tp);
+
+  allocate(num_selected);
+  if (num_selected == 0) {
+    return 0;
+  }
+
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_chunks, [&](std::ptrdiff_t chunk) {
+    const auto work = concurrency::ThreadPool::PartitionWork(chunk, num_chunks, count);
+    int64_t output_index = chunk_offsets[chunk];
+    for (std::ptrdiff_t i = work.start; i < work.end; ++i) {
+      if (is_selected(i)) {
+        write(i, output_index++);
+      }
+    }
+  });
+
+  return num_selected;
+}
+
+}  // namespace onnxruntime
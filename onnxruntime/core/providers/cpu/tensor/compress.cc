@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/compress.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/compaction.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -38,25 +39,48 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->template Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[axis] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
-  // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
+  const auto* input_data = static_cast<const uint8_t*>(input_tensor->DataRaw());
+  auto element_bytes = input_tensor->DataType()->Size();
+  bool is_string_type = input_tensor->IsDataTypeString();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  if (!has_axis_) {
+    // compact the selected elements of the flattened input
+    uint8_t* output_data = nullptr;
+    ParallelCompact(
+        tp, valid_condition_length,
+        [condition_data](std::ptrdiff_t i) { return condition_data[i]; },
+        [&](int64_t positive_condition_count) {
+          auto output_tensor = ctx->Output(0, {positive_condition_count});
+          output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
+        },
+        [&](std::ptrdiff_t i, int64_t output_index) {
+          if (is_string_type) {
+            reinterpret_cast<std::string*>(output_data)[output_index] =
+                reinterpret_cast<const std::string*>(input_data)[i];
+          } else {
+            memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
+          }
+        });
+
+    return Status::OK();
+  }
+
+  // the entries of the axis to keep
+  std::vector<int64_t> selected_indices;
+  for (int64_t i = 0; i < valid_condition_length; ++i) {
     if (condition_data[i]) {
-      ++positive_condition_count;
+      selected_indices.push_back(i);
     }
   }
 
+  const auto positive_condition_count = static_cast<int64_t>(selected_indices.size());
   std::vector<int64_t> output_dims(input_dimensions);
-  if (has_axis_) {
-    output_dims[axis] = positive_condition_count;
-  } else {
-    output_dims.resize(1);
-    output_dims[0] = positive_condition_count;
-  }
+  output_dims[axis] = positive_condition_count;
 
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
@@ -64,60 +88,47 @@ Status Compress::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  const auto* input_data = static_cast<const uint8_t*>(input_tensor->DataRaw());
   auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
-  auto element_bytes = input_tensor->DataType()->Size();
-  bool is_string_type = input_tensor->IsDataTypeString();
-  int64_t output_index = 0;
 
-  if (has_axis_) {
-    int64_t axes_left_stride = 1;
-    int64_t axes_right_stride = 1;
-    for (int i = 0; i < axis; ++i) {
-      axes_left_stride *= input_dimensions[i];
-    }
+  int64_t axes_left_stride = 1;
+  int64_t axes_right_stride = 1;
+  for (int i = 0; i < axis; ++i) {
+    axes_left_stride *= input_dimensions[i];
+  }
 
-    for (auto i = static_cast<size_t>(axis + 1); i < rank; ++i) {
-      axes_right_stride *= input_dimensions[i];
-    }
-    int64_t axes_included_right_stride = axes_right_stride * input_dimensions[axis];
-    int64_t axes_included_right_stride_bytes = axes_included_right_stride * element_bytes;
-    ORT_ENFORCE(axes_right_stride >= 0 &&
-                static_cast<uint64_t>(axes_right_stride) < std::numeric_limits<size_t>::max());
-    size_t axes_right_stride_bytes = 0;
-    if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
-                                         &axes_right_stride_bytes))
-      return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
-          continue;
-        }
-        if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-                reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
+  for (auto i = static_cast<size_t>(axis + 1); i < rank; ++i) {
+    axes_right_stride *= input_dimensions[i];
+  }
+  int64_t axes_included_right_stride = axes_right_stride * input_dimensions[axis];
+  int64_t axes_included_right_stride_bytes = axes_included_right_stride * element_bytes;
+  ORT_ENFORCE(axes_right_stride >= 0 &&
+              static_cast<uint64_t>(axes_right_stride) < std::numeric_limits<size_t>::max());
+  size_t axes_right_stride_bytes = 0;
+  if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
+                                       &axes_right_stride_bytes))
+    return Status(ONNXRUNTIME, FAIL, "size overflow");
+
+  // every selected block of axes_right_stride elements goes to a known place in the output, so the blocks are
+  // copied in parallel
+  const double block_bytes = static_cast<double>(axes_right_stride_bytes);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, axes_left_stride * positive_condition_count, TensorOpCost{block_bytes, block_bytes, 0},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t block = begin; block < end; ++block) {
+          const int64_t i = block / positive_condition_count;
+          const int64_t j = selected_indices[block % positive_condition_count];
+          if (is_string_type) {
+            const auto* src = reinterpret_cast<const std::string*>(input_data) +
+                              i * axes_included_right_stride + j * axes_right_stride;
+            auto* dst = reinterpret_cast<std::string*>(output_data) + block * axes_right_stride;
+            std::copy(src, src + axes_right_stride, dst);
+          } else {
+            memcpy(output_data + block * axes_right_stride_bytes,
+                   input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes,
+                   axes_right_stride_bytes);
           }
-          output_index += axes_right_stride;
-        } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
         }
-      }
-    }
-  } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
-      }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
-      }
-      ++output_index;
-    }
-  }
+      });
 
   return Status::OK();
 }
@@ -4,6 +4,7 @@
 #include "core/providers/cpu/tensor/concat.h"
 #include "core/providers/common.h"
 #include "core/framework/TensorSeq.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -159,16 +160,28 @@ Status ConcatBase::PrepareForCompute(OpKernelContext* ctx,
 }
 
 // This method computes the output tensor for Concat/ConcatFromSequence ops
-Status ConcatBase::ComputeImpl(Prepare& p) const {
+Status ConcatBase::ComputeImpl(Prepare& p, concurrency::ThreadPool* tp) const {
   int input_count = static_cast<int>(p.inputs.size());
-  int64_t initial_output_offset = 0;  // initial offset for each input
   auto element_bytes = p.output_tensor->DataType()->Size();
+
+  // initial offset for each input
+  std::vector<int64_t> initial_output_offsets(input_count);
+  int64_t initial_output_offset = 0;
   for (int input_index = 0; input_index < input_count; input_index++) {
+    initial_output_offsets[input_index] = initial_output_offset;
+    if (p.inputs[input_index].num_elements != 0) {
+      initial_output_offset += p.inputs[input_index].axis_pitch;
+    }
+  }
+
+  auto copy_input = [&p, &initial_output_offsets, element_bytes](int input_index) {
     const auto& prep = p.inputs[input_index];
 
     // no data in this tensor - so skip it
     if (prep.num_elements == 0)
-      continue;
+      return;
+
+    const int64_t initial_output_offset = initial_output_offsets[input_index];
 
     auto input_axis_pitch = prep.axis_pitch;
     const uint8_t* input = static_cast<const uint8_t*>(prep.tensor->DataRaw());
@@ -182,6 +195,12 @@ Status ConcatBase::ComputeImpl(Prepare& p) const {
     // 2) Stacking on output axis = 0
     // 3) Stacking scalars
     uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+
+    // the allocation planner may have placed the input in the output already
+    if (input_size == input_axis_pitch && input == output + initial_output_offset * element_bytes) {
+      return;
+    }
+
     int64_t cur_out_offset = 0;
     int64_t cur_in_offset = 0;
     for (size_t idx_copy = 0, end = input_size / input_axis_pitch; idx_copy < end; ++idx_copy) {
@@ -201,9 +220,16 @@ Status ConcatBase::ComputeImpl(Prepare& p) const {
       cur_out_offset += p.output_axis_pitch;
       cur_in_offset += input_axis_pitch;
     }
-
-    initial_output_offset += input_axis_pitch;
-  }
+  };
+
+  const double bytes_per_input = static_cast<double>(p.output_num_elements) * element_bytes / input_count;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, input_count, TensorOpCost{bytes_per_input, bytes_per_input, 0},
+      [&copy_input](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto input_index = first; input_index < last; ++input_index) {
+          copy_input(static_cast<int>(input_index));
+        }
+      });
 
   return Status::OK();
 }
@@ -231,7 +257,7 @@ Status Concat::Compute(OpKernelContext* ctx) const {
     return Status::OK();
 
   // Compute values to be placed in the output tensor
-  return ComputeImpl(p);
+  return ComputeImpl(p, ctx->GetOperatorThreadPool());
 }
 
 }  // namespace onnxruntime
@@ -44,7 +44,8 @@ class ConcatBase {
   Status PrepareForCompute(OpKernelContext* ctx, const std::vector<const Tensor*>& input_tensors,
                            Prepare& p) const;
 
-  Status ComputeImpl(Prepare& p) const;
+  // the inputs are copied in parallel on 'tp' if it's given, as they fill disjoint parts of the output
+  Status ComputeImpl(Prepare& p, concurrency::ThreadPool* tp = nullptr) const;
 
   int64_t axis_;
   bool is_stack_ = false;
@@ -64,6 +64,23 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+// Gathers rows that are 1, 2, 4 or 8 bytes long (e.g. a scalar per index when axis is the innermost dimension)
+// with a typed load/store instead of a memcpy call per index. Rows start at multiples of sizeof(T),
+// so the accesses are aligned.
+template <typename T, typename Tin>
+void GatherScalars(T* dst, const T* src, const Tin* indices_data, int64_t axis_dim_limit,
+                   int64_t M, int64_t N, concurrency::ThreadPool* tp) {
+  concurrency::ThreadPool::TryParallelFor(
+      tp, M * N, TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(T)), 1.0},
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        for (int64_t index = static_cast<int64_t>(first), end = static_cast<int64_t>(last); index < end; ++index) {
+          const int64_t batch = index / N;
+          const Tin idx = indices_data[index % N];
+          dst[index] = src[batch * axis_dim_limit + (idx < 0 ? idx + axis_dim_limit : idx)];
+        }
+      });
+}
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
@@ -83,30 +100,57 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-  auto lambda = [&](int64_t index) {
+  const auto adjusted_index = [indices_data, axis_dim_limit](int64_t i) {
+    const Tin idx = indices_data[i];
+    return static_cast<int64_t>(idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx);
+  };
+
+  if (!is_string_type) {
+    switch (block_size) {
+      case sizeof(uint8_t):
+        GatherScalars(dst_base, src_base, indices_data, axis_dim_limit, M, N, tp);
+        return Status::OK();
+      case sizeof(uint16_t):
+        GatherScalars(reinterpret_cast<uint16_t*>(dst_base), reinterpret_cast<const uint16_t*>(src_base), indices_data,
+                      axis_dim_limit, M, N, tp);
+        return Status::OK();
+      case sizeof(uint32_t):
+        GatherScalars(reinterpret_cast<uint32_t*>(dst_base), reinterpret_cast<const uint32_t*>(src_base), indices_data,
+                      axis_dim_limit, M, N, tp);
+        return Status::OK();
+      case sizeof(uint64_t):
+        GatherScalars(reinterpret_cast<uint64_t*>(dst_base), reinterpret_cast<const uint64_t*>(src_base), indices_data,
+                      axis_dim_limit, M, N, tp);
+        return Status::OK();
+      default:
+        break;
+    }
+  }
+
+  const int64_t block = block_size / static_cast<int64_t>(element_bytes);
+  const auto lambda = [&](int64_t index) {
     int64_t batch = index / N;
     int64_t i = index % N;
 
     const int64_t src_offset_batch = batch * data_batch_bytes;
     const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
+    const int64_t src_offset = src_offset_batch + adjusted_index(i) * block_size;
     const int64_t dst_offset = dst_offset_batch + i * block_size;
 
     if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+      const auto* src = reinterpret_cast<const std::string*>(src_base) + src_offset / element_bytes;
+      std::copy(src, src + block, reinterpret_cast<std::string*>(dst_base) + dst_offset / element_bytes);
     } else {
       memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
     }
   };
-  concurrency::ThreadPool::TryParallelFor(tp, M * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
-                                              lambda(index);
-                                            }
-                                          });
+  concurrency::ThreadPool::TryParallelFor(
+      tp, M * N, TensorOpCost{static_cast<double>(block_size), static_cast<double>(block_size), 1.0},
+      [&lambda](ptrdiff_t first, ptrdiff_t last) {
+        for (int64_t index = static_cast<int64_t>(first), end = static_cast<int64_t>(last); index < end; ++index) {
+          lambda(index);
+        }
+      });
 
   return Status::OK();
 }
@@ -2,7 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gather_elements.h"
-#include "onnxruntime_config.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -86,26 +86,12 @@ static inline void increment_over_inner_dim(std::vector<int64_t>& current_dims,
   }
 }
 
-template <typename Tin>
-static inline int64_t GetNegativeIndexAdjustedValue(const Tin* indices_data, Tin index, int64_t axis, const TensorShape& input_shape) {
-  int64_t retval = -1;
-  if (indices_data[index] < 0) {
-    retval = static_cast<int64_t>(indices_data[index] + input_shape[axis]);
-  } else {
-    retval = static_cast<int64_t>(indices_data[index]);
-  }
-  return retval;
-}
-
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#ifdef HAS_CLASS_MEMACCESS
-#pragma GCC diagnostic ignored "-Wclass-memaccess"
-#endif
-#endif
+// Every 'inner_dimension' chunk of the output is independent, so the chunks are spread over the thread pool.
+// Elements are copied with a typed assignment: T is std::string for string tensors, and an unsigned integer
+// of the element size for every other type.
 template <bool is_string, typename T, typename Tin>
 static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
-                      Tensor* output_tensor, int64_t axis) {
+                      Tensor* output_tensor, int64_t axis, concurrency::ThreadPool* tp) {
   // get pointer to input data
   // optimizer will remove the redundant if/else block based on 'is_string' template parameter
   const T* input_data = nullptr;
@@ -142,77 +128,50 @@ static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
                 lower_index_limit, " , ", upper_index_limit, "]. Actual value is ", indices_val);
   }
 
-  int64_t num_inner_dim = calculate_num_inner_dim(indices_shape);
-  int64_t inner_dim_size = indices_shape[input_rank - 1];
-  bool processing_inner_dim = (axis == input_rank - 1) ? true : false;
-
-  int64_t base_offset = 0;
-  Tin indices_counter = -1;
-  int64_t output_counter = -1;
-  size_t element_size = input_tensor->DataType()->Size();
-
-  std::vector<int64_t> process_dims(input_rank, 0);
-
-  if (!processing_inner_dim) {
-    while (num_inner_dim-- != 0) {
-      base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
-
-      // process 1 chunk of 'inner dimension' length
-      // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-      if (is_string) {
-        for (int64_t i = 0; i < inner_dim_size; ++i) {
-          output_data[++output_counter] =
-              input_data[base_offset +
-                         (GetNegativeIndexAdjustedValue<Tin>(indices_data, ++indices_counter, axis, input_shape) *
-                          input_shape_pitches[axis]) +
-                         i];
-        }
-      } else {
-        for (int64_t i = 0; i < inner_dim_size; ++i) {
-          // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-          memcpy(output_data,
-                 input_data + (base_offset + (GetNegativeIndexAdjustedValue<Tin>(indices_data, ++indices_counter, axis, input_shape) * input_shape_pitches[axis]) + i) * element_size,
-                 element_size);
-          output_data += element_size;
-        }
-      }
-      increment_over_inner_dim(process_dims, indices_shape);
+  const int64_t num_inner_dim = calculate_num_inner_dim(indices_shape);
+  const int64_t inner_dim_size = indices_shape[input_rank - 1];
+  const bool processing_inner_dim = (axis == input_rank - 1) ? true : false;
+  const int64_t axis_dim = input_shape[axis];
+  const int64_t axis_pitch = input_shape_pitches[axis];
+
+  const TensorOpCost cost{static_cast<double>(inner_dim_size * (sizeof(T) + sizeof(Tin))),
+                          static_cast<double>(inner_dim_size * sizeof(T)),
+                          static_cast<double>(inner_dim_size * 2)};
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(num_inner_dim), cost,
+                                          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    // position of the first chunk of this range in 'indices' (the innermost dimension stays 0)
+    std::vector<int64_t> process_dims(input_rank, 0);
+    int64_t remaining = static_cast<int64_t>(first);
+    for (int64_t i = input_rank - 2; i >= 0; --i) {
+      process_dims[i] = remaining % indices_shape[i];
+      remaining /= indices_shape[i];
     }
-  }
-  // we special-case inner dim as we can weed-out some unnecessary computations in element offset calculations
-  else {
-    while (num_inner_dim-- != 0) {
-      base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
+
+    for (std::ptrdiff_t chunk = first; chunk < last; ++chunk) {
+      const int64_t base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
+      const Tin* chunk_indices = indices_data + chunk * inner_dim_size;
+      T* chunk_output = output_data + chunk * inner_dim_size;
 
       // process 1 chunk of 'inner dimension' length
-      // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-      if (is_string) {
+      // we special-case inner dim as we can weed-out some unnecessary computations in element offset calculations
+      if (processing_inner_dim) {
         for (int64_t i = 0; i < inner_dim_size; ++i) {
           // for innermost axis, input_shape_pitches[axis] = 1 (so no need to multiply)
-          output_data[++output_counter] =
-              input_data[base_offset +
-                         GetNegativeIndexAdjustedValue<Tin>(indices_data, ++indices_counter, axis, input_shape)];
+          const int64_t index = static_cast<int64_t>(chunk_indices[i]);
+          chunk_output[i] = input_data[base_offset + (index < 0 ? index + axis_dim : index)];
         }
       } else {
         for (int64_t i = 0; i < inner_dim_size; ++i) {
-          // for innermost axis, input_shape_pitches[axis] = 1 (so no need to multiply)
-          // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-          memcpy(output_data,
-                 input_data + (base_offset +
-                               GetNegativeIndexAdjustedValue<Tin>(indices_data, ++indices_counter, axis, input_shape)) *
-                                  element_size,
-                 element_size);
-          output_data += element_size;
+          const int64_t index = static_cast<int64_t>(chunk_indices[i]);
+          chunk_output[i] = input_data[base_offset + (index < 0 ? index + axis_dim : index) * axis_pitch + i];
         }
       }
 
       increment_over_inner_dim(process_dims, indices_shape);
     }
-  }
+  });
 }
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif
 
 Status GatherElements::ValidateInputShapes(const TensorShape& input_data_shape,
                                            const TensorShape& indices_shape,
@@ -272,16 +231,45 @@ Status GatherElements::Compute(OpKernelContext* context) const {
   if (indices_shape.Size() == 0)
     return Status::OK();
 
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const bool int32_indices = indices_tensor->IsDataType<int32_t>();
+
   if (input_tensor->IsDataTypeString()) {
-    if (indices_tensor->IsDataType<int32_t>())
-      core_impl<true, std::string, int32_t>(input_tensor, indices_tensor, output_tensor, axis);
-    else
-      core_impl<true, std::string, int64_t>(input_tensor, indices_tensor, output_tensor, axis);
-  } else {
-    if (indices_tensor->IsDataType<int32_t>())
-      core_impl<false, int8_t, int32_t>(input_tensor, indices_tensor, output_tensor, axis);
+    if (int32_indices)
+      core_impl<true, std::string, int32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
     else
-      core_impl<false, int8_t, int64_t>(input_tensor, indices_tensor, output_tensor, axis);
+      core_impl<true, std::string, int64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+    return Status::OK();
+  }
+
+  switch (input_data_type->Size()) {
+    case sizeof(uint8_t):
+      if (int32_indices)
+        core_impl<false, uint8_t, int32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      else
+        core_impl<false, uint8_t, int64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint16_t):
+      if (int32_indices)
+        core_impl<false, uint16_t, int32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      else
+        core_impl<false, uint16_t, int64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint32_t):
+      if (int32_indices)
+        core_impl<false, uint32_t, int32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      else
+        core_impl<false, uint32_t, int64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint64_t):
+      if (int32_indices)
+        core_impl<false, uint64_t, int32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      else
+        core_impl<false, uint64_t, int64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                             "GatherElements op: Unsupported element size ", input_data_type->Size());
   }
 
   return Status::OK();
@@ -4,6 +4,8 @@
 #include "gather_nd.h"
 #include "core/platform/threadpool.h"
 
+#include <atomic>
+
 namespace onnxruntime {
 
 // Register a kernel for kMsDomain (contrib op) GatherND
@@ -73,7 +75,9 @@ Status GatherNDBase::PrepareForCompute(const TensorShape& input_shape, const Ten
     sizes_from_slice_dims[i] = input_shape.SizeFromDimension(batch_dims_ + i + 1);
   }
 
-  int64_t err_index = 0;
+  // written by whichever slice finds an invalid index first
+  std::atomic<bool> has_invalid_index{false};
+  std::atomic<int64_t> err_index{0};
   p.element_bytes = bytes_per_value;
   p.element_count_per_slice = slice_size;
   p.bytes_per_slice = p.element_bytes * p.element_count_per_slice;
@@ -92,7 +96,9 @@ Status GatherNDBase::PrepareForCompute(const TensorShape& input_shape, const Ten
       const auto upper_limit = input_shape[batch_dims_ + dim_idx];
       const auto lower_limit = -upper_limit;
       if (index < lower_limit || index >= upper_limit) {
-        err_index = index;
+        if (!has_invalid_index.exchange(true)) {
+          err_index = index;
+        }
         break;
       }
       if (index < 0) index += upper_limit;
@@ -104,15 +110,18 @@ Status GatherNDBase::PrepareForCompute(const TensorShape& input_shape, const Ten
   };
 
   concurrency::ThreadPool::TryParallelFor(
-      tp, num_slices, static_cast<double>(num_slice_dims),
+      tp, num_slices,
+      TensorOpCost{static_cast<double>(num_slice_dims * sizeof(Tind)), static_cast<double>(sizeof(uint64_t)),
+                   static_cast<double>(num_slice_dims * 2)},
       [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
+        for (int64_t slice_idx = static_cast<int64_t>(first), end = static_cast<int64_t>(last); slice_idx < end; ++slice_idx) {
           lambda(slice_idx);
         }
       });
 
-  return err_index == 0 ? Status::OK()
-                        : ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid index found, index = ", err_index);
+  return !has_invalid_index ? Status::OK()
+                            : ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid index found, index = ",
+                                              err_index.load());
 }
 
 template Status GatherNDBase::PrepareForCompute<int32_t>(const TensorShape&,
@@ -161,9 +170,9 @@ Status GatherND::Compute(OpKernelContext* context) const {
   auto bytes_per_value = input_tensor->DataType()->Size();
 
   if (indices_tensor->IsDataType<int32_t>()) {
-    PrepareForCompute<int32_t>(input_shape, indices_tensor, bytes_per_value, p, tp);
+    ORT_RETURN_IF_ERROR(PrepareForCompute<int32_t>(input_shape, indices_tensor, bytes_per_value, p, tp));
   } else if (indices_tensor->IsDataType<int64_t>()) {
-    PrepareForCompute<int64_t>(input_shape, indices_tensor, bytes_per_value, p, tp);
+    ORT_RETURN_IF_ERROR(PrepareForCompute<int64_t>(input_shape, indices_tensor, bytes_per_value, p, tp));
   } else {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices tensor data type not supported");
   }
@@ -177,9 +186,10 @@ Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) con
            p.bytes_per_slice);
   };
   concurrency::ThreadPool::TryParallelFor(
-      tp, p.slice_offsets.size(), static_cast<double>(p.bytes_per_slice),
+      tp, p.slice_offsets.size(),
+      TensorOpCost{static_cast<double>(p.bytes_per_slice), static_cast<double>(p.bytes_per_slice), 1.0},
       [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
+        for (int64_t slice_idx = static_cast<int64_t>(first), end = static_cast<int64_t>(last); slice_idx < end; ++slice_idx) {
           lambda(slice_idx);
         }
       });
@@ -196,7 +206,7 @@ Status GatherND::GatherString(const Prepare& p, concurrency::ThreadPool* tp) con
   concurrency::ThreadPool::TryParallelFor(
       tp, p.slice_offsets.size(), static_cast<double>(p.element_count_per_slice),
       [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
+        for (int64_t slice_idx = static_cast<int64_t>(first), end = static_cast<int64_t>(last); slice_idx < end; ++slice_idx) {
           lambda(slice_idx);
         }
       });
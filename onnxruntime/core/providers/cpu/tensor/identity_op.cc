@@ -28,13 +28,13 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Identity,
     1,
     12,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).Alias(0, 0),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).Alias(0, 0).Trivial(),
     IdentityOp<false>);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Identity,
     13,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).Alias(0, 0),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).Alias(0, 0).Trivial(),
     IdentityOp<false>);
 
 }  // namespace onnxruntime
@@ -4,9 +4,9 @@
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
 #include <cassert>
-#include <vector>
 
-#include "core/util/math_cpuonly.h"
+#include "core/providers/cpu/tensor/compaction.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -59,59 +59,36 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : X_shape.NumDimensions();
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(X_shape.Size() * coordinate_size);
-
+  const int64_t coordinate_size = X_shape.IsScalar() ? 1 : static_cast<int64_t>(X_shape.NumDimensions());
+  const TensorPitches X_pitches(X_shape);
   const T* data = X->Data<T>();
 
-  if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
-    }
-  } else {
-    std::vector<int64_t> coordinate(coordinate_size, 0);
-
-    // as we iterate the entries, increment the coordinate for the current entry
-    // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
-      for (int64_t idx = coordinate_size - 1; idx >= 0; --idx) {
-        int64_t& cur_coord = coordinate[idx];
-        if (cur_coord != X_shape[idx] - 1) {
-          ++cur_coord;
-          break;
+  int64_t num_non_zero_values = 0;
+  int64_t* y_data = nullptr;
+
+  // the coordinates of the non zero values are the columns of the output, so they are counted first to find where
+  // each thread writes its share of the columns
+  ParallelCompact(
+      context->GetOperatorThreadPool(), X_shape.Size(),
+      [data](std::ptrdiff_t i) { return data[i] != T{}; },
+      [&](int64_t num_selected) {
+        num_non_zero_values = num_selected;
+        Tensor* const Y = context->Output(0, {coordinate_size, num_non_zero_values});
+        ORT_ENFORCE(Y, "failed to get first output!");
+        y_data = Y->MutableData<int64_t>();
+      },
+      [&](std::ptrdiff_t i, int64_t output_index) {
+        if (X_shape.IsScalar()) {
+          y_data[output_index] = 0;
+          return;
+        }
+
+        int64_t remainder = i;
+        for (int64_t axis = 0; axis < coordinate_size; ++axis) {
+          y_data[axis * num_non_zero_values + output_index] = remainder / X_pitches[axis];
+          remainder %= X_pitches[axis];
         }
-        cur_coord = 0;
-      }
-    };
-
-    for (size_t i = 0, end = X_shape.Size(); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
-      }
-
-      increment_coordinate();
-    }
-  }
-
-  const Eigen::Index num_non_zero_values = non_zero_indices_buffer.size() / coordinate_size;
-
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
-
-  Tensor* const Y = context->Output(0, {coordinate_size, num_non_zero_values});
-  ORT_ENFORCE(Y, "failed to get first output!");
-
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+      });
 
   return Status::OK();
 }
@@ -165,7 +165,7 @@ Status OneHotOp<in_type, out_type, depth_type>::Compute(OpKernelContext* p_op_ke
 
   // allocate output
   const auto* values_data = values->Data<out_type>();
-  Tensor* output = p_op_kernel_context->Output(0, TensorShape(output_shape));
+  Tensor* output = p_op_kernel_context->Output(0, output_shape);
 
   // edge case where we have a dim with a value of 0
   if (output->Shape().Size() == 0)
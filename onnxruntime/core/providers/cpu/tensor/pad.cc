@@ -8,9 +8,13 @@
 #pragma warning(disable : 4996)
 #endif
 #include "core/util/math.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/pad.h"
 #include "core/providers/cpu/tensor/utils.h"
 
+#include <functional>
+#include <numeric>
+
 namespace onnxruntime {
 
 // Register a kernel for kMsDomain (contrib op) Pad
@@ -71,34 +75,28 @@ ONNX_CPU_OPERATOR_KERNEL(
                                             DataTypeImpl::GetTensorType<uint8_t>()}),
     Pad);
 
-// This is the general padding method to n-dimensionally do edge or reflection padding (based on the inputDelta values)
+// This is the general padding method to n-dimensionally do edge or reflection padding (based on the input_pitch
+// values). Each block is a contiguous row of the output, so it's copied as a whole.
 template <typename T>
-static void PadAxis(T* output, T* input, ptrdiff_t input_delta, ptrdiff_t input_pitch,
-                    size_t block_size, size_t block_count) {
+static void PadAxis(T* output, T* input, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
   for (size_t block_index = 0; block_index < block_count; block_index++) {
-    for (size_t i = 0; i < block_size; i++) {
-      *output++ = *input;
-      input += input_delta;
-    }
-    input += input_pitch;
+    std::copy_n(input, block_size, output);
+    output += block_size;
+    input += block_size + input_pitch;
   }
 }
 
-// These are optimizations of PadAxis. The inner loop is removed since the innermost axis has a blockSize of 1,
-// and inputPitch and inputDelta are just a single value added each iteration.
+// This is an optimization of PadAxis for reflection padding of the innermost axis, which is the block_count
+// values ending at input in reverse order.
 template <typename T>
-static void PadInnermostAxis(T* output, T* input, ptrdiff_t input_delta, size_t block_count) {
-  for (size_t block_index = 0; block_index < block_count; block_index++) {
-    *output++ = *input;
-    input += input_delta;
-  }
+static void PadInnermostAxisReflect(T* output, const T* input, size_t block_count) {
+  std::reverse_copy(input + 1 - block_count, input + 1, output);
 }
 
 // For constant padding, there is no input, just a size to write the constant to
 template <typename T>
 static void PadAxisConstant(T* output, T constant, size_t size) {
-  for (size_t i = 0; i < size; i++)
-    *output++ = constant;
+  std::fill_n(output, size, constant);
 }
 
 Status PadBase::HandleDimValueZero(const Mode& mode, const TensorShape& input_shape, TensorShape& output_shape) {
@@ -186,6 +184,29 @@ static void FlattenInnerShape(const std::vector<int64_t>& input_dims, const std:
   reshaped_dims[inner_axis] = inner_size;
 }
 
+// Edge and reflect padding copy whole rows of the padded axes, so for them the padded axis can't be flattened with
+// the no padding inner most Axis as FlattenInnerShape does. Only the no padding inner most Axis are flattened.
+// For example, for a shape of [2,3,4] with padding [1,0,0,1,0,0], can be flatten as [2,12] with padding [1,0,1,0].
+static void FlattenInnerShapeWithoutPadding(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& pads,
+                                            const std::vector<int64_t>& slices, std::vector<int64_t>& reshaped_dims) {
+  size_t dims_count = input_dims.size();
+
+  // Find the first of the inner most axes without padding.
+  size_t inner_axis = dims_count;
+  while (inner_axis > 0 &&
+         pads[inner_axis - 1] == 0 && pads[inner_axis - 1 + dims_count] == 0 &&
+         slices[inner_axis - 1] == 0 && slices[inner_axis - 1 + dims_count] == 0) {
+    --inner_axis;
+  }
+
+  reshaped_dims = input_dims;
+  if (inner_axis + 1 < dims_count) {
+    reshaped_dims.resize(inner_axis + 1);
+    reshaped_dims[inner_axis] = std::accumulate(input_dims.begin() + inner_axis, input_dims.end(),
+                                                static_cast<int64_t>(1), std::multiplies<int64_t>());
+  }
+}
+
 static void ReshapePads(const std::vector<int64_t>& src_pad, size_t src_dim_count, size_t new_dim_count,
                         size_t inner_no_pad_size, std::vector<int64_t>& reshaped_pad) {
   size_t inner_axis = new_dim_count - 1;
@@ -215,7 +236,11 @@ static Status PadImpl(OpKernelContext* ctx,
 
   // Reshape input dims
   std::vector<int64_t> reshaped_input_dims;
-  FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
+  if (mode == Mode::Constant) {
+    FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
+  } else {
+    FlattenInnerShapeWithoutPadding(output_dims, pads, slices, reshaped_input_dims);
+  }
 
   // Reshape padding
   size_t new_dims_count = reshaped_input_dims.size();
@@ -227,6 +252,28 @@ static Status PadImpl(OpKernelContext* ctx,
   ReshapePads(pads, data_rank, new_dims_count, inner_no_pad_size, reshaped_pad);
   ReshapePads(slices, data_rank, new_dims_count, inner_no_pad_size, reshaped_slice);
 
+  // Merge the outer axes without padding or slicing into the outermost axis. Its rows are padded independently
+  // of each other so they are split between the threads.
+  size_t outer_axes = 0;
+  while (outer_axes < inner_axis &&
+         reshaped_pad[outer_axes] == 0 && reshaped_pad[outer_axes + new_dims_count] == 0 &&
+         reshaped_slice[outer_axes] == 0 && reshaped_slice[outer_axes + new_dims_count] == 0) {
+    ++outer_axes;
+  }
+
+  if (outer_axes > 1) {
+    const int64_t outer_size = std::accumulate(reshaped_input_dims.begin(), reshaped_input_dims.begin() + outer_axes,
+                                               static_cast<int64_t>(1), std::multiplies<int64_t>());
+    for (auto* reshaped : {&reshaped_pad, &reshaped_slice}) {
+      reshaped->erase(reshaped->begin() + new_dims_count + 1, reshaped->begin() + new_dims_count + outer_axes);
+      reshaped->erase(reshaped->begin() + 1, reshaped->begin() + outer_axes);
+    }
+    reshaped_input_dims.erase(reshaped_input_dims.begin() + 1, reshaped_input_dims.begin() + outer_axes);
+    reshaped_input_dims[0] = outer_size;
+    new_dims_count = reshaped_input_dims.size();
+    inner_axis = new_dims_count - 1;
+  }
+
   std::vector<int64_t> reshaped_output_dims = reshaped_input_dims;
   std::vector<int64_t> input_starts;
   std::vector<int64_t> input_extents;
@@ -252,116 +299,137 @@ static Status PadImpl(OpKernelContext* ctx,
   }
 
   TensorShape input_shape(reshaped_input_dims);
-  SliceIterator<T> input(input_tensor, input_shape, input_starts, input_extents, {});
 
   // output_shape need to keep original.
   TensorShape output_shape(output_dims);
   auto& output_tensor = *ctx->Output(0, output_shape);
-  auto* output = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
+  T* output_start = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
 
   TensorPitches output_pitches(reshaped_output_dims);
-  size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
-
-  // Initial skip, sum up the begin padding on each axis
-  for (size_t i = 0; i < new_dims_count; i++)
-    alignSkip += reshaped_pad[i] * output_pitches[i];
 
-  ExtentAxisCounters input_counters(input_extents);
-
-  switch (mode) {
-    case Mode::Constant:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, prePad);
-          PadAxisConstant(output, value, postPad);
-          output += postPad;
-          alignSkip = prePad;
+  // Pads the rows [begin, end) of the outermost axis of the input
+  auto pad_rows = [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    std::vector<int64_t> block_starts(input_starts);
+    std::vector<int64_t> block_extents(input_extents);
+    block_starts[0] += begin;
+    block_extents[0] = end - begin;
+
+    SliceIterator<T> input(input_tensor, input_shape, block_starts, block_extents, {});
+    T* output = output_start + begin * output_pitches[0];
+    size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
+
+    // Initial skip, sum up the begin padding on each axis
+    for (size_t i = 0; i < new_dims_count; i++)
+      alignSkip += reshaped_pad[i] * output_pitches[i];
+
+    ExtentAxisCounters input_counters(block_extents);
+
+    switch (mode) {
+      case Mode::Constant:
+        // Loop over the output tensor, writing out padding between the blocks of copied data
+        // On loop entry, 'pad' is already set to the first continuous block of padding, and
+        // after every pass through the inner loop it gets set to the next continuous pad size.
+        while (input_counters) {
+          output += alignSkip;
+          {
+            T* axisStart = output;
+            output = input.CopyInnermostAxisSolitaryInnerStep(output);
+
+            int64_t prePad = reshaped_pad[inner_axis];
+            int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
+            PadAxisConstant(axisStart - prePad, value, prePad);
+            PadAxisConstant(output, value, postPad);
+            output += postPad;
+            alignSkip = prePad;
+          }
+          // Calculate the size of the next block of padding
+          // (skipping over the innermost axis since that's already done)
+          while (input_counters.Increment()) {
+            ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
+            T* axisStart = output - inner_pitch * block_extents[input_counters.Axis()];
+            int64_t prePad = reshaped_pad[input_counters.Axis()];
+            int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
+            PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
+            PadAxisConstant(output, value, postPad * inner_pitch);
+            output += inner_pitch * postPad;
+            alignSkip += inner_pitch * prePad;
+          }
         }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
-          PadAxisConstant(output, value, postPad * inner_pitch);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
-      break;
-
-    case Mode::Edge:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, *axisStart, prePad);
-          PadAxisConstant(output, *(output - 1), postPad);
-          output += postPad;
-          alignSkip = prePad;
+        break;
+
+      case Mode::Edge:
+        // Loop over the output tensor, writing out padding between the blocks of copied data
+        // On loop entry, 'pad' is already set to the first continuous block of padding, and
+        // after every pass through the inner loop it gets set to the next continuous pad size.
+        while (input_counters) {
+          output += alignSkip;
+          {
+            T* axisStart = output;
+            output = input.CopyInnermostAxisSolitaryInnerStep(output);
+
+            int64_t prePad = reshaped_pad[inner_axis];
+            int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
+            PadAxisConstant(axisStart - prePad, *axisStart, prePad);
+            PadAxisConstant(output, *(output - 1), postPad);
+            output += postPad;
+            alignSkip = prePad;
+          }
+          // Calculate the size of the next block of padding
+          // (skipping over the innermost axis since that's already done)
+          while (input_counters.Increment()) {
+            ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
+            T* axisStart = output - inner_pitch * block_extents[input_counters.Axis()];
+            int64_t prePad = reshaped_pad[input_counters.Axis()];
+            int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
+            PadAxis(axisStart - prePad * inner_pitch, axisStart, -inner_pitch, inner_pitch, prePad);
+            PadAxis(output, output - inner_pitch, -inner_pitch, inner_pitch, postPad);
+            output += inner_pitch * postPad;
+            alignSkip += inner_pitch * prePad;
+          }
         }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
-          PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
+        break;
+
+      case Mode::Reflect:
+        // Loop over the output tensor, writing out padding between the blocks of copied data
+        // On loop entry, 'pad' is already set to the first continuous block of padding, and
+        // after every pass through the inner loop it gets set to the next continuous pad size.
+        while (input_counters) {
+          output += alignSkip;
+          {
+            T* axisStart = output;
+            output = input.CopyInnermostAxisSolitaryInnerStep(output);
+
+            int64_t prePad = reshaped_pad[inner_axis];
+            int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
+            PadInnermostAxisReflect(axisStart - prePad, axisStart + prePad, prePad);
+            PadInnermostAxisReflect(output, output - 2, postPad);
+            output += postPad;
+            alignSkip = prePad;
+          }
+          // Calculate the size of the next block of padding
+          // (skipping over the innermost axis since that's already done)
+          while (input_counters.Increment()) {
+            ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
+            T* axisStart = output - inner_pitch * block_extents[input_counters.Axis()];
+            int64_t prePad = reshaped_pad[input_counters.Axis()];
+            int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
+            PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, -inner_pitch * 2,
+                    inner_pitch, prePad);
+            PadAxis(output, output - 2 * inner_pitch, -inner_pitch * 2, inner_pitch, postPad);
+            output += inner_pitch * postPad;
+            alignSkip += inner_pitch * prePad;
+          }
         }
-      }
-      break;
+        break;
+    }
+  };
 
-    case Mode::Reflect:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadInnermostAxis(axisStart - prePad, axisStart + prePad, -1 /* inputDelta */, prePad);
-          PadInnermostAxis(output, output - 2, -1 /* inputDelta */, postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2,
-                  inner_pitch, prePad);
-          PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
-      break;
+  if (outer_axes > 0) {
+    const double row_bytes = static_cast<double>(output_pitches[0] * sizeof(T));
+    concurrency::ThreadPool::TryParallelFor(ctx->GetOperatorThreadPool(), input_extents[0],
+                                            TensorOpCost{row_bytes, row_bytes, 0}, pad_rows);
+  } else {
+    pad_rows(0, input_extents[0]);
   }
 
   return Status::OK();
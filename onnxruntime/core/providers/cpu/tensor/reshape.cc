@@ -10,6 +10,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     12,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("shape", DataTypeImpl::GetTensorType<int64_t>()),
     Reshape);
@@ -19,6 +20,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     13,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("shape", DataTypeImpl::GetTensorType<int64_t>()),
     Reshape);
@@ -29,6 +31,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     4,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Reshape_1);
 
@@ -5,6 +5,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
+#include "core/platform/threadpool.h"
 #ifdef ENABLE_TRAINING
 #include "orttraining/training_ops/cpu/tensor/gather_elements_grad_impl.h"
 #endif
@@ -62,7 +63,7 @@ struct Func_Assignment {
 
 template <class Tin, class Tdata, typename FuncT>
 Status CopyScatterData(const FuncT& func, const Tensor* data_input, const Tensor* indices_input, const Tensor* updates_input,
-                       const int64_t axis, Tensor* data_output) {
+                       const int64_t axis, Tensor* data_output, concurrency::ThreadPool* tp) {
   const TensorShape& input_data_shape = data_input->Shape();
   const Tin* indices_data_raw = indices_input->template Data<Tin>();
   const auto num_indices = indices_input->Shape().Size();
@@ -106,41 +107,27 @@ Status CopyScatterData(const FuncT& func, const Tensor* data_input, const Tensor
   }
 
   // Now poke updates
-
   const auto& upd_shape = updates_input->Shape();
   const auto num_dims = input_data_shape.NumDimensions();
   assert(num_dims > 0);
 
-  // Allocate and zero out counts. The input/output is of the same rank as
-  // indices/updates but the actual dimensions of indices/updates must be less or equal
-  // than that of input/output because we can update no more elements than
-  // the input contains. As we walk through the indices/updates
-  // we maintain dimension count as we will need to use it
-  // to compute output offset but using input/output dim values.
-  // We treat the whole array as a number where each element having
-  // different cardinality according to the upd_shape dimensions.
-  // As each counter reaches its max (upd_shape) it resets to zero
-  // and we carry to the more significant dim (right to left)
-  std::vector<int64_t> dim_counters(num_dims);
-
   // This vector contains number of elements under the dimension.
   // For example, for the dimensions of [4, 2, 3] the vector
   // would contain [6, 3, 1] since for each count of dim 1 it
   // contains 3 elements of dim 2.
   // For each count of dim 0 we would have 2x3=6 elements.
   // The last value is always 1.
-  // We use it to compute output element offset. For a given value of
-  // counters we multiple each counter value per corresponding entry of dim_block_size value
-  // and add up resulting the output element offset. However, for dimensions
-  // that are equal to the specified axis value we take indices_data[index]
-  // instead of the counter value.
+  // We use it to compute output element offset. For a given update
+  // we multiple each of its coordinates per corresponding entry of dim_block_size value
+  // and add up resulting the output element offset. However, for the dimension
+  // that is equal to the specified axis value we take indices_data[index]
+  // instead of the coordinate.
   // E.g. for 3-dim and axis=0
   //    output[indices[i][j][k]][j][k] = updates[i][j][k]
   // for axis 1
   //    output[i][indices[i][j][k]][k] = updates[i][j][k]
   // and so on
   std::vector<int64_t> dim_block_size(num_dims);
-
   dim_block_size.back() = 1;
   if (num_dims > 1) {
     // We start at num_dims - 2 because we already pre-populated
@@ -151,41 +138,47 @@ Status CopyScatterData(const FuncT& func, const Tensor* data_input, const Tensor
   }
 
   const auto* update_data = static_cast<const Tdata*>(updates_input->DataRaw());
-  // For every update we compute the destination offset and copy it there
-  for (int64_t index = 0; index < num_indices;) {
-    const Tin axis_idx = indices_data[index];
-
-    // Compute the offset
-    // See comments above for dim_block_size
-    size_t dst_offset = 0;
-    for (size_t i = 0; i < num_dims; ++i) {
-      if (i == size_t(axis)) {
-        // replace the counter with the update index for this dim
-        dst_offset += axis_idx * dim_block_size[i];
-      } else {
-        dst_offset += dim_counters[i] * dim_block_size[i];
-      }
-    }
 
-    func(dst_base + dst_offset, update_data + index);
+  // Updates are walked as 'lines' along the axis: all updates that share the coordinates of every other
+  // dimension. Updates of different lines always write different output elements, so lines run in parallel
+  // without any uniqueness check on the indices. Within a line the updates are applied in order, so
+  // repeated indices keep their serial semantics (the last assignment wins, or every update accumulates).
+  const int64_t upd_axis_dim = upd_shape[axis];
+  const int64_t upd_inner_size = upd_shape.SizeFromDimension(axis + 1);
+  const int64_t num_lines = upd_axis_dim == 0 ? 0 : num_indices / upd_axis_dim;
+  const int64_t axis_block_size = dim_block_size[axis];
+
+  const TensorOpCost cost{static_cast<double>(upd_axis_dim * (sizeof(Tin) + sizeof(Tdata))),
+                          static_cast<double>(upd_axis_dim * sizeof(Tdata)),
+                          static_cast<double>(upd_axis_dim * 2 + num_dims)};
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(num_lines), cost,
+                                          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t line = first; line < last; ++line) {
+      // offset of the line's first update, and the output offset of its coordinates except the axis one
+      const int64_t outer = line / upd_inner_size;
+      const int64_t inner = line % upd_inner_size;
+      const int64_t update_base = outer * upd_axis_dim * upd_inner_size + inner;
+
+      size_t dst_base_offset = 0;
+      int64_t remaining = inner;
+      for (auto i = int64_t(num_dims - 1); i > axis; --i) {
+        dst_base_offset += (remaining % upd_shape[i]) * dim_block_size[i];
+        remaining /= upd_shape[i];
+      }
+      remaining = outer;
+      for (auto i = int64_t(axis - 1); i >= 0; --i) {
+        dst_base_offset += (remaining % upd_shape[i]) * dim_block_size[i];
+        remaining /= upd_shape[i];
+      }
 
-    if (++index == num_indices) {
-      break;
-    }
-    // Increment counters
-    // See comments for dim_counters above
-    for (auto i = int64_t(num_dims - 1); i >= 0; --i) {
-      auto v = ++dim_counters[i];
-      assert(v <= upd_shape[i]);
-      if (v < upd_shape[i]) {
-        // No carry, done
-        break;
+      for (int64_t j = 0; j < upd_axis_dim; ++j) {
+        const int64_t index = update_base + j * upd_inner_size;
+        func(dst_base + dst_base_offset + indices_data[index] * axis_block_size, update_data + index);
       }
-      // No carry for the most significant dim
-      assert(i > 0);
-      dim_counters[i] = 0;
     }
-  }
+  });
+
   return Status::OK();
 }
 
@@ -246,9 +239,11 @@ Status Scatter::Compute(OpKernelContext* context) const {
   MLDataType Tdata_type = data_input->DataType();
   Status status;
   if (indices_input->IsDataType<int32_t>()) {
-    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt32Index, data_input, indices_input, updates_input, axis, data_output);
+    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt32Index, data_input, indices_input, updates_input, axis, data_output,
+                                   context->GetOperatorThreadPool());
   } else if (indices_input->IsDataType<int64_t>()) {
-    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt64Index, data_input, indices_input, updates_input, axis, data_output);
+    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt64Index, data_input, indices_input, updates_input, axis, data_output,
+                                   context->GetOperatorThreadPool());
   } else {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expecting indices to be either int32_t or int64_t");
   }
@@ -268,8 +263,9 @@ struct Func_Add {
 
 template <class Tin, class Tdata>
 Status GatherElementsGradImpl(const Tensor* indices_input, const Tensor* updates_input,
-                              const int64_t axis, Tensor* data_output) {
-  return CopyScatterData<Tin, Tdata>(Func_Add<Tdata>(), data_output, indices_input, updates_input, axis, data_output);
+                              const int64_t axis, Tensor* data_output, concurrency::ThreadPool* tp) {
+  return CopyScatterData<Tin, Tdata>(Func_Add<Tdata>(), data_output, indices_input, updates_input, axis, data_output,
+                                     tp);
 }
 
 #define GATHER_ELEMENTS_GRAD_IMPL_SPECIALIZED(Tin, Tdata)         \
@@ -277,7 +273,8 @@ Status GatherElementsGradImpl(const Tensor* indices_input, const Tensor* updates
       const Tensor* indices_input,                                \
       const Tensor* updates_input,                                \
       const int64_t axis,                                         \
-      Tensor* data_output)
+      Tensor* data_output,                                        \
+      concurrency::ThreadPool* tp)
 
 #define GATHER_ELEMENTS_GRAD_IMPL_TDATA_SPECIALIZED(Tdata)  \
   GATHER_ELEMENTS_GRAD_IMPL_SPECIALIZED(int32_t, Tdata);    \
@@ -100,6 +100,7 @@ Status ScatterNDBase::PrepareForCompute(OpKernelContext* context, Prepare& p) co
   p.element_bytes = input_tensor->DataType()->Size();
   p.element_to_copy = input_shape.SizeFromDimension(last_indice_dimension);
   p.bytes_to_copy = p.element_bytes * p.element_to_copy;
+  p.output_slice_count = input_shape.SizeToDimension(last_indice_dimension);
   auto indice_offset = static_cast<const Tind*>(indice_tensor->DataRaw());
   auto offset_count = indice_shape.Size() / last_indice_dimension;  // Times to copy
   p.element_offsets.assign(offset_count, 0LL);
@@ -130,18 +131,45 @@ Status ScatterND::Compute(OpKernelContext* context) const {
   Prepare p;
   concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
   ORT_RETURN_IF_ERROR(PrepareForCompute<int64_t>(context, p));
+
+  // Updates are only spread over threads when no two of them write the same output slice.
+  // With repeated indices the serial order decides which update lands, as it would for a single thread,
+  // and no output element is written concurrently.
+  if (tp != nullptr && !HasUniqueOffsets(p)) {
+    tp = nullptr;
+  }
+
   return nullptr == p.input_str_base ? ScatterNumber(p, tp) : ScatterString(p, tp);
 }
 
+bool ScatterND::HasUniqueOffsets(const Prepare& p) {
+  if (p.element_offsets.size() < 2 || p.element_to_copy == 0) {
+    return true;
+  }
+
+  // every offset is the start of one of the output_slice_count slices
+  std::vector<bool> written(p.output_slice_count, false);
+  for (const auto offset : p.element_offsets) {
+    const auto slice = offset / p.element_to_copy;
+    if (written[slice]) {
+      return false;
+    }
+    written[slice] = true;
+  }
+  return true;
+}
+
 Status ScatterND::ScatterNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
   auto lambda = [&](int64_t i) {
     memcpy(p.output_base + p.element_offsets[i] * p.element_bytes,
            p.input_base + i * p.bytes_to_copy,
            p.bytes_to_copy);
   };
-  concurrency::ThreadPool::TryParallelFor(tp, p.element_offsets.size(), static_cast<double>(p.bytes_to_copy),
+  concurrency::ThreadPool::TryParallelFor(tp, p.element_offsets.size(),
+                                          TensorOpCost{static_cast<double>(p.bytes_to_copy),
+                                                       static_cast<double>(p.bytes_to_copy), 1.0},
                                           [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
+                                            for (int64_t i = static_cast<int64_t>(first), end = static_cast<int64_t>(last); i < end; ++i) {
                                               lambda(i);
                                             }
                                           });
@@ -156,7 +184,7 @@ Status ScatterND::ScatterString(const Prepare& p, concurrency::ThreadPool* tp) c
   };
   concurrency::ThreadPool::TryParallelFor(tp, p.element_offsets.size(), static_cast<double>(p.element_to_copy),
                                           [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
+                                            for (int64_t i = static_cast<int64_t>(first), end = static_cast<int64_t>(last); i < end; ++i) {
                                               lambda(i);
                                             }
                                           });
@@ -20,6 +20,7 @@ class ScatterNDBase {
     uint64_t bytes_to_copy;
     uint64_t element_bytes;
     uint64_t element_to_copy;
+    uint64_t output_slice_count;
     std::vector<uint64_t> element_offsets;
 
     Prepare() : input_base(nullptr),
@@ -29,6 +30,7 @@ class ScatterNDBase {
                 bytes_to_copy(0),
                 element_bytes(0),
                 element_to_copy(0),
+                output_slice_count(0),
                 element_offsets(0) {}
   };  // struct Prepare
 
@@ -44,6 +46,7 @@ class ScatterND final : public OpKernel, protected ScatterNDBase {
  private:
   Status ScatterNumber(const Prepare& p, concurrency::ThreadPool* tp) const;
   Status ScatterString(const Prepare& p, concurrency::ThreadPool* tp) const;
+  static bool HasUniqueOffsets(const Prepare& p);
 };
 
 }  // namespace onnxruntime
\ No newline at end of file
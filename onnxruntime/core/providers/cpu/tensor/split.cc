@@ -135,6 +135,12 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
+    // the allocation planner may have placed the output in the input already
+    if (before_dims == 1 && output_data == input_data + input_offset) {
+      input_offset += split_size * after_dims_excluding_split;
+      continue;
+    }
+
     ::onnxruntime::math::CopyMatrix<T>(
         before_dims,                                       // M
         split_size * after_dims_excluding_split,           // N
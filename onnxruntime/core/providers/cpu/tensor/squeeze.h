@@ -65,7 +65,7 @@ class Squeeze final : public OpKernel, public SqueezeBase {
     const TensorShape& X_shape = X->Shape();
     std::vector<int64_t> output_shape = ComputeOutputShape(X_shape.GetDims(), axes_);
 
-    Tensor* Y = context->Output(0, TensorShape(output_shape));
+    Tensor* Y = context->Output(0, output_shape);
 
     CopyCpuTensor(X, Y);
 
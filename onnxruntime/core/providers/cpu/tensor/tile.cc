@@ -56,47 +56,80 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
     Tile);
 
-Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats, TensorAxisCounters& input_counters, const TensorPitches& output_pitches, size_t element_size) {
-  const auto& input_shape = input_tensor.Shape().GetDims();
-  const size_t dimension_count = input_shape.size();
+// Fills the num_copies blocks of block_size bytes starting at block with copies of the first one. Every memcpy
+// doubles the filled region, so it takes log2(num_copies) calls instead of num_copies. Blocks of a single small
+// element are filled directly since copying a few bytes at a time is dominated by the call overhead.
+template <typename T>
+static void FillWithElement(uint8_t* block, int64_t num_copies) {
+  T value;
+  memcpy(&value, block, sizeof(T));
+  std::fill_n(reinterpret_cast<T*>(block), num_copies, value);
+}
+
+static uint8_t* CopyByDoubling(uint8_t* block, size_t block_size, int64_t num_copies) {
+  const size_t total_size = block_size * static_cast<size_t>(num_copies);
+
+  if (num_copies > 1) {
+    switch (block_size) {
+      case sizeof(uint8_t):
+        FillWithElement<uint8_t>(block, num_copies);
+        return block + total_size;
+      case sizeof(uint16_t):
+        FillWithElement<uint16_t>(block, num_copies);
+        return block + total_size;
+      case sizeof(uint32_t):
+        FillWithElement<uint32_t>(block, num_copies);
+        return block + total_size;
+      case sizeof(uint64_t):
+        FillWithElement<uint64_t>(block, num_copies);
+        return block + total_size;
+      default:
+        break;
+    }
+  }
+
+  size_t filled_size = block_size;
+  while (filled_size < total_size) {
+    const size_t copy_size = std::min(filled_size, total_size - filled_size);
+    memcpy(block + filled_size, block, copy_size);
+    filled_size += copy_size;
+  }
+
+  return block + total_size;
+}
+
+void TileCoreForFixedSizeTypes(const std::vector<int64_t>& input_dims, const uint8_t* input, uint8_t* output,
+                               const int64_t* repeats, size_t element_size) {
+  const size_t dimension_count = input_dims.size();
+
+  std::vector<int64_t> output_dims(input_dims);
+  for (size_t axis = 0; axis < dimension_count; axis++) {
+    output_dims[axis] *= repeats[axis];
+  }
 
-  const auto* input = reinterpret_cast<const uint8_t*>(input_tensor.DataRaw());
-  auto* output = reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw());
+  ExtentAxisCounters input_counters(input_dims);
+  TensorPitches output_pitches(output_dims);
 
   // some helper variables that will be used along the way
   size_t block_size = 0;
-  int64_t num_repeats = 0;
-  const uint8_t* copy = nullptr;
-  const int64_t innermost_dim = input_shape[dimension_count - 1];
+  const int64_t innermost_dim = input_dims[dimension_count - 1];
 
   while (input_counters) {
     // Copy the input data over
     block_size = innermost_dim * element_size;
     memcpy(output, input, block_size);
-    output += block_size;
     input += block_size;
 
     // Tile data for the innermost axis
-    copy = output - block_size;
-    num_repeats = repeats[dimension_count - 1] - 1;
-    for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-      memcpy(output, copy, block_size);
-      output += block_size;
-    }
+    output = CopyByDoubling(output, block_size, repeats[dimension_count - 1]);
 
     // Tile data for other axes
     while (input_counters.Increment()) {
-      ptrdiff_t pitch = output_pitches[input_counters.Axis()] * input_shape[input_counters.Axis()];
+      ptrdiff_t pitch = output_pitches[input_counters.Axis()] * input_dims[input_counters.Axis()];
       block_size = pitch * element_size;
-      copy = output - block_size;
-      num_repeats = repeats[input_counters.Axis()] - 1;
-      for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-        memcpy(output, copy, block_size);
-        output += block_size;
-      }
+      output = CopyByDoubling(output - block_size, block_size, repeats[input_counters.Axis()]);
     }
   }
-  return Status::OK();
 }
 
 Status Tile::Compute(OpKernelContext* ctx) const {
@@ -132,33 +165,13 @@ Status Tile::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  TensorAxisCounters input_counters(input_tensor);
-  TensorPitches output_pitches(output_tensor);
-
-  static_assert(sizeof(float) == sizeof(int32_t), "Float and Int32 are of different sizes");
-  static_assert(sizeof(double) == sizeof(int64_t), "Double and Int64 are of different sizes");
-
-  if (input_tensor.IsDataType<float>() ||
-      input_tensor.IsDataType<int32_t>() ||
-      input_tensor.IsDataType<uint32_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(float));
-
-  if (input_tensor.IsDataType<double>() || input_tensor.IsDataType<int64_t>() ||
-      input_tensor.IsDataType<uint64_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(double));
-
-  else if (input_tensor.IsDataType<int8_t>() ||
-           input_tensor.IsDataType<uint8_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int8_t));
-
-  if (input_tensor.IsDataType<int16_t>() || input_tensor.IsDataType<uint16_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int16_t));
-
-  else if (input_tensor.IsDataType<bool>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(bool));
-
-  // TODO: Support 'string' and 'float16' types for completeness
-  else
+  // TODO: Support 'string' type for completeness
+  if (input_tensor.IsDataTypeString())
     ORT_THROW("Tile doesn't have an implementation yet for the type: ", input_tensor.DataType());
+
+  TileCoreForFixedSizeTypes(input_shape.GetDims(), reinterpret_cast<const uint8_t*>(input_tensor.DataRaw()),
+                            reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw()), repeats,
+                            input_tensor.DataType()->Size());
+  return Status::OK();
 }
 }  // namespace onnxruntime
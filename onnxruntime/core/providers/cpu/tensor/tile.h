@@ -1,12 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#pragma once
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 
+// Tiles the input of shape input_dims into output, whose shape is input_dims multiplied by repeats.
+// Also used by Expand, which is a Tile of the axes of size 1 of the input.
+void TileCoreForFixedSizeTypes(const std::vector<int64_t>& input_dims, const uint8_t* input, uint8_t* output,
+                               const int64_t* repeats, size_t element_size);
+
 struct Tile final : OpKernel {
   Tile(const OpKernelInfo& info) : OpKernel(info) {
   }
@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 namespace onnxruntime {
 
 /* A permutation [a,b,c,...] indicates that 
@@ -531,9 +533,28 @@ static bool IsMovingSingleAxis(const std::vector<size_t>& permutations, size_t&
   return single_axis_moved;
 }
 
+/*
+MLAS transposes any permutation of a non-string tensor. It drops the dimensions of 1 and merges the axes that stay
+adjacent in the output, and then transposes the matrices left by cache blocks of SIMD tiles on the thread pool.
+It returns false if more than 8 axes are left after merging, and the other implementations are used.
+*/
+static bool TransposeWithMlas(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                              const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
+  if (input.IsDataTypeString()) {
+    return false;
+  }
+
+  const auto& input_shape = input_shape_override ? *input_shape_override : input.Shape();
+  const auto& input_dims = input_shape.GetDims();
+  std::vector<size_t> dims(input_dims.begin(), input_dims.end());
+
+  return ::MlasTransposeTensor(input.DataRaw(), output.MutableDataRaw(), input.DataType()->Size(), dims.size(),
+                               dims.data(), permutations.data(), tp);
+}
+
 //`input_shape_override` overrides the shape of `input` for compute purposes.
 Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
-                                  const TensorShape* input_shape_override) {
+                                  const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -542,7 +563,7 @@ Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const
   if (input_type != output_type) {
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
-  } else {
+  } else if (!TransposeWithMlas(permutations, input, output, input_shape_override, tp)) {
     size_t from = 0, to = 0;
     bool moving_single_axis = IsMovingSingleAxis(permutations, from, to);
 
@@ -578,6 +599,9 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   if (output_shape.Size() == 0)
     return Status::OK();
 
+  if (TransposeWithMlas(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool()))
+    return Status::OK();
+
   size_t from = 0, to = 0;
   bool moving_single_axis = IsMovingSingleAxis(*p_perm, from, to);
 
@@ -9,15 +9,21 @@
 #include <sstream>
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
 
 class TransposeBase {
  public:
   /**
   Transpose the input Tensor into the output Tensor using the provided permutations.
   Both Tensors must have the same data type. `input_shape_override` overrides the shape of `input` for compute purposes.
+  `tp` is the thread pool to transpose with, or nullptr to transpose on the calling thread.
   */
   static Status DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
-                            const TensorShape* input_shape_override = nullptr);
+                            const TensorShape* input_shape_override = nullptr,
+                            concurrency::ThreadPool* tp = nullptr);
 
  protected:
   TransposeBase(const OpKernelInfo& info) {
@@ -131,11 +131,12 @@ class Subtensor {
 
 template <typename T>
 static void CreateFlattenedOutput(OpKernelContext& context,
-                                  const std::map<const T, int64_t>& offsets,         // map sorted key to unsorted idx
-                                  const std::vector<std::vector<int64_t>>& indices,  // unsorted
-                                  const std::vector<int64_t>& inverse_index,         // unsorted
+                                  const std::map<const T, int64_t>& offsets,  // map sorted key to unsorted idx
+                                  const std::vector<int64_t>& first_indices,  // unsorted
+                                  const std::vector<int64_t>& entry_counts,   // unsorted
+                                  const std::vector<int64_t>& inverse_index,  // unsorted
                                   bool sorted) {
-  int64_t num_unique = static_cast<int64_t>(indices.size());
+  int64_t num_unique = static_cast<int64_t>(first_indices.size());
   Tensor& Y = *context.Output(0, {num_unique});
   Tensor* indices_out = context.Output(1, {num_unique});
   Tensor* inverse_indices = context.Output(2, {static_cast<int64_t>(inverse_index.size())});
@@ -159,11 +160,11 @@ static void CreateFlattenedOutput(OpKernelContext& context,
     Y_data[output_idx] = offsets_iter->first;
 
     if (indices_out) {
-      indices_data[output_idx] = indices[unsorted_idx].front();
+      indices_data[output_idx] = first_indices[unsorted_idx];
     }
 
     if (counts) {
-      counts_data[output_idx] = indices[unsorted_idx].size();
+      counts_data[output_idx] = entry_counts[unsorted_idx];
     }
   }
 
@@ -193,10 +194,11 @@ static void CreateOutput(OpKernelContext& context,
                          const TensorShape& subtensor_shape,
                          int64_t axis,
                          const std::map<const Subtensor<T>, int64_t>& offsets,  // map sorted key to unsorted idx
-                         const std::vector<std::vector<int64_t>>& indices,      // unsorted
+                         const std::vector<int64_t>& first_indices,             // unsorted
+                         const std::vector<int64_t>& entry_counts,              // unsorted
                          const std::vector<int64_t>& inverse_index,             // unsorted
                          bool sorted) {
-  int64_t num_unique = static_cast<int64_t>(indices.size());
+  int64_t num_unique = static_cast<int64_t>(first_indices.size());
 
   // rows and columns for the slice along axis, flattened to 2D by merging the dimensions before and after the axis
   int64_t num_cols = subtensor_shape.SizeFromDimension(axis);
@@ -254,11 +256,11 @@ static void CreateOutput(OpKernelContext& context,
     assert(item == items.cend());
 
     if (indices_out) {
-      indices_data[output_idx] = indices[unsorted_idx].front();
+      indices_data[output_idx] = first_indices[unsorted_idx];
     }
 
     if (counts) {
-      counts_data[output_idx] = indices[unsorted_idx].size();
+      counts_data[output_idx] = entry_counts[unsorted_idx];
     }
   }
 
@@ -290,29 +292,29 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
 
   if (flatten_) {
     std::map<const T, int64_t> offsets;  // offset of entry in indices. provides map between sorted and unsorted values
-    std::vector<std::vector<int64_t>> indices;
+    std::vector<int64_t> first_indices;  // index of the first occurrence of each unique entry
+    std::vector<int64_t> entry_counts;   // number of occurrences of each unique entry
     std::vector<int64_t> inverse_index;
 
-    indices.reserve(data.size() / 2);  // arbitrary value. at worst 1 realloc but could be too large
     inverse_index.reserve(data.size());
 
-    int64_t num_unique = 0;
-
     for (int64_t i = 0, end = input.Shape().Size(); i < end; ++i) {
-      auto entry = offsets.find(data[i]);
-      if (entry == offsets.end()) {
-        offsets[data[i]] = num_unique;
-        inverse_index.push_back({num_unique});
-        indices.push_back({i});
-        ++num_unique;
+      // single lookup in the map for both new and existing entries
+      auto entry = offsets.lower_bound(data[i]);
+      if (entry == offsets.end() || offsets.key_comp()(data[i], entry->first)) {
+        const auto num_unique = static_cast<int64_t>(first_indices.size());
+        offsets.emplace_hint(entry, data[i], num_unique);
+        inverse_index.push_back(num_unique);
+        first_indices.push_back(i);
+        entry_counts.push_back(1);
       } else {
-        size_t indices_idx = entry->second;
-        indices[indices_idx].push_back(i);
+        int64_t indices_idx = entry->second;
+        ++entry_counts[indices_idx];
         inverse_index.push_back(indices_idx);
       }
     }
 
-    CreateFlattenedOutput(context, offsets, indices, inverse_index, sort_);
+    CreateFlattenedOutput(context, offsets, first_indices, entry_counts, inverse_index, sort_);
   } else {
     const auto& input_shape = input.Shape();
     const int64_t input_dims = static_cast<int64_t>(input_shape.NumDimensions());
@@ -327,32 +329,31 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
     TensorShape subtensor_shape(std::move(subtensor_dims));
 
     std::map<const Subtensor<T>, int64_t> offsets;
-    std::vector<std::vector<int64_t>> indices;
+    std::vector<int64_t> first_indices;
+    std::vector<int64_t> entry_counts;
     std::vector<int64_t> inverse_index;
 
-    indices.reserve(data.size() / 2);  // arbitrary value. at worst 1 realloc but could be too large
-    inverse_index.reserve(data.size());
-
-    int64_t num_unique = 0;
     int64_t n_axis = input_shape[axis];
+    inverse_index.reserve(n_axis);
 
     for (int64_t i = 0; i < n_axis; ++i) {
       Subtensor<T> s(data, subtensor_shape, axis, n_axis, i);
 
-      auto entry = offsets.find(s);
-      if (entry == offsets.end()) {
-        offsets[std::move(s)] = num_unique;
-        inverse_index.push_back({num_unique});
-        indices.push_back({i});
-        ++num_unique;
+      auto entry = offsets.lower_bound(s);
+      if (entry == offsets.end() || s < entry->first) {
+        const auto num_unique = static_cast<int64_t>(first_indices.size());
+        offsets.emplace_hint(entry, std::move(s), num_unique);
+        inverse_index.push_back(num_unique);
+        first_indices.push_back(i);
+        entry_counts.push_back(1);
       } else {
-        size_t indices_idx = entry->second;
-        indices[indices_idx].push_back(i);
+        int64_t indices_idx = entry->second;
+        ++entry_counts[indices_idx];
         inverse_index.push_back(indices_idx);
       }
     }
 
-    CreateOutput(context, subtensor_shape, axis, offsets, indices, inverse_index, sort_);
+    CreateOutput(context, subtensor_shape, axis, offsets, first_indices, entry_counts, inverse_index, sort_);
   }
 
   return Status::OK();
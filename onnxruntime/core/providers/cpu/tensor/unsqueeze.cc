@@ -15,6 +15,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     10,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Unsqueeze);
 
@@ -23,6 +24,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder()
         .Alias(0, 0)
+        .Trivial()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Unsqueeze);
 
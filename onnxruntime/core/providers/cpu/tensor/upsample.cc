@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 #include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
 #include <sstream>
 
 using namespace onnxruntime::common;
@@ -299,32 +300,49 @@ Status UpsampleLinear(const T* input,
   return Status::OK();
 }
 
-// The following method supports a 4-D input in 'Linear mode'
-// that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
-// the scale values for the outermost 2 dimensions are 1.
-// This is the common use-case where the 4-D input (batched multi-channel images)
-// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
-template <typename T>
-void UpsampleBilinear(int64_t batch_size,
-                      int64_t num_channels,
-                      int64_t input_height,
-                      int64_t input_width,
-                      int64_t output_height,
-                      int64_t output_width,
-                      float height_scale,
-                      float width_scale,
-                      const std::vector<float>& roi,
-                      bool use_extrapolation,
-                      float extrapolation_value,
-                      const T* Xdata,
-                      T* Ydata,
-                      AllocatorPtr& alloc,
-                      GetOriginalCoordinateFunc get_original_coordinate) {
+// Per-axis source indices and interpolation weights for 'Bilinear' mode.
+// These depend only on the input/output extents, scales and roi, so they are computed once per call
+// (O(output_height + output_width)) and shared by every channel and output row.
+struct BilinearParams {
+  std::vector<float> x_original;
   std::vector<float> y_original;
-  y_original.reserve(output_height);
 
-  std::vector<float> x_original;
-  x_original.reserve(output_width);
+  BufferUniquePtr idx_scale_data_buffer_holder;
+
+  int64_t* input_width_mul_y1;
+  int64_t* input_width_mul_y2;
+
+  int64_t* in_x1;
+  int64_t* in_x2;
+
+  float* dx1;
+  float* dx2;
+
+  float* dy1;
+  float* dy2;
+
+  // Weights of the second sample in fixed point, used by the uint8_t path.
+  // The weight of the first sample is (kBilinearFixedPointOne - weight).
+  int32_t* dx1_fixed;
+  int32_t* dy1_fixed;
+};
+
+constexpr int kBilinearFixedPointBits = 11;
+constexpr int32_t kBilinearFixedPointOne = 1 << kBilinearFixedPointBits;
+
+BilinearParams SetupUpsampleBilinear(int64_t input_height,
+                                     int64_t input_width,
+                                     int64_t output_height,
+                                     int64_t output_width,
+                                     float height_scale,
+                                     float width_scale,
+                                     const std::vector<float>& roi,
+                                     AllocatorPtr& alloc,
+                                     const GetOriginalCoordinateFunc& get_original_coordinate) {
+  BilinearParams p;
+
+  p.y_original.reserve(output_height);
+  p.x_original.reserve(output_width);
 
   // For each index in the output height and output width, cache its corresponding indices in the input
   // while multiplying it with the input stride for that dimension (cache because we don't have to re-compute
@@ -335,30 +353,36 @@ void UpsampleBilinear(int64_t batch_size,
   // corresponding indices in the input which proportionately indicates how much they will influence the final
   // pixel value in the output
   // (cache because we don't have to re-compute each time we come across the output width/ output height value while iterating the output image tensor
-  SafeInt<size_t> scale_buffer_size = SafeInt<size_t>(2) * sizeof(float_t) * (output_height + output_width);
+  SafeInt<size_t> scale_buffer_size = SafeInt<size_t>(2) * sizeof(float) * (output_height + output_width);
+
+  // Fixed point copy of the weights of the second sample in each dimension
+  SafeInt<size_t> fixed_scale_buffer_size = SafeInt<size_t>(sizeof(int32_t)) * (output_height + output_width);
 
   // Limit number of allocations to just 1
-  auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
-  BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
+  auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size + fixed_scale_buffer_size);
+  p.idx_scale_data_buffer_holder = BufferUniquePtr(inx_scale_data_buffer, BufferDeleter(alloc));
 
   // Get pointers to appropriate memory locations in the scratch buffer
-  auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
+  auto* idx_data = static_cast<int64_t*>(p.idx_scale_data_buffer_holder.get());
 
   // input_width is the stride for the height dimension
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = input_width_mul_y1 + output_height;
+  p.input_width_mul_y1 = idx_data;
+  p.input_width_mul_y2 = p.input_width_mul_y1 + output_height;
 
   // stride for width is 1 (no multiplication needed)
-  int64_t* in_x1 = input_width_mul_y1 + 2 * output_height;
-  int64_t* in_x2 = in_x1 + output_width;
+  p.in_x1 = p.input_width_mul_y1 + 2 * output_height;
+  p.in_x2 = p.in_x1 + output_width;
 
-  auto* scale_data = reinterpret_cast<float*>(in_x2 + output_width);
+  auto* scale_data = reinterpret_cast<float*>(p.in_x2 + output_width);
 
-  float* dy1 = scale_data;
-  float* dy2 = dy1 + output_height;
+  p.dy1 = scale_data;
+  p.dy2 = p.dy1 + output_height;
 
-  float* dx1 = dy1 + 2 * output_height;
-  float* dx2 = dx1 + output_width;
+  p.dx1 = p.dy1 + 2 * output_height;
+  p.dx2 = p.dx1 + output_width;
+
+  p.dy1_fixed = reinterpret_cast<int32_t*>(p.dx2 + output_width);
+  p.dx1_fixed = p.dy1_fixed + output_height;
 
   // Start processing
   auto roi_y_start = roi.size() / 2 - 2;
@@ -369,21 +393,23 @@ void UpsampleBilinear(int64_t batch_size,
                                                              static_cast<float>(output_height),
                                                              static_cast<float>(input_height),
                                                              roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
+    p.y_original.emplace_back(in_y);
     in_y = std::max(0.0f, std::min(in_y, static_cast<float>(input_height - 1)));
 
     const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
     const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
+    p.dy1[y] = std::fabs(in_y - in_y1);
+    p.dy2[y] = std::fabs(in_y - in_y2);
 
     if (in_y1 == in_y2) {
-      dy1[y] = 0.5f;
-      dy2[y] = 0.5f;
+      p.dy1[y] = 0.5f;
+      p.dy2[y] = 0.5f;
     }
 
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
+    p.dy1_fixed[y] = static_cast<int32_t>(std::lround(p.dy1[y] * kBilinearFixedPointOne));
+
+    p.input_width_mul_y1[y] = input_width * in_y1;
+    p.input_width_mul_y2[y] = input_width * in_y2;
   }
 
   auto roi_x_start = roi.size() / 2 - 1;
@@ -395,49 +421,136 @@ void UpsampleBilinear(int64_t batch_size,
                                                             static_cast<float>(output_width),
                                                             static_cast<float>(input_width),
                                                             roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
+    p.x_original.emplace_back(in_x);
     in_x = std::max(0.0f, std::min(in_x, static_cast<float>(input_width - 1)));
 
-    in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
-    in_x2[x] = std::min(in_x1[x] + 1, input_width - 1);
+    p.in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
+    p.in_x2[x] = std::min(p.in_x1[x] + 1, input_width - 1);
 
-    dx1[x] = std::fabs(in_x - in_x1[x]);
-    dx2[x] = std::fabs(in_x - in_x2[x]);
-    if (in_x1[x] == in_x2[x]) {
-      dx1[x] = 0.5f;
-      dx2[x] = 0.5f;
+    p.dx1[x] = std::fabs(in_x - p.in_x1[x]);
+    p.dx2[x] = std::fabs(in_x - p.in_x2[x]);
+    if (p.in_x1[x] == p.in_x2[x]) {
+      p.dx1[x] = 0.5f;
+      p.dx2[x] = 0.5f;
     }
+
+    p.dx1_fixed[x] = static_cast<int32_t>(std::lround(p.dx1[x] * kBilinearFixedPointOne));
   }
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        for (int64_t x = 0; x < output_width; ++x) {
-          // when use_extrapolation is set and original index of x or y is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation &&
-              ((y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1)) ||
-               (x_original[x] < 0 || x_original[x] > static_cast<float>(input_width - 1)))) {
-            Ydata[output_width * y + x] = static_cast<T>(extrapolation_value);
-            continue;
-          }
+  return p;
+}
 
-          // subscript ordering in the variable - (xy)
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
+// Interpolates output columns [x_begin, x_end) of output row 'y' from the two input rows X1 and X2.
+template <typename T>
+void UpsampleBilinearRow(const BilinearParams& p, int64_t y, int64_t x_begin, int64_t x_end,
+                         const T* X1, const T* X2, T* Yrow) {
+  const float dy1 = p.dy1[y];
+  const float dy2 = p.dy2[y];
+  for (int64_t x = x_begin; x < x_end; ++x) {
+    // subscript ordering in the variable - (xy)
+    T X11 = X1[p.in_x1[x]];
+    T X21 = X1[p.in_x2[x]];
+    T X12 = X2[p.in_x1[x]];
+    T X22 = X2[p.in_x2[x]];
+
+    Yrow[x] = static_cast<T>(p.dx2[x] * dy2 * X11 +
+                             p.dx1[x] * dy2 * X21 +
+                             p.dx2[x] * dy1 * X12 +
+                             p.dx1[x] * dy1 * X22);
+  }
+}
 
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
-        }
-      }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
+// uint8_t images are interpolated in fixed point: the weights have kBilinearFixedPointBits fractional bits,
+// so the sum of the four products has 2 * kBilinearFixedPointBits and fits easily in 32 bits.
+// The result is rounded to nearest instead of being truncated.
+template <>
+void UpsampleBilinearRow<uint8_t>(const BilinearParams& p, int64_t y, int64_t x_begin, int64_t x_end,
+                                  const uint8_t* X1, const uint8_t* X2, uint8_t* Yrow) {
+  constexpr int shift = 2 * kBilinearFixedPointBits;
+  constexpr int32_t rounding = 1 << (shift - 1);
+  const int32_t wy1 = p.dy1_fixed[y];
+  const int32_t wy2 = kBilinearFixedPointOne - wy1;
+  for (int64_t x = x_begin; x < x_end; ++x) {
+    const int32_t wx1 = p.dx1_fixed[x];
+    const int32_t wx2 = kBilinearFixedPointOne - wx1;
+
+    const int32_t top = wx2 * X1[p.in_x1[x]] + wx1 * X1[p.in_x2[x]];
+    const int32_t bottom = wx2 * X2[p.in_x1[x]] + wx1 * X2[p.in_x2[x]];
+
+    Yrow[x] = static_cast<uint8_t>((wy2 * top + wy1 * bottom + rounding) >> shift);
+  }
+}
+
+// The following method supports a 4-D input in 'Linear mode'
+// that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
+// the scale values for the outermost 2 dimensions are 1.
+// This is the common use-case where the 4-D input (batched multi-channel images)
+// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
+template <typename T>
+void UpsampleBilinear(int64_t batch_size,
+                      int64_t num_channels,
+                      int64_t input_height,
+                      int64_t input_width,
+                      int64_t output_height,
+                      int64_t output_width,
+                      float height_scale,
+                      float width_scale,
+                      const std::vector<float>& roi,
+                      bool use_extrapolation,
+                      float extrapolation_value,
+                      const T* Xdata,
+                      T* Ydata,
+                      AllocatorPtr& alloc,
+                      const GetOriginalCoordinateFunc& get_original_coordinate,
+                      concurrency::ThreadPool* tp) {
+  const BilinearParams p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width,
+                                                 height_scale, width_scale, roi, alloc, get_original_coordinate);
+
+  // The coordinate transforms are monotonic, so the output columns whose source lies inside the input
+  // form a single range [x_begin, x_end). Only those are interpolated; the rest take the extrapolation value.
+  int64_t x_begin = 0;
+  int64_t x_end = output_width;
+  if (use_extrapolation) {
+    const float max_x = static_cast<float>(input_width - 1);
+    while (x_begin < output_width && (p.x_original[x_begin] < 0 || p.x_original[x_begin] > max_x)) {
+      ++x_begin;
+    }
+    while (x_end > x_begin && (p.x_original[x_end - 1] < 0 || p.x_original[x_end - 1] > max_x)) {
+      --x_end;
     }
   }
+
+  const int64_t input_plane_size = input_height * input_width;
+  const int64_t output_plane_size = output_height * output_width;
+  const T extrapolation = static_cast<T>(extrapolation_value);
+
+  // Every output row of every channel is independent
+  const std::ptrdiff_t total_rows = static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height);
+  const TensorOpCost cost{static_cast<double>(4 * sizeof(T) * output_width),
+                          static_cast<double>(sizeof(T) * output_width),
+                          static_cast<double>(8 * output_width)};
+
+  concurrency::ThreadPool::TryParallelFor(tp, total_rows, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t plane = row / output_height;
+      const int64_t y = row % output_height;
+
+      const T* X = Xdata + plane * input_plane_size;
+      T* Yrow = Ydata + plane * output_plane_size + y * output_width;
+
+      // when use_extrapolation is set and original index of x or y is out of the dim range
+      // then use extrapolation_value as the output value.
+      if (use_extrapolation &&
+          (p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1))) {
+        std::fill_n(Yrow, output_width, extrapolation);
+        continue;
+      }
+
+      std::fill(Yrow, Yrow + x_begin, extrapolation);
+      UpsampleBilinearRow(p, y, x_begin, x_end, X + p.input_width_mul_y1[y], X + p.input_width_mul_y2[y], Yrow);
+      std::fill(Yrow + x_end, Yrow + output_width, extrapolation);
+    }
+  });
 }
 
 // The following method supports a 5-D input in 'Linear mode'
@@ -661,7 +774,7 @@ float CubicInterpolation1D(const T* Xdata,
                            int64_t y,
                            int64_t input_height,
                            int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
+                           const std::array<float, CubicModeGridLength>& coeff_array,
                            float coeff_sum,
                            std::unordered_map<int64_t, float>& cache) {
   // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
@@ -704,7 +817,8 @@ void ResizeBiCubic(
     const std::vector<float>& roi,
     const T* Xdata,
     T* Ydata,
-    GetOriginalCoordinateFunc get_original_coordinate) {
+    const GetOriginalCoordinateFunc& get_original_coordinate,
+    concurrency::ThreadPool* tp) {
   std::vector<float> y_original;
   y_original.reserve(output_height);
 
@@ -712,7 +826,6 @@ void ResizeBiCubic(
   x_original.reserve(output_width);
 
   std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
@@ -729,7 +842,6 @@ void ResizeBiCubic(
     auto s = y_original[y] - std::floor(y_original[y]);
     if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
       cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
     }
   }
 
@@ -745,18 +857,31 @@ void ResizeBiCubic(
     auto s = x_original[x] - std::floor(x_original[x]);
     if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
       cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
     }
   }
 
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
+  // Each channel is independent. The cache of 1D interpolation results is per channel, so every
+  // task keeps its own; the coefficient table above is only read from here on.
+  const int64_t input_plane_size = input_height * input_width;
+  const int64_t output_plane_size = output_height * output_width;
+  const std::ptrdiff_t total_channels = static_cast<std::ptrdiff_t>(batch_size * num_channels);
+  const TensorOpCost cost{static_cast<double>(sizeof(T) * (input_plane_size + CubicModeGridLength * output_plane_size)),
+                          static_cast<double>(sizeof(T) * output_plane_size),
+                          static_cast<double>(4 * CubicModeGridLength * output_plane_size)};
+
+  concurrency::ThreadPool::TryParallelFor(tp, total_channels, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
+
+    // setup up temp arrays to hold coefficients when exclude_outside is set to true
+    std::array<float, CubicModeGridLength> y_coeff_holder;
+    std::array<float, CubicModeGridLength> x_coeff_holder;
+    float y_coeff_sum = 1;
+    float x_coeff_sum = 1;
+
+    for (std::ptrdiff_t channel = first; channel < last; ++channel) {
+      const T* Xplane = Xdata + channel * input_plane_size;
+      T* Yplane = Ydata + channel * output_plane_size;
 
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
       for (int64_t y = 0; y < output_height; ++y) {
         auto in_y = y_original[y];
 
@@ -764,20 +889,20 @@ void ResizeBiCubic(
         // then use extrapolation_value as the output value.
         if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
           for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
+            Yplane[y * output_width + x] = extrapolation_value;
           }
           continue;
         }
 
         auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
+        const auto& orig_y_coeffs = cubic_coeffs.at(in_y - y_int);
+        const auto& coeff_y = exclude_outside ? y_coeff_holder : orig_y_coeffs;
         y_coeff_sum = 1;
 
         if (exclude_outside) {
           // When true, the weight of sampling locations outside the grid will be set to 0
           // and the weight will be renormalized so that their sum is 1.0
           y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
           for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
             y_coeff_holder[i] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[i];
             y_coeff_sum += y_coeff_holder[i];
@@ -790,20 +915,20 @@ void ResizeBiCubic(
           // when use_extrapolation is set and original index is out of the dim range
           // then use extrapolation_value as the output value.
           if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
+            Yplane[y * output_width + x] = extrapolation_value;
             continue;
           }
 
           auto x_int = static_cast<int64_t>(std::floor(in_x));
           auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
+          const auto& orig_x_coeff = cubic_coeffs.at(s_x);
+          auto& coeff_x = exclude_outside ? x_coeff_holder : orig_x_coeff;
           x_coeff_sum = 1;
 
           if (exclude_outside) {
             // When true, the weight of sampling locations outside the grid will be set to 0
             // and the weight will be renormalized so that their sum is 1.0
             x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
             for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
               x_coeff_holder[i] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[i];
               x_coeff_sum += x_coeff_holder[i];
@@ -815,23 +940,20 @@ void ResizeBiCubic(
           auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
           float result = 0;
           for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
+            auto x_interpolation_result = CubicInterpolation1D(Xplane, x_int, y_val,
                                                                input_height, input_width, coeff_x, x_coeff_sum,
                                                                interpolation_result_cache);
             result += x_interpolation_result * coeff_y[i] / y_coeff_sum;
           }
 
-          Ydata[y * output_width + x] = static_cast<T>(result);
+          Yplane[y * output_width + x] = static_cast<T>(result);
         }
       }
 
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
       // clear the cache when moving to the next channel
       coeff_to_1Dinterpolation_map.clear();
     }
-  }
+  });
 }
 #if defined(_MSC_VER)
 #pragma warning(pop)
@@ -898,7 +1020,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
                          is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], roi,
                          use_extrapolation_, extrapolation_value_, X->template Data<T>(),
-                         Y->template MutableData<T>(), alloc, get_original_coordinate_);
+                         Y->template MutableData<T>(), alloc, get_original_coordinate_,
+                         context->GetOperatorThreadPool());
         return Status::OK();
       } else if (dims.size() == 3 || dims.size() == 5) {
         //'trilinear' == 3-D input or 5-D input with outermost 2 scales as 1
@@ -954,7 +1077,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                     is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], cubic_coeff_a_, use_extrapolation_,
                     extrapolation_value_, exclude_outside_, roi, X->template Data<float>(), Y->template MutableData<float>(),
-                    get_original_coordinate_);
+                    get_original_coordinate_, context->GetOperatorThreadPool());
       return Status::OK();
     }
     default:
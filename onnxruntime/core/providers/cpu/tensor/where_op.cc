@@ -205,12 +205,10 @@ static std::unique_ptr<Tensor> UntypedSelect(OpKernelContext& context, bool targ
   InputBroadcaster input_broadcaster(condition, values);
 
   std::unique_ptr<Tensor> selection_tensor = allocate_tensor(allocator, input_broadcaster.GetOutputShape());
-  OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(), *selection_tensor);
 
   // store value of 'target' directly in void* for user_data so it's accessible in the state-less functors
-  BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, reinterpret_cast<void*>(target));
-
-  BroadcastLooper(broadcast_helper, functors);
+  ParallelBroadcastTwo(input_broadcaster, *selection_tensor, functors, context.GetOperatorThreadPool(), 1.0,
+                       reinterpret_cast<void*>(target));
 
   return selection_tensor;
 }
@@ -221,15 +219,42 @@ static void UntypedMerge(OpKernelContext& context,
   InputBroadcaster merge_broadcaster{X_selection_tensor, Y_selection_tensor};
   Tensor& output = *context.Output(0, merge_broadcaster.GetOutputShape());
 
-  OutputBroadcaster output_broadcaster{merge_broadcaster.GetSpanSize(), output};
-  BroadcastHelper broadcast_helper(merge_broadcaster, output_broadcaster);
+  ParallelBroadcastTwo(merge_broadcaster, output, functors, context.GetOperatorThreadPool(), 1.0);
+}
 
-  BroadcastLooper(broadcast_helper, functors);
+// output = condition ? X : Y in a single pass when no broadcasting is needed.
+// both values are loaded before the select so the compiler can use a blend instead of a branch.
+template <typename T>
+void SameShapeWhere(OpKernelContext& context, const Tensor& condition, const Tensor& X, const Tensor& Y) {
+  Tensor& output = *context.Output(0, condition.Shape());
+  const bool* condition_data = condition.template Data<bool>();
+  const T* X_data = X.template Data<T>();
+  const T* Y_data = Y.template Data<T>();
+  T* output_data = output.template MutableData<T>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), condition.Shape().Size(),
+      TensorOpCost{static_cast<double>(sizeof(bool) + 2 * sizeof(T)), static_cast<double>(sizeof(T)), 1.0},
+      [=](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i < end; ++i) {
+          const T& x = X_data[i];
+          const T& y = Y_data[i];
+          output_data[i] = condition_data[i] ? x : y;
+        }
+      });
 }
 }  // namespace
 
 template <typename T>
 Status Where<T>::Compute(OpKernelContext* context) const {
+  const auto& condition = *context->Input<Tensor>(0);
+  const auto& X = *context->Input<Tensor>(1);
+  const auto& Y = *context->Input<Tensor>(2);
+  if (condition.Shape() == X.Shape() && condition.Shape() == Y.Shape()) {
+    SameShapeWhere<T>(*context, condition, X, Y);
+    return Status::OK();
+  }
+
   // we use a func pointer to save the overhead of std::function, so we can't capture tensor_allocator here
   const auto typed_tensor_allocation = [](const TensorAllocator& allocator,
                                           const TensorShape& shape) {
@@ -178,6 +178,164 @@ __global__ void _BinaryElementWiseRhsPerChannelBatchN(
   }
 }
 
+// VecSize contiguous elements of T, loaded or stored with a single instruction if the address is aligned
+template <typename T, int VecSize>
+struct alignas(sizeof(T) * VecSize) aligned_vector {
+  T val[VecSize];
+};
+
+// elements per thread of the vectorized kernels: 16 bytes of the widest of the types, e.g. float4 for float and
+// 4 half2 for half, and at most 8 to bound the registers of narrow types
+template <typename T, typename T1, typename T2>
+struct BinaryElementWiseVectorization {
+  static constexpr size_t kMaxElementSize =
+      sizeof(T) > sizeof(T1) ? (sizeof(T) > sizeof(T2) ? sizeof(T) : sizeof(T2))
+                             : (sizeof(T1) > sizeof(T2) ? sizeof(T1) : sizeof(T2));
+  static constexpr int kVecSize =
+      kMaxElementSize >= 16 ? 1 : (kMaxElementSize >= 2 ? static_cast<int>(16 / kMaxElementSize) : 8);
+};
+
+template <int VecSize, typename T>
+bool IsVectorAligned(const T* p) {
+  return reinterpret_cast<uintptr_t>(p) % (sizeof(T) * VecSize) == 0;
+}
+
+// vectorized version of _BinaryElementWiseSimple: each thread processes VecSize contiguous elements,
+// and the last thread the ones left over at the end.
+template <bool IncL, bool IncR, typename T, typename T1, typename T2, typename FuncT,
+          int NumThreadsPerBlock, int VecSize>
+__global__ void _BinaryElementWiseSimpleVectorized(
+    const T1* lhs_data,
+    const T2* rhs_data,
+    T* output_data,
+    FuncT func,
+    CUDA_LONG N) {
+  CUDA_LONG id = (NumThreadsPerBlock * blockIdx.x + threadIdx.x) * VecSize;
+  if (id >= N) {
+    return;
+  }
+
+  if (id + VecSize <= N) {
+    aligned_vector<T1, VecSize> lvalue;
+    aligned_vector<T2, VecSize> rvalue;
+    if (IncL) {
+      lvalue = *reinterpret_cast<const aligned_vector<T1, VecSize>*>(lhs_data + id);
+    }
+    if (IncR) {
+      rvalue = *reinterpret_cast<const aligned_vector<T2, VecSize>*>(rhs_data + id);
+    }
+    const T1 lscalar = IncL ? T1() : lhs_data[0];
+    const T2 rscalar = IncR ? T2() : rhs_data[0];
+
+    aligned_vector<T, VecSize> out;
+#pragma unroll
+    for (int i = 0; i < VecSize; i++) {
+      out.val[i] = func(IncL ? lvalue.val[i] : lscalar, IncR ? rvalue.val[i] : rscalar);
+    }
+    *reinterpret_cast<aligned_vector<T, VecSize>*>(output_data + id) = out;
+  } else {
+    for (; id < N; id++) {
+      output_data[id] = func(lhs_data[IncL ? id : 0], rhs_data[IncR ? id : 0]);
+    }
+  }
+}
+
+// vectorized rhs per-channel broadcast: out[id] = op(lhs[id], rhs[id / H % C]).
+// With PerRow, H is 1 and C is a multiple of VecSize, i.e. [N, C] op [C], so the rhs values of the elements of a
+// thread are contiguous too. Otherwise H is a multiple of VecSize, so the elements of a thread share the rhs value.
+// For a batch of 1 the host passes C = N / H, for which the modulo has no effect.
+template <typename T, typename T1, typename T2, typename FuncT, int NumThreadsPerBlock, int VecSize, bool PerRow>
+__global__ void _BinaryElementWiseRhsPerChannelVectorized(
+    const T1* lhs_data,
+    const T2* rhs_data,
+    const fast_divmod fdm_H,
+    const fast_divmod fdm_C,
+    T* output_data,
+    FuncT func,
+    CUDA_LONG N) {
+  CUDA_LONG id = (NumThreadsPerBlock * blockIdx.x + threadIdx.x) * VecSize;
+  if (id >= N) {
+    return;
+  }
+
+  if (id + VecSize <= N) {
+    aligned_vector<T1, VecSize> lvalue = *reinterpret_cast<const aligned_vector<T1, VecSize>*>(lhs_data + id);
+    aligned_vector<T, VecSize> out;
+    if (PerRow) {
+      aligned_vector<T2, VecSize> rvalue =
+          *reinterpret_cast<const aligned_vector<T2, VecSize>*>(rhs_data + fdm_C.mod(id));
+#pragma unroll
+      for (int i = 0; i < VecSize; i++) {
+        out.val[i] = func(lvalue.val[i], rvalue.val[i]);
+      }
+    } else {
+      const T2 rvalue = rhs_data[fdm_C.mod(fdm_H.div(id))];
+#pragma unroll
+      for (int i = 0; i < VecSize; i++) {
+        out.val[i] = func(lvalue.val[i], rvalue);
+      }
+    }
+    *reinterpret_cast<aligned_vector<T, VecSize>*>(output_data + id) = out;
+  } else {
+    for (; id < N; id++) {
+      output_data[id] = func(lhs_data[id], rhs_data[fdm_C.mod(fdm_H.div(id))]);
+    }
+  }
+}
+
+// Launches the vectorized kernel of a no-broadcast or scalar broadcast case if the pointers are aligned.
+// Returns false if they aren't, for the caller to launch the kernel processing an element at a time.
+template <bool IncL, bool IncR, typename T, typename T1, typename T2, typename FuncT>
+bool TryBinaryElementWiseSimpleVectorized(
+    const T1* lhs_data,
+    const T2* rhs_data,
+    T* output_data,
+    const FuncT& func,
+    CUDA_LONG N) {
+  constexpr int vec_size = BinaryElementWiseVectorization<T, T1, T2>::kVecSize;
+  if (vec_size == 1 || !IsVectorAligned<vec_size>(output_data) ||
+      (IncL && !IsVectorAligned<vec_size>(lhs_data)) || (IncR && !IsVectorAligned<vec_size>(rhs_data))) {
+    return false;
+  }
+
+  int blocksPerGrid = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock * vec_size));
+  _BinaryElementWiseSimpleVectorized<IncL, IncR, T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, vec_size>
+      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(lhs_data, rhs_data, output_data, func, N);
+  return true;
+}
+
+// Same for the rhs per-channel broadcast cases, which also need the channels or the rows to split into vectors.
+template <typename T, typename T1, typename T2, typename FuncT>
+bool TryBinaryElementWiseRhsPerChannelVectorized(
+    const T1* lhs_data,
+    const T2* rhs_data,
+    const fast_divmod& fdm_H,
+    const fast_divmod& fdm_C,
+    T* output_data,
+    const FuncT& func,
+    CUDA_LONG N) {
+  constexpr int vec_size = BinaryElementWiseVectorization<T, T1, T2>::kVecSize;
+  if (vec_size == 1 || !IsVectorAligned<vec_size>(output_data) || !IsVectorAligned<vec_size>(lhs_data)) {
+    return false;
+  }
+
+  int blocksPerGrid = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock * vec_size));
+  if (fdm_H.d_ == 1) {
+    if (fdm_C.d_ % vec_size != 0 || !IsVectorAligned<vec_size>(rhs_data)) {
+      return false;
+    }
+    _BinaryElementWiseRhsPerChannelVectorized<T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, vec_size, true>
+        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(lhs_data, rhs_data, fdm_H, fdm_C, output_data, func, N);
+  } else {
+    if (fdm_H.d_ % vec_size != 0) {
+      return false;
+    }
+    _BinaryElementWiseRhsPerChannelVectorized<T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, vec_size, false>
+        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(lhs_data, rhs_data, fdm_H, fdm_C, output_data, func, N);
+  }
+  return true;
+}
+
 template <typename T, typename T1, typename T2, typename FuncT>
 void BinaryElementWiseNoBroadcastImpl(
     const T1* lhs_data,
@@ -190,6 +348,9 @@ void BinaryElementWiseNoBroadcastImpl(
 
   int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  if (TryBinaryElementWiseSimpleVectorized<true, true>(lhs_data, rhs_data, output_data, func, N)) {
+    return;
+  }
   _BinaryElementWiseSimple<true, true, T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
       lhs_data,
       rhs_data,
@@ -217,6 +378,9 @@ void BinaryElementWiseImpl(
   int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
   if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::NoBroadcast)) {
+    if (TryBinaryElementWiseSimpleVectorized<true, true>(lhs_data, rhs_data, output_data, func, N)) {
+      return;
+    }
     _BinaryElementWiseSimple<true, true, T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
@@ -224,6 +388,9 @@ void BinaryElementWiseImpl(
         func,
         N);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::LeftScalar)) {
+    if (TryBinaryElementWiseSimpleVectorized<false, true>(lhs_data, rhs_data, output_data, func, N)) {
+      return;
+    }
     _BinaryElementWiseSimple<false, true, T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
@@ -231,6 +398,9 @@ void BinaryElementWiseImpl(
         func,
         N);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightScalar)) {
+    if (TryBinaryElementWiseSimpleVectorized<true, false>(lhs_data, rhs_data, output_data, func, N)) {
+      return;
+    }
     _BinaryElementWiseSimple<true, false, T, T1, T2, FuncT, GridDim::maxThreadsPerBlock,
                              GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
@@ -239,6 +409,10 @@ void BinaryElementWiseImpl(
         func,
         N);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightPerChannelBatch1)) {
+    const fast_divmod fdm_C_batch1(static_cast<int>(N / fdm_H.d_));
+    if (TryBinaryElementWiseRhsPerChannelVectorized(lhs_data, rhs_data, fdm_H, fdm_C_batch1, output_data, func, N)) {
+      return;
+    }
     _BinaryElementWiseRhsPerChannelBatch1<T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
@@ -247,6 +421,10 @@ void BinaryElementWiseImpl(
         func,
         N);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightPerChannelBatchN)) {
+    // includes [N, C] op [C], where H is 1
+    if (TryBinaryElementWiseRhsPerChannelVectorized(lhs_data, rhs_data, fdm_H, fdm_C, output_data, func, N)) {
+      return;
+    }
     _BinaryElementWiseRhsPerChannelBatchN<T, T1, T2, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
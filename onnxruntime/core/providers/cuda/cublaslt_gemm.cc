@@ -0,0 +1,354 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/shared_inc/cublaslt_gemm.h"
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/shared_inc/cuda_call.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// the workspace the heuristics may pick algorithms for
+constexpr size_t kWorkspaceSize = 4 * 1024 * 1024;
+
+inline int roundoff(int v, int d) {
+  return (v + d - 1) / d * d;
+}
+
+template <typename T, cublasStatus_t (*Destroy)(T)>
+struct LtDescriptor {
+  LtDescriptor() = default;
+  ~LtDescriptor() {
+    if (desc != nullptr) {
+      Destroy(desc);
+    }
+  }
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LtDescriptor);
+
+  T desc = nullptr;
+};
+
+using MatmulDesc = LtDescriptor<cublasLtMatmulDesc_t, cublasLtMatmulDescDestroy>;
+using MatrixLayout = LtDescriptor<cublasLtMatrixLayout_t, cublasLtMatrixLayoutDestroy>;
+using MatmulPreference = LtDescriptor<cublasLtMatmulPreference_t, cublasLtMatmulPreferenceDestroy>;
+using TransformDesc = LtDescriptor<cublasLtMatrixTransformDesc_t, cublasLtMatrixTransformDescDestroy>;
+
+// a cuBLAS handle is a valid cuBLASLt handle, and the matmuls go to the stream of the cuBLAS calls of the kernels
+inline cublasLtHandle_t LtHandle(const CudaKernel* cuda_kernel) {
+  return reinterpret_cast<cublasLtHandle_t>(cuda_kernel->CublasHandle());
+}
+
+Status GetStream(const CudaKernel* cuda_kernel, cudaStream_t& stream) {
+  CUBLAS_RETURN_IF_ERROR(cublasGetStream(cuda_kernel->CublasHandle(), &stream));
+  return Status::OK();
+}
+
+Status CreateMatmulDesc(cudaDataType_t scale_type, MatmulDesc& matmul_desc) {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  const cublasComputeType_t compute_type = scale_type == CUDA_R_32I ? CUBLAS_COMPUTE_32I : CUBLAS_COMPUTE_32F;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&matmul_desc.desc, compute_type, scale_type));
+#else
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&matmul_desc.desc, scale_type));
+#endif
+  return Status::OK();
+}
+
+template <typename TValue>
+Status SetMatmulDescAttribute(MatmulDesc& matmul_desc, cublasLtMatmulDescAttributes_t attribute, const TValue& value) {
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(matmul_desc.desc, attribute, &value, sizeof(value)));
+  return Status::OK();
+}
+
+Status CreateLayout(cudaDataType_t type, int rows, int cols, int ld, cublasLtOrder_t order, MatrixLayout& layout) {
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&layout.desc, type, rows, cols, ld));
+  if (order != CUBLASLT_ORDER_COL) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutSetAttribute(layout.desc, CUBLASLT_MATRIX_LAYOUT_ORDER,
+                                                            &order, sizeof(order)));
+  }
+  return Status::OK();
+}
+
+// Largest power of 2 up to 256 the address is a multiple of. The heuristics assume 256 bytes unless told otherwise.
+uint32_t Alignment(const void* ptr) {
+  const auto address = reinterpret_cast<uintptr_t>(ptr);
+  uint32_t alignment = 256;
+  while (alignment > 1 && address % alignment != 0) {
+    alignment /= 2;
+  }
+  return alignment;
+}
+
+// D = alpha * A x B + beta * C, with the algorithm of <key> in <algo_cache>, queried from the heuristics first.
+// <alignments> are the ones of A, B, C and D, or empty for the allocations of the allocator.
+Status Matmul(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache, const std::vector<int64_t>& key,
+              MatmulDesc& matmul_desc, const std::vector<uint32_t>& alignments,
+              const void* alpha,
+              const void* a, MatrixLayout& a_layout,
+              const void* b, MatrixLayout& b_layout,
+              const void* beta,
+              const void* c, MatrixLayout& c_layout,
+              void* d, MatrixLayout& d_layout) {
+  cublasLtHandle_t handle = LtHandle(cuda_kernel);
+  cudaStream_t stream;
+  ORT_RETURN_IF_ERROR(GetStream(cuda_kernel, stream));
+
+  cublasLtMatmulAlgo_t algo;
+  if (!algo_cache.Find(key, algo)) {
+    MatmulPreference preference;
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceCreate(&preference.desc));
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+        preference.desc, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &kWorkspaceSize, sizeof(kWorkspaceSize)));
+    if (!alignments.empty()) {
+      const cublasLtMatmulPreferenceAttributes_t alignment_attributes[] = {
+          CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES,
+          CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES};
+      for (size_t i = 0; i < alignments.size(); ++i) {
+        CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+            preference.desc, alignment_attributes[i], &alignments[i], sizeof(alignments[i])));
+      }
+    }
+
+    cublasLtMatmulHeuristicResult_t result;
+    int returned_results = 0;
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulAlgoGetHeuristic(handle, matmul_desc.desc, a_layout.desc, b_layout.desc,
+                                                          c_layout.desc, d_layout.desc, preference.desc,
+                                                          1, &result, &returned_results));
+    ORT_RETURN_IF_NOT(returned_results > 0, "cuBLASLt has no algorithm for the matmul");
+    algo = result.algo;
+    algo_cache.Insert(key, algo);
+  }
+
+  auto workspace = cuda_kernel->GetScratchBuffer<void>(kWorkspaceSize);
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmul(handle, matmul_desc.desc, alpha,
+                                        a, a_layout.desc,
+                                        b, b_layout.desc,
+                                        beta,
+                                        c, c_layout.desc,
+                                        d, d_layout.desc,
+                                        &algo, workspace.get(), kWorkspaceSize, stream));
+  return Status::OK();
+}
+
+template <typename T>
+struct LtDataType;
+
+template <>
+struct LtDataType<float> {
+  static constexpr cudaDataType_t value = CUDA_R_32F;
+};
+
+template <>
+struct LtDataType<half> {
+  static constexpr cudaDataType_t value = CUDA_R_16F;
+};
+
+Status GetEpilogue(bool has_bias, CublasLtActivation activation, cublasLtEpilogue_t& epilogue) {
+  switch (activation) {
+    case CublasLtActivation::None:
+      epilogue = has_bias ? CUBLASLT_EPILOGUE_BIAS : CUBLASLT_EPILOGUE_DEFAULT;
+      return Status::OK();
+    case CublasLtActivation::Relu:
+      epilogue = has_bias ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_RELU;
+      return Status::OK();
+    case CublasLtActivation::Gelu:
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11030
+      epilogue = has_bias ? CUBLASLT_EPILOGUE_GELU_BIAS : CUBLASLT_EPILOGUE_GELU;
+      return Status::OK();
+#else
+      break;
+#endif
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The cuBLASLt epilogue doesn't support the activation");
+}
+
+// the B operand of the int8 matmuls is in the layout of the tensor cores of the device
+cublasLtOrder_t Int8BOrder(const cudaDeviceProp& prop) {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  if (prop.major >= 8) {
+    return CUBLASLT_ORDER_COL32_2R_4R4;
+  }
+#else
+  ORT_UNUSED_PARAMETER(prop);
+#endif
+  return CUBLASLT_ORDER_COL4_4R2_8C;
+}
+
+}  // namespace
+
+bool IsCublasLtActivationSupported(CublasLtActivation activation) {
+  cublasLtEpilogue_t epilogue;
+  return GetEpilogue(true, activation, epilogue).IsOK();
+}
+
+bool CublasLtAlgoCache::Find(const std::vector<int64_t>& key, cublasLtMatmulAlgo_t& algo) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = algos_.find(key);
+  if (it == algos_.end()) {
+    return false;
+  }
+  algo = it->second;
+  return true;
+}
+
+void CublasLtAlgoCache::Insert(const std::vector<int64_t>& key, const cublasLtMatmulAlgo_t& algo) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  algos_[key] = algo;
+}
+
+template <typename T>
+Status CublasLtGemm(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache,
+                    cublasOperation_t trans_a, cublasOperation_t trans_b,
+                    int m, int n, int k,
+                    float alpha,
+                    const T* a, int lda,
+                    const T* b, int ldb,
+                    const T* bias, CublasLtActivation activation,
+                    T* c, int ldc) {
+  ORT_ENFORCE(a != nullptr && b != nullptr && c != nullptr, "input matrix should not be null");
+  const cudaDataType_t data_type = LtDataType<T>::value;
+
+  cublasLtEpilogue_t epilogue;
+  ORT_RETURN_IF_ERROR(GetEpilogue(bias != nullptr, activation, epilogue));
+
+  MatmulDesc matmul_desc;
+  ORT_RETURN_IF_ERROR(CreateMatmulDesc(CUDA_R_32F, matmul_desc));
+  ORT_RETURN_IF_ERROR(SetMatmulDescAttribute(matmul_desc, CUBLASLT_MATMUL_DESC_TRANSA, trans_a));
+  ORT_RETURN_IF_ERROR(SetMatmulDescAttribute(matmul_desc, CUBLASLT_MATMUL_DESC_TRANSB, trans_b));
+  ORT_RETURN_IF_ERROR(SetMatmulDescAttribute(matmul_desc, CUBLASLT_MATMUL_DESC_EPILOGUE, epilogue));
+  if (bias != nullptr) {
+    const void* bias_pointer = bias;
+    ORT_RETURN_IF_ERROR(SetMatmulDescAttribute(matmul_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, bias_pointer));
+  }
+
+  MatrixLayout a_layout;
+  MatrixLayout b_layout;
+  MatrixLayout c_layout;
+  const bool a_transposed = trans_a != CUBLAS_OP_N;
+  const bool b_transposed = trans_b != CUBLAS_OP_N;
+  ORT_RETURN_IF_ERROR(CreateLayout(data_type, a_transposed ? k : m, a_transposed ? m : k, lda, CUBLASLT_ORDER_COL,
+                                   a_layout));
+  ORT_RETURN_IF_ERROR(CreateLayout(data_type, b_transposed ? n : k, b_transposed ? k : n, ldb, CUBLASLT_ORDER_COL,
+                                   b_layout));
+  ORT_RETURN_IF_ERROR(CreateLayout(data_type, m, n, ldc, CUBLASLT_ORDER_COL, c_layout));
+
+  const std::vector<uint32_t> alignments{Alignment(a), Alignment(b), Alignment(c), Alignment(c)};
+  const std::vector<int64_t> key{data_type, trans_a, trans_b, m, n, k, lda, ldb, ldc, epilogue,
+                                 alignments[0], alignments[1], alignments[2]};
+
+  const float beta = 0.0f;
+  return Matmul(cuda_kernel, algo_cache, key, matmul_desc, alignments,
+                &alpha, a, a_layout, b, b_layout, &beta, c, c_layout, c, c_layout);
+}
+
+template Status CublasLtGemm<float>(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache,
+                                    cublasOperation_t trans_a, cublasOperation_t trans_b, int m, int n, int k,
+                                    float alpha, const float* a, int lda, const float* b, int ldb,
+                                    const float* bias, CublasLtActivation activation, float* c, int ldc);
+template Status CublasLtGemm<half>(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache,
+                                   cublasOperation_t trans_a, cublasOperation_t trans_b, int m, int n, int k,
+                                   float alpha, const half* a, int lda, const half* b, int ldb,
+                                   const half* bias, CublasLtActivation activation, half* c, int ldc);
+
+bool IsCublasLtInt8Supported(const cudaDeviceProp& prop) {
+  return prop.major * 10 + prop.minor >= 72;
+}
+
+size_t CublasLtCol32Size(int rows, int cols) {
+  // the columns are in tiles of 32, each tile being the 32 values of a row after the other for each row
+  return static_cast<size_t>(rows) * roundoff(cols, 32);
+}
+
+Status CublasLtTransformToCol32(const CudaKernel* cuda_kernel, int rows, int cols, const int8_t* a, int lda,
+                                int8_t* a_col32) {
+  cudaStream_t stream;
+  ORT_RETURN_IF_ERROR(GetStream(cuda_kernel, stream));
+
+  TransformDesc transform_desc;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransformDescCreate(&transform_desc.desc, CUDA_R_32F));
+  MatrixLayout a_layout;
+  MatrixLayout col32_layout;
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_8I, rows, cols, lda, CUBLASLT_ORDER_COL, a_layout));
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_8I, rows, cols, 32 * rows, CUBLASLT_ORDER_COL32, col32_layout));
+
+  const float one = 1.0f;
+  const float zero = 0.0f;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransform(LtHandle(cuda_kernel), transform_desc.desc,
+                                                 &one, a, a_layout.desc,
+                                                 &zero, nullptr, nullptr,
+                                                 a_col32, col32_layout.desc, stream));
+  return Status::OK();
+}
+
+Status CublasLtGemmInt8(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache,
+                        int m, int n, int k,
+                        const int8_t* a_col32,
+                        const int8_t* b, int ldb,
+                        int32_t beta,
+                        int32_t* c, int ldc) {
+  ORT_ENFORCE(a_col32 != nullptr && b != nullptr && c != nullptr, "input matrix should not be null");
+  ORT_ENFORCE(beta == 0 || beta == 1, "beta of the int8 matmul should be 0 or 1");
+
+  cublasLtHandle_t handle = LtHandle(cuda_kernel);
+  cudaStream_t stream;
+  ORT_RETURN_IF_ERROR(GetStream(cuda_kernel, stream));
+
+  // the tensor cores take B as the n x k matrix of its rows, i.e. transposed, in the tiled layout of the device
+  const cublasLtOrder_t b_order = Int8BOrder(cuda_kernel->GetDeviceProp());
+  const int tiled_b_ld = 32 * roundoff(n, b_order == CUBLASLT_ORDER_COL4_4R2_8C ? 8 : 32);
+  auto tiled_b = cuda_kernel->GetScratchBuffer<int8_t>(static_cast<size_t>(tiled_b_ld) * roundoff(k, 32) / 32);
+  auto d_col32 = cuda_kernel->GetScratchBuffer<int32_t>(CublasLtCol32Size(m, n));
+
+  TransformDesc transform_desc;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransformDescCreate(&transform_desc.desc, CUDA_R_32F));
+  const cublasOperation_t transpose = CUBLAS_OP_T;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransformDescSetAttribute(
+      transform_desc.desc, CUBLASLT_MATRIX_TRANSFORM_DESC_TRANSA, &transpose, sizeof(transpose)));
+
+  MatrixLayout b_layout;
+  MatrixLayout tiled_b_layout;
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_8I, k, n, ldb, CUBLASLT_ORDER_COL, b_layout));
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_8I, n, k, tiled_b_ld, b_order, tiled_b_layout));
+
+  const float one = 1.0f;
+  const float zero = 0.0f;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransform(handle, transform_desc.desc,
+                                                 &one, b, b_layout.desc,
+                                                 &zero, nullptr, nullptr,
+                                                 tiled_b.get(), tiled_b_layout.desc, stream));
+
+  // D(m, n) = A x tiled_B^T in COL32
+  MatmulDesc matmul_desc;
+  ORT_RETURN_IF_ERROR(CreateMatmulDesc(CUDA_R_32I, matmul_desc));
+  ORT_RETURN_IF_ERROR(SetMatmulDescAttribute(matmul_desc, CUBLASLT_MATMUL_DESC_TRANSB, transpose));
+
+  MatrixLayout a_layout;
+  MatrixLayout d_layout;
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_8I, m, k, 32 * m, CUBLASLT_ORDER_COL32, a_layout));
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_32I, m, n, 32 * m, CUBLASLT_ORDER_COL32, d_layout));
+
+  const std::vector<int64_t> key{CUDA_R_8I, b_order, m, n, k};
+  const int32_t alpha_matmul = 1;
+  const int32_t beta_matmul = 0;
+  ORT_RETURN_IF_ERROR(Matmul(cuda_kernel, algo_cache, key, matmul_desc, {},
+                             &alpha_matmul, a_col32, a_layout, tiled_b.get(), tiled_b_layout,
+                             &beta_matmul, d_col32.get(), d_layout, d_col32.get(), d_layout));
+
+  // C = D + beta * C, back to column-major
+  TransformDesc output_transform_desc;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransformDescCreate(&output_transform_desc.desc, CUDA_R_32F));
+  MatrixLayout c_layout;
+  ORT_RETURN_IF_ERROR(CreateLayout(CUDA_R_32I, m, n, ldc, CUBLASLT_ORDER_COL, c_layout));
+  const float output_beta = static_cast<float>(beta);
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixTransform(handle, output_transform_desc.desc,
+                                                 &one, d_col32.get(), d_layout.desc,
+                                                 &output_beta, beta != 0 ? c : nullptr,
+                                                 beta != 0 ? c_layout.desc : nullptr,
+                                                 c, c_layout.desc, stream));
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
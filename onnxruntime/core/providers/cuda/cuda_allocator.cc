@@ -51,6 +51,61 @@ FencePtr CUDAAllocator::CreateFence(const SessionState* session_state) {
   return std::make_shared<CUDAFence>(GetGPUDataTransfer(session_state));
 }
 
+CUDAStreamOrderedAllocator::CUDAStreamOrderedAllocator(OrtDevice::DeviceId device_id, const char* name,
+                                                       cudaStream_t stream, size_t release_threshold)
+    : CUDAAllocator(device_id, name), stream_(stream) {
+  ORT_ENFORCE(IsSupported(device_id), "CUDA memory pools are not supported on device ", device_id);
+#if CUDART_VERSION >= 11020
+  cudaMemPool_t pool;
+  CUDA_CALL_THROW(cudaDeviceGetDefaultMemPool(&pool, device_id));
+  uint64_t threshold = release_threshold;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+  // by default the driver may hand a block freed on a stream to another one by making the latter wait on the
+  // former, which would serialize the streams of different sessions
+  int allow_internal_dependencies = 0;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool, cudaMemPoolReuseAllowInternalDependencies,
+                                          &allow_internal_dependencies));
+#else
+  ORT_UNUSED_PARAMETER(release_threshold);
+#endif
+}
+
+bool CUDAStreamOrderedAllocator::IsSupported(OrtDevice::DeviceId device_id) {
+#if CUDART_VERSION >= 11020
+  // also false with a driver older than the runtime, which fails the query
+  int supported = 0;
+  return cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, device_id) == cudaSuccess &&
+         supported != 0;
+#else
+  ORT_UNUSED_PARAMETER(device_id);
+  return false;
+#endif
+}
+
+void* CUDAStreamOrderedAllocator::Alloc(size_t size) {
+  CheckDevice(true);
+  void* p = nullptr;
+#if CUDART_VERSION >= 11020
+  if (size > 0) {
+    CUDA_CALL_THROW(cudaMallocAsync(&p, size, stream_));
+  }
+#else
+  ORT_UNUSED_PARAMETER(size);
+#endif
+  return p;
+}
+
+void CUDAStreamOrderedAllocator::Free(void* p) {
+  CheckDevice(false);
+#if CUDART_VERSION >= 11020
+  if (p != nullptr) {
+    cudaFreeAsync(p, stream_);  // do not throw error, as for cudaFree in CUDAAllocator::Free
+  }
+#else
+  ORT_UNUSED_PARAMETER(p);
+#endif
+}
+
 void* CUDAPinnedAllocator::Alloc(size_t size) {
   void* p = nullptr;
   if (size > 0) {
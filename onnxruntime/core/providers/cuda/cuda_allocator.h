@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cuda_runtime_api.h>
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
@@ -18,10 +19,32 @@ class CUDAAllocator : public IAllocator {
   void Free(void* p) override;
   FencePtr CreateFence(const SessionState* session_state) override;
 
- private:
+ protected:
   void CheckDevice(bool throw_when_fail) const;
 };
 
+// Stream ordered allocator on the memory pool of the device: Alloc is cudaMallocAsync and Free is cudaFreeAsync on
+// one stream, so neither takes a lock in onnxruntime nor waits for the device. A freed block is back in the pool as
+// soon as the work queued before the free on the stream is done, and later allocations on the stream reuse it
+// right away. Another stream only reuses it once it waited on an event recorded after the free, or once the free
+// completed; the driver never makes a stream wait on another to hand out a block.
+// The pool is the default pool of the device, shared by the allocators of all the sessions and threads of the
+// process, and keeps up to release_threshold bytes of freed memory reserved instead of returning it to the device
+// at synchronizations. Requires CUDA 11.2 and a device with memory pools, see IsSupported.
+class CUDAStreamOrderedAllocator : public CUDAAllocator {
+ public:
+  CUDAStreamOrderedAllocator(OrtDevice::DeviceId device_id, const char* name, cudaStream_t stream,
+                             size_t release_threshold);
+
+  static bool IsSupported(OrtDevice::DeviceId device_id);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  cudaStream_t stream_;
+};
+
 //TODO: add a default constructor
 class CUDAPinnedAllocator : public IAllocator {
  public:
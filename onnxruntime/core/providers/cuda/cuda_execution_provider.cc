@@ -5,6 +5,8 @@
 #include "cuda_execution_provider.h"
 #include "cuda_fence.h"
 #include "cuda_allocator.h"
+#include "cudnn_conv_algo_cache.h"
+#include "fusion/elementwise_fusion.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/fallback_cpu_capability.h"
@@ -27,6 +29,17 @@ struct KernelRegistryAndStatus {
   std::shared_ptr<onnxruntime::KernelRegistry> kernel_registry = std::make_shared<onnxruntime::KernelRegistry>();
   Status st;
 };
+
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+constexpr bool kPerThreadDefaultStream = true;
+#else
+constexpr bool kPerThreadDefaultStream = false;
+#endif
+
+// the stream the kernels of the calling thread are launched on
+cudaStream_t DefaultStream() {
+  return kPerThreadDefaultStream ? cudaStreamPerThread : nullptr;
+}
 }  // namespace
 
 namespace onnxruntime {
@@ -57,10 +70,13 @@ ONNX_OPERATOR_KERNEL_EX(
 
 }  // namespace cuda
 
-CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy) {
-  CUDA_CALL_THROW(cudaSetDevice(device_id));
-  CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
-  CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
+static AllocatorPtr CreateCudaAllocator(OrtDevice::DeviceId device_id, size_t cuda_mem_limit,
+                                        ArenaExtendStrategy arena_extend_strategy,
+                                        bool enable_stream_ordered_allocator) {
+  if (enable_stream_ordered_allocator) {
+    // the pool of the device plays the part of the arena
+    return std::make_shared<CUDAStreamOrderedAllocator>(device_id, CUDA, DefaultStream(), cuda_mem_limit);
+  }
 
   AllocatorCreationInfo default_memory_info(
       [](OrtDevice::DeviceId id) {
@@ -73,7 +89,25 @@ CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId de
        -1, -1});
 
   // CUDA malloc/free is expensive so always use an arena
-  allocator_ = CreateAllocator(default_memory_info);
+  return CreateAllocator(default_memory_info);
+}
+
+CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy,
+                                                          bool enable_cuda_graph,
+                                                          bool enable_stream_ordered_allocator) {
+  CUDA_CALL_THROW(cudaSetDevice(device_id));
+  CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
+  CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
+
+  if (enable_cuda_graph || kPerThreadDefaultStream) {
+    // cublas and cudnn are built against the legacy default stream, so they need to be pointed at the
+    // per-thread default stream explicitly for their kernels to be part of a captured graph, and to not
+    // serialize with the kernels other threads launch
+    CUBLAS_CALL_THROW(cublasSetStream(cublas_handle_, cudaStreamPerThread));
+    CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, cudaStreamPerThread));
+  }
+
+  allocator_ = CreateCudaAllocator(device_id, cuda_mem_limit, arena_extend_strategy, enable_stream_ordered_allocator);
 }
 
 CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
@@ -112,6 +146,11 @@ void CUDAExecutionProvider::UpdateProviderOptionsInfo() {
     strategy = "unknown";
   }
   options["arena_extend_strategy"] = strategy;
+  options["enable_cuda_graph"] = enable_cuda_graph_ ? "1" : "0";
+  options["cudnn_conv_algo_cache_path"] = cudnn_conv_algo_cache_path_;
+  options["enable_stream_ordered_allocator"] = enable_stream_ordered_allocator_ ? "1" : "0";
+  options["enable_elementwise_fusion"] = enable_elementwise_fusion_ ? "1" : "0";
+  options["elementwise_fusion_cache_path"] = elementwise_fusion_cache_path_;
 
   IExecutionProvider::SetProviderOptions(options);
 }
@@ -122,9 +161,22 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
       cuda_mem_limit_(info.cuda_mem_limit),
       arena_extend_strategy_(info.arena_extend_strategy),
       cudnn_conv_algo_(info.cudnn_conv_algo),
-      do_copy_in_default_stream_(info.do_copy_in_default_stream) {
+      do_copy_in_default_stream_(info.do_copy_in_default_stream),
+      enable_cuda_graph_(info.enable_cuda_graph),
+      cudnn_conv_algo_cache_path_(info.cudnn_conv_algo_cache_path),
+      enable_stream_ordered_allocator_(info.enable_stream_ordered_allocator),
+      enable_elementwise_fusion_(info.enable_elementwise_fusion),
+      elementwise_fusion_cache_path_(info.elementwise_fusion_cache_path) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
+#if !defined(ENABLE_CUDA_GRAPH)
+  if (enable_cuda_graph_) {
+    LOGS_DEFAULT(WARNING) << "CUDA graph capture was requested but this build was not configured with "
+                             "onnxruntime_ENABLE_CUDA_GRAPH. Kernels will be launched individually.";
+    enable_cuda_graph_ = false;
+  }
+#endif
+
   // must wait GPU idle, otherwise cudaGetDeviceProperties might fail
   CUDA_CALL_THROW(cudaDeviceSynchronize());
   CUDA_CALL_THROW(cudaGetDeviceProperties(&device_prop_, device_id_));
@@ -133,17 +185,21 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
   size_t total = 0;
   CUDA_CALL_THROW(cudaMemGetInfo(&free, &total));
 
-  AllocatorCreationInfo default_memory_info(
-      [](OrtDevice::DeviceId device_id) {
-        return onnxruntime::make_unique<CUDAAllocator>(device_id, CUDA);
-      },
-      device_id_,
-      true,
-      {cuda_mem_limit_,
-       static_cast<int>(arena_extend_strategy_),
-       -1, -1});
+  if (enable_stream_ordered_allocator_) {
+    if (!CUDAStreamOrderedAllocator::IsSupported(device_id_)) {
+      LOGS_DEFAULT(WARNING) << "The stream ordered allocator was requested but CUDA memory pools are not supported "
+                               "by this build or device " << device_id_ << ". Using the BFC arena.";
+      enable_stream_ordered_allocator_ = false;
+    } else if (enable_cuda_graph_) {
+      // the allocations of a captured Run would become nodes of the graph, and the buffers would not outlive it
+      LOGS_DEFAULT(WARNING) << "The stream ordered allocator does not support CUDA graph capture. Using the BFC arena.";
+      enable_stream_ordered_allocator_ = false;
+    }
+  }
 
-  InsertAllocator(CreateAllocator(default_memory_info));
+  default_allocator_ = CreateCudaAllocator(device_id_, cuda_mem_limit_, arena_extend_strategy_,
+                                           enable_stream_ordered_allocator_);
+  InsertAllocator(default_allocator_);
 
   AllocatorCreationInfo pinned_memory_info(
       [](OrtDevice::DeviceId device_id) {
@@ -165,6 +221,15 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
 
   InsertAllocator(CreateAllocator(cpu_memory_info));
 
+  if (!cudnn_conv_algo_cache_path_.empty()) {
+    // a bad cache only costs the searches it would have saved, so it doesn't fail the provider creation
+    auto status = cuda::CudnnConvAlgoCache::Instance().AddFile(cudnn_conv_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Ignoring the cudnn conv algo cache " << cudnn_conv_algo_cache_path_ << ": "
+                            << status.ErrorMessage();
+    }
+  }
+
   UpdateProviderOptionsInfo();
 }
 
@@ -215,7 +280,8 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
 
     // get or create a context
     if (context_state_.retired_context_pool.empty()) {
-      context = std::make_shared<PerThreadContext>(device_id_, cuda_mem_limit_, arena_extend_strategy_);
+      context = std::make_shared<PerThreadContext>(device_id_, cuda_mem_limit_, arena_extend_strategy_,
+                                                   enable_cuda_graph_, enable_stream_ordered_allocator_);
     } else {
       context = context_state_.retired_context_pool.back();
       context_state_.retired_context_pool.pop_back();
@@ -256,6 +322,11 @@ AllocatorPtr CUDAExecutionProvider::GetAllocator(int id, OrtMemType mem_type) co
   // A hypothesis is that arena allocator is not aligned with CUDA output cache, and data from different kernel writes may
   // cause cacheline to contain dirty data.
   if (mem_type == OrtMemTypeDefault) {
+    // an allocator shared with other sessions replaces the per-thread ones, as it is thread safe
+    auto allocator = IExecutionProvider::GetAllocator(id, mem_type);
+    if (allocator != default_allocator_) {
+      return allocator;
+    }
     return GetPerThreadContext().GetAllocator();
   } else {
     return IExecutionProvider::GetAllocator(id, mem_type);
@@ -267,6 +338,19 @@ Status CUDAExecutionProvider::Sync() const {
   return Status::OK();
 }
 
+bool CUDAExecutionProvider::UsesPerThreadStreams() const {
+  return kPerThreadDefaultStream;
+}
+
+Status CUDAExecutionProvider::SyncCurrentThread() const {
+  if (!kPerThreadDefaultStream) {
+    return Sync();
+  }
+
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(cudaStreamPerThread));
+  return Status::OK();
+}
+
 void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
   // when not running in InferenceSession (e.g. Test)
   // it's OK to not remember the deferred release ptr
@@ -320,6 +404,65 @@ Status CUDAExecutionProvider::OnRunEnd() {
   return Status::OK();
 }
 
+bool CUDAExecutionProvider::IsGraphCaptured(uint64_t graph_key) const {
+  std::lock_guard<OrtMutex> lock(cuda_graphs_mutex_);
+  return cuda_graphs_.find(graph_key) != cuda_graphs_.end();
+}
+
+Status CUDAExecutionProvider::BeginGraphCapture(uint64_t graph_key) {
+  ORT_RETURN_IF_NOT(enable_cuda_graph_, "CUDA graph capture is not enabled.");
+  std::lock_guard<OrtMutex> lock(cuda_graphs_mutex_);
+  // a capture records every launch on the per-thread stream of the capturing thread, and the arena blocks used
+  // by the captured kernels must not be handed to a concurrent Run, so only one capture may be in flight.
+  ORT_RETURN_IF(capturing_graph_ != nullptr, "A CUDA graph capture is already in progress.");
+  ORT_RETURN_IF(cuda_graphs_.find(graph_key) != cuda_graphs_.end(), "A CUDA graph was already captured for this key.");
+
+  capturing_graph_ = onnxruntime::make_unique<CUDAGraph>(cudaStreamPerThread);
+  capturing_graph_->CaptureBegin();
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::EndGraphCapture(uint64_t graph_key, bool discard) {
+  std::unique_ptr<CUDAGraph> graph;
+  {
+    std::lock_guard<OrtMutex> lock(cuda_graphs_mutex_);
+    ORT_RETURN_IF(capturing_graph_ == nullptr, "No CUDA graph capture is in progress.");
+    graph = std::move(capturing_graph_);
+  }
+
+  // always end the capture so the stream leaves capture mode
+  auto status = graph->CaptureEnd();
+  if (discard) {
+    return Status::OK();
+  }
+
+  if (!status.IsOK()) {
+    // the captured work never ran, so the outputs of this Run are not valid. don't try again for later Runs.
+    LOGS_DEFAULT(WARNING) << status.ErrorMessage() << " Disabling CUDA graph capture for this session.";
+    enable_cuda_graph_ = false;
+    return status;
+  }
+
+  // nothing was executed while capturing, so launch the graph once to produce the outputs of this Run
+  ORT_RETURN_IF_ERROR(graph->Replay());
+
+  std::lock_guard<OrtMutex> lock(cuda_graphs_mutex_);
+  cuda_graphs_[graph_key] = std::move(graph);
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::ReplayGraph(uint64_t graph_key) {
+  CUDAGraph* graph = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(cuda_graphs_mutex_);
+    auto it = cuda_graphs_.find(graph_key);
+    ORT_RETURN_IF(it == cuda_graphs_.end(), "No CUDA graph was captured for this key.");
+    graph = it->second.get();
+  }
+
+  return graph->Replay();
+}
+
 namespace cuda {
 // opset 1 to 9
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyFromHost);
@@ -1812,7 +1955,9 @@ static bool CastNeedFallbackToCPU(const onnxruntime::Node& node) {
 }
 
 std::unique_ptr<onnxruntime::IDataTransfer> CUDAExecutionProvider::GetDataTransfer() const {
-  return onnxruntime::make_unique<onnxruntime::GPUDataTransfer>(do_copy_in_default_stream_);
+  // copies from pageable CPU memory are staged in the pinned memory arena
+  return onnxruntime::make_unique<onnxruntime::GPUDataTransfer>(
+      do_copy_in_default_stream_, GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPUOutput));
 }
 
 std::vector<std::unique_ptr<ComputeCapability>>
@@ -1881,9 +2026,24 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   // Following logic can be extended for other EPs
   std::unordered_set<NodeIndex> cpu_nodes = GetCpuPreferedNodes(graph, Type(), kernel_registries, candidates);
 
-  std::vector<std::unique_ptr<ComputeCapability>> result;
+  std::vector<NodeIndex> cuda_nodes;
   for (auto& node_index : candidates) {
-    if (cpu_nodes.count(node_index) > 0)
+    if (cpu_nodes.count(node_index) == 0)
+      cuda_nodes.push_back(node_index);
+  }
+
+  // the chains of elementwise ops are fused into one node each, which Compile generates a kernel for
+  std::vector<std::unique_ptr<ComputeCapability>> result;
+  std::unordered_set<NodeIndex> fused_nodes;
+  if (enable_elementwise_fusion_) {
+    for (auto& group : cuda::FindElementwiseFusionGroups(graph, cuda_nodes)) {
+      fused_nodes.insert(group->nodes.begin(), group->nodes.end());
+      result.push_back(onnxruntime::make_unique<ComputeCapability>(std::move(group)));
+    }
+  }
+
+  for (auto& node_index : cuda_nodes) {
+    if (fused_nodes.count(node_index) > 0)
       continue;
 
     std::unique_ptr<IndexedSubGraph> sub_graph = onnxruntime::make_unique<IndexedSubGraph>();
@@ -1893,4 +2053,28 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   return result;
 }
 
+Status CUDAExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                                      std::vector<NodeComputeInfo>& node_compute_funcs) {
+  CUDA_RETURN_IF_ERROR(cudaSetDevice(device_id_));
+  for (const auto* fused_node : fused_nodes) {
+    std::unique_ptr<cuda::FusedElementwiseKernel> kernel;
+    ORT_RETURN_IF_ERROR(cuda::FusedElementwiseKernel::Create(*fused_node, device_prop_,
+                                                             elementwise_fusion_cache_path_, kernel));
+
+    // the kernel is shared by the copies of the compute function and released with the last of them
+    std::shared_ptr<cuda::FusedElementwiseKernel> shared_kernel = std::move(kernel);
+    NodeComputeInfo compute_info;
+    compute_info.create_state_func = [](ComputeContext*, FunctionState* state) {
+      *state = nullptr;
+      return 0;
+    };
+    compute_info.release_state_func = [](FunctionState) {};
+    compute_info.compute_func = [shared_kernel](FunctionState, const OrtApi*, OrtKernelContext* context) {
+      return shared_kernel->Compute(reinterpret_cast<OpKernelContext*>(context), DefaultStream());
+    };
+    node_compute_funcs.push_back(std::move(compute_info));
+  }
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "core/graph/constants.h"
@@ -12,6 +13,7 @@
 #include "core/framework/execution_provider.h"
 #include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cuda_pch.h"
+#include "core/providers/cuda/cuda_graph.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
 
@@ -26,6 +28,21 @@ struct CUDAExecutionProviderInfo {
   ArenaExtendStrategy arena_extend_strategy{ArenaExtendStrategy::kNextPowerOfTwo};
   OrtCudnnConvAlgoSearch cudnn_conv_algo{OrtCudnnConvAlgoSearch::EXHAUSTIVE};
   bool do_copy_in_default_stream{true};
+  // capture the kernels of a Run into a CUDA graph and replay it on later Runs with the same bound buffers.
+  // requires a build with onnxruntime_ENABLE_CUDA_GRAPH so kernels launch on the per-thread default stream.
+  bool enable_cuda_graph{false};
+  // file backing the process wide cache of the algorithms found by exhaustive cuDNN convolution searches,
+  // see cuda::CudnnConvAlgoCache. Empty to only share the searches within the process.
+  std::string cudnn_conv_algo_cache_path;
+  // allocate the device memory with CUDAStreamOrderedAllocator instead of a BFC arena, so that the sessions and
+  // threads using the device share one memory pool. Falls back to the arena if the device or the CUDA version
+  // doesn't support memory pools, or with enable_cuda_graph.
+  bool enable_stream_ordered_allocator{false};
+  // compile the chains of elementwise ops of the graph into one kernel each with NVRTC, see cuda::ElementwiseFusion.
+  bool enable_elementwise_fusion{false};
+  // directory of the PTX compiled for the fused kernels, to not compile them again in later sessions and processes.
+  // Empty to compile the kernels of every session.
+  std::string elementwise_fusion_cache_path;
 };
 
 // Logical device representation.
@@ -38,10 +55,19 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   Status Sync() const override;
 
+  bool UsesPerThreadStreams() const override;
+  Status SyncCurrentThread() const override;
+
   Status OnRunStart() override;
 
   Status OnRunEnd() override;
 
+  bool IsGraphCaptureEnabled() const override { return enable_cuda_graph_; }
+  bool IsGraphCaptured(uint64_t graph_key) const override;
+  Status BeginGraphCapture(uint64_t graph_key) override;
+  Status EndGraphCapture(uint64_t graph_key, bool discard) override;
+  Status ReplayGraph(uint64_t graph_key) override;
+
   const void* GetExecutionHandle() const noexcept override {
     // The CUDA interface does not return anything interesting.
     return nullptr;
@@ -77,6 +103,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
       const onnxruntime::GraphViewer& graph,
       const std::vector<const KernelRegistry*>& kernel_registries) const override;
 
+  // generates the kernels of the nodes fused by the elementwise fusion of GetCapability
+  Status Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
+                 std::vector<NodeComputeInfo>& node_compute_funcs) override;
+
   int GetDeviceId() const { return device_id_; }
   const cudaDeviceProp& GetDeviceProp() const { return device_prop_; };
   int GetCudnnConvAlgo() const { return cudnn_conv_algo_; }
@@ -89,6 +119,20 @@ private:
   ArenaExtendStrategy arena_extend_strategy_;
   int cudnn_conv_algo_;
   bool do_copy_in_default_stream_;
+  bool enable_cuda_graph_;
+  std::string cudnn_conv_algo_cache_path_;
+  bool enable_stream_ordered_allocator_;
+  bool enable_elementwise_fusion_;
+  std::string elementwise_fusion_cache_path_;
+  // the allocator of the device memory inserted by the constructor. the per thread contexts allocate instead of it
+  // unless it was replaced, e.g. by the allocator shared through the env with session.use_env_allocators.
+  AllocatorPtr default_allocator_;
+
+  // captured graphs keyed by the feed/fetch signature computed in InferenceSession::Run.
+  // the graph being captured is only inserted once capturing succeeded.
+  std::unordered_map<uint64_t, std::unique_ptr<CUDAGraph>> cuda_graphs_;
+  std::unique_ptr<CUDAGraph> capturing_graph_;
+  mutable OrtMutex cuda_graphs_mutex_;
 
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
@@ -100,7 +144,8 @@ private:
 
   class PerThreadContext final {
    public:
-    PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy);
+    PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy,
+                     bool enable_cuda_graph, bool enable_stream_ordered_allocator);
     ~PerThreadContext();
 
     cublasHandle_t CublasHandle() const {
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cuda_graph.h"
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+
+CUDAGraph::~CUDAGraph() {
+  Reset();
+}
+
+void CUDAGraph::CaptureBegin() {
+  ORT_ENFORCE(!has_graph_exec_,
+              "This CUDAGraph instance already owns a captured graph. "
+              "To capture a new graph, create a new instance or call Reset() first.");
+
+  CUDA_CALL_THROW(cudaStreamSynchronize(stream_));
+  // cudaStreamCaptureModeGlobal makes any potentially unsafe call made while capturing (such as a synchronous
+  // cudaMemcpy or cudaMalloc from the arena growing) fail and invalidate the capture instead of silently producing
+  // a graph that misses work.
+  CUDA_CALL_THROW(cudaStreamBeginCapture(stream_, cudaStreamCaptureModeGlobal));
+}
+
+Status CUDAGraph::CaptureEnd() {
+  const cudaError_t end_status = cudaStreamEndCapture(stream_, &graph_);
+  if (end_status != cudaSuccess || graph_ == nullptr) {
+    // clear the sticky error so the next Run is not reported as failing
+    ORT_IGNORE_RETURN_VALUE(cudaGetLastError());
+    graph_ = nullptr;
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "CUDA graph capture failed: ", cudaGetErrorName(end_status),
+                           ". The model contains work that cannot be captured into a CUDA graph.");
+  }
+  has_graph_ = true;
+
+  CUDA_RETURN_IF_ERROR(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+
+  // the executable graph holds everything needed for replay
+  CUDA_RETURN_IF_ERROR(cudaGraphDestroy(graph_));
+  graph_ = nullptr;
+  has_graph_ = false;
+
+  return Status::OK();
+}
+
+Status CUDAGraph::Replay() {
+  ORT_RETURN_IF_NOT(has_graph_exec_, "Replaying a CUDA graph that was not captured.");
+  CUDA_RETURN_IF_ERROR(cudaGraphLaunch(graph_exec_, stream_));
+  return Status::OK();
+}
+
+void CUDAGraph::Reset() {
+  if (has_graph_) {
+    CUDA_CALL(cudaGraphDestroy(graph_));
+    has_graph_ = false;
+  }
+  if (has_graph_exec_) {
+    CUDA_CALL(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+}
+
+}  // namespace onnxruntime
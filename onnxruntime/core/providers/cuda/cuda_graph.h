@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+namespace onnxruntime {
+
+// Records the kernels launched on a stream into a CUDA graph and replays them with a single launch.
+// A captured graph is bound to the device addresses used while capturing, so the caller must make sure
+// feeds, fetches and intermediate buffers stay at the same addresses for as long as the graph is replayed.
+struct CUDAGraph {
+  explicit CUDAGraph(cudaStream_t stream) : stream_(stream) {}
+  ~CUDAGraph();
+
+  void CaptureBegin();
+
+  // Finishes the capture and instantiates the graph. Fails if any work submitted while capturing
+  // was not legal inside a capture (e.g. a synchronous copy or a launch on another stream).
+  Status CaptureEnd();
+
+  Status Replay();
+
+  void Reset();
+
+  bool IsCaptured() const { return has_graph_exec_; }
+
+ private:
+  cudaStream_t stream_ = nullptr;
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+  bool has_graph_ = false;
+  bool has_graph_exec_ = false;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAGraph);
+};
+
+}  // namespace onnxruntime
@@ -19,12 +19,22 @@ struct CUDAProviderFactory : IExecutionProviderFactory {
                       size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
                       ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
                       OrtCudnnConvAlgoSearch cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::EXHAUSTIVE,
-                      bool do_copy_in_default_stream = true) 
+                      bool do_copy_in_default_stream = true,
+                      bool enable_cuda_graph = false,
+                      const std::string& cudnn_conv_algo_cache_path = "",
+                      bool enable_stream_ordered_allocator = false,
+                      bool enable_elementwise_fusion = false,
+                      const std::string& elementwise_fusion_cache_path = "")
       : device_id_(device_id), 
         cuda_mem_limit_(cuda_mem_limit), 
         arena_extend_strategy_(arena_extend_strategy),
         cudnn_conv_algo_search_(cudnn_conv_algo_search),
-        do_copy_in_default_stream_(do_copy_in_default_stream) {}
+        do_copy_in_default_stream_(do_copy_in_default_stream),
+        enable_cuda_graph_(enable_cuda_graph),
+        cudnn_conv_algo_cache_path_(cudnn_conv_algo_cache_path),
+        enable_stream_ordered_allocator_(enable_stream_ordered_allocator),
+        enable_elementwise_fusion_(enable_elementwise_fusion),
+        elementwise_fusion_cache_path_(elementwise_fusion_cache_path) {}
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
@@ -35,6 +45,11 @@ struct CUDAProviderFactory : IExecutionProviderFactory {
   ArenaExtendStrategy arena_extend_strategy_;
   OrtCudnnConvAlgoSearch cudnn_conv_algo_search_;
   bool do_copy_in_default_stream_;
+  bool enable_cuda_graph_;
+  std::string cudnn_conv_algo_cache_path_;
+  bool enable_stream_ordered_allocator_;
+  bool enable_elementwise_fusion_;
+  std::string elementwise_fusion_cache_path_;
 };
 
 std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
@@ -44,6 +59,11 @@ std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
   info.arena_extend_strategy = arena_extend_strategy_;
   info.cudnn_conv_algo = cudnn_conv_algo_search_;
   info.do_copy_in_default_stream = do_copy_in_default_stream_;
+  info.enable_cuda_graph = enable_cuda_graph_;
+  info.cudnn_conv_algo_cache_path = cudnn_conv_algo_cache_path_;
+  info.enable_stream_ordered_allocator = enable_stream_ordered_allocator_;
+  info.enable_elementwise_fusion = enable_elementwise_fusion_;
+  info.elementwise_fusion_cache_path = elementwise_fusion_cache_path_;
   return onnxruntime::make_unique<CUDAExecutionProvider>(info);
 }
 
@@ -51,8 +71,16 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(O
                                                                                OrtCudnnConvAlgoSearch cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::EXHAUSTIVE,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
                                                                                ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
-                                                                               bool do_copy_in_default_stream = true) {
-  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id, cuda_mem_limit, arena_extend_strategy, cudnn_conv_algo_search, do_copy_in_default_stream);
+                                                                               bool do_copy_in_default_stream = true,
+                                                                               bool enable_cuda_graph = false,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                      bool enable_stream_ordered_allocator = false,
+                      bool enable_elementwise_fusion = false,
+                      const std::string& elementwise_fusion_cache_path = "") {
+  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id, cuda_mem_limit, arena_extend_strategy, cudnn_conv_algo_search, do_copy_in_default_stream,
+                                                            enable_cuda_graph, cudnn_conv_algo_cache_path,
+                                                            enable_stream_ordered_allocator, enable_elementwise_fusion,
+                                                            elementwise_fusion_cache_path);
 }
 
 }  // namespace onnxruntime
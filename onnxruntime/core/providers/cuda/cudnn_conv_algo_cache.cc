@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cudnn_conv_algo_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+// first line of a cache file, to be changed if the format or the meaning of the entries change
+constexpr const char* kCacheFileHeader = "onnxruntime_cudnn_conv_algo_cache 1";
+}  // namespace
+
+CudnnConvAlgoCache& CudnnConvAlgoCache::Instance() {
+  static CudnnConvAlgoCache cache;
+  return cache;
+}
+
+Status CudnnConvAlgoCache::AddFile(const std::string& path) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (std::find(paths_.begin(), paths_.end(), path) != paths_.end()) {
+    return Status::OK();
+  }
+
+  // the path isn't used if it doesn't hold a cache, to not overwrite some other file
+  EntryMap file_entries;
+  ORT_RETURN_IF_ERROR(LoadFile(path, file_entries));
+  entries_.insert(file_entries.begin(), file_entries.end());
+
+  // save the searches done before the file was added, as they won't be repeated
+  if (entries_.size() > file_entries.size()) {
+    ORT_RETURN_IF_ERROR(SaveFile(path, entries_));
+  }
+  paths_.push_back(path);
+  return Status::OK();
+}
+
+bool CudnnConvAlgoCache::Find(const std::string& key, CudnnConvAlgoCacheEntry& entry) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  entry = it->second;
+  return true;
+}
+
+Status CudnnConvAlgoCache::Insert(const std::string& key, const CudnnConvAlgoCacheEntry& entry) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries_[key] = entry;
+
+  Status status;
+  for (const auto& path : paths_) {
+    // pick up the entries other processes have saved since the file was loaded
+    EntryMap entries = entries_;
+    LoadFile(path, entries).IgnoreError();
+    auto save_status = SaveFile(path, entries);
+    if (!save_status.IsOK() && status.IsOK()) {
+      status = save_status;
+    }
+  }
+  return status;
+}
+
+Status CudnnConvAlgoCache::LoadFile(const std::string& path, EntryMap& entries) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kCacheFileHeader) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, path, " is not a cudnn conv algo cache file.");
+  }
+
+  size_t line_number = 1;
+  while (std::getline(file, line)) {
+    ++line_number;
+    if (line.empty()) {
+      continue;
+    }
+
+    auto tab = line.find('\t');
+    CudnnConvAlgoCacheEntry entry;
+    std::istringstream values(tab == std::string::npos ? std::string() : line.substr(tab + 1));
+    if (!(values >> entry.algo >> entry.memory >> entry.math_type)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid entry at line ", line_number, " of ", path);
+    }
+    entries.emplace(line.substr(0, tab), entry);
+  }
+
+  return Status::OK();
+}
+
+Status CudnnConvAlgoCache::SaveFile(const std::string& path, const EntryMap& entries) {
+  // the temporary file is per process as several processes may save the cache at the same time
+  const std::string temp_path = path + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::out | std::ios::trunc);
+    if (!file) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", temp_path, " for writing.");
+    }
+
+    file << kCacheFileHeader << '\n';
+    for (const auto& entry : entries) {
+      file << entry.first << '\t' << entry.second.algo << ' ' << entry.second.memory << ' '
+           << entry.second.math_type << '\n';
+    }
+
+    file.close();
+    if (!file) {
+      std::remove(temp_path.c_str());
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", temp_path);
+    }
+  }
+
+#ifdef _WIN32
+  // rename doesn't replace an existing file on Windows
+  std::remove(path.c_str());
+#endif
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace ", path);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
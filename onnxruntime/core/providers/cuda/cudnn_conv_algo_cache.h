@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Result of a cuDNN convolution algorithm search, with the cuDNN enums stored as ints.
+struct CudnnConvAlgoCacheEntry {
+  int algo;
+  size_t memory;
+  int math_type;
+};
+
+// Cache of the algorithms found by exhaustive cuDNN convolution searches, shared by the kernels of all sessions
+// through Instance(). Keys are built by the kernels and must identify the device, the cuDNN version and the
+// convolution descriptors, as an algorithm found for one of them may not be valid or fast for another.
+//
+// The cache can be backed by files so the searches also carry over to later processes. A file added with AddFile
+// is loaded once and then rewritten with the entries of every process that uses it whenever a search adds one.
+// Each line of the file holds a key, a tab and the algo, memory and math type of its entry.
+class CudnnConvAlgoCache {
+ public:
+  static CudnnConvAlgoCache& Instance();
+
+  CudnnConvAlgoCache() = default;
+
+  // Loads the entries of <path> and saves the cache to it from now on, starting with the entries the file
+  // doesn't have yet. A missing file is not an error, it is created when the cache has entries to save.
+  Status AddFile(const std::string& path);
+
+  bool Find(const std::string& key, CudnnConvAlgoCacheEntry& entry) const;
+
+  // Adds an entry and saves the cache to the files added so far. The entry is kept if saving fails.
+  Status Insert(const std::string& key, const CudnnConvAlgoCacheEntry& entry);
+
+  using EntryMap = std::unordered_map<std::string, CudnnConvAlgoCacheEntry>;
+
+  // Adds the entries of <path> to <entries>, without replacing existing ones.
+  static Status LoadFile(const std::string& path, EntryMap& entries);
+
+  // Replaces <path> with the entries. The entries are written to a file next to <path> which is then renamed,
+  // so other processes never read a partially written file.
+  static Status SaveFile(const std::string& path, const EntryMap& entries);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnConvAlgoCache);
+
+  EntryMap entries_;
+  std::vector<std::string> paths_;
+  mutable OrtMutex mutex_;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,551 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/fusion/elementwise_fusion.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <nvrtc.h>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/constants.h"
+#include "core/graph/function.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+#define CU_RETURN_IF_ERROR(expr)                                                         \
+  do {                                                                                   \
+    CUresult cu_result = (expr);                                                         \
+    if (cu_result != CUDA_SUCCESS) {                                                     \
+      const char* cu_message = nullptr;                                                  \
+      cuGetErrorString(cu_result, &cu_message);                                          \
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, #expr, " failed: ",                      \
+                             cu_message != nullptr ? cu_message : "unknown CUDA error"); \
+    }                                                                                    \
+  } while (0)
+
+#define NVRTC_RETURN_IF_ERROR(expr)                                                                   \
+  do {                                                                                                \
+    nvrtcResult nvrtc_result = (expr);                                                                \
+    if (nvrtc_result != NVRTC_SUCCESS) {                                                              \
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, #expr, " failed: ", nvrtcGetErrorString(nvrtc_result)); \
+    }                                                                                                 \
+  } while (0)
+
+// expression of each op, with a and b the float values of the first and the second input
+const std::unordered_map<std::string, std::string>& BinaryOps() {
+  static const std::unordered_map<std::string, std::string> ops{
+      {"Add", "a + b"},
+      {"Sub", "a - b"},
+      {"Mul", "a * b"},
+      {"Div", "a / b"},
+      {"Pow", "powf(a, b)"},
+      {"Max", "fmaxf(a, b)"},
+      {"Min", "fminf(a, b)"}};
+  return ops;
+}
+
+const std::unordered_map<std::string, std::string>& UnaryOps() {
+  static const std::unordered_map<std::string, std::string> ops{
+      {"Relu", "fmaxf(a, 0.f)"},
+      {"Sigmoid", "1.f / (1.f + expf(-a))"},
+      {"Tanh", "tanhf(a)"},
+      {"Exp", "expf(a)"},
+      {"Log", "logf(a)"},
+      {"Sqrt", "sqrtf(a)"},
+      {"Neg", "-a"},
+      {"Abs", "fabsf(a)"},
+      {"Reciprocal", "1.f / a"},
+      {"Erf", "erff(a)"}};
+  return ops;
+}
+
+const std::string* TensorType(const NodeArg& arg) {
+  const auto* type = arg.Type();
+  if (type == nullptr || (*type != "tensor(float)" && *type != "tensor(float16)")) {
+    return nullptr;
+  }
+  return type;
+}
+
+// The files of the cache are written next to their final path and renamed, as CudnnConvAlgoCache::SaveFile does,
+// so that other processes never load a partially written module.
+Status SavePtx(const std::string& path, const std::string& ptx) {
+  const std::string temp_path = path + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", temp_path, " for writing.");
+    }
+    file << ptx;
+    file.close();
+    if (!file) {
+      std::remove(temp_path.c_str());
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", temp_path);
+    }
+  }
+
+#ifdef _WIN32
+  std::remove(path.c_str());
+#endif
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace ", path);
+  }
+  return Status::OK();
+}
+
+Status CompilePtx(const std::string& source, const cudaDeviceProp& device_prop, std::string& ptx) {
+  nvrtcProgram program;
+  NVRTC_RETURN_IF_ERROR(nvrtcCreateProgram(&program, source.c_str(), "fused_elementwise.cu", 0, nullptr, nullptr));
+
+  const std::string arch =
+      "--gpu-architecture=compute_" + std::to_string(device_prop.major) + std::to_string(device_prop.minor);
+  const char* options[] = {arch.c_str()};
+  nvrtcResult compile_result = nvrtcCompileProgram(program, 1, options);
+
+  Status status;
+  if (compile_result != NVRTC_SUCCESS) {
+    size_t log_size = 0;
+    std::string log;
+    if (nvrtcGetProgramLogSize(program, &log_size) == NVRTC_SUCCESS && log_size > 1) {
+      log.resize(log_size);
+      nvrtcGetProgramLog(program, &log[0]);
+    }
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to compile the fused elementwise kernel: ",
+                             nvrtcGetErrorString(compile_result), "\n", log, "\n", source);
+  } else {
+    size_t ptx_size = 0;
+    if (nvrtcGetPTXSize(program, &ptx_size) == NVRTC_SUCCESS && ptx_size > 0) {
+      ptx.resize(ptx_size);
+      if (nvrtcGetPTX(program, &ptx[0]) != NVRTC_SUCCESS) {
+        ptx.clear();
+      }
+    }
+    if (ptx.empty()) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to get the PTX of the fused elementwise kernel.");
+    }
+  }
+
+  nvrtcDestroyProgram(&program);
+  return status;
+}
+
+// name of the cache file of the PTX of <source> for the device
+std::string PtxCacheFile(const std::string& cache_path, const std::string& source, const cudaDeviceProp& device_prop) {
+  int nvrtc_major = 0;
+  int nvrtc_minor = 0;
+  nvrtcVersion(&nvrtc_major, &nvrtc_minor);
+  std::ostringstream key;
+  key << source << "\ncompute_" << device_prop.major << device_prop.minor << " nvrtc " << nvrtc_major << "."
+      << nvrtc_minor;
+  const std::string key_string = key.str();
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  MurmurHash3::x86_128(key_string.data(), static_cast<int>(key_string.size()), 0, hash);
+  std::ostringstream file;
+  file << cache_path << "/fused_elementwise_" << std::hex << std::setfill('0');
+  for (auto part : hash) {
+    file << std::setw(8) << part;
+  }
+  file << ".ptx";
+  return file.str();
+}
+
+}  // namespace
+
+bool IsFusableElementwiseNode(const Node& node) {
+  if (node.Domain() != kOnnxDomain) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  const auto& output_defs = node.OutputDefs();
+  size_t expected_inputs = 0;
+  if (BinaryOps().count(node.OpType()) > 0) {
+    expected_inputs = 2;
+  } else if (UnaryOps().count(node.OpType()) > 0) {
+    expected_inputs = 1;
+  } else {
+    return false;
+  }
+  if (input_defs.size() != expected_inputs || output_defs.size() != 1 || !node.ImplicitInputDefs().empty()) {
+    return false;
+  }
+
+  // one element type for all the tensors, so the kernel has one storage type
+  const std::string* type = TensorType(*output_defs[0]);
+  if (type == nullptr) {
+    return false;
+  }
+  for (const auto* input_def : input_defs) {
+    if (!input_def->Exists() || TensorType(*input_def) == nullptr || *TensorType(*input_def) != *type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<std::unique_ptr<IndexedSubGraph>> FindElementwiseFusionGroups(const GraphViewer& graph,
+                                                                          const std::vector<NodeIndex>& candidates) {
+  std::unordered_set<NodeIndex> fusable;
+  for (auto node_index : candidates) {
+    const auto* node = graph.GetNode(node_index);
+    if (node != nullptr && IsFusableElementwiseNode(*node)) {
+      fusable.insert(node_index);
+    }
+  }
+
+  std::unordered_set<const NodeArg*> graph_outputs(graph.GetOutputs().cbegin(), graph.GetOutputs().cend());
+  std::unordered_set<NodeIndex> grouped;
+  std::vector<std::unique_ptr<IndexedSubGraph>> groups;
+
+  // the groups grow from their last node towards their inputs, so the candidates, which are in topological order,
+  // are visited from the last
+  const auto& order = graph.GetNodesInTopologicalOrder();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    if (fusable.count(*it) == 0 || grouped.count(*it) > 0) {
+      continue;
+    }
+
+    std::unordered_set<NodeIndex> group{*it};
+    std::vector<NodeIndex> to_visit{*it};
+    while (!to_visit.empty()) {
+      const Node* node = graph.GetNode(to_visit.back());
+      to_visit.pop_back();
+      for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+        const Node& producer = edge->GetNode();
+        if (fusable.count(producer.Index()) == 0 || grouped.count(producer.Index()) > 0 ||
+            group.count(producer.Index()) > 0 || graph_outputs.count(producer.OutputDefs()[0]) > 0) {
+          continue;
+        }
+
+        // a producer with a consumer outside of the group would need its output written to memory. when a
+        // consumer that isn't in the group yet joins it later, the producer is visited again through it.
+        bool all_consumers_in_group = true;
+        for (auto out_edge = producer.OutputEdgesBegin(); out_edge != producer.OutputEdgesEnd(); ++out_edge) {
+          if (group.count(out_edge->GetNode().Index()) == 0) {
+            all_consumers_in_group = false;
+            break;
+          }
+        }
+        if (all_consumers_in_group) {
+          group.insert(producer.Index());
+          to_visit.push_back(producer.Index());
+        }
+      }
+    }
+
+    if (group.size() < 2) {
+      continue;
+    }
+
+    // the inputs of the group in topological order of their first consumer, the output is the one of the last node
+    auto sub_graph = onnxruntime::make_unique<IndexedSubGraph>();
+    auto meta_def = onnxruntime::make_unique<IndexedSubGraph::MetaDef>();
+    std::unordered_set<std::string> produced;
+    std::unordered_set<std::string> inputs;
+    for (auto node_index : order) {
+      if (group.count(node_index) == 0) {
+        continue;
+      }
+      const Node* node = graph.GetNode(node_index);
+      sub_graph->nodes.push_back(node_index);
+      for (const auto* input_def : node->InputDefs()) {
+        if (produced.count(input_def->Name()) == 0 && inputs.insert(input_def->Name()).second) {
+          meta_def->inputs.push_back(input_def->Name());
+        }
+      }
+      produced.insert(node->OutputDefs()[0]->Name());
+    }
+
+    if (meta_def->inputs.size() > static_cast<size_t>(FusedElementwiseKernel::kMaxInputs)) {
+      continue;
+    }
+
+    // the names of the fused nodes are the names of their functions in the session, so they are made unique in
+    // the process and not only in the graph
+    static std::atomic<int> group_count{0};
+    meta_def->name = "FusedElementwise_" + std::to_string(group_count++);
+    meta_def->domain = kMSDomain;
+    meta_def->since_version = 1;
+    meta_def->status = ONNX_NAMESPACE::EXPERIMENTAL;
+    meta_def->outputs.push_back(graph.GetNode(*it)->OutputDefs()[0]->Name());
+    sub_graph->SetMetaDef(std::move(meta_def));
+
+    grouped.insert(group.begin(), group.end());
+    groups.push_back(std::move(sub_graph));
+  }
+
+  return groups;
+}
+
+Status FusedElementwiseKernel::GenerateSource(const Node& fused_node, std::string& source) {
+  const Function* function = fused_node.GetFunctionBody();
+  ORT_RETURN_IF(function == nullptr, "Fused node ", fused_node.Name(), " has no function body.");
+  const Graph& body = function->Body();
+  const GraphViewer body_viewer(body);
+
+  const auto& input_defs = fused_node.InputDefs();
+  const auto& output_defs = fused_node.OutputDefs();
+  ORT_RETURN_IF_NOT(output_defs.size() == 1 && !input_defs.empty() &&
+                        input_defs.size() <= static_cast<size_t>(kMaxInputs),
+                    "Unexpected inputs or outputs of fused node ", fused_node.Name());
+  const bool is_half = *output_defs[0]->Type() == "tensor(float16)";
+
+  std::ostringstream code;
+  code << "// generated by onnxruntime for " << fused_node.Name() << "\n";
+  if (is_half) {
+    // the kernel is compiled without the CUDA headers, so the float16 values are converted as cuda_fp16.hpp does
+    code << "typedef unsigned short storage_t;\n"
+            "__device__ __forceinline__ float load(storage_t h) {\n"
+            "  float f;\n"
+            "  asm(\"{ cvt.f32.f16 %0, %1;}\\n\" : \"=f\"(f) : \"h\"(h));\n"
+            "  return f;\n"
+            "}\n"
+            "__device__ __forceinline__ storage_t store(float f) {\n"
+            "  storage_t h;\n"
+            "  asm(\"{ cvt.rn.f16.f32 %0, %1;}\\n\" : \"=h\"(h) : \"f\"(f));\n"
+            "  return h;\n"
+            "}\n";
+  } else {
+    code << "typedef float storage_t;\n"
+            "__device__ __forceinline__ float load(storage_t f) { return f; }\n"
+            "__device__ __forceinline__ storage_t store(float f) { return f; }\n";
+  }
+
+  // a device function for each op type of the body, named after the op type
+  std::unordered_set<std::string> op_types;
+  for (auto node_index : body_viewer.GetNodesInTopologicalOrder()) {
+    const Node& node = *body.GetNode(node_index);
+    auto binary = BinaryOps().find(node.OpType());
+    const bool is_binary = binary != BinaryOps().end();
+    ORT_RETURN_IF_NOT((is_binary || UnaryOps().count(node.OpType()) > 0) &&
+                          node.InputDefs().size() == (is_binary ? 2u : 1u) && node.OutputDefs().size() == 1,
+                      "Node ", node.Name(), " of type ", node.OpType(), " can't be fused.");
+    if (!op_types.insert(node.OpType()).second) {
+      continue;
+    }
+    if (is_binary) {
+      code << "__device__ __forceinline__ float " << node.OpType() << "(float a, float b) { return " << binary->second
+           << "; }\n";
+    } else {
+      code << "__device__ __forceinline__ float " << node.OpType() << "(float a) { return "
+           << UnaryOps().at(node.OpType()) << "; }\n";
+    }
+  }
+
+  const size_t num_inputs = input_defs.size();
+  // the parameters are ints only so the host can pass them as an array, see Compute
+  code << "struct Params {\n"
+          "  int rank;\n"
+          "  int n;\n"
+          "  int broadcast;\n"
+          "  int out_strides["
+       << kMaxRank << "];\n"
+       << "  int in_strides[" << num_inputs << "][" << kMaxRank << "];\n"
+       << "};\n"
+       << "extern \"C\" __global__ void " << kKernelName << "(Params p, storage_t* out";
+  for (size_t i = 0; i < num_inputs; ++i) {
+    code << ", const storage_t* __restrict__ in" << i;
+  }
+  code << ") {\n"
+          "  const int idx = blockIdx.x * blockDim.x + threadIdx.x;\n"
+          "  if (idx >= p.n) return;\n"
+          "  int off["
+       << num_inputs << "];\n"
+       << "  for (int i = 0; i < " << num_inputs << "; ++i) off[i] = idx;\n"
+       << "  if (p.broadcast) {\n"
+          "    for (int i = 0; i < "
+       << num_inputs << "; ++i) off[i] = 0;\n"
+       << "    int rem = idx;\n"
+          "    for (int d = 0; d < p.rank; ++d) {\n"
+          "      const int q = rem / p.out_strides[d];\n"
+          "      rem -= q * p.out_strides[d];\n"
+          "      for (int i = 0; i < "
+       << num_inputs << "; ++i) off[i] += q * p.in_strides[i][d];\n"
+       << "    }\n"
+          "  }\n";
+
+  std::unordered_map<std::string, std::string> values;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    const std::string name = "x" + std::to_string(i);
+    code << "  const float " << name << " = load(in" << i << "[off[" << i << "]]);\n";
+    values[input_defs[i]->Name()] = name;
+  }
+
+  int value_count = 0;
+  for (auto node_index : body_viewer.GetNodesInTopologicalOrder()) {
+    const Node& node = *body.GetNode(node_index);
+    const auto& node_inputs = node.InputDefs();
+    std::vector<const std::string*> operands;
+    for (const auto* input_def : node_inputs) {
+      auto value = values.find(input_def->Name());
+      ORT_RETURN_IF(value == values.end(), "Input ", input_def->Name(), " of node ", node.Name(), " is unknown.");
+      operands.push_back(&value->second);
+    }
+
+    const std::string name = "v" + std::to_string(value_count++);
+    code << "  const float " << name << " = " << node.OpType() << "(" << *operands[0];
+    if (operands.size() == 2) {
+      code << ", " << *operands[1];
+    }
+    code << ");\n";
+    values[node.OutputDefs()[0]->Name()] = name;
+  }
+
+  auto output = values.find(output_defs[0]->Name());
+  ORT_RETURN_IF(output == values.end(), "Output ", output_defs[0]->Name(), " of ", fused_node.Name(),
+                " isn't computed by its function body.");
+  code << "  out[idx] = store(" << output->second << ");\n"
+       << "}\n";
+
+  source = code.str();
+  return Status::OK();
+}
+
+Status FusedElementwiseKernel::Create(const Node& fused_node, const cudaDeviceProp& device_prop,
+                                      const std::string& cache_path, std::unique_ptr<FusedElementwiseKernel>& kernel) {
+  std::string source;
+  ORT_RETURN_IF_ERROR(GenerateSource(fused_node, source));
+
+  std::string ptx;
+  std::string cache_file;
+  if (!cache_path.empty()) {
+    cache_file = PtxCacheFile(cache_path, source, device_prop);
+    std::ifstream file(cache_file, std::ios::in | std::ios::binary);
+    if (file) {
+      std::ostringstream content;
+      content << file.rdbuf();
+      ptx = content.str();
+    }
+  }
+
+  if (ptx.empty()) {
+    ORT_RETURN_IF_ERROR(CompilePtx(source, device_prop, ptx));
+    if (!cache_file.empty()) {
+      // the kernel can still be used without the cache
+      Status status = Env::Default().FolderExists(cache_path) ? Status::OK() : Env::Default().CreateFolder(cache_path);
+      if (status.IsOK()) {
+        status = SavePtx(cache_file, ptx);
+      }
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(WARNING) << "Failed to cache the fused elementwise kernel of " << fused_node.Name() << ": "
+                              << status.ErrorMessage();
+      }
+    }
+  }
+
+  std::unique_ptr<FusedElementwiseKernel> result{new FusedElementwiseKernel()};
+  result->num_inputs_ = static_cast<int>(fused_node.InputDefs().size());
+
+  // the module is loaded in the primary context of the device, which the runtime API of the provider uses.
+  // cudaFree(0) makes sure it is initialized and current on this thread.
+  ORT_RETURN_IF_NOT(cudaFree(nullptr) == cudaSuccess, "Failed to initialize the CUDA context.");
+  CU_RETURN_IF_ERROR(cuCtxGetCurrent(&result->context_));
+  CU_RETURN_IF_ERROR(cuModuleLoadData(&result->module_, ptx.c_str()));
+  CU_RETURN_IF_ERROR(cuModuleGetFunction(&result->function_, result->module_, kKernelName));
+
+  kernel = std::move(result);
+  return Status::OK();
+}
+
+FusedElementwiseKernel::~FusedElementwiseKernel() {
+  if (module_ != nullptr) {
+    cuModuleUnload(module_);
+  }
+}
+
+Status FusedElementwiseKernel::Compute(OpKernelContext* context, cudaStream_t stream) const {
+  // the output shape is the numpy broadcast of the shapes of the inputs
+  std::vector<const Tensor*> inputs(num_inputs_);
+  size_t rank = 0;
+  for (int i = 0; i < num_inputs_; ++i) {
+    inputs[i] = context->Input<Tensor>(i);
+    rank = std::max(rank, inputs[i]->Shape().NumDimensions());
+  }
+  ORT_RETURN_IF(rank > static_cast<size_t>(kMaxRank), "Fused elementwise kernels support up to ", kMaxRank,
+                " dimensions, the inputs have ", rank);
+
+  std::vector<int64_t> output_dims(rank, 1);
+  for (const auto* input : inputs) {
+    const auto& dims = input->Shape().GetDims();
+    const size_t offset = rank - dims.size();
+    for (size_t d = 0; d < dims.size(); ++d) {
+      int64_t& output_dim = output_dims[offset + d];
+      if (dims[d] == output_dim || dims[d] == 1) {
+        continue;
+      }
+      ORT_RETURN_IF_NOT(output_dim == 1, "Fused elementwise kernel inputs can't be broadcast: ",
+                        input->Shape().ToString(), " against dimension ", output_dim);
+      output_dim = dims[d];
+    }
+  }
+
+  const TensorShape output_shape(output_dims);
+  Tensor* output = context->Output(0, output_shape);
+  const int64_t size = output_shape.Size();
+  if (size == 0) {
+    return Status::OK();
+  }
+  ORT_RETURN_IF(size > std::numeric_limits<int>::max(), "Fused elementwise kernels are limited to ",
+                std::numeric_limits<int>::max(), " elements, the output has ", size);
+
+  // layout of the Params struct of the generated source
+  std::vector<int> params(3 + kMaxRank + num_inputs_ * kMaxRank, 0);
+  params[0] = static_cast<int>(rank);
+  params[1] = static_cast<int>(size);
+  int* out_strides = &params[3];
+  int stride = 1;
+  for (size_t d = rank; d-- > 0;) {
+    out_strides[d] = stride;
+    stride *= static_cast<int>(output_dims[d]);
+  }
+  for (int i = 0; i < num_inputs_; ++i) {
+    const auto& dims = inputs[i]->Shape().GetDims();
+    // the offsets are the index of the element unless an input broadcasts
+    if (inputs[i]->Shape() != output_shape) {
+      params[2] = 1;
+    }
+    int* in_strides = &params[3 + kMaxRank + i * kMaxRank];
+    const size_t offset = rank - dims.size();
+    int input_stride = 1;
+    for (size_t d = dims.size(); d-- > 0;) {
+      in_strides[offset + d] = dims[d] == 1 ? 0 : input_stride;
+      input_stride *= static_cast<int>(dims[d]);
+    }
+  }
+
+  void* output_data = output->MutableDataRaw();
+  std::vector<const void*> input_data(num_inputs_);
+  std::vector<void*> args{params.data(), &output_data};
+  for (int i = 0; i < num_inputs_; ++i) {
+    input_data[i] = inputs[i]->DataRaw();
+    args.push_back(&input_data[i]);
+  }
+
+  constexpr unsigned int kThreadsPerBlock = 256;
+  const unsigned int blocks = static_cast<unsigned int>((size + kThreadsPerBlock - 1) / kThreadsPerBlock);
+  // the thread running the session may not have used the runtime API yet, which makes the context current
+  CU_RETURN_IF_ERROR(cuCtxSetCurrent(context_));
+  CU_RETURN_IF_ERROR(cuLaunchKernel(function_, blocks, 1, 1, kThreadsPerBlock, 1, 1, 0,
+                                    reinterpret_cast<CUstream>(stream), args.data(), nullptr));
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+
+#include "core/common/common.h"
+#include "core/framework/indexed_sub_graph.h"
+#include "core/framework/op_kernel.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Fusion of the chains of elementwise ops of a graph into one generated kernel each, so that the intermediate
+// results stay in registers instead of round tripping through device memory, and a chain costs one launch.
+//
+// FindElementwiseFusionGroups picks the groups of fusable nodes for GetCapability, as sub graphs with a MetaDef that
+// the partitioner fuses into one node each. FusedElementwiseKernel generates the CUDA source of a fused node,
+// compiles it with NVRTC when the session is initialized and launches it with the driver API. The groups have one
+// output and the inputs broadcast against each other with the numpy rules, as the ops of the group do, so a value of
+// the output only depends on one element of each input and the kernel needs no intermediate buffers.
+//
+// The PTX of the kernels can be cached in a directory, in files named after a hash of the source and the target
+// architecture, so that later sessions and processes only load the module.
+
+// The ops of the groups: the binary arithmetic ops with numpy broadcasting and a set of unary math ops, all on
+// float or float16 tensors. The kernels compute in float, as the float16 kernels of most of these ops do.
+bool IsFusableElementwiseNode(const Node& node);
+
+// Returns the groups of two or more nodes of <candidates>, the nodes the CUDA execution provider can run, that can be
+// fused. A node is pulled into the group of its consumers when all of its consumers are in the group and its output
+// isn't an output of the graph, so only the last node of a group has an output used outside of it.
+std::vector<std::unique_ptr<IndexedSubGraph>> FindElementwiseFusionGroups(const GraphViewer& graph,
+                                                                          const std::vector<NodeIndex>& candidates);
+
+class FusedElementwiseKernel {
+ public:
+  // Generates and compiles the kernel of <fused_node>, a node fused from a group of FindElementwiseFusionGroups.
+  // <cache_path> is the directory of the cached PTX files, empty to not cache it. It is created if missing.
+  static Status Create(const Node& fused_node, const cudaDeviceProp& device_prop, const std::string& cache_path,
+                       std::unique_ptr<FusedElementwiseKernel>& kernel);
+
+  // Generates the CUDA source of the kernel of <fused_node>, which is named kKernelName.
+  static Status GenerateSource(const Node& fused_node, std::string& source);
+
+  ~FusedElementwiseKernel();
+
+  // Broadcasts the inputs, allocates the output and launches the kernel on <stream>.
+  Status Compute(OpKernelContext* context, cudaStream_t stream) const;
+
+  static constexpr const char* kKernelName = "fused_elementwise";
+  // the kernels index the tensors with int and pass the strides of each dimension in their parameters
+  static constexpr int kMaxRank = 8;
+  static constexpr int kMaxInputs = 16;
+
+ private:
+  FusedElementwiseKernel() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FusedElementwiseKernel);
+
+  CUcontext context_ = nullptr;
+  CUmodule module_ = nullptr;
+  CUfunction function_ = nullptr;
+  int num_inputs_ = 0;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
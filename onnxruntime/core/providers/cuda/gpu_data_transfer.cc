@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cuda/gpu_data_transfer.h"
+
+#include <set>
+#include <utility>
+
 #include "cuda_common.h"
 
 // use default stream for copy for now, to avoid racing in BFC arena as in issue #4829
@@ -9,7 +13,10 @@
 // so we leave it as optional, in case user need the previous behavior
 // a full fix to BFC arena is being looked at, and once it's in, we can revert this change
 namespace onnxruntime {
-GPUDataTransfer::GPUDataTransfer(bool do_copy_in_default_stream) {
+constexpr size_t GPUDataTransfer::kMaxStagingBuffers;
+
+GPUDataTransfer::GPUDataTransfer(bool do_copy_in_default_stream, AllocatorPtr pinned_allocator)
+    : pinned_allocator_(std::move(pinned_allocator)) {
   // create streams, default is nullptr
   streams_[kCudaStreamDefault] = nullptr;
   if (do_copy_in_default_stream) {
@@ -22,6 +29,14 @@ GPUDataTransfer::GPUDataTransfer(bool do_copy_in_default_stream) {
 }
 
 GPUDataTransfer::~GPUDataTransfer() {
+  for (auto& buffer : staging_buffers_) {
+    CUDA_CALL(cudaEventSynchronize(buffer->copy_done));
+    CUDA_CALL(cudaEventDestroy(buffer->copy_done));
+    if (buffer->data != nullptr) {
+      pinned_allocator_->Free(buffer->data);
+    }
+  }
+
   if (streams_[kCudaStreamCopyIn] != nullptr) {
     CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyIn]));
   }
@@ -30,6 +45,32 @@ GPUDataTransfer::~GPUDataTransfer() {
   }
 }
 
+// enables the access of device to the memory of peer, once per pair, so that the copies between them go directly
+// over NVLink or PCIe instead of through the host
+static void EnablePeerAccess(int device, int peer) {
+  static OrtMutex mutex;
+  static std::set<std::pair<int, int>> visited_pairs;
+  std::lock_guard<OrtMutex> lock(mutex);
+  if (!visited_pairs.insert({device, peer}).second) {
+    return;
+  }
+
+  int can_access_peer = 0;
+  if (!CUDA_CALL(cudaDeviceCanAccessPeer(&can_access_peer, device, peer)) || !can_access_peer) {
+    return;
+  }
+
+  int current_device;
+  if (!CUDA_CALL(cudaGetDevice(&current_device)) || !CUDA_CALL(cudaSetDevice(device))) {
+    return;
+  }
+  if (cudaDeviceEnablePeerAccess(peer, 0) == cudaErrorPeerAccessAlreadyEnabled) {
+    // clear the error
+    cudaGetLastError();
+  }
+  CUDA_CALL(cudaSetDevice(current_device));
+}
+
 bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
   return src_device.Type() == OrtDevice::GPU || src_device.MemType() == OrtDevice::MemType::CUDA_PINNED ||
          dst_device.Type() == OrtDevice::GPU || dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED;
@@ -47,6 +88,11 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
     if (src_device.Type() == OrtDevice::CPU && src_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copy from pinned memory to GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+    } else if (src_device.Type() == OrtDevice::GPU && src_device.Id() != dst_device.Id()) {
+      // copying between two GPUs, e.g. between the stages of an InferenceSessionPipeline, this is non-blocking
+      EnablePeerAccess(dst_device.Id(), src_device.Id());
+      CUDA_RETURN_IF_ERROR(cudaMemcpyPeerAsync(dst_data, dst_device.Id(), src_data, src_device.Id(), bytes,
+                                               streams_[kCudaStreamDefault]));
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
       // Copy only if the two addresses are different.
@@ -54,8 +100,8 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
         CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, streams_[kCudaStreamDefault]));
       }
     } else {
-      // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      // copy from other CPU memory to GPU, this is staged in pinned memory if possible
+      ORT_RETURN_IF_ERROR(CopyFromPageableMemory(dst_data, src_data, bytes, exec_queue_id));
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU && dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
@@ -72,4 +118,80 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
 
   return Status::OK();
 }
+
+GPUDataTransfer::StagingBuffer* GPUDataTransfer::AcquireStagingBuffer(size_t bytes) const {
+  StagingBuffer* best_fit = nullptr;
+  StagingBuffer* too_small = nullptr;
+  for (auto& buffer : staging_buffers_) {
+    if (buffer->in_use || cudaEventQuery(buffer->copy_done) != cudaSuccess) {
+      continue;
+    }
+
+    if (buffer->size >= bytes) {
+      if (best_fit == nullptr || buffer->size < best_fit->size) {
+        best_fit = buffer.get();
+      }
+    } else {
+      too_small = buffer.get();
+    }
+  }
+
+  if (best_fit == nullptr) {
+    if (too_small != nullptr) {
+      // grow an idle buffer instead of adding one
+      best_fit = too_small;
+      pinned_allocator_->Free(best_fit->data);
+      best_fit->data = nullptr;
+      best_fit->size = 0;
+    } else if (staging_buffers_.size() < kMaxStagingBuffers) {
+      auto buffer = onnxruntime::make_unique<StagingBuffer>();
+      CUDA_CALL_THROW(cudaEventCreateWithFlags(&buffer->copy_done, cudaEventDisableTiming));
+      best_fit = buffer.get();
+      staging_buffers_.push_back(std::move(buffer));
+    } else {
+      return nullptr;
+    }
+
+    best_fit->data = pinned_allocator_->Alloc(bytes);
+    best_fit->size = bytes;
+  }
+
+  best_fit->in_use = true;
+  return best_fit;
+}
+
+Status GPUDataTransfer::CopyFromPageableMemory(void* dst_data, const void* src_data, size_t bytes,
+                                               int exec_queue_id) const {
+  StagingBuffer* buffer = nullptr;
+  if (pinned_allocator_ != nullptr && bytes > 0) {
+    std::lock_guard<OrtMutex> lock(staging_buffers_mutex_);
+    buffer = AcquireStagingBuffer(bytes);
+  }
+
+  if (buffer == nullptr) {
+    // this is blocking
+    CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+    return Status::OK();
+  }
+
+  // copies for the compute stream are issued in the copy-in stream if there's one, so they can overlap the kernels
+  // of a concurrent Run. the compute stream waits for the copy before running the kernels consuming it.
+  cudaStream_t stream = streams_[exec_queue_id];
+  cudaStream_t copy_stream = exec_queue_id == kCudaStreamDefault && streams_[kCudaStreamCopyIn] != nullptr
+                                 ? streams_[kCudaStreamCopyIn]
+                                 : stream;
+
+  // the source can be reused by the caller once this returns
+  memcpy(buffer->data, src_data, bytes);
+  Status status = Status::OK();
+  if (!CUDA_CALL(cudaMemcpyAsync(dst_data, buffer->data, bytes, cudaMemcpyHostToDevice, copy_stream)) ||
+      !CUDA_CALL(cudaEventRecord(buffer->copy_done, copy_stream)) ||
+      (copy_stream != stream && !CUDA_CALL(cudaStreamWaitEvent(stream, buffer->copy_done, 0)))) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to copy ", bytes, " bytes from CPU to GPU memory.");
+  }
+
+  std::lock_guard<OrtMutex> lock(staging_buffers_mutex_);
+  buffer->in_use = false;
+  return status;
+}
 }  // namespace onnxruntime
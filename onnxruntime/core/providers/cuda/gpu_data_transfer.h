@@ -3,8 +3,13 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "cuda_pch.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -17,7 +22,9 @@ enum CUDAStreamType : int {
 
 class GPUDataTransfer : public IDataTransfer {
  public:
-  GPUDataTransfer(bool do_copy_in_default_stream = true);
+  // pinned_allocator is used to stage copies from pageable CPU memory to the GPU, so they don't block the caller
+  // until the copy completes. The copies are synchronous if it's null.
+  GPUDataTransfer(bool do_copy_in_default_stream = true, AllocatorPtr pinned_allocator = nullptr);
   ~GPUDataTransfer();
 
   bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override;
@@ -32,7 +39,27 @@ class GPUDataTransfer : public IDataTransfer {
   }
 
  private:
+  // A pinned buffer holding the source of an asynchronous copy. It can be reused once the copy is done.
+  struct StagingBuffer {
+    void* data = nullptr;
+    size_t size = 0;
+    cudaEvent_t copy_done = nullptr;
+    bool in_use = false;
+  };
+
+  // the number of copies that can be in flight. further copies are synchronous until one completes.
+  static constexpr size_t kMaxStagingBuffers = 8;
+
+  common::Status CopyFromPageableMemory(void* dst_data, const void* src_data, size_t bytes, int exec_queue_id) const;
+
+  // Returns nullptr if all the buffers are in use.
+  StagingBuffer* AcquireStagingBuffer(size_t bytes) const;
+
   cudaStream_t streams_[kTotalCudaStreams];
+
+  AllocatorPtr pinned_allocator_;
+  mutable OrtMutex staging_buffers_mutex_;
+  mutable std::vector<std::unique_ptr<StagingBuffer>> staging_buffers_;
 };
 
 }  // namespace onnxruntime
@@ -41,6 +41,7 @@ Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const T
   if (inputs[0]->IsDataType<float>()) {
     auto einsum_compute_processor = EinsumTypedComputeProcessor<float>(context, allocator, tp,
                                                                        einsum_compute_preprocessor,
+                                                                       contraction_path_cache_,
                                                                        &einsum_cuda_assets);
 
     einsum_compute_processor.SetDeviceHelpers(EinsumOp::DeviceHelpers::CudaDeviceHelpers::Transpose,
@@ -51,6 +52,7 @@ Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const T
   } else if (inputs[0]->IsDataType<double>()) {
     auto einsum_compute_processor = EinsumTypedComputeProcessor<double>(context, allocator, tp,
                                                                         einsum_compute_preprocessor,
+                                                                        contraction_path_cache_,
                                                                         &einsum_cuda_assets);
 
     // Set device specific methods (CPU methods) to be used during processing
@@ -29,6 +29,7 @@ class Einsum final : public onnxruntime::Einsum {
                        AllocatorPtr allocator, concurrency::ThreadPool* tp) const override;
 
   // Members of Einsum CUDA kernel
+  using onnxruntime::Einsum::contraction_path_cache_;
   using onnxruntime::Einsum::einsum_equation_preprocessor_;
   using onnxruntime::Einsum::equation_;
 
@@ -54,9 +54,47 @@ REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
+namespace {
+
+// cuBLASLt runs the float and half matmuls
+template <typename T>
+using IsCublasLtType = std::integral_constant<bool, std::is_same<T, float>::value ||
+                                                        std::is_same<T, MLFloat16>::value>;
+
+template <typename CudaT>
+Status LtGemm(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache, bool trans_a, bool trans_b,
+              int M, int N, int K, float alpha, const CudaT* x, const CudaT* w, const CudaT* bias,
+              CublasLtActivation activation, CudaT* y, std::true_type) {
+  // as for cuBLAS, Y(N,M) = alpha * op(W) x op(X) + B(N,1) x ones(1,M)
+  return CublasLtGemm(cuda_kernel, algo_cache,
+                      trans_b ? CUBLAS_OP_T : CUBLAS_OP_N,
+                      trans_a ? CUBLAS_OP_T : CUBLAS_OP_N,
+                      N, M, K,
+                      alpha,
+                      w, (trans_b ? K : N),
+                      x, (trans_a ? M : K),
+                      bias, activation,
+                      y, N);
+}
+
+template <typename CudaT>
+Status LtGemm(const CudaKernel*, CublasLtAlgoCache&, bool, bool, int, int, int, float, const CudaT*, const CudaT*,
+              const CudaT*, CublasLtActivation, CudaT*, std::false_type) {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "cuBLASLt matmuls are not supported for the type");
+}
+
+}  // namespace
+
 template <typename T>
 Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
+  bool activation_applied = false;
+  return ComputeGemm(ctx, CublasLtActivation::None, activation_applied);
+}
+
+template <typename T>
+Status Gemm<T>::ComputeGemm(OpKernelContext* ctx, CublasLtActivation activation, bool& activation_applied) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
+  activation_applied = false;
 
   const auto* X = ctx->Input<Tensor>(0);
   const auto* W = ctx->Input<Tensor>(1);
@@ -73,6 +111,22 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   auto* Y = ctx->Output(0, {M, N});
   CudaT* out_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
 
+  // The epilogue of the cuBLASLt matmul adds a bias of one value per column of Y, and applies the activation,
+  // saving the kernels broadcasting the bias and applying the activation.
+  const bool has_bias = beta_ != 0 && B != nullptr;
+  const bool is_row_bias = has_bias && B->Shape().Size() == N &&
+                           (B->Shape().NumDimensions() == 1 || B->Shape()[0] == 1);
+  if (IsCublasLtType<T>::value && IsCublasLtActivationSupported(activation) && M > 0 && N > 0 && K > 0 &&
+      (has_bias ? is_row_bias && beta_ == 1.0f : activation != CublasLtActivation::None)) {
+    ORT_RETURN_IF_ERROR(LtGemm<CudaT>(this, cublaslt_algo_cache_, trans_A_, trans_B_, M, N, K, alpha_,
+                                      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+                                      reinterpret_cast<const CudaT*>(W->template Data<T>()),
+                                      has_bias ? reinterpret_cast<const CudaT*>(B->template Data<T>()) : nullptr,
+                                      activation, out_data, IsCublasLtType<T>()));
+    activation_applied = true;
+    return Status::OK();
+  }
+
   CudaT one = ToCudaType<T>::FromFloat(1.0f);
   CudaT zero = ToCudaType<T>::FromFloat(0.0f);
   auto& device_prop = GetDeviceProp();
@@ -140,5 +194,9 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+// FusedGemm derives from these
+template class Gemm<float>;
+template class Gemm<MLFloat16>;
+
 }  // namespace cuda
 }  // namespace onnxruntime
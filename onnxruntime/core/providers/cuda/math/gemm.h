@@ -4,11 +4,12 @@
 #pragma once
 
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/shared_inc/cublaslt_gemm.h"
 
 namespace onnxruntime {
 namespace cuda {
 template <typename T>
-class Gemm final : public CudaKernel {
+class Gemm : public CudaKernel {
   using Base = CudaKernel;
 
  public:
@@ -26,11 +27,17 @@ class Gemm final : public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+ protected:
+  // Computes Y = alpha * A' x B' + beta * C, then <activation> if the epilogue of the cuBLASLt matmul can apply it,
+  // as <activation_applied> tells.
+  Status ComputeGemm(OpKernelContext* context, CublasLtActivation activation, bool& activation_applied) const;
+
  private:
   bool trans_A_;
   bool trans_B_;
   float alpha_;
   float beta_;
+  mutable CublasLtAlgoCache cublaslt_algo_cache_;
 };
 }  // namespace cuda
 }  // namespace onnxruntime
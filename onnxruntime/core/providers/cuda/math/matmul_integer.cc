@@ -26,6 +26,25 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
     MatMulInteger<int8_t, int8_t>);
 
+template <>
+Status MatMulInteger<int8_t, int8_t>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  // B stays, for the column sums of the zero point of A and for the inputs the packed B doesn't apply to
+  is_packed = false;
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2 || tensor.Shape().Size() == 0 ||
+      !IsCublasLtInt8Supported(GetDeviceProp())) {
+    return Status::OK();
+  }
+
+  // as for cuBLAS, the row-major B(K,N) is the column-major A operand of Y^T(N,M) = B^T(N,K) x A^T(K,M)
+  const int K = gsl::narrow<int>(tensor.Shape()[0]);
+  const int N = gsl::narrow<int>(tensor.Shape()[1]);
+  packed_b_ = IAllocator::MakeUniquePtr<int8_t>(Info().GetAllocator(GetDeviceId(), OrtMemTypeDefault),
+                                                CublasLtCol32Size(N, K));
+  ORT_RETURN_IF_ERROR(CublasLtTransformToCol32(this, N, K, tensor.template Data<int8_t>(), N, packed_b_.get()));
+  packed_b_shape_ = tensor.Shape();
+  return Status::OK();
+}
+
 template <>
 Status MatMulInteger<int8_t, int8_t>::ComputeInternal(OpKernelContext* ctx) const {
   auto a = ctx->Input<Tensor>(0);
@@ -91,6 +110,18 @@ Status MatMulInteger<int8_t, int8_t>::ComputeInternal(OpKernelContext* ctx) cons
     beta = 1;
   }
 
+  if (packed_b_ != nullptr && b->Shape() == packed_b_shape_ && helper.OutputOffsets().size() == 1) {
+    // A is flattened to (M,K) for a 2D B, and the int8 tensor cores compute Y^T(N,M) = B^T(N,K) x A^T(K,M)
+    return CublasLtGemmInt8(this, cublaslt_algo_cache_,
+                            static_cast<int>(helper.N()),
+                            static_cast<int>(helper.M()),
+                            static_cast<int>(helper.K()),
+                            packed_b_.get(),
+                            a_ptr, static_cast<int>(helper.K()),
+                            beta,
+                            output_ptr, static_cast<int>(helper.N()));
+  }
+
   for (size_t batch = 0; batch < helper.OutputOffsets().size(); batch++) {
     GemmInt8(static_cast<int>(helper.M()),
              static_cast<int>(helper.N()),
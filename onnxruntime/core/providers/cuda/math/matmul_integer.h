@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/shared_inc/cublaslt_gemm.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -25,9 +26,16 @@ class MatMulInteger final : public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
  private:
   bool has_a_zero_point_;
   bool has_b_zero_point_;
+
+  // a constant 2D B in the COL32 layout of the int8 tensor core matmuls of cuBLASLt
+  IAllocatorUniquePtr<int8_t> packed_b_;
+  TensorShape packed_b_shape_;
+  mutable CublasLtAlgoCache cublaslt_algo_cache_;
 };
 
 }  // namespace cuda
@@ -97,6 +97,14 @@ Status TopK<inputk>::ComputeInternal(OpKernelContext* ctx) const {
   if (IS_PRIM_TYPE(int64_t)) return TOPKIMPL(int64_t);
   if (IS_PRIM_TYPE(float)) return TOPKIMPL(float);
   if (IS_PRIM_TYPE(double)) return TOPKIMPL(double);
+  if (IS_PRIM_TYPE(MLFloat16)) {
+    return TopKImpl<half>(this, reinterpret_cast<const half*>(tensor_X->Data<MLFloat16>()),
+                          static_cast<half*>(tensor_V->MutableDataRaw()),
+                          static_cast<int64_t*>(tensor_I->MutableDataRaw()),
+                          elem_nums_cuda,
+                          elem_nums.size(),
+                          axis, K_, largest_, sorted_, N, dimension);
+  }
   if (IS_PRIM_TYPE(uint8_t)) return TOPKIMPL(uint8_t);
   return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type not supported for TopK operator");
 }
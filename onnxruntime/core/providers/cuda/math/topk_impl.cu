@@ -8,7 +8,9 @@
 #include "cub/util_type.cuh"
 #include "cub/util_allocator.cuh"
 #include "cub/device/device_radix_sort.cuh"
+#include <algorithm>
 #include <limits>
+#include <type_traits>
 
 namespace onnxruntime {
 namespace cuda {
@@ -362,30 +364,247 @@ __global__ void FillInput(const T* input_x, T* output_v, int64_t* output_i, cons
   output_i[id] = id;
 }
 
+// Radix select based TopK for long axes and large K. Each row is processed by all the blocks of the device:
+//  1) the K-th key is found with one histogram pass per byte of the key, most significant byte first,
+//  2) the indices of the keys up to the K-th are compacted in index order with a stable cub::DeviceSelect,
+//  3) only the compacted keys, usually just K of them, are sorted with a stable cub::DeviceRadixSort.
+// The keys are the bits of the values mapped so that their unsigned order is the selection order, so the
+// selection is exact and ties are resolved in favor of the lower index, as in the other implementations.
+
+// the axis is long enough for RadixSelectTopK to beat the single block RadixTopK when there are few rows
+constexpr int64_t kRadixSelectMinDimension = 128 * 1024;
+constexpr int64_t kRadixSelectMaxRows = 16;
+
+template <typename T>
+struct RadixSelectTraits {
+  using Bits = typename std::make_unsigned<T>::type;
+  __device__ static Bits ToBits(T x) {
+    // flip the sign bit of signed types so negative values come first
+    return std::is_signed<T>::value ? static_cast<Bits>(static_cast<Bits>(x) ^ (Bits(1) << (sizeof(Bits) * 8 - 1)))
+                                    : static_cast<Bits>(x);
+  }
+};
+
+template <>
+struct RadixSelectTraits<float> {
+  using Bits = uint32_t;
+  __device__ static Bits ToBits(float x) {
+    Bits u = __float_as_uint(x);
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+  }
+};
+
+template <>
+struct RadixSelectTraits<double> {
+  using Bits = uint64_t;
+  __device__ static Bits ToBits(double x) {
+    Bits u = static_cast<Bits>(__double_as_longlong(x));
+    return (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+  }
+};
+
+template <>
+struct RadixSelectTraits<half> {
+  using Bits = uint16_t;
+  __device__ static Bits ToBits(half x) {
+    Bits u = __half_as_ushort(x);
+    return (u & 0x8000u) ? static_cast<Bits>(~u) : static_cast<Bits>(u | 0x8000u);
+  }
+};
+
+// the key to select the K smallest of
+template <typename T>
+__device__ __inline__ typename RadixSelectTraits<T>::Bits RadixSelectKey(T x, int64_t largest) {
+  using Bits = typename RadixSelectTraits<T>::Bits;
+  Bits bits = RadixSelectTraits<T>::ToBits(x);
+  return 1 == largest ? static_cast<Bits>(~bits) : bits;
+}
+
+template <typename Bits>
+struct RadixSelectState {
+  Bits prefix;         // the bytes of the K-th key found so far
+  Bits mask;           // the bytes of the key covered by prefix
+  uint32_t remaining;  // the rank of the K-th key among the keys matching prefix
+  uint32_t histogram[256];
+};
+
+template <typename Bits>
+__global__ void RadixSelectInit(RadixSelectState<Bits>* state, int64_t K) {
+  state->histogram[threadIdx.x] = 0;
+  if (0 == threadIdx.x) {
+    state->prefix = 0;
+    state->mask = 0;
+    state->remaining = static_cast<uint32_t>(K);
+  }
+}
+
+template <typename T, typename Bits>
+__global__ void RadixSelectHistogram(const T* keys, int64_t dimension, int64_t largest,
+                                     RadixSelectState<Bits>* state, int32_t shift) {
+  __shared__ uint32_t histogram[256];
+  for (auto i = threadIdx.x; i < 256; i += blockDim.x) {
+    histogram[i] = 0;
+  }
+  __syncthreads();
+
+  const Bits prefix = state->prefix;
+  const Bits mask = state->mask;
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < dimension; i += gridDim.x * blockDim.x) {
+    auto key = RadixSelectKey(keys[i], largest);
+    if ((key & mask) == prefix) {
+      atomicAdd(&histogram[(key >> shift) & 255], 1);
+    }
+  }
+  __syncthreads();
+
+  for (auto i = threadIdx.x; i < 256; i += blockDim.x) {
+    if (histogram[i] > 0) {
+      atomicAdd(&state->histogram[i], histogram[i]);
+    }
+  }
+}
+
+// finds the byte of the K-th key at shift from the histogram, and clears the histogram for the next pass
+template <typename Bits>
+__global__ void RadixSelectFindByte(RadixSelectState<Bits>* state, int32_t shift) {
+  if (0 == threadIdx.x) {
+    uint32_t remaining = state->remaining;
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+      auto count = state->histogram[byte];
+      if (remaining <= count) {
+        state->prefix |= static_cast<Bits>(byte) << shift;
+        state->mask |= static_cast<Bits>(255) << shift;
+        break;
+      }
+      remaining -= count;
+    }
+    state->remaining = remaining;
+  }
+  __syncthreads();
+  state->histogram[threadIdx.x] = 0;
+}
+
+template <typename T, typename Bits>
+struct RadixSelectUpToKth {
+  const T* keys;
+  int64_t largest;
+  const RadixSelectState<Bits>* state;
+
+  __device__ __forceinline__ bool operator()(const int64_t& i) const {
+    return RadixSelectKey(keys[i], largest) <= state->prefix;
+  }
+};
+
+template <typename T, typename Bits>
+__global__ void RadixSelectGatherKeys(const T* keys, const int64_t* indices, Bits* selected_keys, int64_t largest,
+                                      int64_t num_selected) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, num_selected);
+  selected_keys[id] = RadixSelectKey(keys[indices[id]], largest);
+}
+
 template <typename T>
-__global__ void FillOutput(const T* input_v, const int64_t* input_i, T* output_v, int64_t* output_i, const TArray<int64_t> elem_nums, size_t size, int32_t axis, int64_t K, int64_t offset, int64_t dimension) {
+__global__ void RadixSelectOutput(const T* keys, const int64_t* indices, T* output_v, int64_t* output_i,
+                                  const TArray<int64_t> elem_nums, size_t size, int32_t axis, int64_t K,
+                                  int64_t offset, int64_t dimension) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, K);
   auto left = offset / (axis == size - 1 ? 1 : elem_nums[axis + 1]) * elem_nums[axis] * K / dimension;
   auto right = axis == size - 1 ? 0 : offset % elem_nums[axis + 1];
   auto output_offset = left + id * (axis == size - 1 ? 1 : elem_nums[axis + 1]) + right;
-  output_v[output_offset] = input_v[id];
-  output_i[output_offset] = input_i[id];
+  auto index = indices[id];
+  output_v[output_offset] = keys[index];
+  output_i[output_offset] = index;
 }
 
-__global__ void ExcludeOutput(int64_t* output_i, int64_t K, int64_t dimension) {
-  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, dimension);
-  if (id >= K) {
-    output_i[id] = dimension;
+template <typename T>
+Status RadixSelectTopK(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i,
+                       const TArray<int64_t>& elem_nums, size_t size, int32_t axis, int64_t K, int64_t largest,
+                       int64_t sorted, int64_t N, int64_t dimension) {
+  using Bits = typename RadixSelectTraits<T>::Bits;
+
+  // scratch space comes from the CUDA allocator and is reused for each row
+  auto keys_buffer = kernel->GetScratchBuffer<T>(dimension);
+  auto indices_buffer = kernel->GetScratchBuffer<int64_t>(dimension);
+  auto sorted_indices_buffer = kernel->GetScratchBuffer<int64_t>(dimension);
+  auto selected_keys_buffer = kernel->GetScratchBuffer<Bits>(dimension);
+  auto sorted_keys_buffer = kernel->GetScratchBuffer<Bits>(dimension);
+  auto state_buffer = kernel->GetScratchBuffer<RadixSelectState<Bits>>(1);
+  auto num_selected_buffer = kernel->GetScratchBuffer<int>(1);
+  auto* keys = keys_buffer.get();
+  auto* indices = indices_buffer.get();
+  auto* sorted_indices = sorted_indices_buffer.get();
+  auto* selected_keys = selected_keys_buffer.get();
+  auto* sorted_keys = sorted_keys_buffer.get();
+  auto* state = state_buffer.get();
+  auto* num_selected = num_selected_buffer.get();
+
+  const int num_items = static_cast<int>(dimension);
+  const RadixSelectUpToKth<T, Bits> select_op{keys, largest, state};
+  cub::CountingInputIterator<int64_t> all_indices(0);
+
+  size_t select_bytes = 0;
+  size_t sort_bytes = 0;
+  size_t sort_indices_bytes = 0;
+  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::If(nullptr, select_bytes, all_indices, indices, num_selected, num_items,
+                                             select_op));
+  CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(nullptr, sort_bytes, selected_keys, sorted_keys, indices,
+                                                       sorted_indices, num_items));
+  CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortKeys(nullptr, sort_indices_bytes, sorted_indices, indices,
+                                                      static_cast<int>(K)));
+  size_t temp_bytes = std::max(select_bytes, std::max(sort_bytes, sort_indices_bytes));
+  auto temp_storage_buffer = kernel->GetScratchBuffer<char>(temp_bytes);
+  auto* temp_storage = temp_storage_buffer.get();
+
+  const int blocks_per_grid_D = static_cast<int>((dimension + BT - 1) / BT);
+  const int blocks_per_grid_K = static_cast<int>((K + BT - 1) / BT);
+  // enough blocks to fill the device while each thread still handles several keys
+  const int histogram_blocks = std::min(blocks_per_grid_D, 256);
+
+  for (int64_t i = 0; i < N; i++) {
+    FillInput<T><<<blocks_per_grid_D, BT, 0>>>(input_x, keys, indices, elem_nums, size, axis, K, i, dimension);
+
+    RadixSelectInit<Bits><<<1, 256, 0>>>(state, K);
+    for (int32_t shift = sizeof(Bits) * 8 - 8; shift >= 0; shift -= 8) {
+      RadixSelectHistogram<T, Bits><<<histogram_blocks, BT, 0>>>(keys, dimension, largest, state, shift);
+      RadixSelectFindByte<Bits><<<1, 256, 0>>>(state, shift);
+    }
+
+    CUDA_RETURN_IF_ERROR(cub::DeviceSelect::If(temp_storage, temp_bytes, all_indices, indices, num_selected,
+                                               num_items, select_op));
+    int h_num_selected = 0;
+    CUDA_RETURN_IF_ERROR(cudaMemcpy(&h_num_selected, num_selected, sizeof(int), cudaMemcpyDeviceToHost));
+
+    // the selected indices are in ascending order and the sort is stable, so ties stay in index order
+    RadixSelectGatherKeys<T, Bits><<<(h_num_selected + BT - 1) / BT, BT, 0>>>(keys, indices, selected_keys, largest,
+                                                                             h_num_selected);
+    CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, selected_keys, sorted_keys, indices,
+                                                         sorted_indices, h_num_selected));
+
+    if (1 == sorted) {
+      RadixSelectOutput<T><<<blocks_per_grid_K, BT, 0>>>(keys, sorted_indices, output_v, output_i, elem_nums, size,
+                                                         axis, K, i, dimension);
+    } else {  // reorder by ascending index
+      CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortKeys(temp_storage, temp_bytes, sorted_indices, indices,
+                                                          static_cast<int>(K)));
+      RadixSelectOutput<T><<<blocks_per_grid_K, BT, 0>>>(keys, indices, output_v, output_i, elem_nums, size, axis,
+                                                         K, i, dimension);
+    }
   }
+
+  return Status::OK();
 }
 
 template <typename T>
-Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const TArray<int64_t>& elem_nums, size_t size, int32_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension) {
+Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const TArray<int64_t>& elem_nums, size_t size, int32_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension, std::true_type /*radix select only*/) {
+  return RadixSelectTopK<T>(kernel, input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, N, dimension);
+}
+
+template <typename T>
+Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const TArray<int64_t>& elem_nums, size_t size, int32_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension, std::false_type /*radix select only*/) {
   auto aligned_K = ALIGN(K);
   auto aligned_dimension = ALIGN(dimension);
   if (aligned_dimension <= GridDim::maxThreadsPerBlock) {
     BitonicTopK<T><<<N, GridDim::maxThreadsPerBlock, aligned_dimension * sizeof(KV<T>)>>>(input_x, output_v, output_i, elem_nums, size, axis, K, aligned_K, largest, sorted, dimension, aligned_dimension, std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
-  } else if (K <= BT*16 || 0 == sorted) {
+  } else if ((K <= BT*16 || 0 == sorted) && (dimension < kRadixSelectMinDimension || N > kRadixSelectMaxRows)) {
     auto XPT = static_cast<int64_t>(ceil(static_cast<double>(dimension) / GridDim::maxThreadsPerBlock));
     if (BT*2 >= K || 0 == sorted) {
       RadixTopK<T,BT,2><<<N,BT,256*sizeof(uint32_t)>>>(input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, dimension, XPT, std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
@@ -397,35 +616,19 @@ Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t
       RadixTopK<T,BT,16><<<N,BT,256*sizeof(uint32_t)>>>(input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, dimension, XPT, std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
     }
   } else {
-    auto input_key_buffer = kernel->GetScratchBuffer<T>(dimension);
-    auto output_key_buffer = kernel->GetScratchBuffer<T>(dimension);
-    auto input_value_buffer = kernel->GetScratchBuffer<int64_t>(dimension);
-    auto output_value_buffer = kernel->GetScratchBuffer<int64_t>(dimension);
-    auto* input_key = input_key_buffer.get();
-    auto* output_key = output_key_buffer.get();
-    auto* input_value = input_value_buffer.get();
-    auto* output_value = output_value_buffer.get();
-    size_t temp_bytes = 0;
-    CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(nullptr, temp_bytes, input_key, output_key, input_value, output_value, dimension));
-    auto temp_storage_buffer = kernel->GetScratchBuffer<char>(temp_bytes);
-    auto* temp_storage = temp_storage_buffer.get();
-    auto blocks_per_grid_D = (int)(ceil(static_cast<float>(dimension) / BT));
-    auto blocks_per_grid_K = (int)(ceil(static_cast<float>(K) / BT));
-    for (int64_t i = 0; i < N; i++) {
-      FillInput<T><<<blocks_per_grid_D, BT, 0>>>(input_x, input_key, input_value, elem_nums, size, axis, K, i, dimension);
-      CUDA_RETURN_IF_ERROR(1 == largest ? cub::DeviceRadixSort::SortPairsDescending(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, dimension) : cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, dimension));
-      if (1 == sorted) {
-        FillOutput<T><<<blocks_per_grid_K, BT, 0>>>(output_key, output_value, output_v, output_i, elem_nums, size, axis, K, i, dimension);
-      } else {  //reorder by ascending index
-        ExcludeOutput<<<blocks_per_grid_D, BT, 0>>>(output_value, K, dimension);
-        CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, output_value, input_value, output_key, input_key, dimension));
-        FillOutput<T><<<blocks_per_grid_K, BT, 0>>>(input_key, input_value, output_v, output_i, elem_nums, size, axis, K, i, dimension);
-      }
-    } 
+    // K is too large for a block to sort, or the axis is long enough to be worth splitting across blocks
+    return RadixSelectTopK<T>(kernel, input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, N, dimension);
   }
   return Status::OK();
 }
 
+template <typename T>
+Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const TArray<int64_t>& elem_nums, size_t size, int32_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension) {
+  // the block based kernels need comparison operators and numeric limits that half doesn't have
+  return TopKImpl<T>(kernel, input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, N, dimension,
+                     std::is_same<T, half>());
+}
+
 #define TOPKIMPLE(T) template Status TopKImpl<T>(const CudaKernel* kernel, \
                                                  const T* input_x,         \
                                                  T* output_v,              \
@@ -449,6 +652,7 @@ TOPKIMPLE(int32_t);
 TOPKIMPLE(int64_t);
 TOPKIMPLE(float);
 TOPKIMPLE(double);
+TOPKIMPLE(half);
 
 }  // namespace cuda
 }  // namespace onnxruntime
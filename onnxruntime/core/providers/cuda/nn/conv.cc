@@ -3,10 +3,13 @@
 
 #include "core/providers/common.h"
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/cudnn_conv_algo_cache.h"
 #include "core/providers/cuda/nn/conv.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 #include "core/providers/cuda/tensor/slice.h"
 
+#include <sstream>
+
 namespace onnxruntime {
 namespace cuda {
 
@@ -52,6 +55,34 @@ static Status SliceOutUnwantedOutputSection(const void* input_data,
   return SliceCuda::Impl(input_data, input_dims, output_data, compute_metadata, element_size);
 }
 
+static void AppendDims(std::ostringstream& key, const char* name, const std::vector<int64_t>& dims) {
+  key << ';' << name;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    key << (i == 0 ? ' ' : ',') << dims[i];
+  }
+}
+
+// Key of an exhaustive forward algorithm search in the process wide CudnnConvAlgoCache.
+// The dims are the ones the cuDNN descriptors are set with.
+static std::string CudnnConvFwdAlgoCacheKey(const cudaDeviceProp& prop,
+                                            cudnnDataType_t data_type,
+                                            const std::vector<int64_t>& x_dims,
+                                            const std::vector<int64_t>& w_dims,
+                                            const std::vector<int64_t>& pads,
+                                            const std::vector<int64_t>& strides,
+                                            const std::vector<int64_t>& dilations,
+                                            int64_t group) {
+  std::ostringstream key;
+  key << "fwd;" << prop.name << " sm_" << prop.major << prop.minor << ";cudnn " << cudnnGetVersion()
+      << ";type " << static_cast<int>(data_type) << ";group " << group;
+  AppendDims(key, "x", x_dims);
+  AppendDims(key, "w", w_dims);
+  AppendDims(key, "pads", pads);
+  AppendDims(key, "strides", strides);
+  AppendDims(key, "dilations", dilations);
+  return key.str();
+}
+
 template <typename T>
 Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
@@ -215,22 +246,42 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
         int cudnn_conv_algo = cuda_ep->GetCudnnConvAlgo();
         ORT_ENFORCE(cudnn_conv_algo > -1 && cudnn_conv_algo < 3, "cudnn_conv_algo should be 0, 1 or 2, but got ", cudnn_conv_algo);
         switch (cudnn_conv_algo) {
-          case 0:
-              CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
-                  CudnnHandle(),
-                  s_.x_tensor,
-                  x_data,
-                  s_.filter_desc,
-                  w_data,
-                  s_.conv_desc,
-                  s_.y_tensor,
-                  y_data,
-                  1,
-                  &algo_count,
-                  &perf,
-                  algo_search_workspace.get(),
-                  AlgoSearchWorkspaceSize));
+          case 0: {
+            // the exhaustive search is shared with the other kernels through the process wide cache
+            const std::string cache_key = CudnnConvFwdAlgoCacheKey(
+                cuda_ep->GetDeviceProp(), CudnnTensor::GetDataType<CudaT>(), x_dims_cudnn, w_dims, pads, strides,
+                dilations, conv_attrs_.group);
+            auto& algo_cache = CudnnConvAlgoCache::Instance();
+            CudnnConvAlgoCacheEntry cached;
+            if (algo_cache.Find(cache_key, cached)) {
+              perf.algo = static_cast<cudnnConvolutionFwdAlgo_t>(cached.algo);
+              perf.memory = cached.memory;
+              perf.mathType = static_cast<cudnnMathType_t>(cached.math_type);
+              break;
+            }
+
+            CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
+                CudnnHandle(),
+                s_.x_tensor,
+                x_data,
+                s_.filter_desc,
+                w_data,
+                s_.conv_desc,
+                s_.y_tensor,
+                y_data,
+                1,
+                &algo_count,
+                &perf,
+                algo_search_workspace.get(),
+                AlgoSearchWorkspaceSize));
+
+            auto status = algo_cache.Insert(cache_key, {static_cast<int>(perf.algo), perf.memory,
+                                                        static_cast<int>(perf.mathType)});
+            if (!status.IsOK()) {
+              LOGS_DEFAULT(WARNING) << "Failed to save the cudnn conv algo cache: " << status.ErrorMessage();
+            }
             break;
+          }
 
           case 1:
               CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionForwardAlgorithm_v7(
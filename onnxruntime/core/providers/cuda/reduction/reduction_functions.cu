@@ -384,5 +384,218 @@ template void reduce_matrix_rows<float, float>(
 template void reduce_matrix_rows<double, double>(
     const double* data, double* output, int m, int n);
 
+namespace {
+
+constexpr int kMatrixColumnsThreadsPerBlock = 256;
+constexpr int kMatrixColumnsWarpsPerBlock = kMatrixColumnsThreadsPerBlock / GPU_WARP_SIZE;
+// rows of up to this many values are reduced by one warp, so a block reduces several rows
+constexpr int kMaxWarpRowSize = 1024;
+// the least values the block of a part of a row reduces when the rows are split across blocks
+constexpr int kMinRowPartSize = 8 * kMatrixColumnsThreadsPerBlock;
+// blocks per multiprocessor to aim for when deciding whether to split the rows across blocks
+constexpr int kBlocksPerMultiprocessor = 4;
+
+template <typename T>
+struct SumOp {
+  __forceinline__ __device__ T operator()(const T& a, const T& b) const { return a + b; }
+  __forceinline__ __device__ static T Init() { return T(0); }
+};
+
+// Max and Min propagate NaN, as the cuDNN reductions do.
+template <typename T>
+struct MaxOp {
+  __forceinline__ __device__ T operator()(const T& a, const T& b) const { return (a > b || a != a) ? a : b; }
+  __forceinline__ __device__ static T Init() { return T(-INFINITY); }
+};
+
+template <typename T>
+struct MinOp {
+  __forceinline__ __device__ T operator()(const T& a, const T& b) const { return (a < b || a != a) ? a : b; }
+  __forceinline__ __device__ static T Init() { return T(INFINITY); }
+};
+
+// post-ops, with the size of the rows of the input
+template <typename T>
+struct NoPostOp {
+  __forceinline__ __device__ T operator()(const T& value, int /*n*/) const { return value; }
+};
+
+template <typename T>
+struct MeanPostOp {
+  __forceinline__ __device__ T operator()(const T& value, int n) const { return value / T(n); }
+};
+
+template <typename T>
+struct SqrtPostOp {
+  __forceinline__ __device__ T operator()(const T& value, int /*n*/) const { return _Sqrt(value); }
+};
+
+template <typename T>
+struct LogPostOp {
+  __forceinline__ __device__ T operator()(const T& value, int /*n*/) const { return _Log(value); }
+};
+
+template <typename T, typename TCombine>
+__forceinline__ __device__ T warp_reduce(T value) {
+#pragma unroll
+  for (int stride = GPU_WARP_SIZE / 2; stride > 0; stride /= 2) {
+    value = TCombine()(value, WARP_SHFL_DOWN(value, stride));
+  }
+  return value;
+}
+
+// One warp per row. post_n is the size of the rows of the original input, which differs from n when the input is
+// the partial results of reduce_matrix_columns_block_kernel.
+template <typename TIn, typename TOut, typename TAcc, typename TPreOp, typename TCombine, typename TPostOp>
+__global__ void reduce_matrix_columns_warp_kernel(const TIn* input, TOut* output, int m, int n, int post_n) {
+  const int row = blockIdx.x * kMatrixColumnsWarpsPerBlock + threadIdx.x / GPU_WARP_SIZE;
+  const int lane = threadIdx.x % GPU_WARP_SIZE;
+  // the warps return as a whole, so the shuffles below see all of their lanes
+  if (row >= m) {
+    return;
+  }
+
+  const TIn* row_input = input + static_cast<int64_t>(row) * n;
+  TAcc value = TCombine::Init();
+  for (int i = lane; i < n; i += GPU_WARP_SIZE) {
+    value = TCombine()(value, TPreOp()(row_input[i]));
+  }
+  value = warp_reduce<TAcc, TCombine>(value);
+
+  if (lane == 0) {
+    output[row] = TOut(TPostOp()(value, post_n));
+  }
+}
+
+// One block per part of a row: block b reduces part b % num_parts of row b / num_parts to output[b].
+template <typename TIn, typename TOut, typename TAcc, typename TPreOp, typename TCombine, typename TPostOp>
+__global__ void reduce_matrix_columns_block_kernel(const TIn* input, TOut* output, int n, int num_parts,
+                                                   int post_n) {
+  __shared__ TAcc warp_values[kMatrixColumnsWarpsPerBlock];
+
+  const int row = blockIdx.x / num_parts;
+  const int part = blockIdx.x % num_parts;
+  const int part_size = (n + num_parts - 1) / num_parts;
+  const int begin = part * part_size;
+  const int end = min(n, begin + part_size);
+
+  const TIn* row_input = input + static_cast<int64_t>(row) * n;
+  TAcc value = TCombine::Init();
+  for (int i = begin + threadIdx.x; i < end; i += kMatrixColumnsThreadsPerBlock) {
+    value = TCombine()(value, TPreOp()(row_input[i]));
+  }
+
+  // warp-level reduction, then the first warp reduces the values of the warps
+  value = warp_reduce<TAcc, TCombine>(value);
+  const int warp = threadIdx.x / GPU_WARP_SIZE;
+  const int lane = threadIdx.x % GPU_WARP_SIZE;
+  if (lane == 0) {
+    warp_values[warp] = value;
+  }
+  __syncthreads();
+
+  if (warp == 0) {
+    value = lane < kMatrixColumnsWarpsPerBlock ? warp_values[lane] : TCombine::Init();
+    value = warp_reduce<TAcc, TCombine>(value);
+    if (lane == 0) {
+      output[blockIdx.x] = TOut(TPostOp()(value, post_n));
+    }
+  }
+}
+
+// Number of blocks each row is reduced by, 0 for one warp per row.
+int compute_matrix_columns_row_parts(int m, int n, int num_multiprocessors) {
+  if (n <= kMaxWarpRowSize) {
+    return 0;
+  }
+  const int target_blocks = std::max(1, num_multiprocessors) * kBlocksPerMultiprocessor;
+  if (m >= target_blocks) {
+    return 1;
+  }
+  return std::max(1, std::min(CeilDiv(target_blocks, m), n / kMinRowPartSize));
+}
+
+template <typename TIn, typename TOut, typename TPreOp, template <typename> class TCombine,
+          template <typename> class TPostOp>
+void call_reduce_matrix_columns(const TIn* input, TOut* output, int m, int n, int num_multiprocessors,
+                                void* buffer) {
+  typedef typename ToBuffer<TIn>::Type TAcc;
+  const int num_parts = compute_matrix_columns_row_parts(m, n, num_multiprocessors);
+
+  if (num_parts == 0) {
+    reduce_matrix_columns_warp_kernel<TIn, TOut, TAcc, TPreOp, TCombine<TAcc>, TPostOp<TAcc>>
+        <<<CeilDiv(m, kMatrixColumnsWarpsPerBlock), kMatrixColumnsThreadsPerBlock>>>(input, output, m, n, n);
+  } else if (num_parts == 1) {
+    reduce_matrix_columns_block_kernel<TIn, TOut, TAcc, TPreOp, TCombine<TAcc>, TPostOp<TAcc>>
+        <<<m, kMatrixColumnsThreadsPerBlock>>>(input, output, n, 1, n);
+  } else {
+    // the partial results of the parts of each row make an m-by-num_parts matrix reduced by a warp per row
+    TAcc* partial_results = reinterpret_cast<TAcc*>(buffer);
+    reduce_matrix_columns_block_kernel<TIn, TAcc, TAcc, TPreOp, TCombine<TAcc>, NoPostOp<TAcc>>
+        <<<m * num_parts, kMatrixColumnsThreadsPerBlock>>>(input, partial_results, n, num_parts, n);
+    reduce_matrix_columns_warp_kernel<TAcc, TOut, TAcc, Cast<TAcc, TAcc>, TCombine<TAcc>, TPostOp<TAcc>>
+        <<<CeilDiv(m, kMatrixColumnsWarpsPerBlock), kMatrixColumnsThreadsPerBlock>>>(
+            partial_results, output, m, num_parts, n);
+  }
+}
+
+}  // namespace
+
+template <typename TIn>
+size_t compute_reduce_matrix_columns_buffer_size(int m, int n, int num_multiprocessors) {
+  typedef typename ToBuffer<TIn>::Type TAcc;
+  const int num_parts = compute_matrix_columns_row_parts(m, n, num_multiprocessors);
+  return num_parts > 1 ? static_cast<size_t>(m) * num_parts * sizeof(TAcc) : 0;
+}
+
+template <typename TIn, typename TOut>
+void reduce_matrix_columns(MatrixColumnsReduction reduction, const TIn* data, TOut* output, int m, int n,
+                           int num_multiprocessors, void* buffer) {
+  typedef typename ToBuffer<TIn>::Type TAcc;
+  switch (reduction) {
+    case MatrixColumnsReduction::Sum:
+      call_reduce_matrix_columns<TIn, TOut, Cast<TAcc, TIn>, SumOp, NoPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::SumSquare:
+      call_reduce_matrix_columns<TIn, TOut, Square<TAcc, TIn>, SumOp, NoPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::L1:
+      call_reduce_matrix_columns<TIn, TOut, Abs<TAcc, TIn>, SumOp, NoPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::L2:
+      call_reduce_matrix_columns<TIn, TOut, Square<TAcc, TIn>, SumOp, SqrtPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::Mean:
+      call_reduce_matrix_columns<TIn, TOut, Cast<TAcc, TIn>, SumOp, MeanPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::LogSum:
+      call_reduce_matrix_columns<TIn, TOut, Cast<TAcc, TIn>, SumOp, LogPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::Max:
+      call_reduce_matrix_columns<TIn, TOut, Cast<TAcc, TIn>, MaxOp, NoPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+    case MatrixColumnsReduction::Min:
+      call_reduce_matrix_columns<TIn, TOut, Cast<TAcc, TIn>, MinOp, NoPostOp>(
+          data, output, m, n, num_multiprocessors, buffer);
+      break;
+  }
+}
+
+#define INSTANTIATE_REDUCE_MATRIX_COLUMNS(T)                                                             \
+  template size_t compute_reduce_matrix_columns_buffer_size<T>(int m, int n, int num_multiprocessors); \
+  template void reduce_matrix_columns<T, T>(MatrixColumnsReduction reduction, const T* data, T* output,   \
+                                            int m, int n, int num_multiprocessors, void* buffer);
+
+INSTANTIATE_REDUCE_MATRIX_COLUMNS(half)
+INSTANTIATE_REDUCE_MATRIX_COLUMNS(float)
+INSTANTIATE_REDUCE_MATRIX_COLUMNS(double)
+
 }  // namespace cuda
 }  // namespace onnxruntime
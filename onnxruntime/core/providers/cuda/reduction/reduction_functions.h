@@ -32,5 +32,30 @@ bool is_matrix_row_reduction(
 template <typename TIn, typename TOut>
 void reduce_matrix_rows(const TIn* data, TOut* output, int m, int n);
 
+// The reductions reduce_matrix_columns computes, each with the pre-op applied to the values and the post-op applied
+// to the result of the ReduceX op of the same name.
+enum class MatrixColumnsReduction {
+  Sum,
+  SumSquare,  // square
+  L1,         // abs
+  L2,         // square, sqrt
+  Mean,       // division by the row size
+  LogSum,     // log
+  Max,
+  Min,
+};
+
+// Size in bytes of the device buffer reduce_matrix_columns needs for an m-by-n input, 0 if it needs none.
+template <typename TIn>
+size_t compute_reduce_matrix_columns_buffer_size(int m, int n, int num_multiprocessors);
+
+// Reduces each of the m rows of the row major m-by-n matrix <data> to one value of <output>, which is the reduction
+// of a tensor over its trailing axes. The strategy depends on the sizes: one warp reduces each row of up to 1024
+// values, one block each longer row, and when the rows are too few to fill the device they are split across blocks
+// whose partial results go through <buffer> to a second pass. half values are accumulated in float.
+template <typename TIn, typename TOut>
+void reduce_matrix_columns(MatrixColumnsReduction reduction, const TIn* data, TOut* output, int m, int n,
+                           int num_multiprocessors, void* buffer);
+
 }  // namespace cuda
 }  // namespace onnxruntime
\ No newline at end of file
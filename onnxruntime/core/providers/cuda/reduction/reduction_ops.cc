@@ -394,6 +394,97 @@ Status PrepareForReduce(const Tensor* X,
   return Status::OK();
 }
 
+namespace {
+
+// The reduction of reduce_matrix_columns computing the cuDNN reduction with the pre and post ops of the ReduceX op.
+bool GetMatrixColumnsReduction(cudnnReduceTensorOp_t cudnn_reduce_op, bool calculate_log, bool calculate_sqt,
+                               MatrixColumnsReduction& reduction) {
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+      if (calculate_log && calculate_sqt) {
+        return false;
+      }
+      reduction = calculate_log ? MatrixColumnsReduction::LogSum
+                                : calculate_sqt ? MatrixColumnsReduction::SumSquare : MatrixColumnsReduction::Sum;
+      return true;
+    case CUDNN_REDUCE_TENSOR_AVG:
+      reduction = MatrixColumnsReduction::Mean;
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      reduction = MatrixColumnsReduction::L1;
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      reduction = MatrixColumnsReduction::L2;
+      break;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      reduction = MatrixColumnsReduction::Max;
+      break;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      reduction = MatrixColumnsReduction::Min;
+      break;
+    default:
+      return false;
+  }
+  return !calculate_log && !calculate_sqt;
+}
+
+// Whether the reduction reduces each row of an m-by-n matrix, i.e. none of the reduced axes with more than one value
+// comes before a kept axis with more than one value. The reduction over all axes is the one of a single row.
+bool IsMatrixColumnsReduction(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& output_dims,
+                              int& m, int& n) {
+  size_t kept_rank = input_dims.size();
+  while (kept_rank > 0 && output_dims[kept_rank - 1] == 1) {
+    --kept_rank;
+  }
+
+  int64_t rows = 1;
+  int64_t row_size = 1;
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    if (i < kept_rank) {
+      if (output_dims[i] != input_dims[i]) {
+        return false;
+      }
+      rows *= input_dims[i];
+    } else {
+      row_size *= input_dims[i];
+    }
+  }
+
+  if (rows > std::numeric_limits<int>::max() || row_size > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  m = static_cast<int>(rows);
+  n = static_cast<int>(row_size);
+  return true;
+}
+
+// reduce_matrix_columns is instantiated for the float types only
+template <typename T>
+using IsMatrixColumnsReductionType = std::integral_constant<bool, std::is_same<T, float>::value ||
+                                                                      std::is_same<T, double>::value ||
+                                                                      std::is_same<T, MLFloat16>::value>;
+
+template <typename T>
+void ReduceMatrixColumns(CUDAExecutionProvider& cuda_ep, MatrixColumnsReduction reduction, const Tensor& input,
+                         Tensor& output, int m, int n, std::true_type) {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const int num_multiprocessors = cuda_ep.GetDeviceProp().multiProcessorCount;
+  auto buffer = cuda_ep.GetScratchBuffer<void>(
+      compute_reduce_matrix_columns_buffer_size<CudaT>(m, n, num_multiprocessors));
+  reduce_matrix_columns(reduction,
+                        reinterpret_cast<const CudaT*>(input.template Data<T>()),
+                        reinterpret_cast<CudaT*>(output.template MutableData<T>()),
+                        m, n, num_multiprocessors, buffer.get());
+}
+
+template <typename T>
+void ReduceMatrixColumns(CUDAExecutionProvider&, MatrixColumnsReduction, const Tensor&, Tensor&, int, int,
+                         std::false_type) {
+  ORT_THROW("reduce_matrix_columns doesn't support ", DataTypeImpl::GetType<T>());
+}
+
+}  // namespace
+
 // `input_shape_override` is the input shape for compute purposes (if provided)
 template <typename T, cudnnReduceTensorIndices_t ReduceTensorIndices>
 Status ReduceComputeCore(CUDAExecutionProvider& cuda_ep, const Tensor& input, PrepareReduceMetadata& prepare_reduce_metadata,
@@ -418,6 +509,18 @@ Status ReduceComputeCore(CUDAExecutionProvider& cuda_ep, const Tensor& input, Pr
     return Status::OK();
   }
 
+  // Block of native reduction over the trailing axes, e.g. the ReduceMean of LayerNormalization like subgraphs.
+  // It takes one kernel, or two for few long rows, with the pre and post ops fused, no cuDNN workspace and no atomics.
+  MatrixColumnsReduction matrix_columns_reduction;
+  int m = 0;
+  int n = 0;
+  if (IsMatrixColumnsReductionType<T>::value && ReduceTensorIndices == CUDNN_REDUCE_TENSOR_NO_INDICES && !log_sum_exp &&
+      GetMatrixColumnsReduction(cudnn_reduce_op, calculate_log, calculate_sqt, matrix_columns_reduction) &&
+      IsMatrixColumnsReduction(input_shape.GetDims(), output_dims, m, n)) {
+    ReduceMatrixColumns<T>(cuda_ep, matrix_columns_reduction, input, output, m, n, IsMatrixColumnsReductionType<T>());
+    return Status::OK();
+  }
+
   // This reduction keep adding values to this buffer. If a non-zero value, say 1000, is here, the sum will start with 1000.
   // Therefore zeroing out the memory is required
   CUDA_RETURN_IF_ERROR(cudaMemset(output.MutableDataRaw(), 0, output.SizeInBytes()));
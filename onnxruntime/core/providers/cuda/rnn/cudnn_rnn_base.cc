@@ -72,7 +72,7 @@ template <typename T>
 Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                                           IAllocatorUniquePtr<void>& reorganized_w_data,
                                           CudnnFilterDescriptor& target_w_desc,
-                                          CudnnRNN& rnn_desc) const {
+                                          const CudnnRNN& rnn_desc) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
   int64_t input_size = W->Shape()[2];
   // RNN W[num_directions_, hidden_size_, input_size]
@@ -106,9 +106,68 @@ Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, cons
   return Status::OK();
 }
 
+template <typename T>
+bool CudnnRnnBase<T>::HasSameWeightLayout(const cudnnRNNDescriptor_t rnn_desc,
+                                          const cudnnRNNDescriptor_t other_rnn_desc,
+                                          int64_t input_size) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  CudnnTensor fake_x_desc;
+  if (!fake_x_desc.Set({1, input_size, 1}, CudnnTensor::GetDataType<CudaT>()).IsOK()) {
+    return false;
+  }
+
+  size_t params_size = 0;
+  size_t other_params_size = 0;
+  if (cudnnGetRNNParamsSize(CudnnHandle(), rnn_desc, fake_x_desc, &params_size, CudnnTensor::GetDataType<CudaT>()) != CUDNN_STATUS_SUCCESS ||
+      cudnnGetRNNParamsSize(CudnnHandle(), other_rnn_desc, fake_x_desc, &other_params_size, CudnnTensor::GetDataType<CudaT>()) != CUDNN_STATUS_SUCCESS ||
+      params_size != other_params_size) {
+    return false;
+  }
+
+  // compare where each matrix and bias of the cached weights is for the two descriptors
+  CudnnFilterDescriptor filter_desc;
+  std::vector<int> lin_layer_ids(W_lin_layer_id_);
+  lin_layer_ids.insert(lin_layer_ids.end(), R_lin_layer_id_.cbegin(), R_lin_layer_id_.cend());
+  for (int layer = 0; layer < RNN_NUM_LAYERS * num_directions_; ++layer) {
+    for (int lin_layer_id : lin_layer_ids) {
+      void* mem_offset = nullptr;
+      void* other_mem_offset = nullptr;
+      if (cudnnGetRNNLinLayerMatrixParams(CudnnHandle(), rnn_desc, layer, fake_x_desc, w_desc_cache_, w_data_cache_.get(),
+                                          lin_layer_id, filter_desc, &mem_offset) != CUDNN_STATUS_SUCCESS ||
+          cudnnGetRNNLinLayerMatrixParams(CudnnHandle(), other_rnn_desc, layer, fake_x_desc, w_desc_cache_, w_data_cache_.get(),
+                                          lin_layer_id, filter_desc, &other_mem_offset) != CUDNN_STATUS_SUCCESS ||
+          mem_offset != other_mem_offset) {
+        return false;
+      }
+
+      if (cudnnGetRNNLinLayerBiasParams(CudnnHandle(), rnn_desc, layer, fake_x_desc, w_desc_cache_, w_data_cache_.get(),
+                                        lin_layer_id, filter_desc, &mem_offset) != CUDNN_STATUS_SUCCESS ||
+          cudnnGetRNNLinLayerBiasParams(CudnnHandle(), other_rnn_desc, layer, fake_x_desc, w_desc_cache_, w_data_cache_.get(),
+                                        lin_layer_id, filter_desc, &other_mem_offset) != CUDNN_STATUS_SUCCESS ||
+          mem_offset != other_mem_offset) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 template <typename T>
 Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   typedef typename ToCudaType<T>::MappedType CudaT;
+  ORT_RETURN_IF_ERROR(rnn_desc_.Set(CudnnHandle(),
+                                    hidden_size_,
+                                    RNN_NUM_LAYERS,
+                                    cudnn_dropout_desc_,
+                                    cudnn_direction_mode_,
+                                    rnn_mode_,
+                                    CudnnTensor::GetDataType<CudaT>(),
+                                    GetDeviceProp()));
+
+  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
+  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc_, CUDNN_RNN_PADDED_IO_ENABLED));
+
   // Cache the weight
   const Tensor* W;
   const Tensor* R;
@@ -118,23 +177,52 @@ Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   bool get_B = info.TryGetConstantInput(RNN_Input_Index::B, &B);
 
   if (get_W && get_R) {
-    CudnnRNN tmp_rnn_desc;
-    ORT_RETURN_IF_ERROR(tmp_rnn_desc.Set(CudnnHandle(),
-                                         hidden_size_,
-                                         RNN_NUM_LAYERS,
-                                         cudnn_dropout_desc_,
-                                         cudnn_direction_mode_,
-                                         rnn_mode_,
-                                         CudnnTensor::GetDataType<CudaT>(),
-                                         GetDeviceProp()));
     if (get_B) {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, rnn_desc_));
     } else {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, rnn_desc_));
     }
     weight_cached_ = true;
+
+    // The persistent kernels need compute capability 6.0 and don't support double. They share the cached weights,
+    // so only use them if cuDNN lays the weights out the same way for both algorithms.
+    if (GetDeviceProp().major >= 6 && !std::is_same<T, double>::value &&
+        persistent_rnn_desc_.Set(CudnnHandle(),
+                                 hidden_size_,
+                                 RNN_NUM_LAYERS,
+                                 cudnn_dropout_desc_,
+                                 cudnn_direction_mode_,
+                                 rnn_mode_,
+                                 CudnnTensor::GetDataType<CudaT>(),
+                                 GetDeviceProp(),
+                                 CUDNN_RNN_ALGO_PERSIST_STATIC)
+            .IsOK()) {
+      persistent_rnn_enabled_ = HasSameWeightLayout(rnn_desc_, persistent_rnn_desc_, W->Shape()[2]);
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+Status CudnnRnnBase<T>::GetBatchDescriptors(int64_t batch_size, int64_t input_size,
+                                            BatchDescriptors*& descriptors) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  std::lock_guard<OrtMutex> lock(batch_descriptors_mutex_);
+  auto& entry = batch_descriptors_[std::make_pair(batch_size, input_size)];
+  if (entry == nullptr) {
+    auto new_descriptors = onnxruntime::make_unique<BatchDescriptors>();
+    std::vector<int64_t> dims_x({batch_size, input_size, 1});
+    std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
+    std::vector<int64_t> dims_hxy({RNN_NUM_LAYERS * num_directions_, batch_size, hidden_size_});
+    ORT_RETURN_IF_ERROR(new_descriptors->x_desc.Set(dims_x, CudnnTensor::GetDataType<CudaT>()));
+    ORT_RETURN_IF_ERROR(new_descriptors->y_desc.Set(dims_y, CudnnTensor::GetDataType<CudaT>()));
+    ORT_RETURN_IF_ERROR(new_descriptors->hxy_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
+    new_descriptors->use_persistent_rnn = persistent_rnn_enabled_ && batch_size <= RNN_PERSISTENT_MAX_BATCH_SIZE;
+    entry = std::move(new_descriptors);
   }
 
+  descriptors = entry.get();
   return Status::OK();
 }
 
@@ -166,24 +254,14 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   Tensor* Y_h = ctx->Output(Output_Index::Y_h, dims_hxy);
   Tensor* Y_c = ctx->Output(Output_Index::Y_c, dims_yc);
 
-  std::vector<int64_t> dims_x({batch_size, input_size, 1});
-  std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
-
-  CudnnTensor x_desc_temp;
-  ORT_RETURN_IF_ERROR(x_desc_temp.Set(dims_x, CudnnTensor::GetDataType<CudaT>()));
-  CudnnTensor y_desc_temp;
-  ORT_RETURN_IF_ERROR(y_desc_temp.Set(dims_y, CudnnTensor::GetDataType<CudaT>()));
-  std::vector<cudnnTensorDescriptor_t> x_desc(seq_length, x_desc_temp);
-  std::vector<cudnnTensorDescriptor_t> y_desc(seq_length, y_desc_temp);
-
-  CudnnTensor hx_desc;
-  CudnnTensor cx_desc;
-  CudnnTensor y_h_desc;
-  CudnnTensor y_c_desc;
-  ORT_RETURN_IF_ERROR(hx_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(cx_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_h_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_c_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
+  BatchDescriptors* batch_descriptors = nullptr;
+  ORT_RETURN_IF_ERROR(GetBatchDescriptors(batch_size, input_size, batch_descriptors));
+  std::vector<cudnnTensorDescriptor_t> x_desc(seq_length, batch_descriptors->x_desc);
+  std::vector<cudnnTensorDescriptor_t> y_desc(seq_length, batch_descriptors->y_desc);
+  const CudnnTensor& hx_desc = batch_descriptors->hxy_desc;
+  const CudnnTensor& cx_desc = batch_descriptors->hxy_desc;
+  const CudnnTensor& y_h_desc = batch_descriptors->hxy_desc;
+  const CudnnTensor& y_c_desc = batch_descriptors->hxy_desc;
 
   IAllocatorUniquePtr<T> x_reversed_data;
   const T* x_data = X->template Data<T>();
@@ -216,16 +294,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
   const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
 
-  CudnnRNN rnn_desc;
-  ORT_RETURN_IF_ERROR(rnn_desc.Set(CudnnHandle(),
-                                   hidden_size_,
-                                   RNN_NUM_LAYERS,
-                                   cudnn_dropout_desc_,
-                                   cudnn_direction_mode_,
-                                   rnn_mode_,
-                                   CudnnTensor::GetDataType<CudaT>(),
-                                   GetDeviceProp()));
-
   // Prepare the weight data
   IAllocatorUniquePtr<void> w_data;
   CudnnFilterDescriptor w_desc;
@@ -233,39 +301,53 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     const Tensor& W = *ctx->Input<Tensor>(RNN_Input_Index::W);
     const Tensor& R = *ctx->Input<Tensor>(RNN_Input_Index::R);
     const Tensor* B = ctx->Input<Tensor>(RNN_Input_Index::B);
-    ORT_RETURN_IF_ERROR(ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc));
+    ORT_RETURN_IF_ERROR(ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc_));
   }
 
-  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
-  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc, CUDNN_RNN_PADDED_IO_ENABLED));
-
   size_t workspace_bytes;
-  CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
-  auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
+  IAllocatorUniquePtr<void> workspace_cuda;
   int32_t zero_seq_count = 0;
   std::vector<int32_t> zero_seq_index_cache(batch_size, 0);
   int64_t zero_seq_index_cache_size = 0;
 
   if (CUDNN_RNN_RELU == rnn_mode_ || CUDNN_RNN_TANH == rnn_mode_ || nullptr == sequence_lens_data) {
-    CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInference(CudnnHandle(),
-                                                   rnn_desc,
-                                                   gsl::narrow_cast<int>(seq_length),
-                                                   x_desc.data(),
-                                                   x_data_input,
-                                                   hx_desc,
-                                                   hx_data,
-                                                   cx_desc,
-                                                   cx_data,
-                                                   weight_cached_ ? w_desc_cache_ : w_desc,
-                                                   weight_cached_ ? w_data_cache_.get() : w_data.get(),
-                                                   y_desc.data(),
-                                                   y_data,
-                                                   y_h_desc,
-                                                   y_h_data,
-                                                   y_c_desc,
-                                                   y_c_data,
-                                                   workspace_cuda.get(),
-                                                   workspace_bytes));
+    auto forward_inference = [&](const CudnnRNN& rnn_desc) {
+      CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
+      workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
+      CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInference(CudnnHandle(),
+                                                     rnn_desc,
+                                                     gsl::narrow_cast<int>(seq_length),
+                                                     x_desc.data(),
+                                                     x_data_input,
+                                                     hx_desc,
+                                                     hx_data,
+                                                     cx_desc,
+                                                     cx_data,
+                                                     weight_cached_ ? w_desc_cache_ : w_desc,
+                                                     weight_cached_ ? w_data_cache_.get() : w_data.get(),
+                                                     y_desc.data(),
+                                                     y_data,
+                                                     y_h_desc,
+                                                     y_h_data,
+                                                     y_c_desc,
+                                                     y_c_data,
+                                                     workspace_cuda.get(),
+                                                     workspace_bytes));
+      return Status::OK();
+    };
+
+    // The persistent kernels have limits on the hidden size that depend on the device, so fall back to the
+    // standard algorithm for good the first time cuDNN rejects them.
+    bool ran_persistent = false;
+    if (batch_descriptors->use_persistent_rnn) {
+      ran_persistent = forward_inference(persistent_rnn_desc_).IsOK();
+      if (!ran_persistent) {
+        batch_descriptors->use_persistent_rnn = false;
+      }
+    }
+    if (!ran_persistent) {
+      ORT_RETURN_IF_ERROR(forward_inference(rnn_desc_));
+    }
   } else {
     // cudnn doesn't support 0 sequence inside the batch, find the 0 sequence and set it to 1
     // there's a ZeroMask kernel to reset the result to 0 for the 0 sequence
@@ -294,8 +376,10 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     CudnnDataTensor y_desc1;
     ORT_RETURN_IF_ERROR(y_desc1.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, hidden_size_ * num_directions_, seq_len_array.data()));
 
+    CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc_, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
+    workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
     CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInferenceEx(CudnnHandle(),
-                                                     rnn_desc,
+                                                     rnn_desc_,
                                                      x_desc1,
                                                      x_data_input,
                                                      hx_desc,
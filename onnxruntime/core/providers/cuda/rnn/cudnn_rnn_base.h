@@ -3,7 +3,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
 #include "gsl/gsl"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/cuda_common.h"
 #include <cudnn.h>
@@ -24,6 +31,10 @@ enum RNN_Input_Index {
 // Onnx RNN/GRU/LSTM only support 1 layer
 const int RNN_NUM_LAYERS = 1;
 
+// Batches up to this size run with CUDNN_RNN_ALGO_PERSIST_STATIC when the device supports it, which keeps the
+// recurrent weights on chip across the time steps instead of reloading them for each step's small GEMM.
+const int64_t RNN_PERSISTENT_MAX_BATCH_SIZE = 8;
+
 class CudnnRNN {
  public:
   CudnnRNN() : cudnn_rnn_desc_(nullptr) {
@@ -38,7 +49,8 @@ class CudnnRNN {
 
   Status Set(const cudnnHandle_t& cudnnHandle, int64_t hidden_size, int num_layers,
              cudnnDropoutDescriptor_t cudnn_dropout_desc, cudnnDirectionMode_t cudnn_direction_model,
-             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType, const cudaDeviceProp& prop) {
+             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType, const cudaDeviceProp& prop,
+             cudnnRNNAlgo_t algo = CUDNN_RNN_ALGO_STANDARD) {
     if (!cudnn_rnn_desc_)
       CUDNN_RETURN_IF_ERROR(cudnnCreateRNNDescriptor(&cudnn_rnn_desc_));
 
@@ -50,7 +62,7 @@ class CudnnRNN {
                                                 CUDNN_LINEAR_INPUT,  // We can also skip the input matrix transformation
                                                 cudnn_direction_model,
                                                 rnn_mode,
-                                                CUDNN_RNN_ALGO_STANDARD,  //CUDNN_RNN_ALGO_PERSIST_STATIC, CUDNN_RNN_ALGO_PERSIST_DYNAMIC
+                                                algo,
                                                 dataType));
 
     if (prop.major >= 7 && dataType == CUDNN_DATA_HALF) {
@@ -94,6 +106,7 @@ class CudnnRnnBase : public CudaKernel {
     ORT_ENFORCE(info.GetAttr("hidden_size", &hidden_size_).IsOK() && hidden_size_ > 0);
     rnn_mode_ = CUDNN_LSTM;
     weight_cached_ = false;
+    persistent_rnn_enabled_ = false;
     w_data_cache_ = nullptr;
 
     size_t state_size;
@@ -103,6 +116,8 @@ class CudnnRnnBase : public CudaKernel {
     cudnn_dropout_desc_.Set(CudnnHandle(), state_buffer_.get(), state_size);
   }
 
+  // Sets up the cuDNN RNN descriptors once the derived class has set the mode, and packs the weights into the
+  // cuDNN layout if they are constant.
   Status CacheCudnnRnnWeights(const OpKernelInfo& info);
 
   Status ComputeInternal(OpKernelContext* ctx) const override;
@@ -110,6 +125,21 @@ class CudnnRnnBase : public CudaKernel {
   void SetRNNMode(cudnnRNNMode_t rnn_mode) { rnn_mode_ = rnn_mode; }
 
  private:
+  // The per-step x/y descriptors and the descriptor shared by hx, cx, y_h and y_c only depend on the batch and
+  // input sizes, so they are created once for each pair seen.
+  struct BatchDescriptors {
+    CudnnTensor x_desc;
+    CudnnTensor y_desc;
+    CudnnTensor hxy_desc;
+    // cleared if cuDNN doesn't support the persistent algorithm for this batch size
+    std::atomic<bool> use_persistent_rnn{false};
+  };
+
+  Status GetBatchDescriptors(int64_t batch_size, int64_t input_size, BatchDescriptors*& descriptors) const;
+
+  bool HasSameWeightLayout(const cudnnRNNDescriptor_t rnn_desc, const cudnnRNNDescriptor_t other_rnn_desc,
+                           int64_t input_size) const;
+
   Status SetCudnnRnnWeightBias(const cudnnHandle_t cudnn_handle,
                                const cudnnRNNDescriptor_t rnn_desc,
                                const cudnnTensorDescriptor_t x_desc,
@@ -122,7 +152,7 @@ class CudnnRnnBase : public CudaKernel {
   Status ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                            IAllocatorUniquePtr<void>& target_w_data,
                            CudnnFilterDescriptor& target_w_desc,
-                           CudnnRNN& rnn_desc) const;
+                           const CudnnRNN& rnn_desc) const;
 
   void SetWeightBias(const cudnnHandle_t handle,
                      const cudnnRNNDescriptor_t rnn_desc,
@@ -159,6 +189,15 @@ class CudnnRnnBase : public CudaKernel {
   IAllocatorUniquePtr<void> w_data_cache_;
   bool weight_cached_;
 
+  // rnn_desc_ is set in CacheCudnnRnnWeights and never changed afterwards. persistent_rnn_desc_ is only used when
+  // persistent_rnn_enabled_, i.e. the weights are cached and the device supports CUDNN_RNN_ALGO_PERSIST_STATIC.
+  CudnnRNN rnn_desc_;
+  CudnnRNN persistent_rnn_desc_;
+  bool persistent_rnn_enabled_;
+
+  mutable OrtMutex batch_descriptors_mutex_;
+  mutable std::map<std::pair<int64_t, int64_t>, std::unique_ptr<BatchDescriptors>> batch_descriptors_;
+
   // cudnn_dropout_desc_ is a cache, never to be changed
   IAllocatorUniquePtr<void> state_buffer_;
   CudnnDropout cudnn_dropout_desc_;
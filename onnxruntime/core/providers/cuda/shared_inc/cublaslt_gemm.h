@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <cublasLt.h>
+
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Matmuls with cuBLASLt, which applies the bias and the activation in the epilogue of the GEMM kernel instead of
+// separate kernels, and runs the int8 tensor core (IMMA) kernels on matrices in the tiled layouts they take.
+// The matrices are column-major as for cuBLAS.
+
+// Activation applied by the epilogue of a matmul, after the bias.
+enum class CublasLtActivation {
+  None,
+  Relu,
+  // the tanh approximation of FastGelu
+  Gelu,
+};
+
+// Whether the epilogue can apply <activation>. The GELU epilogue requires CUDA 11.3.
+bool IsCublasLtActivationSupported(CublasLtActivation activation);
+
+// The algorithms the cuBLASLt heuristics picked for the shapes a kernel has seen, so that only the first matmul of a
+// shape queries them.
+class CublasLtAlgoCache {
+ public:
+  bool Find(const std::vector<int64_t>& key, cublasLtMatmulAlgo_t& algo) const;
+  void Insert(const std::vector<int64_t>& key, const cublasLtMatmulAlgo_t& algo);
+
+ private:
+  mutable OrtMutex mutex_;
+  std::map<std::vector<int64_t>, cublasLtMatmulAlgo_t> algos_;
+};
+
+// C(m, n) = activation(alpha * op(A) x op(B) + bias), with <bias> the m values added to each column of C, or null.
+// T is float or half, computed in float.
+template <typename T>
+Status CublasLtGemm(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache,
+                    cublasOperation_t trans_a, cublasOperation_t trans_b,
+                    int m, int n, int k,
+                    float alpha,
+                    const T* a, int lda,
+                    const T* b, int ldb,
+                    const T* bias, CublasLtActivation activation,
+                    T* c, int ldc);
+
+// Whether the device has the int8 tensor cores of CublasLtGemmInt8.
+bool IsCublasLtInt8Supported(const cudaDeviceProp& prop);
+
+// Bytes of the rows x cols int8 matrix in the COL32 layout of the A operand of CublasLtGemmInt8.
+size_t CublasLtCol32Size(int rows, int cols);
+
+// Transforms the column-major rows x cols int8 matrix <a> to the COL32 layout, for the A operand of
+// CublasLtGemmInt8. <a_col32> has CublasLtCol32Size(rows, cols) bytes.
+Status CublasLtTransformToCol32(const CudaKernel* cuda_kernel, int rows, int cols, const int8_t* a, int lda,
+                                int8_t* a_col32);
+
+// C(m, n) = A(m, k) x B(k, n) + beta * C with the int8 tensor cores, beta being 0 or 1. <a_col32> is A in the COL32
+// layout of CublasLtTransformToCol32, B and C are column-major. B is transformed to the tiled layout of the device and
+// the result from COL32 on each call, so A is the operand to keep transformed, e.g. a weight.
+Status CublasLtGemmInt8(const CudaKernel* cuda_kernel, CublasLtAlgoCache& algo_cache,
+                        int m, int n, int k,
+                        const int8_t* a_col32,
+                        const int8_t* b, int ldb,
+                        int32_t beta,
+                        int32_t* c, int ldc);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -272,11 +272,16 @@ void DmlCommandRecorder::ExecuteCommandList(
     gpuEvent.fence.CopyTo(fence);
     *completionValue = gpuEvent.fenceValue;
 
-    // Trigger a flush of the command list, with the assumption that it contains enough GPU work that this
-    // will help parallelize GPU work with subsequent CPU work.  This policy is related to the choice of
+    // Trigger a flush of the command list if the GPU is idle, with the assumption that it contains enough GPU work
+    // that this will help parallelize GPU work with subsequent CPU work.  This policy is related to the choice of
     // minNodeCountToReuseCommandList within FusedGraphKernel, so both should be tuned together.
-    CloseAndExecute();
-    Open();
+    // If the GPU is still busy the command list is batched with the work recorded after it, which saves the
+    // submission and its fence; it is submitted by the next flush, at the latest at the end of the Run.
+    if (m_queue->GetCurrentCompletionEvent().IsSignaled())
+    {
+        CloseAndExecute();
+        Open();
+    }
 
     SetDescriptorHeap(heap);
 }
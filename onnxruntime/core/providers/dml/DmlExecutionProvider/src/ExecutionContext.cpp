@@ -170,6 +170,16 @@ namespace Dml
         SetCommandRecorder(&m_dmlRecorder);
     }
     
+    void ExecutionContext::FlushIfIdle()
+    {
+        assert(!m_closed);
+
+        if (m_queue->GetCurrentCompletionEvent().IsSignaled())
+        {
+            Flush();
+        }
+    }
+
     void ExecutionContext::QueueReference(IUnknown* object) 
     {              
         assert(!m_closed);
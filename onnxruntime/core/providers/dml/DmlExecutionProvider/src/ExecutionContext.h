@@ -72,6 +72,10 @@ namespace Dml
         // for the submitted work to complete execution on the GPU.
         void Flush();
 
+        // Flushes if the GPU completed all the work submitted before, so it doesn't wait for work. Otherwise the
+        // queued work is batched with the work queued after it, and submitted together.
+        void FlushIfIdle();
+
         // Returns an event which will become signaled when everything submitted to the execution context thus far has
         // completed execution on the GPU, including work that has yet to be flushed to the queue.
         GpuEvent GetCurrentCompletionEvent();
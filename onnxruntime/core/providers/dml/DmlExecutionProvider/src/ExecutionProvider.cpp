@@ -585,6 +585,12 @@ namespace Dml
         m_context->Flush();
     }
 
+    void __stdcall ExecutionProviderImpl::FlushIfIdle() const
+    {
+        assert(!m_closed);
+        m_context->FlushIfIdle();
+    }
+
     void ExecutionProviderImpl::SetDefaultRoundingMode(AllocatorRoundingMode roundingMode)
     {
         m_allocator->SetDefaultRoundingMode(roundingMode);
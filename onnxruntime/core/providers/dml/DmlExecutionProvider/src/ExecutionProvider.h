@@ -124,6 +124,7 @@ namespace Dml
 
         STDMETHOD_(D3D12_COMMAND_LIST_TYPE, GetCommandListTypeForQueue)() const override;
         STDMETHOD_(void, Flush)() const override;
+        STDMETHOD_(void, FlushIfIdle)() const override;
 
         void SetDefaultRoundingMode(AllocatorRoundingMode roundingMode);
 
@@ -249,6 +250,13 @@ namespace Dml
             return m_impl->OnSessionInitializationEnd();
         }
 
+        onnxruntime::common::Status OnRunEnd() override
+        {
+            // Submit the work batched during the Run, e.g. when its outputs are bound to GPU memory
+            m_impl->Flush();
+            return onnxruntime::common::Status::OK();
+        }
+
         void Flush()
         {
             return m_impl->Flush();
@@ -184,9 +184,9 @@ public:
     void Compute(const MLOperatorKernelContext& kernelContext) override
     {
         // Assume that enough GPU work has been queued up after the RNN operator that it is worth
-        // kicking it off, to enable subsequent CPU work to be parallelized with this GPU work.
+        // kicking it off if the GPU is idle, to enable subsequent CPU work to be parallelized with this GPU work.
         __super::Compute(kernelContext);
-        m_executionProvider->Flush();
+        m_executionProvider->FlushIfIdle();
     }
 
 protected:
@@ -104,7 +104,12 @@ namespace Dml
             nullptr,
             IID_PPV_ARGS(&uploadBuffer)));
 
-        return Chunk{ sizeInBytes, std::move(uploadBuffer) };
+        // The CPU never reads from the upload heap
+        void* mappedData = nullptr;
+        D3D12_RANGE readRange = { 0, 0 };
+        THROW_IF_FAILED(uploadBuffer->Map(0, &readRange, &mappedData));
+
+        return Chunk{ sizeInBytes, std::move(uploadBuffer), static_cast<std::byte*>(mappedData) };
     }
 
     std::pair<PooledUploadHeap::Chunk*, size_t> PooledUploadHeap::Reserve(size_t sizeInBytes)
@@ -168,11 +173,8 @@ namespace Dml
         assert(chunk != nullptr);
         assert(offsetInChunk + src.size() <= chunk->capacityInBytes);
 
-        // Map the upload heap and copy the source data into it at the specified offset
-        void* uploadHeapData = nullptr;
-        THROW_IF_FAILED(chunk->resource->Map(0, nullptr, &uploadHeapData));
-        memcpy(static_cast<byte*>(uploadHeapData) + offsetInChunk, src.data(), src.size());
-        chunk->resource->Unmap(0, nullptr);
+        // Copy the source data into the upload heap at the specified offset
+        memcpy(chunk->mappedData + offsetInChunk, src.data(), src.size());
 
         // Copy from the upload heap into the destination resource
         m_executionContext->CopyBufferRegion(
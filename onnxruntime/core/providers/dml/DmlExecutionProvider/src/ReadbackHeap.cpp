@@ -45,6 +45,13 @@ namespace Dml
         return newCapacity;
     }
 
+    void ReadbackHeap::MapReadbackHeap()
+    {
+        void* readbackHeapData = nullptr;
+        THROW_IF_FAILED(m_readbackHeap->Map(0, nullptr, &readbackHeapData));
+        m_readbackHeapData = static_cast<const std::byte*>(readbackHeapData);
+    }
+
     void ReadbackHeap::EnsureReadbackHeap(size_t size) 
     {
         if (!m_readbackHeap)
@@ -53,14 +60,17 @@ namespace Dml
             assert(m_capacity == 0);
             m_capacity = ComputeNewCapacity(c_initialCapacity, size);
             m_readbackHeap = CreateReadbackHeap(m_device.Get(), m_capacity);
+            MapReadbackHeap();
         }
         else if (m_capacity < size)
         {
             // Ensure there's sufficient capacity
             m_capacity = ComputeNewCapacity(m_capacity, size);
 
+            m_readbackHeapData = nullptr;
             m_readbackHeap = nullptr;
             m_readbackHeap = CreateReadbackHeap(m_device.Get(), m_capacity);
+            MapReadbackHeap();
         }
 
         assert(m_readbackHeap->GetDesc().Width >= size);
@@ -91,11 +101,8 @@ namespace Dml
         m_executionContext->GetCurrentCompletionEvent().WaitForSignal();
         m_executionContext->ReleaseCompletedReferences();
 
-        // Map the readback heap and copy it into the destination
-        void* readbackHeapData = nullptr;
-        THROW_IF_FAILED(m_readbackHeap->Map(0, nullptr, &readbackHeapData));
-        memcpy(dst.data(), readbackHeapData, dst.size());
-        m_readbackHeap->Unmap(0, nullptr);
+        // Copy the readback heap into the destination
+        memcpy(dst.data(), m_readbackHeapData, dst.size());
     }
     
     void ReadbackHeap::ReadbackFromGpu(
@@ -141,18 +148,12 @@ namespace Dml
         m_executionContext->GetCurrentCompletionEvent().WaitForSignal();
         m_executionContext->ReleaseCompletedReferences();
 
-        // Map the readback heap and copy it into the destination
-        void* readbackHeapData = nullptr;
-        THROW_IF_FAILED(m_readbackHeap->Map(0, nullptr, &readbackHeapData));
-
-        // Copy from the source resource into the readback heap
+        // Copy the readback heap into the destinations
         offset = 0;
         for (uint32_t i = 0; i < dst.size(); ++i)
         {
-            memcpy(dst[i], static_cast<uint8_t*>(readbackHeapData) + offset, dstSizes[i]);
+            memcpy(dst[i], m_readbackHeapData + offset, dstSizes[i]);
             offset += dstSizes[i];
         }
-
-        m_readbackHeap->Unmap(0, nullptr);
     }
 } // namespace Dml
@@ -31,6 +31,7 @@ namespace Dml
 
     private:
         void EnsureReadbackHeap(size_t size);
+        void MapReadbackHeap();
 
         static constexpr size_t c_initialCapacity = 1024 * 1024; // 1MB
 
@@ -39,6 +40,9 @@ namespace Dml
 
         ComPtr<ID3D12Resource> m_readbackHeap;
         size_t m_capacity = 0;
+
+        // The readback heap stays mapped for its lifetime, it is only read after the copies into it completed
+        const std::byte* m_readbackHeapData = nullptr;
     };
 
 } // namespace Dml
@@ -232,6 +232,17 @@ std::vector<std::unique_ptr<Provider_ComputeCapability>> DNNLExecutionProvider::
 
     auto op_it = dnnl_ops_.find(node->OpType());
     if (op_it != dnnl_ops_.end()) {
+      // the weights of a MatMul are read from the subgraph inputs. if they are computed in the current sub-graph,
+      // the MatMul starts a new one
+      if (node->OpType() == "MatMul" && !sub_var.subgraph_node_indexes.empty() &&
+          std::find(sub_var.outputs.begin(), sub_var.outputs.end(), node->InputDefs()[1]->Name()) !=
+              sub_var.outputs.end()) {
+        CreateMetaDef(graph_viewer, *subgraph_attributes, subgraph_ptr, sub_var, result);
+        subgraph_ptr = std::make_shared<ort_dnnl::Subgraph>(ort_dnnl::Subgraph(graph_name));
+        subgraph_attributes->clear();
+        output_to_source_node_map.clear();
+      }
+
       sub_var.subgraph_node_indexes.push_back(node->Index());
 
       // can we fuse (at Dnnl level) nodes?
@@ -243,7 +254,8 @@ std::vector<std::unique_ptr<Provider_ComputeCapability>> DNNLExecutionProvider::
         }
       }
       if (sub_var.subgraph_node_indexes.size() > 1 && node->OpType() == "Relu") {
-        if (subgraph_ptr->dnnl_nodes.back().name == "Conv-BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "Conv") {
+        if (subgraph_ptr->dnnl_nodes.back().name == "Conv-BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "Conv" ||
+            subgraph_ptr->dnnl_nodes.back().name == "MatMul") {
           subgraph_ptr->dnnl_nodes.back().name += "-Relu";
           fused = true;
         }
@@ -141,6 +141,33 @@ class DNNLExecutionProvider : public Provider_IExecutionProvider {
       if (node->OutputDefs().size() > 1)
         supported = false;
     }
+    if (node->OpType() == "MatMul") {
+      // a 2D or 3D input times 2D weights
+      auto node_inputs = node->InputDefs();
+      if (node_inputs[0]->Shape() == nullptr || node_inputs[1]->Shape() == nullptr ||
+          (node_inputs[0]->Shape()->dim_size() != 2 && node_inputs[0]->Shape()->dim_size() != 3) ||
+          node_inputs[1]->Shape()->dim_size() != 2) {
+        supported = false;
+      }
+    }
+    if (node->OpType() == "Softmax") {
+      // only the softmax over the last axis
+      auto node_inputs = node->InputDefs();
+      if (node_inputs[0]->Shape() == nullptr) {
+        supported = false;
+      } else {
+        int64_t rank = node_inputs[0]->Shape()->dim_size();
+        int64_t axis = 1;
+        const auto& attributes = node->GetAttributes();
+        auto attr = attributes.find("axis");
+        if (attr != attributes.end()) {
+          axis = attr->second().i();
+        }
+        if (rank == 0 || rank > 5 || (axis < 0 ? axis + rank : axis) != rank - 1) {
+          supported = false;
+        }
+      }
+    }
     return supported;
   }
 
@@ -169,7 +196,8 @@ class DNNLExecutionProvider : public Provider_IExecutionProvider {
 
   // supported Dnnl Operators
   std::set<std::string> dnnl_ops_ = {"Conv", "BatchNormalization", "Relu", "Sum",
-                                     "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN"};
+                                     "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN",
+                                     "MatMul", "Softmax"};
 
   mutable std::unordered_map<std::string, std::shared_ptr<ort_dnnl::Subgraph>> mkl_subgraphs_;
 };
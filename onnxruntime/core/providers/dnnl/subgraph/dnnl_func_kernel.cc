@@ -15,6 +15,8 @@
 #include "core/providers/dnnl/subgraph/dnnl_pool.h"
 #include "core/providers/dnnl/subgraph/dnnl_sum.h"
 #include "core/providers/dnnl/subgraph/dnnl_lrn.h"
+#include "core/providers/dnnl/subgraph/dnnl_matmul.h"
+#include "core/providers/dnnl/subgraph/dnnl_softmax.h"
 
 namespace onnxruntime {
 namespace ort_dnnl {
@@ -170,6 +172,34 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
+      } else if (dnnl_node.name == "MatMul") {
+        std::ostringstream os;
+        os << "MatMul-" << dnnl_node.node_index << "-";
+        std::shared_ptr<DnnlMatMul<T>> kernel;
+        kernel = std::make_shared<DnnlMatMul<T>>(dnnl_node, params.provider, *params.attributes, os.str());
+        for (auto index : dnnl_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
+      } else if (dnnl_node.name == "MatMul-Relu") {
+        std::ostringstream os;
+        os << "MatMul-" << dnnl_node.node_index << "-";
+        std::shared_ptr<DnnlMatMul<T>> kernel;
+        kernel = std::make_shared<DnnlMatMul<T>>(dnnl_node, params.provider, *params.attributes, os.str());
+        kernel->fuse_relu_ = true;
+        for (auto index : dnnl_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
+      } else if (dnnl_node.name == "Softmax") {
+        std::ostringstream os;
+        os << "Softmax-" << dnnl_node.node_index << "-";
+        std::shared_ptr<DnnlSoftmax<T>> kernel;
+        kernel = std::make_shared<DnnlSoftmax<T>>(dnnl_node, params.provider, *params.attributes, os.str());
+        for (auto index : dnnl_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
       } else if (dnnl_node.name == "Sum") {
         std::ostringstream os;
         os << "Sum-" << dnnl_node.node_index << "-";
@@ -216,8 +246,10 @@ class SubgraphPrimitivePool : public PrimitivePool<T> {
                                    OrtKernelContext* context,
                                    const SubgraphParams& params) {
     Ort::CustomOpApi ort{*api};
+    // the primitives depend on the shapes of all the inputs of the subgraph, e.g. the weights of a MatMul in the
+    // middle of the subgraph, not only on the inputs of its first node
     std::string dims_str;
-    for (auto i = 0; i < params.subgraph->dnnl_nodes[0].num_inputs; i++) {
+    for (size_t i = 0, end = ort.KernelContext_GetInputCount(context); i < end; i++) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
       auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
       auto tensor_shape = ort.GetTensorShape(tensor_info);
@@ -0,0 +1,171 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/dnnl/dnnl_fwd.h"
+#include "core/providers/dnnl/dnnl_execution_provider.h"
+#include "core/providers/dnnl/subgraph/dnnl_kernel.h"
+
+namespace onnxruntime {
+namespace ort_dnnl {
+
+// MatMul of a 2D or 3D input with a 2D weight matrix.
+// The weight matrix is shared by all the rows of the input, so the input is treated as one {rows, K} matrix.
+template <typename T>
+class DnnlMatMul : public DnnlKernel {
+ public:
+  DnnlMatMul(const DnnlNode& node,
+             DNNLExecutionProvider* provider,
+             const Provider_NodeAttributes& attributes,
+             const std::string attributes_prefix = "") : DnnlKernel(node, provider) {
+    ORT_UNUSED_PARAMETER(attributes);
+    ORT_UNUSED_PARAMETER(attributes_prefix);
+  }
+
+  void CreatePrimitives(const OrtCustomOpApi* api,
+                        OrtKernelContext* context,
+                        dnnl::engine& cpu_engine,
+                        std::vector<dnnl::primitive>& net,
+                        std::vector<std::unordered_map<int, dnnl::memory>>& net_args) override {
+    Ort::CustomOpApi ort{*api};
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    TensorShape x_shape;
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+      auto tensor_shape = ort.GetTensorShape(tensor_info);
+      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+      x_shape = TensorShape(tensor_shape);
+    } else {
+      x_shape = parents_[0].get()->primitive_dst_shape_;
+    }
+
+    const OrtValue* winput_tensor = ort.KernelContext_GetInput(context, input_index + 1);
+    auto wtensor_info = ort.GetTensorTypeAndShape(winput_tensor);
+    auto wtensor_shape = ort.GetTensorShape(wtensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(wtensor_info);
+    TensorShape w_shape(wtensor_shape);
+
+    const auto& x_dims = x_shape.GetDims();
+    const auto& w_dims = w_shape.GetDims();
+    if ((x_dims.size() != 2 && x_dims.size() != 3) || w_dims.size() != 2 || x_dims.back() != w_dims[0]) {
+      primitive_created_status_ = Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                                         "MatMul shapes are not supported: " + x_shape.ToString() + " and " +
+                                             w_shape.ToString());
+      return;
+    }
+
+    std::vector<int64_t> y_dims(x_dims);
+    y_dims.back() = w_dims[1];
+    primitive_dst_shape_ = TensorShape(y_dims);
+
+    ort_source_format_ = GetSourceFormat(static_cast<int>(y_dims.size()));
+    ort_source_desc_ = dnnl::memory::desc({dnnl::memory::dims(y_dims.begin(), y_dims.end())},
+                                          DnnnType<T>(), ort_source_format_);
+    // the output stays in the ONNX Runtime format, so the subgraph doesn't need a reorder after it
+    primitive_dst_desc_ = ort_source_desc_;
+
+    const int64_t rows = x_shape.SizeToDimension(x_dims.size() - 1);
+    const dnnl::memory::dims src_dims{rows, x_dims.back()};
+    const dnnl::memory::dims weights_dims{w_dims[0], w_dims[1]};
+    const dnnl::memory::dims dst_dims{rows, w_dims[1]};
+    const dnnl::memory::desc src_md(src_dims, DnnnType<T>(), dnnl::memory::format_tag::ab);
+    const dnnl::memory::desc weights_md(weights_dims, DnnnType<T>(), dnnl::memory::format_tag::ab);
+    const dnnl::memory::desc dst_md(dst_dims, DnnnType<T>(), dnnl::memory::format_tag::ab);
+
+    dnnl::primitive_attr attr;
+    if (fuse_relu_) {
+      // Execute RELU as Fuse PostOps
+      const float ops_scale = 1.f;
+      const float ops_alpha = 0.f;  // relu negative slope
+      const float ops_beta = 0.f;
+      dnnl::post_ops ops;
+      ops.append_eltwise(ops_scale, dnnl::algorithm::eltwise_relu, ops_alpha, ops_beta);
+      attr.set_post_ops(ops);
+    }
+
+    matmul_pd_ = onnxruntime::make_unique<dnnl::matmul::primitive_desc>(
+        dnnl::matmul::primitive_desc(dnnl::matmul::desc(src_md, weights_md, dst_md), attr, cpu_engine));
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      src_mem_ = onnxruntime::make_unique<dnnl::memory>(dnnl::memory(src_md, cpu_engine, nullptr));
+    } else {
+      std::shared_ptr<dnnl::memory> parent_mem = parents_[0].get()->primitive_dst_mem_;
+      const auto& parent_desc = parents_[0].get()->primitive_dst_desc_;
+      auto x_desc = dnnl::memory::desc({dnnl::memory::dims(x_dims.begin(), x_dims.end())}, DnnnType<T>(),
+                                       GetSourceFormat(static_cast<int>(x_dims.size())));
+      if (parent_desc != x_desc) {
+        // blocked output of the parent. reorder it to the plain format the matmul reads
+        src_mem_from_ = onnxruntime::make_unique<dnnl::memory>(dnnl::memory(x_desc, cpu_engine));
+        net.push_back(dnnl::reorder(*parent_mem, *src_mem_from_));
+        net_args.push_back({{DNNL_ARG_FROM, *parent_mem},
+                            {DNNL_ARG_TO, *src_mem_from_}});
+        parent_mem = src_mem_from_;
+      }
+
+      // the parent's output is an intermediate buffer of the subgraph, so its address doesn't change
+      src_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(src_md, cpu_engine, parent_mem->get_data_handle()));
+    }
+
+    weights_mem_ = onnxruntime::make_unique<dnnl::memory>(dnnl::memory(weights_md, cpu_engine, nullptr));
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // Last node of sub-graph. The output buffer is set in Bind
+      primitive_dst_mem_ = std::make_shared<dnnl::memory>(dnnl::memory(primitive_dst_desc_, cpu_engine, nullptr));
+    } else {
+      // Intermediate node. Use dnnl kernel internal memory for output and
+      // use this as input to next node.
+      primitive_dst_mem_ = std::make_shared<dnnl::memory>(dnnl::memory(primitive_dst_desc_, cpu_engine));
+    }
+    dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+        dnnl::memory(dst_md, cpu_engine, primitive_dst_mem_->get_data_handle()));
+
+    net.push_back(dnnl::matmul(*matmul_pd_));
+    net_args.push_back({{DNNL_ARG_SRC, *src_mem_},
+                        {DNNL_ARG_WEIGHTS, *weights_mem_},
+                        {DNNL_ARG_DST, *dst_mem_}});
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+
+    ORT_RETURN_IF_ERROR(primitive_created_status_);
+
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      // Sub-graph's first node. Read input from input buffer
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      const T* src_data = ort.GetTensorData<T>(input_tensor);
+      src_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(src_data)));
+    }
+
+    const OrtValue* winput_tensor = ort.KernelContext_GetInput(context, input_index + 1);
+    const T* weights_data = ort.GetTensorData<T>(winput_tensor);
+    weights_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(weights_data)));
+
+    if (mklnode_ptr_->output_index >= 0) {
+      auto& y_dims = primitive_dst_shape_.GetDims();
+      // Allocate memory for output bufffer
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0],
+                                                     static_cast<int>(primitive_dst_shape_.GetDims().size()));
+      T* dst_data = ort.GetTensorMutableData<T>(output);
+      primitive_dst_mem_->set_data_handle(dst_data);
+      dst_mem_->set_data_handle(dst_data);
+    }
+
+    return Status::OK();
+  }
+
+ private:
+  std::shared_ptr<dnnl::memory> src_mem_from_;
+  std::unique_ptr<dnnl::memory> src_mem_;
+  std::unique_ptr<dnnl::memory> weights_mem_;
+  std::unique_ptr<dnnl::memory> dst_mem_;
+
+  std::unique_ptr<dnnl::matmul::primitive_desc> matmul_pd_;
+};
+}  // namespace ort_dnnl
+}  // namespace onnxruntime
@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/dnnl/dnnl_fwd.h"
+#include "core/providers/dnnl/dnnl_execution_provider.h"
+#include "core/providers/dnnl/subgraph/dnnl_kernel.h"
+
+namespace onnxruntime {
+namespace ort_dnnl {
+
+// Softmax over the innermost axis. ONNX Softmax coerces the input to 2D at 'axis', which only matches a softmax
+// over a single axis when 'axis' is the last one, so the execution provider only assigns that case to DNNL.
+template <typename T>
+class DnnlSoftmax : public DnnlKernel {
+ public:
+  DnnlSoftmax(const DnnlNode& node,
+              DNNLExecutionProvider* provider,
+              const Provider_NodeAttributes& attributes,
+              const std::string attributes_prefix = "") : DnnlKernel(node, provider) {
+    ReadAttributes(attributes, attributes_prefix);
+  }
+
+  void CreatePrimitives(const OrtCustomOpApi* api,
+                        OrtKernelContext* context,
+                        dnnl::engine& cpu_engine,
+                        std::vector<dnnl::primitive>& net,
+                        std::vector<std::unordered_map<int, dnnl::memory>>& net_args) override {
+    Ort::CustomOpApi ort{*api};
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    TensorShape x_shape;
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+      auto tensor_shape = ort.GetTensorShape(tensor_info);
+      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+      x_shape = TensorShape(tensor_shape);
+    } else {
+      x_shape = parents_[0].get()->primitive_dst_shape_;
+    }
+
+    const auto rank = static_cast<int64_t>(x_shape.NumDimensions());
+    const int64_t axis = axis_ < 0 ? axis_ + rank : axis_;
+    if (rank == 0 || rank > 5 || axis != rank - 1) {
+      primitive_created_status_ = Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                                         "Softmax is only supported over the last axis. Shape " +
+                                             x_shape.ToString() + ", axis " + std::to_string(axis_));
+      return;
+    }
+
+    primitive_dst_shape_ = TensorShape(x_shape);
+    dnnl::memory::dims src_dims(x_shape.GetDims().begin(), x_shape.GetDims().end());
+    ort_source_format_ = GetSourceFormat(static_cast<int>(rank));
+    ort_source_desc_ = dnnl::memory::desc({src_dims}, DnnnType<T>(), ort_source_format_);
+    source_desc_ = ort_source_desc_;
+
+    fwd_primitive_desc_ = onnxruntime::make_unique<dnnl::softmax_forward::primitive_desc>(
+        dnnl::softmax_forward::primitive_desc(
+            dnnl::softmax_forward::desc(dnnl::prop_kind::forward_inference, ort_source_desc_,
+                                        static_cast<int>(axis)),
+            cpu_engine));
+
+    primitive_src_desc_ = fwd_primitive_desc_.get()->src_desc();
+    primitive_dst_desc_ = fwd_primitive_desc_.get()->dst_desc();
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      src_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(fwd_primitive_desc_->src_desc(), cpu_engine, nullptr));
+    } else if (parents_[0].get()->primitive_dst_desc_ != primitive_src_desc_) {
+      // blocked output of the parent. reorder it to the plain format the softmax reads
+      src_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(fwd_primitive_desc_->src_desc(), cpu_engine));
+      net.push_back(dnnl::reorder(*parents_[0].get()->primitive_dst_mem_, *src_mem_));
+      net_args.push_back({{DNNL_ARG_FROM, *parents_[0].get()->primitive_dst_mem_},
+                          {DNNL_ARG_TO, *src_mem_}});
+    } else {
+      src_mem_ = parents_[0].get()->primitive_dst_mem_;
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // last node of sub-graph. need to allocate memory for output_tensor
+      if (primitive_dst_desc_ != ort_source_desc_) {
+        // reorder neded. Use primitive output as input to reorder and
+        // allocate buffer for reorder output, final output of this subgraph
+        primitive_dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(fwd_primitive_desc_.get()->dst_desc(), cpu_engine));
+      } else {
+        // Last node but re-order not needed. Allocate buffer to output of this node
+        primitive_dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(fwd_primitive_desc_.get()->dst_desc(), cpu_engine, nullptr));
+      }
+    } else {
+      // Intermediate node. Use Dnnl kernel internal memory for output and
+      // use this as input to next node.
+      primitive_dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(fwd_primitive_desc_.get()->dst_desc(), cpu_engine));
+    }
+
+    net.push_back(dnnl::softmax_forward(*fwd_primitive_desc_));
+    net_args.push_back({{DNNL_ARG_SRC, *src_mem_},
+                        {DNNL_ARG_DST, *primitive_dst_mem_}});
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // one of the end nodes. Allocate output buffer memory and
+      // reorder is necessary
+      dnnl::memory::data_type t = DnnnType<T>();
+      InitDstReorderOutput(cpu_engine, t, net, net_args);
+    }
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+
+    ORT_RETURN_IF_ERROR(primitive_created_status_);
+
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      // Sub-graph's first node. Read input from input buffer
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      const T* src_data = ort.GetTensorData<T>(input_tensor);
+      src_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(src_data)));
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      auto& y_dims = primitive_dst_shape_.GetDims();
+      // Allocate memory for output bufffer
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0],
+                                                     static_cast<int>(primitive_dst_shape_.GetDims().size()));
+      T* dst_data = ort.GetTensorMutableData<T>(output);
+
+      if (primitive_dst_desc_ != ort_source_desc_) {
+        reorder_dst_mem_to_->set_data_handle(dst_data);
+      } else {
+        primitive_dst_mem_->set_data_handle(dst_data);
+      }
+    }
+
+    return Status::OK();
+  }
+
+ private:
+  void ReadAttributes(const Provider_NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    auto attr = attributes.find(attributes_prefix + "axis");
+    if (attr != attributes.end() &&
+        attr->second().type() == ::ONNX_NAMESPACE::AttributeProto_AttributeType::AttributeProto_AttributeType_INT) {
+      axis_ = attr->second().i();
+    }
+  }
+
+ private:
+  int64_t axis_ = 1;
+
+  std::shared_ptr<dnnl::memory> src_mem_;
+
+  std::unique_ptr<dnnl::softmax_forward::primitive_desc> fwd_primitive_desc_;
+};
+}  // namespace ort_dnnl
+}  // namespace onnxruntime
@@ -18,6 +18,7 @@
 #include "hip_allocator.h"
 #include "gpu_data_transfer.h"
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 
 #if defined(_MSC_VER)
@@ -106,6 +107,7 @@ MIGraphXExecutionProvider::MIGraphXExecutionProvider(const MIGraphXExecutionProv
     LOGS_DEFAULT(FATAL) << "Device " << info.target_device << " are not supported";
   }
 
+  target_device_ = info.target_device;
   t_ = migraphx::target(info.target_device.c_str());
 
   // Get environment variables
@@ -116,6 +118,9 @@ MIGraphXExecutionProvider::MIGraphXExecutionProvider(const MIGraphXExecutionProv
   if (!fp16_enable_env.empty()) {
     fp16_enable_ = (std::stoi(fp16_enable_env) == 0 ? false : true);
   }
+
+  // directory of the compiled programs saved to disk
+  program_cache_path_ = env_instance.GetEnvironmentVar(migraphx_env_vars::kProgramCachePath);
 }
 
 AllocatorPtr MIGraphXExecutionProvider::GetAllocator(int id, OrtMemType mem_type) const {
@@ -966,6 +971,52 @@ bool get_input_output_names(std::string& onnx_buffer,
   return no_input_shape;
 }
 
+// 64-bit FNV-1a, which gives the same value in every build, unlike std::hash
+static uint64_t HashString(const std::string& str, uint64_t hash = 14695981039346656037ULL) {
+  for (const char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Parses and compiles the program of a subgraph. shape_key describes the input shapes set in options.
+// With a cache path, the compiled program is saved to a file named after the hash of the subgraph, the target,
+// the precision and the input shapes, and loaded from there by the next session that needs it.
+static migraphx::program CompileProgram(const std::string& onnx_string, const migraphx::onnx_options& options,
+                                        const migraphx::target& t, const std::string& target_device,
+                                        bool fp16_enable, const std::string& cache_path,
+                                        const std::string& shape_key) {
+  std::string cache_file;
+  if (!cache_path.empty()) {
+    uint64_t hash = HashString(onnx_string);
+    hash = HashString(target_device + (fp16_enable ? "|fp16|" : "|fp32|") + shape_key, hash);
+    std::ostringstream file_name;
+    file_name << cache_path << "/" << std::hex << hash << ".mxr";
+    cache_file = file_name.str();
+
+    std::ifstream cached(cache_file, std::ios::binary);
+    if (cached.good()) {
+      cached.close();
+      LOGS_DEFAULT(VERBOSE) << "MIGraphX: loading compiled program " << cache_file;
+      return migraphx::load(cache_file.c_str());
+    }
+  }
+
+  migraphx::program prog = migraphx::parse_onnx_buffer(onnx_string, options);
+  if (fp16_enable) {
+    migraphx::quantize_fp16(prog);
+  }
+  prog.compile(t);
+
+  if (!cache_file.empty()) {
+    LOGS_DEFAULT(VERBOSE) << "MIGraphX: saving compiled program " << cache_file;
+    migraphx::save(prog, cache_file.c_str());
+  }
+
+  return prog;
+}
+
 Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                                           std::vector<NodeComputeInfo>& node_compute_funcs) {
   migraphx::onnx_options options;
@@ -993,12 +1044,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
     migraphx::program prog;
 
     if (!no_input_shape) {
-      prog = migraphx::parse_onnx_buffer(onnx_string_buffer, options);
-      if (fp16_enable_) {
-        migraphx::quantize_fp16(prog);
-      }
-
-      prog.compile(t_);
+      prog = CompileProgram(onnx_string_buffer, options, t_, target_device_, fp16_enable_, program_cache_path_, "");
       auto prog_output_shapes = prog.get_output_shapes();
       for (std::size_t i = 0; i < output_names.size(); ++i) {
         auto out_len = prog_output_shapes[i].lengths();
@@ -1017,7 +1063,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
       std::unique_ptr<MIGraphXFuncState> p = onnxruntime::make_unique<MIGraphXFuncState>();
       *p = {context->allocate_func, context->release_func, context->allocator_handle, map_progs_[context->node_name],
             map_onnx_string_[context->node_name], options, t_, map_input_index_[context->node_name], &mgx_mu_,
-            map_no_input_shape_[context->node_name], fp16_enable_};
+            map_no_input_shape_[context->node_name], fp16_enable_, target_device_, program_cache_path_};
       *state = p.release();
       return 0;
     };
@@ -1038,6 +1084,15 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
       bool& no_input_shape = mgx_state->no_input_shape;
       bool fp16_enable = mgx_state->fp16_enable;
 
+      // the input shapes, in the order of the inputs of the fused node
+      std::vector<std::vector<int64_t>> input_shapes(map_input_name_index.size());
+      for (auto& it : map_input_name_index) {
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, it.second);
+        auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+        input_shapes[it.second] = ort.GetTensorShape(tensor_info);
+        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+      }
+
       // mean no program at all, so need to get the input shape info
       // from input data
       bool input_shape_match = true;
@@ -1046,9 +1101,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
         for (auto& it : map_input_name_index) {
           auto& name = it.first;
           auto& index = it.second;
-          const OrtValue* input_tensor = ort.KernelContext_GetInput(context, index);
-          auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-          const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+          const auto& tensor_shape = input_shapes[index];
           std::vector<std::size_t> ort_lens(tensor_shape.begin(), tensor_shape.end());
           cmp_options.set_input_parameter_shape(name, ort_lens);
           input_shape_match = false;
@@ -1062,9 +1115,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
         if (param_shapes.size() > 0) {
           for (auto&& name : param_shapes.names()) {
             if (map_input_name_index.count(name) > 0) {
-              const OrtValue* input_tensor = ort.KernelContext_GetInput(context, map_input_name_index[name]);
-              auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-              const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+              const auto& tensor_shape = input_shapes[map_input_name_index[name]];
               std::vector<std::size_t> ort_lens(tensor_shape.begin(), tensor_shape.end());
 
               auto mgx_s = param_shapes[name];
@@ -1084,15 +1135,26 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
         }
       }
 
-      // input shapes are different, needs to re-parse onnx and
-      // re-compile the program
+      // input shapes are different, use the program compiled for them before, or
+      // re-parse onnx and re-compile the program
       if (!input_shape_match) {
-        prog = migraphx::parse_onnx_buffer(onnx_string, cmp_options);
-        if (fp16_enable) {
-          migraphx::quantize_fp16(prog);
+        std::ostringstream shape_key;
+        for (const auto& shape : input_shapes) {
+          for (const auto dim : shape) {
+            shape_key << dim << ",";
+          }
+          shape_key << ";";
         }
 
-        prog.compile(t);
+        std::lock_guard<OrtMutex> lock(*(mgx_state->mgx_mu_ptr));
+        auto found = mgx_state->shape_programs.find(shape_key.str());
+        if (found != mgx_state->shape_programs.end()) {
+          prog = found->second;
+        } else {
+          prog = CompileProgram(onnx_string, cmp_options, t, mgx_state->target_device, fp16_enable,
+                                mgx_state->program_cache_path, shape_key.str());
+          mgx_state->shape_programs.emplace(shape_key.str(), prog);
+        }
         mgx_state->prog = prog;
         param_shapes = prog.get_parameter_shapes();
         no_input_shape = false;
@@ -12,6 +12,7 @@ namespace onnxruntime {
 
 namespace migraphx_env_vars {
 static const std::string kFP16Enable = "ORT_MIGRAPHX_FP16_ENABLE";
+static const std::string kProgramCachePath = "ORT_MIGRAPHX_PROGRAM_CACHE_PATH";
 };
 
 // Information needed to construct amdmigraphx execution providers.
@@ -33,6 +34,10 @@ struct MIGraphXFuncState {
   OrtMutex* mgx_mu_ptr = nullptr;
   bool no_input_shape = false;
   bool fp16_enable = false;
+  std::string target_device;
+  std::string program_cache_path;
+  // programs compiled for the input shapes seen so far, keyed by the shapes
+  std::unordered_map<std::string, migraphx::program> shape_programs;
 };
 
 // Logical device representation.
@@ -55,7 +60,9 @@ class MIGraphXExecutionProvider : public IExecutionProvider {
 private:
   bool fp16_enable_ = false;
   int device_id_;
-  migraphx::target t_; 
+  std::string target_device_;
+  std::string program_cache_path_;
+  migraphx::target t_;
   OrtMutex mgx_mu_;
 
   std::unordered_map<std::string, migraphx::program> map_progs_;
@@ -328,13 +328,17 @@ Status ModelBuilder::RegisterModelInputs() {
         continue;
     }
 
-    const auto* shape_proto = node_arg->Shape();
-    ORT_RETURN_IF_NOT(shape_proto != nullptr, "shape_proto cannot be null for input: ", input_name);
     Shaper::Shape shape;
-
-    for (const auto& dim : shape_proto->dim()) {
-      // NNAPI uses 0 for dynamic dimension, which is the default value for dim.dim_value()
-      shape.push_back(SafeInt<uint32_t>(dim.dim_value()));
+    const auto input_shape = input_shapes_.find(input_name);
+    if (input_shape != input_shapes_.end()) {
+      shape = input_shape->second;
+    } else {
+      const auto* shape_proto = node_arg->Shape();
+      ORT_RETURN_IF_NOT(shape_proto != nullptr, "shape_proto cannot be null for input: ", input_name);
+      for (const auto& dim : shape_proto->dim()) {
+        // NNAPI uses 0 for dynamic dimension, which is the default value for dim.dim_value()
+        shape.push_back(SafeInt<uint32_t>(dim.dim_value()));
+      }
     }
 
     ORT_RETURN_IF_NOT(GetAndroidSdkVer() >= 29 || !shape.empty(),
@@ -564,6 +568,16 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
           nnapi_model_->compilation_, static_cast<int32_t>(exe_pref_)),
       "on setPreference");
 
+  // compilation caching is only available on API 29+
+  if (!cache_dir_.empty() && GetAndroidSdkVer() >= 29) {
+    ORT_RETURN_IF_NOT(cache_token_.size() == ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN,
+                      "The NNAPI cache token must have ", ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN, " bytes");
+    RETURN_STATUS_ON_ERROR_WITH_NOTE(
+        nnapi_->ANeuralNetworksCompilation_setCaching(
+            nnapi_model_->compilation_, cache_dir_.c_str(), cache_token_.data()),
+        "on setCaching");
+  }
+
   RETURN_STATUS_ON_ERROR_WITH_NOTE(
       nnapi_->ANeuralNetworksCompilation_finish(nnapi_model_->compilation_),
       "on compilation finish");
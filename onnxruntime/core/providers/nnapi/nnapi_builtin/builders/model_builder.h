@@ -76,10 +76,22 @@ class ModelBuilder {
   void SetUseFp16(bool use_fp16) { use_fp16_ = use_fp16; }
 
   // Set NNAPI execution preference
-  // Default preference is PREFER_SUSTAINED_SPEED
+  // Default preference is PREFER_FAST_SINGLE_ANSWER
   void ExecutePreference(
       android::nn::wrapper::ExecutePreference pref) { exe_pref_ = pref; }
 
+  // Use the compilation cache of the NNAPI drivers in cache_dir, only available on API 29+
+  // The token identifies the model and its compilation options and has
+  // ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN bytes
+  void SetCaching(const std::string& cache_dir, const std::vector<uint8_t>& token) {
+    cache_dir_ = cache_dir;
+    cache_token_ = token;
+  }
+
+  // Use these shapes of the graph inputs instead of the shapes of the graph
+  // Allows compiling a model for the actual input shapes of a graph with dynamic shapes
+  void SetInputShapes(const std::unordered_map<std::string, Shape>& input_shapes) { input_shapes_ = input_shapes; }
+
   // Accessors for members
   Shaper& GetShaper() { return shaper_; }
 
@@ -121,6 +133,11 @@ class ModelBuilder {
   android::nn::wrapper::ExecutePreference exe_pref_{
       android::nn::wrapper::ExecutePreference::PREFER_FAST_SINGLE_ANSWER};
 
+  std::string cache_dir_;
+  std::vector<uint8_t> cache_token_;
+
+  std::unordered_map<std::string, Shape> input_shapes_;
+
   Shaper shaper_;
 
   std::unordered_map<std::string, uint32_t> operand_indices_;
@@ -13,8 +13,10 @@ namespace onnxruntime {
 
 constexpr const char* NNAPI = "Nnapi";
 
-NnapiExecutionProvider::NnapiExecutionProvider()
-    : IExecutionProvider{onnxruntime::kNnapiExecutionProvider} {
+NnapiExecutionProvider::NnapiExecutionProvider(uint32_t nnapi_flags, const std::string& cache_dir)
+    : IExecutionProvider{onnxruntime::kNnapiExecutionProvider},
+      nnapi_flags_(nnapi_flags),
+      cache_dir_(cache_dir) {
   AllocatorCreationInfo device_info(
       [](int) {
         return onnxruntime::make_unique<CPUAllocator>(OrtMemoryInfo(NNAPI, OrtAllocatorType::OrtDeviceAllocator));
@@ -210,6 +212,95 @@ static Status GetOutputBuffer(Ort::CustomOpApi& ort,
   return Status::OK();
 }
 
+// The number of models compiled for the actual input shapes of a fused node, see NNAPI_FLAG_COMPILE_PER_INPUT_SHAPES
+constexpr size_t kMaxInputShapeModels = 8;
+
+// FNV-1a
+static uint64_t Hash(const std::string& data, uint64_t seed) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < 8; ++i) {
+    hash = (hash ^ ((seed >> (8 * i)) & 0xff)) * 1099511628211ULL;
+  }
+  for (const char c : data) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+// The token of the NNAPI compilation cache, made of 64-bit hashes of the key
+static std::vector<uint8_t> GetCacheToken(const std::string& key) {
+  std::vector<uint8_t> token;
+  token.reserve(ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN);
+  for (uint64_t seed = 0; token.size() < ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN; ++seed) {
+    const uint64_t hash = Hash(key, seed);
+    for (int i = 0; i < 8 && token.size() < ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN; ++i) {
+      token.push_back(static_cast<uint8_t>(hash >> (8 * i)));
+    }
+  }
+  return token;
+}
+
+Status NnapiExecutionProvider::CompileModel(const FusedNodeModels& models,
+                                            const std::vector<nnapi::Shaper::Shape>& input_shapes,
+                                            std::unique_ptr<nnapi::Model>& model) const {
+  using namespace android::nn::wrapper;
+  onnxruntime::GraphViewer graph_viewer(*models.graph_body);
+  nnapi::ModelBuilder builder(graph_viewer);
+  builder.SetUseNCHW(false);
+  builder.SetUseFp16(false);
+  if (nnapi_flags_ & NNAPI_FLAG_PREFER_SUSTAINED_SPEED) {
+    builder.ExecutePreference(ExecutePreference::PREFER_SUSTAINED_SPEED);
+  } else if (nnapi_flags_ & NNAPI_FLAG_PREFER_LOW_POWER) {
+    builder.ExecutePreference(ExecutePreference::PREFER_LOW_POWER);
+  }
+
+  std::string cache_key = models.cache_key;
+  if (!input_shapes.empty()) {
+    const auto& input_names = models.model->GetInputs();
+    std::unordered_map<std::string, nnapi::Shaper::Shape> input_shape_map;
+    for (size_t i = 0; i < input_names.size(); i++) {
+      input_shape_map[input_names[i]] = input_shapes[i];
+      cache_key += "|" + nnapi::Shape2String(input_shapes[i]);
+    }
+    builder.SetInputShapes(input_shape_map);
+  }
+
+  if (!cache_dir_.empty()) {
+    builder.SetCaching(cache_dir_, GetCacheToken(cache_key));
+  }
+
+  ORT_RETURN_IF_ERROR(builder.Compile(model));
+  model->SetInputMap(std::unordered_map<std::string, size_t>(models.input_map));
+  model->SetOutputMap(std::unordered_map<std::string, size_t>(models.output_map));
+  return Status::OK();
+}
+
+nnapi::Model* NnapiExecutionProvider::GetModel(FusedNodeModels& models,
+                                               const std::vector<nnapi::Shaper::Shape>& input_shapes) const {
+  if (!(nnapi_flags_ & NNAPI_FLAG_COMPILE_PER_INPUT_SHAPES) || !models.has_dynamic_input_shapes) {
+    return models.model.get();
+  }
+
+  std::lock_guard<OrtMutex> lock(models.input_shape_models_mutex);
+  auto it = models.input_shape_models.find(input_shapes);
+  if (it == models.input_shape_models.end()) {
+    if (models.input_shape_models.size() >= kMaxInputShapeModels) {
+      return models.model.get();
+    }
+
+    std::unique_ptr<nnapi::Model> model;
+    const auto status = CompileModel(models, input_shapes, model);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to compile the NNAPI model for the input shapes of this run, "
+                            << "the model for the dynamic shapes is used instead: " << status.ErrorMessage();
+      model.reset();
+    }
+    it = models.input_shape_models.emplace(input_shapes, std::move(model)).first;
+  }
+
+  return it->second ? it->second.get() : models.model.get();
+}
+
 common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                                                std::vector<NodeComputeInfo>& node_compute_funcs) {
   using namespace android::nn::wrapper;
@@ -220,60 +311,82 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
       return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Function body is empty");
     }
 
-    const Graph& graph_body = func_body->Body();
+    auto models = onnxruntime::make_unique<FusedNodeModels>();
+    models->graph_body = &func_body->Body();
+
+    // Build map from input name to its index in input definitions
     {
-      onnxruntime::GraphViewer graph_viewer(graph_body);
-      nnapi::ModelBuilder builder(graph_viewer);
-      builder.SetUseNCHW(false);
-      builder.SetUseFp16(false);
-      std::unique_ptr<nnapi::Model> nnapi_model;
-      ORT_RETURN_IF_ERROR(builder.Compile(nnapi_model));
-
-      // Build map from input name to its index in input definitions
-      {
-        std::unordered_map<std::string, size_t> input_map;
-        const auto& input_defs = fused_node->InputDefs();
-        input_map.reserve(input_defs.size());
-        for (size_t i = 0, end = input_defs.size(); i < end; ++i) {
-          input_map[input_defs[i]->Name()] = i;
-        }
-        nnapi_model->SetInputMap(std::move(input_map));
+      const auto& input_defs = fused_node->InputDefs();
+      models->input_map.reserve(input_defs.size());
+      for (size_t i = 0, end = input_defs.size(); i < end; ++i) {
+        models->input_map[input_defs[i]->Name()] = i;
       }
+    }
 
-      // Build map from output name to its index in output definitions
-      {
-        std::unordered_map<std::string, size_t> output_map;
-        const auto& output_defs = fused_node->OutputDefs();
-        output_map.reserve(output_defs.size());
-        for (size_t i = 0, end = output_defs.size(); i < end; ++i) {
-          output_map[output_defs[i]->Name()] = i;
-        }
-        nnapi_model->SetOutputMap(std::move(output_map));
+    // Build map from output name to its index in output definitions
+    {
+      const auto& output_defs = fused_node->OutputDefs();
+      models->output_map.reserve(output_defs.size());
+      for (size_t i = 0, end = output_defs.size(); i < end; ++i) {
+        models->output_map[output_defs[i]->Name()] = i;
       }
+    }
 
-      nnapi_models_.emplace(fused_node->Name(), std::move(nnapi_model));
+    if (!cache_dir_.empty()) {
+      // the graph with its initializers, and the options the compilation depends on
+      std::string graph_bytes;
+      models->graph_body->ToGraphProto().SerializeToString(&graph_bytes);
+      models->cache_key = std::to_string(Hash(graph_bytes, 0)) + "_" + std::to_string(Hash(graph_bytes, 1)) +
+                          "_" + std::to_string(nnapi_flags_);
     }
 
+    ORT_RETURN_IF_ERROR(CompileModel(*models, {}, models->model));
+    for (const auto& input_name : models->model->GetInputs()) {
+      const auto& dimensions = models->model->GetInputType(input_name).dimensions;
+      models->has_dynamic_input_shapes |= std::find(dimensions.begin(), dimensions.end(), 0) != dimensions.end();
+    }
+
+    fused_node_models_.emplace(fused_node->Name(), std::move(models));
+
     NodeComputeInfo compute_info;
     compute_info.create_state_func = [&](ComputeContext* context, FunctionState* state) {
-      *state = nnapi_models_[context->node_name].get();
+      *state = fused_node_models_[context->node_name].get();
       return 0;
     };
 
     compute_info.release_state_func = [](FunctionState state) {
-      // the `state` is a nnapi::model managed by unique_ptr
+      // the `state` is a FusedNodeModels managed by unique_ptr
       ORT_UNUSED_PARAMETER(state);
     };
 
-    compute_info.compute_func = [](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
+    compute_info.compute_func = [this](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
       Ort::CustomOpApi ort{*api};
-      nnapi::Model* model = reinterpret_cast<nnapi::Model*>(state);
+      auto& models = *reinterpret_cast<FusedNodeModels*>(state);
       const size_t num_inputs = ort.KernelContext_GetInputCount(context);
       const size_t num_outputs = ort.KernelContext_GetOutputCount(context);
-      const auto& model_inputs = model->GetInputs();
-      const auto& model_outputs = model->GetOutputs();
+      const auto& model_inputs = models.model->GetInputs();
 
       ORT_RETURN_IF_NOT(model_inputs.size() <= num_inputs, "Inconsistent input sizes");
+
+      std::vector<const OrtValue*> input_tensors;
+      std::vector<nnapi::Shaper::Shape> input_shapes;
+      input_tensors.reserve(model_inputs.size());
+      input_shapes.reserve(model_inputs.size());
+      for (const auto& input_name : model_inputs) {
+        auto input_idx = models.model->GetMappedInputIdx(input_name);
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_idx);
+        auto* tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+        std::vector<uint32_t> dimensions;
+        for (const auto& dim : ort.GetTensorShape(tensor_info))
+          dimensions.push_back(static_cast<uint32_t>(dim));
+        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+
+        input_tensors.push_back(input_tensor);
+        input_shapes.push_back(std::move(dimensions));
+      }
+
+      nnapi::Model* model = GetModel(models, input_shapes);
+      const auto& model_outputs = model->GetOutputs();
       ORT_RETURN_IF_NOT(model_outputs.size() == num_outputs, "Inconsistent output sizes");
 
       std::vector<nnapi::Execution::InputBuffer> inputs;
@@ -281,13 +394,7 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
       for (size_t i = 0; i < model_inputs.size(); i++) {
         const auto& input_name = model_inputs[i];
         const auto& model_input_type = model->GetInputType(input_name);
-
-        auto input_idx = model->GetMappedInputIdx(input_name);
-        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_idx);
-        auto* tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-        std::vector<uint32_t> dimensions;
-        for (const auto& dim : ort.GetTensorShape(tensor_info))
-          dimensions.push_back(static_cast<uint32_t>(dim));
+        const auto& dimensions = input_shapes[i];
 
         // NNAPI has strict input type requirements which separates tensor inputs and scalar inputs
         // For ONNX the we do not have clear line between scalar inputs and tensor inputs
@@ -316,10 +423,8 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
                                  "dimensions, or model input dimension has 0 (dynamic)");
         }
 
-        const void* inputBuffer = ort.GetTensorData<void>(input_tensor);
+        const void* inputBuffer = ort.GetTensorData<void>(input_tensors[i]);
         inputs.push_back({input_name, inputBuffer, std::move(input_type)});
-
-        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
       }
 
       // From this point we will need to take the exclusive lock on the model until the Predict is
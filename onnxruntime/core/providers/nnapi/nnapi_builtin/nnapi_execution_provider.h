@@ -3,13 +3,18 @@
 
 #pragma once
 
+#include <map>
+
 #include "core/framework/execution_provider.h"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/nnapi/nnapi_builtin/model.h"
+#include "core/providers/nnapi/nnapi_provider_factory.h"
 
 namespace onnxruntime {
 class NnapiExecutionProvider : public IExecutionProvider {
  public:
-  NnapiExecutionProvider();
+  explicit NnapiExecutionProvider(uint32_t nnapi_flags = NNAPI_FLAG_USE_NONE,
+                                  const std::string& cache_dir = std::string());
   virtual ~NnapiExecutionProvider();
 
   std::vector<std::unique_ptr<ComputeCapability>>
@@ -19,6 +24,35 @@ class NnapiExecutionProvider : public IExecutionProvider {
                          std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
  private:
-  std::unordered_map<std::string, std::unique_ptr<onnxruntime::nnapi::Model>> nnapi_models_;
+  // The NNAPI models of a fused node
+  // The model for the shapes of the graph is compiled in Compile. With NNAPI_FLAG_COMPILE_PER_INPUT_SHAPES and
+  // dynamic input shapes, a model for the actual input shapes is compiled the first time the node is run with them
+  struct FusedNodeModels {
+    const Graph* graph_body{nullptr};
+    std::unordered_map<std::string, size_t> input_map;
+    std::unordered_map<std::string, size_t> output_map;
+
+    // Identifies the graph and the compilation options, the cache tokens of the models are derived from it
+    std::string cache_key;
+
+    std::unique_ptr<nnapi::Model> model;
+    bool has_dynamic_input_shapes{false};
+
+    // The models for the actual input shapes, in the order of the inputs of the model
+    // nullptr if the compilation failed, the node then runs with the model for the shapes of the graph
+    std::map<std::vector<nnapi::Shaper::Shape>, std::unique_ptr<nnapi::Model>> input_shape_models;
+    OrtMutex input_shape_models_mutex;
+  };
+
+  // Compiles the graph of the fused node, for the given shapes of the inputs of models.model if they're not empty
+  Status CompileModel(const FusedNodeModels& models, const std::vector<nnapi::Shaper::Shape>& input_shapes,
+                      std::unique_ptr<nnapi::Model>& model) const ORT_MUST_USE_RESULT;
+
+  // Gets the model to run the fused node with the input shapes
+  nnapi::Model* GetModel(FusedNodeModels& models, const std::vector<nnapi::Shaper::Shape>& input_shapes) const;
+
+  const uint32_t nnapi_flags_;
+  const std::string cache_dir_;
+  std::unordered_map<std::string, std::unique_ptr<FusedNodeModels>> fused_node_models_;
 };
 }  // namespace onnxruntime
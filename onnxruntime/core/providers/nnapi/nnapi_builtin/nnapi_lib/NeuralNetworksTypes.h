@@ -162,6 +162,13 @@ enum {
   ANEURALNETWORKS_PREFER_SUSTAINED_SPEED = 2,
 };
 
+/**
+ * The length of the token passed to ANeuralNetworksCompilation_setCaching.
+ */
+enum {
+  ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN = 32,
+};
+
 /**
  * Result codes.
  */
@@ -9,18 +9,28 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct NnapiProviderFactory : IExecutionProviderFactory {
-  NnapiProviderFactory() {}
+  NnapiProviderFactory(uint32_t nnapi_flags, const std::string& cache_dir)
+      : nnapi_flags_(nnapi_flags), cache_dir_(cache_dir) {}
   ~NnapiProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
+
+ private:
+  const uint32_t nnapi_flags_;
+  const std::string cache_dir_;
 };
 
 std::unique_ptr<IExecutionProvider> NnapiProviderFactory::CreateProvider() {
-  return onnxruntime::make_unique<NnapiExecutionProvider>();
+  return onnxruntime::make_unique<NnapiExecutionProvider>(nnapi_flags_, cache_dir_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi(uint32_t nnapi_flags,
+                                                                                const std::string& cache_dir) {
+  return std::make_shared<onnxruntime::NnapiProviderFactory>(nnapi_flags, cache_dir);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi() {
-  return std::make_shared<onnxruntime::NnapiProviderFactory>();
+  return CreateExecutionProviderFactory_Nnapi(NNAPI_FLAG_USE_NONE, std::string());
 }
 }  // namespace onnxruntime
 
@@ -28,3 +38,10 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSess
   options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Nnapi());
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_NnapiWithOptions, _In_ OrtSessionOptions* options,
+                    uint32_t nnapi_flags, _In_opt_ const char* cache_dir) {
+  options->provider_factories.push_back(
+      onnxruntime::CreateExecutionProviderFactory_Nnapi(nnapi_flags, cache_dir != nullptr ? cache_dir : ""));
+  return nullptr;
+}
@@ -20,6 +20,9 @@
 #undef _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
 #include <atomic>
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 namespace fs = std::experimental::filesystem;
 
 namespace onnxruntime {
@@ -67,6 +70,11 @@ static bool GetCacheSoFilePath(std::string& so_path) {
   return false;
 }
 
+// Every line of a manifest is "<func_name>\t<target_name>".
+// JIT appends to the manifest of the cache directory, which create_shared renames to <dll_name>.manifest.
+constexpr static const char* kNupharCacheManifest = "manifest.txt";
+constexpr static const char* kNupharCacheManifestExtension = ".manifest";
+
 static void* GetFuncFromLibrary(const std::string& so_path, const std::string& func_name, bool throw_if_not_found = true) {
   void* so_handle;
   ORT_ENFORCE(Env::Default().LoadDynamicLibrary(so_path, &so_handle).IsOK());
@@ -173,14 +181,25 @@ CacheStatus LoadTVMPackedFuncFromCache(const std::string& func_name, tvm::runtim
     }
   }
 
-  if (!VerifyCacheVersion(so_path)) {
-    return CacheStatus::Mismatch;
+  // the dll is loaded and its version checked once, instead of once per function
+  static std::mutex loaded_modules_mutex;
+  static std::unordered_map<std::string, tvm::runtime::Module> loaded_modules;
+  tvm::runtime::Module module;
+  {
+    std::lock_guard<std::mutex> lock(loaded_modules_mutex);
+    auto iter = loaded_modules.find(so_path);
+    if (iter == loaded_modules.end()) {
+      if (!VerifyCacheVersion(so_path)) {
+        return CacheStatus::Mismatch;
+      }
+      iter = loaded_modules.emplace(so_path, tvm::runtime::Module::LoadFromFile(so_path)).first;
+    }
+    module = iter->second;
   }
 
   if (!VerifyTVMModuleChecksum(so_path))
     return CacheStatus::Mismatch;
 
-  tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(so_path);
   func = module.GetFunction(func_name);
   if (func == nullptr) {
     LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cannot find " << func_name << " in cache, using JIT...";
@@ -189,24 +208,154 @@ CacheStatus LoadTVMPackedFuncFromCache(const std::string& func_name, tvm::runtim
   return CacheStatus::Found;
 }
 
-void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module) {
+void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module, const std::string& target_name) {
   fs::path path;
 
   static std::mutex save_cache_mutex;
   std::lock_guard<std::mutex> lock(save_cache_mutex);
   if (GetOrCreateTVMModuleCacheDirectory(path, /*create*/ true)) {
+    fs::path manifest_path = path;
+    manifest_path.append(kNupharCacheManifest);
     path.append(filename + ".o");
     if (fs::exists(path)) {
       //LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Object file " << path << " already exists, skip saving...";
       return;
     }
     module->SaveToFile(path.string(), "o");
+
+    std::ofstream manifest(manifest_path.string(), std::ios::app);
+    manifest << filename << "\t" << target_name << std::endl;
+  }
+}
+
+bool GetCachedCodeGenTargets(std::unordered_set<std::string>& targets) {
+  std::string so_path;
+  if (!GetCacheSoFilePath(so_path))
+    return false;
+
+  std::ifstream manifest(so_path + kNupharCacheManifestExtension);
+  if (!manifest.good())
+    return false;
+
+  std::string line;
+  while (std::getline(manifest, line)) {
+    auto pos = line.find('\t');
+    if (pos != std::string::npos) {
+      targets.insert(line.substr(pos + 1));
+    }
+  }
+  return !targets.empty();
+}
+
+// 64-bit FNV-1a, which, unlike std::hash, gives the same value in every build
+static void HashBytes(uint64_t& hash, const void* data, size_t size) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
   }
 }
 
+static void HashString(uint64_t& hash, const std::string& str) {
+  HashBytes(hash, str.data(), str.size());
+  // terminate the string, so that "ab" + "c" and "a" + "bc" differ
+  HashBytes(hash, "", 1);
+}
+
+static void HashInt(uint64_t& hash, int64_t value) {
+  HashBytes(hash, &value, sizeof(value));
+}
+
+// Hashes everything the generated code of the subgraph depends on: the ops and their attributes, how they are
+// connected, the types and shapes of the values, the initializers and the codegen settings.
+// The names of the values don't change the code, so values are numbered in the order they are first seen instead.
+// That lets the same subgraph in different models share a cached function.
+static std::string GetSubgraphHash(const nuphar::NupharSubgraphUnit& subgraph) {
+  uint64_t hash = 14695981039346656037ULL;
+
+  std::unordered_map<std::string, int64_t> value_ids;
+  auto hash_value = [&](const NodeArg* def) {
+    auto iter = value_ids.emplace(def->Name(), static_cast<int64_t>(value_ids.size())).first;
+    HashInt(hash, iter->second);
+    const auto* type = def->TypeAsProto();
+    HashString(hash, type != nullptr ? type->SerializeAsString() : std::string());
+  };
+
+  for (const auto* def : subgraph.inputs) {
+    hash_value(def);
+  }
+
+  for (const Node* node : subgraph.nodes) {
+    HashString(hash, node->Domain());
+    HashString(hash, node->OpType());
+    HashInt(hash, node->SinceVersion());
+
+    // NodeAttributes is unordered, so hash the attributes sorted by name
+    const auto& attributes = node->GetAttributes();
+    std::map<std::string, const ONNX_NAMESPACE::AttributeProto*> sorted_attributes;
+    for (const auto& attr : attributes) {
+      sorted_attributes.emplace(attr.first, &attr.second);
+    }
+    for (const auto& attr : sorted_attributes) {
+      HashString(hash, attr.second->SerializeAsString());
+    }
+
+    HashInt(hash, static_cast<int64_t>(node->InputDefs().size()));
+    for (const auto* def : node->InputDefs()) {
+      hash_value(def);
+    }
+    HashInt(hash, static_cast<int64_t>(node->ImplicitInputDefs().size()));
+    for (const auto* def : node->ImplicitInputDefs()) {
+      hash_value(def);
+    }
+    HashInt(hash, static_cast<int64_t>(node->OutputDefs().size()));
+    for (const auto* def : node->OutputDefs()) {
+      hash_value(def);
+    }
+  }
+
+  HashInt(hash, static_cast<int64_t>(subgraph.outputs.size()));
+  for (const auto* def : subgraph.outputs) {
+    hash_value(def);
+  }
+
+  // initializers may be folded into the generated code
+  for (const auto& initializer : subgraph.initializers) {
+    auto iter = value_ids.find(initializer.first);
+    HashInt(hash, iter != value_ids.end() ? iter->second : -1);
+    const Tensor* tensor = initializer.second;
+    if (tensor != nullptr) {
+      HashString(hash, DataTypeImpl::ToString(tensor->DataType()));
+      for (auto dim : tensor->Shape().GetDims()) {
+        HashInt(hash, dim);
+      }
+      HashBytes(hash, tensor->DataRaw(), tensor->SizeInBytes());
+    }
+  }
+
+  for (auto attr : subgraph.input_attrs) {
+    HashInt(hash, static_cast<int64_t>(attr));
+  }
+  for (auto attr : subgraph.output_attrs) {
+    HashInt(hash, static_cast<int64_t>(attr));
+  }
+
+  const codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  for (const char* option : {kNupharMatmulExec, kNupharIMatMulForceMkl, kNupharForceNoTensorize,
+                             kNupharTensorize_IGEMM_Tile_M, kNupharTensorize_IGEMM_Tile_N,
+                             kNupharTensorize_IGEMM_Tile_K, kNupharTensorize_IGEMM_Permute,
+                             kNupharTensorize_IGEMM_Split_Last_Tile, kNupharFastMath, kNupharFastActivation}) {
+    HashString(hash, settings.HasOption(option) ? settings.GetOptionValue(option) : std::string());
+  }
+
+  std::ostringstream hash_str;
+  hash_str << std::hex << hash;
+  return hash_str.str();
+}
+
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads) {
   // in C, a function does not allow its name starting with a digit.
-  return NormalizeCppName("_" + subgraph.UniqueId() + "_" + codegen_target.GetTargetName() + "_p" + std::to_string(parallel_min_workloads));
+  return NormalizeCppName("_" + GetSubgraphHash(subgraph) + "_" + codegen_target.GetTargetName() + "_p" + std::to_string(parallel_min_workloads));
 }
 
 bool TryCreateConstantScalar(
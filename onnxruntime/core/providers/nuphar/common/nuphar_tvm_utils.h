@@ -4,6 +4,7 @@
 #pragma once
 #include <tvm/tvm.h>
 #include <string>
+#include <unordered_set>
 
 #include "core/graph/graph.h"
 
@@ -28,8 +29,16 @@ enum class CacheStatus {
 };
 
 CacheStatus LoadTVMPackedFuncFromCache(const std::string& func_name, tvm::runtime::PackedFunc& func);
-void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module);
+// target_name is recorded in the manifest of the cache, so a dll built from the objects of several targets
+// can be matched against the host CPU at runtime.
+void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module, const std::string& target_name);
 
+// Returns the codegen targets the functions in the cached dll were compiled for,
+// or false if there's no cached dll or manifest.
+bool GetCachedCodeGenTargets(std::unordered_set<std::string>& targets);
+
+// The name is derived from the content of the subgraph, instead of its position in the model,
+// so the same subgraph maps to the same cached function in any model and any session.
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads);
 
 bool TryCreateConstantScalar(tvm::Expr& scalar, const Tensor* tensor);
@@ -65,7 +65,8 @@ static tvm::runtime::PackedFunc LowerLayoutFunc(const tvm_codegen::WeightLayout*
     auto module = tvm::build(lowered, tvm::target::llvm(), tvm::Target(), config);
     tvm_codegen::DumpTVMModuleToFile(func_name, module);
     if (cache_status == nuphar::CacheStatus::Missing) {
-      nuphar::SaveTVMModuleToCache(func_name, module);
+      // weight layouts are built for the generic llvm target, so they don't belong to any of the codegen targets
+      nuphar::SaveTVMModuleToCache(func_name, module, "llvm");
     }
     cached_func = module.GetFunction(func_name);
   }
@@ -182,7 +182,7 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
     tvm::runtime::Module module = tvm::build(lowered, tvm_target, tvm_host_target, config);
     tvm_codegen::DumpTVMModuleToFile(func_name, module);
     if (cache_status == nuphar::CacheStatus::Missing) {
-      nuphar::SaveTVMModuleToCache(func_name, module);
+      nuphar::SaveTVMModuleToCache(func_name, module, context_.GetCodeGenHandle()->codegen_target->GetTargetName());
     }
     cached_func = module.GetFunction(func_name);
   }
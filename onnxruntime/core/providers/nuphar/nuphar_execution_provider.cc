@@ -10,6 +10,7 @@
 #include "core/providers/nuphar/common/analysis/shape_expr.h"  // TODO: remove this shape_expr after shape_infernece refinement
 #include "core/providers/nuphar/common/analysis/subgraph_partition_stats.h"
 #include "core/providers/nuphar/common/nuphar_settings.h"
+#include "core/providers/nuphar/common/nuphar_tvm_utils.h"
 #include "core/providers/nuphar/common/utils.h"
 #include "core/providers/nuphar/compiler/x86/x86_target_info.h"
 #include "core/providers/nuphar/kernel.h"
@@ -45,6 +46,24 @@ static std::string GetCurrentHostTargetString() {
 #endif  // USE_TVM_WITH_LLVM
 }
 
+// Picks the best of the targets the cached dll was compiled for that the host CPU supports,
+// so a dll built for several targets ahead of time runs without JIT on any of them.
+static std::unique_ptr<CodeGenTarget> CreateCachedCodeGenTarget() {
+  std::unordered_set<std::string> cached_targets;
+  if (!nuphar::GetCachedCodeGenTargets(cached_targets))
+    return nullptr;
+
+  const auto& cpu_id_info = CPUIDInfo::GetCPUIDInfo();
+  if (cpu_id_info.HasAVX512f() && cached_targets.count(CodeGenTargetX86::LLVM_TARGET_AVX512) > 0) {
+    return CodeGenTarget_AVX512();
+  } else if (cpu_id_info.HasAVX2() && cached_targets.count(CodeGenTargetX86::LLVM_TARGET_AVX2) > 0) {
+    return CodeGenTarget_AVX2();
+  } else if (cpu_id_info.HasAVX() && cached_targets.count(CodeGenTargetX86::LLVM_TARGET_AVX) > 0) {
+    return CodeGenTarget_AVX();
+  }
+  return nullptr;
+}
+
 NupharExecutionProvider::NupharExecutionProvider(const NupharExecutionProviderInfo& info)
     : IExecutionProvider(kNupharExecutionProvider) {
   nuphar::CreateNupharCodeGenSettings(info);
@@ -60,7 +79,15 @@ NupharExecutionProvider::NupharExecutionProvider(const NupharExecutionProviderIn
   }
 
   const auto& cpu_id_info = CPUIDInfo::GetCPUIDInfo();
+  bool use_cached_target = false;
   if (target_str == llvm_target_str) {
+    codegen_target_ = CreateCachedCodeGenTarget();
+    use_cached_target = (codegen_target_ != nullptr);
+  }
+
+  if (use_cached_target) {
+    LOGS_DEFAULT(INFO) << "Using codegen target " << codegen_target_->GetTargetName() << " of the cached dll";
+  } else if (target_str == llvm_target_str) {
     // auto detect from CPU ID
     if (cpu_id_info.HasAVX512f()) {
       codegen_target_ = CodeGenTarget_AVX512();
@@ -95,7 +122,9 @@ NupharExecutionProvider::NupharExecutionProvider(const NupharExecutionProviderIn
     tvm_host_target_ = tvm::Target::create(codegen_target_->GetTargetName());
   } else {
     CreateTVMTarget();
-    tvm_host_target_ = tvm::Target::create(GetCurrentHostTargetString());
+    // code JIT-compiled for a subgraph missing in the cached dll is saved for the same target as the dll
+    tvm_host_target_ = tvm::Target::create(use_cached_target ? codegen_target_->GetTargetName()
+                                                             : GetCurrentHostTargetString());
   }
 
   tvm_ctx_.device_type = static_cast<DLDeviceType>(tvm_target_->device_type);
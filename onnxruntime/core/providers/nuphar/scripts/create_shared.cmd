@@ -67,6 +67,9 @@ echo Linking %CACHE_DIR%\%OUTPUT_DLL%...
 link -dll -FORCE:MULTIPLE *.o -EXPORT:__tvm_main__ -out:%CACHE_DIR%\%OUTPUT_DLL%
 del *.o *.cc
 
+REM the manifest lists the functions in the dll and the codegen targets they were compiled for
+if exist manifest.txt move /y manifest.txt %CACHE_DIR%\%OUTPUT_DLL%.manifest
+
 exit /b
 
 :Usage
@@ -5,6 +5,7 @@
 import argparse
 import hashlib
 import os
+import shutil
 import subprocess
 import sys
 
@@ -97,6 +98,13 @@ if __name__ == '__main__':
     else:
         subprocess.run(['g++', '-shared', '-fPIC', '-o', args.output_name] + objs, cwd=args.input_dir, check=True)
 
+    # the manifest lists the functions in the so and the codegen targets they were compiled for
+    manifest = os.path.join(args.input_dir, 'manifest.txt')
+    if os.path.exists(manifest):
+        shutil.copyfile(manifest, os.path.join(args.input_dir, args.output_name + '.manifest'))
+
     if not args.keep_input:
         for f in objs:
             os.remove(os.path.join(args.input_dir, f))
+        if os.path.exists(manifest):
+            os.remove(manifest)
@@ -81,3 +81,8 @@ if ls *.o 1> /dev/null 2>&1; then
     fi
     rm *.o
 fi
+
+# the manifest lists the functions in the so and the codegen targets they were compiled for
+if [ -f manifest.txt ]; then
+    mv manifest.txt $CACHE_DIR/$OUTPUT_SO_FILE.manifest
+fi
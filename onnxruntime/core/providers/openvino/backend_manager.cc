@@ -267,6 +267,8 @@ void BackendManager::Compute(Ort::CustomOpApi api, OrtKernelContext* context) {
     std::vector<std::vector<int64_t>> tensor_shapes = GetInputTensorShapes(api, context);
     auto key = MakeMapKeyString(tensor_shapes, GetGlobalContext().device_type);
 
+    // Only the lookup and the creation of the backend are serialized, concurrent Infer calls can overlap
+    std::unique_lock<std::mutex> lock(backend_map_mutex_);
     if(GetGlobalContext().device_type == "MYRIAD"){
       
       #if (defined OPENVINO_2020_2) || (defined OPENVINO_2020_3)
@@ -296,6 +298,7 @@ void BackendManager::Compute(Ort::CustomOpApi api, OrtKernelContext* context) {
     } else {
       dynamic_backend = search->second;
     }
+    lock.unlock();
 
     dynamic_backend->Infer(api, context);
   } else {
@@ -9,6 +9,7 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/allocatormgr.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include <mutex>
 #include <inference_engine.hpp>
 
 #include "contexts.h"
@@ -41,6 +42,8 @@ class BackendManager {
   ONNX_NAMESPACE::ModelProto model_proto_;
   std::shared_ptr<IBackend> concrete_backend_;
   std::map<std::string, std::shared_ptr<IBackend>> backend_map_;
+  // guards backend_map_ and subgraph_context_ when Compute is called concurrently
+  std::mutex backend_map_mutex_;
   SubGraphContext subgraph_context_;
 };
 
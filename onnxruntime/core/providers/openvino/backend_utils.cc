@@ -41,6 +41,29 @@ void DumpOnnxModelProto(const ONNX_NAMESPACE::ModelProto& model_proto, std::stri
 
 #endif
 
+// 64-bit FNV-1a. Unlike std::hash its value doesn't change between builds, which a file name on disk needs.
+static uint64_t HashString(const std::string& str, uint64_t hash = 14695981039346656037ULL) {
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string GetBlobCachePath(const ONNX_NAMESPACE::ModelProto& model_proto, const GlobalContext& global_context,
+                             const std::string& hw_target, const std::map<std::string, std::string>& config) {
+  uint64_t hash = HashString(model_proto.SerializeAsString());
+  hash = HashString(hw_target, hash);
+  hash = HashString(global_context.precision_str, hash);
+  for (const auto& item : config) {
+    hash = HashString(item.first + "=" + item.second + ";", hash);
+  }
+
+  std::ostringstream path;
+  path << global_context.blob_cache_dir << "/" << std::hex << hash << ".blob";
+  return path.str();
+}
+
 struct static_cast_int64
 {
   template <typename T1> // T1 models type statically convertible to T
@@ -17,6 +17,11 @@ const std::string log_tag = "[OpenVINO-EP] ";
 bool IsDebugEnabled();
 #endif
 
+// Returns the file the compiled network of the model is cached in. The name is a hash of everything the compiled
+// network depends on, so a changed model or configuration doesn't load a stale blob.
+std::string GetBlobCachePath(const ONNX_NAMESPACE::ModelProto& model_proto, const GlobalContext& global_context,
+                             const std::string& hw_target, const std::map<std::string, std::string>& config);
+
 void SetIODefs(const ONNX_NAMESPACE::ModelProto& model_proto,
                std::shared_ptr<InferenceEngine::CNNNetwork> network,
                std::unordered_map<std::string, int> output_names,
@@ -1,6 +1,8 @@
 // Copyright(C) 2019 Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
+#include <cstdio>
 #include <map>
 #include <string>
 #include <memory>
@@ -32,8 +34,6 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
   ie_cnn_network_ = CreateCNNNetwork(model_proto, global_context_, subgraph_context_, const_outputs_map_);
   SetIODefs(model_proto, ie_cnn_network_, subgraph_context_.output_names, const_outputs_map_, global_context_.device_type);
 
-  InferenceEngine::ExecutableNetwork exe_network;
-
 #if defined(OPENVINO_2020_4) || defined(OPENVINO_2021_1)
   if(const_outputs_map_.size() == subgraph_context_.output_names.size())
     subgraph_context_.is_constant = true;
@@ -55,6 +55,52 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
     }
   }
   std::string& hw_target = (global_context_.device_id != "") ? global_context_.device_id : global_context_.device_type;
+  auto exe_network = LoadNetwork(model_proto, hw_target, config);
+  LOGS_DEFAULT(INFO) << log_tag << "Loaded model to the plugin";
+
+  // Create infer requests
+  size_t num_infer_requests = global_context_.num_of_infer_requests;
+  if (num_infer_requests == 0) {
+    try {
+      num_infer_requests = exe_network.GetMetric(METRIC_KEY(OPTIMAL_NUMBER_OF_INFER_REQUESTS)).as<unsigned int>();
+    } catch (...) {
+      // the plugin doesn't report it
+    }
+    num_infer_requests = std::max<size_t>(1, num_infer_requests);
+  }
+  for (size_t i = 0; i < num_infer_requests; i++) {
+    try {
+      idle_infer_requests_.push_back(exe_network.CreateInferRequestPtr());
+    } catch (InferenceEngine::details::InferenceEngineException e) {
+      ORT_THROW(log_tag + " Exception while creating InferRequest object: " + e.what());
+    } catch (...) {
+      ORT_THROW(log_tag + "Exception while creating InferRequest object");
+    }
+  }
+  LOGS_DEFAULT(INFO) << log_tag << "Infer requests created: " << num_infer_requests;
+}
+
+// Compiles the network for the device, or imports the network compiled by an earlier session from the blob cache.
+// Only the VPU plugin can export compiled networks, so the cache is skipped for the other devices.
+InferenceEngine::ExecutableNetwork BasicBackend::LoadNetwork(const ONNX_NAMESPACE::ModelProto& model_proto,
+                                                             const std::string& hw_target,
+                                                             const std::map<std::string, std::string>& config) {
+  std::string blob_path;
+  if (!global_context_.blob_cache_dir.empty() && global_context_.device_type == "MYRIAD") {
+    blob_path = GetBlobCachePath(model_proto, global_context_, hw_target, config);
+    if (std::ifstream(blob_path).good()) {
+      try {
+        auto exe_network = global_context_.ie_core.ImportNetwork(blob_path, hw_target, config);
+        LOGS_DEFAULT(INFO) << log_tag << "Imported compiled network from " << blob_path;
+        return exe_network;
+      } catch (...) {
+        // e.g. a blob of another OpenVINO version. compile the network and replace it
+        LOGS_DEFAULT(WARNING) << log_tag << "Couldn't import compiled network from " << blob_path;
+      }
+    }
+  }
+
+  InferenceEngine::ExecutableNetwork exe_network;
   try {
     exe_network = global_context_.ie_core.LoadNetwork(*ie_cnn_network_, hw_target, config);
   } catch (InferenceEngine::details::InferenceEngineException e) {
@@ -62,22 +108,43 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
   } catch (...) {
     ORT_THROW(log_tag + " Exception while Loading Network for graph " + subgraph_context_.subgraph_name);
   }
-  LOGS_DEFAULT(INFO) << log_tag << "Loaded model to the plugin";
 
-  // Create infer request
-  try {
-    infer_request_ = exe_network.CreateInferRequestPtr();
-  } catch (InferenceEngine::details::InferenceEngineException e) {
-    ORT_THROW(log_tag + " Exception while creating InferRequest object: " + e.what());
-  } catch (...) {
-    ORT_THROW(log_tag + "Exception while creating InferRequest object");
+  if (!blob_path.empty()) {
+    // export to a temporary file first, so another process never imports a partly written blob
+    std::string tmp_path = blob_path + "." + subgraph_context_.subgraph_name + ".tmp";
+    try {
+      exe_network.Export(tmp_path);
+      std::remove(blob_path.c_str());
+      if (std::rename(tmp_path.c_str(), blob_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+      }
+    } catch (...) {
+      std::remove(tmp_path.c_str());
+      LOGS_DEFAULT(WARNING) << log_tag << "Couldn't export compiled network to " << blob_path;
+    }
   }
-  LOGS_DEFAULT(INFO) << log_tag << "Infer request created";
+  return exe_network;
 }
 
-// Starts an asynchronous inference request for data in slice indexed by batch_slice_idx on
-// an Infer Request indexed by infer_req_idx
-void BasicBackend::StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context) {
+InferenceEngine::InferRequest::Ptr BasicBackend::AcquireInferRequest() {
+  std::unique_lock<std::mutex> lock(infer_requests_mutex_);
+  infer_request_released_.wait(lock, [this] { return !idle_infer_requests_.empty(); });
+  auto infer_request = idle_infer_requests_.back();
+  idle_infer_requests_.pop_back();
+  return infer_request;
+}
+
+void BasicBackend::ReleaseInferRequest(InferenceEngine::InferRequest::Ptr infer_request) {
+  {
+    std::lock_guard<std::mutex> lock(infer_requests_mutex_);
+    idle_infer_requests_.push_back(infer_request);
+  }
+  infer_request_released_.notify_one();
+}
+
+// Fills the inputs of the infer request and starts an asynchronous inference on it
+void BasicBackend::StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context,
+                                       InferenceEngine::InferRequest::Ptr infer_request) {
 
   auto graph_input_info = ie_cnn_network_->getInputsInfo();
 
@@ -88,7 +155,7 @@ void BasicBackend::StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext*
     InferenceEngine::Blob::Ptr graph_input_blob;
     std::string input_name = input_info_iter->first;
     try {
-      graph_input_blob = infer_request_->GetBlob(input_name);
+      graph_input_blob = infer_request->GetBlob(input_name);
 
     } catch (InferenceEngine::details::InferenceEngineException e) {
       ORT_THROW(log_tag + " Cannot access IE Blob for input: " + input_name + e.what());
@@ -101,7 +168,7 @@ void BasicBackend::StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext*
   }
   // Start Async inference
   try {
-    infer_request_->StartAsync();
+    infer_request->StartAsync();
   } catch (InferenceEngine::details::InferenceEngineException e) {
     ORT_THROW(log_tag + " Couldn't start Inference: " + e.what());
   } catch (...) {
@@ -109,12 +176,12 @@ void BasicBackend::StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext*
   }
 }
 
-// Wait for asynchronous inference completion on an Infer Request object indexed by infer_req_idx
-// and copy the results into a slice location within the batched output buffer indexed by batch_slice_idx
-void BasicBackend::CompleteAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context) {
+// Wait for asynchronous inference completion on the infer request and copy the results to the outputs
+void BasicBackend::CompleteAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context,
+                                          InferenceEngine::InferRequest::Ptr infer_request) {
   // Wait for Async inference completion
   try {
-    infer_request_->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+    infer_request->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
   } catch (InferenceEngine::details::InferenceEngineException e) {
     ORT_THROW(log_tag + " Exception with completing Inference: " + e.what());
   } catch (...) {
@@ -128,14 +195,15 @@ void BasicBackend::CompleteAsyncInference(Ort::CustomOpApi& ort, OrtKernelContex
     InferenceEngine::Blob::Ptr graph_output_blob;
     auto output_name = output_info_iter->first;
     try {
-      graph_output_blob = infer_request_->GetBlob(output_name);
+      graph_output_blob = infer_request->GetBlob(output_name);
     } catch (InferenceEngine::details::InferenceEngineException e) {
       ORT_THROW(log_tag + " Cannot access IE Blob for output: " + output_name + e.what());
     } catch (...) {
       ORT_THROW(log_tag + " Cannot access IE Blob for output: " + output_name);
     }
     size_t batch_size = 1;
-    auto output_tensor = GetOutputTensor(ort, context, batch_size, infer_request_, output_name, subgraph_context_.output_names);
+    auto output_tensor = GetOutputTensor(ort, context, batch_size, infer_request, output_name,
+                                         subgraph_context_.output_names);
     auto precision = output_info_iter->second->getPrecision();
 
     size_t batch_slice = 0;
@@ -155,12 +223,11 @@ void BasicBackend::CompleteAsyncInference(Ort::CustomOpApi& ort, OrtKernelContex
 }
 
 void BasicBackend::Infer(Ort::CustomOpApi& ort, OrtKernelContext* context) {
-  // Preliminary Thread safety mechanism
-  // Currently allows only one Infer execution at a time
+  // Concurrent Infer calls run on different infer requests of the pool, and wait for
+  // one to be released when all of them are in use
 
   LOGS_DEFAULT(INFO) << log_tag << "Running graph " << subgraph_context_.subgraph_name;
   LOGS_DEFAULT(INFO) << log_tag << "In Infer";
-  std::lock_guard<std::mutex> lock(compute_lock_);
 
   if(subgraph_context_.is_constant){
 #if defined(OPENVINO_2020_4) || defined(OPENVINO_2021_1)
@@ -173,8 +240,15 @@ void BasicBackend::Infer(Ort::CustomOpApi& ort, OrtKernelContext* context) {
 #endif
   }
   else{
-    StartAsyncInference(ort, context);
-    CompleteAsyncInference(ort, context);
+    auto infer_request = AcquireInferRequest();
+    try {
+      StartAsyncInference(ort, context, infer_request);
+      CompleteAsyncInference(ort, context, infer_request);
+    } catch (...) {
+      ReleaseInferRequest(infer_request);
+      throw;
+    }
+    ReleaseInferRequest(infer_request);
   }
   // Get Output tensors
   LOGS_DEFAULT(INFO) << log_tag << "Inference successful";
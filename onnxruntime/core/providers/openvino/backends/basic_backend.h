@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <inference_engine.hpp>
 
 #include "core/session/onnxruntime_cxx_api.h"
@@ -22,16 +25,29 @@ class BasicBackend : public IBackend {
   void Infer(Ort::CustomOpApi& ort, OrtKernelContext* context) override;
 
  private:
-  void StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context);
+  InferenceEngine::ExecutableNetwork LoadNetwork(const ONNX_NAMESPACE::ModelProto& model_proto,
+                                                const std::string& hw_target,
+                                                const std::map<std::string, std::string>& config);
 
-  void CompleteAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context);
+  void StartAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context,
+                           InferenceEngine::InferRequest::Ptr infer_request);
+
+  void CompleteAsyncInference(Ort::CustomOpApi& ort, OrtKernelContext* context,
+                              InferenceEngine::InferRequest::Ptr infer_request);
+
+  // Takes an idle infer request from the pool, waiting for one if all of them are running
+  InferenceEngine::InferRequest::Ptr AcquireInferRequest();
+
+  void ReleaseInferRequest(InferenceEngine::InferRequest::Ptr infer_request);
 
   GlobalContext& global_context_;
   SubGraphContext subgraph_context_;
-  mutable std::mutex compute_lock_;
   std::shared_ptr<InferenceEngine::CNNNetwork> ie_cnn_network_;
   std::map<std::string, std::shared_ptr<ngraph::Node>> const_outputs_map_;
-  InferenceEngine::InferRequest::Ptr infer_request_;
+  // Every concurrent Infer call runs on its own infer request, so the device can overlap them
+  std::vector<InferenceEngine::InferRequest::Ptr> idle_infer_requests_;
+  std::mutex infer_requests_mutex_;
+  std::condition_variable infer_request_released_;
 };
 }  // namespace openvino_ep
 }  // namespace onnxruntime
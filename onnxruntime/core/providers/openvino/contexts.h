@@ -16,6 +16,10 @@ struct GlobalContext {
   std::string device_type;
   std::string precision_str;
   std::string device_id;
+  // 0 lets the backend use the number of infer requests the device reports as optimal
+  size_t num_of_infer_requests = 0;
+  // directory of the compiled networks exported by the devices that support it, empty to disable
+  std::string blob_cache_dir;
   std::vector<bool> deviceAvailableList = {true, true, true, true, true, true, true, true};
   std::vector<std::string> deviceTags = {"0", "1", "2", "3", "4", "5", "6", "7"};
 };
@@ -43,6 +43,9 @@ OpenVINOExecutionProvider::OpenVINOExecutionProvider(const OpenVINOExecutionProv
   }
   openvino_ep::BackendManager::GetGlobalContext().device_id = info.device_id_;
 
+  openvino_ep::BackendManager::GetGlobalContext().num_of_infer_requests = info.num_of_infer_requests_;
+  openvino_ep::BackendManager::GetGlobalContext().blob_cache_dir = info.blob_cache_dir_;
+
   AllocatorCreationInfo device_info(
       [](int) {
         return std::make_unique<CPUAllocator>(OrtMemoryInfo(OpenVINO, OrtDeviceAllocator));
@@ -19,9 +19,13 @@ struct OpenVINOExecutionProviderInfo {
   std::string precision_;
   bool enable_vpu_fast_compile_;
   std::string device_id_;
+  size_t num_of_infer_requests_;
+  std::string blob_cache_dir_;
 
-  explicit OpenVINOExecutionProviderInfo(std::string dev_type, bool enable_vpu_fast_compile, std::string dev_id)
-            : enable_vpu_fast_compile_(enable_vpu_fast_compile), device_id_(dev_id) {
+  explicit OpenVINOExecutionProviderInfo(std::string dev_type, bool enable_vpu_fast_compile, std::string dev_id,
+                                         size_t num_of_infer_requests = 0, std::string blob_cache_dir = "")
+            : enable_vpu_fast_compile_(enable_vpu_fast_compile), device_id_(dev_id),
+              num_of_infer_requests_(num_of_infer_requests), blob_cache_dir_(blob_cache_dir) {
 
     if (dev_type == "") {
       LOGS_DEFAULT(INFO) << "[OpenVINO-EP]"
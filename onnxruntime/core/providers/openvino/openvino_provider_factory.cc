@@ -8,10 +8,11 @@
 namespace onnxruntime {
 struct OpenVINOProviderFactory : IExecutionProviderFactory {
   OpenVINOProviderFactory(const char* device_type, bool enable_vpu_fast_compile,
-                          const char* device_id)
-    : enable_vpu_fast_compile_(enable_vpu_fast_compile) {
+                          const char* device_id, size_t num_of_infer_requests, const char* blob_cache_dir)
+    : enable_vpu_fast_compile_(enable_vpu_fast_compile), num_of_infer_requests_(num_of_infer_requests) {
     device_type_ = (device_type == nullptr) ? "" : device_type;
     device_id_ = (device_id == nullptr) ? "" : device_id;
+    blob_cache_dir_ = (blob_cache_dir == nullptr) ? "" : blob_cache_dir;
   }
   ~OpenVINOProviderFactory() override {
   }
@@ -22,16 +23,21 @@ struct OpenVINOProviderFactory : IExecutionProviderFactory {
   std::string device_type_;
   bool enable_vpu_fast_compile_;
   std::string device_id_;
+  size_t num_of_infer_requests_;
+  std::string blob_cache_dir_;
 };
 
 std::unique_ptr<IExecutionProvider> OpenVINOProviderFactory::CreateProvider() {
-  OpenVINOExecutionProviderInfo info(device_type_, enable_vpu_fast_compile_, device_id_);
+  OpenVINOExecutionProviderInfo info(device_type_, enable_vpu_fast_compile_, device_id_, num_of_infer_requests_,
+                                     blob_cache_dir_);
   return std::make_unique<OpenVINOExecutionProvider>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVINO(
-    const char* device_type, bool enable_vpu_fast_compile, const char* device_id) {
-  return std::make_shared<onnxruntime::OpenVINOProviderFactory>(device_type, enable_vpu_fast_compile, device_id);
+    const char* device_type, bool enable_vpu_fast_compile, const char* device_id, size_t num_of_infer_requests,
+    const char* blob_cache_dir) {
+  return std::make_shared<onnxruntime::OpenVINOProviderFactory>(device_type, enable_vpu_fast_compile, device_id,
+                                                                num_of_infer_requests, blob_cache_dir);
 }
 
 }  // namespace onnxruntime
@@ -39,7 +45,7 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVI
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_OpenVINO,
                     _In_ OrtSessionOptions* options, _In_ const char* device_type) {
   options->provider_factories.push_back(
-      onnxruntime::CreateExecutionProviderFactory_OpenVINO(device_type, false, ""));
+      onnxruntime::CreateExecutionProviderFactory_OpenVINO(device_type, false, "", 0, ""));
   return nullptr;
 }
 
@@ -49,6 +55,8 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderEx_OpenVINOEP,
   std::string device_type = "";
   bool enable_vpu_fast_compile = false;
   std::string device_id = "";
+  size_t num_of_infer_requests = 0;
+  std::string blob_cache_dir = "";
 
   // Parse settings string
   std::stringstream iss;
@@ -74,6 +82,18 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderEx_OpenVINOEP,
       }
     } else if(key == "device_id") {
       device_id = value;
+    } else if (key == "num_of_infer_requests") {
+      int num = 0;
+      try {
+        num = std::stoi(value);
+      } catch (...) {
+      }
+      if (num <= 0) {
+        ORT_THROW("Invalid value passed for num_of_infer_requests: " + value);
+      }
+      num_of_infer_requests = static_cast<size_t>(num);
+    } else if (key == "blob_cache_dir") {
+      blob_cache_dir = value;
     }
 
   }
@@ -81,6 +101,8 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProviderEx_OpenVINOEP,
   options->provider_factories.push_back(
       onnxruntime::CreateExecutionProviderFactory_OpenVINO(device_type.c_str(),
                                                            enable_vpu_fast_compile,
-                                                           device_id.c_str()));
+                                                           device_id.c_str(),
+                                                           num_of_infer_requests,
+                                                           blob_cache_dir.c_str()));
   return nullptr;
 }
@@ -6,6 +6,11 @@
 
 #include "core/framework/func_api.h"
 
+#ifdef USE_TENSORRT
+struct cudaDeviceProp;
+typedef struct CUstream_st* cudaStream_t;
+#endif
+
 #define PROVIDER_DISALLOW_ALL(TypeName)     \
   TypeName() = delete;                      \
   TypeName(const TypeName&) = delete;       \
@@ -244,6 +249,15 @@ struct ProviderHost {
   virtual void cuda__Impl_Cast(const int64_t* input_data, int32_t* output_data, size_t count) = 0;
   virtual void cuda__Impl_Cast(const int32_t* input_data, int64_t* output_data, size_t count) = 0;
 
+  // CUDA kernels of the contrib ops, for the TensorRT plugins. They return false without the contrib ops.
+  virtual bool contrib_cuda__LaunchFastGeluKernel(const cudaDeviceProp& prop, cudaStream_t stream, int input_length,
+                                                  int bias_length, const void* input, const void* bias, void* output,
+                                                  size_t element_size) = 0;
+  virtual bool contrib_cuda__LaunchSkipLayerNormKernel(void* output, const void* input, const void* skip,
+                                                       const void* gamma, const void* beta, const void* bias,
+                                                       float epsilon, int hidden_size, int element_count,
+                                                       size_t element_size) = 0;
+
   virtual bool CudaCall_false(int retCode, const char* exprString, const char* libName, int successCode, const char* msg) = 0;
   virtual bool CudaCall_true(int retCode, const char* exprString, const char* libName, int successCode, const char* msg) = 0;
 #endif
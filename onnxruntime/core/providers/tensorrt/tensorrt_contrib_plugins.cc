@@ -0,0 +1,253 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/shared_library/provider_api.h"
+#include "tensorrt_contrib_plugins.h"
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "NvInfer.h"
+#include "cuda_runtime_api.h"
+
+namespace onnxruntime {
+namespace {
+
+constexpr const char* kPluginVersion = "1";
+
+int64_t Volume(const nvinfer1::Dims& dims) {
+  int64_t volume = 1;
+  for (int i = 0; i < dims.nbDims; ++i) {
+    volume *= dims.d[i];
+  }
+  return volume;
+}
+
+size_t ElementSize(nvinfer1::DataType type) {
+  return type == nvinfer1::DataType::kHALF ? 2 : 4;
+}
+
+template <typename T>
+void Write(char*& buffer, const T& value) {
+  std::memcpy(buffer, &value, sizeof(T));
+  buffer += sizeof(T);
+}
+
+template <typename T>
+T Read(const char*& buffer) {
+  T value;
+  std::memcpy(&value, buffer, sizeof(T));
+  buffer += sizeof(T);
+  return value;
+}
+
+// Base of the plugins of the contrib ops: one output with the shape and the type of the first input, which is
+// float or half. All the tensors are in the linear format and have the same type.
+class ContribOpPlugin : public nvinfer1::IPluginV2DynamicExt {
+ public:
+  int getNbOutputs() const override { return 1; }
+
+  nvinfer1::DimsExprs getOutputDimensions(int /*output_index*/, const nvinfer1::DimsExprs* inputs, int /*nb_inputs*/,
+                                          nvinfer1::IExprBuilder& /*expr_builder*/) override {
+    return inputs[0];
+  }
+
+  bool supportsFormatCombination(int pos, const nvinfer1::PluginTensorDesc* in_out, int /*nb_inputs*/,
+                                 int /*nb_outputs*/) override {
+    const auto& desc = in_out[pos];
+    if (desc.format != nvinfer1::TensorFormat::kLINEAR) {
+      return false;
+    }
+    if (pos == 0) {
+      return desc.type == nvinfer1::DataType::kFLOAT || desc.type == nvinfer1::DataType::kHALF;
+    }
+    return desc.type == in_out[0].type;
+  }
+
+  void configurePlugin(const nvinfer1::DynamicPluginTensorDesc* /*in*/, int nb_inputs,
+                       const nvinfer1::DynamicPluginTensorDesc* /*out*/, int /*nb_outputs*/) override {
+    num_inputs_ = nb_inputs;
+  }
+
+  size_t getWorkspaceSize(const nvinfer1::PluginTensorDesc* /*inputs*/, int /*nb_inputs*/,
+                          const nvinfer1::PluginTensorDesc* /*outputs*/, int /*nb_outputs*/) const override {
+    return 0;
+  }
+
+  nvinfer1::DataType getOutputDataType(int /*index*/, const nvinfer1::DataType* input_types,
+                                       int /*nb_inputs*/) const override {
+    return input_types[0];
+  }
+
+  const char* getPluginVersion() const override { return kPluginVersion; }
+
+  int initialize() override {
+    int device = 0;
+    if (cudaGetDevice(&device) != cudaSuccess || cudaGetDeviceProperties(&prop_, device) != cudaSuccess) {
+      return 1;
+    }
+    return 0;
+  }
+
+  void terminate() override {}
+
+  void destroy() override { delete this; }
+
+  void setPluginNamespace(const char* plugin_namespace) override { namespace_ = plugin_namespace; }
+
+  const char* getPluginNamespace() const override { return namespace_.c_str(); }
+
+ protected:
+  // number of inputs of the node, as optional inputs may be missing
+  int num_inputs_ = 0;
+  cudaDeviceProp prop_{};
+  std::string namespace_;
+};
+
+// FastGelu(input, bias): the tanh approximation of Gelu of input + bias, with bias optional.
+class FastGeluPlugin : public ContribOpPlugin {
+ public:
+  static constexpr const char* kName = "FastGelu";
+
+  explicit FastGeluPlugin(const nvinfer1::PluginFieldCollection* /*fields*/) {}
+
+  FastGeluPlugin(const void* data, size_t /*length*/) {
+    const char* buffer = static_cast<const char*>(data);
+    num_inputs_ = Read<int>(buffer);
+  }
+
+  static const nvinfer1::PluginFieldCollection* Fields() {
+    static const nvinfer1::PluginFieldCollection fields{0, nullptr};
+    return &fields;
+  }
+
+  const char* getPluginType() const override { return kName; }
+
+  int enqueue(const nvinfer1::PluginTensorDesc* input_desc, const nvinfer1::PluginTensorDesc* /*output_desc*/,
+              const void* const* inputs, void* const* outputs, void* /*workspace*/, cudaStream_t stream) override {
+    const bool has_bias = num_inputs_ > 1;
+    const int input_length = static_cast<int>(Volume(input_desc[0].dims));
+    const int bias_length = has_bias ? static_cast<int>(Volume(input_desc[1].dims)) : 0;
+    return g_host->contrib_cuda__LaunchFastGeluKernel(prop_, stream, input_length, bias_length, inputs[0],
+                                                      has_bias ? inputs[1] : nullptr, outputs[0],
+                                                      ElementSize(input_desc[0].type))
+               ? 0
+               : 1;
+  }
+
+  size_t getSerializationSize() const override { return sizeof(int); }
+
+  void serialize(void* data) const override {
+    char* buffer = static_cast<char*>(data);
+    Write(buffer, num_inputs_);
+  }
+
+  nvinfer1::IPluginV2DynamicExt* clone() const override {
+    return new FastGeluPlugin(*this);
+  }
+};
+
+// SkipLayerNormalization(input, skip, gamma, beta, bias): layer normalization over the last axis of
+// input + skip + bias, with bias optional.
+class SkipLayerNormPlugin : public ContribOpPlugin {
+ public:
+  static constexpr const char* kName = "SkipLayerNormalization";
+
+  explicit SkipLayerNormPlugin(const nvinfer1::PluginFieldCollection* fields) {
+    for (int i = 0; i < fields->nbFields; ++i) {
+      const auto& field = fields->fields[i];
+      if (std::strcmp(field.name, "epsilon") == 0 && field.type == nvinfer1::PluginFieldType::kFLOAT32) {
+        epsilon_ = *static_cast<const float*>(field.data);
+      }
+    }
+  }
+
+  SkipLayerNormPlugin(const void* data, size_t /*length*/) {
+    const char* buffer = static_cast<const char*>(data);
+    num_inputs_ = Read<int>(buffer);
+    epsilon_ = Read<float>(buffer);
+  }
+
+  static const nvinfer1::PluginFieldCollection* Fields() {
+    static const std::vector<nvinfer1::PluginField> field_list{
+        nvinfer1::PluginField("epsilon", nullptr, nvinfer1::PluginFieldType::kFLOAT32, 1)};
+    static const nvinfer1::PluginFieldCollection fields{static_cast<int>(field_list.size()), field_list.data()};
+    return &fields;
+  }
+
+  const char* getPluginType() const override { return kName; }
+
+  // The kernel runs on the default stream, which is the stream the execution provider enqueues the engines on.
+  int enqueue(const nvinfer1::PluginTensorDesc* input_desc, const nvinfer1::PluginTensorDesc* /*output_desc*/,
+              const void* const* inputs, void* const* outputs, void* /*workspace*/, cudaStream_t /*stream*/) override {
+    const auto& dims = input_desc[0].dims;
+    const int hidden_size = static_cast<int>(dims.d[dims.nbDims - 1]);
+    const int element_count = static_cast<int>(Volume(dims));
+    return g_host->contrib_cuda__LaunchSkipLayerNormKernel(outputs[0], inputs[0], inputs[1], inputs[2], inputs[3],
+                                                           num_inputs_ > 4 ? inputs[4] : nullptr, epsilon_,
+                                                           hidden_size, element_count,
+                                                           ElementSize(input_desc[0].type))
+               ? 0
+               : 1;
+  }
+
+  size_t getSerializationSize() const override { return sizeof(int) + sizeof(float); }
+
+  void serialize(void* data) const override {
+    char* buffer = static_cast<char*>(data);
+    Write(buffer, num_inputs_);
+    Write(buffer, epsilon_);
+  }
+
+  nvinfer1::IPluginV2DynamicExt* clone() const override {
+    return new SkipLayerNormPlugin(*this);
+  }
+
+ private:
+  // default of the attribute in the schema of the contrib op
+  float epsilon_ = 1e-12f;
+};
+
+template <typename Plugin>
+class ContribOpPluginCreator : public nvinfer1::IPluginCreator {
+ public:
+  const char* getPluginName() const override { return Plugin::kName; }
+
+  const char* getPluginVersion() const override { return kPluginVersion; }
+
+  const nvinfer1::PluginFieldCollection* getFieldNames() override { return Plugin::Fields(); }
+
+  nvinfer1::IPluginV2* createPlugin(const char* /*name*/, const nvinfer1::PluginFieldCollection* fields) override {
+    auto* plugin = new Plugin(fields);
+    plugin->setPluginNamespace(namespace_.c_str());
+    return plugin;
+  }
+
+  nvinfer1::IPluginV2* deserializePlugin(const char* /*name*/, const void* data, size_t length) override {
+    auto* plugin = new Plugin(data, length);
+    plugin->setPluginNamespace(namespace_.c_str());
+    return plugin;
+  }
+
+  void setPluginNamespace(const char* plugin_namespace) override { namespace_ = plugin_namespace; }
+
+  const char* getPluginNamespace() const override { return namespace_.c_str(); }
+
+ private:
+  std::string namespace_;
+};
+
+}  // namespace
+
+void RegisterTensorrtContribOpPlugins() {
+  static std::once_flag registered;
+  std::call_once(registered, []() {
+    static ContribOpPluginCreator<FastGeluPlugin> fast_gelu_creator;
+    static ContribOpPluginCreator<SkipLayerNormPlugin> skip_layer_norm_creator;
+    getPluginRegistry()->registerCreator(fast_gelu_creator, "");
+    getPluginRegistry()->registerCreator(skip_layer_norm_creator, "");
+  });
+}
+
+}  // namespace onnxruntime
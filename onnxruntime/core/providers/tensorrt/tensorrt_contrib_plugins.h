@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+
+// Registers TensorRT plugins for the FastGelu and SkipLayerNormalization contrib ops in the TensorRT plugin registry.
+// The plugins run the CUDA kernels of the contrib ops. The ONNX parser of TensorRT imports a node it has no importer
+// for with the plugin registered under the op type, so a graph with these ops is no longer split into several engines.
+// Registering more than once has no effect.
+void RegisterTensorrtContribOpPlugins();
+
+}  // namespace onnxruntime
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <list>
 #include <unordered_set>
@@ -10,6 +13,7 @@
 #include "core/common/safeint.h"
 
 #include "tensorrt_execution_provider.h"
+#include "tensorrt_contrib_plugins.h"
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/shared_inc/cuda_call.h"
 #include "core/providers/cuda/math/unary_elementwise_ops_impl.h"
@@ -21,6 +25,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <sstream>
 
 #define CUDA_RETURN_IF_ERROR(expr)               \
   ORT_RETURN_IF_ERROR(CUDA_CALL(expr)            \
@@ -170,6 +175,470 @@ TensorrtLogger& GetTensorrtLogger() {
   return trt_logger;
 }
 
+namespace {
+// Parses the <input name>:<dims> entries of one of the ORT_TENSORRT_PROFILE_*_SHAPES environment variables.
+std::vector<std::pair<std::string, std::vector<int64_t>>> ParseProfileShapes(const std::string& env_var,
+                                                                            const std::string& value) {
+  std::vector<std::pair<std::string, std::vector<int64_t>>> entries;
+  std::istringstream entry_stream(value);
+  std::string entry;
+  while (std::getline(entry_stream, entry, ',')) {
+    auto separator = entry.rfind(':');
+    if (separator == 0 || separator == std::string::npos || separator + 1 == entry.size()) {
+      throw std::runtime_error("Invalid entry '" + entry + "' in " + env_var + ", expected <input name>:<dims>");
+    }
+
+    std::vector<int64_t> dims;
+    std::istringstream dim_stream(entry.substr(separator + 1));
+    std::string dim;
+    while (std::getline(dim_stream, dim, 'x')) {
+      size_t end = 0;
+      int64_t dim_value = -1;
+      try {
+        dim_value = std::stoll(dim, &end);
+      } catch (const std::exception&) {
+        end = 0;
+      }
+      if (end == 0 || end != dim.size() || dim_value < 0) {
+        throw std::runtime_error("Invalid dims in entry '" + entry + "' of " + env_var);
+      }
+      dims.push_back(dim_value);
+    }
+    entries.emplace_back(entry.substr(0, separator), std::move(dims));
+  }
+  return entries;
+}
+
+// Builds the optimization profiles declared with the ORT_TENSORRT_PROFILE_*_SHAPES environment variables.
+// The n-th entry of an input goes to the n-th profile.
+std::vector<TensorrtProfile> GetDeclaredProfiles(const std::string& min_shapes, const std::string& opt_shapes,
+                                                 const std::string& max_shapes) {
+  std::vector<TensorrtProfile> profiles;
+  if (min_shapes.empty() && opt_shapes.empty() && max_shapes.empty()) {
+    return profiles;
+  }
+
+  auto min_entries = ParseProfileShapes(tensorrt_env_vars::kProfileMinShapes, min_shapes);
+  auto opt_entries = ParseProfileShapes(tensorrt_env_vars::kProfileOptShapes, opt_shapes);
+  auto max_entries = ParseProfileShapes(tensorrt_env_vars::kProfileMaxShapes, max_shapes);
+  if (min_entries.size() != opt_entries.size() || min_entries.size() != max_entries.size()) {
+    throw std::runtime_error(tensorrt_env_vars::kProfileMinShapes + ", " + tensorrt_env_vars::kProfileOptShapes +
+                             " and " + tensorrt_env_vars::kProfileMaxShapes + " must list the same inputs");
+  }
+
+  std::unordered_map<std::string, size_t> input_profile_counts;
+  for (size_t i = 0; i < min_entries.size(); ++i) {
+    const std::string& name = min_entries[i].first;
+    auto& min_dims = min_entries[i].second;
+    auto& opt_dims = opt_entries[i].second;
+    auto& max_dims = max_entries[i].second;
+    if (opt_entries[i].first != name || max_entries[i].first != name ||
+        opt_dims.size() != min_dims.size() || max_dims.size() != min_dims.size()) {
+      throw std::runtime_error("The optimization profile entry " + std::to_string(i) + " of input " + name +
+                               " doesn't have the same input and rank for the min, opt and max shapes");
+    }
+    for (size_t j = 0; j < min_dims.size(); ++j) {
+      if (min_dims[j] > opt_dims[j] || opt_dims[j] > max_dims[j]) {
+        throw std::runtime_error("The optimization profile entry " + std::to_string(i) + " of input " + name +
+                                 " doesn't satisfy min <= opt <= max");
+      }
+    }
+
+    size_t profile_index = input_profile_counts[name]++;
+    if (profile_index == profiles.size()) {
+      profiles.emplace_back();
+    }
+    profiles[profile_index][name] = TensorrtInputProfile{std::move(min_dims), std::move(opt_dims), std::move(max_dims)};
+  }
+  return profiles;
+}
+
+// Restricts the declared profiles to the inputs of <network>. <profiles> is left empty if they don't declare any
+// of its dynamic inputs, in which case the shape ranges are learned at run time.
+Status GetSubgraphProfiles(const nvinfer1::INetworkDefinition& network, const std::vector<TensorrtProfile>& declared,
+                           const std::string& node_name, std::vector<TensorrtProfile>& profiles) {
+  profiles.clear();
+  std::vector<const nvinfer1::ITensor*> dynamic_inputs;
+  bool any_declared = false;
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    const auto* input = network.getInput(i);
+    const nvinfer1::Dims dims = input->getDimensions();
+    bool dynamic = input->isShapeTensor();
+    for (int j = 0; j < dims.nbDims; ++j) {
+      dynamic = dynamic || dims.d[j] == -1;
+    }
+    if (dynamic) {
+      dynamic_inputs.push_back(input);
+      any_declared = any_declared || (!declared.empty() && declared[0].count(input->getName()) != 0);
+    }
+  }
+  if (!any_declared) {
+    return Status::OK();
+  }
+
+  for (size_t k = 0; k < declared.size(); ++k) {
+    TensorrtProfile profile;
+    for (const auto* input : dynamic_inputs) {
+      const std::string name = input->getName();
+      auto it = declared[k].find(name);
+      if (input->isShapeTensor()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP optimization profiles can't be declared for the shape tensor input ",
+                               name, " of fused node ", node_name);
+      }
+      if (it == declared[k].end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP optimization profile ", k, " doesn't declare the dynamic input ",
+                               name, " of fused node ", node_name);
+      }
+
+      const nvinfer1::Dims dims = input->getDimensions();
+      const TensorrtInputProfile& input_profile = it->second;
+      bool matches = static_cast<int>(input_profile.min_dims.size()) == dims.nbDims;
+      for (int j = 0; matches && j < dims.nbDims; ++j) {
+        matches = dims.d[j] == -1 || (input_profile.min_dims[j] == dims.d[j] && input_profile.max_dims[j] == dims.d[j]);
+      }
+      if (!matches) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP optimization profile ", k, " of input ", name,
+                               " doesn't match its shape in fused node ", node_name);
+      }
+      profile[name] = input_profile;
+    }
+    profiles.push_back(std::move(profile));
+  }
+  return Status::OK();
+}
+
+nvinfer1::Dims ToTensorrtDims(const std::vector<int64_t>& dims) {
+  nvinfer1::Dims trt_dims;
+  trt_dims.nbDims = static_cast<int>(dims.size());
+  for (size_t j = 0; j < dims.size(); ++j) {
+    trt_dims.d[j] = static_cast<int>(dims[j]);
+  }
+  return trt_dims;
+}
+
+nvinfer1::IOptimizationProfile* CreateDeclaredProfile(nvinfer1::IBuilder& builder, const TensorrtProfile& profile) {
+  nvinfer1::IOptimizationProfile* trt_profile = builder.createOptimizationProfile();
+  for (const auto& input : profile) {
+    trt_profile->setDimensions(input.first.c_str(), nvinfer1::OptProfileSelector::kMIN, ToTensorrtDims(input.second.min_dims));
+    trt_profile->setDimensions(input.first.c_str(), nvinfer1::OptProfileSelector::kOPT, ToTensorrtDims(input.second.opt_dims));
+    trt_profile->setDimensions(input.first.c_str(), nvinfer1::OptProfileSelector::kMAX, ToTensorrtDims(input.second.max_dims));
+  }
+  return trt_profile;
+}
+
+// Creates the profile the engine is built with at run time for the learned shape ranges: from the lower to the
+// upper bound of each range, optimized for the upper bound.
+nvinfer1::IOptimizationProfile* CreateProfileFromRanges(nvinfer1::IBuilder& builder,
+                                                        const nvinfer1::INetworkDefinition& network,
+                                                        const TensorrtShapeRanges& ranges) {
+  nvinfer1::IOptimizationProfile* trt_profile = builder.createOptimizationProfile();
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    const auto* input = network.getInput(i);
+    auto it = ranges.find(input->getName());
+    if (it == ranges.end()) {
+      continue;
+    }
+
+    const auto& range = it->second;
+    if (input->isShapeTensor()) {
+      const int shape_size = static_cast<int>(range.size());
+      std::vector<int32_t> values_min(shape_size), values_max(shape_size);
+      for (int j = 0; j < shape_size; ++j) {
+        values_min[j] = static_cast<int32_t>(range.at(j).first);
+        values_max[j] = static_cast<int32_t>(range.at(j).second);
+      }
+      trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, values_min.data(), shape_size);
+      trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, values_max.data(), shape_size);
+      trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, values_max.data(), shape_size);
+    } else {
+      nvinfer1::Dims dims_min = input->getDimensions();
+      nvinfer1::Dims dims_max = dims_min;
+      for (const auto& dim_range : range) {
+        dims_min.d[dim_range.first] = static_cast<int>(dim_range.second.first);
+        dims_max.d[dim_range.first] = static_cast<int>(dim_range.second.second);
+      }
+      trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
+      trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_max);
+      trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+    }
+  }
+  return trt_profile;
+}
+
+// Hashes that don't depend on the iteration order of the maps, as they name engines cached across processes.
+std::string GetShapeRangesHash(const TensorrtShapeRanges& ranges) {
+  std::map<std::string, std::map<int, std::pair<int64_t, int64_t>>> sorted_ranges;
+  for (const auto& input : ranges) {
+    sorted_ranges[input.first].insert(input.second.begin(), input.second.end());
+  }
+  std::vector<int> values;
+  for (const auto& input : sorted_ranges) {
+    values.insert(values.end(), input.first.begin(), input.first.end());
+    for (const auto& dim_range : input.second) {
+      values.push_back(dim_range.first);
+      values.push_back(static_cast<int>(dim_range.second.first));
+      values.push_back(static_cast<int>(dim_range.second.second));
+    }
+  }
+  return GetVecHash(values);
+}
+
+std::string GetProfilesHash(const std::vector<TensorrtProfile>& profiles) {
+  std::vector<int> values;
+  for (const auto& profile : profiles) {
+    std::map<std::string, const TensorrtInputProfile*> sorted_profile;
+    for (const auto& input : profile) {
+      sorted_profile[input.first] = &input.second;
+    }
+    for (const auto& input : sorted_profile) {
+      values.insert(values.end(), input.first.begin(), input.first.end());
+      for (const auto* dims : {&input.second->min_dims, &input.second->opt_dims, &input.second->max_dims}) {
+        for (auto dim : *dims) {
+          values.push_back(static_cast<int>(dim));
+        }
+      }
+    }
+    values.push_back(-1);
+  }
+  return GetVecHash(values);
+}
+
+// The shape ranges learned at run time are saved next to the cached engines, one "<input>\t<dim> <min> <max>" line
+// per range, so later processes build or load the engine for them before the first run.
+std::string GetShapeRangesPath(const std::string& root, const std::string& name) {
+  if (root.empty()) {
+    return name + ".profile";
+  }
+  fs::path path = root;
+  path.append(name + ".profile");
+  return path.string();
+}
+
+void SaveShapeRanges(const std::string& path, const TensorrtShapeRanges& ranges) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  for (const auto& input : ranges) {
+    for (const auto& dim_range : input.second) {
+      file << input.first << '\t' << dim_range.first << ' ' << dim_range.second.first << ' '
+           << dim_range.second.second << '\n';
+    }
+  }
+  if (!file) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Failed to save the shape ranges to " << path;
+  }
+}
+
+// Loads the ranges saved for <network> if they cover the same dynamic inputs and dims as <ranges>.
+bool LoadShapeRanges(const std::string& path, const nvinfer1::INetworkDefinition& network, TensorrtShapeRanges& ranges) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+
+  TensorrtShapeRanges loaded;
+  std::string line;
+  while (std::getline(file, line)) {
+    auto tab = line.find('\t');
+    int dim = 0;
+    int64_t min_value = 0, max_value = 0;
+    std::istringstream values(tab == std::string::npos ? std::string() : line.substr(tab + 1));
+    if (!(values >> dim >> min_value >> max_value) || min_value > max_value) {
+      LOGS_DEFAULT(WARNING) << "[TensorRT EP] Ignoring the invalid shape ranges in " << path;
+      return false;
+    }
+    loaded[line.substr(0, tab)][dim] = std::make_pair(min_value, max_value);
+  }
+
+  if (loaded.size() != ranges.size()) {
+    return false;
+  }
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    const auto* input = network.getInput(i);
+    auto it = ranges.find(input->getName());
+    if (it == ranges.end()) {
+      continue;
+    }
+    auto loaded_it = loaded.find(input->getName());
+    if (loaded_it == loaded.end()) {
+      return false;
+    }
+    // the values of a shape tensor can have any size, the dynamic dims of a tensor must be the same
+    if (!input->isShapeTensor()) {
+      if (loaded_it->second.size() != it->second.size()) {
+        return false;
+      }
+      for (const auto& dim_range : it->second) {
+        if (loaded_it->second.count(dim_range.first) == 0) {
+          return false;
+        }
+      }
+    }
+  }
+
+  ranges = std::move(loaded);
+  return true;
+}
+
+// Reads the dynamic ranges of a calibration table, written either by the quantization tools as
+// "<tensor>\t<min> <max>" lines or by TensorRT as "<tensor>: <scale>" lines with the scale as the hex of a float.
+std::unordered_map<std::string, float> ReadCalibrationTable(const std::string& path, std::string& table_id) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Failed to open the INT8 calibration table " + path);
+  }
+
+  std::unordered_map<std::string, float> dynamic_ranges;
+  std::string content;
+  std::string line;
+  if (!std::getline(file, line)) {
+    throw std::runtime_error("The INT8 calibration table " + path + " is empty");
+  }
+  const bool native_table = line.compare(0, 4, "TRT-") == 0;
+  if (!native_table && line != "onnxruntime_tensorrt_calibration_table 1") {
+    throw std::runtime_error(path + " is not an INT8 calibration table");
+  }
+  content += line;
+
+  size_t line_number = 1;
+  while (std::getline(file, line)) {
+    ++line_number;
+    content += '\n' + line;
+    if (line.empty()) {
+      continue;
+    }
+
+    std::string name;
+    float dynamic_range = 0.f;
+    bool valid = false;
+    if (native_table) {
+      auto separator = line.rfind(": ");
+      if (separator != std::string::npos) {
+        name = line.substr(0, separator);
+        char* end = nullptr;
+        const std::string hex = line.substr(separator + 2);
+        const uint32_t bits = static_cast<uint32_t>(std::strtoul(hex.c_str(), &end, 16));
+        float scale = 0.f;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        // A tensor quantized with <scale> covers [-127 * scale, 127 * scale]
+        dynamic_range = scale * 127.f;
+        valid = end != hex.c_str() && *end == '\0';
+      }
+    } else {
+      auto tab = line.find('\t');
+      if (tab != std::string::npos) {
+        name = line.substr(0, tab);
+        float rmin = 0.f, rmax = 0.f;
+        std::istringstream values(line.substr(tab + 1));
+        valid = static_cast<bool>(values >> rmin >> rmax) && rmin <= rmax;
+        dynamic_range = std::max(std::abs(rmin), std::abs(rmax));
+      }
+    }
+    if (!valid || name.empty() || !std::isfinite(dynamic_range)) {
+      throw std::runtime_error("Invalid entry at line " + std::to_string(line_number) + " of the INT8 calibration table " + path);
+    }
+    dynamic_ranges[name] = dynamic_range;
+  }
+
+  table_id = std::to_string(std::hash<std::string>()(content));
+  return dynamic_ranges;
+}
+
+// Sets the dynamic ranges of the tensors of <network> for INT8 mode.
+void SetDynamicRanges(nvinfer1::INetworkDefinition& network, const std::unordered_map<std::string, float>& dynamic_ranges,
+                      const std::string& node_name) {
+  std::vector<nvinfer1::ITensor*> tensors;
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    tensors.push_back(network.getInput(i));
+  }
+  for (int i = 0, end = network.getNbLayers(); i < end; ++i) {
+    auto* layer = network.getLayer(i);
+    for (int j = 0, end_j = layer->getNbOutputs(); j < end_j; ++j) {
+      tensors.push_back(layer->getOutput(j));
+    }
+  }
+
+  std::vector<std::string> missing;
+  for (auto* tensor : tensors) {
+    auto it = dynamic_ranges.find(tensor->getName());
+    if (it == dynamic_ranges.end()) {
+      missing.push_back(tensor->getName());
+    } else if (!tensor->setDynamicRange(-it->second, it->second)) {
+      missing.push_back(tensor->getName());
+    }
+  }
+  if (!missing.empty()) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] The INT8 calibration table has no dynamic range for " << missing.size()
+                          << " tensors of fused node " << node_name << ", e.g. " << missing[0]
+                          << ". TensorRT can't run the layers using them in INT8.";
+  }
+}
+
+// Deserializes the engine cached at <cached_path> if the engine cache has it. Otherwise builds the engine
+// and adds it to the cache if the cache is enabled.
+Status LoadOrBuildEngine(nvinfer1::IBuilder& builder, nvinfer1::INetworkDefinition& network,
+                         nvinfer1::IBuilderConfig& config, nvinfer1::IRuntime* runtime, bool engine_cache_enable,
+                         const std::string& cached_path, const std::string& node_name,
+                         tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>& engine) {
+  std::ifstream plan_file(cached_path, std::ios::binary | std::ios::in);
+  if (plan_file && engine_cache_enable) {
+    plan_file.seekg(0, std::ios::end);
+    int engine_size = plan_file.tellg();
+    plan_file.seekg(0, std::ios::beg);
+    std::unique_ptr<char[]> engine_buf{new char[engine_size]};
+    plan_file.read((char*)engine_buf.get(), engine_size);
+    engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(runtime->deserializeCudaEngine(engine_buf.get(), engine_size, nullptr));
+    if (engine != nullptr) {
+      LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] DeSerialized " + cached_path;
+      return Status::OK();
+    }
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Failed to deserialize " + cached_path + ", building the engine again";
+  }
+
+  engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(builder.buildEngineWithConfig(network, config));
+  if (engine == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP could not build engine for fused node: " + node_name);
+  }
+  if (engine_cache_enable) {
+    nvinfer1::IHostMemory* serializedModel = engine->serialize();
+    std::ofstream file(cached_path, std::ios::binary | std::ios::out);
+    file.write(reinterpret_cast<char*>(serializedModel->data()), serializedModel->size());
+    serializedModel->destroy();
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + cached_path;
+  }
+  return Status::OK();
+}
+
+// Creates the execution context of an engine. With a shared context memory, the context gets no device memory of its
+// own: the buffer grows to the size the engine needs, and compute_func sets it on the context before each enqueue.
+Status CreateExecutionContext(nvinfer1::ICudaEngine& engine, TensorrtContextMemory* context_memory,
+                              tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>& context) {
+  if (context_memory == nullptr) {
+    context = tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>(engine.createExecutionContext());
+    return Status::OK();
+  }
+
+  const size_t size = engine.getDeviceMemorySize();
+  if (size > context_memory->size) {
+    if (context_memory->buffer != nullptr) {
+      // engines enqueued earlier may still be running in the buffer
+      CUDA_RETURN_IF_ERROR(cudaDeviceSynchronize());
+      context_memory->allocator->Free(context_memory->buffer);
+      context_memory->buffer = nullptr;
+      context_memory->size = 0;
+    }
+    context_memory->buffer = context_memory->allocator->Alloc(size);
+    if (context_memory->buffer == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to allocate ", size,
+                             " bytes of execution context memory.");
+    }
+    context_memory->size = size;
+    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Shared execution context memory grown to " << size << " bytes";
+  }
+  context = tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>(
+      engine.createExecutionContextWithoutDeviceMemory());
+  return Status::OK();
+}
+}  // namespace
+
 TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProviderInfo& info)
     : Provider_IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
@@ -204,6 +673,33 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     fp16_enable_ = (std::stoi(fp16_enable_env) == 0 ? false : true);
   }
 
+  const std::string int8_enable_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kINT8Enable);
+  if (!int8_enable_env.empty()) {
+    int8_enable_ = (std::stoi(int8_enable_env) == 0 ? false : true);
+  }
+
+  if (int8_enable_) {
+    // INT8 mode needs the dynamic ranges of the tensors, the EP doesn't calibrate models itself
+    const std::string calibration_table_path = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kINT8CalibrationTablePath);
+    if (calibration_table_path.empty()) {
+      throw std::runtime_error(tensorrt_env_vars::kINT8Enable + " requires " + tensorrt_env_vars::kINT8CalibrationTablePath);
+    }
+    dynamic_ranges_ = ReadCalibrationTable(calibration_table_path, calibration_table_id_);
+  }
+
+  const std::string context_memory_sharing_enable_env =
+      onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kContextMemorySharingEnable);
+  if (!context_memory_sharing_enable_env.empty()) {
+    context_memory_sharing_enable_ = (std::stoi(context_memory_sharing_enable_env) == 0 ? false : true);
+  }
+  context_memory_.allocator = allocator_;
+
+  const std::string contrib_ops_plugins_enable_env =
+      onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kContribOpsPluginsEnable);
+  if (contrib_ops_plugins_enable_env.empty() || std::stoi(contrib_ops_plugins_enable_env) != 0) {
+    RegisterTensorrtContribOpPlugins();
+  }
+
   const std::string dump_subgraphs_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kDumpSubgraphs);
   if (!dump_subgraphs_env.empty()) {
     dump_subgraphs_ = (std::stoi(dump_subgraphs_env) == 0 ? false : true);
@@ -223,9 +719,17 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     }
     runtime_ = nvinfer1::createInferRuntime(GetTensorrtLogger());
   }
+
+  declared_profiles_ = GetDeclaredProfiles(onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kProfileMinShapes),
+                                           onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kProfileOptShapes),
+                                           onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kProfileMaxShapes));
 }
 
-TensorrtExecutionProvider::~TensorrtExecutionProvider() {}
+TensorrtExecutionProvider::~TensorrtExecutionProvider() {
+  if (context_memory_.buffer != nullptr) {
+    context_memory_.allocator->Free(context_memory_.buffer);
+  }
+}
 
 Provider_AllocatorPtr TensorrtExecutionProvider::Provider_GetAllocator(int id, OrtMemType mem_type) const {
   if (mem_type == OrtMemTypeDefault) {
@@ -757,7 +1261,7 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
     int num_inputs = trt_network->getNbInputs();
     int num_outputs = trt_network->getNbOutputs();
     std::unordered_map<std::string, int> input_indexes(num_inputs);
-    std::unordered_map<std::string, std::unordered_map<int, std::pair<int64_t, int64_t>>> input_shape_ranges;
+    TensorrtShapeRanges input_shape_ranges;
     std::unordered_map<std::string, int> output_indexes(num_outputs);
     std::unordered_map<std::string, int> output_types(num_outputs);
 
@@ -793,38 +1297,46 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
       trt_node_name_with_precision += "_fp16";
       LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] FP16 mode is enabled.";
     }
+    if (int8_enable_ && trt_builder->platformHasFastInt8()) {
+      trt_config->setFlag(nvinfer1::BuilderFlag::kINT8);
+      SetDynamicRanges(*trt_network, dynamic_ranges_, fused_node->Name());
+      // a different calibration table gives a different engine
+      trt_node_name_with_precision += "_int8_" + calibration_table_id_;
+      LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] INT8 mode is enabled.";
+    }
 
-    // Build TRT engine here if the graph doesn't have dynamic shape input. Otherwise engine will
-    // be built at runtime
+    // Build TRT engine here if the graph doesn't have dynamic shape input, or if its shape ranges are known:
+    // declared with the optimization profiles, or learned by an earlier run whose engine was cached.
+    // Otherwise engine will be built at runtime
     tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine> trt_engine;
     tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext> trt_context;
+    std::vector<TensorrtProfile> profiles;
+    if (has_dynamic_shape) {
+      ORT_RETURN_IF_ERROR(GetSubgraphProfiles(*trt_network, declared_profiles_, fused_node->Name(), profiles));
+    }
+    std::string cached_path;
     if (!has_dynamic_shape) {
-      std::string trt_node_name_with_precision_shape = trt_node_name_with_precision + "_" + GetVecHash(input_shapes);
-      std::string cached_path = GetEnginePath(engine_cache_path_, trt_node_name_with_precision_shape);
-      std::ifstream plan_file(cached_path, std::ios::binary | std::ios::in);
-      if (plan_file && engine_cache_enable_) {
-        plan_file.seekg(0, std::ios::end);
-        int engine_size = plan_file.tellg();
-        plan_file.seekg(0, std::ios::beg);
-        std::unique_ptr<char[]> engine_buf{new char[engine_size]};
-        plan_file.read((char*)engine_buf.get(), engine_size);
-        trt_engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(runtime_->deserializeCudaEngine(engine_buf.get(), engine_size, nullptr));
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] DeSerialized " + cached_path;
-      } else {
-        trt_engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildEngineWithConfig(*trt_network, *trt_config));
-        if (trt_engine == nullptr) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                 "TensorRT EP could not build engine for fused node: " + fused_node->Name());
-        }
-        if (engine_cache_enable_) {
-          nvinfer1::IHostMemory* serializedModel = trt_engine->serialize();
-          std::ofstream file(cached_path, std::ios::binary | std::ios::out);
-          file.write(reinterpret_cast<char*>(serializedModel->data()), serializedModel->size());
-          serializedModel->destroy();
-          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + cached_path;
-        }
+      cached_path = GetEnginePath(engine_cache_path_, trt_node_name_with_precision + "_" + GetVecHash(input_shapes));
+    } else if (!profiles.empty()) {
+      // The engine has a profile per set of declared shapes, which compute_func picks from
+      for (const auto& profile : profiles) {
+        trt_config->addOptimizationProfile(CreateDeclaredProfile(*trt_builder, profile));
       }
-      trt_context = tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>(trt_engine->createExecutionContext());
+      cached_path = GetEnginePath(engine_cache_path_, trt_node_name_with_precision + "_" + GetProfilesHash(profiles));
+      input_shape_ranges.clear();
+    } else if (engine_cache_enable_ &&
+               LoadShapeRanges(GetShapeRangesPath(engine_cache_path_, trt_node_name_with_precision), *trt_network,
+                               input_shape_ranges)) {
+      trt_config->addOptimizationProfile(CreateProfileFromRanges(*trt_builder, *trt_network, input_shape_ranges));
+      cached_path = GetEnginePath(engine_cache_path_,
+                                  trt_node_name_with_precision + "_" + GetShapeRangesHash(input_shape_ranges));
+    }
+    if (!cached_path.empty()) {
+      ORT_RETURN_IF_ERROR(LoadOrBuildEngine(*trt_builder, *trt_network, *trt_config, runtime_, engine_cache_enable_,
+                                            cached_path, fused_node->Name(), trt_engine));
+      ORT_RETURN_IF_ERROR(CreateExecutionContext(*trt_engine,
+                                                 context_memory_sharing_enable_ ? &context_memory_ : nullptr,
+                                                 trt_context));
       if (trt_context == nullptr) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
                                "TensorRT EP could not build execution context for fused node: " + fused_node->Name());
@@ -863,6 +1375,7 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
     output_info_[fused_node->Name()].push_back(output_indexes);
     output_info_[fused_node->Name()].push_back(output_types);
     input_shape_ranges_[fused_node->Name()] = input_shape_ranges;
+    profiles_[fused_node->Name()] = std::move(profiles);
 
     // Create function state
     // TODO: remove default capture
@@ -873,7 +1386,9 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
             &engines_[context->node_name], &contexts_[context->node_name], builders_[context->node_name].get(),
             networks_[context->node_name].get(), input_info_[context->node_name], output_info_[context->node_name],
             input_shape_ranges_[context->node_name], &tensorrt_mu_, &fp16_enable_,
-            &max_workspace_size_, trt_node_name_with_precision, engine_cache_enable_, engine_cache_path_, runtime_};
+            &max_workspace_size_, trt_node_name_with_precision, engine_cache_enable_, engine_cache_path_, runtime_,
+            profiles_[context->node_name], int8_enable_,
+            context_memory_sharing_enable_ ? &context_memory_ : nullptr};
       *state = p.release();
       return 0;
     };
@@ -903,6 +1418,49 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
       std::unordered_map<std::string, std::vector<int32_t>> tensor_shape_values;
       nvinfer1::IOptimizationProfile* trt_profile = nullptr;
       std::vector<int> input_shapes;
+
+      // With declared optimization profiles the engine has one profile per set of declared shapes, so the context is
+      // switched to the first one covering the input shapes instead of rebuilding the engine
+      const auto& profiles = trt_state->profiles;
+      int profile_index = 0;
+      if (!profiles.empty()) {
+        profile_index = -1;
+        std::unordered_map<std::string, std::vector<int64_t>> declared_input_shapes;
+        for (const auto& input : profiles[0]) {
+          int input_index = 0;
+          const auto& iter = input_indexes.find(input.first);
+          if (iter != input_indexes.end()) {
+            input_index = iter->second;
+          }
+          const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+          auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+          declared_input_shapes[input.first] = ort.GetTensorShape(tensor_info);
+          ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+        }
+
+        for (int k = 0, end = static_cast<int>(profiles.size()); k < end && profile_index == -1; ++k) {
+          bool covered = true;
+          for (const auto& input : profiles[k]) {
+            const auto& tensor_shapes = declared_input_shapes[input.first];
+            covered = covered && tensor_shapes.size() == input.second.min_dims.size();
+            for (size_t j = 0; covered && j < tensor_shapes.size(); ++j) {
+              covered = tensor_shapes[j] >= input.second.min_dims[j] && tensor_shapes[j] <= input.second.max_dims[j];
+            }
+          }
+          if (covered) {
+            profile_index = k;
+          }
+        }
+        if (profile_index == -1) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP input shapes of fused node ",
+                                 trt_state->trt_node_name_with_precision, " are outside of the optimization profiles set with ",
+                                 tensorrt_env_vars::kProfileMinShapes, " and ", tensorrt_env_vars::kProfileMaxShapes);
+        }
+        if (trt_context->getOptimizationProfile() != profile_index && !trt_context->setOptimizationProfile(profile_index)) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to set optimization profile ", profile_index);
+        }
+      }
+
       for (int i = 0, end = num_inputs; i < end; ++i) {
         auto input = trt_state->network->getInput(i);
         const std::string& input_name = input->getName();
@@ -1046,7 +1604,7 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
       // Regenerate engine
       // Only one profile is generated, so no need to explicitly set optimization profile
       if (engine_update) {
-        std::string trt_node_name_with_precision_shape = trt_state->trt_node_name_with_precision + "_" + GetVecHash(input_shapes);
+        std::string trt_node_name_with_precision_shape = trt_state->trt_node_name_with_precision + "_" + GetShapeRangesHash(shape_ranges);
         std::string cached_path = GetEnginePath(trt_state->engine_cache_path, trt_node_name_with_precision_shape);
         std::ifstream plan_file(cached_path, std::ios::binary | std::ios::in);
         trt_state->context->reset();
@@ -1072,6 +1630,9 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
           if (*(trt_state->fp16_enable_ptr) && trt_builder->platformHasFastFp16()) {
             trt_config->setFlag(nvinfer1::BuilderFlag::kFP16);
           }
+          if (trt_state->int8_enable && trt_builder->platformHasFastInt8()) {
+            trt_config->setFlag(nvinfer1::BuilderFlag::kINT8);
+          }
           *(trt_state->engine) = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(
               trt_builder->buildEngineWithConfig(*trt_state->network, *trt_config));
 
@@ -1085,10 +1646,12 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
             file.write(reinterpret_cast<char*>(serializedModel->data()), serializedModel->size());
             serializedModel->destroy();
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + cached_path;
+            SaveShapeRanges(GetShapeRangesPath(trt_state->engine_cache_path, trt_state->trt_node_name_with_precision),
+                            shape_ranges);
           }
         }
-        *(trt_state->context) = tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>(
-            trt_state->engine->get()->createExecutionContext());
+        ORT_RETURN_IF_ERROR(CreateExecutionContext(*trt_state->engine->get(), trt_state->context_memory,
+                                                   *(trt_state->context)));
         if (trt_state->context->get() == nullptr) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to create context.");
         }
@@ -1096,10 +1659,14 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
       }
 
       // Get input and output binding names
+      // The bindings are repeated for each optimization profile, the ones of profile k are offset by
+      // k * bindings_per_profile
       int total_bindings = trt_engine->getNbBindings();
+      int bindings_per_profile = total_bindings / trt_engine->getNbOptimizationProfiles();
+      int binding_offset = profile_index * bindings_per_profile;
       std::vector<void*> buffers(total_bindings);
       std::vector<std::string> input_binding_names, output_binding_names;
-      for (int i = 0, end = total_bindings; i < end; ++i) {
+      for (int i = 0, end = bindings_per_profile; i < end; ++i) {
         if (trt_engine->bindingIsInput(i)) {
           input_binding_names.push_back(trt_engine->getBindingName(i));
         } else {
@@ -1115,6 +1682,7 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
         if (binding_index == -1) {
           continue;
         }
+        binding_index += binding_offset;
 
         int input_index = 0;
         const auto& iter = input_indexes.find(input_name);
@@ -1230,6 +1798,7 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
         if (binding_index == -1) {
           continue;
         }
+        binding_index += binding_offset;
 
         int output_index = 0;
         const auto& index_iter = output_indexes.find(output_name);
@@ -1331,6 +1900,10 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
       }
 
       // Run TRT inference
+      if (trt_state->context_memory != nullptr) {
+        // the buffer may have been reallocated for a larger engine since the last run
+        trt_context->setDeviceMemory(trt_state->context_memory->buffer);
+      }
       if (!trt_context->enqueueV2(&buffers[0], nullptr, nullptr)) {
         for (const auto& binding_index : binding_buffers_to_freeup) {
           cudaFree(buffers[binding_index]);
@@ -1342,7 +1915,7 @@ common::Status TensorrtExecutionProvider::Provider_Compile(const std::vector<onn
       // Cast INT64 input to INT32 because TensorRT doesn't fully support INT64
       for (int i = 0, end = output_binding_names.size(); i < end; ++i) {
         const std::string& output_name = output_binding_names[i];
-        size_t binding_index = trt_engine->getBindingIndex(output_name.c_str());
+        size_t binding_index = trt_engine->getBindingIndex(output_name.c_str()) + binding_offset;
         int output_type = 0;
         const auto& iter = output_types.find(output_name);
         if (iter != output_types.end()) {
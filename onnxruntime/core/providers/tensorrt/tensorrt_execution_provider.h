@@ -17,6 +17,20 @@ static const std::string kFP16Enable = "ORT_TENSORRT_FP16_ENABLE";
 static const std::string kDumpSubgraphs = "ORT_TENSORRT_DUMP_SUBGRAPHS";
 static const std::string kEngineCacheEnable = "ORT_TENSORRT_ENGINE_CACHE_ENABLE";
 static const std::string kEngineCachePath = "ORT_TENSORRT_ENGINE_CACHE_PATH";
+// Optimization profiles of the dynamic inputs, as comma separated <input name>:<dims> entries with the dims
+// separated by 'x', e.g. "input_ids:1x16,attention_mask:1x16". An input listed several times gets one profile
+// per entry, in order. The three variables must list the same entries.
+static const std::string kProfileMinShapes = "ORT_TENSORRT_PROFILE_MIN_SHAPES";
+static const std::string kProfileOptShapes = "ORT_TENSORRT_PROFILE_OPT_SHAPES";
+static const std::string kProfileMaxShapes = "ORT_TENSORRT_PROFILE_MAX_SHAPES";
+static const std::string kINT8Enable = "ORT_TENSORRT_INT8_ENABLE";
+// Calibration table giving the dynamic ranges of the tensors in INT8 mode: either written by
+// onnxruntime.quantization.calibrate.write_calibration_table or a calibration cache written by TensorRT.
+static const std::string kINT8CalibrationTablePath = "ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH";
+// Set to 0 not to run FastGelu and SkipLayerNormalization in the engines as plugins backed by their CUDA kernels.
+static const std::string kContribOpsPluginsEnable = "ORT_TENSORRT_CONTRIB_OPS_PLUGINS_ENABLE";
+// Set to 1 for the execution contexts of all the engines to share one device memory buffer.
+static const std::string kContextMemorySharingEnable = "ORT_TENSORRT_CONTEXT_MEMORY_SHARING_ENABLE";
 }  // namespace tensorrt_env_vars
 
 class TensorrtLogger : public nvinfer1::ILogger {
@@ -56,6 +70,27 @@ template <typename T>
 using unique_pointer = std::unique_ptr<T, TensorrtInferDeleter>;
 };  // namespace tensorrt_ptr
 
+// Dims of an input in an optimization profile.
+struct TensorrtInputProfile {
+  std::vector<int64_t> min_dims;
+  std::vector<int64_t> opt_dims;
+  std::vector<int64_t> max_dims;
+};
+
+// Optimization profile, from input name to its dims.
+using TensorrtProfile = std::unordered_map<std::string, TensorrtInputProfile>;
+
+// Range of the values seen for the dynamic dims (or the shape values of shape tensors) of each input.
+using TensorrtShapeRanges = std::unordered_map<std::string, std::unordered_map<int, std::pair<int64_t, int64_t>>>;
+
+// Device memory shared by the execution contexts of the engines of a provider, sized for the largest of them.
+// The engines run one at a time on the same stream, so they never use it concurrently.
+struct TensorrtContextMemory {
+  Provider_AllocatorPtr allocator;
+  void* buffer = nullptr;
+  size_t size = 0;
+};
+
 // Information needed to construct trt execution providers.
 struct TensorrtExecutionProviderInfo {
   int device_id{0};
@@ -73,7 +108,7 @@ struct TensorrtFuncState {
   nvinfer1::INetworkDefinition* network = nullptr;
   std::vector<std::unordered_map<std::string, int>> input_info;
   std::vector<std::unordered_map<std::string, int>> output_info;
-  std::unordered_map<std::string, std::unordered_map<int, std::pair<int64_t, int64_t>>> input_shape_ranges;
+  TensorrtShapeRanges input_shape_ranges;
   OrtMutex* tensorrt_mu_ptr = nullptr;
   bool* fp16_enable_ptr = nullptr;
   size_t* max_workspace_size_ptr = nullptr;
@@ -81,6 +116,12 @@ struct TensorrtFuncState {
   bool engine_cache_enable;
   std::string engine_cache_path;
   nvinfer1::IRuntime* runtime = nullptr;
+  // declared optimization profiles the engine was built with, in which case input_shape_ranges is empty
+  // as the engine is never rebuilt
+  std::vector<TensorrtProfile> profiles;
+  bool int8_enable = false;
+  // memory shared by the execution contexts, nullptr if each context has its own
+  TensorrtContextMemory* context_memory = nullptr;
 };
 
 // Logical device representation.
@@ -108,10 +149,16 @@ class TensorrtExecutionProvider : public Provider_IExecutionProvider {
   int max_partition_iterations_ = 1000;
   int min_subgraph_size_ = 1;
   bool fp16_enable_ = false;
+  bool int8_enable_ = false;
+  // dynamic range of each tensor in the INT8 calibration table, and an id of the table for the engine names
+  std::unordered_map<std::string, float> dynamic_ranges_;
+  std::string calibration_table_id_;
   bool dump_subgraphs_ = false;
   bool engine_cache_enable_ = false;
   std::string engine_cache_path_;
   nvinfer1::IRuntime* runtime_ = nullptr;
+  bool context_memory_sharing_enable_ = false;
+  TensorrtContextMemory context_memory_;
 
   OrtMutex tensorrt_mu_;
   int device_id_;
@@ -122,7 +169,10 @@ class TensorrtExecutionProvider : public Provider_IExecutionProvider {
   std::unordered_map<std::string, tensorrt_ptr::unique_pointer<nvinfer1::INetworkDefinition>> networks_;
   std::unordered_map<std::string, std::vector<std::unordered_map<std::string, int>>> input_info_;
   std::unordered_map<std::string, std::vector<std::unordered_map<std::string, int>>> output_info_;
-  std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_map<int, std::pair<int64_t, int64_t>>>> input_shape_ranges_;
+  std::unordered_map<std::string, TensorrtShapeRanges> input_shape_ranges_;
+  // optimization profiles declared with the ORT_TENSORRT_PROFILE_*_SHAPES environment variables
+  std::vector<TensorrtProfile> declared_profiles_;
+  std::unordered_map<std::string, std::vector<TensorrtProfile>> profiles_;
 
   /**Get IndexedSubGraph based on node list of the subgraph*/
   std::unique_ptr<Provider_IndexedSubGraph> GetSubGraph(SubGraph_t graph_nodes_index, int& kernels_index,
@@ -19,15 +19,24 @@ static std::pair<bool, size_t> Contains(const std::vector<std::string>& names, c
   return {true, it - std::begin(names)};
 }
 
+// the device a value bound for a feed or a fetch is at. fetches that aren't pre-allocated are at the bound device.
+static OrtDevice BoundDevice(const OrtValue& value, OrtDevice device = {}) {
+  return value.IsAllocated() && value.IsTensor() ? value.Get<Tensor>().Location().device : device;
+}
+
 common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_value) {
   auto rc = Contains(feed_names_, name);
 
   auto add_or_replace = [this, &name](const bool exists, size_t index, const OrtValue& value) {
     if (exists) {
+      if (BoundDevice(feeds_[index]) != BoundDevice(value)) {
+        feeds_fetches_manager_.reset();
+      }
       feeds_[index] = value;
     } else {
       feed_names_.push_back(name);
       feeds_.push_back(value);
+      feeds_fetches_manager_.reset();
     }
   };
 
@@ -45,6 +54,7 @@ common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_
 void IOBinding::ClearInputs() {
   feed_names_.clear();
   feeds_.clear();
+  feeds_fetches_manager_.reset();
 }
 
 static common::Status SyncProviders(const SessionState::NameNodeInfoMapType& node_info_map,
@@ -90,12 +100,16 @@ common::Status IOBinding::BindOutput(const std::string& name, OrtDevice device)
 common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device) {
   auto rc = Contains(output_names_, name);
   if (rc.first) {
+    if (BoundDevice(outputs_[rc.second], outputs_device_info_[rc.second]) != BoundDevice(ml_value, device)) {
+      feeds_fetches_manager_.reset();
+    }
     outputs_[rc.second] = ml_value;
     outputs_device_info_[rc.second] = device;
   } else {
     output_names_.push_back(name);
     outputs_.push_back(ml_value);
     outputs_device_info_.push_back(device);
+    feeds_fetches_manager_.reset();
   }
 
   return Status::OK();
@@ -105,6 +119,7 @@ void IOBinding::ClearOutputs() {
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
+  feeds_fetches_manager_.reset();
 }
 
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
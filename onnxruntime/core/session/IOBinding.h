@@ -7,6 +7,7 @@
 #include <unordered_map>
 
 #include "core/framework/execution_provider.h"
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/common/status.h"
 #include "core/graph/basic_types.h"
 #include "core/framework/ml_value.h"
@@ -104,6 +105,10 @@ class IOBinding {
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
 
+  // feed/fetch info and device copy info computed by the first Run with the current names, reused by later Runs.
+  // reset when the names change or a value is bound from/to a different device.
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
   // device info for all outputs. only used by InferenceSession if the output is not pre-allocated.
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batch_utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/ml_value.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace batch_utils {
+
+// the rows [begin, end) of the first dimension of tensor, on its buffer
+static OrtValue SliceRows(const Tensor& tensor, int64_t begin, int64_t end) {
+  const auto& shape = tensor.Shape();
+  const size_t row_size = static_cast<size_t>(shape.SizeFromDimension(1)) * tensor.DataType()->Size();
+  std::vector<int64_t> dims = shape.GetDims();
+  dims[0] = end - begin;
+
+  void* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw())) + begin * row_size;
+  auto slice = onnxruntime::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+  OrtValue value;
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  value.Init(slice.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return value;
+}
+
+// concatenates the CPU tensors in parts along their first dimension
+static common::Status ConcatRows(const std::vector<const Tensor*>& parts, const AllocatorPtr& allocator,
+                                 OrtValue& output) {
+  const Tensor& first = *parts[0];
+  std::vector<int64_t> dims = first.Shape().GetDims();
+  if (dims.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Outputs of a split batch must have a batch dimension.");
+  }
+
+  dims[0] = 0;
+  for (const Tensor* part : parts) {
+    const auto& part_dims = part->Shape().GetDims();
+    if (part->DataType() != first.DataType() || part_dims.size() != dims.size() ||
+        !std::equal(part_dims.begin() + 1, part_dims.end(), dims.begin() + 1)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The outputs of the parts of a split batch have different shapes: ",
+                             first.Shape(), " and ", part->Shape());
+    }
+    if (strcmp(part->Location().name, CPU) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The outputs of a split batch must be on the CPU.");
+    }
+    dims[0] += part_dims[0];
+  }
+
+  auto result = onnxruntime::make_unique<Tensor>(first.DataType(), TensorShape(dims), allocator);
+  if (first.IsDataTypeString()) {
+    std::string* dst = result->MutableData<std::string>();
+    for (const Tensor* part : parts) {
+      dst = std::copy(part->Data<std::string>(), part->Data<std::string>() + part->Shape().Size(), dst);
+    }
+  } else {
+    char* dst = static_cast<char*>(result->MutableDataRaw());
+    for (const Tensor* part : parts) {
+      memcpy(dst, part->DataRaw(), part->SizeInBytes());
+      dst += part->SizeInBytes();
+    }
+  }
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  output.Init(result.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
+common::Status SplitBatch(const NameMLValMap& feeds, size_t max_parts, std::vector<NameMLValMap>& parts) {
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Feed ", feed.first, " of a split batch isn't a tensor.");
+    }
+    const Tensor& tensor = feed.second.Get<Tensor>();
+    if (strcmp(tensor.Location().name, CPU) != 0 || tensor.Shape().NumDimensions() == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Feed ", feed.first,
+                             " of a split batch must be a CPU tensor with a batch dimension.");
+    }
+    if (batch_size != -1 && tensor.Shape()[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The feeds of a split batch have different batch sizes: ",
+                             batch_size, " and ", tensor.Shape()[0], " for ", feed.first);
+    }
+    batch_size = tensor.Shape()[0];
+  }
+
+  const int64_t num_parts = std::max<int64_t>(std::min(static_cast<int64_t>(max_parts), batch_size), 1);
+  parts.clear();
+  parts.resize(num_parts);
+  for (const auto& feed : feeds) {
+    const Tensor& tensor = feed.second.Get<Tensor>();
+    int64_t begin = 0;
+    for (int64_t part = 0; part < num_parts; ++part) {
+      const int64_t end = begin + batch_size / num_parts + (part < batch_size % num_parts ? 1 : 0);
+      parts[part][feed.first] = SliceRows(tensor, begin, end);
+      begin = end;
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status ConcatBatch(const std::vector<std::vector<OrtValue>>& part_fetches,
+                           const std::vector<std::string>& output_names, const AllocatorPtr& allocator,
+                           std::vector<OrtValue>& fetches) {
+  ORT_RETURN_IF_NOT(allocator != nullptr, "ConcatBatch requires a CPU allocator.");
+  fetches.clear();
+  fetches.resize(output_names.size());
+  std::vector<const Tensor*> parts(part_fetches.size());
+  for (size_t output = 0; output < output_names.size(); ++output) {
+    for (size_t part = 0; part < part_fetches.size(); ++part) {
+      ORT_RETURN_IF_NOT(output < part_fetches[part].size() && part_fetches[part][output].IsTensor(),
+                        "Output ", output_names[output], " isn't a tensor.");
+      parts[part] = &part_fetches[part][output].Get<Tensor>();
+    }
+    ORT_RETURN_IF_ERROR(ConcatRows(parts, allocator, fetches[output]));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace batch_utils
+}  // namespace onnxruntime
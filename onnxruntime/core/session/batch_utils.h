@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+
+namespace onnxruntime {
+namespace batch_utils {
+
+/**
+  * Splits the CPU tensors in feeds along their first dimension, which all of them must have the same size for, into
+  * up to max_parts parts of sizes differing by at most one. The parts are views of the buffers of feeds.
+  */
+common::Status SplitBatch(const NameMLValMap& feeds, size_t max_parts,
+                          std::vector<NameMLValMap>& parts) ORT_MUST_USE_RESULT;
+
+/**
+  * Concatenates the CPU tensors of each output in part_fetches, the fetches of each of the parts of SplitBatch,
+  * along their first dimension in tensors allocated with allocator.
+  */
+common::Status ConcatBatch(const std::vector<std::vector<OrtValue>>& part_fetches,
+                           const std::vector<std::string>& output_names, const AllocatorPtr& allocator,
+                           std::vector<OrtValue>& fetches) ORT_MUST_USE_RESULT;
+
+}  // namespace batch_utils
+}  // namespace onnxruntime
@@ -5,6 +5,9 @@
 #include "core/session/inference_session.h"
 #include "core/session/ort_env.h"
 #include "core/session/allocator_impl.h"
+#ifdef USE_CUDA
+#include "core/providers/cuda/cuda_allocator.h"
+#endif
 
 #ifndef ORT_NO_EXCEPTIONS
 
@@ -45,14 +48,28 @@ ORT_API_STATUS_IMPL(OrtApis::CreateAndRegisterAllocator, _Inout_ OrtEnv* env, _I
     return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "OrtMemoryInfo is null");
   }
 
-  // TODO should we allow sharing of non-CPU allocators?
+  // the device memory of the CUDA execution provider can be shared too
+  const bool is_cuda = mem_info->device.Type() == OrtDevice::GPU && strcmp(mem_info->name, onnxruntime::CUDA) == 0;
+#ifdef USE_CUDA
+  if (mem_info->device.Type() != OrtDevice::CPU && !is_cuda) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Only CPU and CUDA devices are supported for now.");
+  }
+#else
   if (mem_info->device.Type() != OrtDevice::CPU) {
-    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Only CPU devices are supported for now.");
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, is_cuda ? "This build does not support CUDA."
+                                                               : "Only CPU devices are supported for now.");
   }
+#endif
 
   // determine if arena should be used
   bool create_arena = mem_info->alloc_type == OrtArenaAllocator;
 
+  if (is_cuda) {
+    // the execution provider allocates from an arena, so only an arena can replace its allocator
+    if (!create_arena) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "CUDA allocators shared through the env must be arenas.");
+    }
+  } else {
 #ifdef USE_JEMALLOC
 #if defined(USE_MIMALLOC_ARENA_ALLOCATOR) || defined(USE_MIMALLOC_STL_ALLOCATOR)
 #error jemalloc and mimalloc should not both be enabled
@@ -63,6 +80,18 @@ ORT_API_STATUS_IMPL(OrtApis::CreateAndRegisterAllocator, _Inout_ OrtEnv* env, _I
   //Disable Arena allocator for x86_32 build because it may run into infinite loop when integer overflow happens
   create_arena = false;
 #endif
+  }
+
+  AllocatorFactory device_allocator_factory = [mem_info](OrtDevice::DeviceId) {
+    return onnxruntime::make_unique<TAllocator>(*mem_info);
+  };
+#ifdef USE_CUDA
+  if (is_cuda) {
+    device_allocator_factory = [](OrtDevice::DeviceId device_id) {
+      return onnxruntime::make_unique<CUDAAllocator>(device_id, CUDA);
+    };
+  }
+#endif
 
   AllocatorPtr allocator_ptr;
   // create appropriate DeviceAllocatorRegistrationInfo and allocator based on create_arena
@@ -91,8 +120,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateAndRegisterAllocator, _Inout_ OrtEnv* env, _I
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk};
     AllocatorCreationInfo alloc_creation_info{
-        [mem_info](int) { return onnxruntime::make_unique<TAllocator>(*mem_info); },
-        0,
+        device_allocator_factory,
+        static_cast<OrtDevice::DeviceId>(mem_info->id),
         create_arena,
         l_arena_cfg};
     allocator_ptr = CreateAllocator(alloc_creation_info);
@@ -4,6 +4,11 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -12,8 +17,10 @@
 #include <thread>
 
 #include "core/common/denormal.h"
+#include "core/common/path.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/capped_allocator.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -21,19 +28,25 @@
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/mldata_type_utils.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_memory_report.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/utils.h"
+#include "core/graph/graph_flatbuffers_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
+#include "core/optimizer/static_shape_specialization.h"
+#include "core/optimizer/utils.h"
 #include "core/platform/Barrier.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -93,6 +106,80 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// Compute the key a captured graph is stored under. A graph bakes in the device addresses of everything it touches,
+// so the key covers the type, shape and buffer address of every feed and fetch.
+// Returns false if the Run can't be captured, i.e. a feed or fetch is not a tensor, or the fetches were not
+// pre-allocated by the caller (e.g. via IOBinding) so their addresses would change between Runs.
+bool GetGraphCaptureKey(const std::vector<OrtValue>& feeds, const std::vector<OrtValue>& fetches,
+                        size_t num_outputs, uint64_t& graph_key) {
+  if (fetches.size() != num_outputs) {
+    return false;
+  }
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  auto hash_value = [&hash](const OrtValue& value) {
+    if (!value.IsAllocated() || !value.IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = value.Get<Tensor>();
+    const void* data = tensor.DataRaw();
+    const int32_t element_type = tensor.GetElementType();
+    const auto& dims = tensor.Shape().GetDims();
+    MurmurHash3::x86_128(&data, sizeof(data), hash[0], &hash);
+    MurmurHash3::x86_128(&element_type, sizeof(element_type), hash[0], &hash);
+    MurmurHash3::x86_128(dims.data(), gsl::narrow<int>(dims.size() * sizeof(int64_t)), hash[0], &hash);
+    return true;
+  };
+
+  for (const auto& feed : feeds) {
+    if (!hash_value(feed)) {
+      return false;
+    }
+  }
+
+  for (const auto& fetch : fetches) {
+    if (!hash_value(fetch)) {
+      return false;
+    }
+  }
+
+  graph_key = uint64_t(hash[0]) | (uint64_t(hash[1]) << 32);
+  return true;
+}
+
+// Starts reading the external data of the initializers of the graph and its subgraphs in the background.
+// Returns the number of initializers whose data is being prefetched.
+size_t PrefetchExternalData(const Graph& graph, const std::basic_string<ORTCHAR_T>& model_location,
+                            const logging::Logger& logger) {
+  size_t num_prefetched = 0;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    if (entry.second->data_location() != ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL) {
+      continue;
+    }
+
+    auto status = utils::PrefetchExternalData(Env::Default(), model_location.c_str(), *entry.second);
+    if (!status.IsOK()) {
+      // the data is read as usual when the session state is created
+      LOGS(logger, VERBOSE) << "Not prefetching the external data of " << entry.first << ": " << status.ErrorMessage();
+      if (status.Code() == common::NOT_IMPLEMENTED) {
+        return num_prefetched;
+      }
+      continue;
+    }
+
+    ++num_prefetched;
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      num_prefetched += PrefetchExternalData(*subgraph, model_location, logger);
+    }
+  }
+
+  return num_prefetched;
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -219,6 +306,47 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     });
   }
 
+  std::string numa_node_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaNode, "");
+  if (!numa_node_str.empty()) {
+    std::istringstream iss(numa_node_str);
+    int numa_node = -1;
+    ORT_ENFORCE((iss >> numa_node) && iss.eof() && numa_node >= 0, "Invalid value for ",
+                kOrtSessionOptionsConfigIntraOpNumaNode, ": ", numa_node_str);
+    session_options_.intra_op_param.numa_node = numa_node;
+  }
+
+  std::string placement_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpThreadPlacement, "");
+  if (!placement_str.empty()) {
+    ORT_ENFORCE(placement_str == "physical_cores" || placement_str == "performance_cores", "Invalid value for ",
+                kOrtSessionOptionsConfigIntraOpThreadPlacement, ": ", placement_str);
+    session_options_.intra_op_param.physical_cores_only = true;
+    session_options_.intra_op_param.performance_cores_only = placement_str == "performance_cores";
+  }
+
+  // the thread options copy the affinities, so they only need to outlive the creation of the thread pool
+  std::vector<size_t> intra_op_affinities;
+  std::string affinities_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpThreadAffinities, "");
+  if (!affinities_str.empty()) {
+    std::istringstream iss(affinities_str);
+    std::string processor_str;
+    while (std::getline(iss, processor_str, ',')) {
+      std::istringstream processor_iss(processor_str);
+      int64_t processor = -1;
+      ORT_ENFORCE((processor_iss >> processor) && processor_iss.eof() && processor >= 0, "Invalid value for ",
+                  kOrtSessionOptionsConfigIntraOpThreadAffinities, ": ", affinities_str);
+#ifdef _WIN32
+      // SetThreadAffinityMask takes a mask of the processors in the group of the thread
+      ORT_ENFORCE(processor < static_cast<int64_t>(sizeof(size_t) * 8), "Processor ", processor, " in ",
+                  kOrtSessionOptionsConfigIntraOpThreadAffinities, " is outside of the processor group");
+      intra_op_affinities.push_back(size_t{1} << processor);
+#else
+      intra_op_affinities.push_back(static_cast<size_t>(processor));
+#endif
+    }
+    ORT_ENFORCE(!intra_op_affinities.empty(), "Invalid value for ", kOrtSessionOptionsConfigIntraOpThreadAffinities,
+                ": ", affinities_str);
+  }
+
   use_per_session_threads_ = session_options.use_per_session_threads;
 
   if (use_per_session_threads_) {
@@ -229,6 +357,20 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.name = ORT_TSTR("intra-op");
       }
       to.set_denormal_as_zero = set_denormal_as_zero;
+      to.adaptive_spinning =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveSpinning, "0") == "1";
+      if (!intra_op_affinities.empty()) {
+        if (to.thread_pool_size <= 0) {
+          to.thread_pool_size = static_cast<int>(intra_op_affinities.size());
+        }
+        // one entry per thread
+        const size_t num_processors = intra_op_affinities.size();
+        for (size_t i = num_processors; i < static_cast<size_t>(to.thread_pool_size); ++i) {
+          intra_op_affinities.push_back(intra_op_affinities[i % num_processors]);
+        }
+        to.affinity_vec = intra_op_affinities.data();
+        to.affinity_vec_len = intra_op_affinities.size();
+      }
       // If the thread pool can use all the processors, then
       // we set affinity of each thread to each processor.
       to.auto_set_affinity = to.thread_pool_size == 0 &&
@@ -262,7 +404,17 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
   }
 
+  {
+    // the Runs of the sessions sharing the global thread pools get equal shares of their threads by default
+    std::string weight_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpThreadPoolWeight,
+                                                                 use_per_session_threads_ ? "0" : "1");
+    std::istringstream iss(weight_str);
+    ORT_ENFORCE((iss >> intra_op_thread_pool_weight_) && iss.eof() && intra_op_thread_pool_weight_ >= 0,
+                "Invalid value for ", kOrtSessionOptionsConfigIntraOpThreadPoolWeight, ": ", weight_str);
+  }
+
   session_profiler_.Initialize(session_logger_);
+  data_transfer_mgr_.SetProfiler(&session_profiler_);
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -347,6 +499,12 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  {
+    // the async Runs use the session state and the thread pools owned by this session
+    std::unique_lock<OrtMutex> lock(async_runs_mutex_);
+    async_runs_cv_.wait(lock, [this]() { return num_async_runs_ == 0; });
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -818,7 +976,14 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 #endif
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  GraphPartitionerOptions partitioner_options;
+  partitioner_options.use_cost_model =
+      session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigPartitioningCostModel, "0") == "1";
+  partitioner_options.load_placement_file =
+      session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigLoadPartitioningPlacement, "");
+  partitioner_options.save_placement_file =
+      session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigSavePartitioningPlacement, "");
+  GraphPartitioner partitioner(kernel_registry_manager, providers, partitioner_options);
   ORT_RETURN_IF_ERROR_SESSIONID_(partitioner.Partition(graph, session_state.ExportDll(),
                                                        session_state.GetMutableFuncMgr()));
 
@@ -890,15 +1055,29 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 template <typename T>
 static Status LoadOrtModelBytes(const std::basic_string<T>& model_uri,
                                 std::basic_string<ORTCHAR_T>& model_location,
-                                std::vector<uint8_t>& bytes) {
+                                bool map_file,
+                                gsl::span<const uint8_t>& bytes,
+                                std::vector<uint8_t>& bytes_data_holder,
+                                Env::MappedMemoryPtr& mapped_memory) {
   size_t num_bytes = 0;
   model_location = ToWideString(model_uri);
   ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_location.c_str(), num_bytes));
 
-  bytes.resize(num_bytes);
+  if (map_file) {
+    auto status = Env::Default().MapFileIntoMemory(model_location.c_str(), 0, num_bytes, mapped_memory);
+    if (status.IsOK() && mapped_memory) {
+      bytes = gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_memory.get()), num_bytes);
+      return Status::OK();
+    }
+
+    // fall back to reading the file, in which case the initializers will be copied
+    mapped_memory.reset();
+  }
+
+  bytes_data_holder.resize(num_bytes);
 
   std::ifstream bytes_stream(model_uri, std::ifstream::in | std::ifstream::binary);
-  bytes_stream.read(reinterpret_cast<char*>(bytes.data()), num_bytes);
+  bytes_stream.read(reinterpret_cast<char*>(bytes_data_holder.data()), num_bytes);
 
   if (!bytes_stream) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -906,13 +1085,18 @@ static Status LoadOrtModelBytes(const std::basic_string<T>& model_uri,
                            bytes_stream.gcount(), "/", num_bytes, " bytes were able to be read.");
   }
 
+  bytes = gsl::make_span(bytes_data_holder.data(), num_bytes);
+
   return Status::OK();
 }
 
 Status InferenceSession::LoadOrtModel(const std::string& model_uri) {
   return LoadOrtModel(
       [&]() {
-        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, ort_format_model_bytes_));
+        const bool map_file =
+            session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigMapOrtModelInitializers, "0") == "1";
+        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, map_file, ort_format_model_bytes_,
+                                              ort_format_model_bytes_data_holder_, ort_format_model_mapped_memory_));
         return Status::OK();
       });
 }
@@ -921,7 +1105,10 @@ Status InferenceSession::LoadOrtModel(const std::string& model_uri) {
 Status InferenceSession::LoadOrtModel(const std::wstring& model_uri) {
   return LoadOrtModel(
       [&]() {
-        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, ort_format_model_bytes_));
+        const bool map_file =
+            session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigMapOrtModelInitializers, "0") == "1";
+        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, model_location_, map_file, ort_format_model_bytes_,
+                                              ort_format_model_bytes_data_holder_, ort_format_model_mapped_memory_));
         return Status::OK();
       });
 }
@@ -933,8 +1120,11 @@ Status InferenceSession::LoadOrtModel(const void* model_data, int model_data_len
     //
     // TODO: Provide Load API where we can take ownership of memory to avoid the copy,
     // and/or a combined Load+Initialize where we don't need this temporary copy.
-    ort_format_model_bytes_.resize(model_data_len);
-    std::copy_n(reinterpret_cast<const uint8_t*>(model_data), model_data_len, ort_format_model_bytes_.data());
+    ort_format_model_bytes_data_holder_.resize(model_data_len);
+    std::copy_n(reinterpret_cast<const uint8_t*>(model_data), model_data_len,
+                ort_format_model_bytes_data_holder_.data());
+    ort_format_model_bytes_ = gsl::make_span(ort_format_model_bytes_data_holder_.data(),
+                                             ort_format_model_bytes_data_holder_.size());
 
     return Status::OK();
   });
@@ -958,7 +1148,14 @@ Status InferenceSession::LoadOrtModel(std::function<Status()> load_ort_format_mo
   }
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
+  ORT_RETURN_IF_ERROR(LoadOrtModelFromBytes());
+
+  is_model_loaded_ = true;
+
+  return Status::OK();
+}
 
+Status InferenceSession::LoadOrtModelFromBytes() {
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
   flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier));
@@ -976,20 +1173,155 @@ Status InferenceSession::LoadOrtModel(std::function<Status()> load_ort_format_mo
   const auto* fbs_model = fbs_session->model();
   ORT_RETURN_IF(nullptr == fbs_model, "Missing Model. Invalid ORT format model.");
 
+  // Initialize uses the serialized SessionState so it must be present
+  const auto* fbs_sess_state = fbs_session->session_state();
+  ORT_RETURN_IF(nullptr == fbs_sess_state, "SessionState is null. Invalid ORT format model.");
+
   // need to go from unique_ptr to shared_ptr when moving into model_
+  // if the model file is memory mapped the initializers can refer to their data in the file instead of being copied
+  experimental::utils::OrtFormatLoadOptions load_options;
+  if (ort_format_model_mapped_memory_) {
+    const auto& path_components = Path::Parse(model_location_).GetComponents();
+    ORT_RETURN_IF(path_components.empty(), "Invalid model path: ", ToMBString(model_location_));
+    load_options.model_file_name = ToMBString(path_components.back());
+    load_options.model_bytes = ort_format_model_bytes_.data();
+  }
+
   std::unique_ptr<Model> tmp_model;
-  ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model, *session_logger_, tmp_model));
+  ORT_RETURN_IF_ERROR(Model::LoadFromOrtFormat(*fbs_model, *session_logger_, tmp_model,
+                                               ort_format_model_mapped_memory_ ? &load_options : nullptr));
   ORT_RETURN_IF_ERROR(SaveModelMetadata(*tmp_model));
   model_ = std::move(tmp_model);
 
-  // Initialize takes the session_mutex_ as well so we need to have released it prior to calling this
-  const auto* fbs_sess_state = fbs_session->session_state();
-  ORT_RETURN_IF(nullptr == fbs_sess_state, "SessionState is null. Invalid ORT format model.");
+  return Status::OK();
+}
 
-  is_model_loaded_ = true;
+#if !defined(ORT_MINIMAL_BUILD)
+static std::string HashToHexString(const void* data, size_t size) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  MurmurHash3::x86_128(data, gsl::narrow<int>(size), 0, hash);
+
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0');
+  for (auto value : hash) {
+    oss << std::setw(8) << value;
+  }
+  return oss.str();
+}
+
+Status InferenceSession::GetOptimizedModelCachePath(std::basic_string<ORTCHAR_T>& cache_path) const {
+  cache_path.clear();
+
+  std::string cache_dir;
+  if (!session_options_.TryGetConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir, cache_dir) ||
+      cache_dir.empty()) {
+    return Status::OK();
+  }
+
+  // models that are already in ORT format are optimized, and custom ops can't be saved in the ORT format
+  if (!ort_format_model_bytes_.empty() || HasLocalSchema()) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used for ORT format models or models with "
+                                 << "custom ops.";
+    return Status::OK();
+  }
+
+  const std::string model_bytes = model_->ToProto().SerializeAsString();
+
+  // everything other than the model that changes the optimized graph or the kernels created for it
+  std::ostringstream key;
+  key << ORT_VERSION << '\n'
+      << HashToHexString(model_bytes.data(), model_bytes.size()) << '\n'
+      << static_cast<int>(session_options_.graph_optimization_level) << '\n'
+      << session_options_.use_deterministic_compute << '\n';
+
+  // the NCHWc layout of level 3 optimized graphs depends on the instruction set of the CPU
+  if (session_options_.graph_optimization_level >= TransformerLevel::Level3) {
+    key << "nchwc:" << MlasNchwcGetBlockSize() << '\n';
+  }
+
+  const auto& provider_options = execution_providers_.GetAllProviderOptions();
+  for (const auto& provider_id : execution_providers_.GetIds()) {
+    key << "ep:" << provider_id;
+    auto it = provider_options.find(provider_id);
+    if (it != provider_options.end()) {
+      std::map<std::string, std::string> sorted_options(it->second.begin(), it->second.end());
+      for (const auto& option : sorted_options) {
+        key << ';' << option.first << '=' << option.second;
+      }
+    }
+    key << '\n';
+  }
+
+  std::map<std::string, std::string> sorted_configurations(session_options_.session_configurations.begin(),
+                                                           session_options_.session_configurations.end());
+  sorted_configurations.erase(kOrtSessionOptionsConfigOptimizedModelCacheDir);
+  for (const auto& entry : sorted_configurations) {
+    key << "config:" << entry.first << '=' << entry.second << '\n';
+  }
+
+  for (const auto& free_dimension_override : session_options_.free_dimension_overrides) {
+    key << "dim:" << static_cast<int>(free_dimension_override.dim_identifer_type) << ':'
+        << free_dimension_override.dim_identifier << '=' << free_dimension_override.dim_value << '\n';
+  }
+
+  for (const auto& transformer : transformers_to_enable_) {
+    key << "transformer:" << transformer << '\n';
+  }
+
+  const std::string key_string = key.str();
+  cache_path = ToPathString(cache_dir) + ORT_TSTR("/") +
+               ToPathString(HashToHexString(key_string.data(), key_string.size())) + ORT_TSTR(".ort");
 
   return Status::OK();
 }
+
+bool InferenceSession::LoadOptimizedModelFromCache(const std::basic_string<ORTCHAR_T>& cache_path) {
+  size_t num_bytes = 0;
+  if (!Env::Default().GetFileLength(cache_path.c_str(), num_bytes).IsOK()) {
+    LOGS(*session_logger_, INFO) << "No optimized model cache entry at " << ToMBString(cache_path);
+    return false;
+  }
+
+  std::basic_string<ORTCHAR_T> cache_location;
+  auto status = LoadOrtModelBytes(cache_path, cache_location, false, ort_format_model_bytes_,
+                                  ort_format_model_bytes_data_holder_, ort_format_model_mapped_memory_);
+  if (status.IsOK()) {
+    status = LoadOrtModelFromBytes();
+  }
+
+  if (!status.IsOK()) {
+    // fall back to optimizing the model, which replaces the invalid cache entry
+    LOGS(*session_logger_, WARNING) << "Failed to load the optimized model cache entry at " << ToMBString(cache_path)
+                                    << ". " << status.ErrorMessage();
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    return false;
+  }
+
+  LOGS(*session_logger_, INFO) << "Loaded the optimized model from the cache entry at " << ToMBString(cache_path);
+  return true;
+}
+
+void InferenceSession::SaveOptimizedModelToCache(const std::basic_string<ORTCHAR_T>& cache_path) const {
+  // write to a file unique to this process and session, then rename it so that other processes sharing the cache
+  // directory never load a partially written entry
+  std::basic_string<ORTCHAR_T> temp_path = cache_path + ORT_TSTR(".") +
+                                           ToPathString(std::to_string(Env::Default().GetSelfPid())) +
+                                           ORT_TSTR(".") + ToPathString(std::to_string(session_id_)) +
+                                           ORT_TSTR(".tmp");
+
+  auto status = SaveToOrtFormat(temp_path);
+  if (status.IsOK() && std::rename(ToMBString(temp_path).c_str(), ToMBString(cache_path).c_str()) != 0) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", ToMBString(temp_path), " to the cache entry.");
+  }
+
+  if (!status.IsOK()) {
+    std::remove(ToMBString(temp_path).c_str());
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model cache entry at " << ToMBString(cache_path)
+                                    << ". " << status.ErrorMessage();
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
 #endif  // defined(ENABLE_ORT_FORMAT_LOAD)
 
 bool InferenceSession::IsInitialized() const {
@@ -1071,7 +1403,25 @@ common::Status InferenceSession::Initialize() {
     // RegisterExecutionProvider locks the session_mutex_ so we can't be holding it when we call that
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      // keep the arena on the same NUMA node as the intra-op threads that touch it
+      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena, session_options_.intra_op_param.numa_node};
+      epi.quantize_tree_ensemble_thresholds =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigQuantizeTreeEnsembleThresholds, "0") == "1";
+      epi.disable_winograd_conv =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigDisableWinogradConv, "0") == "1";
+      std::string sparse_threshold_str =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigSparseMatMulThreshold, "");
+      if (!sparse_threshold_str.empty()) {
+        std::istringstream iss(sparse_threshold_str);
+        float sparse_threshold = -1.0f;
+        if (!(iss >> sparse_threshold) || !iss.eof() || !(sparse_threshold >= 0.0f)) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                 kOrtSessionOptionsConfigSparseMatMulThreshold, ": ", sparse_threshold_str);
+        }
+        epi.sparse_matmul_threshold = sparse_threshold;
+      }
+      epi.ml_perfect_hash_tables =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigMlPerfectHashTables, "0") == "1";
       auto p_cpu_exec_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -1093,10 +1443,51 @@ common::Status InferenceSession::Initialize() {
     // from IAllocator to keep things clean.
     std::string use_env_allocators = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvAllocators,
                                                                          "0");
+    size_t env_allocator_limits[2] = {0, 0};
+    const char* const env_allocator_limit_keys[2] = {kOrtSessionOptionsConfigEnvAllocatorSoftLimit,
+                                                     kOrtSessionOptionsConfigEnvAllocatorHardLimit};
+    for (int i = 0; i < 2; ++i) {
+      std::string limit_str = session_options_.GetConfigOrDefault(env_allocator_limit_keys[i], "");
+      if (limit_str.empty()) {
+        continue;
+      }
+      std::istringstream iss(limit_str);
+      int64_t limit = -1;
+      if (!(iss >> limit) || !iss.eof() || limit < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ", env_allocator_limit_keys[i], ": ",
+                               limit_str);
+      }
+      if (use_env_allocators != "1") {
+        LOGS(*session_logger_, WARNING) << env_allocator_limit_keys[i] << " is ignored as "
+                                        << kOrtSessionOptionsConfigUseEnvAllocators << " is not enabled.";
+      }
+      env_allocator_limits[i] = static_cast<size_t>(limit);
+    }
+
     if (use_env_allocators == "1") {
-      UpdateProvidersWithSharedAllocators();
+      UpdateProvidersWithSharedAllocators(env_allocator_limits[0], env_allocator_limits[1]);
+    }
+
+    // pre-packed weights are shared through the env the same way as the allocators, so sharing them requires
+    // opting into the env allocators as well.
+    PrepackedWeightsContainer* prepacked_weights_container = nullptr;
+    if (session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigShareEnvPrepackedWeights, "0") == "1") {
+      if (use_env_allocators == "1") {
+        prepacked_weights_container = &environment_.GetPrepackedWeightsContainer();
+      } else {
+        LOGS(*session_logger_, WARNING) << kOrtSessionOptionsConfigShareEnvPrepackedWeights << " is ignored as "
+                                        << kOrtSessionOptionsConfigUseEnvAllocators << " is not enabled.";
+      }
     }
 
+#if !defined(ORT_MINIMAL_BUILD) && defined(ENABLE_ORT_FORMAT_LOAD)
+    // replace the model with the optimized one from the cache before the session state is created for its graph
+    std::basic_string<ORTCHAR_T> optimized_model_cache_path;
+    ORT_RETURN_IF_ERROR_SESSIONID_(GetOptimizedModelCachePath(optimized_model_cache_path));
+    const bool loaded_from_optimized_model_cache =
+        !optimized_model_cache_path.empty() && LoadOptimizedModelFromCache(optimized_model_cache_path);
+#endif
+
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
     TraceLoggingWriteStart(session_activity, "OrtInferenceSessionActivity");
     session_activity_started_ = true;
@@ -1112,10 +1503,116 @@ common::Status InferenceSession::Initialize() {
         data_transfer_mgr_,
         *session_logger_,
         session_profiler_,
-        session_options_.use_deterministic_compute);
+        session_options_.use_deterministic_compute,
+        prepacked_weights_container);
+
+    {
+      std::string cache_size_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigExecutionPlanCacheSize,
+                                                                         "");
+      if (!cache_size_str.empty()) {
+        std::istringstream iss(cache_size_str);
+        int64_t cache_size = -1;
+        if (!(iss >> cache_size) || !iss.eof() || cache_size < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                 kOrtSessionOptionsConfigExecutionPlanCacheSize, ": ", cache_size_str);
+        }
+
+        session_state_->SetExecutionPlanCacheCapacity(static_cast<size_t>(cache_size));
+      }
+    }
+
+    {
+      arena_shrink_after_run_ = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigArenaShrinkAfterRun, "0") == "1";
+      std::string min_idle_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigArenaShrinkMinIdleSeconds, "");
+      if (!min_idle_str.empty()) {
+        std::istringstream iss(min_idle_str);
+        int64_t min_idle_seconds = -1;
+        if (!(iss >> min_idle_seconds) || !iss.eof() || min_idle_seconds < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                 kOrtSessionOptionsConfigArenaShrinkMinIdleSeconds, ": ", min_idle_str);
+        }
+
+        arena_shrink_after_run_ = true;
+        arena_shrink_min_idle_time_ = std::chrono::seconds(min_idle_seconds);
+      }
+    }
+
+    {
+      std::string pad_buckets_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigPadBuckets, "");
+      if (!pad_buckets_str.empty()) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(shape_buckets::ParseBuckets(pad_buckets_str, pad_buckets_));
+
+        // the axes of the graph inputs and outputs with the bucketed dim_params, from the shapes in the model
+        auto get_axes = [this](const NodeArg& arg) {
+          std::vector<std::pair<size_t, std::string>> axes;
+          const auto* shape = arg.Shape();
+          for (int k = 0, end = shape ? shape->dim_size() : 0; k < end; ++k) {
+            const auto& dim = shape->dim(k);
+            if (dim.has_dim_param() && pad_buckets_.count(dim.dim_param()) > 0) {
+              axes.emplace_back(static_cast<size_t>(k), dim.dim_param());
+            }
+          }
+          return axes;
+        };
+
+        std::unordered_set<std::string> input_dim_params;
+        for (const auto& input : input_def_map_) {
+          auto axes = get_axes(*input.second.node_arg);
+          for (const auto& axis : axes) {
+            input_dim_params.insert(axis.second);
+          }
+          if (!axes.empty()) {
+            padded_input_axes_[input.first] = std::move(axes);
+          }
+        }
+
+        for (const auto& bucket : pad_buckets_) {
+          if (input_dim_params.count(bucket.first) == 0) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                   kOrtSessionOptionsConfigPadBuckets, ": ", bucket.first,
+                                   " isn't a symbolic dimension of a graph input.");
+          }
+        }
+
+        for (const auto* output : output_def_list_) {
+          auto axes = get_axes(*output);
+          if (!axes.empty()) {
+            padded_output_axes_[output->Name()] = std::move(axes);
+          }
+        }
+      }
+    }
+
+    {
+      sampling_profile_file_ = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingStatsFile, "");
+      std::string interval_str =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingStatsExportIntervalSeconds, "");
+      if (!interval_str.empty()) {
+        std::istringstream iss(interval_str);
+        int64_t interval_seconds = -1;
+        if (!(iss >> interval_seconds) || !iss.eof() || interval_seconds < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                                 kOrtSessionOptionsConfigProfilingStatsExportIntervalSeconds, ": ", interval_str);
+        }
+
+        sampling_profile_export_interval_ = std::chrono::seconds(interval_seconds);
+      }
+
+      // the first export happens one interval after the session is initialized
+      sampling_profile_last_export_ = std::chrono::high_resolution_clock::now();
+    }
 
     onnxruntime::Graph& graph = model_->MainGraph();
 
+    // let the external data of the initializers be read while the graph is optimized and partitioned,
+    // it's loaded when the session state is finalized.
+    if (session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigPrefetchExternalData, "1") == "1") {
+      const size_t num_prefetched = PrefetchExternalData(graph, model_location_, *session_logger_);
+      if (num_prefetched > 0) {
+        LOGS(*session_logger_, INFO) << "Prefetching the external data of " << num_prefetched << " initializers";
+      }
+    }
+
     // Collect the kernel registries from execution provider instances;
     // There are 2 kinds of kernel registries with priority from high to low as below,
     // 1. Custom execution provider type specific kernel registries.
@@ -1127,34 +1624,76 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR_SESSIONID_(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
 #if !defined(ORT_MINIMAL_BUILD)
-    // add predefined transformers
-    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
-                              transformers_to_enable_);
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+    // the cached graph is already optimized and partitioned
+    if (!loaded_from_optimized_model_cache)
+#endif
+    {
+      // add predefined transformers
+      AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
+                                transformers_to_enable_);
 
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
-                                                  execution_providers_, kernel_registry_manager_,
-                                                  insert_cast_transformer_,
-                                                  *session_state_));
+      // apply any transformations to the main graph and any subgraphs
+      ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
+                                                    execution_providers_, kernel_registry_manager_,
+                                                    insert_cast_transformer_,
+                                                    *session_state_));
 
-    // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
-    ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
+      // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
+      ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
-    // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
-    ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+      // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
+      ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+    }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // need to keep the initializers if we're going to save the optimized model
     bool keep_initializers = !session_options_.optimized_model_filepath.empty();
+#if !defined(ORT_MINIMAL_BUILD) && defined(ENABLE_ORT_FORMAT_LOAD)
+    const bool save_to_optimized_model_cache =
+        !optimized_model_cache_path.empty() && !loaded_from_optimized_model_cache;
+    keep_initializers = keep_initializers || save_to_optimized_model_cache;
+#endif
 
     auto* serialized_session_state = !ort_format_model_bytes_.empty()
                                          ? fbs::GetInferenceSession(ort_format_model_bytes_.data())->session_state()
                                          : nullptr;
 
+    // the serialized pre-packed weights are used in place if the model file is memory mapped
     ORT_RETURN_IF_ERROR_SESSIONID_(session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                                                         session_options_,
                                                                         serialized_session_state,
-                                                                        !keep_initializers));
+                                                                        !keep_initializers,
+                                                                        ort_format_model_mapped_memory_
+                                                                            ? ort_format_model_bytes_.data()
+                                                                            : nullptr));
+
+#if !defined(ORT_MINIMAL_BUILD)
+    {
+      std::string sticky_inputs_str = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigStickyInputs, "");
+      if (!sticky_inputs_str.empty()) {
+        std::vector<std::string> sticky_inputs;
+        std::istringstream iss(sticky_inputs_str);
+        std::string name;
+        while (std::getline(iss, name, ',')) {
+          if (!name.empty()) {
+            sticky_inputs.push_back(name);
+          }
+        }
+
+        std::unique_ptr<NodeResultCache> node_result_cache;
+        ORT_RETURN_IF_ERROR_SESSIONID_(NodeResultCache::Create(
+            *session_state_, sticky_inputs,
+            [](const Node& node) { return optimizer_utils::IsOperationDeterministic(node.Domain(), node.OpType()); },
+            node_result_cache));
+        if (node_result_cache == nullptr) {
+          LOGS(*session_logger_, WARNING) << "No node only depends on the sticky inputs " << sticky_inputs_str
+                                          << ", so no results are memoized.";
+        }
+        session_state_->SetNodeResultCache(std::move(node_result_cache));
+      }
+    }
+#endif
 
 #if !defined(ORT_MINIMAL_BUILD)
     if (!session_options_.optimized_model_filepath.empty()) {
@@ -1176,13 +1715,35 @@ common::Status InferenceSession::Initialize() {
         ORT_RETURN_IF_ERROR_SESSIONID_(Model::Save(*model_, session_options_.optimized_model_filepath));
       }
     }
+
+#if defined(ENABLE_ORT_FORMAT_LOAD)
+    if (save_to_optimized_model_cache) {
+      SaveOptimizedModelToCache(optimized_model_cache_path);
+    }
+#endif
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     session_state_->ResolveMemoryPatternFlag();
+
+    // a captured graph replays the launches of a whole Run, which is only well defined for the sequential executor
+    for (auto& xp : execution_providers_) {
+      if (xp->IsGraphCaptureEnabled()) {
+        if (session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
+          graph_capture_ep_ = xp.get();
+        } else {
+          LOGS(*session_logger_, WARNING) << "Graph capture for " << xp->Type()
+                                          << " requires the sequential execution mode and will not be used.";
+        }
+        break;
+      }
+    }
+
     is_inited_ = true;
 
     // we don't directly use the ORT format bytes currently, so free those now
-    std::vector<uint8_t>().swap(ort_format_model_bytes_);
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    ort_format_model_mapped_memory_.reset();
 
     // and log telemetry
     bool model_has_fp16_inputs = ModelHasFP16Inputs(graph);
@@ -1227,13 +1788,20 @@ common::Status InferenceSession::Initialize() {
 
 // This method should be called from within Initialize() only and before the creation of the session state.
 // This ensures all providers have been registered in the session and the session state is consistent with the providers.
-void InferenceSession::UpdateProvidersWithSharedAllocators() {
+void InferenceSession::UpdateProvidersWithSharedAllocators(size_t soft_limit, size_t hard_limit) {
   using namespace std;
   const auto& provider_ids = execution_providers_.GetIds();
+  const std::string owner = "Session " + (session_options_.session_logid.empty() ? std::to_string(session_id_)
+                                                                                  : session_options_.session_logid);
   for (const auto& one_shared_alloc : environment_.GetRegisteredSharedAllocators()) {
+    // one wrapper for all the providers, so the session's usage of the shared allocator is counted once
+    AllocatorPtr alloc = one_shared_alloc;
+    if (soft_limit != 0 || hard_limit != 0) {
+      alloc = std::make_shared<CappedAllocator>(one_shared_alloc, soft_limit, hard_limit, owner);
+    }
     for (const auto& id : provider_ids) {
       auto* provider_ptr = execution_providers_.Get(id);
-      provider_ptr->ReplaceAllocator(one_shared_alloc);
+      provider_ptr->ReplaceAllocator(alloc);
     }
   }
 }
@@ -1399,10 +1967,114 @@ common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>&
   return common::Status::OK();
 }
 
+common::Status InferenceSession::PadFeeds(const std::vector<std::string>& feed_names,
+                                          const std::vector<OrtValue>& feeds, std::vector<OrtValue>& padded_feeds,
+                                          std::unordered_map<std::string, int64_t>& dim_sizes) const {
+  padded_feeds.clear();
+  dim_sizes.clear();
+
+  // the size of each bucketed dimension, which the feeds must agree on. feeds that can't be padded leave the Run
+  // unpadded.
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    auto axes = padded_input_axes_.find(feed_names[i]);
+    if (axes == padded_input_axes_.cend()) {
+      continue;
+    }
+
+    if (!feeds[i].IsTensor() || strcmp(feeds[i].Get<Tensor>().Location().name, CPU) != 0) {
+      dim_sizes.clear();
+      return Status::OK();
+    }
+
+    const auto& dims = feeds[i].Get<Tensor>().Shape().GetDims();
+    for (const auto& axis : axes->second) {
+      if (axis.first >= dims.size()) {
+        dim_sizes.clear();
+        return Status::OK();
+      }
+
+      auto inserted = dim_sizes.emplace(axis.second, dims[axis.first]);
+      if (!inserted.second && inserted.first->second != dims[axis.first]) {
+        dim_sizes.clear();
+        return Status::OK();
+      }
+    }
+  }
+
+  bool needs_padding = false;
+  for (const auto& dim_size : dim_sizes) {
+    needs_padding = needs_padding ||
+                    shape_buckets::GetBucketSize(pad_buckets_.at(dim_size.first), dim_size.second) != dim_size.second;
+  }
+
+  if (!needs_padding) {
+    dim_sizes.clear();
+    return Status::OK();
+  }
+
+  auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  padded_feeds = feeds;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    auto axes = padded_input_axes_.find(feed_names[i]);
+    if (axes == padded_input_axes_.cend()) {
+      continue;
+    }
+
+    const Tensor& tensor = feeds[i].Get<Tensor>();
+    std::vector<int64_t> dims = tensor.Shape().GetDims();
+    for (const auto& axis : axes->second) {
+      dims[axis.first] = shape_buckets::GetBucketSize(pad_buckets_.at(axis.second), dims[axis.first]);
+    }
+
+    if (dims != tensor.Shape().GetDims()) {
+      ORT_RETURN_IF_ERROR(shape_buckets::Resize(tensor, dims, allocator, padded_feeds[i]));
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::SliceFetches(const std::vector<std::string>& output_names,
+                                              const std::unordered_map<std::string, int64_t>& dim_sizes,
+                                              std::vector<OrtValue>& fetches) const {
+  auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  for (size_t i = 0; i < output_names.size() && i < fetches.size(); ++i) {
+    auto axes = padded_output_axes_.find(output_names[i]);
+    if (axes == padded_output_axes_.cend() || !fetches[i].IsTensor()) {
+      continue;
+    }
+
+    const Tensor& tensor = fetches[i].Get<Tensor>();
+    std::vector<int64_t> dims = tensor.Shape().GetDims();
+    for (const auto& axis : axes->second) {
+      auto dim_size = dim_sizes.find(axis.second);
+      if (dim_size != dim_sizes.cend() && axis.first < dims.size() && dims[axis.first] > dim_size->second) {
+        dims[axis.first] = dim_size->second;
+      }
+    }
+
+    if (dims != tensor.Shape().GetDims()) {
+      OrtValue sliced;
+      ORT_RETURN_IF_ERROR(shape_buckets::Resize(tensor, dims, allocator, sliced));
+      fetches[i] = sliced;
+    }
+  }
+
+  return Status::OK();
+}
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info, nullptr);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                 const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 std::unique_ptr<FeedsFetchesManager>* p_cached_feeds_fetches_manager) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.StartTime();
@@ -1416,8 +2088,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
   Status retval = Status::OK();
   const Env& env = Env::Default();
 
-  std::vector<IExecutionProvider*> exec_providers_to_stop;
-  exec_providers_to_stop.reserve(execution_providers_.NumProviders());
+  // OnRunStart is called until a provider fails, so the providers to stop are the first num_providers_started
+  size_t num_providers_started = 0;
+
+  std::unique_lock<OrtMutex> graph_capture_lock;
+  uint64_t graph_key = 0;
+  bool capture_graph = false;
 
   ORT_TRY {
     if (!is_inited_) {
@@ -1431,19 +2107,42 @@ Status InferenceSession::Run(const RunOptions& run_options,
     ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
     ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
 
-    FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
-
-    if (p_fetches_device_info) {
-      // populate the target device info. ignored if pre-allocated fetches are provided
-      const auto& fetch_device_info = *p_fetches_device_info;
-      auto& fetch_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
-
-      for (size_t i = 0, end = output_names.size(); i < end; ++i) {
-        fetch_info[i].target_device = fetch_device_info[i];
+    // pad the feeds to the buckets of their symbolic dimensions. the outputs are sliced back after the Run, so the
+    // outputs must not be pre-allocated or placed on another device. the C API passes fetches sized to the outputs,
+    // which are unallocated unless the caller provides the buffers.
+    std::vector<OrtValue> padded_feeds;
+    std::unordered_map<std::string, int64_t> padded_dim_sizes;
+    if (!pad_buckets_.empty() && p_fetches_device_info == nullptr &&
+        std::none_of(p_fetches->cbegin(), p_fetches->cend(),
+                     [](const OrtValue& fetch) { return fetch.IsAllocated(); })) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(PadFeeds(feed_names, feeds, padded_feeds, padded_dim_sizes));
+    }
+    const bool padded = !padded_feeds.empty();
+    const std::vector<OrtValue>& run_feeds = padded ? padded_feeds : feeds;
+
+    // reuse the manager of a previous Run if the caller keeps one, along with the device copy info it holds
+    std::unique_ptr<FeedsFetchesManager> owned_feeds_fetches_manager;
+    auto& p_feeds_fetches_manager =
+        p_cached_feeds_fetches_manager ? *p_cached_feeds_fetches_manager : owned_feeds_fetches_manager;
+
+    if (!p_feeds_fetches_manager) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(FeedsFetchesManager::Create(feed_names, output_names,
+                                                                 session_state_->GetOrtValueNameIdxMap(),
+                                                                 p_feeds_fetches_manager));
+
+      if (p_fetches_device_info) {
+        // populate the target device info. ignored if pre-allocated fetches are provided
+        const auto& fetch_device_info = *p_fetches_device_info;
+        auto& fetch_info = p_feeds_fetches_manager->GetMutableFetchesDeviceCopyInfo();
+
+        for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+          fetch_info[i].target_device = fetch_device_info[i];
+        }
       }
     }
 
+    FeedsFetchesManager& feeds_fetches_manager = *p_feeds_fetches_manager;
+
     if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
@@ -1460,11 +2159,11 @@ Status InferenceSession::Run(const RunOptions& run_options,
     // info all execution providers InferenceSession:Run started
     // TODO: only call OnRunStart for all providers in-use
     for (auto& xp : execution_providers_) {
-      // call OnRunStart and add to exec_providers_to_stop if successful
-      auto start_func = [&xp, &exec_providers_to_stop]() {
+      // call OnRunStart and count the provider as started if successful
+      auto start_func = [&xp, &num_providers_started]() {
         auto status = xp->OnRunStart();
         if (status.IsOK())
-          exec_providers_to_stop.push_back(xp.get());
+          ++num_providers_started;
 
         return status;
       };
@@ -1478,10 +2177,47 @@ Status InferenceSession::Run(const RunOptions& run_options,
     }
 #endif
 
-    // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                                                 session_options_.execution_mode, run_options.terminate, run_logger,
-                                                 run_options.only_execute_path_to_fetches));
+    bool replay_graph = false;
+    if (graph_capture_ep_ != nullptr) {
+      graph_capture_lock = std::unique_lock<OrtMutex>(graph_capture_mutex_);
+      if (graph_capture_ep_->IsGraphCaptureEnabled() && !run_options.only_execute_path_to_fetches &&
+          GetGraphCaptureKey(run_feeds, *p_fetches, output_names.size(), graph_key)) {
+        if (graph_capture_ep_->IsGraphCaptured(graph_key)) {
+          replay_graph = true;
+        } else if (!graph_capture_warmed_up_keys_.insert(graph_key).second) {
+          // second Run with this key. everything the kernels lazily allocate has been allocated by now.
+          capture_graph = true;
+        }
+      }
+    }
+
+    if (replay_graph) {
+      ORT_CHECK_AND_SET_RETVAL(graph_capture_ep_->ReplayGraph(graph_key));
+    } else {
+      if (capture_graph) {
+        auto status = graph_capture_ep_->BeginGraphCapture(graph_key);
+        capture_graph = status.IsOK();
+        ORT_CHECK_AND_SET_RETVAL(status);
+      }
+
+      // the intra-op thread budget, the priority and the weight of the Run apply to the parallel loops of its kernels
+      concurrency::ThreadPoolParallelismLimitScope parallelism_limit_scope(
+          run_options.intra_op_max_degree_of_parallelism);
+      concurrency::ThreadPoolRunPriorityScope run_priority_scope(session_state_->GetThreadPool(),
+                                                                 run_options.priority < 0);
+      concurrency::ThreadPoolRunWeightScope run_weight_scope(session_state_->GetThreadPool(),
+                                                             intra_op_thread_pool_weight_);
+
+      // execute the graph
+      ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(*session_state_, feeds_fetches_manager, run_feeds, *p_fetches,
+                                                   session_options_.execution_mode, run_options.terminate, run_logger,
+                                                   run_options.only_execute_path_to_fetches, run_options.stream_id,
+                                                   run_options.end_of_stream));
+
+      if (padded && retval.IsOK()) {
+        ORT_CHECK_AND_SET_RETVAL(SliceFetches(output_names, padded_dim_sizes, *p_fetches));
+      }
+    }
   }
   ORT_CATCH(const std::exception& e) {
     ORT_HANDLE_EXCEPTION([&]() {
@@ -1492,14 +2228,29 @@ Status InferenceSession::Run(const RunOptions& run_options,
     retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
   }
 
+  // end the capture even if the Run failed so the provider doesn't keep recording
+  if (capture_graph) {
+    auto status = graph_capture_ep_->EndGraphCapture(graph_key, !retval.IsOK());
+    ORT_CHECK_AND_SET_RETVAL(status);
+  }
+
   // info all execution providers InferenceSession:Run ended
-  for (auto* xp : exec_providers_to_stop) {
-    auto status = xp->OnRunEnd();
+  auto xp_it = execution_providers_.begin();
+  for (size_t i = 0; i < num_providers_started; ++i, ++xp_it) {
+    auto status = (*xp_it)->OnRunEnd();
     ORT_CHECK_AND_SET_RETVAL(status);
   }
 
   --current_num_runs_;
 
+  if (arena_shrink_after_run_) {
+    ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas(arena_shrink_min_idle_time_));
+  }
+
+  if (!sampling_profile_file_.empty()) {
+    ExportSamplingProfileIfDue();
+  }
+
   // keep track of telemetry
   ++telemetry_.total_runs_since_last_;
   telemetry_.total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
@@ -1550,6 +2301,158 @@ common::Status InferenceSession::Run(const RunOptions& run_options, const NameML
   return Run(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
 }
 
+common::Status InferenceSession::ScheduleAsyncRun(std::function<void()> run) {
+  // The Run is executed on the intra-op pool rather than the inter-op pool, as the latter only exists in parallel
+  // execution mode and the parallel executor blocks on the nodes it schedules on it.
+  // A Run that is executing on the intra-op pool can still use it for its kernels as the work that is not picked
+  // up by other threads is run by the scheduling thread.
+  concurrency::ThreadPool* tp = GetIntraOpThreadPoolToUse();
+  if (tp == nullptr || tp->NumThreads() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "RunAsync requires an intra-op thread pool with at least one thread.");
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    ++num_async_runs_;
+  }
+
+  tp->Schedule([this, run]() {
+    run();
+
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    if (--num_async_runs_ == 0) {
+      async_runs_cv_.notify_all();
+    }
+  });
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  if (!callback) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  // std::function requires a copyable target, so the arguments are moved into a shared state
+  struct AsyncRunState {
+    const RunOptions& run_options;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    std::vector<OrtValue> fetches;
+    RunAsyncCallback callback;
+  };
+
+  auto state = std::make_shared<AsyncRunState>(AsyncRunState{run_options, std::move(feed_names), std::move(feeds),
+                                                             std::move(output_names), std::move(fetches),
+                                                             std::move(callback)});
+
+  return ScheduleAsyncRun([this, state]() {
+    Status status;
+    ORT_TRY {
+      status = Run(state->run_options, state->feed_names, state->feeds, state->output_names, &state->fetches);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    ORT_TRY {
+      state->callback(status, state->fetches);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, ERROR) << "Exception thrown by the RunAsync callback: " << ex.what();
+      });
+    }
+
+    // release the values before the session can be destroyed as they may use its allocators
+    state->feeds.clear();
+    state->fetches.clear();
+  });
+}
+
+common::Status InferenceSession::RunMany(const RunOptions& run_options, const std::vector<NameMLValMap>& feeds,
+                                         const std::vector<std::string>& output_names,
+                                         std::vector<std::vector<OrtValue>>& fetches) {
+  fetches.clear();
+  fetches.resize(feeds.size());
+  std::vector<Status> statuses(feeds.size());
+
+  auto* thread_pool = GetInterOpThreadPoolToUse();
+  if (thread_pool == nullptr) {
+    thread_pool = GetIntraOpThreadPoolToUse();
+  }
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(feeds.size()), [&](std::ptrdiff_t i) {
+        ORT_TRY {
+          statuses[i] = Run(run_options, feeds[i], output_names, &fetches[i]);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+          });
+        }
+      });
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, IOBinding& io_binding,
+                                          IOBindingRunAsyncCallback callback) {
+  if (!callback) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  // The copies made by BindInput are queued on the stream of the thread that bound the inputs. The Run executes on
+  // another thread, so if a provider uses per-thread streams it has to wait for them explicitly.
+  bool synchronize_inputs = false;
+  for (const auto& xp : execution_providers_) {
+    synchronize_inputs = synchronize_inputs || xp->UsesPerThreadStreams();
+  }
+
+  auto shared_callback = std::make_shared<IOBindingRunAsyncCallback>(std::move(callback));
+  return ScheduleAsyncRun([this, &run_options, &io_binding, synchronize_inputs, shared_callback]() {
+    Status status;
+    ORT_TRY {
+      if (synchronize_inputs) {
+        status = io_binding.SynchronizeInputs();
+      }
+
+      if (status.IsOK()) {
+        status = Run(run_options, io_binding);
+      }
+
+      // outputs bound to a device may still be written by the kernels or the copy streams
+      if (status.IsOK()) {
+        status = io_binding.SynchronizeOutputs();
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    ORT_TRY {
+      (*shared_callback)(status, io_binding);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, ERROR) << "Exception thrown by the RunAsync callback: " << ex.what();
+      });
+    }
+  });
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -1617,8 +2520,8 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+  return RunImpl(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
+                 &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo(), &io_binding.feeds_fetches_manager_);
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -1626,6 +2529,55 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::ShrinkMemoryArenas(std::chrono::seconds min_idle_time) {
+  for (const auto& xp : execution_providers_) {
+    // a captured graph replays with the buffers the arena gave out when it was captured
+    if (xp.get() == graph_capture_ep_) {
+      continue;
+    }
+
+    for (const auto& alloc : xp->GetAllocators()) {
+      if (alloc->Info().alloc_type == OrtArenaAllocator) {
+        ORT_RETURN_IF_ERROR(static_cast<IArenaAllocator*>(alloc.get())->Shrink(min_idle_time));
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetArenaStats(std::string& stats_json) const {
+  std::ostringstream ss;
+  ss << "{\"arenas\":[";
+  bool first = true;
+  for (const auto& xp : execution_providers_) {
+    for (const auto& alloc : xp->GetAllocators()) {
+      if (alloc->Info().alloc_type == OrtArenaAllocator) {
+        ss << (first ? "" : ",") << "{\"provider\":\"" << xp->Type() << "\",\"device\":\"" << alloc->Info().name
+           << "\",\"deviceId\":" << alloc->Info().id
+           << ",\"bytesInUse\":" << static_cast<IArenaAllocator*>(alloc.get())->Used() << "}";
+        first = false;
+      }
+    }
+  }
+  ss << "]}";
+  stats_json = ss.str();
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetMemoryReport(std::string& report_json) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  report_json = CreateSessionMemoryReport(*session_state_);
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -1650,7 +2602,17 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
-      return session_profiler_.EndProfiling();
+      std::string profile_file = session_profiler_.EndProfiling();
+      // the memory report goes next to the profile, e.g. prefix_<time>_memory.json
+      const std::string json_extension = ".json";
+      const size_t stem_size = profile_file.size() - std::min(profile_file.size(), json_extension.size());
+      std::string report_json;
+      if (stem_size > 0 && profile_file.compare(stem_size, std::string::npos, json_extension) == 0 &&
+          GetMemoryReport(report_json).IsOK()) {
+        std::ofstream report_file(profile_file.substr(0, stem_size) + "_memory" + json_extension);
+        report_file << report_json;
+      }
+      return profile_file;
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
       return std::string();
@@ -1664,6 +2626,69 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+common::Status InferenceSession::GetSamplingProfileStats(std::string& stats_json) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  const auto* sampling_profiler = session_state_->GetSamplingProfiler();
+  if (sampling_profiler == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The sampling profiler is not enabled. Set ",
+                           kOrtSessionOptionsConfigProfilingSampleRate, " to enable it.");
+  }
+
+  profiling::SamplingProfileReport report;
+  report.sample_rate = sampling_profiler->SampleRate();
+  report.sampled_runs = sampling_profiler->SampledRuns();
+  session_state_->AddToSamplingProfileReport(report);
+  stats_json = report.ToJson();
+  return Status::OK();
+}
+
+void InferenceSession::ExportSamplingProfileIfDue() {
+  // only one of the concurrent Runs exports, the others carry on
+  if (session_state_->GetSamplingProfiler() == nullptr || sampling_profile_exporting_.exchange(true)) {
+    return;
+  }
+
+  const auto now = std::chrono::high_resolution_clock::now();
+  if (now - sampling_profile_last_export_ >= sampling_profile_export_interval_) {
+    sampling_profile_last_export_ = now;
+
+    std::string stats_json;
+    auto status = GetSamplingProfileStats(stats_json);
+    if (status.IsOK()) {
+      // write a temporary file and rename it so that readers of the file never see a partial write
+      const std::string temp_file = sampling_profile_file_ + ".tmp";
+      {
+        std::ofstream out(temp_file, std::ios::out | std::ios::trunc);
+        out << stats_json;
+        if (!out.good()) {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", temp_file);
+        }
+      }
+
+#ifdef _WIN32
+      // rename doesn't replace an existing file on Windows
+      std::remove(sampling_profile_file_.c_str());
+#endif
+      if (status.IsOK() && std::rename(temp_file.c_str(), sampling_profile_file_.c_str()) != 0) {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", temp_file, " to ", sampling_profile_file_);
+      }
+    }
+
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to export the sampling profile: " << status.ErrorMessage();
+    }
+  }
+
+  sampling_profile_exporting_ = false;
+}
+
 AllocatorPtr InferenceSession::GetAllocator(const OrtMemoryInfo& mem_info) const {
   return session_state_->GetAllocator(mem_info);
 }
@@ -1742,7 +2767,11 @@ const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& ru
   const logging::Logger* run_logger;
 
   // create a per-run logger if we can
-  if (logging_manager_ != nullptr) {
+  if (logging_manager_ != nullptr && run_options.run_tag.empty() && run_options.run_log_severity_level == -1 &&
+      run_options.run_log_verbosity_level == session_options_.session_log_verbosity_level) {
+    // a per-run logger would have the same id, severity and verbosity as the session logger
+    run_logger = session_logger_;
+  } else if (logging_manager_ != nullptr) {
     std::string run_log_id{session_options_.session_logid};
 
     if (!session_options_.session_logid.empty() && !run_options.run_tag.empty()) {
@@ -1808,10 +2837,21 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
     auto transformers_to_register =
         optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides,
                                               *execution_providers_.Get(onnxruntime::kCpuExecutionProvider),
-                                              custom_list);
+                                              custom_list, GetIntraOpThreadPoolToUse());
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
+
+    // Specialize the graph for the static input shapes given in the session config.
+    std::string static_input_shapes_string;
+    if (level == TransformerLevel::Level1 &&
+        session_options_.TryGetConfigEntry(kOrtSessionOptionsConfigStaticInputShapes, static_input_shapes_string) &&
+        (custom_list.empty() ||
+         std::find(custom_list.begin(), custom_list.end(), "StaticShapeSpecialization") != custom_list.end())) {
+      StaticShapeSpecialization::InputShapeMap static_input_shapes;
+      ORT_THROW_IF_ERROR(StaticShapeSpecialization::ParseInputShapes(static_input_shapes_string, static_input_shapes));
+      transformer_manager.Register(onnxruntime::make_unique<StaticShapeSpecialization>(static_input_shapes), level);
+    }
   };
 
   ORT_ENFORCE(graph_optimization_level <= TransformerLevel::MaxLevel,
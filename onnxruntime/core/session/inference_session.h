@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <unordered_map>
 
@@ -16,10 +17,12 @@
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/session_state.h"
 #include "core/graph/basic_types.h"
+#include "core/platform/env.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/framework/session_options.h"
+#include "core/session/shape_buckets.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -44,6 +47,7 @@ struct OrtCustomOpDomain {
 
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
+class FeedsFetchesManager;
 class IOBinding;
 class CustomRegistry;
 struct Notification;
@@ -285,6 +289,34 @@ class InferenceSession {
                      const std::vector<std::string>& output_names,
                      std::vector<OrtValue>* p_fetches) ORT_MUST_USE_RESULT;
 
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Run a pre-loaded and pre-intialized model without blocking the calling thread.
+    * The Run is scheduled on the intra-op thread pool of the session and callback is invoked on the thread
+    * that executed it, with the status of the Run and the fetches in the order specified by output_names.
+    * run_options is not copied, so that the Run can be terminated with it, and must stay valid until callback
+    * has been invoked.
+    * The session must not be destroyed from callback; the destructor waits for the outstanding Runs to complete.
+    * @param fetches pre-allocated outputs, or empty OrtValues for the outputs that should be allocated by the Run.
+    * @return OK if the Run was scheduled, in which case callback is invoked exactly once. callback is not
+    *         invoked otherwise.
+    */
+  common::Status RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback) ORT_MUST_USE_RESULT;
+
+  /**
+    * Run a pre-loaded and pre-initialized model once for each of feeds, concurrently on the inter-op thread pool
+    * of the session, or on its intra-op thread pool if it has no inter-op thread pool, e.g. when it is executed
+    * sequentially. The calling thread takes part in the Runs.
+    * @param fetches set to the fetches of each of the Runs, in the order of feeds.
+    * @return the status of the first of feeds whose Run failed, or OK if all of them succeeded.
+    */
+  common::Status RunMany(const RunOptions& run_options, const std::vector<NameMLValMap>& feeds,
+                         const std::vector<std::string>& output_names,
+                         std::vector<std::vector<OrtValue>>& fetches) ORT_MUST_USE_RESULT;
+
   /**
   * Creates a new binding object for binding inputs and outputs.
   * @param provider_type specifies the location where the inputs need to be potentially copied.
@@ -295,6 +327,26 @@ class InferenceSession {
   virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding) ORT_MUST_USE_RESULT;
   common::Status Run(IOBinding& io_binding) ORT_MUST_USE_RESULT;
 
+  using IOBindingRunAsyncCallback = std::function<void(const common::Status& status, IOBinding& io_binding)>;
+
+  /**
+    * Run with the values bound to io_binding without blocking the calling thread, see RunAsync above.
+    * The outputs are synchronized before callback is invoked so they can be read from it. Copies made by
+    * BindInput that are still in flight are ordered before the Run by the execution provider, so the next
+    * inputs can be bound to another IOBinding while this Run executes. See RunPipeline for a helper that keeps
+    * a number of these Runs in flight.
+    * io_binding must not be modified until callback has been invoked.
+    */
+  common::Status RunAsync(const RunOptions& run_options, IOBinding& io_binding,
+                          IOBindingRunAsyncCallback callback) ORT_MUST_USE_RESULT;
+
+  /**
+    * Return the memory held by the arenas of the execution providers to the devices, keeping the regions used in
+    * the last min_idle_time. This is what session.arena_shrink_after_run does at the end of each Run, and can be
+    * called while Runs are in progress, e.g. from a timer of an application that becomes idle.
+    */
+  common::Status ShrinkMemoryArenas(std::chrono::seconds min_idle_time) ORT_MUST_USE_RESULT;
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -378,6 +430,31 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Get the per-node and per-op type latency statistics collected by the sampling profiler, which is enabled with
+    * the kOrtSessionOptionsConfigProfilingSampleRate config.
+    * @param stats_json the statistics in JSON format.
+    * @return OK if success.
+    */
+  common::Status GetSamplingProfileStats(std::string& stats_json) const;
+
+  /**
+    * Get the bytes in use of the arena allocators of the execution providers of the session.
+    * @param stats_json the statistics in JSON format, e.g.
+    *   {"arenas":[{"provider":"CPUExecutionProvider","device":"Cpu","deviceId":0,"bytesInUse":1048576}]}
+    * @return OK if success.
+    */
+  common::Status GetArenaStats(std::string& stats_json) const;
+
+  /**
+    * Get a breakdown of the memory of the session: initializers, pre-packed weights, planned activation peaks by
+    * input shapes, the planned bytes of the outputs of each node and the statistics of the arenas.
+    * The report is also written next to the profile when profiling ends, with a _memory.json suffix.
+    * @param report_json the report in JSON format. See CreateSessionMemoryReport for its content.
+    * @return OK if success.
+    */
+  common::Status GetMemoryReport(std::string& report_json) const;
+
   /**
     * Search registered execution providers for an allocator that has characteristics
     * specified within mem_info
@@ -456,6 +533,9 @@ class InferenceSession {
 
   common::Status SaveModelMetadata(const onnxruntime::Model& model) ORT_MUST_USE_RESULT;
 
+  // Write the statistics of the sampling profiler to sampling_profile_file_ if the export interval has passed.
+  void ExportSamplingProfileIfDue();
+
 #if !defined(ORT_MINIMAL_BUILD)
   common::Status Load(std::function<common::Status(std::shared_ptr<Model>&)> loader,
                       const std::string& event_name) ORT_MUST_USE_RESULT;
@@ -493,9 +573,40 @@ class InferenceSession {
 
   common::Status LoadOrtModel(std::function<Status()> load_ort_format_model_bytes) ORT_MUST_USE_RESULT;
 
+  // Creates the Model from the ORT format bytes in ort_format_model_bytes_.
+  common::Status LoadOrtModelFromBytes() ORT_MUST_USE_RESULT;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  /**
+    * Get the path of the optimized model cache entry for the loaded model and the session configuration.
+    * @param cache_path Set to the path, or to an empty string if the optimized model cache is not used.
+    * @return OK if success.
+    */
+  common::Status GetOptimizedModelCachePath(std::basic_string<ORTCHAR_T>& cache_path) const ORT_MUST_USE_RESULT;
+
+  /**
+    * Replace the loaded model with the optimized model in the cache entry at cache_path.
+    * @return true if the cache entry exists and could be loaded, in which case Initialize uses the optimized
+    *         graph and the serialized SessionState from it instead of optimizing the model.
+    */
+  bool LoadOptimizedModelFromCache(const std::basic_string<ORTCHAR_T>& cache_path);
+
+  // Save the optimized model to the cache entry at cache_path. Failures are logged as the cache is optional.
+  void SaveOptimizedModelToCache(const std::basic_string<ORTCHAR_T>& cache_path) const;
+#endif
+
 #endif  // defined(ENABLE_ORT_FORMAT_LOAD)
 
+  // The implementation of Run(). If p_cached_feeds_fetches_manager is provided the manager it holds is used, and a
+  // new one is created and stored in it if it is empty, so the feed/fetch info is computed once for repeated Runs.
+  // p_fetches_device_info is only applied when the manager is created.
+  common::Status RunImpl(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                         const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                         std::vector<OrtValue>* p_fetches, const std::vector<OrtDevice>* p_fetches_device_info,
+                         std::unique_ptr<FeedsFetchesManager>* p_cached_feeds_fetches_manager) ORT_MUST_USE_RESULT;
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
+  // The session logger is used if a new logger would be configured the same way.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
   // If the default logger is used, new_run_logger will remain empty.
@@ -514,13 +625,26 @@ class InferenceSession {
   common::Status ValidateOutputs(const std::vector<std::string>& output_names,
                                  const std::vector<OrtValue>* p_fetches) const ORT_MUST_USE_RESULT;
 
+  // Pads the feeds to the buckets of their symbolic dimensions, see kOrtSessionOptionsConfigPadBuckets.
+  // padded_feeds is left empty if no feed needs padding, otherwise dim_sizes receives the unpadded size of each
+  // padded dimension.
+  common::Status PadFeeds(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                          std::vector<OrtValue>& padded_feeds,
+                          std::unordered_map<std::string, int64_t>& dim_sizes) const ORT_MUST_USE_RESULT;
+
+  // Slices the dimensions of the fetches that PadFeeds padded back to their unpadded sizes.
+  common::Status SliceFetches(const std::vector<std::string>& output_names,
+                              const std::unordered_map<std::string, int64_t>& dim_sizes,
+                              std::vector<OrtValue>& fetches) const ORT_MUST_USE_RESULT;
+
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) ORT_MUST_USE_RESULT;
 
   template <typename T>
   void StartProfiling(const std::basic_string<T>& file_prefix);
 
-  // Updates all providers with the allocators from the env based on OrtMemoryInfo
-  void UpdateProvidersWithSharedAllocators();
+  // Updates all providers with the allocators from the env based on OrtMemoryInfo, wrapped in a CappedAllocator
+  // accounting the usage of this session if a limit is set.
+  void UpdateProvidersWithSharedAllocators(size_t soft_limit, size_t hard_limit);
 
 #if !defined(ORT_MINIMAL_BUILD)
   virtual void AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
@@ -604,6 +728,42 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // The execution provider that captures the device work of a Run into a graph (e.g. a CUDA graph) and replays it
+  // on later Runs with the same feeds and fetches. Runs are serialized while it is set, as a replayed graph reuses
+  // the intermediate buffers that were allocated while capturing.
+  IExecutionProvider* graph_capture_ep_ = nullptr;
+  // keys of the Runs that have been executed once without capturing, so the arena and per-kernel caches
+  // (e.g. cudnn algo search) are warmed up before a capture, as those need calls that are illegal while capturing.
+  std::unordered_set<uint64_t> graph_capture_warmed_up_keys_;  // GUARDED_BY(graph_capture_mutex_)
+  onnxruntime::OrtMutex graph_capture_mutex_;
+
+  // The weight of the Runs on the intra-op thread pool, see kOrtSessionOptionsConfigIntraOpThreadPoolWeight.
+  int intra_op_thread_pool_weight_ = 0;
+
+  // Whether to shrink the arenas at the end of each Run, and the time their regions must have been unused for.
+  bool arena_shrink_after_run_ = false;
+  std::chrono::seconds arena_shrink_min_idle_time_{0};
+
+  // The buckets of the symbolic dimensions the feeds are padded to, see kOrtSessionOptionsConfigPadBuckets, and the
+  // axes and dim_params of those dimensions in the graph inputs and outputs.
+  shape_buckets::BucketMap pad_buckets_;
+  std::unordered_map<std::string, std::vector<std::pair<size_t, std::string>>> padded_input_axes_;
+  std::unordered_map<std::string, std::vector<std::pair<size_t, std::string>>> padded_output_axes_;
+
+  // The file the statistics of the sampling profiler are written to after a Run once the interval has passed.
+  std::string sampling_profile_file_;
+  std::chrono::seconds sampling_profile_export_interval_{60};
+  TimePoint sampling_profile_last_export_;  // GUARDED_BY(sampling_profile_exporting_)
+  std::atomic<bool> sampling_profile_exporting_{false};
+
+  // Schedules run on the intra-op pool, counting it in num_async_runs_ until it returns.
+  common::Status ScheduleAsyncRun(std::function<void()> run);
+
+  // Number of RunAsync calls whose callback hasn't returned yet. The destructor waits for it to drop to 0.
+  size_t num_async_runs_ = 0;  // GUARDED_BY(async_runs_mutex_)
+  onnxruntime::OrtMutex async_runs_mutex_;
+  onnxruntime::OrtCondVar async_runs_cv_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
@@ -642,9 +802,13 @@ class InferenceSession {
   // We store them currently to make the Load + Initialize behave the same way as for an ONNX model
   // as we need some of the bytes for the Load (create the Model) and some for the Initialize (create SessionState).
   // Short term we free them after Initialize.
-  // Longer term we may want to directly refer to offsets in this buffer for initializers so we don't need to copy
-  // those into new OrtValue instances, at which point we won't free them until the InferenceSession goes away.
-  std::vector<uint8_t> ort_format_model_bytes_;
+  // The bytes are either copied into ort_format_model_bytes_data_holder_ or, when loading from a file with
+  // session.map_ort_model_initializers enabled, memory mapped in ort_format_model_mapped_memory_. In the latter case
+  // the initializers refer to their location in the model file and are mapped again when the SessionState is
+  // created, so they share the page cache with other processes using the model instead of being copied.
+  gsl::span<const uint8_t> ort_format_model_bytes_;
+  std::vector<uint8_t> ort_format_model_bytes_data_holder_;
+  Env::MappedMemoryPtr ort_format_model_mapped_memory_;
 };
 
 struct SessionIOBinding {
@@ -0,0 +1,216 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/inference_session_group.h"
+
+#include <algorithm>
+
+#include "core/framework/mem_buffer.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/batch_utils.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+#if !defined(ORT_MINIMAL_BUILD)
+// decodes the initializers of the main graph of model_data to CPU tensors in buffers of their own
+static common::Status DecodeInitializers(const void* model_data, int model_data_len,
+                                         std::vector<std::unique_ptr<char[]>>& buffers,
+                                         std::vector<std::unique_ptr<OrtValue>>& values,
+                                         std::vector<std::string>& names) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  if (!model_proto.ParseFromArray(model_data, model_data_len)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "Failed to load model because protobuf parsing failed.");
+  }
+
+  const OrtMemoryInfo cpu_memory_info(CPU, OrtDeviceAllocator);
+  for (const auto& tensor_proto : model_proto.graph().initializer()) {
+    if (tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+        tensor_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL) {
+      continue;
+    }
+
+    size_t size_in_bytes;
+    ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes));
+    std::unique_ptr<char[]> buffer(new char[std::max<size_t>(size_in_bytes, 1)]);
+    auto value = onnxruntime::make_unique<OrtValue>();
+    OrtCallback deleter{nullptr, nullptr};
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(Env::Default(), nullptr, tensor_proto,
+                                                    MemBuffer(buffer.get(), size_in_bytes, cpu_memory_info),
+                                                    *value, deleter));
+    // only string and external data tensors need a deleter
+    ORT_ENFORCE(deleter.f == nullptr);
+
+    buffers.push_back(std::move(buffer));
+    values.push_back(std::move(value));
+    names.push_back(tensor_proto.name());
+  }
+
+  return Status::OK();
+}
+#endif
+
+common::Status InferenceSessionGroup::Create(const SessionOptions& session_options, const Environment& session_env,
+                                             const void* model_data, int model_data_len,
+                                             const std::vector<int>& device_ids,
+                                             const ProviderFactory& provider_factory,
+                                             std::unique_ptr<InferenceSessionGroup>& group) {
+  if (device_ids.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "An InferenceSessionGroup requires at least one device.");
+  }
+
+  // private constructor, can't use make_unique
+  std::unique_ptr<InferenceSessionGroup> new_group(new InferenceSessionGroup());
+  SessionOptions replica_options = session_options;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  std::vector<std::string> initializer_names;
+  ORT_RETURN_IF_ERROR(DecodeInitializers(model_data, model_data_len, new_group->initializer_buffers_,
+                                         new_group->initializers_, initializer_names));
+  for (size_t i = 0; i < initializer_names.size(); ++i) {
+    // initializers the user supplied in session_options take precedence
+    if (replica_options.initializers_to_share_map.count(initializer_names[i]) == 0) {
+      ORT_RETURN_IF_ERROR(replica_options.AddInitializer(initializer_names[i].c_str(),
+                                                         new_group->initializers_[i].get()));
+    }
+  }
+#endif
+
+  for (int device_id : device_ids) {
+    auto provider = provider_factory(device_id);
+    if (provider == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the execution provider for device ", device_id);
+    }
+
+    auto replica = onnxruntime::make_unique<Replica>();
+    replica->device_id = device_id;
+    replica->session = onnxruntime::make_unique<InferenceSession>(replica_options, session_env);
+    ORT_RETURN_IF_ERROR(replica->session->RegisterExecutionProvider(std::move(provider)));
+    ORT_RETURN_IF_ERROR(replica->session->Load(model_data, model_data_len));
+    ORT_RETURN_IF_ERROR(replica->session->Initialize());
+    new_group->replicas_.push_back(std::move(replica));
+  }
+
+  group = std::move(new_group);
+  return Status::OK();
+}
+
+InferenceSessionGroup::~InferenceSessionGroup() = default;
+
+size_t InferenceSessionGroup::AcquireReplica() {
+  const size_t num_replicas = replicas_.size();
+  const size_t start = next_replica_++ % num_replicas;
+  size_t best = start;
+  for (size_t offset = 1; offset < num_replicas; ++offset) {
+    const size_t i = (start + offset) % num_replicas;
+    if (replicas_[i]->runs_in_flight < replicas_[best]->runs_in_flight) {
+      best = i;
+    }
+  }
+
+  // concurrent callers may pick the same replica, which only makes the balancing approximate
+  ++replicas_[best]->runs_in_flight;
+  return best;
+}
+
+common::Status InferenceSessionGroup::RunOnReplica(size_t i, const RunOptions& run_options, const NameMLValMap& feeds,
+                                                   const std::vector<std::string>& output_names,
+                                                   std::vector<OrtValue>* p_fetches) {
+  Status status;
+  ORT_TRY {
+    status = replicas_[i]->session->Run(run_options, feeds, output_names, p_fetches);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+
+  --replicas_[i]->runs_in_flight;
+  return status;
+}
+
+common::Status InferenceSessionGroup::Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          std::vector<OrtValue>* p_fetches) {
+  return RunOnReplica(AcquireReplica(), run_options, feeds, output_names, p_fetches);
+}
+
+common::Status InferenceSessionGroup::RunSplitBatch(const RunOptions& run_options, const NameMLValMap& feeds,
+                                                    const std::vector<std::string>& output_names,
+                                                    std::vector<OrtValue>* p_fetches) {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+  std::vector<NameMLValMap> part_feeds;
+  ORT_RETURN_IF_ERROR(batch_utils::SplitBatch(feeds, replicas_.size(), part_feeds));
+  const int64_t num_parts = static_cast<int64_t>(part_feeds.size());
+  if (num_parts <= 1) {
+    return Run(run_options, feeds, output_names, p_fetches);
+  }
+
+  // the parts other than the first run on the intra-op pools of their sessions, the first one on this thread.
+  // starting the Runs reserves each replica before the next one is picked, so the parts go to different replicas.
+  std::vector<std::vector<OrtValue>> part_fetches(num_parts);
+  std::vector<Status> statuses(num_parts);
+  std::vector<size_t> replica_indices(num_parts);
+  for (auto& replica_index : replica_indices) {
+    replica_index = AcquireReplica();
+  }
+
+  OrtMutex mutex;
+  OrtCondVar parts_done;
+  int64_t num_async_parts = 0;
+  for (int64_t part = 1; part < num_parts; ++part) {
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feed_values;
+    for (const auto& feed : part_feeds[part]) {
+      feed_names.push_back(feed.first);
+      feed_values.push_back(feed.second);
+    }
+
+    const size_t i = replica_indices[part];
+    auto callback = [this, i, part, &part_fetches, &statuses, &mutex, &parts_done, &num_async_parts](
+                        const Status& status, std::vector<OrtValue>& fetches) {
+      --replicas_[i]->runs_in_flight;
+      part_fetches[part] = std::move(fetches);
+      statuses[part] = status;
+      std::lock_guard<OrtMutex> lock(mutex);
+      if (--num_async_parts == 0) {
+        parts_done.notify_all();
+      }
+    };
+
+    {
+      std::lock_guard<OrtMutex> lock(mutex);
+      ++num_async_parts;
+    }
+    Status schedule_status = replicas_[i]->session->RunAsync(run_options, std::move(feed_names),
+                                                             std::move(feed_values), output_names, {}, callback);
+    if (!schedule_status.IsOK()) {
+      // e.g. the session has no intra-op thread pool to run on
+      {
+        std::lock_guard<OrtMutex> lock(mutex);
+        --num_async_parts;
+      }
+      statuses[part] = RunOnReplica(i, run_options, part_feeds[part], output_names, &part_fetches[part]);
+    }
+  }
+
+  statuses[0] = RunOnReplica(replica_indices[0], run_options, part_feeds[0], output_names, &part_fetches[0]);
+
+  {
+    std::unique_lock<OrtMutex> lock(mutex);
+    parts_done.wait(lock, [&num_async_parts]() { return num_async_parts == 0; });
+  }
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  auto allocator = replicas_[0]->session->GetAllocator(OrtMemoryInfo(CPU, OrtDeviceAllocator));
+  return batch_utils::ConcatBatch(part_fetches, output_names, allocator, *p_fetches);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/execution_provider.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/session_options.h"
+
+namespace onnxruntime {
+class Environment;
+class InferenceSession;
+struct RunOptions;
+
+/**
+Replicates a model over several devices for data-parallel inference, with one InferenceSession per device.
+
+The model is parsed once, and its initializers are decoded once into CPU tensors owned by the group, which the
+sessions use through SessionOptions::AddInitializer: the initializers placed on the CPU are shared by all the sessions,
+the ones placed on a device are copied from them to the device of each session.
+
+Run executes on the session with the fewest Runs in flight. RunSplitBatch splits the feeds along their first
+dimension, runs the parts on different sessions concurrently and concatenates the outputs.
+
+Typical use, with one CUDA execution provider per GPU:
+  std::unique_ptr<InferenceSessionGroup> group;
+  ORT_RETURN_IF_ERROR(InferenceSessionGroup::Create(
+      session_options, env, model_data, model_data_len, {0, 1, 2, 3},
+      [](int device_id) {
+        CUDAExecutionProviderInfo info;
+        info.device_id = static_cast<OrtDevice::DeviceId>(device_id);
+        return std::unique_ptr<IExecutionProvider>(onnxruntime::make_unique<CUDAExecutionProvider>(info));
+      },
+      group));
+  ORT_RETURN_IF_ERROR(group->Run(run_options, feeds, output_names, &fetches));
+*/
+class InferenceSessionGroup {
+ public:
+  /** Creates the execution provider of the session for device_id. */
+  using ProviderFactory = std::function<std::unique_ptr<IExecutionProvider>(int device_id)>;
+
+  /**
+    * Creates and initializes a session for each of device_ids from the serialized model in model_data.
+    * The initializers in external data files, and string initializers, are decoded by each session.
+    */
+  static common::Status Create(const SessionOptions& session_options, const Environment& session_env,
+                               const void* model_data, int model_data_len, const std::vector<int>& device_ids,
+                               const ProviderFactory& provider_factory,
+                               std::unique_ptr<InferenceSessionGroup>& group) ORT_MUST_USE_RESULT;
+
+  ~InferenceSessionGroup();
+
+  /** Runs feeds on the session with the fewest Runs in flight. */
+  common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<OrtValue>* p_fetches) ORT_MUST_USE_RESULT;
+
+  /**
+    * Splits the CPU tensors in feeds along their first dimension, which all of them must have the same size for,
+    * into up to Size() parts, runs them concurrently on different sessions, and concatenates the outputs of the parts
+    * along their first dimension in CPU tensors.
+    * The outputs of the model must have the batch as their first dimension.
+    */
+  common::Status RunSplitBatch(const RunOptions& run_options, const NameMLValMap& feeds,
+                               const std::vector<std::string>& output_names,
+                               std::vector<OrtValue>* p_fetches) ORT_MUST_USE_RESULT;
+
+  size_t Size() const { return replicas_.size(); }
+
+  InferenceSession& GetSession(size_t i) { return *replicas_[i]->session; }
+
+  int DeviceId(size_t i) const { return replicas_[i]->device_id; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSessionGroup);
+
+  InferenceSessionGroup() = default;
+
+  struct Replica {
+    int device_id;
+    std::unique_ptr<InferenceSession> session;
+    std::atomic<int> runs_in_flight{0};
+  };
+
+  // returns the index of the replica with the fewest Runs in flight, whose count is incremented
+  size_t AcquireReplica();
+
+  common::Status RunOnReplica(size_t i, const RunOptions& run_options, const NameMLValMap& feeds,
+                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  // the CPU tensors of the initializers given to the sessions, and their buffers. declared before replicas_ so they
+  // outlive the sessions.
+  std::vector<std::unique_ptr<char[]>> initializer_buffers_;
+  std::vector<std::unique_ptr<OrtValue>> initializers_;
+
+  std::vector<std::unique_ptr<Replica>> replicas_;
+  // start of the search of AcquireReplica, so that idle replicas take turns
+  std::atomic<size_t> next_replica_{0};
+};
+
+}  // namespace onnxruntime
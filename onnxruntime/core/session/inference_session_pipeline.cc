@@ -0,0 +1,324 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/inference_session_pipeline.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+#include "core/session/batch_utils.h"
+#include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
+#include "core/util/thread_utils.h"
+
+namespace onnxruntime {
+
+// the value names consumed by node, including the outer scope values of its subgraphs
+static std::vector<const NodeArg*> GetConsumedArgs(const Node& node) {
+  std::vector<const NodeArg*> args;
+  for (const auto* defs : {&node.InputDefs(), &node.ImplicitInputDefs()}) {
+    for (const NodeArg* arg : *defs) {
+      if (arg->Exists()) {
+        args.push_back(arg);
+      }
+    }
+  }
+  return args;
+}
+
+common::Status InferenceSessionPipeline::PartitionModel(const ONNX_NAMESPACE::ModelProto& model_proto,
+                                                        size_t num_stages, const logging::Logger& logger,
+                                                        std::vector<ONNX_NAMESPACE::ModelProto>& stage_models) {
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(model_proto, model, nullptr, logger));
+  const Graph& graph = model->MainGraph();
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  if (num_stages == 0 || order.size() < num_stages) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Cannot partition a graph of ", order.size(),
+                           " nodes into ", num_stages, " pipeline stages.");
+  }
+
+  // the cost of a node is the size of the initializers it is the first consumer of, plus one so that the nodes
+  // without initializers are spread over the stages too
+  std::unordered_set<std::string> counted_initializers;
+  std::vector<double> costs;
+  costs.reserve(order.size());
+  double total_cost = 0;
+  for (NodeIndex index : order) {
+    double cost = 1;
+    for (const NodeArg* arg : GetConsumedArgs(*graph.GetNode(index))) {
+      const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+      size_t size_in_bytes = 0;
+      if (graph.GetInitializedTensor(arg->Name(), initializer) && counted_initializers.insert(arg->Name()).second &&
+          utils::GetSizeInBytesFromTensorProto<0>(*initializer, &size_in_bytes).IsOK()) {
+        cost += static_cast<double>(size_in_bytes);
+      }
+    }
+    costs.push_back(cost);
+    total_cost += cost;
+  }
+
+  // a stage ends once the cost of the nodes so far reaches its share, or when the remaining nodes are needed for
+  // one stage each
+  std::unordered_map<NodeIndex, size_t> node_stages;
+  size_t stage = 0;
+  size_t stage_begin = 0;
+  double prefix_cost = 0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (stage + 1 < num_stages && i > stage_begin &&
+        (prefix_cost >= total_cost * static_cast<double>(stage + 1) / static_cast<double>(num_stages) ||
+         order.size() - i == num_stages - stage - 1)) {
+      ++stage;
+      stage_begin = i;
+    }
+    node_stages[order[i]] = stage;
+    prefix_cost += costs[i];
+  }
+
+  // the last stage consuming each value
+  std::unordered_map<std::string, size_t> last_consumer_stages;
+  for (NodeIndex index : order) {
+    for (const NodeArg* arg : GetConsumedArgs(*graph.GetNode(index))) {
+      auto& last_stage = last_consumer_stages[arg->Name()];
+      last_stage = std::max(last_stage, node_stages[index]);
+    }
+  }
+  std::unordered_set<std::string> graph_outputs;
+  for (const NodeArg* arg : graph.GetOutputs()) {
+    graph_outputs.insert(arg->Name());
+  }
+
+  stage_models.clear();
+  stage_models.resize(num_stages);
+  for (auto& stage_model : stage_models) {
+    stage_model.set_ir_version(model_proto.ir_version());
+    *stage_model.mutable_opset_import() = model_proto.opset_import();
+    stage_model.set_producer_name(model_proto.producer_name());
+    stage_model.set_producer_version(model_proto.producer_version());
+  }
+
+  std::vector<std::unordered_set<std::string>> stage_values(num_stages);
+  for (NodeIndex index : order) {
+    const Node& node = *graph.GetNode(index);
+    const size_t s = node_stages[index];
+    auto& stage_graph = *stage_models[s].mutable_graph();
+    auto& values = stage_values[s];
+    if (stage_graph.name().empty()) {
+      stage_graph.set_name(graph.Name() + "_stage_" + std::to_string(s));
+    }
+    node.ToProto(*stage_graph.add_node());
+
+    for (const NodeArg* arg : GetConsumedArgs(node)) {
+      if (!values.insert(arg->Name()).second) {
+        continue;
+      }
+
+      const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+      if (graph.GetInitializedTensor(arg->Name(), initializer)) {
+        *stage_graph.add_initializer() = *initializer;
+      } else {
+        ORT_RETURN_IF_NOT(arg->TypeAsProto() != nullptr, "The type of ", arg->Name(), " consumed by stage ", s,
+                          " is unknown.");
+        *stage_graph.add_input() = arg->ToProto();
+      }
+    }
+
+    for (const NodeArg* arg : node.OutputDefs()) {
+      if (!arg->Exists()) {
+        continue;
+      }
+      values.insert(arg->Name());
+      auto consumer = last_consumer_stages.find(arg->Name());
+      if (graph_outputs.count(arg->Name()) != 0 ||
+          (consumer != last_consumer_stages.end() && consumer->second > s)) {
+        ORT_RETURN_IF_NOT(arg->TypeAsProto() != nullptr, "The type of ", arg->Name(), " produced by stage ", s,
+                          " is unknown.");
+        *stage_graph.add_output() = arg->ToProto();
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSessionPipeline::Create(const SessionOptions& session_options,
+                                                const Environment& session_env,
+                                                const void* model_data, int model_data_len,
+                                                const std::vector<int>& device_ids,
+                                                const ProviderFactory& provider_factory,
+                                                std::unique_ptr<InferenceSessionPipeline>& pipeline) {
+  if (device_ids.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "An InferenceSessionPipeline requires at least one device.");
+  }
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  if (!model_proto.ParseFromArray(model_data, model_data_len)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "Failed to load model because protobuf parsing failed.");
+  }
+
+  std::vector<ONNX_NAMESPACE::ModelProto> stage_models;
+  ORT_RETURN_IF_ERROR(PartitionModel(model_proto, device_ids.size(), logging::LoggingManager::DefaultLogger(),
+                                     stage_models));
+  std::unordered_set<std::string> graph_outputs;
+  for (const auto& output : model_proto.graph().output()) {
+    graph_outputs.insert(output.name());
+  }
+  model_proto.Clear();
+
+  // the last stage consuming each value
+  std::unordered_map<std::string, size_t> last_consumer_stages;
+
+  // private constructor, can't use make_unique
+  std::unique_ptr<InferenceSessionPipeline> new_pipeline(new InferenceSessionPipeline());
+  new_pipeline->stages_.resize(device_ids.size());
+  for (size_t s = 0; s < device_ids.size(); ++s) {
+    auto& stage = new_pipeline->stages_[s];
+    const auto& stage_graph = stage_models[s].graph();
+    for (const auto& input : stage_graph.input()) {
+      stage.input_names.push_back(input.name());
+      last_consumer_stages[input.name()] = s;
+    }
+    for (const auto& output : stage_graph.output()) {
+      stage.output_names.push_back(output.name());
+    }
+
+    auto provider = provider_factory(device_ids[s]);
+    if (provider == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the execution provider for device ", device_ids[s]);
+    }
+    auto allocator = provider->GetAllocator(0, OrtMemTypeDefault);
+    ORT_RETURN_IF_NOT(allocator != nullptr, "The execution provider for device ", device_ids[s],
+                      " has no default allocator.");
+    stage.device_id = device_ids[s];
+    stage.device = allocator->Info().device;
+
+    std::string stage_model_data;
+    stage_models[s].SerializeToString(&stage_model_data);
+    stage_models[s].Clear();
+    stage.session = onnxruntime::make_unique<InferenceSession>(session_options, session_env);
+    ORT_RETURN_IF_ERROR(stage.session->RegisterExecutionProvider(std::move(provider)));
+    ORT_RETURN_IF_ERROR(stage.session->Load(stage_model_data.data(), static_cast<int>(stage_model_data.size())));
+    ORT_RETURN_IF_ERROR(stage.session->Initialize());
+  }
+
+  for (size_t s = 0; s < device_ids.size(); ++s) {
+    auto& stage = new_pipeline->stages_[s];
+    for (const auto& name : stage.output_names) {
+      // the outputs that are only consumed by later stages stay on the device, the graph outputs go to the CPU
+      stage.outputs_on_device.push_back(graph_outputs.count(name) == 0);
+    }
+  }
+  for (const auto& entry : last_consumer_stages) {
+    if (graph_outputs.count(entry.first) == 0) {
+      new_pipeline->stages_[entry.second].last_uses.push_back(entry.first);
+    }
+  }
+
+  // one thread per stage, the calling thread running one of them. the threads are blocked on the devices most of the
+  // time, so they don't spin.
+  OrtThreadPoolParams thread_pool_params;
+  thread_pool_params.thread_pool_size = static_cast<int>(device_ids.size());
+  thread_pool_params.allow_spinning = false;
+  new_pipeline->thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), thread_pool_params,
+                                                             concurrency::ThreadPoolType::INTER_OP);
+
+  pipeline = std::move(new_pipeline);
+  return Status::OK();
+}
+
+InferenceSessionPipeline::~InferenceSessionPipeline() = default;
+
+common::Status InferenceSessionPipeline::RunStage(size_t s, const RunOptions& run_options, NameMLValMap& values) {
+  auto& stage = stages_[s];
+  std::unique_ptr<IOBinding> io_binding;
+  ORT_RETURN_IF_ERROR(stage.session->NewIOBinding(&io_binding));
+  for (const auto& name : stage.input_names) {
+    auto it = values.find(name);
+    if (it == values.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Missing input ", name, " of pipeline stage ", s);
+    }
+    ORT_RETURN_IF_ERROR(io_binding->BindInput(name, it->second));
+  }
+  for (size_t i = 0; i < stage.output_names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(io_binding->BindOutput(stage.output_names[i],
+                                               stage.outputs_on_device[i] ? stage.device : OrtDevice()));
+  }
+
+  ORT_RETURN_IF_ERROR(stage.session->Run(run_options, *io_binding));
+
+  const auto& outputs = io_binding->GetOutputs();
+  for (size_t i = 0; i < stage.output_names.size(); ++i) {
+    values[stage.output_names[i]] = outputs[i];
+  }
+  // release the device buffers that aren't needed anymore
+  for (const auto& name : stage.last_uses) {
+    values.erase(name);
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSessionPipeline::Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                                             const std::vector<std::string>& output_names,
+                                             std::vector<OrtValue>* p_fetches, size_t num_micro_batches) {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+  std::vector<NameMLValMap> micro_batches;
+  if (num_micro_batches <= 1) {
+    micro_batches.push_back(feeds);
+  } else {
+    ORT_RETURN_IF_ERROR(batch_utils::SplitBatch(feeds, num_micro_batches, micro_batches));
+  }
+
+  // in step t, stage s runs micro-batch t - s
+  const size_t num_stages = stages_.size();
+  const size_t num_batches = micro_batches.size();
+  for (size_t step = 0; step + 1 < num_stages + num_batches; ++step) {
+    const size_t first_stage = step < num_batches ? 0 : step - num_batches + 1;
+    const size_t last_stage = std::min(step, num_stages - 1);
+    std::vector<Status> statuses(last_stage - first_stage + 1);
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool_.get(), static_cast<std::ptrdiff_t>(statuses.size()), [&](std::ptrdiff_t i) {
+          const size_t s = first_stage + i;
+          ORT_TRY {
+            statuses[i] = RunStage(s, run_options, micro_batches[step - s]);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+            });
+          }
+        });
+
+    for (const auto& status : statuses) {
+      ORT_RETURN_IF_ERROR(status);
+    }
+  }
+
+  std::vector<std::vector<OrtValue>> batch_fetches(num_batches);
+  for (size_t m = 0; m < num_batches; ++m) {
+    for (const auto& name : output_names) {
+      auto it = micro_batches[m].find(name);
+      if (it == micro_batches[m].end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name: ", name);
+      }
+      batch_fetches[m].push_back(it->second);
+    }
+  }
+
+  if (num_batches == 1) {
+    *p_fetches = std::move(batch_fetches[0]);
+    return Status::OK();
+  }
+
+  auto allocator = stages_.back().session->GetAllocator(OrtMemoryInfo(CPU, OrtDeviceAllocator));
+  return batch_utils::ConcatBatch(batch_fetches, output_names, allocator, *p_fetches);
+}
+
+}  // namespace onnxruntime
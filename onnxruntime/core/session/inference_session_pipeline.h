@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/status.h"
+#include "core/framework/execution_provider.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/session_options.h"
+#include "core/platform/threadpool.h"
+
+namespace ONNX_NAMESPACE {
+class ModelProto;
+}  // namespace ONNX_NAMESPACE
+
+namespace onnxruntime {
+class Environment;
+class InferenceSession;
+struct RunOptions;
+
+/**
+Pipeline model parallel inference for models that don't fit on one device.
+
+The nodes of the main graph are partitioned in topological order into contiguous stages of about the same size of
+initializers, one per device, with a session per stage that only holds the initializers of its nodes. The values a
+stage produces for a later stage stay on its device and are copied to the device of the consumer by its data transfer,
+e.g. a peer to peer copy between two GPUs.
+
+Run splits the feeds along their first dimension into micro-batches which go through the stages in a wavefront: while
+stage s runs micro-batch m, stage s + 1 runs micro-batch m - 1, so that all the devices are busy once the pipeline is
+full.
+*/
+class InferenceSessionPipeline {
+ public:
+  /** Creates the execution provider of the session for device_id. */
+  using ProviderFactory = std::function<std::unique_ptr<IExecutionProvider>(int device_id)>;
+
+  /** Partitions and creates a stage for each of device_ids from the serialized model in model_data. */
+  static common::Status Create(const SessionOptions& session_options, const Environment& session_env,
+                               const void* model_data, int model_data_len, const std::vector<int>& device_ids,
+                               const ProviderFactory& provider_factory,
+                               std::unique_ptr<InferenceSessionPipeline>& pipeline) ORT_MUST_USE_RESULT;
+
+  /**
+    * Partitions the nodes of the main graph of model_proto in topological order into num_stages contiguous ranges.
+    * The inputs of each of stage_models are the values it consumes from the graph inputs or the earlier stages, its
+    * outputs the values consumed by later stages or that are graph outputs, and it has the initializers of its nodes.
+    */
+  static common::Status PartitionModel(const ONNX_NAMESPACE::ModelProto& model_proto, size_t num_stages,
+                                       const logging::Logger& logger,
+                                       std::vector<ONNX_NAMESPACE::ModelProto>& stage_models) ORT_MUST_USE_RESULT;
+
+  ~InferenceSessionPipeline();
+
+  /**
+    * Runs feeds through the stages in num_micro_batches micro-batches, split along the first dimension of feeds, which
+    * then must be CPU tensors. The outputs of the micro-batches are concatenated along their first dimension.
+    */
+  common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
+                     size_t num_micro_batches = 1) ORT_MUST_USE_RESULT;
+
+  size_t NumStages() const { return stages_.size(); }
+
+  InferenceSession& GetStageSession(size_t i) { return *stages_[i].session; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSessionPipeline);
+
+  InferenceSessionPipeline() = default;
+
+  struct Stage {
+    int device_id;
+    // the device of the outputs consumed by later stages
+    OrtDevice device;
+    std::unique_ptr<InferenceSession> session;
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    std::vector<bool> outputs_on_device;
+    // the values that no later stage consumes once this one has run
+    std::vector<std::string> last_uses;
+  };
+
+  // runs stage s on the values of a micro-batch, adding its outputs to them
+  common::Status RunStage(size_t s, const RunOptions& run_options, NameMLValMap& values);
+
+  std::vector<Stage> stages_;
+  std::unique_ptr<concurrency::ThreadPool> thread_pool_;
+};
+
+}  // namespace onnxruntime
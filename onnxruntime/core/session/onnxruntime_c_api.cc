@@ -533,17 +533,18 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
-ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
-                    _In_reads_(input_len) const char* const* input_names,
-                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
-                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
-                    _Inout_updates_all_(output_names_len) OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+namespace {
+// Converts the arguments of Run and RunAsync to the ones of InferenceSession::Run
+OrtStatus* GetRunFeedsAndFetches(_In_reads_(input_len) const char* const* input_names,
+                                 _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                                 _In_reads_(output_names_len) const char* const* output_names1,
+                                 size_t output_names_len, _In_reads_(output_names_len) OrtValue* const* output,
+                                 std::vector<std::string>& feed_names, std::vector<OrtValue>& feeds,
+                                 std::vector<std::string>& output_names, std::vector<OrtValue>& fetches) {
   const int queue_id = 0;
 
-  std::vector<std::string> feed_names(input_len);
-  std::vector<OrtValue> feeds(input_len);
+  feed_names.resize(input_len);
+  feeds.resize(input_len);
 
   for (size_t i = 0; i != input_len; ++i) {
     if (input_names[i] == nullptr || input_names[i][0] == '\0') {
@@ -557,7 +558,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
   }
 
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
@@ -565,7 +566,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
     output_names[i] = output_names1[i];
   }
 
-  std::vector<OrtValue> fetches(output_names_len);
+  fetches.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output[i] != nullptr) {
       ::OrtValue& value = *(output[i]);
@@ -574,6 +575,41 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
       fetches[i] = value;
     }
   }
+
+  return nullptr;
+}
+
+// Hands the fetches of a successful Run to the caller. New OrtValues are created for the outputs that were null.
+void SetRunOutputs(std::vector<OrtValue>& fetches, _Inout_updates_all_(fetches.size()) OrtValue** output) {
+  const int queue_id = 0;
+  for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  auto* args_status = GetRunFeedsAndFetches(input_names, input, input_len, output_names1, output_names_len, output,
+                                            feed_names, feeds, output_names, fetches);
+  if (args_status != nullptr)
+    return args_status;
+
   Status status;
   if (run_options == nullptr) {
     OrtRunOptions op;
@@ -584,18 +620,56 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
 
   if (!status.IsOK())
     return ToOrtStatus(status);
-  for (size_t i = 0; i != output_names_len; ++i) {
-    ::OrtValue& value = fetches[i];
-    if (value.Fence())
-      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
-    if (output[i] == nullptr) {
-      output[i] = new OrtValue(value);
-    }
-  }
+  SetRunOutputs(fetches, output);
   return nullptr;
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output,
+                    _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  if (run_async_callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "run_async_callback cannot be null");
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  auto* args_status = GetRunFeedsAndFetches(input_names, input, input_len, output_names1, output_names_len, output,
+                                            feed_names, feeds, output_names, fetches);
+  if (args_status != nullptr)
+    return args_status;
+
+  // the default options have to outlive the Run
+  std::shared_ptr<OrtRunOptions> default_run_options;
+  if (run_options == nullptr) {
+    default_run_options = std::make_shared<OrtRunOptions>();
+    run_options = default_run_options.get();
+  }
+
+  auto callback = [default_run_options, output, run_async_callback, user_data](const Status& status,
+                                                                               std::vector<OrtValue>& run_fetches) {
+    if (!status.IsOK()) {
+      run_async_callback(user_data, output, run_fetches.size(), ToOrtStatus(status));
+      return;
+    }
+
+    SetRunOutputs(run_fetches, output);
+    run_async_callback(user_data, output, run_fetches.size(), nullptr);
+  };
+
+  return ToOrtStatus(session->RunAsync(*run_options, std::move(feed_names), std::move(feeds), std::move(output_names),
+                                       std::move(fetches), std::move(callback)));
+  API_IMPL_END
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -1803,6 +1877,51 @@ ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingStartTimeNs, _In_ const OrtSessi
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string stats_json;
+  auto status = session->GetSamplingProfileStats(stats_json);
+  if (!status.IsOK()) {
+    return ToOrtStatus(status);
+  }
+
+  *out = StrDup(stats_json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetArenaStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string stats_json;
+  auto status = session->GetArenaStats(stats_json);
+  if (!status.IsOK()) {
+    return ToOrtStatus(status);
+  }
+
+  *out = StrDup(stats_json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMemoryReport, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string report_json;
+  auto status = session->GetMemoryReport(report_json);
+  if (!status.IsOK()) {
+    return ToOrtStatus(status);
+  }
+
+  *out = StrDup(report_json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 // End support for non-tensor types
 
 static constexpr OrtApiBase ort_api_base = {
@@ -2031,10 +2150,17 @@ static constexpr OrtApi ort_api_1_to_6 = {
     // Version 6 - In development, feel free to add/remove/rearrange here
     &OrtApis::AddInitializer,
     &OrtApis::CreateEnvWithCustomLoggerAndGlobalThreadPools,
+    &OrtApis::RunAsync,
 #ifdef USE_CUDA
     &OrtApis::OrtSessionOptionsAppendExecutionProvider_CUDA,
 #endif
     &OrtApis::SetGlobalDenormalAsZero,
+    &OrtApis::RunOptionsSetStream,
+    &OrtApis::SessionGetProfilingStats,
+    &OrtApis::SessionGetArenaStats,
+    &OrtApis::SessionGetMemoryReport,
+    &OrtApis::RunOptionsSetIntraOpMaxDegreeOfParallelism,
+    &OrtApis::RunOptionsSetPriority,
 };
 
 // Assert to do a limited check to ensure Version 1 of OrtApi never changes (will detect an addition or deletion but not if they cancel out each other)
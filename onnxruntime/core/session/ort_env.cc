@@ -11,6 +11,8 @@
 #include "core/session/allocator_impl.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/provider_shutdown.h"
+#include "core/common/logging/sinks/async_sink.h"
+#include "core/platform/env.h"
 #ifdef __ANDROID__
 #include "core/platform/android/logging/android_log_sink.h"
 #else
@@ -24,6 +26,17 @@ OrtEnv* OrtEnv::p_instance_ = nullptr;
 int OrtEnv::ref_count_ = 0;
 onnxruntime::OrtMutex OrtEnv::m_;
 
+// Set to "1" to format and write the log messages on a background thread, see AsyncSink.
+static const char* const kAsyncLoggingEnvVar = "ORT_ASYNC_LOGGING";
+
+static std::unique_ptr<ISink> MaybeMakeAsync(std::unique_ptr<ISink> sink) {
+  if (Env::Default().GetEnvironmentVar(kAsyncLoggingEnvVar) == "1") {
+    return onnxruntime::make_unique<AsyncSink>(std::move(sink));
+  }
+
+  return sink;
+}
+
 LoggingWrapper::LoggingWrapper(OrtLoggingFunction logging_function, void* logger_param)
     : logging_function_(logging_function), logger_param_(logger_param) {
 }
@@ -56,7 +69,7 @@ OrtEnv* OrtEnv::GetInstance(const OrtEnv::LoggingManagerConstructionInfo& lm_inf
     if (lm_info.logging_function) {
       std::unique_ptr<ISink> logger = onnxruntime::make_unique<LoggingWrapper>(lm_info.logging_function,
                                                                                lm_info.logger_param);
-      lmgr.reset(new LoggingManager(std::move(logger),
+      lmgr.reset(new LoggingManager(MaybeMakeAsync(std::move(logger)),
                                     static_cast<Severity>(lm_info.default_warning_level),
                                     false,
                                     LoggingManager::InstanceType::Default,
@@ -68,7 +81,7 @@ OrtEnv* OrtEnv::GetInstance(const OrtEnv::LoggingManagerConstructionInfo& lm_inf
       ISink* sink = new CLogSink();
 #endif
 
-      lmgr.reset(new LoggingManager(std::unique_ptr<ISink>{sink},
+      lmgr.reset(new LoggingManager(MaybeMakeAsync(std::unique_ptr<ISink>{sink}),
                                     static_cast<Severity>(lm_info.default_warning_level),
                                     false,
                                     LoggingManager::InstanceType::Default,
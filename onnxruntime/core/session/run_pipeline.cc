@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/run_pipeline.h"
+
+#include <algorithm>
+
+#include "core/session/inference_session.h"
+#include "gsl/gsl"
+
+namespace onnxruntime {
+
+common::Status RunPipeline::Create(InferenceSession& session, size_t depth, std::unique_ptr<RunPipeline>& pipeline) {
+  if (depth == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The depth of a RunPipeline must be positive.");
+  }
+
+  // private constructor, can't use make_unique
+  std::unique_ptr<RunPipeline> new_pipeline(new RunPipeline(session));
+  new_pipeline->slots_.resize(depth);
+  for (auto& slot : new_pipeline->slots_) {
+    ORT_RETURN_IF_ERROR(session.NewIOBinding(&slot.io_binding));
+  }
+
+  pipeline = std::move(new_pipeline);
+  return Status::OK();
+}
+
+RunPipeline::~RunPipeline() {
+  Wait();
+}
+
+RunPipeline::Slot* RunPipeline::FindSlot(const IOBinding& io_binding) {
+  auto it = std::find_if(slots_.begin(), slots_.end(),
+                         [&io_binding](const Slot& slot) { return slot.io_binding.get() == &io_binding; });
+  return it == slots_.end() ? nullptr : &*it;
+}
+
+common::Status RunPipeline::AcquireBinding(IOBinding*& io_binding) {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  Slot* free_slot = nullptr;
+  slot_released_.wait(lock, [this, &free_slot]() {
+    auto it = std::find_if(slots_.begin(), slots_.end(),
+                           [](const Slot& slot) { return !slot.acquired && !slot.running; });
+    free_slot = it == slots_.end() ? nullptr : &*it;
+    return free_slot != nullptr;
+  });
+
+  free_slot->acquired = true;
+  io_binding = free_slot->io_binding.get();
+  return Status::OK();
+}
+
+common::Status RunPipeline::Submit(const RunOptions& run_options, IOBinding& io_binding, Callback callback) {
+  if (!callback) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Submit requires a callback.");
+  }
+
+  Slot* slot;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    slot = FindSlot(io_binding);
+    if (slot == nullptr || !slot->acquired) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The IOBinding was not acquired from this RunPipeline.");
+    }
+
+    slot->acquired = false;
+    slot->running = true;
+  }
+
+  auto shared_callback = std::make_shared<Callback>(std::move(callback));
+  auto status = session_.RunAsync(run_options, io_binding,
+                                  [this, slot, shared_callback](const Status& run_status, IOBinding& binding) {
+                                    // released even if the callback throws
+                                    auto release_slot = gsl::finally([this, slot]() {
+                                      std::lock_guard<OrtMutex> lock(mutex_);
+                                      slot->running = false;
+                                      slot_released_.notify_all();
+                                    });
+
+                                    (*shared_callback)(run_status, binding);
+                                  });
+
+  if (!status.IsOK()) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    slot->running = false;
+    slot_released_.notify_all();
+  }
+
+  return status;
+}
+
+void RunPipeline::ReleaseBinding(IOBinding& io_binding) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Slot* slot = FindSlot(io_binding);
+  if (slot != nullptr && slot->acquired) {
+    slot->acquired = false;
+    slot_released_.notify_all();
+  }
+}
+
+void RunPipeline::Wait() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  slot_released_.wait(lock, [this]() {
+    return std::none_of(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.running; });
+  });
+}
+
+}  // namespace onnxruntime
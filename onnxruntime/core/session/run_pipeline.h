@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/IOBinding.h"
+
+namespace onnxruntime {
+class InferenceSession;
+struct RunOptions;
+
+/**
+Keeps up to depth Runs of a session in flight for streaming workloads, e.g. inference on consecutive video frames.
+Each Run uses its own IOBinding, so the inputs of the next request can be bound, and copied to the device, while
+the previous Runs execute, and the outputs of a Run can be read back while the next one computes.
+
+Typical use:
+  IOBinding* io_binding;
+  ORT_RETURN_IF_ERROR(pipeline->AcquireBinding(io_binding));  // blocks while depth Runs are in flight
+  ORT_RETURN_IF_ERROR(io_binding->BindInput("X", frame));
+  ORT_RETURN_IF_ERROR(io_binding->BindOutput("Y"));
+  ORT_RETURN_IF_ERROR(pipeline->Submit(run_options, *io_binding, callback));
+
+The values bound to an IOBinding are kept when it is acquired again, so outputs pre-allocated on the device are
+reused by the next Run with the same binding.
+*/
+class RunPipeline {
+ public:
+  using Callback = std::function<void(const common::Status& status, IOBinding& io_binding)>;
+
+  static common::Status Create(InferenceSession& session, size_t depth,
+                               std::unique_ptr<RunPipeline>& pipeline) ORT_MUST_USE_RESULT;
+
+  /** Waits for the Runs in flight. */
+  ~RunPipeline();
+
+  /** Returns a binding that is not used by a Run in flight, waiting for one to complete if there is none. */
+  common::Status AcquireBinding(IOBinding*& io_binding) ORT_MUST_USE_RESULT;
+
+  /**
+    * Starts a Run with io_binding, which must have been returned by AcquireBinding. It is released once callback,
+    * which is invoked on the thread that executed the Run, has returned. It is released immediately if the Run could
+    * not be started. run_options must stay valid until callback has been invoked.
+    */
+  common::Status Submit(const RunOptions& run_options, IOBinding& io_binding,
+                        Callback callback) ORT_MUST_USE_RESULT;
+
+  /** Returns a binding from AcquireBinding without running it. */
+  void ReleaseBinding(IOBinding& io_binding);
+
+  /** Waits until all the submitted Runs have completed. */
+  void Wait();
+
+  size_t Depth() const { return slots_.size(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunPipeline);
+
+  explicit RunPipeline(InferenceSession& session) : session_(session) {}
+
+  struct Slot {
+    std::unique_ptr<IOBinding> io_binding;
+    bool acquired = false;
+    bool running = false;
+  };
+
+  Slot* FindSlot(const IOBinding& io_binding);
+
+  InferenceSession& session_;
+  std::vector<Slot> slots_;
+  OrtMutex mutex_;
+  OrtCondVar slot_released_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/shape_buckets.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace shape_buckets {
+
+common::Status ParseBuckets(const std::string& config, BucketMap& buckets) {
+  buckets.clear();
+  std::istringstream entries(config);
+  std::string entry;
+  while (std::getline(entries, entry, ';')) {
+    if (entry.empty()) {
+      continue;
+    }
+
+    const auto colon = entry.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == entry.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid pad bucket entry '", entry,
+                             "'. Expected 'dim_param:size,size,...'.");
+    }
+
+    const std::string dim_param = entry.substr(0, colon);
+    std::vector<int64_t> sizes;
+    std::istringstream sizes_stream(entry.substr(colon + 1));
+    std::string size_str;
+    while (std::getline(sizes_stream, size_str, ',')) {
+      std::istringstream iss(size_str);
+      int64_t size = 0;
+      if (!(iss >> size) || !iss.eof() || size <= 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid pad bucket size '", size_str,
+                               "' for dimension ", dim_param);
+      }
+      sizes.push_back(size);
+    }
+
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    if (!buckets.emplace(dim_param, std::move(sizes)).second) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Duplicate pad buckets for dimension ", dim_param);
+    }
+  }
+
+  return Status::OK();
+}
+
+int64_t GetBucketSize(const std::vector<int64_t>& sizes, int64_t size) {
+  auto it = std::lower_bound(sizes.cbegin(), sizes.cend(), size);
+  return it == sizes.cend() ? size : *it;
+}
+
+common::Status Resize(const Tensor& tensor, const std::vector<int64_t>& dims, const AllocatorPtr& allocator,
+                      OrtValue& output) {
+  const auto& src_dims = tensor.Shape().GetDims();
+  if (src_dims.size() != dims.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can't resize a tensor of shape ", tensor.Shape(),
+                           " to rank ", dims.size());
+  }
+  if (strcmp(tensor.Location().name, CPU) != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Only CPU tensors can be padded or sliced.");
+  }
+
+  auto result = onnxruntime::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), allocator);
+  const bool is_string = tensor.IsDataTypeString();
+  const size_t element_size = tensor.DataType()->Size();
+  if (!is_string) {
+    memset(result->MutableDataRaw(), 0, result->SizeInBytes());
+  }
+
+  // copy the part both tensors have, one run of the innermost dimension at a time
+  const size_t rank = dims.size();
+  std::vector<int64_t> region(rank);
+  bool empty = false;
+  for (size_t i = 0; i < rank; ++i) {
+    region[i] = std::min(src_dims[i], dims[i]);
+    empty = empty || region[i] == 0;
+  }
+
+  if (!empty) {
+    std::vector<int64_t> src_strides(rank, 1);
+    std::vector<int64_t> dst_strides(rank, 1);
+    for (size_t i = rank; i-- > 1;) {
+      src_strides[i - 1] = src_strides[i] * src_dims[i];
+      dst_strides[i - 1] = dst_strides[i] * dims[i];
+    }
+
+    const int64_t run = rank == 0 ? 1 : region[rank - 1];
+    int64_t num_runs = 1;
+    for (size_t i = 0; i + 1 < rank; ++i) {
+      num_runs *= region[i];
+    }
+
+    std::vector<int64_t> index(rank, 0);
+    for (int64_t r = 0; r < num_runs; ++r) {
+      int64_t src_offset = 0;
+      int64_t dst_offset = 0;
+      for (size_t i = 0; i + 1 < rank; ++i) {
+        src_offset += index[i] * src_strides[i];
+        dst_offset += index[i] * dst_strides[i];
+      }
+
+      if (is_string) {
+        const std::string* src = tensor.Data<std::string>() + src_offset;
+        std::copy(src, src + run, result->MutableData<std::string>() + dst_offset);
+      } else {
+        memcpy(static_cast<char*>(result->MutableDataRaw()) + dst_offset * element_size,
+               static_cast<const char*>(tensor.DataRaw()) + src_offset * element_size, run * element_size);
+      }
+
+      // next index of the outer dimensions
+      for (size_t i = rank > 1 ? rank - 1 : 0; i-- > 0;) {
+        if (++index[i] < region[i]) {
+          break;
+        }
+        index[i] = 0;
+      }
+    }
+  }
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  output.Init(result.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
+}  // namespace shape_buckets
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+
+namespace onnxruntime {
+class Tensor;
+
+namespace shape_buckets {
+
+// The ascending sizes each symbolic dimension of the graph inputs is padded up to, keyed by dim_param.
+using BucketMap = std::unordered_map<std::string, std::vector<int64_t>>;
+
+/**
+  * Parses "dim_param:size,size,...;dim_param:size,..." into buckets.
+  */
+common::Status ParseBuckets(const std::string& config, BucketMap& buckets) ORT_MUST_USE_RESULT;
+
+/**
+  * The smallest of the ascending sizes that holds size, or size itself if it's larger than all of them.
+  */
+int64_t GetBucketSize(const std::vector<int64_t>& sizes, int64_t size);
+
+/**
+  * Copies the CPU tensor into a tensor of the given dims allocated with allocator. Each dimension is either padded
+  * with zeros, or empty strings for a string tensor, or sliced to its leading part.
+  */
+common::Status Resize(const Tensor& tensor, const std::vector<int64_t>& dims, const AllocatorPtr& allocator,
+                      OrtValue& output) ORT_MUST_USE_RESULT;
+
+}  // namespace shape_buckets
+}  // namespace onnxruntime
@@ -103,4 +103,37 @@ void QGemm(
 #endif
 }
 
+void QGemmApplyColumnOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_offsets,
+    bool rhs_signed,
+    int32_t* result_data,
+    int ldc) {
+  for (int m = 0; m < M; m++) {
+    int32_t row_sum = 0;
+    for (int k = 0; k < K; k++) {
+      row_sum += static_cast<int32_t>(lhs_data[k]);
+    }
+    row_sum -= K * static_cast<int32_t>(lhs_offset);
+
+    if (rhs_signed) {
+      for (int n = 0; n < N; n++) {
+        result_data[n] -= static_cast<int32_t>(static_cast<int8_t>(rhs_offsets[n])) * row_sum;
+      }
+    } else {
+      for (int n = 0; n < N; n++) {
+        result_data[n] -= static_cast<int32_t>(rhs_offsets[n]) * row_sum;
+      }
+    }
+
+    lhs_data += lda;
+    result_data += ldc;
+  }
+}
+
 }  // namespace onnxruntime
@@ -42,6 +42,21 @@ void QGemm(
     const float* bias,
     concurrency::ThreadPool* thread_pool);
 
+// Adjusts the output of a QGemm that was computed with a zero point of zero
+// for the right hand side matrix to apply a zero point per column instead:
+//   result[m][n] -= rhs_offsets[n] * sum_k(lhs[m][k] - lhs_offset)
+void QGemmApplyColumnOffsets(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_offsets,
+    bool rhs_signed,
+    int32_t* result_data,
+    int ldc);
+
 inline float RoundHalfToEven(float input) {
   if (!std::isfinite(input)) {
     return input;
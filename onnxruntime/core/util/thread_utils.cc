@@ -6,6 +6,8 @@
 #include <Windows.h>
 #endif
 #include <thread>
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
 #include "core/session/ort_apis.h"
 
 namespace onnxruntime {
@@ -18,6 +20,38 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
   if (options.affinity_vec_len != 0) {
     to.affinity.assign(options.affinity_vec, options.affinity_vec + options.affinity_vec_len);
+  } else if (options.numa_node >= 0) {
+    std::vector<size_t> node_cpus = env->GetNumaNodeThreadAffinityMasks(options.numa_node);
+    ORT_ENFORCE(!node_cpus.empty(), "No logical processors are available on NUMA node ", options.numa_node);
+    if (options.thread_pool_size <= 0) {
+      options.thread_pool_size = static_cast<int>(node_cpus.size());
+      if (options.thread_pool_size == 1)
+        return nullptr;
+    }
+    // One entry per thread, wrapping around if there are more threads than processors on the node
+    to.affinity.resize(options.thread_pool_size);
+    for (size_t i = 0; i < to.affinity.size(); ++i) {
+      to.affinity[i] = node_cpus[i % node_cpus.size()];
+    }
+  } else if (options.physical_cores_only || options.performance_cores_only) {
+    std::vector<size_t> core_cpus = env->GetPhysicalCoreThreadAffinityMasks(options.performance_cores_only);
+    if (core_cpus.empty()) {
+      // the threads are left to the OS scheduler, which may use the efficiency cores of a hybrid processor
+      LOGS_DEFAULT(WARNING) << "The physical core topology isn't available on this platform"
+                            << (CPUIDInfo::GetCPUIDInfo().IsHybrid() ? " and the processor is hybrid" : "")
+                            << ", the threads of the pool aren't pinned to cores.";
+    } else {
+      if (options.thread_pool_size <= 0) {
+        options.thread_pool_size = static_cast<int>(core_cpus.size());
+        if (options.thread_pool_size == 1)
+          return nullptr;
+      }
+      // One entry per thread, wrapping around if there are more threads than cores
+      to.affinity.resize(options.thread_pool_size);
+      for (size_t i = 0; i < to.affinity.size(); ++i) {
+        to.affinity[i] = core_cpus[i % core_cpus.size()];
+      }
+    }
   }
   if (options.thread_pool_size <= 0) {  // default
     cpu_list = Env::Default().GetThreadAffinityMasks();
@@ -28,6 +62,10 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
       to.affinity = cpu_list;
   }
   to.set_denormal_as_zero = options.set_denormal_as_zero;
+  to.adaptive_spinning = options.adaptive_spinning;
+  if (options.max_spin_duration_us != 0) {
+    to.max_spin_duration_us = options.max_spin_duration_us;
+  }
 
   return onnxruntime::make_unique<ThreadPool>(env, to, options.name, options.thread_pool_size,
                                               options.allow_spinning);
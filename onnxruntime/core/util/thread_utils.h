@@ -28,6 +28,27 @@ struct OrtThreadPoolParams {
 
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
+
+  //-1: Don't pin to a NUMA node
+  //n: Pin the threads to the logical processors of NUMA node n. If thread_pool_size is 0 the pool gets one
+  //   thread per processor of the node. Ignored if affinity_vec is set.
+  int numa_node = -1;
+
+  // If it is true, pin the threads to one logical processor of each physical core, so two threads of the pool
+  // never share a core through SMT. If thread_pool_size is 0 the pool gets one thread per core.
+  // Ignored if affinity_vec is set or numa_node isn't -1.
+  bool physical_cores_only = false;
+
+  // If it is true, only use the performance cores of a hybrid processor, for the same placement as
+  // physical_cores_only. Processors that aren't hybrid have only performance cores.
+  bool performance_cores_only = false;
+
+  // If it is true, the spin window of idle threads adapts to the recent frequency of parallel loops.
+  // Only used if allow_spinning is true.
+  bool adaptive_spinning = false;
+
+  // Upper bound for the adaptive spin window. 0 means use the ThreadOptions default.
+  unsigned int max_spin_duration_us = 0;
 };
 
 struct OrtThreadingOptions {
@@ -8,22 +8,16 @@
 
 #include "Featurizers/NumericalizeFeaturizer.h"
 #include "Featurizers/../Archive.h"
+#include "featurizers_ops/cpu/transformer_cache.h"
 
 namespace onnxruntime {
 namespace featurizers {
 
 template <typename InputT>
 struct NumericalizeTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
-    // Create the transformer
-    Microsoft::Featurizer::Featurizers::NumericalizeTransformer<InputT> transformer(
-        [ctx](void) {
-          const auto* state_tensor(ctx->Input<Tensor>(0));
-          const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-
-          Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
-          return Microsoft::Featurizer::Featurizers::NumericalizeTransformer<InputT>(archive);
-        }());
+  void operator()(OpKernelContext* ctx, const TransformerCache& transformer_cache) const {
+    // Get the transformer
+    auto transformer(transformer_cache.Get<Microsoft::Featurizer::Featurizers::NumericalizeTransformer<InputT>>(ctx));
 
     // Get the input
     const auto* input_tensor(ctx->Input<Tensor>(1));
@@ -36,23 +30,24 @@ struct NumericalizeTransformerImpl {
     // Execute
     const int64_t length(input_tensor->Shape().Size());
 
-    for (int64_t i = 0; i < length; ++i) {
-      output_data[i] = transformer.execute(input_data[i]);
-    }
+    ExecuteElementwise(ctx, *transformer, input_data, output_data, length);
   }
 };
 
 class NumericalizeTransformer final : public OpKernel {
  public:
-  explicit NumericalizeTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit NumericalizeTransformer(const OpKernelInfo& info) : OpKernel(info), transformer_cache_(info) {
   }
 
   Status Compute(OpKernelContext* ctx) const override {
     utils::MLTypeCallDispatcher<NumericalizeTransformerImpl, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
         int64_t, uint64_t, float, double, std::string> t_disp(ctx->Input<Tensor>(1)->GetElementType());
-    t_disp.Invoke(ctx);
+    t_disp.Invoke(ctx, transformer_cache_);
     return Status::OK();
   }
+
+ private:
+  TransformerCache transformer_cache_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -8,6 +8,7 @@
 
 #include "Featurizers/RobustScalerFeaturizer.h"
 #include "Featurizers/../Archive.h"
+#include "featurizers_ops/cpu/transformer_cache.h"
 
 namespace onnxruntime {
 namespace featurizers {
@@ -37,16 +38,10 @@ struct OutputTypeMapper<double> { using type = double; };
 
 template <typename InputT>
 struct RobustScalerTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
-    // Create the transformer
-    Microsoft::Featurizer::Featurizers::RobustScalerTransformer<InputT, typename OutputTypeMapper<InputT>::type> transformer(
-        [ctx](void) {
-          const auto* state_tensor(ctx->Input<Tensor>(0));
-          const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-
-          Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
-          return Microsoft::Featurizer::Featurizers::RobustScalerTransformer<InputT, typename OutputTypeMapper<InputT>::type>(archive);
-        }());
+  void operator()(OpKernelContext* ctx, const TransformerCache& transformer_cache) const {
+    // Get the transformer
+    using TransformerT = Microsoft::Featurizer::Featurizers::RobustScalerTransformer<InputT, typename OutputTypeMapper<InputT>::type>;
+    auto transformer(transformer_cache.Get<TransformerT>(ctx));
 
     // Get the input
     const auto* input_tensor(ctx->Input<Tensor>(1));
@@ -59,24 +54,25 @@ struct RobustScalerTransformerImpl {
     // Execute
     const int64_t length(input_tensor->Shape().Size());
 
-    for (int64_t i = 0; i < length; ++i) {
-      output_data[i] = transformer.execute(input_data[i]);
-    }
+    ExecuteElementwise(ctx, *transformer, input_data, output_data, length);
   }
 };
 
 class RobustScalerTransformer final : public OpKernel {
  public:
-  explicit RobustScalerTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit RobustScalerTransformer(const OpKernelInfo& info) : OpKernel(info), transformer_cache_(info) {
   }
 
   Status Compute(OpKernelContext* ctx) const override {
     utils::MLTypeCallDispatcher<RobustScalerTransformerImpl, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
                                 int64_t, uint64_t, float, double>
         t_disp(ctx->Input<Tensor>(1)->GetElementType());
-    t_disp.Invoke(ctx);
+    t_disp.Invoke(ctx, transformer_cache_);
     return Status::OK();
   }
+
+ private:
+  TransformerCache transformer_cache_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
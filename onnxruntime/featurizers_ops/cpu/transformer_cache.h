@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+
+#include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+#include "Featurizers/../Archive.h"
+
+namespace onnxruntime {
+namespace featurizers {
+
+// Holds the transformer a kernel deserializes from its state, input 0. A state that's a constant initializer is
+// deserialized by the first Run and the transformer is shared by the later ones, other states are deserialized by
+// every Run. Only use it for stateless transformers, as the shared transformer is executed by concurrent Runs.
+class TransformerCache {
+ public:
+  explicit TransformerCache(const OpKernelInfo& info) {
+    const Tensor* state_tensor;
+    is_constant_ = info.TryGetConstantInput(0, &state_tensor);
+  }
+
+  template <typename TransformerT>
+  std::shared_ptr<TransformerT> Get(OpKernelContext* ctx) const {
+    if (!is_constant_) {
+      return Deserialize<TransformerT>(ctx);
+    }
+
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (transformer_ == nullptr) {
+      transformer_ = Deserialize<TransformerT>(ctx);
+    }
+    return std::static_pointer_cast<TransformerT>(transformer_);
+  }
+
+ private:
+  template <typename TransformerT>
+  static std::shared_ptr<TransformerT> Deserialize(OpKernelContext* ctx) {
+    const auto* state_tensor(ctx->Input<Tensor>(0));
+    const uint8_t* const state_data(state_tensor->Data<uint8_t>());
+
+    Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
+    return std::make_shared<TransformerT>(archive);
+  }
+
+  bool is_constant_;
+  mutable OrtMutex mutex_;
+  // the kernels dispatch on the input type, which is fixed for a node, so a single transformer type is cached
+  mutable std::shared_ptr<void> transformer_;
+};
+
+// Applies a stateless transformer to each element of the input, in parallel over blocks of elements.
+template <typename TransformerT, typename InputT, typename OutputT>
+void ExecuteElementwise(OpKernelContext* ctx, TransformerT& transformer, const InputT* input_data,
+                        OutputT* output_data, int64_t length) {
+  // the transformers are executed through virtual calls and callbacks
+  constexpr double kExecuteCost = 32.0;
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(length),
+      TensorOpCost{static_cast<double>(sizeof(InputT)), static_cast<double>(sizeof(OutputT)), kExecuteCost},
+      [&transformer, input_data, output_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          output_data[i] = transformer.execute(input_data[i]);
+        }
+      });
+}
+
+}  // namespace featurizers
+}  // namespace onnxruntime
@@ -101,17 +101,22 @@ class Session:
         """
         self._enable_fallback = True
 
-    def run(self, output_names, input_feed, run_options=None):
+    def run(self, output_names, input_feed, run_options=None, output_arrays=None):
         """
         Compute the predictions.
 
         :param output_names: name of the outputs
-        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param input_feed: dictionary ``{ input_name: input_value }``. The values may also be OrtValues, or
+            tensors of other frameworks supporting DLPack, e.g. PyTorch tensors, whose memory is used without copying it.
         :param run_options: See :class:`onnxruntime.RunOptions`.
+        :param output_arrays: optional list parallel to *output_names* of pre-allocated numpy arrays, OrtValues
+            or DLPack tensors the outputs are written into, and which are returned in place of new arrays.
+            An entry may be None to allocate that output.
 
         ::
 
             sess.run([output_name], {input_name: x})
+            sess.run([output_name], {input_name: x}, output_arrays=[y])
         """
         num_required_inputs = len(self._inputs_meta)
         num_inputs = len(input_feed)
@@ -120,8 +125,14 @@ class Session:
             raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
         if not output_names:
             output_names = [output.name for output in self._outputs_meta]
+
+        def invoke():
+            if output_arrays is None:
+                return self._sess.run(output_names, input_feed, run_options)
+            return self._sess.run_with_output_arrays(output_names, input_feed, output_arrays, run_options)
+
         try:
-            return self._sess.run(output_names, input_feed, run_options)
+            return invoke()
         except C.EPFail as err:
             if self._enable_fallback:
                 print("EP Error: {} using {}".format(str(err), self._providers))
@@ -129,10 +140,34 @@ class Session:
                 self.set_providers(self._fallback_providers)
                 # Fallback only once.
                 self.disable_fallback()
-                return self._sess.run(output_names, input_feed, run_options)
+                return invoke()
             else:
                 raise
 
+    def run_many(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions for several input feeds at once. The runs execute concurrently on the
+        inter-op thread pool of the session, or on its intra-op thread pool when the session is executed
+        sequentially, without holding the GIL.
+
+        :param output_names: name of the outputs
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: the list of the outputs of each input feed
+
+        ::
+
+            sess.run_many([output_name], [{input_name: x1}, {input_name: x2}])
+        """
+        num_required_inputs = len(self._inputs_meta)
+        for input_feed in input_feeds:
+            if len(input_feed) < num_required_inputs:
+                raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs,
+                                                                                          len(input_feed)))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_many(output_names, input_feeds, run_options)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -441,3 +476,25 @@ class OrtValue:
         Valid only for OrtValues holding Tensors. Throws for OrtValues holding non-Tensors.
         '''
         return self._ortvalue.numpy()
+
+    @staticmethod
+    def from_dlpack(dlpack_obj):
+        '''
+        Factory method to construct an OrtValue (which holds a Tensor) over the memory of a tensor of another
+        framework, e.g. PyTorch or CuPy, on the CPU or a CUDA device, without copying it
+        :param dlpack_obj: a DLPack capsule, or an object with a `__dlpack__` method
+        '''
+        return OrtValue(C.OrtValue.from_dlpack(dlpack_obj))
+
+    def to_dlpack(self):
+        '''
+        Returns a DLPack capsule sharing the memory of the OrtValue, e.g. for `torch.utils.dlpack.from_dlpack`.
+        Valid only for OrtValues holding Tensors.
+        '''
+        return self._ortvalue.to_dlpack()
+
+    def __dlpack__(self, stream=None):
+        return self._ortvalue.__dlpack__(stream)
+
+    def __dlpack_device__(self):
+        return self._ortvalue.__dlpack_device__()
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "onnxruntime_pybind_dlpack.h"
+
+#include <vector>
+
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+namespace python {
+
+static const char* DLTENSOR_CAPSULE_NAME = "dltensor";
+static const char* USED_DLTENSOR_CAPSULE_NAME = "used_dltensor";
+
+namespace {
+
+// Owns a tensor imported with DLPack, and releases it through its deleter when the Tensor over its memory is freed.
+class DlpackAllocator : public IAllocator {
+ public:
+  DlpackAllocator(DLManagedTensor* dl_managed_tensor, const OrtMemoryInfo& mem_info)
+      : IAllocator(mem_info), dl_managed_tensor_(dl_managed_tensor) {}
+
+  ORT_DISALLOW_COPY_AND_ASSIGNMENT(DlpackAllocator);
+
+  ~DlpackAllocator() override {
+    Release();
+  }
+
+  void* Alloc(size_t) override {
+    return static_cast<char*>(dl_managed_tensor_->dl_tensor.data) + dl_managed_tensor_->dl_tensor.byte_offset;
+  }
+
+  void Free(void*) override {
+    Release();
+  }
+
+ private:
+  void Release() {
+    if (dl_managed_tensor_ != nullptr && dl_managed_tensor_->deleter != nullptr) {
+      // the deleters of Python exporters, e.g. CuPy, release Python objects
+      py::gil_scoped_acquire acquire;
+      dl_managed_tensor_->deleter(dl_managed_tensor_);
+    }
+    dl_managed_tensor_ = nullptr;
+  }
+
+  DLManagedTensor* dl_managed_tensor_;
+};
+
+// The context of a tensor exported with DLPack, which shares the buffer of the OrtValue.
+struct ExportedTensor {
+  OrtValue ml_value;
+  std::vector<int64_t> shape;
+  DLManagedTensor dl_managed_tensor;
+};
+
+void DeleteExportedTensor(DLManagedTensor* dl_managed_tensor) {
+  delete static_cast<ExportedTensor*>(dl_managed_tensor->manager_ctx);
+}
+
+// Releases a capsule that was never consumed.
+void DeleteUnusedCapsule(PyObject* capsule) {
+  if (PyCapsule_IsValid(capsule, DLTENSOR_CAPSULE_NAME)) {
+    auto* dl_managed_tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, DLTENSOR_CAPSULE_NAME));
+    dl_managed_tensor->deleter(dl_managed_tensor);
+  }
+}
+
+MLDataType ElementTypeFromDlpack(const DLDataType& dtype) {
+  if (dtype.lanes != 1) {
+    throw std::runtime_error("DLPack tensors with vector data types are not supported");
+  }
+
+  switch (dtype.code) {
+    case kDLInt:
+      switch (dtype.bits) {
+        case 8:
+          return DataTypeImpl::GetType<int8_t>();
+        case 16:
+          return DataTypeImpl::GetType<int16_t>();
+        case 32:
+          return DataTypeImpl::GetType<int32_t>();
+        case 64:
+          return DataTypeImpl::GetType<int64_t>();
+      }
+      break;
+    case kDLUInt:
+      switch (dtype.bits) {
+        case 8:
+          return DataTypeImpl::GetType<uint8_t>();
+        case 16:
+          return DataTypeImpl::GetType<uint16_t>();
+        case 32:
+          return DataTypeImpl::GetType<uint32_t>();
+        case 64:
+          return DataTypeImpl::GetType<uint64_t>();
+      }
+      break;
+    case kDLFloat:
+      switch (dtype.bits) {
+        case 16:
+          return DataTypeImpl::GetType<MLFloat16>();
+        case 32:
+          return DataTypeImpl::GetType<float>();
+        case 64:
+          return DataTypeImpl::GetType<double>();
+      }
+      break;
+    case kDLBfloat:
+      if (dtype.bits == 16) {
+        return DataTypeImpl::GetType<BFloat16>();
+      }
+      break;
+  }
+
+  throw std::runtime_error("Unsupported DLPack data type with code " + std::to_string(dtype.code) + " and " +
+                           std::to_string(dtype.bits) + " bits");
+}
+
+DLDataType DlpackDataType(const Tensor& tensor) {
+  DLDataType dtype;
+  dtype.lanes = 1;
+  dtype.bits = static_cast<uint8_t>(tensor.DataType()->Size() * 8);
+  switch (tensor.GetElementType()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+      dtype.code = kDLInt;
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+      dtype.code = kDLUInt;
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+      dtype.code = kDLFloat;
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      dtype.code = kDLBfloat;
+      break;
+    default:
+      throw std::runtime_error("Tensors of type " + std::string(DataTypeImpl::ToString(tensor.DataType())) +
+                               " can't be exported with DLPack");
+  }
+
+  return dtype;
+}
+
+DLContext DlpackContext(const OrtValue& ml_value) {
+  ORT_ENFORCE(ml_value.IsTensor(), "Only OrtValues that are Tensors can be exported with DLPack");
+  const auto& device = ml_value.Get<Tensor>().Location().device;
+  DLContext ctx;
+  switch (device.Type()) {
+    case OrtDevice::CPU:
+      ctx.device_type = device.MemType() == OrtDevice::MemType::CUDA_PINNED ? kDLCPUPinned : kDLCPU;
+      ctx.device_id = 0;
+      break;
+    case OrtDevice::GPU:
+      ctx.device_type = kDLGPU;
+      ctx.device_id = device.Id();
+      break;
+    default:
+      throw std::runtime_error("Tensors on this device can't be exported with DLPack");
+  }
+
+  return ctx;
+}
+
+}  // namespace
+
+bool IsDlpackObject(const py::object& obj) {
+  return PyCapsule_IsValid(obj.ptr(), DLTENSOR_CAPSULE_NAME) || py::hasattr(obj, "__dlpack__");
+}
+
+std::unique_ptr<OrtValue> OrtValueFromDlpack(const py::object& obj) {
+  py::object capsule = PyCapsule_CheckExact(obj.ptr()) ? obj : obj.attr("__dlpack__")();
+  if (!PyCapsule_IsValid(capsule.ptr(), DLTENSOR_CAPSULE_NAME)) {
+    throw std::runtime_error("Expected a DLPack capsule which has not been consumed yet");
+  }
+
+  auto* dl_managed_tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule.ptr(), DLTENSOR_CAPSULE_NAME));
+  const DLTensor& dl_tensor = dl_managed_tensor->dl_tensor;
+
+  MLDataType element_type = ElementTypeFromDlpack(dl_tensor.dtype);
+  std::vector<int64_t> shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  if (dl_tensor.strides != nullptr) {
+    int64_t expected_stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; --i) {
+      if (shape[i] != 1 && dl_tensor.strides[i] != expected_stride) {
+        throw std::runtime_error("Only compact DLPack tensors in row-major order are supported");
+      }
+      expected_stride *= shape[i];
+    }
+  }
+
+  OrtDevice device;
+  switch (dl_tensor.ctx.device_type) {
+    case kDLCPU:
+    case kDLCPUPinned:
+      device = OrtDevice();
+      break;
+    case kDLGPU:
+#ifdef USE_CUDA
+      device = OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT,
+                         static_cast<OrtDevice::DeviceId>(dl_tensor.ctx.device_id));
+      break;
+#else
+      throw std::runtime_error(
+          "Can't use DLPack tensors on a CUDA device with this package of OnnxRuntime. "
+          "Please use the CUDA package of OnnxRuntime to use this feature.");
+#endif
+    default:
+      throw std::runtime_error("Unsupported DLPack device type " + std::to_string(dl_tensor.ctx.device_type));
+  }
+
+  OrtMemoryInfo info(device.Type() == OrtDevice::GPU ? CUDA : CPU, OrtDeviceAllocator, device);
+  // from now on the allocator owns the tensor, so the capsule must not release it
+  auto allocator = std::make_shared<DlpackAllocator>(dl_managed_tensor, info);
+  PyCapsule_SetName(capsule.ptr(), USED_DLTENSOR_CAPSULE_NAME);
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, allocator);
+  auto ml_value = onnxruntime::make_unique<OrtValue>();
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ml_value->Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return ml_value;
+}
+
+py::object OrtValueToDlpack(const OrtValue& ml_value) {
+  DLContext ctx = DlpackContext(ml_value);
+  const Tensor& tensor = ml_value.Get<Tensor>();
+
+  auto exported = onnxruntime::make_unique<ExportedTensor>();
+  exported->ml_value = ml_value;
+  exported->shape = tensor.Shape().GetDims();
+
+  DLTensor& dl_tensor = exported->dl_managed_tensor.dl_tensor;
+  dl_tensor.data = const_cast<void*>(tensor.DataRaw());
+  dl_tensor.ctx = ctx;
+  dl_tensor.ndim = static_cast<int>(exported->shape.size());
+  dl_tensor.dtype = DlpackDataType(tensor);
+  dl_tensor.shape = exported->shape.data();
+  dl_tensor.strides = nullptr;
+  dl_tensor.byte_offset = 0;
+  exported->dl_managed_tensor.manager_ctx = exported.get();
+  exported->dl_managed_tensor.deleter = DeleteExportedTensor;
+
+  PyObject* capsule = PyCapsule_New(&exported->dl_managed_tensor, DLTENSOR_CAPSULE_NAME, DeleteUnusedCapsule);
+  if (capsule == nullptr) {
+    throw py::error_already_set();
+  }
+
+  exported.release();
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
+py::tuple DlpackDevice(const OrtValue& ml_value) {
+  DLContext ctx = DlpackContext(ml_value);
+  return py::make_tuple(static_cast<int>(ctx.device_type), ctx.device_id);
+}
+
+}  // namespace python
+}  // namespace onnxruntime
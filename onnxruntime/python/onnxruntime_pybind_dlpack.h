@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <pybind11/pybind11.h>
+
+#include "core/framework/ml_value.h"
+
+// The structures of the DLPack ABI (https://github.com/dmlc/dlpack, v0.3), through which tensors are exchanged with
+// other frameworks, e.g. PyTorch and CuPy, without copying their data.
+extern "C" {
+typedef enum {
+  kDLCPU = 1,
+  kDLGPU = 2,
+  kDLCPUPinned = 3,
+} DLDeviceType;
+
+typedef struct {
+  DLDeviceType device_type;
+  int device_id;
+} DLContext;
+
+typedef enum {
+  kDLInt = 0U,
+  kDLUInt = 1U,
+  kDLFloat = 2U,
+  kDLBfloat = 4U,
+} DLDataTypeCode;
+
+typedef struct {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+  void* data;
+  DLContext ctx;
+  int ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(struct DLManagedTensor* self);
+} DLManagedTensor;
+}
+
+namespace onnxruntime {
+namespace python {
+namespace py = pybind11;
+
+// Returns true if obj is a DLPack capsule, or an object exporting one with __dlpack__, e.g. a PyTorch tensor.
+bool IsDlpackObject(const py::object& obj);
+
+// Creates an OrtValue over the memory of a tensor exported with DLPack. The tensor must be compact and in row-major
+// order. The OrtValue keeps the exporter's tensor alive, and the capsule is consumed as required by the protocol.
+std::unique_ptr<OrtValue> OrtValueFromDlpack(const py::object& obj);
+
+// Exports the tensor of ml_value as a DLPack capsule sharing its memory, which stays valid until the consumer
+// releases the tensor.
+py::object OrtValueToDlpack(const OrtValue& ml_value);
+
+// The (device_type, device_id) pair returned by __dlpack_device__.
+py::tuple DlpackDevice(const OrtValue& ml_value);
+
+}  // namespace python
+}  // namespace onnxruntime
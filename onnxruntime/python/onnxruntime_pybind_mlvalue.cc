@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "onnxruntime_pybind_mlvalue.h"
+#include "onnxruntime_pybind_dlpack.h"
 
 #define NO_IMPORT_ARRAY
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
@@ -665,6 +666,9 @@ void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, const
     // This should just increase the ref counts of the underlying shared_ptrs in the native OrtValue
     // and the ref count will be decreased when the OrtValue used for Run() is destroyed upon exit.
     *p_mlvalue = *value.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+  } else if (!accept_only_numpy_array && IsDlpackObject(value)) {
+    // A tensor of another framework, e.g. PyTorch, whose memory is used without copying it.
+    *p_mlvalue = *OrtValueFromDlpack(value);
   } else if (!accept_only_numpy_array) {
     auto iterator = PyObject_GetIter(value.ptr());
     if (iterator == NULL) {
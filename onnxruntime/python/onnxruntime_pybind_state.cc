@@ -3,6 +3,7 @@
 
 #include "python/onnxruntime_pybind_exceptions.h"
 #include "python/onnxruntime_pybind_mlvalue.h"
+#include "python/onnxruntime_pybind_dlpack.h"
 #include "python/onnxruntime_pybind_state_common.h"
 
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
@@ -140,6 +141,8 @@ OrtCudnnConvAlgoSearch cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::EXHAUSTI
 size_t cuda_mem_limit = std::numeric_limits<size_t>::max();
 onnxruntime::ArenaExtendStrategy arena_extend_strategy = onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
 bool do_copy_in_default_stream = true;
+bool enable_cuda_graph = false;
+bool enable_stream_ordered_allocator = false;
 
 #endif
 #ifdef USE_TENSORRT
@@ -186,14 +189,21 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(O
                                                                                OrtCudnnConvAlgoSearch cudnn_conv_algo_search,
                                                                                size_t cuda_mem_limit,
                                                                                onnxruntime::ArenaExtendStrategy arena_extend_strategy,
-                                                                               bool do_copy_in_default_stream);
+                                                                               bool do_copy_in_default_stream,
+                                                                               bool enable_cuda_graph,
+                                                                               const std::string& cudnn_conv_algo_cache_path,
+                                                                               bool enable_stream_ordered_allocator,
+                                                                               bool enable_elementwise_fusion,
+                                                                               const std::string& elementwise_fusion_cache_path);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_MIGraphX(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Dnnl(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_NGraph(const char* ng_backend_type);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVINO(const char* device_type,
                                                                                    bool enable_vpu_fast_compile,
-                                                                                   const char* device_id);
+                                                                                   const char* device_id,
+                                                                                   size_t num_of_infer_requests,
+                                                                                   const char* blob_cache_dir);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nuphar(bool, const char*);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_VITISAI(const char* backend_type, int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_ACL(int use_arena);
@@ -297,6 +307,13 @@ void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj,
       PyArray_DATA(reinterpret_cast<PyArrayObject*>(obj.ptr())));
 
   if (numpy_type != NPY_OBJECT) {
+    // the copy doesn't touch Python objects, so other Python threads can run while large outputs are copied
+    constexpr size_t min_bytes_to_release_gil = 64 * 1024;
+    std::unique_ptr<py::gil_scoped_release> release_gil;
+    if (dtype->Size() * shape.Size() >= min_bytes_to_release_gil) {
+      release_gil = onnxruntime::make_unique<py::gil_scoped_release>();
+    }
+
     //if it is not cpu tensor, need to copy to host
     auto device_type = rtensor.Location().device.Type();
     if (device_type != OrtDevice::CPU) {
@@ -359,7 +376,7 @@ void AddNonTensor<TensorSeq>(const OrtValue& val, std::vector<py::object>& pyobj
   py::list py_list;
   for (const auto& rtensor : seq_tensors) {
     py::object obj;
-    GetPyObjFromTensor(rtensor, obj, data_transfer_manager, mem_cpy_to_host_functions);
+    GetPyObjFromTensor(rtensor.Get<Tensor>(), obj, data_transfer_manager, mem_cpy_to_host_functions);
     py_list.append(obj);
   }
   pyobjs.push_back(py_list);
@@ -546,6 +563,54 @@ static void UpdateCudaProviderOptions(InferenceSession* sess, onnxruntime::CUDAE
     options.arena_extend_strategy = strategy;
     LOGS(*(sess->GetLogger()), INFO) << "cuda arean extend strategy is set to " << it->second;
   }
+
+  it = options_map.find("enable_cuda_graph");
+  if (it != options_map.end()) {
+    if (it->second == "1" || it->second == "True" || it->second == "true") {
+      options.enable_cuda_graph = true;
+    } else if (it->second == "0" || it->second == "False" || it->second == "false") {
+      options.enable_cuda_graph = false;
+    } else {
+      throw std::runtime_error("Please provide enable_cuda_graph with '0' or '1'.");
+    }
+    LOGS(*(sess->GetLogger()), INFO) << "cuda graph capture is set to " << it->second;
+  }
+
+  it = options_map.find("cudnn_conv_algo_cache_path");
+  if (it != options_map.end()) {
+    options.cudnn_conv_algo_cache_path = it->second;
+    LOGS(*(sess->GetLogger()), INFO) << "cudnn conv algo cache path is set to " << it->second;
+  }
+
+  it = options_map.find("enable_stream_ordered_allocator");
+  if (it != options_map.end()) {
+    if (it->second == "1" || it->second == "True" || it->second == "true") {
+      options.enable_stream_ordered_allocator = true;
+    } else if (it->second == "0" || it->second == "False" || it->second == "false") {
+      options.enable_stream_ordered_allocator = false;
+    } else {
+      throw std::runtime_error("Please provide enable_stream_ordered_allocator with '0' or '1'.");
+    }
+    LOGS(*(sess->GetLogger()), INFO) << "cuda stream ordered allocator is set to " << it->second;
+  }
+
+  it = options_map.find("enable_elementwise_fusion");
+  if (it != options_map.end()) {
+    if (it->second == "1" || it->second == "True" || it->second == "true") {
+      options.enable_elementwise_fusion = true;
+    } else if (it->second == "0" || it->second == "False" || it->second == "false") {
+      options.enable_elementwise_fusion = false;
+    } else {
+      throw std::runtime_error("Please provide enable_elementwise_fusion with '0' or '1'.");
+    }
+    LOGS(*(sess->GetLogger()), INFO) << "cuda elementwise fusion is set to " << it->second;
+  }
+
+  it = options_map.find("elementwise_fusion_cache_path");
+  if (it != options_map.end()) {
+    options.elementwise_fusion_cache_path = it->second;
+    LOGS(*(sess->GetLogger()), INFO) << "cuda elementwise fusion cache path is set to " << it->second;
+  }
 }
 
 static AllocatorPtr GetCudaAllocator(OrtDevice::DeviceId id) {
@@ -624,14 +689,24 @@ static void RegisterExecutionProviders(InferenceSession* sess, const std::vector
                                                                     cuda_provider_options.cudnn_conv_algo,
                                                                     cuda_provider_options.cuda_mem_limit,
                                                                     cuda_provider_options.arena_extend_strategy,
-                                                                    cuda_provider_options.do_copy_in_default_stream));
+                                                                    cuda_provider_options.do_copy_in_default_stream,
+                                                                    cuda_provider_options.enable_cuda_graph,
+                                                                    cuda_provider_options.cudnn_conv_algo_cache_path,
+                                                                    cuda_provider_options.enable_stream_ordered_allocator,
+                                                                    cuda_provider_options.enable_elementwise_fusion,
+                                                                    cuda_provider_options.elementwise_fusion_cache_path));
       } else {
         RegisterExecutionProvider(
             sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id,
                                                                     cudnn_conv_algo_search,
                                                                     cuda_mem_limit,
                                                                     arena_extend_strategy,
-                                                                    do_copy_in_default_stream));
+                                                                    do_copy_in_default_stream,
+                                                                    enable_cuda_graph,
+                                                                    "",
+                                                                    enable_stream_ordered_allocator,
+                                                                    false,
+                                                                    ""));
       }
 #endif
     } else if (type == kDnnlExecutionProvider) {
@@ -647,6 +722,8 @@ static void RegisterExecutionProviders(InferenceSession* sess, const std::vector
 #ifdef USE_OPENVINO
       bool enable_vpu_fast_compile = false;
       std::string openvino_device_id;
+      size_t num_of_infer_requests = 0;
+      std::string blob_cache_dir;
       auto it = provider_options_map.find(type);
       if (it != provider_options_map.end()) {
         for (auto option : it->second) {
@@ -663,6 +740,18 @@ static void RegisterExecutionProviders(InferenceSession* sess, const std::vector
 
           } else if (option.first == "device_id")
             openvino_device_id = option.second;
+          else if (option.first == "num_of_infer_requests") {
+            int num = 0;
+            try {
+              num = std::stoi(option.second);
+            } catch (...) {
+            }
+            if (num <= 0) {
+              ORT_THROW("Invalid value passed for num_of_infer_requests: ", option.second);
+            }
+            num_of_infer_requests = static_cast<size_t>(num);
+          } else if (option.first == "blob_cache_dir")
+            blob_cache_dir = option.second;
           else {
             ORT_THROW("Invalid OpenVINO EP option: ", option.first);
           }
@@ -670,7 +759,9 @@ static void RegisterExecutionProviders(InferenceSession* sess, const std::vector
       }
       RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_OpenVINO(openvino_device_type.c_str(),
                                                                                             enable_vpu_fast_compile,
-                                                                                            openvino_device_id.c_str()));
+                                                                                            openvino_device_id.c_str(),
+                                                                                            num_of_infer_requests,
+                                                                                            blob_cache_dir.c_str()));
       // Reset global variables config to avoid it being accidentally passed on to the next session
       openvino_device_type.clear();
 #endif
@@ -784,6 +875,99 @@ static bool CheckIfTensor(const std::vector<const NodeArg*>& def_list,
   return type_proto.has_tensor_type();
 }
 
+static void CreateFeeds(PyInferenceSession* sess, const std::map<std::string, py::object>& pyfeeds,
+                        NameMLValMap& feeds) {
+  auto px = sess->GetSessionHandle()->GetModelInputs();
+  if (!px.first.IsOK() || !px.second) {
+    throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+  }
+
+  for (auto _ : pyfeeds) {
+    OrtValue ml_value;
+    CreateGenericMLValue(px.second, GetAllocator(), _.first, _.second, &ml_value);
+    if (PyErr_Occurred()) {
+      PyObject *ptype, *pvalue, *ptraceback;
+      PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+
+      PyObject* pStr = PyObject_Str(ptype);
+      std::string sType = py::reinterpret_borrow<py::str>(pStr);
+      Py_XDECREF(pStr);
+      pStr = PyObject_Str(pvalue);
+      sType += ": ";
+      sType += py::reinterpret_borrow<py::str>(pStr);
+      Py_XDECREF(pStr);
+      throw std::runtime_error(sType);
+    }
+    feeds.insert(std::make_pair(_.first, ml_value));
+  }
+}
+
+static void RunWithFeeds(PyInferenceSession* sess, const NameMLValMap& feeds,
+                         const std::vector<std::string>& output_names, std::vector<OrtValue>& fetches,
+                         RunOptions* run_options) {
+  // release GIL to allow multiple python threads to invoke Run() in parallel.
+  py::gil_scoped_release release;
+  if (run_options != nullptr) {
+    OrtPybindThrowIfError(sess->GetSessionHandle()->Run(*run_options, feeds, output_names, &fetches));
+  } else {
+    OrtPybindThrowIfError(sess->GetSessionHandle()->Run(feeds, output_names, &fetches));
+  }
+}
+
+static void AddFetchAsPyObj(const OrtValue& fetch, std::vector<py::object>& pyobjs) {
+  if (fetch.IsTensor()) {
+    AddTensorAsPyObj(fetch, pyobjs, nullptr, nullptr);
+  } else {
+    AddNonTensorAsPyObj(fetch, pyobjs, nullptr, nullptr);
+  }
+}
+
+// Creates a fetch over the memory of output_array, so that Run writes the output into it.
+static void CreatePreallocatedFetch(PyInferenceSession* sess, const std::string& name, py::object& output_array,
+                                    OrtValue& fetch) {
+  auto px = sess->GetSessionHandle()->GetModelOutputs();
+  if (!px.first.IsOK() || !px.second) {
+    throw std::runtime_error("Either failed to get model outputs from the session object or the output def list was null");
+  }
+
+  onnx::TypeProto type_proto;
+  if (!CheckIfTensor(*px.second, name, type_proto) || !type_proto.tensor_type().has_elem_type() ||
+      type_proto.tensor_type().elem_type() == onnx::TensorProto::STRING) {
+    throw std::runtime_error("Output arrays are only supported for non-string Tensors, unlike output " + name);
+  }
+
+  if (PyArray_Check(output_array.ptr())) {
+    PyArrayObject* array = reinterpret_cast<PyArrayObject*>(output_array.ptr());
+    if (!PyArray_ISCARRAY(array)) {
+      throw std::runtime_error("The output array of " + name + " must be C-contiguous, aligned and writeable");
+    }
+
+    int type_num = PyArray_TYPE(array);
+    if (!IsNumericNumpyType(type_num)) {
+      throw std::runtime_error("The output array of " + name + " must be numeric");
+    }
+
+    std::vector<int64_t> shape(PyArray_DIMS(array), PyArray_DIMS(array) + PyArray_NDIM(array));
+    auto p_tensor = onnxruntime::make_unique<Tensor>(NumpyTypeToOnnxRuntimeType(type_num), shape,
+                                                     PyArray_DATA(array), GetAllocator()->Info());
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    fetch.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  } else if (strcmp(Py_TYPE(output_array.ptr())->tp_name, PYTHON_ORTVALUE_OBJECT_NAME) == 0) {
+    fetch = *output_array.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+  } else if (py::isinstance<OrtValue>(output_array)) {
+    fetch = *output_array.cast<OrtValue*>();
+  } else if (IsDlpackObject(output_array)) {
+    fetch = *OrtValueFromDlpack(output_array);
+  } else {
+    throw std::runtime_error("The output array of " + name + " must be a numpy array, an OrtValue or a DLPack tensor");
+  }
+
+  if (!fetch.IsTensor() ||
+      fetch.Get<Tensor>().GetElementType() != type_proto.tensor_type().elem_type()) {
+    throw std::runtime_error("The output array of " + name + " doesn't have the element type of the output");
+  }
+}
+
 void addGlobalMethods(py::module& m, const Environment& env) {
   m.def("get_default_session_options", &GetDefaultCPUSessionOptions, "Return a default session_options instance.");
   m.def("get_session_initializer", &SessionObjectInitializer::Get, "Return a default session object initializer.");
@@ -858,7 +1042,7 @@ void addGlobalMethods(py::module& m, const Environment& env) {
         std::vector<std::shared_ptr<onnxruntime::IExecutionProviderFactory>> factories = {
             onnxruntime::CreateExecutionProviderFactory_CPU(0),
 #ifdef USE_CUDA
-            onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cudnn_conv_algo_search, cuda_mem_limit, arena_extend_strategy, do_copy_in_default_stream),
+            onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cudnn_conv_algo_search, cuda_mem_limit, arena_extend_strategy, do_copy_in_default_stream, enable_cuda_graph, "", enable_stream_ordered_allocator, false, ""),
 #endif
 #ifdef USE_DNNL
             onnxruntime::CreateExecutionProviderFactory_Dnnl(1),
@@ -867,7 +1051,7 @@ void addGlobalMethods(py::module& m, const Environment& env) {
             onnxruntime::CreateExecutionProviderFactory_NGraph("CPU"),
 #endif
 #ifdef USE_OPENVINO
-            onnxruntime::CreateExecutionProviderFactory_OpenVINO(openvino_device_type, false, ""),
+            onnxruntime::CreateExecutionProviderFactory_OpenVINO(openvino_device_type, false, "", 0, ""),
 #endif
 #ifdef USE_TENSORRT
             onnxruntime::CreateExecutionProviderFactory_Tensorrt(0),
@@ -1201,6 +1385,23 @@ void addObjectMethods(py::module& m, Environment& env) {
         GetPyObjFromTensor(ml_value->Get<Tensor>(), obj, nullptr, nullptr);
 #endif
         return obj;
+      })
+      // Factory method to create an OrtValue (Tensor) over the memory of a tensor exported with DLPack,
+      // e.g. a PyTorch or CuPy tensor on the CPU or a CUDA device. The data is not copied.
+      .def_static("from_dlpack", [](py::object& obj) {
+        return OrtValueFromDlpack(obj);
+      })
+      .def("to_dlpack", [](OrtValue* ml_value) -> py::object {
+        return OrtValueToDlpack(*ml_value);
+      })
+      // The stream is ignored: the data of an OrtValue is ready once the Run that produced it has returned.
+      .def(
+          "__dlpack__", [](OrtValue* ml_value, py::object& /*stream*/) -> py::object {
+            return OrtValueToDlpack(*ml_value);
+          },
+          py::arg("stream") = py::none())
+      .def("__dlpack_device__", [](OrtValue* ml_value) -> py::tuple {
+        return DlpackDevice(*ml_value);
       });
 
   py::class_<SessionIOBinding> session_io_binding(m, "SessionIOBinding");
@@ -1640,49 +1841,76 @@ including arg name, arg type (contains both type and shape).)pbdoc")
               std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr)
                -> std::vector<py::object> {
              NameMLValMap feeds;
-             for (auto _ : pyfeeds) {
-               OrtValue ml_value;
-               auto px = sess->GetSessionHandle()->GetModelInputs();
-               if (!px.first.IsOK() || !px.second) {
-                 throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
-               }
-               CreateGenericMLValue(px.second, GetAllocator(), _.first, _.second, &ml_value);
-               if (PyErr_Occurred()) {
-                 PyObject *ptype, *pvalue, *ptraceback;
-                 PyErr_Fetch(&ptype, &pvalue, &ptraceback);
-
-                 PyObject* pStr = PyObject_Str(ptype);
-                 std::string sType = py::reinterpret_borrow<py::str>(pStr);
-                 Py_XDECREF(pStr);
-                 pStr = PyObject_Str(pvalue);
-                 sType += ": ";
-                 sType += py::reinterpret_borrow<py::str>(pStr);
-                 Py_XDECREF(pStr);
-                 throw std::runtime_error(sType);
-               }
-               feeds.insert(std::make_pair(_.first, ml_value));
-             }
+             CreateFeeds(sess, pyfeeds, feeds);
 
              std::vector<OrtValue> fetches;
-             common::Status status;
+             RunWithFeeds(sess, feeds, output_names, fetches, run_options);
 
+             std::vector<py::object> rfetch;
+             rfetch.reserve(fetches.size());
+             for (auto _ : fetches) {
+               AddFetchAsPyObj(_, rfetch);
+             }
+             return rfetch;
+           })
+      // Runs the model once for each of the feed dicts concurrently, see InferenceSession::RunMany.
+      .def("run_many",
+           [](PyInferenceSession* sess, std::vector<std::string> output_names,
+              std::vector<std::map<std::string, py::object>> pyfeeds_list, RunOptions* run_options = nullptr)
+               -> std::vector<std::vector<py::object>> {
+             std::vector<NameMLValMap> feeds(pyfeeds_list.size());
+             for (size_t i = 0; i < pyfeeds_list.size(); ++i) {
+               CreateFeeds(sess, pyfeeds_list[i], feeds[i]);
+             }
+
+             std::vector<std::vector<OrtValue>> fetches;
              {
-               // release GIL to allow multiple python threads to invoke Run() in parallel.
+               // release GIL to allow other python threads to run while the Runs execute.
                py::gil_scoped_release release;
-               if (run_options != nullptr) {
-                 OrtPybindThrowIfError(sess->GetSessionHandle()->Run(*run_options, feeds, output_names, &fetches));
-               } else {
-                 OrtPybindThrowIfError(sess->GetSessionHandle()->Run(feeds, output_names, &fetches));
+               RunOptions default_run_options;
+               OrtPybindThrowIfError(sess->GetSessionHandle()->RunMany(
+                   run_options != nullptr ? *run_options : default_run_options, feeds, output_names, fetches));
+             }
+
+             std::vector<std::vector<py::object>> rfetches(fetches.size());
+             for (size_t i = 0; i < fetches.size(); ++i) {
+               rfetches[i].reserve(fetches[i].size());
+               for (const auto& fetch : fetches[i]) {
+                 AddFetchAsPyObj(fetch, rfetches[i]);
                }
              }
+             return rfetches;
+           })
+      // Writes the outputs into output_arrays, a list parallel to output_names of None, to allocate the output,
+      // or of numpy arrays, OrtValues or DLPack tensors the output is written into without copying it.
+      .def("run_with_output_arrays",
+           [](PyInferenceSession* sess, std::vector<std::string> output_names,
+              std::map<std::string, py::object> pyfeeds, std::vector<py::object> output_arrays,
+              RunOptions* run_options = nullptr) -> std::vector<py::object> {
+             if (output_arrays.size() != output_names.size()) {
+               throw std::runtime_error("Expected " + std::to_string(output_names.size()) +
+                                        " output arrays but got " + std::to_string(output_arrays.size()));
+             }
+
+             NameMLValMap feeds;
+             CreateFeeds(sess, pyfeeds, feeds);
+
+             std::vector<OrtValue> fetches(output_names.size());
+             for (size_t i = 0; i < output_names.size(); ++i) {
+               if (!output_arrays[i].is_none()) {
+                 CreatePreallocatedFetch(sess, output_names[i], output_arrays[i], fetches[i]);
+               }
+             }
+
+             RunWithFeeds(sess, feeds, output_names, fetches, run_options);
 
              std::vector<py::object> rfetch;
              rfetch.reserve(fetches.size());
-             for (auto _ : fetches) {
-               if (_.IsTensor()) {
-                 AddTensorAsPyObj(_, rfetch, nullptr, nullptr);
+             for (size_t i = 0; i < fetches.size(); ++i) {
+               if (output_arrays[i].is_none()) {
+                 AddFetchAsPyObj(fetches[i], rfetch);
                } else {
-                 AddNonTensorAsPyObj(_, rfetch, nullptr, nullptr);
+                 rfetch.push_back(output_arrays[i]);
                }
              }
              return rfetch;
@@ -1,4 +1,4 @@
-from .quantize import quantize, quantize_static, quantize_dynamic, quantize_qat
+from .quantize import quantize, quantize_static, quantize_dynamic, quantize_qat, quantize_weight_only
 from .quantize import QuantizationMode
 from .calibrate import CalibrationDataReader
 from .calibrate import calibrate
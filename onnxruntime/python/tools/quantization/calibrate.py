@@ -9,9 +9,12 @@
 import numpy as np
 import onnx
 import onnxruntime
-from onnx import helper, TensorProto
+from onnx import helper, numpy_helper, TensorProto
 
 import abc
+import threading
+
+calibration_modes = ['naive', 'entropy', 'percentile']
 
 
 class CalibrationDataReader(metaclass=abc.ABCMeta):
@@ -25,9 +28,148 @@ class CalibrationDataReader(metaclass=abc.ABCMeta):
         raise NotImplementedError
 
 
+class HistogramCollector:
+    '''
+        Aggregates a histogram of the values of each tensor batch by batch, so the calibration data never has to be
+        held in memory. The histogram of a tensor is symmetric around zero with num_bins bins, and its range is widened
+        by an integer factor when a batch exceeds it, which merges the counts of the old bins exactly.
+    '''
+    def __init__(self, num_bins=2048):
+        if num_bins < 2 or num_bins % 2 != 0:
+            raise ValueError('num_bins must be a positive even number, got {}'.format(num_bins))
+        self.num_bins = num_bins
+        # tensor name -> [histogram, threshold, min, max], the histogram covers [-threshold, threshold]
+        self.histograms = {}
+
+    def collect(self, tensor_name, data):
+        data = np.asarray(data, dtype=np.float32).ravel()
+        if data.size == 0:
+            return
+        rmin = float(data.min())
+        rmax = float(data.max())
+        threshold = max(abs(rmin), abs(rmax))
+
+        entry = self.histograms.get(tensor_name)
+        if entry is None:
+            threshold = threshold if threshold > 0 else 1.0
+            histogram = np.zeros(self.num_bins, dtype=np.int64)
+            entry = [histogram, threshold, rmin, rmax]
+            self.histograms[tensor_name] = entry
+        elif threshold > entry[1]:
+            # each old bin falls into a single bin of the range widened by factor
+            factor = int(np.ceil(threshold / entry[1]))
+            indices = (np.arange(self.num_bins) + (factor - 1) * (self.num_bins // 2)) // factor
+            histogram = np.zeros(self.num_bins, dtype=np.int64)
+            np.add.at(histogram, indices, entry[0])
+            entry[0] = histogram
+            entry[1] = entry[1] * factor
+
+        histogram, _ = np.histogram(data, self.num_bins, range=(-entry[1], entry[1]))
+        entry[0] += histogram
+        entry[2] = min(entry[2], rmin)
+        entry[3] = max(entry[3], rmax)
+
+    def _absolute_histogram(self, tensor_name):
+        '''
+            Returns the histogram of the absolute values of a tensor and its bin width.
+        '''
+        histogram, threshold, _, _ = self.histograms[tensor_name]
+        half = self.num_bins // 2
+        return histogram[half:] + histogram[:half][::-1], threshold / half
+
+    def _clamp(self, tensor_name, threshold):
+        '''
+            Clips the observed range of a tensor to [-threshold, threshold].
+        '''
+        _, _, rmin, rmax = self.histograms[tensor_name]
+        return (min(max(rmin, -threshold), threshold), min(max(rmax, -threshold), threshold))
+
+    def compute_percentile(self, percentile=99.999):
+        '''
+            Returns the range of each tensor that clips the given percentile of its absolute values.
+        '''
+        if percentile < 0 or percentile > 100:
+            raise ValueError('percentile must be in [0, 100], got {}'.format(percentile))
+
+        ranges = {}
+        for tensor_name in self.histograms:
+            histogram, bin_width = self._absolute_histogram(tensor_name)
+            cdf = np.cumsum(histogram) / histogram.sum()
+            index = min(int(np.searchsorted(cdf, percentile / 100.0)), len(histogram) - 1)
+            ranges[tensor_name] = self._clamp(tensor_name, (index + 1) * bin_width)
+        return ranges
+
+    def compute_entropy(self, num_quantized_bins=128):
+        '''
+            Returns the range of each tensor that minimizes the KL divergence between the histogram of its absolute
+            values and the histogram quantized to num_quantized_bins bins.
+        '''
+        ranges = {}
+        for tensor_name in self.histograms:
+            histogram, bin_width = self._absolute_histogram(tensor_name)
+            ranges[tensor_name] = self._clamp(
+                tensor_name,
+                _get_entropy_threshold_bins(histogram, num_quantized_bins) * bin_width)
+        return ranges
+
+
+def _get_entropy_threshold_bins(histogram, num_quantized_bins):
+    '''
+        Returns the number of bins of histogram to keep that minimizes the KL divergence between the kept bins, with the
+        outliers clipped into the last bin, and their quantization to num_quantized_bins bins.
+    '''
+    num_bins = len(histogram)
+    if num_bins <= num_quantized_bins:
+        return num_bins
+
+    histogram = histogram.astype(np.float64)
+    outliers = np.cumsum(histogram[::-1])[::-1]
+    best_bins = num_bins
+    best_divergence = np.inf
+
+    for bins in range(num_quantized_bins, num_bins + 1):
+        sliced = histogram[:bins]
+        reference = sliced.copy()
+        if bins < num_bins:
+            reference[bins - 1] += outliers[bins]
+        is_nonzero = reference != 0
+
+        # spread the count of each quantized bin evenly over its nonzero bins
+        starts = np.arange(num_quantized_bins) * bins // num_quantized_bins
+        lengths = np.diff(np.append(starts, bins))
+        counts = np.add.reduceat(sliced, starts)
+        nonzeros = np.add.reduceat(is_nonzero.astype(np.float64), starts)
+        averages = np.divide(counts, nonzeros, out=np.zeros_like(counts), where=nonzeros != 0)
+        quantized = (np.repeat(averages, lengths) * is_nonzero)[is_nonzero]
+        if quantized.sum() == 0:
+            continue
+
+        # smooth the bins that the clipping emptied, so the divergence stays finite
+        p = reference[is_nonzero] / reference.sum()
+        q = quantized / quantized.sum()
+        q = np.where(q == 0, 1e-4, q)
+        q = q / q.sum()
+        divergence = np.sum(p * np.log(p / q))
+        if divergence < best_divergence:
+            best_divergence = divergence
+            best_bins = bins
+
+    return best_bins
+
+
 class ONNXCalibrater:
-    def __init__(self, model_path, data_reader: CalibrationDataReader, calibrate_op_types, black_nodes, white_nodes,
-                 augmented_model_path):
+    def __init__(self,
+                 model_path,
+                 data_reader: CalibrationDataReader,
+                 calibrate_op_types,
+                 black_nodes,
+                 white_nodes,
+                 augmented_model_path,
+                 calib_mode='naive',
+                 num_workers=1,
+                 num_bins=2048,
+                 num_quantized_bins=128,
+                 percentile=99.999):
         '''
         :param model_path: ONNX model to calibrate
         :param data_reader: user implemented object to read in and preprocess calibration dataset
@@ -36,20 +178,40 @@ class ONNXCalibrater:
         :param black_nodes: operator names that should not be quantized, default = ''
         :param white_nodes: operator names that force to be quantized, default = ''
         :param augmented_model_path: save augmented_model to this path
+        :param calib_mode: 'naive' takes the min and max of each tensor, 'entropy' the range that minimizes the KL
+                           divergence of its histogram and 'percentile' the range that clips the given percentile of
+                           its absolute values
+        :param num_workers: number of calibration batches run concurrently
+        :param num_bins: number of bins of the histograms of the 'entropy' and 'percentile' modes
+        :param num_quantized_bins: number of quantized bins the 'entropy' mode compares the histograms with
+        :param percentile: percentile of the absolute values the 'percentile' mode keeps
 
         '''
+        if calib_mode not in calibration_modes:
+            raise ValueError('Unknown value for calib_mode {}, it must be one of {}.'.format(
+                calib_mode, calibration_modes))
+        if num_workers < 1:
+            raise ValueError('num_workers must be at least 1, got {}'.format(num_workers))
+
         self.model_path = model_path
         self.data_reader = data_reader
         self.calibrate_op_types = calibrate_op_types
         self.black_nodes = black_nodes
         self.white_nodes = white_nodes
         self.augmented_model_path = augmented_model_path
+        self.calib_mode = calib_mode
+        self.num_workers = num_workers
+        self.num_bins = num_bins
+        self.num_quantized_bins = num_quantized_bins
+        self.percentile = percentile
         self.input_name_to_nodes = {}
+        self.tensors_to_calibrate = []
 
     def augment_graph(self):
         '''
         Adds ReduceMin and ReduceMax nodes to all quantization_candidates op type nodes in
-        model and ensures their outputs are stored as part of the graph output
+        model and ensures their outputs are stored as part of the graph output. In the 'entropy' and 'percentile'
+        modes, the candidate tensors themselves are added to the graph outputs instead.
         :return: augmented ONNX model
         '''
 
@@ -70,7 +232,20 @@ class ONNXCalibrater:
                 if tensor in model.graph.initializer:
                     tensors_to_calibrate.remove(tensor)
 
-        for tensor in tensors_to_calibrate:
+        self.tensors_to_calibrate = sorted(tensors_to_calibrate)
+
+        if self.calib_mode != 'naive':
+            # the graph inputs and initializers are collected from the feeds and the model
+            existing_outputs = set(output.name for output in model.graph.output)
+            non_node_outputs = set(graph_input.name for graph_input in model.graph.input)
+            non_node_outputs.update(initializer.name for initializer in model.graph.initializer)
+            for tensor in self.tensors_to_calibrate:
+                if tensor not in existing_outputs and tensor not in non_node_outputs:
+                    added_outputs.append(helper.make_tensor_value_info(tensor, TensorProto.FLOAT, None))
+            model.graph.output.extend(added_outputs)
+            return model
+
+        for tensor in self.tensors_to_calibrate:
             # Adding ReduceMin nodes
             reduce_min_name = tensor + '_ReduceMin'
             reduce_min_node = onnx.helper.make_node('ReduceMin', [tensor], [tensor + '_ReduceMin'],
@@ -94,58 +269,113 @@ class ONNXCalibrater:
 
         return model
 
+    def _run_calibration_data(self, output_names, collect):
+        '''
+            Runs the calibration data through the augmented model, fetching only output_names, and passes the inputs
+            and outputs of each batch to collect as soon as it is run, so that no batch is held after it is collected.
+            Up to num_workers batches run concurrently on the same session.
+        '''
+        session = onnxruntime.InferenceSession(self.augmented_model_path, None)
+
+        reader_lock = threading.Lock()
+        collect_lock = threading.Lock()
+        errors = []
+
+        def worker():
+            try:
+                while True:
+                    with reader_lock:
+                        if errors:
+                            return
+                        inputs = self.data_reader.get_next()
+                    if not inputs:
+                        return
+                    outputs = session.run(output_names, inputs)
+                    with collect_lock:
+                        collect(inputs, dict(zip(output_names, outputs)))
+            except Exception as e:
+                with reader_lock:
+                    errors.append(e)
+
+        if self.num_workers == 1:
+            worker()
+        else:
+            workers = [threading.Thread(target=worker) for _ in range(self.num_workers)]
+            for thread in workers:
+                thread.start()
+            for thread in workers:
+                thread.join()
+
+        if errors:
+            raise errors[0]
+
     #Using augmented outputs to generate inputs for quantization
-    def get_intermediate_outputs(self, calib_mode='naive'):
+    def get_intermediate_outputs(self, calib_mode=None):
         ''' 
             Gather intermediate model outputs after running inference
             parameter calib_mode: type 'naive' gives (ReduceMin, ReduceMax) pairs
                                 for each augmented node across test data sets, where
                                 the first element is a minimum of all ReduceMin values
                                 and the second element is a maximum of all ReduceMax
-                                values;
+                                values; types 'entropy' and 'percentile' give the
+                                ranges computed from the histograms of the tensors
+                                across test data sets. Defaults to the mode of the calibrater.
             :return: dictionary mapping: {added node names: (ReduceMin, ReduceMax) pairs }
         '''
+        calib_mode = calib_mode or self.calib_mode
+        if calib_mode not in calibration_modes:
+            raise ValueError('Unknown value for calib_mode {}, it must be one of {}.'.format(
+                calib_mode, calibration_modes))
+        if (calib_mode == 'naive') != (self.calib_mode == 'naive'):
+            raise ValueError('calib_mode {} needs a model augmented for it, the model was augmented for {}.'.format(
+                calib_mode, self.calib_mode))
 
-        #conduct inference session and get intermediate outputs
-        session = onnxruntime.InferenceSession(self.augmented_model_path, None)
+        if calib_mode == 'naive':
+            ranges = {}
+
+            def collect_min_max(inputs, outputs):
+                for tensor in self.tensors_to_calibrate:
+                    rmin = float(outputs[tensor + '_ReduceMin'])
+                    rmax = float(outputs[tensor + '_ReduceMax'])
+                    if tensor in ranges:
+                        ranges[tensor] = (min(ranges[tensor][0], rmin), max(ranges[tensor][1], rmax))
+                    else:
+                        ranges[tensor] = (rmin, rmax)
+
+            output_names = [tensor + suffix for tensor in self.tensors_to_calibrate
+                            for suffix in ('_ReduceMin', '_ReduceMax')]
+            self._run_calibration_data(output_names, collect_min_max)
+            return ranges
 
-        intermediate_outputs = []
-        while True:
-            inputs = self.data_reader.get_next()
-            if not inputs:
-                break
-            intermediate_outputs.append(session.run(None, inputs))
-        node_output_names = [session.get_outputs()[i].name for i in range(len(intermediate_outputs[0]))]
-        output_dicts_list = [
-            dict(zip(node_output_names, intermediate_output)) for intermediate_output in intermediate_outputs
+        model = onnx.load(self.model_path)
+        initializers = dict((initializer.name, initializer) for initializer in model.graph.initializer)
+        graph_inputs = set(graph_input.name for graph_input in model.graph.input)
+
+        collector = HistogramCollector(self.num_bins)
+        for tensor in self.tensors_to_calibrate:
+            if tensor in initializers and tensor not in graph_inputs:
+                collector.collect(tensor, numpy_helper.to_array(initializers[tensor]))
+
+        output_names = [
+            tensor for tensor in self.tensors_to_calibrate if tensor not in initializers and tensor not in graph_inputs
         ]
 
-        #number of outputs in original model
-        model = onnx.load(self.model_path)
-        num_model_outputs = len(model.graph.output)
-        merged_dict = {}
-        for d in output_dicts_list:
-            for k, v in d.items():
-                merged_dict.setdefault(k, []).append(v)
-        added_node_output_names = node_output_names[num_model_outputs:]
-        node_names = [added_node_output_names[i].rpartition('_')[0]
-                      for i in range(0, len(added_node_output_names), 2)]  #output names
-
-        # Characterizing distribution of a node's values across test data sets
-        clean_merged_dict = dict((i, merged_dict[i]) for i in merged_dict if i != list(merged_dict.keys())[0])
-        if calib_mode == 'naive':
-            pairs = [
-                tuple([
-                    float(min(clean_merged_dict[added_node_output_names[i]])),
-                    float(max(clean_merged_dict[added_node_output_names[i + 1]]))
-                ]) for i in range(0, len(added_node_output_names), 2)
-            ]
-        else:
-            raise ValueError('Unknown value for calib_mode. Currently only naive mode is supported.')
+        def collect_histograms(inputs, outputs):
+            for tensor in self.tensors_to_calibrate:
+                if tensor in outputs:
+                    collector.collect(tensor, outputs[tensor])
+                elif tensor in inputs:
+                    collector.collect(tensor, inputs[tensor])
 
-        final_dict = dict(zip(node_names, pairs))
+        self._run_calibration_data(output_names, collect_histograms)
+        # initializers that are graph inputs too and were not fed
+        for tensor in self.tensors_to_calibrate:
+            if tensor in initializers and tensor not in collector.histograms:
+                collector.collect(tensor, numpy_helper.to_array(initializers[tensor]))
 
-        return final_dict
+        if calib_mode == 'entropy':
+            return collector.compute_entropy(self.num_quantized_bins)
+        return collector.compute_percentile(self.percentile)
 
     def _get_input_name_to_nodes(self, model):
         '''
@@ -238,7 +468,12 @@ def calibrate(model_path,
               op_types=['Conv', 'MatMul'],
               black_nodes=[],
               white_nodes=[],
-              augmented_model_path='augmented_model.onnx'):
+              augmented_model_path='augmented_model.onnx',
+              calib_mode='naive',
+              num_workers=1,
+              num_bins=2048,
+              num_quantized_bins=128,
+              percentile=99.999):
     '''
         Given an onnx model, augment and run the augmented model on calibration data set, aggregate and calculate the quantization parameters.
 
@@ -248,9 +483,15 @@ def calibrate(model_path,
     :param black_nodes: operator names that should not be quantized, default = ''
     :param white_nodes: operator names that force to be quantized, default = ''
     :param augmented_model_path: save augmented_model to this path
+    :param calib_mode: 'naive', 'entropy' or 'percentile', see ONNXCalibrater
+    :param num_workers: number of calibration batches run concurrently
+    :param num_bins: number of bins of the histograms of the 'entropy' and 'percentile' modes
+    :param num_quantized_bins: number of quantized bins the 'entropy' mode compares the histograms with
+    :param percentile: percentile of the absolute values the 'percentile' mode keeps
     '''
     #1. initialize a calibrater
-    calibrater = ONNXCalibrater(model_path, data_reader, op_types, black_nodes, white_nodes, augmented_model_path)
+    calibrater = ONNXCalibrater(model_path, data_reader, op_types, black_nodes, white_nodes, augmented_model_path,
+                                calib_mode, num_workers, num_bins, num_quantized_bins, percentile)
     #2. augment
     augmented_model = calibrater.augment_graph()
     onnx.save(augmented_model, augmented_model_path)
@@ -260,4 +501,21 @@ def calibrate(model_path,
     quantization_params_dict = calibrater.calculate_quantization_params(dict_for_quantization)
 
     print("Calibrated,quantized parameters calculated and returned.")
-    return quantization_params_dict
\ No newline at end of file
+    return quantization_params_dict
+
+
+def write_calibration_table(calibration_cache, path='calibration.table'):
+    '''
+        Write the tensor ranges found by ONNXCalibrater.get_intermediate_outputs to a calibration table that the
+        TensorRT execution provider loads in INT8 mode (see ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH).
+        TensorRT needs the range of every tensor of the subgraphs it runs in INT8, so the model should be calibrated
+        with all its op types rather than the default Conv and MatMul.
+    :param calibration_cache: dictionary mapping tensor names to (min, max) pairs
+    :param path: file to write the table to
+    '''
+    with open(path, 'w') as table:
+        table.write('onnxruntime_tensorrt_calibration_table 1\n')
+        for tensor_name, (rmin, rmax) in sorted(calibration_cache.items()):
+            if '\t' in tensor_name or '\n' in tensor_name:
+                raise ValueError('Tensor name {} can not be written to a calibration table.'.format(repr(tensor_name)))
+            table.write('{}\t{} {}\n'.format(tensor_name, repr(float(rmin)), repr(float(rmax))))
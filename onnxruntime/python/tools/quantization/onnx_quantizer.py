@@ -104,6 +104,11 @@ class ONNXQuantizer:
         # For int8 data-type, zero point is always zero (respresented by fixed_zero_point_name tensor)
         self.fixed_zero_zp_name = "fixed_zero_zp"
 
+        # Bits, block size and symmetry of the blockwise quantized weights. Used when mode is WeightOnly
+        self.weight_only_bits = 4
+        self.weight_only_block_size = 32
+        self.weight_only_symmetric = True
+
         # List of quantized weights
         self._quantized_weights = []
         # Map of all original value names to quantized value names
@@ -1,6 +1,9 @@
+import numpy as np
 import onnx
+import onnx.numpy_helper
 from .base_operator import QuantOperatorBase
-from ..quant_utils import find_by_name, get_mul_node, QuantizedValue, QuantizedValueType
+from ..quant_utils import find_by_name, get_mul_node, QuantizedValue, QuantizedValueType, QuantizedInitializer
+from ..quant_utils import ms_domain
 from onnx import onnx_pb as onnx_proto
 '''
     Used when quantize mode is QuantizationMode.IntegerOps.
@@ -101,3 +104,101 @@ class QLinearMatMul(QuantOperatorBase):
         self.quantizer.quantized_value_map[node.output[0]] = q_output
 
         self.quantizer.new_nodes += nodes
+
+
+'''
+    Used when quantize mode is QuantizationMode.WeightOnly
+'''
+
+
+def quantize_blockwise(weight, bits, block_size, symmetric):
+    '''
+        Quantizes the columns of the 2D weight [K, N] in blocks of block_size values along K, as the MatMulNBits
+        contrib op expects them.
+        return: the packed quantized values [N, blocks_per_col, block_size * bits / 8] as uint8, the scales
+        [N * blocks_per_col] as float, and the packed zero points as uint8, or None if symmetric.
+    '''
+    K, N = weight.shape
+    blocks_per_col = (K + block_size - 1) // block_size
+    # the padding of the last block is quantized to the zero point
+    padded = np.zeros((blocks_per_col * block_size, N), dtype=np.float32)
+    padded[:K] = weight
+    blocks = padded.T.reshape(N, blocks_per_col, block_size)
+    qmax = (1 << bits) - 1
+    symmetric_zero_point = 1 << (bits - 1)
+
+    if symmetric:
+        # map the value of the largest magnitude to -2^(bits - 1)
+        abs_max_index = np.argmax(np.abs(blocks), axis=2)
+        signed_max = np.take_along_axis(blocks, abs_max_index[..., np.newaxis], axis=2)[..., 0]
+        scales = signed_max / -float(symmetric_zero_point)
+        zero_points = np.full(scales.shape, symmetric_zero_point, dtype=np.int32)
+    else:
+        # the range always contains zero, so that zero is exactly representable
+        rmin = np.minimum(blocks.min(axis=2), 0.0)
+        rmax = np.maximum(blocks.max(axis=2), 0.0)
+        scales = (rmax - rmin) / float(qmax)
+        safe_scales = np.where(scales != 0, scales, 1.0)
+        zero_points = np.where(scales != 0, np.clip(np.rint(-rmin / safe_scales), 0, qmax),
+                               symmetric_zero_point).astype(np.int32)
+
+    scales = scales.astype(np.float32)
+    reciprocal_scales = np.where(scales != 0, 1.0 / np.where(scales != 0, scales, 1.0), 0.0)
+    quantized = np.clip(np.rint(blocks * reciprocal_scales[..., np.newaxis]) + zero_points[..., np.newaxis], 0,
+                        qmax).astype(np.uint8)
+
+    if bits == 4:
+        # the first value of a pair in the low nibble
+        quantized = quantized[..., 0::2] | (quantized[..., 1::2] << 4)
+
+    packed_zero_points = None
+    if not symmetric:
+        packed_zero_points = zero_points.astype(np.uint8)
+        if bits == 4:
+            if blocks_per_col % 2 != 0:
+                packed_zero_points = np.pad(packed_zero_points, ((0, 0), (0, 1)), 'constant')
+            packed_zero_points = packed_zero_points[:, 0::2] | (packed_zero_points[:, 1::2] << 4)
+        packed_zero_points = packed_zero_points.reshape(-1)
+
+    return quantized, scales.reshape(-1), packed_zero_points
+
+
+class MatMulWeightOnly(QuantOperatorBase):
+    def __init__(self, onnx_quantizer, onnx_node):
+        super().__init__(onnx_quantizer, onnx_node)
+
+    def quantize(self):
+        node = self.node
+        assert (node.op_type == "MatMul")
+
+        # only a 2D float weight that no other node consumes is replaced by its quantized blocks
+        weight = find_by_name(node.input[1], self.quantizer.model.initializer())
+        if weight is None or weight.data_type != onnx_proto.TensorProto.FLOAT or len(weight.dims) != 2 or \
+                len(self.quantizer.model.input_name_to_nodes()[weight.name]) != 1:
+            super().quantize()
+            return
+
+        bits = self.quantizer.weight_only_bits
+        block_size = self.quantizer.weight_only_block_size
+        symmetric = self.quantizer.weight_only_symmetric
+        K, N = weight.dims
+
+        quantized, scales, zero_points = quantize_blockwise(onnx.numpy_helper.to_array(weight), bits, block_size,
+                                                            symmetric)
+
+        quantized_name = weight.name + "_Q" + str(bits)
+        scales_name = weight.name + "_scales"
+        self.quantizer.model.add_initializer(onnx.numpy_helper.from_array(quantized, quantized_name))
+        self.quantizer.model.add_initializer(onnx.numpy_helper.from_array(scales, scales_name))
+        inputs = [node.input[0], quantized_name, scales_name]
+        if zero_points is not None:
+            zero_points_name = weight.name + "_zero_points"
+            self.quantizer.model.add_initializer(onnx.numpy_helper.from_array(zero_points, zero_points_name))
+            inputs.append(zero_points_name)
+
+        self.quantizer._quantized_weights.append(QuantizedInitializer(weight.name, weight, [], [], [], []))
+
+        kwargs = {"K": K, "N": N, "bits": bits, "block_size": block_size, "domain": ms_domain}
+        matmul_nbits_name = node.name + "_quant" if node.name != "" else ""
+        matmul_nbits_node = onnx.helper.make_node("MatMulNBits", inputs, [node.output[0]], matmul_nbits_name, **kwargs)
+        self.quantizer.new_nodes.append(matmul_nbits_node)
@@ -35,6 +35,7 @@ type_to_name = {
 class QuantizationMode():
     IntegerOps = 0
     QLinearOps = 1
+    WeightOnly = 2
 
 
 quantization_modes = [
@@ -19,6 +19,7 @@ from .quant_utils import find_by_name, get_elem_index, get_mul_node, generate_id
 from .quant_utils import QuantType
 
 from .registry import CreateOpQuantizer, CreateDefaultOpQuantizer, QLinearOpsRegistry, IntegerOpsRegistry
+from .registry import WeightOnlyOpsRegistry
 
 from .onnx_model import ONNXModel
 from .onnx_quantizer import ONNXQuantizer
@@ -131,7 +132,9 @@ def quantize_static(model_input,
                     weight_type=QuantType.QUInt8,
                     nodes_to_quantize=[],
                     nodes_to_exclude=[],
-                    use_external_data_format=False):
+                    use_external_data_format=False,
+                    calib_mode='naive',
+                    calib_num_workers=1):
     '''
         Given an onnx model and calibration data reader, create a quantized onnx model and save it into a file
     :param model_input: file path of model to quantize
@@ -155,6 +158,10 @@ def quantize_static(model_input,
         List of nodes names to exclude. The nodes in this list will be excluded from quantization
         when it is not None.
     :parma use_external_data_format: option used for large size (>2GB) model. Set to False by default. 
+    :param calib_mode: how the ranges of the activations are calibrated: 'naive' takes their min and max, 'entropy' the
+        range that minimizes the KL divergence of their histogram and 'percentile' the range that clips the 99.999th
+        percentile of their absolute values. The histograms are aggregated batch by batch.
+    :param calib_num_workers: number of calibration batches run concurrently
     '''
 
     if activation_type != QuantType.QUInt8:
@@ -167,8 +174,13 @@ def quantize_static(model_input,
     if not op_types_to_quantize or len(op_types_to_quantize) == 0:
         op_types_to_quantize = list(QLinearOpsRegistry.keys())
 
-    quantization_params_dict = calibrate(model_input, calibration_data_reader, op_types_to_quantize, nodes_to_quantize,
-                                         nodes_to_exclude)
+    quantization_params_dict = calibrate(model_input,
+                                         calibration_data_reader,
+                                         op_types_to_quantize,
+                                         black_nodes=nodes_to_exclude,
+                                         white_nodes=nodes_to_quantize,
+                                         calib_mode=calib_mode,
+                                         num_workers=calib_num_workers)
 
     quantizer = ONNXQuantizer(
         onnx.load(model_input),
@@ -301,4 +313,59 @@ def quantize_qat(model_input: Path,
         op_types_to_quantize)
 
     quantizer.quantize_model()
-    quantizer.model.save_model_to_file(model_output, use_external_data_format)
\ No newline at end of file
+    quantizer.model.save_model_to_file(model_output, use_external_data_format)
+
+
+def quantize_weight_only(model_input: Path,
+                         model_output: Path,
+                         bits=4,
+                         block_size=32,
+                         symmetric=True,
+                         nodes_to_quantize=[],
+                         nodes_to_exclude=[],
+                         use_external_data_format=False):
+    '''
+        Given an onnx model, create a model whose MatMul weights are quantized blockwise and save it into a file.
+        The MatMul nodes with a 2D float weight are replaced by MatMulNBits nodes, which dequantize the weights on the
+        fly and keep the activations in float, e.g. for the memory bandwidth bound MatMuls of a decoder at batch 1.
+    :param model_input: file path of model to quantize
+    :param model_output: file path of quantized model
+    :param bits: number of bits of a quantized weight, 4 or 8
+    :param block_size: number of weights along K quantized with a scale and zero point, a power of 2 from 16 to 256
+    :param symmetric: quantize the blocks symmetrically, with no zero points stored, else over the range of their
+        values with a zero point per block
+    :param nodes_to_quantize:
+        List of nodes names to quantize. When this list is not None only the nodes in this list
+        are quantized.
+    :param nodes_to_exclude:
+        List of nodes names to exclude. The nodes in this list will be excluded from quantization
+        when it is not None.
+    :parma use_external_data_format: option used for large size (>2GB) model. Set to False by default.
+    '''
+
+    if bits not in (4, 8):
+        raise ValueError('unsupported number of bits {}, only 4 and 8 are supported'.format(bits))
+    if block_size < 16 or block_size > 256 or (block_size & (block_size - 1)) != 0:
+        raise ValueError('unsupported block size {}, a power of 2 from 16 to 256 is required'.format(block_size))
+
+    mode = QuantizationMode.WeightOnly
+    op_types_to_quantize = list(WeightOnlyOpsRegistry.keys())
+
+    quantizer = ONNXQuantizer(
+        onnx.load(model_input),
+        False,  #per_channel
+        False,  #reduce_range
+        mode,
+        False,  #static
+        onnx_proto.TensorProto.UINT8,
+        onnx_proto.TensorProto.UINT8,
+        None,
+        nodes_to_quantize,
+        nodes_to_exclude,
+        op_types_to_quantize)
+    quantizer.weight_only_bits = bits
+    quantizer.weight_only_block_size = block_size
+    quantizer.weight_only_symmetric = symmetric
+
+    quantizer.quantize_model()
+    quantizer.model.save_model_to_file(model_output, use_external_data_format)
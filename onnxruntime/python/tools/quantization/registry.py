@@ -1,6 +1,6 @@
 from .quant_utils import QuantizationMode
 from .operators.base_operator import QuantOperatorBase
-from .operators.matmul import MatMulInteger, QLinearMatMul
+from .operators.matmul import MatMulInteger, QLinearMatMul, MatMulWeightOnly
 from .operators.attention import AttentionQuant
 from .operators.embed_layernorm import EmbedLayerNormalizationQuant
 from .operators.gather import GatherQuant
@@ -31,13 +31,22 @@ QLinearOpsRegistry = {
 }
 QLinearOpsRegistry.update(CommonOpsRegistry)
 
+WeightOnlyOpsRegistry = {
+    "MatMul": MatMulWeightOnly,
+}
+
 
 def CreateDefaultOpQuantizer(onnx_quantizer, node):
     return QuantOperatorBase(onnx_quantizer, node)
 
 
 def CreateOpQuantizer(onnx_quantizer, node):
-    registry = IntegerOpsRegistry if onnx_quantizer.mode == QuantizationMode.IntegerOps else QLinearOpsRegistry
+    if onnx_quantizer.mode == QuantizationMode.WeightOnly:
+        registry = WeightOnlyOpsRegistry
+    elif onnx_quantizer.mode == QuantizationMode.IntegerOps:
+        registry = IntegerOpsRegistry
+    else:
+        registry = QLinearOpsRegistry
     if node.op_type in registry.keys():
         return registry[node.op_type](onnx_quantizer, node)
     return QuantOperatorBase(onnx_quantizer, node)
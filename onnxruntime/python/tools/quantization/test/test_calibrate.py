@@ -11,7 +11,8 @@ import onnx
 import onnxruntime
 import numpy as np
 from onnx import helper, TensorProto, numpy_helper
-from onnxruntime.quantization.calibrate import calibrate, CalibrationDataReader, ONNXCalibrater
+from onnxruntime.quantization.calibrate import calibrate, CalibrationDataReader, ONNXCalibrater, write_calibration_table
+from onnxruntime.quantization.calibrate import HistogramCollector
 
 
 def generate_input_initializer(tensor_shape, tensor_dtype, input_name):
@@ -265,7 +266,78 @@ class TestCalibrate(unittest.TestCase):
             self.assertEqual(scale_expected, scale_actual)
         
         print('Finished' + ' test calculation of quantization params.')
+
+    def test_write_calibration_table(self):
+        calibration_cache = {'X2': (np.float32(-1.5), np.float32(2.25)), 'input0': (0.0, 1.0)}
+        table_path = './test_calibration.table'
+        write_calibration_table(calibration_cache, table_path)
+
+        with open(table_path) as table:
+            lines = table.read().splitlines()
+        self.assertEqual(lines[0], 'onnxruntime_tensorrt_calibration_table 1')
+        self.assertEqual(lines[1:], ['X2\t-1.5 2.25', 'input0\t0.0 1.0'])
+
+        with self.assertRaises(ValueError):
+            write_calibration_table({'bad\tname': (0.0, 1.0)}, table_path)
     
+    def test_histogram_collector(self):
+        collector = HistogramCollector(num_bins=8)
+        collector.collect('x', np.array([-1.0, 0.5, 0.9], dtype=np.float32))
+        # widens [-1, 1] by 3, moving old bins 0, 6 and 7 to bins 2, 4 and 5
+        collector.collect('x', np.array([3.0], dtype=np.float32))
+
+        histogram, threshold, rmin, rmax = collector.histograms['x']
+        self.assertEqual(list(histogram), [0, 0, 1, 0, 1, 1, 0, 1])
+        self.assertEqual(threshold, 3.0)
+        self.assertEqual((rmin, rmax), (-1.0, 3.0))
+
+        # the histogram of the absolute values is [1, 2, 0, 1] with bins of 0.75
+        self.assertEqual(collector.compute_percentile(50)['x'], (-1.0, 1.5))
+        self.assertEqual(collector.compute_percentile(100)['x'], (-1.0, 3.0))
+
+        # the entropy calibration clips a single far outlier
+        collector = HistogramCollector()
+        collector.collect('y', np.linspace(-1.0, 1.0, 10001, dtype=np.float32)**3)
+        collector.collect('y', np.array([100.0], dtype=np.float32))
+        rmin, rmax = collector.compute_entropy()['y']
+        self.assertEqual(rmin, -1.0)
+        self.assertTrue(0.0 < rmax < 100.0)
+
+    def test_histogram_calibration(self):
+        #   Relu
+        #    |
+        #   Conv
+
+        input0 = helper.make_tensor_value_info('input0', TensorProto.FLOAT, [1, 3, 1, 3])
+        output = helper.make_tensor_value_info('output', TensorProto.FLOAT, [1, 3, 1, 3])
+        relu_node = onnx.helper.make_node('Relu', ['input0'], ['X1'], name='Relu')
+        conv_node = onnx.helper.make_node('Conv', ['X1', 'X1_weight'], ['output'], name='Conv')
+        graph = helper.make_graph([relu_node, conv_node], 'test_graph_5', [input0], [output])
+        graph.initializer.add().CopyFrom(generate_input_initializer([3, 3, 1, 1], np.float32, 'X1_weight'))
+        model = helper.make_model(graph)
+        test_model_path = './test_model_5.onnx'
+        onnx.save(model, test_model_path)
+
+        def get_ranges(calib_mode, num_workers):
+            augmented_model_path = './augmented_test_model_5_{}.onnx'.format(calib_mode)
+            calibrater = ONNXCalibrater(test_model_path, TestDataReaderSecond(), ['Conv'], [], [],
+                                        augmented_model_path, calib_mode=calib_mode, num_workers=num_workers)
+            onnx.save(calibrater.augment_graph(), augmented_model_path)
+            return calibrater.get_intermediate_outputs()
+
+        naive_ranges = get_ranges('naive', 1)
+        self.assertEqual(sorted(naive_ranges.keys()), ['X1', 'X1_weight', 'output'])
+        for calib_mode in ['entropy', 'percentile']:
+            ranges = get_ranges(calib_mode, 2)
+            self.assertEqual(sorted(ranges.keys()), sorted(naive_ranges.keys()))
+            # the histogram ranges clip the observed ranges, which are extended to zero when quantized
+            for tensor_name, (rmin, rmax) in ranges.items():
+                naive_min, naive_max = naive_ranges[tensor_name]
+                self.assertTrue(min(naive_min, 0) <= rmin <= rmax <= max(naive_max, 0))
+
+        with self.assertRaises(ValueError):
+            ONNXCalibrater(test_model_path, TestDataReader(), ['Conv'], [], [], './unused.onnx', calib_mode='kl')
+
 
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
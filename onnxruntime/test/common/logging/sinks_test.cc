@@ -3,6 +3,7 @@
 
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
@@ -10,6 +11,8 @@
 
 #include "test/common/logging/helpers.h"
 
+#include <thread>
+
 using namespace ::onnxruntime::logging;
 using InstanceType = LoggingManager::InstanceType;
 
@@ -144,3 +147,58 @@ TEST(LoggingTests, TestCompositeSink) {
 
   LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Warning";
 }
+
+/// <summary>
+/// Tests that the async_sink sends the messages of all threads to the wrapped sink, in order for each thread.
+/// </summary>
+TEST(LoggingTests, TestAsyncSink) {
+  const std::string logid{"TestAsyncSink"};
+  const Severity min_log_level = Severity::kVERBOSE;
+  constexpr int kNumThreads = 4;
+  constexpr int kNumMessages = 1000;
+
+  // records the messages, only the background thread of the async_sink calls it
+  class RecordingSink : public ISink {
+   public:
+    explicit RecordingSink(std::vector<std::string>& messages) : messages_{messages} {}
+
+   private:
+    void SendImpl(const Timestamp&, const std::string&, const Capture& message) override {
+      messages_.push_back(message.Message());
+    }
+
+    std::vector<std::string>& messages_;
+  };
+
+  std::vector<std::string> messages;
+  {
+    // use a small ring buffer so the logging threads have to wait for the background thread
+    LoggingManager manager{std::unique_ptr<ISink>{new AsyncSink{
+                               std::unique_ptr<ISink>{new RecordingSink{messages}}, 16}},
+                           min_log_level, false, InstanceType::Temporal};
+    auto logger = manager.CreateLogger(logid);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&logger, t]() {
+        for (int i = 0; i < kNumMessages; ++i) {
+          LOGS(*logger, VERBOSE) << t << " " << i;
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  ASSERT_EQ(messages.size(), static_cast<size_t>(kNumThreads * kNumMessages));
+  std::vector<int> next(kNumThreads, 0);
+  for (const auto& message : messages) {
+    std::istringstream stream{message};
+    int t, i;
+    stream >> t >> i;
+    ASSERT_TRUE(t >= 0 && t < kNumThreads) << message;
+    EXPECT_EQ(i, next[t]++) << message;
+  }
+}
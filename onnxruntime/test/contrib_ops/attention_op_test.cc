@@ -613,6 +613,82 @@ TEST(AttentionTest, AttentionPastStateBatch1) {
                    use_past_state, past_sequence_length, &past_data, &present_data);
 }
 
+// Same data as AttentionPastStateBatch1, with past and present sharing a buffer with a maximum sequence length of 5.
+TEST(AttentionTest, AttentionPastPresentShareBuffer) {
+  if (!HasCudaEnvironment(0)) {
+    return;
+  }
+
+  int batch_size = 1;
+  int sequence_length = 1;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+  int head_size = hidden_size / number_of_heads;
+  int max_sequence_length = 5;
+
+  std::vector<float> input_data = {
+      -0.019333266f, -0.21813886f, 0.16212955f, -0.015626367f};
+
+  std::vector<float> weight_data = {
+      -0.4738484025001526f, -0.2613658607006073f, -0.0978037416934967f, -0.34988933801651f,
+      0.2243240624666214f, -0.0429205559194088f, 0.418695330619812f, 0.17441125214099884f,
+      -0.18825532495975494f, 0.18357256054878235f, -0.5806483626365662f, -0.02251487597823143f,
+
+      0.08742205798625946f, 0.14734269678592682f, 0.2387014478445053f, 0.2884027063846588f,
+      0.6490834355354309f, 0.16965825855731964f, -0.06346885114908218f, 0.4073973298072815f,
+      -0.03070945478975773f, 0.4110257923603058f, 0.07896808534860611f, 0.16783113777637482f,
+
+      0.0038893644232302904f, 0.06946629285812378f, 0.36680519580841064f, -0.07261059433221817f,
+      -0.14960581064224243f, 0.020944256335496902f, -0.09378612786531448f, -0.1336742341518402f,
+      0.06061394885182381f, 0.2205914407968521f, -0.03519909828901291f, -0.18405692279338837f,
+
+      0.22149960696697235f, -0.1884360909461975f, -0.014074507169425488f, 0.4252440333366394f,
+      0.24987126886844635f, -0.31396418809890747f, 0.14036843180656433f, 0.2854192554950714f,
+      0.09709841012954712f, 0.09935075044631958f, -0.012154420837759972f, 0.2575816512107849f};
+
+  std::vector<float> bias_data = {
+      0.4803391396999359f, -0.5254325866699219f, -0.42926454544067383f, -0.2059524953365326f,
+      -0.12773379683494568f, -0.09542735666036606f, -0.35286077857017517f, -0.07646317780017853f,
+      -0.04590314254164696f, -0.03752850368618965f, -0.013764488510787487f, -0.18478283286094666f};
+
+  std::vector<float> output_data = {
+      0.20141591f, 0.43005896f, 0.35745093f, 0.19957167f};
+
+  // past_k and past_v of each head, with 3 of the 5 positions used
+  std::vector<float> past_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, 0.f, 0.f, 0.f, 0.f,
+      0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f, 0.f, 0.f, 0.f, 0.f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, 0.f, 0.f, 0.f, 0.f,
+      0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f, 0.f, 0.f, 0.f, 0.f};
+
+  // the new keys and values are written to the 4th position
+  std::vector<float> present_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, -0.30182117f, -0.12330482f, 0.f, 0.f,
+      0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f, -0.36450946f, -0.19483691f, 0.f, 0.f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, -0.027254611f, -0.096526355f, 0.f, 0.f,
+      0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f, -0.025281552f, -0.25482416f, 0.f, 0.f};
+
+  std::vector<int64_t> past_dims = {2, batch_size, number_of_heads, max_sequence_length, head_size};
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", 1);
+  tester.AddAttribute<int64_t>("past_present_share_buffer", 1);
+
+  tester.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input_data);
+  tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data);
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+  tester.AddMissingOptionalInput<int32_t>();
+  tester.AddInput<float>("past", past_dims, past_data);
+  tester.AddInput<int32_t>("past_sequence_length", {}, {3});
+  tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output_data);
+  tester.AddOutput<float>("present", past_dims, present_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(AttentionTest, AttentionPastStateBatch2) {
   int batch_size = 2;
   int sequence_length = 1;
@@ -1293,5 +1369,150 @@ TEST(AttentionTest, AttentionPastState_dynamic) {
   test.Run();
 }
 
+// Computes the Attention output without past state in double precision.
+static std::vector<float> ComputeAttentionReference(const std::vector<float>& input_data,
+                                                    const std::vector<float>& weight_data,
+                                                    const std::vector<float>& bias_data,
+                                                    const std::vector<int32_t>& mask_index_data,  // [batch_size]
+                                                    int batch_size, int sequence_length, int hidden_size,
+                                                    int number_of_heads, bool is_unidirectional) {
+  const int head_size = hidden_size / number_of_heads;
+  std::vector<double> qkv(static_cast<size_t>(batch_size) * sequence_length * 3 * hidden_size);
+  for (int t = 0; t < batch_size * sequence_length; t++) {
+    for (int j = 0; j < 3 * hidden_size; j++) {
+      double sum = bias_data[j];
+      for (int k = 0; k < hidden_size; k++) {
+        sum += static_cast<double>(input_data[t * hidden_size + k]) * weight_data[k * 3 * hidden_size + j];
+      }
+      qkv[t * 3 * hidden_size + j] = sum;
+    }
+  }
+
+  std::vector<float> output(static_cast<size_t>(batch_size) * sequence_length * hidden_size);
+  std::vector<double> probs(sequence_length);
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < number_of_heads; n++) {
+      for (int s = 0; s < sequence_length; s++) {
+        const double* q = &qkv[(b * sequence_length + s) * 3 * hidden_size + n * head_size];
+        double max = -std::numeric_limits<double>::infinity();
+        for (int m = 0; m < sequence_length; m++) {
+          const double* k = &qkv[(b * sequence_length + m) * 3 * hidden_size + hidden_size + n * head_size];
+          double score = 0.0;
+          for (int h = 0; h < head_size; h++) {
+            score += q[h] * k[h];
+          }
+          score /= std::sqrt(static_cast<double>(head_size));
+          if (!mask_index_data.empty() && m >= mask_index_data[b]) score -= 10000.0;
+          if (is_unidirectional && m > s) score -= 10000.0;
+          probs[m] = score;
+          max = std::max(max, score);
+        }
+
+        double sum = 0.0;
+        for (auto& p : probs) {
+          p = std::exp(p - max);
+          sum += p;
+        }
+
+        for (int h = 0; h < head_size; h++) {
+          double value = 0.0;
+          for (int m = 0; m < sequence_length; m++) {
+            value += probs[m] / sum * qkv[(b * sequence_length + m) * 3 * hidden_size + 2 * hidden_size + n * head_size + h];
+          }
+          output[(b * sequence_length + s) * hidden_size + n * head_size + h] = static_cast<float>(value);
+        }
+      }
+    }
+  }
+
+  return output;
+}
+
+// Sequences long enough for the CPU kernel to compute the attention over blocks of keys with an online softmax.
+static void RunLongSequenceAttentionTest(bool is_unidirectional) {
+  int batch_size = 2;
+  int sequence_length = 300;
+  int hidden_size = 16;
+  int number_of_heads = 2;
+
+  RandomValueGenerator random{};
+  std::vector<float> input_data = random.Gaussian<float>({batch_size, sequence_length, hidden_size}, 0.0f, 0.5f);
+  std::vector<float> weight_data = random.Gaussian<float>({hidden_size, 3 * hidden_size}, 0.0f, 0.5f);
+  std::vector<float> bias_data = random.Gaussian<float>({3 * hidden_size}, 0.0f, 0.5f);
+  std::vector<int32_t> mask_index_data = {300L, 170L};
+
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size,
+                                                             number_of_heads, is_unidirectional);
+
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional);
+}
+
+TEST(AttentionTest, AttentionLongSequence) {
+  RunLongSequenceAttentionTest(false);
+}
+
+TEST(AttentionTest, AttentionLongSequenceUnidirectional) {
+  RunLongSequenceAttentionTest(true);
+}
+
+// Attention over the packed tokens (1, total_tokens, hidden_size) of sequences with the lengths in mask_index, which
+// must match the attention over the padded sequences for the tokens that are not padding.
+static void RunPackedTokensAttentionTest(const std::vector<int32_t>& sequence_lengths, int hidden_size,
+                                         int number_of_heads, bool is_unidirectional) {
+  int batch_size = static_cast<int>(sequence_lengths.size());
+  int sequence_length = *std::max_element(sequence_lengths.begin(), sequence_lengths.end());
+
+  RandomValueGenerator random{};
+  std::vector<float> input_data = random.Gaussian<float>({batch_size, sequence_length, hidden_size}, 0.0f, 0.5f);
+  std::vector<float> weight_data = random.Gaussian<float>({hidden_size, 3 * hidden_size}, 0.0f, 0.5f);
+  std::vector<float> bias_data = random.Gaussian<float>({3 * hidden_size}, 0.0f, 0.5f);
+
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, sequence_lengths,
+                                                             batch_size, sequence_length, hidden_size,
+                                                             number_of_heads, is_unidirectional);
+
+  std::vector<float> packed_input_data;
+  std::vector<float> packed_output_data;
+  for (int b = 0; b < batch_size; b++) {
+    const auto begin = static_cast<ptrdiff_t>(b) * sequence_length * hidden_size;
+    const auto end = begin + static_cast<ptrdiff_t>(sequence_lengths[b]) * hidden_size;
+    packed_input_data.insert(packed_input_data.end(), input_data.begin() + begin, input_data.begin() + end);
+    packed_output_data.insert(packed_output_data.end(), output_data.begin() + begin, output_data.begin() + end);
+  }
+  const int64_t total_tokens = static_cast<int64_t>(packed_input_data.size()) / hidden_size;
+
+  for (bool use_cuda : {false, true}) {
+    if (use_cuda ? !HasCudaEnvironment(0) : nullptr == DefaultCpuExecutionProvider().get()) {
+      continue;
+    }
+
+    OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+    tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(is_unidirectional ? 1 : 0));
+    tester.AddAttribute<int64_t>("packed_tokens", 1);
+    tester.AddInput<float>("input", {1, total_tokens, hidden_size}, packed_input_data);
+    tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data);
+    tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+    tester.AddInput<int32_t>("mask_index", {batch_size}, sequence_lengths);
+    tester.AddOutput<float>("output", {1, total_tokens, hidden_size}, packed_output_data);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(use_cuda ? DefaultCudaExecutionProvider() : DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
+TEST(AttentionTest, AttentionPackedTokens) {
+  RunPackedTokensAttentionTest({7, 3, 5}, 8, 2, false);
+  RunPackedTokensAttentionTest({4, 0, 9, 1}, 16, 4, false);
+  RunPackedTokensAttentionTest({6, 2}, 8, 2, true);
+}
+
+TEST(AttentionTest, AttentionPackedTokensLongSequence) {
+  RunPackedTokensAttentionTest({300, 120}, 16, 2, false);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
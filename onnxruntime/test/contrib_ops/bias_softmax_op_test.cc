@@ -128,28 +128,38 @@ class BiasSoftmaxTester {
   }
 
   void RunComparison() {
-    // BiasSoftmax only implemented for cuda architecture
+    // the CPU kernel only supports float
+    if (!use_float16_) {
+      std::vector<std::unique_ptr<IExecutionProvider>> ep;
+      ep.push_back(DefaultCpuExecutionProvider());
+      Run(ep);
+    }
+
     int min_cuda_architecture = use_float16_ ? 530 : 0;
     if (HasCudaEnvironment(min_cuda_architecture)) {
-      OpTester tester("BiasSoftmax", 1, onnxruntime::kMSDomain);
-      tester.AddAttribute<int64_t>("softmax_axis", softmax_axis_);
-      tester.AddAttribute<int64_t>("broadcast_axis", broadcast_axis_);
-
-      if (use_float16_) {
-        tester.AddInput<MLFloat16>("data", in_shape_, ToFloat16(in_data_));
-        tester.AddInput<MLFloat16>("bias", bias_shape_, ToFloat16(bias_data_));
-        tester.AddOutput<MLFloat16>("output", out_shape_, ToFloat16(out_data_));
-      } else {
-        tester.AddInput<float>("data", in_shape_, in_data_);
-        tester.AddInput<float>("bias", bias_shape_, bias_data_);
-        tester.AddOutput<float>("output", out_shape_, out_data_);
-      }
-
       std::vector<std::unique_ptr<IExecutionProvider>> ep;
       ep.push_back(DefaultCudaExecutionProvider());
-      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &ep);
+      Run(ep);
     }
   }
+
+  void Run(std::vector<std::unique_ptr<IExecutionProvider>>& ep) {
+    OpTester tester("BiasSoftmax", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("softmax_axis", softmax_axis_);
+    tester.AddAttribute<int64_t>("broadcast_axis", broadcast_axis_);
+
+    if (use_float16_) {
+      tester.AddInput<MLFloat16>("data", in_shape_, ToFloat16(in_data_));
+      tester.AddInput<MLFloat16>("bias", bias_shape_, ToFloat16(bias_data_));
+      tester.AddOutput<MLFloat16>("output", out_shape_, ToFloat16(out_data_));
+    } else {
+      tester.AddInput<float>("data", in_shape_, in_data_);
+      tester.AddInput<float>("bias", bias_shape_, bias_data_);
+      tester.AddOutput<float>("output", out_shape_, out_data_);
+    }
+
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &ep);
+  }
 };
 
 // broadcast is along dimensions [broadcast_axis, softmax_axis)
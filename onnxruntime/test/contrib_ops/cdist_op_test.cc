@@ -69,5 +69,54 @@ TEST(CDistOpTest, DoubleEuclidean) {
   test.Run();
 }
 
+TEST(CDistOpTest, Cosine) {
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", "cosine");
+
+  test.AddInput<float>("A", {2, 2},
+                       {1.0f, 0.0f,
+                        3.0f, 4.0f});
+  test.AddInput<float>("B", {3, 2},
+                       {0.0f, 2.0f,
+                        -1.0f, 0.0f,
+                        6.0f, 8.0f});
+
+  test.AddOutput<float>("y", {2, 3},
+                        {1.0f, 2.0f, 0.4f,
+                         0.2f, 1.6f, 0.0f});
+  test.Run();
+}
+
+// the output is computed in tiles, so use shapes that don't divide evenly into them
+TEST(CDistOpTest, MultipleTiles) {
+  constexpr int64_t m = 70, n = 300, k = 3;
+  std::vector<float> A(m * k), B(n * k);
+  for (int64_t i = 0; i < m * k; ++i) {
+    A[i] = static_cast<float>((i * 7) % 11) - 5.0f;
+  }
+  for (int64_t i = 0; i < n * k; ++i) {
+    B[i] = static_cast<float>((i * 5) % 13) - 6.0f;
+  }
+
+  std::vector<float> expected(m * n);
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t j = 0; j < n; ++j) {
+      float sum = 0.0f;
+      for (int64_t l = 0; l < k; ++l) {
+        const float diff = A[i * k + l] - B[j * k + l];
+        sum += diff * diff;
+      }
+      expected[i * n + j] = sum;
+    }
+  }
+
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", "sqeuclidean");
+  test.AddInput<float>("A", {m, k}, A);
+  test.AddInput<float>("B", {n, k}, B);
+  test.AddOutput<float>("y", {m, n}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
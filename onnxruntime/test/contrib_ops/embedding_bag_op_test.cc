@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// 5 embeddings of dimension 2
+static const std::vector<float> kWeight = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f};
+
+TEST(EmbeddingBagContribOpTest, SumWithOffsets) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddInput<float>("weight", {5, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {5}, {0, 2, 4, 1, -1});
+  test.AddInput<int64_t>("offsets", {3}, {0, 2, 2});
+  // the second bag is empty, and -1 is the last embedding
+  test.AddOutput<float>("output", {3, 2}, {4.f, 6.f, 0.f, 0.f, 18.f, 21.f});
+  test.Run();
+}
+
+TEST(EmbeddingBagContribOpTest, Mean2DIndices) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("weight", {5, 2}, kWeight);
+  test.AddInput<int32_t>("indices", {2, 2}, {0, 4, 1, 3});
+  test.AddOutput<float>("output", {2, 2}, {4.f, 5.f, 4.f, 5.f});
+  test.Run();
+}
+
+TEST(EmbeddingBagContribOpTest, Max) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddAttribute<std::string>("mode", "max");
+  test.AddInput<float>("weight", {5, 2}, {0.f, 9.f, 2.f, 3.f, 4.f, -5.f, 6.f, 7.f, -8.f, 1.f});
+  test.AddInput<int64_t>("indices", {4}, {0, 1, 2, 4});
+  test.AddInput<int64_t>("offsets", {2}, {0, 3});
+  test.AddOutput<float>("output", {2, 2}, {4.f, 9.f, -8.f, 1.f});
+  test.Run();
+}
+
+TEST(EmbeddingBagContribOpTest, PerSampleWeights) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddInput<float>("weight", {5, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {2, 2}, {1, 2, 3, 3});
+  test.AddMissingOptionalInput<int64_t>();
+  test.AddInput<float>("per_sample_weights", {2, 2}, {1.f, 0.5f, 2.f, -1.f});
+  test.AddOutput<float>("output", {2, 2}, {4.f, 5.5f, 6.f, 7.f});
+  test.Run();
+}
+
+// only the CUDA kernel supports float16
+TEST(EmbeddingBagContribOpTest, Float16) {
+  if (!HasCudaEnvironment(0)) {
+    return;
+  }
+
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddInput<MLFloat16>("weight", {5, 2}, ToFloat16(kWeight));
+  test.AddInput<int64_t>("indices", {4}, {0, 1, 2, 3});
+  test.AddInput<int64_t>("offsets", {2}, {0, 1});
+  test.AddOutput<MLFloat16>("output", {2, 2}, ToFloat16({0.f, 1.f, 12.f, 15.f}));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(EmbeddingBagContribOpTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddInput<float>("weight", {5, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {2, 1}, {0, 5});
+  test.AddOutput<float>("output", {2, 2}, {0.f, 1.f, 0.f, 0.f});
+  // the CUDA kernel skips out-of-range indices
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds", {kCudaExecutionProvider});
+}
+
+TEST(EmbeddingBagContribOpTest, DecreasingOffsets) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddInput<float>("weight", {5, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {3}, {0, 1, 2});
+  test.AddInput<int64_t>("offsets", {3}, {0, 2, 1});
+  test.AddOutput<float>("output", {3, 2}, {0.f, 0.f, 0.f, 0.f, 0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "offsets must be non-decreasing", {kCudaExecutionProvider});
+}
+
+TEST(EmbeddingBagContribOpTest, WeightsRequireSumMode) {
+  OpTester test("EmbeddingBag", 1, kMSDomain);
+  test.AddAttribute<std::string>("mode", "max");
+  test.AddInput<float>("weight", {5, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 1});
+  test.AddMissingOptionalInput<int64_t>();
+  test.AddInput<float>("per_sample_weights", {1, 2}, {1.f, 1.f});
+  test.AddOutput<float>("output", {1, 2}, {0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "per_sample_weights are only supported by the sum mode");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
@@ -298,6 +301,40 @@ TEST(EmbedLayerNormTest, EmbedLayerNormBatch2) {
           hidden_size);
 }
 
+// The same inputs as EmbedLayerNormBatch2, with the padding token of the last sequence dropped from the output.
+TEST(EmbedLayerNormTest, EmbedLayerNormBatch2_PackedTokens) {
+  OpTester tester("EmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute("epsilon", epsilon_);
+  tester.AddAttribute<int64_t>("packed_tokens", 1);
+  tester.AddInput<int32_t>("input_ids", {3, 2}, {1, 3, 1, 3, 2, 0});
+  tester.AddInput<int32_t>("segment_ids", {3, 2}, {0, 1, 0, 1, 0, 0});
+  tester.AddInput<float>("word_embedding", {6, 4},
+                         {0.2f, 0.1f, 0.4f, -0.6f,
+                          0.3f, 0.2f, 0.5f, 0.6f,
+                          0.6f, 0.7f, 0.0f, -0.1f,
+                          0.8f, 0.6f, 0.9f, 1.2f,
+                          0.1f, 0.3f, 0.5f, 0.9f,
+                          1.0f, -2.0f, 1.1f, 0.8f});
+  tester.AddInput<float>("position_embedding", {3, 4},
+                         {0.1f, 0.1f, 0.4f, 0.6f,
+                          0.6f, 0.0f, 0.8f, 0.6f,
+                          0.3f, 0.9f, -2.0f, 0.8f});
+  tester.AddInput<float>("segment_embedding", {2, 4},
+                         {0.3f, 0.4f, 0.9f, 0.1f,
+                          0.7f, 0.3f, 0.5f, 0.2f});
+  tester.AddInput<float>("gamma", {4}, {0.25f, 0.15f, 0.45f, -0.66f});
+  tester.AddInput<float>("beta", {4}, {0.6f, 0.2f, 0.5f, -0.6f});
+  tester.AddInput<int32_t>("mask", {3, 2}, {1, 1, 1, 1, 1, 0});
+  tester.AddOutput<float>("output", {1, 5, 4},
+                          {0.36917170882225037f, 0.061503000557422638f, 1.1598974466323853f, -0.85092413425445557f,
+                           0.74301940202713013f, -0.057434864342212677f, 0.84324657917022705f, -0.85171419382095337f,
+                           0.36917170882225037f, 0.061503000557422638f, 1.1598974466323853f, -0.85092413425445557f,
+                           0.74301940202713013f, -0.057434864342212677f, 0.84324657917022705f, -0.85171419382095337f,
+                           0.57668739557266235f, 0.2979130744934082f, 0.96158987283706665f, 0.44627034664154053f});
+  tester.AddOutput<int32_t>("mask_index", {3}, {2, 2, 1});
+  tester.Run();
+}
+
 TEST(EmbedLayerNormTest, EmbedLayerNormBatch2_NoMask) {
   int batch_size = 3;
   int sequence_length = 2;
@@ -514,5 +551,109 @@ TEST(EmbedLayerNormTest, EmbedLayerNormBatch_Distill) {
           true,
           false);
 }
+
+namespace {
+
+// quantizes data per tensor to uint8 within its range, returning the dequantized values in dequantized_data
+std::vector<uint8_t> QuantizeUInt8(const std::vector<float>& data, float& scale, uint8_t& zero_point,
+                                   std::vector<float>& dequantized_data) {
+  const float min = std::min(0.0f, *std::min_element(data.begin(), data.end()));
+  const float max = std::max(0.0f, *std::max_element(data.begin(), data.end()));
+  scale = (max - min) / 255.0f;
+  zero_point = static_cast<uint8_t>(std::round(-min / scale));
+  std::vector<uint8_t> quantized_data(data.size());
+  dequantized_data.resize(data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    const float q = std::round(data[i] / scale) + zero_point;
+    quantized_data[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, q)));
+    dequantized_data[i] = scale * (static_cast<int>(quantized_data[i]) - zero_point);
+  }
+  return quantized_data;
+}
+
+}  // namespace
+
+TEST(EmbedLayerNormTest, QEmbedLayerNormBatch2) {
+  if (!HasCudaEnvironment(0)) {
+    return;
+  }
+
+  const int batch_size = 2;
+  const int sequence_length = 3;
+  const int hidden_size = 8;
+  const int vocab_size = 5;
+
+  RandomValueGenerator random{};
+  std::vector<int32_t> input_ids_data = {1, 3, 4, 0, 2, 1};
+  std::vector<int32_t> segment_ids_data = {0, 0, 1, 0, 1, 1};
+  std::vector<int32_t> mask_data = {1, 1, 1, 1, 1, 0};
+  std::vector<float> word_embedding_data = random.Uniform<float>({vocab_size, hidden_size}, -1.0f, 1.0f);
+  std::vector<float> position_embedding_data = random.Uniform<float>({sequence_length, hidden_size}, -1.0f, 1.0f);
+  std::vector<float> segment_embedding_data = random.Uniform<float>({2, hidden_size}, -1.0f, 1.0f);
+  std::vector<float> gamma_data = random.Uniform<float>({hidden_size}, 0.5f, 1.5f);
+  std::vector<float> beta_data = random.Uniform<float>({hidden_size}, -0.5f, 0.5f);
+
+  float word_scale, position_scale, segment_scale, gamma_scale, beta_scale;
+  uint8_t word_zero_point, position_zero_point, segment_zero_point, gamma_zero_point, beta_zero_point;
+  std::vector<float> word, position, segment, gamma, beta;
+  auto word_quant = QuantizeUInt8(word_embedding_data, word_scale, word_zero_point, word);
+  auto position_quant = QuantizeUInt8(position_embedding_data, position_scale, position_zero_point, position);
+  auto segment_quant = QuantizeUInt8(segment_embedding_data, segment_scale, segment_zero_point, segment);
+  auto gamma_quant = QuantizeUInt8(gamma_data, gamma_scale, gamma_zero_point, gamma);
+  auto beta_quant = QuantizeUInt8(beta_data, beta_scale, beta_zero_point, beta);
+
+  // EmbedLayerNormalization of the dequantized tensors
+  std::vector<float> output_data(batch_size * sequence_length * hidden_size);
+  for (int b = 0; b < batch_size; b++) {
+    for (int s = 0; s < sequence_length; s++) {
+      const int token = b * sequence_length + s;
+      float* output = output_data.data() + token * hidden_size;
+      float mean = 0.0f;
+      for (int h = 0; h < hidden_size; h++) {
+        output[h] = word[input_ids_data[token] * hidden_size + h] + position[s * hidden_size + h] +
+                    segment[segment_ids_data[token] * hidden_size + h];
+        mean += output[h];
+      }
+      mean /= hidden_size;
+      float variance = 0.0f;
+      for (int h = 0; h < hidden_size; h++) {
+        variance += (output[h] - mean) * (output[h] - mean);
+      }
+      variance /= hidden_size;
+      for (int h = 0; h < hidden_size; h++) {
+        output[h] = (output[h] - mean) / std::sqrt(variance + epsilon_) * gamma[h] + beta[h];
+      }
+    }
+  }
+
+  OpTester tester("QEmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute("epsilon", epsilon_);
+  tester.AddInput<int32_t>("input_ids", {batch_size, sequence_length}, input_ids_data);
+  tester.AddInput<int32_t>("segment_ids", {batch_size, sequence_length}, segment_ids_data);
+  tester.AddInput<uint8_t>("word_embedding_quant", {vocab_size, hidden_size}, word_quant, true);
+  tester.AddInput<uint8_t>("position_embedding_quant", {sequence_length, hidden_size}, position_quant, true);
+  tester.AddInput<uint8_t>("segment_embedding_quant", {2, hidden_size}, segment_quant, true);
+  tester.AddInput<uint8_t>("gamma_quant", {hidden_size}, gamma_quant, true);
+  tester.AddInput<uint8_t>("beta_quant", {hidden_size}, beta_quant, true);
+  tester.AddInput<int32_t>("mask", {batch_size, sequence_length}, mask_data);
+  tester.AddInput<float>("word_embedding_scale", {}, {word_scale}, true);
+  tester.AddInput<float>("position_embedding_scale", {}, {position_scale}, true);
+  tester.AddInput<float>("segment_embedding_scale", {}, {segment_scale}, true);
+  tester.AddInput<float>("gamma_scale", {}, {gamma_scale}, true);
+  tester.AddInput<float>("beta_scale", {}, {beta_scale}, true);
+  tester.AddInput<uint8_t>("word_embedding_zero_point", {}, {word_zero_point}, true);
+  tester.AddInput<uint8_t>("position_embedding_zero_point", {}, {position_zero_point}, true);
+  tester.AddInput<uint8_t>("segment_embedding_zero_point", {}, {segment_zero_point}, true);
+  tester.AddInput<uint8_t>("gamma_zero_point", {}, {gamma_zero_point}, true);
+  tester.AddInput<uint8_t>("beta_zero_point", {}, {beta_zero_point}, true);
+  tester.AddOutput<float>("layernorm_out", {batch_size, sequence_length, hidden_size}, output_data);
+  tester.AddOutput<int32_t>("mask_index_out", {batch_size}, {3, 2});
+  tester.SetOutputAbsErr("layernorm_out", 1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
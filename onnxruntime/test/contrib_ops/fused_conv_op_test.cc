@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Y = Relu(Conv(X, W) + B + Z) of a kernel_size x kernel_size convolution with a padding of kernel_size / 2, so the
+// output has the shape of the input. The optional bias B is left out if use_bias is false.
+void RunFusedConvSumTest(int64_t C, int64_t M, int64_t group, int64_t H, int64_t W, int64_t kernel_size,
+                         bool use_bias, int thread_pool_size = 0) {
+  const int64_t N = 2;
+  const int64_t input_channels = C / group;
+  const int64_t pad = kernel_size / 2;
+
+  RandomValueGenerator random_value_generator{};
+  auto x = random_value_generator.Uniform<float>({N, C, H, W}, -1.0f, 1.0f);
+  auto w = random_value_generator.Uniform<float>({M, input_channels, kernel_size, kernel_size}, -0.5f, 0.5f);
+  auto b = random_value_generator.Uniform<float>({M}, -1.0f, 1.0f);
+  auto z = random_value_generator.Uniform<float>({N, M, H, W}, -1.0f, 1.0f);
+
+  std::vector<float> y(N * M * H * W);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t m = 0; m < M; ++m) {
+      const int64_t g = m / (M / group);
+      for (int64_t oh = 0; oh < H; ++oh) {
+        for (int64_t ow = 0; ow < W; ++ow) {
+          const int64_t y_index = ((n * M + m) * H + oh) * W + ow;
+          double sum = (use_bias ? b[m] : 0.0f) + z[y_index];
+          for (int64_t ic = 0; ic < input_channels; ++ic) {
+            const int64_t c = g * input_channels + ic;
+            for (int64_t kh = 0; kh < kernel_size; ++kh) {
+              for (int64_t kw = 0; kw < kernel_size; ++kw) {
+                const int64_t ih = oh + kh - pad, iw = ow + kw - pad;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += static_cast<double>(x[((n * C + c) * H + ih) * W + iw]) *
+                         w[((m * input_channels + ic) * kernel_size + kh) * kernel_size + kw];
+                }
+              }
+            }
+          }
+          y[y_index] = std::max(static_cast<float>(sum), 0.0f);
+        }
+      }
+    }
+  }
+
+  OpTester test("FusedConv", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{kernel_size, kernel_size});
+  test.AddAttribute("pads", std::vector<int64_t>{pad, pad, pad, pad});
+  test.AddAttribute("group", group);
+  test.AddAttribute("activation", "Relu");
+  test.AddInput<float>("X", {N, C, H, W}, x);
+  test.AddInput<float>("W", {M, input_channels, kernel_size, kernel_size}, w, true);
+  if (use_bias) {
+    test.AddInput<float>("B", {M}, b, true);
+  } else {
+    test.AddMissingOptionalInput<float>();
+  }
+  test.AddInput<float>("Z", {N, M, H, W}, z);
+  test.AddOutput<float>("Y", {N, M, H, W}, y);
+  test.SetOutputAbsErr("Y", 1e-4f);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = thread_pool_size;
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+// the sum is accumulated by the GEMM of the convolution, before the activation
+TEST(FusedConvOpTest, Sum) {
+  RunFusedConvSumTest(16, 24, 1, 9, 11, 3, true);
+  RunFusedConvSumTest(16, 24, 1, 9, 11, 1, false);
+  RunFusedConvSumTest(16, 32, 2, 7, 7, 3, true);
+}
+
+// the convolutions the Winograd and depthwise kernels would compute without a sum
+TEST(FusedConvOpTest, SumSpecializedConvolutions) {
+  RunFusedConvSumTest(32, 24, 1, 13, 15, 3, true, 1);
+  RunFusedConvSumTest(32, 32, 32, 13, 15, 3, true, 1);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// (s - x) / y -> Abs -> Sqrt, with the chain value as the second operand of Sub and the first one of Div
+TEST(FusedElementwiseTest, ChainWithSingleValue) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Div", "Abs", "Sqrt"});
+  test.AddAttribute("chain_input_indices", std::vector<int64_t>{0, 0, 0, 0});
+
+  std::vector<float> x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> y = {1.0f, 2.0f, 4.0f, 0.5f, 1.0f, 2.0f};
+  const float s = 2.0f;
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    expected[i] = std::sqrt(std::abs((x[i] - s) / y[i]));
+  }
+
+  test.AddInput<float>("x", {2, 3}, x);
+  test.AddInput<float>("s", {1}, {s});
+  test.AddInput<float>("y", {2, 3}, y);
+  test.AddOutput<float>("Y", {2, 3}, expected);
+  test.Run();
+}
+
+// Sigmoid(y * (x + s)) - x with an output that spans several tiles
+TEST(FusedElementwiseTest, LargeChain) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Sigmoid", "Sub"});
+  test.AddAttribute("chain_input_indices", std::vector<int64_t>{0, 1, 0, 0});
+
+  const int64_t rows = 3;
+  const int64_t cols = 3001;
+  std::vector<float> x(rows * cols);
+  std::vector<float> y(rows * cols);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(i % 17) * 0.25f - 2.0f;
+    y[i] = static_cast<float>(i % 5) * 0.5f - 1.0f;
+  }
+  const float s = 0.5f;
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    expected[i] = 1.0f / (1.0f + std::exp(-(y[i] * (x[i] + s)))) - x[i];
+  }
+
+  test.AddInput<float>("x", {rows, cols}, x);
+  test.AddInput<float>("s", {}, {s});
+  test.AddInput<float>("y", {1, rows, cols}, y);
+  test.AddInput<float>("x2", {rows, cols}, x);
+  test.AddOutput<float>("Y", {1, rows, cols}, expected);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, InvalidShapes) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu"});
+  test.AddAttribute("chain_input_indices", std::vector<int64_t>{0, 0});
+  test.AddInput<float>("x", {2, 3}, std::vector<float>(6, 1.0f));
+  test.AddInput<float>("y", {3}, std::vector<float>(3, 1.0f));
+  test.AddOutput<float>("Y", {2, 3}, std::vector<float>(6, 2.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "must have the same shape");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+float ApplyActivation(const std::string& activation, float x) {
+  if (activation == "Relu") {
+    return std::max(x, 0.0f);
+  }
+  // FastGelu
+  return x * (0.5f + 0.5f * std::tanh(x * (0.035677408136300125f * x * x + 0.7978845608028654f)));
+}
+
+// Y = activation(A(M,K) x B(K,N) + C), with the C of <c_dims> broadcast to (M,N).
+void RunFusedGemmTest(const std::string& activation, int64_t M, int64_t K, int64_t N,
+                      const std::vector<int64_t>& c_dims, bool use_float16 = false) {
+  if (!HasCudaEnvironment(use_float16 ? 530 : 0)) {
+    return;
+  }
+
+  RandomValueGenerator random_value_generator{};
+  auto a = random_value_generator.Uniform<float>({M, K}, -1.0f, 1.0f);
+  auto b = random_value_generator.Uniform<float>({K, N}, -1.0f, 1.0f);
+  auto c = random_value_generator.Uniform<float>(c_dims, -1.0f, 1.0f);
+  if (use_float16) {
+    // the expected values are computed from the inputs the kernel sees
+    for (auto* values : {&a, &b, &c}) {
+      for (auto& value : *values) {
+        value = MLFloat16(math::floatToHalf(value)).ToFloat();
+      }
+    }
+  }
+  const bool c_is_row = TensorShape(c_dims).Size() == N;
+
+  std::vector<float> y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = c_is_row ? c[n] : c[m * N + n];
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a[m * K + k] * b[k * N + n];
+      }
+      y[m * N + n] = ApplyActivation(activation, sum);
+    }
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", activation);
+  if (use_float16) {
+    test.AddInput<MLFloat16>("A", {M, K}, ToFloat16(a));
+    test.AddInput<MLFloat16>("B", {K, N}, ToFloat16(b), true);
+    test.AddInput<MLFloat16>("C", c_dims, ToFloat16(c), true);
+    test.AddOutput<MLFloat16>("Y", {M, N}, ToFloat16(y));
+  } else {
+    test.AddInput<float>("A", {M, K}, a);
+    test.AddInput<float>("B", {K, N}, b, true);
+    test.AddInput<float>("C", c_dims, c, true);
+    test.AddOutput<float>("Y", {M, N}, y);
+  }
+  test.SetOutputAbsErr("Y", use_float16 ? 2e-2f : 1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Y = activation(A(M,K) x B(K,N) + C(N)) on the CPU, where MLAS applies the activation while computing the output.
+void RunFusedGemmCpuTest(const std::string& activation, float alpha, float beta, int64_t M, int64_t K, int64_t N) {
+  RandomValueGenerator random_value_generator{};
+  auto a = random_value_generator.Uniform<float>({M, K}, -1.0f, 1.0f);
+  auto b = random_value_generator.Uniform<float>({K, N}, -1.0f, 1.0f);
+  auto c = random_value_generator.Uniform<float>({N}, -1.0f, 1.0f);
+
+  std::vector<float> y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = c[n];
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a[m * K + k] * b[k * N + n];
+      }
+      y[m * N + n] = activation == "HardSigmoid" ? std::min(std::max(alpha * sum + beta, 0.0f), 1.0f)
+                                                 : (sum >= 0.0f ? sum : alpha * sum);
+    }
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", activation);
+  test.AddAttribute("activation_alpha", alpha);
+  if (activation == "HardSigmoid") {
+    test.AddAttribute("activation_beta", beta);
+  }
+  test.AddInput<float>("A", {M, K}, a);
+  test.AddInput<float>("B", {K, N}, b, true);
+  test.AddInput<float>("C", {N}, c, true);
+  test.AddOutput<float>("Y", {M, N}, y);
+  test.SetOutputAbsErr("Y", 1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+TEST(FusedGemmOpTest, CpuMlasActivation) {
+  RunFusedGemmCpuTest("LeakyRelu", 0.1f, 0.0f, 37, 64, 48);
+  RunFusedGemmCpuTest("HardSigmoid", 0.2f, 0.5f, 37, 64, 48);
+  RunFusedGemmCpuTest("HardSigmoid", 0.5f, 0.25f, 1, 300, 70);
+}
+
+// the bias of one value per column is added by the epilogue of the matmul
+TEST(FusedGemmOpTest, RowBias) {
+  RunFusedGemmTest("Relu", 37, 64, 48, {48});
+  RunFusedGemmTest("Relu", 16, 33, 40, {1, 40});
+  RunFusedGemmTest("FastGelu", 37, 64, 48, {48});
+  RunFusedGemmTest("Relu", 37, 64, 48, {48}, true);
+  RunFusedGemmTest("FastGelu", 64, 128, 32, {32}, true);
+}
+
+// the bias is broadcast to the output before the matmul, and the activation runs on the result
+TEST(FusedGemmOpTest, FullBias) {
+  RunFusedGemmTest("Relu", 8, 16, 24, {8, 24});
+  RunFusedGemmTest("FastGelu", 8, 16, 24, {8, 24});
+  RunFusedGemmTest("FastGelu", 8, 16, 24, {8, 24}, true);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -43,5 +43,22 @@ TEST(LayerNormTest, BERTLayerNorm) {
   tester.Run();
 }
 
+TEST(LayerNormTest, LayerNorm_HiddenSizeNotMultipleOfVectorWidth) {
+  OpTester test("LayerNormalization", 1 /*opset_version*/);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", 1e-5f);
+
+  std::vector<int64_t> dims{2, 11};
+  test.AddInput<float>("X", dims, {0.8f, -0.5f, 0.0f, 1.0f, 0.5f, 0.2f, 0.3f, -0.6f, 0.9f, -1.1f, 0.4f,
+                                   1.5f, 2.0f, 3.0f, -4.0f, 0.25f, -0.75f, 1.25f, 2.5f, -2.0f, 0.5f, 1.0f});
+  test.AddInput<float>("Scale", {11}, {1.0f, 0.5f, -0.5f, 2.0f, 1.5f, 1.0f, 0.25f, 0.75f, -1.0f, 1.0f, 0.5f});
+  test.AddInput<float>("B", {11}, {0.1f, 0.0f, -0.1f, 0.2f, 0.0f, 0.3f, -0.2f, 0.0f, 0.1f, 0.0f, -0.3f});
+  test.AddOutput<float>("Y", dims, {1.082699f, -0.526954f, 0.035299f, 2.792045f, 0.769068f, 0.342726f,
+                                    -0.150153f, -0.907928f, -1.039361f, -1.993881f, -0.121975f,
+                                    0.620727f, 0.387652f, -0.742230f, -4.359251f, -0.173576f, -0.324872f,
+                                    -0.101641f, 0.772411f, 1.361316f, 0.011572f, -0.166925f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
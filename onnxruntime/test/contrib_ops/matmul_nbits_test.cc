@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/mlas/inc/mlas.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+int32_t GetPacked(int64_t bits, const uint8_t* data, int64_t i) {
+  return bits == 4 ? (data[i / 2] >> (4 * (i & 1))) & 0x0F : data[i];
+}
+
+// Y = A(M,K) x B(K,N) + bias, with B quantized blockwise by MlasQuantizeBlockwise and the expected values computed
+// from the dequantized weights.
+void RunMatMulNBitsTest(const std::vector<int64_t>& a_batch_dims, int64_t M, int64_t N, int64_t K, int64_t bits,
+                        int64_t block_size, bool has_zero_points, bool has_bias) {
+  std::vector<int64_t> a_dims = a_batch_dims;
+  a_dims.push_back(M);
+  a_dims.push_back(K);
+  std::vector<int64_t> y_dims = a_batch_dims;
+  y_dims.push_back(M);
+  y_dims.push_back(N);
+  int64_t batch = 1;
+  for (int64_t dim : a_batch_dims) {
+    batch *= dim;
+  }
+
+  RandomValueGenerator random_value_generator{};
+  auto a = random_value_generator.Uniform<float>({batch * M, K}, -1.0f, 1.0f);
+  auto b = random_value_generator.Uniform<float>({K, N}, -1.0f, 1.0f);
+  auto bias = random_value_generator.Uniform<float>({N}, -1.0f, 1.0f);
+
+  size_t b_data_size;
+  size_t scales_size;
+  size_t zero_points_size;
+  MlasBlockwiseQuantizedBufferSizes(static_cast<size_t>(bits), static_cast<size_t>(block_size), static_cast<size_t>(N),
+                                    static_cast<size_t>(K), &b_data_size, &scales_size, &zero_points_size);
+  std::vector<uint8_t> b_data(b_data_size);
+  std::vector<float> scales(scales_size);
+  std::vector<uint8_t> zero_points(zero_points_size);
+  MlasQuantizeBlockwise(static_cast<size_t>(bits), static_cast<size_t>(block_size), b.data(), static_cast<size_t>(N),
+                        static_cast<size_t>(N), static_cast<size_t>(K), !has_zero_points, b_data.data(),
+                        scales.data(), has_zero_points ? zero_points.data() : nullptr);
+
+  const int64_t blocks_per_col = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t zero_points_per_col = (blocks_per_col * bits + 7) / 8;
+  std::vector<float> dequantized_b(K * N);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t k = 0; k < K; ++k) {
+      const int64_t block = n * blocks_per_col + k / block_size;
+      const int32_t q = GetPacked(bits, b_data.data() + block * blob_size, k % block_size);
+      const int32_t zero_point = has_zero_points
+                                     ? GetPacked(bits, zero_points.data() + n * zero_points_per_col, k / block_size)
+                                     : 1 << (bits - 1);
+      dequantized_b[k * N + n] = static_cast<float>(q - zero_point) * scales[block];
+    }
+  }
+
+  std::vector<float> y(batch * M * N);
+  for (int64_t m = 0; m < batch * M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = has_bias ? bias[n] : 0.0f;
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a[m * K + k] * dequantized_b[k * N + n];
+      }
+      y[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("K", K);
+  test.AddAttribute("N", N);
+  test.AddAttribute("bits", bits);
+  test.AddAttribute("block_size", block_size);
+  test.AddInput<float>("A", a_dims, a);
+  test.AddInput<uint8_t>("B", {N, blocks_per_col, blob_size}, b_data, true);
+  test.AddInput<float>("scales", {N * blocks_per_col}, scales, true);
+  if (has_zero_points) {
+    test.AddInput<uint8_t>("zero_points", {N * zero_points_per_col}, zero_points, true);
+  } else {
+    test.AddMissingOptionalInput<uint8_t>();
+  }
+  if (has_bias) {
+    test.AddInput<float>("bias", {N}, bias, true);
+  } else {
+    test.AddMissingOptionalInput<float>();
+  }
+  test.AddOutput<float>("Y", y_dims, y);
+  test.SetOutputAbsErr("Y", 1e-3f);
+  test.Run();
+}
+
+}  // namespace
+
+TEST(MatMulNBitsTest, Int4) {
+  for (bool has_zero_points : {false, true}) {
+    RunMatMulNBitsTest({}, 1, 64, 128, 4, 32, has_zero_points, false);
+    RunMatMulNBitsTest({}, 1, 37, 100, 4, 16, has_zero_points, true);
+    RunMatMulNBitsTest({}, 3, 48, 300, 4, 128, has_zero_points, false);
+    RunMatMulNBitsTest({2}, 20, 40, 96, 4, 32, has_zero_points, true);
+  }
+}
+
+TEST(MatMulNBitsTest, Int8) {
+  for (bool has_zero_points : {false, true}) {
+    RunMatMulNBitsTest({}, 1, 64, 128, 8, 32, has_zero_points, false);
+    RunMatMulNBitsTest({}, 5, 33, 70, 8, 64, has_zero_points, true);
+    RunMatMulNBitsTest({2, 3}, 17, 24, 256, 8, 256, has_zero_points, false);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
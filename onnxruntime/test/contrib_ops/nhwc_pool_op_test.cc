@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Pools the NHWC input X with explicit padding {top, left, bottom, right}. A kernel of {H, W} with no padding and
+// unit strides is global pooling.
+std::vector<float> NhwcPoolReference(const std::vector<float>& x, int64_t N, int64_t H, int64_t W, int64_t C,
+                                     const std::vector<int64_t>& kernel, const std::vector<int64_t>& pads,
+                                     const std::vector<int64_t>& strides, bool max_pool, bool count_include_pad,
+                                     int64_t OH, int64_t OW) {
+  std::vector<float> y(N * OH * OW * C);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t oh = 0; oh < OH; ++oh) {
+      for (int64_t ow = 0; ow < OW; ++ow) {
+        const int64_t h_start = oh * strides[0] - pads[0];
+        const int64_t w_start = ow * strides[1] - pads[1];
+        const int64_t h_end = std::min(h_start + kernel[0], H + pads[2]);
+        const int64_t w_end = std::min(w_start + kernel[1], W + pads[3]);
+        const int64_t window_size = (h_end - h_start) * (w_end - w_start);
+        for (int64_t c = 0; c < C; ++c) {
+          float value = max_pool ? std::numeric_limits<float>::lowest() : 0.0f;
+          int64_t count = 0;
+          for (int64_t h = std::max<int64_t>(h_start, 0); h < std::min(h_end, H); ++h) {
+            for (int64_t w = std::max<int64_t>(w_start, 0); w < std::min(w_end, W); ++w) {
+              const float input = x[((n * H + h) * W + w) * C + c];
+              value = max_pool ? std::max(value, input) : value + input;
+              ++count;
+            }
+          }
+          if (!max_pool) {
+            value /= static_cast<float>(count_include_pad ? window_size : count);
+          }
+          y[((n * OH + oh) * OW + ow) * C + c] = value;
+        }
+      }
+    }
+  }
+  return y;
+}
+
+void RunNhwcPoolTest(const char* op_type, int64_t N, int64_t H, int64_t W, int64_t C,
+                     const std::vector<int64_t>& kernel, const std::vector<int64_t>& pads,
+                     const std::vector<int64_t>& strides, bool count_include_pad = false) {
+  const bool global_pooling = kernel.empty();
+  const bool max_pool = std::string(op_type).find("Max") != std::string::npos;
+  const std::vector<int64_t> actual_kernel = global_pooling ? std::vector<int64_t>{H, W} : kernel;
+  const std::vector<int64_t> actual_pads = global_pooling ? std::vector<int64_t>{0, 0, 0, 0} : pads;
+  const std::vector<int64_t> actual_strides = global_pooling ? std::vector<int64_t>{1, 1} : strides;
+  const int64_t OH = (H + actual_pads[0] + actual_pads[2] - actual_kernel[0]) / actual_strides[0] + 1;
+  const int64_t OW = (W + actual_pads[1] + actual_pads[3] - actual_kernel[1]) / actual_strides[1] + 1;
+
+  RandomValueGenerator random_value_generator{};
+  auto x = random_value_generator.Uniform<float>({N, H, W, C}, -10.0f, 10.0f);
+  auto y = NhwcPoolReference(x, N, H, W, C, actual_kernel, actual_pads, actual_strides, max_pool, count_include_pad,
+                             OH, OW);
+
+  OpTester test(op_type, 1, onnxruntime::kMSDomain);
+  if (!global_pooling) {
+    test.AddAttribute("kernel_shape", kernel);
+    test.AddAttribute("pads", pads);
+    test.AddAttribute("strides", strides);
+    if (!max_pool) {
+      test.AddAttribute("count_include_pad", static_cast<int64_t>(count_include_pad));
+    }
+  }
+  test.AddInput<float>("X", {N, H, W, C}, x);
+  test.AddOutput<float>("Y", {N, OH, OW, C}, y);
+  test.SetOutputAbsErr("Y", 1e-4f);
+  test.Run();
+}
+
+}  // namespace
+
+TEST(NhwcPoolTest, MaxPool) {
+  RunNhwcPoolTest("NhwcMaxPool", 1, 8, 8, 16, {3, 3}, {1, 1, 1, 1}, {1, 1});
+  RunNhwcPoolTest("NhwcMaxPool", 2, 9, 7, 5, {2, 2}, {0, 0, 0, 0}, {2, 2});
+  RunNhwcPoolTest("NhwcMaxPool", 1, 13, 11, 37, {3, 5}, {1, 2, 1, 2}, {2, 1});
+}
+
+TEST(NhwcPoolTest, AveragePool) {
+  for (bool count_include_pad : {false, true}) {
+    RunNhwcPoolTest("NhwcAveragePool", 1, 8, 8, 16, {3, 3}, {1, 1, 1, 1}, {1, 1}, count_include_pad);
+    RunNhwcPoolTest("NhwcAveragePool", 2, 9, 7, 5, {2, 2}, {0, 0, 0, 0}, {2, 2}, count_include_pad);
+    RunNhwcPoolTest("NhwcAveragePool", 1, 13, 11, 37, {3, 5}, {1, 2, 1, 2}, {2, 1}, count_include_pad);
+  }
+}
+
+TEST(NhwcPoolTest, GlobalPool) {
+  for (const char* op_type : {"NhwcGlobalMaxPool", "NhwcGlobalAveragePool"}) {
+    RunNhwcPoolTest(op_type, 1, 7, 7, 3, {}, {}, {});
+    RunNhwcPoolTest(op_type, 2, 14, 14, 64, {}, {}, {});
+    RunNhwcPoolTest(op_type, 1, 56, 56, 37, {}, {}, {});
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
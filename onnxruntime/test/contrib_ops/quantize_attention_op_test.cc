@@ -85,7 +85,8 @@ void RunQAttention(const std::vector<float>& input_data,         // input:
                    int hidden_size,
                    int number_of_heads,
                    bool is_unidirectional = false,
-                   bool use_float16 = false) {
+                   bool use_float16 = false,
+                   bool is_weight_constant = false) {
   OpTester tester("QAttention", 1, onnxruntime::kMSDomain);
   tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
   if (is_unidirectional) {
@@ -104,10 +105,13 @@ void RunQAttention(const std::vector<float>& input_data,         // input:
   QWeight weight_zero_point = quantize_parameters.weight_zero_point;
   if (input_scale != 0.0f) {
     tester.AddInput<QInput>("input", input_dims, ToInteger<QInput>(input_data, input_scale, input_zero_point));
-    tester.AddInput<QWeight>("weight", weights_dims, ToInteger<QWeight>(weights_data, weight_scale, weight_zero_point));
+    tester.AddInput<QWeight>("weight", weights_dims, ToInteger<QWeight>(weights_data, weight_scale, weight_zero_point),
+                             is_weight_constant);
   } else {
     tester.AddInput<QInput>("input", input_dims, QuantizeLinear<QInput, ep == EP::CUDA>(input_data, input_scale, input_zero_point));
-    tester.AddInput<QWeight>("weight", weights_dims, QuantizeLinear<QWeight, ep == EP::CUDA>(weights_data, weight_scale, weight_zero_point));
+    tester.AddInput<QWeight>("weight", weights_dims,
+                             QuantizeLinear<QWeight, ep == EP::CUDA>(weights_data, weight_scale, weight_zero_point),
+                             is_weight_constant);
   }
   if (use_float16) {
     tester.AddInput<MLFloat16>("bias", bias_dims, ToFloat16(bias_data));
@@ -163,9 +167,13 @@ static void RunQAttentionCUDA(
       qp.input_scale = 0.1f;
       qp.weight_scale = 0.1f;
     }
-    RunQAttention<int8_t, int8_t, EP::CUDA>(
-        input_data, weights_data, bias_data, mask_index_data, output_data, qp,
-        batch_size, sequence_length, hidden_size, number_of_heads, is_unidirectional, use_float16);
+    // a constant weight is prepacked for the int8 tensor cores on the devices that have them
+    for (bool is_weight_constant : {false, true}) {
+      RunQAttention<int8_t, int8_t, EP::CUDA>(
+          input_data, weights_data, bias_data, mask_index_data, output_data, qp,
+          batch_size, sequence_length, hidden_size, number_of_heads, is_unidirectional, use_float16,
+          is_weight_constant);
+    }
   }
 }
 
@@ -48,6 +48,28 @@ TEST(ContribOpTest, WordConvEmbedding) {
   test.Run();
 }
 
+TEST(ContribOpTest, WordConvEmbedding_empty_word) {
+  OpTester test("WordConvEmbedding", 1, onnxruntime::kMSDomain);
+  // the 2nd word is empty, the others are the words of InitializeTestWithoutAttribute
+  test.AddInput<int>("Sequence", {3, 5}, {1, 2, 3, 4, 0,
+                                          0, 0, 0, 0, 0,
+                                          4, 3, 2, 1, 0});
+  test.AddInput<float>("W", {2, 1, 2, 3}, {0.1f, 0.2f, 0.3f,
+                                           0.2f, 0.3f, 0.1f,
+                                           0.3f, 0.1f, 0.2f,
+                                           1.0f, 1.1f, 1.2f});
+  test.AddInput<float>("B", {2}, {0.1f, 0.2f});
+  test.AddInput<float>("C", {5, 3}, {0.1f, 0.2f, 0.3f,
+                                     0.2f, 0.3f, 0.1f,
+                                     0.3f, 0.1f, 0.2f,
+                                     0.4f, 0.5f, 0.6f,
+                                     0.7f, 0.8f, 0.9f});
+  test.AddOutput<float>("Y", {3, 2}, {0.711393774f, 0.996334076f,
+                                      0.0f, 0.0f,
+                                      0.711393774f, 0.981612563f});
+  test.Run();
+}
+
 TEST(ContribOpTest, WordConvEmbedding_valid_attribute) {
   // Invalid input dimensions
   OpTester test("WordConvEmbedding", 1, onnxruntime::kMSDomain);
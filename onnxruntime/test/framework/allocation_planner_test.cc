@@ -131,15 +131,27 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool parallel_execution = false)
+      : shape_map_(shape_map), parallel_execution_(parallel_execution) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool IsParallelExecutionEnabled() const override { return parallel_execution_; }
+
  private:
   ShapeMap* shape_map_;
+  bool parallel_execution_;
+};
+
+// A CPU provider that claims to launch its work on per-thread streams, to check the fences of a parallel plan.
+class PerThreadStreamsExecutionProvider : public CPUExecutionProvider {
+ public:
+  explicit PerThreadStreamsExecutionProvider(const CPUExecutionProviderInfo& info) : CPUExecutionProvider(info) {}
+
+  bool UsesPerThreadStreams() const override { return true; }
 };
 
 class PlannerTest : public ::testing::Test {
@@ -156,6 +168,9 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> alias_kernel_;     // a unary kernel with its output aliasing its input
+  std::unique_ptr<::onnxruntime::KernelDef> concat_kernel_;
+  std::unique_ptr<::onnxruntime::KernelDef> split_kernel_;
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -178,8 +193,13 @@ class PlannerTest : public ::testing::Test {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     in_place_kernel_ =
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
+    alias_kernel_ =
+        KernelDefBuilder().SetName("Identity").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Alias(0, 0).Build();
+    concat_kernel_ = KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 10).Build();
+    split_kernel_ = KernelDefBuilder().SetName("Split").Provider(kCpuExecutionProvider).SinceVersion(2, 10).Build();
     CPUExecutionProviderInfo epi;
-    auto execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
+    // only affects plans for parallel execution
+    auto execution_provider = onnxruntime::make_unique<PerThreadStreamsExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
 
     state_.reset(new SessionState(graph_, execution_providers_, false, tp_.get(), nullptr, dtm_,
@@ -209,6 +229,32 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddAliasNode(std::string& input, std::string& output) {
+    return AddNode(*alias_kernel_, input, output);
+  }
+
+  // add a Concat or Split node operating on the given axis
+  onnxruntime::Node* AddAxisNode(::onnxruntime::KernelDef& kernel_def, const std::vector<std::string>& inputs,
+                                 const std::vector<std::string>& outputs, int64_t axis) {
+    std::vector<onnxruntime::NodeArg*> input_args, output_args;
+    for (auto& input : inputs) input_args.push_back(Arg(input));
+    for (auto& output : outputs) output_args.push_back(Arg(output));
+    auto* p_node = &graph_.AddNode("node" + std::to_string(NodeCounter::Next()), kernel_def.OpName(), "test op",
+                                   input_args, output_args);
+    p_node->AddAttribute("axis", axis);
+    p_node->SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+    kernel_bindings_.emplace_back(p_node, kernel_def);
+    return p_node;
+  }
+
+  onnxruntime::Node* AddConcatNode(const std::vector<std::string>& inputs, std::string& output, int64_t axis) {
+    return AddAxisNode(*concat_kernel_, inputs, {output}, axis);
+  }
+
+  onnxruntime::Node* AddSplitNode(std::string& input, const std::vector<std::string>& outputs, int64_t axis) {
+    return AddAxisNode(*split_kernel_, {input}, outputs, axis);
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def, KernelRegistry* reg,
                   std::unordered_map<NodeIndex, gsl::not_null<const KernelCreateInfo*>>& kernel_create_info_map) {
     const IExecutionProvider* ep = execution_providers_.Get(*p_node);
@@ -238,7 +284,7 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}, bool parallel_execution = false) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
 
     std::shared_ptr<KernelRegistry> reg = std::make_shared<KernelRegistry>();
@@ -260,7 +306,7 @@ class PlannerTest : public ::testing::Test {
     status = state_->FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager, {}, nullptr, remove_initializers);
 
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, parallel_execution);
 
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers_,
                                            kernel_create_info_map, state_->GetOrtValueNameIdxMap(), test_context,
@@ -276,6 +322,24 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckSlice(const std::string& name, const std::string& buffer, size_t offset) {
+    int id, buffer_id;
+    index(name, id);
+    index(buffer, buffer_id);
+    const auto& value_plan = plan_->allocation_plan[id];
+    EXPECT_EQ(value_plan.alloc_kind, AllocKind::kSlice) << "Error in allocation kind for " << name;
+    EXPECT_EQ(value_plan.reused_buffer, buffer_id) << "Error in buffer of " << name;
+    EXPECT_EQ(value_plan.buffer_offset, offset) << "Error in buffer offset of " << name;
+  }
+
+  int StreamId(const onnxruntime::Node* p_node) const { return plan_->node_stream_ids[p_node->Index()]; }
+
+  bool HasFence(const std::string& name) {
+    int id;
+    index(name, id);
+    return plan_->allocation_plan[id].create_fence_if_async;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // create set and check equality
     std::unordered_set<int> expected;
@@ -403,6 +467,95 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckFreed(2, {X2});
 }
 
+// AliasOutputTest: Check that a graph output produced by an aliasing kernel is a view of its input.
+TEST_F(PlannerTest, AliasOutputTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // no in-place operator; X1: input; X2: temporary
+  AddAliasNode(X2, X3);   // aliasing operator; X3: output
+  AddNormalNode(X2, X4);  // no in-place operator; X4: temporary
+  AddAliasNode(X1, X5);   // aliasing operator; X5: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  // the buffer of a view must not come from a memory pattern
+  CheckAllocKind(X2, AllocKind::kAllocateOutput);
+  CheckAllocKind(X3, AllocKind::kAlias);
+  CheckAllocKind(X5, AllocKind::kAlias);
+
+  // the buffer of X2 is kept for X3
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {});
+  CheckFreed(3, {});
+}
+
+// ConcatSliceTest: Check that the inputs of a Concat only it uses are placed in its output.
+TEST_F(PlannerTest, ConcatSliceTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7");
+
+  // graph structure:
+  AddNormalNode(X1, X2);               // X2: temporary read by the Concat only
+  AddNormalNode(X1, X3);               // X3: temporary read by the Concat and another node
+  AddNormalNode(X1, X4);               // X4: temporary read by the Concat only
+  AddConcatNode({X2, X3, X4}, X5, 1);  // X5: temporary
+  AddNormalNode(X3, X6);               // X6: output
+  AddNormalNode(X5, X7);               // X7: output
+
+  // simulate shape-inference results:
+  Shape shape1{1, 2};
+  Shape shape2{1, 3};
+  Shape shape3{1, 7};
+  SetShape({{X1, &shape1.value}, {X2, &shape1.value}, {X3, &shape1.value}, {X4, &shape2.value},
+            {X5, &shape3.value}, {X6, &shape1.value}, {X7, &shape3.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckSlice(X2, X5, 0);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckSlice(X4, X5, 4 * sizeof(float));
+  // X5 is allocated with X2, so it must not reuse a buffer freed before the Concat
+  CheckAllocKind(X5, AllocKind::kAllocate);
+}
+
+// SplitSliceTest: Check that the outputs of a Split are placed in its input if only the Split reads it.
+TEST_F(PlannerTest, SplitSliceTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7");
+
+  // graph structure:
+  AddNormalNode(X1, X2);              // X2: temporary read by the Split only
+  AddSplitNode(X2, {X3, X4, X5}, 0);  // X3, X4: temporaries; X5: output
+  AddNormalNode(X3, X6);              // X6: output
+  AddNormalNode(X4, X7);              // X7: output
+
+  // simulate shape-inference results:
+  Shape shape1{6, 4};
+  Shape shape2{2, 4};
+  SetShape({{X1, &shape1.value}, {X2, &shape1.value}, {X3, &shape2.value}, {X4, &shape2.value},
+            {X5, &shape2.value}, {X6, &shape2.value}, {X7, &shape2.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckSlice(X3, X2, 0);
+  CheckSlice(X4, X2, 8 * sizeof(float));
+  // a graph output owns its buffer
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+}
+
 // InPlaceSizeMismatchTest: Check that Inplace reuse is not allowed when sizes don't match.
 // Also tests reuse of disjoint lifetime tensors.
 TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
@@ -438,6 +591,62 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+/* ParallelStreamTest: Test that in parallel execution mode a node continues the stream of its producer unless an
+earlier consumer of the producer already does, and that values crossing streams or leaving the graph are fenced.
+*/
+TEST_F(PlannerTest, ParallelStreamTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  auto* node1 = AddNormalNode(X1, X2);  // X1: input
+  auto* node2 = AddNormalNode(X2, X3);  // node2 and node3 consume X2, one of them continues the stream of node1
+  auto* node3 = AddNormalNode(X2, X4);
+  auto* node4 = AddNormalNode(X4, X5);  // continues the stream of node3; X3 and X5: outputs
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan({}, true);
+
+  EXPECT_NE(StreamId(node2), StreamId(node3));
+  EXPECT_TRUE(StreamId(node1) == StreamId(node2) || StreamId(node1) == StreamId(node3));
+  EXPECT_EQ(StreamId(node3), StreamId(node4));
+
+  EXPECT_TRUE(GetPlan().has_cross_stream_fences);
+  EXPECT_TRUE(HasFence(X2));
+  EXPECT_TRUE(HasFence(X3));
+  EXPECT_FALSE(HasFence(X4));
+  EXPECT_TRUE(HasFence(X5));
+}
+
+// ParallelInPlaceTest: Check that in parallel execution mode an input is only updated in place if no other node reads
+// its buffer, as the other nodes may run concurrently.
+TEST_F(PlannerTest, ParallelInPlaceTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // X1: input
+  AddNormalNode(X2, X3);   // X3: output
+  AddInplaceNode(X2, X4);  // may-in-place operator, X2 is also read by the previous node
+  AddInplaceNode(X4, X5);  // may-in-place operator, X4 is only read by this node
+  AddNormalNode(X5, X6);   // X6: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan({}, true);
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  CheckAllocKind(X5, AllocKind::kReuse);
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
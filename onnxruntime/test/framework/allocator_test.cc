@@ -33,6 +33,20 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   //todo: test the used / max api.
 }
 
+TEST(AllocatorTest, NumaCPUAllocatorTest) {
+  // memory must be usable whether or not the platform can bind it to the node
+  NumaCPUAllocator allocator(0);
+  ASSERT_STREQ(allocator.Info().name, CPU);
+  EXPECT_EQ(allocator.NumaNode(), 0);
+
+  size_t size = 1 << 20;
+  auto bytes = allocator.Alloc(size);
+  ASSERT_TRUE(bytes);
+  memset(bytes, -1, size);
+  EXPECT_EQ(*((int*)bytes), -1);
+  allocator.Free(bytes);
+}
+
 // helper class to validate values in Alloc and Free calls made via IAllocator::MakeUniquePtr
 class TestAllocator : public IAllocator {
  public:
@@ -284,5 +284,50 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* small_ptr = a.Alloc(1 << 10);   // first region of 1MiB
+  void* large_ptr = a.Alloc(64 << 20);  // region of its own
+  a.Free(large_ptr);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (64 << 20));
+
+  // the large region was used too recently
+  ASSERT_TRUE(a.Shrink(std::chrono::seconds(3600)).IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (64 << 20));
+
+  // only the unused region is freed
+  ASSERT_TRUE(a.Shrink(std::chrono::seconds(0)).IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  EXPECT_EQ(stats.bytes_in_use, 1 << 10);
+
+  // the arena grows again from the initial chunk size
+  void* ptr = a.Alloc(2 << 20);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 3);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (2 << 20));
+
+  a.Free(ptr);
+  a.Free(small_ptr);
+  ASSERT_TRUE(a.Shrink(std::chrono::seconds(0)).IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 2);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // and can still be used after returning everything
+  ptr = a.Alloc(100);
+  EXPECT_NE(ptr, nullptr);
+  a.Free(ptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
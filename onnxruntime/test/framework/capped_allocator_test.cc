@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/bfc_arena.h"
+#include "core/framework/capped_allocator.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(CappedAllocatorTest, AccountsOwnUsageOfSharedArena) {
+  auto arena = std::make_shared<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+  CappedAllocator a(arena, 0, 0, "session a");
+  CappedAllocator b(arena, 0, 0, "session b");
+  EXPECT_EQ(a.Info(), arena->Info());
+
+  void* a1 = a.Alloc(1000);
+  void* a2 = a.Alloc(3000);
+  void* b1 = b.Alloc(500);
+  ASSERT_NE(a1, nullptr);
+  ASSERT_NE(a2, nullptr);
+  ASSERT_NE(b1, nullptr);
+  EXPECT_EQ(a.Alloc(0), nullptr);
+  EXPECT_EQ(a.Used(), 4000u);
+  EXPECT_EQ(b.Used(), 500u);
+
+  a.Free(a2);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.bytes_in_use, 1000);
+  EXPECT_EQ(stats.max_bytes_in_use, 4000);
+  EXPECT_EQ(stats.max_alloc_size, 3000);
+  // the memory the arena holds for both sessions
+  EXPECT_GT(stats.total_allocated_bytes, 0);
+
+  a.Free(a1);
+  b.Free(b1);
+  EXPECT_EQ(a.Used(), 0u);
+  EXPECT_EQ(b.Used(), 0u);
+  arena->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(CappedAllocatorTest, HardLimit) {
+  auto arena = std::make_shared<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+  CappedAllocator a(arena, 1024, 4096, "session a");
+
+  // over the soft limit only warns
+  void* p1 = a.Alloc(3000);
+  ASSERT_NE(p1, nullptr);
+  EXPECT_THROW(a.Alloc(2000), OnnxRuntimeException);
+  EXPECT_THROW(a.Reserve(5000), OnnxRuntimeException);
+  EXPECT_EQ(a.Used(), 3000u);
+
+  // the failed allocations are not counted
+  void* p2 = a.Alloc(1096);
+  ASSERT_NE(p2, nullptr);
+  EXPECT_EQ(a.Used(), 4096u);
+
+  a.Free(p1);
+  void* p3 = a.Reserve(2000);
+  ASSERT_NE(p3, nullptr);
+  a.Free(p2);
+  a.Free(p3);
+  EXPECT_EQ(a.Used(), 0u);
+  EXPECT_EQ(a.Max(), 4096u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
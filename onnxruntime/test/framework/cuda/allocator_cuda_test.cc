@@ -106,5 +106,51 @@ TEST(AllocatorTest, CUDAAllocatorFallbackTest) {
   auto last_error = cudaGetLastError();
   EXPECT_EQ(last_error, cudaSuccess) << "Last error should be cleared if handled gracefully";
 }
+
+TEST(AllocatorTest, CUDAStreamOrderedAllocatorTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  if (!CUDAStreamOrderedAllocator::IsSupported(cuda_device_id)) {
+    return;  // CUDA older than 11.2 or no memory pools on the device
+  }
+
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+  cudaStream_t stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+
+  {
+    CUDAStreamOrderedAllocator allocator(cuda_device_id, CUDA, stream, std::numeric_limits<size_t>::max());
+    EXPECT_STREQ(allocator.Info().name, CUDA);
+    EXPECT_EQ(allocator.Info().id, cuda_device_id);
+    EXPECT_EQ(allocator.Info().mem_type, OrtMemTypeDefault);
+    EXPECT_EQ(allocator.Info().alloc_type, OrtDeviceAllocator);
+    EXPECT_EQ(allocator.Alloc(0), nullptr);
+
+    size_t size = 1024;
+    std::vector<int> host_a(size / sizeof(int), -1);
+    std::vector<int> host_b(size / sizeof(int), 0);
+
+    // the block freed on the stream is reused by the next allocation on it without a synchronization,
+    // and the copies queued around the free see the values in stream order
+    void* cuda_addr_a = allocator.Alloc(size);
+    EXPECT_TRUE(cuda_addr_a);
+    CUDA_CALL_THROW(cudaMemcpyAsync(cuda_addr_a, host_a.data(), size, cudaMemcpyHostToDevice, stream));
+    void* cuda_addr_b = allocator.Alloc(size);
+    EXPECT_TRUE(cuda_addr_b);
+    CUDA_CALL_THROW(cudaMemcpyAsync(cuda_addr_b, cuda_addr_a, size, cudaMemcpyDeviceToDevice, stream));
+    allocator.Free(cuda_addr_a);
+    void* cuda_addr_c = allocator.Alloc(size);
+    EXPECT_TRUE(cuda_addr_c);
+    CUDA_CALL_THROW(cudaMemcpyAsync(cuda_addr_c, cuda_addr_b, size, cudaMemcpyDeviceToDevice, stream));
+    CUDA_CALL_THROW(cudaMemcpyAsync(host_b.data(), cuda_addr_c, size, cudaMemcpyDeviceToHost, stream));
+    allocator.Free(cuda_addr_b);
+    allocator.Free(cuda_addr_c);
+    CUDA_CALL_THROW(cudaStreamSynchronize(stream));
+    EXPECT_EQ(host_b, host_a);
+  }
+
+  CUDA_CALL_THROW(cudaStreamDestroy(stream));
+  auto last_error = cudaGetLastError();
+  EXPECT_EQ(last_error, cudaSuccess);
+}
 }  // namespace test
 }  // namespace onnxruntime
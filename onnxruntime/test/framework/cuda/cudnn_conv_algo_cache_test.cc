@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "core/providers/cuda/cuda_execution_provider.h"
+#include "core/providers/cuda/cudnn_conv_algo_cache.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(CudnnConvAlgoCacheTest, SaveAndLoad) {
+  const std::string path = "cudnn_conv_algo_cache_test_save_and_load.txt";
+  std::remove(path.c_str());
+
+  {
+    cuda::CudnnConvAlgoCache cache;
+    ASSERT_TRUE(cache.AddFile(path).IsOK());
+    ASSERT_TRUE(cache.Insert("fwd;device a;x 1,3,8,8", {1, 1024, 0}).IsOK());
+    ASSERT_TRUE(cache.Insert("fwd;device a;x 2,3,8,8", {6, 0, 1}).IsOK());
+  }
+
+  cuda::CudnnConvAlgoCache cache;
+  ASSERT_TRUE(cache.AddFile(path).IsOK());
+  cuda::CudnnConvAlgoCacheEntry entry;
+  ASSERT_TRUE(cache.Find("fwd;device a;x 1,3,8,8", entry));
+  EXPECT_EQ(entry.algo, 1);
+  EXPECT_EQ(entry.memory, 1024u);
+  EXPECT_EQ(entry.math_type, 0);
+  ASSERT_TRUE(cache.Find("fwd;device a;x 2,3,8,8", entry));
+  EXPECT_EQ(entry.algo, 6);
+  EXPECT_EQ(entry.math_type, 1);
+  EXPECT_FALSE(cache.Find("fwd;device b;x 1,3,8,8", entry));
+
+  std::remove(path.c_str());
+}
+
+TEST(CudnnConvAlgoCacheTest, RejectsOtherFiles) {
+  const std::string path = "cudnn_conv_algo_cache_test_rejects_other_files.txt";
+  {
+    std::ofstream file(path);
+    file << "not a cache\n";
+  }
+
+  cuda::CudnnConvAlgoCache cache;
+  EXPECT_FALSE(cache.AddFile(path).IsOK());
+  ASSERT_TRUE(cache.Insert("fwd;device a;x 1,3,8,8", {1, 0, 0}).IsOK());
+
+  // the file wasn't added, so it is left untouched
+  std::ifstream file(path);
+  std::string line;
+  ASSERT_TRUE(std::getline(file, line));
+  EXPECT_EQ(line, "not a cache");
+  file.close();
+
+  std::remove(path.c_str());
+}
+
+TEST(CudnnConvAlgoCacheTest, ConvSavesSearch) {
+  const std::string path = "cudnn_conv_algo_cache_test_conv_saves_search.txt";
+  std::remove(path.c_str());
+
+  for (int run = 0; run < 2; ++run) {
+    OpTester test("Conv");
+    test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+    test.AddInput<float>("X", {1, 1, 3, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f});
+    test.AddInput<float>("W", {1, 1, 2, 2}, {1.f, 0.f, 0.f, 1.f});
+    test.AddOutput<float>("Y", {1, 1, 2, 2}, {6.f, 8.f, 12.f, 14.f});
+
+    CUDAExecutionProviderInfo info;
+    info.cudnn_conv_algo = OrtCudnnConvAlgoSearch::EXHAUSTIVE;
+    info.cudnn_conv_algo_cache_path = path;
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(onnxruntime::make_unique<CUDAExecutionProvider>(info));
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+
+  cuda::CudnnConvAlgoCache::EntryMap entries;
+  ASSERT_TRUE(cuda::CudnnConvAlgoCache::LoadFile(path, entries).IsOK());
+  bool found = false;
+  for (const auto& entry : entries) {
+    found = found || (entry.first.find("fwd;") == 0 && entry.first.find(";x 1,1,3,3") != std::string::npos);
+  }
+  EXPECT_TRUE(found);
+
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "core/providers/cuda/cuda_execution_provider.h"
+#include "core/providers/cuda/fusion/elementwise_fusion.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+using ArgMap = std::vector<NodeArg*>;
+
+// Y = Relu(Mul(T, Sigmoid(T))) with T = Add(X, B), and Z = Exp(Sub(X, B)), where Sub(X, B) is also an output.
+void BuildModel(Graph& graph) {
+  ONNX_NAMESPACE::TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& t = graph.GetOrCreateNodeArg("T", &tensor_float);
+  auto& s = graph.GetOrCreateNodeArg("S", &tensor_float);
+  auto& m = graph.GetOrCreateNodeArg("M", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  auto& d = graph.GetOrCreateNodeArg("D", &tensor_float);
+  auto& z = graph.GetOrCreateNodeArg("Z", &tensor_float);
+
+  graph.AddNode("add", "Add", "", ArgMap{&x, &b}, ArgMap{&t});
+  graph.AddNode("sigmoid", "Sigmoid", "", ArgMap{&t}, ArgMap{&s});
+  graph.AddNode("mul", "Mul", "", ArgMap{&t, &s}, ArgMap{&m});
+  graph.AddNode("relu", "Relu", "", ArgMap{&m}, ArgMap{&y});
+  graph.AddNode("sub", "Sub", "", ArgMap{&x, &b}, ArgMap{&d});
+  graph.AddNode("exp", "Exp", "", ArgMap{&d}, ArgMap{&z});
+  graph.SetOutputs({&y, &d, &z});
+}
+
+}  // namespace
+
+TEST(ElementwiseFusionTest, FindGroups) {
+  Model model("elementwise_fusion", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  BuildModel(graph);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  GraphViewer viewer(graph);
+  auto groups = cuda::FindElementwiseFusionGroups(viewer, viewer.GetNodesInTopologicalOrder());
+
+  // D is an output of the graph, so Sub and Exp stay separate nodes
+  ASSERT_EQ(groups.size(), 1u);
+  EXPECT_EQ(groups[0]->nodes.size(), 4u);
+  const auto* meta_def = groups[0]->GetMetaDef();
+  ASSERT_NE(meta_def, nullptr);
+  EXPECT_EQ(meta_def->inputs, (std::vector<std::string>{"X", "B"}));
+  EXPECT_EQ(meta_def->outputs, std::vector<std::string>{"Y"});
+}
+
+TEST(ElementwiseFusionTest, RunFusedKernel) {
+  Model model("elementwise_fusion", false, DefaultLoggingManager().DefaultLogger());
+  BuildModel(model.MainGraph());
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  CUDAExecutionProviderInfo info;
+  info.enable_elementwise_fusion = true;
+  ASSERT_STATUS_OK(session.RegisterExecutionProvider(onnxruntime::make_unique<CUDAExecutionProvider>(info)));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  int fused_nodes = 0;
+  for (const auto& node : session.GetGraph().Nodes()) {
+    fused_nodes += node.OpType().rfind("FusedElementwise_", 0) == 0;
+  }
+  EXPECT_EQ(fused_nodes, 1);
+
+  // B broadcasts over the rows of X
+  const std::vector<int64_t> x_dims{2, 3, 4};
+  std::vector<float> x_data(24);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = static_cast<float>(i) / 6.f - 2.f;
+  }
+  const std::vector<float> b_data{0.5f, -1.f, 0.f, 2.f};
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value;
+  OrtValue b_value;
+  CreateMLValue<float>(cpu_allocator, x_dims, x_data, &x_value);
+  CreateMLValue<float>(cpu_allocator, {4}, b_data, &b_value);
+
+  std::vector<OrtValue> outputs;
+  ASSERT_STATUS_OK(session.Run(NameMLValMap{{"X", x_value}, {"B", b_value}}, {"Y", "Z"}, &outputs));
+  ASSERT_EQ(outputs.size(), 2u);
+  const Tensor& y = outputs[0].Get<Tensor>();
+  EXPECT_EQ(y.Shape(), TensorShape(x_dims));
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    const float t = x_data[i] + b_data[i % 4];
+    const float expected = std::max(t / (1.f + std::exp(-t)), 0.f);
+    EXPECT_NEAR(y.Data<float>()[i], expected, 1e-5f) << "index " << i;
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/allocatormgr.h"
+#include "core/framework/tensor.h"
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+#include "cuda_runtime.h"
+#include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/gpu_data_transfer.h"
+
+namespace onnxruntime {
+namespace test {
+// copies from pageable memory are staged in pinned memory, so the source can be modified as soon as the copy returns
+TEST(GPUDataTransferTest, StagedCopyFromPageableMemory) {
+  AllocatorCreationInfo default_memory_info(
+      {[](OrtDevice::DeviceId id) { return onnxruntime::make_unique<CUDAAllocator>(id, CUDA); }, 0});
+  auto cuda_arena = CreateAllocator(default_memory_info);
+
+  AllocatorCreationInfo pinned_memory_info(
+      [](int) { return onnxruntime::make_unique<CUDAPinnedAllocator>(static_cast<OrtDevice::DeviceId>(0), CUDA_PINNED); });
+  auto pinned_allocator = CreateAllocator(pinned_memory_info);
+
+  const auto& cpu_arena = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  for (bool do_copy_in_default_stream : {true, false}) {
+    GPUDataTransfer data_transfer(do_copy_in_default_stream, pinned_allocator);
+
+    // more tensors than staging buffers, so some of the copies have to reuse a buffer or be synchronous
+    constexpr int num_tensors = 20;
+    std::vector<std::unique_ptr<Tensor>> gpu_tensors;
+    for (int i = 0; i < num_tensors; ++i) {
+      // grow the size so idle buffers that are too small are replaced
+      gpu_tensors.push_back(onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<float>(),
+                                                             TensorShape({256 + 16 * i, 4}), cuda_arena));
+    }
+
+    for (int i = 0; i < num_tensors; ++i) {
+      Tensor source(DataTypeImpl::GetType<float>(), gpu_tensors[i]->Shape(), cpu_arena);
+      float* data = source.MutableData<float>();
+      std::fill(data, data + source.Shape().Size(), static_cast<float>(i));
+      ASSERT_TRUE(data_transfer.CopyTensor(source, *gpu_tensors[i], kCudaStreamDefault).IsOK());
+      // overwritten before the asynchronous copy completes
+      std::fill(data, data + source.Shape().Size(), -1.f);
+    }
+
+    for (int i = 0; i < num_tensors; ++i) {
+      Tensor result(DataTypeImpl::GetType<float>(), gpu_tensors[i]->Shape(), cpu_arena);
+      ASSERT_TRUE(data_transfer.CopyTensor(*gpu_tensors[i], result, kCudaStreamDefault).IsOK());
+      const float* data = result.Data<float>();
+      for (int64_t j = 0; j < result.Shape().Size(); ++j) {
+        ASSERT_EQ(data[j], static_cast<float>(i)) << "tensor " << i << " element " << j;
+      }
+    }
+  }
+}
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/common/make_unique.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/execution_plan_cache.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/graph/model.h"
@@ -254,6 +255,77 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, 64u);
 }
 
+// the memory pattern for new input shapes is planned from the symbolic shapes, without tracing a Run
+TEST_F(ExecutionFrameTest, MemPatternFromSymbolicShapesTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_n_2;
+  tensor_n_2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_n_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  tensor_n_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  TypeProto tensor_2_2;
+  tensor_2_2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_2_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_2_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  onnxruntime::NodeArg input_def1("X1", &tensor_n_2),
+      input_def2("X2", &tensor_2_2),
+      gemm1_out_def("T1", nullptr),
+      gemm2_out_def("T2", nullptr),
+      gemm3_out_def("T3", nullptr);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def2}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "MatMul", "gemm3", ArgMap{&gemm2_out_def, &input_def2}, ArgMap{&gemm3_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionState state(graph, execution_providers, true, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+
+  int x1_idx = -1, x2_idx = -1, t1_idx = -1, t2_idx = -1;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+
+  TensorShape x1_shape({3, 2}), x2_shape({2, 2});
+  auto entry = state.GetExecutionPlanCacheEntry({std::cref(x1_shape), std::cref(x2_shape)}, {x1_idx, x2_idx});
+  ASSERT_NE(entry, nullptr);
+  ASSERT_NE(entry->mem_patterns, nullptr);
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+  auto p = entry->mem_patterns->GetPatterns(cpu_allocator->Info());
+  ASSERT_NE(p, nullptr);
+  // T1 and T2 are alive together, T3 is a graph output. each allocation is 64-byte aligned
+  EXPECT_EQ(p->PeakSize(), 2u * 64u);
+  ASSERT_NE(p->GetBlock(t1_idx), nullptr);
+  ASSERT_NE(p->GetBlock(t2_idx), nullptr);
+  EXPECT_EQ(p->GetBlock(t1_idx)->size_, 64u);
+  EXPECT_NE(p->GetBlock(t1_idx)->offset_, p->GetBlock(t2_idx)->offset_);
+
+  EXPECT_EQ(entry->inferred_shapes.at(t1_idx), TensorShape({3, 2}));
+}
+
 TEST(ExecutionFrameTestWithoutSessionState, BadModelInvalidDimParamUsage) {
   // load model with 2 Scan ops that both incorrectly use shapes of { 'None', 'None' } for their outputs.
   // as 'None' is not a special value it's treated as a variable name, leading to a runtime error when we
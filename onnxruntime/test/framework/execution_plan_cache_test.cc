@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_plan_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::shared_ptr<const ExecutionPlanCacheEntry> MakeEntry() {
+  return std::make_shared<const ExecutionPlanCacheEntry>(nullptr, std::unordered_map<int, TensorShape>(), 0);
+}
+
+TEST(ExecutionPlanCacheTest, KeyIncludesRank) {
+  TensorShape a({2, 3});
+  TensorShape b({2});
+  TensorShape c({3});
+
+  auto key_a = ExecutionPlanCache::MakeKey({std::cref(a)});
+  auto key_bc = ExecutionPlanCache::MakeKey({std::cref(b), std::cref(c)});
+  EXPECT_NE(key_a, key_bc);
+
+  // the old xor based key mapped these to the same value
+  TensorShape d({1, 2});
+  TensorShape e({2, 1});
+  EXPECT_NE(ExecutionPlanCache::MakeKey({std::cref(d)}), ExecutionPlanCache::MakeKey({std::cref(e)}));
+}
+
+TEST(ExecutionPlanCacheTest, EvictsLeastRecentlyUsed) {
+  ExecutionPlanCache cache(2);
+  TensorShape s1({1});
+  TensorShape s2({2});
+  TensorShape s3({3});
+  auto k1 = ExecutionPlanCache::MakeKey({std::cref(s1)});
+  auto k2 = ExecutionPlanCache::MakeKey({std::cref(s2)});
+  auto k3 = ExecutionPlanCache::MakeKey({std::cref(s3)});
+
+  auto e1 = MakeEntry();
+  cache.Insert(k1, e1);
+  cache.Insert(k2, MakeEntry());
+
+  // touch k1 so k2 is the least recently used
+  EXPECT_EQ(cache.Find(k1), e1);
+  cache.Insert(k3, MakeEntry());
+
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_NE(cache.Find(k1), nullptr);
+  EXPECT_EQ(cache.Find(k2), nullptr);
+  EXPECT_NE(cache.Find(k3), nullptr);
+
+  // an entry in use stays valid after eviction
+  cache.SetCapacity(0);
+  EXPECT_EQ(cache.Size(), 0u);
+  EXPECT_EQ(e1.use_count(), 1);
+
+  cache.Insert(k1, e1);
+  EXPECT_EQ(cache.Find(k1), nullptr);
+}
+
+TEST(ExecutionPlanCacheTest, FlatBlockLookup) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(1, 256);
+  planner.TraceAllocation(3, 512);
+
+  auto group = onnxruntime::make_unique<MemoryPatternGroup>();
+  group->locations.push_back(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator));
+  group->patterns.push_back(planner.GenerateMemPattern());
+
+  ExecutionPlanCacheEntry entry(std::move(group), std::unordered_map<int, TensorShape>(), 5);
+
+  int location_idx = -1;
+  const auto* block = entry.GetBlock(3, location_idx);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(location_idx, 0);
+  EXPECT_EQ(block->offset_, 256u);
+  EXPECT_EQ(block->size_, 512u);
+
+  EXPECT_EQ(entry.GetBlock(2, location_idx), nullptr);
+  EXPECT_EQ(entry.GetBlock(10, location_idx), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
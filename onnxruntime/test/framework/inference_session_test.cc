@@ -7,6 +7,7 @@
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <sstream>
 #include <thread>
 #include <fstream>
 
@@ -21,12 +22,14 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/platform/hardware_counters.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
@@ -36,6 +39,10 @@
 #include "core/session/IOBinding.h"
 #include "core/session/device_allocator.h"
 #include "core/session/allocator_impl.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/inference_session_group.h"
+#include "core/session/inference_session_pipeline.h"
+#include "core/session/run_pipeline.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -599,15 +606,17 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   ASSERT_TRUE(profile);
   std::string line;
 
-  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
+  // the events of the node are followed by a counter event with the memory use of the CPU arena
+  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "name", "args"};
   int count = 0;
   while (std::getline(profile, line)) {
     if (count == 0) {
       ASSERT_TRUE(line.find("[") != string::npos);
-    } else if (count <= 7) {
+    } else if (count <= 8) {
       for (auto& s : tags) {
         ASSERT_TRUE(line.find(s) != string::npos);
       }
+      ASSERT_TRUE(line.find("\"ph\" : \"X\"") != string::npos || line.find("\"ph\" : \"C\"") != string::npos);
     } else {
       ASSERT_TRUE(line.find("]") != string::npos);
     }
@@ -619,6 +628,38 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithHardwareCounters) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithHardwareCounters";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_hardware_counters_test");
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfileHardwareCounters, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string contents((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+  ASSERT_NE(contents.find("_kernel_time"), std::string::npos);
+
+  // the counters are skipped if the platform or the machine doesn't provide them
+  profiling::HardwareCounterValues values;
+  const bool has_hardware_counters = profiling::ReadHardwareCounters(values);
+  for (const char* arg : {"\"cycles\"", "\"instructions\"", "\"llc_references\"", "\"llc_misses\"",
+                          "\"memory_bandwidth_gbps\""}) {
+    EXPECT_EQ(contents.find(arg) != std::string::npos, has_hardware_counters) << arg;
+  }
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
@@ -638,15 +679,16 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   std::ifstream profile(profile_file);
   std::string line;
 
-  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
+  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "name", "args"};
   int count = 0;
   while (std::getline(profile, line)) {
     if (count == 0) {
       ASSERT_TRUE(line.find("[") != string::npos);
-    } else if (count <= 5) {
+    } else if (count <= 6) {
       for (auto& s : tags) {
         ASSERT_TRUE(line.find(s) != string::npos);
       }
+      ASSERT_TRUE(line.find("\"ph\" : \"X\"") != string::npos || line.find("\"ph\" : \"C\"") != string::npos);
     } else {
       ASSERT_TRUE(line.find("]") != string::npos);
     }
@@ -683,6 +725,222 @@ TEST(InferenceSessionTests, CheckRunProfilerStartTime) {
   ASSERT_TRUE(before_start_time <= profiling_start_time && profiling_start_time <= after_start_time);
 }
 
+TEST(InferenceSessionTests, CheckSamplingProfiler) {
+  SessionOptions so;
+
+  so.session_logid = "CheckSamplingProfiler";
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfilingSampleRate, "2"));
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfilingStatsFile, "sampling_profile_test.json"));
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigProfilingStatsExportIntervalSeconds, "0"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  for (int i = 0; i < 5; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // runs 0, 2 and 4 are sampled
+  std::string stats;
+  ASSERT_STATUS_OK(session_object.GetSamplingProfileStats(stats));
+  EXPECT_NE(stats.find("\"sample_rate\": 2,"), std::string::npos) << stats;
+  EXPECT_NE(stats.find("\"sampled_runs\": 3,"), std::string::npos) << stats;
+  EXPECT_NE(stats.find("{\"name\": \"mul_1\", \"op_type\": \"Mul\", \"provider\": \"CPUExecutionProvider\", "
+                       "\"count\": 3,"),
+            std::string::npos)
+      << stats;
+  EXPECT_NE(stats.find("{\"op_type\": \"Mul\", \"count\": 3,"), std::string::npos) << stats;
+
+  // the statistics are exported after every Run with an interval of 0
+  std::ifstream exported_stats_file("sampling_profile_test.json");
+  ASSERT_TRUE(exported_stats_file);
+  std::string exported_stats((std::istreambuf_iterator<char>(exported_stats_file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(exported_stats, stats);
+  exported_stats_file.close();
+  std::remove("sampling_profile_test.json");
+}
+
+TEST(InferenceSessionTests, SaveAndLoadPartitioningPlacement) {
+  SessionOptions so;
+
+  so.session_logid = "SaveAndLoadPartitioningPlacement";
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigPartitioningCostModel, "1"));
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigSavePartitioningPlacement, "partitioning_placement.txt"));
+  {
+    InferenceSession session_object(so, GetEnvironment());
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  }
+
+  std::ifstream placement_file("partitioning_placement.txt");
+  ASSERT_TRUE(placement_file);
+  std::string placement((std::istreambuf_iterator<char>(placement_file)), std::istreambuf_iterator<char>());
+  placement_file.close();
+  EXPECT_EQ(placement, "mul_1\tCPUExecutionProvider\n");
+
+  SessionOptions load_so;
+  load_so.session_logid = "SaveAndLoadPartitioningPlacement";
+  ASSERT_STATUS_OK(load_so.AddConfigEntry(kOrtSessionOptionsConfigLoadPartitioningPlacement,
+                                          "partitioning_placement.txt"));
+  InferenceSession session_object(load_so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::remove("partitioning_placement.txt");
+}
+
+TEST(InferenceSessionTests, CheckSamplingProfilerDisabled) {
+  SessionOptions so;
+
+  so.session_logid = "CheckSamplingProfilerDisabled";
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string stats;
+  ASSERT_FALSE(session_object.GetSamplingProfileStats(stats).IsOK());
+}
+
+TEST(InferenceSessionTests, ArenaStats) {
+  SessionOptions so;
+
+  so.session_logid = "ArenaStats";
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "ArenaStats";
+  RunModel(session_object, run_options);
+
+  std::string stats;
+  ASSERT_STATUS_OK(session_object.GetArenaStats(stats));
+  EXPECT_EQ(stats.find(R"({"arenas":[{"provider":"CPUExecutionProvider","device":"Cpu","deviceId":0,"bytesInUse":)"), 0u)
+      << stats;
+}
+
+TEST(InferenceSessionTests, MemoryReport) {
+  SessionOptions so;
+
+  so.session_logid = "MemoryReport";
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "MemoryReport";
+  RunModel(session_object, run_options);
+
+  std::string report;
+  ASSERT_STATUS_OK(session_object.GetMemoryReport(report));
+  EXPECT_EQ(report.find(R"({"initializers":[)"), 0u) << report;
+  for (const char* section : {R"("prePacked":{)", R"("plannedActivations":[)", R"("nodes":[)",
+                              R"("arenas":[{"provider":"CPUExecutionProvider","device":"Cpu","deviceId":0,)"}) {
+    EXPECT_NE(report.find(section), std::string::npos) << section << " not in " << report;
+  }
+}
+
+TEST(InferenceSessionTests, RunMany) {
+  for (auto execution_mode : {ExecutionMode::ORT_SEQUENTIAL, ExecutionMode::ORT_PARALLEL}) {
+    SessionOptions so;
+    so.session_logid = "RunMany";
+    so.execution_mode = execution_mode;
+    InferenceSession session_object(so, GetEnvironment());
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    std::vector<int64_t> dims_mul_x = {3, 2};
+    std::vector<NameMLValMap> feeds(8);
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      std::vector<float> values_mul_x(6, static_cast<float>(i));
+      OrtValue ml_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                           &ml_value);
+      feeds[i].insert(std::make_pair("X", ml_value));
+    }
+
+    RunOptions run_options;
+    std::vector<std::vector<OrtValue>> fetches;
+    ASSERT_STATUS_OK(session_object.RunMany(run_options, feeds, {"Y"}, fetches));
+    ASSERT_EQ(fetches.size(), feeds.size());
+    for (size_t i = 0; i < fetches.size(); ++i) {
+      VerifyOutputs(fetches[i], dims_mul_x, std::vector<float>(6, static_cast<float>(i * i)));
+    }
+
+    // a failed Run is reported
+    feeds[3].clear();
+    EXPECT_FALSE(session_object.RunMany(run_options, feeds, {"Y"}, fetches).IsOK());
+  }
+}
+
+TEST(InferenceSessionTests, ParallelExecutionWithNodeCostModel) {
+  SessionOptions so;
+
+  so.session_logid = "ParallelExecutionWithNodeCostModel";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutorWarmupRuns, "2"));
+
+  InferenceSessionWrapper session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const NodeCostModel* cost_model = session_object.GetSessionState().GetNodeCostModel();
+  ASSERT_NE(cost_model, nullptr);
+  EXPECT_FALSE(cost_model->HasEstimates());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  for (int i = 0; i < 2; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // the estimates are available after the warmup runs and the later runs are scheduled with them
+  ASSERT_TRUE(cost_model->HasEstimates());
+  for (const auto& node : session_object.GetSessionState().GetGraphViewer().Nodes()) {
+    EXPECT_GE(cost_model->CostNs(node.Index()), 0);
+    EXPECT_GE(cost_model->PriorityNs(node.Index()), cost_model->CostNs(node.Index()));
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+}
+
+TEST(InferenceSessionTests, ParallelExecutionWithoutNodeCostModel) {
+  SessionOptions so;
+
+  so.session_logid = "ParallelExecutionWithoutNodeCostModel";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutorWarmupRuns, "0"));
+
+  InferenceSessionWrapper session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_EQ(session_object.GetSessionState().GetNodeCostModel(), nullptr);
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, ParallelExecutionInvalidWarmupRuns) {
+  SessionOptions so;
+
+  so.session_logid = "ParallelExecutionInvalidWarmupRuns";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutorWarmupRuns, "-1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  auto status = session_object.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr(kOrtSessionOptionsConfigParallelExecutorWarmupRuns));
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -894,6 +1152,304 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingRepeatedRuns) {
+  SessionOptions so;
+  InferenceSession session_object(so, GetEnvironment());
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue b;
+  CreateMLValue<float>(cpu_allocator, {2, 1}, {1.f, 2.f}, &b);
+  ASSERT_STATUS_OK(io_binding->BindInput("B", b));
+
+  // the feed/fetch info of the first Run is reused, so later Runs must still pick up the new values
+  for (int run = 0; run < 3; ++run) {
+    OrtValue a;
+    auto x = static_cast<float>(run + 1);
+    CreateMLValue<float>(cpu_allocator, {1, 2}, {x, x}, &a);
+    ASSERT_STATUS_OK(io_binding->BindInput("A", a));
+    if (run < 2) {
+      ASSERT_STATUS_OK(io_binding->BindOutput("Y"));
+    } else {
+      // switch to a pre-allocated output
+      OrtValue y;
+      CreateMLValue<float>(cpu_allocator, {1, 1}, {0.f}, &y);
+      ASSERT_STATUS_OK(io_binding->BindOutput("Y", y));
+    }
+
+    ASSERT_STATUS_OK(session_object.Run(*io_binding));
+    ASSERT_EQ(io_binding->GetOutputs().size(), 1u);
+    VerifyOutputs(io_binding->GetOutputs()[0].Get<Tensor>(), {1, 1}, {3.f * x});
+  }
+
+  // binding a new name changes the feeds, which must not use the info computed for the previous ones
+  io_binding->ClearInputs();
+  OrtValue a;
+  CreateMLValue<float>(cpu_allocator, {1, 2}, {1.f, 1.f}, &a);
+  ASSERT_STATUS_OK(io_binding->BindInput("B", b));
+  ASSERT_STATUS_OK(io_binding->BindInput("A", a));
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  VerifyOutputs(io_binding->GetOutputs()[0].Get<Tensor>(), {1, 1}, {3.f});
+}
+
+TEST(InferenceSessionTests, RunPipelineKeepsRunsInFlight) {
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 2;
+  InferenceSession session_object(so, GetEnvironment());
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::unique_ptr<RunPipeline> pipeline;
+  ASSERT_FALSE(RunPipeline::Create(session_object, 0, pipeline).IsOK());
+  ASSERT_STATUS_OK(RunPipeline::Create(session_object, 2, pipeline));
+  ASSERT_EQ(pipeline->Depth(), 2u);
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue b;
+  CreateMLValue<float>(cpu_allocator, {2, 1}, {1.f, 2.f}, &b);
+
+  constexpr int num_runs = 8;
+  std::vector<float> results(num_runs, 0.f);
+  std::vector<Status> statuses(num_runs);
+  RunOptions run_options;
+  for (int run = 0; run < num_runs; ++run) {
+    IOBinding* io_binding;
+    ASSERT_STATUS_OK(pipeline->AcquireBinding(io_binding));
+
+    OrtValue a;
+    auto x = static_cast<float>(run + 1);
+    CreateMLValue<float>(cpu_allocator, {1, 2}, {x, x}, &a);
+    ASSERT_STATUS_OK(io_binding->BindInput("A", a));
+    ASSERT_STATUS_OK(io_binding->BindInput("B", b));
+    ASSERT_STATUS_OK(io_binding->BindOutput("Y"));
+
+    ASSERT_STATUS_OK(pipeline->Submit(run_options, *io_binding,
+                                      [&results, &statuses, run](const Status& status, IOBinding& binding) {
+                                        statuses[run] = status;
+                                        if (status.IsOK()) {
+                                          results[run] = binding.GetOutputs()[0].Get<Tensor>().Data<float>()[0];
+                                        }
+                                      }));
+  }
+
+  pipeline->Wait();
+  for (int run = 0; run < num_runs; ++run) {
+    ASSERT_STATUS_OK(statuses[run]);
+    EXPECT_EQ(results[run], 3.f * static_cast<float>(run + 1));
+  }
+
+  // a binding that wasn't acquired from the pipeline is rejected
+  unique_ptr<IOBinding> other_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&other_binding));
+  ASSERT_FALSE(pipeline->Submit(run_options, *other_binding, [](const Status&, IOBinding&) {}).IsOK());
+}
+
+// Y = A x B with the initializer B = {1, 2}
+static void RunInferenceSessionGroupTest(ProviderType provider_type, const std::vector<int>& device_ids,
+                                         const InferenceSessionGroup::ProviderFactory& provider_factory) {
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, provider_type);
+  Graph& graph = p_model->MainGraph();
+  ONNX_NAMESPACE::TensorProto b{};
+  b.set_name("B");
+  b.add_dims(2);
+  b.add_dims(1);
+  b.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b.add_float_data(1.f);
+  b.add_float_data(2.f);
+  graph.AddInitializedTensor(b);
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  p_model->ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 2;
+  std::unique_ptr<InferenceSessionGroup> group;
+  ASSERT_FALSE(InferenceSessionGroup::Create(so, GetEnvironment(), model_data.data(),
+                                             static_cast<int>(model_data.size()), {}, provider_factory, group)
+                   .IsOK());
+  ASSERT_STATUS_OK(InferenceSessionGroup::Create(so, GetEnvironment(), model_data.data(),
+                                                 static_cast<int>(model_data.size()), device_ids, provider_factory,
+                                                 group));
+  ASSERT_EQ(group->Size(), device_ids.size());
+  for (size_t i = 0; i < device_ids.size(); ++i) {
+    EXPECT_EQ(group->DeviceId(i), device_ids[i]);
+  }
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  RunOptions run_options;
+
+  // concurrent Runs spread over the sessions
+  constexpr int num_runs = 8;
+  std::vector<Status> statuses(num_runs);
+  std::vector<float> results(num_runs, 0.f);
+  std::vector<std::thread> threads;
+  for (int run = 0; run < num_runs; ++run) {
+    threads.emplace_back([&, run]() {
+      OrtValue a;
+      auto x = static_cast<float>(run + 1);
+      CreateMLValue<float>(cpu_allocator, {1, 2}, {x, x}, &a);
+      std::vector<OrtValue> fetches;
+      statuses[run] = group->Run(run_options, NameMLValMap{{"A", a}}, {"Y"}, &fetches);
+      if (statuses[run].IsOK()) {
+        results[run] = fetches[0].Get<Tensor>().Data<float>()[0];
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int run = 0; run < num_runs; ++run) {
+    ASSERT_STATUS_OK(statuses[run]);
+    EXPECT_EQ(results[run], 3.f * static_cast<float>(run + 1));
+  }
+
+  // a batch of 5 rows is split over the sessions, and the rows of the output are in the order of the batch
+  OrtValue a;
+  CreateMLValue<float>(cpu_allocator, {5, 2}, {1.f, 1.f, 2.f, 2.f, 3.f, 3.f, 4.f, 4.f, 5.f, 5.f}, &a);
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(group->RunSplitBatch(run_options, NameMLValMap{{"A", a}}, {"Y"}, &fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  VerifyOutputs(fetches[0].Get<Tensor>(), {5, 1}, {3.f, 6.f, 9.f, 12.f, 15.f});
+}
+
+TEST(InferenceSessionTests, InferenceSessionGroup) {
+  RunInferenceSessionGroupTest(kCpuExecutionProvider, {0, 1, 2}, [](int) {
+    return std::unique_ptr<IExecutionProvider>(
+        onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  });
+
+#ifdef USE_CUDA
+  // the initializer is decoded once and copied to the device by each of the sessions
+  RunInferenceSessionGroupTest(kCudaExecutionProvider, {0, 0}, [](int) { return DefaultCudaExecutionProvider(); });
+#endif
+}
+
+// Y = Relu(X x W1) x W2, with W1 = {{1, -1}, {2, 1}} and W2 = {{1}, {2}}
+static void CreateTwoLayerModel(std::string& model_data) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("two_layers", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& w1 = graph.GetOrCreateNodeArg("W1", &tensor_float);
+  auto& h = graph.GetOrCreateNodeArg("H", &tensor_float);
+  auto& r = graph.GetOrCreateNodeArg("R", &tensor_float);
+  auto& w2 = graph.GetOrCreateNodeArg("W2", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  using ArgMap = std::vector<NodeArg*>;
+  graph.AddNode("matmul1", "MatMul", "", ArgMap{&x, &w1}, ArgMap{&h});
+  graph.AddNode("relu", "Relu", "", ArgMap{&h}, ArgMap{&r});
+  graph.AddNode("matmul2", "MatMul", "", ArgMap{&r, &w2}, ArgMap{&y});
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                  const std::vector<float>& values) {
+    ONNX_NAMESPACE::TensorProto initializer{};
+    initializer.set_name(name);
+    for (auto dim : dims) {
+      initializer.add_dims(dim);
+    }
+    initializer.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto value : values) {
+      initializer.add_float_data(value);
+    }
+    graph.AddInitializedTensor(initializer);
+  };
+  add_initializer("W1", {2, 2}, {1.f, -1.f, 2.f, 1.f});
+  add_initializer("W2", {2, 1}, {1.f, 2.f});
+  ASSERT_STATUS_OK(graph.Resolve());
+  model.ToProto().SerializeToString(&model_data);
+}
+
+TEST(InferenceSessionTests, InferenceSessionPipelinePartition) {
+  std::string model_data;
+  CreateTwoLayerModel(model_data);
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_TRUE(model_proto.ParseFromString(model_data));
+
+  std::vector<ONNX_NAMESPACE::ModelProto> stage_models;
+  ASSERT_FALSE(InferenceSessionPipeline::PartitionModel(model_proto, 4, DefaultLoggingManager().DefaultLogger(),
+                                                        stage_models)
+                   .IsOK());
+  ASSERT_STATUS_OK(InferenceSessionPipeline::PartitionModel(model_proto, 2, DefaultLoggingManager().DefaultLogger(),
+                                                            stage_models));
+  ASSERT_EQ(stage_models.size(), 2u);
+
+  // each stage only has the initializers of its nodes
+  const auto& stage0 = stage_models[0].graph();
+  const auto& stage1 = stage_models[1].graph();
+  ASSERT_EQ(stage0.initializer_size(), 1);
+  EXPECT_EQ(stage0.initializer(0).name(), "W1");
+  ASSERT_EQ(stage1.initializer_size(), 1);
+  EXPECT_EQ(stage1.initializer(0).name(), "W2");
+  ASSERT_EQ(stage0.input_size(), 1);
+  EXPECT_EQ(stage0.input(0).name(), "X");
+  ASSERT_EQ(stage0.output_size(), 1);
+  ASSERT_EQ(stage1.input_size(), 1);
+  EXPECT_EQ(stage1.input(0).name(), stage0.output(0).name());
+  ASSERT_EQ(stage1.output_size(), 1);
+  EXPECT_EQ(stage1.output(0).name(), "Y");
+  EXPECT_EQ(stage0.node_size() + stage1.node_size(), 3);
+}
+
+TEST(InferenceSessionTests, InferenceSessionPipelineRun) {
+  std::string model_data;
+  CreateTwoLayerModel(model_data);
+
+  SessionOptions so;
+  std::unique_ptr<InferenceSessionPipeline> pipeline;
+  InferenceSessionPipeline::ProviderFactory provider_factory = [](int) {
+    return std::unique_ptr<IExecutionProvider>(
+        onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  };
+#ifdef USE_CUDA
+  // both stages on one GPU, the copy between them stays on the device
+  provider_factory = [](int) { return DefaultCudaExecutionProvider(); };
+#endif
+  ASSERT_STATUS_OK(InferenceSessionPipeline::Create(so, GetEnvironment(), model_data.data(),
+                                                    static_cast<int>(model_data.size()), {0, 0}, provider_factory,
+                                                    pipeline));
+  ASSERT_EQ(pipeline->NumStages(), 2u);
+
+  const std::vector<float> x_data{1.f, 1.f, 2.f, -1.f, -1.f, 3.f, 0.f, 1.f, 3.f, 2.f};
+  std::vector<float> expected;
+  for (size_t row = 0; row < 5; ++row) {
+    const float x0 = x_data[2 * row];
+    const float x1 = x_data[2 * row + 1];
+    expected.push_back(std::max(x0 + 2.f * x1, 0.f) + 2.f * std::max(x1 - x0, 0.f));
+  }
+
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {5, 2}, x_data, &x);
+  RunOptions run_options;
+  for (size_t num_micro_batches : {1, 2, 5, 8}) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(pipeline->Run(run_options, NameMLValMap{{"X", x}}, {"Y"}, &fetches, num_micro_batches));
+    ASSERT_EQ(fetches.size(), 1u);
+    VerifyOutputs(fetches[0].Get<Tensor>(), {5, 1}, expected);
+  }
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -976,6 +1532,69 @@ TEST(InferenceSessionTests, TestBindCudaSpecifyOutputDeviceOnCuda) {
                  &device /* specify output device */);
 }
 
+#ifdef ENABLE_CUDA_GRAPH
+TEST(InferenceSessionTests, TestCudaGraphCaptureAndReplay) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestCudaGraphCaptureAndReplay";
+  InferenceSession session_object{so, GetEnvironment()};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.enable_cuda_graph = true;
+  ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(onnxruntime::make_unique<CUDAExecutionProvider>(epi)));
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto gpu_allocator = TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  GPUDataTransfer data_transfer;
+
+  // the graph bakes in the device addresses, so feeds and fetches stay fixed across Runs.
+  std::vector<float> values_a = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f};
+  OrtValue cpu_a, cpu_b, gpu_a, gpu_b, gpu_y;
+  CreateMLValue<float>(cpu_allocator, {3, 4}, values_a, &cpu_a);
+  CreateMLValue<float>(cpu_allocator, {4, 3}, values_a, &cpu_b);
+  AllocateMLValue<float>(gpu_allocator, {3, 4}, &gpu_a);
+  AllocateMLValue<float>(gpu_allocator, {4, 3}, &gpu_b);
+  AllocateMLValue<float>(gpu_allocator, {3, 3}, &gpu_y);
+  ASSERT_STATUS_OK(data_transfer.CopyTensor(cpu_a.Get<Tensor>(), *gpu_a.GetMutable<Tensor>(), 0));
+  ASSERT_STATUS_OK(data_transfer.CopyTensor(cpu_b.Get<Tensor>(), *gpu_b.GetMutable<Tensor>(), 0));
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+  ASSERT_STATUS_OK(io_binding->BindInput("A", gpu_a));
+  ASSERT_STATUS_OK(io_binding->BindInput("B", gpu_b));
+  ASSERT_STATUS_OK(io_binding->BindOutput("Y", gpu_y));
+
+  auto verify_output = [&](const std::vector<float>& expected_values) {
+    ASSERT_STATUS_OK(TestCudaExecutionProvider()->Sync());
+    OrtValue cpu_y;
+    AllocateMLValue<float>(cpu_allocator, {3, 3}, &cpu_y);
+    ASSERT_STATUS_OK(data_transfer.CopyTensor(io_binding->GetOutputs()[0].Get<Tensor>(), *cpu_y.GetMutable<Tensor>(), 0));
+    VerifyOutputs({cpu_y}, {3, 3}, expected_values);
+  };
+
+  // warm up, capture, replay
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_STATUS_OK(session_object.Run(*io_binding));
+    verify_output({42, 48, 54, 114, 136, 158, 186, 224, 262});
+  }
+
+  // update the content of a feed in place. the replayed graph must pick up the new values.
+  std::vector<float> ones(12, 1.0f);
+  CreateMLValue<float>(cpu_allocator, {3, 4}, ones, &cpu_a);
+  ASSERT_STATUS_OK(data_transfer.CopyTensor(cpu_a.Get<Tensor>(), *gpu_a.GetMutable<Tensor>(), 0));
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  verify_output({18, 22, 26, 18, 22, 26, 18, 22, 26});
+}
+#endif  // ENABLE_CUDA_GRAPH
+
 #endif
 
 TEST(InferenceSessionTests, ModelWithoutOpset) {
@@ -1101,6 +1720,226 @@ TEST(InferenceSessionTests, TestOptionalInputs) {
   }
 }
 
+// a graph output produced by an aliasing kernel such as Flatten is a view of its input and stays valid after the
+// session is released
+TEST(InferenceSessionTests, AliasedGraphOutputOutlivesSession) {
+  onnxruntime::Model model("aliased_output", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& abs = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("abs", "Abs", "", {&x}, {&abs});
+  auto& flatten = graph.AddNode("flatten", "Flatten", "", {&abs}, {&y});
+  flatten.AddAttribute("axis", static_cast<int64_t>(0));
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  const std::string model_file_name = "aliased_graph_output.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  std::vector<OrtValue> fetches;
+  {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.AliasedGraphOutputOutlivesSession";
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_file_name));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    OrtValue ml_value_x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                         {-1.0f, 2.0f, -3.0f, 4.0f, -5.0f, 6.0f}, &ml_value_x);
+    NameMLValMap feeds{{"X", ml_value_x}};
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, {"Y"}, &fetches));
+  }
+
+  ASSERT_EQ(fetches.size(), 1u);
+  const auto& y_tensor = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y_tensor.Shape(), TensorShape({1, 6}));
+  const std::vector<float> expected{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  EXPECT_EQ(std::vector<float>(y_tensor.Data<float>(), y_tensor.Data<float>() + 6), expected);
+
+  std::remove(model_file_name.c_str());
+}
+
+// the tensors of sequence outputs don't live in the temp space the execution frame serves from its memory pattern
+TEST(InferenceSessionTests, SequenceOutputsOutliveExecutionFrame) {
+  onnxruntime::Model model("sequence_outputs", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& abs = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& split = graph.GetOrCreateNodeArg("S", nullptr);
+  auto& construct = graph.GetOrCreateNodeArg("C", nullptr);
+  graph.AddNode("abs", "Abs", "", {&x}, {&abs});
+  graph.AddNode("split", "SplitToSequence", "", {&abs}, {&split});
+  graph.AddNode("construct", "SequenceConstruct", "", {&abs, &x}, {&construct});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SequenceOutputsOutliveExecutionFrame";
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(serialized_model);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // the second Run with the same shapes executes with the memory pattern of the first one
+  std::vector<OrtValue> fetches;
+  for (float sign : {1.0f, -1.0f}) {
+    OrtValue ml_value_x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                         {sign * 1.0f, sign * -2.0f, sign * 3.0f, sign * -4.0f, sign * 5.0f, sign * -6.0f},
+                         &ml_value_x);
+    NameMLValMap feeds{{"X", ml_value_x}};
+    fetches.clear();
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, {"S", "C"}, &fetches));
+  }
+
+  ASSERT_EQ(fetches.size(), 2u);
+  const auto& split_seq = fetches[0].Get<TensorSeq>();
+  ASSERT_EQ(split_seq.Size(), 2u);
+  EXPECT_EQ(split_seq.Get(0).Shape(), TensorShape({1, 3}));
+  EXPECT_EQ(std::vector<float>(split_seq.Get(0).Data<float>(), split_seq.Get(0).Data<float>() + 3),
+            (std::vector<float>{1.0f, 2.0f, 3.0f}));
+  EXPECT_EQ(std::vector<float>(split_seq.Get(1).Data<float>(), split_seq.Get(1).Data<float>() + 3),
+            (std::vector<float>{4.0f, 5.0f, 6.0f}));
+
+  const auto& construct_seq = fetches[1].Get<TensorSeq>();
+  ASSERT_EQ(construct_seq.Size(), 2u);
+  EXPECT_EQ(std::vector<float>(construct_seq.Get(0).Data<float>(), construct_seq.Get(0).Data<float>() + 6),
+            (std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+  EXPECT_EQ(std::vector<float>(construct_seq.Get(1).Data<float>(), construct_seq.Get(1).Data<float>() + 6),
+            (std::vector<float>{-1.0f, 2.0f, -3.0f, 4.0f, -5.0f, 6.0f}));
+}
+
+// the feeds are padded to the bucket of their symbolic dimension, with the fetches sized like the C API does
+TEST(InferenceSessionTests, PadBucketsWithUnallocatedFetches) {
+  onnxruntime::Model model("pad_buckets", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("seq");
+
+  // Y is sliced back to the size of X, while the shape of the input the graph executed with isn't
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& executed_shape = graph.GetOrCreateNodeArg("ExecutedShape", nullptr);
+  graph.AddNode("abs", "Abs", "", {&x}, {&y});
+  graph.AddNode("shape", "Shape", "", {&x}, {&executed_shape});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PadBucketsWithUnallocatedFetches";
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigPadBuckets, "seq:4,8"));
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(serialized_model);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3}, {-1.0f, 2.0f, -3.0f},
+                       &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<OrtValue> fetches(2);
+  ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, {"Y", "ExecutedShape"}, &fetches));
+
+  ASSERT_EQ(fetches.size(), 2u);
+  const auto& executed_shape_tensor = fetches[1].Get<Tensor>();
+  ASSERT_EQ(executed_shape_tensor.Shape().Size(), 1);
+  EXPECT_EQ(executed_shape_tensor.Data<int64_t>()[0], 4);
+
+  const auto& y_tensor = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y_tensor.Shape(), TensorShape({3}));
+  EXPECT_EQ(std::vector<float>(y_tensor.Data<float>(), y_tensor.Data<float>() + 3),
+            (std::vector<float>{1.0f, 2.0f, 3.0f}));
+}
+
+// the outputs of the nodes that only depend on the sticky input are reused by the Runs with the same sticky contents
+TEST(InferenceSessionTests, StickyInputsMemoizeNodeResults) {
+  onnxruntime::Model model("sticky_inputs", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& s = graph.GetOrCreateNodeArg("S", &float_tensor);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& abs = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& abs_node = graph.AddNode("abs", "Abs", "", {&s}, {&abs});
+  auto& add_node = graph.AddNode("add", "Add", "", {&abs, &x}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StickyInputsMemoizeNodeResults";
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigStickyInputs, "S"));
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  std::stringstream model_stream(serialized_model);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const auto& session_state = session_object.GetSessionState();
+  const auto* cache = session_state.GetNodeResultCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_NE(cache->GetMemoizedOutputs(abs_node.Index()), nullptr);
+  EXPECT_EQ(cache->GetMemoizedOutputs(add_node.Index()), nullptr);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue ml_value_s;
+  CreateMLValue<float>(allocator, {4}, {-1.0f, 2.0f, -3.0f, 4.0f}, &ml_value_s);
+  int s_idx;
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("S", s_idx));
+
+  auto run = [&](const std::vector<float>& x_values, const std::vector<float>& expected) {
+    OrtValue ml_value_x;
+    CreateMLValue<float>(allocator, {4}, x_values, &ml_value_x);
+    NameMLValMap feeds{{"S", ml_value_s}, {"X", ml_value_x}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, {"Y"}, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& y_tensor = fetches[0].Get<Tensor>();
+    EXPECT_EQ(std::vector<float>(y_tensor.Data<float>(), y_tensor.Data<float>() + 4), expected);
+
+    NodeResultCache::Key key;
+    ASSERT_TRUE(cache->GetKey({s_idx}, {ml_value_s}, key));
+    auto results = cache->Lookup(key);
+    ASSERT_NE(results, nullptr);
+    EXPECT_EQ(results->count(abs_node.Index()), 1u);
+  };
+
+  run({1.0f, 1.0f, 1.0f, 1.0f}, {2.0f, 3.0f, 4.0f, 5.0f});
+  run({0.0f, 1.0f, 2.0f, 3.0f}, {1.0f, 3.0f, 5.0f, 7.0f});
+
+  // the new contents of the same buffer are computed again
+  float* s_data = ml_value_s.GetMutable<Tensor>()->MutableData<float>();
+  s_data[0] = -10.0f;
+  run({0.0f, 1.0f, 2.0f, 3.0f}, {10.0f, 3.0f, 5.0f, 7.0f});
+}
+
 TEST(ExecutionProviderTest, FunctionTest) {
   onnxruntime::Model model("graph_1", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
   auto& graph = model.MainGraph();
@@ -2208,6 +3047,30 @@ TEST(InferenceSessionTests, CheckIfPerSessionThreadPoolsAreBeingUsed) {
   RunModel(session_object, run_options);
 }
 
+// the intra-op thread pool gets one thread per entry of the affinity list unless the number of threads is set
+TEST(InferenceSessionTests, IntraOpThreadAffinities) {
+  SessionOptions so;
+  so.session_logid = "IntraOpThreadAffinities";
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, "0,0"));
+
+  InferenceSessionTestGlobalThreadPools session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+#ifndef _OPENMP
+  auto* intra_tp = session_object.GetIntraOpThreadPoolToUse();
+  ASSERT_NE(intra_tp, nullptr);
+  ASSERT_EQ(concurrency::ThreadPool::DegreeOfParallelism(intra_tp), 2);
+#endif
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+
+  SessionOptions invalid_so;
+  ASSERT_STATUS_OK(invalid_so.AddConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, "0,-1"));
+  ASSERT_THROW(InferenceSession(invalid_so, GetEnvironment()), OnnxRuntimeException);
+}
+
 // Test 2: env created with global tp / DONT use per session tp: in this case global tps should be in use
 TEST(InferenceSessionTests, CheckIfGlobalThreadPoolsAreBeingUsed) {
   SessionOptions so;
@@ -4,6 +4,9 @@
 #include <gtest/gtest.h>
 #include <core/framework/kernel_registry.h>
 #include <core/framework/op_kernel.h>
+#include <core/graph/model.h>
+#include "asserts.h"
+#include "test/test_environment.h"
 
 using namespace onnxruntime;
 static Status RegKernels(KernelRegistry& r, std::vector<std::unique_ptr<KernelDef> >& function_table, const KernelCreateFn& kernel_creator) {
@@ -101,4 +104,50 @@ TEST(KernelRegistryTests, two_versions4) {
   function_table.emplace_back(KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).SetName("Elu").SetDomain("").SinceVersion(6,7).Provider(kCpuExecutionProvider).Build());
   Status st;
   ASSERT_FALSE((st = RegKernels(r, function_table, CreateFakeKernel)).IsOK());
-}
\ No newline at end of file
+}
+
+// Lookups by node signature and by kernel def hash find the kernel matching the types of the node.
+TEST(KernelRegistryTests, find_kernel) {
+  KernelRegistry r;
+  std::vector<std::unique_ptr<KernelDef> > function_table;
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  ASSERT_STATUS_OK(RegKernels(r, function_table, CreateFakeKernel));
+
+  Model model("find_kernel", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}}, {}, test::DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  auto add_elu = [&graph](const std::string& name, ONNX_NAMESPACE::TensorProto_DataType elem_type) -> Node& {
+    ONNX_NAMESPACE::TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    auto& input = graph.GetOrCreateNodeArg(name + "_in", &type);
+    auto& output = graph.GetOrCreateNodeArg(name + "_out", &type);
+    return graph.AddNode(name, "Elu", name, {&input}, {&output});
+  };
+  Node& float_node = add_elu("float_elu", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  Node& double_node = add_elu("double_elu", ONNX_NAMESPACE::TensorProto_DataType_DOUBLE);
+  Node& half_node = add_elu("half_elu", ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  const KernelCreateInfo* float_info = nullptr;
+  const KernelCreateInfo* double_info = nullptr;
+  ASSERT_STATUS_OK(r.TryFindKernel(float_node, kCpuExecutionProvider, &float_info));
+  ASSERT_STATUS_OK(r.TryFindKernel(double_node, kCpuExecutionProvider, &double_info));
+  ASSERT_NE(float_info, double_info);
+  EXPECT_EQ(float_info->kernel_def->TypeConstraints().at("T")[0], DataTypeImpl::GetTensorType<float>());
+  EXPECT_EQ(double_info->kernel_def->TypeConstraints().at("T")[0], DataTypeImpl::GetTensorType<double>());
+
+  // the second lookup of the same signature is served by the cache
+  const KernelCreateInfo* info = nullptr;
+  ASSERT_STATUS_OK(r.TryFindKernel(float_node, kCpuExecutionProvider, &info));
+  EXPECT_EQ(info, float_info);
+
+  // no kernel for the types of the node, or for another provider
+  EXPECT_FALSE(r.TryFindKernel(half_node, kCpuExecutionProvider, &info).IsOK());
+  EXPECT_FALSE(r.TryFindKernel(float_node, kCudaExecutionProvider, &info).IsOK());
+
+  ASSERT_STATUS_OK(r.TryFindKernel(double_node, kCpuExecutionProvider, double_info->kernel_def->GetHash(), &info));
+  EXPECT_EQ(info, double_info);
+  EXPECT_FALSE(r.TryFindKernel(float_node, kCudaExecutionProvider, float_info->kernel_def->GetHash(), &info).IsOK());
+  EXPECT_FALSE(r.TryFindKernel(float_node, kCpuExecutionProvider, uint64_t(8), &info).IsOK());
+}
@@ -34,5 +34,40 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024u + 256u + 512u);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024u);
 }
+
+TEST(MemPatternPlannerTest, BestFitTest) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, 1024);
+  planner.TraceAllocation(1, 256);
+  planner.TraceAllocation(2, 512);
+  planner.TraceAllocation(3, 1024);
+
+  // all the blocks are alive together, so there's nothing to improve over the traced offsets
+  auto pattern = planner.GenerateBestFitMemPattern();
+  EXPECT_EQ(pattern.PeakSize(), 1024u + 256u + 512u + 1024u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 1024u);
+
+  planner.TraceFree(1);
+  planner.TraceAllocation(4, 512);
+  planner.TraceFree(3);
+  planner.TraceAllocation(5, 600);
+  planner.TraceAllocation(6, 200);
+
+  // the traced offsets need 1024 + 256 + 512 + 1024 + 512 bytes. placing the largest blocks first the peak is the
+  // size of the blocks alive after the allocation of 4.
+  pattern = planner.GenerateBestFitMemPattern();
+
+  EXPECT_EQ(pattern.PeakSize(), 1024u + 512u + 1024u + 512u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 1024u);
+  EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024u);  // 3 is freed before 5 is allocated
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 1024u + 1024u);
+  EXPECT_EQ(pattern.GetBlock(4)->offset_, 1024u + 1024u + 512u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 1024u + 1024u + 512u);  // 1 is freed before 4 is allocated
+  EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024u + 600u);
+
+  // the traced offsets are unchanged
+  EXPECT_EQ(planner.GenerateMemPattern().PeakSize(), 1024u + 256u + 512u + 1024u + 512u);
+}
 }  // namespace test
 }  // namespace onnxruntime
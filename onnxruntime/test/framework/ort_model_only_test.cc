@@ -6,6 +6,7 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 #include "core/graph/model.h"
@@ -19,6 +20,10 @@
 
 #include "gtest/gtest.h"
 
+#if !defined(_WIN32)
+#include <dirent.h>
+#endif
+
 using namespace std;
 using namespace ONNX_NAMESPACE;
 using namespace onnxruntime::logging;
@@ -264,6 +269,169 @@ TEST(OrtModelOnlyTests, SerializeToOrtFormat) {
   RunOrtModel(test_info);
 }
 
+// the MatMul kernel shares the buffer it packs its constant B into, so the buffer can be saved in the model and used
+// instead of packing B again when the model is loaded.
+TEST(OrtModelOnlyTests, SerializePrePackedWeights) {
+  const std::basic_string<ORTCHAR_T> ort_file = ORT_TSTR("matmul_1_prepacked.onnx.ort");
+  {
+    SessionOptions so;
+    so.session_logid = "SerializePrePackedWeights";
+    so.optimized_model_filepath = ort_file;
+    ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigSavePrePackedWeights, "1"));
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load("testdata/matmul_1.onnx"));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  }
+
+  std::string model_bytes;
+  ASSERT_TRUE(flatbuffers::LoadFile(ToMBString(ort_file).c_str(), true, &model_bytes));
+  const auto* fbs_session_state =
+      experimental::fbs::GetInferenceSession(model_bytes.data())->session_state();
+  ASSERT_NE(fbs_session_state->prepacked_weights(), nullptr);
+  ASSERT_EQ(fbs_session_state->prepacked_weights()->size(), 1u);
+  ASSERT_EQ(fbs_session_state->prepacked_weights_signature()->str(), MlasGetPlatformSignature());
+
+  auto run = [&ort_file](bool map_file, bool expect_copied_weights) {
+    SessionOptions so;
+    so.session_logid = "LoadPrePackedWeights";
+    if (map_file) {
+      ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigMapOrtModelInitializers, "1"));
+    }
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ort_file));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    // B is released as the kernel uses the saved buffer
+    const auto& session_state = session_object.GetSessionState();
+    EXPECT_TRUE(session_state.GetConstantInitializedTensors().empty());
+    EXPECT_EQ(session_state.GetOwnedPrePackedBytes().size(), expect_copied_weights ? 1u : 0u);
+
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                         {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(feeds, {"Y"}, &fetches));
+
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape({3, 1}));
+    EXPECT_EQ(std::vector<float>(output.Data<float>(), output.Data<float>() + 3),
+              (std::vector<float>{5.f, 11.f, 17.f}));
+  };
+
+  run(false, true);
+#if !defined(_WIN32)
+  // the buffer is used in place from the mapped file
+  run(true, false);
+#endif
+}
+
+// models saved by this version align the initializer data so it can be used in place from the mapped file.
+// Env::MapFileIntoMemory is not implemented on Windows, where the loader falls back to copying.
+// The optimized model cache test below lists the cache directory with POSIX APIs.
+#if !defined(_WIN32)
+TEST(OrtModelOnlyTests, SerializeToOrtFormatAndMapInitializers) {
+  const std::basic_string<ORTCHAR_T> ort_file = ORT_TSTR("ort_github_issue_4031_mapped.onnx.ort");
+  SaveAndCompareModels("testdata/ort_github_issue_4031.onnx", ort_file);
+
+  SessionOptions so;
+  so.session_logid = "SerializeToOrtFormatAndMapInitializers";
+  so.AddConfigEntry(kOrtSessionOptionsConfigMapOrtModelInitializers, "1");
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(ort_file));
+
+  // the initializers should refer to the model file rather than hold a copy of the data
+  const auto& initializers = session_object.GetGraph().GetAllInitializedTensors();
+  ASSERT_FALSE(initializers.empty());
+  for (const auto& initializer : initializers) {
+    ASSERT_EQ(initializer.second->data_location(), ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL)
+        << initializer.first;
+  }
+
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {123.f},
+                       &ml_value);
+  NameMLValMap feeds{{"state_var_in", ml_value}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(feeds, {"state_var_out"}, &fetches));
+
+  const auto& output = fetches[0].Get<Tensor>();
+  ASSERT_TRUE(output.Shape().Size() == 1);
+  ASSERT_TRUE(output.Data<float>()[0] == 125.f);
+}
+
+static std::vector<std::string> GetOrtFilesInFolder(const std::string& folder) {
+  std::vector<std::string> files;
+  DIR* dir = opendir(folder.c_str());
+  if (dir != nullptr) {
+    while (const struct dirent* entry = readdir(dir)) {
+      std::string name(entry->d_name);
+      if (name.size() > 4 && name.compare(name.size() - 4, 4, ".ort") == 0) {
+        files.push_back(folder + "/" + name);
+      }
+    }
+    closedir(dir);
+  }
+  return files;
+}
+
+static void RunWithOptimizedModelCache(const std::string& cache_dir, TransformerLevel level) {
+  SessionOptions so;
+  so.session_logid = "OptimizedModelCache";
+  so.graph_optimization_level = level;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir, cache_dir.c_str()));
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load("testdata/ort_github_issue_4031.onnx"));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {123.f},
+                       &ml_value);
+  NameMLValMap feeds{{"state_var_in", ml_value}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(feeds, {"state_var_out"}, &fetches));
+
+  const auto& output = fetches[0].Get<Tensor>();
+  ASSERT_TRUE(output.Shape().Size() == 1);
+  ASSERT_TRUE(output.Data<float>()[0] == 125.f);
+}
+
+TEST(OrtModelOnlyTests, OptimizedModelCache) {
+  const std::string cache_dir = "optimized_model_cache_test";
+  if (Env::Default().FolderExists(cache_dir)) {
+    ASSERT_STATUS_OK(Env::Default().DeleteFolder(ToPathString(cache_dir)));
+  }
+  ASSERT_STATUS_OK(Env::Default().CreateFolder(cache_dir));
+
+  // the first session saves the optimized model and the second one loads it
+  RunWithOptimizedModelCache(cache_dir, TransformerLevel::Level2);
+  auto files = GetOrtFilesInFolder(cache_dir);
+  ASSERT_EQ(files.size(), 1u);
+  RunWithOptimizedModelCache(cache_dir, TransformerLevel::Level2);
+  ASSERT_EQ(GetOrtFilesInFolder(cache_dir).size(), 1u);
+
+  // a different optimization level uses a different entry
+  RunWithOptimizedModelCache(cache_dir, TransformerLevel::Level1);
+  ASSERT_EQ(GetOrtFilesInFolder(cache_dir).size(), 2u);
+
+  // an invalid entry is replaced
+  size_t valid_size = 0;
+  ASSERT_STATUS_OK(Env::Default().GetFileLength(ToPathString(files[0]).c_str(), valid_size));
+  {
+    std::ofstream corrupted(files[0], std::ios::binary | std::ios::trunc);
+    corrupted << "not an ORT format model";
+  }
+  RunWithOptimizedModelCache(cache_dir, TransformerLevel::Level2);
+  size_t replaced_size = 0;
+  ASSERT_STATUS_OK(Env::Default().GetFileLength(ToPathString(files[0]).c_str(), replaced_size));
+  ASSERT_EQ(replaced_size, valid_size);
+
+  ASSERT_STATUS_OK(Env::Default().DeleteFolder(ToPathString(cache_dir)));
+}
+#endif  // !defined(_WIN32)
+
 #if !defined(DISABLE_ML_OPS)
 TEST(OrtModelOnlyTests, SerializeToOrtFormatMLOps) {
   const std::basic_string<ORTCHAR_T> ort_file = ORT_TSTR("sklearn_bin_voting_classifier_soft_converted.ort");
@@ -3,10 +3,13 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
 
+#include <cstdio>
+
 #include "gtest/gtest.h"
 
 using namespace ONNX_NAMESPACE;
@@ -145,5 +148,77 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                         testing::Values(1, 0));
+
+TEST(ParallelExecutor, TestTrivialKernelDef) {
+  auto kernel_def = KernelDefBuilder().SetName("Reshape").Provider(kCpuExecutionProvider).SinceVersion(5).Build();
+  auto trivial_kernel_def =
+      KernelDefBuilder().SetName("Reshape").Provider(kCpuExecutionProvider).SinceVersion(5).Trivial().Build();
+  EXPECT_FALSE(kernel_def->IsTrivial());
+  EXPECT_TRUE(trivial_kernel_def->IsTrivial());
+
+  // the kernel lookup by hash is not affected
+  EXPECT_EQ(kernel_def->GetHash(), trivial_kernel_def->GetHash());
+}
+
+// the trivial Identity and Shape nodes made ready by the first Add are run inline by the thread that ran it
+TEST(ParallelExecutor, TestTrivialNodesRunInline) {
+  onnxruntime::Model model("trivial_nodes", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& c = graph.GetOrCreateNodeArg("C", &float_tensor);
+  auto& shape = graph.GetOrCreateNodeArg("S", &int64_tensor);
+  graph.AddNode("add_0", "Add", "", {&x, &x}, {&a});
+  graph.AddNode("identity", "Identity", "", {&a}, {&b});
+  graph.AddNode("shape", "Shape", "", {&a}, {&shape});
+  graph.AddNode("add_1", "Add", "", {&a, &b}, {&c});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  const std::string model_file_name = "parallel_executor_trivial_nodes.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.TestTrivialNodesRunInline";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  // keep the Identity node
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3}, {1.0f, 2.0f, 3.0f},
+                       &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<std::string> output_names{"C", "S"};
+  std::vector<OrtValue> fetches;
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 2u);
+
+    const auto& c_tensor = fetches[0].Get<Tensor>();
+    ASSERT_EQ(c_tensor.Shape().Size(), 3);
+    EXPECT_EQ(c_tensor.Data<float>()[0], 4.0f);
+    EXPECT_EQ(c_tensor.Data<float>()[1], 8.0f);
+    EXPECT_EQ(c_tensor.Data<float>()[2], 12.0f);
+
+    const auto& shape_tensor = fetches[1].Get<Tensor>();
+    ASSERT_EQ(shape_tensor.Shape().Size(), 1);
+    EXPECT_EQ(shape_tensor.Data<int64_t>()[0], 3);
+  }
+
+  std::remove(model_file_name.c_str());
+}
 }  // namespace test
 }  // namespace onnxruntime
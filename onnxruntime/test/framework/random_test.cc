@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/framework/philox.h"
 #include "core/framework/random_seed.h"
 #include "core/framework/random_generator.h"
 #include "gtest/gtest.h"
@@ -54,5 +55,34 @@ TEST(RandomTest, PhiloxGeneratorTest) {
   ASSERT_EQ(seeds.second, 0);
 }
 
+TEST(RandomTest, PhiloxKnownAnswerTest) {
+  // known answer tests of the Random123 library
+  uint32_t block[4];
+  Philox4x32x10::Generate(0, 0, 0, block);
+  ASSERT_EQ(block[0], 0x6627e8d5u);
+  ASSERT_EQ(block[1], 0xe169c58du);
+  ASSERT_EQ(block[2], 0xbc57ac4cu);
+  ASSERT_EQ(block[3], 0x9b00dbd8u);
+
+  Philox4x32x10::Generate(~0ull, ~0ull, ~0ull, block);
+  ASSERT_EQ(block[0], 0x408f276du);
+  ASSERT_EQ(block[1], 0x41c83b0eu);
+  ASSERT_EQ(block[2], 0xa20bc7c6u);
+  ASSERT_EQ(block[3], 0x6d5451fdu);
+
+  Philox4x32x10::Generate(0x299f31d0a4093822ull, 0x85a308d3243f6a88ull, 0x0370734413198a2eull, block);
+  ASSERT_EQ(block[0], 0xd16cfe09u);
+  ASSERT_EQ(block[1], 0x94fdccebu);
+  ASSERT_EQ(block[2], 0x5001e420u);
+  ASSERT_EQ(block[3], 0x24126ea1u);
+}
+
+TEST(RandomTest, PhiloxToFloatTest) {
+  ASSERT_EQ(Philox4x32x10::ToFloat(0), 0.0f);
+  ASSERT_LT(Philox4x32x10::ToFloat(~0u), 1.0f);
+  ASSERT_EQ(Philox4x32x10::ToDouble(0, 0), 0.0);
+  ASSERT_LT(Philox4x32x10::ToDouble(~0u, ~0u), 1.0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/sampling_profiler.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace profiling {
+namespace test {
+
+TEST(LatencyHistogramTest, BucketBounds) {
+  // every duration falls in a bucket whose upper bound is at most 1/8 above it
+  for (uint64_t ns : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, (1ull << 40) - 1}) {
+    const size_t bucket = LatencyHistogram::BucketIndex(ns);
+    ASSERT_LT(bucket, LatencyHistogram::kNumBuckets);
+    const uint64_t upper_bound = LatencyHistogram::BucketUpperBoundNs(bucket);
+    EXPECT_GE(upper_bound, ns);
+    EXPECT_LE(upper_bound - ns, ns / LatencyHistogram::kSubBuckets) << ns;
+    if (bucket > 0) {
+      EXPECT_LT(LatencyHistogram::BucketUpperBoundNs(bucket - 1), ns) << ns;
+    }
+  }
+
+  EXPECT_EQ(LatencyHistogram::BucketIndex(std::numeric_limits<uint64_t>::max()), LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 100; ++i) {
+    histogram.Record(i * 1000);
+  }
+
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 100u);
+  EXPECT_EQ(snapshot.MeanNs(), 50500u);
+  EXPECT_EQ(snapshot.max_ns, 100000u);
+  EXPECT_EQ(snapshot.PercentileNs(100), 100000u);
+
+  for (double percentile : {50.0, 90.0, 99.0}) {
+    const double expected = percentile * 1000;
+    const double actual = static_cast<double>(snapshot.PercentileNs(percentile));
+    EXPECT_GE(actual, expected) << percentile;
+    EXPECT_LE(actual, expected * (1.0 + 1.0 / LatencyHistogram::kSubBuckets)) << percentile;
+  }
+
+  LatencyHistogram other;
+  other.Record(1000000);
+  snapshot.Merge(other.GetSnapshot());
+  EXPECT_EQ(snapshot.count, 101u);
+  EXPECT_EQ(snapshot.max_ns, 1000000u);
+  EXPECT_EQ(snapshot.PercentileNs(100), 1000000u);
+}
+
+TEST(SamplingProfilerTest, SampleRate) {
+  SamplingProfiler profiler(2, 3);
+  int sampled = 0;
+  for (int i = 0; i < 9; ++i) {
+    if (profiler.ShouldSample()) {
+      ++sampled;
+      profiler.RecordNode(0, std::chrono::microseconds(10));
+    }
+  }
+
+  EXPECT_EQ(sampled, 3);
+  EXPECT_EQ(profiler.SampledRuns(), 3u);
+  EXPECT_EQ(profiler.SampleRate(), 3u);
+
+  // out of range node indices are ignored
+  profiler.RecordNode(2, std::chrono::microseconds(10));
+}
+
+TEST(SamplingProfileReportTest, ToJson) {
+  SamplingProfileReport report;
+  report.sample_rate = 10;
+  report.sampled_runs = 1;
+
+  LatencyHistogram histogram;
+  histogram.Record(2000);
+
+  LatencyStatistics statistics;
+  statistics.name = "node \"1\"";
+  statistics.op_type = "Add";
+  statistics.provider = "CPUExecutionProvider";
+  statistics.histogram = histogram.GetSnapshot();
+  report.nodes.push_back(statistics);
+  report.op_types["Add"] = statistics.histogram;
+
+  const std::string expected =
+      "{\n"
+      "\"sample_rate\": 10,\n"
+      "\"sampled_runs\": 1,\n"
+      "\"nodes\": [\n"
+      "{\"name\": \"node \\\"1\\\"\", \"op_type\": \"Add\", \"provider\": \"CPUExecutionProvider\", \"count\": 1, "
+      "\"mean_us\": 2.000, \"p50_us\": 2.000, \"p90_us\": 2.000, \"p99_us\": 2.000, \"max_us\": 2.000}\n"
+      "],\n"
+      "\"op_types\": [\n"
+      "{\"op_type\": \"Add\", \"count\": 1, "
+      "\"mean_us\": 2.000, \"p50_us\": 2.000, \"p90_us\": 2.000, \"p99_us\": 2.000, \"max_us\": 2.000}\n"
+      "]\n"
+      "}\n";
+  EXPECT_EQ(report.ToJson(), expected);
+}
+
+}  // namespace test
+}  // namespace profiling
+}  // namespace onnxruntime
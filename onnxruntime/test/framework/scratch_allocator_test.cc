@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "core/framework/scratch_allocator.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ScratchAllocatorTest, TracesPeakWithoutBuffer) {
+  auto cpu_allocator = std::make_shared<CPUAllocator>();
+  ScratchAllocator a(cpu_allocator, nullptr, 0);
+  EXPECT_EQ(a.Info(), cpu_allocator->Info());
+
+  // every allocation falls back to the underlying allocator
+  void* p1 = a.Alloc(100);
+  void* p2 = a.Alloc(1000);
+  ASSERT_NE(p1, nullptr);
+  ASSERT_NE(p2, nullptr);
+  EXPECT_EQ(a.Alloc(0), nullptr);
+  a.Free(p2);
+  a.Free(p1);
+  EXPECT_EQ(a.PeakSize(), 128u + 1024u);
+
+  // the offsets restart once everything is freed
+  void* p3 = a.Alloc(500);
+  a.Free(p3);
+  EXPECT_EQ(a.PeakSize(), 128u + 1024u);
+}
+
+TEST(ScratchAllocatorTest, ReusesBufferBetweenNodes) {
+  auto cpu_allocator = std::make_shared<CPUAllocator>();
+  std::vector<char> buffer(1024 + ScratchAllocator::kAlignment);
+  char* start = buffer.data();
+  ScratchAllocator a(cpu_allocator, start, 1024);
+
+  // first node
+  void* p1 = a.Alloc(100);
+  void* p2 = a.Alloc(200);
+  EXPECT_EQ(p1, start);
+  EXPECT_EQ(p2, start + 128);
+  a.Free(p1);
+  a.Free(p2);
+
+  // second node starts from the beginning of the buffer again
+  void* p3 = a.Alloc(1000);
+  EXPECT_EQ(p3, start);
+
+  // doesn't fit while p3 is alive
+  void* p4 = a.Alloc(64);
+  ASSERT_NE(p4, nullptr);
+  EXPECT_TRUE(p4 < start || p4 >= start + 1024);
+  a.Free(p4);
+  a.Free(p3);
+
+  EXPECT_EQ(a.PeakSize(), 1024u + 64u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
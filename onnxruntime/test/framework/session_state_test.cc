@@ -1,12 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
 #include <iostream>
 
 #include "core/framework/execution_providers.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/prepacked_weights_container.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
@@ -15,6 +17,7 @@
 #include "core/util/thread_utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "asserts.h"
+#include "file_util.h"
 #include "gtest/gtest.h"
 #include "test/test_environment.h"
 
@@ -271,5 +274,419 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStatePrepackingTest, testing::Values(true, false));
 
+class ParallelPrePackingTestOpKernel : public OpKernel {
+ public:
+  ParallelPrePackingTestOpKernel(const OpKernelInfo& info) : OpKernel(info) {
+    ++num_kernels;
+  }
+
+  Status Compute(OpKernelContext* context) const override {
+    ORT_UNUSED_PARAMETER(context);
+    return Status::OK();
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    ++num_packs;
+    is_packed = true;
+    return Status::OK();
+  }
+
+  static std::atomic<int> num_kernels;
+  static std::atomic<int> num_packs;
+};
+
+std::atomic<int> ParallelPrePackingTestOpKernel::num_kernels{0};
+std::atomic<int> ParallelPrePackingTestOpKernel::num_packs{0};
+
+// Test that kernel creation and pre-packing on the thread pool sets up every node, and that an initializer shared
+// by several nodes is only released once all of them have packed it.
+class SessionStateParallelInitializationTest : public testing::TestWithParam<bool> {};
+TEST_P(SessionStateParallelInitializationTest, CreateKernelsAndPrePack) {
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(ParallelPrePackingTest)
+      .SetDoc("Faking Node for parallel PrePacking")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Input(2, "Input_2", "input 2", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto add_initializer = [&graph](const std::string& name) {
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.add_dims(1);
+    tensor.add_float_data(1.0f);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    tensor.set_name(name);
+    graph.AddInitializedTensor(tensor);
+  };
+
+  // a chain of nodes that each use a shared initializer and one of their own
+  constexpr int num_nodes = 64;
+  add_initializer("shared_weight");
+  auto* input_arg = &graph.GetOrCreateNodeArg("input", &type);
+  for (int i = 0; i < num_nodes; ++i) {
+    const std::string suffix = std::to_string(i);
+    add_initializer("weight_" + suffix);
+    auto& weight_arg = graph.GetOrCreateNodeArg("weight_" + suffix, &type);
+    auto& shared_weight_arg = graph.GetOrCreateNodeArg("shared_weight", &type);
+    auto& output_arg = graph.GetOrCreateNodeArg("output_" + suffix, &type);
+    onnxruntime::Node& node = graph.AddNode("node_" + suffix, "ParallelPrePackingTest", "node " + suffix,
+                                            {input_arg, &weight_arg, &shared_weight_arg}, {&output_arg});
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+    input_arg = &output_arg;
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionState session_state(graph,
+                             execution_providers,
+                             true, /*enable_mem_pattern*/
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler);
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def =
+      KernelDefBuilder().SetName("ParallelPrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](const OpKernelInfo& info) -> OpKernel* { return new ParallelPrePackingTestOpKernel(info); })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  SessionOptions sess_options;
+  bool disable_parallel_initialization = GetParam();
+  sess_options.session_configurations[kOrtSessionOptionsConfigDisableParallelInitialization] =
+      disable_parallel_initialization ? "1" : "0";
+  ParallelPrePackingTestOpKernel::num_kernels = 0;
+  ParallelPrePackingTestOpKernel::num_packs = 0;
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager,
+                                                      sess_options));
+
+  ASSERT_EQ(ParallelPrePackingTestOpKernel::num_kernels, num_nodes);
+  ASSERT_EQ(ParallelPrePackingTestOpKernel::num_packs, 2 * num_nodes);
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_NE(session_state.GetKernel(node.Index()), nullptr);
+  }
+
+  // all the initializers were packed by all their consumers so they are released
+  ASSERT_EQ(session_state.GetConstantInitializedTensors().size(), size_t(0));
+  ASSERT_EQ(session_state.GetInitializedTensors().size(), size_t(0));
+}
+
+INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateParallelInitializationTest, testing::Values(true, false));
+
+// Test that an initializer in an external data file uses the file data in place, and that it is only pre-packed
+// when the lazy loading of external initializers is disabled.
+class SessionStateLazyExternalInitializersTest : public testing::TestWithParam<bool> {};
+TEST_P(SessionStateLazyExternalInitializersTest, PrePackExternalInitializer) {
+  OrtThreadPoolParams to;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(ExternalDataPrePackingTest)
+      .SetDoc("Faking Node for PrePacking of external data")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  FILE* fp;
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("external_initializer_XXXXXX"));
+  CreateTestFile(fp, filename);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+  const float data[] = {1.0f, 2.5f, -3.0f, 4.25f};
+  ASSERT_EQ(sizeof(data), fwrite(data, 1, sizeof(data), fp));
+  ASSERT_EQ(0, fclose(fp));
+
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& input_0_arg = graph.GetOrCreateNodeArg("node_0_input_0", &type);
+  auto& input_1_arg = graph.GetOrCreateNodeArg("node_0_input_1", &type);
+  auto& output_arg = graph.GetOrCreateNodeArg("node_0_output_0", &type);
+  onnxruntime::Node& node = graph.AddNode("node_0", "ExternalDataPrePackingTest", "node 0",
+                                          {&input_0_arg, &input_1_arg}, {&output_arg});
+  node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.add_dims(4);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.set_data_location(TensorProto_DataLocation_EXTERNAL);
+  auto* location = tensor.add_external_data();
+  location->set_key("location");
+  location->set_value(ToMBString(filename));
+  tensor.set_name("node_0_input_1");
+  graph.AddInitializedTensor(tensor);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionState session_state(graph,
+                             execution_providers,
+                             true, /*enable_mem_pattern*/
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler);
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def =
+      KernelDefBuilder().SetName("ExternalDataPrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](const OpKernelInfo& info) -> OpKernel* { return new PrePackingTestOpKernel(info); })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  SessionOptions sess_options;
+  bool lazy_load = GetParam();
+  sess_options.session_configurations[kOrtSessionOptionsConfigLazyLoadExternalInitializers] = lazy_load ? "1" : "0";
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager,
+                                                      sess_options));
+
+  const auto& const_initialized_tensors = session_state.GetConstantInitializedTensors();
+  if (!lazy_load) {
+    ASSERT_EQ(const_initialized_tensors.size(), size_t(0));
+    return;
+  }
+
+  // the initializer was not pre-packed and released
+  ASSERT_EQ(const_initialized_tensors.size(), size_t(1));
+  const Tensor& initializer = const_initialized_tensors.begin()->second.Get<Tensor>();
+  ASSERT_EQ(initializer.Shape().Size(), 4);
+  const float* initializer_data = initializer.Data<float>();
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(initializer_data[i], data[i]);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateLazyExternalInitializersTest, testing::Values(true, false));
+
+// Test that the raw data of an initializer is moved to its tensor when the initializers are removed from the graph,
+// and is left in the graph otherwise.
+class SessionStateRawDataInitializersTest : public testing::TestWithParam<bool> {};
+TEST_P(SessionStateRawDataInitializersTest, MoveRawData) {
+  OrtThreadPoolParams to;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& input_0_arg = graph.GetOrCreateNodeArg("node_0_input_0", &type);
+  auto& input_1_arg = graph.GetOrCreateNodeArg("node_0_input_1", &type);
+  auto& output_arg = graph.GetOrCreateNodeArg("node_0_output_0", &type);
+  onnxruntime::Node& node = graph.AddNode("node_0", "Add", "node 0", {&input_0_arg, &input_1_arg}, {&output_arg});
+  node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  const float data[] = {1.0f, 2.5f, -3.0f, 4.25f};
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.add_dims(4);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.set_raw_data(data, sizeof(data));
+  tensor.set_name("node_0_input_1");
+  graph.AddInitializedTensor(tensor);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionState session_state(graph,
+                             execution_providers,
+                             true, /*enable_mem_pattern*/
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler);
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  bool remove_initializers = GetParam();
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager,
+                                                      SessionOptions(),
+                                                      nullptr,
+                                                      remove_initializers));
+
+  const auto& const_initialized_tensors = session_state.GetConstantInitializedTensors();
+  ASSERT_EQ(const_initialized_tensors.size(), size_t(1));
+  const Tensor& initializer = const_initialized_tensors.begin()->second.Get<Tensor>();
+  ASSERT_EQ(initializer.Shape().Size(), 4);
+  const float* initializer_data = initializer.Data<float>();
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(initializer_data[i], data[i]);
+  }
+
+  if (remove_initializers) {
+    ASSERT_TRUE(graph.GetAllInitializedTensors().empty());
+    return;
+  }
+
+  // the raw data was copied to the tensor
+  const ONNX_NAMESPACE::TensorProto* graph_initializer = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("node_0_input_1", graph_initializer));
+  ASSERT_EQ(graph_initializer->raw_data().size(), sizeof(data));
+  ASSERT_NE(static_cast<const void*>(graph_initializer->raw_data().data()), initializer.DataRaw());
+}
+
+INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateRawDataInitializersTest, testing::Values(true, false));
+
+class SharedPrePackingTestOpKernel : public OpKernel {
+ public:
+  SharedPrePackingTestOpKernel(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override {
+    ORT_UNUSED_PARAMETER(context);
+    return Status::OK();
+  }
+
+  Status PrePackWithSharing(const Tensor& tensor, int input_idx, AllocatorPtr alloc, bool& is_packed,
+                            PrePackedWeights& prepacked_weights) override {
+    ORT_UNUSED_PARAMETER(input_idx);
+    ++num_packs;
+    void* buffer = alloc->Alloc(tensor.SizeInBytes());
+    memcpy(buffer, tensor.DataRaw(), tensor.SizeInBytes());
+    prepacked_weights.buffers_.push_back(BufferUniquePtr(buffer, BufferDeleter(alloc)));
+    prepacked_weights.buffer_sizes_.push_back(tensor.SizeInBytes());
+    is_packed = true;
+    return Status::OK();
+  }
+
+  Status UseSharedPrePackedBuffers(const Tensor& tensor, int input_idx, const PrePackedWeights& prepacked_weights,
+                                   bool& used_shared_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    packed_ = prepacked_weights.buffers_[0].get();
+    used_shared_buffers = true;
+    return Status::OK();
+  }
+
+  const void* packed_ = nullptr;
+  static int num_packs;
+};
+
+int SharedPrePackingTestOpKernel::num_packs = 0;
+
+TEST(SessionStateTest, SharedPrePackingTest) {
+  OrtThreadPoolParams to;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(SharedPrePackingTest)
+      .SetDoc("Faking Node for shared PrePacking")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  KernelRegistryManager kernel_registry_manager;
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def =
+      KernelDefBuilder().SetName("SharedPrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](const OpKernelInfo& info) -> OpKernel* { return new SharedPrePackingTestOpKernel(info); })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  PrepackedWeightsContainer container;
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionOptions sess_options;
+  SharedPrePackingTestOpKernel::num_packs = 0;
+
+  // load the same model into two session states
+  std::vector<std::unique_ptr<onnxruntime::Model>> models;
+  std::vector<std::unique_ptr<SessionState>> session_states;
+  for (int i = 0; i < 2; ++i) {
+    models.push_back(onnxruntime::make_unique<onnxruntime::Model>("graph_1", false,
+                                                                  DefaultLoggingManager().DefaultLogger()));
+    auto& graph = models.back()->MainGraph();
+
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& input_0_arg = graph.GetOrCreateNodeArg("node_0_input_0", &type);
+    auto& input_1_arg = graph.GetOrCreateNodeArg("node_0_input_1", &type);
+    auto& output_arg = graph.GetOrCreateNodeArg("node_0_output_0", &type);
+    onnxruntime::Node& node = graph.AddNode("node_0", "SharedPrePackingTest", "node 0",
+                                            {&input_0_arg, &input_1_arg}, {&output_arg});
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.add_dims(1);
+    tensor.add_float_data(1.0f);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    tensor.set_name("node_0_input_1");
+    graph.AddInitializedTensor(tensor);
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    session_states.push_back(onnxruntime::make_unique<SessionState>(graph,
+                                                                    execution_providers,
+                                                                    true, /*enable_mem_pattern*/
+                                                                    tp.get(),
+                                                                    nullptr, /*inter_op_thread_pool*/
+                                                                    dtm,
+                                                                    DefaultLoggingManager().DefaultLogger(),
+                                                                    profiler,
+                                                                    false, /*use_deterministic_compute*/
+                                                                    &container));
+    ASSERT_STATUS_OK(session_states.back()->FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                                 kernel_registry_manager,
+                                                                 sess_options));
+    ASSERT_EQ(session_states.back()->GetConstantInitializedTensors().size(), size_t(0));
+  }
+
+  // packed once, and both kernels use the single copy in the container
+  ASSERT_EQ(SharedPrePackingTestOpKernel::num_packs, 1);
+  ASSERT_EQ(container.GetNumberOfElements(), size_t(1));
+
+  const auto* kernel_0 = static_cast<const SharedPrePackingTestOpKernel*>(session_states[0]->GetKernel(0));
+  const auto* kernel_1 = static_cast<const SharedPrePackingTestOpKernel*>(session_states[1]->GetKernel(0));
+  ASSERT_NE(kernel_0->packed_, nullptr);
+  ASSERT_EQ(kernel_0->packed_, kernel_1->packed_);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "core/session/shape_buckets.h"
+#include "test_utils.h"
+#include "asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ShapeBucketsTest, ParseBuckets) {
+  shape_buckets::BucketMap buckets;
+  ASSERT_STATUS_OK(shape_buckets::ParseBuckets("seq:128,32,64,32;batch:8", buckets));
+  ASSERT_EQ(buckets.size(), 2u);
+  EXPECT_EQ(buckets["seq"], (std::vector<int64_t>{32, 64, 128}));
+  EXPECT_EQ(buckets["batch"], (std::vector<int64_t>{8}));
+
+  EXPECT_FALSE(shape_buckets::ParseBuckets("seq", buckets).IsOK());
+  EXPECT_FALSE(shape_buckets::ParseBuckets("seq:32,x", buckets).IsOK());
+  EXPECT_FALSE(shape_buckets::ParseBuckets("seq:0", buckets).IsOK());
+  EXPECT_FALSE(shape_buckets::ParseBuckets("seq:32;seq:64", buckets).IsOK());
+}
+
+TEST(ShapeBucketsTest, GetBucketSize) {
+  const std::vector<int64_t> sizes{32, 64, 128};
+  EXPECT_EQ(shape_buckets::GetBucketSize(sizes, 1), 32);
+  EXPECT_EQ(shape_buckets::GetBucketSize(sizes, 32), 32);
+  EXPECT_EQ(shape_buckets::GetBucketSize(sizes, 33), 64);
+  EXPECT_EQ(shape_buckets::GetBucketSize(sizes, 200), 200);
+}
+
+TEST(ShapeBucketsTest, PadAndSlice) {
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue value;
+  CreateMLValue<int64_t>(allocator, {2, 3}, {1, 2, 3, 4, 5, 6}, &value);
+
+  OrtValue padded;
+  ASSERT_STATUS_OK(shape_buckets::Resize(value.Get<Tensor>(), {2, 4}, allocator, padded));
+  const Tensor& padded_tensor = padded.Get<Tensor>();
+  ASSERT_EQ(padded_tensor.Shape(), TensorShape({2, 4}));
+  EXPECT_EQ(std::vector<int64_t>(padded_tensor.Data<int64_t>(), padded_tensor.Data<int64_t>() + 8),
+            (std::vector<int64_t>{1, 2, 3, 0, 4, 5, 6, 0}));
+
+  OrtValue sliced;
+  ASSERT_STATUS_OK(shape_buckets::Resize(padded_tensor, {2, 3}, allocator, sliced));
+  const Tensor& sliced_tensor = sliced.Get<Tensor>();
+  ASSERT_EQ(sliced_tensor.Shape(), TensorShape({2, 3}));
+  EXPECT_EQ(std::vector<int64_t>(sliced_tensor.Data<int64_t>(), sliced_tensor.Data<int64_t>() + 6),
+            (std::vector<int64_t>{1, 2, 3, 4, 5, 6}));
+
+  EXPECT_FALSE(shape_buckets::Resize(value.Get<Tensor>(), {6}, allocator, padded).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
+#include "core/graph/symbolic_dim.h"
 #include "test/providers/provider_test_utils.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -21,6 +22,9 @@ using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
 
+// number of times the type/shape inferencing of CountedInference_Fake ran
+static int counted_inference_runs = 0;
+
 static bool RegisterCustomSchemas() {
   OPERATOR_SCHEMA(Variable_DFS)
       .SetDoc("Input variable.")
@@ -98,6 +102,16 @@ static bool RegisterCustomSchemas() {
         fail_shape_inference("try harder");
       });
 
+  OPERATOR_SCHEMA(CountedInference_Fake)
+      .SetDoc("Identity that counts its type/shape inferencing.")
+      .Input(0, "input_1", "docstr for input_1.", "tensor(int32)")
+      .Output(0, "output_1", "docstr for output_1.", "tensor(int32)")
+      .Attr("value", "attribute the inferencing doesn't use.", AttributeProto::INT, false)
+      .TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
+        ++counted_inference_runs;
+        propagateShapeAndTypeFromFirstInput(ctx);
+      });
+
   return true;
 }
 static std::once_flag once;
@@ -1193,6 +1207,120 @@ TEST_F(GraphTest, GraphConstruction_TypeInference) {
   EXPECT_EQ("node_4_out_1", graph_proto.output(0).name());
 }
 
+// Resolve only re-runs the type/shape inferencing of the nodes whose inputs, outputs or attributes changed, and of
+// the consumers of the outputs whose inferred types changed.
+TEST_F(GraphTest, IncrementalTypeInference) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_int32;
+  tensor_int32.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  tensor_int32.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("node_1_in_1", &tensor_int32);
+  auto& output_arg_1 = graph.GetOrCreateNodeArg("node_1_out_1", nullptr);
+  auto& output_arg_2 = graph.GetOrCreateNodeArg("node_2_out_1", nullptr);
+  auto& node_1 = graph.AddNode("node_1", "CountedInference_Fake", "node 1", {&input_arg}, {&output_arg_1});
+  auto& node_2 = graph.AddNode("node_2", "CountedInference_Fake", "node 2", {&output_arg_1}, {&output_arg_2});
+
+  counted_inference_runs = 0;
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(counted_inference_runs, 2);
+  ASSERT_NE(output_arg_2.Shape(), nullptr);
+  EXPECT_EQ(output_arg_2.Shape()->dim(0).dim_value(), 2);
+
+  // nothing changed
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(counted_inference_runs, 2);
+
+  // the attributes of node_2 changed
+  node_2.AddAttribute("value", static_cast<int64_t>(1));
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(counted_inference_runs, 3);
+
+  // the output of node_1 changed. it is inferred to the same type, so node_2 isn't inferred again
+  output_arg_1.ClearShape();
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(counted_inference_runs, 4);
+  ASSERT_NE(output_arg_1.Shape(), nullptr);
+  EXPECT_EQ(output_arg_1.Shape()->dim(0).dim_value(), 2);
+
+  // a new node consuming the output of node_2
+  auto& output_arg_3 = graph.GetOrCreateNodeArg("node_3_out_1", nullptr);
+  graph.AddNode("node_3", "CountedInference_Fake", "node 3", {&output_arg_2}, {&output_arg_3});
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(counted_inference_runs, 5);
+
+  // the attributes of node_1 changed through the mutable attributes
+  node_1.GetMutableAttributes()["value"] = node_2.GetAttributes().at("value");
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(counted_inference_runs, 6);
+}
+
+// The values of the shape tensors are propagated so Reshape gets symbolic output dimensions that the ONNX shape
+// inferencing leaves unknown.
+TEST_F(GraphTest, SymbolicShapeInference) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* input_shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  input_shape->add_dim()->set_dim_param("batch");
+  input_shape->add_dim()->set_dim_param("seq");
+  input_shape->add_dim()->set_dim_value(768);
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& values) {
+    TensorProto t;
+    t.set_name(name);
+    t.set_data_type(TensorProto_DataType_INT64);
+    t.add_dims(static_cast<int64_t>(values.size()));
+    for (auto v : values) {
+      t.add_int64_data(v);
+    }
+    graph.AddInitializedTensor(t);
+    return &graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  // x [batch, seq, 768] -> Reshape(x, Concat(Gather(Shape(x), [0, 1]), [12, 64])) -> Reshape(-1, 768)
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+  auto& shape = graph.GetOrCreateNodeArg("shape", nullptr);
+  auto& batch_seq = graph.GetOrCreateNodeArg("batch_seq", nullptr);
+  auto& new_shape = graph.GetOrCreateNodeArg("new_shape", nullptr);
+  auto& heads = graph.GetOrCreateNodeArg("heads", nullptr);
+  auto& merged = graph.GetOrCreateNodeArg("merged", nullptr);
+
+  graph.AddNode("shape", "Shape", "", {&x}, {&shape});
+  graph.AddNode("gather", "Gather", "", {&shape, add_initializer("indices", {0, 1})}, {&batch_seq});
+  graph.AddNode("concat", "Concat", "", {&batch_seq, add_initializer("head_dims", {12, 64})}, {&new_shape})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  graph.AddNode("reshape_heads", "Reshape", "", {&x, &new_shape}, {&heads});
+  graph.AddNode("reshape_merged", "Reshape", "", {&heads, add_initializer("merged_shape", {-1, 768})}, {&merged});
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_NE(heads.Shape(), nullptr);
+  ASSERT_EQ(heads.Shape()->dim_size(), 4);
+  EXPECT_EQ(heads.Shape()->dim(0).dim_param(), "batch");
+  EXPECT_EQ(heads.Shape()->dim(1).dim_param(), "seq");
+  EXPECT_EQ(heads.Shape()->dim(2).dim_value(), 12);
+  EXPECT_EQ(heads.Shape()->dim(3).dim_value(), 64);
+
+  ASSERT_NE(merged.Shape(), nullptr);
+  ASSERT_EQ(merged.Shape()->dim_size(), 2);
+  EXPECT_EQ(merged.Shape()->dim(0).dim_param(), "batch*seq");
+  EXPECT_EQ(merged.Shape()->dim(1).dim_value(), 768);
+
+  // the memory planning evaluates the dimension from the values of the graph inputs' symbols
+  int64_t value = 0;
+  ASSERT_TRUE(SymbolicDim::Evaluate("batch*seq", {{"batch", 2}, {"seq", 128}}, value));
+  EXPECT_EQ(value, 256);
+  EXPECT_FALSE(SymbolicDim::Evaluate("batch*seq", {{"batch", 2}}, value));
+}
+
 TEST_F(GraphTest, ShapeInferenceErrorHandling) {
   Model model("graph", false, *logger_);
   auto& graph = model.MainGraph();
@@ -17,6 +17,7 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <random>
@@ -575,6 +576,28 @@ protected:
     {
         MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, BIsSigned, C, ldc, &CScale, Bias, threadpool);
     }
+
+    void
+    TestGemm(
+        size_t M,
+        size_t N,
+        size_t K,
+        const float* A,
+        size_t lda,
+        float AScale,
+        uint8_t offa,
+        const uint8_t* B,
+        size_t ldb,
+        uint8_t offb,
+        bool BIsSigned,
+        float* C,
+        size_t ldc,
+        float CScale,
+        const float* Bias
+        )
+    {
+        MlasGemm(M, N, K, A, lda, AScale, offa, B, ldb, offb, BIsSigned, C, ldc, &CScale, Bias, threadpool);
+    }
 };
 
 #ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
@@ -641,6 +664,29 @@ protected:
         MlasGemm(M, N, K, A, lda, offa, PackedB, offb, BIsSigned, C, ldc, &CScale, Bias, threadpool);
     }
 
+    void
+    TestGemm(
+        size_t M,
+        size_t N,
+        size_t K,
+        const float* A,
+        size_t lda,
+        float AScale,
+        uint8_t offa,
+        const uint8_t* B,
+        size_t ldb,
+        uint8_t offb,
+        bool BIsSigned,
+        float* C,
+        size_t ldc,
+        float CScale,
+        const float* Bias
+        )
+    {
+        const void* PackedB = PackB(N, K, B, ldb, BIsSigned);
+        MlasGemm(M, N, K, A, lda, AScale, offa, PackedB, offb, BIsSigned, C, ldc, &CScale, Bias, threadpool);
+    }
+
 private:
     MatrixGuardBuffer<uint8_t> BufferBPacked;
 };
@@ -863,8 +909,8 @@ private:
 
         const float CScale = AScale * BScale;
 
-        Test(M, N, K, A, AFloat, K, offa, B, BFloat, N, offb, C, CReference, N, CScale, nullptr);
-        Test(M, N, K, A, AFloat, K, offa, B, BFloat, N, offb, C, CReference, N, CScale, Bias);
+        Test(M, N, K, A, AFloat, K, offa, B, BFloat, N, offb, C, CReference, N, AScale, CScale, nullptr);
+        Test(M, N, K, A, AFloat, K, offa, B, BFloat, N, offb, C, CReference, N, AScale, CScale, Bias);
     }
 
     void
@@ -883,6 +929,7 @@ private:
         float* C,
         float* CReference,
         size_t ldc,
+        float AScale,
         float CScale,
         const float* Bias
         )
@@ -906,6 +953,21 @@ private:
                 break;
             }
         }
+
+        //
+        // Matrix A quantizes back to itself, so quantizing it as it is packed
+        // must produce the same result.
+        //
+
+        this->TestGemm(M, N, K, AFloat, lda, AScale, offa, B, ldb, offb, BIsSigned, C, ldc, CScale, Bias);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch float A M=%zd, N=%zd, K=%zd, offa=%d, offb=%d! %f %f\n",
+                    M, N, K, offa, offb, C[f], CReference[f]);
+                break;
+            }
+        }
     }
 
     template<typename qint8_t>
@@ -1100,6 +1162,8 @@ protected:
                         OutputShape,
                         FilterCount,
                         &Activation,
+                        0.0f,
+                        nullptr,
                         &WorkingBufferSize,
                         nullptr);
 
@@ -1224,6 +1288,10 @@ public:
             Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(2, 16, 1, i, i, 1, 3, 3, 0, 1, 1, 0, 1, 1, 2, 2);
+            Test(1, 16, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+            Test(2, 16, 1, i, i, 1, 5, 5, 1, 2, 2, 1, 1, 1, 2, 2);
         }
     }
 
@@ -1502,6 +1570,119 @@ public:
 
 };
 
+class MlasConvWinogradTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t PaddingTop,
+        size_t PaddingLeft,
+        size_t PaddingBottom,
+        size_t PaddingRight
+        )
+    {
+        const size_t OutputHeight = InputHeight + PaddingTop + PaddingBottom - 2;
+        const size_t OutputWidth = InputWidth + PaddingLeft + PaddingRight - 2;
+
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { 3, 3 };
+        int64_t DilationShape[] = { 1, 1 };
+        int64_t Padding[] = { int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight) };
+        int64_t StrideShape[] = { 1, 1 };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        size_t InputElements = BatchCount * GroupCount * InputChannels * InputHeight * InputWidth;
+        size_t FilterElements = GroupCount * FilterCount * InputChannels * 9;
+        size_t BiasElements = GroupCount * FilterCount;
+        size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputHeight * OutputWidth;
+
+        const float* Input = BufferInput.GetBuffer(InputElements);
+        const float* Filter = BufferFilter.GetBuffer(FilterElements);
+        const float* Bias = BufferBias.GetBuffer(BiasElements);
+        float* Output = BufferOutput.GetBuffer(OutputElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+        float* PackedFilter = BufferPackedFilter.GetBuffer(
+            MlasConvWinogradPackFilterSize(GroupCount, InputChannels, FilterCount));
+
+        MlasConvWinogradPackFilter(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        MLAS_CONV_PARAMETERS Parameters;
+        size_t WorkingBufferSize;
+
+        //
+        // Compute the convolution with the Winograd algorithm and then with
+        // the algorithm selected without the packed filter.
+        //
+
+        MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels, InputShape,
+            KernelShape, DilationShape, Padding, StrideShape, OutputShape, FilterCount,
+            &Activation, 0.0f, PackedFilter, &WorkingBufferSize, threadpool);
+
+        if (Parameters.Algorithm != MlasConvAlgorithmWinograd) {
+            printf("winograd not selected: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd!!!\n",
+                BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount);
+            return;
+        }
+
+        MlasConv(&Parameters, Input, Filter, Bias, BufferWorking.GetBuffer(WorkingBufferSize),
+            Output, threadpool);
+
+        MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels, InputShape,
+            KernelShape, DilationShape, Padding, StrideShape, OutputShape, FilterCount,
+            &Activation, 0.0f, nullptr, &WorkingBufferSize, threadpool);
+
+        MlasConv(&Parameters, Input, Filter, Bias, BufferWorking.GetBuffer(WorkingBufferSize),
+            OutputReference, threadpool);
+
+        //
+        // The transforms round the intermediate values, so the outputs are
+        // compared relative to the magnitude of the dot products.
+        //
+
+        const float Tolerance = 1e-6f * float(InputChannels * 9 * 23 * 23);
+
+        for (size_t n = 0; n < OutputElements; n++) {
+            if (std::fabs(Output[n] - OutputReference[n]) > Tolerance) {
+                printf("mismatch winograd: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,padding(%zd,%zd,%zd,%zd): %f %f!!!\n",
+                    BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+                    PaddingTop, PaddingLeft, PaddingBottom, PaddingRight, Output[n], OutputReference[n]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferFilter;
+    MatrixGuardBuffer<float> BufferPackedFilter;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferWorking;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        Test(1, 1, 16, 24, 24, 16, 1, 1, 1, 1);
+        Test(1, 1, 32, 32, 32, 32, 1, 1, 1, 1);
+        Test(2, 2, 24, 17, 13, 20, 0, 1, 1, 0);
+        Test(3, 1, 16, 9, 23, 48, 1, 1, 0, 0);
+        Test(1, 1, 64, 21, 19, 17, 0, 0, 0, 0);
+    }
+};
+
 class MlasPool2DTest : public MlasTestBase
 {
 protected:
@@ -1871,6 +2052,77 @@ public:
 
 };
 
+class MlasPoolNhwc2DTest : public MlasPool2DTest
+{
+protected:
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        ) override
+    {
+        const size_t BatchCount = size_t(InputShape[0]);
+        const size_t Channels = size_t(InputShape[1]);
+        const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+        const size_t OutputSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+        int64_t NhwcInputShape[] = { InputShape[0], InputShape[2], InputShape[3], InputShape[1] };
+        int64_t NhwcOutputShape[] = { OutputShape[0], OutputShape[2], OutputShape[3], OutputShape[1] };
+
+        float* NhwcInput = BufferNhwcInput.GetBuffer(BatchCount * Channels * InputSize);
+        float* NhwcOutput = BufferNhwcOutput.GetBuffer(BatchCount * Channels * OutputSize);
+
+        for (size_t n = 0; n < BatchCount; n++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t i = 0; i < InputSize; i++) {
+                    NhwcInput[(n * InputSize + i) * Channels + c] = Input[(n * Channels + c) * InputSize + i];
+                }
+            }
+        }
+
+        MlasPoolNhwc(PoolingKind, NhwcInputShape, KernelShape, Padding, StrideShape, NhwcOutputShape, NhwcInput,
+            NhwcOutput, threadpool);
+
+        for (size_t n = 0; n < BatchCount; n++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t i = 0; i < OutputSize; i++) {
+                    Output[(n * Channels + c) * OutputSize + i] = NhwcOutput[(n * OutputSize + i) * Channels + c];
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferNhwcInput;
+    MatrixGuardBuffer<float> BufferNhwcOutput;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        MlasPool2DTest::ExecuteShort();
+
+        //
+        // Test channel counts that are not a multiple of the vector size and
+        // global pooling that splits the channels across threads.
+        //
+
+        for (unsigned c : { 1, 5, 37, 64 }) {
+            Test(2, c, 9, 11, 3, 3, 1, 1, 1, 1, 2, 2);
+            Test(3, c, 7, 7, 2, 2, 0, 0, 1, 1, 2, 2);
+            Test(1, c, 56, 56, 56, 56, 0, 0, 0, 0, 1, 1);
+            Test(2, c, 13, 3, 13, 3, 0, 0, 0, 0, 1, 1);
+        }
+    }
+};
+
 class MlasPool3DTest : public MlasTestBase
 {
 protected:
@@ -2276,6 +2528,31 @@ public:
                 }
             }
         }
+
+        //
+        // Test the vectorized and scalar HardSigmoid activations against the
+        // reference computation, skipping the NaN inputs.
+        //
+
+        Activation.ActivationKind = MlasHardSigmoidActivation;
+        Activation.Parameters.HardSigmoid.alpha = 0.2f;
+        Activation.Parameters.HardSigmoid.beta = 0.5f;
+
+        for (unsigned i = 0; i < _countof(TestData); i++) {
+            Buffer[i].u = TestData[i][0].u;
+        }
+
+        MlasActivation(&Activation, &Buffer[0].f, nullptr, 1, _countof(Buffer), _countof(Buffer));
+
+        for (unsigned i = 0; i < _countof(TestData); i++) {
+            float Expected = std::min(std::max(0.2f * TestData[i][0].f + 0.5f, 0.0f), 1.0f);
+            float Scalar = TestData[i][0].f;
+            MlasActivation(&Activation, &Scalar, nullptr, 1, 1, 1);
+            if (!std::isnan(TestData[i][0].f) &&
+                (std::fabs(Buffer[i].f - Expected) > 1e-6f || std::fabs(Scalar - Expected) > 1e-6f)) {
+                printf("mismatch HardSigmoid activation i=%d value=%f scalar=%f expected=%f\n", (int)i, Buffer[i].f, Scalar, Expected);
+            }
+        }
     }
 };
 
@@ -2387,6 +2664,8 @@ private:
     MatrixGuardBuffer<float> BufferInput;
     MatrixGuardBuffer<float> BufferOutput;
     MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferMask;
+    MatrixGuardBuffer<float> BufferMaskedInput;
 
     void
     Test(
@@ -2411,6 +2690,66 @@ private:
         Test(Input, Output, OutputReference, N, D, true);
     }
 
+    void
+    TestMasked(
+        size_t N,
+        size_t D,
+        float Scale,
+        size_t MaskRowCount,
+        size_t MaskBroadcastCount
+        )
+    {
+        const size_t MaskBlockCount = N / (MaskRowCount * MaskBroadcastCount);
+
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+        float* Mask = BufferMask.GetBuffer(MaskBlockCount * MaskRowCount * D);
+        float* MaskedInput = BufferMaskedInput.GetBuffer(N * D);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(-10.f, 10.f);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = distribution(generator);
+        }
+
+        //
+        // Mask out every third element like a padding mask.
+        //
+
+        for (size_t i = 0; i < MaskBlockCount * MaskRowCount * D; i++) {
+            Mask[i] = (i % 3 == 1) ? -10000.0f : 0.0f;
+        }
+
+        for (size_t n = 0; n < N; n++) {
+            const size_t MaskRow = (n / (MaskRowCount * MaskBroadcastCount)) * MaskRowCount + (n % MaskRowCount);
+            for (size_t d = 0; d < D; d++) {
+                MaskedInput[n * D + d] = Scale * Input[n * D + d] + Mask[MaskRow * D + d];
+            }
+        }
+
+        for (bool LogSoftmax : {false, true}) {
+
+            MlasComputeMaskedSoftmax(Input, Output, N, D, Scale, Mask, MaskRowCount, MaskBroadcastCount,
+                LogSoftmax, threadpool);
+            ReferenceSoftmax(MaskedInput, OutputReference, N, D, LogSoftmax);
+
+            constexpr float AbsoluteTolerance = 1e-6f;
+            constexpr float RelativeTolerance = 1e-5f;
+
+            for (size_t nd = 0; nd < N * D; nd++) {
+                float diff = std::fabs(Output[nd] - OutputReference[nd]);
+                if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[nd]) * RelativeTolerance) {
+                    printf("masked softmax(%d) difference: %u/%u/%u/%u %.8f %.8f\n", int32_t(LogSoftmax), unsigned(N),
+                        unsigned(D), unsigned(MaskRowCount), unsigned(MaskBroadcastCount), Output[nd],
+                        OutputReference[nd]);
+                    break;
+                }
+            }
+        }
+    }
+
     void
     Test(
         const float* Input,
@@ -2495,6 +2834,11 @@ public:
         Test(3, 128, 20.f, 30.f);
         Test(63, 95, -150.f, 190.f);
         Test(16, 211, 20.f, 30.f);
+
+        TestMasked(7, 13, 0.5f, 1, 1);
+        TestMasked(24, 33, 0.125f, 4, 3);
+        TestMasked(60, 128, 1.0f, 1, 12);
+        TestMasked(64, 7, 2.0f, 8, 1);
     }
 };
 
@@ -2756,63 +3100,805 @@ public:
     }
 };
 
-void
-RunThreadedTests(
-    void
-    )
+class MlasHalfGemmTest : public MlasTestBase
 {
-    printf("SGEMM tests.\n");
-    onnxruntime::make_unique<MlasFgemmTest<float, false>>()->ExecuteShort();
-    printf("SGEMM packed tests.\n");
-    onnxruntime::make_unique<MlasFgemmTest<float, true>>()->ExecuteShort();
-#ifdef MLAS_SUPPORTS_GEMM_DOUBLE
-    printf("DGEMM tests.\n");
-    onnxruntime::make_unique<MlasFgemmTest<double, false>>()->ExecuteShort();
-#endif
+private:
+    MatrixGuardBuffer<uint16_t> BufferA;
+    MatrixGuardBuffer<uint16_t> BufferB;
+    MatrixGuardBuffer<uint16_t> BufferC;
+    MatrixGuardBuffer<float> BufferFloat;
 
-#ifdef MLAS_SUPPORTS_GEMM_U8X8
-    printf("QGEMM U8S8=int32_t tests.\n");
-    onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, int32_t, false>>()->ExecuteShort();
-    printf("QGEMM U8S8=float tests.\n");
-    onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, float, false>>()->ExecuteShort();
-    printf("QGEMM U8U8=int32_t tests.\n");
-    onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, int32_t, false>>()->ExecuteShort();
-    printf("QGEMM U8U8=float tests.\n");
-    onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, float, false>>()->ExecuteShort();
-#endif
+    void
+    Test(
+        MLAS_HALF_TYPE HalfType,
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float beta
+        )
+    {
+        uint16_t* A = BufferA.GetBuffer(M * K);
+        uint16_t* B = BufferB.GetBuffer(K * N);
+        uint16_t* C = BufferC.GetBuffer(M * N);
+        float* Float = BufferFloat.GetBuffer(M * K + K * N + M * N);
+        float* FloatA = Float;
+        float* FloatB = FloatA + M * K;
+        float* FloatC = FloatB + K * N;
 
-#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-    if (MlasGemmPackBSize(128, 128, true) > 0) {
-        printf("QGEMM U8S8=int32_t packed tests.\n");
-        onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, int32_t, true>>()->ExecuteShort();
-        printf("QGEMM U8S8=float packed tests.\n");
-        onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, float, true>>()->ExecuteShort();
-    }
-    if (MlasGemmPackBSize(128, 128, false) > 0) {
-        printf("QGEMM U8U8=int32_t packed tests.\n");
-        onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, int32_t, true>>()->ExecuteShort();
-        printf("QGEMM U8U8=float packed tests.\n");
-        onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, float, true>>()->ExecuteShort();
-    }
-#endif
+        //
+        // Use small integers so that the inputs are exact in half precision and
+        // the sums are exact in single precision, which makes the rounded
+        // output independent of the order of the accumulation.
+        //
+
+        for (size_t i = 0; i < M * K; i++) {
+            FloatA[i] = float(int(i % 7) - 3);
+        }
+        for (size_t i = 0; i < K * N; i++) {
+            FloatB[i] = float(int(i % 3) - 1);
+        }
+        for (size_t i = 0; i < M * N; i++) {
+            FloatC[i] = float(int(i % 5) - 2);
+        }
+
+        MlasConvertFloatToHalf(HalfType, FloatA, A, M * K);
+        MlasConvertFloatToHalf(HalfType, FloatB, B, K * N);
+        MlasConvertFloatToHalf(HalfType, FloatC, C, M * N);
+
+        const size_t lda = (TransA == CblasNoTrans) ? K : M;
+        const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+        MlasHalfGemm(HalfType, TransA, TransB, M, N, K, 1.0f, A, lda, B, ldb, beta, C, N, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+
+                float Sum = beta * FloatC[m * N + n];
+
+                for (size_t k = 0; k < K; k++) {
+                    float a = (TransA == CblasNoTrans) ? FloatA[m * K + k] : FloatA[k * M + m];
+                    float b = (TransB == CblasNoTrans) ? FloatB[k * N + n] : FloatB[n * K + k];
+                    Sum += a * b;
+                }
+
+                uint16_t Reference;
+                MlasConvertFloatToHalf(HalfType, &Sum, &Reference, 1);
+
+                if (C[m * N + n] != Reference) {
+                    printf("mismatch HalfType=%d, TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, beta=%f  %04x %04x!\n",
+                        int(HalfType), TransA, TransB, M, N, K, beta, C[m * N + n], Reference);
+                    return;
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (MLAS_HALF_TYPE HalfType : {MlasHalfTypeFloat16, MlasHalfTypeBFloat16}) {
+            for (CBLAS_TRANSPOSE TransA : {CblasNoTrans, CblasTrans}) {
+                for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+                    Test(HalfType, TransA, TransB, 1, 1, 1, 0.0f);
+                    Test(HalfType, TransA, TransB, 7, 9, 5, 1.0f);
+                    Test(HalfType, TransA, TransB, 33, 131, 17, 0.0f);
+                    Test(HalfType, TransA, TransB, 70, 150, 260, 1.0f);
+                    Test(HalfType, TransA, TransB, 4, 5, 0, 1.0f);
+                }
+            }
+        }
+    }
+};
+
+class MlasHalfConvertTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<uint16_t> BufferHalf;
+    MatrixGuardBuffer<uint16_t> BufferHalfOutput;
+    MatrixGuardBuffer<float> BufferFloat;
+
+    void
+    Test(
+        size_t Count,
+        uint16_t FirstValue
+        )
+    {
+        uint16_t* Half = BufferHalf.GetBuffer(Count);
+        uint16_t* HalfOutput = BufferHalfOutput.GetBuffer(Count);
+        float* Float = BufferFloat.GetBuffer(Count);
+
+        //
+        // Every float16 value that isn't a NaN is exact in single precision,
+        // so converting it back must return the same value.
+        //
+
+        uint16_t Value = FirstValue;
+
+        for (size_t i = 0; i < Count; i++) {
+            while ((Value & 0x7C00) == 0x7C00 && (Value & 0x3FF) != 0) {
+                Value++;
+            }
+            Half[i] = Value++;
+        }
+
+        MlasConvertHalfToFloat(MlasHalfTypeFloat16, Half, Float, Count);
+        MlasConvertFloatToHalfBuffer(Float, HalfOutput, Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            if (HalfOutput[i] != Half[i]) {
+                printf("mismatch Count=%zd, i=%zd: %04x %04x %f!\n", Count, i, Half[i], HalfOutput[i], Float[i]);
+                return;
+            }
+        }
+    }
+
+    void
+    TestRounding(
+        void
+        )
+    {
+        //
+        // Values halfway between two float16 values round to the even one, and
+        // values that are too large for float16 become infinity.
+        //
+
+        const float Source[] = {1.0f + 1.0f / 2048, 1.0f + 3.0f / 2048, -1.0f - 1.0f / 2048, 65520.0f, 1e-8f, 0.0f};
+        const uint16_t Expected[] = {0x3C00, 0x3C02, 0xBC00, 0x7C00, 0x0000, 0x0000};
+        const size_t Count = sizeof(Source) / sizeof(Source[0]);
+
+        uint16_t Destination[Count];
+        MlasConvertFloatToHalfBuffer(Source, Destination, Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            if (Destination[i] != Expected[i]) {
+                printf("mismatch rounding %f: %04x %04x!\n", Source[i], Destination[i], Expected[i]);
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t Count = 1; Count <= 40; Count++) {
+            Test(Count, uint16_t(Count * 997));
+        }
+
+        Test(65536, 0);
+        TestRounding();
+    }
+};
+
+class MlasSparseGemmTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<size_t> BufferPackedB;
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        size_t ZeroPercent
+        )
+    {
+        float* A = BufferA.GetBuffer(M * K);
+        float* B = BufferB.GetBuffer(K * N);
+        float* C = BufferC.GetBuffer(M * N);
+
+        //
+        // Use small integers so that the sums are exact in single precision,
+        // which makes the output independent of the order of the accumulation.
+        //
+
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = float(int(i % 7) - 3);
+        }
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = ((i * 37) % 100 < ZeroPercent) ? 0.0f : float(int(i % 5) - 2);
+        }
+        std::fill_n(C, M * N, -1.0f);
+
+        const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+        const size_t NonZeroBlocks = MlasSparseGemmCountBlocks(TransB, N, K, B, ldb);
+        const size_t PackedBSize = MlasSparseGemmPackBSize(N, K, NonZeroBlocks);
+        size_t* PackedB = BufferPackedB.GetBuffer((PackedBSize + sizeof(size_t) - 1) / sizeof(size_t));
+
+        MlasSparseGemmPackB(TransB, N, K, B, ldb, PackedB);
+        MlasSparseGemm(M, N, K, 0.5f, A, K, PackedB, C, N, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+
+                float Sum = 0.0f;
+
+                for (size_t k = 0; k < K; k++) {
+                    float b = (TransB == CblasNoTrans) ? B[k * N + n] : B[n * K + k];
+                    Sum += A[m * K + k] * b;
+                }
+
+                if (C[m * N + n] != 0.5f * Sum) {
+                    printf("mismatch TransB=%d, M=%zd, N=%zd, K=%zd, ZeroPercent=%zd  %f %f!\n",
+                        TransB, M, N, K, ZeroPercent, C[m * N + n], 0.5f * Sum);
+                    return;
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+            for (size_t ZeroPercent : {0, 50, 90, 100}) {
+                Test(TransB, 1, 1, 1, ZeroPercent);
+                Test(TransB, 7, 9, 5, ZeroPercent);
+                Test(TransB, 33, 131, 17, ZeroPercent);
+                Test(TransB, 70, 150, 260, ZeroPercent);
+                Test(TransB, 4, 5, 0, ZeroPercent);
+            }
+        }
+    }
+};
+
+class MlasQNBitGemmTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<uint8_t> BufferQuantBData;
+    MatrixGuardBuffer<float> BufferQuantBScale;
+    MatrixGuardBuffer<uint8_t> BufferQuantBZeroPoint;
+
+    static
+    int32_t
+    GetPacked(
+        size_t BlkBitWidth,
+        const uint8_t* Data,
+        size_t i
+        )
+    {
+        return (BlkBitWidth == 4) ? (Data[i / 2] >> (4 * (i & 1))) & 0x0F : Data[i];
+    }
+
+    static
+    void
+    SetPacked(
+        size_t BlkBitWidth,
+        uint8_t* Data,
+        size_t i,
+        int32_t Value
+        )
+    {
+        if (BlkBitWidth == 4) {
+            Data[i / 2] = uint8_t((Data[i / 2] & ~(0x0F << (4 * (i & 1)))) | (Value << (4 * (i & 1))));
+        } else {
+            Data[i] = uint8_t(Value);
+        }
+    }
+
+    //
+    // Returns the value of matrix B at (k, n) dequantized from the buffers.
+    //
+
+    static
+    float
+    Dequantize(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        size_t K,
+        const uint8_t* QuantBData,
+        const float* QuantBScale,
+        const uint8_t* QuantBZeroPoint,
+        size_t k,
+        size_t n
+        )
+    {
+        const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+        const size_t Block = n * BlockCountK + k / BlkLen;
+        const int32_t q = GetPacked(BlkBitWidth, QuantBData + Block * BlkLen * BlkBitWidth / 8, k % BlkLen);
+        const int32_t ZeroPoint = (QuantBZeroPoint == nullptr) ? 1 << (BlkBitWidth - 1) :
+            GetPacked(BlkBitWidth, QuantBZeroPoint + n * ((BlockCountK * BlkBitWidth + 7) / 8), k / BlkLen);
+        return float(q - ZeroPoint) * QuantBScale[Block];
+    }
+
+    void
+    Test(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        size_t M,
+        size_t N,
+        size_t K,
+        bool Symmetric
+        )
+    {
+        size_t QuantBDataSize;
+        size_t QuantBScaleSize;
+        size_t QuantBZeroPointSize;
+
+        MlasBlockwiseQuantizedBufferSizes(BlkBitWidth, BlkLen, N, K, &QuantBDataSize, &QuantBScaleSize,
+            &QuantBZeroPointSize);
+
+        float* A = BufferA.GetBuffer(M * K);
+        float* Bias = BufferBias.GetBuffer(N);
+        float* C = BufferC.GetBuffer(M * N);
+        uint8_t* QuantBData = BufferQuantBData.GetBuffer(QuantBDataSize);
+        float* QuantBScale = BufferQuantBScale.GetBuffer(QuantBScaleSize);
+        uint8_t* QuantBZeroPoint = Symmetric ? nullptr : BufferQuantBZeroPoint.GetBuffer(QuantBZeroPointSize);
+
+        //
+        // Use small integers and scales that are powers of two so that the
+        // sums are exact in single precision, which makes the output
+        // independent of the order of the accumulation.
+        //
+
+        const int32_t QuantMax = (1 << BlkBitWidth) - 1;
+        const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = float(int(i % 7) - 3);
+        }
+        for (size_t n = 0; n < N; n++) {
+            Bias[n] = float(int(n % 3) - 1);
+        }
+        for (size_t i = 0; i < N * BlockCountK * BlkLen; i++) {
+            SetPacked(BlkBitWidth, QuantBData, i, int32_t((i * 7) % (QuantMax + 1)));
+        }
+        for (size_t i = 0; i < QuantBScaleSize; i++) {
+            QuantBScale[i] = 1.0f / float(1 << (i % 4));
+        }
+        if (QuantBZeroPoint != nullptr) {
+            for (size_t n = 0; n < N; n++) {
+                for (size_t Block = 0; Block < BlockCountK; Block++) {
+                    SetPacked(BlkBitWidth, QuantBZeroPoint + n * (QuantBZeroPointSize / N), Block,
+                        int32_t((n + Block * 3) % (QuantMax + 1)));
+                }
+            }
+        }
+        std::fill_n(C, M * N, -1.0f);
+
+        MlasBlockwiseQuantizedGemm(BlkBitWidth, BlkLen, M, N, K, A, K, QuantBData, QuantBScale, QuantBZeroPoint,
+            Bias, C, N, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+
+                float Sum = Bias[n];
+
+                for (size_t k = 0; k < K; k++) {
+                    Sum += A[m * K + k] *
+                        Dequantize(BlkBitWidth, BlkLen, K, QuantBData, QuantBScale, QuantBZeroPoint, k, n);
+                }
+
+                if (C[m * N + n] != Sum) {
+                    printf("mismatch BlkBitWidth=%zd, BlkLen=%zd, M=%zd, N=%zd, K=%zd, Symmetric=%d  %f %f!\n",
+                        BlkBitWidth, BlkLen, M, N, K, int(Symmetric), C[m * N + n], Sum);
+                    return;
+                }
+            }
+        }
+    }
+
+    void
+    TestQuantize(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        size_t N,
+        size_t K,
+        bool Symmetric
+        )
+    {
+        size_t QuantBDataSize;
+        size_t QuantBScaleSize;
+        size_t QuantBZeroPointSize;
+
+        MlasBlockwiseQuantizedBufferSizes(BlkBitWidth, BlkLen, N, K, &QuantBDataSize, &QuantBScaleSize,
+            &QuantBZeroPointSize);
+
+        float* B = BufferB.GetBuffer(K * N);
+        uint8_t* QuantBData = BufferQuantBData.GetBuffer(QuantBDataSize);
+        float* QuantBScale = BufferQuantBScale.GetBuffer(QuantBScaleSize);
+        uint8_t* QuantBZeroPoint = Symmetric ? nullptr : BufferQuantBZeroPoint.GetBuffer(QuantBZeroPointSize);
+
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = float(int((i * 13) % 41) - 23) * 0.125f;
+        }
+
+        MlasQuantizeBlockwise(BlkBitWidth, BlkLen, B, N, N, K, Symmetric, QuantBData, QuantBScale, QuantBZeroPoint);
+
+        //
+        // Every value is within half a step of its block of the dequantized
+        // value.
+        //
+
+        const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+        for (size_t n = 0; n < N; n++) {
+            for (size_t k = 0; k < K; k++) {
+
+                const float Scale = QuantBScale[n * BlockCountK + k / BlkLen];
+                const float Value =
+                    Dequantize(BlkBitWidth, BlkLen, K, QuantBData, QuantBScale, QuantBZeroPoint, k, n);
+
+                if (std::fabs(Value - B[k * N + n]) > std::fabs(Scale) * 0.5001f) {
+                    printf("mismatch quantize BlkBitWidth=%zd, BlkLen=%zd, N=%zd, K=%zd, Symmetric=%d  %f %f!\n",
+                        BlkBitWidth, BlkLen, N, K, int(Symmetric), Value, B[k * N + n]);
+                    return;
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t BlkBitWidth : {4, 8}) {
+            for (size_t BlkLen : {16, 32, 64, 128, 256}) {
+                for (bool Symmetric : {true, false}) {
+                    Test(BlkBitWidth, BlkLen, 1, 1, 1, Symmetric);
+                    Test(BlkBitWidth, BlkLen, 1, 37, 64, Symmetric);
+                    Test(BlkBitWidth, BlkLen, 3, 19, 95, Symmetric);
+                    Test(BlkBitWidth, BlkLen, 7, 65, 300, Symmetric);
+                    Test(BlkBitWidth, BlkLen, 33, 33, 257, Symmetric);
+                    Test(BlkBitWidth, BlkLen, 70, 150, 600, Symmetric);
+                    TestQuantize(BlkBitWidth, BlkLen, 1, 1, Symmetric);
+                    TestQuantize(BlkBitWidth, BlkLen, 13, 70, Symmetric);
+                    TestQuantize(BlkBitWidth, BlkLen, 17, 300, Symmetric);
+                }
+            }
+        }
+    }
+};
+
+class MlasSgemmActivationTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        size_t M,
+        size_t N,
+        size_t K,
+        float beta,
+        const MLAS_ACTIVATION* Activation,
+        bool HasBias
+        )
+    {
+        float* A = BufferA.GetBuffer(M * K);
+        float* B = BufferB.GetBuffer(K * N);
+        float* Bias = BufferBias.GetBuffer(M);
+        float* C = BufferC.GetBuffer(M * N);
+        float* CReference = BufferCReference.GetBuffer(M * N);
+
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = float(int(i % 7) - 3) * 0.125f;
+        }
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = float(int(i % 5) - 2) * 0.0625f;
+        }
+        for (size_t i = 0; i < M; i++) {
+            Bias[i] = float(int(i % 3) - 1) * 0.5f;
+        }
+        for (size_t i = 0; i < M * N; i++) {
+            C[i] = float(int(i % 11) - 5) * 0.25f;
+        }
+        std::copy_n(C, M * N, CReference);
+
+        const size_t lda = (TransA == CblasNoTrans) ? K : M;
+
+        //
+        // The activation fused into the kernel loop must produce the same
+        // output as the activation applied to the output of the GEMM.
+        //
+
+        MlasGemm(TransA, CblasNoTrans, M, N, K, 1.0f, A, lda, B, N, beta, C, N, Activation,
+            HasBias ? Bias : nullptr, threadpool);
+
+        MlasGemm(TransA, CblasNoTrans, M, N, K, 1.0f, A, lda, B, N, beta, CReference, N, threadpool);
+        MlasActivation(Activation, CReference, HasBias ? Bias : nullptr, M, N, N);
+
+        for (size_t i = 0; i < M * N; i++) {
+            if (C[i] != CReference[i]) {
+                printf("mismatch TransA=%d, M=%zd, N=%zd, K=%zd, beta=%f, kind=%d, bias=%d %f %f!\n",
+                    TransA, M, N, K, beta, int(Activation->ActivationKind), int(HasBias), C[i], CReference[i]);
+                return;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        MLAS_ACTIVATION Activations[4];
+
+        Activations[0].ActivationKind = MlasReluActivation;
+        Activations[1].ActivationKind = MlasTanhActivation;
+        Activations[2].ActivationKind = MlasLeakyReluActivation;
+        Activations[2].Parameters.LeakyRelu.alpha = 0.2f;
+        Activations[3].ActivationKind = MlasHardSigmoidActivation;
+        Activations[3].Parameters.HardSigmoid.alpha = 0.2f;
+        Activations[3].Parameters.HardSigmoid.beta = 0.5f;
+
+        for (const MLAS_ACTIVATION& Activation : Activations) {
+            for (CBLAS_TRANSPOSE TransA : {CblasNoTrans, CblasTrans}) {
+                for (bool HasBias : {false, true}) {
+                    Test(TransA, 1, 37, 19, 0.0f, &Activation, HasBias);
+                    Test(TransA, 29, 1, 40, 0.0f, &Activation, HasBias);
+                    Test(TransA, 16, 48, 33, 0.0f, &Activation, HasBias);
+                    Test(TransA, 47, 129, 300, 1.0f, &Activation, HasBias);
+                    Test(TransA, 70, 150, 600, 0.5f, &Activation, HasBias);
+                }
+            }
+        }
+    }
+};
+
+class MlasChannelNormalizationTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferScale;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferNchwcInput;
+    MatrixGuardBuffer<float> BufferNchwcOutput;
+
+    void
+    ReferenceChannelNormalization(
+        const float* Input,
+        const float* Scale,
+        const float* Bias,
+        float* Output,
+        size_t BatchCount,
+        size_t Channels,
+        size_t ChannelSize,
+        bool ComputeMoments,
+        float Epsilon,
+        const MLAS_ACTIVATION* Activation
+        )
+    {
+        for (size_t nc = 0; nc < BatchCount * Channels; nc++) {
+
+            const float* input = Input + nc * ChannelSize;
+            float* output = Output + nc * ChannelSize;
+
+            double scale = Scale[nc % Channels];
+            double shift = Bias[nc % Channels];
+
+            if (ComputeMoments) {
+
+                double mean = 0.0;
+                for (size_t i = 0; i < ChannelSize; i++) {
+                    mean += input[i];
+                }
+                mean /= ChannelSize;
+
+                double variance = 0.0;
+                for (size_t i = 0; i < ChannelSize; i++) {
+                    variance += (input[i] - mean) * (input[i] - mean);
+                }
+                variance /= ChannelSize;
+
+                scale /= std::sqrt(variance + Epsilon);
+                shift -= mean * scale;
+            }
+
+            for (size_t i = 0; i < ChannelSize; i++) {
+                output[i] = float(input[i] * scale + shift);
+            }
+        }
+
+        MlasActivation(Activation, Output, nullptr, BatchCount * Channels, ChannelSize, ChannelSize);
+    }
+
+    void
+    Test(
+        size_t BatchCount,
+        size_t Channels,
+        size_t ChannelSize,
+        float InputOffset,
+        const MLAS_ACTIVATION* Activation
+        )
+    {
+        const size_t ElementCount = BatchCount * Channels * ChannelSize;
+        const float Epsilon = 1e-5f;
+
+        float* Input = BufferInput.GetBuffer(ElementCount);
+        float* Scale = BufferScale.GetBuffer(Channels);
+        float* Bias = BufferBias.GetBuffer(Channels);
+        float* Output = BufferOutput.GetBuffer(ElementCount);
+        float* OutputReference = BufferOutputReference.GetBuffer(ElementCount);
+
+        for (size_t i = 0; i < ElementCount; i++) {
+            Input[i] = InputOffset + float(int(i % 23) - 11) * 0.125f;
+        }
+        for (size_t c = 0; c < Channels; c++) {
+            Scale[c] = float(int(c % 5) + 1) * 0.25f;
+            Bias[c] = float(int(c % 7) - 3) * 0.5f;
+        }
+
+        for (bool ComputeMoments : {false, true}) {
+
+            if (ComputeMoments) {
+                MlasInstanceNormalization(Input, Scale, Bias, Output, BatchCount, Channels, ChannelSize, Epsilon,
+                    Activation, threadpool);
+            } else {
+                MlasChannelScaleShift(Input, Scale, Bias, Output, BatchCount, Channels, ChannelSize,
+                    Activation, threadpool);
+            }
+
+            ReferenceChannelNormalization(Input, Scale, Bias, OutputReference, BatchCount, Channels, ChannelSize,
+                ComputeMoments, Epsilon, Activation);
+
+            for (size_t i = 0; i < ElementCount; i++) {
+                if (std::fabs(Output[i] - OutputReference[i]) > 1e-4f + 1e-4f * std::fabs(OutputReference[i])) {
+                    printf("mismatch ChannelNormalization: moments=%d batch=%zd channels=%zd size=%zd kind=%d %f %f!\n",
+                        int(ComputeMoments), BatchCount, Channels, ChannelSize, int(Activation->ActivationKind),
+                        Output[i], OutputReference[i]);
+                    return;
+                }
+            }
+        }
+
+        //
+        // The NCHWc instance normalization must produce the same output as the
+        // NCHW instance normalization for block aligned channel counts.
+        //
+
+        const size_t BlockSize = MlasNchwcGetBlockSize();
+
+        if (BlockSize <= 1 || (Channels % BlockSize) != 0 || ChannelSize % 7 != 0) {
+            return;
+        }
+
+        float* NchwcInput = BufferNchwcInput.GetBuffer(ElementCount);
+        float* NchwcOutput = BufferNchwcOutput.GetBuffer(ElementCount);
+
+        int64_t Shape[] = { int64_t(BatchCount), int64_t(Channels), 7, int64_t(ChannelSize / 7) };
+
+        MlasReorderInput(Shape, Input, NchwcInput);
+        MlasNchwcInstanceNormalization(Shape, NchwcInput, Scale, Bias, NchwcOutput, Epsilon, Activation, threadpool);
+        MlasReorderOutputNchw(Shape, NchwcOutput, Output);
+
+        for (size_t i = 0; i < ElementCount; i++) {
+            if (std::fabs(Output[i] - OutputReference[i]) > 1e-4f + 1e-4f * std::fabs(OutputReference[i])) {
+                printf("mismatch NchwcInstanceNormalization: batch=%zd channels=%zd size=%zd kind=%d %f %f!\n",
+                    BatchCount, Channels, ChannelSize, int(Activation->ActivationKind), Output[i], OutputReference[i]);
+                return;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        MLAS_ACTIVATION Activations[3];
+
+        Activations[0].ActivationKind = MlasIdentityActivation;
+        Activations[1].ActivationKind = MlasReluActivation;
+        Activations[2].ActivationKind = MlasLeakyReluActivation;
+        Activations[2].Parameters.LeakyRelu.alpha = 0.2f;
+
+        for (const MLAS_ACTIVATION& Activation : Activations) {
+            Test(1, 3, 1, 0.0f, &Activation);
+            Test(2, 5, 13, 0.0f, &Activation);
+            Test(1, 16, 49, 0.0f, &Activation);
+            Test(3, 32, 77, 100.0f, &Activation);
+            Test(2, 64, 56 * 56, 0.0f, &Activation);
+        }
+    }
+};
+
+void
+RunThreadedTests(
+    void
+    )
+{
+    printf("SGEMM tests.\n");
+    onnxruntime::make_unique<MlasFgemmTest<float, false>>()->ExecuteShort();
+    printf("SGEMM packed tests.\n");
+    onnxruntime::make_unique<MlasFgemmTest<float, true>>()->ExecuteShort();
+#ifdef MLAS_SUPPORTS_GEMM_DOUBLE
+    printf("DGEMM tests.\n");
+    onnxruntime::make_unique<MlasFgemmTest<double, false>>()->ExecuteShort();
+#endif
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+    printf("QGEMM U8S8=int32_t tests.\n");
+    onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, int32_t, false>>()->ExecuteShort();
+    printf("QGEMM U8S8=float tests.\n");
+    onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, float, false>>()->ExecuteShort();
+    printf("QGEMM U8U8=int32_t tests.\n");
+    onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, int32_t, false>>()->ExecuteShort();
+    printf("QGEMM U8U8=float tests.\n");
+    onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, float, false>>()->ExecuteShort();
+#endif
+
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+    if (MlasGemmPackBSize(128, 128, true) > 0) {
+        printf("QGEMM U8S8=int32_t packed tests.\n");
+        onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, int32_t, true>>()->ExecuteShort();
+        printf("QGEMM U8S8=float packed tests.\n");
+        onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t, float, true>>()->ExecuteShort();
+    }
+    if (MlasGemmPackBSize(128, 128, false) > 0) {
+        printf("QGEMM U8U8=int32_t packed tests.\n");
+        onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, int32_t, true>>()->ExecuteShort();
+        printf("QGEMM U8U8=float packed tests.\n");
+        onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t, float, true>>()->ExecuteShort();
+    }
+#endif
+
+    printf("HGEMM tests.\n");
+    onnxruntime::make_unique<MlasHalfGemmTest>()->ExecuteShort();
+
+    printf("Half conversion tests.\n");
+    onnxruntime::make_unique<MlasHalfConvertTest>()->ExecuteShort();
+
+    printf("SGEMM activation tests.\n");
+    onnxruntime::make_unique<MlasSgemmActivationTest>()->ExecuteShort();
+
+    printf("Sparse SGEMM tests.\n");
+    onnxruntime::make_unique<MlasSparseGemmTest>()->ExecuteShort();
+
+    printf("Blockwise quantized SGEMM tests.\n");
+    onnxruntime::make_unique<MlasQNBitGemmTest>()->ExecuteShort();
 
     printf("Conv2D tests.\n");
     onnxruntime::make_unique<MlasConv2DTest>()->ExecuteShort();
     if (MlasNchwcGetBlockSize() > 1) {
         onnxruntime::make_unique<MlasNchwcConv2DTest>()->ExecuteShort();
     }
+    onnxruntime::make_unique<MlasConvWinogradTest>()->ExecuteShort();
 
     printf("Pool2D tests.\n");
     onnxruntime::make_unique<MlasPool2DTest>()->ExecuteShort();
     if (MlasNchwcGetBlockSize() > 1) {
         onnxruntime::make_unique<MlasNchwcPool2DTest>()->ExecuteShort();
     }
+    onnxruntime::make_unique<MlasPoolNhwc2DTest>()->ExecuteShort();
 
     printf("Pool3D tests.\n");
     onnxruntime::make_unique<MlasPool3DTest>()->ExecuteShort();
 
     printf("Softmax tests.\n");
     onnxruntime::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+    printf("Channel normalization tests.\n");
+    onnxruntime::make_unique<MlasChannelNormalizationTest>()->ExecuteShort();
 }
 
 int
@@ -0,0 +1,375 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of the MLAS kernels on shapes of BERT, ResNet and MobileNet models, with 1 to 8 threads.
+// The GFLOPS counter gives the floating point or integer operations per second, bytes_per_second the memory read
+// and written. Set the MLAS_MAX_ISA environment variable (sse2, avx, avx2, avx512f, avx512core, avx512vnni) to
+// benchmark the kernels of a lower instruction set on the same machine.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <core/platform/threadpool.h>
+#include <core/util/thread_utils.h>
+#include <mlas.h>
+
+#include <memory>
+#include <vector>
+
+using namespace onnxruntime;
+
+namespace {
+
+std::unique_ptr<concurrency::ThreadPool> CreateBenchmarkThreadPool(int thread_count) {
+  OrtThreadPoolParams param;
+  param.thread_pool_size = thread_count;
+  param.auto_set_affinity = true;
+  param.allow_spinning = true;
+  return concurrency::CreateThreadPool(&onnxruntime::Env::Default(), param,
+                                       concurrency::ThreadPoolType::INTRA_OP);
+}
+
+template <typename T>
+std::vector<T> RandomVector(size_t size, T low, T high) {
+  T* data = GenerateArrayWithRandomValue<T>(size, low, high);
+  std::vector<T> result(data, data + size);
+  aligned_free(data);
+  return result;
+}
+
+std::vector<uint8_t> RandomBytes(size_t size) {
+  std::vector<uint8_t> result(size);
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto& value : result) {
+    value = static_cast<uint8_t>(dist(gen));
+  }
+  return result;
+}
+
+void SetOpsCounter(benchmark::State& state, double ops_per_iteration) {
+  state.counters["GFLOPS"] = benchmark::Counter(ops_per_iteration / 1e9, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// M, N, K of the matrix multiplications
+void GemmShapes(benchmark::internal::Benchmark* b) {
+  const std::vector<std::vector<int64_t>> shapes = {
+      // BERT-base, sequence length 128: QKV, attention output, FFN in and out
+      {128, 2304, 768},
+      {128, 768, 768},
+      {128, 3072, 768},
+      {128, 768, 3072},
+      // ResNet-50 convolutions as im2col GEMMs: filters x output pixels x (channels * kernel size)
+      {64, 3136, 576},
+      {256, 784, 1152},
+      {512, 49, 4608},
+      // MobileNet pointwise convolutions
+      {64, 12544, 32},
+      {1024, 49, 1024},
+      // batch 1 fully connected
+      {1, 1000, 2048},
+  };
+  for (const auto& shape : shapes) {
+    for (int64_t threads : {1, 4, 8}) {
+      b->Args({shape[0], shape[1], shape[2], threads});
+    }
+  }
+  b->ArgNames({"M", "N", "K", "threads"});
+}
+
+}  // namespace
+
+static void BM_MlasSGemm(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(3)));
+  auto A = RandomVector<float>(M * K, -1.0f, 1.0f);
+  auto B = RandomVector<float>(K * N, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A.data(), K, B.data(), N, 0.0f, C.data(), N, tp.get());
+  }
+
+  SetOpsCounter(state, 2.0 * M * N * K);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (M * K + K * N + M * N) * sizeof(float)));
+}
+
+BENCHMARK(BM_MlasSGemm)->Apply(GemmShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_MlasSGemmPackedB(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(3)));
+  auto A = RandomVector<float>(M * K, -1.0f, 1.0f);
+  auto B = RandomVector<float>(K * N, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+
+  const size_t packed_b_size = MlasGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    state.SkipWithError("packing of B is not supported on this platform");
+    return;
+  }
+  std::vector<uint8_t> packed_b(packed_b_size);
+  MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, packed_b.data());
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, M, N, K, 1.0f, A.data(), K, packed_b.data(), 0.0f, C.data(), N, tp.get());
+  }
+
+  SetOpsCounter(state, 2.0 * M * N * K);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (M * K + K * N + M * N) * sizeof(float)));
+}
+
+BENCHMARK(BM_MlasSGemmPackedB)->Apply(GemmShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// Quantized GEMM with uint8 A; B is int8 when the last argument is 1, uint8 otherwise.
+static void BM_MlasQGemm(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(3)));
+  const bool b_is_signed = state.range(4) != 0;
+  auto A = RandomBytes(M * K);
+  auto B = RandomBytes(K * N);
+  std::vector<int32_t> C(M * N);
+
+  for (auto _ : state) {
+    MlasGemm(M, N, K, A.data(), K, 128, B.data(), N, b_is_signed ? 0 : 128, b_is_signed, C.data(), N, tp.get());
+  }
+
+  SetOpsCounter(state, 2.0 * M * N * K);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (M * K + K * N + M * N * sizeof(int32_t))));
+}
+
+BENCHMARK(BM_MlasQGemm)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      for (const auto& shape : std::vector<std::vector<int64_t>>{{128, 2304, 768},
+                                                                 {128, 768, 768},
+                                                                 {128, 3072, 768},
+                                                                 {128, 768, 3072},
+                                                                 {64, 3136, 576},
+                                                                 {1, 1000, 2048}}) {
+        for (int64_t threads : {1, 4, 8}) {
+          for (int64_t b_is_signed : {0, 1}) {
+            b->Args({shape[0], shape[1], shape[2], threads, b_is_signed});
+          }
+        }
+      }
+      b->ArgNames({"M", "N", "K", "threads", "b_is_signed"});
+    })
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// 2D convolutions with batch 1 and square inputs and kernels: channels in, channels out, input size, kernel size,
+// stride, groups, threads.
+static void ConvShapes(benchmark::internal::Benchmark* b) {
+  const std::vector<std::vector<int64_t>> shapes = {
+      // ResNet-50
+      {3, 64, 224, 7, 2, 1},
+      {64, 64, 56, 3, 1, 1},
+      {256, 64, 56, 1, 1, 1},
+      {128, 128, 28, 3, 1, 1},
+      {512, 512, 7, 3, 1, 1},
+      // MobileNet v2 depthwise and pointwise
+      {32, 32, 112, 3, 1, 32},
+      {144, 144, 56, 3, 2, 144},
+      {96, 24, 56, 1, 1, 1},
+  };
+  for (const auto& shape : shapes) {
+    for (int64_t threads : {1, 4, 8}) {
+      b->Args({shape[0], shape[1], shape[2], shape[3], shape[4], shape[5], threads});
+    }
+  }
+  b->ArgNames({"C", "F", "HW", "k", "stride", "groups", "threads"});
+}
+
+static void BM_MlasConv(benchmark::State& state) {
+  const int64_t channels = state.range(0);
+  const int64_t filters = state.range(1);
+  const int64_t input_size = state.range(2);
+  const int64_t kernel_size = state.range(3);
+  const int64_t stride = state.range(4);
+  const int64_t groups = state.range(5);
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(6)));
+
+  const int64_t pad = kernel_size / 2;
+  const int64_t output_size = (input_size + 2 * pad - kernel_size) / stride + 1;
+  const int64_t input_shape[] = {input_size, input_size};
+  const int64_t kernel_shape[] = {kernel_size, kernel_size};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {pad, pad, pad, pad};
+  const int64_t stride_shape[] = {stride, stride};
+  const int64_t output_shape[] = {output_size, output_size};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size = 0;
+  MlasConvPrepare(&parameters, 2, 1, static_cast<size_t>(groups), static_cast<size_t>(channels / groups),
+                  input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(filters / groups), &activation, 0.0f, nullptr, &working_buffer_size, tp.get());
+
+  auto input = RandomVector<float>(static_cast<size_t>(channels * input_size * input_size), -1.0f, 1.0f);
+  auto filter = RandomVector<float>(static_cast<size_t>(filters * (channels / groups) * kernel_size * kernel_size),
+                                    -1.0f, 1.0f);
+  auto bias = RandomVector<float>(static_cast<size_t>(filters), -1.0f, 1.0f);
+  std::vector<float> working_buffer(working_buffer_size);
+  std::vector<float> output(static_cast<size_t>(filters * output_size * output_size));
+
+  for (auto _ : state) {
+    MlasConv(&parameters, input.data(), filter.data(), bias.data(), working_buffer.data(), output.data(), tp.get());
+  }
+
+  SetOpsCounter(state, 2.0 * filters * output_size * output_size * (channels / groups) * kernel_size * kernel_size);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (input.size() + filter.size() + output.size()) *
+                                               sizeof(float)));
+}
+
+BENCHMARK(BM_MlasConv)->Apply(ConvShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// The same convolutions in the NCHWc layout, with the channels rounded up to the block size.
+static void BM_MlasNchwcConv(benchmark::State& state) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc kernels are not supported on this platform");
+    return;
+  }
+  const int64_t groups = state.range(5);
+  const bool depthwise = groups > 1;
+  auto round_up = [block_size](int64_t n) { return (n + block_size - 1) / block_size * block_size; };
+  // the first convolution of ResNet reads the NCHW input directly
+  const int64_t channels = state.range(0) < block_size ? state.range(0) : round_up(state.range(0));
+  const int64_t filters = round_up(state.range(1));
+  const int64_t input_size = state.range(2);
+  const int64_t kernel_size = state.range(3);
+  const int64_t stride = state.range(4);
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(6)));
+
+  const int64_t pad = kernel_size / 2;
+  const int64_t output_size = (input_size + 2 * pad - kernel_size) / stride + 1;
+  const int64_t input_shape[] = {1, channels, input_size, input_size};
+  const int64_t kernel_shape[] = {kernel_size, kernel_size};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {pad, pad, pad, pad};
+  const int64_t stride_shape[] = {stride, stride};
+  const int64_t output_shape[] = {1, filters, output_size, output_size};
+  const int64_t group_count = depthwise ? filters : 1;
+  const int64_t filter_channels = depthwise ? 1 : channels;
+
+  auto input = RandomVector<float>(static_cast<size_t>(channels * input_size * input_size), -1.0f, 1.0f);
+  auto filter = RandomVector<float>(static_cast<size_t>(filters * filter_channels * kernel_size * kernel_size),
+                                    -1.0f, 1.0f);
+  auto bias = RandomVector<float>(static_cast<size_t>(filters), -1.0f, 1.0f);
+  std::vector<float> output(static_cast<size_t>(filters * output_size * output_size));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+  for (auto _ : state) {
+    MlasNchwcConv(input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(group_count), input.data(), filter.data(), bias.data(), output.data(),
+                  &activation, true, tp.get());
+  }
+
+  SetOpsCounter(state, 2.0 * filters * output_size * output_size * filter_channels * kernel_size * kernel_size);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (input.size() + filter.size() + output.size()) *
+                                               sizeof(float)));
+}
+
+BENCHMARK(BM_MlasNchwcConv)->Apply(ConvShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// Softmax over the rows of BERT attention scores (heads * sequence length rows of sequence length) and of a
+// classifier output.
+static void BM_MlasSoftmax(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(2)));
+  auto input = RandomVector<float>(N * D, -10.0f, 10.0f);
+  std::vector<float> output(N * D);
+
+  for (auto _ : state) {
+    MlasComputeSoftmax(input.data(), output.data(), N, D, false, tp.get());
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * N * D * sizeof(float)));
+}
+
+BENCHMARK(BM_MlasSoftmax)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      for (int64_t sequence_length : {128, 384}) {
+        for (int64_t threads : {1, 4, 8}) {
+          b->Args({12 * sequence_length, sequence_length, threads});
+        }
+      }
+      b->Args({1, 1000, 1});
+      b->ArgNames({"N", "D", "threads"});
+    })
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_MlasErf(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  auto input = RandomVector<float>(N, -3.0f, 3.0f);
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    MlasComputeErf(input.data(), output.data(), N);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * N * sizeof(float)));
+}
+
+// BERT-base FFN activations for sequence lengths 128 and 384
+BENCHMARK(BM_MlasErf)
+    ->Arg(1000)
+    ->Arg(128 * 3072)
+    ->Arg(384 * 3072)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_MlasTanh(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  auto input = RandomVector<float>(N, -5.0f, 5.0f);
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    MlasComputeTanh(input.data(), output.data(), N);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * N * sizeof(float)));
+}
+
+BENCHMARK(BM_MlasTanh)
+    ->Arg(1000)
+    ->Arg(128 * 3072)
+    ->Arg(384 * 3072)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// Transposes of 32-bit elements: BERT attention head splits and a square weight matrix.
+static void BM_MlasTranspose(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  std::vector<uint32_t> input(M * N);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<uint32_t>(i);
+  }
+  std::vector<uint32_t> output(M * N);
+
+  for (auto _ : state) {
+    MlasTranspose(input.data(), output.data(), M, N);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * M * N * sizeof(uint32_t)));
+}
+
+BENCHMARK(BM_MlasTranspose)
+    ->ArgNames({"M", "N"})
+    ->Args({128, 768})
+    ->Args({768, 768})
+    ->Args({3072, 768})
+    ->Args({64, 3136})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
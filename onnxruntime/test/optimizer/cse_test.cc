@@ -58,6 +58,28 @@ std::vector<std::string> GetAllNodeNamesSorted(const Graph& graph) {
   std::sort(res.begin(), res.end());
   return res;
 }
+
+ONNX_NAMESPACE::TypeProto MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType elem_type,
+                                         const std::vector<int64_t>& dims) {
+  ONNX_NAMESPACE::TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (int64_t dim : dims) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+ONNX_NAMESPACE::TensorProto MakeFloatInitializer(const std::string& name, const std::vector<float>& values) {
+  ONNX_NAMESPACE::TensorProto initializer;
+  initializer.set_name(name);
+  initializer.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  initializer.add_dims(static_cast<int64_t>(values.size()));
+  for (float value : values) {
+    initializer.add_float_data(value);
+  }
+  return initializer;
+}
 }  // namespace
 
 TEST(CseTests, SimpleTest) {
@@ -229,8 +251,8 @@ TEST(CseTests, MergeConstants) {
                   .IsOK());
   Graph& graph = model->MainGraph();
   GraphTransformerManager graph_transformation_mgr(1);
-  // In current implementation, equal constants are not merged. So CSE must precede constant folding, otherwise we end up
-  // with multiple copies of the same constant.
+  // Equal constants are only merged when CSE runs, so CSE must precede constant folding, otherwise we end up
+  // with multiple copies of the same constant after this step.
   std::unique_ptr<CPUExecutionProvider> e = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
   ASSERT_TRUE(
       graph_transformation_mgr.Register(onnxruntime::make_unique<CommonSubexpressionElimination>(), TransformerLevel::Level1).IsOK());
@@ -245,5 +267,144 @@ TEST(CseTests, MergeConstants) {
   ASSERT_EQ(op_count["Add"], 2);
 }
 
+TEST(CseTests, CommutativeOps) {
+  Model model("cse_commutative_ops", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  auto float_type = MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType_FLOAT, {2});
+
+  auto& x = graph.GetOrCreateNodeArg("x", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &float_type);
+  auto& add_1 = graph.GetOrCreateNodeArg("Add1", &float_type);
+  auto& add_2 = graph.GetOrCreateNodeArg("Add2", &float_type);
+  auto& max_1 = graph.GetOrCreateNodeArg("Max1", &float_type);
+  auto& max_2 = graph.GetOrCreateNodeArg("Max2", &float_type);
+  auto& sub_1 = graph.GetOrCreateNodeArg("Sub1", &float_type);
+  auto& sub_2 = graph.GetOrCreateNodeArg("Sub2", &float_type);
+  auto& result = graph.GetOrCreateNodeArg("Result", &float_type);
+  graph.AddNode("add_1", "Add", "", {&x, &y}, {&add_1});
+  graph.AddNode("add_2", "Add", "", {&y, &x}, {&add_2});
+  graph.AddNode("max_1", "Max", "", {&x, &y, &add_1}, {&max_1});
+  graph.AddNode("max_2", "Max", "", {&add_2, &y, &x}, {&max_2});
+  // not commutative
+  graph.AddNode("sub_1", "Sub", "", {&max_1, &x}, {&sub_1});
+  graph.AddNode("sub_2", "Sub", "", {&x, &max_2}, {&sub_2});
+  graph.AddNode("result", "Sum", "", {&sub_1, &sub_2}, {&result});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ApplyCse(model);
+
+  auto op_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_count["Add"], 1);
+  ASSERT_EQ(op_count["Max"], 1);
+  ASSERT_EQ(op_count["Sub"], 2);
+}
+
+TEST(CseTests, MergeEqualInitializers) {
+  Model model("cse_merge_equal_initializers", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  auto float_type = MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType_FLOAT, {3});
+
+  graph.AddInitializedTensor(MakeFloatInitializer("c1", {1.f, 2.f, 3.f}));
+  graph.AddInitializedTensor(MakeFloatInitializer("c2", {1.f, 2.f, 3.f}));
+  graph.AddInitializedTensor(MakeFloatInitializer("c3", {1.f, 2.f, 4.f}));
+
+  auto& x = graph.GetOrCreateNodeArg("x", &float_type);
+  auto& c1 = graph.GetOrCreateNodeArg("c1", &float_type);
+  auto& c2 = graph.GetOrCreateNodeArg("c2", &float_type);
+  auto& c3 = graph.GetOrCreateNodeArg("c3", &float_type);
+  auto& add_1 = graph.GetOrCreateNodeArg("Add1", &float_type);
+  auto& add_2 = graph.GetOrCreateNodeArg("Add2", &float_type);
+  auto& add_3 = graph.GetOrCreateNodeArg("Add3", &float_type);
+  auto& result = graph.GetOrCreateNodeArg("Result", &float_type);
+  graph.AddNode("add_1", "Add", "", {&x, &c1}, {&add_1});
+  graph.AddNode("add_2", "Add", "", {&x, &c2}, {&add_2});
+  graph.AddNode("add_3", "Add", "", {&x, &c3}, {&add_3});
+  graph.AddNode("result", "Sum", "", {&add_1, &add_2, &add_3}, {&result});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ApplyCse(model);
+
+  const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+  ASSERT_EQ(graph.GetAllInitializedTensors().size(), 2U);
+  ASSERT_TRUE(graph.GetInitializedTensor("c1", initializer));
+  ASSERT_TRUE(graph.GetInitializedTensor("c3", initializer));
+
+  auto op_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_count["Add"], 2);
+}
+
+TEST(CseTests, HoistLoopInvariantNodes) {
+  auto float_type = MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType_FLOAT, {2});
+  auto bool_type = MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType_BOOL, {});
+  auto int64_type = MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType_INT64, {});
+
+  // v_out = v_in + (-w * c), where w comes from the main graph and c is an initializer of the body
+  ONNX_NAMESPACE::GraphProto body_proto;
+  {
+    Model body_model("cse_loop_body", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                     {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+    Graph& body = body_model.MainGraph();
+    body.AddInitializedTensor(MakeFloatInitializer("c", {2.f, 3.f}));
+
+    auto& iteration_num = body.GetOrCreateNodeArg("iteration_num", &int64_type);
+    auto& cond_in = body.GetOrCreateNodeArg("cond_in", &bool_type);
+    auto& v_in = body.GetOrCreateNodeArg("v_in", &float_type);
+    auto& w = body.GetOrCreateNodeArg("w", &float_type);
+    body.AddOuterScopeNodeArg("w");
+    auto& c = body.GetOrCreateNodeArg("c", &float_type);
+    auto& neg_w = body.GetOrCreateNodeArg("neg_w", &float_type);
+    auto& scaled_w = body.GetOrCreateNodeArg("scaled_w", &float_type);
+    auto& cond_out = body.GetOrCreateNodeArg("cond_out", &bool_type);
+    auto& v_out = body.GetOrCreateNodeArg("v_out", &float_type);
+    body.AddNode("neg", "Neg", "", {&w}, {&neg_w});
+    body.AddNode("mul", "Mul", "", {&neg_w, &c}, {&scaled_w});
+    body.AddNode("add", "Add", "", {&v_in, &scaled_w}, {&v_out});
+    body.AddNode("cond", "Identity", "", {&cond_in}, {&cond_out});
+    body.SetInputs({&iteration_num, &cond_in, &v_in});
+    body.SetOutputs({&cond_out, &v_out});
+    ASSERT_TRUE(body.Resolve().IsOK());
+    body_proto = body.ToGraphProto();
+  }
+
+  Model model("cse_hoist_loop_invariant_nodes", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  auto& trip_count = graph.GetOrCreateNodeArg("trip_count", &int64_type);
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_type);
+  auto& v = graph.GetOrCreateNodeArg("v", &float_type);
+  auto& w = graph.GetOrCreateNodeArg("w", &float_type);
+  auto& v_final = graph.GetOrCreateNodeArg("v_final", &float_type);
+  auto& loop = graph.AddNode("loop", "Loop", "", {&trip_count, &cond, &v}, {&v_final});
+  loop.AddAttribute("body", body_proto);
+  graph.SetInputs({&trip_count, &cond, &v, &w});
+  graph.SetOutputs({&v_final});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ApplyCse(model);
+
+  auto op_count = CountOpsInGraph(graph, false);
+  ASSERT_EQ(op_count["Loop"], 1);
+  ASSERT_EQ(op_count["Neg"], 1);
+  ASSERT_EQ(op_count["Mul"], 1);
+  ASSERT_EQ(graph.GetAllInitializedTensors().size(), 1U);
+
+  const Graph* body = nullptr;
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Loop") {
+      body = node.GetGraphAttribute("body");
+    }
+  }
+
+  ASSERT_NE(body, nullptr);
+  op_count = CountOpsInGraph(*body, false);
+  ASSERT_EQ(op_count.count("Neg"), 0U);
+  ASSERT_EQ(op_count.count("Mul"), 0U);
+  ASSERT_EQ(op_count["Add"], 1);
+  ASSERT_EQ(op_count["Identity"], 1);
+  ASSERT_TRUE(body->GetAllInitializedTensors().empty());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -26,7 +26,9 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
@@ -40,17 +42,22 @@
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/qdq_transformer.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/optimizer/scan_matmul_hoisting.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/static_shape_specialization.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
 #include "core/platform/env.h"
 #include "core/session/inference_session.h"
 #include "core/util/math.h"
+#include "core/util/thread_utils.h"
 #include "gtest/gtest.h"
 #include "test/capturing_sink.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -251,6 +258,154 @@ TEST_F(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+TEST_F(GraphTransformationTests, ConstantFoldingInlinesIfWithConstantCondition) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto create_branch = [&](const std::string& op_type, GraphProto& graph_proto) {
+    // create a branch that combines a parent graph input with a local initializer
+    Model model("ConstantFoldingInlinesIfTest_" + op_type, false, ModelMetaData(), PathString(),
+                IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    TensorProto local_constant;
+    local_constant.set_name("local_constant");
+    local_constant.add_dims(1);
+    local_constant.add_float_data(1.f);
+    local_constant.set_data_type(TensorProto_DataType_FLOAT);
+    graph.AddInitializedTensor(local_constant);
+
+    auto& local_constant_arg = graph.GetOrCreateNodeArg("local_constant", &float_tensor_type);
+    auto& x_arg = graph.GetOrCreateNodeArg("x", &float_tensor_type);
+    graph.AddOuterScopeNodeArg("x");
+
+    auto& branch_out = graph.GetOrCreateNodeArg("branch_out", &float_tensor_type);
+    graph.AddNode(op_type, op_type, "Combine the parent input and the local constant.", {&x_arg, &local_constant_arg},
+                  {&branch_out});
+
+    ASSERT_STATUS_OK(graph.Resolve());
+    graph_proto = graph.ToGraphProto();
+  };
+
+  Model model("ConstantFoldingInlinesIfTest_main_graph", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TensorProto cond;
+  cond.set_name("if_cond");
+  cond.add_dims(1);
+  cond.add_int32_data(1);
+  cond.set_data_type(TensorProto_DataType_BOOL);
+  graph.AddInitializedTensor(cond);
+
+  TypeProto if_cond_type;
+  if_cond_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  if_cond_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& if_cond_arg = graph.GetOrCreateNodeArg("if_cond", &if_cond_type);
+  auto& x_in_arg = graph.GetOrCreateNodeArg("x_in", &float_tensor_type);
+  auto& x_arg = graph.GetOrCreateNodeArg("x", &float_tensor_type);
+  graph.AddNode("identity", "Identity", "Provide the value the branches use from the parent graph.", {&x_in_arg},
+                {&x_arg});
+  auto& if_output = graph.GetOrCreateNodeArg("if_out", &float_tensor_type);
+
+  auto& if_node = graph.AddNode("if", "If", "If node", {&if_cond_arg}, {&if_output});
+
+  GraphProto then_branch;
+  create_branch("Add", then_branch);
+  GraphProto else_branch;
+  create_branch("Sub", else_branch);
+
+  if_node.AddAttribute("then_branch", then_branch);
+  if_node.AddAttribute("else_branch", else_branch);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::unique_ptr<CPUExecutionProvider> e =
+      onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(*e.get()), TransformerLevel::Level1);
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["If"] == 0) << "The If node with a constant condition should have been inlined";
+  ASSERT_TRUE(op_to_count["Add"] == 1);
+  ASSERT_TRUE(op_to_count["Sub"] == 0);
+
+  // the inlined Add produces the graph output the If node produced
+  const auto* producer = graph.GetProducerNode("if_out");
+  ASSERT_TRUE(producer != nullptr && producer->OpType() == "Add");
+}
+
+// Independent chains of constant nodes are folded level by level on the thread pool.
+TEST_F(GraphTransformationTests, ConstantFoldingParallelLevels) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  Model model("ConstantFoldingParallelLevels", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TensorProto constant;
+  constant.set_name("constant");
+  constant.add_dims(2);
+  constant.add_float_data(1.f);
+  constant.add_float_data(-2.f);
+  constant.set_data_type(TensorProto_DataType_FLOAT);
+  graph.AddInitializedTensor(constant);
+  auto& constant_arg = graph.GetOrCreateNodeArg("constant", &float_tensor_type);
+  auto& x_arg = graph.GetOrCreateNodeArg("x", &float_tensor_type);
+
+  // constant -> Neg -> Abs -> Neg -> Add(x) for each chain, so the three levels of each chain are folded
+  constexpr int num_chains = 8;
+  for (int chain = 0; chain < num_chains; ++chain) {
+    const std::string prefix = "chain_" + std::to_string(chain) + "_";
+    auto& neg_out = graph.GetOrCreateNodeArg(prefix + "neg", &float_tensor_type);
+    auto& abs_out = graph.GetOrCreateNodeArg(prefix + "abs", &float_tensor_type);
+    auto& neg2_out = graph.GetOrCreateNodeArg(prefix + "neg2", &float_tensor_type);
+    auto& add_out = graph.GetOrCreateNodeArg(prefix + "out", &float_tensor_type);
+    graph.AddNode(prefix + "neg", "Neg", "", {&constant_arg}, {&neg_out});
+    graph.AddNode(prefix + "abs", "Abs", "", {&neg_out}, {&abs_out});
+    graph.AddNode(prefix + "neg2", "Neg", "", {&abs_out}, {&neg2_out});
+    graph.AddNode(prefix + "add", "Add", "", {&neg2_out, &x_arg}, {&add_out});
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  OrtThreadPoolParams thread_pool_params;
+  thread_pool_params.thread_pool_size = 4;
+  auto thread_pool = concurrency::CreateThreadPool(&Env::Default(), thread_pool_params,
+                                                   concurrency::ThreadPoolType::INTRA_OP);
+
+  std::unique_ptr<CPUExecutionProvider> e =
+      onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(*e.get(),
+                                                                              std::unordered_set<std::string>{},
+                                                                              std::unordered_set<std::string>{},
+                                                                              thread_pool.get()),
+                                    TransformerLevel::Level1);
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  // a single step is enough to fold all levels
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Neg"], 0);
+  ASSERT_EQ(op_to_count["Abs"], 0);
+  ASSERT_EQ(op_to_count["Add"], num_chains);
+
+  for (int chain = 0; chain < num_chains; ++chain) {
+    const TensorProto* folded = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor("chain_" + std::to_string(chain) + "_neg2", folded));
+    Initializer folded_values{*folded, graph.ModelPath()};
+    ASSERT_EQ(folded_values.size(), 2);
+    EXPECT_EQ(folded_values.data<float>()[0], -1.f);
+    EXPECT_EQ(folded_values.data<float>()[1], -2.f);
+  }
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingWithShapeToInitializer) {
   auto model_uri = MODEL_FOLDER "fusion/constant_folding_with_shape_to_initializer.onnx";
   std::shared_ptr<Model> model;
@@ -323,6 +478,111 @@ TEST_F(GraphTransformationTests, ShapeToInitializer) {
   ASSERT_TRUE(op_to_count["Shape"] == 2);
 }
 
+TEST_F(GraphTransformationTests, StaticShapeSpecialization) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 12;
+  Model model("StaticShapeSpecialization", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(), *logger_);
+  auto& graph = model.MainGraph();
+
+  auto add_int64_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                        const std::vector<int64_t>& values) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_INT64);
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+    }
+    tensor.set_raw_data(values.data(), values.size() * sizeof(int64_t));
+    graph.AddInitializedTensor(tensor);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+
+  // Reshape(Relu(x), Concat(Unsqueeze(Gather(Shape(x), 0)), [3, 4])) is a no-op once N is known.
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", nullptr);
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu_out});
+  auto& shape_out = graph.GetOrCreateNodeArg("shape_out", nullptr);
+  graph.AddNode("shape", "Shape", "", {&x}, {&shape_out});
+  auto& gather_out = graph.GetOrCreateNodeArg("gather_out", nullptr);
+  graph.AddNode("gather", "Gather", "", {&shape_out, &add_int64_initializer("index", {}, {0})}, {&gather_out});
+  auto& unsqueeze_out = graph.GetOrCreateNodeArg("unsqueeze_out", nullptr);
+  graph.AddNode("unsqueeze", "Unsqueeze", "", {&gather_out}, {&unsqueeze_out})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  auto& concat_out = graph.GetOrCreateNodeArg("concat_out", nullptr);
+  graph.AddNode("concat", "Concat", "", {&unsqueeze_out, &add_int64_initializer("inner_dims", {2}, {3, 4})},
+                {&concat_out})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  auto& reshape_out = graph.GetOrCreateNodeArg("reshape_out", nullptr);
+  graph.AddNode("reshape", "Reshape", "", {&relu_out, &concat_out}, {&reshape_out});
+
+  // Expand to a shape the input already has.
+  auto& expand_out = graph.GetOrCreateNodeArg("expand_out", nullptr);
+  graph.AddNode("expand", "Expand", "", {&reshape_out, &add_int64_initializer("expand_shape", {2}, {3, 1})},
+                {&expand_out});
+  auto& sigmoid_out = graph.GetOrCreateNodeArg("sigmoid_out", nullptr);
+  graph.AddNode("sigmoid", "Sigmoid", "", {&expand_out}, {&sigmoid_out});
+
+  // Flatten with Reshape(Sigmoid, Unsqueeze(Size(x))).
+  auto& size_out = graph.GetOrCreateNodeArg("size_out", nullptr);
+  graph.AddNode("size", "Size", "", {&x}, {&size_out});
+  auto& size_unsqueeze_out = graph.GetOrCreateNodeArg("size_unsqueeze_out", nullptr);
+  graph.AddNode("size_unsqueeze", "Unsqueeze", "", {&size_out}, {&size_unsqueeze_out})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  auto& y = graph.GetOrCreateNodeArg("y", nullptr);
+  graph.AddNode("flatten", "Reshape", "", {&sigmoid_out, &size_unsqueeze_out}, {&y});
+
+  graph.SetInputs({&x});
+  graph.SetOutputs({&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  StaticShapeSpecialization::InputShapeMap input_shapes;
+  ASSERT_STATUS_OK(StaticShapeSpecialization::ParseInputShapes("x:2,3,4", input_shapes));
+
+  std::unique_ptr<CPUExecutionProvider> e =
+      onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(*e.get()), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(onnxruntime::make_unique<StaticShapeSpecialization>(input_shapes),
+                                    TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 0);
+  EXPECT_EQ(op_to_count["Gather"], 0);
+  EXPECT_EQ(op_to_count["Unsqueeze"], 0);
+  EXPECT_EQ(op_to_count["Concat"], 0);
+  EXPECT_EQ(op_to_count["Size"], 0);
+  EXPECT_EQ(op_to_count["Expand"], 0);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Sigmoid"], 1);
+
+  const auto* y_shape = graph.GetOutputs()[0]->Shape();
+  ASSERT_TRUE(y_shape != nullptr);
+  ASSERT_EQ(y_shape->dim_size(), 1);
+  EXPECT_EQ(y_shape->dim(0).dim_value(), 24);
+}
+
+TEST_F(GraphTransformationTests, StaticShapeSpecializationParseInputShapes) {
+  StaticShapeSpecialization::InputShapeMap input_shapes;
+  ASSERT_STATUS_OK(StaticShapeSpecialization::ParseInputShapes("input_ids:1,128;scalar:;ns:x:3", input_shapes));
+  ASSERT_EQ(input_shapes.size(), 3u);
+  EXPECT_EQ(input_shapes["input_ids"], (std::vector<int64_t>{1, 128}));
+  EXPECT_TRUE(input_shapes["scalar"].empty());
+  EXPECT_EQ(input_shapes["ns:x"], (std::vector<int64_t>{3}));
+
+  EXPECT_FALSE(StaticShapeSpecialization::ParseInputShapes("input_ids", input_shapes).IsOK());
+  EXPECT_FALSE(StaticShapeSpecialization::ParseInputShapes("input_ids:1,-1", input_shapes).IsOK());
+  EXPECT_FALSE(StaticShapeSpecialization::ParseInputShapes("a:1;a:2", input_shapes).IsOK());
+}
+
 // Check transformations in the case of a subgraph with constant inputs.
 TEST_F(GraphTransformationTests, SubgraphWithConstantInputs) {
   auto model_uri = MODEL_FOLDER "constant-subgraph.onnx";
@@ -501,6 +761,207 @@ TEST_F(GraphTransformationTests, FuseConvClip11Activation) {
     }
   }
 }
+
+TEST_F(GraphTransformationTests, FuseConvAddActivation) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 12;
+  domain_to_version[kMSDomain] = 1;
+  Model model("FuseConvAddActivation", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(), *logger_);
+  auto& graph = model.MainGraph();
+
+  auto add_float_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    std::vector<float> values(size, 0.5f);
+    tensor.set_raw_data(values.data(), values.size() * sizeof(float));
+    graph.AddInitializedTensor(tensor);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {1, 8, 5, 5}) {
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+
+  // Relu(Conv(x) + x), the residual of a ResNet block.
+  auto& conv1_out = graph.GetOrCreateNodeArg("conv1_out", nullptr);
+  graph.AddNode("conv1", "Conv", "", {&x, &add_float_initializer("w1", {8, 8, 3, 3})}, {&conv1_out})
+      .AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  auto& add1_out = graph.GetOrCreateNodeArg("add1_out", nullptr);
+  graph.AddNode("add1", "Add", "", {&conv1_out, &x}, {&add1_out});
+  auto& y1 = graph.GetOrCreateNodeArg("y1", nullptr);
+  graph.AddNode("relu1", "Relu", "", {&add1_out}, {&y1});
+
+  // Conv(x) + b, where the Add broadcasts b so it can't be accumulated into the output.
+  auto& conv2_out = graph.GetOrCreateNodeArg("conv2_out", nullptr);
+  graph.AddNode("conv2", "Conv", "", {&x, &add_float_initializer("w2", {8, 8, 1, 1})}, {&conv2_out});
+  auto& y2 = graph.GetOrCreateNodeArg("y2", nullptr);
+  graph.AddNode("add2", "Add", "", {&conv2_out, &add_float_initializer("b2", {8, 1, 1})}, {&y2});
+
+  graph.SetInputs({&x});
+  graph.SetOutputs({&y1, &y2});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  // the Add is only fused for the CPU execution provider
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConvActivationFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["com.microsoft.FusedConv"], 1);
+  EXPECT_EQ(op_to_count["Conv"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 0);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "FusedConv") {
+      const auto& input_defs = node.InputDefs();
+      ASSERT_EQ(input_defs.size(), 4u);
+      EXPECT_FALSE(input_defs[2]->Exists());
+      EXPECT_EQ(input_defs[3]->Name(), "x");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "y1");
+      EXPECT_EQ(node.GetAttributes().at("activation").s(), "Relu");
+    }
+  }
+}
+
+// x_t * W of every Scan iteration becomes one MatMul of the whole input in the main graph
+TEST_F(GraphTransformationTests, ScanMatMulHoisting) {
+  auto make_type = [](const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  const TypeProto state_type = make_type({2, 3});
+  const TypeProto element_type = make_type({2, 5});
+  const TypeProto weight_type = make_type({5, 3});
+
+  // h_t = Tanh(h_t-1 + x_t * W), where W comes from the main graph
+  GraphProto body_proto;
+  {
+    Model body_model("scan_matmul_hoisting_body", false, ModelMetaData(), PathString(),
+                     IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 11}}, {}, *logger_);
+    Graph& body = body_model.MainGraph();
+    auto& h_prev = body.GetOrCreateNodeArg("h_prev", &state_type);
+    auto& x_t = body.GetOrCreateNodeArg("x_t", &element_type);
+    auto& w = body.GetOrCreateNodeArg("W", &weight_type);
+    body.AddOuterScopeNodeArg("W");
+    auto& xw = body.GetOrCreateNodeArg("xw", &state_type);
+    auto& sum = body.GetOrCreateNodeArg("sum", &state_type);
+    auto& h = body.GetOrCreateNodeArg("h", &state_type);
+    auto& y_t = body.GetOrCreateNodeArg("y_t", &state_type);
+    body.AddNode("matmul", "MatMul", "", {&x_t, &w}, {&xw});
+    body.AddNode("add", "Add", "", {&h_prev, &xw}, {&sum});
+    body.AddNode("tanh", "Tanh", "", {&sum}, {&h});
+    body.AddNode("identity", "Identity", "", {&h}, {&y_t});
+    body.SetInputs({&h_prev, &x_t});
+    body.SetOutputs({&h, &y_t});
+    ASSERT_STATUS_OK(body.Resolve());
+    body_proto = body.ToGraphProto();
+  }
+
+  Model model("scan_matmul_hoisting", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  Graph& graph = model.MainGraph();
+
+  TensorProto w_initializer;
+  w_initializer.set_name("W");
+  w_initializer.set_data_type(TensorProto_DataType_FLOAT);
+  w_initializer.add_dims(5);
+  w_initializer.add_dims(3);
+  for (int i = 0; i < 15; ++i) {
+    w_initializer.add_float_data(0.1f * i - 0.7f);
+  }
+  graph.AddInitializedTensor(w_initializer);
+
+  const TypeProto input_type = make_type({4, 2, 5});
+  const TypeProto output_type = make_type({4, 2, 3});
+  auto& h0 = graph.GetOrCreateNodeArg("h0", &state_type);
+  auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+  graph.GetOrCreateNodeArg("W", &weight_type);
+  auto& h_final = graph.GetOrCreateNodeArg("h_final", &state_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+  auto& scan = graph.AddNode("scan", "Scan", "", {&h0, &x}, {&h_final, &y});
+  scan.AddAttribute("body", body_proto);
+  scan.AddAttribute("num_scan_inputs", static_cast<int64_t>(1));
+  graph.SetInputs({&h0, &x});
+  graph.SetOutputs({&h_final, &y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ScanMatMulHoisting>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph, false);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  ASSERT_EQ(op_to_count["Scan"], 1);
+
+  const Graph* body = nullptr;
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Scan") {
+      body = node.GetGraphAttribute("body");
+      EXPECT_EQ(graph_utils::GetInputNode(node, 1)->OpType(), "MatMul");
+    }
+  }
+
+  ASSERT_NE(body, nullptr);
+  op_to_count = CountOpsInGraph(*body, false);
+  ASSERT_EQ(op_to_count.count("MatMul"), 0U);
+  ASSERT_EQ(body->GetInputs().size(), 2U);
+  EXPECT_EQ(body->GetInputs()[1]->Name(), "xw");
+
+  // the session hoists the MatMul at Level2, which must not change the results
+  RandomValueGenerator random{};
+  OrtValue h0_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                       random.Uniform<float>({2, 3}, -1.0f, 1.0f), &h0_value);
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {4, 2, 5},
+                       random.Uniform<float>({4, 2, 5}, -1.0f, 1.0f), &x_value);
+  NameMLValMap feeds{{"h0", h0_value}, {"X", x_value}};
+  const std::vector<std::string> output_names{"h_final", "Y"};
+
+  auto run_model_test = [&](TransformerLevel level, std::vector<OrtValue>& fetches) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    session_options.session_logid = "OptimizerTests";
+    InferenceSession session{session_options, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_STATUS_OK(session.Run(RunOptions(), feeds, output_names, &fetches));
+  };
+
+  std::vector<OrtValue> unoptimized_fetches;
+  run_model_test(TransformerLevel::Default, unoptimized_fetches);
+
+  std::vector<OrtValue> optimized_fetches;
+  run_model_test(TransformerLevel::Level2, optimized_fetches);
+
+  ASSERT_EQ(optimized_fetches.size(), 2U);
+  for (size_t i = 0; i < optimized_fetches.size(); ++i) {
+    auto ret = CompareOrtValue(optimized_fetches[i], unoptimized_fetches[i], 1e-5, 0.0, false);
+    EXPECT_EQ(ret.first, COMPARE_RESULT::SUCCESS) << ret.second;
+  }
+}
 #endif
 
 TEST_F(GraphTransformationTests, FuseConvMulNoBias) {
@@ -2182,6 +2643,359 @@ TEST_F(GraphTransformationTests, GeluApproximation_Gelu_Add_MatMul) {
   EXPECT_EQ(op_to_count["com.microsoft.FastGelu"], 1);
 }
 
+// Test Add -> Mul -> Tanh -> Relu -> Add with a broadcast input: the first 4 nodes are fused
+TEST_F(GraphTransformationTests, ElementwiseFusion_Chain) {
+  Model model("ElementwiseFusion", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto matrix_type;
+  matrix_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  matrix_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  matrix_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  TypeProto scalar_type;
+  scalar_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  scalar_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto row_type;
+  row_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  row_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &matrix_type);
+  auto& s = graph.GetOrCreateNodeArg("s", &scalar_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &matrix_type);
+  auto& w = graph.GetOrCreateNodeArg("w", &row_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &matrix_type);
+  auto& mul_out = graph.GetOrCreateNodeArg("mul_out", &matrix_type);
+  auto& tanh_out = graph.GetOrCreateNodeArg("tanh_out", &matrix_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &matrix_type);
+  auto& output = graph.GetOrCreateNodeArg("output", &matrix_type);
+
+  graph.AddNode("add", "Add", "x + s", {&x, &s}, {&add_out});
+  graph.AddNode("mul", "Mul", "y * chain", {&y, &add_out}, {&mul_out});
+  graph.AddNode("tanh", "Tanh", "Tanh", {&mul_out}, {&tanh_out});
+  graph.AddNode("relu", "Relu", "Relu", {&tanh_out}, {&relu_out});
+  graph.AddNode("add_row", "Add", "broadcast of w is not fused", {&relu_out, &w}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Tanh"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 0);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "FusedElementwise") {
+      const auto& inputs = node.InputDefs();
+      ASSERT_EQ(inputs.size(), 3u);
+      EXPECT_EQ(inputs[0]->Name(), "x");
+      EXPECT_EQ(inputs[1]->Name(), "s");
+      EXPECT_EQ(inputs[2]->Name(), "y");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "relu_out");
+
+      const auto& ops = graph_utils::GetNodeAttribute(node, "ops")->strings();
+      EXPECT_EQ(std::vector<std::string>(ops.begin(), ops.end()),
+                (std::vector<std::string>{"Add", "Mul", "Tanh", "Relu"}));
+      const auto& chain_input_indices = graph_utils::GetNodeAttribute(node, "chain_input_indices")->ints();
+      EXPECT_EQ(std::vector<int64_t>(chain_input_indices.begin(), chain_input_indices.end()),
+                (std::vector<int64_t>{0, 1, 0, 0}));
+    }
+  }
+}
+
+// Gather -> Mul by Unsqueeze(weights) -> ReduceSum over the bag axis is fused into a weighted EmbeddingBag
+TEST_F(GraphTransformationTests, EmbeddingBagFusion_WeightedSum) {
+  Model model("EmbeddingBagFusion", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](TensorProto_DataType elem_type, std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto table_type = make_type(TensorProto_DataType_FLOAT, {10, 4});
+  TypeProto indices_type = make_type(TensorProto_DataType_INT64, {2, 3});
+  TypeProto weights_type = make_type(TensorProto_DataType_FLOAT, {2, 3});
+  TypeProto unsqueezed_type = make_type(TensorProto_DataType_FLOAT, {2, 3, 1});
+  TypeProto gathered_type = make_type(TensorProto_DataType_FLOAT, {2, 3, 4});
+  TypeProto output_type = make_type(TensorProto_DataType_FLOAT, {2, 4});
+
+  auto& table = graph.GetOrCreateNodeArg("table", &table_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& weights = graph.GetOrCreateNodeArg("weights", &weights_type);
+  auto& unsqueezed = graph.GetOrCreateNodeArg("unsqueezed", &unsqueezed_type);
+  auto& gathered = graph.GetOrCreateNodeArg("gathered", &gathered_type);
+  auto& weighted = graph.GetOrCreateNodeArg("weighted", &gathered_type);
+  auto& output = graph.GetOrCreateNodeArg("output", &output_type);
+
+  graph.AddNode("unsqueeze", "Unsqueeze", "Unsqueeze", {&weights}, {&unsqueezed})
+      .AddAttribute("axes", std::vector<int64_t>{2});
+  graph.AddNode("gather", "Gather", "Gather", {&table, &indices}, {&gathered});
+  graph.AddNode("mul", "Mul", "Mul", {&gathered, &unsqueezed}, {&weighted});
+  Node& reduce = graph.AddNode("reduce", "ReduceSum", "ReduceSum", {&weighted}, {&output});
+  reduce.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["com.microsoft.EmbeddingBag"], 1);
+  EXPECT_EQ(op_to_count["Gather"], 0);
+  EXPECT_EQ(op_to_count["Unsqueeze"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["ReduceSum"], 0);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "EmbeddingBag") {
+      const auto& inputs = node.InputDefs();
+      ASSERT_EQ(inputs.size(), 4u);
+      EXPECT_EQ(inputs[0]->Name(), "table");
+      EXPECT_EQ(inputs[1]->Name(), "indices");
+      EXPECT_FALSE(inputs[2]->Exists());
+      EXPECT_EQ(inputs[3]->Name(), "weights");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+      EXPECT_EQ(graph_utils::GetNodeAttribute(node, "mode")->s(), "sum");
+    }
+  }
+}
+
+// Gather -> ReduceMax is fused, but not when the reduction keeps the bag axis or the gathered rows have other uses
+TEST_F(GraphTransformationTests, EmbeddingBagFusion_Max) {
+  Model model("EmbeddingBagFusion", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto table_type;
+  table_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  table_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(10);
+  table_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  TypeProto indices_type;
+  indices_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  indices_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& table = graph.GetOrCreateNodeArg("table", &table_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& gathered = graph.GetOrCreateNodeArg("gathered", nullptr);
+  auto& output = graph.GetOrCreateNodeArg("output", nullptr);
+  auto& gathered_kept = graph.GetOrCreateNodeArg("gathered_kept", nullptr);
+  auto& output_kept = graph.GetOrCreateNodeArg("output_kept", nullptr);
+  auto& gathered_shared = graph.GetOrCreateNodeArg("gathered_shared", nullptr);
+  auto& output_shared = graph.GetOrCreateNodeArg("output_shared", nullptr);
+  auto& abs_shared = graph.GetOrCreateNodeArg("abs_shared", nullptr);
+
+  graph.AddNode("gather", "Gather", "fused", {&table, &indices}, {&gathered});
+  Node& reduce = graph.AddNode("reduce", "ReduceMax", "fused", {&gathered}, {&output});
+  reduce.AddAttribute("axes", std::vector<int64_t>{-2});
+  reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  graph.AddNode("gather_kept", "Gather", "keepdims", {&table, &indices}, {&gathered_kept});
+  graph.AddNode("reduce_kept", "ReduceMax", "keepdims", {&gathered_kept}, {&output_kept})
+      .AddAttribute("axes", std::vector<int64_t>{1});
+
+  graph.AddNode("gather_shared", "Gather", "shared", {&table, &indices}, {&gathered_shared});
+  Node& reduce_shared = graph.AddNode("reduce_shared", "ReduceMax", "shared", {&gathered_shared}, {&output_shared});
+  reduce_shared.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce_shared.AddAttribute("keepdims", static_cast<int64_t>(0));
+  graph.AddNode("abs_shared", "Abs", "shared", {&gathered_shared}, {&abs_shared});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["com.microsoft.EmbeddingBag"], 1);
+  EXPECT_EQ(op_to_count["Gather"], 2);
+  EXPECT_EQ(op_to_count["ReduceMax"], 2);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "EmbeddingBag") {
+      ASSERT_EQ(node.InputDefs().size(), 2u);
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+      EXPECT_EQ(graph_utils::GetNodeAttribute(node, "mode")->s(), "max");
+    }
+  }
+}
+
+static TypeProto MakeFloatTensorType(const std::vector<int64_t>& dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+// NCHW -> NHWC Transpose, Relu, Add of a per channel bias and NHWC -> NCHW Transpose: both Transposes are removed
+TEST_F(GraphTransformationTests, TransposeOptimizer_CancelThroughElementwise) {
+  Model model("TransposeOptimizer", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto nchw_type = MakeFloatTensorType({1, 3, 4, 5});
+  TypeProto nhwc_type = MakeFloatTensorType({1, 4, 5, 3});
+  TypeProto bias_type = MakeFloatTensorType({3});
+
+  TensorProto bias;
+  bias.set_name("bias");
+  bias.set_data_type(TensorProto_DataType_FLOAT);
+  bias.add_dims(3);
+  for (float value : {1.0f, 2.0f, 3.0f}) {
+    bias.add_float_data(value);
+  }
+  graph.AddInitializedTensor(bias);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &nchw_type);
+  auto& bias_arg = graph.GetOrCreateNodeArg("bias", &bias_type);
+  auto& nhwc = graph.GetOrCreateNodeArg("nhwc", &nhwc_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &nhwc_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &nhwc_type);
+  auto& output = graph.GetOrCreateNodeArg("output", &nchw_type);
+
+  graph.AddNode("to_nhwc", "Transpose", "NCHW to NHWC", {&x}, {&nhwc}).AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  graph.AddNode("relu", "Relu", "Relu", {&nhwc}, {&relu_out});
+  graph.AddNode("add", "Add", "Add a per channel bias", {&relu_out, &bias_arg}, {&add_out});
+  graph.AddNode("to_nchw", "Transpose", "NHWC to NCHW", {&add_out}, {&output}).AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Relu") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "x");
+    } else if (node.OpType() == "Add") {
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+
+      // the bias is transposed back to NCHW
+      const TensorProto* transposed_bias = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      ASSERT_TRUE(transposed_bias != nullptr);
+      EXPECT_EQ(std::vector<int64_t>(transposed_bias->dims().begin(), transposed_bias->dims().end()),
+                (std::vector<int64_t>{1, 3, 1, 1}));
+      Initializer transposed_bias_data{*transposed_bias, graph.ModelPath()};
+      EXPECT_EQ(std::vector<float>(transposed_bias_data.data<float>(), transposed_bias_data.data<float>() + 3),
+                (std::vector<float>{1.0f, 2.0f, 3.0f}));
+    }
+  }
+}
+
+// 2 NHWC Transposes feeding a Concat on the channels, and a ReduceMean over H and W without kept dims:
+// the Concat and the ReduceMean work on NCHW and no Transpose is left
+TEST_F(GraphTransformationTests, TransposeOptimizer_ConcatAndReduce) {
+  Model model("TransposeOptimizer", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto nchw_type = MakeFloatTensorType({2, 3, 4, 5});
+  TypeProto nhwc_type = MakeFloatTensorType({2, 4, 5, 3});
+  TypeProto concat_type = MakeFloatTensorType({2, 4, 5, 6});
+  TypeProto reduced_type = MakeFloatTensorType({2, 6});
+
+  auto& x = graph.GetOrCreateNodeArg("x", &nchw_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &nchw_type);
+  auto& x_nhwc = graph.GetOrCreateNodeArg("x_nhwc", &nhwc_type);
+  auto& y_nhwc = graph.GetOrCreateNodeArg("y_nhwc", &nhwc_type);
+  auto& concat_out = graph.GetOrCreateNodeArg("concat_out", &concat_type);
+  auto& output = graph.GetOrCreateNodeArg("output", &reduced_type);
+
+  graph.AddNode("x_to_nhwc", "Transpose", "NCHW to NHWC", {&x}, {&x_nhwc}).AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  graph.AddNode("y_to_nhwc", "Transpose", "NCHW to NHWC", {&y}, {&y_nhwc}).AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  graph.AddNode("concat", "Concat", "Concat the channels", {&x_nhwc, &y_nhwc}, {&concat_out}).AddAttribute("axis", int64_t{-1});
+  auto& reduce = graph.AddNode("reduce", "ReduceMean", "Global average pooling", {&concat_out}, {&output});
+  reduce.AddAttribute("axes", std::vector<int64_t>{1, 2});
+  reduce.AddAttribute("keepdims", int64_t{0});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  EXPECT_EQ(op_to_count["Concat"], 1);
+  EXPECT_EQ(op_to_count["ReduceMean"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Concat") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "x");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "y");
+      EXPECT_EQ(graph_utils::GetNodeAttribute(node, "axis")->i(), 1);
+    } else if (node.OpType() == "ReduceMean") {
+      std::vector<int64_t> axes;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes));
+      EXPECT_EQ(axes, (std::vector<int64_t>{2, 3}));
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+    }
+  }
+}
+
+// Transposes that don't cancel are merged, and a Transpose followed by a layout sensitive operator stays
+TEST_F(GraphTransformationTests, TransposeOptimizer_MergeAndStop) {
+  Model model("TransposeOptimizer", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type = MakeFloatTensorType({2, 3, 4});
+  TypeProto transposed_type = MakeFloatTensorType({3, 4, 2});
+  TypeProto output_type = MakeFloatTensorType({4, 2, 3});
+  TypeProto softmax_type = MakeFloatTensorType({2, 3, 4});
+
+  auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+  auto& transposed = graph.GetOrCreateNodeArg("transposed", &transposed_type);
+  auto& sigmoid_out = graph.GetOrCreateNodeArg("sigmoid_out", &transposed_type);
+  auto& output = graph.GetOrCreateNodeArg("output", &output_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &input_type);
+  auto& y_transposed = graph.GetOrCreateNodeArg("y_transposed", &transposed_type);
+  auto& softmax_out = graph.GetOrCreateNodeArg("softmax_out", &transposed_type);
+
+  graph.AddNode("transpose0", "Transpose", "", {&x}, {&transposed}).AddAttribute("perm", std::vector<int64_t>{1, 2, 0});
+  graph.AddNode("sigmoid", "Sigmoid", "", {&transposed}, {&sigmoid_out});
+  graph.AddNode("transpose1", "Transpose", "", {&sigmoid_out}, {&output}).AddAttribute("perm", std::vector<int64_t>{1, 2, 0});
+  graph.AddNode("transpose2", "Transpose", "", {&y}, {&y_transposed}).AddAttribute("perm", std::vector<int64_t>{1, 2, 0});
+  graph.AddNode("softmax", "Softmax", "", {&y_transposed}, {&softmax_out});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 2);
+  EXPECT_EQ(op_to_count["Sigmoid"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Transpose" && node.OutputDefs()[0]->Name() == "output") {
+      // (1, 2, 0) twice is (2, 0, 1)
+      EXPECT_EQ(graph.GetProducerNode(node.InputDefs()[0]->Name())->OpType(), "Sigmoid");
+      std::vector<int64_t> perm;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm));
+      EXPECT_EQ(perm, (std::vector<int64_t>{2, 0, 1}));
+    }
+  }
+}
+
 TEST_F(GraphTransformationTests, FastGeluFusionTest) {
   auto model_uri = MODEL_FOLDER "fusion/fast_gelu.onnx";
   std::shared_ptr<Model> p_model;
@@ -2364,13 +3178,13 @@ struct BiasSoftmaxFusionTester {
   BiasSoftmaxFusionTester(
       const PathString& model_uri,
       onnxruntime::logging::Logger* logger,
-      bool on_cuda_ = true) : logger_(logger), graph_transformation_mgr_{5} {
+      const std::string& provider = kCudaExecutionProvider) : logger_(logger), graph_transformation_mgr_{5} {
     model_load_ = Model::Load(model_uri, p_model_, nullptr, *logger_);
 
-    // move to cuda since fusion only takes place in that case
-    if (on_cuda_) {
+    // assign the nodes to the provider since fusion only takes place on cuda and cpu
+    if (!provider.empty()) {
       for (auto& node : p_model_->MainGraph().Nodes()) {
-        node.SetExecutionProviderType(kCudaExecutionProvider);
+        node.SetExecutionProviderType(provider);
       }
     }
 
@@ -2415,10 +3229,16 @@ struct BiasSoftmaxFusionTester {
 
 TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_CudaOnly) {
   auto model_uri = MODEL_FOLDER "fusion/bias_softmax_fusion_simple.onnx";
-  BiasSoftmaxFusionTester tester(model_uri, logger_.get(), false);
+  BiasSoftmaxFusionTester tester(model_uri, logger_.get(), "");
   tester.TestNoFusionOccurs();
 }
 
+TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_Cpu) {
+  auto model_uri = MODEL_FOLDER "fusion/bias_softmax_fusion_middleones.onnx";
+  BiasSoftmaxFusionTester tester(model_uri, logger_.get(), kCpuExecutionProvider);
+  tester.TestFusionOccurs(3);
+}
+
 TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_Simple) {
   auto model_uri = MODEL_FOLDER "fusion/bias_softmax_fusion_simple.onnx";
   BiasSoftmaxFusionTester tester(model_uri, logger_.get());
@@ -3379,6 +4199,163 @@ TEST_F(GraphTransformationTests, MatMulScaleFusionUnsupportedInputType) {
       },
       {kCpuExecutionProvider});
 }
+template <typename T>
+static NodeArg& AddQDQTestInitializer(Graph& graph, const std::string& name, TensorProto_DataType data_type,
+                                      const std::vector<int64_t>& dims, const std::vector<T>& values) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(data_type);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  tensor.set_raw_data(values.data(), values.size() * sizeof(T));
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+static NodeArg& AddQDQTestInput(Graph& graph, const std::string& name, TensorProto_DataType data_type,
+                                const std::vector<int64_t>& dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  for (auto dim : dims) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+// Adds a QuantizeLinear or DequantizeLinear node with a constant uint8_t zero point.
+static NodeArg& AddQDQTestNode(Graph& graph, const std::string& op_type, NodeArg& input,
+                               float scale, uint8_t zero_point, const std::string& prefix) {
+  auto& scale_arg = AddQDQTestInitializer<float>(graph, prefix + "_scale", TensorProto_DataType_FLOAT, {}, {scale});
+  auto& zero_point_arg = AddQDQTestInitializer<uint8_t>(graph, prefix + "_zero_point", TensorProto_DataType_UINT8,
+                                                        {}, {zero_point});
+  auto& output = graph.GetOrCreateNodeArg(prefix + "_output", nullptr);
+  graph.AddNode(prefix, op_type, "", {&input, &scale_arg, &zero_point_arg}, {&output});
+  return output;
+}
+
+static std::unordered_map<std::string, int> QDQTestDomains() {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 13;
+  domain_to_version[kMSDomain] = 1;
+  return domain_to_version;
+}
+
+TEST_F(GraphTransformationTests, QDQTransformerConvPoolReshapeAdd) {
+  Model model("QDQTransformer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              QDQTestDomains(), std::vector<ONNX_NAMESPACE::FunctionProto>(), *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& x = AddQDQTestInput(graph, "x", TensorProto_DataType_UINT8, {1, 3, 8, 8});
+  auto& y = AddQDQTestInput(graph, "y", TensorProto_DataType_UINT8, {1, 64});
+
+  // DQ(x), DQ(w), DQ(bias) -> Conv -> Q
+  auto& x_dq = AddQDQTestNode(graph, "DequantizeLinear", x, .05f, 128, "x_dq");
+  auto& w = AddQDQTestInitializer<uint8_t>(graph, "w", TensorProto_DataType_UINT8, {4, 3, 3, 3},
+                                           std::vector<uint8_t>(4 * 3 * 3 * 3, 130));
+  auto& w_dq = AddQDQTestNode(graph, "DequantizeLinear", w, .02f, 120, "w_dq");
+  auto& bias = AddQDQTestInitializer<int32_t>(graph, "bias", TensorProto_DataType_INT32, {4}, {1, -2, 3, -4});
+  auto& bias_scale = AddQDQTestInitializer<float>(graph, "bias_scale", TensorProto_DataType_FLOAT, {}, {.05f * .02f});
+  auto& bias_dq = graph.GetOrCreateNodeArg("bias_dq_output", nullptr);
+  graph.AddNode("bias_dq", "DequantizeLinear", "", {&bias, &bias_scale}, {&bias_dq});
+  auto& conv_output = graph.GetOrCreateNodeArg("conv_output", nullptr);
+  auto& conv = graph.AddNode("conv", "Conv", "", {&x_dq, &w_dq, &bias_dq}, {&conv_output});
+  conv.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  auto& conv_q = AddQDQTestNode(graph, "QuantizeLinear", conv_output, .1f, 100, "conv_q");
+
+  // DQ -> MaxPool -> Q with matching parameters.
+  auto& pool_dq = AddQDQTestNode(graph, "DequantizeLinear", conv_q, .1f, 100, "pool_dq");
+  auto& pool_output = graph.GetOrCreateNodeArg("pool_output", nullptr);
+  auto& pool = graph.AddNode("pool", "MaxPool", "", {&pool_dq}, {&pool_output});
+  pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  pool.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  auto& pool_q = AddQDQTestNode(graph, "QuantizeLinear", pool_output, .1f, 100, "pool_q");
+
+  // DQ -> Reshape -> Q with matching parameters.
+  auto& reshape_dq = AddQDQTestNode(graph, "DequantizeLinear", pool_q, .1f, 100, "reshape_dq");
+  auto& shape = AddQDQTestInitializer<int64_t>(graph, "shape", TensorProto_DataType_INT64, {2}, {1, -1});
+  auto& reshape_output = graph.GetOrCreateNodeArg("reshape_output", nullptr);
+  graph.AddNode("reshape", "Reshape", "", {&reshape_dq, &shape}, {&reshape_output});
+  auto& reshape_q = AddQDQTestNode(graph, "QuantizeLinear", reshape_output, .1f, 100, "reshape_q");
+
+  // DQ, DQ -> Add -> Q
+  auto& add_a_dq = AddQDQTestNode(graph, "DequantizeLinear", reshape_q, .1f, 100, "add_a_dq");
+  auto& add_b_dq = AddQDQTestNode(graph, "DequantizeLinear", y, .07f, 90, "add_b_dq");
+  auto& add_output = graph.GetOrCreateNodeArg("add_output", nullptr);
+  graph.AddNode("add", "Add", "", {&add_a_dq, &add_b_dq}, {&add_output});
+  auto& output = AddQDQTestNode(graph, "QuantizeLinear", add_output, .15f, 110, "add_q");
+
+  graph.SetInputs({&x, &y});
+  graph.SetOutputs({&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQTransformer>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["QLinearConv"], 1);
+  EXPECT_EQ(op_to_count["MaxPool"], 1);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+  EXPECT_EQ(op_to_count["com.microsoft.QLinearAdd"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "QLinearConv") {
+      ASSERT_EQ(node.InputDefs().size(), 9u);
+      EXPECT_EQ(node.InputDefs()[8]->Name(), "bias");
+    }
+  }
+}
+
+TEST_F(GraphTransformationTests, QDQTransformerMatMulAndMismatchedPassThrough) {
+  Model model("QDQTransformer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              QDQTestDomains(), std::vector<ONNX_NAMESPACE::FunctionProto>(), *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& a = AddQDQTestInput(graph, "a", TensorProto_DataType_UINT8, {2, 8});
+
+  // DQ(a), DQ(b) -> MatMul -> Q where DQ(a) also feeds a float graph output.
+  auto& a_dq = AddQDQTestNode(graph, "DequantizeLinear", a, .04f, 128, "a_dq");
+  auto& b = AddQDQTestInitializer<uint8_t>(graph, "b", TensorProto_DataType_UINT8, {8, 4},
+                                           std::vector<uint8_t>(8 * 4, 140));
+  auto& b_dq = AddQDQTestNode(graph, "DequantizeLinear", b, .03f, 128, "b_dq");
+  auto& matmul_output = graph.GetOrCreateNodeArg("matmul_output", nullptr);
+  graph.AddNode("matmul", "MatMul", "", {&a_dq, &b_dq}, {&matmul_output});
+  auto& matmul_q = AddQDQTestNode(graph, "QuantizeLinear", matmul_output, .2f, 100, "matmul_q");
+  auto& a_float = graph.GetOrCreateNodeArg("a_float", nullptr);
+  graph.AddNode("a_identity", "Identity", "", {&a_dq}, {&a_float});
+
+  // DQ -> Reshape -> Q with a different output scale must stay in float.
+  auto& reshape_dq = AddQDQTestNode(graph, "DequantizeLinear", matmul_q, .2f, 100, "reshape_dq");
+  auto& shape = AddQDQTestInitializer<int64_t>(graph, "shape", TensorProto_DataType_INT64, {1}, {-1});
+  auto& reshape_output = graph.GetOrCreateNodeArg("reshape_output", nullptr);
+  graph.AddNode("reshape", "Reshape", "", {&reshape_dq, &shape}, {&reshape_output});
+  auto& output = AddQDQTestNode(graph, "QuantizeLinear", reshape_output, .3f, 100, "reshape_q");
+
+  graph.SetInputs({&a});
+  graph.SetOutputs({&output, &a_float});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQTransformer>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["QLinearMatMul"], 1);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+  // DQ(a) is kept for the Identity and the Reshape keeps its DQ and Q.
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 2);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 1);
+}
+
 #endif
 
 }  // namespace test
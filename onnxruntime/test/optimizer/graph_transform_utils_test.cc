@@ -65,24 +65,25 @@ TEST(GraphTransformerUtilsTests, TestGenerateGraphTransformers) {
 
 TEST(GraphTransformerUtilsTests, TestCustomOnlyTransformers) {
   // Transformers that are disabled by default. They can only be enabled by custom list.
-  std::string l2_transformer = "GeluApproximation";
   std::unique_ptr<CPUExecutionProvider> cpu_execution_provider =
       onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
 
-  std::vector<std::string> default_list = {};
-  auto default_transformers = optimizer_utils::GenerateTransformers(TransformerLevel::Level2, {}, *cpu_execution_provider.get(), default_list);
-  for (auto& transformer : default_transformers) {
-    ASSERT_TRUE(transformer->Name() != l2_transformer);
-  }
+  for (const std::string l2_transformer : {"GeluApproximation", "ElementwiseFusion"}) {
+    std::vector<std::string> default_list = {};
+    auto default_transformers = optimizer_utils::GenerateTransformers(TransformerLevel::Level2, {}, *cpu_execution_provider.get(), default_list);
+    for (auto& transformer : default_transformers) {
+      ASSERT_TRUE(transformer->Name() != l2_transformer);
+    }
 
-  std::vector<std::string> custom_list = {l2_transformer};
-  auto custom_transformers = optimizer_utils::GenerateTransformers(TransformerLevel::Level2, {}, *cpu_execution_provider.get(), custom_list);
+    std::vector<std::string> custom_list = {l2_transformer};
+    auto custom_transformers = optimizer_utils::GenerateTransformers(TransformerLevel::Level2, {}, *cpu_execution_provider.get(), custom_list);
 #ifndef DISABLE_CONTRIB_OPS
-  ASSERT_TRUE(custom_transformers.size() == 1);
-  ASSERT_TRUE(custom_transformers[0]->Name() == l2_transformer);
+    ASSERT_TRUE(custom_transformers.size() == 1);
+    ASSERT_TRUE(custom_transformers[0]->Name() == l2_transformer);
 #else
-  ASSERT_TRUE(custom_transformers.size() == 0);
+    ASSERT_TRUE(custom_transformers.size() == 0);
 #endif
+  }
 }
 
 }  // namespace test
@@ -563,6 +563,42 @@ TEST(NchwcOptimizerTests, ConvAddFusion) {
   }
 }
 
+TEST(NchwcOptimizerTests, ConvAddActivationFusion) {
+  auto test_case = [&](const std::string& activation_op_type) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({1, 32, 28, 28});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* add_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+      helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+      helper.AddNode("Add", {conv1_output_arg, conv2_output_arg}, {add_output_arg});
+      auto& activation_node = helper.AddNode(activation_op_type, {add_output_arg}, {output_arg});
+      activation_node.AddAttribute("alpha", 0.25f);
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["Add"], 0);
+      EXPECT_EQ(op_to_count[activation_op_type], 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that the activations with parameters can be fused into the NCHWc
+  // Conv node after the Conv/Add fusion.
+  std::vector<std::string> activation_op_types{"LeakyRelu", "HardSigmoid"};
+  for (auto& activation_op_type : activation_op_types) {
+    test_case(activation_op_type);
+  }
+}
+
 TEST(NchwcOptimizerTests, ConvNoBiasAddFusion) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput<float>({1, 32, 28, 28});
@@ -710,6 +746,94 @@ TEST(NchwcOptimizerTests, ConvConcat) {
   test_case(0, 64, 3);
 }
 
+TEST(NchwcOptimizerTests, ConvSplit) {
+  auto test_case = [&](int opset_version, const std::vector<int64_t>& split, int reorder_output_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({1, 48, 17, 34});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* split1_output_arg = helper.MakeIntermediate();
+      auto* split2_output_arg = helper.MakeIntermediate();
+      auto* output1_arg = helper.MakeOutput();
+      auto* output2_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {96, 48, 3, 3});
+
+      auto& split_node = helper.AddNode("Split", {conv_output_arg}, {split1_output_arg, split2_output_arg});
+      split_node.AddAttribute("axis", static_cast<int64_t>(1));
+      if (!split.empty()) {
+        split_node.AddAttribute("split", split);
+      }
+
+      helper.AddConvNode(split1_output_arg, output1_arg, {32, split.empty() ? 48 : split[0], 3, 3});
+      helper.AddNode("Relu", {split2_output_arg}, {output2_arg});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], reorder_output_count == 2 ? 2 : 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], reorder_output_count);
+      EXPECT_EQ(op_to_count["Split"], 1);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, opset_version);
+  };
+
+  for (int opset_version : {10, 11}) {
+    // Split along channel axis with aligned channel counts (stays in NCHWc format).
+    test_case(opset_version, {64, 32}, 2);
+    test_case(opset_version, {}, 2);
+
+    // Split along channel axis with unaligned channel counts (reorders back to NCHW).
+    test_case(opset_version, {60, 36}, 1);
+  }
+}
+
+TEST(NchwcOptimizerTests, SqueezeExcite) {
+  auto test_case = [&](int64_t batch_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({batch_count, 32, 19, 23});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* swish_sigmoid_output_arg = helper.MakeIntermediate();
+      auto* swish_output_arg = helper.MakeIntermediate();
+      auto* pool_output_arg = helper.MakeIntermediate();
+      auto* reduce_output_arg = helper.MakeIntermediate();
+      auto* reduce_relu_output_arg = helper.MakeIntermediate();
+      auto* expand_output_arg = helper.MakeIntermediate();
+      auto* scale_output_arg = helper.MakeIntermediate();
+      auto* mul_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {64, 32, 3, 3});
+      helper.AddNode("Sigmoid", {conv1_output_arg}, {swish_sigmoid_output_arg});
+      helper.AddNode("Mul", {conv1_output_arg, swish_sigmoid_output_arg}, {swish_output_arg});
+      helper.AddNode("GlobalAveragePool", {swish_output_arg}, {pool_output_arg});
+      helper.AddConvNode(pool_output_arg, reduce_output_arg, {16, 64, 1, 1});
+      helper.AddNode("Relu", {reduce_output_arg}, {reduce_relu_output_arg});
+      helper.AddConvNode(reduce_relu_output_arg, expand_output_arg, {64, 16, 1, 1});
+      helper.AddNode("Sigmoid", {expand_output_arg}, {scale_output_arg});
+      helper.AddNode("Mul", {scale_output_arg, swish_output_arg}, {mul_output_arg});
+      helper.AddConvNode(mul_output_arg, output_arg, {16, 64, 1, 1});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 4);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.GlobalAveragePool"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ScaleChannels"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["Mul"], 1);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that the whole squeeze and excite block with a Swish activation
+  // stays in NCHWc format.
+  test_case(1);
+  test_case(3);
+}
+
 TEST(NchwcOptimizerTests, ConvReuseWeightsOIHWBiBo) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput<float>({1, 64, 7, 7});
@@ -1081,6 +1205,66 @@ TEST(NchwcOptimizerTests, BatchNormalization) {
   test_case(true);
 }
 
+TEST(NchwcOptimizerTests, InstanceNormalization) {
+  auto test_case = [&](const std::string& activation_op_type) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({2, 3, 29, 25});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      // Using a channel count not aligned to the block size to verify handling
+      // of unaligned data.
+      helper.AddConvNode(input_arg, conv_output_arg, {34, 3, 3, 3});
+
+      std::vector<float> in_scale(34);
+      std::vector<float> in_bias(34);
+
+      for (int i = 0; i < 34; i++) {
+        in_scale[i] = static_cast<float>((i % 5) + 1) * 0.25f;
+        in_bias[i] = static_cast<float>(i - 17) * 0.125f;
+      }
+
+      auto* in_scale_arg = helper.Make1DInitializer(in_scale);
+      auto* in_bias_arg = helper.Make1DInitializer(in_bias);
+
+      if (activation_op_type.empty()) {
+        auto& in_node = helper.AddNode("InstanceNormalization", {conv_output_arg, in_scale_arg, in_bias_arg},
+                                       {output_arg});
+        in_node.AddAttribute("epsilon", 1e-3f);
+      } else {
+        auto* in_output_arg = helper.MakeIntermediate();
+        helper.AddNode("InstanceNormalization", {conv_output_arg, in_scale_arg, in_bias_arg}, {in_output_arg});
+        helper.AddNode(activation_op_type, {in_output_arg}, {output_arg});
+      }
+
+      // The moments of the channels are accumulated in a different order for
+      // the NCHWc layout.
+      helper.per_sample_tolerance_ = .0001;
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.InstanceNormalization"], 1);
+      EXPECT_EQ(op_to_count["InstanceNormalization"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+      if (!activation_op_type.empty()) {
+        EXPECT_EQ(op_to_count[activation_op_type], 0);
+      }
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that an instance normalization node can use the NCHWc input and
+  // that a following activation is fused into the NCHWc node.
+  std::vector<std::string> activation_op_types{"", "Relu", "LeakyRelu"};
+  for (const auto& activation_op_type : activation_op_types) {
+    test_case(activation_op_type);
+  }
+}
+
 TEST(NchwcOptimizerTests, ConvReorderOutputNhwc) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput<float>({1, 64, 28, 32});
@@ -1227,7 +1411,7 @@ TEST(NchwcOptimizerTests, Activation) {
 
   // Verify that the optimizer doesn't add reorders for these activations that
   // cannot be fused with a convolution.
-  std::vector<std::string> activation_op_types{"Relu", "Sigmoid", "Tanh"};
+  std::vector<std::string> activation_op_types{"Relu", "Sigmoid", "Tanh", "LeakyRelu", "HardSigmoid"};
   for (auto& activation_op_type : activation_op_types) {
     test_case(activation_op_type);
   }
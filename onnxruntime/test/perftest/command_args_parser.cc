@@ -3,6 +3,7 @@
 
 #include "command_args_parser.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <iostream>
 
@@ -50,13 +51,18 @@ namespace perftest {
       "\t-u [optimized_model_path]: Specify the optimized model path for saving.\n"
       "\t-d [cudnn_conv_algorithm]: Specify CUDNN convolution algothrithms: 0(benchmark), 1(heuristic), 2(default). \n"
       "\t-q: [CUDA only] use separate stream for copy. \n"
+      "\t-Q [target_qps]: Run an open-loop load test: requests arrive at random (Poisson) times, on average "
+      "target_qps per second, and the -c clients serve them. The latency of a request is counted from its arrival, "
+      "so queueing is included.\n"
+      "\t-S [sessions_count]: [Load test only] Number of sessions the clients share. Default:1.\n"
+      "\t-j [json_file]: [Load test only] Write the load test results as JSON to the file. Default: standard output.\n"
       "\t-z: Set denormal as zero. When turning on this option reduces latency dramatically, a model may have denormals.\n"
       "\t-h: help\n");
 }
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:AMPIvhsqz"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:Q:S:j:AMPIvhsqz"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -189,6 +195,25 @@ namespace perftest {
       case 'z':
         test_config.run_config.set_denormal_as_zero = true;
         break;
+      case 'Q':
+#ifdef _WIN32
+        test_config.run_config.target_qps = wcstod(optarg, nullptr);
+#else
+        test_config.run_config.target_qps = strtod(optarg, nullptr);
+#endif
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
+      case 'S':
+        test_config.run_config.sessions_count = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        if (test_config.run_config.sessions_count <= 0) {
+          return false;
+        }
+        break;
+      case 'j':
+        test_config.run_config.json_result_file = optarg;
+        break;
       case '?':
       case 'h':
       default:
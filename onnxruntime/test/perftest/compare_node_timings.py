@@ -0,0 +1,239 @@
+#-------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation.  All rights reserved.
+# Licensed under the MIT License.
+#--------------------------------------------------------------------------
+
+# Compares the per-node kernel times of a model between two onnxruntime builds or two session configurations.
+#
+# The tool runs onnxruntime_perf_test with profiling for the baseline and the candidate, alternating between them
+# to spread the drift of the machine over both, or reads profiles from earlier runs. Every run of the model in a
+# profile is one sample of the time of each node; the first run, the warm up, is dropped. For each node the ratio of
+# the median times of the candidate and the baseline is reported with a bootstrap confidence interval, and a node
+# is reported as a regression or an improvement when the interval doesn't contain 1 and the change is larger than
+# the threshold. The same is reported per op type, with the sum of the times of the nodes of the type in a run.
+#
+# Examples:
+#   python compare_node_timings.py --baseline_perf_test old/onnxruntime_perf_test \
+#       --candidate_perf_test new/onnxruntime_perf_test --perf_test_args "-e cpu -x 1" model_dir/model.onnx
+#   python compare_node_timings.py --perf_test_args "-e cuda" --candidate_perf_test_args "-e cuda -o 1" model.onnx
+#   python compare_node_timings.py --baseline_profiles a_*.json --candidate_profiles b_*.json
+
+import argparse
+import csv
+import glob
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+from collections import defaultdict
+
+import numpy as np
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('model', nargs='?', help='model to run with onnxruntime_perf_test')
+    parser.add_argument('--baseline_perf_test', default='onnxruntime_perf_test', help='perf test of the baseline build')
+    parser.add_argument('--candidate_perf_test', default=None,
+                        help='perf test of the candidate build. Default: the one of the baseline')
+    parser.add_argument('--perf_test_args', default='', help='perf test arguments of the baseline')
+    parser.add_argument('--candidate_perf_test_args', default=None,
+                        help='perf test arguments of the candidate. Default: the ones of the baseline')
+    parser.add_argument('--runs', type=int, default=3, help='perf test runs of each of the baseline and the candidate')
+    parser.add_argument('--repeats', type=int, default=100, help='model runs in each perf test run')
+    parser.add_argument('--baseline_profiles', nargs='+', default=None,
+                        help='profiles of the baseline to compare instead of running the perf test')
+    parser.add_argument('--candidate_profiles', nargs='+', default=None,
+                        help='profiles of the candidate to compare instead of running the perf test')
+    parser.add_argument('--confidence', type=float, default=0.99, help='confidence level of the intervals')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='smallest relative change of the median reported as significant')
+    parser.add_argument('--bootstrap_samples', type=int, default=2000, help='resamples of the bootstrap')
+    parser.add_argument('--min_time_us', type=float, default=5.0,
+                        help='nodes whose baseline median is below this time in microseconds are not reported')
+    parser.add_argument('--all', action='store_true', help='report the nodes without a significant change too')
+    parser.add_argument('--csv', default=None, help='file to write the comparison of all the nodes and op types to')
+    args = parser.parse_args()
+
+    if (args.baseline_profiles is None) != (args.candidate_profiles is None):
+        parser.error('--baseline_profiles and --candidate_profiles go together')
+    if args.baseline_profiles is None and args.model is None:
+        parser.error('a model is required to run the perf test')
+    return args
+
+
+def load_profile(path):
+    """Returns {node name: (op type, [kernel times in us, one for each run of the model but the first])}."""
+    with open(path) as f:
+        events = json.load(f)
+
+    nodes = {}
+    run = -1
+    for event in events:
+        category = event.get('cat')
+        if category == 'Session' and event.get('name') == 'model_run':
+            # the session events are written when they end, so they follow the node events of their run
+            run += 1
+        elif category == 'Node' and event.get('name', '').endswith('_kernel_time'):
+            # run + 1 is the index of the run the node belongs to, 0 being the warm up
+            if run + 1 == 0:
+                continue
+            name = event['name'][:-len('_kernel_time')]
+            op_type = event.get('args', {}).get('op_name', '')
+            nodes.setdefault(name, (op_type, defaultdict(float)))[1][run + 1] += event['dur']
+
+    return nodes
+
+
+def load_profiles(paths):
+    """Merges the profiles into {node name: (op type, np.array of times)} and {op type: np.array of times}."""
+    node_times = {}
+    op_times = defaultdict(list)
+    for path in paths:
+        op_runs = defaultdict(lambda: defaultdict(float))
+        for name, (op_type, runs) in load_profile(path).items():
+            node_times.setdefault(name, (op_type, []))[1].extend(runs.values())
+            for run, time in runs.items():
+                op_runs[op_type][run] += time
+        for op_type, runs in op_runs.items():
+            op_times[op_type].extend(runs.values())
+
+    return ({name: (op_type, np.array(times)) for name, (op_type, times) in node_times.items()},
+            {op_type: np.array(times) for op_type, times in op_times.items()})
+
+
+def run_perf_test(perf_test, perf_test_args, model, repeats, profile_dir, tag, index):
+    """Runs the perf test with profiling and returns the path of the profile it wrote."""
+    prefix = os.path.join(profile_dir, '{}_{}'.format(tag, index))
+    command = [perf_test] + shlex.split(perf_test_args) + ['-m', 'times', '-r', str(repeats), '-p', prefix, model]
+    print('running: ' + ' '.join(command), file=sys.stderr)
+    subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+
+    # the session appends the time to the prefix of the profile
+    profiles = glob.glob(prefix + '_*.json')
+    if len(profiles) != 1:
+        raise RuntimeError('expected one profile with the prefix {}, found {}'.format(prefix, len(profiles)))
+    return profiles[0]
+
+
+def compare(baseline, candidate, confidence, bootstrap_samples, rng):
+    """Returns the ratio of the medians of the candidate and the baseline, and its bootstrap confidence interval."""
+    baseline_median = np.median(baseline)
+    ratio = np.median(candidate) / baseline_median if baseline_median > 0 else float('nan')
+
+    baseline_medians = np.median(rng.choice(baseline, (bootstrap_samples, len(baseline))), axis=1)
+    candidate_medians = np.median(rng.choice(candidate, (bootstrap_samples, len(candidate))), axis=1)
+    with np.errstate(divide='ignore', invalid='ignore'):
+        ratios = candidate_medians / baseline_medians
+    alpha = (1 - confidence) / 2
+    low, high = np.nanquantile(ratios, [alpha, 1 - alpha])
+    return ratio, low, high
+
+
+def classify(low, high, ratio, threshold):
+    if low > 1 and ratio > 1 + threshold:
+        return 'regression'
+    if high < 1 and ratio < 1 - threshold:
+        return 'improvement'
+    return ''
+
+
+RESULT_FIELDS = ['name', 'op_type', 'baseline_us', 'candidate_us', 'ratio', 'ci_low', 'ci_high', 'samples', 'change']
+
+
+def compare_all(baseline_times, candidate_times, args, rng):
+    """Compares the entries of the two {key: (op type, times)} maps, sorted by the change, largest regression first."""
+    results = []
+    for key, (op_type, baseline) in baseline_times.items():
+        if key not in candidate_times:
+            continue
+        candidate = candidate_times[key][1]
+        if len(baseline) < 2 or len(candidate) < 2:
+            continue
+        ratio, low, high = compare(baseline, candidate, args.confidence, args.bootstrap_samples, rng)
+        results.append({
+            'name': key,
+            'op_type': op_type,
+            'baseline_us': float(np.median(baseline)),
+            'candidate_us': float(np.median(candidate)),
+            'ratio': float(ratio),
+            'ci_low': float(low),
+            'ci_high': float(high),
+            'samples': min(len(baseline), len(candidate)),
+            'change': classify(low, high, ratio, args.threshold)
+        })
+    results.sort(key=lambda result: result['ratio'], reverse=True)
+    return results
+
+
+def print_results(title, results, args):
+    reported = [
+        result for result in results
+        if (args.all or result['change']) and result['baseline_us'] >= args.min_time_us
+    ]
+    print('{} ({} of {} compared, {:.0%} confidence intervals)'.format(title, len(reported), len(results),
+                                                                       args.confidence))
+    if not reported:
+        return
+    print('{:<48} {:<24} {:>12} {:>12} {:>8} {:>19}  {}'.format('name', 'op type', 'baseline us', 'candidate us',
+                                                                 'ratio', 'interval', 'change'))
+    for result in reported:
+        print('{:<48} {:<24} {:>12.1f} {:>12.1f} {:>8.3f} {:>8.3f} - {:<8.3f}  {}'.format(
+            result['name'][:48], result['op_type'][:24], result['baseline_us'], result['candidate_us'],
+            result['ratio'], result['ci_low'], result['ci_high'], result['change']))
+
+
+def main():
+    args = parse_arguments()
+
+    if args.baseline_profiles is not None:
+        baseline_profiles = args.baseline_profiles
+        candidate_profiles = args.candidate_profiles
+    else:
+        candidate_perf_test = args.candidate_perf_test or args.baseline_perf_test
+        candidate_args = args.perf_test_args if args.candidate_perf_test_args is None else args.candidate_perf_test_args
+        profile_dir = tempfile.mkdtemp(prefix='compare_node_timings_')
+        baseline_profiles = []
+        candidate_profiles = []
+        for index in range(args.runs):
+            baseline_profiles.append(
+                run_perf_test(args.baseline_perf_test, args.perf_test_args, args.model, args.repeats, profile_dir,
+                              'baseline', index))
+            candidate_profiles.append(
+                run_perf_test(candidate_perf_test, candidate_args, args.model, args.repeats, profile_dir, 'candidate',
+                              index))
+        print('profiles are in ' + profile_dir, file=sys.stderr)
+
+    baseline_nodes, baseline_ops = load_profiles(baseline_profiles)
+    candidate_nodes, candidate_ops = load_profiles(candidate_profiles)
+
+    rng = np.random.default_rng(0)
+    op_results = compare_all({op_type: (op_type, times) for op_type, times in baseline_ops.items()},
+                             {op_type: (op_type, times) for op_type, times in candidate_ops.items()}, args, rng)
+    node_results = compare_all(baseline_nodes, candidate_nodes, args, rng)
+
+    print_results('Op types', op_results, args)
+    print()
+    print_results('Nodes', node_results, args)
+
+    missing = sorted(set(baseline_nodes) ^ set(candidate_nodes))
+    if missing:
+        # the graph was partitioned or optimized differently, e.g. by fusions of one build only
+        print('\n{} nodes are in only one of the baseline and the candidate'.format(len(missing)))
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.DictWriter(f, fieldnames=['kind'] + RESULT_FIELDS)
+            writer.writeheader()
+            for kind, results in (('op_type', op_results), ('node', node_results)):
+                for result in results:
+                    writer.writerow(dict(result, kind=kind))
+
+    regressions = sum(1 for result in node_results + op_results if result['change'] == 'regression')
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
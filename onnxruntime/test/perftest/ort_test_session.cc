@@ -15,7 +15,11 @@ std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
   //Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
   const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
   const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
-  auto& input = test_inputs_.at(id);
+  return RunWithTestData(id);
+}
+
+std::chrono::duration<double> OnnxRuntimeTestSession::RunWithTestData(size_t test_data_id) {
+  auto& input = test_inputs_.at(test_data_id);
   auto start = std::chrono::high_resolution_clock::now();
   auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
                                     output_names_raw_ptr.data(), output_names_raw_ptr.size());
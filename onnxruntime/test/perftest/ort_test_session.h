@@ -33,6 +33,7 @@ class OnnxRuntimeTestSession : public TestSession {
     }
   }
   std::chrono::duration<double> Run() override;
+  std::chrono::duration<double> RunWithTestData(size_t test_data_id) override;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
@@ -7,7 +7,11 @@
 #endif
 
 #include "performance_runner.h"
+#include <deque>
+#include <iomanip>
 #include <iostream>
+#include <numeric>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -99,6 +103,59 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+void PerformanceResult::DumpLoadTestToJson(const std::basic_string<ORTCHAR_T>& path,
+                                           const RunConfig& run_config) const {
+  std::ofstream outfile;
+  if (!path.empty()) {
+    outfile.open(path, std::ofstream::out | std::ofstream::trunc);
+    if (!outfile.good()) {
+      std::cerr << "failed to open JSON result file '" << ToMBString(path) << "'. will dump it to output.\n";
+    }
+  }
+  std::ostream& ostream = outfile.is_open() && outfile.good() ? static_cast<std::ostream&>(outfile) : std::cout;
+
+  auto output_percentiles = [&ostream](const char* name, std::vector<double> values) {
+    ostream << "  \"" << name << "\": {";
+    if (!values.empty()) {
+      std::sort(values.begin(), values.end());
+      const size_t total = values.size();
+      ostream << "\"min\": " << values[0]
+              << ", \"mean\": " << std::accumulate(values.begin(), values.end(), 0.0) / total
+              << ", \"p50\": " << values[static_cast<size_t>(total * 0.5)]
+              << ", \"p90\": " << values[static_cast<size_t>(total * 0.9)]
+              << ", \"p99\": " << values[static_cast<size_t>(total * 0.99)]
+              << ", \"p99.9\": " << values[static_cast<size_t>(total * 0.999)]
+              << ", \"max\": " << values[total - 1];
+    }
+    ostream << "}";
+  };
+
+  std::string escaped_model_name;
+  for (char c : model_name) {
+    if (c == '"' || c == '\\') {
+      escaped_model_name += '\\';
+    }
+    escaped_model_name += c;
+  }
+
+  const double duration = std::chrono::duration<double>(end - start).count();
+  ostream << std::setprecision(9)
+          << "{\n"
+          << "  \"model_name\": \"" << escaped_model_name << "\",\n"
+          << "  \"target_qps\": " << run_config.target_qps << ",\n"
+          << "  \"achieved_qps\": " << (duration > 0 ? time_costs.size() / duration : 0.0) << ",\n"
+          << "  \"clients\": " << run_config.concurrent_session_runs << ",\n"
+          << "  \"sessions\": " << run_config.sessions_count << ",\n"
+          << "  \"requests\": " << time_costs.size() << ",\n"
+          << "  \"failed_requests\": " << failed_requests << ",\n"
+          << "  \"duration_s\": " << duration << ",\n";
+  // latency_s includes the time a request waited for a free client, service_time_s only the run
+  output_percentiles("latency_s", latencies);
+  ostream << ",\n";
+  output_percentiles("service_time_s", time_costs);
+  ostream << "\n}" << std::endl;
+}
+
 Status PerformanceRunner::Run() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
@@ -106,21 +163,28 @@ Status PerformanceRunner::Run() {
 
   // warm up
   RunOneIteration<true>();
+  for (auto& session : additional_sessions_) {
+    session->Run();
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunLoadTest());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -142,6 +206,11 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (performance_test_config_.run_config.target_qps > 0) {
+    performance_result_.DumpLoadTestToJson(performance_test_config_.run_config.json_result_file,
+                                           performance_test_config_.run_config);
+  }
+
   return Status::OK();
 }
 
@@ -230,6 +299,110 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+// Open-loop load test. The arrival times of the requests are drawn in advance of their runs, with exponentially
+// distributed gaps, and don't depend on when the previous requests finish. A request that arrives while all the
+// clients are busy waits in a queue, and its latency is counted from its arrival: measuring from the start of its run
+// would hide the queueing delay, the coordinated omission of closed-loop benchmarks. The test runs for
+// duration_in_seconds of arrivals in duration mode, or for repeated_times requests in times mode. Each request runs
+// with a test data set picked at random.
+Status PerformanceRunner::RunLoadTest() {
+  using Clock = std::chrono::high_resolution_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  struct Request {
+    Clock::time_point arrival;
+    size_t test_data_id;
+  };
+  std::deque<Request> queue;
+  bool arrivals_done = false;
+  OrtMutex queue_mutex;
+  OrtCondVar queue_cv;
+
+  const size_t session_count = additional_sessions_.size() + 1;
+  auto tpool = onnxruntime::make_unique<DefaultThreadPoolType>(static_cast<int>(run_config.concurrent_session_runs));
+  std::atomic<int> counter{0};
+  OrtMutex m;
+  OrtCondVar cv;
+
+  // Fork the clients, each one taking the requests from the queue until the arrivals are done
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    TestSession* session = i % session_count == 0 ? session_.get() : additional_sessions_[i % session_count - 1].get();
+    counter++;
+    tpool->Schedule([this, session, &queue, &arrivals_done, &queue_mutex, &queue_cv, &counter, &m, &cv]() {
+      for (;;) {
+        Request request;
+        {
+          std::unique_lock<OrtMutex> lock(queue_mutex);
+          queue_cv.wait(lock, [&queue, &arrivals_done]() { return arrivals_done || !queue.empty(); });
+          if (queue.empty()) {
+            break;
+          }
+          request = queue.front();
+          queue.pop_front();
+        }
+
+        std::chrono::duration<double> service_time(std::chrono::seconds(0));
+        bool failed = false;
+        ORT_TRY {
+          service_time = session->RunWithTestData(request.test_data_id);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            std::cerr << "PerformanceRunner::RunLoadTest caught exception: " << ex.what() << std::endl;
+            failed = true;
+          });
+        }
+        std::chrono::duration<double> latency = Clock::now() - request.arrival;
+
+        std::lock_guard<OrtMutex> guard(results_mutex_);
+        if (failed) {
+          performance_result_.failed_requests++;
+        } else {
+          performance_result_.time_costs.emplace_back(service_time.count());
+          performance_result_.total_time_cost += service_time.count();
+          performance_result_.latencies.emplace_back(latency.count());
+        }
+      }
+
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<OrtMutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
+
+  std::exponential_distribution<double> interarrival_time(run_config.target_qps);
+  std::uniform_int_distribution<size_t> test_data(0, test_data_count_ - 1);
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(static_cast<double>(run_config.duration_in_seconds)));
+  auto arrival = start;
+  for (size_t requests = 0;; ++requests) {
+    arrival += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(interarrival_time(rand_engine_)));
+    if (run_config.test_mode == TestMode::kFixDurationMode ? arrival >= end : requests == run_config.repeated_times) {
+      break;
+    }
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lock(queue_mutex);
+      queue.push_back({arrival, test_data(rand_engine_)});
+    }
+    queue_cv.notify_one();
+  }
+  {
+    std::lock_guard<OrtMutex> lock(queue_mutex);
+    arrivals_done = true;
+  }
+  queue_cv.notify_all();
+
+  //Join
+  std::unique_lock<OrtMutex> lock(m);
+  cv.wait(lock, [&counter]() { return counter == 0; });
+
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     const auto& file_path = performance_test_config_.model_info.model_file_path;
@@ -272,10 +445,16 @@ static std::unique_ptr<TestSession> CreateSession(Ort::Env& env, std::random_dev
 
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
-      test_model_info_(CreateModelInfo(test_config)) {
+      test_model_info_(CreateModelInfo(test_config)),
+      rand_engine_(rd()) {
   session_create_start_ = std::chrono::high_resolution_clock::now();
   session_ = CreateSession(env, rd, test_config, *test_model_info_);
   session_create_end_ = std::chrono::high_resolution_clock::now();
+  if (test_config.run_config.target_qps > 0) {
+    for (size_t i = 1; i < test_config.run_config.sessions_count; ++i) {
+      additional_sessions_.push_back(CreateSession(env, rd, test_config, *test_model_info_));
+    }
+  }
 }
 
 PerformanceRunner::~PerformanceRunner() = default;
@@ -300,6 +479,9 @@ bool PerformanceRunner::Initialize() {
   test_case_ = CreateOnnxTestCase(narrow_model_name, std::move(test_model_info_), 0.0, 0.0);
 
   if (performance_test_config_.run_config.generate_model_input_binding) {
+    for (auto& session : additional_sessions_) {
+      static_cast<OnnxRuntimeTestSession*>(session.get())->PopulateGeneratedInputTestData();
+    }
     return static_cast<OnnxRuntimeTestSession*>(session_.get())->PopulateGeneratedInputTestData();
   }
 
@@ -309,19 +491,23 @@ bool PerformanceRunner::Initialize() {
     std::cout << "there is no test data for model " << test_case_->GetTestCaseName() << std::endl;
     return false;
   }
-  for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
-    std::unordered_map<std::string, Ort::Value> feeds;
-    test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
-    // Discard the names in feeds
-    int input_count = test_model_info->GetInputCount();
-    for (int i = 0; i != input_count; ++i) {
-      auto iter = feeds.find(test_model_info->GetInputName(i));
-      if (iter == feeds.end()) {
-        std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
-                  << test_case_->GetTestCaseName() << std::endl;
-        return false;
+  test_data_count_ = test_data_count;
+  for (size_t session_id = 0; session_id <= additional_sessions_.size(); ++session_id) {
+    TestSession& session = session_id == 0 ? *session_ : *additional_sessions_[session_id - 1];
+    for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
+      std::unordered_map<std::string, Ort::Value> feeds;
+      test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
+      // Discard the names in feeds
+      int input_count = test_model_info->GetInputCount();
+      for (int i = 0; i != input_count; ++i) {
+        auto iter = feeds.find(test_model_info->GetInputName(i));
+        if (iter == feeds.end()) {
+          std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
+                    << test_case_->GetTestCaseName() << std::endl;
+          return false;
+        }
+        session.PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
       }
-      session_->PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
     }
   }
 
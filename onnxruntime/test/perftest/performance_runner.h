@@ -34,9 +34,14 @@ struct PerformanceResult {
   short average_CPU_usage{0};
   double total_time_cost{0};
   std::vector<double> time_costs;
+  // load test only: the time from the arrival of each request to the end of its run
+  std::vector<double> latencies;
+  size_t failed_requests{0};
   std::string model_name;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
+  // Writes the latency percentiles of a load test as JSON, to standard output if path is empty.
+  void DumpLoadTestToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const;
 };
 
 class PerformanceRunner {
@@ -88,6 +93,7 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunLoadTest();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -110,6 +116,10 @@ class PerformanceRunner {
   PerformanceTestConfig performance_test_config_;
   std::unique_ptr<TestModelInfo> test_model_info_;
   std::unique_ptr<TestSession> session_;
+  // load test only: the sessions beyond session_, so the clients share sessions_count sessions
+  std::vector<std::unique_ptr<TestSession>> additional_sessions_;
+  size_t test_data_count_{1};
+  std::mt19937 rand_engine_;
   onnxruntime::test::HeapBuffer b_;
   std::unique_ptr<ITestCase> test_case_;
 
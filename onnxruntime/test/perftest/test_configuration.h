@@ -53,6 +53,11 @@ struct RunConfig {
   int cudnn_conv_algo{0};
   bool do_cuda_copy_in_separate_stream{false};
   bool set_denormal_as_zero{false};
+  // Open-loop load test: when target_qps is not 0, requests arrive as a Poisson process of this average rate and
+  // concurrent_session_runs clients serve them from sessions_count sessions.
+  double target_qps{0};
+  size_t sessions_count{1};
+  std::basic_string<ORTCHAR_T> json_result_file;
 };
 
 struct PerformanceTestConfig {
@@ -11,6 +11,8 @@ namespace perftest {
 class TestSession {
  public:
   virtual std::chrono::duration<double> Run() = 0;
+  // Runs with the inputs of one test data set. Unlike Run, it may be called from several threads at once.
+  virtual std::chrono::duration<double> RunWithTestData(size_t /*test_data_id*/) { return Run(); }
   // TODO: implement it
   // This function won't return duration, because it may vary largely.
   // Please measure the perf at a higher level.
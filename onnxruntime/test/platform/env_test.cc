@@ -3,7 +3,10 @@
 
 #include "core/platform/env.h"
 
+#include <algorithm>
 #include <fstream>
+#include <set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -33,5 +36,36 @@ TEST(PlatformEnvTest, DirectoryCreationAndDeletion) {
   ASSERT_FALSE(env.FolderExists(root_dir));
 }
 
+TEST(PlatformEnvTest, NumaNodeThreadAffinityMasks) {
+  const auto& env = Env::Default();
+  EXPECT_TRUE(env.GetNumaNodeThreadAffinityMasks(-1).empty());
+  EXPECT_TRUE(env.GetNumaNodeThreadAffinityMasks(1 << 20).empty());
+
+  // node 0 may not be reported (e.g. no NUMA information), but if it is it can't have more
+  // processors than the machine
+  auto node_cpus = env.GetNumaNodeThreadAffinityMasks(0);
+  EXPECT_LE(node_cpus.size(), static_cast<size_t>(env.GetNumCpuCores()));
+}
+
+TEST(PlatformEnvTest, PhysicalCoreThreadAffinityMasks) {
+  const auto& env = Env::Default();
+  // the topology may not be reported, but if it is there's at most one processor per core, and the performance
+  // cores are a subset of the cores
+  auto core_cpus = env.GetPhysicalCoreThreadAffinityMasks(false);
+  EXPECT_LE(core_cpus.size(), static_cast<size_t>(env.GetNumCpuCores()));
+  EXPECT_EQ(std::set<size_t>(core_cpus.begin(), core_cpus.end()).size(), core_cpus.size());
+
+  auto performance_cpus = env.GetPhysicalCoreThreadAffinityMasks(true);
+  for (size_t cpu : performance_cpus) {
+    EXPECT_NE(std::find(core_cpus.begin(), core_cpus.end(), cpu), core_cpus.end());
+  }
+}
+
+TEST(PlatformEnvTest, BindMemoryToInvalidNumaNode) {
+  const auto& env = Env::Default();
+  std::vector<char> buffer(1 << 16);
+  EXPECT_FALSE(env.BindMemoryToNumaNode(buffer.data(), buffer.size(), -1).IsOK());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -8,7 +8,9 @@
 #include <utility>
 #include <vector>
 
-#ifndef _WIN32
+#ifdef _WIN32
+#include <Windows.h>  // for GetSystemInfo()
+#else
 #include <unistd.h>  // for sysconf() and _SC_PAGESIZE
 #endif
 
@@ -109,9 +111,15 @@ TEST(FileIoTest, ReadFileIntoBuffer) {
   ASSERT_FALSE(Env::Default().ReadFileIntoBuffer(tmp.path.c_str(), 0, 3, gsl::make_span(buffer.data(), 2)).IsOK());
 }
 
-#ifndef _WIN32  // not implemented on Windows
 TEST(FileIoTest, MapFileIntoMemory) {
+#ifdef _WIN32
+  // the offsets of mapped views are aligned to the allocation granularity
+  SYSTEM_INFO system_info;
+  GetSystemInfo(&system_info);
+  static const auto page_size = static_cast<long>(system_info.dwAllocationGranularity);
+#else
   static const auto page_size = sysconf(_SC_PAGESIZE);
+#endif
   ASSERT_GT(page_size, 0);
 
   TempFilePath tmp(ORT_TSTR("map_file_test_"));
@@ -144,7 +152,32 @@ TEST(FileIoTest, MapFileIntoMemory) {
     ASSERT_FALSE(Env::Default().MapFileIntoMemory(tmp.path.c_str(), -1, 0, mapped_memory).IsOK());
   }
 }
-#endif
+
+TEST(FileIoTest, PrefetchFile) {
+  TempFilePath tmp(ORT_TSTR("prefetch_file_test_"));
+  const auto expected_data = GenerateData(12345);
+  WriteDataToFile(gsl::make_span(expected_data), tmp.path);
+
+  auto status = Env::Default().PrefetchFile(tmp.path.c_str(), 100, 1000);
+  if (status.Code() == common::NOT_IMPLEMENTED) {
+    return;
+  }
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // up to the end of the file
+  ASSERT_TRUE(Env::Default().PrefetchFile(tmp.path.c_str(), 0, 0).IsOK());
+
+  // the prefetched content reads the same
+  std::vector<char> buffer(1000);
+  ASSERT_TRUE(Env::Default().ReadFileIntoBuffer(tmp.path.c_str(), 100, 1000, gsl::make_span(buffer)).IsOK());
+  ASSERT_EQ(gsl::make_span(buffer), gsl::make_span(expected_data.data() + 100, 1000));
+
+  // invalid - negative offset
+  ASSERT_FALSE(Env::Default().PrefetchFile(tmp.path.c_str(), -1, 0).IsOK());
+
+  // invalid - no file
+  ASSERT_FALSE(Env::Default().PrefetchFile((tmp.path + ORT_TSTR("_missing")).c_str(), 0, 0).IsOK());
+}
 
 }  // namespace test
 }  // namespace onnxruntime
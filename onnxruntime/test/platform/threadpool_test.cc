@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/platform/threadpool.h"
+#include "core/common/profiler.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
 
@@ -9,8 +10,12 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -161,6 +166,34 @@ void TestPoolCreation(const std::string&, int iter) {
   ASSERT_EQ(ctr, iter * per_iter);
 }
 
+void TestAdaptiveSpinning(const std::string&, int num_threads, int num_loops) {
+  // Run a burst of small loops with adaptive spinning enabled, then let the pool go idle.  Each loop must still
+  // cover its iteration space exactly once, and once idle for longer than the spin window the workers park.
+  onnxruntime::ThreadOptions to;
+  to.adaptive_spinning = true;
+  to.max_spin_duration_us = 200;
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, num_threads, true);
+
+  constexpr std::ptrdiff_t per_loop = 1024;
+  for (int loop = 0; loop < num_loops; loop++) {
+    auto test_data = CreateTestData(per_loop);
+    tp->ParallelFor(per_loop, 10.0, [&](std::ptrdiff_t s, std::ptrdiff_t e) {
+      for (std::ptrdiff_t i = s; i < e; i++) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+  }
+
+  ThreadPoolStats stats = tp->GetStats();
+  for (int i = 0; i < 1000 && stats.num_parks == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    stats = tp->GetStats();
+  }
+  ASSERT_GT(stats.num_spins, 0u);
+  ASSERT_GT(stats.num_parks, 0u);
+}
+
 }  // namespace
 
 namespace onnxruntime {
@@ -290,6 +323,183 @@ TEST(ThreadPoolTest, TestPoolCreation_100Iter) {
   TestPoolCreation("TestPoolCreation_100Iter", 100);
 }
 
+TEST(ThreadPoolTest, TestAdaptiveSpinning_4Thread_100Loops) {
+  TestAdaptiveSpinning("TestAdaptiveSpinning_4Thread_100Loops", 4, 100);
+}
+
+TEST(ThreadPoolTest, TestStats_1Thread) {
+  // A pool with degree of parallelism 1 has no worker threads to count for
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 1, true);
+  ThreadPoolStats stats = tp->GetStats();
+  ASSERT_EQ(stats.num_steals, 0u);
+  ASSERT_EQ(stats.num_spins, 0u);
+  ASSERT_EQ(stats.num_parks, 0u);
+}
+
+TEST(ThreadPoolTest, TestProfilingScope) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  onnxruntime::profiling::Profiler profiler;
+  profiler.StartProfiling(std::string("threadpool_profiling_scope_test.json"));
+
+  const std::string event_name = "test_node_parallel_for";
+  {
+    ThreadPoolProfilingScope profiling_scope(profiler, event_name);
+    ASSERT_EQ(ThreadPoolProfilingScope::CurrentProfiler(), &profiler);
+    tp->SimpleParallelFor(1000, [](std::ptrdiff_t) {});
+  }
+  ASSERT_EQ(ThreadPoolProfilingScope::CurrentProfiler(), nullptr);
+
+  // loops outside of a scope are not recorded
+  tp->SimpleParallelFor(1000, [](std::ptrdiff_t) {});
+
+  std::string profile_file = profiler.EndProfiling();
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+
+  // each thread that ran iterations records an event with the number it ran
+  int num_events = 0;
+  std::string line;
+  while (std::getline(profile, line)) {
+    if (line.find(event_name) != std::string::npos) {
+      ASSERT_NE(line.find("\"cat\" : \"ThreadPool\""), std::string::npos);
+      ASSERT_NE(line.find("\"total_iterations\" : \"1000\""), std::string::npos);
+      num_events++;
+    }
+  }
+  ASSERT_GE(num_events, 1);
+  ASSERT_LE(num_events, 4);
+  profile.close();
+  std::remove(profile_file.c_str());
+}
+
+#ifndef _OPENMP
+TEST(ThreadPoolTest, TestParallelismLimitScope) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+  {
+    ThreadPoolParallelismLimitScope limit_scope(2);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 2);
+    {
+      // a limit above the pool size has no effect
+      ThreadPoolParallelismLimitScope nested_limit_scope(8);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+    }
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 2);
+
+    // the limit only applies to the thread that set it
+    int other_thread_degree_of_parallelism = 0;
+    std::thread other_thread([&]() { other_thread_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get()); });
+    other_thread.join();
+    ASSERT_EQ(other_thread_degree_of_parallelism, 4);
+  }
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+}
+
+TEST(ThreadPoolTest, TestRunPriorityScope) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  ThreadPoolRunPriorityScope low_priority_scope(tp.get(), true);
+  ASSERT_TRUE(ThreadPoolRunPriorityScope::CurrentIsLowPriority());
+  // a low priority Run uses the whole pool while no normal priority Run is using it
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+
+  Notification normal_run_started;
+  Notification low_priority_checked;
+  int normal_degree_of_parallelism = 0;
+  std::thread normal_run([&]() {
+    ThreadPoolRunPriorityScope normal_priority_scope(tp.get(), false);
+    normal_run_started.Notify();
+    low_priority_checked.Wait();
+    normal_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+  });
+  normal_run_started.Wait();
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 1);
+  {
+    // the threads of a Run only set their priority
+    int thread_degree_of_parallelism = 0;
+    std::thread inter_op_thread([&]() {
+      ThreadPoolRunPriorityScope thread_scope(nullptr, true);
+      thread_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+    });
+    inter_op_thread.join();
+    ASSERT_EQ(thread_degree_of_parallelism, 1);
+  }
+  low_priority_checked.Notify();
+  normal_run.join();
+  ASSERT_EQ(normal_degree_of_parallelism, 4);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+}
+
+TEST(ThreadPoolTest, TestRunWeightScope) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  ThreadPoolRunWeightScope weight_scope(tp.get(), 1);
+  ASSERT_EQ(ThreadPoolRunWeightScope::CurrentWeight(), 1);
+  // a Run uses the whole pool while no other Run with a weight is using it
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+
+  // start a Run with weight 3 while a loop of the Run with weight 1 is using the whole pool
+  constexpr std::ptrdiff_t kIterations = 1000;
+  Notification start_other_run;
+  Notification loop_done;
+  std::atomic<bool> other_run_started{false};
+  int other_degree_of_parallelism = 0;
+  std::thread other_run([&]() {
+    start_other_run.Wait();
+    ThreadPoolRunWeightScope other_weight_scope(tp.get(), 3);
+    other_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+    other_run_started = true;
+    loop_done.Wait();
+  });
+
+  const std::thread::id loop_thread = std::this_thread::get_id();
+  std::atomic<std::ptrdiff_t> num_started{0};
+  std::atomic<int> helper_iterations_after_other_run{0};
+  std::unique_ptr<std::atomic<int>[]> counts(new std::atomic<int>[kIterations]);
+  for (std::ptrdiff_t i = 0; i < kIterations; ++i) {
+    counts[i] = 0;
+  }
+
+  tp->SimpleParallelFor(kIterations, [&](std::ptrdiff_t i) {
+    const bool after_other_run = other_run_started;
+    if (num_started++ == kIterations / 4) {
+      start_other_run.Notify();
+    }
+    // the share of the loop is 1 now, so each helper leaves before claiming its next iteration
+    if (after_other_run && std::this_thread::get_id() != loop_thread) {
+      ++helper_iterations_after_other_run;
+    }
+    ++counts[i];
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  });
+
+  ASSERT_TRUE(other_run_started);
+  ASSERT_LE(helper_iterations_after_other_run, 3);
+  for (std::ptrdiff_t i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(counts[i], 1) << i;
+  }
+
+  ASSERT_EQ(other_degree_of_parallelism, 3);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 1);
+  {
+    // the threads of a Run only set their weight
+    int thread_degree_of_parallelism = 0;
+    std::thread inter_op_thread([&]() {
+      ThreadPoolRunWeightScope thread_scope(nullptr, 1);
+      thread_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+    });
+    inter_op_thread.join();
+    ASSERT_EQ(thread_degree_of_parallelism, 1);
+  }
+  loop_done.Notify();
+  other_run.join();
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 4);
+}
+#endif
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestStackSize) {
   ThreadOptions to;
@@ -2,14 +2,67 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/framework/philox.h"
 #include "test/providers/provider_test_utils.h"
 
 #include <algorithm>
-#include <random>
+#include <cmath>
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
 
+// The values of the first Compute of a kernel with the seed, generated serially from the start of its Philox
+// stream: float i is value i % 4 of block i / 4, double i is values 2 * (i % 2) and 2 * (i % 2) + 1 of block i / 2.
+template <typename T>
+static std::vector<T> UniformValues(float seed, size_t count);
+
+template <>
+std::vector<float> UniformValues<float>(float seed, size_t count) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t block[4];
+    Philox4x32x10::Generate(static_cast<uint64_t>(seed), i / 4, 0, block);
+    values[i] = Philox4x32x10::ToFloat(block[i % 4]);
+  }
+  return values;
+}
+
+template <>
+std::vector<double> UniformValues<double>(float seed, size_t count) {
+  std::vector<double> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t block[4];
+    Philox4x32x10::Generate(static_cast<uint64_t>(seed), i / 2, 0, block);
+    values[i] = Philox4x32x10::ToDouble(block[2 * (i % 2)], block[2 * (i % 2) + 1]);
+  }
+  return values;
+}
+
+template <typename T>
+static std::vector<T> ExpectedUniform(float seed, float low, float high, size_t count) {
+  std::vector<T> values = UniformValues<T>(seed, count);
+  for (T& value : values) {
+    value = static_cast<T>(low) + (static_cast<T>(high) - static_cast<T>(low)) * value;
+  }
+  return values;
+}
+
+// the Box-Muller transform of uniform values 2k and 2k + 1 are elements 2k and 2k + 1
+template <typename T>
+static std::vector<T> ExpectedNormal(float seed, float mean, float scale, size_t count) {
+  const std::vector<T> uniform = UniformValues<T>(seed, count + count % 2);
+  std::vector<T> values(count);
+  for (size_t i = 0; i < count; i += 2) {
+    const T radius = std::sqrt(-2 * std::log(1 - uniform[i])) * static_cast<T>(scale);
+    const T theta = static_cast<T>(2.0 * 3.14159265358979323846) * uniform[i + 1];
+    values[i] = static_cast<T>(mean) + radius * std::cos(theta);
+    if (i + 1 < count) {
+      values[i + 1] = static_cast<T>(mean) + radius * std::sin(theta);
+    }
+  }
+  return values;
+}
+
 TEST(Random, RandomNormal2DDouble) {
   OpTester test("RandomNormal");
 
@@ -25,12 +78,7 @@ TEST(Random, RandomNormal2DDouble) {
   test.AddAttribute<int64_t>("dtype", TensorProto::DOUBLE);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<double> distribution{mean, scale};
-
-  std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  std::vector<double> expected_output = ExpectedNormal<double>(seed, mean, scale, TensorShape(dims).Size());
 
   test.AddOutput<double>("Y", dims, expected_output);
   test.Run();
@@ -59,12 +107,7 @@ void RunRandomNormalLike3DFloat(bool infer_dtype = false) {
                         0.f, 0.f, 0.f,
                         0.f, 0.f, 0.f});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<float> distribution{mean, scale};
-
-  std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  std::vector<float> expected_output = ExpectedNormal<float>(seed, mean, scale, TensorShape(dims).Size());
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -95,12 +138,7 @@ TEST(Random, RandomUniform1DFloat) {
   test.AddAttribute<int64_t>("dtype", TensorProto::FLOAT);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<float> distribution{low, high};
-
-  std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  std::vector<float> expected_output = ExpectedUniform<float>(seed, low, high, TensorShape(dims).Size());
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -128,12 +166,7 @@ void RunRandomUniformLikeTest(bool infer_dtype = false) {
                         {0., 0., 0., 0., 0., 0.,
                          0., 0., 0., 0., 0., 0.});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<double> distribution{low, high};
-
-  std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  std::vector<double> expected_output = ExpectedUniform<double>(seed, low, high, TensorShape(dims).Size());
 
   test.AddOutput<double>("Y", dims, expected_output);
 
@@ -222,10 +255,9 @@ TEST(Random, InvalidDType) {
 }
 
 /*
-Note: There are no reference tests that can be reused in this case. I tried to use the tensorflow
-test cases but they use a different RNG (Philox) and hence the test results differ. Since the implementation
-of the op is same as tensorflow, for now I've just relied on the output generated by this code as ground truth
-for verification.
+Note: There are no reference tests that can be reused in this case. The tensorflow test cases use a different
+layout of the Philox stream and hence the test results differ. Since the implementation of the op is same as
+tensorflow, for now I've just relied on the output generated by this code as ground truth for verification.
 */
 TEST(Random, MultinomialGoodCase) {
   OpTester test("Multinomial");
@@ -245,13 +277,7 @@ TEST(Random, MultinomialGoodCase) {
   test.AddAttribute<int64_t>("dtype", TensorProto::INT64);
 
   const std::vector<int64_t> output_dims{batch_size, num_samples};
-#ifdef _WIN32
-  const std::vector<int64_t> expected_output{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-#elif defined(__MACH__) || defined(__ANDROID__) || defined(__FreeBSD__)
-  const std::vector<int64_t> expected_output{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-#else
-  const std::vector<int64_t> expected_output{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-#endif
+  const std::vector<int64_t> expected_output{1, 2, 0, 2, 0, 0, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
   test.AddOutput<int64_t>("Y", output_dims, expected_output);
 
   test.Run();
@@ -282,16 +308,9 @@ TEST(Random, MultinomialDefaultDType) {
     test.Run();
   };
 
-#ifdef _WIN32
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-  const std::vector<int32_t> expected_output_2{0, 0, 1, 0, 2, 2, 2, 0, 2, 1, 2, 1, 0, 2, 0, 2, 2, 1, 2, 1};
-#elif defined(__MACH__) || defined(__ANDROID__) || defined(__FreeBSD__)
-  const std::vector<int32_t> expected_output_1{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-  const std::vector<int32_t> expected_output_2{1, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 2, 0, 1, 1, 0, 2, 2, 2, 1};
-#else
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-  const std::vector<int32_t> expected_output_2{2, 2, 1, 1, 0, 2, 2, 1, 1, 2, 0, 0, 0, 2, 0, 1, 1, 1, 0, 0};
-#endif
+  // the values are the same on all platforms as they only depend on the Philox stream of the seed
+  const std::vector<int32_t> expected_output_1{1, 2, 0, 2, 0, 0, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
+  const std::vector<int32_t> expected_output_2{2, 0, 0, 2, 0, 1, 2, 1, 1, 0, 0, 2, 0, 2, 2, 0, 2, 2, 1, 2};
 
   // Test output from a single call to Multinomial::Compute
   run_test(1, expected_output_1);
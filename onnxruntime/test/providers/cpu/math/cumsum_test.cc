@@ -207,5 +207,24 @@ TEST(CumSumTest, _1DTestdouble_WithInt64Axis) {
   test.AddOutput<double>("y", {5}, {1., 3., 6., 10., 15.});
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+// long enough for the scan to be split into blocks
+TEST(CumSumTest, _1DTestLongInt64ReverseExclusive) {
+  constexpr int64_t size = 100000;
+  std::vector<int64_t> input(size), output(size);
+  int64_t sum = 0;
+  for (int64_t i = size - 1; i >= 0; --i) {
+    input[i] = i % 5 - 2;
+    output[i] = sum;
+    sum += input[i];
+  }
+
+  OpTester test("CumSum", 11, onnxruntime::kOnnxDomain);
+  test.AddAttribute<int64_t>("exclusive", 1);
+  test.AddAttribute<int64_t>("reverse", 1);
+  test.AddInput<int64_t>("x", {size}, input);
+  test.AddInput<int32_t>("axis", {1}, {0});
+  test.AddOutput<int64_t>("y", {size}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "core/framework/data_types.h"
+#include "core/providers/cpu/math/einsum_utils/einsum_contraction_path.h"
 #include "core/util/math.h"
 
 namespace onnxruntime {
@@ -509,5 +510,42 @@ TEST(Einsum, ImplicitEinsumAsTensorContraction) {
   test.Run();
 }
 
+// Theme: Contraction order of 3 or more operands
+
+TEST(Einsum, ContractionPathPrefersSmallerIntermediates) {
+  // 'ab,bc,c->a' with a = 2, b = 3, c = 4. Contracting 'bc,c' first avoids the 'ac' intermediate
+  EinsumOp::ContractionPath path = EinsumOp::FindContractionPath({{2, 3, 1}, {1, 3, 4}, {1, 1, 4}},
+                                                                 {true, false, false});
+  EinsumOp::ContractionPath expected_path{{1, 2}, {0, 1}};
+  EXPECT_EQ(path, expected_path);
+
+  // 'ij,jk,kl,lm->im' with a small k: contract 'ij,jk' and 'kl,lm' before multiplying the results
+  path = EinsumOp::FindContractionPath({{10, 100, 1, 1, 1}, {1, 100, 2, 1, 1}, {1, 1, 2, 100, 1}, {1, 1, 1, 100, 10}},
+                                       {true, false, false, false, true});
+  expected_path = {{0, 1}, {0, 1}, {0, 1}};
+  EXPECT_EQ(path, expected_path);
+}
+
+TEST(Einsum, ExplicitEinsumAsMatrixVectorChain) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,c->a");
+  test.AddInput<float>("x", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("y", {3, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+  test.AddInput<float>("z", {4}, {1.f, 1.f, 1.f, 1.f});
+  test.AddOutput<float>("o", {2}, {188.f, 422.f});
+  test.Run();
+}
+
+TEST(Einsum, ExplicitEinsumAsChainWithSeveralReducedDims) {
+  // 'd' and 'e' are both reduced from the last operand before it is multiplied
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,cde->a");
+  test.AddInput<float>("x", {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("y", {2, 2}, {1.f, 0.f, 0.f, 1.f});
+  test.AddInput<float>("z", {2, 2, 2}, {1.f, 1.f, 1.f, 1.f, 2.f, 2.f, 2.f, 2.f});
+  test.AddOutput<float>("o", {2}, {20.f, 44.f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,7 @@
 #include "core/util/math.h"
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 namespace onnxruntime {
 namespace test {
@@ -262,6 +263,68 @@ TEST(MathOpTest, Add_Broadcast_2x1x4_1x3x1) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// shapes for the vectorized kernels of the CUDA EP: contiguous runs of elements that split into vectors or not,
+// and a number of elements that leaves a tail after the last vector
+static void RunAddBroadcastTest(const std::vector<int64_t>& a_dims, const std::vector<int64_t>& b_dims) {
+  TensorShape a_shape(a_dims);
+  TensorShape b_shape(b_dims);
+  std::vector<int64_t> c_dims(std::max(a_dims.size(), b_dims.size()));
+  for (size_t i = 0; i < c_dims.size(); ++i) {
+    int64_t a_dim = i < c_dims.size() - a_dims.size() ? 1 : a_dims[i - (c_dims.size() - a_dims.size())];
+    int64_t b_dim = i < c_dims.size() - b_dims.size() ? 1 : b_dims[i - (c_dims.size() - b_dims.size())];
+    c_dims[i] = std::max(a_dim, b_dim);
+  }
+
+  std::vector<float> a(a_shape.Size());
+  std::vector<float> b(b_shape.Size());
+  std::iota(a.begin(), a.end(), 0.0f);
+  std::iota(b.begin(), b.end(), 1000.0f);
+
+  // c[index] = a[broadcast index] + b[broadcast index]
+  TensorShape output_shape(c_dims);
+  std::vector<float> c(output_shape.Size());
+  std::vector<int64_t> index(c_dims.size(), 0);
+  for (size_t offset = 0; offset < c.size(); ++offset) {
+    int64_t a_offset = 0;
+    int64_t b_offset = 0;
+    for (size_t i = 0; i < c_dims.size(); ++i) {
+      if (i >= c_dims.size() - a_dims.size()) {
+        int64_t dim = a_dims[i - (c_dims.size() - a_dims.size())];
+        a_offset = a_offset * dim + (dim == 1 ? 0 : index[i]);
+      }
+      if (i >= c_dims.size() - b_dims.size()) {
+        int64_t dim = b_dims[i - (c_dims.size() - b_dims.size())];
+        b_offset = b_offset * dim + (dim == 1 ? 0 : index[i]);
+      }
+    }
+    c[offset] = a[a_offset] + b[b_offset];
+    for (size_t i = c_dims.size(); i-- > 0;) {
+      if (++index[i] < c_dims[i]) {
+        break;
+      }
+      index[i] = 0;
+    }
+  }
+
+  OpTester test("Add");
+  test.AddInput<float>("A", a_dims, a);
+  test.AddInput<float>("B", b_dims, b);
+  test.AddOutput<float>("C", c_dims, c);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(MathOpTest, Add_Vectorizable_Shapes) {
+  RunAddBroadcastTest({3, 13}, {3, 13});     // no broadcast with a tail
+  RunAddBroadcastTest({64}, {64});           // no broadcast without a tail
+  RunAddBroadcastTest({3, 13}, {1});         // scalar
+  RunAddBroadcastTest({1}, {5, 7});          // scalar on the left
+  RunAddBroadcastTest({5, 16}, {16});        // rows of a multiple of the vector size
+  RunAddBroadcastTest({5, 6}, {6});          // rows that don't split into vectors
+  RunAddBroadcastTest({2, 3, 8}, {3, 1});    // per-channel, channels of a multiple of the vector size
+  RunAddBroadcastTest({1, 3, 8}, {3, 1});    // per-channel with a batch of 1
+  RunAddBroadcastTest({2, 3, 5}, {3, 1});    // per-channel, channels that don't split into vectors
+}
+
 TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
   OpTester test("Add");
 
@@ -937,6 +1000,32 @@ TEST(MathOpTest, SumMultipleInputsNoBroadcasting) {
   }
 }
 
+// the first two inputs broadcast to the output shape, so the last two are added to the output in place
+TEST(MathOpTest, SumMultipleInputsBroadcastToOutputInPlace) {
+  const int64_t rows = 300;
+  const int64_t cols = 64;
+  std::vector<float> data_0(cols), data_1(rows), data_2(rows * cols), data_3(cols);
+  std::iota(data_0.begin(), data_0.end(), 0.0f);
+  std::iota(data_1.begin(), data_1.end(), 1000.0f);
+  std::iota(data_2.begin(), data_2.end(), -50.0f);
+  std::fill(data_3.begin(), data_3.end(), 0.5f);
+
+  std::vector<float> expected(rows * cols);
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      expected[i * cols + j] = data_0[j] + data_1[i] + data_2[i * cols + j] + data_3[j];
+    }
+  }
+
+  OpTester test("Sum", 8);
+  test.AddInput<float>("data_0", {1, cols}, data_0);
+  test.AddInput<float>("data_1", {rows, 1}, data_1);
+  test.AddInput<float>("data_2", {rows, cols}, data_2);
+  test.AddInput<float>("data_3", {cols}, data_3);
+  test.AddOutput<float>("sum", {rows, cols}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(MathOpTest, Min_6) {
   OpTester test("Min", 6);
   std::vector<int64_t> dims{3, 3};
@@ -1819,6 +1908,16 @@ TEST(MathOpTest, Expand_8_3x1x3x1_int64) {
   test.Run();
 }
 
+TEST(MathOpTest, Expand_8_2x1_to_2x2x5) {
+  OpTester test("Expand", 8);
+  test.AddInput<float>("data_0", {2, 1}, {1.0f, 2.0f});
+  test.AddInput<int64_t>("data_1", {3}, {2, 1, 5});
+  test.AddOutput<float>("result", {2, 2, 5},
+                        {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f,
+                         1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f});
+  test.Run();
+}
+
 TEST(MathOpTest, Expand_8_3x3_float16) {
   OpTester test("Expand", 8);
   test.AddInput<MLFloat16>("data_0", {1}, {MLFloat16(math::floatToHalf(1.0f))});
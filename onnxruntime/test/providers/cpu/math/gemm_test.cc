@@ -75,6 +75,56 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
 }
 #endif
 
+static void ConvertFloats(const std::vector<float>& values, std::vector<MLFloat16>& converted) {
+  converted.resize(values.size());
+  ConvertFloatToMLFloat16(values.data(), converted.data(), static_cast<int>(values.size()));
+}
+
+static void ConvertFloats(const std::vector<float>& values, std::vector<BFloat16>& converted) {
+  converted.resize(values.size());
+  FloatToBFloat16(values.data(), converted.data(), values.size());
+}
+
+template <typename T>
+static void RunHalfGemmTransBBroadcastTest(int opset_version) {
+  OpTester test("Gemm", opset_version);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+
+  std::vector<float> A{1.0f, 2.0f, 3.0f, 4.0f,
+                       -1.0f, -2.0f, -3.0f, -4.0f};
+  std::vector<float> B{1.0f, 1.0f, 1.0f, 1.0f,
+                       2.0f, 2.0f, 2.0f, 2.0f,
+                       0.0f, 1.0f, 0.0f, 1.0f};
+  std::vector<float> C{1.0f, 2.0f, 3.0f};
+  std::vector<float> Y{7.0f, 14.0f, 9.0f,
+                       -3.0f, -6.0f, 3.0f};
+
+  std::vector<T> h_A, h_B, h_C, h_Y;
+  ConvertFloats(A, h_A);
+  ConvertFloats(B, h_B);
+  ConvertFloats(C, h_C);
+  ConvertFloats(Y, h_Y);
+
+  test.AddInput<T>("A", {2, 4}, h_A);
+  test.AddInput<T>("B", {3, 4}, h_B);
+  test.AddInput<T>("C", {3}, h_C);
+  test.AddOutput<T>("Y", {2, 3}, h_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+TEST(GemmOpTest, GemmTransBBroadcast_f16) {
+  RunHalfGemmTransBBroadcastTest<MLFloat16>(11);
+  RunHalfGemmTransBBroadcastTest<MLFloat16>(13);
+}
+
+TEST(GemmOpTest, GemmTransBBroadcast_bf16) {
+  RunHalfGemmTransBBroadcastTest<BFloat16>(13);
+}
+
 TEST(GemmOpTest, GemmBroadcast) {
   OpTester test("Gemm");
 
@@ -247,6 +247,54 @@ TEST(MatmulIntegerOpTest, MatMulInteger_int8_t_No_Zero_Point) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
 }
 
+// A constant B is packed for the int8 tensor cores, which take the A of the shapes with a 2D B
+void RunMatMulIntegerInt8ConstantBTest(const std::vector<int64_t>& a_dims, int64_t N, int8_t a_zero_point,
+                                       int8_t b_zero_point) {
+  const int64_t K = a_dims.back();
+  const int64_t M = TensorShape(a_dims).Size() / K;
+
+  std::default_random_engine generator(1234);
+  std::uniform_int_distribution<int32_t> distribution(-128, 127);
+  std::vector<int8_t> a_data(M * K);
+  std::vector<int8_t> b_data(K * N);
+  for (auto& value : a_data) value = static_cast<int8_t>(distribution(generator));
+  for (auto& value : b_data) value = static_cast<int8_t>(distribution(generator));
+
+  std::vector<int32_t> y_data(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      int32_t sum = 0;
+      for (int64_t k = 0; k < K; k++) {
+        sum += (static_cast<int32_t>(a_data[m * K + k]) - a_zero_point) *
+               (static_cast<int32_t>(b_data[k * N + n]) - b_zero_point);
+      }
+      y_data[m * N + n] = sum;
+    }
+  }
+
+  std::vector<int64_t> y_dims = a_dims;
+  y_dims.back() = N;
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<int8_t>("T1", a_dims, a_data);
+  test.AddInput<int8_t>("T2", {K, N}, b_data, true);
+  test.AddInput<int8_t>("a_zero_point", {}, {a_zero_point});
+  test.AddInput<int8_t>("b_zero_point", {}, {b_zero_point});
+  test.AddOutput<int32_t>("T3", y_dims, y_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_int8_t_Constant_B) {
+  if (!DefaultCudaExecutionProvider() || !HasCudaEnvironment(530 /*min_cuda_architecture*/)) return;
+
+  RunMatMulIntegerInt8ConstantBTest({16, 32}, 32, 0, 0);
+  RunMatMulIntegerInt8ConstantBTest({37, 70}, 45, 3, -2);
+  RunMatMulIntegerInt8ConstantBTest({3, 17, 64}, 100, -5, 0);
+  RunMatMulIntegerInt8ConstantBTest({1, 129}, 7, 0, 4);
+}
+
 TEST(MatmulIntegerOpTest, MatMulInteger_WithZero_ZeroPoint) {
   OpTester test("MatMulInteger", 10);
   test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
@@ -344,5 +392,56 @@ TEST(MatmulIntegerOpTest, MatMulInteger_Uint8_Int8_GEMM) {
   RUN_MATMUL_INTEGER_U8X8(4, 8, 68);
 }
 
+// [batch x M x N] = [M x K] x [batch x K x N]
+template <typename ScalarB>
+void RunMatMulIntegerU8X8BatchedBTest(const int batch, const int M, const int N, const int K, bool B_is_initializer) {
+  OpTester test("MatMulInteger", 10);
+  static std::default_random_engine e(456);
+  static std::uniform_int_distribution<int> n_unsigned(0, 255);
+  static std::uniform_int_distribution<int> n_xint8(std::numeric_limits<ScalarB>::min(), std::numeric_limits<ScalarB>::max());
+
+  std::vector<uint8_t> matrix_a_data(M * K);
+  for (auto& v : matrix_a_data) {
+    v = static_cast<uint8_t>(n_unsigned(e));
+  }
+  std::vector<ScalarB> matrix_b_data(batch * K * N);
+  for (auto& v : matrix_b_data) {
+    v = static_cast<ScalarB>(n_xint8(e));
+  }
+  const uint8_t a_zero_point = GetMiddle(matrix_a_data);
+  const ScalarB b_zero_point = GetMiddle(matrix_b_data);
+
+  std::vector<int32_t> matrix_c_data(batch * M * N);
+  for (int b = 0; b < batch; b++) {
+    for (int m = 0; m < M; m++) {
+      for (int n = 0; n < N; n++) {
+        int32_t sum = 0;
+        for (int k = 0; k < K; k++) {
+          sum += (static_cast<int32_t>(matrix_a_data[m * K + k]) - a_zero_point) *
+                 (static_cast<int32_t>(matrix_b_data[(b * K + k) * N + n]) - b_zero_point);
+        }
+        matrix_c_data[(b * M + m) * N + n] = sum;
+      }
+    }
+  }
+
+  test.AddInput<uint8_t>("T1", {M, K}, std::move(matrix_a_data));
+  test.AddInput<ScalarB>("T2", {batch, K, N}, std::move(matrix_b_data), B_is_initializer);
+  test.AddInput<uint8_t>("a_zero_point", {}, {a_zero_point});
+  test.AddInput<ScalarB>("b_zero_point", {}, {b_zero_point});
+  test.AddOutput<int32_t>("T3", {batch, M, N}, std::move(matrix_c_data));
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider, kNupharExecutionProvider});
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_Uint8_Int8_B_ND) {
+  for (bool B_is_initializer : {false, true}) {
+    RunMatMulIntegerU8X8BatchedBTest<int8_t>(3, 4, 17, 33, B_is_initializer);
+    RunMatMulIntegerU8X8BatchedBTest<uint8_t>(3, 4, 17, 33, B_is_initializer);
+    RunMatMulIntegerU8X8BatchedBTest<int8_t>(2, 1, 40, 64, B_is_initializer);
+    RunMatMulIntegerU8X8BatchedBTest<uint8_t>(2, 1, 40, 64, B_is_initializer);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -145,5 +146,116 @@ TEST(MathOpTest, MatMulUint64Type) {
   RunMatMulTest<uint64_t>(9);
 }
 
+static void ConvertFloats(const std::vector<float>& values, std::vector<MLFloat16>& converted) {
+  converted.resize(values.size());
+  ConvertFloatToMLFloat16(values.data(), converted.data(), static_cast<int>(values.size()));
+}
+
+static void ConvertFloats(const std::vector<float>& values, std::vector<BFloat16>& converted) {
+  converted.resize(values.size());
+  FloatToBFloat16(values.data(), converted.data(), values.size());
+}
+
+// The test values are small integers, which MLFloat16 and BFloat16 represent exactly.
+template <typename T>
+void RunHalfMatMulTest(int32_t opset_version) {
+  std::vector<float> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  for (auto t : GenerateTestCases<float>()) {
+    OpTester test("MatMul", opset_version);
+
+    int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+    std::vector<T> input0_vals;
+    ConvertFloats(std::vector<float>(common_input_vals.cbegin(), common_input_vals.cbegin() + size0), input0_vals);
+    test.AddInput<T>("A", t.input0_dims, input0_vals);
+
+    int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+    std::vector<T> input1_vals;
+    ConvertFloats(std::vector<float>(common_input_vals.cbegin(), common_input_vals.cbegin() + size1), input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals);
+
+    std::vector<T> expected_vals;
+    ConvertFloats(t.expected_vals, expected_vals);
+    test.AddOutput<T>("Y", t.expected_dims, expected_vals);
+
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "",
+             {kTensorrtExecutionProvider, kOpenVINOExecutionProvider, kNnapiExecutionProvider});
+  }
+}
+
+TEST(MathOpTest, MatMulFloat16Type) {
+  RunHalfMatMulTest<MLFloat16>(9);
+  RunHalfMatMulTest<MLFloat16>(13);
+}
+
+TEST(MathOpTest, MatMulBFloat16Type) {
+  RunHalfMatMulTest<BFloat16>(13);
+}
+
+// Accumulates over several blocks of the inner dimension in float.
+TEST(MathOpTest, MatMulFloat16LargeK) {
+  const int64_t M = 3, K = 300, N = 5;
+  std::vector<float> a(M * K), b(K * N), y(M * N, 0.0f);
+  for (int64_t i = 0; i < M * K; ++i) {
+    a[i] = static_cast<float>(i % 3) - 1.0f;
+  }
+  for (int64_t i = 0; i < K * N; ++i) {
+    b[i] = static_cast<float>(i % 5) * 0.25f;
+  }
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y[m * N + n] += a[m * K + k] * b[k * N + n];
+      }
+    }
+  }
+
+  std::vector<MLFloat16> a_half, b_half, y_half;
+  ConvertFloats(a, a_half);
+  ConvertFloats(b, b_half);
+  ConvertFloats(y, y_half);
+
+  OpTester test("MatMul", 13);
+  test.AddInput<MLFloat16>("A", {M, K}, a_half);
+  test.AddInput<MLFloat16>("B", {K, N}, b_half);
+  test.AddOutput<MLFloat16>("Y", {M, N}, y_half);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+// A constant B with 4 of 5 blocks of 4 columns zero, multiplied by the sparse kernel for a threshold up to 0.8.
+TEST(MathOpTest, MatMulSparseInitializer) {
+  const int64_t batch = 2, M = 5, K = 7, N = 18;
+  std::vector<float> a(batch * M * K), b(K * N, 0.0f), y(batch * M * N, 0.0f);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  for (int64_t k = 0; k < K; ++k) {
+    // a single block of each row is non-zero, the last block is partial
+    const int64_t first = ((k % 5) * 4);
+    for (int64_t n = first; n < std::min(first + 4, N); ++n) {
+      b[k * N + n] = static_cast<float>((k + n) % 3) + 0.5f;
+    }
+  }
+  for (int64_t i = 0; i < batch * M; ++i) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y[i * N + n] += a[i * K + k] * b[k * N + n];
+      }
+    }
+  }
+
+  for (float threshold : {0.5f, 2.0f}) {
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {batch, M, K}, a);
+    test.AddInput<float>("B", {K, N}, b, true);
+    test.AddOutput<float>("Y", {batch, M, N}, y);
+
+    CPUExecutionProviderInfo info;
+    info.sparse_matmul_threshold = threshold;
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,10 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "core/mlas/inc/mlas.h"
+
+#include <cmath>
+#include <random>
 
 namespace onnxruntime {
 namespace test {
@@ -83,5 +87,77 @@ TEST(QuantizeLinearMatmulOpTest, QLinearMatMul) {
 TEST(QuantizeLinearMatmulOpTest, QLinearMatMulAllInputExceptT1AreInitializers) {
   QLinearMatMul2DTest(true);
 }
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+
+static void QLinearMatMulPerColumnTest(bool per_column_zero_points, bool only_t1_not_initializer) {
+  constexpr int64_t M = 5;
+  constexpr int64_t K = 19;
+  constexpr int64_t N = 6;
+
+  std::default_random_engine generator(1234);
+  std::uniform_int_distribution<int32_t> distribution(0, 255);
+
+  std::vector<uint8_t> a_data(M * K);
+  for (auto& a : a_data) {
+    a = static_cast<uint8_t>(distribution(generator));
+  }
+  std::vector<uint8_t> b_data(K * N);
+  for (auto& b : b_data) {
+    b = static_cast<uint8_t>(distribution(generator));
+  }
+
+  const float a_scale = 0.0066f;
+  const uint8_t a_zero_point = 113;
+  const std::vector<float> b_scale{0.0041f, 0.0057f, 0.0032f, 0.0070f, 0.0049f, 0.0063f};
+  const std::vector<uint8_t> b_zero_point = per_column_zero_points
+                                                ? std::vector<uint8_t>{114, 120, 97, 131, 128, 109}
+                                                : std::vector<uint8_t>{114};
+  const float y_scale = 0.0707f;
+  const uint8_t y_zero_point = 118;
+
+  std::vector<uint8_t> y_data(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      const int32_t b_offset = b_zero_point[b_zero_point.size() == 1 ? 0 : n];
+      int32_t sum = 0;
+      for (int64_t k = 0; k < K; k++) {
+        sum += (static_cast<int32_t>(a_data[m * K + k]) - a_zero_point) *
+               (static_cast<int32_t>(b_data[k * N + n]) - b_offset);
+      }
+      const float scale = (a_scale * b_scale[n]) / y_scale;
+      float value = static_cast<float>(sum) * scale;
+      value = std::min(value, static_cast<float>(255 - y_zero_point));
+      value = std::max(value, static_cast<float>(0 - y_zero_point));
+      y_data[m * N + n] = static_cast<uint8_t>(std::nearbyint(value) + y_zero_point);
+    }
+  }
+
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {M, K}, a_data);
+  test.AddInput<float>("a_scale", {}, {a_scale}, only_t1_not_initializer);
+  test.AddInput<uint8_t>("a_zero_point", {}, {a_zero_point}, only_t1_not_initializer);
+  test.AddInput<uint8_t>("T2", {K, N}, b_data, only_t1_not_initializer);
+  test.AddInput<float>("b_scale", {N}, b_scale, only_t1_not_initializer);
+  test.AddInput<uint8_t>("b_zero_point", {static_cast<int64_t>(b_zero_point.size())}, b_zero_point,
+                         only_t1_not_initializer);
+  test.AddInput<float>("y_scale", {}, {y_scale}, only_t1_not_initializer);
+  test.AddInput<uint8_t>("y_zero_point", {}, {y_zero_point}, only_t1_not_initializer);
+  test.AddOutput<uint8_t>("T3", {M, N}, y_data);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNnapiExecutionProvider});
+}
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulPerColumnScale) {
+  QLinearMatMulPerColumnTest(false, false);
+  QLinearMatMulPerColumnTest(false, true);
+}
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulPerColumnScaleAndZeroPoint) {
+  QLinearMatMulPerColumnTest(true, false);
+  QLinearMatMulPerColumnTest(true, true);
+}
+
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "test/common/cuda_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -556,5 +557,62 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded(k, n, batch_size);
 }
 
+// create input of 1x200000 and select 500. there are fewer rows than threads and the axis is large enough
+// for it to be split across the threads, whose candidates are then merged.
+// on CUDA the axis is long enough to use the radix select kernels.
+TEST(TopKOperator, SplitAxisThreaded) {
+  const int64_t k = 500;
+  const int64_t n = 1;
+  const int64_t batch_size = 200000;
+  TestThreaded(k, n, batch_size);
+}
+
+// K is too large for the block based CUDA kernels to sort
+TEST(TopKOperator, LargeK) {
+  const int64_t k = 20000;
+  const int64_t n = 2;
+  const int64_t batch_size = 50000;
+  TestThreaded(k, n, batch_size);
+}
+
+TEST(TopKOperator, LargeAxisFloat16WithTies) {
+  if (!DefaultCudaExecutionProvider() || !HasCudaEnvironment(530 /*min_cuda_architecture*/)) return;
+
+  const int64_t k = 600;
+  const int64_t dimension = 150000;
+
+  // 2048 distinct values repeated along the axis, so the top k have many ties that must be resolved by index
+  std::vector<float> input_vals(dimension);
+  for (int64_t i = 0; i < dimension; ++i) {
+    input_vals[i] = static_cast<float>((i * 7) % 2048) - 1024.f;
+  }
+
+  std::vector<int64_t> order(dimension);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&input_vals](int64_t a, int64_t b) { return input_vals[a] > input_vals[b]; });
+
+  std::vector<float> expected_vals(k);
+  std::vector<int64_t> expected_indices(order.begin(), order.begin() + k);
+  for (int64_t i = 0; i < k; ++i) {
+    expected_vals[i] = input_vals[expected_indices[i]];
+  }
+
+  std::vector<MLFloat16> f_input_vals(dimension);
+  std::vector<MLFloat16> f_expected_vals(k);
+  ConvertFloatToMLFloat16(input_vals.data(), f_input_vals.data(), static_cast<int>(dimension));
+  ConvertFloatToMLFloat16(expected_vals.data(), f_expected_vals.data(), static_cast<int>(k));
+
+  OpTester test("TopK", 11);
+  test.AddInput<MLFloat16>("X", {1, dimension}, f_input_vals);
+  test.AddInput<int64_t>("K", {1}, {k});
+  test.AddOutput<MLFloat16>("Values", {1, k}, f_expected_vals);
+  test.AddOutput<int64_t>("Indices", {1, k}, expected_indices);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -189,5 +190,50 @@ TEST(LabelEncoder, Int64ToInt64Opset2) {
   test.Run();
 }
 
+// A vocabulary large enough for every bucket size of the perfect hash, with a repeated key whose last value is kept.
+static void RunLargeVocabularyTest(bool perfect_hash) {
+  const int64_t num_keys = 5000;
+  std::vector<std::string> keys;
+  std::vector<std::int64_t> values;
+  for (int64_t i = 0; i < num_keys; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    values.push_back(i * 3);
+  }
+  keys.push_back("key9");
+  values.push_back(-9);
+
+  std::vector<std::string> input;
+  std::vector<std::int64_t> output;
+  for (int64_t i = 0; i < 2 * num_keys; i += 3) {
+    input.push_back("key" + std::to_string(i));
+    output.push_back(i == 9 ? -9 : (i < num_keys ? i * 3 : -1));
+  }
+  input.push_back("");
+  output.push_back(-1);
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  const std::vector<std::int64_t> dims{static_cast<std::int64_t>(input.size())};
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  CPUExecutionProviderInfo info;
+  info.ml_perfect_hash_tables = perfect_hash;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(LabelEncoder, StringToInt64LargeVocabularyOpset2) {
+  RunLargeVocabularyTest(false);
+}
+
+TEST(LabelEncoder, StringToInt64LargeVocabularyPerfectHashOpset2) {
+  RunLargeVocabularyTest(true);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
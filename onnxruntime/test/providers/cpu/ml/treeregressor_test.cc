@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+#include <limits>
 #include "gtest/gtest.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -183,5 +186,95 @@ TEST(MLOpTest, TreeRegressorSingleTargetMax) {
   GenTreeAndRunTest1("MAX", true);
 }
 
+// Enough rows for them to be evaluated in blocks, with a last block that is not a multiple of the vector width,
+// and missing values tracked on some nodes.
+template <typename T>
+void RunTreeRegressorManyRows(bool quantize_thresholds) {
+  const int64_t n_trees = 5;
+  const int64_t n_features = 3;
+  const int64_t n_rows = 301;
+
+  // complete trees of depth 3: node k has the children 2k+1 and 2k+2, the nodes 7 to 14 are leaves
+  std::vector<int64_t> lefts, rights, treeids, nodeids, featureids, missing_tracks;
+  std::vector<float> thresholds;
+  std::vector<std::string> modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_classids;
+  std::vector<float> target_weights;
+  for (int64_t t = 0; t < n_trees; ++t) {
+    for (int64_t k = 0; k < 15; ++k) {
+      bool leaf = k >= 7;
+      treeids.push_back(t);
+      nodeids.push_back(k);
+      lefts.push_back(leaf ? 0 : 2 * k + 1);
+      rights.push_back(leaf ? 0 : 2 * k + 2);
+      featureids.push_back(leaf ? 0 : (t + k) % n_features);
+      thresholds.push_back(leaf ? 0.f : static_cast<float>((t + 3 * k) % 7) / 4.f - 0.75f);
+      missing_tracks.push_back((t + k) % 2);
+      modes.push_back(leaf ? "LEAF" : "BRANCH_LEQ");
+      if (leaf) {
+        target_treeids.push_back(t);
+        target_nodeids.push_back(k);
+        target_classids.push_back(0);
+        target_weights.push_back(static_cast<float>(t * 16 + k));
+      }
+    }
+  }
+
+  std::vector<T> X(n_rows * n_features);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = i % 11 == 0 ? std::numeric_limits<T>::quiet_NaN() : static_cast<T>((i * 7) % 13) / 6 - 1;
+  }
+
+  std::vector<float> results(n_rows, 0.f);
+  for (int64_t r = 0; r < n_rows; ++r) {
+    for (int64_t t = 0; t < n_trees; ++t) {
+      int64_t k = 0;
+      while (k < 7) {
+        size_t node = static_cast<size_t>(t * 15 + k);
+        T val = X[r * n_features + featureids[node]];
+        k = (val <= thresholds[node] || (missing_tracks[node] && std::isnan(val))) ? lefts[node] : rights[node];
+      }
+      results[r] += static_cast<float>(t * 16 + k);
+    }
+  }
+
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  test.AddInput<T>("X", {n_rows, n_features}, X);
+  test.AddOutput<float>("Y", {n_rows, 1}, results);
+  if (quantize_thresholds) {
+    CPUExecutionProviderInfo info;
+    info.quantize_tree_ensemble_thresholds = true;
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  } else {
+    test.Run();
+  }
+}
+
+TEST(MLOpTest, TreeRegressorManyRows) {
+  RunTreeRegressorManyRows<float>(false);
+}
+
+TEST(MLOpTest, TreeRegressorManyRowsQuantizedThresholds) {
+  // the thresholds of the float input are only quantized without AVX2, double covers the quantized path everywhere
+  RunTreeRegressorManyRows<float>(true);
+  RunTreeRegressorManyRows<double>(true);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
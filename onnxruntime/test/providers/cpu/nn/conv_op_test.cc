@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
 namespace onnxruntime {
@@ -677,5 +678,67 @@ TEST(ConvTest, Conv1D_asymmetric_padding) {
   TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape, true);
 }
 
+// A 3x3 convolution with enough channels for the CPU provider to compute it with the Winograd algorithm, and with the
+// Winograd algorithm disabled.
+TEST(ConvTest, Conv2D_Winograd) {
+  const int64_t N = 2, C = 32, H = 13, W = 15, M = 24;
+  vector<float> X(N * C * H * W);
+  vector<float> Wt(M * C * 3 * 3);
+  vector<float> B(M);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(static_cast<int>(i * 7 % 13) - 6) * 0.05f;
+  }
+  for (size_t i = 0; i < Wt.size(); ++i) {
+    Wt[i] = static_cast<float>(static_cast<int>(i * 5 % 11) - 5) * 0.01f;
+  }
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<float>(i) * 0.1f - 1.0f;
+  }
+
+  // pads of 1 at the top and left and 0 at the bottom and right
+  const int64_t OH = H - 1, OW = W - 1;
+  vector<float> Y(N * M * OH * OW);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t oh = 0; oh < OH; ++oh) {
+        for (int64_t ow = 0; ow < OW; ++ow) {
+          double sum = B[m];
+          for (int64_t c = 0; c < C; ++c) {
+            for (int64_t kh = 0; kh < 3; ++kh) {
+              for (int64_t kw = 0; kw < 3; ++kw) {
+                const int64_t ih = oh + kh - 1, iw = ow + kw - 1;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += static_cast<double>(X[((n * C + c) * H + ih) * W + iw]) * Wt[((m * C + c) * 3 + kh) * 3 + kw];
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * OH + oh) * OW + ow] = static_cast<float>(sum);
+        }
+      }
+    }
+  }
+
+  for (bool disable_winograd : {false, true}) {
+    OpTester test("Conv", 11);
+    test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+    test.AddAttribute("pads", vector<int64_t>{1, 1, 0, 0});
+    test.AddInput<float>("X", {N, C, H, W}, X);
+    test.AddInput<float>("W", {M, C, 3, 3}, Wt, true);
+    test.AddInput<float>("B", {M}, B, true);
+    test.AddOutput<float>("Y", {N, M, OH, OW}, Y);
+
+    // a single intra-op thread, for which the cost of the Winograd algorithm is lower
+    SessionOptions so;
+    so.intra_op_param.thread_pool_size = 1;
+
+    CPUExecutionProviderInfo info;
+    info.disable_winograd_conv = disable_winograd;
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -114,5 +114,48 @@ TEST(InstanceNormalizationOpTest, InstanceNorm_2) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// The values of each channel have a large mean relative to their spread, which checks that the moments of the
+// channels are computed without a loss of precision.
+TEST(InstanceNormalizationOpTest, InstanceNormLargeMean) {
+  OpTester test("InstanceNormalization");
+  test.AddAttribute("epsilon", 1e-5F);
+
+  const int64_t N = 2;
+  const int64_t C = 3;
+  const int64_t spatial_size = 300;
+  vector<float> input(N * C * spatial_size);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = 1000.0F * static_cast<float>((i / spatial_size) + 1) + static_cast<float>(i % 13) * 0.125F;
+  }
+  vector<float> scale = {0.5F, 1.0F, 2.0F};
+  vector<float> B = {-1.0F, 0.0F, 1.0F};
+
+  vector<float> expected_output(input.size());
+  for (int64_t nc = 0; nc < N * C; nc++) {
+    const float* x = input.data() + nc * spatial_size;
+    double mean = 0.0;
+    for (int64_t i = 0; i < spatial_size; i++) {
+      mean += x[i];
+    }
+    mean /= spatial_size;
+    double variance = 0.0;
+    for (int64_t i = 0; i < spatial_size; i++) {
+      variance += (x[i] - mean) * (x[i] - mean);
+    }
+    variance /= spatial_size;
+    for (int64_t i = 0; i < spatial_size; i++) {
+      expected_output[nc * spatial_size + i] =
+          static_cast<float>((x[i] - mean) / std::sqrt(variance + 1e-5) * scale[nc % C] + B[nc % C]);
+    }
+  }
+
+  vector<int64_t> input_dims = {N, C, 15, 20};
+  test.AddInput<float>("input", input_dims, input);
+  test.AddInput<float>("scale", {C}, scale);
+  test.AddInput<float>("B", {C}, B);
+  test.AddOutput<float>("Y", input_dims, expected_output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
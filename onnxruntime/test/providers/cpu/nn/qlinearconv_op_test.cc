@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "core/mlas/inc/mlas.h"
+#include <cmath>
 #include <random>
 
 namespace onnxruntime {
@@ -260,6 +261,89 @@ TEST(QLinearConvTest, WithGroup_2D) {
                     {kNGraphExecutionProvider});
 }
 
+// The reference output matches the MLAS requantization, not the fixed point GEMMLOWP one.
+#ifdef MLAS_SUPPORTS_GEMM_U8X8_AND_REQUANTIZE_OUTPUT
+
+void RunDepthwiseConv2DTest(int64_t kernel_size, int64_t stride, int64_t pad) {
+  const int64_t batch_count = 2;
+  const int64_t channels = 6;
+  const int64_t input_height = 7;
+  const int64_t input_width = 9;
+  const int64_t output_height = (input_height + 2 * pad - kernel_size) / stride + 1;
+  const int64_t output_width = (input_width + 2 * pad - kernel_size) / stride + 1;
+
+  std::default_random_engine generator(static_cast<unsigned>(kernel_size * 10 + stride));
+  std::uniform_int_distribution<int> distribution(0, 255);
+
+  std::vector<uint8_t> x_data(static_cast<size_t>(batch_count * channels * input_height * input_width));
+  std::vector<uint8_t> w_data(static_cast<size_t>(channels * kernel_size * kernel_size));
+  std::vector<int32_t> b_data(static_cast<size_t>(channels));
+  for (auto& v : x_data) v = static_cast<uint8_t>(distribution(generator));
+  for (auto& v : w_data) v = static_cast<uint8_t>(distribution(generator));
+  for (auto& v : b_data) v = (distribution(generator) - 128) * 16;
+
+  QuantizedTensor X(x_data, 0.02f, 131);
+  QuantizedTensor W(w_data, 0.005f, 117);
+  QuantizedBiasTensor B(b_data, X.scale_ * W.scale_);
+
+  // Compute the reference output, requantizing the same way as the kernel.
+  const float y_scale = 0.125f;
+  const uint8_t y_zero_point = 124;
+  const float real_multiplier = (X.scale_ * W.scale_) / y_scale;
+
+  std::vector<uint8_t> y_data;
+  for (int64_t n = 0; n < batch_count; n++) {
+    for (int64_t c = 0; c < channels; c++) {
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          int32_t sum = b_data[c];
+          for (int64_t kh = 0; kh < kernel_size; kh++) {
+            for (int64_t kw = 0; kw < kernel_size; kw++) {
+              const int64_t ih = oh * stride + kh - pad;
+              const int64_t iw = ow * stride + kw - pad;
+              if (ih >= 0 && ih < input_height && iw >= 0 && iw < input_width) {
+                const int32_t x = x_data[static_cast<size_t>(((n * channels + c) * input_height + ih) * input_width + iw)];
+                const int32_t w = w_data[static_cast<size_t>((c * kernel_size + kh) * kernel_size + kw)];
+                sum += (x - X.zero_point_) * (w - W.zero_point_);
+              }
+            }
+          }
+          float y = static_cast<float>(sum) * real_multiplier;
+          y = std::min(std::max(y, static_cast<float>(0 - y_zero_point)), static_cast<float>(255 - y_zero_point));
+          y_data.push_back(static_cast<uint8_t>(static_cast<int32_t>(std::nearbyint(y)) + y_zero_point));
+        }
+      }
+    }
+  }
+
+  QuantizedTensor Y(y_data, y_scale, y_zero_point);
+
+  OpTester test("QLinearConv", 10);
+  test.AddAttribute("group", channels);
+  test.AddAttribute("pads", std::vector<int64_t>{pad, pad, pad, pad});
+  test.AddAttribute("strides", std::vector<int64_t>{stride, stride});
+
+  TestQLinearConvOp(test,
+                    X, {batch_count, channels, input_height, input_width},
+                    W, {channels, 1, kernel_size, kernel_size},
+                    &B,
+                    Y, {batch_count, channels, output_height, output_width},
+                    false,
+                    {kNGraphExecutionProvider});
+}
+
+TEST(QLinearConvTest, Depthwise_2D_3x3) {
+  RunDepthwiseConv2DTest(3, 1, 1);
+  RunDepthwiseConv2DTest(3, 2, 1);
+}
+
+TEST(QLinearConvTest, Depthwise_2D_5x5) {
+  RunDepthwiseConv2DTest(5, 1, 2);
+  RunDepthwiseConv2DTest(5, 2, 2);
+}
+
+#endif
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
 template <typename T1, typename T2>
@@ -276,6 +360,7 @@ class QLinearConvOpTester {
   std::default_random_engine generator_{1234};
   QuantizedTensor<T1> X_;
   QuantizedTensor<T2> W_;
+  std::vector<T2> W_zero_points_;
   std::vector<int32_t> B_;
   std::vector<int64_t> pads_;
   std::vector<int64_t> strides_;
@@ -407,6 +492,7 @@ class QLinearConvOpTester {
           int64_t channel_index = group * group_output_channels + oc;
           int32_t bias = B_.empty() ? 0 : B_[channel_index];
           float weight_scale = W_.scale_[(W_.scale_.size() == 1) ? 0 : channel_index];
+          int32_t weight_zero_point = W_zero_points_.empty() ? W_.zero_point_ : W_zero_points_[channel_index];
           float requantize_scale = (X_.scale_[0] * weight_scale) / output_scale_;
 
           for (int64_t oh = 0; oh < output_h; oh++) {
@@ -419,7 +505,7 @@ class QLinearConvOpTester {
                   int64_t ih = kh * dilation_h + oh * stride_h - pad_t;
                   for (int64_t kw = 0; kw < kernel_w; kw++) {
                     int64_t iw = kw * dilation_w + ow * stride_w - pad_l;
-                    int32_t w_value = static_cast<int32_t>(*weight_data++);
+                    int32_t w_value = static_cast<int32_t>(*weight_data++) - weight_zero_point;
                     if (static_cast<uint64_t>(ih) < static_cast<uint64_t>(input_h) &&
                         static_cast<uint64_t>(iw) < static_cast<uint64_t>(input_w)) {
                       int32_t x_value = static_cast<int32_t>(input_image[ih * input_w + iw]) - X_zero_point;
@@ -456,7 +542,12 @@ class QLinearConvOpTester {
     const std::vector<int64_t> W_scale_shape{static_cast<int64_t>(W_.scale_.size())};
     test.AddInput<T2>("w", W_.shape_, W_.data_, all_input_initializer_except_x);
     test.AddInput<float>("w_scale", W_scale_shape, W_.scale_, all_input_initializer_except_x);
-    test.AddInput<T2>("w_zero_point", {}, {W_.zero_point_});
+    if (W_zero_points_.empty()) {
+      test.AddInput<T2>("w_zero_point", {}, {W_.zero_point_});
+    } else {
+      const std::vector<int64_t> W_zero_point_shape{static_cast<int64_t>(W_zero_points_.size())};
+      test.AddInput<T2>("w_zero_point", W_zero_point_shape, W_zero_points_);
+    }
 
     test.AddInput<float>("y_scale", {}, {output_scale_}, all_input_initializer_except_x);
     test.AddInput<T1>("y_zero_point", {}, {output_zero_point_});
@@ -493,13 +584,19 @@ class QLinearConvOpTester {
   }
 
   void GenerateRandomWeights(const std::vector<int64_t>& shape, float scale, T2 zero_point) {
-    GenerateRandom(W_, shape, scale, zero_point, -63, 63);
+    GenerateRandom(W_, shape, scale, zero_point,
+                   std::max<int32_t>(zero_point - 63, std::numeric_limits<T2>::min()),
+                   std::min<int32_t>(zero_point + 63, std::numeric_limits<T2>::max()));
   }
 
   void SetWeightScales(const std::vector<float>& scales) {
     W_.scale_ = scales;
   }
 
+  void SetWeightZeroPoints(const std::vector<T2>& zero_points) {
+    W_zero_points_ = zero_points;
+  }
+
   void GenerateRandomBias() {
     ORT_ENFORCE(W_.shape_.size() >= 1);
     const size_t output_channels = static_cast<size_t>(W_.shape_[0]);
@@ -589,6 +686,68 @@ TEST(QLinearConvTest, Conv2D_U8S8_Groups_PerChannel) {
   test.Run();
 }
 
+TEST(QLinearConvTest, Conv2D_U8S8_PerChannelZeroPoints) {
+  QLinearConvOpTester<uint8_t, int8_t> test;
+  test.GenerateRandomInput({2, 6, 11, 9}, .04f, 12);
+  test.GenerateRandomWeights({4, 6, 3, 3}, .09f, 0);
+  test.SetWeightScales({.12f, .09f, .15f, .10f});
+  test.SetWeightZeroPoints({0, 3, -2, 5});
+  test.GenerateRandomBias();
+  test.SetPads({1, 1, 1, 1});
+  test.SetOutputScaleAndZeroPoint(.45f, 100);
+  test.Run();
+}
+
+TEST(QLinearConvTest, Conv2D_U8U8) {
+  QLinearConvOpTester<uint8_t, uint8_t> test;
+  test.GenerateRandomInput({3, 24, 15, 11}, .05f, 4);
+  test.GenerateRandomWeights({32, 24, 3, 3}, .125f, 128);
+  test.GenerateRandomBias();
+  test.SetPads({1, 1, 1, 1});
+  test.SetOutputScaleAndZeroPoint(.55f, 54);
+  test.Run();
+}
+
+TEST(QLinearConvTest, Conv2D_U8U8_Pointwise) {
+  QLinearConvOpTester<uint8_t, uint8_t> test;
+  test.GenerateRandomInput({1, 16, 9, 7}, .05f, 10);
+  test.GenerateRandomWeights({20, 16, 1, 1}, .08f, 100);
+  test.SetOutputScaleAndZeroPoint(.32f, 70);
+  test.Run();
+}
+
+TEST(QLinearConvTest, Conv2D_U8U8_Groups_PerChannel) {
+  QLinearConvOpTester<uint8_t, uint8_t> test;
+  test.GenerateRandomInput({1, 8, 13, 17}, .03f, 7);
+  test.GenerateRandomWeights({10, 4, 3, 3}, .10f, 120);
+  test.SetWeightScales({.15f, .14f, .11f, .13f, .15f, .09f, .12f, .16f, .17f, .07f});
+  test.SetWeightZeroPoints({120, 118, 125, 121, 119, 120, 123, 117, 122, 120});
+  test.GenerateRandomBias();
+  test.SetPads({1, 1, 1, 1});
+  test.SetGroups(2);
+  test.SetOutputScaleAndZeroPoint(.76f, 88);
+  test.Run();
+}
+
+TEST(QLinearConvTest, Depthwise_U8U8_PerChannel) {
+  // Per channel scales use the direct depthwise algorithm, per channel zero
+  // points fall back to the GEMM path.
+  for (bool per_channel_zero_points : {false, true}) {
+    QLinearConvOpTester<uint8_t, uint8_t> test;
+    test.GenerateRandomInput({2, 6, 10, 12}, .04f, 9);
+    test.GenerateRandomWeights({6, 1, 3, 3}, .11f, 128);
+    test.SetWeightScales({.11f, .08f, .13f, .10f, .12f, .09f});
+    if (per_channel_zero_points) {
+      test.SetWeightZeroPoints({128, 126, 131, 128, 125, 130});
+    }
+    test.GenerateRandomBias();
+    test.SetPads({1, 1, 1, 1});
+    test.SetGroups(6);
+    test.SetOutputScaleAndZeroPoint(.35f, 110);
+    test.Run();
+  }
+}
+
 #endif
 
 }  // namespace
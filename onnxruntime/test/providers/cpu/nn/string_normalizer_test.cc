@@ -166,6 +166,29 @@ TEST(ContribOpTest, StringNormalizerTest) {
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 
+  // - case-insensitive approach
+  // - ASCII and non-ASCII strings mixed
+  // - filter out monday and Понедельник
+  // - LOWER
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {u8"MONDAY", u8"понедельник"}, test_locale);
+    std::vector<int64_t> dims{6};
+    std::vector<std::string> input = {std::string(u8"Monday"),
+                                      std::string(u8"TUESDAY-[@`{]"),
+                                      std::string(u8"Понедельник"),
+                                      std::string(u8"École"),
+                                      std::string(u8""),
+                                      std::string(u8"Wednesday 中文")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"tuesday-[@`{]"),
+                                       std::string(u8"école"),
+                                       std::string(u8""),
+                                       std::string(u8"wednesday 中文")};
+    test.AddOutput<std::string>("Y", {4}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
   // Empty output case
   // - casesensitive approach
   // - filter out monday
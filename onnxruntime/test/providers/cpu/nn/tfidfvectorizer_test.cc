@@ -690,6 +690,47 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5_2rows) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// Many rows with a skip distance, checked against a direct count of the pool n-grams
+TEST(TfIdfVectorizerTest, Int64_TFIDF_ManyRows_Skip1) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // unigrams 2 and 5, bigrams (2, 5) and (5, 5)
+  InitTestAttr(test, "TFIDF", 1, 2, 1,
+               {0, 2},
+               {0, 1, 2, 3},
+               {1.f, 2.f, 3.f, 4.f},
+               {2, 5,
+                2, 5, 5, 5},
+               {});
+
+  const int64_t num_rows = 200;
+  const int64_t row_size = 9;
+  std::vector<int64_t> input;
+  for (int64_t i = 0; i < num_rows * row_size; ++i) {
+    input.push_back((i * 7 + i / 5) % 6);
+  }
+
+  std::vector<float> output(num_rows * 4, 0.f);
+  for (int64_t r = 0; r < num_rows; ++r) {
+    const int64_t* row = input.data() + r * row_size;
+    float* counts = output.data() + r * 4;
+    for (int64_t i = 0; i < row_size; ++i) {
+      counts[0] += row[i] == 2;
+      counts[1] += row[i] == 5;
+      for (int64_t skip = 1; skip <= 2 && i + skip < row_size; ++skip) {
+        counts[2] += row[i] == 2 && row[i + skip] == 5;
+        counts[3] += row[i] == 5 && row[i + skip] == 5;
+      }
+    }
+    for (int64_t k = 0; k < 4; ++k) {
+      counts[k] *= static_cast<float>(k + 1);
+    }
+  }
+
+  test.AddInput<int64_t>("T", {num_rows, row_size}, input);
+  test.AddOutput<float>("Y", {num_rows, 4}, output);
+  test.Run();
+}
+
 // This test runs the inference 100 times to test the improvement
 // It enables profiling while running inference multiple times.
 // So we can manually inspect the profiling output
@@ -288,6 +288,43 @@ TEST(NonMaxSuppressionOpTest, SelectFromIdenticalBoxes) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, SuppressByBoxBeyondFirstSelectedBlock) {
+  // Ten disjoint boxes are selected first; box 10 overlaps the tenth selected box and must be suppressed,
+  // box 11 overlaps nothing and is still selected.
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, 12, 4},
+                       {0.0f, 0.0f, 1.0f, 1.0f,
+                        0.0f, 10.0f, 1.0f, 11.0f,
+                        0.0f, 20.0f, 1.0f, 21.0f,
+                        0.0f, 30.0f, 1.0f, 31.0f,
+                        0.0f, 40.0f, 1.0f, 41.0f,
+                        0.0f, 50.0f, 1.0f, 51.0f,
+                        0.0f, 60.0f, 1.0f, 61.0f,
+                        0.0f, 70.0f, 1.0f, 71.0f,
+                        0.0f, 80.0f, 1.0f, 81.0f,
+                        0.0f, 90.0f, 1.0f, 91.0f,
+                        0.0f, 90.1f, 1.0f, 91.1f,
+                        0.0f, 200.0f, 1.0f, 201.0f});
+  test.AddInput<float>("scores", {1, 1, 12},
+                       {0.9f, 0.85f, 0.8f, 0.75f, 0.7f, 0.65f, 0.6f, 0.55f, 0.5f, 0.45f, 0.1f, 0.05f});
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {20L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {11, 3},
+                          {0L, 0L, 0L,
+                           0L, 0L, 1L,
+                           0L, 0L, 2L,
+                           0L, 0L, 3L,
+                           0L, 0L, 4L,
+                           0L, 0L, 5L,
+                           0L, 0L, 6L,
+                           0L, 0L, 7L,
+                           0L, 0L, 8L,
+                           0L, 0L, 9L,
+                           0L, 0L, 11L});
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 6, 4},
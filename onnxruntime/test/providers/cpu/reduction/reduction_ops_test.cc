@@ -1,8 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <random>
 #include <cmath>
+#include <limits>
 #include <type_traits>
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -1960,6 +1962,54 @@ TEST(ReduceApiTest, Sum) {
 
 #endif
 
+// Reductions of the trailing axes of <m> rows of <n> values, with shapes for rows reduced by one warp, one block and
+// several blocks each in the CUDA kernels.
+void TestReduceTrailingAxes(const std::string& op, int64_t m, int64_t n, float tolerance = 1e-4f) {
+  RandomValueGenerator random_value_generator{};
+  const auto input = random_value_generator.Uniform<float>({m, n}, -1.0f, 1.0f);
+  std::vector<float> expected(m);
+  for (int64_t i = 0; i < m; ++i) {
+    const float* row = input.data() + i * n;
+    double value = op == "ReduceMax" ? row[0] : 0.0;
+    for (int64_t j = 0; j < n; ++j) {
+      if (op == "ReduceMax") {
+        value = std::max(value, static_cast<double>(row[j]));
+      } else if (op == "ReduceL2") {
+        value += static_cast<double>(row[j]) * row[j];
+      } else {
+        value += row[j];
+      }
+    }
+    expected[i] = static_cast<float>(op == "ReduceL2" ? std::sqrt(value) : op == "ReduceMean" ? value / n : value);
+  }
+
+  OpTester test(op.c_str());
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", static_cast<int64_t>(0));
+  test.AddInput<float>("data", {m, n}, input);
+  test.AddOutput<float>("reduced", {m}, expected);
+  test.SetOutputAbsErr("reduced", tolerance);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(ReductionOpTest, ReduceTrailingAxesWarpPerRow) {
+  TestReduceTrailingAxes("ReduceMean", 300, 64);
+  TestReduceTrailingAxes("ReduceL2", 300, 64);
+  TestReduceTrailingAxes("ReduceMax", 300, 64);
+}
+
+TEST(ReductionOpTest, ReduceTrailingAxesBlockPerRow) {
+  TestReduceTrailingAxes("ReduceMean", 64, 4096);
+  TestReduceTrailingAxes("ReduceL2", 64, 4096);
+  TestReduceTrailingAxes("ReduceMax", 64, 4096);
+}
+
+TEST(ReductionOpTest, ReduceTrailingAxesSplitRows) {
+  TestReduceTrailingAxes("ReduceMean", 2, 1 << 17);
+  TestReduceTrailingAxes("ReduceL2", 2, 1 << 17, 1e-2f);
+  TestReduceTrailingAxes("ReduceMax", 2, 1 << 17);
+}
+
 TEST(ReductionOpTest, ArgMin_int32_neg_axis) {
   OpTester test("ArgMin");
   test.AddAttribute("axis", (int64_t)(-3));
@@ -2018,5 +2068,74 @@ TEST(ReductionOpTest, ReduceDimWithZero) {
   run(test3);
 }
 
+// The axes of a NCHW tensor are fused into contiguous (KR), strided (RK, KRK) or generic (RKR) reductions
+// depending on which of them are reduced. Check each layout against a reduction done one value at a time.
+TEST(ReductionOpTest, ReduceFusedAxesLayouts) {
+  const std::vector<int64_t> dims{2, 3, 4, 300};
+  std::vector<float> data(2 * 3 * 4 * 300);
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  for (auto& value : data) {
+    value = distribution(generator);
+  }
+
+  auto add_axis = [](const std::vector<std::vector<int64_t>>& indices, int64_t dim) {
+    std::vector<std::vector<int64_t>> result;
+    for (const auto& index : indices) {
+      for (int64_t i = 0; i < dim; ++i) {
+        result.push_back(index);
+        result.back().push_back(i);
+      }
+    }
+    return result;
+  };
+
+  for (const auto& axes : std::vector<std::vector<int64_t>>{{2, 3}, {1}, {0}, {0, 1}, {0, 2, 3}, {1, 3}}) {
+    // enumerate the kept indices then the reduced ones, outermost first, in the input's order
+    std::vector<std::vector<int64_t>> kept{{}};
+    std::vector<std::vector<int64_t>> reduced{{}};
+    std::vector<int64_t> output_dims;
+    for (int64_t axis = 0; axis < 4; ++axis) {
+      bool is_reduced = std::find(axes.begin(), axes.end(), axis) != axes.end();
+      if (is_reduced) {
+        reduced = add_axis(reduced, dims[axis]);
+      } else {
+        kept = add_axis(kept, dims[axis]);
+      }
+      output_dims.push_back(is_reduced ? 1 : dims[axis]);
+    }
+
+    std::vector<float> expected_mean;
+    std::vector<float> expected_max;
+    for (const auto& kept_index : kept) {
+      double sum = 0;
+      float max = std::numeric_limits<float>::lowest();
+      for (const auto& reduced_index : reduced) {
+        int64_t offset = 0;
+        for (int64_t axis = 0, k = 0, r = 0; axis < 4; ++axis) {
+          bool is_reduced = std::find(axes.begin(), axes.end(), axis) != axes.end();
+          offset = offset * dims[axis] + (is_reduced ? reduced_index[r++] : kept_index[k++]);
+        }
+        sum += data[offset];
+        max = std::max(max, data[offset]);
+      }
+      expected_mean.push_back(static_cast<float>(sum / reduced.size()));
+      expected_max.push_back(max);
+    }
+
+    OpTester test_mean("ReduceMean");
+    test_mean.AddAttribute("axes", axes);
+    test_mean.AddInput<float>("data", dims, data);
+    test_mean.AddOutput<float>("reduced", output_dims, expected_mean);
+    test_mean.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+    OpTester test_max("ReduceMax");
+    test_max.AddAttribute("axes", axes);
+    test_max.AddInput<float>("data", dims, data);
+    test_max.AddOutput<float>("reduced", output_dims, expected_max);
+    test_max.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
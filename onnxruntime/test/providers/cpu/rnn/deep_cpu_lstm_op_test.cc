@@ -7,7 +7,10 @@
 #include <vector>
 
 #include "core/providers/cpu/rnn/deep_cpu_lstm.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -1206,5 +1209,78 @@ TEST(LSTMTest, ONNXRuntime_TestLSTMZeroSeqInMiddle) {
 }
 #endif // USE_NGRAPH
 
+// Runs a forward LSTM over the frames of a sequence one Run at a time in streaming mode, and checks the final states
+// match those of a single Run over the whole sequence.
+TEST(LSTMTest, StreamingMatchesWholeSequence) {
+  const int64_t input_size = 2;
+  const int64_t hidden_size = 3;
+  const std::vector<float> X_data{0.1f, 0.2f, 0.3f, -0.4f, 0.5f, 0.6f};
+  const int64_t seq_length = static_cast<int64_t>(X_data.size()) / input_size;
+
+  // build a model with a symbolic sequence length and the weights as initializers so they are pre-packed
+  OpTester test("LSTM");
+  test.AddAttribute("hidden_size", hidden_size);
+  std::vector<std::string> X_dim_params{"seq", "1", "2"};
+  test.AddInput<float>("X", {seq_length, 1, input_size}, X_data, false, &X_dim_params);
+  test.AddInput<float>("W", {1, 4 * hidden_size, input_size}, std::vector<float>(4 * hidden_size * input_size, 0.1f),
+                       true);
+  test.AddInput<float>("R", {1, 4 * hidden_size, hidden_size}, std::vector<float>(4 * hidden_size * hidden_size, 0.2f),
+                       true);
+  test.AddMissingOptionalOutput<float>();
+  test.AddOutput<float>("Y_h", {1, 1, hidden_size}, std::vector<float>(hidden_size));
+  test.AddOutput<float>("Y_c", {1, 1, hidden_size}, std::vector<float>(hidden_size));
+
+  std::string model_data;
+  test.BuildGraph()->ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+  SessionOptions so;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto run = [&](const RunOptions& run_options, int64_t first_frame, int64_t num_frames,
+                 std::vector<OrtValue>& fetches) {
+    OrtValue X;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {num_frames, 1, input_size},
+                         std::vector<float>(X_data.begin() + first_frame * input_size,
+                                            X_data.begin() + (first_frame + num_frames) * input_size),
+                         &X);
+    fetches.clear();
+    ASSERT_STATUS_OK(session_object.Run(run_options, {"X"}, {X}, {"Y_h", "Y_c"}, &fetches));
+  };
+
+  auto expect_same_outputs = [](const std::vector<OrtValue>& actual, const std::vector<OrtValue>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+      auto actual_values = actual[i].Get<Tensor>().DataAsSpan<float>();
+      auto expected_values = expected[i].Get<Tensor>().DataAsSpan<float>();
+      ASSERT_EQ(actual_values.size(), expected_values.size());
+      for (ptrdiff_t j = 0; j < actual_values.size(); ++j) {
+        EXPECT_NEAR(actual_values[j], expected_values[j], 1e-6f);
+      }
+    }
+  };
+
+  RunOptions stateless;
+  std::vector<OrtValue> whole_sequence;
+  run(stateless, 0, seq_length, whole_sequence);
+  std::vector<OrtValue> last_frame;
+  run(stateless, seq_length - 1, 1, last_frame);
+
+  RunOptions streaming;
+  streaming.stream_id = "utterance";
+  std::vector<OrtValue> fetches;
+  for (int64_t frame = 0; frame < seq_length; ++frame) {
+    streaming.end_of_stream = frame == seq_length - 1;
+    run(streaming, frame, 1, fetches);
+  }
+  expect_same_outputs(fetches, whole_sequence);
+
+  // the state was released at the end of the stream, so the stream starts over
+  streaming.end_of_stream = false;
+  run(streaming, seq_length - 1, 1, fetches);
+  expect_same_outputs(fetches, last_frame);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
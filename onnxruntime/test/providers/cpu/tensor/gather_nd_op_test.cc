@@ -309,5 +309,14 @@ TEST(GatherNDOpTest, GatherND_slice_int64_t) {
   test.Run();
 }
 
+TEST(GatherNDOpTest, GatherND_index_out_of_bounds) {
+  OpTester test("GatherND", 12, kOnnxDomain);
+  test.AddInput<float>("data", {2, 2}, {0.0f, 0.1f, 0.2f, 0.3f});
+  test.AddInput<int64_t>("indices", {2, 1}, {1LL, 2LL});
+  test.AddOutput<float>("output", {2, 2}, {0.2f, 0.3f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "invalid index found, index = 2",
+           {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
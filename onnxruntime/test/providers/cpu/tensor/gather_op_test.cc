@@ -286,6 +286,21 @@ TEST(GatherOpTest, Gather_axis1_indices2d_string) {
   test.Run();
 }
 
+TEST(GatherOpTest, Gather_axis0_indices1d_string) {
+  // every gathered row holds more than one string
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<std::string>("data", {3, 3},
+                             {"0", "1", "2",
+                              "10", "11", "12",
+                              "20", "21", "22"});
+  test.AddInput<int64_t>("indices", {2}, {2LL, -3LL});
+  test.AddOutput<std::string>("output", {2, 3},
+                              {"20", "21", "22",
+                               "0", "1", "2"});
+  test.Run();
+}
+
 TEST(GatherOpTest, Gather_axis1_indices2d_bool) {
   OpTester test("Gather");
   test.AddAttribute<int64_t>("axis", 1LL);
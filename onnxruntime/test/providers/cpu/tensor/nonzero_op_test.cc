@@ -82,6 +82,30 @@ TEST(NonZeroOpTest, Scalar) {
   }
 }
 
+// large enough for the input to be split between several threads
+TEST(NonZeroOpTest, Large) {
+  OpTester test{kOpName, kOpVersion};
+
+  constexpr int64_t rows = 300, cols = 301;
+  std::vector<int32_t> X(rows * cols, 0);
+  std::vector<int64_t> Y_rows, Y_cols;
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      if ((i * cols + j) % 7 == 3) {
+        X[i * cols + j] = 1;
+        Y_rows.push_back(i);
+        Y_cols.push_back(j);
+      }
+    }
+  }
+
+  std::vector<int64_t> Y(Y_rows);
+  Y.insert(Y.end(), Y_cols.begin(), Y_cols.end());
+  test.AddInput<int32_t>("X", {rows, cols}, X);
+  test.AddOutput<int64_t>("Y", {2, static_cast<int64_t>(Y_rows.size())}, Y);
+  test.Run();
+}
+
 TEST(NonZeroOpTest, EmptyInput) {
   OpTester test{kOpName, kOpVersion};
   test.AddInput<int32_t>(
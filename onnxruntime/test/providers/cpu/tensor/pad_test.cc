@@ -360,6 +360,41 @@ TYPED_TEST(PadOpTest, Pad_Reflect_2D) {
                                   "reflect");
 }
 
+// the padded outer axis is copied by rows, it is not flattened with the inner axes without padding
+TYPED_TEST(PadOpTest, Pad_Edge_OuterAxis) {
+  using T = TypeParam;
+  RunAllOpsetAllDomainPadTests<T>({2, 2, 2},
+                                  {T(1), T(2), T(3), T(4),
+                                   T(5), T(6), T(7), T(8)},
+                                  {1, 0, 0, 2, 0, 0},
+                                  T(0),
+                                  {5, 2, 2},
+                                  {T(1), T(2), T(3), T(4),
+                                   T(1), T(2), T(3), T(4),
+                                   T(5), T(6), T(7), T(8),
+                                   T(5), T(6), T(7), T(8),
+                                   T(5), T(6), T(7), T(8)},
+                                  "edge");
+}
+
+TYPED_TEST(PadOpTest, Pad_Reflect_OuterAxis) {
+  using T = TypeParam;
+  RunAllOpsetAllDomainPadTests<T>({3, 2},
+                                  {T(1), T(2),
+                                   T(3), T(4),
+                                   T(5), T(6)},
+                                  {2, 0, 1, 0},
+                                  T(0),
+                                  {6, 2},
+                                  {T(5), T(6),
+                                   T(3), T(4),
+                                   T(1), T(2),
+                                   T(3), T(4),
+                                   T(5), T(6),
+                                   T(3), T(4)},
+                                  "reflect");
+}
+
 
 /*
 Example numpy for testing behavior
@@ -279,6 +279,41 @@ TEST(ResizeOpTest, ResizeOpLinearUpSampleTest_2DBilinear_align_corners) {
   test.Run();
 }
 
+TEST(ResizeOpTest, ResizeOpLinearUpSampleTest_4DBilinear_asymmetric_uint8) {
+  OpTester test("Resize", 11);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 1.0f, 2.0f, 4.0f};
+
+  test.AddAttribute("mode", "linear");
+  test.AddAttribute("coordinate_transformation_mode", "asymmetric");
+
+  const int64_t N = 2, C = 1, H = 2, W = 2;
+  std::vector<uint8_t> X = {1, 3,
+                            4, 8,
+
+                            6, 2,
+                            7, 11};
+
+  test.AddInput<uint8_t>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+
+  // The CPU kernel interpolates uint8_t in fixed point and rounds to nearest
+  std::vector<uint8_t> Y = {
+      1, 2, 2, 3, 3, 3, 3, 3,
+      3, 3, 4, 5, 6, 6, 6, 6,
+      4, 5, 6, 7, 8, 8, 8, 8,
+      4, 5, 6, 7, 8, 8, 8, 8,
+
+      6, 5, 4, 3, 2, 2, 2, 2,
+      7, 7, 7, 7, 7, 7, 7, 7,
+      7, 8, 9, 10, 11, 11, 11, 11,
+      7, 8, 9, 10, 11, 11, 11, 11};
+
+  test.AddOutput<uint8_t>("Y", {N, C, static_cast<int64_t>(H * scales[2]), static_cast<int64_t>(W * scales[3])}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
 TEST(ResizeOpTest, ResizeOpLinearDownSampleTest_3DTrilinear_pytorch_half_pixel) {
   OpTester test("Resize", 11);
   std::vector<float> roi{};
@@ -155,5 +155,15 @@ TEST(ScatterNDOpTest, ScatterND_batched_3tensor_int64) {
   test3.Run();
 }
 
+TEST(ScatterNDOpTest, ScatterND_repeated_index_float_int64) {
+  // The CPU kernel applies repeated indices serially, so the last update wins
+  OpTester test("ScatterND", 11);
+  test.AddInput<float>("data", {3, 2}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.AddInput<int64_t>("indices", {3, 1}, {1LL, 2LL, 1LL});
+  test.AddInput<float>("updates", {3, 2}, {1.0f, 1.1f, 2.0f, 2.1f, 3.0f, 3.1f});
+  test.AddOutput<float>("output", {3, 2}, {0.0f, 0.0f, 3.0f, 3.1f, 2.0f, 2.1f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
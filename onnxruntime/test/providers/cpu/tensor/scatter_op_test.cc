@@ -51,6 +51,37 @@ TEST(Scatter, WithAxis) {
   scatter_with_axis_tests("ScatterElements", 11);
 }
 
+static void scatter_partial_updates_tests(const char* op_name, int op_version) {
+  // updates cover only part of the non-axis dimensions, and repeat an index along the axis
+  OpTester test1(op_name, op_version);
+  test1.AddAttribute<int64_t>("axis", 1);
+  test1.AddInput<float>("data", {3, 4}, std::vector<float>(12, 0.0f));
+  test1.AddInput<int64_t>("indices", {2, 2}, {1, 1, 3, 0});
+  test1.AddInput<float>("updates", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test1.AddOutput<float>("y", {3, 4},
+                         {0.0f, 2.0f, 0.0f, 0.0f,
+                          4.0f, 0.0f, 0.0f, 3.0f,
+                          0.0f, 0.0f, 0.0f, 0.0f});
+  // CUDA: the order of updates to the same element is not defined
+  test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+
+  OpTester test2(op_name, op_version);
+  test2.AddAttribute<int64_t>("axis", 0);
+  test2.AddInput<float>("data", {3, 3}, std::vector<float>(9, 0.0f));
+  test2.AddInput<int64_t>("indices", {2, 2}, {2, 0, 1, 2});
+  test2.AddInput<float>("updates", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test2.AddOutput<float>("y", {3, 3},
+                         {0.0f, 2.0f, 0.0f,
+                          3.0f, 0.0f, 0.0f,
+                          1.0f, 4.0f, 0.0f});
+  test2.Run();
+}
+
+TEST(Scatter, PartialUpdates) {
+  scatter_partial_updates_tests("Scatter", 9);
+  scatter_partial_updates_tests("ScatterElements", 11);
+}
+
 static void scatter_three_dim_with_axis_0(const char* op_name, int op_version) {
   OpTester test(op_name, op_version);
   test.AddAttribute<int64_t>("axis", 0);
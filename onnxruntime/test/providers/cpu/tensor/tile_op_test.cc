@@ -43,6 +43,12 @@ void RunTestWrapper() {
 
   // Tile3D
   RunTest<T>({111, 112, 113, 122, 123, 124}, {2, 1, 3}, {1, 2, 1}, {3}, {111, 112, 113, 111, 112, 113, 122, 123, 124, 122, 123, 124}, {2, 2, 3});
+
+  // Tile2D_InnermostSingleElement
+  RunTest<T>({11, 21}, {2, 1}, {1, 7}, {2}, {11, 11, 11, 11, 11, 11, 11, 21, 21, 21, 21, 21, 21, 21}, {2, 7});
+
+  // Tile2D_OddRepeats
+  RunTest<T>({11, 12, 13}, {1, 3}, {5, 1}, {2}, {11, 12, 13, 11, 12, 13, 11, 12, 13, 11, 12, 13, 11, 12, 13}, {5, 3});
 }
 
 template <>
@@ -419,6 +419,60 @@ TEST(TransposeOpTest, SingleAxisMovingInwardsBlockCopy) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false);
 }
 
+// Transpose with an expected output computed an element at a time, for shapes that aren't multiples of the tile
+// sizes of the MLAS kernels.
+template <typename T>
+static void TransposeReferenceTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> output_shape(rank);
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank; i-- > 1;) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+  for (size_t i = 0; i < rank; ++i) {
+    output_shape[i] = input_shape[perm[i]];
+  }
+
+  const int64_t size = rank > 0 ? input_strides[0] * input_shape[0] : 1;
+  std::vector<T> input_vals(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 101);
+  }
+
+  std::vector<T> expected_vals(size);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t remainder = i;
+    int64_t input_offset = 0;
+    for (size_t j = rank; j-- > 0;) {
+      input_offset += (remainder % output_shape[j]) * input_strides[perm[j]];
+      remainder /= output_shape[j];
+    }
+    expected_vals[i] = input_vals[input_offset];
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", output_shape, expected_vals);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+template <typename T>
+static void TransposeReferenceTests() {
+  TransposeReferenceTest<T>({3, 17, 19}, {2, 1, 0});
+  TransposeReferenceTest<T>({2, 33, 1, 65}, {3, 1, 0, 2});
+  TransposeReferenceTest<T>({2, 3, 5, 7, 9}, {4, 2, 0, 3, 1});
+  TransposeReferenceTest<T>({2, 9, 11, 3}, {1, 0, 3, 2});
+  TransposeReferenceTest<T>({3, 130, 75}, {0, 2, 1});
+}
+
+TEST(TransposeOpTest, ArbitraryPermutations) {
+  TransposeReferenceTests<uint8_t>();
+  TransposeReferenceTests<int16_t>();
+  TransposeReferenceTests<float>();
+  TransposeReferenceTests<double>();
+}
+
 #ifdef USE_CUDA
 static void TestTranspose(
     const std::vector<int64_t>& perm,
@@ -109,6 +109,32 @@ TEST(WhereOpTest, Broadcast) {
   WhereBroadcastTest<std::string>("true", "false");
 }
 
+TEST(WhereOpTest, BroadcastLarge) {
+  // large enough for the selections and the merge to be split across threads
+  const int64_t rows = 500;
+  const int64_t cols = 40;
+  // std::vector<bool> has no data() to add it as an input
+  std::unique_ptr<bool[]> condition(new bool[rows]);
+  std::vector<float> X(cols), Y(rows * cols), result(rows * cols);
+  for (int64_t i = 0; i < rows; ++i) {
+    condition[i] = i % 3 != 0;
+  }
+  for (int64_t j = 0; j < cols; ++j) {
+    X[j] = static_cast<float>(j);
+  }
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    Y[i] = -static_cast<float>(i);
+    result[i] = condition[i / cols] ? X[i % cols] : Y[i];
+  }
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<bool>("condition", {rows, 1}, condition.get(), rows);
+  test.AddInput<float>("X", {1, cols}, X);
+  test.AddInput<float>("Y", {rows, cols}, Y);
+  test.AddOutput<float>("output", {rows, cols}, result);
+  test.Run();
+}
+
 TEST(WhereOpTest, BroadcastDimWithZero) {
   // test where broadcast is possible, and dim of 0 should be selected
   OpTester test{kOpName, kOpVersion};
@@ -511,14 +511,16 @@ class TestInferenceSession(unittest.TestCase):
         sess.run([], {'X': x})
         profile_file = sess.end_profiling()
 
-        tags = ['pid', 'dur', 'ts', 'ph', 'X', 'name', 'args']
+        # the events of the node are followed by a counter event with the memory use of the CPU arena
+        tags = ['pid', 'dur', 'ts', 'ph', 'name', 'args']
         with open(profile_file) as f:
             lines = f.readlines()
             self.assertTrue('[' in lines[0])
-            for i in range(1, 8):
+            for i in range(1, 9):
                 for tag in tags:
                     self.assertTrue(tag in lines[i])
-            self.assertTrue(']' in lines[8])
+                self.assertTrue('"ph" : "X"' in lines[i] or '"ph" : "C"' in lines[i])
+            self.assertTrue(']' in lines[9])
 
     def testProfilerGetStartTimeNs(self):
         def getSingleSessionProfilingStartTime():
@@ -789,6 +791,64 @@ class TestInferenceSession(unittest.TestCase):
             # The constructed OrtValue should still be valid after being used in a session
             self.assertTrue(np.array_equal(ortvalue2.numpy(), numpy_arr_input))
 
+    def testRunWithOutputArrays(self):
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        y = np.zeros((3, 2), dtype=np.float32)
+        res = sess.run(["Y"], {"X": x}, output_arrays=[y])
+        self.assertIs(res[0], y)
+        np.testing.assert_allclose(y, expected)
+
+        y_ortvalue = onnxrt.OrtValue.ortvalue_from_shape_and_type([3, 2], np.float32)
+        sess.run(["Y"], {"X": x}, output_arrays=[y_ortvalue])
+        np.testing.assert_allclose(y_ortvalue.numpy(), expected)
+
+        # None allocates the output
+        res = sess.run(["Y"], {"X": x}, output_arrays=[None])
+        np.testing.assert_allclose(res[0], expected)
+
+        with self.assertRaises(RuntimeError):
+            sess.run(["Y"], {"X": x}, output_arrays=[np.zeros((3, 2), dtype=np.float64)])
+        with self.assertRaises(RuntimeError):
+            sess.run(["Y"], {"X": x}, output_arrays=[np.zeros((2, 3), dtype=np.float32).T])
+
+    def testRunMany(self):
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        feeds = [{"X": np.full((3, 2), i, dtype=np.float32)} for i in range(8)]
+        res = sess.run_many(["Y"], feeds)
+        self.assertEqual(len(res), len(feeds))
+        for i, outputs in enumerate(res):
+            np.testing.assert_allclose(outputs[0], np.full((3, 2), i * i, dtype=np.float32))
+
+        with self.assertRaises(ValueError):
+            sess.run_many(["Y"], [{}])
+
+    def testOrtValueDlpack(self):
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        ortvalue = onnxrt.OrtValue.ortvalue_from_numpy(x)
+        self.assertEqual(ortvalue.__dlpack_device__(), (1, 0))
+
+        # the imported OrtValue shares the memory of the exported one
+        imported = onnxrt.OrtValue.from_dlpack(ortvalue.to_dlpack())
+        self.assertEqual(imported.data_ptr(), ortvalue.data_ptr())
+        self.assertEqual(imported.shape(), [3, 2])
+        self.assertEqual(imported.data_type(), "tensor(float)")
+        del ortvalue
+        np.testing.assert_allclose(imported.numpy(), x)
+
+        # a capsule can only be consumed once
+        capsule = imported.to_dlpack()
+        onnxrt.OrtValue.from_dlpack(capsule)
+        with self.assertRaises(RuntimeError):
+            onnxrt.OrtValue.from_dlpack(capsule)
+
+        # DLPack tensors are accepted as inputs
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        res = sess.run(["Y"], {"X": imported.to_dlpack()})
+        np.testing.assert_allclose(res[0], x * x)
+
     def testRunModelWithCudaCopyStream(self):
         available_providers = onnxrt.get_available_providers()
 
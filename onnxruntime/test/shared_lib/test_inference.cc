@@ -12,6 +12,7 @@
 #include <fstream>
 #include <sstream>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
@@ -998,3 +999,71 @@ TEST(CApiTest, TestSharingOfInitializer) {
                     expected_values_y,
                     nullptr);
 }
+
+namespace {
+struct RunAsyncResult {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  OrtErrorCode error_code = ORT_OK;
+  std::vector<float> values;
+};
+
+void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+  auto* result = static_cast<RunAsyncResult*>(user_data);
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (status != nullptr) {
+    result->error_code = Ort::GetApi().GetErrorCode(status);
+    Ort::GetApi().ReleaseStatus(status);
+  } else if (num_outputs == 1) {
+    Ort::Unowned<Ort::Value> output{outputs[0]};
+    auto count = output.GetTensorTypeAndShapeInfo().GetElementCount();
+    const auto* data = output.GetTensorMutableData<float>();
+    result->values.assign(data, data + count);
+  }
+  result->done = true;
+  result->cv.notify_one();
+}
+}  // namespace
+
+TEST(CApiTest, run_async) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::Value y{nullptr};
+  RunAsyncResult result;
+
+  Ort::RunOptions run_options;
+  session.RunAsync(run_options, input_names, &x, 1, output_names, &y, 1, RunAsyncCallback, &result);
+
+  {
+    std::unique_lock<std::mutex> lock(result.mutex);
+    result.cv.wait(lock, [&result]() { return result.done; });
+  }
+
+  ASSERT_EQ(result.error_code, ORT_OK);
+  ASSERT_NE(static_cast<OrtValue*>(y), nullptr);
+  ASSERT_EQ(result.values, (std::vector<float>{1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+
+  // errors of the Run are reported to the callback
+  const char* invalid_output_names[] = {"Z"};
+  Ort::Value z{nullptr};
+  RunAsyncResult invalid_result;
+  session.RunAsync(run_options, input_names, &x, 1, invalid_output_names, &z, 1, RunAsyncCallback, &invalid_result);
+
+  {
+    std::unique_lock<std::mutex> lock(invalid_result.mutex);
+    invalid_result.cv.wait(lock, [&invalid_result]() { return invalid_result.done; });
+  }
+
+  ASSERT_EQ(invalid_result.error_code, ORT_INVALID_ARGUMENT);
+  ASSERT_EQ(static_cast<OrtValue*>(z), nullptr);
+}
@@ -5,6 +5,8 @@
 
 #include <algorithm>
 #include <fstream>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -29,6 +31,7 @@ namespace {
 constexpr const PathChar* k_tensors_file_name = ORT_TSTR("tensors.pbseq");
 constexpr const PathChar* k_tensors_data_file_name = ORT_TSTR("tensors.bin");
 constexpr const PathChar* k_properties_file_name = ORT_TSTR("properties.pbseq");
+constexpr const PathChar* k_manifest_file_name = ORT_TSTR("manifest.pbseq");
 
 PathString GetCheckpointTensorsFilePath(const PathString& checkpoint_directory) {
   return ConcatPathComponent<PathChar>(checkpoint_directory, k_tensors_file_name);
@@ -42,6 +45,18 @@ PathString GetCheckpointPropertiesFilePath(const PathString& checkpoint_director
   return ConcatPathComponent<PathChar>(checkpoint_directory, k_properties_file_name);
 }
 
+PathString GetCheckpointManifestFilePath(const PathString& checkpoint_directory) {
+  return ConcatPathComponent<PathChar>(checkpoint_directory, k_manifest_file_name);
+}
+
+PathString GetShardTensorsFileName(int shard_index) {
+  return ORT_TSTR("tensors.") + ToPathString(std::to_string(shard_index)) + ORT_TSTR(".pbseq");
+}
+
+PathString GetShardTensorsDataFileName(int shard_index) {
+  return ORT_TSTR("tensors.") + ToPathString(std::to_string(shard_index)) + ORT_TSTR(".bin");
+}
+
 Status SaveRuntimeTensor(
     const std::string& tensor_name,
     const Tensor& tensor,
@@ -146,13 +161,20 @@ Status SaveRuntimeTensors(
     ORT_RETURN_IF_NOT(ort_value.IsTensor());
     const Tensor& tensor = ort_value.Get<Tensor>();
 
-    tensor_data_buffer.resize(tensor.SizeInBytes());
-    ORT_RETURN_IF_ERROR(CopyTensorDataToByteSpan(
-        data_transfer_manager, tensor, cpu_alloc_info, gsl::make_span(tensor_data_buffer)));
+    // host tensors, e.g., the copies of an asynchronous save, are written without another copy
+    gsl::span<const char> tensor_data{};
+    if (tensor.Location().device.Type() == OrtDevice::CPU) {
+      tensor_data = gsl::make_span(static_cast<const char*>(tensor.DataRaw()), tensor.SizeInBytes());
+    } else {
+      tensor_data_buffer.resize(tensor.SizeInBytes());
+      ORT_RETURN_IF_ERROR(CopyTensorDataToByteSpan(
+          data_transfer_manager, tensor, cpu_alloc_info, gsl::make_span(tensor_data_buffer)));
+      tensor_data = gsl::make_span(tensor_data_buffer);
+    }
 
     saved_tensor_protos.emplace_back();
     ORT_RETURN_IF_ERROR(SaveRuntimeTensor(
-        tensor_name, tensor, tensor_data_buffer, tensors_data_relative_path,
+        tensor_name, tensor, tensor_data, tensors_data_relative_path,
         tensors_data_file, saved_tensor_protos.back()));
   }
 
@@ -200,6 +222,27 @@ Status SaveProperties(
   return Status::OK();
 }
 
+Status SaveManifest(const PathString& manifest_path, int num_shards) {
+  std::vector<ONNX_NAMESPACE::StringStringEntryProto> shard_protos{};
+  shard_protos.reserve(num_shards);
+  for (int shard_index = 0; shard_index < num_shards; ++shard_index) {
+    ONNX_NAMESPACE::StringStringEntryProto shard_proto{};
+    shard_proto.set_key(ToMBString(GetShardTensorsFileName(shard_index)));
+    shard_proto.set_value(ToMBString(GetShardTensorsDataFileName(shard_index)));
+    shard_protos.emplace_back(std::move(shard_proto));
+  }
+
+  ORT_RETURN_IF_ERROR(WithOpenFile(
+      manifest_path, false,
+      [&shard_protos](int fd) {
+        google::protobuf::io::FileOutputStream output{fd};
+        ORT_RETURN_IF_ERROR(WriteProtoMessageSequence(shard_protos, output));
+        return Status::OK();
+      }));
+
+  return Status::OK();
+}
+
 }  // namespace
 
 Status SaveModelCheckpoint(
@@ -229,6 +272,125 @@ Status SaveModelCheckpoint(
   return Status::OK();
 }
 
+Status SaveModelCheckpoint(
+    const PathString& checkpoint_path,
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const std::unordered_map<std::string, std::string>& properties,
+    const CheckpointShard& shard) {
+  ORT_RETURN_IF_NOT(
+      shard.count > 0 && shard.index >= 0 && shard.index < shard.count,
+      "Invalid checkpoint shard ", shard.index, " of ", shard.count);
+
+  LOGS_DEFAULT(INFO) << "Saving model checkpoint shard " << shard.index << " of " << shard.count
+                     << " to " << ToMBString(checkpoint_path);
+
+  LOGS_DEFAULT_IF(shard.index == 0 && Env::Default().FolderExists(checkpoint_path), WARNING)
+      << "Checkpoint directory exists - data may be overwritten.";
+
+  // the other shards may be creating the directory too
+  const Status create_folder_status = Env::Default().CreateFolder(checkpoint_path);
+  ORT_RETURN_IF_NOT(
+      create_folder_status.IsOK() || Env::Default().FolderExists(checkpoint_path),
+      create_folder_status.ErrorMessage());
+
+  // write tensors files
+  ORT_RETURN_IF_ERROR(SaveRuntimeTensors(
+      ConcatPathComponent<PathChar>(checkpoint_path, GetShardTensorsFileName(shard.index)),
+      ConcatPathComponent<PathChar>(checkpoint_path, GetShardTensorsDataFileName(shard.index)),
+      data_transfer_manager, runtime_tensors));
+
+  if (shard.index == 0) {
+    // write manifest and properties files
+    ORT_RETURN_IF_ERROR(SaveManifest(
+        GetCheckpointManifestFilePath(checkpoint_path), shard.count));
+    ORT_RETURN_IF_ERROR(SaveProperties(
+        GetCheckpointPropertiesFilePath(checkpoint_path), properties));
+  }
+
+  LOGS_DEFAULT(INFO) << "Model checkpoint shard " << shard.index << " saved successfully.";
+
+  return Status::OK();
+}
+
+Status CopyCheckpointTensorsToHost(
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const AllocatorPtr& host_allocator,
+    NameMLValMap& host_tensors) {
+  ORT_RETURN_IF_NOT(host_allocator, "A host allocator is required.");
+
+  NameMLValMap copied_tensors{};
+  for (const auto& name_and_ort_value : runtime_tensors) {
+    const OrtValue& ort_value = name_and_ort_value.second;
+    ORT_RETURN_IF_NOT(ort_value.IsTensor());
+    const Tensor& tensor = ort_value.Get<Tensor>();
+
+    auto host_tensor = onnxruntime::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), host_allocator);
+    ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(tensor, *host_tensor));
+
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    OrtValue host_ort_value{host_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc()};
+    copied_tensors.emplace(name_and_ort_value.first, std::move(host_ort_value));
+  }
+
+  host_tensors = std::move(copied_tensors);
+  return Status::OK();
+}
+
+AsyncCheckpointSaver::AsyncCheckpointSaver(AllocatorPtr host_allocator)
+    : host_allocator_{std::move(host_allocator)} {
+}
+
+AsyncCheckpointSaver::~AsyncCheckpointSaver() {
+  const Status status = Wait();
+  LOGS_DEFAULT_IF(!status.IsOK(), ERROR)
+      << "Failed to save model checkpoint: " << status.ErrorMessage();
+}
+
+Status AsyncCheckpointSaver::Save(
+    const PathString& checkpoint_path,
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const std::unordered_map<std::string, std::string>& properties,
+    const CheckpointShard* shard) {
+  ORT_RETURN_IF_ERROR(Wait());
+
+  // the copies are made before returning, the training steps may update the tensors afterwards
+  NameMLValMap host_tensors{};
+  ORT_RETURN_IF_ERROR(CopyCheckpointTensorsToHost(
+      data_transfer_manager, runtime_tensors, host_allocator_, host_tensors));
+
+  const bool is_sharded = shard != nullptr;
+  const CheckpointShard saved_shard = is_sharded ? *shard : CheckpointShard{};
+  pending_save_ = std::async(
+      std::launch::async,
+      [checkpoint_path, &data_transfer_manager, host_tensors = std::move(host_tensors), properties,
+       is_sharded, saved_shard]() {
+        return is_sharded
+                   ? SaveModelCheckpoint(
+                         checkpoint_path, data_transfer_manager, host_tensors, properties, saved_shard)
+                   : SaveModelCheckpoint(
+                         checkpoint_path, data_transfer_manager, host_tensors, properties);
+      });
+
+  return Status::OK();
+}
+
+Status AsyncCheckpointSaver::Wait() {
+  if (!pending_save_.valid()) {
+    return Status::OK();
+  }
+
+  Status status{};
+  try {
+    status = pending_save_.get();
+  } catch (std::exception& e) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, e.what());
+  }
+  return status;
+}
+
 namespace {
 Status UpdateTensorsExternalDataLocations(
     const PathString& external_data_path,
@@ -252,17 +414,16 @@ Status UpdateTensorsExternalDataLocations(
 }
 }  // namespace
 
-Status LoadModelCheckpoint(
-    const PathString& checkpoint_path,
-    const PathString& model_path,
-    std::vector<ONNX_NAMESPACE::TensorProto>& tensor_protos,
-    std::unordered_map<std::string, std::string>& properties) {
-  LOGS_DEFAULT(INFO) << "Loading model checkpoint files from " << ToMBString(checkpoint_path);
-
+namespace {
+Status LoadCheckpointTensors(
+    const PathString& tensors_path,
+    const PathString& tensors_data_path,
+    const PathString& model_directory_canonical_path,
+    std::vector<ONNX_NAMESPACE::TensorProto>& tensor_protos) {
   // read tensors file
   std::vector<ONNX_NAMESPACE::TensorProto> loaded_tensor_protos{};
   ORT_RETURN_IF_ERROR(WithOpenFile(
-      GetCheckpointTensorsFilePath(checkpoint_path), true,
+      tensors_path, true,
       [&loaded_tensor_protos](int fd) {
         google::protobuf::io::FileInputStream input{fd};
         ORT_RETURN_IF_ERROR(ReadProtoMessageSequence(loaded_tensor_protos, input));
@@ -270,24 +431,104 @@ Status LoadModelCheckpoint(
       }));
 
   // set external data locations
+  PathString tensors_data_canonical_path{};
+  ORT_RETURN_IF_ERROR(Env::Default().GetCanonicalPath(
+      tensors_data_path, tensors_data_canonical_path));
+
+  Path relative_tensors_data_path_obj{};
+  ORT_RETURN_IF_ERROR(RelativePath(
+      Path::Parse(model_directory_canonical_path),
+      Path::Parse(tensors_data_canonical_path),
+      relative_tensors_data_path_obj));
+  ORT_RETURN_IF_ERROR(UpdateTensorsExternalDataLocations(
+      relative_tensors_data_path_obj.ToPathString(), loaded_tensor_protos));
+
+  tensor_protos = std::move(loaded_tensor_protos);
+  return Status::OK();
+}
+
+// gets the tensors and data files of the shards, or of the whole checkpoint if it isn't sharded
+Status GetCheckpointTensorsFilePaths(
+    const PathString& checkpoint_path,
+    std::vector<std::pair<PathString, PathString>>& tensors_file_paths) {
+  const PathString manifest_path = GetCheckpointManifestFilePath(checkpoint_path);
+  if (!std::ifstream{manifest_path}.good()) {
+    tensors_file_paths = {{GetCheckpointTensorsFilePath(checkpoint_path),
+                           GetCheckpointTensorsDataFilePath(checkpoint_path)}};
+    return Status::OK();
+  }
+
+  std::vector<ONNX_NAMESPACE::StringStringEntryProto> shard_protos{};
+  ORT_RETURN_IF_ERROR(WithOpenFile(
+      manifest_path, true,
+      [&shard_protos](int fd) {
+        google::protobuf::io::FileInputStream input{fd};
+        ORT_RETURN_IF_ERROR(ReadProtoMessageSequence(shard_protos, input));
+        return Status::OK();
+      }));
+  ORT_RETURN_IF(shard_protos.empty(), "Checkpoint manifest has no shards: ", ToMBString(manifest_path));
+
+  tensors_file_paths.clear();
+  for (const auto& shard_proto : shard_protos) {
+    tensors_file_paths.emplace_back(
+        ConcatPathComponent<PathChar>(checkpoint_path, ToPathString(shard_proto.key())),
+        ConcatPathComponent<PathChar>(checkpoint_path, ToPathString(shard_proto.value())));
+  }
+
+  return Status::OK();
+}
+}  // namespace
+
+Status LoadModelCheckpoint(
+    const PathString& checkpoint_path,
+    const PathString& model_path,
+    std::vector<ONNX_NAMESPACE::TensorProto>& tensor_protos,
+    std::unordered_map<std::string, std::string>& properties) {
+  LOGS_DEFAULT(INFO) << "Loading model checkpoint files from " << ToMBString(checkpoint_path);
+
+  PathString model_directory_path{}, model_directory_canonical_path{};
+  ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(
+      model_path, model_directory_path));
+  ORT_RETURN_IF_ERROR(Env::Default().GetCanonicalPath(
+      model_directory_path, model_directory_canonical_path));
+
+  std::vector<std::pair<PathString, PathString>> tensors_file_paths{};
+  ORT_RETURN_IF_ERROR(GetCheckpointTensorsFilePaths(checkpoint_path, tensors_file_paths));
+
+  // read the tensors files of the shards concurrently
+  const size_t num_shards = tensors_file_paths.size();
+  std::vector<std::vector<ONNX_NAMESPACE::TensorProto>> shard_tensor_protos(num_shards);
+  std::vector<Status> shard_statuses(num_shards);
   {
-    PathString model_directory_path{}, model_directory_canonical_path{};
-    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(
-        model_path, model_directory_path));
-    ORT_RETURN_IF_ERROR(Env::Default().GetCanonicalPath(
-        model_directory_path, model_directory_canonical_path));
-
-    PathString checkpoint_canonical_path{};
-    ORT_RETURN_IF_ERROR(Env::Default().GetCanonicalPath(
-        checkpoint_path, checkpoint_canonical_path));
-
-    Path relative_tensors_data_path_obj{};
-    ORT_RETURN_IF_ERROR(RelativePath(
-        Path::Parse(model_directory_canonical_path),
-        Path::Parse(GetCheckpointTensorsDataFilePath(checkpoint_canonical_path)),
-        relative_tensors_data_path_obj));
-    ORT_RETURN_IF_ERROR(UpdateTensorsExternalDataLocations(
-        relative_tensors_data_path_obj.ToPathString(), loaded_tensor_protos));
+    auto load_shard = [&](size_t shard_index) {
+      try {
+        shard_statuses[shard_index] = LoadCheckpointTensors(
+            tensors_file_paths[shard_index].first, tensors_file_paths[shard_index].second,
+            model_directory_canonical_path, shard_tensor_protos[shard_index]);
+      } catch (std::exception& e) {
+        shard_statuses[shard_index] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, e.what());
+      }
+    };
+
+    std::vector<std::thread> shard_threads{};
+    for (size_t shard_index = 1; shard_index < num_shards; ++shard_index) {
+      shard_threads.emplace_back(load_shard, shard_index);
+    }
+    load_shard(0);
+    for (auto& shard_thread : shard_threads) {
+      shard_thread.join();
+    }
+  }
+
+  std::vector<ONNX_NAMESPACE::TensorProto> loaded_tensor_protos{};
+  std::unordered_set<std::string> loaded_tensor_names{};
+  for (size_t shard_index = 0; shard_index < num_shards; ++shard_index) {
+    ORT_RETURN_IF_ERROR(shard_statuses[shard_index]);
+    for (auto& tensor_proto : shard_tensor_protos[shard_index]) {
+      if (loaded_tensor_names.insert(tensor_proto.name()).second) {
+        loaded_tensor_protos.emplace_back(std::move(tensor_proto));
+      }
+    }
   }
 
   // read properties file
@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <future>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "core/common/common.h"
 #include "core/common/path_string.h"
 #include "core/common/status.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/data_types.h"
 #include "core/framework/framework_common.h"
@@ -22,7 +25,23 @@ namespace training {
  *   tensors.pbseq - tensor protobuf messages
  *   tensors.bin - tensor binary data
  *   properties.pbseq - property protobuf messages
+ *
+ * A sharded checkpoint is a directory of files:
+ * checkpoint/
+ *   manifest.pbseq - shard protobuf messages, mapping each tensors file to its data file
+ *   tensors.<i>.pbseq - tensor protobuf messages of shard i
+ *   tensors.<i>.bin - tensor binary data of shard i
+ *   properties.pbseq - property protobuf messages
+ */
+
+/**
+ * The part of a sharded checkpoint written by one process.
+ * Shard 0 also writes the manifest and the properties.
  */
+struct CheckpointShard {
+  int index = 0;
+  int count = 1;
+};
 
 /**
  * Saves a model checkpoint in the specified location.
@@ -40,7 +59,92 @@ common::Status SaveModelCheckpoint(
     const std::unordered_map<std::string, std::string>& properties);
 
 /**
- * Loads a model checkpoint from the specified location.
+ * Saves a shard of a sharded model checkpoint in the specified location.
+ * The shards can be saved concurrently, e.g., one by each rank.
+ *
+ * @param checkpoint_path The checkpoint location.
+ * @param data_transfer_manager The DataTransferManager instance.
+ * @param runtime_tensors The tensors of the shard to persist.
+ * @param properties The properties to persist, only used by shard 0.
+ * @param shard The shard to save.
+ * @return The status of the operation.
+ */
+common::Status SaveModelCheckpoint(
+    const PathString& checkpoint_path,
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const std::unordered_map<std::string, std::string>& properties,
+    const CheckpointShard& shard);
+
+/**
+ * Copies tensors to host memory, so that they can be persisted while the
+ * original tensors are updated.
+ *
+ * @param data_transfer_manager The DataTransferManager instance.
+ * @param runtime_tensors The tensors to copy.
+ * @param host_allocator The allocator of the copies, e.g., a pinned memory allocator.
+ * @param[out] host_tensors The copies.
+ * @return The status of the operation.
+ */
+common::Status CopyCheckpointTensorsToHost(
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const AllocatorPtr& host_allocator,
+    NameMLValMap& host_tensors);
+
+/**
+ * Saves model checkpoints in the background.
+ *
+ * A save copies the tensors to host memory before returning, then writes
+ * the checkpoint files on another thread. Only one save is in progress at a
+ * time: a save waits for the previous one to finish.
+ */
+class AsyncCheckpointSaver {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param host_allocator The allocator of the host copies of the tensors.
+   */
+  explicit AsyncCheckpointSaver(AllocatorPtr host_allocator);
+
+  /**
+   * Destructor. Waits for the save in progress, if any.
+   */
+  ~AsyncCheckpointSaver();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AsyncCheckpointSaver);
+
+  /**
+   * Starts saving a model checkpoint, or a shard of a sharded one.
+   *
+   * @param checkpoint_path The checkpoint location.
+   * @param data_transfer_manager The DataTransferManager instance, which must
+   *        outlive the save.
+   * @param runtime_tensors The tensors to persist.
+   * @param properties The properties to persist.
+   * @param shard The shard to save, if the checkpoint is sharded.
+   * @return The status of the previous save and of the copy of the tensors.
+   */
+  common::Status Save(
+      const PathString& checkpoint_path,
+      const DataTransferManager& data_transfer_manager,
+      const NameMLValMap& runtime_tensors,
+      const std::unordered_map<std::string, std::string>& properties,
+      const CheckpointShard* shard = nullptr);
+
+  /**
+   * Waits for the save in progress, if any.
+   *
+   * @return The status of the save.
+   */
+  common::Status Wait();
+
+ private:
+  const AllocatorPtr host_allocator_;
+  std::future<common::Status> pending_save_;
+};
+ a model checkpoint from the specified location.
  *
  * @param checkpoint_path The checkpoint location.
  * @param model_path The model location.
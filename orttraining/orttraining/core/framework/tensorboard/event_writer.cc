@@ -5,9 +5,11 @@
 #include "orttraining/core/framework/tensorboard/crc32c.h"
 #include "core/platform/env.h"
 
+#include <chrono>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 
 #if defined(__GNUC__)
@@ -46,13 +48,74 @@ static void Encode(char* buffer, T value) {
   memcpy(buffer, &value, sizeof(value));
 }
 
-EventWriter::EventWriter(const std::basic_string<PATH_CHAR_TYPE>& log_dir) : stream_(GenerateFilePath(log_dir), std::ios::binary) {
+// The maximum number of pending records. Adding an event blocks while the ring is full.
+static constexpr size_t kMaxPendingRecords = 1024;
+// The writer thread waits for new records at most this long, as the caller notifies it without taking the lock.
+static constexpr std::chrono::milliseconds kIdleWait{100};
+
+EventWriter::EventWriter(const std::basic_string<PATH_CHAR_TYPE>& log_dir)
+    : EventWriter(std::ofstream(GenerateFilePath(log_dir), std::ios::binary)) {
 }
 
-EventWriter::EventWriter(std::ofstream&& stream) : stream_(std::move(stream)) {
+EventWriter::EventWriter(std::ofstream&& stream) : stream_(std::move(stream)), records_(kMaxPendingRecords) {
+  writer_thread_ = std::thread(&EventWriter::WriterLoop, this);
 }
 
 EventWriter::~EventWriter() {
+  stop_.store(true, std::memory_order_release);
+  idle_cv_.notify_one();
+  writer_thread_.join();
+}
+
+void EventWriter::Enqueue(RecordFn&& record) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  while (tail - head_.load(std::memory_order_acquire) == records_.size()) {
+    std::this_thread::yield();
+  }
+
+  records_[tail % records_.size()] = std::move(record);
+  tail_.store(tail + 1, std::memory_order_release);
+  idle_cv_.notify_one();
+}
+
+void EventWriter::WriterLoop() {
+  for (;;) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      // Check the ring again after seeing stop_, so the records added before the destructor are written.
+      if (stop_.load(std::memory_order_acquire)) {
+        if (head == tail_.load(std::memory_order_acquire)) {
+          break;
+        }
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(idle_mutex_);
+      idle_cv_.wait_for(lock, kIdleWait, [this, head]() {
+        return head != tail_.load(std::memory_order_acquire) || stop_.load(std::memory_order_acquire);
+      });
+      continue;
+    }
+
+    RecordFn record = std::move(records_[head % records_.size()]);
+    records_[head % records_.size()] = nullptr;
+    WriteRecord(record());
+
+    // The file is flushed once the ring is drained, before Flush() can see it empty.
+    if (head + 1 == tail_.load(std::memory_order_acquire)) {
+      stream_.flush();
+    }
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  stream_.flush();
+}
+
+void EventWriter::Flush() {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  while (head_.load(std::memory_order_acquire) != tail) {
+    std::this_thread::yield();
+  }
 }
 
 void EventWriter::WriteRecord(const std::string& data) {
@@ -66,11 +129,11 @@ void EventWriter::WriteRecord(const std::string& data) {
   stream_.write(header, sizeof(header));
   stream_.write(data.data(), data.size());
   stream_.write(footer, sizeof(footer));
-  stream_.flush();
 }
 
 void EventWriter::AddEvent(const ::tensorboard::Event& event) {
-  WriteRecord(event.SerializeAsString());
+  auto event_copy = std::make_shared<::tensorboard::Event>(event);
+  Enqueue([event_copy]() { return event_copy->SerializeAsString(); });
 }
 
 void EventWriter::AddHistogram(const std::string& tag, const ::tensorboard::HistogramProto& histogram, int64_t step) {
@@ -91,40 +154,40 @@ void EventWriter::AddScalar(const std::string& tag, float value, int64_t step) {
   AddSummary(summary, step);
 }
 
-void EventWriter::AddSummary(const ::tensorboard::Summary& summary, int64_t step, const std::string& tag_prefix) {
-  ::tensorboard::Event event;
-  event.set_step(step);
-  event.set_wall_time(static_cast<double>(std::time(0)));
-
-  ::tensorboard::Summary* event_summary = event.mutable_summary();
-  event_summary->CopyFrom(summary);
-
+static void AddTagPrefix(::tensorboard::Summary& summary, const std::string& tag_prefix) {
   if (!tag_prefix.empty()) {
-    for (int i = 0; i < event_summary->value_size(); ++i) {
-      ::tensorboard::Summary::Value* summary_value = event_summary->mutable_value(i);
+    for (int i = 0; i < summary.value_size(); ++i) {
+      ::tensorboard::Summary::Value* summary_value = summary.mutable_value(i);
       summary_value->set_tag(tag_prefix + "/" + summary_value->tag());
     }
   }
+}
 
-  AddEvent(event);
+void EventWriter::AddSummary(const ::tensorboard::Summary& summary, int64_t step, const std::string& tag_prefix) {
+  auto event = std::make_shared<::tensorboard::Event>();
+  event->set_step(step);
+  event->set_wall_time(static_cast<double>(std::time(0)));
+  event->mutable_summary()->CopyFrom(summary);
+
+  Enqueue([event, tag_prefix]() {
+    AddTagPrefix(*event->mutable_summary(), tag_prefix);
+    return event->SerializeAsString();
+  });
 }
 
 void EventWriter::AddSummary(const std::string& summary, int64_t step, const std::string& tag_prefix) {
-  ::tensorboard::Event event;
-  event.set_step(step);
-  event.set_wall_time(static_cast<double>(std::time(0)));
-
-  ::tensorboard::Summary* event_summary = event.mutable_summary();
-  event_summary->ParseFromString(summary);
-
-  if (!tag_prefix.empty()) {
-    for (int i = 0; i < event_summary->value_size(); ++i) {
-      ::tensorboard::Summary::Value* summary_value = event_summary->mutable_value(i);
-      summary_value->set_tag(tag_prefix + "/" + summary_value->tag());
-    }
-  }
-
-  AddEvent(event);
+  // The serialized summary is only parsed on the writer thread.
+  const double wall_time = static_cast<double>(std::time(0));
+  Enqueue([summary, step, tag_prefix, wall_time]() {
+    ::tensorboard::Event event;
+    event.set_step(step);
+    event.set_wall_time(wall_time);
+
+    ::tensorboard::Summary* event_summary = event.mutable_summary();
+    event_summary->ParseFromString(summary);
+    AddTagPrefix(*event_summary, tag_prefix);
+    return event.SerializeAsString();
+  });
 }
 
 }  // namespace tensorboard
@@ -3,7 +3,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "core/platform/path_lib.h"
 
 namespace tensorboard {
@@ -16,10 +22,13 @@ namespace onnxruntime {
 namespace training {
 namespace tensorboard {
 
+// Writes Tensorboard events from a background thread, so adding a summary to the log doesn't wait for the
+// serialization and the file I/O. The Add methods must be called from one thread at a time.
 class EventWriter {
  public:
   EventWriter(const std::basic_string<PATH_CHAR_TYPE>& log_dir);
   EventWriter(std::ofstream&& stream);
+  // Writes the pending events before returning.
   ~EventWriter();
 
   void AddEvent(const ::tensorboard::Event& event);
@@ -28,10 +37,28 @@ class EventWriter {
   void AddSummary(const ::tensorboard::Summary& summary, int64_t step = 0, const std::string& tag_prefix = "");
   void AddSummary(const std::string& summary, int64_t step = 0, const std::string& tag_prefix = "");
 
+  // Blocks until the events added so far are written to the file.
+  void Flush();
+
  private:
+  // Returns the serialized event to write. It runs on the writer thread.
+  using RecordFn = std::function<std::string()>;
+
+  void Enqueue(RecordFn&& record);
+  void WriterLoop();
   void WriteRecord(const std::string& data);
 
   std::ofstream stream_;
+
+  // A single producer, single consumer ring of the pending records. Only the caller advances tail_ and only the
+  // writer thread advances head_, so neither takes a lock. The mutex only puts the writer thread to sleep when idle.
+  std::vector<RecordFn> records_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cv_;
+  std::thread writer_thread_;
 };
 
 }  // namespace tensorboard
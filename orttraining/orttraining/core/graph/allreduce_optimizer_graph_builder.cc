@@ -3,6 +3,11 @@
 
 #include "orttraining/core/graph/allreduce_optimizer_graph_builder.h"
 
+#include <numeric>
+
+#include "core/framework/session_options.h"
+#include "core/graph/graph_viewer.h"
+
 namespace onnxruntime {
 namespace training {
 
@@ -90,22 +95,15 @@ Status AllreduceOptimizerGraphBuilder::AddHorovodAllReduceForGradients(std::vect
   return Status::OK();
 }
 
-static Status AddNcclAllReduceForGradients(
+// Adds the View of the gradients in the fused buffer reduced_fused_gradient_argdef, and replaces the gradients with
+// the views.
+static void AddAllReduceOutputView(
     std::vector<ArgDef>& gradient_argdefs,
-    ArgDef& fused_gradient_argdef,
-    GraphAugmenter::GraphDefs& graph_defs,
-    ArgDef& fused_allreduce_output) {
-  fused_allreduce_output = ArgDef(fused_gradient_argdef.name + "AllReduce_Out", fused_gradient_argdef.type_proto);
-
-  // Add NCCL Allreduce node.
-  graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclAllReduce", kMSDomain, 1},
-                                  {fused_gradient_argdef},
-                                  {fused_allreduce_output},
-                                  NodeAttributes(),
-                                  "NcclAllReduce")});
-
+    const ArgDef& reduced_fused_gradient_argdef,
+    const std::string& view_name,
+    GraphAugmenter::GraphDefs& graph_defs) {
   std::vector<ArgDef> view_inputs(gradient_argdefs.size() + 1);
-  view_inputs[0] = fused_allreduce_output;
+  view_inputs[0] = reduced_fused_gradient_argdef;
 
   for (size_t i = 0; i < gradient_argdefs.size(); i++) {
     ArgDef& gradient_shape = view_inputs[i + 1];
@@ -122,7 +120,7 @@ static Status AddNcclAllReduceForGradients(
   for (size_t i = 0; i < gradient_argdefs.size(); i++) {
     TypeProto* allreduced_gradient_type_proto = graph_defs.CopyTypeProto(gradient_argdefs[i]);
     allreduced_gradient_type_proto->mutable_tensor_type()->set_elem_type(
-        fused_gradient_argdef.type_proto->tensor_type().elem_type());
+        reduced_fused_gradient_argdef.type_proto->tensor_type().elem_type());
 
     allreduce_outputs[i] = ArgDef(gradient_argdefs[i].name + "_AllReduce_Out", allreduced_gradient_type_proto);
   }
@@ -131,9 +129,154 @@ static Status AddNcclAllReduceForGradients(
                                   view_inputs,
                                   allreduce_outputs,
                                   NodeAttributes(),
-                                  "AllReduceOutputView")});
+                                  view_name)});
 
   gradient_argdefs = allreduce_outputs;
+}
+
+static Status AddNcclAllReduceForGradients(
+    std::vector<ArgDef>& gradient_argdefs,
+    ArgDef& fused_gradient_argdef,
+    GraphAugmenter::GraphDefs& graph_defs,
+    ArgDef& fused_allreduce_output) {
+  fused_allreduce_output = ArgDef(fused_gradient_argdef.name + "AllReduce_Out", fused_gradient_argdef.type_proto);
+
+  // Add NCCL Allreduce node.
+  graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclAllReduce", kMSDomain, 1},
+                                  {fused_gradient_argdef},
+                                  {fused_allreduce_output},
+                                  NodeAttributes(),
+                                  "NcclAllReduce")});
+
+  AddAllReduceOutputView(gradient_argdefs, fused_allreduce_output, "AllReduceOutputView", graph_defs);
+  return Status::OK();
+}
+
+// Groups the gradients into buckets of at most bucket_size_in_bytes in the order the backward pass produces them,
+// i.e. the topological order of their producers. A gradient larger than the limit, or of unknown size, gets a bucket
+// of its own.
+static std::vector<std::vector<size_t>> GetGradientBuckets(
+    const Graph& graph,
+    const std::vector<std::string>& gradient_names,
+    const std::vector<ArgDef>& weight_argdefs,
+    size_t element_size,
+    size_t bucket_size_in_bytes) {
+  GraphViewer graph_viewer(graph);
+  const auto& node_order = graph_viewer.GetNodesInTopologicalOrder();
+  std::unordered_map<NodeIndex, size_t> node_positions;
+  for (size_t i = 0; i < node_order.size(); ++i) {
+    node_positions[node_order[i]] = i;
+  }
+
+  std::vector<size_t> gradient_positions(gradient_names.size(), 0);
+  for (size_t i = 0; i < gradient_names.size(); ++i) {
+    const Node* producer = graph.GetProducerNode(gradient_names[i]);
+    if (producer != nullptr) {
+      gradient_positions[i] = node_positions[producer->Index()];
+    }
+  }
+
+  std::vector<size_t> production_order(gradient_names.size());
+  std::iota(production_order.begin(), production_order.end(), 0);
+  std::stable_sort(production_order.begin(), production_order.end(), [&gradient_positions](size_t a, size_t b) {
+    return gradient_positions[a] < gradient_positions[b];
+  });
+
+  std::vector<std::vector<size_t>> buckets;
+  size_t current_bucket_size = 0;
+  for (size_t i : production_order) {
+    // the gradient has the shape of its weight
+    size_t gradient_size = bucket_size_in_bytes;
+    const TypeProto* type_proto = weight_argdefs[i].type_proto;
+    if (type_proto != nullptr && type_proto->tensor_type().has_shape()) {
+      size_t num_elements = 1;
+      for (const auto& dim : type_proto->tensor_type().shape().dim()) {
+        if (!dim.has_dim_value()) {
+          num_elements = 0;
+          break;
+        }
+        num_elements *= static_cast<size_t>(dim.dim_value());
+      }
+      if (num_elements > 0) {
+        gradient_size = num_elements * element_size;
+      }
+    }
+
+    if (!buckets.empty() && current_bucket_size + gradient_size <= bucket_size_in_bytes) {
+      buckets.back().push_back(i);
+      current_bucket_size += gradient_size;
+    } else {
+      buckets.push_back({i});
+      current_bucket_size = gradient_size;
+    }
+  }
+
+  return buckets;
+}
+
+// Scales and allreduces each bucket of gradients in a fused buffer. The nodes of a bucket have a high priority, so
+// they run as soon as the backward pass has produced its gradients, and the allreduce runs on a communication stream
+// concurrently with the rest of the backward pass. The compute stream only waits for it in NcclWait, before the
+// reduced gradients are used.
+static Status AddBucketedNcclAllReduceForGradients(
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const std::vector<std::vector<size_t>>& buckets,
+    const float scale,
+    ONNX_NAMESPACE::TensorProto_DataType allreduce_element_type,
+    std::vector<ArgDef>& gradient_argdefs,  // update argdefs in place
+    GraphAugmenter::GraphDefs& graph_defs,
+    std::vector<ArgDef>& reduced_fused_gradient_argdefs) {
+  ArgDef pre_allreduce_scale(nodearg_name_generator("pre_allreduce_scale"),
+                             graph_defs.CreateTypeProto({}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  graph_defs.AddInitializers({CreateTensorProto<float>(pre_allreduce_scale.name, scale, {})});
+
+  reduced_fused_gradient_argdefs.clear();
+  for (size_t b = 0; b < buckets.size(); ++b) {
+    TypeProto* fused_gradient_type_proto = graph_defs.CreateTypeProto();
+    fused_gradient_type_proto->mutable_tensor_type()->set_elem_type(allreduce_element_type);
+    ArgDef fused_gradient_argdef(nodearg_name_generator("fused_gradient_bucket_" + std::to_string(b)),
+                                 fused_gradient_type_proto);
+
+    std::vector<ArgDef> bucket_gradient_argdefs;
+    for (size_t i : buckets[b]) {
+      bucket_gradient_argdefs.push_back(gradient_argdefs[i]);
+    }
+
+    std::vector<ArgDef> scale_inputs{pre_allreduce_scale};
+    scale_inputs.insert(scale_inputs.end(), bucket_gradient_argdefs.begin(), bucket_gradient_argdefs.end());
+    NodeDef scale_node(OpDef{"MixedPrecisionScale", kMSDomain, 1},
+                       scale_inputs,
+                       {fused_gradient_argdef},
+                       std::vector<AttributeProto>({ONNX_NAMESPACE::MakeAttribute("to", static_cast<int64_t>(allreduce_element_type)),
+                                                    ONNX_NAMESPACE::MakeAttribute("fuse_outputs", static_cast<int64_t>(true))}),
+                       fused_gradient_argdef.name);
+    scale_node.priority = static_cast<int>(ExecutionPriority::LOCAL_HIGH);
+
+    ArgDef allreduce_output(fused_gradient_argdef.name + "_AllReduce_Out", fused_gradient_type_proto);
+    NodeDef allreduce_node(OpDef{"NcclAllReduce", kMSDomain, 1},
+                           {fused_gradient_argdef},
+                           {allreduce_output},
+                           std::vector<AttributeProto>({ONNX_NAMESPACE::MakeAttribute("async", static_cast<int64_t>(1))}),
+                           fused_gradient_argdef.name + "_AllReduce");
+    allreduce_node.priority = static_cast<int>(ExecutionPriority::LOCAL_HIGH);
+
+    ArgDef reduced_fused_gradient_argdef(fused_gradient_argdef.name + "_AllReduce_Wait_Out", fused_gradient_type_proto);
+    graph_defs.AddNodeDefs({scale_node,
+                            allreduce_node,
+                            NodeDef(OpDef{"NcclWait", kMSDomain, 1},
+                                    {allreduce_output},
+                                    {reduced_fused_gradient_argdef},
+                                    NodeAttributes(),
+                                    fused_gradient_argdef.name + "_AllReduce_Wait")});
+
+    AddAllReduceOutputView(bucket_gradient_argdefs, reduced_fused_gradient_argdef,
+                           fused_gradient_argdef.name + "_AllReduceOutputView", graph_defs);
+    for (size_t j = 0; j < buckets[b].size(); ++j) {
+      gradient_argdefs[buckets[b][j]] = bucket_gradient_argdefs[j];
+    }
+    reduced_fused_gradient_argdefs.push_back(reduced_fused_gradient_argdef);
+  }
+
   return Status::OK();
 }
 
@@ -177,37 +320,52 @@ Status AllreduceOptimizerGraphBuilder::BuildInternal(
   const bool overlap_compute_allreduce = !opt_graph_config_.use_nccl;
   const int64_t horovod_reduce_op = opt_graph_config_.horovod_reduce_op;
 
-  // add gradient scaling
-  ArgDef fused_gradient_argdef;
   const auto total_num_accumulations =
       opt_graph_config_.gradient_accumulation_steps * opt_graph_config_.data_parallel_group_size;
   ORT_RETURN_IF_NOT(total_num_accumulations > 0);
   const float scale = 1.0f / total_num_accumulations;
-  const bool fuse_scaling_outputs = !overlap_compute_allreduce;
-  ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, gradient_argdefs, fused_gradient_argdef, graph_defs,
-                                              opt_graph_config_.AllReduceDataType(), fuse_scaling_outputs));
 
-  // add Allreduce for gradients
-  ArgDef reduced_fused_gradient_argdef;
-
-  if (opt_graph_config_.use_nccl) {
-    ORT_RETURN_IF_ERROR(AddNcclAllReduceForGradients(gradient_argdefs, fused_gradient_argdef, graph_defs, reduced_fused_gradient_argdef));
+  // inputs of the gradient norm, the reduced fused buffers if any
+  std::vector<ArgDef> gradient_norm_inputs;
+  if (opt_graph_config_.use_nccl && opt_graph_config_.allreduce_bucket_size_in_bytes > 0) {
+    const auto allreduce_element_type = opt_graph_config_.AllReduceDataType();
+    const size_t element_size = allreduce_element_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ? 4 : 2;
+    const auto buckets = GetGradientBuckets(graph, gradient_names_, weight_argdefs, element_size,
+                                            opt_graph_config_.allreduce_bucket_size_in_bytes);
+    ORT_RETURN_IF_ERROR(AddBucketedNcclAllReduceForGradients(nodearg_name_generator, buckets, scale,
+                                                             allreduce_element_type, gradient_argdefs, graph_defs,
+                                                             gradient_norm_inputs));
   } else {
-    ORT_RETURN_IF_ERROR(AddHorovodAllReduceForGradients(gradient_argdefs, graph_defs, horovod_reduce_op));
+    // add gradient scaling
+    ArgDef fused_gradient_argdef;
+    const bool fuse_scaling_outputs = !overlap_compute_allreduce;
+    ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, gradient_argdefs, fused_gradient_argdef, graph_defs,
+                                                opt_graph_config_.AllReduceDataType(), fuse_scaling_outputs));
+
+    // add Allreduce for gradients
+    ArgDef reduced_fused_gradient_argdef;
+
+    if (opt_graph_config_.use_nccl) {
+      ORT_RETURN_IF_ERROR(AddNcclAllReduceForGradients(gradient_argdefs, fused_gradient_argdef, graph_defs, reduced_fused_gradient_argdef));
+    } else {
+      ORT_RETURN_IF_ERROR(AddHorovodAllReduceForGradients(gradient_argdefs, graph_defs, horovod_reduce_op));
+    }
+    gradient_norm_inputs = GetGradientNormInputs(gradient_argdefs, reduced_fused_gradient_argdef);
   }
 
   // check if all gradients are finite
   ArgDef global_grad_norm_argdef;
   ArgDef global_grad_norm_finite_argdef;
   if (opt_graph_config_.use_mixed_precision) {
-    auto gradient_norm_inputs = GetGradientNormInputs(gradient_argdefs, reduced_fused_gradient_argdef);
     ORT_RETURN_IF_ERROR(AddGradientNorm(
         nodearg_name_generator, gradient_norm_inputs, graph_defs, global_grad_norm_argdef));
     optimizer_graph_outputs[OptimizerOutputKey::GlobalGradientNorm] = global_grad_norm_argdef.name;
 
-    ORT_RETURN_IF_ERROR(AddFiniteGradientCheck(
-        nodearg_name_generator, {global_grad_norm_argdef}, graph_defs, global_grad_norm_finite_argdef));
-    optimizer_graph_outputs[OptimizerOutputKey::GradientAllIsFinite] = global_grad_norm_finite_argdef.name;
+    if (!SkipsNonFiniteStepsOnDevice()) {
+      ORT_RETURN_IF_ERROR(AddFiniteGradientCheck(
+          nodearg_name_generator, {global_grad_norm_argdef}, graph_defs, global_grad_norm_finite_argdef));
+      optimizer_graph_outputs[OptimizerOutputKey::GradientAllIsFinite] = global_grad_norm_finite_argdef.name;
+    }
   }
 
   // add weight update
@@ -218,6 +376,15 @@ Status AllreduceOptimizerGraphBuilder::BuildInternal(
       opt_configs_, graph_defs,
       optimizer_state_initializer_names));
 
+  // update the loss scale in the graph
+  if (opt_graph_config_.use_device_loss_scaling) {
+    std::vector<ArgDef> optimizer_output_argdefs(weight_argdefs);
+    optimizer_output_argdefs.insert(optimizer_output_argdefs.end(), gradient_argdefs.begin(), gradient_argdefs.end());
+    ORT_RETURN_IF_ERROR(AddDynamicLossScaleUpdate(
+        nodearg_name_generator, global_grad_norm_argdef, optimizer_output_argdefs,
+        graph_defs, optimizer_state_initializer_names));
+  }
+
   return Status::OK();
 }
 
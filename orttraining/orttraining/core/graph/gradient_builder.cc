@@ -1345,12 +1345,20 @@ IMPLEMENT_GRADIENT_BUILDER(GetBatchNormalizationGradient) {
   }
 }
 
+// The allreduce of the column parallel MatMul's input gradient runs on the communication stream, overlapping with
+// the MatMul's weight gradient, which doesn't depend on it. The high priority launches it as soon as it's ready.
 IMPLEMENT_GRADIENT_BUILDER(GetMegatronFGradient) {
+  NodeDef allreduce_node(OpDef{"NcclAllReduce", kMSDomain, 1},
+                         {GO(0)},
+                         {IA("AllReduce_Out")},
+                         {MakeAttribute("group_type", static_cast<int64_t>(training::WorkerGroupType::HorizontalParallel)),
+                          MakeAttribute("async", static_cast<int64_t>(1))});
+  allreduce_node.priority = static_cast<int>(ExecutionPriority::LOCAL_HIGH);
   return std::vector<NodeDef>{
-      NodeDef(OpDef{"NcclAllReduce", kMSDomain, 1},
-              {GO(0)},
-              {GI(0)},
-              {MakeAttribute("group_type", static_cast<int64_t>(training::WorkerGroupType::HorizontalParallel))})};
+      allreduce_node,
+      NodeDef(OpDef{"NcclWait", kMSDomain, 1},
+              {IA("AllReduce_Out")},
+              {GI(0)})};
 }
 
 IMPLEMENT_GRADIENT_BUILDER(GetMegatronGGradient) {
@@ -1360,6 +1368,49 @@ IMPLEMENT_GRADIENT_BUILDER(GetMegatronGGradient) {
               {GI(0)})};
 }
 
+// The sequence parallel collectives keep their group and axis, so the gradient shards the same dimension.
+static std::vector<AttributeProto> GetSequenceParallelAttributes(const NodeAttributes& attributes) {
+  std::vector<AttributeProto> result;
+  for (const char* name : {"group_type", "axis"}) {
+    auto it = attributes.find(name);
+    if (it != attributes.end()) {
+      result.push_back(it->second);
+    }
+  }
+  return result;
+}
+
+IMPLEMENT_GRADIENT_BUILDER(GetMegatronReduceScatterGradient) {
+  auto attributes = GetSequenceParallelAttributes(SrcNodeAttributes());
+  attributes.push_back(MakeAttribute("reduce_gradient", static_cast<int64_t>(1)));
+  return std::vector<NodeDef>{
+      NodeDef(OpDef{"MegatronAllGather", kMSDomain, 1},
+              {GO(0)},
+              {GI(0)},
+              attributes)};
+}
+
+IMPLEMENT_GRADIENT_BUILDER(GetMegatronAllGatherGradient) {
+  auto attributes = SrcNodeAttributes();
+  auto it = attributes.find("reduce_gradient");
+  const bool reduce_gradient = it != attributes.end() && it->second.i() != 0;
+  return std::vector<NodeDef>{
+      NodeDef(OpDef{reduce_gradient ? "MegatronReduceScatter" : "MegatronSlice", kMSDomain, 1},
+              {GO(0)},
+              {GI(0)},
+              GetSequenceParallelAttributes(attributes))};
+}
+
+IMPLEMENT_GRADIENT_BUILDER(GetMegatronSliceGradient) {
+  auto attributes = GetSequenceParallelAttributes(SrcNodeAttributes());
+  attributes.push_back(MakeAttribute("reduce_gradient", static_cast<int64_t>(0)));
+  return std::vector<NodeDef>{
+      NodeDef(OpDef{"MegatronAllGather", kMSDomain, 1},
+              {GO(0)},
+              {GI(0)},
+              attributes)};
+}
+
 IMPLEMENT_GRADIENT_BUILDER(GetSliceGradient) {
   std::vector<ArgDef> inputs{GO(0), IA("I0_shape")};
   for (int i = 1; i < GetSrcNodeInputSize(); i++) {
@@ -60,6 +60,9 @@ DECLARE_GRADIENT_BUILDER(GetSimplifiedLayerNormalizationGradient)
 DECLARE_GRADIENT_BUILDER(GetBatchNormalizationGradient)
 DECLARE_GRADIENT_BUILDER(GetMegatronFGradient)
 DECLARE_GRADIENT_BUILDER(GetMegatronGGradient)
+DECLARE_GRADIENT_BUILDER(GetMegatronReduceScatterGradient)
+DECLARE_GRADIENT_BUILDER(GetMegatronAllGatherGradient)
+DECLARE_GRADIENT_BUILDER(GetMegatronSliceGradient)
 DECLARE_GRADIENT_BUILDER(GetSliceGradient)
 DECLARE_GRADIENT_BUILDER(GetWhereGradient)
 DECLARE_GRADIENT_BUILDER(GetSendGradient)
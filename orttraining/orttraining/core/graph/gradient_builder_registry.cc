@@ -91,6 +91,9 @@ void GradientBuilderRegistry::RegisterGradientBuilders() {
   REGISTER_GRADIENT_BUILDER("BatchNormalization", GetBatchNormalizationGradient);
   REGISTER_GRADIENT_BUILDER("MegatronF", GetMegatronFGradient);
   REGISTER_GRADIENT_BUILDER("MegatronG", GetMegatronGGradient);
+  REGISTER_GRADIENT_BUILDER("MegatronReduceScatter", GetMegatronReduceScatterGradient);
+  REGISTER_GRADIENT_BUILDER("MegatronAllGather", GetMegatronAllGatherGradient);
+  REGISTER_GRADIENT_BUILDER("MegatronSlice", GetMegatronSliceGradient);
   REGISTER_GRADIENT_BUILDER("Slice", GetSliceGradient);
   REGISTER_GRADIENT_BUILDER("Where", GetWhereGradient);
   REGISTER_GRADIENT_BUILDER("Send", GetSendGradient);
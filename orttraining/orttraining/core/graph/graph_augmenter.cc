@@ -67,13 +67,16 @@ Status GraphAugmenter::AugmentGraph(Graph& graph,
       output_args.push_back(&node_arg);
     }
 
-    graph.AddNode(node_def.name,
-                  node_def.op_type,
-                  "Backward pass",
-                  input_args,
-                  output_args,
-                  &node_def.attributes,
-                  node_def.domain);
+    Node& node = graph.AddNode(node_def.name,
+                               node_def.op_type,
+                               "Backward pass",
+                               input_args,
+                               output_args,
+                               &node_def.attributes,
+                               node_def.domain);
+    if (node_def.priority != 0) {
+      node.SetPriority(node_def.priority);
+    }
   }
 
   // Add new inputs to the graph.
@@ -93,6 +93,8 @@ struct NodeDef {
   std::vector<ArgDef> output_args;
   NodeAttributes attributes;
   std::string name;
+  // The execution priority of the node, see ExecutionPriority.
+  int priority = 0;
 };
 
 /** GraphAugmenter is a stateless class to add new elements into a Graph.
@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/core/graph/optimizer/multi_tensor_adam_optimizer_builder.h"
+#include "orttraining/core/graph/graph_augmenter.h"
+#include "core/util/math.h"
+#include "onnx/defs/attr_proto_util.h"
+
+namespace onnxruntime {
+namespace training {
+namespace {
+
+float GetFloatAttribute(const OptimizerNodeConfig& opt_config, const std::string& name, float default_value) {
+  auto iter = opt_config.attributes.find(name);
+  return iter != opt_config.attributes.end() ? iter->second : default_value;
+}
+
+int64_t GetIntAttribute(const OptimizerNodeConfig& opt_config, const std::string& name, int64_t default_value) {
+  auto iter = opt_config.int_attributes.find(name);
+  return iter != opt_config.int_attributes.end() ? iter->second : default_value;
+}
+
+}  // namespace
+
+Status MultiTensorAdamOptimizerBuilder::Build(
+    const std::vector<ArgDef>& weight_argdefs,
+    const std::vector<ArgDef>& gradient_argdefs,
+    const ArgDef* gradient_norm_argdef,
+    const ArgDef* gradient_norm_finite_argdef,
+    const std::vector<OptimizerNodeConfig>& opt_configs,
+    GraphAugmenter::GraphDefs& graph_defs,
+    std::vector<ONNX_NAMESPACE::TensorProto>& new_external_initializers,
+    std::vector<ArgDef>& output_weight_argdefs,
+    std::vector<ArgDef>& output_gradient_argdefs) const {
+  return Build(weight_argdefs, gradient_argdefs,
+        gradient_norm_argdef, gradient_norm_finite_argdef,
+        opt_configs, graph_defs,
+        new_external_initializers, output_weight_argdefs,
+        output_gradient_argdefs,
+        // gradient clipping is disabled by default for Adam.
+        false /*enable_grad_clipping*/);
+}
+
+Status MultiTensorAdamOptimizerBuilder::Build(
+    const std::vector<ArgDef>& weight_argdefs,
+    const std::vector<ArgDef>& gradient_argdefs,
+    const ArgDef* gradient_norm_argdef,
+    const ArgDef* gradient_norm_finite_argdef,
+    const std::vector<OptimizerNodeConfig>& opt_configs,
+    GraphAugmenter::GraphDefs& graph_defs,
+    std::vector<TensorProto>& new_external_initializers,
+    std::vector<ArgDef>& output_weight_argdefs,
+    std::vector<ArgDef>& output_gradient_argdefs,
+    bool enable_grad_clipping) const {
+  ORT_RETURN_IF_NOT(weight_argdefs.size() <= size_t(1024),
+                    "MultiTensorAdamOptimizer can only update up to 1024 weight tensors, but ",
+                    "the actual number of weight tensors is ", weight_argdefs.size());
+
+  std::vector<ArgDef> input_argdefs;
+  std::vector<ArgDef> output_argdefs;
+
+  if (gradient_norm_finite_argdef) {
+    input_argdefs.push_back(*gradient_norm_finite_argdef);
+  } else {
+    input_argdefs.emplace_back(ArgDef());
+  }
+
+  if (!opt_configs[0].loss_scale_input_name.empty()) {
+    input_argdefs.emplace_back(ArgDef(opt_configs[0].loss_scale_input_name, graph_defs.CreateTypeProto({1}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT)));
+  } else {
+    input_argdefs.emplace_back(ArgDef());
+  }
+
+  if (gradient_norm_argdef && enable_grad_clipping) {
+    input_argdefs.push_back(*gradient_norm_argdef);
+  } else if (gradient_norm_argdef == nullptr && enable_grad_clipping) {
+    ORT_THROW("Gradient clipping is enabled but gradient norm is not given.");
+  } else {
+    input_argdefs.push_back(ArgDef());
+  }
+
+  input_argdefs.emplace_back(ArgDef(opt_configs[0].lr_feed_name, CreateLearningRateTypeProto(graph_defs)));
+  graph_defs.AddGraphInputs({opt_configs[0].lr_feed_name});
+
+  // All weights share one update count, which should be 1 at the first training iteration.
+  const std::string update_count_string = "Update_Count";
+  new_external_initializers.emplace_back(CreateTensorProto<int64_t>(update_count_string, 1));
+  input_argdefs.emplace_back(ArgDef(update_count_string));
+
+  TypeProto* step_type_proto = graph_defs.CreateTypeProto({}, ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  output_argdefs.emplace_back(ArgDef(update_count_string + "_Out", step_type_proto));
+
+  // Per-weight float attributes, and int attributes which all weights must share.
+  std::vector<float> alpha;
+  std::vector<float> beta;
+  std::vector<float> lambda;
+  std::vector<float> epsilon;
+  const int64_t do_bias_correction = GetIntAttribute(opt_configs.front(), "do_bias_correction", 1);
+  const int64_t weight_decay_mode = GetIntAttribute(opt_configs.front(), "weight_decay_mode", 0);
+
+  // Each iteration handles the associated inputs and outputs of a weight tensor.
+  // Associated inputs: [w, g, m1, m2, w_mixed_precision].
+  // Associated outputs: [w_new, g_new, m1_new, m2_new, w_mixed_precision_new].
+  for (size_t i = 0; i < weight_argdefs.size(); ++i) {
+    const std::string& weight_name = weight_argdefs[i].name;
+    const std::string& gradient_name = gradient_argdefs[i].name;
+    const TypeProto* const weight_type_proto = weight_argdefs[i].type_proto;
+    const TypeProto* const gradient_type_proto = gradient_argdefs[i].type_proto;
+
+    // Return either the input gradient/weight/mixed-precision-weight or updated gradient/weight/mixed-precision-weight.
+    ArgDef output_gradient_argdef = gradient_argdefs[i];
+    ArgDef output_weight_argdef = weight_argdefs[i];
+    if (opt_configs[i].mixed_precision_weight_arg != nullptr)
+      output_weight_argdef = ArgDef(opt_configs[i].mixed_precision_weight_arg->Name(), opt_configs[i].mixed_precision_weight_arg->TypeAsProto());
+
+    // In distributed training, some weights may not be updated by all ranks.
+    if (opt_configs[i].enabled) {
+      ORT_RETURN_IF_NOT(GetIntAttribute(opt_configs[i], "do_bias_correction", 1) == do_bias_correction &&
+                            GetIntAttribute(opt_configs[i], "weight_decay_mode", 0) == weight_decay_mode,
+                        "All weights updated by MultiTensorAdamOptimizer must share do_bias_correction and "
+                        "weight_decay_mode, which differ for ", weight_name);
+      alpha.emplace_back(GetFloatAttribute(opt_configs[i], "alpha", 0.9f));
+      beta.emplace_back(GetFloatAttribute(opt_configs[i], "beta", 0.999f));
+      lambda.emplace_back(GetFloatAttribute(opt_configs[i], "lambda", 0.0f));
+      epsilon.emplace_back(GetFloatAttribute(opt_configs[i], "epsilon", 1e-8f));
+
+      std::vector<int64_t> weight_dims;
+      ORT_RETURN_IF_NOT(
+          weight_type_proto &&
+          weight_type_proto->has_tensor_type() &&
+          weight_type_proto->tensor_type().has_shape());
+      for (const auto& dim : weight_type_proto->tensor_type().shape().dim()) {
+        weight_dims.push_back(dim.dim_value());
+      }
+
+      // w & g
+      input_argdefs.push_back(weight_argdefs[i]);
+      input_argdefs.push_back(gradient_argdefs[i]);
+
+      // Output either w_new or g_new based on config.
+      if (opt_configs[i].update_weight) {
+        output_weight_argdef = ArgDef(weight_name + "_Adam_out", weight_type_proto);
+        output_argdefs.push_back(output_weight_argdef);  // w_new
+        output_argdefs.push_back(ArgDef());  // g_new
+      } else {
+        output_gradient_argdef = ArgDef(gradient_name + "_Adam_out", gradient_type_proto);
+        output_argdefs.push_back(ArgDef());  // w_new
+        output_argdefs.push_back(output_gradient_argdef);  // g_new
+      }
+
+      // m1 & m2 & m1_new & m2_new, named as AdamOptimizer's so that checkpoints are interchangeable.
+      const std::vector<std::string> moments_prefixes({"Moment_1_", "Moment_2_"});
+      for (const auto& moments_prefix : moments_prefixes) {
+        const std::string gradient_moment_name = moments_prefix + weight_name;
+
+        TensorProto moment_tensor_proto;
+        TypeProto* moment_type_proto = graph_defs.CopyTypeProto(weight_argdefs[i]);
+        if (opt_configs[i].use_mixed_precision_moments) {
+          moment_tensor_proto = CreateTensorProto<MLFloat16>(gradient_moment_name, MLFloat16(math::floatToHalf(0.f)), weight_dims);
+          moment_type_proto->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT16);
+        } else {
+          moment_tensor_proto = CreateTensorProto<float>(gradient_moment_name, 0.f, weight_dims);
+        }
+
+        new_external_initializers.emplace_back(std::move(moment_tensor_proto));
+
+        input_argdefs.emplace_back(ArgDef(gradient_moment_name, moment_type_proto));
+        output_argdefs.emplace_back(ArgDef(gradient_moment_name + "_Out", moment_type_proto));
+      }
+
+      // w_mixed_precision & w_mixed_precision_new
+      if (opt_configs[i].update_weight && opt_configs[i].mixed_precision_weight_arg != nullptr) {
+        input_argdefs.emplace_back(ArgDef(
+            opt_configs[i].mixed_precision_weight_arg->Name(),
+            opt_configs[i].mixed_precision_weight_arg->TypeAsProto()));
+        output_weight_argdef = ArgDef(
+            opt_configs[i].mixed_precision_weight_arg->Name() + "_Adam_out",
+            opt_configs[i].mixed_precision_weight_arg->TypeAsProto());
+        output_argdefs.push_back(output_weight_argdef);
+      } else {
+        input_argdefs.emplace_back(ArgDef());
+        output_argdefs.emplace_back(ArgDef());
+      }
+    }
+
+    output_weight_argdefs.push_back(output_weight_argdef);
+    output_gradient_argdefs.push_back(output_gradient_argdef);
+  }
+
+  // No node is needed if this rank updates none of the weights.
+  if (alpha.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<AttributeProto> attribute_protos;
+  attribute_protos.emplace_back(ONNX_NAMESPACE::MakeAttribute("alpha", alpha));
+  attribute_protos.emplace_back(ONNX_NAMESPACE::MakeAttribute("beta", beta));
+  attribute_protos.emplace_back(ONNX_NAMESPACE::MakeAttribute("lambda", lambda));
+  attribute_protos.emplace_back(ONNX_NAMESPACE::MakeAttribute("epsilon", epsilon));
+  attribute_protos.emplace_back(ONNX_NAMESPACE::MakeAttribute("do_bias_correction", do_bias_correction));
+  attribute_protos.emplace_back(ONNX_NAMESPACE::MakeAttribute("weight_decay_mode", weight_decay_mode));
+
+  graph_defs.AddNodeDefs({NodeDef(OpDefinition(),
+                                  input_argdefs,
+                                  output_argdefs,
+                                  attribute_protos,
+                                  OptimizerNodeName("AllWeights"))});
+
+  return Status::OK();
+}
+
+}  // namespace training
+}  // namespace onnxruntime
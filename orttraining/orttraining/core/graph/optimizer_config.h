@@ -26,8 +26,9 @@ enum MixedPrecisionDataType {
 };
 
 // Configuration for the DeepSpeed ZeRO technique.  Currently only the stage
-// setting is supported, and only with stages 0 (disabled) and 1 (optimizer
-// state partitioning).
+// setting is supported, with stages 0 (disabled), 1 (optimizer state
+// partitioning), 2 (1 + gradient partitioning) and 3 (2 + parameter
+// partitioning).
 
 struct ZeROConfig {
   // Default configuration
@@ -63,10 +64,17 @@ struct OptimizerGraphConfig {
   MixedPrecisionDataType mixed_precision_type{MixedPrecisionDataType::FP16};
   bool allreduce_in_mixed_precision_type{false};
   bool use_nccl{false};
+  // With NCCL, the size limit of the buckets of gradients which are allreduced together as soon as the backward pass
+  // has produced them, overlapping the communication with the rest of the backward pass.
+  // 0 allreduces all the gradients at once after the backward pass.
+  size_t allreduce_bucket_size_in_bytes{0};
   ZeROConfig deepspeed_zero{0};
   int gradient_accumulation_steps{1};
   int64_t horovod_reduce_op{1};
   std::string loss_scale_input_name{};  // empty string means no loss scaling factor is applied
+  // If true, the loss scale is updated in the graph from the global gradient norm by a DynamicLossScale node,
+  // and the Adam optimizers skip the overflowed steps on the device instead of waiting for the host.
+  bool use_device_loss_scaling{false};
   AdasumReductionType adasum_reduction_type{AdasumReductionType::None};
   bool enable_grad_norm_clip{true};
 
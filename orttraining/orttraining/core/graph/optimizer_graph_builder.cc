@@ -301,6 +301,53 @@ Status OptimizerGraphBuilder::AddFiniteGradientCheck(
   return Status::OK();
 }
 
+bool OptimizerGraphBuilder::SkipsNonFiniteStepsOnDevice() const {
+  // The CUDA Adam kernels check the gradient norm input themselves, the other optimizers need do_update.
+  return opt_graph_config_.use_device_loss_scaling &&
+         opt_graph_config_.enable_grad_norm_clip &&
+         !opt_configs_.empty() &&
+         (opt_configs_[0].name == "AdamOptimizer" || opt_configs_[0].name == "MultiTensorAdamOptimizer");
+}
+
+Status OptimizerGraphBuilder::AddDynamicLossScaleUpdate(
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const ArgDef& global_grad_norm_argdef,
+    const std::vector<ArgDef>& optimizer_output_argdefs,
+    GraphAugmenter::GraphDefs& graph_defs,
+    std::unordered_set<std::string>& optimizer_state_initializer_names) {
+  ORT_RETURN_IF(opt_graph_config_.loss_scale_input_name.empty(),
+                "Device loss scaling requires a loss scale input.");
+  ORT_RETURN_IF(global_grad_norm_argdef.name.empty(),
+                "Device loss scaling requires the global gradient norm.");
+
+  // The loss scale is updated in place, so it must wait for every node reading it,
+  // which the optimizer outputs transitively depend on.
+  std::vector<ArgDef> update_signal_inputs;
+  std::copy_if(
+      optimizer_output_argdefs.begin(), optimizer_output_argdefs.end(), std::back_inserter(update_signal_inputs),
+      [](const ArgDef& argdef) { return !argdef.name.empty(); });
+  ArgDef update_signal_argdef = BuildGroupNode(nodearg_name_generator("Group_Optimizer_Outputs"),
+                                               update_signal_inputs,
+                                               graph_defs);
+
+  const TypeProto* const loss_scale_type = graph_defs.CreateTypeProto({1}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  const TypeProto* const stable_steps_type = graph_defs.CreateTypeProto({1}, ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  const ArgDef loss_scale_argdef{opt_graph_config_.loss_scale_input_name, loss_scale_type};
+  const ArgDef stable_steps_argdef{nodearg_name_generator("loss_scale_stable_steps"), stable_steps_type};
+  graph_defs.AddInitializers({CreateTensorProto<int64_t>(stable_steps_argdef.name, 0)});
+  optimizer_state_initializer_names.insert(stable_steps_argdef.name);
+
+  const ArgDef loss_scale_out_argdef{nodearg_name_generator(loss_scale_argdef.name + "_out"), loss_scale_type};
+  const ArgDef stable_steps_out_argdef{nodearg_name_generator(stable_steps_argdef.name + "_out"), stable_steps_type};
+  graph_defs.AddNodeDefs({NodeDef{OpDef{"DynamicLossScale", kMSDomain, 1},
+                                  {loss_scale_argdef, stable_steps_argdef, global_grad_norm_argdef, update_signal_argdef},
+                                  {loss_scale_out_argdef, stable_steps_out_argdef},
+                                  NodeAttributes(),
+                                  loss_scale_out_argdef.name}});
+
+  return Status::OK();
+}
+
 OptimizerGraphBuilder::OptimizerGraphBuilder(
     const OptimizerBuilderRegistry& opt_builder_registry,
     const OptimizerGraphConfig& opt_graph_config,
@@ -358,7 +405,8 @@ Status OptimizerGraphBuilder::Build(
   ORT_RETURN_IF_ERROR(GetArgDefsFromGraph(graph, weight_names_, weight_argdefs));
   ORT_RETURN_IF_ERROR(GetArgDefsFromGraph(graph, gradient_names_, gradient_argdefs));
 
-  const bool is_gradient_accumulation_enabled = opt_graph_config_.gradient_accumulation_steps > 1;
+  const bool is_gradient_accumulation_enabled =
+      opt_graph_config_.gradient_accumulation_steps > 1 && !BuildsGradientAccumulation();
 
   // add gradient accumulation
   std::vector<ArgDef> gradient_accumulation_buffers;
@@ -411,9 +459,11 @@ Status OptimizerGraphBuilder::BuildInternal(
       ORT_RETURN_IF_ERROR(AddGradientNorm(
           nodearg_name_generator, gradient_argdefs, graph_defs, global_grad_norm_argdef));
       optimizer_graph_outputs[OptimizerOutputKey::GlobalGradientNorm] = global_grad_norm_argdef.name;
-      ORT_RETURN_IF_ERROR(AddFiniteGradientCheck(
-          nodearg_name_generator, {global_grad_norm_argdef}, graph_defs, global_grad_norm_finite_argdef));
-      optimizer_graph_outputs[OptimizerOutputKey::GradientAllIsFinite] = global_grad_norm_finite_argdef.name;
+      if (!SkipsNonFiniteStepsOnDevice()) {
+        ORT_RETURN_IF_ERROR(AddFiniteGradientCheck(
+            nodearg_name_generator, {global_grad_norm_argdef}, graph_defs, global_grad_norm_finite_argdef));
+        optimizer_graph_outputs[OptimizerOutputKey::GradientAllIsFinite] = global_grad_norm_finite_argdef.name;
+      }
     }
   }
 
@@ -425,6 +475,15 @@ Status OptimizerGraphBuilder::BuildInternal(
       opt_configs_, graph_defs,
       optimizer_state_initializer_names));
 
+  // update the loss scale in the graph
+  if (opt_graph_config_.use_device_loss_scaling) {
+    std::vector<ArgDef> optimizer_output_argdefs(weight_argdefs);
+    optimizer_output_argdefs.insert(optimizer_output_argdefs.end(), gradient_argdefs.begin(), gradient_argdefs.end());
+    ORT_RETURN_IF_ERROR(AddDynamicLossScaleUpdate(
+        nodearg_name_generator, global_grad_norm_argdef, optimizer_output_argdefs,
+        graph_defs, optimizer_state_initializer_names));
+  }
+
   return Status::OK();
 }
 
@@ -29,6 +29,16 @@ ArgDef BuildGradientAccumulationNode(const NodeArgNameGeneratorFn& nodearg_name_
                                      GraphAugmenter::GraphDefs& graph_defs,
                                      bool add_accumulate_buffer_as_initializers = true);
 
+ArgDef AddGradientAccumulationNodes(const NodeArgNameGeneratorFn& nodearg_name_generator,
+                                    std::vector<ArgDef>& gradient_argdefs,
+                                    std::vector<ArgDef>& gradient_accumulation_buffers,
+                                    GraphAugmenter::GraphDefs& graph_defs);
+
+Status AddZeroGradientNodes(const NodeArgNameGeneratorFn& nodearg_name_generator,
+                            const std::vector<ArgDef>& control_signals,
+                            std::vector<ArgDef>& gradient_argdefs,
+                            GraphAugmenter::GraphDefs& graph_defs);
+
 /**
  * Builds the optimizer components on top of an existing training graph.
  * The optimizers used are determined by the weight_names_to_opt_configs parameter
@@ -73,6 +83,10 @@ class OptimizerGraphBuilder {
       std::unordered_set<std::string>& optimizer_state_initializer_names,
       OptimizerOutputKeyMap<std::string>& optimizer_graph_outputs);
 
+  // If true, BuildInternal adds the gradient accumulation and zero gradient nodes itself,
+  // e.g. to accumulate only part of the gradients, instead of Build adding them for all gradients.
+  virtual bool BuildsGradientAccumulation() const { return false; }
+
   Status AddGradientScalingNodes(
       const NodeArgNameGeneratorFn& nodearg_name_generator,
       const float scale,
@@ -95,6 +109,18 @@ class OptimizerGraphBuilder {
       ArgDef& grad_norm_finite_argdef,
       const std::string& node_name = "all_gradients_finite");
 
+  // Whether the optimizers skip the overflowed steps on the device from the global gradient norm,
+  // so the IsAllFinite check feeding the host-side do_update input can be left out.
+  bool SkipsNonFiniteStepsOnDevice() const;
+
+  // Adds the DynamicLossScale node updating the loss scale in place after all the optimizer outputs.
+  Status AddDynamicLossScaleUpdate(
+      const NodeArgNameGeneratorFn& nodearg_name_generator,
+      const ArgDef& global_grad_norm_argdef,
+      const std::vector<ArgDef>& optimizer_output_argdefs,
+      GraphAugmenter::GraphDefs& graph_defs,
+      std::unordered_set<std::string>& optimizer_state_initializer_names);
+
   Status AddDirectWeightUpdate(
       const OptimizerBuilderRegistry& opt_builder_registry,
       std::vector<ArgDef>& weight_argdefs,
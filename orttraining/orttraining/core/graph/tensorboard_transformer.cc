@@ -3,13 +3,106 @@
 
 #include "orttraining/core/graph/tensorboard_transformer.h"
 #include "orttraining/core/graph/graph_augmenter.h"
+#include "orttraining/core/graph/optimizer_builder.h"
 #include "onnx/defs/attr_proto_util.h"
 
+#include <map>
+
 using namespace onnxruntime::common;
 
 namespace onnxruntime {
 namespace training {
 
+namespace {
+// A scalar to summarize, with its tag.
+struct ScalarSummary {
+  std::string input;
+  std::string tag;
+  // The element type of the input, or UNDEFINED if it isn't known yet.
+  int32_t elem_type;
+};
+}  // namespace
+
+static int32_t GetElemType(const Graph& graph, const std::string& name) {
+  const NodeArg* node_arg = graph.GetNodeArg(name);
+  if (node_arg == nullptr || node_arg->TypeAsProto() == nullptr || !node_arg->TypeAsProto()->has_tensor_type()) {
+    return ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
+  }
+  return node_arg->TypeAsProto()->tensor_type().elem_type();
+}
+
+// Adds the SummaryScalar nodes. The scalars of the same type are concatenated where they are computed, e.g. on the
+// device, into the input of a single SummaryScalar node, so they are copied to the host at once.
+static void AddScalarSummaries(Graph& graph,
+                               const std::string& summary_name,
+                               const std::vector<ScalarSummary>& scalars,
+                               std::vector<ArgDef>& summary_args,
+                               std::vector<NodeDef>& new_nodes,
+                               GraphAugmenter::GraphDefs& graph_defs) {
+  std::map<int32_t, std::vector<const ScalarSummary*>> batches;
+  for (const ScalarSummary& scalar : scalars) {
+    if (scalar.elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+        scalar.elem_type == ONNX_NAMESPACE::TensorProto_DataType_DOUBLE) {
+      batches[scalar.elem_type].push_back(&scalar);
+    } else {
+      summary_args.push_back(ArgDef(scalar.tag));
+      new_nodes.emplace_back(NodeDef(OpDef{"SummaryScalar", kMSDomain, 1},
+                                     {ArgDef(scalar.input)},
+                                     {ArgDef(scalar.tag)},
+                                     {ONNX_NAMESPACE::MakeAttribute("tags", std::vector<std::string>{scalar.tag})},
+                                     graph.GenerateNodeName(scalar.tag)));
+    }
+  }
+
+  std::string scalar_shape;
+  for (const auto& batch : batches) {
+    const std::vector<const ScalarSummary*>& batch_scalars = batch.second;
+    if (batch_scalars.size() == 1) {
+      const ScalarSummary& scalar = *batch_scalars.front();
+      summary_args.push_back(ArgDef(scalar.tag));
+      new_nodes.emplace_back(NodeDef(OpDef{"SummaryScalar", kMSDomain, 1},
+                                     {ArgDef(scalar.input)},
+                                     {ArgDef(scalar.tag)},
+                                     {ONNX_NAMESPACE::MakeAttribute("tags", std::vector<std::string>{scalar.tag})},
+                                     graph.GenerateNodeName(scalar.tag)));
+      continue;
+    }
+
+    if (scalar_shape.empty()) {
+      scalar_shape = graph.GenerateNodeArgName(summary_name + "/scalar_shape");
+      graph_defs.AddInitializers({CreateTensorProto<int64_t>(scalar_shape, int64_t(1), {1})});
+    }
+
+    std::vector<ArgDef> flat_scalars;
+    std::vector<std::string> tags;
+    for (const ScalarSummary* scalar : batch_scalars) {
+      std::string flat_scalar = graph.GenerateNodeArgName(scalar->tag + "/flat");
+      flat_scalars.push_back(ArgDef(flat_scalar));
+      tags.push_back(scalar->tag);
+      new_nodes.emplace_back(NodeDef("Reshape",
+                                     {ArgDef(scalar->input), ArgDef(scalar_shape)},
+                                     {ArgDef(flat_scalar)},
+                                     NodeAttributes(),
+                                     graph.GenerateNodeName(flat_scalar)));
+    }
+
+    std::string batched_scalars = graph.GenerateNodeArgName(summary_name + "/scalars");
+    new_nodes.emplace_back(NodeDef("Concat",
+                                   flat_scalars,
+                                   {ArgDef(batched_scalars)},
+                                   {ONNX_NAMESPACE::MakeAttribute("axis", int64_t(0))},
+                                   graph.GenerateNodeName(batched_scalars)));
+
+    std::string batched_scalars_output = graph.GenerateNodeArgName(summary_name + "/scalar");
+    summary_args.push_back(ArgDef(batched_scalars_output));
+    new_nodes.emplace_back(NodeDef(OpDef{"SummaryScalar", kMSDomain, 1},
+                                   {ArgDef(batched_scalars)},
+                                   {ArgDef(batched_scalars_output)},
+                                   {ONNX_NAMESPACE::MakeAttribute("tags", tags)},
+                                   graph.GenerateNodeName(batched_scalars_output)));
+  }
+}
+
 Status TransformGraphForTensorboard(Graph& graph,
                                     const std::string& summary_name,
                                     const std::vector<std::string>& scalar_nodes,
@@ -18,16 +111,12 @@ Status TransformGraphForTensorboard(Graph& graph,
                                     const bool dump_convergence_metrics) {
   std::vector<ArgDef> summary_args;
   std::vector<NodeDef> new_nodes;
+  std::vector<ScalarSummary> scalars;
+  GraphAugmenter::GraphDefs graph_defs;
 
-  // SummaryScalar nodes.
+  // Scalars.
   for (const std::string& scalar_input : scalar_nodes) {
-    std::string scalar_output = summary_name + "/scalar/" + scalar_input;
-    summary_args.push_back(ArgDef(scalar_output));
-    new_nodes.emplace_back(NodeDef(OpDef{"SummaryScalar", kMSDomain, 1},
-                                   {ArgDef(scalar_input)},
-                                   {ArgDef(scalar_output)},
-                                   {ONNX_NAMESPACE::MakeAttribute("tags", std::vector<std::string>{scalar_output})},
-                                   graph.GenerateNodeName(scalar_output)));
+    scalars.push_back({scalar_input, summary_name + "/scalar/" + scalar_input, GetElemType(graph, scalar_input)});
   }
 
   // SummaryHistogram nodes.
@@ -65,18 +154,14 @@ Status TransformGraphForTensorboard(Graph& graph,
                                    graph.GenerateNodeName(norm_output)));
 
     std::string scalar_output = graph.GenerateNodeArgName(summary_name + "/scalar/L2-norm/" + norm_input);
-    summary_args.push_back(ArgDef(scalar_output));
-    new_nodes.emplace_back(NodeDef(OpDef("SummaryScalar", kMSDomain, 1),
-                                   {ArgDef(norm_output)},
-                                   {ArgDef(scalar_output)},
-                                   {ONNX_NAMESPACE::MakeAttribute("tags", std::vector<std::string>{scalar_output})},
-                                   graph.GenerateNodeName(scalar_output)));
+    scalars.push_back({norm_output, scalar_output, GetElemType(graph, norm_input)});
   }
 
   // If user wants to output gradient norm.
   if (dump_convergence_metrics) {
     auto initializer_set = graph.GetAllInitializedTensors();
     std::vector<ArgDef> squared_grad_sum_arg_defs;
+    int32_t gradient_elem_type = ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
     for (const auto& pair: initializer_set) {
       auto name = pair.first;
       auto grad_node = graph.GetNodeArg(name + "_grad");
@@ -95,6 +180,7 @@ Status TransformGraphForTensorboard(Graph& graph,
       attribute_protos.push_back(ONNX_NAMESPACE::MakeAttribute("axes", axes));
       std::string squared_sum_name = graph.GenerateNodeArgName(summary_name + grad_node->Name() + "/squared_sum");
       std::string squared_sum_node_name = graph.GenerateNodeName(squared_sum_name);
+      gradient_elem_type = GetElemType(graph, grad_node->Name());
       squared_grad_sum_arg_defs.push_back(ArgDef(squared_sum_name)),
       new_nodes.emplace_back(NodeDef("ReduceSumSquare",
                                     {ArgDef(grad_node->Name())},
@@ -120,15 +206,11 @@ Status TransformGraphForTensorboard(Graph& graph,
                                   sqrt_node_name));
 
     std::string total_gradient_norm_scalar_output = graph.GenerateNodeArgName(summary_name + "/tb_total_gradient_norm");
-    std::string summary_scalar_node_name = graph.GenerateNodeName(total_gradient_norm_scalar_output);
-    summary_args.push_back(ArgDef(total_gradient_norm_scalar_output));
-    new_nodes.emplace_back(NodeDef(OpDef("SummaryScalar", kMSDomain, 1),
-                                   {ArgDef(total_gradient_norm)},
-                                   {ArgDef(total_gradient_norm_scalar_output)},
-                                   {ONNX_NAMESPACE::MakeAttribute("tags", std::vector<std::string>{total_gradient_norm_scalar_output})},
-                                   summary_scalar_node_name));
+    scalars.push_back({total_gradient_norm, total_gradient_norm_scalar_output, gradient_elem_type});
   }
 
+  AddScalarSummaries(graph, summary_name, scalars, summary_args, new_nodes, graph_defs);
+
   // SummaryMerge (if any tensorboard nodes exist).
   if (summary_args.size() > 0) {
     new_nodes.emplace_back(NodeDef(OpDef("SummaryMerge", kMSDomain, 1),
@@ -138,7 +220,6 @@ Status TransformGraphForTensorboard(Graph& graph,
                                     summary_name));
 
     // Modify graph.
-    GraphAugmenter::GraphDefs graph_defs;
     graph_defs.AddNodeDefs(new_nodes);
     graph_defs.AddGraphOutputs({summary_name});
     return GraphAugmenter::AugmentGraph(graph, graph_defs);
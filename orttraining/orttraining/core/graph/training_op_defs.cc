@@ -132,6 +132,31 @@ static void propagateRecvOutputTensorElemTypes(
   }
 }
 
+// Propagates the input's type and rank, leaving the dimension along 'axis' unknown, as it is scaled by the size of
+// the horizontal parallel group, which is only known at run time. The transformer which inserts the node sets it.
+static void propagateShapeAndTypeExceptAxis(InferenceContext& ctx) {
+  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (!hasInputShape(ctx, 0)) {
+    return;
+  }
+
+  const auto& input_shape = getInputShape(ctx, 0);
+  const int64_t rank = input_shape.dim_size();
+  int64_t axis = getAttribute(ctx, "axis", 1);
+  if (axis < -rank || axis >= rank) {
+    fail_shape_inference("axis must be in [-rank, rank-1].");
+  }
+  axis = axis < 0 ? axis + rank : axis;
+
+  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+  for (int64_t i = 0; i < rank; ++i) {
+    auto* dim = output_shape->add_dim();
+    if (i != axis) {
+      *dim = input_shape.dim(static_cast<int>(i));
+    }
+  }
+}
+
 // TODO: This is copied from onnx schemas. When the change is in and we update this can be removed.
 // For Brevity documentation was not copied
 OpSchema& RegisterLambOpSchema(OpSchema&& op_schema) {
@@ -320,6 +345,178 @@ OpSchema& RegisterLambOpSchema(OpSchema&& op_schema) {
   return op_schema;
 }
 
+OpSchema& RegisterMultiTensorAdamOpSchema(OpSchema&& op_schema) {
+  op_schema
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Adam optimizer updating all weights at once with multi-tensor CUDA kernels. "
+              "The update of each weight is the same as AdamOptimizer's.")
+      .Attr(
+          "alpha",
+          "Coefficient of previous gradient in running average, one per weight.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.9f))
+      .Attr(
+          "beta",
+          "Coefficient of previous squared gradient in running average, one per weight.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.999f))
+      .Attr(
+          "lambda",
+          "Regularization coefficient, one per weight. Default to 0, "
+          "which means no regularization.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.0f))
+      .Attr(
+          "epsilon",
+          "Small scalar to avoid dividing by zero, one per weight.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 1e-8f))
+      .Attr(
+          "do_bias_correction",
+          "Compute unbiased 1st and 2nd momentums.",
+          AttributeProto::INT,
+          static_cast<int64_t>(1))
+      .Attr(
+          "weight_decay_mode",
+          "Modes for applying weight decay, "
+          "0 means applying decay before weight update, "
+          "1 means applying decay after weight update.",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
+      .TypeConstraint(
+          "T1",
+          {"tensor(float16)", "tensor(float)", "tensor(double)", "tensor(bfloat16)"},
+          "Constrain learning rate to float")
+      .TypeConstraint(
+          "T2",
+          {"tensor(int64)"},
+          "Constrain step count to 64-bit integer")
+      .TypeConstraint(
+          "T3",
+          {"tensor(float)", "tensor(double)"},
+          "Constrain input types to float tensors.")
+      .TypeConstraint(
+          "T4",
+          {"tensor(float16)", "tensor(float)", "tensor(double)", "tensor(bfloat16)"},
+          "Constrain input types to float tensors.")
+      .TypeConstraint(
+          "T_GRAD",
+          {"tensor(float16)", "tensor(float)", "tensor(double)", "tensor(bfloat16)"},
+          "Constrain input types to float tensors.")
+      .TypeConstraint(
+          "T_MIXED_PRECISION_FP",
+          {"tensor(float16)", "tensor(bfloat16)"},
+          "Constrain input types to float16 or bfloat16 tensors.")
+      .TypeConstraint(
+          "T_GRAD_NORM",
+          {"tensor(float16)", "tensor(float)", "tensor(double)", "tensor(bfloat16)"},
+          "Constrain input types to float tensors.")
+      .TypeConstraint(
+          "T_BOOL",
+          {"tensor(bool)"},
+          "Constrain types to boolean tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        // The first 4 inputs don't affect output shape, and the step is propagated to the first output.
+        propagateElemTypeFromInputToOutput(ctx, 4, 0);
+        if (hasInputShape(ctx, 4)) {
+          propagateShapeFromInputToOutput(ctx, 4, 0);
+        }
+
+        for (size_t i = 0; i < ctx.getNumInputs() - 5; ++i) {
+          const size_t input_index = 5 + i;
+          const size_t output_index = 1 + i;
+          if (ctx.getInputType(input_index) != nullptr && output_index < ctx.getNumOutputs()) {
+            propagateElemTypeFromInputToOutput(ctx, input_index, output_index);
+            if (hasInputShape(ctx, input_index)) {
+              propagateShapeFromInputToOutput(ctx, input_index, output_index);
+            }
+          }
+        }
+      });
+
+  op_schema
+      .Input(
+          0,
+          "update_signal",
+          "This signal indicates if weight tensors should be updated.",
+          "T_BOOL",
+          OpSchema::Optional)
+      .Input(
+          1,
+          "loss_scale",
+          "Loss scale for mixed precision training.",
+          "T3",
+          OpSchema::Optional)
+      .Input(
+          2,
+          "global_gradient_norm",
+          "Global gradient norm.",
+          "T_GRAD_NORM",
+          OpSchema::Optional)
+      .Input(
+          3,
+          "R",
+          "The initial learning rate.",
+          "T1")
+      .Input(
+          4,
+          "T",
+          "The update count shared by all weights. It should be a scalar.",
+          "T2");
+
+  AddRepeatedInputs(
+      op_schema,
+      5,
+      1024,
+      {"weights",
+       "gradients",
+       "moment1",
+       "moment2",
+       "mixed_precision_weights"},
+      {"weights to optimize.",
+       "gradients computed in this iteration.",
+       "exponentially averaged historical gradients.",
+       "exponentially averaged historical squared gradients.",
+       "FP16 or BF16 weights to optimize."},
+      {"T3",
+       "T_GRAD",
+       "T4",
+       "T4",
+       "T_MIXED_PRECISION_FP"},
+      OpSchema::Optional);
+
+  op_schema
+      .Output(
+          0,
+          "new_T",
+          "New update count.",
+          "T2");
+
+  AddRepeatedOutputs(
+      op_schema,
+      1,
+      1024,
+      {"new_weights",
+       "new_gradients",
+       "new_moment_1",
+       "new_moment_2",
+       "new_mixed_precision_weights"},
+      {"New weights",
+       "New gradients",
+       "New averaged gradients",
+       "New averaged squared gradients",
+       "New FP16 or BF16 weights"},
+      {"T3",
+       "T_GRAD",
+       "T4",
+       "T4",
+       "T_MIXED_PRECISION_FP"},
+      OpSchema::Optional);
+
+  return op_schema;
+}
+
 void RegisterTrainingOpSchemas() {
   ONNX_CONTRIB_OPERATOR_SCHEMA(ReluGrad)
       .SetDomain(kMSDomain)
@@ -709,6 +906,8 @@ void RegisterTrainingOpSchemas() {
           {"tensor(bool)"},
           "Constrain types to boolean tensors.");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(MultiTensorAdamOptimizer, RegisterMultiTensorAdamOpSchema);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(LambOptimizer, RegisterLambOpSchema);
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(InPlaceAccumulator)
@@ -932,6 +1131,11 @@ Example 4:
       .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
             AttributeProto::INT,
             static_cast<int64_t>(0))
+      .Attr("async",
+            "1 - the reduction runs on a communication stream concurrently with the following nodes, "
+            "and the outputs must be passed through NcclWait before they are used",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
       .Input(0, "input", "tensors to be reduced", "T", OpSchema::Variadic)
       .Output(0, "output", "reduced tensors", "T", OpSchema::Variadic)
       .TypeConstraint(
@@ -942,6 +1146,25 @@ Example 4:
         propagateShapeAndTypeFromFirstInput(ctx);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NcclWait)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Waits for the asynchronous NCCL collective which produced the inputs. The outputs are the inputs.")
+      .Input(0, "input", "outputs of an asynchronous NCCL collective", "T", OpSchema::Variadic)
+      .Output(0, "output", "the inputs, which can be used once the collective has completed", "T", OpSchema::Variadic)
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain to float, float16 and double tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        for (size_t i = 0; i < ctx.getNumOutputs(); ++i) {
+          propagateElemTypeFromInputToOutput(ctx, i, i);
+          if (hasInputShape(ctx, i)) {
+            propagateShapeFromInputToOutput(ctx, i, i);
+          }
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(NcclAllGather)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -958,6 +1181,34 @@ Example 4:
         propagateShapeAndTypeFromFirstInput(ctx);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NcclAllGatherV)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Gathers a tensor partitioned across the ranks, each rank holding the next range of its elements "
+              "in rank order.")
+      .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("counts", "number of elements of the tensor held by each rank", AttributeProto::INTS)
+      .Attr("shape", "shape of the gathered tensor", AttributeProto::INTS)
+      .Input(0, "input", "elements of the tensor held by this rank", "T")
+      .Output(0, "output", "gathered tensor", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain to float, float16 and double tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        const auto* shape_attr = ctx.getAttribute("shape");
+        if (shape_attr != nullptr) {
+          ONNX_NAMESPACE::TensorShapeProto shape;
+          for (auto dim : shape_attr->ints()) {
+            shape.add_dim()->set_dim_value(dim);
+          }
+          updateOutputShape(ctx, 0, shape);
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(NcclReduceScatter)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1506,6 +1757,66 @@ Example 4:
           {"tensor(bool)"},
           "Binarize tensors.");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GistPack16Encoder)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Lossy packing of a stashed activation into a 16-bit float type.")
+      .Attr(
+          "to",
+          "The compressed data type, float16 or bfloat16.",
+          AttributeProto::INT,
+          static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT16))
+      .Input(0, "X", "uncompressed input", "T")
+      .Output(0, "Y", "uncompressed output", "T")
+      .Output(1, "Y1", "compressed output", "T1")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain to float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(float16)", "tensor(bfloat16)"},
+          "Constrain to 16-bit float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        propagateElemTypeFromAttributeToOutput(ctx, "to", 1);
+        if (hasInputShape(ctx, 0)) {
+          propagateShapeFromInputToOutput(ctx, 0, 0);
+          propagateShapeFromInputToOutput(ctx, 0, 1);
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GistPack16Decoder)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Unpacking of an activation compressed by GistPack16Encoder.")
+      .Attr(
+          "to",
+          "The uncompressed data type.",
+          AttributeProto::INT,
+          static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT))
+      .Input(0, "X1", "dummy input for late decoding", "T2", OpSchema::Optional)
+      .Input(1, "X", "compresssed input", "T1")
+      .Output(0, "Y", "uncompressed output", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain to float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(float16)", "tensor(bfloat16)"},
+          "Constrain to 16-bit float tensors.")
+      .TypeConstraint(
+          "T2",
+          OpSchema::all_tensor_types(),
+          "Allow any tensor type for the dummy input.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromAttributeToOutput(ctx, "to", 0);
+        if (hasInputShape(ctx, 1)) {
+          propagateShapeFromInputToOutput(ctx, 1, 0);
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(SinGrad)
       .SetDomain(kOnnxDomain)
       .SinceVersion(9)
@@ -1788,6 +2099,68 @@ Example 4:
           "be false.",
           "T");
 
+  static const char* DynamicLossScale_doc = R"DOC(
+Update the loss scale of mixed precision training in-place from the global gradient norm.
+If the norm is not finite, the loss scale is halved, no lower than min_loss_scale.
+Otherwise, it is doubled, no higher than max_loss_scale, after up_scale_window consecutive finite steps.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicLossScale)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
+      .SetDoc(DynamicLossScale_doc)
+      .Attr(
+          "up_scale_window",
+          "The number of consecutive steps with finite gradients after which the loss scale is doubled.",
+          AttributeProto::INT,
+          static_cast<int64_t>(2000))
+      .Attr(
+          "min_loss_scale",
+          "The lower bound of the loss scale.",
+          AttributeProto::FLOAT,
+          1.0f)
+      .Attr(
+          "max_loss_scale",
+          "The upper bound of the loss scale.",
+          AttributeProto::FLOAT,
+          static_cast<float>(1 << 24))
+      .Input(0, "loss_scale", "The current loss scale.", "T")
+      .Input(1, "stable_steps", "The number of consecutive steps with finite gradients.", "TInt64")
+      .Input(2, "gradient_norm", "The global norm of the loss-scaled gradients.", "T_GRAD_NORM")
+      .Input(
+          3,
+          "update_signal",
+          "Signal produced once all the readers of the current loss scale have run, "
+          "so the loss scale is only updated after them.",
+          "T_BOOL",
+          OpSchema::Optional)
+      .Output(0, "loss_scale_out", "The updated loss scale.", "T")
+      .Output(1, "stable_steps_out", "The updated number of consecutive steps with finite gradients.", "TInt64")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain the loss scale to float tensors.")
+      .TypeConstraint(
+          "TInt64",
+          {"tensor(int64)"},
+          "Constrain the step count to int64 tensors.")
+      .TypeConstraint(
+          "T_GRAD_NORM",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain the gradient norm to float tensors.")
+      .TypeConstraint(
+          "T_BOOL",
+          {"tensor(bool)"},
+          "Constrain the update signal to a boolean tensor.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateShapeAndTypeFromFirstInput(ctx);
+        propagateElemTypeFromInputToOutput(ctx, 1, 1);
+        if (hasInputShape(ctx, 1)) {
+          propagateShapeFromInputToOutput(ctx, 1, 1);
+        }
+      });
+
   static const char* All_doc = R"DOC(
 Return true if all elements are true and false otherwise.
 )DOC";
@@ -2040,6 +2413,66 @@ Return true if all elements are true and false otherwise.
         propagateShapeAndTypeFromFirstInput(ctx);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MegatronReduceScatter)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Sequence parallel counterpart of MegatronG: sums the inputs of the horizontal parallel group "
+              "and keeps this rank's chunk of the result along 'axis'.")
+      .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("axis", "The sharded dimension, whose size must be divisible by the group size.",
+            AttributeProto::INT,
+            static_cast<int64_t>(1))
+      .Input(0, "input", "The partial sums as Tensor.", "T")
+      .Output(0, "output", "This rank's chunk of the sum.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain to float, float16 and double tensors.")
+      .TypeAndShapeInferenceFunction(propagateShapeAndTypeExceptAxis);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MegatronAllGather)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Concatenates the chunks of the horizontal parallel group along 'axis'.")
+      .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("axis", "The sharded dimension.",
+            AttributeProto::INT,
+            static_cast<int64_t>(1))
+      .Attr("reduce_gradient",
+            "1 if the consumers compute partial results on each rank, e.g. a column parallel MatMul, so the "
+            "gradient is summed over the group before it is sliced, 0 if they are replicated.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Input(0, "input", "This rank's chunk.", "T")
+      .Output(0, "output", "The concatenated chunks.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain to float, float16 and double tensors.")
+      .TypeAndShapeInferenceFunction(propagateShapeAndTypeExceptAxis);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MegatronSlice)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Keeps this rank's chunk along 'axis' of a tensor replicated in the horizontal parallel group.")
+      .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("axis", "The sharded dimension, whose size must be divisible by the group size.",
+            AttributeProto::INT,
+            static_cast<int64_t>(1))
+      .Input(0, "input", "The replicated tensor.", "T")
+      .Output(0, "output", "This rank's chunk.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain to float, float16 and double tensors.")
+      .TypeAndShapeInferenceFunction(propagateShapeAndTypeExceptAxis);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(SliceGrad)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -3,9 +3,13 @@
 
 #include "orttraining/core/graph/zero_optimizer_graph_builder.h"
 
+#include <algorithm>
+
 #include "core/common/common.h"
+#include "core/framework/session_options.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph.h"
+#include "core/graph/graph_utils.h"
 #include "orttraining/core/graph/graph_augmenter.h"
 
 namespace onnxruntime {
@@ -19,6 +23,14 @@ static bool IsNcclAvailable() {
 #endif
 }
 
+// Returns the number of elements of the concatenated parameters each rank is responsible for.
+// Note: the alignment here needs to be kept in-sync with the alignment in nccl_kernels.cc
+static int64_t GetRankCount(int64_t total_count, int data_parallel_group_size) {
+  const int64_t alignment = data_parallel_group_size * 32;
+  const int64_t padded_count = total_count + alignment - (total_count % alignment);
+  return padded_count / data_parallel_group_size;
+}
+
 static Status AddNcclReduceScatterForGradients(
     std::vector<ArgDef>& gradient_argdefs,
     GraphAugmenter::GraphDefs& graph_defs) {
@@ -195,12 +207,8 @@ static Status ModifyParametersForOptimizerPartitioning(
   }
 
   // Compute split points for parameters.
-  // Note: the alignment here needs to be kept in-sync with the alignment in nccl_kernels.cc
   const int data_parallel_group_rank = opt_graph_config.data_parallel_group_rank;
-  const int data_parallel_group_size = opt_graph_config.data_parallel_group_size;
-  const int64_t alignment = data_parallel_group_size * 32;
-  const int64_t padded_count = total_count + alignment - (total_count % alignment);
-  const int64_t rank_count = padded_count / data_parallel_group_size;
+  const int64_t rank_count = GetRankCount(total_count, opt_graph_config.data_parallel_group_size);
   const int64_t rank_start = data_parallel_group_rank * rank_count;
   const int64_t rank_end = rank_start + rank_count;
 
@@ -284,6 +292,109 @@ static std::vector<ArgDef> GetGradientNormInputs(
   return inputs;
 }
 
+// Accumulates the gradients of the parameters this rank updates, which are the only valid ones after
+// ReduceScatter, so the accumulation buffers only hold this rank's partition of the gradients.
+static Status AddGradientAccumulationForPartition(
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const std::vector<OptimizerNodeConfig>& opt_configs,
+    std::vector<ArgDef>& gradient_argdefs,
+    std::vector<size_t>& accumulated_indices,
+    std::vector<ArgDef>& gradient_accumulation_buffers,
+    GraphAugmenter::GraphDefs& graph_defs,
+    OptimizerOutputKeyMap<std::string>& optimizer_graph_outputs) {
+  std::vector<ArgDef> accumulated_gradients;
+  for (size_t i = 0; i < gradient_argdefs.size(); i++) {
+    if (opt_configs[i].enabled) {
+      accumulated_indices.push_back(i);
+      accumulated_gradients.push_back(gradient_argdefs[i]);
+    }
+  }
+  ORT_RETURN_IF(accumulated_gradients.empty(), "No parameter is partitioned to this rank.");
+
+  ArgDef group_accumulate_gradient_output =
+      AddGradientAccumulationNodes(nodearg_name_generator, accumulated_gradients, gradient_accumulation_buffers, graph_defs);
+  optimizer_graph_outputs[OptimizerOutputKey::GradientAccumulation] = group_accumulate_gradient_output.name;
+
+  for (size_t i = 0; i < accumulated_indices.size(); i++) {
+    gradient_argdefs[accumulated_indices[i]] = accumulated_gradients[i];
+  }
+
+  return Status::OK();
+}
+
+static Status AddZeroGradientForPartition(
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const std::vector<ArgDef>& weight_argdefs,
+    const std::vector<size_t>& accumulated_indices,
+    std::vector<ArgDef>& gradient_accumulation_buffers,
+    GraphAugmenter::GraphDefs& graph_defs) {
+  std::vector<ArgDef> control_signals;
+  for (size_t index : accumulated_indices) {
+    control_signals.push_back(weight_argdefs[index]);
+  }
+
+  return AddZeroGradientNodes(nodearg_name_generator, control_signals, gradient_accumulation_buffers, graph_defs);
+}
+
+// Replaces the initializer of a parameter by the elements [begin, begin + counts[rank]) this rank holds, and gathers
+// the full parameter from the partitions of all the ranks for each node consuming it. The gathers have a low
+// priority to run as late as possible, and each gathered parameter is freed once its consumer has run.
+static Status PartitionParameter(
+    Graph& graph,
+    GraphAugmenter::GraphDefs& graph_defs,
+    const std::string& name,
+    int64_t begin,
+    const std::vector<int64_t>& counts,
+    int rank) {
+  const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+  ORT_RETURN_IF_NOT(graph.GetInitializedTensor(name, initializer),
+                    "Partitioning parameters requires ", name, " to be an initializer.");
+
+  std::unique_ptr<uint8_t[]> data;
+  size_t data_size = 0;
+  ORT_RETURN_IF_ERROR(utils::UnpackInitializerData(*initializer, data, data_size));
+  const TensorShape shape(std::vector<int64_t>(initializer->dims().begin(), initializer->dims().end()));
+  const size_t element_size = shape.Size() > 0 ? data_size / shape.Size() : 0;
+  const int64_t count = counts[rank];
+
+  ONNX_NAMESPACE::TensorProto partition;
+  partition.set_name(name);
+  partition.set_data_type(initializer->data_type());
+  partition.add_dims(count);
+  partition.set_raw_data(data.get() + begin * element_size, count * element_size);
+  graph.RemoveInitializedTensor(name);
+  graph.AddInitializedTensor(partition);
+
+  NodeArg* node_arg = graph.GetNodeArg(name);
+  TypeProto* full_type_proto = graph_defs.CopyTypeProto(node_arg);
+  ONNX_NAMESPACE::TensorShapeProto partition_shape;
+  partition_shape.add_dim()->set_dim_value(count);
+  node_arg->SetShape(partition_shape);
+  const ArgDef partition_argdef(name, node_arg->TypeAsProto());
+
+  for (Node* consumer : graph.GetMutableConsumerNodes(name)) {
+    ArgDef gathered_argdef(graph.GenerateNodeArgName(name + "_AllGatherV_Out"), full_type_proto);
+    NodeDef gather_node(OpDef{"NcclAllGatherV", kMSDomain, 1},
+                        {partition_argdef},
+                        {gathered_argdef},
+                        std::vector<AttributeProto>({ONNX_NAMESPACE::MakeAttribute("counts", counts),
+                                                     ONNX_NAMESPACE::MakeAttribute("shape", shape.GetDims())}),
+                        gathered_argdef.name);
+    gather_node.priority = static_cast<int>(ExecutionPriority::LOCAL_LOW);
+    graph_defs.AddNodeDefs({gather_node});
+
+    NodeArg& gathered_arg = graph.GetOrCreateNodeArg(gathered_argdef.name, full_type_proto);
+    const auto& input_defs = consumer->InputDefs();
+    for (size_t i = 0; i < input_defs.size(); i++) {
+      if (input_defs[i]->Name() == name) {
+        graph_utils::ReplaceNodeInput(*consumer, static_cast<int>(i), gathered_arg);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 ZeROOptimizerGraphBuilder::ZeROOptimizerGraphBuilder(
     const OptimizerBuilderRegistry& opt_builder_registry,
     const OptimizerGraphConfig& opt_graph_config,
@@ -307,6 +418,11 @@ Status ZeROOptimizerGraphBuilder::BuildInternal(
     return graph.GenerateNodeArgName(base_name);
   };
 
+  if (opt_graph_config_.deepspeed_zero.stage >= 3) {
+    return BuildParameterPartitioning(graph, graph_defs, weight_argdefs, gradient_argdefs,
+                                      optimizer_state_initializer_names, optimizer_graph_outputs);
+  }
+
   // handle optimizer partitioning
   ORT_RETURN_IF_ERROR(ModifyParametersForOptimizerPartitioning(
       graph, graph_defs, opt_graph_config_, opt_configs_, weight_argdefs, gradient_argdefs));
@@ -322,6 +438,15 @@ Status ZeROOptimizerGraphBuilder::BuildInternal(
   // add Reducescatter for gradients
   ORT_RETURN_IF_ERROR(AddNcclReduceScatterForGradients(gradient_argdefs, graph_defs));
 
+  // add gradient accumulation of this rank's partition
+  std::vector<size_t> accumulated_indices;
+  std::vector<ArgDef> gradient_accumulation_buffers;
+  if (BuildsGradientAccumulation() && opt_graph_config_.gradient_accumulation_steps > 1) {
+    ORT_RETURN_IF_ERROR(AddGradientAccumulationForPartition(
+        nodearg_name_generator, opt_configs_, gradient_argdefs, accumulated_indices, gradient_accumulation_buffers,
+        graph_defs, optimizer_graph_outputs));
+  }
+
   // check if all gradients are finite
   ArgDef global_grad_norm_argdef;
   ArgDef global_grad_norm_finite_argdef;
@@ -346,11 +471,144 @@ Status ZeROOptimizerGraphBuilder::BuildInternal(
       opt_configs_, graph_defs,
       optimizer_state_initializer_names));
 
+  // add zero gradient
+  if (!gradient_accumulation_buffers.empty()) {
+    ORT_RETURN_IF_ERROR(AddZeroGradientForPartition(
+        nodearg_name_generator, weight_argdefs, accumulated_indices, gradient_accumulation_buffers, graph_defs));
+  }
+
   // add Allgather for weights
   ORT_RETURN_IF_ERROR(AddNcclAllGatherForWeights(weight_argdefs, graph_defs));
 
   return Status::OK();
 }
 
+Status ZeROOptimizerGraphBuilder::BuildParameterPartitioning(
+    Graph& graph,
+    GraphAugmenter::GraphDefs& graph_defs,
+    std::vector<ArgDef>& weight_argdefs,
+    std::vector<ArgDef>& gradient_argdefs,
+    std::unordered_set<std::string>& optimizer_state_initializer_names,
+    OptimizerOutputKeyMap<std::string>& optimizer_graph_outputs) {
+  auto nodearg_name_generator = [&graph](const std::string& base_name) {
+    return graph.GenerateNodeArgName(base_name);
+  };
+
+  ORT_ENFORCE(weight_argdefs.size() == gradient_argdefs.size());
+  ORT_ENFORCE(weight_argdefs.size() == opt_configs_.size());
+
+  // add gradient scaling and Reducescatter for the full gradients, which are partitioned as in stage 1
+  ArgDef fused_gradient_argdef;
+  const auto total_num_accumulations = opt_graph_config_.gradient_accumulation_steps * opt_graph_config_.data_parallel_group_size;
+  ORT_RETURN_IF_NOT(total_num_accumulations > 0);
+  const float scale = 1.0f / total_num_accumulations;
+  ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, gradient_argdefs, fused_gradient_argdef, graph_defs,
+                                              opt_graph_config_.AllReduceDataType(), false));
+  ORT_RETURN_IF_ERROR(AddNcclReduceScatterForGradients(gradient_argdefs, graph_defs));
+
+  int64_t total_count = 0;
+  for (const ArgDef& weight_argdef : weight_argdefs) {
+    ORT_ENFORCE(weight_argdef.type_proto != nullptr);
+    total_count += utils::GetTensorShapeFromTensorShapeProto(weight_argdef.type_proto->tensor_type().shape()).Size();
+  }
+
+  const int data_parallel_group_rank = opt_graph_config_.data_parallel_group_rank;
+  const int data_parallel_group_size = opt_graph_config_.data_parallel_group_size;
+  const int64_t rank_count = GetRankCount(total_count, data_parallel_group_size);
+
+  // Partition the parameters, and update the ones held by this rank with their partition of the gradients.
+  std::vector<OptimizerNodeConfig> new_opt_configs;
+  std::vector<ArgDef> new_weight_argdefs;
+  std::vector<ArgDef> new_gradient_argdefs;
+
+  int64_t offset = 0;
+  for (size_t i = 0; i < weight_argdefs.size(); i++) {
+    const std::string& weight_name = weight_argdefs[i].name;
+    const TensorShape weight_shape =
+        utils::GetTensorShapeFromTensorShapeProto(weight_argdefs[i].type_proto->tensor_type().shape());
+    const int64_t tensor_count = weight_shape.Size();
+
+    std::vector<int64_t> counts(data_parallel_group_size);
+    for (int rank = 0; rank < data_parallel_group_size; rank++) {
+      const int64_t rank_start = rank * rank_count;
+      const int64_t rank_end = rank_start + rank_count;
+      counts[rank] = std::max<int64_t>(0, std::min(offset + tensor_count, rank_end) - std::max(offset, rank_start));
+    }
+    const int64_t begin = std::min(std::max<int64_t>(0, data_parallel_group_rank * rank_count - offset), tensor_count);
+    const int64_t count = counts[data_parallel_group_rank];
+
+    const OptimizerNodeConfig& opt_config = opt_configs_[i];
+    ORT_RETURN_IF_ERROR(PartitionParameter(graph, graph_defs, weight_name, begin, counts, data_parallel_group_rank));
+    if (opt_config.mixed_precision_weight_arg != nullptr) {
+      ORT_RETURN_IF_ERROR(PartitionParameter(graph, graph_defs, opt_config.mixed_precision_weight_arg->Name(),
+                                             begin, counts, data_parallel_group_rank));
+    }
+
+    if (count > 0) {
+      // View the partitions of the previous ranks, this rank and the next ranks in the reduced gradient.
+      std::vector<TensorShape> view_shapes;
+      if (begin > 0) {
+        view_shapes.push_back({begin});
+      }
+      const size_t view_index = view_shapes.size();
+      view_shapes.push_back({count});
+      if (begin + count < tensor_count) {
+        view_shapes.push_back({tensor_count - begin - count});
+      }
+      std::vector<ArgDef> gradient_views = AddViewForParameter(graph_defs, gradient_argdefs[i], view_shapes);
+
+      new_opt_configs.push_back(opt_config);
+      new_weight_argdefs.emplace_back(weight_name, graph.GetNodeArg(weight_name)->TypeAsProto());
+      new_gradient_argdefs.push_back(gradient_views[view_index]);
+    }
+
+    offset += tensor_count;
+  }
+
+  opt_configs_ = std::move(new_opt_configs);
+  weight_argdefs = std::move(new_weight_argdefs);
+  gradient_argdefs = std::move(new_gradient_argdefs);
+
+  // add gradient accumulation of this rank's partition
+  std::vector<size_t> accumulated_indices;
+  std::vector<ArgDef> gradient_accumulation_buffers;
+  if (opt_graph_config_.gradient_accumulation_steps > 1) {
+    ORT_RETURN_IF_ERROR(AddGradientAccumulationForPartition(
+        nodearg_name_generator, opt_configs_, gradient_argdefs, accumulated_indices, gradient_accumulation_buffers,
+        graph_defs, optimizer_graph_outputs));
+  }
+
+  // check if all gradients are finite
+  ArgDef global_grad_norm_argdef;
+  ArgDef global_grad_norm_finite_argdef;
+  if (opt_graph_config_.use_mixed_precision) {
+    ORT_RETURN_IF_ERROR(AddGradientNorm(
+        nodearg_name_generator, gradient_argdefs, graph_defs, global_grad_norm_argdef));
+    optimizer_graph_outputs[OptimizerOutputKey::GlobalGradientNorm] = global_grad_norm_argdef.name;
+
+    ORT_RETURN_IF_ERROR(AddL2NormNcclAllReduce(global_grad_norm_argdef, graph_defs));
+
+    ORT_RETURN_IF_ERROR(AddFiniteGradientCheck(
+        nodearg_name_generator, {global_grad_norm_argdef}, graph_defs, global_grad_norm_finite_argdef));
+    optimizer_graph_outputs[OptimizerOutputKey::GradientAllIsFinite] = global_grad_norm_finite_argdef.name;
+  }
+
+  // add weight update of this rank's partition, which is gathered again by the next step
+  ORT_RETURN_IF_ERROR(AddDirectWeightUpdate(
+      opt_builder_registry_, weight_argdefs, gradient_argdefs,
+      &global_grad_norm_argdef,
+      &global_grad_norm_finite_argdef,
+      opt_configs_, graph_defs,
+      optimizer_state_initializer_names));
+
+  // add zero gradient
+  if (!gradient_accumulation_buffers.empty()) {
+    ORT_RETURN_IF_ERROR(AddZeroGradientForPartition(
+        nodearg_name_generator, weight_argdefs, accumulated_indices, gradient_accumulation_buffers, graph_defs));
+  }
+
+  return Status::OK();
+}
+
 }  // namespace training
 }  // namespace onnxruntime
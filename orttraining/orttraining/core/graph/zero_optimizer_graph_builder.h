@@ -23,6 +23,18 @@ class ZeROOptimizerGraphBuilder : public OptimizerGraphBuilder {
       std::vector<ArgDef>& gradient_argdefs,
       std::unordered_set<std::string>& optimizer_state_initializer_names,
       OptimizerOutputKeyMap<std::string>& optimizer_graph_outputs) override;
+
+  // From stage 2, only the gradients of this rank's partition are accumulated.
+  bool BuildsGradientAccumulation() const override { return opt_graph_config_.deepspeed_zero.stage >= 2; }
+
+ private:
+  Status BuildParameterPartitioning(
+      Graph& graph,
+      GraphAugmenter::GraphDefs& graph_defs,
+      std::vector<ArgDef>& weight_argdefs,
+      std::vector<ArgDef>& gradient_argdefs,
+      std::unordered_set<std::string>& optimizer_state_initializer_names,
+      OptimizerOutputKeyMap<std::string>& optimizer_graph_outputs);
 };
 
 }  // namespace training
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/core/optimizer/activation_offload.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/framework/session_options.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+struct OffloadCandidate {
+  const NodeArg* activation;
+  size_t size_in_bytes;
+  // the number of nodes between the last forward use and the first backward use
+  int lifetime;
+  std::vector<NodeIndex> backward_consumers;
+};
+
+bool IsBackward(const Node& node) {
+  return node.Description() == "Backward pass";
+}
+
+bool GetSizeInBytes(const NodeArg& node_arg, size_t& size_in_bytes) {
+  const auto* type_proto = node_arg.TypeAsProto();
+  if (type_proto == nullptr || !type_proto->has_tensor_type() || node_arg.Shape() == nullptr) {
+    return false;
+  }
+
+  const auto* tensor_type = DataTypeImpl::TypeFromProto(*type_proto)->AsTensorType();
+  if (tensor_type == nullptr || tensor_type->GetElementType() == nullptr) {
+    return false;
+  }
+
+  size_in_bytes = tensor_type->GetElementType()->Size();
+  for (const auto& dim : node_arg.Shape()->dim()) {
+    if (dim.has_dim_value()) {
+      size_in_bytes *= static_cast<size_t>(dim.dim_value());
+    }
+  }
+
+  return true;
+}
+
+void Offload(Graph& graph, const OffloadCandidate& candidate) {
+  const std::string& name = candidate.activation->Name();
+  NodeArg* activation = graph.GetNodeArg(name);
+
+  auto& host_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(name + "_offload"), activation->TypeAsProto());
+  Node& offload_node = graph.AddNode(graph.GenerateNodeName(name + "_offload"),
+                                     "MemcpyToHost",
+                                     "Offload of " + name,
+                                     {activation},
+                                     {&host_arg});
+  offload_node.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_HIGH));
+
+  auto& prefetched_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(name + "_prefetch"),
+                                                  activation->TypeAsProto());
+  Node& prefetch_node = graph.AddNode(graph.GenerateNodeName(name + "_prefetch"),
+                                      "MemcpyFromHost",
+                                      "Prefetch of " + name,
+                                      {&host_arg},
+                                      {&prefetched_arg});
+  prefetch_node.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_LOW));
+
+  for (NodeIndex consumer_index : candidate.backward_consumers) {
+    Node& consumer = *graph.GetNode(consumer_index);
+    const auto& input_defs = consumer.InputDefs();
+    for (size_t i = 0; i < input_defs.size(); ++i) {
+      if (input_defs[i]->Name() == name) {
+        graph_utils::ReplaceNodeInput(consumer, static_cast<int>(i), prefetched_arg);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+Status ActivationOffload::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::unordered_map<NodeIndex, int> positions;
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    positions[node_topology_list[i]] = static_cast<int>(i);
+  }
+
+  const auto& graph_outputs = graph.GetOutputs();
+  const std::unordered_set<const NodeArg*> graph_output_set(graph_outputs.begin(), graph_outputs.end());
+
+  // find the forward activations used by the backward pass
+  std::vector<OffloadCandidate> candidates;
+  for (NodeIndex node_index : node_topology_list) {
+    const Node& node = *graph.GetNode(node_index);
+    if (IsBackward(node)) {
+      continue;
+    }
+
+    for (const NodeArg* output : node.OutputDefs()) {
+      size_t size_in_bytes = 0;
+      if (!output->Exists() || graph_output_set.find(output) != graph_output_set.end() ||
+          !GetSizeInBytes(*output, size_in_bytes) || size_in_bytes < min_size_in_bytes_) {
+        continue;
+      }
+
+      int last_forward_use = positions.at(node_index);
+      int first_backward_use = std::numeric_limits<int>::max();
+      std::vector<NodeIndex> backward_consumers;
+      for (const Node* consumer : graph.GetConsumerNodes(output->Name())) {
+        const int position = positions.at(consumer->Index());
+        if (IsBackward(*consumer)) {
+          backward_consumers.push_back(consumer->Index());
+          first_backward_use = std::min(first_backward_use, position);
+        } else {
+          last_forward_use = std::max(last_forward_use, position);
+        }
+      }
+
+      if (backward_consumers.empty() || first_backward_use - last_forward_use < min_lifetime_) {
+        continue;
+      }
+
+      candidates.push_back({output, size_in_bytes, first_backward_use - last_forward_use, backward_consumers});
+    }
+  }
+
+  // the activations stashed for longest save memory for most of the backward pass
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const OffloadCandidate& a, const OffloadCandidate& b) { return a.lifetime > b.lifetime; });
+
+  size_t offloaded_size_in_bytes = 0;
+  int offloaded_count = 0;
+  for (const OffloadCandidate& candidate : candidates) {
+    if (max_size_in_bytes_ > 0 && offloaded_size_in_bytes + candidate.size_in_bytes > max_size_in_bytes_) {
+      continue;
+    }
+
+    Offload(graph, candidate);
+    offloaded_size_in_bytes += candidate.size_in_bytes;
+    ++offloaded_count;
+  }
+
+  LOGS(logger, INFO) << "Offloading " << offloaded_count << " of " << candidates.size()
+                     << " stashed activations to host memory, " << offloaded_size_in_bytes << " bytes.";
+
+  modified = offloaded_count > 0;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ActivationOffload
+
+Offloads the activations stashed for the backward pass to pinned host memory, to train models whose activations
+don't fit in device memory even with recompute. It is applied to the training graph once the backward pass has
+been built.
+
+An activation is offloaded with a MemcpyToHost node which runs as soon as it is produced, so its device memory is
+freed after its last forward use, and a MemcpyFromHost node which runs as late as possible, before its backward
+consumers. The copies run on the copy streams of the CUDA execution provider, unless it copies in the default stream.
+*/
+class ActivationOffload : public GraphTransformer {
+ public:
+  /**
+   * @param min_size_in_bytes Activations smaller than this are kept on the device. Symbolic dimensions count as 1.
+   * @param min_lifetime Activations used by the backward pass fewer than min_lifetime nodes after their last forward
+   *        use are kept on the device.
+   * @param max_size_in_bytes The limit of the total size of the offloaded activations, 0 for no limit. Activations
+   *        stashed for longer, i.e. those of the first layers, are offloaded first.
+   */
+  ActivationOffload(size_t min_size_in_bytes, int min_lifetime, size_t max_size_in_bytes,
+                    const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ActivationOffload", compatible_execution_providers),
+        min_size_in_bytes_(min_size_in_bytes),
+        min_lifetime_(min_lifetime),
+        max_size_in_bytes_(max_size_in_bytes) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+ private:
+  size_t min_size_in_bytes_;
+  int min_lifetime_;
+  size_t max_size_in_bytes_;
+};
+
+}  // namespace onnxruntime
@@ -1,11 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "core/common/logging/logging.h"
+#include "core/common/make_unique.h"
 #include "core/graph/op.h"
 #include "core/optimizer/rewrite_rule.h"
 #include "orttraining/core/optimizer/gist_encode_decode.h"
 #include "core/graph/graph_utils.h"
+#include "onnx/defs/attr_proto_util.h"
 
 namespace onnxruntime {
 struct GraphEdgeHelper {
@@ -33,7 +38,7 @@ struct GraphEdgeHelper {
                                  edge_end.GetNode().Index(),
                                  edge_end.GetSrcArgIndex(),
                                  edge_end.GetDstArgIndex(),
-                                 node.InputDefs()[edge_end.GetSrcArgIndex()]->Name());
+                                 node.OutputDefs()[edge_end.GetSrcArgIndex()]->Name());
   }
 };
 
@@ -103,8 +108,116 @@ bool GistEncodeDecode::AddEncodeDecode(Graph& graph, Node& curr_node, std::strin
   }
   return true;
 }
+bool GistEncodeDecode::AddPack16EncodeDecode(Graph& graph, Node& curr_node, bool use_bfloat16) const {
+  NodeArg* activation = curr_node.MutableOutputDefs()[0];
+  const auto* type_proto = activation->TypeAsProto();
+  if (type_proto == nullptr || !type_proto->has_tensor_type() ||
+      type_proto->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  std::vector<GraphEdgeHelper> forward_edges;
+  std::vector<GraphEdgeHelper> backward_edges;
+  for (const auto& output_edge : GetNodeOutputEdges(curr_node)) {
+    if (output_edge.src_arg_index != 0) {
+      continue;
+    }
+    if (graph.GetNode(output_edge.dst_node)->Description() == "Backward pass") {
+      backward_edges.push_back(output_edge);
+    } else {
+      forward_edges.push_back(output_edge);
+    }
+  }
+  if (backward_edges.empty()) {
+    return false;
+  }
+
+  const auto compressed_elem_type = use_bfloat16 ? ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16
+                                                 : ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+  ONNX_NAMESPACE::TypeProto compressed_type(*type_proto);
+  compressed_type.mutable_tensor_type()->set_elem_type(compressed_elem_type);
+
+  std::string encode_node_name = graph.GenerateNodeName(GIST_ENCODER_NODE_NAME_BASE);
+  auto& encode_output_def_compressed_arg = graph.GetOrCreateNodeArg(encode_node_name, &compressed_type);
+  auto& encode_output_def_uncompressed_arg = graph.GetOrCreateNodeArg(encode_node_name + "_identity", type_proto);
+  NodeAttributes encode_attributes;
+  encode_attributes["to"] = ONNX_NAMESPACE::MakeAttribute("to", static_cast<int64_t>(compressed_elem_type));
+  auto& encode = graph.AddNode(encode_node_name, "GistPack16Encoder", "Encode", {activation},
+                               {&encode_output_def_uncompressed_arg, &encode_output_def_compressed_arg},
+                               &encode_attributes, kMSDomain);
+
+  // Delay the decoding until another input of a backward consumer is ready, so the uncompressed
+  // activation is only alive while it is used. That input must not depend on any backward consumer,
+  // otherwise the decoder would form a cycle.
+  std::unordered_set<NodeIndex> backward_consumers;
+  for (const auto& output_edge : backward_edges) {
+    backward_consumers.insert(output_edge.dst_node);
+  }
+  auto depends_on_backward_consumer = [&graph, &backward_consumers](NodeIndex node_index) {
+    bool found = false;
+    graph.ReverseDFSFrom(
+        std::vector<NodeIndex>{node_index},
+        [&backward_consumers, &found](const Node* n) {
+          found = found || backward_consumers.count(n->Index()) > 0;
+        },
+        nullptr);
+    return found;
+  };
+
+  NodeArg* late_decoding_arg = nullptr;
+  std::unique_ptr<GraphEdgeHelper> late_decoding_edge;
+  for (size_t i = 0; late_decoding_arg == nullptr && i < backward_edges.size(); ++i) {
+    Node* node_dst = graph.GetNode(backward_edges[i].dst_node);
+    for (const auto& input_edge : GetNodeInputEdges(*node_dst)) {
+      if (input_edge.src_node != curr_node.Index() && !depends_on_backward_consumer(input_edge.src_node)) {
+        late_decoding_arg = node_dst->MutableInputDefs()[input_edge.dst_arg_index];
+        late_decoding_edge = onnxruntime::make_unique<GraphEdgeHelper>(input_edge);
+        break;
+      }
+    }
+  }
+
+  std::string decode_arg_name = graph.GenerateNodeName(GIST_DECODER_NODE_NAME_BASE);
+  auto& decode_output_def_uncompressed_arg = graph.GetOrCreateNodeArg(decode_arg_name, type_proto);
+  NodeAttributes decode_attributes;
+  decode_attributes["to"] = ONNX_NAMESPACE::MakeAttribute(
+      "to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  std::vector<NodeArg*> decode_inputs{late_decoding_arg, &encode_output_def_compressed_arg};
+  if (late_decoding_arg == nullptr) {
+    decode_inputs[0] = &graph.GetOrCreateNodeArg("", nullptr);
+  }
+  auto& decode = graph.AddNode(decode_arg_name, "GistPack16Decoder", "Decode", decode_inputs,
+                               {&decode_output_def_uncompressed_arg}, &decode_attributes, kMSDomain);
+
+  for (const auto& output_edge : forward_edges) {
+    graph.RemoveEdge(output_edge.src_node, output_edge.dst_node, output_edge.src_arg_index, output_edge.dst_arg_index);
+    graph.AddEdge(encode.Index(), output_edge.dst_node, 0, output_edge.dst_arg_index);
+  }
+  for (const auto& output_edge : backward_edges) {
+    graph.RemoveEdge(output_edge.src_node, output_edge.dst_node, output_edge.src_arg_index, output_edge.dst_arg_index);
+    graph.AddEdge(decode.Index(), output_edge.dst_node, 0, output_edge.dst_arg_index);
+  }
+  graph.AddEdge(curr_node.Index(), encode.Index(), 0, 0);
+  graph.AddEdge(encode.Index(), decode.Index(), 1, 1);
+  if (late_decoding_edge != nullptr) {
+    graph.AddEdge(late_decoding_edge->src_node, decode.Index(), late_decoding_edge->src_arg_index, 0);
+  }
+  return true;
+}
+
 Status GistEncodeDecode::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& /*logger*/) const {
-  if (GistEncodeDecode::AddEncodeDecode(graph, node, "GistBinarize")) {
+  const std::string& compression_type = op_type_to_compression_type_.at(node.OpType());
+  bool modified = false;
+  if (compression_type == GIST_BINARIZE) {
+    modified = AddEncodeDecode(graph, node, compression_type);
+  } else if (compression_type == GIST_PACK16 || compression_type == GIST_PACK_BF16) {
+    modified = AddPack16EncodeDecode(graph, node, compression_type == GIST_PACK_BF16);
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported Gist compression type ", compression_type,
+                           " for op type ", node.OpType());
+  }
+
+  if (modified) {
     rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
   }
 
@@ -112,7 +225,20 @@ Status GistEncodeDecode::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule
 }
 
 bool GistEncodeDecode::SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger& logger) const {
-  return graph_utils::CanRemoveNode(graph, node, logger);
+  // skip the nodes whose output is already encoded
+  for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+    if (it->OpType() == "GistBinarizeEncoder" || it->OpType() == "GistPack16Encoder") {
+      return false;
+    }
+  }
+
+  if (op_type_to_compression_type_.at(node.OpType()) == GIST_BINARIZE) {
+    return graph_utils::CanRemoveNode(graph, node, logger);
+  }
+
+  // the packed output is rewired to the encoder and the decoder, so it must not be a graph output
+  const auto graph_outputs = graph.GetNodeOutputsInGraphOutputs(node);
+  return std::find(graph_outputs.begin(), graph_outputs.end(), 0) == graph_outputs.end();
 }
 
 }  // namespace onnxruntime
@@ -3,26 +3,44 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "core/optimizer/rewrite_rule.h"
 
 namespace onnxruntime {
 
 /**
-@Class GistEncode
+@Class GistEncodeDecode
 
-Rewrite rule that encode when Relu is found.
+Rewrite rule that compresses the activations stashed for the backward pass.
 
-It is attempted to be triggered only on nodes with op type "Relu".
+It is attempted to be triggered only on nodes whose op type is in its compression policy,
+which maps an op type to the compression type applied to its output:
+  - GIST_BINARIZE: lossless boolean encoding of Relu outputs used by ReluGrad.
+  - GIST_PACK16: lossy float16 packing of float outputs used by any backward node.
+  - GIST_PACK_BF16: lossy bfloat16 packing of float outputs used by any backward node.
+The default policy is {"Relu": GIST_BINARIZE}.
 */
 class GistEncodeDecode : public RewriteRule {
  public:
   static constexpr const char* GIST_ENCODER_NODE_NAME_BASE = "gist_encode";
   static constexpr const char* GIST_DECODER_NODE_NAME_BASE = "gist_decode";
 
-  GistEncodeDecode() noexcept : RewriteRule("GistEncodeDecode") {}
+  static constexpr const char* GIST_BINARIZE = "GistBinarize";
+  static constexpr const char* GIST_PACK16 = "GistPack16";
+  static constexpr const char* GIST_PACK_BF16 = "GistPackBf16";
+
+  GistEncodeDecode() : GistEncodeDecode({{"Relu", GIST_BINARIZE}}) {}
+
+  explicit GistEncodeDecode(const std::unordered_map<std::string, std::string>& op_type_to_compression_type)
+      : RewriteRule("GistEncodeDecode"), op_type_to_compression_type_(op_type_to_compression_type) {}
 
   std::vector<std::string> TargetOpTypes() const noexcept override {
-    return {"Relu"};
+    std::vector<std::string> op_types;
+    for (const auto& entry : op_type_to_compression_type_) {
+      op_types.push_back(entry.first);
+    }
+    return op_types;
   }
 
  private:
@@ -30,6 +48,9 @@ class GistEncodeDecode : public RewriteRule {
 
   Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& logger) const override;
   bool AddEncodeDecode(Graph& graph, Node& curr_node, std::string compression_type) const;
+  bool AddPack16EncodeDecode(Graph& graph, Node& curr_node, bool use_bfloat16) const;
+
+  std::unordered_map<std::string, std::string> op_type_to_compression_type_;
 };
 
-}
\ No newline at end of file
+}  // namespace onnxruntime
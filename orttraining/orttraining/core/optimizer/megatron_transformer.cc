@@ -8,6 +8,8 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/random_seed.h"
 #include <deque>
+#include <tuple>
+#include <unordered_map>
 
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
@@ -629,6 +631,316 @@ Status MegatronTransformer::TransformDropout(Graph& graph, bool& modified, int g
   return Status::OK();
 }
 
+// The sequence dimension of [batch, sequence, hidden] activations.
+static constexpr int64_t kSequenceAxis = 1;
+
+// Checks whether a node can be computed on chunks of the sequence, given the rank of its sharded inputs.
+// 'reduced_inputs' are the inputs which the node broadcasts along the sequence, if any, whose gradients only cover
+// this rank's chunk and must be summed over the group.
+static bool IsSequenceShardable(const Node& node, int64_t rank, std::vector<int>& reduced_inputs) {
+  reduced_inputs.clear();
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", opset_v7_13)) {
+    reduced_inputs = {0, 1};
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LayerNormalization", {1}, kOnnxDomain)) {
+    const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+    const int64_t axis = axis_attr != nullptr ? axis_attr->i() : -1;
+    if ((axis < 0 ? axis + rank : axis) <= kSequenceAxis) {
+      return false;
+    }
+    reduced_inputs = {1, 2};
+    return true;
+  }
+
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Dropout", opset_v12_13) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "TrainableDropout", opset_v9, kOnnxDomain) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Identity", {1, 13});
+}
+
+static bool IsMegatronCollectiveType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return false;
+  }
+  const auto elem_type = type->tensor_type().elem_type();
+  return elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+         elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 ||
+         elem_type == ONNX_NAMESPACE::TensorProto_DataType_DOUBLE;
+}
+
+static ONNX_NAMESPACE::TensorShapeProto ShardShape(const ONNX_NAMESPACE::TensorShapeProto& shape, int64_t axis,
+                                                   int64_t size) {
+  ONNX_NAMESPACE::TensorShapeProto result = shape;
+  auto* dim = result.mutable_dim(static_cast<int>(axis));
+  if (utils::HasDimValue(*dim)) {
+    dim->set_dim_value(dim->dim_value() / size);
+  } else if (utils::HasDimParam(*dim)) {
+    // Keep the chunks of the same dimension symbolically equal, for the fusions matching on shapes.
+    dim->set_dim_param(dim->dim_param() + "_shard_" + std::to_string(size));
+  }
+  return result;
+}
+
+static bool IsDivisible(const ONNX_NAMESPACE::TensorShapeProto& shape, int64_t axis, int64_t size) {
+  return axis < shape.dim_size() &&
+         (!utils::HasDimValue(shape.dim(static_cast<int>(axis))) ||
+          shape.dim(static_cast<int>(axis)).dim_value() % size == 0);
+}
+
+// Adds a node between a consumer and its input, which becomes the node's only input.
+static Node& InsertNodeBefore(Graph& graph, Node& consumer, int input_index, const std::string& op_type,
+                              NodeArg& output_arg) {
+  NodeArg* input_arg = consumer.MutableInputDefs()[input_index];
+  Node& node = graph.AddNode(graph.GenerateNodeName("SequenceParallel_" + op_type),
+                             op_type,
+                             "Sequence parallel " + op_type,
+                             {input_arg},
+                             {&output_arg}, {}, kMSDomain);
+  node.SetExecutionProviderType(consumer.GetExecutionProviderType());
+
+  const Node::EdgeEnd* edge = graph_utils::GetInputEdge(consumer, input_index);
+  if (edge != nullptr) {
+    const NodeIndex src_node_index = edge->GetNode().Index();
+    const int src_arg_index = edge->GetSrcArgIndex();
+    graph.RemoveEdge(src_node_index, consumer.Index(), src_arg_index, input_index);
+    graph.AddEdge(src_node_index, node.Index(), src_arg_index, 0);
+  }
+  graph_utils::ReplaceNodeInput(consumer, input_index, output_arg);
+  graph.AddEdge(node.Index(), consumer.Index(), 0, input_index);
+  return node;
+}
+
+// Replaces a node by a sequence parallel collective with the same inputs and outputs.
+static Node& ReplaceBySequenceParallelOp(Graph& graph, Node& node, const std::string& op_type) {
+  Node& replacement = graph.AddNode(graph.GenerateNodeName("SequenceParallel_" + op_type),
+                                    op_type,
+                                    "Sequence parallel " + op_type,
+                                    node.MutableInputDefs(),
+                                    node.MutableOutputDefs(), {}, kMSDomain);
+  replacement.AddAttribute("group_type", static_cast<int64_t>(training::WorkerGroupType::HorizontalParallel));
+  replacement.AddAttribute("axis", kSequenceAxis);
+  replacement.SetExecutionProviderType(node.GetExecutionProviderType());
+  graph_utils::FinalizeNodeFusion(graph, std::vector<std::reference_wrapper<Node>>{node}, replacement);
+  return replacement;
+}
+
+Status MegatronTransformer::TransformSequenceParallel(
+    Graph& graph, bool& modified, const logging::Logger& logger,
+    std::vector<NodeArg*>& sharded_args,
+    std::vector<std::pair<NodeArg*, ONNX_NAMESPACE::TensorShapeProto>>& sharded_shapes,
+    std::unordered_set<Node*>& sharded_dropout_nodes) const {
+  // Plan the whole transform first, so the graph is left untouched if any part of it isn't supported.
+  std::vector<Node*> g_nodes;
+  GraphViewer graph_viewer(graph);
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node& node = *graph.GetNode(node_index);
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MegatronG", {1}, kMSDomain) &&
+        graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      g_nodes.push_back(&node);
+    }
+  }
+  if (g_nodes.empty()) {
+    return Status::OK();
+  }
+
+  auto skip = [&logger](const std::string& reason) {
+    LOGS(logger, WARNING) << "Sequence parallelism is not applied: " << reason;
+    return Status::OK();
+  };
+
+  const auto& graph_outputs = graph.GetOutputs();
+  std::unordered_set<const NodeArg*> sharded_arg_set;
+  std::vector<NodeArg*> planned_sharded_args;
+  std::unordered_map<const Node*, int64_t> sharded_node_ranks;
+  std::vector<Node*> sharded_nodes;
+  std::vector<Node*> f_nodes;
+  // The sharded args with other consumers, which get the gathered tensor.
+  std::vector<std::pair<NodeArg*, std::vector<std::pair<Node*, int>>>> gathered_args;
+  std::deque<std::pair<Node*, int>> to_visit;
+
+  auto add_sharded_output = [&](Node& node, int output_index) {
+    NodeArg* arg = node.MutableOutputDefs()[output_index];
+    if (arg->Exists() && sharded_arg_set.insert(arg).second) {
+      planned_sharded_args.push_back(arg);
+      to_visit.emplace_back(&node, output_index);
+    }
+  };
+
+  for (Node* g_node : g_nodes) {
+    const auto* shape = g_node->OutputDefs()[0]->Shape();
+    if (shape == nullptr || !IsDivisible(*shape, kSequenceAxis, horizontal_parallel_size_)) {
+      return skip("the sequence length of " + g_node->Name() + " is unknown or not divisible by the group size.");
+    }
+    add_sharded_output(*g_node, 0);
+  }
+
+  while (!to_visit.empty()) {
+    Node& producer = *to_visit.front().first;
+    const int output_index = to_visit.front().second;
+    to_visit.pop_front();
+    NodeArg* arg = producer.MutableOutputDefs()[output_index];
+    if (std::find(graph_outputs.begin(), graph_outputs.end(), arg) != graph_outputs.end()) {
+      return skip(arg->Name() + " is a graph output.");
+    }
+    if (arg->Shape() == nullptr) {
+      return skip("the shape of " + arg->Name() + " is unknown.");
+    }
+    const int64_t rank = arg->Shape()->dim_size();
+
+    std::vector<std::pair<Node*, int>> other_consumers;
+    for (auto it = producer.OutputEdgesBegin(); it != producer.OutputEdgesEnd(); ++it) {
+      if (it->GetSrcArgIndex() != output_index) {
+        continue;
+      }
+      Node& consumer = *graph.GetNode(it->GetNode().Index());
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "MegatronF", {1}, kMSDomain)) {
+        if (std::find(f_nodes.begin(), f_nodes.end(), &consumer) == f_nodes.end()) {
+          f_nodes.push_back(&consumer);
+        }
+        continue;
+      }
+      if (sharded_node_ranks.count(&consumer) > 0) {
+        continue;
+      }
+
+      std::vector<int> reduced_inputs;
+      if (consumer.GetExecutionProviderType() == producer.GetExecutionProviderType() &&
+          IsSequenceShardable(consumer, rank, reduced_inputs)) {
+        sharded_node_ranks[&consumer] = rank;
+        sharded_nodes.push_back(&consumer);
+        for (int i = 0; i < static_cast<int>(consumer.OutputDefs().size()); ++i) {
+          add_sharded_output(consumer, i);
+        }
+      } else {
+        other_consumers.emplace_back(&consumer, it->GetDstArgIndex());
+      }
+    }
+
+    if (!other_consumers.empty()) {
+      if (!IsMegatronCollectiveType(*arg)) {
+        return skip(arg->Name() + " has an unsupported type to gather.");
+      }
+      gathered_args.emplace_back(arg, std::move(other_consumers));
+    }
+  }
+
+  // The unsharded inputs of the sharded nodes are either broadcast along the sequence, or replicated on every rank
+  // and sliced.
+  std::vector<std::pair<Node*, int>> reduced_inputs_to_add;
+  std::vector<std::tuple<Node*, int, int64_t>> sliced_inputs;
+  for (Node* node : sharded_nodes) {
+    const int64_t rank = sharded_node_ranks[node];
+    std::vector<int> reduced_inputs;
+    IsSequenceShardable(*node, rank, reduced_inputs);
+    for (int i = 0; i < static_cast<int>(node->InputDefs().size()); ++i) {
+      const NodeArg* input = node->InputDefs()[i];
+      if (!input->Exists() || sharded_arg_set.count(input) > 0) {
+        continue;
+      }
+      if (input->Shape() == nullptr) {
+        return skip("the shape of " + input->Name() + " is unknown.");
+      }
+
+      const auto& shape = *input->Shape();
+      const int64_t axis = kSequenceAxis - (rank - shape.dim_size());
+      const bool is_broadcast = axis < 0 ||
+                                (utils::HasDimValue(shape.dim(static_cast<int>(axis))) &&
+                                 shape.dim(static_cast<int>(axis)).dim_value() == 1);
+      if (is_broadcast) {
+        if (std::find(reduced_inputs.begin(), reduced_inputs.end(), i) != reduced_inputs.end()) {
+          if (!IsMegatronCollectiveType(*input)) {
+            return skip(input->Name() + " has an unsupported type to reduce.");
+          }
+          reduced_inputs_to_add.emplace_back(node, i);
+        }
+      } else {
+        if (!IsMegatronCollectiveType(*input) || !IsDivisible(shape, axis, horizontal_parallel_size_)) {
+          return skip(input->Name() + " can't be sliced.");
+        }
+        sliced_inputs.emplace_back(node, i, axis);
+      }
+    }
+  }
+
+  // Apply the plan.
+  sharded_args.insert(sharded_args.end(), planned_sharded_args.begin(), planned_sharded_args.end());
+  for (auto& gathered_arg : gathered_args) {
+    NodeArg* arg = gathered_arg.first;
+    auto type_info = *arg->TypeAsProto();
+    auto& gather_out_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("SequenceParallel_MegatronAllGather_Output"),
+                                                    &type_info);
+    auto& consumers = gathered_arg.second;
+    Node& gather_node = InsertNodeBefore(graph, *consumers[0].first, consumers[0].second, "MegatronAllGather",
+                                         gather_out_arg);
+    gather_node.AddAttribute("group_type", static_cast<int64_t>(training::WorkerGroupType::HorizontalParallel));
+    gather_node.AddAttribute("axis", kSequenceAxis);
+    gather_node.AddAttribute("reduce_gradient", static_cast<int64_t>(0));
+    for (size_t i = 1; i < consumers.size(); ++i) {
+      Node& consumer = *consumers[i].first;
+      const int input_index = consumers[i].second;
+      const Node::EdgeEnd* edge = graph_utils::GetInputEdge(consumer, input_index);
+      ORT_ENFORCE(edge != nullptr);
+      graph.RemoveEdge(edge->GetNode().Index(), consumer.Index(), edge->GetSrcArgIndex(), input_index);
+      graph_utils::ReplaceNodeInput(consumer, input_index, gather_out_arg);
+      graph.AddEdge(gather_node.Index(), consumer.Index(), 0, input_index);
+    }
+  }
+
+  for (auto& sliced_input : sliced_inputs) {
+    Node& node = *std::get<0>(sliced_input);
+    const int input_index = std::get<1>(sliced_input);
+    const int64_t axis = std::get<2>(sliced_input);
+    NodeArg* input = node.MutableInputDefs()[input_index];
+    auto type_info = *input->TypeAsProto();
+    *type_info.mutable_tensor_type()->mutable_shape() = ShardShape(*input->Shape(), axis, horizontal_parallel_size_);
+    auto& slice_out_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("SequenceParallel_MegatronSlice_Output"),
+                                                   &type_info);
+    Node& slice_node = InsertNodeBefore(graph, node, input_index, "MegatronSlice", slice_out_arg);
+    slice_node.AddAttribute("group_type", static_cast<int64_t>(training::WorkerGroupType::HorizontalParallel));
+    slice_node.AddAttribute("axis", axis);
+  }
+
+  // MegatronF sums the gradients of the parameters over the group, as each rank only sees its chunk.
+  for (auto& reduced_input : reduced_inputs_to_add) {
+    NodeArg* input = reduced_input.first->MutableInputDefs()[reduced_input.second];
+    auto type_info = *input->TypeAsProto();
+    auto& f_out_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("SequenceParallel_MegatronF_Output"),
+                                               &type_info);
+    InsertNodeBefore(graph, *reduced_input.first, reduced_input.second, "MegatronF", f_out_arg);
+  }
+
+  for (Node* g_node : g_nodes) {
+    NodeArg* output = g_node->MutableOutputDefs()[0];
+    sharded_shapes.emplace_back(output, ShardShape(*output->Shape(), kSequenceAxis, horizontal_parallel_size_));
+    ReplaceBySequenceParallelOp(graph, *g_node, "MegatronReduceScatter");
+  }
+
+  for (Node* f_node : f_nodes) {
+    NodeArg* output = f_node->MutableOutputDefs()[0];
+    const auto* full_shape = f_node->InputDefs()[0]->Shape();
+    if (full_shape != nullptr) {
+      sharded_shapes.emplace_back(output, *full_shape);
+    }
+    Node& gather_node = ReplaceBySequenceParallelOp(graph, *f_node, "MegatronAllGather");
+    gather_node.AddAttribute("reduce_gradient", static_cast<int64_t>(1));
+  }
+
+  for (Node* node : sharded_nodes) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Dropout", opset_v12_13) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(*node, "TrainableDropout", opset_v9, kOnnxDomain)) {
+      sharded_dropout_nodes.insert(node);
+    }
+  }
+
+  LOGS(logger, INFO) << "Sequence parallelism shards " << sharded_nodes.size() << " nodes after " << g_nodes.size()
+                     << " MegatronG nodes.";
+  modified = true;
+  return Status::OK();
+}
+
 Status MegatronTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   if (horizontal_parallel_size_ <= 1) {
     return Status::OK();
@@ -639,6 +951,16 @@ Status MegatronTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_le
 
   ORT_ENFORCE(TransformMLP(graph, modified, graph_level, logger, nodes_to_clear_shape).IsOK());
   ORT_ENFORCE(TransformSelfAttention(graph, modified, graph_level, logger, nodes_to_clear_shape, self_attention_dropout_nodes).IsOK());
+
+  // The dropouts on chunks of the sequence need different masks on each rank, like the self attention ones.
+  std::vector<NodeArg*> sharded_args;
+  std::vector<std::pair<NodeArg*, ONNX_NAMESPACE::TensorShapeProto>> sharded_shapes;
+  if (sequence_parallel_) {
+    ORT_ENFORCE(TransformSequenceParallel(graph, modified, logger, sharded_args, sharded_shapes,
+                                          self_attention_dropout_nodes)
+                    .IsOK());
+  }
+
   ORT_ENFORCE(TransformDropout(graph, modified, graph_level, logger, self_attention_dropout_nodes).IsOK());
 
   auto& graph_inputs = graph.GetInputs();
@@ -653,6 +975,13 @@ Status MegatronTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_le
         output->ClearShape();
   }
 
+  for (auto* arg : sharded_args) {
+    arg->ClearShape();
+  }
+  for (auto& sharded_shape : sharded_shapes) {
+    sharded_shape.first->SetShape(sharded_shape.second);
+  }
+
   if (modified) {
     graph.SetGraphResolveNeeded();
     auto ret = graph.Resolve();
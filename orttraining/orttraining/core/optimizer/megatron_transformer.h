@@ -11,10 +11,12 @@ namespace onnxruntime {
 class MegatronTransformer : public GraphTransformer {
  public:
   MegatronTransformer(int32_t horizontal_parallel_rank, int32_t horizontal_parallel_size,
-                      const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+                      const std::unordered_set<std::string>& compatible_execution_providers = {},
+                      bool sequence_parallel = false) noexcept
       : GraphTransformer("MegatronTransformer", compatible_execution_providers),
         horizontal_parallel_rank_(horizontal_parallel_rank),
-        horizontal_parallel_size_(horizontal_parallel_size) {}
+        horizontal_parallel_size_(horizontal_parallel_size),
+        sequence_parallel_(sequence_parallel) {}
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level,
                    const logging::Logger& logger) const override;
@@ -30,6 +32,15 @@ class MegatronTransformer : public GraphTransformer {
   Status TransformDropout(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger,
                           std::unordered_set<Node*>& self_attention_dropout_nodes) const;
 
+  // Shards the sequence dimension of the activations between the row parallel and the column parallel MatMuls,
+  // e.g. bias, dropout, residual and LayerNorm, which are otherwise computed redundantly on every rank.
+  // MegatronG becomes a MegatronReduceScatter, and the following MegatronF a MegatronAllGather.
+  // The shapes of the sharded tensors are cleared, and 'sharded_shapes' holds the ones to set afterwards.
+  Status TransformSequenceParallel(Graph& graph, bool& modified, const logging::Logger& logger,
+                                   std::vector<NodeArg*>& sharded_args,
+                                   std::vector<std::pair<NodeArg*, ONNX_NAMESPACE::TensorShapeProto>>& sharded_shapes,
+                                   std::unordered_set<Node*>& sharded_dropout_nodes) const;
+
   bool PartitionWeightByColumn(const Graph& graph, const NodeArg& input_arg,
                                ONNX_NAMESPACE::TensorProto& initializer_partition, int stride = 1) const;
 
@@ -38,6 +49,7 @@ class MegatronTransformer : public GraphTransformer {
 
   const int32_t horizontal_parallel_rank_;
   const int32_t horizontal_parallel_size_;
+  const bool sequence_parallel_;
 };
 
 }  // namespace onnxruntime
@@ -23,6 +23,7 @@
 
 //Gist Encoding
 #include "orttraining/core/optimizer/gist_encode_decode.h"
+#include "orttraining/core/optimizer/activation_offload.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_common.h"
@@ -81,6 +82,8 @@ Status SetupOptimizerParams(
   opt_graph_config.use_mixed_precision = config.mixed_precision_config.has_value();
   if (opt_graph_config.use_mixed_precision) {
     opt_graph_config.mixed_precision_type = config.mixed_precision_config.value().mixed_precision_type;
+    opt_graph_config.use_device_loss_scaling =
+        loss_scale_input_name.has_value() && config.mixed_precision_config.value().use_device_loss_scaling;
   }
 
   // TODO make OptimizerGraphConfig::loss_scale_input_name optional<string>
@@ -94,6 +97,7 @@ Status SetupOptimizerParams(
   opt_graph_config.gradient_accumulation_steps = config.gradient_accumulation_steps;
   opt_graph_config.allreduce_in_mixed_precision_type = optimizer_config.do_all_reduce_in_mixed_precision_type;
   opt_graph_config.use_nccl = optimizer_config.use_nccl;
+  opt_graph_config.allreduce_bucket_size_in_bytes = optimizer_config.allreduce_bucket_size_in_bytes;
   opt_graph_config.adasum_reduction_type = optimizer_config.adasum_reduction_type;
   opt_graph_config.enable_grad_norm_clip = optimizer_config.enable_grad_norm_clip;
 #if USE_HOROVOD
@@ -191,6 +195,15 @@ Status TrainingSession::ConfigureForTraining(
                             (pipeline_stage_id + 1 == config.distributed_config.pipeline_parallel_size));
   optional<std::string> loss_scale_input_name =
       enable_loss_scale ? optional<std::string>{""} : optional<std::string>{};
+  if (enable_loss_scale && config.mixed_precision_config.value().use_device_loss_scaling) {
+    // The other pipeline stages and the ZeRO and Adasum optimizer graphs still rely on the host-side check.
+    ORT_RETURN_IF(config.pipeline_config.has_value(), "Device loss scaling is not supported with pipeline parallelism.");
+    ORT_RETURN_IF(config.optimizer_config.has_value() &&
+                      (config.optimizer_config.value().deepspeed_zero.stage != 0 ||
+                       config.optimizer_config.value().adasum_reduction_type != AdasumReductionType::None),
+                  "Device loss scaling is not supported with ZeRO or Adasum.");
+    device_loss_scale_initial_value_ = config.mixed_precision_config.value().initial_loss_scale;
+  }
   if (config.pipeline_config.has_value()) {
     // if use pipeline, first check if model contains send op. If it does, set the
     // send node's output as the start tensor to build gradient graph
@@ -224,6 +237,10 @@ Status TrainingSession::ConfigureForTraining(
       !filtered_config_weight_names_to_train.empty()
           ? filtered_config_weight_names_to_train
           : GetTrainableModelInitializers(config.immutable_weights, loss_name);
+  // The loss scale initializer is updated in place by DynamicLossScale, keep it away from constant folding.
+  if (device_loss_scale_initial_value_.has_value()) {
+    trainable_initializers.insert(loss_scale_input_name.value());
+  }
   if (config.weight_names_to_not_train.size() > 0) {
     LOGS(*session_logger_, INFO) << "Excluding following weights from trainable list as specified in configuration:";
     for (const auto& weight_name_to_not_train : config.weight_names_to_not_train) {
@@ -247,6 +264,9 @@ Status TrainingSession::ConfigureForTraining(
   for (const auto& weight_name_to_not_train : config.weight_names_to_not_train) {
     weight_names_to_train.erase(weight_name_to_not_train);
   }
+  if (device_loss_scale_initial_value_.has_value()) {
+    weight_names_to_train.erase(loss_scale_input_name.value());
+  }
 
   {
     std::ostringstream weight_names_stream{};
@@ -269,7 +289,22 @@ Status TrainingSession::ConfigureForTraining(
   ORT_RETURN_IF_ERROR(BuildGradientGraph(
       weight_names_to_train, loss_name, config.gradient_graph_config, *session_logger_));
 
+  if (config.activation_offload_config.has_value()) {
+    ORT_RETURN_IF(config.pipeline_config.has_value(), "Activation offload is not supported with pipeline parallelism.");
+    ORT_RETURN_IF_ERROR(AddActivationOffload(config.activation_offload_config.value()));
+  }
+
   if (config.pipeline_config.has_value()) {
+    const auto& pipeline_config = config.pipeline_config.value();
+    ORT_RETURN_IF_NOT(pipeline_config.num_micro_batches > 0,
+                      "Pipeline needs a positive number of micro-batches, got ", pipeline_config.num_micro_batches);
+    ORT_RETURN_IF_NOT(pipeline_config.max_num_inflight_micro_batches >= 0,
+                      "Pipeline maximum number of in-flight micro-batches can't be negative, got ",
+                      pipeline_config.max_num_inflight_micro_batches);
+    ORT_RETURN_IF_NOT(pipeline_config.num_chunks_per_stage == 1,
+                      "The pipeline partition doesn't make interleaved model chunks yet, got ",
+                      pipeline_config.num_chunks_per_stage, " chunks per stage.");
+
     TrainingConfigurationResult::PipelineConfigurationResult pipeline_result{};
     ORT_RETURN_IF_ERROR(InsertPipelineOps(weight_names_to_train,
                                           pipeline_result.pipeline_tensor_names));
@@ -292,6 +327,11 @@ Status TrainingSession::ConfigureForTraining(
     pipeline_result.pipeline_stage_id =
         config.distributed_config.world_rank /
         (config.distributed_config.data_parallel_size * config.distributed_config.horizontal_parallel_size);
+    pipeline_result.pipeline_schedule = std::make_shared<pipeline::PipelineScheduler>(
+        pipeline_config.num_micro_batches,
+        config.distributed_config.pipeline_parallel_size,
+        pipeline_config.num_chunks_per_stage,
+        pipeline_config.max_num_inflight_micro_batches);
     config_result.pipeline_config_result = pipeline_result;
   }
 
@@ -321,6 +361,10 @@ Status TrainingSession::ConfigureForTraining(
     ORT_RETURN_IF_ERROR(BuildOptimizer(
         opt_graph_config, opt_node_configs,
         optimizer_config_result.output_key_to_graph_output_name));
+    if (opt_graph_config.use_device_loss_scaling) {
+      // The loss scale is now part of the training state.
+      opt_state_initializer_names_.insert(opt_graph_config.loss_scale_input_name);
+    }
 
     config_result.opt_config_result = optimizer_config_result;
   } else {
@@ -367,7 +411,7 @@ Status TrainingSession::ConfigureForTraining(
 
   // add GIST encoding
   if (config.gist_config.has_value()) {
-    ORT_RETURN_IF_ERROR(AddGistEncoding());
+    ORT_RETURN_IF_ERROR(AddGistEncoding(config.gist_config.value()));
   }
 
   // If the current node is in rank0 or if the current session is running pipeline (in which case different rank would
@@ -405,7 +449,8 @@ Status TrainingSession::ConfigureForTraining(
 
 static Status AddLossScaling(
     const std::string& loss_name,
-    Graph& graph, std::string* loss_scale_input_name, std::string& scaled_loss_name) {
+    Graph& graph, std::string* loss_scale_input_name, std::string& scaled_loss_name,
+    const optional<float>& initial_loss_scale) {
   if (!loss_scale_input_name) {
     scaled_loss_name = loss_name;
     return Status::OK();
@@ -423,7 +468,12 @@ static Status AddLossScaling(
       {ArgDef{scaled_loss_name}},
       NodeAttributes(),
       scaled_loss_name});
-  defs.AddGraphInputs({*loss_scale_input_name});
+  if (initial_loss_scale.has_value()) {
+    // The loss scale is updated in the graph, so it is kept in an initializer instead of being fed.
+    defs.AddInitializers({CreateTensorProto<float>(*loss_scale_input_name, initial_loss_scale.value())});
+  } else {
+    defs.AddGraphInputs({*loss_scale_input_name});
+  }
 
   ORT_RETURN_IF_ERROR(GraphAugmenter::AugmentGraph(graph, defs));
 
@@ -436,7 +486,8 @@ static Status ConfigureLossFunctionInternal(
     const optional<LossFunctionInfo>& loss_func_info,
     Graph& graph,
     std::string* loss_scale_input_name,
-    std::string& actual_loss_name) {
+    std::string& actual_loss_name,
+    const optional<float>& initial_loss_scale = {}) {
   // build loss function or use external one
   ORT_RETURN_IF_NOT(
       (loss_func_info.has_value() && loss_graph_builder) ^ external_loss_name.has_value(),
@@ -453,7 +504,7 @@ static Status ConfigureLossFunctionInternal(
   }
 
   ORT_RETURN_IF_ERROR(AddLossScaling(
-      unscaled_loss_name, graph, loss_scale_input_name, actual_loss_name));
+      unscaled_loss_name, graph, loss_scale_input_name, actual_loss_name, initial_loss_scale));
 
   return Status::OK();
 }
@@ -587,12 +638,17 @@ void TrainingSession::AddPredefinedTransformers(GraphTransformerManager& transfo
   }
 }
 
-Status TrainingSession::AddGistEncoding() {
+Status TrainingSession::AddGistEncoding(const TrainingConfiguration::GistConfiguration& gist_config) {
   try {
     Graph& graph = model_->MainGraph();
 
     auto rule_transformer_L1 = onnxruntime::make_unique<RuleBasedGraphTransformer>("RuleGistTransformer1");
-    rule_transformer_L1->Register(onnxruntime::make_unique<GistEncodeDecode>());
+    if (gist_config.op_type_to_compression_type.empty()) {
+      rule_transformer_L1->Register(onnxruntime::make_unique<GistEncodeDecode>());
+    } else {
+      rule_transformer_L1->Register(
+          onnxruntime::make_unique<GistEncodeDecode>(gist_config.op_type_to_compression_type));
+    }
     onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
     graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
 
@@ -603,6 +659,17 @@ Status TrainingSession::AddGistEncoding() {
   return DoPostLoadProcessing(*model_);
 }
 
+Status TrainingSession::AddActivationOffload(
+    const TrainingConfiguration::ActivationOffloadConfiguration& offload_config) {
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  graph_transformation_mgr.Register(
+      onnxruntime::make_unique<ActivationOffload>(offload_config.min_size_in_bytes, offload_config.min_lifetime,
+                                                  offload_config.max_size_in_bytes),
+      TransformerLevel::Level1);
+
+  return graph_transformation_mgr.ApplyTransformers(model_->MainGraph(), TransformerLevel::Level1, *session_logger_);
+}
+
 Status TrainingSession::AddTensorboard(const std::string& summary_name,
                                        const std::vector<std::string>& scalar_nodes,
                                        const std::vector<std::string>& histogram_nodes,
@@ -646,7 +713,7 @@ Status TrainingSession::ConfigureLossFunction(
   try {
     ORT_RETURN_IF_ERROR(ConfigureLossFunctionInternal(
         external_loss_name_, loss_graph_builder_.get(), loss_function_info_,
-        model_->MainGraph(), loss_scale_input_name, actual_loss_name));
+        model_->MainGraph(), loss_scale_input_name, actual_loss_name, device_loss_scale_initial_value_));
   } catch (const OnnxRuntimeException& exp) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to add loss function:", exp.what());
   }
@@ -77,6 +77,12 @@ class TrainingSession : public InferenceSession {
       MixedPrecisionDataType mixed_precision_type{MixedPrecisionDataType::FP16};
 
       bool layernorm_stash_as_fp32{true};
+
+      // Whether to keep the FP16 loss scale in the graph, updated on the device from the global gradient norm,
+      // instead of feeding it every step and updating it on the host from the all-finite check.
+      bool use_device_loss_scaling{false};
+      // The initial value of the loss scale updated on the device.
+      float initial_loss_scale{static_cast<float>(1 << 16)};
       
       ONNX_NAMESPACE::TensorProto_DataType TensorProtoDataType() const {
         switch (mixed_precision_type) {
@@ -102,11 +108,30 @@ class TrainingSession : public InferenceSession {
     // Exactly one of loss_function_config or loss_name should be given.
     optional<std::string> loss_name{};
 
-    struct GistConfiguration {};
+    struct GistConfiguration {
+      // The compression type applied to the stashed output of each op type,
+      // one of "GistBinarize", "GistPack16" or "GistPackBf16".
+      // If empty, the Relu outputs are binarized.
+      std::unordered_map<std::string, std::string> op_type_to_compression_type{};
+    };
     // The GIST configuration.
     // If not provided, GIST is disabled.
     optional<GistConfiguration> gist_config{};
 
+    struct ActivationOffloadConfiguration {
+      // Activations smaller than this are kept on the device. Symbolic dimensions count as 1.
+      size_t min_size_in_bytes{1 << 20};
+      // Activations used by the backward pass fewer than this number of nodes after their last forward use are kept
+      // on the device.
+      int min_lifetime{16};
+      // The limit of the total size of the offloaded activations, 0 for no limit.
+      // The activations stashed for longest, i.e. those of the first layers, are offloaded first.
+      size_t max_size_in_bytes{0};
+    };
+    // The configuration of the offload of stashed activations to pinned host memory, which requires CUDA.
+    // If not provided, the activations are kept on the device.
+    optional<ActivationOffloadConfiguration> activation_offload_config{};
+
     struct TensorboardConfiguration {
       // The summary name.
       std::string summary_name{};
@@ -139,6 +164,9 @@ class TrainingSession : public InferenceSession {
       bool do_all_reduce_in_mixed_precision_type{};
       // Whether to use NCCL.
       bool use_nccl{};
+      // The size limit of the buckets of gradients allreduced with NCCL during the backward pass.
+      // 0 means a single allreduce after the backward pass.
+      size_t allreduce_bucket_size_in_bytes{};
       // Whether to partition the optimizer state.
       ZeROConfig deepspeed_zero{};
       // Selects the reduction algorithm for Adasum.
@@ -185,6 +213,15 @@ class TrainingSession : public InferenceSession {
 
       // The base path at which to save the intermediate partitioned input model (forward pass only).
       optional<PathString> partitioned_model_path{};
+
+      // The number of micro-batches per pipeline run, i.e., per weight update.
+      int num_micro_batches{1};
+      // The number of model chunks per stage, which are interleaved in the schedule as virtual stages.
+      // The pipeline partition only makes one chunk per stage so far.
+      int num_chunks_per_stage{1};
+      // The maximum number of micro-batches in the pipeline at a time. Each stage keeps the activations
+      // of at most this number of micro-batches. 0 means the number of virtual stages.
+      int max_num_inflight_micro_batches{0};
     };
 
     // If pipeline is enabled, this field's has_value() returns true.
@@ -202,6 +239,9 @@ class TrainingSession : public InferenceSession {
       bool transformer_layer_recompute{false};
       // Number of layers to apply recompute
       int number_recompute_layers{0};
+      // With horizontal parallelism, shard the sequence dimension of the activations outside the Megatron
+      // parallel regions between the ranks, instead of computing them on every rank.
+      bool megatron_sequence_parallel{false};
     };
 
     GraphTransformerConfiguration graph_transformer_config{};
@@ -213,6 +253,7 @@ class TrainingSession : public InferenceSession {
   struct TrainingConfigurationResult {
     struct MixedPrecisionConfigurationResult {
       // The name of the loss scaling factor input.
+      // With device loss scaling, it is an initializer updated in the graph and must not be fed.
       std::string loss_scale_input_name;
     };
     // The mixed precision configuration output.
@@ -240,6 +281,8 @@ class TrainingSession : public InferenceSession {
       // Tensors to fetch at this pipeline stage.
       // It's a subset of PipelineConfiguration.fetch_names.
       std::vector<std::string> fetch_names;
+      // The 1F1B schedule of the micro-batches, which gives the events to feed at each run.
+      std::shared_ptr<pipeline::PipelineScheduler> pipeline_schedule;
     };
 
     // The pipeline configuration output.
@@ -354,7 +397,9 @@ class TrainingSession : public InferenceSession {
       std::string* loss_scale_input_name,
       std::string& actual_loss_name);
 
-  common::Status AddGistEncoding();
+  common::Status AddGistEncoding(const TrainingConfiguration::GistConfiguration& gist_config);
+
+  common::Status AddActivationOffload(const TrainingConfiguration::ActivationOffloadConfiguration& offload_config);
 
   /** Add tensorboard summary nodes to the graph.
   @param summary_name name for the merged summary node.
@@ -471,6 +516,8 @@ class TrainingSession : public InferenceSession {
   std::unordered_set<std::string> mixed_precision_weight_initializer_names_;
 
   bool is_mixed_precision_enabled_;
+  // The initial value of the loss scale initializer if the loss scale is updated on the device.
+  optional<float> device_loss_scale_initial_value_;
   optional<std::string> external_loss_name_;
   std::unique_ptr<ILossFunction> loss_graph_builder_;
   optional<LossFunctionInfo> loss_function_info_;
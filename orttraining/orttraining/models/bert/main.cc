@@ -23,7 +23,12 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(O
                                                                                OrtCudnnConvAlgoSearch cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::EXHAUSTIVE,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
                                                                                onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
-                                                                               bool do_copy_in_default_stream = true);
+                                                                               bool do_copy_in_default_stream = true,
+                                                                               bool enable_cuda_graph = false,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool enable_stream_ordered_allocator = false,
+                                                                               bool enable_elementwise_fusion = false,
+                                                                               const std::string& elementwise_fusion_cache_path = "");
 }
 
 using namespace onnxruntime;
@@ -103,12 +108,21 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("checkpoint_period", "How many weight-update steps to run before saving a model checkpoint.", cxxopts::value<size_t>()->default_value("1000"))
       ("max_num_checkpoints", "Maximum number of checkpoint files to maintain.",
         cxxopts::value<size_t>()->default_value("10"))
+      ("async_checkpoint", "Write the checkpoint files in the background, from host copies of the model state.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("shard_checkpoints", "Have each rank save a shard of the checkpoints.",
+        cxxopts::value<bool>()->default_value("false"))
       ("gradient_accumulation_steps_phase2", "The number of gradient accumulation steps before performing a backward/update pass in phase 2.",
         cxxopts::value<int>()->default_value("1"))
       ("iterations_per_loop", "How many steps to make in each estimator call.", cxxopts::value<int>()->default_value("1000"))
       ("max_eval_steps", "Maximum number of eval steps.", cxxopts::value<int>()->default_value("100"))
       ("seed", "Random seed.", cxxopts::value<int64_t>()->default_value("-1"))
       ("use_mixed_precision", "Whether to use a mix of fp32 and fp16 arithmetic on GPU.", cxxopts::value<bool>()->default_value("false"))
+      ("use_bfloat16", "Whether to use bfloat16 instead of fp16 in mixed precision training, without loss scaling.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("device_loss_scaling", "Whether to update the dynamic fp16 loss scale in the graph on the device, "
+        "so overflowed steps are skipped without waiting for the host.",
+        cxxopts::value<bool>()->default_value("false"))
       ("use_adasum", "Whether to use Adasum for allreduction.", cxxopts::value<bool>()->default_value("false"))
       ("allreduce_in_fp16", "Whether to do AllReduce in fp16. If false, AllReduce will be done in fp32", cxxopts::value<bool>()->default_value("true"))
       ("loss_scale", "Loss scaling, positive power of 2 values can improve fp16 convergence. "
@@ -118,6 +132,9 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("use_fp16_initializer", "FP16 weights will be created. Otherwise, cast nodes will be inserted for converting weights from FP32 to FP16",
         cxxopts::value<bool>()->default_value("true"))
       ("use_nccl", "Whether to use NCCL for distributed training.", cxxopts::value<bool>()->default_value("false"))
+      ("allreduce_bucket_size_mb", "With NCCL, allreduce the gradients in buckets of up to this many MB as soon as the "
+        "backward pass produces them. 0 allreduces all of them after the backward pass.",
+        cxxopts::value<size_t>()->default_value("0"))
       ("use_profiler", "Collect runtime profile data during this training run.", cxxopts::value<bool>()->default_value("false"))
       ("max_profile_records", "Maximum number of runtime profile data records to collect. 0 means use the default value.",
         cxxopts::value<size_t>()->default_value("0"))
@@ -135,9 +152,10 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("max_predictions_per_seq",
         "Maximum number of masked LM predictions per sequence. "
         "Must match data generation.", cxxopts::value<int>()->default_value("80"))
-      ("optimizer", "Adam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
+      ("optimizer", "Adam, MultiTensorAdam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
       ("deepspeed_zero_stage", "Controls whether to partition state using the DeepSpeed ZeRO technique. "
-       "Stages 0 (disabled) and 1 (optimizer state partitioning) are supported.",
+       "Stages 0 (disabled), 1 (optimizer state partitioning), 2 (1 + gradient partitioning) and "
+       "3 (2 + parameter partitioning) are supported.",
        cxxopts::value<int>()->default_value("0"))
       ("alpha", "Adam/Lamb alpha parameter", cxxopts::value<float>()->default_value("0.9"))
       ("beta", "Adam/Lamb beta parameter", cxxopts::value<float>()->default_value("0.999"))
@@ -158,7 +176,13 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("cuda_mem_limit_in_gb", "Max cuda memory ort can use, in GB", cxxopts::value<float>()->default_value("-1.0"))
       ("data_parallel_size", "Data parallel group size.", cxxopts::value<int>()->default_value("1"))
       ("horizontal_parallel_size", "Horizontal model parallel group size.", cxxopts::value<int>()->default_value("1"))
+      ("megatron_sequence_parallel", "Shard the sequence dimension of the dropouts, residuals and layer norms between "
+        "the horizontal parallel ranks. The sequence length must be divisible by horizontal_parallel_size.",
+        cxxopts::value<bool>()->default_value("false"))
       ("pipeline_parallel_size", "Number of pipeline stages.", cxxopts::value<int>()->default_value("1"))
+      ("pipeline_max_inflight_batches", "Maximum number of micro-batches in the pipeline at a time, which "
+        "bounds the activation memory of each stage. 0 means the number of pipeline stages.",
+        cxxopts::value<int>()->default_value("0"))
       ("pipeline_stage_paths", "Specify the forward ONNX files for pipeline evaluation.", cxxopts::value<std::vector<std::string>>()->default_value(""))
       ("cut_group_info", "Specify the cutting info for graph partition (pipeline only). An example of a cut_group_info of "
       "size two is: 1393:407-1463/1585/1707,2369:407-2439/2561/2683. Here, the cut info is split by ',', with the first "
@@ -178,7 +202,17 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("number_recompute_layers", "Number of layers to apply recompute.",
         cxxopts::value<int>()->default_value("0"))
       ("use_invertible_layernorm_grad", "Specify whether to use invertible laynorm(dropping the input activation)",
-        cxxopts::value<bool>()->default_value("false"));
+        cxxopts::value<bool>()->default_value("false"))
+      ("activation_offload", "Offload the activations stashed for the backward pass to host memory to save memory.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("activation_offload_min_size_kb", "Activations smaller than this are kept on the device.",
+        cxxopts::value<int>()->default_value("1024"))
+      ("activation_offload_max_size_mb", "The limit of the total size of the offloaded activations, activations of "
+       "the first layers are offloaded first. 0 means no limit.",
+        cxxopts::value<int>()->default_value("0"))
+      ("gist_compression", "Compress the activations stashed for the backward pass, as a list of op_type:compression "
+       "pairs, where compression is GistBinarize, GistPack16 or GistPackBf16, e.g. Gelu:GistPack16,Softmax:GistPack16.",
+        cxxopts::value<std::vector<std::string>>()->default_value(""));
   options
     .add_options("ORT configuration")
       ("ort_log_severity", "ORT minimum logging severity (see onnxruntime::logging::Severity values)",
@@ -247,8 +281,11 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     params.display_loss_steps = flags["display_loss_steps"].as<size_t>();
     params.checkpoint_period = flags["checkpoint_period"].as<size_t>();
     params.max_num_checkpoints = flags["max_num_checkpoints"].as<size_t>();
+    params.async_checkpoint = flags["async_checkpoint"].as<bool>();
+    params.shard_checkpoints = flags["shard_checkpoints"].as<bool>();
 
     params.use_nccl = flags["use_nccl"].as<bool>();
+    params.allreduce_bucket_size_in_bytes = flags["allreduce_bucket_size_mb"].as<size_t>() * 1024 * 1024;
     params.use_adasum = flags["use_adasum"].as<bool>();
     params.use_profiler = flags.count("use_profiler") > 0;
     ort_params.max_num_profiling_events = flags["max_profile_records"].as<size_t>();
@@ -289,6 +326,10 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     if (params.use_mixed_precision) {
       printf("Mixed precision training is enabled.\n");
     }
+    params.use_bfloat16 = flags["use_bfloat16"].as<bool>() && params.use_mixed_precision;
+    if (params.use_bfloat16) {
+      printf("Using bfloat16 mixed precision, loss scaling is disabled.\n");
+    }
     if (params.allreduce_in_mixed_precision_type) {
       printf("Performing AllReduce in mixed precision type \n");
     } else {
@@ -307,6 +348,14 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
           printf("Mixed precision loss scale is: %f\n", params.loss_scale);
         }
       }
+      params.use_device_loss_scaling = flags["device_loss_scaling"].as<bool>() &&
+                                       params.use_mixed_precision && !params.use_bfloat16;
+      if (params.use_device_loss_scaling) {
+        if (params.loss_scale != 0.0f) {
+          return Status(ONNXRUNTIME, INVALID_ARGUMENT, "device_loss_scaling requires the dynamic loss scale.");
+        }
+        printf("Updating the loss scale on the device.\n");
+      }
     }
 
     params.use_mixed_precision_moments = flags["use_fp16_moments"].as<bool>();
@@ -334,10 +383,12 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     std::string optimizer_name = flags["optimizer"].as<std::string>();
     if (optimizer_name == "adam" || optimizer_name == "Adam") {
       params.training_optimizer_name = "AdamOptimizer";
+    } else if (optimizer_name == "multi_tensor_adam" || optimizer_name == "MultiTensorAdam") {
+      params.training_optimizer_name = "MultiTensorAdamOptimizer";
     } else if (optimizer_name == "lamb" || optimizer_name == "Lamb") {
       params.training_optimizer_name = "LambOptimizer";
     } else {
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|Lamb]");
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|MultiTensorAdam|Lamb]");
     }
 
     params.deepspeed_zero = ZeROConfig(flags["deepspeed_zero_stage"].as<int>());
@@ -389,12 +440,15 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     params.horizontal_parallel_size = flags["horizontal_parallel_size"].as<int>();
     ORT_RETURN_IF_NOT(params.data_parallel_size > 0, "data_parallel_size must > 0");
     ORT_RETURN_IF_NOT(params.horizontal_parallel_size > 0, "horizontal_parallel_size must > 0");
+    params.megatron_sequence_parallel = flags["megatron_sequence_parallel"].as<bool>();
 
     // pipeline_parallel_size controls the number of pipeline's stages.
     // pipeline_parallel_size=1 means no model partition, which means all processes run
     // the same model. We only partition model when pipeline_parallel_size > 1.
     params.pipeline_parallel_size = flags["pipeline_parallel_size"].as<int>();
     ORT_RETURN_IF_NOT(params.pipeline_parallel_size > 0, "pipeline_parallel_size must > 0");
+    params.pipeline_max_num_inflight_batches = flags["pipeline_max_inflight_batches"].as<int>();
+    ORT_RETURN_IF_NOT(params.pipeline_max_num_inflight_batches >= 0, "pipeline_max_inflight_batches must >= 0");
 
     // If user provides partitioned model files, the number of files should match the number of
     // processes. The i-th file should correspond to the i-th process' pipeline stage.
@@ -468,6 +522,25 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     params.gelu_recompute = flags["gelu_recompute"].as<bool>();
     params.transformer_layer_recompute = flags["transformer_layer_recompute"].as<bool>();
     params.number_recompute_layers = flags["number_recompute_layers"].as<int>();
+    params.activation_offload = flags["activation_offload"].as<bool>();
+    const int activation_offload_min_size_kb = flags["activation_offload_min_size_kb"].as<int>();
+    const int activation_offload_max_size_mb = flags["activation_offload_max_size_mb"].as<int>();
+    if (activation_offload_min_size_kb < 0 || activation_offload_max_size_mb < 0) {
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Activation offload sizes should be >= 0.");
+    }
+    params.activation_offload_min_size_in_bytes = static_cast<size_t>(activation_offload_min_size_kb) * 1024;
+    params.activation_offload_max_size_in_bytes = static_cast<size_t>(activation_offload_max_size_mb) * 1024 * 1024;
+
+    for (const auto& gist_entry : flags["gist_compression"].as<std::vector<std::string>>()) {
+      if (gist_entry.empty()) {
+        continue;
+      }
+      const size_t pos = gist_entry.find(':');
+      ORT_RETURN_IF_NOT(pos != std::string::npos, "gist_compression entries must be op_type:compression, got ",
+                        gist_entry);
+      params.gist_op_type_to_compression_type[gist_entry.substr(0, pos)] = gist_entry.substr(pos + 1);
+    }
+    params.use_gist = !params.gist_op_type_to_compression_type.empty();
 
     ort_params.log_severity = static_cast<logging::Severity>(flags["ort_log_severity"].as<int>());
     ORT_RETURN_IF_NOT(
@@ -22,7 +22,12 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(O
                                                                                OrtCudnnConvAlgoSearch cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::EXHAUSTIVE,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
                                                                                onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
-                                                                               bool do_copy_in_default_stream = true);
+                                                                               bool do_copy_in_default_stream = true,
+                                                                               bool enable_cuda_graph = false,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool enable_stream_ordered_allocator = false,
+                                                                               bool enable_elementwise_fusion = false,
+                                                                               const std::string& elementwise_fusion_cache_path = "");
 }
 
 using namespace onnxruntime;
@@ -80,9 +85,10 @@ Status ParseArguments(int argc, char* argv[], GPT2Parameters& params, OrtParamet
         "The maximum total input sequence length after WordPiece tokenization. "
         "Sequences longer than this will be truncated, and sequences shorter "
         "than this will be padded. Must match data generation.", cxxopts::value<int>()->default_value("1024"))
-      ("optimizer", "Adam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
+      ("optimizer", "Adam, MultiTensorAdam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
       ("deepspeed_zero_stage", "Controls whether to partition state using the DeepSpeed ZeRO technique. "
-       "Stages 0 (disabled) and 1 (optimizer state partitioning) are supported.",
+       "Stages 0 (disabled), 1 (optimizer state partitioning), 2 (1 + gradient partitioning) and "
+       "3 (2 + parameter partitioning) are supported.",
        cxxopts::value<int>()->default_value("0"))
       ("alpha", "Adam/Lamb alpha parameter", cxxopts::value<float>()->default_value("0.9"))
       ("beta", "Adam/Lamb beta parameter", cxxopts::value<float>()->default_value("0.999"))
@@ -202,10 +208,12 @@ Status ParseArguments(int argc, char* argv[], GPT2Parameters& params, OrtParamet
     std::string optimizer_name = flags["optimizer"].as<std::string>();
     if (optimizer_name == "adam" || optimizer_name == "Adam") {
       params.training_optimizer_name = "AdamOptimizer";
+    } else if (optimizer_name == "multi_tensor_adam" || optimizer_name == "MultiTensorAdam") {
+      params.training_optimizer_name = "MultiTensorAdamOptimizer";
     } else if (optimizer_name == "lamb" || optimizer_name == "Lamb") {
       params.training_optimizer_name = "LambOptimizer";
     } else {
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|Lamb]");
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|MultiTensorAdam|Lamb]");
     }
 
     params.deepspeed_zero = ZeROConfig(flags["deepspeed_zero_stage"].as<int>());
@@ -22,7 +22,12 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(O
                                                                                OrtCudnnConvAlgoSearch cudnn_conv_algo_search = OrtCudnnConvAlgoSearch::EXHAUSTIVE,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
                                                                                onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
-                                                                               bool do_copy_in_default_stream = true);
+                                                                               bool do_copy_in_default_stream = true,
+                                                                               bool enable_cuda_graph = false,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool enable_stream_ordered_allocator = false,
+                                                                               bool enable_elementwise_fusion = false,
+                                                                               const std::string& elementwise_fusion_cache_path = "");
 }
 
 using namespace onnxruntime;
@@ -87,8 +87,21 @@ const PipelineTask& PipelineSlot::GetFrontAction() const {
   return tasks_.front();
 }
 
-PipelineScheduler::PipelineScheduler(const int num_batches, const int num_stages) {
+PipelineScheduler::PipelineScheduler(const int num_batches, const int num_stages)
+    : PipelineScheduler(num_batches, num_stages, 1, 0) {
+}
+
+PipelineScheduler::PipelineScheduler(const int num_batches, const int num_stages, const int num_chunks, const int max_num_inflight_batches) {
+  if (num_batches < 1 || num_stages < 1 || num_chunks < 1 || max_num_inflight_batches < 0) {
+    throw std::invalid_argument("Pipeline schedule needs positive numbers of batches, stages and chunks.");
+  }
+  if (num_chunks > 1 && num_stages < 2) {
+    throw std::invalid_argument("Interleaved pipeline schedule needs at least 2 stages.");
+  }
   num_stages_ = num_stages;
+  num_chunks_ = num_chunks;
+  num_virtual_stages_ = num_stages * num_chunks;
+  max_num_inflight_batches_ = max_num_inflight_batches > 0 ? max_num_inflight_batches : num_virtual_stages_;
   num_batches_ = num_batches;
   CreateComputeSchedule();
 
@@ -148,7 +161,7 @@ std::vector<int> PipelineSlot::GetRecordedEvent() const {
 std::ostream& operator<<(std::ostream& stream, PipelineScheduler const& schedule) {
   // print something from v to str, e.g: Str << v.getX();
   stream << "-------------View of Compute Schedule-------------" << std::endl;
-  for (int s = 0; s < schedule.num_stages_; ++s) {
+  for (int s = 0; s < schedule.num_virtual_stages_; ++s) {
     for (size_t t = 0; t < schedule.compute_table_.size(); ++t) {
       stream << schedule.compute_table_[t][s];
     }
@@ -156,7 +169,7 @@ std::ostream& operator<<(std::ostream& stream, PipelineScheduler const& schedule
   }
 
   stream << "-------------View of Compute-commute Schedule-------------" << std::endl;
-  for (int s = 0; s < schedule.num_stages_; ++s) {
+  for (int s = 0; s < schedule.num_virtual_stages_; ++s) {
     for (size_t t = 0; t < schedule.compute_commute_table_.size(); ++t) {
       stream << schedule.compute_commute_table_[t][s];
     }
@@ -166,16 +179,26 @@ std::ostream& operator<<(std::ostream& stream, PipelineScheduler const& schedule
   return stream;
 }
 
+bool PipelineScheduler::IsStageComputing(const int t, const int s) const {
+  // The virtual stages of a stage share its device, so only one of them computes at a time.
+  for (int virtual_s = GetStageId(s); virtual_s < num_virtual_stages_; virtual_s += num_stages_) {
+    if (!compute_table_[t][virtual_s].IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // Return time indexes of a given batch.
-// i-th returned element is the time of batch_id's forward at stage i.
-// previous_forward_time[s] is the time that the last forward happens on stage s.
+// i-th returned element is the time of batch_id's forward at virtual stage i.
+// previous_forward_time[s] is the time that the last forward happens on virtual stage s.
 std::vector<int> PipelineScheduler::FindForwardComputeTime(const std::vector<int> previous_forward_time) const {
-  // forward_time[i]: i-th stage's forward time of batch_id.
-  std::vector<int> forward_time(num_stages_, 0);
+  // forward_time[i]: i-th virtual stage's forward time of batch_id.
+  std::vector<int> forward_time(num_virtual_stages_, 0);
 
-  for (int s = 0; s < num_stages_; ++s) {
+  for (int s = 0; s < num_virtual_stages_; ++s) {
     for (int t = previous_forward_time[s]; t < static_cast<int>(compute_table_.size()); ++t) {
-      if (!compute_table_[t][s].IsEmpty()) {
+      if (IsStageComputing(t, s)) {
         // One slot cannot be occupied by two batches.
         continue;
       }
@@ -186,7 +209,7 @@ std::vector<int> PipelineScheduler::FindForwardComputeTime(const std::vector<int
         continue;
       }
 
-      if (compute_batch_count_[t] >= num_stages_) {
+      if (compute_batch_count_[t] >= max_num_inflight_batches_) {
         // At time t, the number of running batches is at maximum,
         // so we need to put this stage to another time slot.
         continue;
@@ -206,20 +229,20 @@ std::vector<int> PipelineScheduler::FindForwardComputeTime(const std::vector<int
 // i-th returned element is the time of batch_id's backward at stage i.
 // forward_time[s] is the forward time for the given batch on stage s.
 std::vector<int> PipelineScheduler::FindBackwardComputeTime(const std::vector<int> forward_time) const {
-  std::vector<int> backward_time(num_stages_, 0);
+  std::vector<int> backward_time(num_virtual_stages_, 0);
   // For a specific batch, the last stage has the earliest backward computation.
   // Thus, the first loop reversely scans stages.
-  for (int s = num_stages_ - 1; s > -1; --s) {
+  for (int s = num_virtual_stages_ - 1; s > -1; --s) {
     for (int t = forward_time[s] + 1; t < static_cast<int>(compute_table_.size()); ++t) {
-      if (!compute_table_[t][s].IsEmpty()) {
+      if (IsStageComputing(t, s)) {
         continue;
       }
 
-      if (s < num_stages_ - 1 && t <= backward_time[s + 1]) {
+      if (s < num_virtual_stages_ - 1 && t <= backward_time[s + 1]) {
         continue;
       }
 
-      if (compute_batch_count_[t] >= num_stages_) {
+      if (compute_batch_count_[t] >= max_num_inflight_batches_) {
         continue;
       }
 
@@ -235,9 +258,12 @@ int PipelineScheduler::FindSendRecvTime(const int upstream_compute_time, const i
   // Search for a time to insert Recv and then Send in full table.
   // Recv is on slot's stage.
   // Send is on upstream slot's stage.
+  // Send and Recv peers are stages, not virtual stages.
+  const int upstream_rank = GetStageId(upstream_stage);
+  const int rank = GetStageId(stage);
   for (int full_t = static_cast<int>(compute_commute_table_.size()) - 1; full_t > upstream_compute_time; --full_t) {
     bool is_good_time = true;
-    for (int full_s = 0; full_s < num_stages_; ++full_s) {
+    for (int full_s = 0; full_s < num_virtual_stages_; ++full_s) {
       auto& candidate_slot = compute_commute_table_[full_t][full_s];
 
       if (candidate_slot.HasCompute()) {
@@ -245,12 +271,12 @@ int PipelineScheduler::FindSendRecvTime(const int upstream_compute_time, const i
         break;
       }
 
-      if (candidate_slot.HasRecvFrom(upstream_stage)) {
+      if (candidate_slot.HasRecvFrom(upstream_rank)) {
         is_good_time = false;
         break;
       }
 
-      if (candidate_slot.HasRendTo(stage)) {
+      if (candidate_slot.HasRendTo(rank)) {
         is_good_time = false;
         break;
       }
@@ -270,10 +296,10 @@ void PipelineScheduler::CreateFullSchedule() {
   for (int t = 0; static_cast<size_t>(t) < compute_table_.size(); ++t) {
     // The last stage is compute, so we append one slot for commute.
     if (t != 0) {
-      compute_commute_table_.push_back(std::vector<PipelineSlot>(num_stages_));
+      compute_commute_table_.push_back(std::vector<PipelineSlot>(num_virtual_stages_));
     }
 
-    for (int s = 0; s < num_stages_; ++s) {
+    for (int s = 0; s < num_virtual_stages_; ++s) {
       // Read a slot from compute-only schedule.
       // We will build send-recv pair to connect this slot with its upstream slot.
       auto slot = compute_table_[t][s];
@@ -302,7 +328,7 @@ void PipelineScheduler::CreateFullSchedule() {
         continue;
       }
 
-      if (s == num_stages_ - 1 && action.IsBackward() && action.IsCompute()) {
+      if (s == num_virtual_stages_ - 1 && action.IsBackward() && action.IsCompute()) {
         continue;
       }
 
@@ -321,19 +347,25 @@ void PipelineScheduler::CreateFullSchedule() {
       const PipelineTask::Pass send_pass = upstream_action.IsForward() ? PipelineTask::Pass::Forward : PipelineTask::Pass::Backward;
 
       // Find a time index to insert send-recv pair in the schedule with compute and commute actions.
-      const int good_time = FindSendRecvTime(upstream_compute_time, upstream_s, s);
+      int good_time = FindSendRecvTime(upstream_compute_time, upstream_s, s);
+      if (good_time < 0) {
+        // With virtual stages, a stage may send to or receive from the same stage twice before
+        // this compute, so the pair gets a commute slot of its own.
+        compute_commute_table_.push_back(std::vector<PipelineSlot>(num_virtual_stages_));
+        good_time = static_cast<int>(compute_commute_table_.size()) - 1;
+      }
 
       // Add Send and Recv to compute-commute schedule.
       // Send from upstream_s-th stage.
       // Recv at s-th stage.
-      compute_commute_table_[good_time][upstream_s].AddSend(batch, send_pass, upstream_compute_time, upstream_s, upstream_s, s);
-      compute_commute_table_[good_time][s].AddRecv(batch, recv_pass, good_time, s, s, upstream_s);
+      compute_commute_table_[good_time][upstream_s].AddSend(batch, send_pass, upstream_compute_time, upstream_s, GetStageId(upstream_s), GetStageId(s));
+      compute_commute_table_[good_time][s].AddRecv(batch, recv_pass, good_time, s, GetStageId(s), GetStageId(upstream_s));
     }
 
     // Actions in compute_table_[t] are going be copied to full schedule.
     // For each action, we store its actual time and responsding etage in compute-only schedule.
     // The stored information may be carried to full schedule.
-    for (int s = 0; s < num_stages_; ++s) {
+    for (int s = 0; s < num_virtual_stages_; ++s) {
       auto slot = compute_table_[t][s];
       for (int a = 0; a < static_cast<int>(slot.NumActions()); ++a) {
         auto& task = slot[a];
@@ -348,14 +380,16 @@ void PipelineScheduler::CreateFullSchedule() {
 }
 
 void PipelineScheduler::InsertEvents(std::vector<std::vector<PipelineSlot>>& schedule, const size_t num_events_per_slot, const std::vector<int> initial_events) {
+  // The events chain all the slots of a stage, including those of its different virtual stages.
   std::vector<std::vector<int>> last_recorded_events(num_stages_, initial_events);
 
   for (int t = 0; static_cast<size_t>(t) < schedule.size(); ++t) {
-    for (int s = 0; s < num_stages_; ++s) {
-      if (schedule[t][s].IsEmpty()) {
+    for (int virtual_s = 0; virtual_s < num_virtual_stages_; ++virtual_s) {
+      const int s = GetStageId(virtual_s);
+      if (schedule[t][virtual_s].IsEmpty()) {
         continue;
       }
-      schedule[t][s].SetWaitedEvent(last_recorded_events[s]);
+      schedule[t][virtual_s].SetWaitedEvent(last_recorded_events[s]);
 
       // Create new recorded events. Their indexes should be greater than those of previous events.
       const auto max_event = std::max_element(last_recorded_events[s].begin(), last_recorded_events[s].end());
@@ -364,15 +398,15 @@ void PipelineScheduler::InsertEvents(std::vector<std::vector<PipelineSlot>>& sch
         new_recorded_events.push_back(*max_event + i + 1);
       }
 
-      schedule[t][s].SetRecordedEvent(new_recorded_events);
-      last_recorded_events[s] = schedule[t][s].GetRecordedEvent();
+      schedule[t][virtual_s].SetRecordedEvent(new_recorded_events);
+      last_recorded_events[s] = schedule[t][virtual_s].GetRecordedEvent();
     }
   }
 }
 
 void PipelineScheduler::InsertForwardCompute(const int batch_id, const std::vector<int> forward_time) {
   // Occupy the time slots so that these slots won't be used in later iterations.
-  for (int s = 0; s < num_stages_; ++s) {
+  for (int s = 0; s < num_virtual_stages_; ++s) {
     const auto batch_forward_time = forward_time[s];
     if (s == 0) {
       // The first forward compute has no upstream action.
@@ -386,8 +420,8 @@ void PipelineScheduler::InsertForwardCompute(const int batch_id, const std::vect
 
 void PipelineScheduler::InsertBackwardCompute(const int batch_id, const std::vector<int> forward_time, const std::vector<int> backward_time) {
   // Occupy the time slots so that these slots won't be used in later iterations.
-  const auto last_stage_index = num_stages_ - 1;
-  for (int s = num_stages_ - 1; s >= 0; --s) {
+  const auto last_stage_index = num_virtual_stages_ - 1;
+  for (int s = num_virtual_stages_ - 1; s >= 0; --s) {
     const auto batch_backward_time = backward_time[s];
     if (s == last_stage_index) {
       // The first backward (on the last pipeline stage) depends on the a forward on the last pipeline stage.
@@ -401,14 +435,19 @@ void PipelineScheduler::InsertBackwardCompute(const int batch_id, const std::vec
 
 void PipelineScheduler::CreateComputeSchedule() {
   // Expand table to accomonadate the new batch.
-  const int compute_max_time = 2 * num_stages_ + 2 * (num_batches_ - 1);
-
-  compute_table_.resize(compute_max_time, std::vector<PipelineSlot>(num_stages_));
+  // Without interleaving nor a tighter bound on in-flight batches, the schedule is known to fit in
+  // 2 * num_stages_ + 2 * (num_batches_ - 1) slots. Otherwise, the table is large enough for running
+  // the batches one after the other, and its trailing empty slots are removed at the end.
+  const bool is_default_schedule = num_chunks_ == 1 && max_num_inflight_batches_ >= num_stages_;
+  const int compute_max_time = is_default_schedule ? 2 * num_stages_ + 2 * (num_batches_ - 1)
+                                                   : 2 * num_virtual_stages_ * num_batches_;
+
+  compute_table_.resize(compute_max_time, std::vector<PipelineSlot>(num_virtual_stages_));
   compute_batch_count_.resize(compute_max_time);
   commute_batch_count_.resize(compute_max_time);
 
-  std::vector<int> forward_time(num_stages_, 0);
-  std::vector<int> backward_time(num_stages_, 0);
+  std::vector<int> forward_time(num_virtual_stages_, 0);
+  std::vector<int> backward_time(num_virtual_stages_, 0);
   for (int batch_id = 0; batch_id < num_batches_; ++batch_id) {
     // Find slot to insert forward compute.
     // The search on stage[s] starts at time forward_time[s].
@@ -430,6 +469,16 @@ void PipelineScheduler::CreateComputeSchedule() {
       ++compute_batch_count_[t_compute];
     }
   }
+
+  if (!is_default_schedule) {
+    while (!compute_table_.empty() &&
+           std::all_of(compute_table_.back().begin(), compute_table_.back().end(),
+                       [](const PipelineSlot& slot) { return slot.IsEmpty(); })) {
+      compute_table_.pop_back();
+      compute_batch_count_.pop_back();
+      commute_batch_count_.pop_back();
+    }
+  }
 }
 
 std::vector<int> PipelineScheduler::TryGetEvent(
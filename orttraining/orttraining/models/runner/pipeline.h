@@ -140,21 +140,43 @@ class PipelineSlot {
   std::vector<int> recorded_events_;
 };
 
+// One-forward-one-backward (1F1B) schedule of micro-batches over pipeline stages.
+//
+// Each stage (i.e., rank) may run several model chunks, called virtual stages. Virtual stage
+// chunk * num_stages + stage runs the chunk-th chunk on stage, so a micro-batch goes through all
+// the stages once per chunk. Interleaving the chunks shrinks the bubble at the begin and the end
+// of the pipeline, at the cost of more Send/Recv.
+//
+// The number of micro-batches in the pipeline at any time is bounded, and so is the number of
+// activations each stage keeps for the backward pass.
 class PipelineScheduler {
  public:
   PipelineScheduler(const int num_batches, const int num_stages);
+  // num_chunks is the number of virtual stages per stage.
+  // max_num_inflight_batches is the maximum number of micro-batches between their first forward and
+  // their last backward, 0 means the number of virtual stages.
+  PipelineScheduler(const int num_batches, const int num_stages, const int num_chunks, const int max_num_inflight_batches);
   // Number of time steps.
   size_t GetScheduleSize() const { return compute_commute_table_.size(); }
   // Number of stages.
   size_t GetStageSize() const { return num_stages_; }
+  // Number of virtual stages.
+  size_t GetVirtualStageSize() const { return num_virtual_stages_; }
+  // The virtual stage running the chunk-th model chunk on a stage.
+  int GetVirtualStageId(const int stage_id, const int chunk) const { return chunk * num_stages_ + stage_id; }
+  // The stage running a virtual stage.
+  int GetStageId(const int virtual_stage_id) const { return virtual_stage_id % num_stages_; }
+  // Slots with Send or Recv, in time order, of all the virtual stages on a stage.
   std::vector<PipelineSlot> GetSchedule(const int stage_id) const {
     std::vector<PipelineSlot> commute_slots;
     for (int t = 0; static_cast<size_t>(t) < GetScheduleSize(); ++t) {
-      auto& slot = compute_commute_table_[t][stage_id];
-      if (!slot.HasCommute()) {
-        continue;
+      for (int s = stage_id; s < num_virtual_stages_; s += num_stages_) {
+        auto& slot = compute_commute_table_[t][s];
+        if (!slot.HasCommute()) {
+          continue;
+        }
+        commute_slots.push_back(slot);
       }
-      commute_slots.push_back(slot);
     }
     return commute_slots;
   }
@@ -162,6 +184,8 @@ class PipelineScheduler {
   // APIs to get events for the following pattern.
   //   Wait -> Recv -> Record -> Wait -> Compute -> Record -> Wait -> Send -> Record.
   // If no event exists, -1 may be returned.
+  // stage_id is a virtual stage, which is the stage itself without interleaving.
+  // The events of a stage are ordered across all its virtual stages.
   //
   // Forward Recv.
   int GetForwardRecvWaitedEvent(const int batch_id, const int stage_id) const;
@@ -193,6 +217,8 @@ class PipelineScheduler {
   // i-th returned element is the time of batch_id's backward at stage i.
   // forward_time[s] is the forward time for the given batch on stage s.
   std::vector<int> FindBackwardComputeTime(const std::vector<int> forward_time) const;
+  // Whether the stage running virtual stage s computes at time t.
+  bool IsStageComputing(const int t, const int s) const;
   void CreateComputeSchedule();
   void InsertEvents(std::vector<std::vector<PipelineSlot>>& schedule, const size_t num_events_per_slot, const std::vector<int> initial_events);
   void CreateFullSchedule();
@@ -206,7 +232,7 @@ class PipelineScheduler {
   int GetEventOrDefault(const bool is_waited_event, const int batch_id, const int stage_id, const PipelineTask::Pass pass, const PipelineTask::Type type) const;
 
   // Compute-only pipeline schedule as a 2-D table. table_[i][j] is the computation happening in
-  // the i-th time slot at the j-th stage. For example, PipeDream schedule may have
+  // the i-th time slot at the j-th virtual stage. For example, PipeDream schedule may have
   //   1. table_[0][0].batch_id is 0 and table_[0][0].type is Forward.
   //   2. table_[0][1].type is Empty, which means no computation.
   //   3. table_[1][0].batch_id is 1 and table_[1][0].type is Forward.
@@ -218,6 +244,9 @@ class PipelineScheduler {
   std::vector<int> compute_batch_count_;
   std::vector<int> commute_batch_count_;
   int num_stages_;
+  int num_chunks_;
+  int num_virtual_stages_;
+  int max_num_inflight_batches_;
   int num_batches_;
 };
 
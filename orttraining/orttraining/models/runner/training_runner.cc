@@ -119,6 +119,10 @@ Status TrainingRunner::Initialize() {
       mp.mixed_precision_type = MixedPrecisionDataType::BF16;
     }
     mp.layernorm_stash_as_fp32 = params_.layernorm_stash_as_fp32;
+    if (params_.use_device_loss_scaling) {
+      ORT_RETURN_IF_NOT(params_.loss_scale == 0.0f, "Device loss scaling requires the dynamic loss scale.");
+      mp.use_device_loss_scaling = true;
+    }
     config.mixed_precision_config = mp;
   }
 
@@ -144,6 +148,7 @@ Status TrainingRunner::Initialize() {
     opt.use_mixed_precision_moments = params_.use_mixed_precision_moments;
     opt.do_all_reduce_in_mixed_precision_type = params_.allreduce_in_mixed_precision_type;
     opt.use_nccl = params_.use_nccl;
+    opt.allreduce_bucket_size_in_bytes = params_.allreduce_bucket_size_in_bytes;
     opt.deepspeed_zero = params_.deepspeed_zero;
     opt.adasum_reduction_type = params_.GetAdasumReductionType();
     opt.enable_grad_norm_clip = params_.enable_grad_norm_clip;
@@ -163,6 +168,7 @@ Status TrainingRunner::Initialize() {
 
   if (params_.use_gist) {
     TrainingSession::TrainingConfiguration::GistConfiguration gist{};
+    gist.op_type_to_compression_type = params_.gist_op_type_to_compression_type;
 
     config.gist_config = gist;
   }
@@ -176,6 +182,8 @@ Status TrainingRunner::Initialize() {
     pipe.fetch_names = params_.fetch_names;
     pipe.cut_list = params_.pipeline_partition_cut_list;
     pipe.partitioned_model_path = params_.pipeline_partitioned_model_path;
+    pipe.num_micro_batches = params_.gradient_accumulation_steps;
+    pipe.max_num_inflight_micro_batches = params_.pipeline_max_num_inflight_batches;
     // Do not assign value to config.pipeline_config if pipeline is not used.
     config.pipeline_config = pipe;
   }
@@ -188,10 +196,18 @@ Status TrainingRunner::Initialize() {
     gt_config.gelu_recompute = params_.gelu_recompute;
     gt_config.transformer_layer_recompute = params_.transformer_layer_recompute;
     gt_config.number_recompute_layers = params_.number_recompute_layers;
+    gt_config.megatron_sequence_parallel = params_.megatron_sequence_parallel;
 
     config.graph_transformer_config = gt_config;
   }
 
+  if (params_.activation_offload) {
+    TrainingSession::TrainingConfiguration::ActivationOffloadConfiguration offload_config{};
+    offload_config.min_size_in_bytes = params_.activation_offload_min_size_in_bytes;
+    offload_config.max_size_in_bytes = params_.activation_offload_max_size_in_bytes;
+    config.activation_offload_config = offload_config;
+  }
+
   TrainingSession::TrainingConfigurationResult config_result{};
 
   ORT_RETURN_IF_ERROR(session_.ConfigureForTraining(config, config_result));
@@ -199,7 +215,9 @@ Status TrainingRunner::Initialize() {
   if (config_result.mixed_precision_config_result.has_value()) {
     const std::string& loss_scale_input_name =
         config_result.mixed_precision_config_result.value().loss_scale_input_name;
-    if (params_.loss_scale == 0.0f) {
+    if (params_.use_device_loss_scaling) {
+      // the loss_scale is an initializer updated in the graph, nothing to feed
+    } else if (params_.loss_scale == 0.0f) {
       // use dynamic loss_scale
       loss_scaler_ = onnxruntime::make_unique<LossScaler>(loss_scale_input_name, true, static_cast<float>(1 << 16));
     } else {
@@ -236,6 +254,7 @@ Status TrainingRunner::Initialize() {
 
     pipeline_context_.pipeline_stage_id = config_result.pipeline_config_result.value().pipeline_stage_id;
     pipeline_context_.num_pipeline_batches = params_.gradient_accumulation_steps;
+    pipeline_schedule_ = *config_result.pipeline_config_result.value().pipeline_schedule;
   } else {
     fetch_names = params_.fetch_names;
     pipeline_context_.pipeline_stage_id = 0;
@@ -267,6 +286,9 @@ Status TrainingRunner::Initialize() {
   if (!params_.checkpoints_dir.empty()) {
     checkpoint_registry_ = onnxruntime::make_unique<CheckpointRegistry>(
         params_.checkpoints_dir, params_.max_num_checkpoints);
+    if (params_.async_checkpoint) {
+      checkpoint_saver_ = onnxruntime::make_unique<AsyncCheckpointSaver>(input_allocator_);
+    }
 
     // Load checkpoint, if any
     PathString checkpoint_to_load_path = params_.checkpoint_to_load_path;
@@ -445,7 +467,7 @@ Status TrainingRunner::PrepareFetchNamesAndFetches(const SessionMode mode,
       fetch_names = params_.fetch_names;
 
       if (params_.use_mixed_precision) {
-        if (!params_.use_bfloat16) {
+        if (!params_.use_bfloat16 && !params_.use_device_loss_scaling) {
           auto it = opt_graph_outputs_.find(OptimizerOutputKey::GradientAllIsFinite);
           ORT_RETURN_IF(it == opt_graph_outputs_.end(), "Gradient norm's IsFinite output is missing in the optimizer output");
           fetch_names.push_back(it->second);
@@ -728,7 +750,7 @@ void TrainingRunner::RunWithoutUpdate(VectorString& feed_names,
 Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoader* test_data_loader,
                                     const MapStringToString& mapped_dimensions) {
   const bool enable_checkpoint_saving =
-      MPIContext::GetInstance().GetWorldRank() == 0 &&
+      (MPIContext::GetInstance().GetWorldRank() == 0 || params_.shard_checkpoints) &&
       checkpoint_registry_ && params_.checkpoint_period > 0;
 
   std::unique_ptr<perftest::utils::ICPUUsage> cpu_usage_calculator;
@@ -884,16 +906,24 @@ Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoad
           PathString new_checkpoint_path, old_checkpoint_path;
           bool should_remove_old_checkpoint;
 
+          // the previous checkpoint may still be written to the directory to remove
+          if (checkpoint_saver_) {
+            ORT_RETURN_IF_ERROR(checkpoint_saver_->Wait());
+          }
+
           ORT_RETURN_IF_ERROR(checkpoint_registry_->AddCheckpoint(
               weight_update_step_count_, new_checkpoint_path,
               should_remove_old_checkpoint, old_checkpoint_path));
 
           // ensure checkpoint directory exists
           if (!Env::Default().FolderExists(params_.checkpoints_dir)) {
-            ORT_RETURN_IF_ERROR(Env::Default().CreateFolder(params_.checkpoints_dir));
+            const auto status = Env::Default().CreateFolder(params_.checkpoints_dir);
+            // the other ranks may create it too when checkpoints are sharded
+            ORT_RETURN_IF_NOT(status.IsOK() || Env::Default().FolderExists(params_.checkpoints_dir),
+                              status.ErrorMessage());
           }
 
-          if (should_remove_old_checkpoint) {
+          if (should_remove_old_checkpoint && MPIContext::GetInstance().GetWorldRank() == 0) {
             const auto status = Env::Default().DeleteFolder(old_checkpoint_path);
             LOGS_DEFAULT_IF(!status.IsOK(), WARNING)
                 << "Failed to delete old checkpoint. "
@@ -913,6 +943,10 @@ Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoad
 
     ++epoch;
   }
+  if (checkpoint_saver_) {
+    ORT_RETURN_IF_ERROR(checkpoint_saver_->Wait());
+  }
+
   auto all_steps_time_end = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> all_steps_duration_seconds = all_steps_time_end - all_steps_time_start;
 
@@ -1222,6 +1256,35 @@ Status TrainingRunner::Evaluate(TrainingSession& session, IDataLoader& data_load
   return Status::OK();
 }
 
+namespace {
+// Assigns the state tensors to the shards, the largest first, each to the shard with the fewest bytes so far.
+// All ranks must have the same state tensors.
+NameMLValMap GetCheckpointShardTensors(const NameMLValMap& state_tensors, const CheckpointShard& shard) {
+  std::vector<std::pair<size_t, std::string>> sizes_and_names{};
+  for (const auto& name_and_ort_value : state_tensors) {
+    const OrtValue& ort_value = name_and_ort_value.second;
+    const size_t size_in_bytes = ort_value.IsTensor() ? ort_value.Get<Tensor>().SizeInBytes() : 0;
+    sizes_and_names.emplace_back(size_in_bytes, name_and_ort_value.first);
+  }
+  std::sort(sizes_and_names.begin(), sizes_and_names.end(),
+            [](const std::pair<size_t, std::string>& a, const std::pair<size_t, std::string>& b) {
+              return a.first != b.first ? a.first > b.first : a.second < b.second;
+            });
+
+  std::vector<size_t> shard_sizes(shard.count, 0);
+  NameMLValMap shard_tensors{};
+  for (const auto& size_and_name : sizes_and_names) {
+    const auto smallest_shard = std::min_element(shard_sizes.begin(), shard_sizes.end());
+    *smallest_shard += size_and_name.first;
+    if (smallest_shard - shard_sizes.begin() == shard.index) {
+      shard_tensors.emplace(size_and_name.second, state_tensors.at(size_and_name.second));
+    }
+  }
+
+  return shard_tensors;
+}
+}  // namespace
+
 Status TrainingRunner::SaveCheckpoint(const PathString& checkpoint_path) {
   NameMLValMap checkpointed_tensors{};
   ORT_RETURN_IF_ERROR(session_.GetStateTensors(checkpointed_tensors));
@@ -1229,9 +1292,30 @@ Status TrainingRunner::SaveCheckpoint(const PathString& checkpoint_path) {
   std::unordered_map<std::string, std::string> checkpointed_properties{};
   ORT_RETURN_IF_ERROR(SaveCheckpointProperties(checkpointed_properties));
 
-  ORT_RETURN_IF_ERROR(SaveModelCheckpoint(
-      checkpoint_path, session_.GetDataTransferManager(),
-      checkpointed_tensors, checkpointed_properties));
+  std::unique_ptr<CheckpointShard> shard{};
+  if (params_.shard_checkpoints) {
+    shard = onnxruntime::make_unique<CheckpointShard>();
+    shard->index = MPIContext::GetInstance().GetWorldRank();
+    shard->count = MPIContext::GetInstance().GetWorldSize();
+    // with ZeRO, the partitioned optimizer states differ between the ranks, so each rank saves all of its own
+    if (params_.deepspeed_zero.stage == 0) {
+      checkpointed_tensors = GetCheckpointShardTensors(checkpointed_tensors, *shard);
+    }
+  }
+
+  if (checkpoint_saver_) {
+    ORT_RETURN_IF_ERROR(checkpoint_saver_->Save(
+        checkpoint_path, session_.GetDataTransferManager(),
+        checkpointed_tensors, checkpointed_properties, shard.get()));
+  } else if (shard) {
+    ORT_RETURN_IF_ERROR(SaveModelCheckpoint(
+        checkpoint_path, session_.GetDataTransferManager(),
+        checkpointed_tensors, checkpointed_properties, *shard));
+  } else {
+    ORT_RETURN_IF_ERROR(SaveModelCheckpoint(
+        checkpoint_path, session_.GetDataTransferManager(),
+        checkpointed_tensors, checkpointed_properties));
+  }
 
   return Status::OK();
 }
@@ -1287,7 +1371,9 @@ Status TrainingRunner::LoadCheckpoint(const PathString& checkpoint_path) {
   ORT_RETURN_IF_ERROR(WithOrtValuesFromTensorProtos(
       session_.GetModelLocation(), checkpointed_tensors,
       [this](const NameMLValMap& name_to_ort_value) -> Status {
-        ORT_RETURN_IF_ERROR(session_.SetStateTensors(name_to_ort_value, true));
+        // with ZeRO, a sharded checkpoint also has the optimizer states of the other ranks
+        const bool strict = !(params_.shard_checkpoints && params_.deepspeed_zero.stage != 0);
+        ORT_RETURN_IF_ERROR(session_.SetStateTensors(name_to_ort_value, strict));
         return Status::OK();
       }));
 
@@ -10,6 +10,7 @@
 #include "core/framework/ml_value.h"
 #include "core/providers/providers.h"
 #include "orttraining/core/framework/checkpoint_registry.h"
+#include "orttraining/core/framework/checkpointing.h"
 #include "orttraining/core/framework/mpi_context.h"
 #include "orttraining/core/graph/optimizer_config.h"
 #include "orttraining/core/session/training_session.h"
@@ -91,12 +92,16 @@ class TrainingRunner {
     std::unordered_map<std::string, std::shared_ptr<IExecutionProviderFactory>> providers;
     // Whether to use NCCL for distributed training.
     bool use_nccl = false;
+    // The size limit of the buckets of gradients allreduced with NCCL during the backward pass, 0 for none.
+    size_t allreduce_bucket_size_in_bytes = 0;
     // Whether to partition the optimizer state across nodes for distributed training.
     ZeROConfig deepspeed_zero{};
     // Use Adasum for allreduce.
     bool use_adasum = false;
-    // Use Gist on CPU.
+    // Use Gist to compress the activations stashed for the backward pass.
     bool use_gist = false;
+    // The Gist compression type of each op type, see GistConfiguration. Empty for the default policy.
+    std::unordered_map<std::string, std::string> gist_op_type_to_compression_type;
     // Whether we collect execution profile trace during this run.
     bool use_profiler = false;
     bool skip_evaluation = false;
@@ -108,6 +113,8 @@ class TrainingRunner {
     bool use_mixed_precision = false;
     bool use_bfloat16 = false;
     float loss_scale = 1.0f;
+    // Whether to update the dynamic fp16 loss scale in the graph instead of on the host after each step.
+    bool use_device_loss_scaling = false;
     bool use_mixed_precision_moments = false;
     bool use_mixed_precision_initializer = true;
     bool allreduce_in_mixed_precision_type = false;
@@ -156,12 +163,21 @@ class TrainingRunner {
     size_t checkpoint_period = 0;
     // upper limit on number of checkpoint files to keep
     size_t max_num_checkpoints = 1;
+    // whether to write the checkpoint files in the background, from host copies of the state tensors
+    bool async_checkpoint = false;
+    // whether each rank saves a shard of the checkpoint, otherwise rank 0 saves the whole checkpoint
+    bool shard_checkpoints = false;
 
     int data_parallel_size = 1;
     int horizontal_parallel_size = 1;
+    // whether to shard the sequence dimension of the activations between the horizontal parallel ranks
+    bool megatron_sequence_parallel = false;
     // pipeline_parallel_size > 1 means pipeline is enabled.
     // pipeline_parallel_size == 1 means pipeline is disabled.
     int pipeline_parallel_size = 1;
+    // maximum number of micro-batches in the pipeline at a time, which bounds the activations kept by each stage
+    // 0 means pipeline_parallel_size
+    int pipeline_max_num_inflight_batches = 0;
     // pipeline partition information to do online-partition. If the graph is
     // pre-partitioned, no need to fill this value.
     std::vector<TrainingSession::TrainingConfiguration::CutInfo> pipeline_partition_cut_list;
@@ -184,6 +200,12 @@ class TrainingRunner {
     int number_recompute_layers = 0;
     // Use invertible layernorm grad
     bool use_invertible_layernorm_grad = false;
+    // Offload the activations stashed for the backward pass to host memory
+    bool activation_offload = false;
+    // Activations smaller than this are kept on the device
+    size_t activation_offload_min_size_in_bytes = 1 << 20;
+    // The limit of the total size of the offloaded activations, 0 for no limit
+    size_t activation_offload_max_size_in_bytes = 0;
   };
 
   TrainingRunner(Parameters params, const Environment& env);
@@ -255,6 +277,8 @@ class TrainingRunner {
   AllocatorPtr input_allocator_;
 
   std::unique_ptr<CheckpointRegistry> checkpoint_registry_;
+  // valid only if params_.async_checkpoint is true
+  std::unique_ptr<AsyncCheckpointSaver> checkpoint_saver_;
 
   // Pipeline fields are valid only if params_.pipeline_parallel_size > 1.
   // Information for running pipeline.
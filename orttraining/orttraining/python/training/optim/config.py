@@ -11,7 +11,7 @@ class _OptimizerConfig(object):
 
     Args:
         name (str): optimizer names.
-            One of 'SGDOptimizer', 'AdamOptimizer' and 'LambOptimizer'
+            One of 'SGDOptimizer', 'AdamOptimizer', 'MultiTensorAdamOptimizer' and 'LambOptimizer'
         defaults (dict): optimizer parameters applied to all model parameters.
                          Used when a parameter group doesn’t specify them.
                          NOTE: Every optimizer must have 'lr'.
@@ -39,8 +39,8 @@ class _OptimizerConfig(object):
 
     def __init__(self, name, params, defaults):
         assert isinstance(name, str), "'name' must be a string"
-        assert name in ['AdamOptimizer', 'LambOptimizer', 'SGDOptimizer'], \
-            "'name' must be one of 'AdamOptimizer', 'LambOptimizer' or 'SGDOptimizer'"
+        assert name in ['AdamOptimizer', 'MultiTensorAdamOptimizer', 'LambOptimizer', 'SGDOptimizer'], \
+            "'name' must be one of 'AdamOptimizer', 'MultiTensorAdamOptimizer', 'LambOptimizer' or 'SGDOptimizer'"
         assert isinstance(defaults,
                           dict), "'defaults' must be a dict"
         assert 'lr' in defaults, "'defaults' must contain a {'lr' : positive number} entry"
@@ -129,6 +129,9 @@ class AdamConfig(_OptimizerConfig):
         epsilon (float, default is 1e-8): Small scalar to avoid dividing by zero.
         do_bias_correction (bool, default is True): Compute unbiased 1st and 2nd momentums.
         weight_decay_mode (DecayMode, default is BEFORE_WEIGHT_UPDATE): Selects weight decay update strategy.
+        multi_tensor (bool, default is False): Updates all the parameters with a single 'MultiTensorAdamOptimizer'
+            node, whose CUDA kernel updates many tensors per launch, instead of an 'AdamOptimizer' node per parameter.
+            All parameter groups must then share 'do_bias_correction' and 'weight_decay_mode'.
 
     NOTE: To prevent model parameters to be trained, refer to :py:attr:`.ORTTrainerOptions.utils.frozen_weights`.
 
@@ -149,7 +152,7 @@ class AdamConfig(_OptimizerConfig):
         AFTER_WEIGHT_UPDATE = 1
 
     def __init__(self, params=[], lr=0.001, alpha=0.9, beta=0.999, lambda_coef=0.0, epsilon=1e-8,
-                 do_bias_correction=True, weight_decay_mode=DecayMode.BEFORE_WEIGHT_UPDATE):
+                 do_bias_correction=True, weight_decay_mode=DecayMode.BEFORE_WEIGHT_UPDATE, multi_tensor=False):
         assert lr >= 0, "'lr' must be a positive number"
         assert alpha >= 0, "'alpha' must be a positive number"
         assert beta >= 0, "'beta' must be a positive number"
@@ -157,6 +160,7 @@ class AdamConfig(_OptimizerConfig):
         assert epsilon >= 0, "'epsilon' must be a positive number"
         assert isinstance(do_bias_correction, bool), "'do_bias_correction' must be a boolean"
         assert isinstance(weight_decay_mode, AdamConfig.DecayMode), "'weight_decay_mode' must be a AdamConfig.DecayMode"
+        assert isinstance(multi_tensor, bool), "'multi_tensor' must be a boolean"
         for param in params:
             assert 'lr' not in param, "'lr' is not supported inside params"
 
@@ -167,7 +171,7 @@ class AdamConfig(_OptimizerConfig):
                     'epsilon': epsilon,
                     'do_bias_correction': do_bias_correction,
                     'weight_decay_mode': weight_decay_mode}
-        super().__init__(name='AdamOptimizer',
+        super().__init__(name='MultiTensorAdamOptimizer' if multi_tensor else 'AdamOptimizer',
                          params=params,
                          defaults=defaults)
         self.alpha = alpha
@@ -176,6 +180,7 @@ class AdamConfig(_OptimizerConfig):
         self.epsilon = epsilon
         self.do_bias_correction = do_bias_correction
         self.weight_decay_mode = weight_decay_mode
+        self.multi_tensor = multi_tensor
 
 
 class LambConfig(_OptimizerConfig):
@@ -84,7 +84,7 @@ class ORTTrainerOptions(object):
                                 'stage': {
                                     'type': 'integer',
                                     'min': 0,
-                                    'max': 1,
+                                    'max': 3,
                                     'default': 0
                                 },
                             }
@@ -229,7 +229,8 @@ class ORTTrainerOptions(object):
         distributed.deepspeed_zero_optimization:
             DeepSpeed ZeRO options.
         distributed.deepspeed_zero_optimization.stage (int, default is 0):
-            select which stage of DeepSpeed ZeRO to use. Stage 0 means disabled.
+            select which stage of DeepSpeed ZeRO to use. Stage 0 means disabled, stage 1 partitions the optimizer
+            state, stage 2 also partitions the gradients and stage 3 also partitions the parameters.
         distributed.enable_adasum (bool, default is False):
             enable `Adasum <https://github.com/horovod/horovod/pull/1484>`_
             algorithm for AllReduce
@@ -437,7 +438,7 @@ _ORTTRAINER_OPTIONS_SCHEMA = {
                     'stage': {
                         'type': 'integer',
                         'min': 0,
-                        'max': 1,
+                        'max': 3,
                         'default': 0
                     },
                 }
@@ -111,5 +111,65 @@ TEST(Pipeline, ScheduleB5S3) {
   TestPipelineScheduler(num_batches, num_stages, baseline_events);
 }
 
+TEST(Pipeline, ScheduleB3S2MaxInflightBatches) {
+  const int num_batches = 3;
+  const int num_stages = 2;
+
+  // By default, the forward of a batch can start before the backward of the previous one.
+  onnxruntime::training::pipeline::PipelineScheduler default_schedule(num_batches, num_stages);
+  EXPECT_LT(default_schedule.GetForwardComputeRecordedEvent(1, 0), default_schedule.GetBackwardComputeWaitedEvent(0, 0));
+
+  // With one batch in the pipeline at a time, each stage keeps the activations of one batch.
+  onnxruntime::training::pipeline::PipelineScheduler schedule(num_batches, num_stages, 1, 1);
+  for (int s = 0; s < num_stages; ++s) {
+    for (int b = 0; b + 1 < num_batches; ++b) {
+      EXPECT_LE(schedule.GetBackwardComputeRecordedEvent(b, s), schedule.GetForwardComputeWaitedEvent(b + 1, s))
+          << " batch " << b << " stage " << s;
+    }
+  }
+}
+
+TEST(Pipeline, ScheduleB4S2Interleaved) {
+  const int num_batches = 4;
+  const int num_stages = 2;
+  const int num_chunks = 2;
+
+  onnxruntime::training::pipeline::PipelineScheduler schedule(num_batches, num_stages, num_chunks, 0);
+  ASSERT_EQ(schedule.GetStageSize(), static_cast<size_t>(num_stages));
+  ASSERT_EQ(schedule.GetVirtualStageSize(), static_cast<size_t>(num_stages * num_chunks));
+
+  // The events of a stage order the computes of its chunks:
+  //   FW of chunk 0 -> FW of chunk 1 -> BW of chunk 1 -> BW of chunk 0.
+  for (int s = 0; s < num_stages; ++s) {
+    const int first_chunk = schedule.GetVirtualStageId(s, 0);
+    const int second_chunk = schedule.GetVirtualStageId(s, 1);
+    ASSERT_EQ(schedule.GetStageId(first_chunk), s);
+    ASSERT_EQ(schedule.GetStageId(second_chunk), s);
+
+    for (int b = 0; b < num_batches; ++b) {
+      EXPECT_NE(schedule.GetForwardComputeRecordedEvent(b, first_chunk), -1) << " batch " << b << " stage " << s;
+      EXPECT_LE(schedule.GetForwardComputeRecordedEvent(b, first_chunk),
+                schedule.GetForwardComputeWaitedEvent(b, second_chunk))
+          << " batch " << b << " stage " << s;
+      EXPECT_LE(schedule.GetForwardComputeRecordedEvent(b, second_chunk),
+                schedule.GetBackwardComputeWaitedEvent(b, second_chunk))
+          << " batch " << b << " stage " << s;
+      EXPECT_LE(schedule.GetBackwardComputeRecordedEvent(b, second_chunk),
+                schedule.GetBackwardComputeWaitedEvent(b, first_chunk))
+          << " batch " << b << " stage " << s;
+    }
+
+    // Each stage only communicates with the other one.
+    for (auto& slot : schedule.GetSchedule(s)) {
+      for (auto& task : slot.GetTasks()) {
+        if (task.IsCommute()) {
+          EXPECT_EQ(task.this_rank, s);
+          EXPECT_EQ(task.peer_rank, 1 - s);
+        }
+      }
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
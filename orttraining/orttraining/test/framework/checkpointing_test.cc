@@ -3,12 +3,14 @@
 
 #include "orttraining/core/framework/checkpointing.h"
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 #include "core/common/common.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
@@ -87,26 +89,60 @@ void CompareOrtValuesToTensorProtoValues(
         std::memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0);
   }
 }
-}  // namespace
 
-TEST(CheckpointingTest, SaveAndLoad) {
+void LoadAndCompareModelCheckpoint(
+    const PathString& checkpoint_path,
+    const PathString& model_path,
+    const NameMLValMap& name_to_ort_value,
+    const std::unordered_map<std::string, std::string>& properties) {
+  std::vector<ONNX_NAMESPACE::TensorProto> loaded_tensor_protos{};
+  std::unordered_map<std::string, std::string> loaded_properties{};
+
+  ASSERT_STATUS_OK(LoadModelCheckpoint(
+      checkpoint_path, model_path, loaded_tensor_protos, loaded_properties));
+
+  ASSERT_EQ(loaded_properties, properties);
+
+  std::unordered_map<std::string, ONNX_NAMESPACE::TensorProto> name_to_loaded_tensor_proto{};
+  std::transform(
+      loaded_tensor_protos.begin(), loaded_tensor_protos.end(),
+      std::inserter(name_to_loaded_tensor_proto, name_to_loaded_tensor_proto.end()),
+      [](const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+        return std::make_pair(tensor_proto.name(), tensor_proto);
+      });
+
+  CompareOrtValuesToTensorProtoValues(
+      model_path, name_to_ort_value, name_to_loaded_tensor_proto);
+}
+
+struct CheckpointTestData {
   std::unordered_map<std::string, OrtValueTensorData> name_to_ort_value_data{
       {"first", {{3}, {1.0f, 2.0f, 3.0f}}},
       {"second", {{2, 2}, {1.0f, 2.0f, 3.0f, 4.0f}}},
+      {"third", {{2}, {5.0f, 6.0f}}},
   };
 
-  NameMLValMap name_to_ort_value{};
-  for (auto& name_and_ort_value_data : name_to_ort_value_data) {
-    name_to_ort_value.emplace(
-        name_and_ort_value_data.first, name_and_ort_value_data.second.GetOrtValue());
-  }
-
   std::unordered_map<std::string, std::string> properties{
       {"one", "1"},
       {"two", "2"},
       {"three", "3"},
   };
 
+  NameMLValMap GetNameToOrtValue() {
+    NameMLValMap name_to_ort_value{};
+    for (auto& name_and_ort_value_data : name_to_ort_value_data) {
+      name_to_ort_value.emplace(
+          name_and_ort_value_data.first, name_and_ort_value_data.second.GetOrtValue());
+    }
+    return name_to_ort_value;
+  }
+};
+}  // namespace
+
+TEST(CheckpointingTest, SaveAndLoad) {
+  CheckpointTestData test_data{};
+  const NameMLValMap name_to_ort_value = test_data.GetNameToOrtValue();
+
   TemporaryDirectory tmp_dir{ORT_TSTR("checkpointing_test_dir")};
 
   PathString checkpoint_path{
@@ -119,26 +155,69 @@ TEST(CheckpointingTest, SaveAndLoad) {
   data_transfer.RegisterDataTransfer(onnxruntime::make_unique<CPUDataTransfer>());
 
   ASSERT_STATUS_OK(SaveModelCheckpoint(
-      checkpoint_path, data_transfer, name_to_ort_value, properties));
+      checkpoint_path, data_transfer, name_to_ort_value, test_data.properties));
 
-  std::vector<ONNX_NAMESPACE::TensorProto> loaded_tensor_protos{};
-  std::unordered_map<std::string, std::string> loaded_properties{};
+  LoadAndCompareModelCheckpoint(checkpoint_path, model_path, name_to_ort_value, test_data.properties);
+}
 
-  ASSERT_STATUS_OK(LoadModelCheckpoint(
-      checkpoint_path, model_path, loaded_tensor_protos, loaded_properties));
+TEST(CheckpointingTest, SaveShardsAndLoad) {
+  CheckpointTestData test_data{};
+  const NameMLValMap name_to_ort_value = test_data.GetNameToOrtValue();
 
-  ASSERT_EQ(loaded_properties, properties);
+  TemporaryDirectory tmp_dir{ORT_TSTR("checkpointing_test_dir")};
 
-  std::unordered_map<std::string, ONNX_NAMESPACE::TensorProto> name_to_loaded_tensor_proto{};
-  std::transform(
-      loaded_tensor_protos.begin(), loaded_tensor_protos.end(),
-      std::inserter(name_to_loaded_tensor_proto, name_to_loaded_tensor_proto.end()),
-      [](const ONNX_NAMESPACE::TensorProto& tensor_proto) {
-        return std::make_pair(tensor_proto.name(), tensor_proto);
-      });
+  PathString checkpoint_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("test_checkpoint"))};
+  PathString model_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("test_model.onnx"))};
 
-  CompareOrtValuesToTensorProtoValues(
-      model_path, name_to_ort_value, name_to_loaded_tensor_proto);
+  DataTransferManager data_transfer{};
+  data_transfer.RegisterDataTransfer(onnxruntime::make_unique<CPUDataTransfer>());
+
+  // "second" is saved by both shards and loaded once
+  const NameMLValMap shard_0_ort_values{
+      {"first", name_to_ort_value.at("first")}, {"second", name_to_ort_value.at("second")}};
+  const NameMLValMap shard_1_ort_values{
+      {"second", name_to_ort_value.at("second")}, {"third", name_to_ort_value.at("third")}};
+
+  CheckpointShard shard{};
+  shard.count = 2;
+  shard.index = 1;
+  ASSERT_STATUS_OK(SaveModelCheckpoint(
+      checkpoint_path, data_transfer, shard_1_ort_values, {}, shard));
+  shard.index = 0;
+  ASSERT_STATUS_OK(SaveModelCheckpoint(
+      checkpoint_path, data_transfer, shard_0_ort_values, test_data.properties, shard));
+
+  LoadAndCompareModelCheckpoint(checkpoint_path, model_path, name_to_ort_value, test_data.properties);
+}
+
+TEST(CheckpointingTest, AsyncSaveAndLoad) {
+  CheckpointTestData test_data{}, expected_test_data{};
+  NameMLValMap name_to_ort_value = test_data.GetNameToOrtValue();
+  // the checkpoint has the values from when the save started
+  const NameMLValMap expected_name_to_ort_value = expected_test_data.GetNameToOrtValue();
+
+  TemporaryDirectory tmp_dir{ORT_TSTR("checkpointing_test_dir")};
+
+  PathString checkpoint_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("test_checkpoint"))};
+  PathString model_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("test_model.onnx"))};
+
+  DataTransferManager data_transfer{};
+  data_transfer.RegisterDataTransfer(onnxruntime::make_unique<CPUDataTransfer>());
+
+  AsyncCheckpointSaver saver{std::make_shared<CPUAllocator>()};
+  ASSERT_STATUS_OK(saver.Save(
+      checkpoint_path, data_transfer, name_to_ort_value, test_data.properties));
+
+  auto* first_data = name_to_ort_value.at("first").GetMutable<Tensor>()->MutableData<float>();
+  first_data[0] = -1.0f;
+
+  ASSERT_STATUS_OK(saver.Wait());
+
+  LoadAndCompareModelCheckpoint(checkpoint_path, model_path, expected_name_to_ort_value, test_data.properties);
 }
 
 }  // namespace test
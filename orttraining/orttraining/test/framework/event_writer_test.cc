@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/core/framework/tensorboard/event_writer.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "core/platform/path_lib.h"
+#include "orttraining/core/framework/tensorboard/crc32c.h"
+#include "test/util/include/temp_dir.h"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+#include "tensorboard/compat/proto/event.pb.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+using onnxruntime::test::TemporaryDirectory;
+
+namespace onnxruntime {
+namespace training {
+namespace test {
+
+namespace {
+uint32_t MaskedCrc32c(const char* data, size_t size) {
+  uint32_t value = tensorboard::Crc32c(data, size);
+  return ((value >> 15) | (value << 17)) + 0xa282ead8ul;
+}
+
+// Reads the records of an events file, checking their checksums.
+std::vector<::tensorboard::Event> ReadEvents(const PathString& path) {
+  std::vector<::tensorboard::Event> events;
+  std::ifstream stream(path, std::ios::binary);
+  char header[sizeof(uint64_t) + sizeof(uint32_t)];
+  while (stream.read(header, sizeof(header))) {
+    uint64_t size;
+    uint32_t header_crc;
+    memcpy(&size, header, sizeof(size));
+    memcpy(&header_crc, header + sizeof(uint64_t), sizeof(header_crc));
+    EXPECT_EQ(header_crc, MaskedCrc32c(header, sizeof(uint64_t)));
+
+    std::string data(static_cast<size_t>(size), '\0');
+    uint32_t footer_crc;
+    stream.read(&data[0], data.size());
+    stream.read(reinterpret_cast<char*>(&footer_crc), sizeof(footer_crc));
+    EXPECT_EQ(footer_crc, MaskedCrc32c(data.data(), data.size()));
+
+    events.emplace_back();
+    EXPECT_TRUE(events.back().ParseFromString(data));
+  }
+  return events;
+}
+}  // namespace
+
+TEST(EventWriterTest, WritesEventsInOrder) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("event_writer_test_dir")};
+  PathString events_path{ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("events.out.tfevents"))};
+
+  // More events than the writer keeps pending.
+  const int num_scalars = 3000;
+  {
+    tensorboard::EventWriter writer{std::ofstream(events_path, std::ios::binary)};
+    for (int i = 0; i < num_scalars; ++i) {
+      writer.AddScalar("loss", static_cast<float>(i), i);
+    }
+
+    ::tensorboard::Summary summary;
+    ::tensorboard::Summary::Value* summary_value = summary.add_value();
+    summary_value->set_tag("lr");
+    summary_value->set_simple_value(0.5f);
+    writer.AddSummary(summary.SerializeAsString(), num_scalars, "train");
+  }
+
+  std::vector<::tensorboard::Event> events = ReadEvents(events_path);
+  ASSERT_EQ(events.size(), static_cast<size_t>(num_scalars + 1));
+  for (int i = 0; i < num_scalars; ++i) {
+    ASSERT_EQ(events[i].step(), i);
+    ASSERT_EQ(events[i].summary().value(0).tag(), "loss");
+    ASSERT_EQ(events[i].summary().value(0).simple_value(), static_cast<float>(i));
+  }
+  ASSERT_EQ(events.back().step(), num_scalars);
+  ASSERT_EQ(events.back().summary().value(0).tag(), "train/lr");
+  ASSERT_EQ(events.back().summary().value(0).simple_value(), 0.5f);
+}
+
+TEST(EventWriterTest, Flush) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("event_writer_flush_test_dir")};
+  PathString events_path{ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("events.out.tfevents"))};
+
+  tensorboard::EventWriter writer{std::ofstream(events_path, std::ios::binary)};
+  writer.AddScalar("loss", 1.0f, 1);
+  writer.AddScalar("loss", 2.0f, 2);
+  writer.Flush();
+
+  std::vector<::tensorboard::Event> events = ReadEvents(events_path);
+  ASSERT_EQ(events.size(), static_cast<size_t>(2));
+  ASSERT_EQ(events[1].summary().value(0).simple_value(), 2.0f);
+}
+
+}  // namespace test
+}  // namespace training
+}  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <bitset>
 #include <cmath>
+#include <limits>
 #include <random>
 #include <thread>
 
@@ -1808,6 +1809,50 @@ TEST(GradientUtilsTest, ZeroGradientFloat16) {
 }
 #endif
 
+TEST(GradientUtilsTest, DynamicLossScaleFinite) {
+  OpTester test("DynamicLossScale", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("up_scale_window", static_cast<int64_t>(3));
+
+  test.AddInput<float>("loss_scale", {1}, {1024.0f});
+  test.AddInput<int64_t>("stable_steps", {1}, {2});
+  test.AddInput<float>("gradient_norm", {}, {10.0f});
+
+  test.AddOutput<float>("loss_scale_out", {1}, {2048.0f});
+  test.AddOutput<int64_t>("stable_steps_out", {1}, {0});
+
+  test.Run();
+}
+
+TEST(GradientUtilsTest, DynamicLossScaleFiniteMaxLossScale) {
+  OpTester test("DynamicLossScale", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("up_scale_window", static_cast<int64_t>(3));
+  test.AddAttribute("max_loss_scale", 1024.0f);
+
+  test.AddInput<float>("loss_scale", {1}, {1024.0f});
+  test.AddInput<int64_t>("stable_steps", {1}, {2});
+  test.AddInput<float>("gradient_norm", {}, {10.0f});
+
+  test.AddOutput<float>("loss_scale_out", {1}, {1024.0f});
+  test.AddOutput<int64_t>("stable_steps_out", {1}, {0});
+
+  test.Run();
+}
+
+TEST(GradientUtilsTest, DynamicLossScaleOverflow) {
+  OpTester test("DynamicLossScale", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("min_loss_scale", 512.0f);
+
+  test.AddInput<float>("loss_scale", {1}, {1024.0f});
+  test.AddInput<int64_t>("stable_steps", {1}, {100});
+  test.AddInput<float>("gradient_norm", {}, {std::numeric_limits<float>::infinity()});
+  test.AddInput<bool>("update_signal", {}, {true});
+
+  test.AddOutput<float>("loss_scale_out", {1}, {512.0f});
+  test.AddOutput<int64_t>("stable_steps_out", {1}, {0});
+
+  test.Run();
+}
+
 TEST(GradientCheckerTest, WhereGrad) {
   float max_error;
   GradientChecker<float, float, float> gradient_checker;
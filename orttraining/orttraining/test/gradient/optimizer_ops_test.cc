@@ -365,6 +365,106 @@ TEST(OptimizerTest, AdamOptimizerMixPrecisionTest_Gradient) {
   test.Run();
 }
 
+TEST(OptimizerTest, MultiTensorAdamOptimizerTest) {
+  OpTester test("MultiTensorAdamOptimizer", 1, onnxruntime::kMSDomain);
+  AdamOptimizerInputOutput data;
+
+  test.AddMissingOptionalInput<bool>();
+  test.AddMissingOptionalInput<float>();
+  test.AddMissingOptionalInput<float>();
+  test.AddInput<float>("ETA", {}, data.eta);
+  test.AddInput<int64_t>("Update_Count", {}, {3});
+  test.AddOutput<int64_t>("Update_Count_Out", {}, {4});
+
+  // The first weight outputs its new weight and the second one its new gradient.
+  test.AddInput<float>("W_1", {3}, data.w);
+  test.AddInput<float>("G_1", {3}, data.g);
+  test.AddInput<float>("Moment_1_1", {3}, data.m1);
+  test.AddInput<float>("Moment_2_1", {3}, data.m2);
+  test.AddMissingOptionalInput<MLFloat16>();
+  test.AddInput<float>("W_2", {3}, data.w);
+  test.AddInput<float>("G_2", {3}, data.g);
+  test.AddInput<float>("Moment_1_2", {3}, data.m1);
+  test.AddInput<float>("Moment_2_2", {3}, data.m2);
+
+  test.AddOutput<float>("W_1_Out", {3}, data.w_new);
+  test.AddMissingOptionalOutput<float>();
+  test.AddOutput<float>("Moment_1_1_Out", {3}, data.m1_new);
+  test.AddOutput<float>("Moment_2_1_Out", {3}, data.m2_new);
+  test.AddMissingOptionalOutput<MLFloat16>();
+  test.AddMissingOptionalOutput<float>();
+  test.AddOutput<float>("G_2_Out", {3}, data.g_new);
+  test.AddOutput<float>("Moment_1_2_Out", {3}, data.m1_new);
+  test.AddOutput<float>("Moment_2_2_Out", {3}, data.m2_new);
+
+  test.AddAttribute("do_bias_correction", static_cast<int64_t>(0));
+  test.AddAttribute("weight_decay_mode", static_cast<int64_t>(0));
+
+  test.Run();
+}
+
+TEST(OptimizerTest, MultiTensorAdamOptimizerMixPrecision_FP16Weight_Test) {
+  OpTester test("MultiTensorAdamOptimizer", 1, onnxruntime::kMSDomain);
+  AdamOptimizerInputOutput data;
+
+  test.AddInput<bool>("DoUpdate", {1}, {true});
+  test.AddInput<float>("loss_scale", {1}, {1.0f});
+  // grad clipping should not take effect
+  test.AddInput<float>("grad_norm", {1}, {0.01f});
+  test.AddInput<MLFloat16>("ETA", {}, data.eta_half);
+  test.AddInput<int64_t>("Update_Count", {}, {3});
+  test.AddOutput<int64_t>("Update_Count_Out", {}, {4});
+
+  for (int i = 0; i < 2; ++i) {
+    const std::string suffix = "_" + std::to_string(i);
+    test.AddInput<float>("W" + suffix, {3}, data.w);
+    test.AddInput<MLFloat16>("G" + suffix, {3}, data.g_half);
+    test.AddInput<MLFloat16>("Moment_1" + suffix, {3}, data.m1_half);
+    test.AddInput<MLFloat16>("Moment_2" + suffix, {3}, data.m2_half);
+    test.AddInput<MLFloat16>("FP16_W" + suffix, {3}, data.w_half);
+
+    test.AddOutput<float>("W_Out" + suffix, {3}, data.w_new);
+    test.AddMissingOptionalOutput<MLFloat16>();
+    test.AddOutput<MLFloat16>("Moment_1_Out" + suffix, {3}, data.m1_new_half);
+    test.AddOutput<MLFloat16>("Moment_2_Out" + suffix, {3}, data.m2_new_half);
+    test.AddOutput<MLFloat16>("FP16_W_Out" + suffix, {3}, data.w_new_half);
+  }
+
+  test.AddAttribute("do_bias_correction", static_cast<int64_t>(0));
+  test.AddAttribute("weight_decay_mode", static_cast<int64_t>(0));
+
+  test.Run();
+}
+
+TEST(OptimizerTest, MultiTensorAdamOptimizerMixPrecision_FP16Weight_SkipUpdate_Test) {
+  OpTester test("MultiTensorAdamOptimizer", 1, onnxruntime::kMSDomain);
+  AdamOptimizerInputOutput data;
+
+  test.AddInput<bool>("DoUpdate", {1}, {false});
+  test.AddInput<float>("loss_scale", {1}, {1.0f});
+  test.AddInput<float>("grad_norm", {1}, {0.01f});
+  test.AddInput<MLFloat16>("ETA", {}, data.eta_half);
+  test.AddInput<int64_t>("Update_Count", {}, {3});
+  test.AddOutput<int64_t>("Update_Count_Out", {}, {3});
+
+  test.AddInput<float>("W", {3}, data.w);
+  test.AddInput<MLFloat16>("G", {3}, data.g_half);
+  test.AddInput<MLFloat16>("Moment_1", {3}, data.m1_half);
+  test.AddInput<MLFloat16>("Moment_2", {3}, data.m2_half);
+  test.AddInput<MLFloat16>("FP16_W", {3}, data.w_half);
+
+  test.AddOutput<float>("W_Out", {3}, data.w);
+  test.AddMissingOptionalOutput<MLFloat16>();
+  test.AddOutput<MLFloat16>("Moment_1_Out", {3}, data.m1_half);
+  test.AddOutput<MLFloat16>("Moment_2_Out", {3}, data.m2_half);
+  test.AddOutput<MLFloat16>("FP16_W_Out", {3}, data.w_half);
+
+  test.AddAttribute("do_bias_correction", static_cast<int64_t>(0));
+  test.AddAttribute("weight_decay_mode", static_cast<int64_t>(0));
+
+  test.Run();
+}
+
 // This helper function is a CPU-based LAMB optimizer
 // implementation. It mainly focuses on readability.
 void compute_lamb(
@@ -231,6 +231,26 @@ TEST(GradientGraphBuilderTest, TrainingSession_WithGist) {
   RunTrainingSessionWithChecks(so, backprop_model_file);
 }
 
+TEST(GradientGraphBuilderTest, TrainingSession_WithGistPack16) {
+  auto config = MakeBasicTrainingConfig();
+  TrainingSession::TrainingConfiguration::GistConfiguration gist_config{};
+  gist_config.op_type_to_compression_type = {{"Relu", onnxruntime::GistEncodeDecode::GIST_PACK16}};
+  config.gist_config = gist_config;
+  PathString backprop_model_file;
+  ASSERT_STATUS_OK(BuildBackPropGraph(ORIGINAL_MODEL_PATH, config, backprop_model_file));
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(onnxruntime::Model::Load(backprop_model_file, p_model, nullptr, DefaultLoggingManager().DefaultLogger()));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(p_model->MainGraph());
+  ASSERT_GT(op_to_count["com.microsoft.GistPack16Encoder"], 0);
+  ASSERT_EQ(op_to_count["com.microsoft.GistPack16Encoder"], op_to_count["com.microsoft.GistPack16Decoder"]);
+  ASSERT_EQ(op_to_count["com.microsoft.GistBinarizeEncoder"], 0);
+
+  SessionOptions so{};
+  RunTrainingSessionWithChecks(so, backprop_model_file);
+}
+
 TEST(GradientGraphBuilderTest, TrainingSession_WithLogging) {
   const auto& log_manager = DefaultLoggingManager();
   const auto& default_logger = log_manager.DefaultLogger();
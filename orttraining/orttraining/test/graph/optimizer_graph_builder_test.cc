@@ -11,6 +11,7 @@
 #include "gtest/gtest.h"
 
 #include "core/common/common.h"
+#include "core/framework/session_options.h"
 #include "core/graph/graph.h"
 #include "core/graph/model.h"
 #include "orttraining/core/graph/gradient_builder_base.h"
@@ -33,15 +34,19 @@ namespace {
 const std::vector<const char*> k_weight_names{"weight_1", "weight_2"};
 constexpr const char* const k_loss_scaling_factor_name = "loss_scaling_factor";
 constexpr const char* const k_optimizer_op_name = "AdamOptimizer";
+constexpr const char* const k_multi_tensor_optimizer_op_name = "MultiTensorAdamOptimizer";
 constexpr const char* const k_horovod_all_reduce_op_name = "HorovodAllReduce";
 constexpr const char* const k_all_reduce_op_name = "NcclAllReduce";
+constexpr const char* const k_nccl_wait_op_name = "NcclWait";
 constexpr const char* const k_all_gather_op_name = "NcclAllGather";
+constexpr const char* const k_all_gather_v_op_name = "NcclAllGatherV";
 constexpr const char* const k_reduce_scatter_op_name = "NcclReduceScatter";
 constexpr const char* const k_is_all_finite_op_name = "IsAllFinite";
 constexpr const char* const k_gradient_norm_op_name = "ReduceAllL2";
 constexpr const char* const k_unscale_op_name = "MixedPrecisionScale";
 constexpr const char* const k_inplace_accumulator_op_name = "InPlaceAccumulator";
 constexpr const char* const k_zero_gradient_op_name = "ZeroGradient";
+constexpr const char* const k_dynamic_loss_scale_op_name = "DynamicLossScale";
 
 Status SetUpBaseGraph(Graph& graph);
 
@@ -96,13 +101,14 @@ Status SetUpBaseGraph(Graph& graph) {
   return graph.Resolve(resolve_options);
 }
 
-std::unordered_map<std::string, OptimizerNodeConfig> GetOptInfoMap() {
+std::unordered_map<std::string, OptimizerNodeConfig> GetOptInfoMap(
+    const std::string& optimizer_op_name = k_optimizer_op_name) {
   std::unordered_map<std::string, OptimizerNodeConfig> result{};
   std::transform(
       k_weight_names.begin(), k_weight_names.end(), std::inserter(result, result.end()),
-      [](const std::string& weight_name) {
+      [&optimizer_op_name](const std::string& weight_name) {
         return std::make_pair(
-            weight_name, OptimizerNodeConfig{k_optimizer_op_name, nullptr, "Learning_Rate", {}});
+            weight_name, OptimizerNodeConfig{optimizer_op_name, nullptr, "Learning_Rate", {}});
       });
   return result;
 }
@@ -184,6 +190,89 @@ TEST_F(OptimizerGraphBuilderTest, Default_WithGradientAccumulation_WithMixedPrec
   TestDefaultOptimizerGraphBuilder(config, graph_);
 }
 
+TEST_F(OptimizerGraphBuilderTest, Default_WithMixedPrecision_DeviceLossScaling) {
+  OptimizerGraphConfig config;
+  config.gradient_accumulation_steps = 1;
+  config.use_mixed_precision = true;
+  config.loss_scale_input_name = k_loss_scaling_factor_name;
+  config.use_device_loss_scaling = true;
+
+  OptimizerGraphBuilder optimizer_graph_builder(
+      GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph_, opt_initializer_names, opt_graph_outputs));
+
+  auto op_counts = CountOpsInGraph(graph_, false);
+
+  // the optimizers skip the overflowed steps from the gradient norm, no host-side check is needed
+  ASSERT_GT(GetOpCount(op_counts, k_gradient_norm_op_name), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_is_all_finite_op_name), 0);
+  ASSERT_EQ(opt_graph_outputs.count(OptimizerOutputKey::GradientAllIsFinite), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_dynamic_loss_scale_op_name), 1);
+
+  for (const auto& node : graph_.Nodes()) {
+    if (node.OpType() == k_dynamic_loss_scale_op_name) {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), k_loss_scaling_factor_name);
+      ASSERT_EQ(opt_initializer_names.count(node.InputDefs()[1]->Name()), 1);
+      // the in-place loss scale update runs after the optimizers
+      const Node* update_signal_producer = graph_.GetProducerNode(node.InputDefs()[3]->Name());
+      ASSERT_NE(update_signal_producer, nullptr);
+      ASSERT_EQ(update_signal_producer->OpType(), "Group");
+      ASSERT_EQ(update_signal_producer->InputDefs().size(), k_weight_names.size());
+    }
+    if (node.OpType() == k_optimizer_op_name) {
+      // [ETA, Update_Count, W, G, Moment_1, Moment_2, W_mixed_precision, loss_scale, grad_norm, do_update]
+      ASSERT_TRUE(node.InputDefs()[8]->Exists());
+      ASSERT_TRUE(node.InputDefs().size() < 10 || !node.InputDefs()[9]->Exists());
+    }
+  }
+}
+
+static void TestMultiTensorOptimizerGraphBuilder(OptimizerGraphConfig config, Graph& graph) {
+  OptimizerGraphBuilder optimizer_graph_builder(
+      GetOptimizerBuilderRegistry(), config, GetOptInfoMap(k_multi_tensor_optimizer_op_name));
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph, opt_initializer_names, opt_graph_outputs));
+
+  auto op_counts = CountOpsInGraph(graph, false);
+
+  // verify a single optimizer updates all weights
+  ASSERT_EQ(GetOpCount(op_counts, k_multi_tensor_optimizer_op_name), 1);
+  ASSERT_EQ(GetOpCount(op_counts, k_optimizer_op_name), 0);
+
+  const Node* optimizer_node = nullptr;
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == k_multi_tensor_optimizer_op_name) {
+      optimizer_node = &node;
+    }
+  }
+  ASSERT_NE(optimizer_node, nullptr);
+  // [update_signal, loss_scale, grad_norm, eta, step] and [w, g, m1, m2, w_mixed_precision] per weight
+  ASSERT_EQ(optimizer_node->InputDefs().size(), 5 + 5 * k_weight_names.size());
+  ASSERT_EQ(optimizer_node->OutputDefs().size(), 1 + 5 * k_weight_names.size());
+  ASSERT_EQ(optimizer_node->InputDefs()[0]->Exists(), config.use_mixed_precision);
+  ASSERT_EQ(opt_initializer_names.count("Update_Count"), 1);
+}
+
+TEST_F(OptimizerGraphBuilderTest, MultiTensor_NoGradientAccumulation_NoMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.gradient_accumulation_steps = 1;
+  config.use_mixed_precision = false;
+  TestMultiTensorOptimizerGraphBuilder(config, graph_);
+}
+
+TEST_F(OptimizerGraphBuilderTest, MultiTensor_WithGradientAccumulation_WithMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.gradient_accumulation_steps = 10;
+  config.use_mixed_precision = true;
+  config.loss_scale_input_name = k_loss_scaling_factor_name;
+  TestMultiTensorOptimizerGraphBuilder(config, graph_);
+}
+
 #if defined(USE_NCCL) || defined(USE_HOROVOD)
 static void TestAllreduceOptimizerGraphBuilder(OptimizerGraphConfig config, Graph& graph) {
   AllreduceOptimizerGraphBuilder optimizer_graph_builder(
@@ -377,6 +466,34 @@ TEST_F(OptimizerGraphBuilderTest, Allreduce_WithGradientAccumulation_WithMixedPr
   TestAllreduceOptimizerGraphBuilder(config, graph_);
 }
 
+TEST_F(OptimizerGraphBuilderTest, Allreduce_Buckets) {
+  for (size_t bucket_size : {size_t{4}, size_t{8}}) {
+    Model model{"test_model", false, onnxruntime::test::DefaultLoggingManager().DefaultLogger()};
+    Graph& graph = model.MainGraph();
+    ASSERT_STATUS_OK(SetUpBaseGraph(graph));
+
+    OptimizerGraphConfig config;
+    config.data_parallel_group_size = 4;
+    config.use_nccl = true;
+    config.gradient_accumulation_steps = 1;
+    config.use_mixed_precision = true;
+    config.loss_scale_input_name = k_loss_scaling_factor_name;
+    // each weight has 4 bytes
+    config.allreduce_bucket_size_in_bytes = bucket_size;
+    TestAllreduceOptimizerGraphBuilder(config, graph);
+
+    const int num_buckets = bucket_size == 4 ? 2 : 1;
+    auto op_counts = CountOpsInGraph(graph, false);
+    ASSERT_EQ(GetOpCount(op_counts, k_all_reduce_op_name), num_buckets);
+    ASSERT_EQ(GetOpCount(op_counts, k_nccl_wait_op_name), num_buckets);
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == k_all_reduce_op_name) {
+        EXPECT_EQ(node.Priority(), static_cast<int>(ExecutionPriority::LOCAL_HIGH));
+      }
+    }
+  }
+}
+
 static void TestZeROOptimizerGraphBuilder(OptimizerGraphConfig config, Graph& graph) {
   ZeROOptimizerGraphBuilder optimizer_graph_builder(
       GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
@@ -452,6 +569,101 @@ TEST_F(OptimizerGraphBuilderTest, ZeRO_WithGradientAccumulation_WithMixedPrecisi
   TestZeROOptimizerGraphBuilder(config, graph_);
 }
 
+TEST_F(OptimizerGraphBuilderTest, ZeRO_Stage2_WithGradientAccumulation_NoMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{2};
+  config.gradient_accumulation_steps = 10;
+  config.use_mixed_precision = false;
+  TestZeROOptimizerGraphBuilder(config, graph_);
+}
+
+TEST_F(OptimizerGraphBuilderTest, ZeRO_Stage2_WithGradientAccumulation_WithMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{2};
+  config.gradient_accumulation_steps = 10;
+  config.use_mixed_precision = true;
+  config.loss_scale_input_name = k_loss_scaling_factor_name;
+  TestZeROOptimizerGraphBuilder(config, graph_);
+}
+
+// adds a node consuming the first weight, which gathers it from its partitions with ZeRO stage 3
+static Status AddWeightConsumer(Graph& graph) {
+  NodeArg* weight_arg = graph.GetNodeArg(k_weight_names[0]);
+  NodeArg& output_arg = graph.GetOrCreateNodeArg("weight_consumer_output", weight_arg->TypeAsProto());
+  graph.AddNode("weight_consumer", "Identity", "", {weight_arg}, {&output_arg});
+
+  std::unordered_set<std::string> initializer_names;
+  for (const auto& weight_name : k_weight_names) {
+    initializer_names.emplace(weight_name);
+    initializer_names.emplace(GradientBuilderBase::GradientName(weight_name));
+  }
+  Graph::ResolveOptions resolve_options{};
+  resolve_options.initializer_names_to_preserve = &initializer_names;
+  return graph.Resolve(resolve_options);
+}
+
+static void TestZeROStage3OptimizerGraphBuilder(OptimizerGraphConfig config, Graph& graph,
+                                                size_t expected_num_partitioned_weights) {
+  ASSERT_STATUS_OK(AddWeightConsumer(graph));
+
+  ZeROOptimizerGraphBuilder optimizer_graph_builder(
+      GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph, opt_initializer_names, opt_graph_outputs));
+
+  auto op_counts = CountOpsInGraph(graph, false);
+
+  // verify only the gradients of this rank's partition are accumulated
+  if (config.gradient_accumulation_steps > 1) {
+    ASSERT_EQ(GetOpCount(op_counts, k_inplace_accumulator_op_name), expected_num_partitioned_weights);
+    ASSERT_EQ(GetOpCount(op_counts, k_zero_gradient_op_name), expected_num_partitioned_weights);
+    ASSERT_GT(opt_graph_outputs.count(OptimizerOutputKey::GradientAccumulation), 0);
+  }
+
+  // verify the weight is gathered for its consumer, and not after the update
+  ASSERT_GT(GetOpCount(op_counts, k_reduce_scatter_op_name), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_all_gather_v_op_name), 1);
+  ASSERT_EQ(GetOpCount(op_counts, k_all_gather_op_name), 0);
+
+  // verify the initializers only hold this rank's partition
+  const ONNX_NAMESPACE::TensorProto* weight_initializer = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor(k_weight_names[0], weight_initializer));
+  ASSERT_EQ(weight_initializer->dims_size(), 1);
+  ASSERT_EQ(weight_initializer->dims(0), expected_num_partitioned_weights > 0 ? 1 : 0);
+
+  // verify optimizers exist for this rank's partition
+  ASSERT_EQ(GetOpCount(op_counts, k_optimizer_op_name), expected_num_partitioned_weights);
+}
+
+TEST_F(OptimizerGraphBuilderTest, ZeRO_Stage3_WithGradientAccumulation_NoMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 2;
+  config.data_parallel_group_rank = 0;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{3};
+  config.gradient_accumulation_steps = 10;
+  config.use_mixed_precision = false;
+  // the two weights of one element are both in the partition of rank 0
+  TestZeROStage3OptimizerGraphBuilder(config, graph_, k_weight_names.size());
+}
+
+TEST_F(OptimizerGraphBuilderTest, ZeRO_Stage3_EmptyPartition) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 2;
+  config.data_parallel_group_rank = 1;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{3};
+  config.gradient_accumulation_steps = 1;
+  config.use_mixed_precision = false;
+  TestZeROStage3OptimizerGraphBuilder(config, graph_, 0);
+}
+
 #endif  // USE_NCCL
 
 }  // namespace test
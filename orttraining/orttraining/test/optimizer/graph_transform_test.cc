@@ -15,6 +15,7 @@
 #include "orttraining/core/optimizer/nonzero_shape_setter.h"
 #include "orttraining/core/optimizer/megatron_transformer.h"
 #include "orttraining/core/optimizer/concat_replacement.h"
+#include "orttraining/core/optimizer/activation_offload.h"
 #include "test/optimizer/graph_transform_test_fixture.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/asserts.h"
@@ -109,6 +110,61 @@ TEST_F(GraphTransformationTests, NonZeroShapeSetter) {
   ASSERT_TRUE(nonzero_shape->dim(1).dim_param() == "nonzero_nonzero_count");
 }
 
+// builds a graph whose activation y is stashed for the backward pass for 3 nodes, and c for 1 node
+static Status BuildStashedActivationGraph(Graph& graph) {
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  std::unordered_map<std::string, NodeArg*> args;
+  for (const char* name : {"x", "y", "a", "b", "c", "d"}) {
+    args[name] = &graph.GetOrCreateNodeArg(name, &float_tensor);
+  }
+
+  graph.AddNode("relu", "Relu", "", {args["x"]}, {args["y"]});
+  graph.AddNode("neg_1", "Neg", "", {args["y"]}, {args["a"]});
+  graph.AddNode("neg_2", "Neg", "", {args["a"]}, {args["b"]});
+  graph.AddNode("neg_3", "Neg", "", {args["b"]}, {args["c"]});
+  graph.AddNode("add_grad", "Add", "Backward pass", {args["c"], args["y"]}, {args["d"]});
+  return graph.Resolve();
+}
+
+TEST_F(GraphTransformationTests, ActivationOffload) {
+  Model model("ActivationOffload", false, *logger_);
+  Graph& graph = model.MainGraph();
+  ASSERT_STATUS_OK(BuildStashedActivationGraph(graph));
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ActivationOffload>(0, 2, 0), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  // only y is stashed for long enough
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MemcpyToHost"], 1);
+  ASSERT_EQ(op_to_count["MemcpyFromHost"], 1);
+
+  const Node* add_grad = GetNodeByName(graph, "add_grad");
+  ASSERT_EQ(add_grad->InputDefs()[0]->Name(), "c");
+  ASSERT_EQ(graph.GetProducerNode(add_grad->InputDefs()[1]->Name())->OpType(), "MemcpyFromHost");
+  ASSERT_EQ(GetNodeByName(graph, "neg_1")->InputDefs()[0]->Name(), "y");
+}
+
+TEST_F(GraphTransformationTests, ActivationOffloadSizeLimit) {
+  Model model("ActivationOffload", false, *logger_);
+  Graph& graph = model.MainGraph();
+  ASSERT_STATUS_OK(BuildStashedActivationGraph(graph));
+
+  // y has 24 bytes
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ActivationOffload>(0, 2, 16), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MemcpyToHost"], 0);
+  ASSERT_EQ(op_to_count["MemcpyFromHost"], 0);
+}
+
 // MegatronF/G and ConcatTraining is defined only for training, and in msdomain.
 #ifndef DISABLE_CONTRIB_OPS
 TEST_F(GraphTransformationTests, ConcatReplacement) {
@@ -395,6 +451,92 @@ TEST_F(GraphTransformationTests, MegatronSelfAttentionPartitionRank1) {
   }
 }
 
+// builds an MLP block followed by the residual connection, a LayerNorm and a replicated output projection
+static Status BuildMLPResidualLayerNormGraph(Graph& graph) {
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto input_tensor = float_tensor;
+  for (int64_t dim : {2, 4, 4}) {
+    input_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  std::unordered_map<std::string, NodeArg*> args;
+  args["x"] = &graph.GetOrCreateNodeArg("x", &input_tensor);
+  for (const char* name : {"m1", "a1", "g", "m2", "a2", "r", "ln", "y"}) {
+    args[name] = &graph.GetOrCreateNodeArg(name, &float_tensor);
+  }
+
+  auto add_initializer = [&graph, &args](const std::string& name, const std::vector<int64_t>& dims) {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      tensor.add_float_data(0.01f * i);
+    }
+    args[name] = &graph_utils::AddInitializer(graph, tensor);
+  };
+  add_initializer("w1", {4, 16});
+  add_initializer("b1", {16});
+  add_initializer("w2", {16, 4});
+  add_initializer("b2", {4});
+  add_initializer("scale", {4});
+  add_initializer("bias", {4});
+  add_initializer("w3", {4, 4});
+
+  graph.AddNode("matmul", "MatMul", "", {args["x"], args["w1"]}, {args["m1"]});
+  graph.AddNode("add", "Add", "", {args["m1"], args["b1"]}, {args["a1"]});
+  graph.AddNode("gelu", "Gelu", "", {args["a1"]}, {args["g"]}, nullptr, kMSDomain);
+  graph.AddNode("matmul2", "MatMul", "", {args["g"], args["w2"]}, {args["m2"]});
+  graph.AddNode("add2", "Add", "", {args["m2"], args["b2"]}, {args["a2"]});
+  graph.AddNode("residual", "Add", "", {args["a2"], args["x"]}, {args["r"]});
+  graph.AddNode("layer_norm", "LayerNormalization", "", {args["r"], args["scale"], args["bias"]}, {args["ln"]});
+  graph.AddNode("head", "MatMul", "", {args["ln"], args["w3"]}, {args["y"]});
+  return graph.Resolve();
+}
+
+TEST_F(GraphTransformationTests, MegatronMLPSequenceParallel) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 12;
+  domain_to_version[kMSDomain] = 1;
+  Model model("MegatronMLPSequenceParallel", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(), *logger_);
+  Graph& graph = model.MainGraph();
+  ASSERT_STATUS_OK(BuildMLPResidualLayerNormGraph(graph));
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<MegatronTransformer>(0, 2, std::unordered_set<std::string>{}, true),
+                                    TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  // The bias Add and the LayerNorm parameters are reduced with MegatronF, besides the MLP input.
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["com.microsoft.MegatronG"], 0);
+  ASSERT_EQ(op_to_count["com.microsoft.MegatronReduceScatter"], 1);
+  ASSERT_EQ(op_to_count["com.microsoft.MegatronSlice"], 1);
+  ASSERT_EQ(op_to_count["com.microsoft.MegatronAllGather"], 1);
+  ASSERT_EQ(op_to_count["com.microsoft.MegatronF"], 4);
+
+  const Node* residual = GetNodeByName(graph, "residual");
+  ASSERT_EQ(graph.GetProducerNode(residual->InputDefs()[1]->Name())->OpType(), "MegatronSlice");
+  const Node* head = GetNodeByName(graph, "head");
+  const Node* gather = graph.GetProducerNode(head->InputDefs()[0]->Name());
+  ASSERT_EQ(gather->OpType(), "MegatronAllGather");
+  ASSERT_EQ(graph_utils::GetNodeAttribute(*gather, "reduce_gradient")->i(), 0);
+
+  // The LayerNorm computes its chunk of the sequence, the output projection the whole sequence.
+  const auto* ln_shape = GetNodeByName(graph, "layer_norm")->OutputDefs()[0]->Shape();
+  ASSERT_NE(ln_shape, nullptr);
+  ASSERT_EQ(ln_shape->dim(1).dim_value(), 2);
+  const auto* y_shape = head->OutputDefs()[0]->Shape();
+  ASSERT_NE(y_shape, nullptr);
+  ASSERT_EQ(y_shape->dim(1).dim_value(), 4);
+}
+
 // We only tested on CUDA run.
 #if defined(USE_CUDA)
 TEST_F(GraphTransformationTests, MegatronMLPPartitionCorrectnessTest) {
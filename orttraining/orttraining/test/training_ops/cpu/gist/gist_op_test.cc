@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+const std::vector<int64_t> shape = {2, 3};
+const std::vector<float> input = {1.0f, -2.5f, 0.15625f, 0.0f, 1.00390625f, 1.01171875f};
+
+std::vector<BFloat16> ToBFloat16(const std::vector<float>& values) {
+  std::vector<BFloat16> result;
+  for (float value : values) {
+    result.push_back(BFloat16(value));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(GistPack16Test, EncodeFloat16) {
+  std::vector<MLFloat16> packed(input.size());
+  ConvertFloatToMLFloat16(input.data(), packed.data(), static_cast<int>(input.size()));
+
+  OpTester test("GistPack16Encoder", 1, kMSDomain);
+  test.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT16));
+  test.AddInput<float>("X", shape, input);
+  test.AddOutput<float>("Y", shape, input);
+  test.AddOutput<MLFloat16>("Y1", shape, packed);
+  test.Run();
+}
+
+TEST(GistPack16Test, EncodeBFloat16RoundsToNearestEven) {
+  OpTester test("GistPack16Encoder", 1, kMSDomain);
+  test.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16));
+  test.AddInput<float>("X", shape, input);
+  test.AddOutput<float>("Y", shape, input);
+  // 1 + 2^-8 and 1 + 3 * 2^-8 are halfway between two bfloat16 values.
+  test.AddOutput<BFloat16>("Y1", shape, ToBFloat16({1.0f, -2.5f, 0.15625f, 0.0f, 1.0f, 1.015625f}));
+  test.Run();
+}
+
+TEST(GistPack16Test, DecodeFloat16) {
+  const std::vector<float> decoded = {1.0f, -2.5f, 0.15625f, 0.0f, 1.0f, 1.01171875f};
+  std::vector<MLFloat16> packed(decoded.size());
+  ConvertFloatToMLFloat16(decoded.data(), packed.data(), static_cast<int>(decoded.size()));
+
+  OpTester test("GistPack16Decoder", 1, kMSDomain);
+  test.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  test.AddInput<float>("X1", {1}, {0.0f});
+  test.AddInput<MLFloat16>("X", shape, packed);
+  test.AddOutput<float>("Y", shape, decoded);
+  test.Run();
+}
+
+TEST(GistPack16Test, DecodeBFloat16WithoutLateDecodingInput) {
+  const std::vector<float> decoded = {1.0f, -2.5f, 0.15625f, 0.0f, 1.0f, 1.015625f};
+
+  OpTester test("GistPack16Decoder", 1, kMSDomain);
+  test.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  test.AddMissingOptionalInput<float>();
+  test.AddInput<BFloat16>("X", shape, ToBFloat16(decoded));
+  test.AddOutput<float>("Y", shape, decoded);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #include "gistdecode_op.h"
 
+#include "core/util/math.h"
+
 namespace onnxruntime {
 namespace contrib {
 ONNX_OPERATOR_KERNEL_EX(
@@ -26,5 +28,38 @@ Status GistBinarizeDecoderOp::Compute(OpKernelContext* context) const {
 
   return Status::OK();
 }
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Decoder,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<BFloat16>()})
+        .TypeConstraint("T2", DataTypeImpl::AllTensorTypes()),
+    GistPack16DecoderOp);
+
+Status GistPack16DecoderOp::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(1);
+  ORT_ENFORCE(X != nullptr);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  auto* dst = Y->template MutableData<float>();
+  const int64_t count = shape.Size();
+  if (X->IsDataType<MLFloat16>()) {
+    const auto* src = X->template Data<MLFloat16>();
+    for (int64_t i = 0; i < count; ++i) {
+      dst[i] = math::halfToFloat(src[i].val);
+    }
+  } else {
+    const auto* src = X->template Data<BFloat16>();
+    for (int64_t i = 0; i < count; ++i) {
+      dst[i] = src[i].ToFloat();
+    }
+  }
+
+  return Status::OK();
+}
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -15,5 +15,11 @@ class GistBinarizeDecoderOp final : public OpKernel {
   GistBinarizeDecoderOp(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 };
+
+class GistPack16DecoderOp final : public OpKernel {
+ public:
+  GistPack16DecoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
 }
 }  //namespace onnxruntime
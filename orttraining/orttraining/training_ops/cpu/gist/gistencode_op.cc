@@ -3,6 +3,11 @@
 
 #include "gistencode_op.h"
 
+#include <cmath>
+#include <cstring>
+
+#include "core/util/math.h"
+
 namespace onnxruntime {
 namespace contrib {
 ONNX_OPERATOR_KERNEL_EX(
@@ -30,5 +35,54 @@ Status GistBinarizeEncoderOp::Compute(OpKernelContext* context) const {
   ORT_ENFORCE(target != nullptr);
   return Status::OK();
 }
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Encoder,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .Alias(0, 0)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<BFloat16>()}),
+    GistPack16EncoderOp);
+
+namespace {
+// BFloat16(float) truncates; round to nearest even instead to halve the packing error.
+BFloat16 FloatToBFloat16RoundNearestEven(float value) {
+  if (std::isnan(value)) {
+    return BFloat16(static_cast<uint16_t>(0x7FC0));
+  }
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits += 0x7FFF + ((bits >> 16) & 1);
+  return BFloat16(static_cast<uint16_t>(bits >> 16));
+}
+}  // namespace
+
+Status GistPack16EncoderOp::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_ENFORCE(X != nullptr);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  Tensor* Y1 = context->Output(1, shape);
+  const auto* src = X->template Data<float>();
+  const int64_t count = shape.Size();
+  if (Y1->IsDataType<MLFloat16>()) {
+    auto* dst = Y1->template MutableData<MLFloat16>();
+    for (int64_t i = 0; i < count; ++i) {
+      dst[i] = MLFloat16(math::floatToHalf(src[i]));
+    }
+  } else {
+    auto* dst = Y1->template MutableData<BFloat16>();
+    for (int64_t i = 0; i < count; ++i) {
+      dst[i] = FloatToBFloat16RoundNearestEven(src[i]);
+    }
+  }
+
+  void* target = Y->MutableDataRaw(X->DataType());
+  ORT_ENFORCE(target != nullptr);
+  return Status::OK();
+}
 }
 }
@@ -3,6 +3,9 @@
 
 #include "gradient_control.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
@@ -73,5 +76,43 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T2", DataTypeImpl::AllTensorTypes()),
     ZeroGradient<float>);
 
+ONNX_OPERATOR_KERNEL_EX(
+    DynamicLossScale,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .Alias(0, 0)  // update loss scale in-place
+        .Alias(1, 1)  // update stable steps in-place
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("TInt64", DataTypeImpl::GetTensorType<int64_t>())
+        .TypeConstraint("T_GRAD_NORM", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_BOOL", DataTypeImpl::GetTensorType<bool>()),
+    DynamicLossScale);
+
+Status DynamicLossScale::Compute(OpKernelContext* context) const {
+  const Tensor& loss_scale = *context->Input<Tensor>(0);
+  const Tensor& stable_steps = *context->Input<Tensor>(1);
+  const Tensor& gradient_norm = *context->Input<Tensor>(2);
+  Tensor& loss_scale_out = *context->Output(0, loss_scale.Shape());
+  Tensor& stable_steps_out = *context->Output(1, stable_steps.Shape());
+
+  float scale = *loss_scale.template Data<float>();
+  int64_t steps = *stable_steps.template Data<int64_t>();
+  if (std::isfinite(*gradient_norm.template Data<float>())) {
+    if (++steps >= up_scale_window_) {
+      scale = std::min(max_loss_scale_, scale * 2.0f);
+      steps = 0;
+    }
+  } else {
+    scale = std::max(min_loss_scale_, scale / 2.0f);
+    steps = 0;
+  }
+
+  *loss_scale_out.template MutableData<float>() = scale;
+  *stable_steps_out.template MutableData<int64_t>() = steps;
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
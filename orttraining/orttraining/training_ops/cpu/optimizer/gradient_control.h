@@ -21,5 +21,20 @@ class InPlaceAccumulator final : public OpKernel {
   InPlaceAccumulator(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 };
+
+class DynamicLossScale final : public OpKernel {
+ public:
+  DynamicLossScale(const OpKernelInfo& info) : OpKernel(info) {
+    up_scale_window_ = info.GetAttrOrDefault<int64_t>("up_scale_window", 2000);
+    min_loss_scale_ = info.GetAttrOrDefault<float>("min_loss_scale", 1.0f);
+    max_loss_scale_ = info.GetAttrOrDefault<float>("max_loss_scale", static_cast<float>(1 << 24));
+  }
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t up_scale_window_;
+  float min_loss_scale_;
+  float max_loss_scale_;
+};
 }  // namespace contrib
 }  // namespace onnxruntime
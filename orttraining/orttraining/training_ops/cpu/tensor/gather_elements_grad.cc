@@ -21,14 +21,14 @@ ONNX_OPERATOR_KERNEL_EX(
                                     DataTypeImpl::GetTensorType<int64_t>()}),
     GatherElementsGrad);
 
-#define TYPED_GRAD_FUNCTION_CALL(T)                                             \
-  if (T_type == DataTypeImpl::GetType<T>()) {                                   \
-    if (Tind_type == DataTypeImpl::GetType<int32_t>()) {                        \
-      return GatherElementsGradImpl<int32_t, T>(indices_tensor, dY, axis, dX);  \
-    }                                                                           \
-    if (Tind_type == DataTypeImpl::GetType<int64_t>()) {                        \
-      return GatherElementsGradImpl<int64_t, T>(indices_tensor, dY, axis, dX);  \
-    }                                                                           \
+#define TYPED_GRAD_FUNCTION_CALL(T)                                                                          \
+  if (T_type == DataTypeImpl::GetType<T>()) {                                                                \
+    if (Tind_type == DataTypeImpl::GetType<int32_t>()) {                                                     \
+      return GatherElementsGradImpl<int32_t, T>(indices_tensor, dY, axis, dX, context->GetOperatorThreadPool()); \
+    }                                                                                                        \
+    if (Tind_type == DataTypeImpl::GetType<int64_t>()) {                                                     \
+      return GatherElementsGradImpl<int64_t, T>(indices_tensor, dY, axis, dX, context->GetOperatorThreadPool()); \
+    }                                                                                                        \
   }
 
 Status GatherElementsGrad::Compute(OpKernelContext* context) const {
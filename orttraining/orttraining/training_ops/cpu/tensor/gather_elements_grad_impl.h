@@ -7,13 +7,17 @@
 #include "core/framework/op_kernel.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 namespace contrib {
 
 template <class Tin, class Tdata>
 Status GatherElementsGradImpl(const Tensor* indices_input,
                               const Tensor* updates_input,
                               const int64_t axis,
-                              Tensor* data_output);
+                              Tensor* data_output,
+                              concurrency::ThreadPool* tp);
 
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "megatron.h"
 #include "nccl_kernels.h"
+#include "core/providers/common.h"
 #include "core/providers/cuda/tensor/identity_op.h"
 
 namespace onnxruntime {
@@ -27,5 +29,153 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
     NcclAllReduce);
 
+MegatronSequenceParallelKernel::MegatronSequenceParallelKernel(const OpKernelInfo& info) : NcclKernel(info) {
+  info.GetAttrOrDefault("axis", &axis_, static_cast<int64_t>(1));
+}
+
+Status MegatronSequenceParallelKernel::GetChunkLayout(const TensorShape& full_shape, size_t element_size,
+                                                      int group_size, ChunkLayout& layout) const {
+  const size_t axis = static_cast<size_t>(HandleNegativeAxis(axis_, full_shape.NumDimensions()));
+  const int64_t axis_size = full_shape[axis];
+  ORT_RETURN_IF_NOT(axis_size % group_size == 0,
+                    "Dimension ", axis, " of shape ", full_shape, " is not divisible by the group size ", group_size);
+
+  layout.outer_size = full_shape.SizeToDimension(axis);
+  layout.chunk_row_bytes = static_cast<size_t>(axis_size / group_size * full_shape.SizeFromDimension(axis + 1)) *
+                           element_size;
+  return Status::OK();
+}
+
+Status MegatronSequenceParallelKernel::CopyChunk(const ChunkLayout& layout, int group_size, int rank,
+                                                 const void* src, void* dst, bool from_full) {
+  const size_t full_row_bytes = layout.chunk_row_bytes * group_size;
+  const size_t rank_offset = layout.chunk_row_bytes * rank;
+  if (from_full) {
+    CUDA_RETURN_IF_ERROR(cudaMemcpy2DAsync(dst, layout.chunk_row_bytes,
+                                           static_cast<const int8_t*>(src) + rank_offset, full_row_bytes,
+                                           layout.chunk_row_bytes, layout.outer_size, cudaMemcpyDeviceToDevice));
+  } else {
+    CUDA_RETURN_IF_ERROR(cudaMemcpy2DAsync(static_cast<int8_t*>(dst) + rank_offset, full_row_bytes,
+                                           src, layout.chunk_row_bytes,
+                                           layout.chunk_row_bytes, layout.outer_size, cudaMemcpyDeviceToDevice));
+  }
+
+  return Status::OK();
+}
+
+Status MegatronReduceScatter::ComputeInternal(OpKernelContext* context) const {
+  cudaStream_t stream = nullptr;  // Default stream
+  ncclComm_t comm = nccl_->Comm(group_type_);
+  const int size = nccl_->Size(group_type_);
+
+  const Tensor* input_tensor = context->Input<Tensor>(0);
+  const TensorShape& input_shape = input_tensor->Shape();
+  const size_t element_size = input_tensor->DataType()->Size();
+  ChunkLayout layout;
+  ORT_RETURN_IF_ERROR(GetChunkLayout(input_shape, element_size, size, layout));
+
+  std::vector<int64_t> output_dims = input_shape.GetDims();
+  output_dims[HandleNegativeAxis(axis_, input_shape.NumDimensions())] /= size;
+  Tensor* output_tensor = context->Output(0, TensorShape(output_dims));
+  const int64_t rank_count = output_tensor->Shape().Size();
+  ncclDataType_t dtype = GetNcclDataType(input_tensor->DataType());
+
+  // ncclReduceScatter sends contiguous chunks, so the chunks are gathered into a buffer first unless the
+  // sharded dimension is the outermost one.
+  const void* send_data = input_tensor->DataRaw();
+  IAllocatorUniquePtr<int8_t> rank_major_buffer;
+  if (layout.outer_size > 1) {
+    rank_major_buffer = GetScratchBuffer<int8_t>(input_tensor->SizeInBytes());
+    for (int r = 0; r < size; ++r) {
+      ORT_RETURN_IF_ERROR(CopyChunk(layout, size, r, input_tensor->DataRaw(),
+                                    rank_major_buffer.get() + r * rank_count * element_size, true));
+    }
+    send_data = rank_major_buffer.get();
+  }
+
+  NCCL_RETURN_IF_ERROR(ncclReduceScatter(send_data, output_tensor->MutableDataRaw(), rank_count, dtype, ncclSum,
+                                         comm, stream));
+  return Status::OK();
+}
+
+Status MegatronAllGather::ComputeInternal(OpKernelContext* context) const {
+  cudaStream_t stream = nullptr;  // Default stream
+  ncclComm_t comm = nccl_->Comm(group_type_);
+  const int size = nccl_->Size(group_type_);
+
+  const Tensor* input_tensor = context->Input<Tensor>(0);
+  const TensorShape& input_shape = input_tensor->Shape();
+  const size_t element_size = input_tensor->DataType()->Size();
+
+  std::vector<int64_t> output_dims = input_shape.GetDims();
+  output_dims[HandleNegativeAxis(axis_, input_shape.NumDimensions())] *= size;
+  Tensor* output_tensor = context->Output(0, TensorShape(output_dims));
+  ChunkLayout layout;
+  ORT_RETURN_IF_ERROR(GetChunkLayout(output_tensor->Shape(), element_size, size, layout));
+
+  const int64_t rank_count = input_shape.Size();
+  ncclDataType_t dtype = GetNcclDataType(input_tensor->DataType());
+
+  // ncclAllGather receives contiguous chunks, which are scattered into the output unless the sharded
+  // dimension is the outermost one.
+  if (layout.outer_size == 1) {
+    NCCL_RETURN_IF_ERROR(ncclAllGather(input_tensor->DataRaw(), output_tensor->MutableDataRaw(), rank_count, dtype,
+                                       comm, stream));
+    return Status::OK();
+  }
+
+  auto rank_major_buffer = GetScratchBuffer<int8_t>(output_tensor->SizeInBytes());
+  NCCL_RETURN_IF_ERROR(ncclAllGather(input_tensor->DataRaw(), rank_major_buffer.get(), rank_count, dtype,
+                                     comm, stream));
+  for (int r = 0; r < size; ++r) {
+    ORT_RETURN_IF_ERROR(CopyChunk(layout, size, r, rank_major_buffer.get() + r * rank_count * element_size,
+                                  output_tensor->MutableDataRaw(), false));
+  }
+
+  return Status::OK();
+}
+
+Status MegatronSlice::ComputeInternal(OpKernelContext* context) const {
+  const int rank = nccl_->Rank(group_type_);
+  const int size = nccl_->Size(group_type_);
+
+  const Tensor* input_tensor = context->Input<Tensor>(0);
+  const TensorShape& input_shape = input_tensor->Shape();
+  ChunkLayout layout;
+  ORT_RETURN_IF_ERROR(GetChunkLayout(input_shape, input_tensor->DataType()->Size(), size, layout));
+
+  std::vector<int64_t> output_dims = input_shape.GetDims();
+  output_dims[HandleNegativeAxis(axis_, input_shape.NumDimensions())] /= size;
+  Tensor* output_tensor = context->Output(0, TensorShape(output_dims));
+  return CopyChunk(layout, size, rank, input_tensor->DataRaw(), output_tensor->MutableDataRaw(), true);
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    MegatronReduceScatter,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
+    MegatronReduceScatter);
+
+ONNX_OPERATOR_KERNEL_EX(
+    MegatronAllGather,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
+    MegatronAllGather);
+
+ONNX_OPERATOR_KERNEL_EX(
+    MegatronSlice,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
+    MegatronSlice);
+
 }  // namespace cuda
 }  // namespace onnxruntime
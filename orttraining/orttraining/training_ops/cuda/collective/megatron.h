@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "nccl_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Sequence parallel collectives. The tensor is viewed as [outer, axis, inner], and each rank of the horizontal
+// parallel group owns a contiguous chunk of the axis dimension.
+class MegatronSequenceParallelKernel : public NcclKernel {
+ public:
+  explicit MegatronSequenceParallelKernel(const OpKernelInfo& info);
+
+ protected:
+  struct ChunkLayout {
+    // Number of bytes of one row of a chunk, i.e. the chunk's axis length times the inner size.
+    size_t chunk_row_bytes;
+    int64_t outer_size;
+  };
+
+  // Computes the layout of 'full_shape', whose axis dimension is split among 'group_size' ranks.
+  Status GetChunkLayout(const TensorShape& full_shape, size_t element_size, int group_size,
+                        ChunkLayout& layout) const;
+
+  // Copies the chunk of 'rank' between a tensor in the [outer, axis, inner] layout and a contiguous chunk, which is
+  // what the NCCL collectives send and receive. 'from_full' selects the direction of the copy.
+  static Status CopyChunk(const ChunkLayout& layout, int group_size, int rank,
+                          const void* src, void* dst, bool from_full);
+
+  int64_t axis_;
+};
+
+class MegatronReduceScatter final : public MegatronSequenceParallelKernel {
+ public:
+  explicit MegatronReduceScatter(const OpKernelInfo& info) : MegatronSequenceParallelKernel(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+class MegatronAllGather final : public MegatronSequenceParallelKernel {
+ public:
+  explicit MegatronAllGather(const OpKernelInfo& info) : MegatronSequenceParallelKernel(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+class MegatronSlice final : public MegatronSequenceParallelKernel {
+ public:
+  explicit MegatronSlice(const OpKernelInfo& info) : MegatronSequenceParallelKernel(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -98,7 +98,36 @@ ncclComm_t NcclContext::Comm(training::WorkerGroupType group_type) {
   return nullptr;
 }
 
+cudaStream_t NcclContext::CommunicationStream() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (communication_stream_ == nullptr) {
+    // not synchronized with the default stream, on which the other kernels run
+    CUDA_CALL_THROW(cudaStreamCreateWithFlags(&communication_stream_, cudaStreamNonBlocking));
+  }
+  return communication_stream_;
+}
+
+void NcclContext::SetPendingEvent(const void* output, cudaEvent_t event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_events_[output] = event;
+}
+
+cudaEvent_t NcclContext::TakePendingEvent(const void* output) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_events_.find(output);
+  if (it == pending_events_.end()) {
+    return nullptr;
+  }
+  cudaEvent_t event = it->second;
+  pending_events_.erase(it);
+  return event;
+}
+
 NcclContext::~NcclContext() {
+  if (communication_stream_ != nullptr) {
+    cudaStreamDestroy(communication_stream_);
+  }
+
   if (data_group_comm_ != nullptr) {
     ncclCommDestroy(data_group_comm_);
   }
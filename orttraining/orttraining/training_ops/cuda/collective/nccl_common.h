@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
 #include "core/providers/cuda/cuda_common.h"
 #include "orttraining/core/framework/distributed_run_context.h"
 #include <nccl.h>
@@ -27,9 +30,22 @@ class NcclContext final {
     return training::DistributedRunContext::GroupSize(group_type);
   }
 
+  // The stream of asynchronous collectives, created on first use.
+  cudaStream_t CommunicationStream();
+
+  // Records that the output of an asynchronous collective is ready once event has completed.
+  void SetPendingEvent(const void* output, cudaEvent_t event);
+
+  // Returns and forgets the event set for output, or nullptr if there is none.
+  cudaEvent_t TakePendingEvent(const void* output);
+
  private:
   ncclComm_t data_group_comm_;
   ncclComm_t horizontal_group_comm_;
+
+  std::mutex mutex_;
+  cudaStream_t communication_stream_ = nullptr;
+  std::unordered_map<const void*, cudaEvent_t> pending_events_;
 };
 
 // -----------------------------------------------------------------------
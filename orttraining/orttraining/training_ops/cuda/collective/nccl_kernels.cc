@@ -7,10 +7,30 @@ namespace onnxruntime {
 namespace cuda {
 
 NcclAllReduce::NcclAllReduce(const OpKernelInfo& info) : NcclKernel(info) {
+  async_ = info.GetAttrOrDefault<int64_t>("async", 0) != 0;
+  if (async_) {
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&inputs_ready_, cudaEventDisableTiming));
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&done_, cudaEventDisableTiming));
+  }
+}
+
+NcclAllReduce::~NcclAllReduce() {
+  if (inputs_ready_ != nullptr) {
+    cudaEventDestroy(inputs_ready_);
+  }
+  if (done_ != nullptr) {
+    cudaEventDestroy(done_);
+  }
 }
 
 Status NcclAllReduce::ComputeInternal(OpKernelContext* context) const {
   cudaStream_t stream = nullptr;  // Default stream
+  if (async_) {
+    // the inputs are produced on the default stream
+    stream = nccl_->CommunicationStream();
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(inputs_ready_, nullptr));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(stream, inputs_ready_, 0));
+  }
   ncclComm_t comm = nccl_->Comm(group_type_);
 
   for (int i = 0; i < context->InputCount(); i++) {
@@ -26,6 +46,34 @@ Status NcclAllReduce::ComputeInternal(OpKernelContext* context) const {
     NCCL_RETURN_IF_ERROR(ncclAllReduce(input_data, output_data, input_count, dtype, ncclSum, comm, stream));
   }
 
+  if (async_) {
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(done_, stream));
+    for (int i = 0; i < context->OutputCount(); i++) {
+      nccl_->SetPendingEvent(context->Output<Tensor>(i)->DataRaw(), done_);
+    }
+  }
+
+  return Status::OK();
+}
+
+NcclWait::NcclWait(const OpKernelInfo& info) : NcclKernel(info) {
+}
+
+Status NcclWait::ComputeInternal(OpKernelContext* context) const {
+  for (int i = 0; i < context->InputCount(); i++) {
+    const Tensor* input_tensor = context->Input<Tensor>(i);
+    cudaEvent_t event = nccl_->TakePendingEvent(input_tensor->DataRaw());
+    if (event != nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(nullptr, event, 0));
+    }
+
+    Tensor* output_tensor = context->Output(i, input_tensor->Shape());
+    if (output_tensor->MutableDataRaw() != input_tensor->DataRaw()) {
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(),
+                                           input_tensor->SizeInBytes(), cudaMemcpyDeviceToDevice));
+    }
+  }
+
   return Status::OK();
 }
 
@@ -118,6 +166,43 @@ Status NcclAllGather::ComputeInternal(OpKernelContext* context) const {
   return Status::OK();
 }
 
+NcclAllGatherV::NcclAllGatherV(const OpKernelInfo& info) : NcclKernel(info) {
+  ORT_ENFORCE(info.GetAttrs<int64_t>("counts", counts_).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("shape", shape_).IsOK());
+}
+
+Status NcclAllGatherV::ComputeInternal(OpKernelContext* context) const {
+  cudaStream_t stream = nullptr;  // Default stream
+  ncclComm_t comm = nccl_->Comm(group_type_);
+  const int rank = nccl_->Rank(group_type_);
+  const int size = nccl_->Size(group_type_);
+  ORT_RETURN_IF_NOT(static_cast<int>(counts_.size()) == size, "NcclAllGatherV needs the element count of each rank.");
+
+  const Tensor* input_tensor = context->Input<Tensor>(0);
+  ORT_RETURN_IF_NOT(input_tensor->Shape().Size() == counts_[rank], "Unexpected element count of rank ", rank, ".");
+  auto onnx_type = input_tensor->DataType();
+  const size_t element_size = onnx_type->Size();
+  ncclDataType_t dtype = GetNcclDataType(onnx_type);
+
+  Tensor* output_tensor = context->Output(0, TensorShape(shape_));
+  int8_t* output_data = static_cast<int8_t*>(output_tensor->MutableDataRaw());
+
+  // Each rank broadcasts its partition to its range of the output, the input is only read on the root.
+  int64_t offset = 0;
+  NCCL_RETURN_IF_ERROR(ncclGroupStart());
+  for (int root = 0; root < size; root++) {
+    if (counts_[root] > 0) {
+      NCCL_RETURN_IF_ERROR(ncclBroadcast(input_tensor->DataRaw(), output_data + offset * element_size, counts_[root],
+                                         dtype, root, comm, stream));
+      offset += counts_[root];
+    }
+  }
+  NCCL_RETURN_IF_ERROR(ncclGroupEnd());
+  ORT_RETURN_IF_NOT(offset == output_tensor->Shape().Size(), "The partitions don't add up to the gathered tensor.");
+
+  return Status::OK();
+}
+
 NcclReduceScatter::NcclReduceScatter(const OpKernelInfo& info) : NcclKernel(info) {
 }
 
@@ -222,6 +307,16 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
     NcclAllReduce);
 
+ONNX_OPERATOR_KERNEL_EX(
+    NcclWait,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .Alias(AliasRange(0, 1024))
+        .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
+    NcclWait);
+
 ONNX_OPERATOR_KERNEL_EX(
     NcclAllGather,
     kMSDomain,
@@ -232,6 +327,15 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
     NcclAllGather);
 
+ONNX_OPERATOR_KERNEL_EX(
+    NcclAllGatherV,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
+    NcclAllGatherV);
+
 ONNX_OPERATOR_KERNEL_EX(
     NcclReduceScatter,
     kMSDomain,
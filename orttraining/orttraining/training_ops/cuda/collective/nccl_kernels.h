@@ -11,6 +11,20 @@ namespace cuda {
 class NcclAllReduce final : public NcclKernel {
  public:
   explicit NcclAllReduce(const OpKernelInfo& info);
+  ~NcclAllReduce();
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  // If true, the reduction runs on the communication stream, and NcclWait waits for done_.
+  bool async_;
+  cudaEvent_t inputs_ready_ = nullptr;
+  cudaEvent_t done_ = nullptr;
+};
+
+class NcclWait final : public NcclKernel {
+ public:
+  explicit NcclWait(const OpKernelInfo& info);
 
   Status ComputeInternal(OpKernelContext* context) const override;
 };
@@ -22,6 +36,18 @@ class NcclAllGather final : public NcclKernel {
   Status ComputeInternal(OpKernelContext* context) const override;
 };
 
+// Gathers a parameter partitioned with ZeRO stage 3, each rank broadcasting its partition.
+class NcclAllGatherV final : public NcclKernel {
+ public:
+  explicit NcclAllGatherV(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  std::vector<int64_t> counts_;
+  std::vector<int64_t> shape_;
+};
+
 class NcclReduceScatter final : public NcclKernel {
  public:
   explicit NcclReduceScatter(const OpKernelInfo& info);
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/training_ops/cuda/gist/gist.h"
+#include "orttraining/training_ops/cuda/gist/gist_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Encoder,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .Alias(0, 0)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<BFloat16>()}),
+    GistPack16Encoder);
+
+Status GistPack16Encoder::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  Tensor* Y1 = context->Output(1, shape);
+  const float* input_data = X->template Data<float>();
+  const size_t count = static_cast<size_t>(shape.Size());
+  if (Y1->IsDataType<MLFloat16>()) {
+    GistPack16EncodeImpl(input_data, reinterpret_cast<half*>(Y1->template MutableData<MLFloat16>()), count);
+  } else {
+    GistPack16EncodeImpl(input_data, reinterpret_cast<uint16_t*>(Y1->template MutableData<BFloat16>()), count);
+  }
+
+  // Y aliases X, so only make sure it is bound.
+  ORT_ENFORCE(Y->MutableDataRaw(X->DataType()) != nullptr);
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Decoder,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<BFloat16>()})
+        .TypeConstraint("T2", DataTypeImpl::AllTensorTypes()),
+    GistPack16Decoder);
+
+Status GistPack16Decoder::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(1);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  float* output_data = Y->template MutableData<float>();
+  const size_t count = static_cast<size_t>(shape.Size());
+  if (X->IsDataType<MLFloat16>()) {
+    GistPack16DecodeImpl(reinterpret_cast<const half*>(X->template Data<MLFloat16>()), output_data, count);
+  } else {
+    GistPack16DecodeImpl(reinterpret_cast<const uint16_t*>(X->template Data<BFloat16>()), output_data, count);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_fp16.h>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "orttraining/training_ops/cuda/gist/gist_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+__device__ __forceinline__ void _Pack16(float value, half& packed) {
+  packed = __float2half(value);
+}
+
+__device__ __forceinline__ void _Pack16(float value, uint16_t& packed) {
+  // Round to nearest even, keeping NaNs quiet.
+  uint32_t bits = __float_as_uint(value);
+  if (isnan(value)) {
+    packed = 0x7FC0;
+  } else {
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    packed = static_cast<uint16_t>(bits >> 16);
+  }
+}
+
+__device__ __forceinline__ float _Unpack16(half packed) {
+  return __half2float(packed);
+}
+
+__device__ __forceinline__ float _Unpack16(uint16_t packed) {
+  return __uint_as_float(static_cast<uint32_t>(packed) << 16);
+}
+
+template <typename T>
+__global__ void _GistPack16Encode(const float* input_data, T* output_data, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  _Pack16(input_data[id], output_data[id]);
+}
+
+template <typename T>
+__global__ void _GistPack16Decode(const T* input_data, float* output_data, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  output_data[id] = _Unpack16(input_data[id]);
+}
+
+template <typename T>
+void GistPack16EncodeImplT(const float* input_data, T* output_data, size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistPack16Encode<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input_data, output_data, N);
+}
+
+template <typename T>
+void GistPack16DecodeImplT(const T* input_data, float* output_data, size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistPack16Decode<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input_data, output_data, N);
+}
+
+void GistPack16EncodeImpl(const float* input_data, half* output_data, size_t count) {
+  GistPack16EncodeImplT(input_data, output_data, count);
+}
+
+void GistPack16EncodeImpl(const float* input_data, uint16_t* output_data, size_t count) {
+  GistPack16EncodeImplT(input_data, output_data, count);
+}
+
+void GistPack16DecodeImpl(const half* input_data, float* output_data, size_t count) {
+  GistPack16DecodeImplT(input_data, output_data, count);
+}
+
+void GistPack16DecodeImpl(const uint16_t* input_data, float* output_data, size_t count) {
+  GistPack16DecodeImplT(input_data, output_data, count);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,18 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+void GistPack16EncodeImpl(const float* input_data, half* output_data, size_t count);
+// bfloat16 values are handled as their raw 16-bit patterns.
+void GistPack16EncodeImpl(const float* input_data, uint16_t* output_data, size_t count);
+
+void GistPack16DecodeImpl(const half* input_data, float* output_data, size_t count);
+void GistPack16DecodeImpl(const uint16_t* input_data, float* output_data, size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
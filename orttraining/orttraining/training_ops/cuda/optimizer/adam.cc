@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+#include <map>
+#include <tuple>
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/reduction/reduction_functions.h"
 #include "core/providers/cuda/math/binary_elementwise_ops.h"
@@ -150,5 +153,233 @@ Status AdamOptimizer<T1, T2, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP>:
   return Status::OK();
 }
 
+std::vector<std::pair<int, int>> GenerateMultiTensorAdamAliasMapping() {
+  // Starting index of extra inputs.
+  constexpr int input_index_bias = 5;
+  // Starting index of extra outputs.
+  constexpr int output_index_bias = 1;
+  // Count of extra I/O groups. One group corresponds to a weight update.
+  constexpr int group_count = 1024;
+  // length of [w, g, m1, m2, w_mixed_precision].
+  constexpr int input_stride = 5;
+  // length of [w_new, g_new, m1_new, m2_new, w_mixed_precision_new].
+  constexpr int output_stride = 5;
+
+  std::vector<std::pair<int, int>> alias_pairs{};
+  for (int i = 0; i < group_count; ++i) {
+    const int input = input_index_bias + i * input_stride;
+    const int output = output_index_bias + i * output_stride;
+    // w --> w_new, g --> g_new, m1 --> m1_new, m2 --> m2_new, w_mixed_precision --> w_mixed_precision_new
+    for (int j = 0; j < input_stride; ++j) {
+      alias_pairs.emplace_back(std::make_pair(input + j, output + j));
+    }
+  }
+
+  // update_count are updated in place.
+  alias_pairs.emplace_back(std::make_pair(4, 0));
+
+  return alias_pairs;
+}
+
+#define REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(T1, T2, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP) \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                                         \
+      MultiTensorAdamOptimizer,                                                                          \
+      kMSDomain,                                                                                         \
+      1,                                                                                                 \
+      T1##_##T2##_##T3##_##T4##_##T_GRAD##_##T_GRAD_NORM##_##T_MIXED_PRECISION_FP,                       \
+      kCudaExecutionProvider,                                                                            \
+      KernelDefBuilder()                                                                                 \
+          .Alias(GenerateMultiTensorAdamAliasMapping())                                                  \
+          .InputMemoryType<OrtMemTypeCPUInput>(0)   /* Keep do_update in CPU */                          \
+          .InputMemoryType<OrtMemTypeCPUInput>(4)   /* Keep step count in CPU */                         \
+          .OutputMemoryType<OrtMemTypeCPUOutput>(0) /* Keep step count in CPU */                         \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<T1>())                                       \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<T2>())                                       \
+          .TypeConstraint("T3", DataTypeImpl::GetTensorType<T3>())                                       \
+          .TypeConstraint("T4", DataTypeImpl::GetTensorType<T4>())                                       \
+          .TypeConstraint("T_GRAD", DataTypeImpl::GetTensorType<T_GRAD>())                               \
+          .TypeConstraint("T_MIXED_PRECISION_FP", DataTypeImpl::GetTensorType<T_MIXED_PRECISION_FP>())   \
+          .TypeConstraint("T_GRAD_NORM", DataTypeImpl::GetTensorType<T_GRAD_NORM>()),                    \
+      MultiTensorAdamOptimizer<T1, T2, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP>);
+
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, int64_t, float, float, float, float, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(MLFloat16, int64_t, float, MLFloat16, float, float, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, int64_t, float, MLFloat16, float, float, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, int64_t, float, float, MLFloat16, MLFloat16, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, int64_t, float, float, MLFloat16, float, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(MLFloat16, int64_t, float, MLFloat16, MLFloat16, MLFloat16, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(MLFloat16, int64_t, float, MLFloat16, MLFloat16, float, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, int64_t, float, MLFloat16, MLFloat16, MLFloat16, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, int64_t, float, MLFloat16, MLFloat16, float, MLFloat16)
+
+template <typename T1, typename T2, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM, typename T_MIXED_PRECISION_FP>
+Status MultiTensorAdamOptimizer<T1, T2, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP>::ComputeInternal(OpKernelContext* ctx) const {
+  typedef typename ToCudaType<T1>::MappedType CudaT1;
+  typedef typename ToCudaType<T3>::MappedType CudaT3;
+  typedef typename ToCudaType<T4>::MappedType CudaT4;
+  typedef typename ToCudaType<T_GRAD>::MappedType CudaT_GRAD;
+  typedef typename ToCudaType<T_GRAD_NORM>::MappedType CudaT_GRAD_NORM;
+  typedef typename ToCudaType<T_MIXED_PRECISION_FP>::MappedType CudaT_MIXED_PRECISION_FP;
+
+  constexpr int non_grouped_input_count = 5;
+  constexpr int input_group_size = 5;
+  constexpr int output_group_size = 5;
+  constexpr int non_grouped_output_count = 1;
+  const int grouped_input_tensor_count = ctx->InputCount() - non_grouped_input_count;
+  const int grouped_output_tensor_count = ctx->OutputCount() - non_grouped_output_count;
+
+  // The last mixed-precision weight of inputs and outputs may be omitted.
+  ORT_ENFORCE(
+      grouped_input_tensor_count > 0 && grouped_output_tensor_count > 0,
+      "MultiTensorAdamOptimizer expects at least one weight to optimize.");
+  const int group_count = (grouped_input_tensor_count + input_group_size - 1) / input_group_size;
+  ORT_ENFORCE(
+      group_count == (grouped_output_tensor_count + output_group_size - 1) / output_group_size,
+      "Input and output tensor counts are not aligned. Please check MultiTensorAdamOptimizer's input and output lists.");
+
+  ORT_ENFORCE(alpha_.size() >= static_cast<size_t>(group_count));
+  ORT_ENFORCE(beta_.size() >= static_cast<size_t>(group_count));
+  ORT_ENFORCE(lambda_.size() >= static_cast<size_t>(group_count));
+  ORT_ENFORCE(epsilon_.size() >= static_cast<size_t>(group_count));
+
+  const Tensor* do_update_tensor = ctx->Input<Tensor>(0);
+  const Tensor* loss_scale_tensor = ctx->Input<Tensor>(1);
+  const Tensor* gradient_norm_tensor = ctx->Input<Tensor>(2);
+  const Tensor& ETA = *ctx->Input<Tensor>(3);
+  const Tensor& S = *ctx->Input<Tensor>(4);
+  Tensor& NS = *ctx->Output(0, S.Shape());
+
+  const bool do_update = do_update_tensor == nullptr || *(do_update_tensor->template Data<bool>());
+
+  const CudaT1* eta = reinterpret_cast<const CudaT1*>(ETA.template Data<T1>());
+  const CudaT3* loss_scale = loss_scale_tensor != nullptr ? reinterpret_cast<const CudaT3*>(loss_scale_tensor->template Data<T3>()) : nullptr;
+  const CudaT_GRAD_NORM* G_norm = gradient_norm_tensor != nullptr ? reinterpret_cast<const CudaT_GRAD_NORM*>(gradient_norm_tensor->template Data<T_GRAD_NORM>()) : nullptr;
+  const T2 update_count = *(S.template Data<T2>());
+
+  constexpr int tensor_count_per_group = 7;
+  const int max_tensor_size = compute_max_tensor_size_per_launch<tensor_count_per_group>(4);
+  // Bucketize tensor groups by the associated optimizer configuration.
+  std::map<std::tuple<float, float, float, float>, std::vector<std::vector<void*>>> buckets;
+  std::map<std::tuple<float, float, float, float>, std::vector<int>> tensor_sizes_in_buckets;
+
+  for (int group_index = 0; group_index < group_count; ++group_index) {
+    const int input_start_index = non_grouped_input_count + group_index * input_group_size;
+    const Tensor& W = *ctx->Input<Tensor>(input_start_index);
+    const Tensor& G = *ctx->Input<Tensor>(input_start_index + 1);
+    const Tensor& M1 = *ctx->Input<Tensor>(input_start_index + 2);
+    const Tensor& M2 = *ctx->Input<Tensor>(input_start_index + 3);
+    const Tensor* W_MIXED_FP = ctx->Input<Tensor>(input_start_index + 4);
+
+    const int output_start_index = non_grouped_output_count + group_index * output_group_size;
+    Tensor* NW = ctx->Output(output_start_index, W.Shape());
+    Tensor* NG = ctx->Output(output_start_index + 1, G.Shape());
+    Tensor& NM1 = *ctx->Output(output_start_index + 2, M1.Shape());
+    Tensor& NM2 = *ctx->Output(output_start_index + 3, M2.Shape());
+    Tensor* NW_MIXED_FP = W_MIXED_FP != nullptr ? ctx->Output(output_start_index + 4, W_MIXED_FP->Shape()) : nullptr;
+
+    // TODO: temporary hack until View is improved (it doesn't work with Alias)
+    if (NW != nullptr)
+      NW->SetByteOffset(W.ByteOffset());
+    if (NG != nullptr)
+      NG->SetByteOffset(G.ByteOffset());
+    if (NW_MIXED_FP != nullptr)
+      NW_MIXED_FP->SetByteOffset(W_MIXED_FP->ByteOffset());
+
+    // The momentums are updated in place in the outputs, which are usually aliases of the inputs.
+    ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T4>(M1, NM1));
+    ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T4>(M2, NM2));
+
+    if (!do_update) {
+      if (NW != nullptr) {
+        ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T3>(W, *NW));
+      }
+      if (NG != nullptr) {
+        ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T_GRAD>(G, *NG));
+      }
+      if (NW_MIXED_FP != nullptr) {
+        ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T_MIXED_PRECISION_FP>(*W_MIXED_FP, *NW_MIXED_FP));
+      }
+      continue;
+    }
+
+    // The index in CUDA system is 32-bit integer.
+    ORT_ENFORCE(W.Shape().Size() < static_cast<int64_t>(std::numeric_limits<int>::max()));
+    const int tensor_size = static_cast<int>(W.Shape().Size());
+
+    const CudaT3* p_w = reinterpret_cast<const CudaT3*>(W.template Data<T3>());
+    const CudaT_GRAD* p_g = reinterpret_cast<const CudaT_GRAD*>(G.template Data<T_GRAD>());
+    CudaT4* p_m1 = reinterpret_cast<CudaT4*>(NM1.template MutableData<T4>());
+    CudaT4* p_m2 = reinterpret_cast<CudaT4*>(NM2.template MutableData<T4>());
+    CudaT3* p_w_new = NW != nullptr ? reinterpret_cast<CudaT3*>(NW->template MutableData<T3>()) : nullptr;
+    CudaT_GRAD* p_g_new = NG != nullptr ? reinterpret_cast<CudaT_GRAD*>(NG->template MutableData<T_GRAD>()) : nullptr;
+    CudaT_MIXED_PRECISION_FP* p_w_mixed_precision_new =
+        NW_MIXED_FP != nullptr ? reinterpret_cast<CudaT_MIXED_PRECISION_FP*>(NW_MIXED_FP->template MutableData<T_MIXED_PRECISION_FP>()) : nullptr;
+
+    if (tensor_size > max_tensor_size) {
+      // Large tensors saturate the GPU on their own.
+      AdamOptimizerImpl(
+          eta,
+          update_count,
+          p_w,
+          p_g,
+          p_m1,
+          p_m2,
+          loss_scale,
+          G_norm,
+          ToCudaType<T4>::FromFloat(alpha_[group_index]),
+          ToCudaType<T4>::FromFloat(beta_[group_index]),
+          ToCudaType<T4>::FromFloat(lambda_[group_index]),
+          ToCudaType<T4>::FromFloat(epsilon_[group_index]),
+          do_bias_correction_,
+          weight_decay_mode_,
+          p_m1,
+          p_m2,
+          p_w_new,
+          p_g_new,
+          p_w_mixed_precision_new,
+          tensor_size);
+    } else {
+      std::vector<void*> ptrs(tensor_count_per_group);
+      ptrs[0] = const_cast<CudaT3*>(p_w);
+      ptrs[1] = const_cast<CudaT_GRAD*>(p_g);
+      ptrs[2] = p_m1;
+      ptrs[3] = p_m2;
+      ptrs[4] = p_w_new;
+      ptrs[5] = p_g_new;
+      ptrs[6] = p_w_mixed_precision_new;
+
+      auto key = std::make_tuple(alpha_[group_index], beta_[group_index], lambda_[group_index], epsilon_[group_index]);
+      buckets[key].push_back(ptrs);
+      tensor_sizes_in_buckets[key].push_back(tensor_size);
+    }
+  }
+
+  for (auto& pair : buckets) {
+    const auto key = pair.first;
+    float alpha = 0.f, beta = 0.f, lambda = 0.f, epsilon = 0.f;
+    std::tie(alpha, beta, lambda, epsilon) = key;
+
+    // If bias correction coefficients are set to 1s, it's equivalent to disabling bias correction.
+    const float alpha_correction =
+        do_bias_correction_ ? onnxruntime::contrib::compute_bias_correction_coefficient(alpha, update_count) : 1.f;
+    const float beta_correction =
+        do_bias_correction_ ? onnxruntime::contrib::compute_bias_correction_coefficient(beta, update_count) : 1.f;
+
+    typedef AdamMultiTensorFunctor<CudaT1, CudaT3, CudaT4, CudaT_GRAD, CudaT_GRAD_NORM, CudaT_MIXED_PRECISION_FP> AdamFunctor;
+    AdamFunctor adam_functor;
+
+    launch_multi_tensor_functor<tensor_count_per_group, AdamFunctor, const CudaT1*, const CudaT3*, const CudaT_GRAD_NORM*, float, float, float, float, float, float, int64_t>(
+        2048 * 32,
+        tensor_sizes_in_buckets[key],
+        pair.second,
+        adam_functor,
+        eta, loss_scale, G_norm, alpha, beta, lambda, epsilon, alpha_correction, beta_correction, weight_decay_mode_);
+  }
+
+  *(NS.template MutableData<T2>()) = do_update ? update_count + 1 : update_count;
+
+  return Status::OK();
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -31,6 +31,22 @@ __global__ void _AdamOptimizer_mode0(
     T_MIXED_PRECISION_FP* mixed_precision_weights_out,
     CUDA_LONG N) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  if (!_IsGradNormFinite(grad_norm)) {
+    // Overflowed step: keep the states, same as the host-side do_update == false path.
+    if (grads_out) {
+      grads_out[id] = grads[id];
+    }
+    if (weights_out) {
+      weights_out[id] = weights[id];
+      if (mixed_precision_weights_out) {
+        mixed_precision_weights_out[id] = static_cast<T_MIXED_PRECISION_FP>(weights[id]);
+      }
+    }
+    moment_1_out[id] = moment_1[id];
+    moment_2_out[id] = moment_2[id];
+    return;
+  }
+
   const T4 actual_scale = _ComputeGradScale<T3, T_GRAD_NORM, T4>(loss_scale, grad_norm);
 
   // Gradient scaling/clipping.
@@ -92,6 +108,22 @@ __global__ void _AdamOptimizer_mode1(
     T_MIXED_PRECISION_FP* mixed_precision_weights_out,
     CUDA_LONG N) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  if (!_IsGradNormFinite(grad_norm)) {
+    // Overflowed step: keep the states, same as the host-side do_update == false path.
+    if (grads_out) {
+      grads_out[id] = grads[id];
+    }
+    if (weights_out) {
+      weights_out[id] = weights[id];
+      if (mixed_precision_weights_out) {
+        mixed_precision_weights_out[id] = static_cast<T_MIXED_PRECISION_FP>(weights[id]);
+      }
+    }
+    moment_1_out[id] = moment_1[id];
+    moment_2_out[id] = moment_2[id];
+    return;
+  }
+
   const T4 actual_scale = _ComputeGradScale<T3, T_GRAD_NORM, T4>(loss_scale, grad_norm);
 
   // Gradient scaling/clipping.
@@ -255,5 +287,141 @@ SPECIALIZED_AdamOptimizerImpl(half, int64_t, float, half, half, float, half)
 SPECIALIZED_AdamOptimizerImpl(float, int64_t, float, half, half, half, half)
 SPECIALIZED_AdamOptimizerImpl(float, int64_t, float, half, half, float, half)
 
+template <typename T1, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM, typename T_MIXED_PRECISION_FP>
+__global__ void AdamMultiTensorImpl(
+    ChunkGroup<7> chunk_group,
+    const T1* eta,
+    const T3* loss_scale,
+    const T_GRAD_NORM* grad_norm,
+    const T4 alpha,
+    const T4 beta,
+    const T4 lambda,
+    const T4 epsilon,
+    const T4 alpha_correction,
+    const T4 beta_correction,
+    const int64_t weight_decay_mode) {
+  const int group_index = chunk_group.block_index_to_tensor_group_index[blockIdx.x];
+  const int tensor_size = chunk_group.tensor_sizes[group_index];
+  const int chunk_size = chunk_group.chunk_size;
+  const int chunk_start = chunk_group.block_index_to_chunk_start_index[blockIdx.x];
+
+  const T3* w = reinterpret_cast<const T3*>(chunk_group.tensor_ptrs[0][group_index]) + chunk_start;
+  const T_GRAD* g = reinterpret_cast<const T_GRAD*>(chunk_group.tensor_ptrs[1][group_index]) + chunk_start;
+  T4* m1 = reinterpret_cast<T4*>(chunk_group.tensor_ptrs[2][group_index]) + chunk_start;
+  T4* m2 = reinterpret_cast<T4*>(chunk_group.tensor_ptrs[3][group_index]) + chunk_start;
+  T3* w_new = chunk_group.tensor_ptrs[4][group_index] != nullptr ? reinterpret_cast<T3*>(chunk_group.tensor_ptrs[4][group_index]) + chunk_start : nullptr;
+  T_GRAD* g_new = chunk_group.tensor_ptrs[5][group_index] != nullptr ? reinterpret_cast<T_GRAD*>(chunk_group.tensor_ptrs[5][group_index]) + chunk_start : nullptr;
+  T_MIXED_PRECISION_FP* w_mixed_precision_new = chunk_group.tensor_ptrs[6][group_index] != nullptr ? reinterpret_cast<T_MIXED_PRECISION_FP*>(chunk_group.tensor_ptrs[6][group_index]) + chunk_start : nullptr;
+
+  if (!_IsGradNormFinite(grad_norm)) {
+    // Overflowed step: moments were already copied to the outputs, so only forward weights and gradients.
+    for (int i = threadIdx.x; i < chunk_size && i + chunk_start < tensor_size; i += blockDim.x) {
+      if (g_new != nullptr) {
+        g_new[i] = g[i];
+      }
+      if (w_new != nullptr) {
+        w_new[i] = w[i];
+        if (w_mixed_precision_new != nullptr) {
+          w_mixed_precision_new[i] = static_cast<T_MIXED_PRECISION_FP>(w[i]);
+        }
+      }
+    }
+    return;
+  }
+
+  const T4 actual_scale = _ComputeGradScale<T3, T_GRAD_NORM, T4>(loss_scale, grad_norm);
+  const T4 one = T4(1.0f);
+  const T4 lr = T4(*eta);
+
+  for (int i = threadIdx.x; i < chunk_size && i + chunk_start < tensor_size; i += blockDim.x) {
+    // Gradient scaling/clipping.
+    const T4 g_scaled = T4(g[i]) / actual_scale;
+
+    // Compute exponentially-averaged historical gradient and squared gradient.
+    const T4 m1o = alpha * m1[i] + (one - alpha) * g_scaled;
+    const T4 m2o = beta * m2[i] + (one - beta) * g_scaled * g_scaled;
+
+    // The same two modes as _AdamOptimizer_mode0 and _AdamOptimizer_mode1.
+    T4 delta;
+    if (weight_decay_mode == 0) {
+      const T4 denom = _Sqrt(m2o / beta_correction) + epsilon;
+      delta = -lr * ((m1o / alpha_correction) / denom + lambda * T4(w[i]));
+    } else {
+      const T4 denom = _Sqrt(m2o) + epsilon;
+      const T4 step_size = lr * _Sqrt(beta_correction) / alpha_correction;
+      delta = -step_size * m1o / denom - lr * lambda * (T4(w[i]) - step_size * m1o / denom);
+    }
+
+    if (g_new != nullptr) {
+      g_new[i] = T_GRAD(delta);
+    }
+
+    if (w_new != nullptr) {
+      const T3 w_updated = w[i] + T3(delta);
+      w_new[i] = w_updated;
+      if (w_mixed_precision_new != nullptr) {
+        w_mixed_precision_new[i] = static_cast<T_MIXED_PRECISION_FP>(w_updated);
+      }
+    }
+
+    m1[i] = m1o;
+    m2[i] = m2o;
+  }
+}
+
+template <typename T1, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM, typename T_MIXED_PRECISION_FP>
+void AdamMultiTensorFunctor<T1, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP>::operator()(
+    ChunkGroup<7> chunk_group,
+    const T1* eta,
+    const T3* loss_scale,
+    const T_GRAD_NORM* grad_norm,
+    const float alpha,
+    const float beta,
+    const float lambda,
+    const float epsilon,
+    const float alpha_correction,
+    const float beta_correction,
+    const int64_t weight_decay_mode) {
+  const int thread_count = ChunkGroup<7>::thread_count_per_block;
+  const int block_count = chunk_group.chunk_count;
+
+  AdamMultiTensorImpl<T1, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP><<<block_count, thread_count, 0>>>(
+      chunk_group,
+      eta,
+      loss_scale,
+      grad_norm,
+      T4(alpha),
+      T4(beta),
+      T4(lambda),
+      T4(epsilon),
+      T4(alpha_correction),
+      T4(beta_correction),
+      weight_decay_mode);
+}
+
+#define INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(T1, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP)      \
+  template void AdamMultiTensorFunctor<T1, T3, T4, T_GRAD, T_GRAD_NORM, T_MIXED_PRECISION_FP>::operator()( \
+      ChunkGroup<7> chunk_group,                                                                          \
+      const T1* eta,                                                                                      \
+      const T3* loss_scale,                                                                               \
+      const T_GRAD_NORM* grad_norm,                                                                       \
+      const float alpha,                                                                                  \
+      const float beta,                                                                                   \
+      const float lambda,                                                                                 \
+      const float epsilon,                                                                                \
+      const float alpha_correction,                                                                       \
+      const float beta_correction,                                                                        \
+      const int64_t weight_decay_mode);
+
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, float, float, float, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(half, float, half, float, float, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, float, float, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, float, half, half, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, float, half, float, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(half, float, half, half, half, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(half, float, half, half, float, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, half, half, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, half, float, half)
+
 }  // namespace cuda
 }  // namespace onnxruntime
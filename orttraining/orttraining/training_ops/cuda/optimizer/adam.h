@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/multi_tensor/common.cuh"
 
 namespace onnxruntime {
 namespace cuda {
@@ -58,5 +59,71 @@ class AdamOptimizer final : public CudaKernel {
   int64_t weight_decay_mode_;
 };
 
+// Adam's multi-tensor update maps [w, g, m1, m2] to [w_new, g_new, m1_new, m2_new, w_mixed_precision_new] where
+//  w: weight tensor
+//  g: gradient tensor
+//  m1, m2: 1st and 2nd momentums, updated in place
+//  w_new: updated weight tensor
+//  g_new: updated gradient tensor
+//  w_mixed_precision_new: updated weight tensor of mixed-precision type
+// Because the momentums are updated in place, there are 7 distinct tensors in
+// total and therefore the type of chunk_group is ChunkGroup<7>.
+//
+// Tensor pointers associated with the i-th tensor in this chunk:
+//  w: chunk_group.tensor_ptrs[0][i]
+//  g: chunk_group.tensor_ptrs[1][i]
+//  m1 (or m1_new): chunk_group.tensor_ptrs[2][i]
+//  m2 (or m2_new): chunk_group.tensor_ptrs[3][i]
+//  w_new: chunk_group.tensor_ptrs[4][i]
+//  g_new: chunk_group.tensor_ptrs[5][i]
+//  w_mixed_precision_new: chunk_group.tensor_ptrs[6][i]
+template <typename T1, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM, typename T_MIXED_PRECISION_FP>
+struct AdamMultiTensorFunctor {
+  void operator()(
+      ChunkGroup<7> chunk_group,
+      const T1* eta,
+      const T3* loss_scale,
+      const T_GRAD_NORM* grad_norm,
+      const float alpha,
+      const float beta,
+      const float lambda,
+      const float epsilon,
+      const float alpha_correction,
+      const float beta_correction,
+      const int64_t weight_decay_mode);
+};
+
+// Adam optimizer updating all weights with a few multi-tensor CUDA kernel calls.
+// Its inputs are [update_signal, loss_scale, grad_norm, eta, step] followed by
+// a repeated sequence of [w, g, m1, m2, w_mixed_precision], and its outputs are [step_new]
+// followed by a repeated sequence of [w_new, g_new, m1_new, m2_new, w_mixed_precision_new].
+template <typename T1, typename T2, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM, typename T_MIXED_PRECISION_FP>
+class MultiTensorAdamOptimizer final : public CudaKernel {
+ public:
+  MultiTensorAdamOptimizer(const OpKernelInfo& info) : CudaKernel(info) {
+    alpha_ = info.GetAttrsOrDefault("alpha", std::vector<float>(1024, 0.9f));
+    beta_ = info.GetAttrsOrDefault("beta", std::vector<float>(1024, 0.999f));
+    lambda_ = info.GetAttrsOrDefault("lambda", std::vector<float>(1024, 0.0f));
+    epsilon_ = info.GetAttrsOrDefault("epsilon", std::vector<float>(1024, 1e-8f));
+
+    int64_t tmp_flag = static_cast<int64_t>(0);
+    ORT_ENFORCE(info.GetAttr<int64_t>("do_bias_correction", &tmp_flag).IsOK(), "Missing/Invalid do_bias_correction");
+    ORT_ENFORCE(tmp_flag == 0 || tmp_flag == 1, "do_bias_correction must be either 0 or 1.");
+    do_bias_correction_ = tmp_flag != 0 ? true : false;
+    info.GetAttrOrDefault("weight_decay_mode", &weight_decay_mode_, static_cast<int64_t>(0));
+    ORT_ENFORCE(weight_decay_mode_ == 0 || weight_decay_mode_ == 1, "weight_decay_mode must be either 0 or 1.");
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  std::vector<float> alpha_;
+  std::vector<float> beta_;
+  std::vector<float> lambda_;
+  std::vector<float> epsilon_;
+  bool do_bias_correction_;
+  int64_t weight_decay_mode_;
+};
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -23,5 +23,14 @@ if (g_norm != nullptr && TFinalScale(*g_norm) > scale) {
 }
 return scale;
 }
+
+// ---------------------------------------------------------------------------
+// _IsGradNormFinite -- helper to skip an update on the device when gradients overflow
+// ---------------------------------------------------------------------------
+
+template<typename TGradNorm>
+__device__ __forceinline__ bool _IsGradNormFinite(const TGradNorm* g_norm) {
+return g_norm == nullptr || isfinite(float(*g_norm));
+}
 }  // namespace cuda
 }  // namespace onnxruntime
\ No newline at end of file
@@ -83,5 +83,48 @@ Status InPlaceAccumulator<T, T_GRAD>::ComputeInternal(OpKernelContext* ctx) cons
   return Status::OK();
 }
 
+template <typename T_GRAD_NORM>
+Status DynamicLossScale<T_GRAD_NORM>::ComputeInternal(OpKernelContext* ctx) const {
+  typedef typename ToCudaType<T_GRAD_NORM>::MappedType CudaT_GRAD_NORM;
+
+  const Tensor& loss_scale = *ctx->Input<Tensor>(0);
+  const Tensor& stable_steps = *ctx->Input<Tensor>(1);
+  const Tensor& gradient_norm = *ctx->Input<Tensor>(2);
+  Tensor& loss_scale_out = *ctx->Output(0, loss_scale.Shape());
+  Tensor& stable_steps_out = *ctx->Output(1, stable_steps.Shape());
+
+  // The gradient norm is checked on the device, so the loss scale is updated without a host round trip.
+  DynamicLossScaleImpl(
+      loss_scale.template Data<float>(),
+      stable_steps.template Data<int64_t>(),
+      reinterpret_cast<const CudaT_GRAD_NORM*>(gradient_norm.template Data<T_GRAD_NORM>()),
+      up_scale_window_,
+      min_loss_scale_,
+      max_loss_scale_,
+      loss_scale_out.template MutableData<float>(),
+      stable_steps_out.template MutableData<int64_t>());
+
+  return Status::OK();
+}
+
+#define REGISTER_DYNAMIC_LOSS_SCALE_TYPED(T_GRAD_NORM)                                \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                      \
+      DynamicLossScale,                                                               \
+      kMSDomain,                                                                      \
+      1,                                                                              \
+      T_GRAD_NORM,                                                                    \
+      kCudaExecutionProvider,                                                         \
+      KernelDefBuilder()                                                              \
+          .Alias(0, 0) /* Update loss scale in-place */                               \
+          .Alias(1, 1) /* Update stable steps in-place */                             \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())                  \
+          .TypeConstraint("TInt64", DataTypeImpl::GetTensorType<int64_t>())           \
+          .TypeConstraint("T_GRAD_NORM", DataTypeImpl::GetTensorType<T_GRAD_NORM>())  \
+          .TypeConstraint("T_BOOL", DataTypeImpl::GetTensorType<bool>()),             \
+      DynamicLossScale<T_GRAD_NORM>);
+
+REGISTER_DYNAMIC_LOSS_SCALE_TYPED(float)
+REGISTER_DYNAMIC_LOSS_SCALE_TYPED(MLFloat16)
+
 }  // namespace cuda
 }  // namespace onnxruntime
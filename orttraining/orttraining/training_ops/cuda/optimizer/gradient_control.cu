@@ -46,5 +46,66 @@ SPECIALIZED_IMPL_InPlaceAccumulator(float, half)
 SPECIALIZED_IMPL_InPlaceAccumulator(half, half)
 SPECIALIZED_IMPL_InPlaceAccumulator(half, float)
 
+template <typename T_GRAD_NORM>
+__global__ void _DynamicLossScale(
+    const float* loss_scale,
+    const int64_t* stable_steps,
+    const T_GRAD_NORM* gradient_norm,
+    const int64_t up_scale_window,
+    const float min_loss_scale,
+    const float max_loss_scale,
+    float* loss_scale_out,
+    int64_t* stable_steps_out) {
+  float scale = *loss_scale;
+  int64_t steps = *stable_steps;
+  if (isfinite(static_cast<float>(*gradient_norm))) {
+    if (++steps >= up_scale_window) {
+      scale = fminf(max_loss_scale, scale * 2.0f);
+      steps = 0;
+    }
+  } else {
+    scale = fmaxf(min_loss_scale, scale / 2.0f);
+    steps = 0;
+  }
+
+  *loss_scale_out = scale;
+  *stable_steps_out = steps;
+}
+
+template <typename T_GRAD_NORM>
+void DynamicLossScaleImpl(
+    const float* loss_scale,
+    const int64_t* stable_steps,
+    const T_GRAD_NORM* gradient_norm,
+    const int64_t up_scale_window,
+    const float min_loss_scale,
+    const float max_loss_scale,
+    float* loss_scale_out,
+    int64_t* stable_steps_out) {
+  _DynamicLossScale<T_GRAD_NORM><<<1, 1, 0>>>(
+      loss_scale,
+      stable_steps,
+      gradient_norm,
+      up_scale_window,
+      min_loss_scale,
+      max_loss_scale,
+      loss_scale_out,
+      stable_steps_out);
+}
+
+#define SPECIALIZED_IMPL_DynamicLossScale(T_GRAD_NORM) \
+  template void DynamicLossScaleImpl(                  \
+      const float* loss_scale,                         \
+      const int64_t* stable_steps,                     \
+      const T_GRAD_NORM* gradient_norm,                \
+      const int64_t up_scale_window,                   \
+      const float min_loss_scale,                      \
+      const float max_loss_scale,                      \
+      float* loss_scale_out,                           \
+      int64_t* stable_steps_out);
+
+SPECIALIZED_IMPL_DynamicLossScale(float)
+SPECIALIZED_IMPL_DynamicLossScale(half)
+
 }  // namespace cuda
 }  // namespace onnxruntime
\ No newline at end of file
@@ -22,6 +22,22 @@ class InPlaceAccumulator final : public CudaKernel {
   Status ComputeInternal(OpKernelContext* context) const override;
 };
 
+template <typename T_GRAD_NORM>
+class DynamicLossScale final : public CudaKernel {
+ public:
+  DynamicLossScale(const OpKernelInfo& info) : CudaKernel(info) {
+    up_scale_window_ = info.GetAttrOrDefault<int64_t>("up_scale_window", 2000);
+    min_loss_scale_ = info.GetAttrOrDefault<float>("min_loss_scale", 1.0f);
+    max_loss_scale_ = info.GetAttrOrDefault<float>("max_loss_scale", static_cast<float>(1 << 24));
+  }
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  int64_t up_scale_window_;
+  float min_loss_scale_;
+  float max_loss_scale_;
+};
+
 // Implementation can be found in cuda file, optimizers_impl.cu
 template <typename T, typename T_GRAD>
 void InPlaceAccumulatorImpl(
@@ -30,5 +46,16 @@ void InPlaceAccumulatorImpl(
     T* accumulated_gradient,
     size_t count);
 
+template <typename T_GRAD_NORM>
+void DynamicLossScaleImpl(
+    const float* loss_scale,
+    const int64_t* stable_steps,
+    const T_GRAD_NORM* gradient_norm,
+    const int64_t up_scale_window,
+    const float min_loss_scale,
+    const float max_loss_scale,
+    float* loss_scale_out,
+    int64_t* stable_steps_out);
+
 }  // namespace cuda
 }  // namespace onnxruntime
\ No newline at end of file
@@ -0,0 +1,355 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "batcher.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+
+// Size of an element of a tensor that can be concatenated with memcpy. Returns 0 for any other type.
+size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+std::vector<Ort::Value> RunSession(Ort::Session& session, const Ort::RunOptions& options,
+                                   const std::vector<std::string>& input_names, std::vector<Ort::Value>& input_values,
+                                   const std::vector<std::string>& output_names) {
+  std::vector<const char*> input_ptrs;
+  input_ptrs.reserve(input_names.size());
+  for (const auto& name : input_names) {
+    input_ptrs.push_back(name.c_str());
+  }
+
+  std::vector<const char*> output_ptrs;
+  output_ptrs.reserve(output_names.size());
+  for (const auto& name : output_names) {
+    output_ptrs.push_back(name.c_str());
+  }
+
+  return session.Run(options, input_ptrs.data(), input_values.data(), input_ptrs.size(),
+                     output_ptrs.data(), output_ptrs.size());
+}
+
+// Builds the batching key of a request and the number of rows it contributes to a batch.
+// Returns an empty key if the request can't be batched.
+std::string MakeBatchKey(const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values,
+                         const std::vector<std::string>& output_names, /* out */ size_t& rows) {
+  rows = 0;
+  if (input_values.empty()) {
+    return {};
+  }
+
+  std::ostringstream key;
+  for (size_t i = 0; i < input_values.size(); ++i) {
+    if (!input_values[i].IsTensor()) {
+      return {};
+    }
+
+    auto info = input_values[i].GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    if (ElementSize(type) == 0 || shape.empty() || shape[0] <= 0) {
+      return {};
+    }
+
+    if (i == 0) {
+      rows = static_cast<size_t>(shape[0]);
+    } else if (static_cast<size_t>(shape[0]) != rows) {
+      return {};
+    }
+
+    key << input_names[i] << ':' << type;
+    for (size_t d = 1; d < shape.size(); ++d) {
+      key << ',' << shape[d];
+    }
+    key << ';';
+  }
+
+  key << '|';
+  for (const auto& name : output_names) {
+    key << name << ';';
+  }
+
+  return key.str();
+}
+
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(const Ort::Session& session, const BatchingOptions& options, OrtLoggingLevel severity,
+                               std::shared_ptr<spdlog::logger> logger, ModelMetrics* metrics)
+    : session_(const_cast<Ort::Session&>(session)),
+      options_(options),
+      severity_(severity),
+      logger_(std::move(logger)),
+      metrics_(metrics),
+      worker_(&DynamicBatcher::WorkerLoop, this) {
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+std::vector<Ort::Value> DynamicBatcher::Run(const std::vector<std::string>& input_names,
+                                            std::vector<Ort::Value>&& input_values,
+                                            const std::vector<std::string>& output_names) {
+  auto request = std::make_unique<Request>();
+
+  // The inputs come from a protobuf map with an unspecified order, so sort them to line up the inputs of
+  // compatible requests.
+  std::vector<size_t> order(input_names.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&input_names](size_t a, size_t b) { return input_names[a] < input_names[b]; });
+  for (auto i : order) {
+    request->input_names.push_back(input_names[i]);
+    request->input_values.push_back(std::move(input_values[i]));
+  }
+  request->output_names = output_names;
+  request->key = MakeBatchKey(request->input_names, request->input_values, request->output_names, request->rows);
+  request->enqueue_time = std::chrono::steady_clock::now();
+
+  auto result = request->result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      throw Ort::Exception("The model is being unloaded.", ORT_FAIL);
+    }
+    queue_.push_back(std::move(request));
+    stats_.max_queue_depth = std::max(stats_.max_queue_depth, queue_.size());
+  }
+  cv_.notify_one();
+
+  return result.get();
+}
+
+BatchingStats DynamicBatcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  BatchingStats stats = stats_;
+  stats.queue_depth = queue_.size();
+  return stats;
+}
+
+void DynamicBatcher::WorkerLoop() {
+  while (true) {
+    std::vector<std::unique_ptr<Request>> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+
+      // Wait for more compatible requests until the batch is full or the first request has waited long enough.
+      const auto& front = *queue_.front();
+      if (!front.key.empty()) {
+        const auto deadline = front.enqueue_time + options_.batch_timeout;
+        while (!shutdown_) {
+          size_t rows = 0;
+          for (const auto& request : queue_) {
+            if (request->key == front.key) {
+              rows += request->rows;
+            }
+          }
+
+          if (rows >= options_.max_batch_size ||
+              cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+            break;
+          }
+        }
+      }
+
+      batch = TakeBatch();
+
+      size_t batch_rows = 0;
+      for (const auto& request : batch) {
+        batch_rows += request->rows;
+      }
+      ++stats_.batch_size_histogram[batch_rows];
+
+      if (metrics_ != nullptr) {
+        const auto now = std::chrono::steady_clock::now();
+        metrics_->batch_size.Observe(static_cast<double>(batch_rows));
+        for (const auto& request : batch) {
+          metrics_->queue_wait.Observe(std::chrono::duration<double>(now - request->enqueue_time).count());
+        }
+      }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    RunBatch(batch);
+    if (metrics_ != nullptr) {
+      metrics_->AddBusyTime(std::chrono::steady_clock::now() - start);
+    }
+  }
+}
+
+std::vector<std::unique_ptr<DynamicBatcher::Request>> DynamicBatcher::TakeBatch() {
+  std::vector<std::unique_ptr<Request>> batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+
+  const auto& key = batch.front()->key;
+  if (key.empty()) {
+    return batch;
+  }
+
+  size_t rows = batch.front()->rows;
+  for (auto it = queue_.begin(); it != queue_.end() && rows < options_.max_batch_size;) {
+    if ((*it)->key == key && rows + (*it)->rows <= options_.max_batch_size) {
+      rows += (*it)->rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return batch;
+}
+
+std::vector<Ort::Value> DynamicBatcher::RunSingle(Request& request) {
+  Ort::RunOptions run_options{};
+  run_options.SetRunLogVerbosityLevel(static_cast<int>(severity_));
+  return RunSession(session_, run_options, request.input_names, request.input_values, request.output_names);
+}
+
+void DynamicBatcher::RunBatch(std::vector<std::unique_ptr<Request>>& batch) {
+  auto run_individually = [this, &batch]() {
+    for (auto& request : batch) {
+      try {
+        request->result.set_value(RunSingle(*request));
+      } catch (...) {
+        request->result.set_exception(std::current_exception());
+      }
+    }
+  };
+
+  if (batch.size() == 1) {
+    run_individually();
+    return;
+  }
+
+  const auto& first = *batch.front();
+  size_t total_rows = 0;
+  for (const auto& request : batch) {
+    total_rows += request->rows;
+  }
+
+  std::vector<Ort::Value> outputs;
+  try {
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    // Concatenate the inputs along the first dimension
+    std::vector<Ort::Value> input_values;
+    input_values.reserve(first.input_values.size());
+    for (size_t i = 0; i < first.input_values.size(); ++i) {
+      auto info = first.input_values[i].GetTensorTypeAndShapeInfo();
+      auto type = info.GetElementType();
+      auto shape = info.GetShape();
+      shape[0] = static_cast<int64_t>(total_rows);
+
+      auto value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+      auto* dst = value.GetTensorMutableData<uint8_t>();
+      for (auto& request : batch) {
+        auto& src = request->input_values[i];
+        const size_t bytes = src.GetTensorTypeAndShapeInfo().GetElementCount() * ElementSize(type);
+        std::memcpy(dst, src.GetTensorMutableData<uint8_t>(), bytes);
+        dst += bytes;
+      }
+
+      input_values.push_back(std::move(value));
+    }
+
+    Ort::RunOptions run_options{};
+    run_options.SetRunLogVerbosityLevel(static_cast<int>(severity_));
+    outputs = RunSession(session_, run_options, first.input_names, input_values, first.output_names);
+  } catch (...) {
+    auto error = std::current_exception();
+    for (auto& request : batch) {
+      request->result.set_exception(error);
+    }
+    return;
+  }
+
+  // Every output has to be a tensor that can be split along the batch dimension
+  for (const auto& output : outputs) {
+    bool can_split = output.IsTensor();
+    if (can_split) {
+      auto info = output.GetTensorTypeAndShapeInfo();
+      auto shape = info.GetShape();
+      can_split = ElementSize(info.GetElementType()) != 0 && !shape.empty() &&
+                  shape[0] == static_cast<int64_t>(total_rows);
+    }
+
+    if (!can_split) {
+      logger_->debug("Model outputs don't share the batch dimension of the inputs. Running requests individually.");
+      run_individually();
+      return;
+    }
+  }
+
+  try {
+    Ort::AllocatorWithDefaultOptions allocator;
+    std::vector<std::vector<Ort::Value>> results(batch.size());
+    for (auto& output : outputs) {
+      auto info = output.GetTensorTypeAndShapeInfo();
+      auto type = info.GetElementType();
+      auto shape = info.GetShape();
+      const size_t row_bytes = info.GetElementCount() / total_rows * ElementSize(type);
+
+      const auto* src = output.GetTensorMutableData<uint8_t>();
+      for (size_t r = 0; r < batch.size(); ++r) {
+        shape[0] = static_cast<int64_t>(batch[r]->rows);
+        auto value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+        const size_t bytes = row_bytes * batch[r]->rows;
+        std::memcpy(value.GetTensorMutableData<uint8_t>(), src, bytes);
+        src += bytes;
+        results[r].push_back(std::move(value));
+      }
+    }
+
+    for (size_t r = 0; r < batch.size(); ++r) {
+      batch[r]->result.set_value(std::move(results[r]));
+    }
+  } catch (...) {
+    auto error = std::current_exception();
+    for (auto& request : batch) {
+      request->result.set_exception(error);
+    }
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include "onnxruntime_cxx_api.h"
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // Maximum number of rows (the sum of the first dimension of the inputs) in a batch.
+  // Values less than 2 disable batching.
+  size_t max_batch_size = 1;
+  // How long the first request of a batch waits for other requests to join it.
+  std::chrono::microseconds batch_timeout{1000};
+};
+
+struct BatchingStats {
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+  // Number of Run calls per batch size in rows. Requests that can't be batched are counted under 0.
+  std::map<size_t, uint64_t> batch_size_histogram;
+};
+
+// Groups concurrent requests for one model into a single Run.
+// Requests are compatible if they have the same inputs, with the same element types and the same shapes apart
+// from the first dimension, and request the same outputs. The inputs of compatible requests are concatenated
+// along the first dimension and the outputs are split back into one set of outputs per request.
+// Requests that can't be batched (e.g. string inputs, or scalar inputs) or whose outputs don't share the batch
+// dimension are run individually.
+// Batches are run one at a time by a worker thread per model.
+class DynamicBatcher {
+ public:
+  // The batch sizes, queue waits and busy time of the session are recorded in metrics, if it is not null.
+  DynamicBatcher(const Ort::Session& session, const BatchingOptions& options, OrtLoggingLevel severity,
+                 std::shared_ptr<spdlog::logger> logger, ModelMetrics* metrics = nullptr);
+  ~DynamicBatcher();
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  // Queue a request and block until the batch it is part of has run.
+  // Throws Ort::Exception if the Run fails.
+  std::vector<Ort::Value> Run(const std::vector<std::string>& input_names,
+                              std::vector<Ort::Value>&& input_values,
+                              const std::vector<std::string>& output_names);
+
+  BatchingStats GetStats() const;
+
+ private:
+  struct Request {
+    std::vector<std::string> input_names;
+    std::vector<Ort::Value> input_values;
+    std::vector<std::string> output_names;
+    // Requests with the same non-empty key can be batched together.
+    std::string key;
+    size_t rows = 0;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<std::vector<Ort::Value>> result;
+  };
+
+  void WorkerLoop();
+
+  // Remove the request at the front of the queue and the requests compatible with it from the queue.
+  std::vector<std::unique_ptr<Request>> TakeBatch();
+
+  void RunBatch(std::vector<std::unique_ptr<Request>>& batch);
+  std::vector<Ort::Value> RunSingle(Request& request);
+
+  Ort::Session& session_;
+  const BatchingOptions options_;
+  const OrtLoggingLevel severity_;
+  std::shared_ptr<spdlog::logger> logger_;
+  ModelMetrics* metrics_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  bool shutdown_ = false;
+  BatchingStats stats_;
+
+  std::thread worker_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
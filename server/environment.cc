@@ -1,9 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include "environment.h"
 #include "onnxruntime_cxx_api.h"
+#include "onnxruntime_session_options_config_keys.h"
+#include "predict.pb.h"
+#include <google/protobuf/util/json_util.h>
 
 #ifdef USE_DNNL
 
@@ -87,32 +94,327 @@ void ServerEnvironment::RegisterExecutionProviders(){
 }
 
 void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
-  RegisterExecutionProviders();
-  auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), options_));
+  ModelConfig model;
+  model.name = model_name;
+  model.version = model_version;
+  model.path = model_path;
+  LoadModels({model});
+}
 
-  if (!result.second) {
-    throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+void ServerEnvironment::SetCoreBudget(int num_cores, bool pin_threads) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the cores owned by the loaded models stay theirs
+  std::vector<int> owned(std::max(num_cores, 0), 0);
+  for (const auto& entry : sessions_) {
+    for (int core : entry.second->cores) {
+      if (core < num_cores) {
+        owned[core] = 1;
+      }
+    }
   }
 
-  auto iterator = result.first;
-  auto output_count = (iterator->second).session.GetOutputCount();
+  num_cores_ = std::max(num_cores, 0);
+  pin_threads_ = pin_threads;
+  free_cores_.clear();
+  for (int core = 0; core < num_cores_; ++core) {
+    if (!owned[core]) {
+      free_cores_.push_back(core);
+    }
+  }
+}
+
+std::shared_ptr<ServerEnvironment::SessionPool> ServerEnvironment::CreateSessionPool(const ModelConfig& model,
+                                                                                     std::vector<int> cores) {
+  auto pool = std::make_shared<SessionPool>();
+  pool->cores = std::move(cores);
+  pool->load_id = ++num_loads_;
+  pool->metrics = &metrics_.AddModel(model.name, model.version);
+
+  const size_t num_sessions = static_cast<size_t>(model.num_sessions);
+  size_t first_core = 0;
+  for (size_t i = 0; i < num_sessions; ++i) {
+    Ort::SessionOptions options = options_.Clone();
+
+    // the cores of the model are split evenly between its sessions, each session gets at least one thread
+    if (num_cores_ > 0) {
+      const size_t session_cores = pool->cores.size() / num_sessions + (i < pool->cores.size() % num_sessions ? 1 : 0);
+      options.SetIntraOpNumThreads(static_cast<int>(std::max<size_t>(session_cores, 1)));
+      if (pin_threads_ && session_cores > 0) {
+        std::string affinities;
+        for (size_t j = first_core; j < first_core + session_cores; ++j) {
+          affinities += (j == first_core ? "" : ",") + std::to_string(pool->cores[j]);
+        }
+        options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, affinities.c_str());
+      }
+      first_core += session_cores;
+    }
+
+    pool->sessions.push_back(std::make_unique<SessionHolder>(runtime_environment_, model.path, options));
+  }
+
+  const auto& session = pool->sessions.front()->session;
+  auto output_count = session.GetOutputCount();
 
   Ort::AllocatorWithDefaultOptions allocator;
   for (size_t i = 0; i < output_count; i++) {
-    auto name = (iterator->second).session.GetOutputName(i, allocator);
-    (iterator->second).output_names.push_back(name);
+    auto name = session.GetOutputName(i, allocator);
+    pool->output_names.push_back(name);
     allocator.Free(name);
+
+    OutputInfo info{ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED, {}};
+    auto type_info = session.GetOutputTypeInfo(i);
+    if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
+      auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+      info.element_type = tensor_info.GetElementType();
+      info.shape = tensor_info.GetShape();
+    }
+    pool->output_info.push_back(std::move(info));
+  }
+
+  // every session batches the requests it is given
+  if (batching_options_.max_batch_size > 1) {
+    for (auto& holder : pool->sessions) {
+      holder->batcher = std::make_unique<DynamicBatcher>(holder->session, batching_options_, severity_, default_logger_,
+                                                         pool->metrics);
+    }
   }
+
+  return pool;
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
+void ServerEnvironment::LoadModels(const std::vector<ModelConfig>& models) {
+  if (models.empty()) {
+    return;
+  }
+
+  if (!providers_registered_) {
+    RegisterExecutionProviders();
+    providers_registered_ = true;
+  }
+
+  int total_weight = 0;
+  for (const auto& model : models) {
+    if (model.weight <= 0 || model.num_sessions <= 0) {
+      throw Ort::Exception("The weight and the number of sessions of model " + model.name + " must be positive.",
+                           ORT_INVALID_ARGUMENT);
+    }
+    total_weight += model.weight;
+  }
+
+  // The cores are taken up front so concurrent loads don't share them, and given back if a model fails to load.
+  std::vector<std::vector<int>> model_cores(models.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::set<std::pair<std::string, std::string>> identifiers;
+    for (const auto& model : models) {
+      auto identifier = std::make_pair(model.name, model.version);
+      if (sessions_.count(identifier) != 0 || !identifiers.insert(identifier).second) {
+        throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+      }
+    }
+
+    // largest remainder split of the free cores by weight
+    const size_t num_free = free_cores_.size();
+    std::vector<size_t> shares(models.size());
+    std::vector<std::pair<size_t, size_t>> remainders;
+    size_t assigned = 0;
+    for (size_t i = 0; i < models.size(); ++i) {
+      const size_t weighted = num_free * static_cast<size_t>(models[i].weight);
+      shares[i] = weighted / static_cast<size_t>(total_weight);
+      remainders.emplace_back(weighted % static_cast<size_t>(total_weight), i);
+      assigned += shares[i];
+    }
+    std::sort(remainders.begin(), remainders.end(), std::greater<std::pair<size_t, size_t>>());
+    for (size_t i = 0; assigned < num_free; ++i, ++assigned) {
+      ++shares[remainders[i].second];
+    }
+
+    auto next_core = free_cores_.begin();
+    for (size_t i = 0; i < models.size(); ++i) {
+      model_cores[i].assign(next_core, next_core + shares[i]);
+      next_core += shares[i];
+    }
+    free_cores_.erase(free_cores_.begin(), next_core);
+  }
+
+  auto release_cores = [this, &model_cores](size_t from) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = from; i < model_cores.size(); ++i) {
+      free_cores_.insert(free_cores_.end(), model_cores[i].begin(), model_cores[i].end());
+    }
+    std::sort(free_cores_.begin(), free_cores_.end());
+  };
+
+  std::vector<std::shared_ptr<SessionPool>> pools;
+  try {
+    for (size_t i = 0; i < models.size(); ++i) {
+      if (num_cores_ > 0 && model_cores[i].size() < static_cast<size_t>(models[i].num_sessions)) {
+        default_logger_->warn("Model {} version {} has {} cores for {} sessions. The sessions share the cores.",
+                              models[i].name, models[i].version, model_cores[i].size(), models[i].num_sessions);
+      }
+      pools.push_back(CreateSessionPool(models[i], model_cores[i]));
+    }
+  } catch (const Ort::Exception&) {
+    release_cores(0);
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < models.size(); ++i) {
+    if (!sessions_.emplace(std::make_pair(models[i].name, models[i].version), pools[i]).second) {
+      // loaded concurrently under the same name
+      for (size_t j = 0; j < i; ++j) {
+        sessions_.erase(std::make_pair(models[j].name, models[j].version));
+      }
+      for (const auto& cores : model_cores) {
+        free_cores_.insert(free_cores_.end(), cores.begin(), cores.end());
+      }
+      std::sort(free_cores_.begin(), free_cores_.end());
+      throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+    }
+
+    default_logger_->info("Loaded model {} version {} with {} sessions on {} cores", models[i].name,
+                          models[i].version, models[i].num_sessions, model_cores[i].size());
+  }
+}
+
+void ServerEnvironment::SetBatchingOptions(const BatchingOptions& options) {
+  batching_options_ = options;
+}
+
+void ServerEnvironment::SetResponseCacheOptions(const ResponseCacheOptions& options) {
+  response_cache_ = options.max_bytes > 0 ? std::make_unique<ResponseCache>(options) : nullptr;
+}
+
+std::shared_ptr<const ServerEnvironment::SessionPool> ServerEnvironment::FindModel(const std::string& model_name,
+                                                                                   const std::string& model_version) const {
   auto identifier = std::make_pair(model_name, model_version);
+  std::lock_guard<std::mutex> lock(mutex_);
   auto it = sessions_.find(identifier);
   if (it == sessions_.end()) {
     throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
   }
 
-  return it->second.output_names;
+  return it->second;
+}
+
+ServerEnvironment::ModelLease::ModelLease(std::shared_ptr<const SessionPool> pool, SessionHolder* session)
+    : pool_(std::move(pool)), session_(session) {
+  ++session_->in_flight;
+}
+
+ServerEnvironment::ModelLease::ModelLease(ModelLease&& other) noexcept
+    : pool_(std::move(other.pool_)), session_(other.session_) {
+  other.session_ = nullptr;
+}
+
+ServerEnvironment::ModelLease::~ModelLease() {
+  if (session_ != nullptr) {
+    --session_->in_flight;
+  }
+}
+
+ServerEnvironment::ModelLease ServerEnvironment::AcquireModel(const std::string& model_name,
+                                                              const std::string& model_version) const {
+  auto pool = FindModel(model_name, model_version);
+
+  SessionHolder* least_busy = pool->sessions.front().get();
+  for (const auto& holder : pool->sessions) {
+    if (holder->in_flight < least_busy->in_flight) {
+      least_busy = holder.get();
+    }
+  }
+
+  return ModelLease(std::move(pool), least_busy);
+}
+
+bool ServerEnvironment::GetBatchingStats(const std::string& model_name, const std::string& model_version,
+                                         BatchingStats& stats) const {
+  auto pool = FindModel(model_name, model_version);
+  if (pool->sessions.front()->batcher == nullptr) {
+    return false;
+  }
+
+  stats = BatchingStats{};
+  for (const auto& holder : pool->sessions) {
+    auto session_stats = holder->batcher->GetStats();
+    stats.queue_depth += session_stats.queue_depth;
+    stats.max_queue_depth = std::max(stats.max_queue_depth, session_stats.max_queue_depth);
+    for (const auto& bucket : session_stats.batch_size_histogram) {
+      stats.batch_size_histogram[bucket.first] += bucket.second;
+    }
+  }
+
+  return true;
+}
+
+void ServerEnvironment::WriteMetrics(std::ostream& out) const {
+  metrics_.Write(out);
+
+  std::vector<std::pair<std::pair<std::string, std::string>, std::shared_ptr<const SessionPool>>> pools;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pools.assign(sessions_.begin(), sessions_.end());
+  }
+  std::sort(pools.begin(), pools.end(),
+            [](const decltype(pools)::value_type& lhs, const decltype(pools)::value_type& rhs) {
+              return lhs.first < rhs.first;
+            });
+
+  auto labels = [](const std::pair<std::string, std::string>& model) {
+    return "model=\"" + EscapeLabelValue(model.first) + "\",version=\"" + EscapeLabelValue(model.second) + "\"";
+  };
+
+  out << "# HELP ort_server_sessions Sessions of the model.\n"
+      << "# TYPE ort_server_sessions gauge\n";
+  for (const auto& pool : pools) {
+    out << "ort_server_sessions{" << labels(pool.first) << "} " << pool.second->sessions.size() << "\n";
+  }
+
+  out << "# HELP ort_server_requests_in_flight Requests using the sessions of the model.\n"
+      << "# TYPE ort_server_requests_in_flight gauge\n";
+  for (const auto& pool : pools) {
+    int in_flight = 0;
+    for (const auto& holder : pool.second->sessions) {
+      in_flight += holder->in_flight;
+    }
+    out << "ort_server_requests_in_flight{" << labels(pool.first) << "} " << in_flight << "\n";
+  }
+
+  out << "# HELP ort_server_arena_bytes_in_use Bytes in use of the arena allocators of the sessions of the model.\n"
+      << "# TYPE ort_server_arena_bytes_in_use gauge\n";
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (const auto& pool : pools) {
+    // summed over the sessions per provider and device
+    std::map<std::string, int64_t> bytes_in_use;
+    for (const auto& holder : pool.second->sessions) {
+      try {
+        char* stats_json = holder->session.GetArenaStats(allocator);
+        ArenaStats stats;
+        auto status = google::protobuf::util::JsonStringToMessage(stats_json, &stats);
+        allocator.Free(stats_json);
+        if (!status.ok()) {
+          continue;
+        }
+
+        for (const auto& arena : stats.arenas()) {
+          auto arena_labels = ",provider=\"" + EscapeLabelValue(arena.provider()) + "\",device=\"" +
+                              EscapeLabelValue(arena.device()) + "\",device_id=\"" + std::to_string(arena.device_id()) + "\"";
+          bytes_in_use[arena_labels] += arena.bytes_in_use();
+        }
+      } catch (const Ort::Exception& e) {
+        default_logger_->warn("GetArenaStats failed: {}", e.what());
+      }
+    }
+
+    for (const auto& arena : bytes_in_use) {
+      out << "ort_server_arena_bytes_in_use{" << labels(pool.first) << arena.first << "} " << arena.second << "\n";
+    }
+  }
+}
+
+std::vector<int> ServerEnvironment::GetModelCores(const std::string& model_name, const std::string& model_version) const {
+  return FindModel(model_name, model_version)->cores;
 }
 
 OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
@@ -120,13 +422,7 @@ OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
 }
 
 const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
-  }
-
-  return it->second.session;
+  return FindModel(model_name, model_version)->sessions.front()->session;
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -141,12 +437,26 @@ std::shared_ptr<spdlog::logger> ServerEnvironment::GetAppLogger() const {
 
 void ServerEnvironment::UnloadModel(const std::string& model_name, const std::string& model_version) {
   auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  std::shared_ptr<SessionPool> pool;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(identifier);
+    if (it == sessions_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+
+    pool = std::move(it->second);
+    sessions_.erase(it);
+    for (int core : pool->cores) {
+      if (core < num_cores_) {
+        free_cores_.push_back(core);
+      }
+    }
+    std::sort(free_cores_.begin(), free_cores_.end());
   }
 
-  sessions_.erase(it);
+  // the sessions are released outside of the lock, or by the last request using them
+  pool.reset();
 }
 
 }  // namespace server
@@ -3,10 +3,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"
+#include "batcher.h"
+#include "metrics.h"
+#include "response_cache.h"
 #include <spdlog/spdlog.h>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
@@ -14,22 +19,129 @@
 namespace onnxruntime {
 namespace server {
 
+// A model hosted by the server.
+struct ModelConfig {
+  std::string name;
+  std::string version;
+  std::string path;
+  // Share of the cores of the server among the models loaded together.
+  int weight = 1;
+  // Number of sessions that run requests for the model concurrently. The cores of the model are split between them.
+  int num_sessions = 1;
+};
+
 class ServerEnvironment {
  public:
+  // Element type and shape of an output of a model. The shape has -1 for symbolic dimensions and the element type is
+  // UNDEFINED if the output isn't a tensor.
+  struct OutputInfo {
+    ONNXTensorElementDataType element_type;
+    std::vector<int64_t> shape;
+  };
+
+ private:
+  struct SessionHolder {
+    Ort::Session session;
+    // Requests using the session.
+    std::atomic<int> in_flight{0};
+    // declared after the session so it is destroyed first
+    std::unique_ptr<DynamicBatcher> batcher;
+    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
+      session = Ort::Session(env, path.c_str(), options);
+    };
+    ~SessionHolder() = default;
+    SessionHolder(const SessionHolder&) = delete;
+    SessionHolder(const SessionHolder&&) = delete;
+    SessionHolder& operator=(const SessionHolder&) = delete;
+  };
+
+  // The sessions of a model. Shared with the requests in flight so the model can be unloaded while they complete.
+  struct SessionPool {
+    std::vector<std::unique_ptr<SessionHolder>> sessions;
+    std::vector<std::string> output_names;
+    std::vector<OutputInfo> output_info;
+    // Cores owned by the model, returned to the server when it is unloaded.
+    std::vector<int> cores;
+    // Differs between loads of the same model name and version.
+    uint64_t load_id = 0;
+    ModelMetrics* metrics = nullptr;
+  };
+
+ public:
+  // Holds a session of a model for the duration of a request. The model stays loaded until the lease is destroyed.
+  class ModelLease {
+   public:
+    ModelLease(ModelLease&& other) noexcept;
+    ~ModelLease();
+    ModelLease(const ModelLease&) = delete;
+    ModelLease& operator=(const ModelLease&) = delete;
+    ModelLease& operator=(ModelLease&&) = delete;
+
+    const Ort::Session& Session() const { return session_->session; }
+    // Returns nullptr if batching is disabled for the model.
+    DynamicBatcher* Batcher() const { return session_->batcher.get(); }
+    const std::vector<std::string>& OutputNames() const { return pool_->output_names; }
+    // In the order of OutputNames.
+    const std::vector<OutputInfo>& OutputInfos() const { return pool_->output_info; }
+    uint64_t LoadId() const { return pool_->load_id; }
+    ModelMetrics& Metrics() const { return *pool_->metrics; }
+
+   private:
+    friend class ServerEnvironment;
+    ModelLease(std::shared_ptr<const SessionPool> pool, SessionHolder* session);
+
+    std::shared_ptr<const SessionPool> pool_;
+    SessionHolder* session_;
+  };
+
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
   ~ServerEnvironment() = default;
   ServerEnvironment(const ServerEnvironment&) = delete;
 
   OrtLoggingLevel GetLogSeverity() const;
 
+  // Returns the session with the fewest requests in flight among the sessions of the model.
+  // Throws Ort::Exception if the model isn't loaded.
+  ModelLease AcquireModel(const std::string& model_name, const std::string& model_version) const;
+
+  // The first session of the model.
   const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
   void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
-  const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+  // Loads the models, splitting the free cores between them in proportion to their weight. The models already loaded
+  // keep their cores. Either all the models are loaded, or none is and Ort::Exception is thrown.
+  void LoadModels(const std::vector<ModelConfig>& models);
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
+  // The requests in flight complete before the sessions of the model are released.
   void UnloadModel(const std::string& model_name, const std::string& model_version);
   void RegisterExecutionProviders();
 
+  // Batching options for the models initialized after the call.
+  void SetBatchingOptions(const BatchingOptions& options);
+  // Sums the batching statistics of the sessions of the model. Returns false if batching is disabled for the model.
+  bool GetBatchingStats(const std::string& model_name, const std::string& model_version,
+                        /* out */ BatchingStats& stats) const;
+
+  // Responses are cached for the requests after the call. A max_bytes of 0 disables the cache.
+  void SetResponseCacheOptions(const ResponseCacheOptions& options);
+  // Returns nullptr if the response cache is disabled.
+  ResponseCache* GetResponseCache() const { return response_cache_.get(); }
+
+  // Returns nullptr if the model was never loaded.
+  ModelMetrics* GetModelMetrics(const std::string& model_name, const std::string& model_version) const {
+    return metrics_.GetModel(model_name, model_version);
+  }
+  // Writes the metrics of the models, their sessions and the bytes in use of their arenas in the Prometheus text
+  // format.
+  void WriteMetrics(std::ostream& out) const;
+
+  // Cores owned by the model, empty if there is no core budget.
+  std::vector<int> GetModelCores(const std::string& model_name, const std::string& model_version) const;
+
+  // Cores of the machine to split between the models loaded after the call. 0 leaves the number of intra-op threads
+  // of the sessions to ONNX Runtime. If pin_threads is set, the intra-op threads of a session are pinned to its cores.
+  void SetCoreBudget(int num_cores, bool pin_threads);
+
  private:
   const OrtLoggingLevel severity_;
   const std::string logger_id_;
@@ -38,20 +150,22 @@ class ServerEnvironment {
 
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
+  BatchingOptions batching_options_;
+  bool providers_registered_ = false;
 
-  struct SessionHolder {
-    Ort::Session session;
-    std::vector<std::string> output_names;
-    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
-      session = Ort::Session(env, path.c_str(), options);
-    };
-    ~SessionHolder() = default;
-    SessionHolder(const SessionHolder&) = delete;
-    SessionHolder(const SessionHolder&&) = delete;
-    SessionHolder& operator=(const SessionHolder&) = delete;
-  };
+  int num_cores_ = 0;
+  bool pin_threads_ = false;
+  std::atomic<uint64_t> num_loads_{0};
+  std::unique_ptr<ResponseCache> response_cache_;
+  ServerMetrics metrics_;
+
+  std::shared_ptr<SessionPool> CreateSessionPool(const ModelConfig& model, std::vector<int> cores);
+  std::shared_ptr<const SessionPool> FindModel(const std::string& model_name, const std::string& model_version) const;
 
-  std::unordered_map<std::pair<std::string, std::string>, ServerEnvironment::SessionHolder, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  // guards sessions_ and free_cores_
+  mutable std::mutex mutex_;
+  std::vector<int> free_cores_;
+  std::unordered_map<std::pair<std::string, std::string>, std::shared_ptr<SessionPool>, boost::hash<std::pair<std::string, std::string>>> sessions_;
 };
 
 }  // namespace server
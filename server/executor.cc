@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include <stdio.h>
+#include <algorithm>
+#include <chrono>
 #include "serializing/mem_buffer.h"
 #include "serializing/tensorprotoutils.h"
 
@@ -23,6 +25,16 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  // the request outlives the Run, so raw data in the right format is used in place
+  try {
+    if (onnxruntime::server::TensorProtoRawDataToMLValue(input_tensor, *cpu_memory_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TensorProtoRawDataToMLValue() failed. Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -79,7 +91,8 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
   return protobufutil::Status::OK;
 }
 
-std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+// Entries of outputs that are not null are pre-allocated and written by the Run in place.
+static void Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names, std::vector<Ort::Value>& outputs) {
   size_t input_count = input_names.size();
   size_t output_count = output_names.size();
 
@@ -93,8 +106,104 @@ std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions&
   for (const auto& output : output_names) {
     output_ptrs.push_back(output.data());
   }
+  while (outputs.size() < output_count) {
+    outputs.emplace_back(nullptr);
+  }
 
-  return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
+  const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), outputs.data(), output_count);
+}
+
+// Size of the elements of the types that MLValueToTensorProto writes to raw_data as they are, 0 for the others.
+static size_t RawDataElementSize(ONNXTensorElementDataType element_type) {
+  switch (element_type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+bool Executor::PreallocateOutput(const ServerEnvironment::OutputInfo& info,
+                                 OrtMemoryInfo* cpu_memory_info,
+                                 /* out */ onnx::TensorProto& tensor_proto,
+                                 /* out */ Ort::Value& ml_value) {
+  const size_t element_size = RawDataElementSize(info.element_type);
+  if (element_size == 0) {
+    return false;
+  }
+
+  size_t size = element_size;
+  for (auto dim : info.shape) {
+    if (dim < 0) {
+      return false;
+    }
+    size *= static_cast<size_t>(dim);
+  }
+
+  // the same fields as MLValueToTensorProto sets
+  for (auto dim : info.shape) {
+    tensor_proto.add_dims(dim);
+  }
+  tensor_proto.set_data_type(MLDataTypeToTensorProtoDataType(info.element_type));
+  tensor_proto.set_data_location(onnx::TensorProto_DataLocation_DEFAULT);
+
+  auto* raw_data = tensor_proto.mutable_raw_data();
+  raw_data->resize(size);
+  if (size == 0 || reinterpret_cast<uintptr_t>(&(*raw_data)[0]) % element_size != 0) {
+    tensor_proto.Clear();
+    return false;
+  }
+
+  ml_value = Ort::Value::CreateTensor(cpu_memory_info, &(*raw_data)[0], size, info.shape.data(), info.shape.size(),
+                                      info.element_type);
+  return true;
+}
+
+protobufutil::Status Executor::Predict(const std::string& model_name,
+                                       const std::string& model_version,
+                                       const std::vector<std::string>& input_names,
+                                       std::vector<Ort::Value> input_values,
+                                       std::vector<std::string>& output_names,
+                                       /* out */ std::vector<Ort::Value>& outputs) {
+  Ort::RunOptions run_options{};
+  run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
+  run_options.SetRunTag(request_id_.c_str());
+
+  try {
+    auto model = env_->AcquireModel(model_name, model_version);
+    if (output_names.empty()) {
+      output_names = model.OutputNames();
+    }
+
+    // the batcher records the busy time of the batches it runs
+    const auto start = std::chrono::steady_clock::now();
+    auto* batcher = model.Batcher();
+    if (batcher != nullptr) {
+      outputs = batcher->Run(input_names, std::move(input_values), output_names);
+    } else {
+      Run(model.Session(), run_options, input_names, input_values, output_names, outputs);
+      model.Metrics().AddBusyTime(std::chrono::steady_clock::now() - start);
+    }
+    model.Metrics().inference_duration.Observe(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  return protobufutil::Status::OK;
 }
 
 protobufutil::Status Executor::Predict(const std::string& model_name,
@@ -103,6 +212,23 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
                                        /* out */ onnxruntime::server::PredictResponse& response) {
   auto logger = env_->GetLogger(request_id_);
 
+  // repeated requests are answered from the cache without running the model
+  auto* cache = env_->GetResponseCache();
+  std::string cache_key;
+  if (cache != nullptr) {
+    try {
+      cache_key = ResponseCache::MakeKey(model_name, model_version,
+                                         env_->AcquireModel(model_name, model_version).LoadId(), request);
+    } catch (const Ort::Exception& e) {
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+
+    if (cache->Lookup(cache_key, response)) {
+      logger->debug("Response served from the cache");
+      return protobufutil::Status::OK;
+    }
+  }
+
   // Convert PredictRequest to NameMLValMap
   MemBufferArray buffer_array;
   std::vector<std::string> input_names;
@@ -112,46 +238,87 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
     return conversion_status;
   }
 
-  Ort::RunOptions run_options{};
-  run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
-  run_options.SetRunTag(request_id_.c_str());
-
   // Prepare the output names
+  // the model information is read from its own lease so it stays valid if the model is unloaded meanwhile
   std::vector<std::string> output_names;
+  std::vector<std::string> model_output_names;
+  std::vector<ServerEnvironment::OutputInfo> model_output_info;
+  bool can_preallocate = using_raw_data_;
+  try {
+    auto model = env_->AcquireModel(model_name, model_version);
+    if (!request.output_filter().empty()) {
+      output_names.reserve(request.output_filter_size());
+      for (const auto& name : request.output_filter()) {
+        output_names.push_back(name);
+      }
+    } else {
+      output_names = model.OutputNames();
+    }
+
+    // the batcher returns the slices of the outputs of the batch
+    can_preallocate = can_preallocate && model.Batcher() == nullptr;
+    if (can_preallocate) {
+      model_output_names = model.OutputNames();
+      model_output_info = model.OutputInfos();
+    }
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
 
-  if (!request.output_filter().empty()) {
-    output_names.reserve(request.output_filter_size());
-    for (const auto& name : request.output_filter()) {
-      output_names.push_back(name);
+  // The response tensors are created first so the Run can write the outputs with a static shape straight into
+  // their raw_data. The others are converted after the Run.
+  auto& response_outputs = *response.mutable_outputs();
+  for (const auto& name : output_names) {
+    if (!response_outputs.insert({name, onnx::TensorProto{}}).second) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", name);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
     }
-  } else {
-    output_names = env_->GetModelOutputNames(model_name, model_version);
   }
 
   std::vector<Ort::Value> outputs;
-  try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
-  } catch (const Ort::Exception& e) {
-    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  std::vector<bool> preallocated(output_names.size(), false);
+  if (can_preallocate) {
+    OrtMemoryInfo* memory_info = nullptr;
+    auto ort_status = Ort::GetApi().CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info);
+    if (ort_status != nullptr || memory_info == nullptr) {
+      logger->error("OrtCreateCpuMemoryInfo failed");
+      return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "OrtCreateCpuMemoryInfo() failed");
+    }
+
+    for (size_t i = 0; i < output_names.size(); ++i) {
+      outputs.emplace_back(nullptr);
+      auto it = std::find(model_output_names.begin(), model_output_names.end(), output_names[i]);
+      if (it != model_output_names.end()) {
+        const auto& info = model_output_info[it - model_output_names.begin()];
+        preallocated[i] = PreallocateOutput(info, memory_info, response_outputs[output_names[i]], outputs[i]);
+      }
+    }
+
+    Ort::GetApi().ReleaseMemoryInfo(memory_info);
+  }
+
+  auto run_status = Predict(model_name, model_version, input_names, std::move(input_values), output_names, outputs);
+  if (run_status != protobufutil::Status::OK) {
+    return run_status;
   }
 
   // Build the response
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
+    if (preallocated[i]) {
+      continue;
+    }
+
     try {
-      MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
+      MLValueToTensorProto(outputs[i], using_raw_data_, logger, response_outputs[output_names[i]]);
     } catch (const Ort::Exception& e) {
       logger = env_->GetLogger(request_id_);
       logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
       return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
     }
+  }
 
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
-
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
-    }
+  if (cache != nullptr) {
+    cache->Insert(cache_key, response);
   }
 
   return protobufutil::Status::OK;
@@ -25,6 +25,16 @@ class Executor {
                                          const onnxruntime::server::PredictRequest& request,
                                          /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Prediction method for inputs that are already deserialized, e.g. from the binary tensor payload of a request.
+  // If output_names is empty it is set to all the outputs of the model. outputs are in the order of output_names.
+  // Entries of outputs that are not null are pre-allocated and written in place, unless the model uses batching.
+  google::protobuf::util::Status Predict(const std::string& model_name,
+                                         const std::string& model_version,
+                                         const std::vector<std::string>& input_names,
+                                         std::vector<Ort::Value> input_values,
+                                         /* in, out */ std::vector<std::string>& output_names,
+                                         /* out */ std::vector<Ort::Value>& outputs);
+
  private:
   ServerEnvironment* env_;
   const std::string request_id_;
@@ -35,6 +45,13 @@ class Executor {
                                             OrtMemoryInfo* cpu_memory_info,
                                             /* out */ Ort::Value& ml_value);
 
+  // Prepares tensor_proto for an output with a static shape and creates ml_value over its raw_data, so the Run
+  // writes the output straight into the response. Returns false if the output can't be pre-allocated.
+  static bool PreallocateOutput(const ServerEnvironment::OutputInfo& info,
+                                OrtMemoryInfo* cpu_memory_info,
+                                /* out */ onnx::TensorProto& tensor_proto,
+                                /* out */ Ort::Value& ml_value);
+
   google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
                                                    /* out */ std::vector<Ort::Value>& input_values,
                                                    const onnxruntime::server::PredictRequest& request,
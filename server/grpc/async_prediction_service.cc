@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "async_prediction_service.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+
+InferenceWorkerPool::InferenceWorkerPool(int num_threads, int max_pending) : max_pending_(max_pending) {
+  for (int i = 0; i < std::max(num_threads, 1); ++i) {
+    threads_.emplace_back(&InferenceWorkerPool::WorkerLoop, this);
+  }
+}
+
+InferenceWorkerPool::~InferenceWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+bool InferenceWorkerPool::TrySchedule(std::function<void()> task) {
+  if (max_pending_ > 0) {
+    int pending = pending_.load();
+    do {
+      if (pending >= max_pending_) {
+        return false;
+      }
+    } while (!pending_.compare_exchange_weak(pending, pending + 1));
+  } else {
+    ++pending_;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  task_available_.notify_one();
+  return true;
+}
+
+void InferenceWorkerPool::WorkerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+    --pending_;
+  }
+}
+
+// A Predict call, which deletes itself once its response has been sent.
+class AsyncPredictionService::Call {
+ public:
+  Call(AsyncPredictionService& owner, ::grpc::ServerCompletionQueue* completion_queue)
+      : owner_(owner), completion_queue_(completion_queue), responder_(&context_) {
+    owner_.service_.RequestPredict(&context_, &request_, &responder_, completion_queue_, completion_queue_, this);
+  }
+
+  // Invoked on the completion queue thread when the last operation of the call has completed.
+  void Proceed(bool ok) {
+    if (state_ == State::kFinishing || !ok) {
+      // the response has been sent, or the server is shutting down before a call arrived
+      delete this;
+      return;
+    }
+
+    // accept the next call before this one is processed
+    {
+      std::lock_guard<std::mutex> lock(owner_.shutdown_mutex_);
+      if (!owner_.shutting_down_) {
+        new Call(owner_, completion_queue_);
+      }
+    }
+
+    state_ = State::kFinishing;
+    if (!owner_.workers_->TrySchedule([this]() { Process(); })) {
+      responder_.FinishWithError(::grpc::Status(::grpc::StatusCode::RESOURCE_EXHAUSTED,
+                                                "The server has too many pending requests."),
+                                 this);
+    }
+  }
+
+ private:
+  enum class State {
+    kWaitingForRequest,
+    kFinishing
+  };
+
+  // Runs the request on an inference thread.
+  void Process() {
+    auto status = owner_.implementation_.Predict(&context_, &request_, &response_);
+    if (status.ok()) {
+      responder_.Finish(response_, status, this);
+    } else {
+      responder_.FinishWithError(status, this);
+    }
+  }
+
+  AsyncPredictionService& owner_;
+  ::grpc::ServerCompletionQueue* completion_queue_;
+  ::grpc::ServerContext context_;
+  PredictRequest request_;
+  PredictResponse response_;
+  ::grpc::ServerAsyncResponseWriter<PredictResponse> responder_;
+  State state_ = State::kWaitingForRequest;
+};
+
+AsyncPredictionService::AsyncPredictionService(const std::shared_ptr<ServerEnvironment>& env,
+                                               const AsyncServiceOptions& options)
+    : environment_(env), options_(options), implementation_(env) {}
+
+AsyncPredictionService::~AsyncPredictionService() {
+  Shutdown();
+}
+
+void AsyncPredictionService::Register(::grpc::ServerBuilder& builder) {
+  builder.RegisterService(&service_);
+  for (int i = 0; i < std::max(options_.num_completion_queue_threads, 1); ++i) {
+    completion_queues_.push_back(builder.AddCompletionQueue());
+  }
+}
+
+void AsyncPredictionService::Start() {
+  workers_ = std::make_unique<InferenceWorkerPool>(options_.num_inference_threads, options_.max_pending_requests);
+  for (auto& completion_queue : completion_queues_) {
+    auto* queue = completion_queue.get();
+    new Call(*this, queue);
+    completion_queue_threads_.emplace_back([queue]() {
+      void* tag;
+      bool ok;
+      while (queue->Next(&tag, &ok)) {
+        static_cast<Call*>(tag)->Proceed(ok);
+      }
+    });
+  }
+}
+
+void AsyncPredictionService::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(shutdown_mutex_);
+    if (shutting_down_) {
+      return;
+    }
+
+    shutting_down_ = true;
+  }
+
+  // the scheduled requests still send their responses, which the completion queues deliver before they drain
+  workers_.reset();
+  for (auto& completion_queue : completion_queues_) {
+    completion_queue->Shutdown();
+  }
+
+  for (auto& thread : completion_queue_threads_) {
+    thread.join();
+  }
+
+  if (completion_queue_threads_.empty()) {
+    // never started, the queues hold no calls but still have to be drained
+    for (auto& completion_queue : completion_queues_) {
+      void* tag;
+      bool ok;
+      while (completion_queue->Next(&tag, &ok)) {
+      }
+    }
+  }
+}
+
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "prediction_service.grpc.pb.h"
+#include "prediction_service_impl.h"
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+
+struct AsyncServiceOptions {
+  // Number of completion queues, each polled by its own thread.
+  int num_completion_queue_threads = 2;
+  // Number of threads that run the requests.
+  int num_inference_threads = static_cast<int>(std::thread::hardware_concurrency());
+  // Maximum number of requests waiting for, or running on, an inference thread. Further requests are rejected with
+  // RESOURCE_EXHAUSTED. 0 doesn't limit them.
+  int max_pending_requests = 0;
+};
+
+// A fixed set of threads running tasks in the order they are scheduled.
+class InferenceWorkerPool {
+ public:
+  InferenceWorkerPool(int num_threads, int max_pending);
+  // Runs the tasks already scheduled before joining the threads.
+  ~InferenceWorkerPool();
+  InferenceWorkerPool(const InferenceWorkerPool&) = delete;
+  InferenceWorkerPool& operator=(const InferenceWorkerPool&) = delete;
+
+  // Returns false, without scheduling the task, if max_pending tasks are queued or running.
+  bool TrySchedule(std::function<void()> task);
+
+  int Pending() const { return pending_.load(); }
+
+ private:
+  void WorkerLoop();
+
+  const int max_pending_;
+  std::atomic<int> pending_{0};
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+// Serves PredictionService with the asynchronous gRPC API. The completion queue threads only accept calls and send
+// the responses, while the requests run on an InferenceWorkerPool, so the number of concurrent calls isn't bounded by
+// the number of threads. A request running on an inference thread may in turn wait in the batcher of its model for
+// other requests, so num_inference_threads should be at least max_batch_size for batches to fill up.
+class AsyncPredictionService {
+ public:
+  AsyncPredictionService(const std::shared_ptr<ServerEnvironment>& env, const AsyncServiceOptions& options);
+  ~AsyncPredictionService();
+  AsyncPredictionService(const AsyncPredictionService&) = delete;
+  AsyncPredictionService& operator=(const AsyncPredictionService&) = delete;
+
+  // Registers the service and its completion queues. Must be called before the server is built.
+  void Register(::grpc::ServerBuilder& builder);
+
+  // Starts accepting calls. Must be called after the server is built.
+  void Start();
+
+  // Finishes the calls in flight and stops the threads. Must be called after the server has been shut down.
+  void Shutdown();
+
+ private:
+  class Call;
+
+  std::shared_ptr<ServerEnvironment> environment_;
+  AsyncServiceOptions options_;
+  PredictionService::AsyncService service_;
+  // runs the requests, reusing the implementation of the synchronous service
+  PredictionServiceImpl implementation_;
+  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> completion_queues_;
+  std::vector<std::thread> completion_queue_threads_;
+  std::unique_ptr<InferenceWorkerPool> workers_;
+  // guards the requests for new calls against the shutdown of the completion queues
+  std::mutex shutdown_mutex_;
+  bool shutting_down_ = false;
+};
+
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
@@ -9,16 +9,23 @@ namespace onnx_grpc = onnxruntime::server::grpc;
 
 namespace onnxruntime {
 namespace server {
-GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port) : prediction_service_implementation_(env) {
+GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+                 const grpc::AsyncServiceOptions& options) : prediction_service_(env, options) {
   ::grpc::EnableDefaultHealthCheckService(true);
   ::grpc::channelz::experimental::InitChannelzService();
   ::grpc::reflection::InitProtoReflectionServerBuilderPlugin();
   ::grpc::ServerBuilder builder;
-  builder.RegisterService(&prediction_service_implementation_);
+  prediction_service_.Register(builder);
   builder.AddListeningPort(host + ":" + std::to_string(port), ::grpc::InsecureServerCredentials());
 
   server_ = builder.BuildAndStart();
   server_->GetHealthCheckService()->SetServingStatus(PredictionService::service_full_name(), true);
+  prediction_service_.Start();
+}
+
+GRPCApp::~GRPCApp() {
+  server_->Shutdown();
+  prediction_service_.Shutdown();
 }
 
 void GRPCApp::Run() {
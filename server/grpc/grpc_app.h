@@ -3,15 +3,16 @@
 
 #pragma once
 #include <grpcpp/grpcpp.h>
-#include "prediction_service_impl.h"
+#include "async_prediction_service.h"
 #include "environment.h"
 
 namespace onnxruntime {
 namespace server {
 class GRPCApp {
  public:
-  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port);
-  ~GRPCApp() = default;
+  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+          const grpc::AsyncServiceOptions& options = {});
+  ~GRPCApp();
   GRPCApp(const GRPCApp& other) = delete;
   GRPCApp(GRPCApp&& other) = delete;
 
@@ -21,7 +22,7 @@ class GRPCApp {
   void Run();
 
  private:
-  grpc::PredictionServiceImpl prediction_service_implementation_;
+  grpc::AsyncPredictionService prediction_service_;
   std::unique_ptr<::grpc::Server> server_;
 };
 }  // namespace server
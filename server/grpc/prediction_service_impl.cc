@@ -12,12 +12,14 @@ PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::
 
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
   auto request_id = SetRequestContext(context);
+  RequestTimer timer(environment_->GetModelMetrics("default", "1"));
   onnxruntime::server::Executor executor(environment_.get(), request_id);
   //TODO: (csteegz) Add modelspec for both paths.
   auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
+  timer.Succeeded();
   return ::grpc::Status::OK;
 }
 
@@ -0,0 +1,224 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <google/protobuf/util/json_util.h>
+
+#include "predict.pb.h"
+#include "binary_tensor_handling.h"
+#include "executor.h"
+#include "json_handling.h"
+
+namespace protobufutil = google::protobuf::util;
+
+namespace onnxruntime {
+namespace server {
+
+static const struct {
+  const char* datatype;
+  ONNXTensorElementDataType element_type;
+  size_t element_size;
+} binary_data_types[] = {
+    {"BOOL", ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL, sizeof(bool)},
+    {"UINT8", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8, sizeof(uint8_t)},
+    {"UINT16", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16, sizeof(uint16_t)},
+    {"UINT32", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32, sizeof(uint32_t)},
+    {"UINT64", ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64, sizeof(uint64_t)},
+    {"INT8", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8, sizeof(int8_t)},
+    {"INT16", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16, sizeof(int16_t)},
+    {"INT32", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32, sizeof(int32_t)},
+    {"INT64", ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64, sizeof(int64_t)},
+    {"FP16", ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16, sizeof(uint16_t)},
+    {"FP32", ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, sizeof(float)},
+    {"FP64", ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE, sizeof(double)},
+};
+
+static size_t ElementSize(ONNXTensorElementDataType element_type) {
+  for (const auto& entry : binary_data_types) {
+    if (entry.element_type == element_type) {
+      return entry.element_size;
+    }
+  }
+
+  return 0;
+}
+
+ONNXTensorElementDataType ElementTypeFromBinaryDataType(const std::string& datatype) {
+  for (const auto& entry : binary_data_types) {
+    if (datatype == entry.datatype) {
+      return entry.element_type;
+    }
+  }
+
+  return ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+}
+
+std::string BinaryDataTypeFromElementType(ONNXTensorElementDataType element_type) {
+  for (const auto& entry : binary_data_types) {
+    if (entry.element_type == element_type) {
+      return entry.datatype;
+    }
+  }
+
+  return "";
+}
+
+static protobufutil::Status InvalidPayload(const std::string& message) {
+  return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, message);
+}
+
+protobufutil::Status GetInputsFromBinaryPayload(const std::string& body, size_t header_length,
+                                                MemBufferArray& buffers,
+                                                std::vector<std::string>& input_names,
+                                                std::vector<Ort::Value>& input_values,
+                                                std::vector<std::string>& output_names) {
+  if (header_length > body.size()) {
+    return InvalidPayload("The length of the inference header exceeds the size of the payload.");
+  }
+
+  InferRequestHeader header;
+  protobufutil::JsonParseOptions options;
+  options.ignore_unknown_fields = true;
+  auto status = JsonStringToMessage(google::protobuf::StringPiece(body.data(), header_length), &header, options);
+  if (!status.ok()) {
+    return status;
+  }
+
+  try {
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    size_t offset = header_length;
+    for (const auto& input : header.inputs()) {
+      auto element_type = ElementTypeFromBinaryDataType(input.datatype());
+      if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED) {
+        return InvalidPayload("Input '" + input.name() + "' has the data type '" + input.datatype() +
+                              "' which can't be sent as binary data.");
+      }
+
+      if (!input.has_parameters()) {
+        return InvalidPayload("Input '" + input.name() + "' has no binary_data_size. Inputs in the inference " +
+                              "header must be sent as binary data.");
+      }
+
+      const size_t element_size = ElementSize(element_type);
+      size_t data_size = element_size;
+      for (auto dim : input.shape()) {
+        if (dim < 0) {
+          return InvalidPayload("Input '" + input.name() + "' has a negative dimension.");
+        }
+
+        if (dim > 0 && data_size > std::numeric_limits<size_t>::max() / static_cast<size_t>(dim)) {
+          return InvalidPayload("The size of input '" + input.name() + "' overflows.");
+        }
+
+        data_size *= static_cast<size_t>(dim);
+      }
+
+      if (input.parameters().binary_data_size() < 0 ||
+          static_cast<uint64_t>(input.parameters().binary_data_size()) != data_size) {
+        return InvalidPayload("Input '" + input.name() + "' has a binary_data_size of " +
+                              std::to_string(input.parameters().binary_data_size()) + " bytes but its shape and " +
+                              "data type require " + std::to_string(data_size) + ".");
+      }
+
+      if (body.size() - offset < data_size) {
+        return InvalidPayload("The payload ends before the data of input '" + input.name() + "'.");
+      }
+
+      // the data follows a header of arbitrary length, so it may need to be copied to be aligned
+      void* data = const_cast<char*>(body.data() + offset);
+      if (reinterpret_cast<uintptr_t>(data) % element_size != 0) {
+        auto* buffer = buffers.AllocNewBuffer(data_size);
+        memcpy(buffer, data, data_size);
+        data = buffer;
+      }
+
+      std::vector<int64_t> shape(input.shape().begin(), input.shape().end());
+      input_names.push_back(input.name());
+      input_values.push_back(Ort::Value::CreateTensor(memory_info, data, data_size, shape.data(), shape.size(),
+                                                      element_type));
+      offset += data_size;
+    }
+
+    if (offset != body.size()) {
+      return InvalidPayload("The payload has " + std::to_string(body.size() - offset) +
+                            " bytes after the data of the inputs.");
+    }
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  for (const auto& output : header.outputs()) {
+    output_names.push_back(output.name());
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status GenerateBinaryPayload(const std::string& model_name,
+                                           const std::string& model_version,
+                                           const std::vector<std::string>& output_names,
+                                           std::vector<Ort::Value>& outputs,
+                                           std::string& body,
+                                           size_t& header_length) {
+  std::vector<const char*> output_data;
+  std::vector<size_t> output_sizes;
+
+  // the header is written directly as the JSON printer of protobuf quotes int64 values
+  std::ostringstream header;
+  header << R"({"model_name":")" << escape_string(model_name)
+         << R"(","model_version":")" << escape_string(model_version) << R"(","outputs":[)";
+
+  try {
+    for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
+      if (!outputs[i].IsTensor()) {
+        return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED,
+                                    "Output '" + output_names[i] + "' is not a tensor.");
+      }
+
+      auto type_and_shape = outputs[i].GetTensorTypeAndShapeInfo();
+      auto datatype = BinaryDataTypeFromElementType(type_and_shape.GetElementType());
+      if (datatype.empty()) {
+        return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED,
+                                    "Output '" + output_names[i] + "' has a data type which can't be sent as binary data.");
+      }
+
+      const size_t data_size = type_and_shape.GetElementCount() * ElementSize(type_and_shape.GetElementType());
+      output_data.push_back(outputs[i].GetTensorMutableData<char>());
+      output_sizes.push_back(data_size);
+
+      header << (i == 0 ? "" : ",") << R"({"name":")" << escape_string(output_names[i])
+             << R"(","datatype":")" << datatype << R"(","shape":[)";
+      const auto shape = type_and_shape.GetShape();
+      for (size_t j = 0; j < shape.size(); ++j) {
+        header << (j == 0 ? "" : ",") << shape[j];
+      }
+      header << R"(],"parameters":{"binary_data_size":)" << data_size << "}}";
+    }
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  header << "]}";
+  body = header.str();
+  header_length = body.size();
+
+  size_t body_size = header_length;
+  for (auto size : output_sizes) {
+    body_size += size;
+  }
+
+  body.reserve(body_size);
+  for (size_t i = 0; i < output_data.size(); ++i) {
+    body.append(output_data[i], output_sizes[i]);
+  }
+
+  return protobufutil::Status::OK;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "onnxruntime_cxx_api.h"
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+class MemBufferArray;
+
+// Maps a KServe v2 data type, e.g. FP32, to the tensor element type. Returns UNDEFINED for unknown or
+// non-numeric types, which can't be sent as binary data.
+ONNXTensorElementDataType ElementTypeFromBinaryDataType(const std::string& datatype);
+std::string BinaryDataTypeFromElementType(ONNXTensorElementDataType element_type);
+
+// A binary tensor payload, as defined by the binary tensor extension of the KServe v2 inference protocol, is a JSON
+// header listing the tensors followed by their data in little-endian byte order. The length of the header is given
+// in the BINARY_HEADER_LENGTH_HEADER field.
+
+// Deserializes a binary tensor payload whose JSON header is header_length bytes long.
+// The input values are created over the payload without copying it, so body must outlive them. Data that isn't
+// aligned for its element type is copied into buffers.
+// output_names is set to the names of the requested outputs, or left empty to return all outputs.
+google::protobuf::util::Status GetInputsFromBinaryPayload(const std::string& body, size_t header_length,
+                                                          MemBufferArray& buffers,
+                                                          /* out */ std::vector<std::string>& input_names,
+                                                          /* out */ std::vector<Ort::Value>& input_values,
+                                                          /* out */ std::vector<std::string>& output_names);
+
+// Serializes the outputs as a binary tensor payload. header_length is set to the length of its JSON header.
+google::protobuf::util::Status GenerateBinaryPayload(const std::string& model_name,
+                                                     const std::string& model_version,
+                                                     const std::vector<std::string>& output_names,
+                                                     std::vector<Ort::Value>& outputs,
+                                                     /* out */ std::string& body,
+                                                     /* out */ size_t& header_length);
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -1,10 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <sstream>
+
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
 #include "http_server.h"
+#include "binary_tensor_handling.h"
 #include "json_handling.h"
 #include "executor.h"
 #include "util.h"
@@ -31,6 +34,9 @@ namespace protobufutil = google::protobuf::util;
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type,
                                 /* out */ PredictRequest& predictRequest, /* out */ http::status& error_code, /* out */ std::string& error_message);
 
+static void PredictBinaryTensors(const std::string& name, const std::string& version,
+                                 /* in, out */ HttpContext& context, const std::shared_ptr<ServerEnvironment>& env);
+
 void Predict(const std::string& name,
              const std::string& version,
              const std::string& action,
@@ -41,6 +47,7 @@ void Predict(const std::string& name,
 
   auto effective_name = name.empty() ? "default" : name;
   auto effective_version = version.empty() ? "1" : version;
+  RequestTimer timer(env->GetModelMetrics(effective_name, effective_version));
 
   if (!context.client_request_id.empty()) {
     logger->info("{}: [{}]", util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
@@ -53,8 +60,16 @@ void Predict(const std::string& name,
     GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
   }
 
+  // Binary tensors are deserialized straight into the input values
+  if (request_type == SupportedContentType::BinaryTensor) {
+    PredictBinaryTensors(effective_name, effective_version, context, env);
+    if (context.response.result() == http::status::ok) {
+      timer.Succeeded();
+    }
+    return;
+  }
+
   // Deserialize the payload
-  auto body = context.request.body();
   PredictRequest predict_request{};
   http::status error_code;
   std::string error_message;
@@ -98,10 +113,157 @@ void Predict(const std::string& name,
   }
   context.response.body() = response_body;
   context.response.result(http::status::ok);
+  timer.Succeeded();
 };
 
+void GetBatchingStats(const std::string& name,
+                      const std::string& version,
+                      /* in, out */ HttpContext& context,
+                      const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+
+  auto effective_name = name.empty() ? "default" : name;
+  auto effective_version = version.empty() ? "1" : version;
+
+  BatchingStats stats;
+  try {
+    if (!env->GetBatchingStats(effective_name, effective_version, stats)) {
+      GenerateErrorResponse(logger, http::status::not_found, "Batching is not enabled for the model", context);
+      return;
+    }
+  } catch (const Ort::Exception& e) {
+    GenerateErrorResponse(logger, http::status::not_found, e.what(), context);
+    return;
+  }
+
+  std::ostringstream body;
+  body << "{\"queueDepth\":" << stats.queue_depth
+       << ",\"maxQueueDepth\":" << stats.max_queue_depth
+       << ",\"batchSizeHistogram\":{";
+  bool first = true;
+  for (const auto& bucket : stats.batch_size_histogram) {
+    body << (first ? "" : ",") << "\"" << bucket.first << "\":" << bucket.second;
+    first = false;
+  }
+  body << "}}";
+
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/json");
+  context.response.body() = body.str();
+  context.response.result(http::status::ok);
+}
+
+void GetMetrics(HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  std::ostringstream body;
+  env->WriteMetrics(body);
+
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  context.response.set(http::field::content_type, "text/plain; version=0.0.4");
+  context.response.body() = body.str();
+  context.response.result(http::status::ok);
+}
+
+void GetResponseCacheStats(HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+
+  auto* cache = env->GetResponseCache();
+  if (cache == nullptr) {
+    GenerateErrorResponse(logger, http::status::not_found, "The response cache is not enabled", context);
+    return;
+  }
+
+  auto stats = cache->GetStats();
+  std::ostringstream body;
+  body << "{\"hits\":" << stats.hits
+       << ",\"misses\":" << stats.misses
+       << ",\"expirations\":" << stats.expirations
+       << ",\"evictions\":" << stats.evictions
+       << ",\"entries\":" << stats.entries
+       << ",\"bytes\":" << stats.bytes << "}";
+
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/json");
+  context.response.body() = body.str();
+  context.response.result(http::status::ok);
+}
+
+static void ModelManagementResponse(const std::string& action, const std::string& name, const std::string& version,
+                                    HttpContext& context) {
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/json");
+  context.response.body() = R"({"model_name":")" + escape_string(name) + R"(","model_version":")" +
+                            escape_string(version) + R"(","status":")" + action + R"("})";
+  context.response.result(http::status::ok);
+}
+
+void LoadModel(const std::string& name,
+               const std::string& version,
+               HttpContext& context,
+               const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+
+  LoadModelRequest load_request{};
+  protobufutil::JsonParseOptions options;
+  options.ignore_unknown_fields = true;
+  auto status = JsonStringToMessage(context.request.body(), &load_request, options);
+  if (!status.ok()) {
+    GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+    return;
+  }
+
+  if (load_request.model_path().empty()) {
+    GenerateErrorResponse(logger, http::status::bad_request, "The request has no model_path", context);
+    return;
+  }
+
+  ModelConfig model;
+  model.name = name;
+  model.version = version;
+  model.path = load_request.model_path();
+  model.weight = load_request.weight() == 0 ? 1 : load_request.weight();
+  model.num_sessions = load_request.num_sessions() == 0 ? 1 : load_request.num_sessions();
+
+  try {
+    env->LoadModels({model});
+  } catch (const Ort::Exception& e) {
+    auto code = e.GetOrtErrorCode() == ORT_INVALID_ARGUMENT ? http::status::bad_request
+                                                             : http::status::internal_server_error;
+    GenerateErrorResponse(logger, code, e.what(), context);
+    return;
+  }
+
+  logger->info("Loaded model {} version {} from {}", name, version, model.path);
+  ModelManagementResponse("loaded", name, version, context);
+}
+
+void UnloadModel(const std::string& name,
+                 const std::string& version,
+                 HttpContext& context,
+                 const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+
+  try {
+    env->UnloadModel(name, version);
+  } catch (const Ort::Exception& e) {
+    GenerateErrorResponse(logger, http::status::not_found, e.what(), context);
+    return;
+  }
+
+  logger->info("Unloaded model {} version {}", name, version);
+  ModelManagementResponse("unloaded", name, version, context);
+}
+
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
-  auto body = context.request.body();
+  const auto& body = context.request.body();
   protobufutil::Status status;
   switch (request_type) {
     case SupportedContentType::Json: {
@@ -132,5 +294,55 @@ static bool ParseRequestPayload(const HttpContext& context, SupportedContentType
   return true;
 }
 
+static void PredictBinaryTensors(const std::string& name, const std::string& version,
+                                 HttpContext& context, const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+
+  size_t header_length = 0;
+  try {
+    header_length = std::stoull(context.request[BINARY_HEADER_LENGTH_HEADER].to_string());
+  } catch (const std::exception&) {
+    GenerateErrorResponse(logger, http::status::bad_request, "Invalid '" + BINARY_HEADER_LENGTH_HEADER + "' header field in the request", context);
+    return;
+  }
+
+  // the input values use the request body, which outlives the Run
+  MemBufferArray buffers;
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  std::vector<std::string> output_names;
+  auto status = GetInputsFromBinaryPayload(context.request.body(), header_length, buffers, input_names, input_values, output_names);
+  if (!status.ok()) {
+    GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+    return;
+  }
+
+  Executor executor(env.get(), context.request_id);
+  std::vector<Ort::Value> outputs;
+  status = executor.Predict(name, version, input_names, std::move(input_values), output_names, outputs);
+  if (!status.ok()) {
+    GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+    return;
+  }
+
+  std::string response_body{};
+  size_t response_header_length = 0;
+  status = GenerateBinaryPayload(name, version, output_names, outputs, response_body, response_header_length);
+  if (!status.ok()) {
+    GenerateErrorResponse(logger, http::status::internal_server_error, status.error_message(), context);
+    return;
+  }
+
+  // Build HTTP response
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/octet-stream");
+  context.response.set(BINARY_HEADER_LENGTH_HEADER, std::to_string(response_header_length));
+  context.response.body() = std::move(response_body);
+  context.response.result(http::status::ok);
+}
+
 }  // namespace server
 }  // namespace onnxruntime
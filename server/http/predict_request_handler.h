@@ -19,5 +19,31 @@ void Predict(const std::string& name,
              /* in, out */ HttpContext& context,
              const std::shared_ptr<ServerEnvironment>& env);
 
+// Writes the dynamic batching statistics of the model as JSON
+void GetBatchingStats(const std::string& name,
+                      const std::string& version,
+                      /* in, out */ HttpContext& context,
+                      const std::shared_ptr<ServerEnvironment>& env);
+
+// Writes the metrics of the server in the Prometheus text format
+void GetMetrics(/* in, out */ HttpContext& context,
+                const std::shared_ptr<ServerEnvironment>& env);
+
+// Writes the hit and miss counts and the size of the response cache as JSON
+void GetResponseCacheStats(/* in, out */ HttpContext& context,
+                           const std::shared_ptr<ServerEnvironment>& env);
+
+// Loads a version of a model from the path in the JSON LoadModelRequest body, without restarting the server
+void LoadModel(const std::string& name,
+               const std::string& version,
+               /* in, out */ HttpContext& context,
+               const std::shared_ptr<ServerEnvironment>& env);
+
+// Unloads a version of a model. The requests in flight for it complete first
+void UnloadModel(const std::string& name,
+                 const std::string& version,
+                 /* in, out */ HttpContext& context,
+                 const std::shared_ptr<ServerEnvironment>& env);
+
 }  // namespace server
 }  // namespace onnxruntime
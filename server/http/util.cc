@@ -13,6 +13,8 @@ namespace protobufutil = google::protobuf::util;
 namespace onnxruntime {
 namespace server {
 
+const std::string BINARY_HEADER_LENGTH_HEADER = "Inference-Header-Content-Length";
+
 static std::unordered_set<std::string> protobuf_mime_types{
     "application/octet-stream",
     "application/vnd.google.protobuf",
@@ -59,6 +61,9 @@ SupportedContentType GetRequestContentType(const HttpContext& context) {
     if (context.request["Content-Type"] == "application/json") {
       return SupportedContentType::Json;
     } else if (protobuf_mime_types.find(context.request["Content-Type"].to_string()) != protobuf_mime_types.end()) {
+      if (context.request.find(BINARY_HEADER_LENGTH_HEADER) != context.request.end()) {
+        return SupportedContentType::BinaryTensor;
+      }
       return SupportedContentType::PbByteArray;
     }
   }
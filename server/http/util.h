@@ -17,14 +17,19 @@ namespace beast = boost::beast;  // from <boost/beast.hpp>
 enum class SupportedContentType : int {
   Unknown,
   Json,
-  PbByteArray
+  PbByteArray,
+  BinaryTensor
 };
 
+// Header field holding the length of the JSON header of a binary tensor payload.
+extern const std::string BINARY_HEADER_LENGTH_HEADER;
+
 // Mapping protobuf status to http status
 boost::beast::http::status GetHttpStatusCode(const google::protobuf::util::Status& status);
 
 // "Content-Type" header field in request is MUST-HAVE.
 // Currently we only support two types of input content type: application/json and application/octet-stream
+// An octet-stream with the BINARY_HEADER_LENGTH_HEADER field is a binary tensor payload rather than a protobuf.
 SupportedContentType GetRequestContentType(const HttpContext& context);
 
 // "Accept" header field in request is OPTIONAL.
@@ -60,12 +60,36 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}, ", config.model_path);
-  logger->info("Model name: {}", config.model_name);
-  logger->info("Model version: {}", config.model_version);
+  for (const auto& model : config.models) {
+    logger->info("Model path: {}, name: {}, version: {}, weight: {}, sessions: {}", model.path, model.name,
+                 model.version, model.weight, model.num_sessions);
+  }
+
+  server::BatchingOptions batching_options{};
+  batching_options.max_batch_size = static_cast<size_t>(config.max_batch_size);
+  batching_options.batch_timeout = std::chrono::microseconds(config.batch_timeout_us);
+  env->SetBatchingOptions(batching_options);
+  if (batching_options.max_batch_size > 1) {
+    logger->info("Batching up to {} rows with a timeout of {}us", config.max_batch_size, config.batch_timeout_us);
+  }
+
+  server::ResponseCacheOptions cache_options{};
+  cache_options.max_bytes = static_cast<size_t>(config.response_cache_mb) * 1024 * 1024;
+  cache_options.ttl = std::chrono::milliseconds(config.response_cache_ttl_ms);
+  env->SetResponseCacheOptions(cache_options);
+  if (cache_options.max_bytes > 0) {
+    logger->info("Caching up to {}MB of responses with a TTL of {}ms", config.response_cache_mb, config.response_cache_ttl_ms);
+  }
+
+  env->SetCoreBudget(config.num_cores, config.pin_cores);
+  if (config.num_cores > 0) {
+    logger->info("Splitting {} cores between the models{}", config.num_cores,
+                 config.pin_cores ? ", with pinned threads" : "");
+  }
 
   try {
-    env->InitializeModel(config.model_path, config.model_name, config.model_version);
+    // loaded together so the cores are split by the weights of all the models
+    env->LoadModels(config.models);
     logger->debug("Initialize Model Successfully!");
   } catch (const Ort::Exception& ex) {
     logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
@@ -76,7 +100,11 @@ int main(int argc, char* argv[]) {
   auto const grpc_address = config.address;
   auto const grpc_port = config.grpc_port;
 
-  server::GRPCApp grpc_app{env, grpc_address, grpc_port};
+  server::grpc::AsyncServiceOptions grpc_options;
+  grpc_options.num_completion_queue_threads = config.num_grpc_threads;
+  grpc_options.num_inference_threads = config.num_inference_threads;
+  grpc_options.max_pending_requests = config.max_pending_requests;
+  server::GRPCApp grpc_app{env, grpc_address, grpc_port, grpc_options};
 
   logger->info("GRPC Listening at: {}:{}", grpc_address, grpc_port);
 
@@ -118,7 +146,38 @@ int main(int argc, char* argv[]) {
       }
   );
 
-  app.Bind(boost_address, config.http_port)
+  app.RegisterGet(
+      R"(/v1/models/([^/:]+)(?:/versions/(\d+))?/(batching_stats))",
+      [&env](const auto& name, const auto& version, const auto& /*action*/, auto& context) -> void {
+        server::GetBatchingStats(name, version, context, env);
+      });
+
+  app.RegisterGet(
+      R"(/()()(metrics))",
+      [&env](const auto& /*name*/, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::GetMetrics(context, env);
+      });
+
+  app.RegisterGet(
+      R"(/v1/()()(response_cache_stats))",
+      [&env](const auto& /*name*/, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::GetResponseCacheStats(context, env);
+      });
+
+  if (config.enable_model_management) {
+    app.RegisterPost(
+        R"(/v1/models/([^/:]+)/versions/(\d+):(load|unload))",
+        [&env](const auto& name, const auto& version, const auto& action, auto& context) -> void {
+          if (action == "load") {
+            server::LoadModel(name, version, context, env);
+          } else {
+            server::UnloadModel(name, version, context, env);
+          }
+        });
+    logger->info("Model management is enabled");
+  }
+
+    app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
 
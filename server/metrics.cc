@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+
+std::vector<double> LatencyBuckets() {
+  return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+}
+
+std::vector<double> BatchSizeBuckets() {
+  return {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+}
+
+std::string Labels(const std::pair<std::string, std::string>& model) {
+  return "model=\"" + EscapeLabelValue(model.first) + "\",version=\"" + EscapeLabelValue(model.second) + "\"";
+}
+
+}  // namespace
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)), counts_(bounds_.size() + 1, 0) {}
+
+void Histogram::Observe(double value) {
+  const size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++counts_[bucket];
+  ++count_;
+  sum_ += value;
+}
+
+void Histogram::Write(std::ostream& out, const std::string& name, const std::string& labels) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < bounds_.size(); ++i) {
+    cumulative += counts_[i];
+    out << name << "_bucket{" << labels << ",le=\"" << bounds_[i] << "\"} " << cumulative << "\n";
+  }
+  out << name << "_bucket{" << labels << ",le=\"+Inf\"} " << count_ << "\n"
+      << name << "_sum{" << labels << "} " << std::to_string(sum_) << "\n"
+      << name << "_count{" << labels << "} " << count_ << "\n";
+}
+
+ModelMetrics::ModelMetrics()
+    : request_duration(LatencyBuckets()),
+      inference_duration(LatencyBuckets()),
+      batch_size(BatchSizeBuckets()),
+      queue_wait(LatencyBuckets()) {}
+
+RequestTimer::RequestTimer(ModelMetrics* metrics) : metrics_(metrics), start_(std::chrono::steady_clock::now()) {
+  if (metrics_ != nullptr) {
+    ++metrics_->requests;
+  }
+}
+
+RequestTimer::~RequestTimer() {
+  if (metrics_ == nullptr) {
+    return;
+  }
+
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_;
+  metrics_->request_duration.Observe(duration.count());
+  if (!succeeded_) {
+    ++metrics_->errors;
+  }
+}
+
+std::string EscapeLabelValue(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped.push_back('\\');
+      escaped.push_back(c);
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped.push_back(c);
+    }
+  }
+
+  return escaped;
+}
+
+ModelMetrics& ServerMetrics::AddModel(const std::string& model_name, const std::string& model_version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto identifier = std::make_pair(model_name, model_version);
+  for (auto& model : models_) {
+    if (model.first == identifier) {
+      return *model.second;
+    }
+  }
+
+  models_.emplace_back(identifier, std::make_unique<ModelMetrics>());
+  return *models_.back().second;
+}
+
+ModelMetrics* ServerMetrics::GetModel(const std::string& model_name, const std::string& model_version) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& model : models_) {
+    if (model.first.first == model_name && model.first.second == model_version) {
+      return model.second.get();
+    }
+  }
+
+  return nullptr;
+}
+
+void ServerMetrics::Write(std::ostream& out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // the samples of a metric are written together, after its HELP and TYPE lines
+  auto write_counter = [this, &out](const char* name, const char* help,
+                                    std::string (*value)(const ModelMetrics&)) {
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " counter\n";
+    for (const auto& model : models_) {
+      out << name << "{" << Labels(model.first) << "} " << value(*model.second) << "\n";
+    }
+  };
+
+  auto write_histogram = [this, &out](const char* name, const char* help,
+                                      const Histogram& (*histogram)(const ModelMetrics&)) {
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " histogram\n";
+    for (const auto& model : models_) {
+      histogram(*model.second).Write(out, name, Labels(model.first));
+    }
+  };
+
+  write_counter("ort_server_requests_total", "Predict requests received for the model.",
+                [](const ModelMetrics& m) { return std::to_string(m.requests.load()); });
+  write_counter("ort_server_request_errors_total", "Predict requests for the model that failed.",
+                [](const ModelMetrics& m) { return std::to_string(m.errors.load()); });
+  write_counter("ort_server_session_busy_seconds_total", "Time the sessions of the model spent running.",
+                [](const ModelMetrics& m) { return std::to_string(m.busy_microseconds.load() / 1e6); });
+  write_histogram("ort_server_request_duration_seconds", "Time from the arrival of a request to its response.",
+                  [](const ModelMetrics& m) -> const Histogram& { return m.request_duration; });
+  write_histogram("ort_server_inference_duration_seconds", "Time a request spent running, including its batch queue.",
+                  [](const ModelMetrics& m) -> const Histogram& { return m.inference_duration; });
+  write_histogram("ort_server_batch_size", "Rows of the batches that were run, 0 for requests that can't be batched.",
+                  [](const ModelMetrics& m) -> const Histogram& { return m.batch_size; });
+  write_histogram("ort_server_queue_wait_seconds", "Time a request waited for its batch to start.",
+                  [](const ModelMetrics& m) -> const Histogram& { return m.queue_wait; });
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+namespace server {
+
+// Histogram with fixed bucket upper bounds, written in the Prometheus text format.
+class Histogram {
+ public:
+  explicit Histogram(std::vector<double> bounds);
+
+  void Observe(double value);
+
+  // Writes the _bucket, _sum and _count samples. labels is the comma separated label list, e.g. model="m".
+  void Write(std::ostream& out, const std::string& name, const std::string& labels) const;
+
+ private:
+  const std::vector<double> bounds_;
+  mutable std::mutex mutex_;
+  // one count per bound, the last one for +Inf
+  std::vector<uint64_t> counts_;
+  uint64_t count_ = 0;
+  double sum_ = 0;
+};
+
+// Telemetry of a model, kept across unloads and reloads of the model so the counters stay monotonic.
+struct ModelMetrics {
+  ModelMetrics();
+
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> errors{0};
+  // From the arrival of a request to its response, in seconds.
+  Histogram request_duration;
+  // Time a request spent in Run, including the wait for its batch when batching is enabled, in seconds.
+  Histogram inference_duration;
+  // Rows of the batches that were run, 0 for requests that can't be batched.
+  Histogram batch_size;
+  // Time a request waited in the queue of the batcher, in seconds.
+  Histogram queue_wait;
+  // Time the sessions of the model spent running, for utilization.
+  std::atomic<uint64_t> busy_microseconds{0};
+
+  void AddBusyTime(std::chrono::steady_clock::duration duration) {
+    busy_microseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  }
+};
+
+// Counts a request and records its duration when it goes out of scope. It is counted as an error unless Succeeded
+// was called. Does nothing if metrics is null, e.g. for a model that isn't loaded.
+class RequestTimer {
+ public:
+  explicit RequestTimer(ModelMetrics* metrics);
+  ~RequestTimer();
+  RequestTimer(const RequestTimer&) = delete;
+  RequestTimer& operator=(const RequestTimer&) = delete;
+
+  void Succeeded() { succeeded_ = true; }
+
+ private:
+  ModelMetrics* metrics_;
+  const std::chrono::steady_clock::time_point start_;
+  bool succeeded_ = false;
+};
+
+// Escapes a Prometheus label value.
+std::string EscapeLabelValue(const std::string& value);
+
+// The metrics of the models hosted by the server. Models are added when they are first loaded, so clients can't add
+// labels by sending requests for arbitrary model names.
+class ServerMetrics {
+ public:
+  // Returns the metrics of the model, adding them if needed. The reference stays valid for the life of the server.
+  ModelMetrics& AddModel(const std::string& model_name, const std::string& model_version);
+
+  // Returns nullptr if the model was never loaded.
+  ModelMetrics* GetModel(const std::string& model_name, const std::string& model_version) const;
+
+  // Writes the counters and histograms of the models in the Prometheus text format.
+  void Write(std::ostream& out) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<std::pair<std::pair<std::string, std::string>, std::unique_ptr<ModelMetrics>>> models_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
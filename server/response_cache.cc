@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "core/framework/murmurhash3.h"
+#include "response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+
+uint32_t HashSeed() {
+  static const uint32_t seed = std::random_device{}();
+  return seed;
+}
+
+// Appends the 128-bit hash of the bytes to digests.
+void HashBytes(const void* data, size_t size, std::vector<uint32_t>& digests) {
+  uint32_t hash[4];
+  MurmurHash3::x86_128(data, static_cast<int>(size), HashSeed(), hash);
+  digests.insert(digests.end(), hash, hash + 4);
+}
+
+}  // namespace
+
+ResponseCache::ResponseCache(const ResponseCacheOptions& options) : options_(options) {}
+
+std::string ResponseCache::MakeKey(const std::string& model_name, const std::string& model_version, uint64_t load_id,
+                                   const PredictRequest& request) {
+  // the iteration order of protobuf maps is unspecified
+  std::vector<const std::string*> input_names;
+  input_names.reserve(request.inputs_size());
+  for (const auto& input : request.inputs()) {
+    input_names.push_back(&input.first);
+  }
+  std::sort(input_names.begin(), input_names.end(),
+            [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+
+  std::vector<uint32_t> digests;
+  std::string serialized;
+  for (const auto* name : input_names) {
+    const auto& tensor = request.inputs().at(*name);
+    HashBytes(name->data(), name->size(), digests);
+    if (tensor.has_raw_data()) {
+      // the raw data is hashed in place, the other fields are serialized
+      std::vector<int64_t> header(tensor.dims().begin(), tensor.dims().end());
+      header.push_back(tensor.data_type());
+      HashBytes(header.data(), header.size() * sizeof(int64_t), digests);
+      HashBytes(tensor.raw_data().data(), tensor.raw_data().size(), digests);
+    } else {
+      tensor.SerializeToString(&serialized);
+      HashBytes(serialized.data(), serialized.size(), digests);
+    }
+  }
+
+  uint32_t hash[4];
+  MurmurHash3::x86_128(digests.data(), static_cast<int>(digests.size() * sizeof(uint32_t)), HashSeed(), hash);
+
+  std::string key = model_name;
+  key.push_back('\0');
+  key += model_version;
+  key.push_back('\0');
+  key += std::to_string(load_id);
+  key.push_back('\0');
+  key.append(reinterpret_cast<const char*>(hash), sizeof(hash));
+
+  // the response is the same whatever the order of the output filter
+  std::vector<std::string> output_names(request.output_filter().begin(), request.output_filter().end());
+  std::sort(output_names.begin(), output_names.end());
+  for (const auto& name : output_names) {
+    key.push_back('\0');
+    key += name;
+  }
+
+  return key;
+}
+
+void ResponseCache::Erase(std::list<Entry>::iterator entry) {
+  stats_.bytes -= entry->bytes;
+  index_.erase(entry->key);
+  entries_.erase(entry);
+}
+
+bool ResponseCache::Lookup(const std::string& key, PredictResponse& response) {
+  std::shared_ptr<const PredictResponse> cached;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return false;
+    }
+
+    auto entry = it->second;
+    if (options_.ttl.count() > 0 && std::chrono::steady_clock::now() >= entry->expiry) {
+      ++stats_.expirations;
+      ++stats_.misses;
+      Erase(entry);
+      return false;
+    }
+
+    entries_.splice(entries_.begin(), entries_, entry);
+    cached = entry->response;
+    ++stats_.hits;
+  }
+
+  // copied outside of the lock, the entry may be evicted meanwhile
+  response = *cached;
+  return true;
+}
+
+void ResponseCache::Insert(const std::string& key, const PredictResponse& response) {
+  const size_t bytes = key.size() + response.ByteSizeLong();
+  if (bytes > options_.max_bytes) {
+    return;
+  }
+
+  auto cached = std::make_shared<const PredictResponse>(response);
+  auto expiry = std::chrono::steady_clock::now() + options_.ttl;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    Erase(it->second);
+  }
+
+  while (stats_.bytes + bytes > options_.max_bytes) {
+    Erase(std::prev(entries_.end()));
+    ++stats_.evictions;
+  }
+
+  entries_.push_front(Entry{key, std::move(cached), bytes, expiry});
+  index_.emplace(key, entries_.begin());
+  stats_.bytes += bytes;
+}
+
+ResponseCacheStats ResponseCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ResponseCacheStats stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct ResponseCacheOptions {
+  // Maximum total size in bytes of the cached responses. 0 disables the cache.
+  size_t max_bytes = 0;
+  // How long a response is served from the cache after it was computed. 0 keeps it until it is evicted.
+  std::chrono::milliseconds ttl{0};
+};
+
+struct ResponseCacheStats {
+  uint64_t hits = 0;
+  // Includes the lookups of expired responses.
+  uint64_t misses = 0;
+  uint64_t expirations = 0;
+  uint64_t evictions = 0;
+  size_t entries = 0;
+  size_t bytes = 0;
+};
+
+// LRU cache of the responses to PredictRequests, for workloads where many requests are exact repeats.
+// Shared by the models of the server.
+class ResponseCache {
+ public:
+  explicit ResponseCache(const ResponseCacheOptions& options);
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Key of a request: the model, its load_id so responses of a reloaded model aren't served, the requested outputs
+  // and a 128-bit MurmurHash3 of the inputs. The hashes use a random seed per process.
+  static std::string MakeKey(const std::string& model_name, const std::string& model_version, uint64_t load_id,
+                             const PredictRequest& request);
+
+  // Returns false if there is no response for the key or it has expired.
+  bool Lookup(const std::string& key, /* out */ PredictResponse& response);
+
+  // Responses larger than the cache are not inserted.
+  void Insert(const std::string& key, const PredictResponse& response);
+
+  ResponseCacheStats GetStats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const PredictResponse> response;
+    size_t bytes;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  void Erase(std::list<Entry>::iterator entry);
+
+  const ResponseCacheOptions options_;
+
+  mutable std::mutex mutex_;
+  // most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  ResponseCacheStats stats_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -5,6 +5,8 @@
 
 #include <memory>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <sstream>
 #include "onnx-ml.pb.h"
@@ -378,6 +380,31 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+bool TensorProtoRawDataToMLValue(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& memory_info,
+                                 Ort::Value& value) {
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() ||
+      tensor_proto.data_location() == onnx::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == onnx::TensorProto_DataType::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  size_t expected_size;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &expected_size);
+
+  // a mismatch is reported by TensorProtoToMLValue
+  const auto& raw_data = tensor_proto.raw_data();
+  if (expected_size == 0 || raw_data.size() != expected_size ||
+      reinterpret_cast<uintptr_t>(raw_data.data()) % alignof(std::max_align_t) != 0) {
+    return false;
+  }
+
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  value = Ort::Value::CreateTensor(&memory_info, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(),
+                                   GetTensorElementType(tensor_proto));
+  return true;
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
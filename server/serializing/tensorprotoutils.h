@@ -27,6 +27,14 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * create a value over the raw_data of a TensorProto without copying it, so the TensorProto must outlive the value.
+ * Returns false if the data has to be converted by TensorProtoToMLValue, i.e. it isn't in raw_data, isn't in the
+ * byte order of the host or isn't aligned.
+ */
+bool TensorProtoRawDataToMLValue(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info,
+                                 /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
@@ -5,10 +5,13 @@
 
 #include <thread>
 #include <fstream>
+#include <sstream>
 #include <unordered_map>
+#include <vector>
 
 #include "boost/program_options.hpp"
 #include "onnxruntime_cxx_api.h"
+#include "environment.h"
 
 namespace onnxruntime {
 namespace server {
@@ -45,18 +48,43 @@ class ServerConfiguration {
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int num_grpc_threads = 2;
+  int num_inference_threads = std::thread::hardware_concurrency();
+  int max_pending_requests = 0;
+  int max_batch_size = 1;
+  int batch_timeout_us = 1000;
+  int num_sessions = 1;
+  int num_cores = 0;
+  bool pin_cores = false;
+  bool enable_model_management = false;
+  int response_cache_mb = 0;
+  int response_cache_ttl_ms = 0;
   OrtLoggingLevel logging_level{};
+  // The models to load at startup: the one of model_path followed by the ones of --model.
+  std::vector<ModelConfig> models;
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model");
     desc.add_options()("model_name", po::value(&model_name)->default_value(model_name), "ONNX model name");
     desc.add_options()("model_version", po::value(&model_version)->default_value(model_version), "ONNX model version");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("num_grpc_threads", po::value(&num_grpc_threads)->default_value(num_grpc_threads), "Number of threads that accept GRPC calls and send their responses");
+    desc.add_options()("num_inference_threads", po::value(&num_inference_threads)->default_value(num_inference_threads), "Number of threads that run GRPC requests");
+    desc.add_options()("max_pending_requests", po::value(&max_pending_requests)->default_value(max_pending_requests), "Maximum number of GRPC requests waiting for or running on an inference thread. Further requests fail with RESOURCE_EXHAUSTED. 0 doesn't limit them");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Maximum number of rows to batch concurrent requests into. 1 disables batching");
+    desc.add_options()("batch_timeout_us", po::value(&batch_timeout_us)->default_value(batch_timeout_us), "Maximum time in microseconds a request waits for other requests to batch with");
+    desc.add_options()("num_sessions", po::value(&num_sessions)->default_value(num_sessions), "Number of sessions that run requests for the model of model_path concurrently");
+    desc.add_options()("model", po::value(&model_specs)->composing(), "Additional model to host, as name=<name>,version=<version>,path=<path>[,weight=<weight>][,sessions=<sessions>]. Can be repeated");
+    desc.add_options()("num_cores", po::value(&num_cores)->default_value(num_cores), "Number of cores split between the models in proportion to their weight, e.g. the number of physical cores. 0 leaves the number of threads of every session to ONNX Runtime");
+    desc.add_options()("pin_cores", po::bool_switch(&pin_cores), "Pin the intra-op threads of the sessions to the cores of their model");
+    desc.add_options()("enable_model_management", po::bool_switch(&enable_model_management), "Enable the HTTP routes that load and unload models");
+    desc.add_options()("response_cache_mb", po::value(&response_cache_mb)->default_value(response_cache_mb), "Size in MB of the cache of the responses to repeated requests. 0 disables the cache");
+    desc.add_options()("response_cache_ttl_ms", po::value(&response_cache_ttl_ms)->default_value(response_cache_ttl_ms), "Time in milliseconds a response is served from the cache. 0 keeps responses until they are evicted");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -93,6 +121,7 @@ class ServerConfiguration {
   po::options_description desc{"Allowed options"};
   po::variables_map vm{};
   std::string log_level_str = "info";
+  std::vector<std::string> model_specs;
 
   // Print help and return if there is a bad value
   Result ValidateOptions() {
@@ -103,12 +132,101 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
-    } else if (!file_exists(model_path)) {
+    } else if (num_grpc_threads <= 0 || num_inference_threads <= 0) {
+      PrintHelp(std::cerr, "num_grpc_threads and num_inference_threads must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_pending_requests < 0) {
+      PrintHelp(std::cerr, "max_pending_requests must not be negative");
+      return Result::ExitFailure;
+    } else if (max_batch_size <= 0) {
+      PrintHelp(std::cerr, "max_batch_size must be greater than 0");
+      return Result::ExitFailure;
+    } else if (batch_timeout_us < 0) {
+      PrintHelp(std::cerr, "batch_timeout_us must not be negative");
+      return Result::ExitFailure;
+    } else if (num_sessions <= 0) {
+      PrintHelp(std::cerr, "num_sessions must be greater than 0");
+      return Result::ExitFailure;
+    } else if (num_cores < 0) {
+      PrintHelp(std::cerr, "num_cores must not be negative");
+      return Result::ExitFailure;
+    } else if (response_cache_mb < 0 || response_cache_ttl_ms < 0) {
+      PrintHelp(std::cerr, "response_cache_mb and response_cache_ttl_ms must not be negative");
+      return Result::ExitFailure;
+    } else if (model_path.empty() && model_specs.empty()) {
+      PrintHelp(std::cerr, "model_path or model must be given");
+      return Result::ExitFailure;
+    } else if (!model_path.empty() && !file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
-    } else {
-      return Result::ContinueSuccess;
     }
+
+    models.clear();
+    if (!model_path.empty()) {
+      ModelConfig model;
+      model.name = model_name;
+      model.version = model_version;
+      model.path = model_path;
+      model.num_sessions = num_sessions;
+      models.push_back(model);
+    }
+
+    for (const auto& spec : model_specs) {
+      ModelConfig model;
+      std::string error;
+      if (!ParseModelSpec(spec, model, error)) {
+        PrintHelp(std::cerr, "Invalid model '" + spec + "': " + error);
+        return Result::ExitFailure;
+      }
+      models.push_back(model);
+    }
+
+    return Result::ContinueSuccess;
+  }
+
+  // Parses name=<name>,version=<version>,path=<path>[,weight=<weight>][,sessions=<sessions>]
+  bool ParseModelSpec(const std::string& spec, ModelConfig& model, std::string& error) {
+    model.version = "1";
+    std::istringstream iss(spec);
+    std::string field;
+    while (std::getline(iss, field, ',')) {
+      auto separator = field.find('=');
+      if (separator == std::string::npos) {
+        error = "expected key=value, got '" + field + "'";
+        return false;
+      }
+
+      auto key = field.substr(0, separator);
+      auto value = field.substr(separator + 1);
+      if (key == "name") {
+        model.name = value;
+      } else if (key == "version") {
+        model.version = value;
+      } else if (key == "path") {
+        model.path = value;
+      } else if (key == "weight" || key == "sessions") {
+        std::istringstream value_iss(value);
+        int number = 0;
+        if (!(value_iss >> number) || !value_iss.eof() || number <= 0) {
+          error = key + " must be a positive integer";
+          return false;
+        }
+        (key == "weight" ? model.weight : model.num_sessions) = number;
+      } else {
+        error = "unknown key '" + key + "'";
+        return false;
+      }
+    }
+
+    if (model.name.empty()) {
+      error = "name must be given";
+      return false;
+    } else if (!file_exists(model.path)) {
+      error = "path must be the location of a valid file";
+      return false;
+    }
+
+    return true;
   }
 
   // Checks if program options contains help
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "grpc/async_prediction_service.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+namespace test {
+
+static PredictRequest MulRequest() {
+  PredictRequest req{};
+  req.add_output_filter("Y");
+  onnx::TensorProto proto{};
+  proto.add_dims(3);
+  proto.add_dims(2);
+  proto.set_data_type(1);
+  for (float f : {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}) {
+    proto.add_float_data(f);
+  }
+  (*req.mutable_inputs())["X"] = proto;
+  return req;
+}
+
+TEST(InferenceWorkerPoolTests, RejectsTasksOverTheLimit) {
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<void> started;
+
+  {
+    InferenceWorkerPool pool(1, 2);
+    EXPECT_TRUE(pool.TrySchedule([&started, released]() {
+      started.set_value();
+      released.wait();
+    }));
+    started.get_future().wait();
+
+    // one task running and one queued
+    std::atomic<int> ran{0};
+    EXPECT_TRUE(pool.TrySchedule([&ran]() { ++ran; }));
+    EXPECT_EQ(pool.Pending(), 2);
+    EXPECT_FALSE(pool.TrySchedule([&ran]() { ++ran; }));
+
+    release.set_value();
+    // the pool runs the queued task before it is destroyed
+    while (pool.Pending() > 0) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(ran.load(), 1);
+    EXPECT_TRUE(pool.TrySchedule([&ran]() { ++ran; }));
+  }
+}
+
+TEST(InferenceWorkerPoolTests, UnlimitedPool) {
+  std::atomic<int> ran{0};
+  {
+    InferenceWorkerPool pool(2, 0);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_TRUE(pool.TrySchedule([&ran]() { ++ran; }));
+    }
+  }
+  EXPECT_EQ(ran.load(), 100);
+}
+
+class AsyncPredictionServiceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    onnxruntime::server::test::ServerEnv()->InitializeModel("testdata/mul_1.onnx", "default", "1");
+  }
+  void TearDown() override {
+    onnxruntime::server::test::ServerEnv()->UnloadModel("default", "1");
+  }
+  std::shared_ptr<ServerEnvironment> GetEnvironment() {
+    return std::shared_ptr<ServerEnvironment>(onnxruntime::server::test::ServerEnv(), [](ServerEnvironment*) {});
+  }
+};
+
+// many more concurrent calls than threads
+TEST_F(AsyncPredictionServiceTest, ConcurrentCalls) {
+  AsyncServiceOptions options;
+  options.num_completion_queue_threads = 1;
+  options.num_inference_threads = 2;
+  AsyncPredictionService service(GetEnvironment(), options);
+
+  ::grpc::ServerBuilder builder;
+  int port = 0;
+  builder.AddListeningPort("localhost:0", ::grpc::InsecureServerCredentials(), &port);
+  service.Register(builder);
+  auto server = builder.BuildAndStart();
+  ASSERT_NE(port, 0);
+  service.Start();
+
+  auto stub = PredictionService::NewStub(
+      ::grpc::CreateChannel("localhost:" + std::to_string(port), ::grpc::InsecureChannelCredentials()));
+  ::grpc::CompletionQueue completion_queue;
+  constexpr int num_calls = 64;
+  const auto request = MulRequest();
+  struct ClientCall {
+    ::grpc::ClientContext context;
+    PredictResponse response;
+    ::grpc::Status status;
+  };
+  std::vector<ClientCall> calls(num_calls);
+  for (int i = 0; i < num_calls; ++i) {
+    auto reader = stub->AsyncPredict(&calls[i].context, request, &completion_queue);
+    reader->Finish(&calls[i].response, &calls[i].status, &calls[i]);
+  }
+
+  for (int i = 0; i < num_calls; ++i) {
+    void* tag;
+    bool ok;
+    ASSERT_TRUE(completion_queue.Next(&tag, &ok));
+    ASSERT_TRUE(ok);
+  }
+
+  for (const auto& call : calls) {
+    ASSERT_TRUE(call.status.ok()) << call.status.error_message();
+    const auto& output = call.response.outputs().at("Y");
+    ASSERT_EQ(output.dims_size(), 2);
+    EXPECT_EQ(output.dims(0), 3);
+    EXPECT_EQ(output.dims(1), 2);
+  }
+
+  server->Shutdown();
+  service.Shutdown();
+  completion_queue.Shutdown();
+  void* tag;
+  bool ok;
+  while (completion_queue.Next(&tag, &ok)) {
+  }
+}
+
+}  // namespace test
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "batcher.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+class DynamicBatcherTest : public ::testing::Test {
+ protected:
+  // Y = X * X with X of shape [N, 2]
+  void SetUp() override {
+    const static auto model_file = "testdata/mul_batch.onnx";
+
+    onnxruntime::server::ServerEnvironment* env = ServerEnv();
+    env->InitializeModel(model_file, "Batch", "1");
+  }
+
+  void TearDown() override {
+    onnxruntime::server::ServerEnvironment* env = ServerEnv();
+    env->UnloadModel("Batch", "1");
+  }
+
+  static std::vector<float> RunRequest(DynamicBatcher& batcher, std::vector<float> data, int64_t columns) {
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<int64_t> shape{static_cast<int64_t>(data.size()) / columns, columns};
+
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size()));
+    auto outputs = batcher.Run({"X"}, std::move(inputs), {"Y"});
+
+    EXPECT_EQ(outputs.size(), 1u);
+    EXPECT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), shape);
+    const auto* y = outputs[0].GetTensorMutableData<float>();
+    return std::vector<float>(y, y + data.size());
+  }
+};
+
+TEST_F(DynamicBatcherTest, BatchesConcurrentRequests) {
+  BatchingOptions options{};
+  options.max_batch_size = 4;
+  // long enough that the batch is only run once it is full
+  options.batch_timeout = std::chrono::seconds(30);
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  DynamicBatcher batcher(env->GetSession("Batch", "1"), options, ORT_LOGGING_LEVEL_WARNING, env->GetAppLogger());
+
+  // 1 + 2 + 1 rows
+  std::vector<std::vector<float>> requests{{1, 2}, {3, 4, 5, 6}, {7, 8}};
+  std::vector<std::vector<float>> results(requests.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    threads.emplace_back([&, i]() { results[i] = RunRequest(batcher, requests[i], 2); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(results[0], (std::vector<float>{1, 4}));
+  EXPECT_EQ(results[1], (std::vector<float>{9, 16, 25, 36}));
+  EXPECT_EQ(results[2], (std::vector<float>{49, 64}));
+
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.queue_depth, 0u);
+  EXPECT_EQ(stats.batch_size_histogram, (std::map<size_t, uint64_t>{{4, 1}}));
+}
+
+TEST_F(DynamicBatcherTest, TimeoutRunsPartialBatch) {
+  BatchingOptions options{};
+  options.max_batch_size = 8;
+  options.batch_timeout = std::chrono::milliseconds(1);
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  DynamicBatcher batcher(env->GetSession("Batch", "1"), options, ORT_LOGGING_LEVEL_WARNING, env->GetAppLogger());
+
+  EXPECT_EQ(RunRequest(batcher, {2, 3}, 2), (std::vector<float>{4, 9}));
+
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.max_queue_depth, 1u);
+  EXPECT_EQ(stats.batch_size_histogram, (std::map<size_t, uint64_t>{{1, 1}}));
+}
+
+TEST_F(DynamicBatcherTest, IncompatibleRequestsRunSeparately) {
+  BatchingOptions options{};
+  options.max_batch_size = 2;
+  options.batch_timeout = std::chrono::milliseconds(50);
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  DynamicBatcher batcher(env->GetSession("Batch", "1"), options, ORT_LOGGING_LEVEL_WARNING, env->GetAppLogger());
+
+  // the second request has an invalid shape, which must not fail the first one
+  std::vector<float> result;
+  std::thread valid([&]() { result = RunRequest(batcher, {1, 2}, 2); });
+  std::thread invalid([&]() { EXPECT_THROW(RunRequest(batcher, {1, 2, 3}, 3), Ort::Exception); });
+  valid.join();
+  invalid.join();
+
+  EXPECT_EQ(result, (std::vector<float>{1, 4}));
+  EXPECT_EQ(batcher.GetStats().batch_size_histogram, (std::map<size_t, uint64_t>{{1, 2}}));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+#include <google/protobuf/stubs/status.h>
+
+#include "gtest/gtest.h"
+
+#include "executor.h"
+#include "http/binary_tensor_handling.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+namespace protobufutil = google::protobuf::util;
+
+static std::string MakePayload(const std::string& header, const std::vector<float>& data) {
+  std::string body = header;
+  body.append(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+  return body;
+}
+
+TEST(BinaryTensorDeserializationTests, HappyPath) {
+  // one of the header lengths leaves the data unaligned, so it is copied
+  for (const std::string padding : {"", " "}) {
+    const std::string header =
+        R"({"inputs":[{"name":"X","datatype":"FP32","shape":[3,2],"parameters":{"binary_data_size":24}}],)"
+        R"("outputs":[{"name":"Y"}]})" +
+        padding;
+    std::vector<float> data{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+    auto body = MakePayload(header, data);
+
+    MemBufferArray buffers;
+    std::vector<std::string> input_names;
+    std::vector<Ort::Value> input_values;
+    std::vector<std::string> output_names;
+    auto status = GetInputsFromBinaryPayload(body, header.size(), buffers, input_names, input_values, output_names);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+
+    ASSERT_EQ(input_names, std::vector<std::string>{"X"});
+    ASSERT_EQ(output_names, std::vector<std::string>{"Y"});
+    auto type_and_shape = input_values[0].GetTensorTypeAndShapeInfo();
+    EXPECT_EQ(type_and_shape.GetElementType(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+    EXPECT_EQ(type_and_shape.GetShape(), (std::vector<int64_t>{3, 2}));
+    const float* values = input_values[0].GetTensorMutableData<float>();
+    EXPECT_EQ(std::vector<float>(values, values + 6), data);
+  }
+}
+
+TEST(BinaryTensorDeserializationTests, InvalidPayloads) {
+  std::vector<float> data{1.f, 2.f};
+  const std::vector<std::pair<std::string, std::vector<float>>> payloads{
+      // size doesn't match the shape
+      {R"({"inputs":[{"name":"X","datatype":"FP32","shape":[3],"parameters":{"binary_data_size":8}}]})", data},
+      // data is missing
+      {R"({"inputs":[{"name":"X","datatype":"FP32","shape":[2],"parameters":{"binary_data_size":8}}]})", {}},
+      // trailing data
+      {R"({"inputs":[{"name":"X","datatype":"FP32","shape":[1],"parameters":{"binary_data_size":4}}]})", data},
+      // not sent as binary data
+      {R"({"inputs":[{"name":"X","datatype":"FP32","shape":[2]}]})", data},
+      // strings can't be sent in binary form
+      {R"({"inputs":[{"name":"X","datatype":"BYTES","shape":[2],"parameters":{"binary_data_size":8}}]})", data},
+  };
+
+  for (const auto& payload : payloads) {
+    auto body = MakePayload(payload.first, payload.second);
+    MemBufferArray buffers;
+    std::vector<std::string> input_names;
+    std::vector<Ort::Value> input_values;
+    std::vector<std::string> output_names;
+    auto status = GetInputsFromBinaryPayload(body, payload.first.size(), buffers, input_names, input_values,
+                                             output_names);
+    EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code()) << payload.first;
+  }
+
+  // the header length exceeds the payload
+  MemBufferArray buffers;
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  std::vector<std::string> output_names;
+  auto status = GetInputsFromBinaryPayload("{}", 3, buffers, input_names, input_values, output_names);
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code());
+}
+
+class BinaryTensorPredictTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const static auto model_file = "testdata/mul_1.onnx";
+
+    onnxruntime::server::ServerEnvironment* env = ServerEnv();
+    env->InitializeModel(model_file, "Name", "version");
+  }
+
+  void TearDown() override {
+    onnxruntime::server::ServerEnvironment* env = ServerEnv();
+    env->UnloadModel("Name", "version");
+  }
+};
+
+TEST_F(BinaryTensorPredictTest, TestMul_1) {
+  const std::string header =
+      R"({"inputs":[{"name":"X","datatype":"FP32","shape":[3,2],"parameters":{"binary_data_size":24}}]})";
+  auto body = MakePayload(header, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+
+  MemBufferArray buffers;
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  std::vector<std::string> output_names;
+  ASSERT_TRUE(GetInputsFromBinaryPayload(body, header.size(), buffers, input_names, input_values, output_names).ok());
+
+  onnxruntime::server::Executor executor(ServerEnv(), "RequestId");
+  std::vector<Ort::Value> outputs;
+  auto status = executor.Predict("Name", "version", input_names, std::move(input_values), output_names, outputs);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  ASSERT_EQ(output_names, std::vector<std::string>{"Y"});
+
+  std::string response;
+  size_t response_header_length = 0;
+  ASSERT_TRUE(GenerateBinaryPayload("Name", "version", output_names, outputs, response, response_header_length).ok());
+
+  const std::string expected_header =
+      R"({"model_name":"Name","model_version":"version","outputs":[)"
+      R"({"name":"Y","datatype":"FP32","shape":[3,2],"parameters":{"binary_data_size":24}}]})";
+  EXPECT_EQ(response.substr(0, response_header_length), expected_header);
+  ASSERT_EQ(response.size(), response_header_length + 6 * sizeof(float));
+
+  std::vector<float> result(6);
+  memcpy(result.data(), response.data() + response_header_length, 6 * sizeof(float));
+  EXPECT_EQ(result, (std::vector<float>{1.f, 4.f, 9.f, 16.f, 25.f, 36.f}));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "environment.h"
+#include "executor.h"
+#include "http/json_handling.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+static const auto model_file = "testdata/mul_1.onnx";
+
+static ModelConfig MakeModelConfig(const std::string& name, int weight, int num_sessions) {
+  ModelConfig model;
+  model.name = name;
+  model.version = "1";
+  model.path = model_file;
+  model.weight = weight;
+  model.num_sessions = num_sessions;
+  return model;
+}
+
+TEST(SessionPoolTests, LeasesSpreadOverSessions) {
+  ServerEnvironment* env = ServerEnv();
+  env->LoadModels({MakeModelConfig("Pool", 1, 2)});
+
+  {
+    auto first = env->AcquireModel("Pool", "1");
+    auto second = env->AcquireModel("Pool", "1");
+    EXPECT_NE(&first.Session(), &second.Session());
+    EXPECT_EQ(first.OutputNames(), std::vector<std::string>{"Y"});
+
+    // the session of a released lease is the least busy again
+    const Ort::Session* released = &first.Session();
+    { auto moved = std::move(first); }
+    auto third = env->AcquireModel("Pool", "1");
+    EXPECT_EQ(&third.Session(), released);
+  }
+
+  env->UnloadModel("Pool", "1");
+}
+
+TEST(SessionPoolTests, LoadAndUnloadWhileServing) {
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+  const static auto expected = R"({"outputs":{"Y":{"dims":["3","2"],"dataType":1,"floatData":[1,4,9,16,25,36]}}})";
+
+  ServerEnvironment* env = ServerEnv();
+  env->LoadModels({MakeModelConfig("Hot", 1, 1)});
+  EXPECT_THROW(env->LoadModels({MakeModelConfig("Hot", 1, 1)}), Ort::Exception);
+
+  // the model stays usable by a request that holds it while it is unloaded
+  auto lease = env->AcquireModel("Hot", "1");
+  env->UnloadModel("Hot", "1");
+  EXPECT_THROW(env->AcquireModel("Hot", "1"), Ort::Exception);
+  EXPECT_EQ(lease.OutputNames(), std::vector<std::string>{"Y"});
+
+  // and can be loaded again without a restart
+  env->LoadModels({MakeModelConfig("Hot", 1, 1)});
+  Executor executor(env, "RequestId");
+  PredictRequest request{};
+  PredictResponse response{};
+  ASSERT_TRUE(GetRequestFromJson(input_json, request).ok());
+  ASSERT_TRUE(executor.Predict("Hot", "1", request, response).ok());
+
+  std::string body;
+  ASSERT_TRUE(GenerateResponseInJson(response, body).ok());
+  EXPECT_EQ(expected, body);
+
+  env->UnloadModel("Hot", "1");
+}
+
+TEST(SessionPoolTests, CoresSplitByWeight) {
+  ServerEnvironment* env = ServerEnv();
+  env->SetCoreBudget(8, false);
+  env->LoadModels({MakeModelConfig("Latency", 3, 2), MakeModelConfig("Batch", 1, 1)});
+
+  EXPECT_EQ(env->GetModelCores("Latency", "1"), (std::vector<int>{0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(env->GetModelCores("Batch", "1"), (std::vector<int>{6, 7}));
+
+  // the cores of the loaded models are kept, a model loaded later only gets the free ones
+  env->UnloadModel("Batch", "1");
+  env->LoadModels({MakeModelConfig("Late", 5, 1)});
+  EXPECT_EQ(env->GetModelCores("Late", "1"), (std::vector<int>{6, 7}));
+  EXPECT_EQ(env->GetModelCores("Latency", "1"), (std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+  // a model without free cores still runs
+  env->LoadModels({MakeModelConfig("Starved", 1, 1)});
+  EXPECT_TRUE(env->GetModelCores("Starved", "1").empty());
+
+  EXPECT_THROW(env->LoadModels({MakeModelConfig("Invalid", 0, 1)}), Ort::Exception);
+
+  env->UnloadModel("Latency", "1");
+  env->UnloadModel("Late", "1");
+  env->UnloadModel("Starved", "1");
+  env->SetCoreBudget(0, false);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstring>
 #include <iostream>
 
 #include "gtest/gtest.h"
@@ -52,6 +53,33 @@ TEST_F(ExecutorTest, TestMul_1) {
   EXPECT_EQ(expected, body);
 }
 
+TEST_F(ExecutorTest, TestMul_1RawData) {
+  // outputs with a static shape are written by the Run straight into the raw_data of the response
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"rawData":"AACAPwAAAEAAAEBAAACAQAAAoEAAAMBA"}},"outputFilter":["Y"]})";
+  const std::vector<float> expected{1.f, 4.f, 9.f, 16.f, 25.f, 36.f};
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictRequest request{};
+  onnxruntime::server::PredictResponse response{};
+
+  auto protostatus = onnxruntime::server::GetRequestFromJson(input_json, request);
+  EXPECT_TRUE(protostatus.ok());
+
+  auto prediction_res = executor.Predict("Name", "version", request, response);
+  ASSERT_TRUE(prediction_res.ok()) << prediction_res.error_message();
+
+  ASSERT_EQ(response.outputs().size(), 1u);
+  const auto& output = response.outputs().at("Y");
+  EXPECT_EQ(output.data_type(), onnx::TensorProto_DataType_FLOAT);
+  ASSERT_EQ(output.dims_size(), 2);
+  EXPECT_EQ(output.dims(0), 3);
+  EXPECT_EQ(output.dims(1), 2);
+  ASSERT_EQ(output.raw_data().size(), expected.size() * sizeof(float));
+  EXPECT_EQ(0, memcmp(output.raw_data().data(), expected.data(), output.raw_data().size()));
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
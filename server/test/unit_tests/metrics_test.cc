@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "executor.h"
+#include "http/json_handling.h"
+#include "metrics.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+TEST(MetricsTests, HistogramBuckets) {
+  Histogram histogram({1, 10});
+  histogram.Observe(0.5);
+  histogram.Observe(1);
+  histogram.Observe(5);
+  histogram.Observe(50);
+
+  std::ostringstream out;
+  histogram.Write(out, "latency", "model=\"m\"");
+  EXPECT_EQ(out.str(),
+            "latency_bucket{model=\"m\",le=\"1\"} 2\n"
+            "latency_bucket{model=\"m\",le=\"10\"} 3\n"
+            "latency_bucket{model=\"m\",le=\"+Inf\"} 4\n"
+            "latency_sum{model=\"m\"} 56.500000\n"
+            "latency_count{model=\"m\"} 4\n");
+}
+
+TEST(MetricsTests, RequestTimer) {
+  ServerMetrics metrics;
+  EXPECT_EQ(metrics.GetModel("m", "1"), nullptr);
+  auto& model = metrics.AddModel("m", "1");
+  EXPECT_EQ(metrics.GetModel("m", "1"), &model);
+
+  {
+    RequestTimer timer(&model);
+    timer.Succeeded();
+  }
+  { RequestTimer failed(&model); }
+  { RequestTimer unknown_model(nullptr); }
+
+  EXPECT_EQ(model.requests.load(), 2u);
+  EXPECT_EQ(model.errors.load(), 1u);
+
+  std::ostringstream out;
+  metrics.Write(out);
+  EXPECT_NE(out.str().find("# TYPE ort_server_requests_total counter\nort_server_requests_total{model=\"m\",version=\"1\"} 2"),
+            std::string::npos)
+      << out.str();
+  EXPECT_EQ(EscapeLabelValue("a\"b\\c\nd"), "a\\\"b\\\\c\\nd");
+}
+
+TEST(MetricsTests, ServerMetrics) {
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx", "Metrics", "1");
+  EXPECT_EQ(env->GetModelMetrics("NotLoaded", "1"), nullptr);
+
+  PredictRequest request{};
+  ASSERT_TRUE(GetRequestFromJson(input_json, request).ok());
+  Executor executor(env, "RequestId");
+  PredictResponse response{};
+  ASSERT_TRUE(executor.Predict("Metrics", "1", request, response).ok());
+
+  std::ostringstream out;
+  env->WriteMetrics(out);
+  const auto metrics = out.str();
+  EXPECT_NE(metrics.find("ort_server_inference_duration_seconds_count{model=\"Metrics\",version=\"1\"} 1\n"),
+            std::string::npos)
+      << metrics;
+  EXPECT_NE(metrics.find("ort_server_sessions{model=\"Metrics\",version=\"1\"} 1\n"), std::string::npos);
+  EXPECT_NE(metrics.find("ort_server_requests_in_flight{model=\"Metrics\",version=\"1\"} 0\n"), std::string::npos);
+  EXPECT_NE(metrics.find("ort_server_arena_bytes_in_use{model=\"Metrics\",version=\"1\",provider=\"CPUExecutionProvider\",device=\"Cpu\",device_id=\"0\"} "),
+            std::string::npos)
+      << metrics;
+
+  // the counters are kept when the model is unloaded
+  env->UnloadModel("Metrics", "1");
+  EXPECT_NE(env->GetModelMetrics("Metrics", "1"), nullptr);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
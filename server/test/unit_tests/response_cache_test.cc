@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "executor.h"
+#include "http/json_handling.h"
+#include "response_cache.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+static PredictRequest MakeRequest(const std::string& json) {
+  PredictRequest request{};
+  EXPECT_TRUE(GetRequestFromJson(json, request).ok());
+  return request;
+}
+
+static PredictResponse MakeResponse(size_t num_values) {
+  PredictResponse response{};
+  auto& tensor = (*response.mutable_outputs())["Y"];
+  tensor.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  tensor.add_dims(static_cast<int64_t>(num_values));
+  tensor.mutable_raw_data()->resize(num_values * sizeof(float));
+  return response;
+}
+
+TEST(ResponseCacheTests, Keys) {
+  auto request = MakeRequest(R"({"inputs":{"X":{"dims":[2],"dataType":1,"rawData":"AACAPwAAAEA="},"Z":{"dims":[1],"dataType":1,"floatData":[1]}},"outputFilter":["Y","W"]})");
+  auto same = MakeRequest(R"({"inputs":{"Z":{"dims":[1],"dataType":1,"floatData":[1]},"X":{"dims":[2],"dataType":1,"rawData":"AACAPwAAAEA="}},"outputFilter":["W","Y"]})");
+  auto other_data = MakeRequest(R"({"inputs":{"X":{"dims":[2],"dataType":1,"rawData":"AACAPwAAQEA="},"Z":{"dims":[1],"dataType":1,"floatData":[1]}},"outputFilter":["Y","W"]})");
+  auto other_shape = MakeRequest(R"({"inputs":{"X":{"dims":[1,2],"dataType":1,"rawData":"AACAPwAAAEA="},"Z":{"dims":[1],"dataType":1,"floatData":[1]}},"outputFilter":["Y","W"]})");
+
+  auto key = ResponseCache::MakeKey("model", "1", 1, request);
+  EXPECT_EQ(key, ResponseCache::MakeKey("model", "1", 1, same));
+  EXPECT_NE(key, ResponseCache::MakeKey("model", "1", 1, other_data));
+  EXPECT_NE(key, ResponseCache::MakeKey("model", "1", 1, other_shape));
+  EXPECT_NE(key, ResponseCache::MakeKey("model", "2", 1, request));
+  EXPECT_NE(key, ResponseCache::MakeKey("model", "1", 2, request));
+}
+
+TEST(ResponseCacheTests, LeastRecentlyUsedEviction) {
+  // room for two responses
+  const size_t entry_bytes = std::string("a").size() + MakeResponse(100).ByteSizeLong();
+  ResponseCacheOptions options;
+  options.max_bytes = 2 * entry_bytes + entry_bytes / 2;
+  ResponseCache cache(options);
+
+  cache.Insert("a", MakeResponse(100));
+  cache.Insert("b", MakeResponse(100));
+  PredictResponse response;
+  EXPECT_TRUE(cache.Lookup("a", response));
+  EXPECT_EQ(response.outputs().at("Y").dims(0), 100);
+
+  // b is the least recently used
+  cache.Insert("c", MakeResponse(100));
+  EXPECT_FALSE(cache.Lookup("b", response));
+  EXPECT_TRUE(cache.Lookup("a", response));
+  EXPECT_TRUE(cache.Lookup("c", response));
+
+  // larger than the cache
+  cache.Insert("d", MakeResponse(1000));
+  EXPECT_FALSE(cache.Lookup("d", response));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 3u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.entries, 2u);
+  EXPECT_EQ(stats.bytes, 2 * entry_bytes);
+}
+
+TEST(ResponseCacheTests, Expiration) {
+  ResponseCacheOptions options;
+  options.max_bytes = 1 << 20;
+  options.ttl = std::chrono::milliseconds(1);
+  ResponseCache cache(options);
+
+  cache.Insert("a", MakeResponse(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  PredictResponse response;
+  EXPECT_FALSE(cache.Lookup("a", response));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.expirations, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.entries, 0u);
+  EXPECT_EQ(stats.bytes, 0u);
+}
+
+// the second request is answered from the cache, and a reloaded model doesn't get the responses of the previous one
+TEST(ResponseCacheTests, ExecutorServesRepeats) {
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"rawData":"AACAPwAAAEAAAEBAAACAQAAAoEAAAMBA"}},"outputFilter":["Y"]})";
+
+  ServerEnvironment* env = ServerEnv();
+  ResponseCacheOptions options;
+  options.max_bytes = 1 << 20;
+  env->SetResponseCacheOptions(options);
+  env->InitializeModel("testdata/mul_1.onnx", "Cached", "1");
+
+  auto request = MakeRequest(input_json);
+  std::string first_body;
+  for (int i = 0; i < 2; ++i) {
+    Executor executor(env, "RequestId");
+    PredictResponse response{};
+    ASSERT_TRUE(executor.Predict("Cached", "1", request, response).ok());
+    std::string body;
+    ASSERT_TRUE(GenerateResponseInJson(response, body).ok());
+    if (i == 0) {
+      first_body = body;
+    } else {
+      EXPECT_EQ(first_body, body);
+    }
+  }
+
+  auto stats = env->GetResponseCache()->GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+
+  env->UnloadModel("Cached", "1");
+  env->InitializeModel("testdata/mul_1.onnx", "Cached", "1");
+  Executor executor(env, "RequestId");
+  PredictResponse response{};
+  ASSERT_TRUE(executor.Predict("Cached", "1", request, response).ok());
+  EXPECT_EQ(env->GetResponseCache()->GetStats().misses, 2u);
+
+  env->UnloadModel("Cached", "1");
+  env->SetResponseCacheOptions(ResponseCacheOptions{});
+  EXPECT_EQ(env->GetResponseCache(), nullptr);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -51,6 +51,66 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
 }
 
+TEST(ConfigParsingTests, BatchingArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("16"),
+      const_cast<char*>("--batch_timeout_us"), const_cast<char*>("500")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 16);
+  EXPECT_EQ(config.batch_timeout_us, 500);
+}
+
+TEST(ConfigParsingTests, WrongBatchSize) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, MultipleModels) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model"), const_cast<char*>("name=ranker,version=2,path=testdata/mul_1.onnx,weight=3,sessions=2"),
+      const_cast<char*>("--model"), const_cast<char*>("name=embedder,path=testdata/mul_1.onnx"),
+      const_cast<char*>("--num_cores"), const_cast<char*>("8"),
+      const_cast<char*>("--pin_cores")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(8, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_cores, 8);
+  EXPECT_TRUE(config.pin_cores);
+  EXPECT_FALSE(config.enable_model_management);
+  ASSERT_EQ(config.models.size(), 2u);
+  EXPECT_EQ(config.models[0].name, "ranker");
+  EXPECT_EQ(config.models[0].version, "2");
+  EXPECT_EQ(config.models[0].weight, 3);
+  EXPECT_EQ(config.models[0].num_sessions, 2);
+  EXPECT_EQ(config.models[1].name, "embedder");
+  EXPECT_EQ(config.models[1].version, "1");
+  EXPECT_EQ(config.models[1].weight, 1);
+  EXPECT_EQ(config.models[1].num_sessions, 1);
+}
+
+TEST(ConfigParsingTests, InvalidModel) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model"), const_cast<char*>("name=ranker,path=testdata/mul_1.onnx,weight=0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(3, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 TEST(ConfigParsingTests, Help) {
   char* test_argv[] = {
       const_cast<char*>("/path/to/binary"),
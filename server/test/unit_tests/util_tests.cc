@@ -40,6 +40,17 @@ TEST(RequestContentTypeTests, ContentTypeRawData) {
   EXPECT_EQ(result, SupportedContentType::PbByteArray);
 }
 
+TEST(RequestContentTypeTests, ContentTypeBinaryTensor) {
+  HttpContext context;
+  http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
+  request.set(http::field::content_type, "application/octet-stream");
+  request.set(BINARY_HEADER_LENGTH_HEADER, "64");
+  context.request = request;
+
+  auto result = GetRequestContentType(context);
+  EXPECT_EQ(result, SupportedContentType::BinaryTensor);
+}
+
 TEST(RequestContentTypeTests, ContentTypeUnknown) {
   HttpContext context;
   http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
@@ -126,6 +126,13 @@ def parse_arguments():
 
     # CUDA related
     parser.add_argument("--use_cuda", action='store_true', help="Enable CUDA.")
+    parser.add_argument(
+        "--enable_cuda_graph", action='store_true',
+        help="Build the CUDA EP with support for capturing Runs into CUDA graphs.")
+    parser.add_argument(
+        "--cuda_per_thread_default_stream", action='store_true',
+        help="Launch CUDA kernels on the per-thread default stream, so parallel branches of a graph run "
+        "concurrently when the parallel execution mode is used.")
     parser.add_argument(
         "--cuda_version", help="The version of CUDA toolkit to use. "
         "Auto-detect if not specified. e.g. 9.0")
@@ -599,6 +606,9 @@ def generate_build_tree(cmake_path, source_dir, build_dir, cuda_home, cudnn_home
         "-Donnxruntime_USE_FEATURIZERS=" + (
             "ON" if args.use_featurizers else "OFF"),
         "-Donnxruntime_CUDA_HOME=" + (cuda_home if args.use_cuda else ""),
+        "-Donnxruntime_ENABLE_CUDA_GRAPH=" + ("ON" if args.use_cuda and args.enable_cuda_graph else "OFF"),
+        "-Donnxruntime_CUDA_PER_THREAD_DEFAULT_STREAM=" + (
+            "ON" if args.use_cuda and args.cuda_per_thread_default_stream else "OFF"),
         "-Donnxruntime_USE_JEMALLOC=" + ("ON" if args.use_jemalloc else "OFF"),
         "-Donnxruntime_USE_MIMALLOC_STL_ALLOCATOR=" + (
             "ON" if args.use_mimalloc == "stl" or
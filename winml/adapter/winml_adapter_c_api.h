@@ -26,6 +26,9 @@ struct IMLOperatorRegistry;
 enum OrtProfilerEventCategory {
   SESSION_EVENT = 0,
   NODE_EVENT,
+  THREADPOOL_EVENT,
+  DATA_TRANSFER_EVENT,
+  MEMORY_EVENT,
   EVENT_CATEGORY_MAX
 };
 
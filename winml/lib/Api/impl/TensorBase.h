@@ -290,6 +290,9 @@ struct TensorBase : TBase {
         m_resources,
         "The tensor has been closed and its resources have been detached during evaluation!");
 
+    // the readback of an earlier evaluation is superseded by this one
+    m_resources->PendingReadback = nullptr;
+
     _winml::Resource updated_resource;
     RETURN_IF_FAILED(value->GetResource(updated_resource));
 
@@ -316,17 +319,37 @@ struct TensorBase : TBase {
         SetBufferFromValueResourceBuffer(shape_size, updated_resource.get());
       }
     } else {
-      // If we got a gpu resource, we should move the data to the cpu so accessors can retrieve the data.
+      // If we got a gpu resource, the data is moved to the cpu when an accessor first retrieves it, so outputs that
+      // are only consumed on the gpu, e.g. rendered or bound to the next evaluation, are never read back.
       // We don't need to copy the engine provided dx resource into a local copy since we always preallocate gpu
       // resources for tensors. Therefore we are certain that the returned dxresource is the same as the one we passed in
       // and was updated in place.
-      auto spSession = context.session.as<winmlp::LearningModelSession>();
-      auto engine = spSession->GetEngine();
-
-      winrt::com_ptr<IValue> dest;
-      RETURN_IF_FAILED_MSG(CreateTensorValueFromExternalBuffer(engine, dest.put()),
-                           "Failed to prepare buffer for copy back from device resource.");
-      RETURN_IF_FAILED(engine->CopyValueAcrossDevices(value, dest.get()));
+      // The readback holds the session and engine, as the tensor may outlive them, and only refers to the resources
+      // it is stored in, as the memory buffer references may outlive the tensor.
+      winrt::com_ptr<winmlp::LearningModelSession> session = context.session.as<winmlp::LearningModelSession>();
+      winrt::com_ptr<_winml::IEngine> engine;
+      engine.copy_from(session->GetEngine());
+      winrt::com_ptr<IValue> device_value;
+      device_value.copy_from(value);
+
+      m_resources->PendingReadback = [resources = m_resources.get(), session, engine, device_value, shape = shape_,
+                                      kind = TensorKind()]() -> HRESULT {
+        // the DML EP is not thread safe.
+        CWinMLAutoLock lock(session->GetDMLEPLock());
+
+        if (resources->CpuResource == nullptr) {
+          resources->CpuResource = std::make_shared<_winml::Tensor<T>>(shape);
+        }
+
+        auto& cpu_resource = resources->CpuResource;
+        winrt::com_ptr<IValue> dest;
+        RETURN_IF_FAILED_MSG(engine->CreateTensorValueFromExternalBuffer(
+                                 cpu_resource->buffer().second, cpu_resource->size_in_bytes(),
+                                 cpu_resource->shape().data(), cpu_resource->shape().size(), kind, dest.put()),
+                             "Failed to prepare buffer for copy back from device resource.");
+        RETURN_IF_FAILED(engine->CopyValueAcrossDevices(device_value.get(), dest.get()));
+        return S_OK;
+      };
     }
 
     return S_OK;
@@ -699,7 +722,8 @@ struct TensorBase : TBase {
         m_resources,
         "The tensor has been closed and its resources have been detached!");
 
-    *pIsPlaceHolder = GetCpuResource() == nullptr && GetGpuResource() == nullptr;
+    // the resources are checked without reading back the last gpu evaluation
+    *pIsPlaceHolder = m_resources->CpuResource == nullptr && m_resources->GpuResource == nullptr;
     return S_OK;
   }
 
@@ -860,6 +884,7 @@ struct TensorBase : TBase {
         m_resources,
         "The tensor has been closed and its resources are detached!");
 
+    WINML_THROW_IF_FAILED(m_resources->ReadbackIfPending());
     return m_resources->CpuResource;
   }
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Tensor.h"
+#include <functional>
 #include <type_traits>
 
 #include <Memorybuffer.h>
@@ -28,6 +29,8 @@ struct TensorResources {
       *value = nullptr;
       *capacity = 0;
 
+      RETURN_IF_FAILED(ReadbackIfPending());
+
       // Lazily allocate the cpu resource on call to GetBuffer
       if (CpuResource == nullptr) {
         CpuResource = std::make_shared<_winml::Tensor<T>>(shape);
@@ -46,9 +49,24 @@ struct TensorResources {
     WINML_CATCH_ALL_COM
   }
 
+  // Copies the output of the last gpu evaluation into the cpu resource, if it hasn't been copied yet.
+  HRESULT ReadbackIfPending() {
+    if (PendingReadback == nullptr) {
+      return S_OK;
+    }
+
+    auto readback = std::move(PendingReadback);
+    PendingReadback = nullptr;
+    return readback();
+  }
+
   // Theses are access directly by TensorMemoryBufferReference<T> and TensorBase
   std::shared_ptr<_winml::Tensor<T>> CpuResource;
   winrt::com_ptr<ID3D12Resource> GpuResource;
+
+  // Set by TensorBase when a gpu evaluation writes the tensor, so the data is only read back when the cpu resource is
+  // accessed. Callers chaining the output into other D3D12 work never pay for the copy.
+  std::function<HRESULT()> PendingReadback;
 };
 
 // This class holds onto the lifetime of TensorResources<T> so that they can be kept alive by TensorBase AND its active MBRs.